@@ -74,6 +74,10 @@
  * Pre-processor Prototypes
  ****************************************************************************/
 
+/* Return the program counter saved in an interrupted register context */
+
+#define up_getusrpc(regs) ((uintptr_t)((FAR uint32_t *)(regs))[REG_PC])
+
 #ifndef __ASSEMBLY__
 
 #ifdef __cplusplus
@@ -333,6 +333,10 @@ static int      qspi_memory(struct qspi_dev_s *dev,
                   struct qspi_meminfo_s *meminfo);
 static void *qspi_alloc(struct qspi_dev_s *dev, size_t buflen);
 static void     qspi_free(struct qspi_dev_s *dev, void *buffer);
+#ifdef CONFIG_QSPI_MEMMAP
+static int      qspi_memmap(struct qspi_dev_s *dev,
+                  const struct qspi_meminfo_s *meminfo, void **base);
+#endif
 
 /* Initialization */
 
@@ -357,6 +361,9 @@ static const struct qspi_ops_s g_qspi0ops =
   .memory            = qspi_memory,
   .alloc             = qspi_alloc,
   .free              = qspi_free,
+#ifdef CONFIG_QSPI_MEMMAP
+  .memmap            = qspi_memmap,
+#endif
 };
 
 /* This is the overall state of the QSPI0 controller */
@@ -2441,6 +2448,133 @@ static void qspi_free(struct qspi_dev_s *dev, void *buffer)
     }
 }
 
+/****************************************************************************
+ * Name: qspi_memorymapped
+ *
+ * Description:
+ *   Put the QSPI device into memory mapped mode.  The caller holds the bus
+ *   lock.
+ *
+ * Input Parameters:
+ *   priv    - QSPI device
+ *   meminfo - parameters like for a memory transfer used for reading
+ *   lpto    - Low-power timeout, zero to keep CS asserted
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void qspi_memorymapped(struct stm32h7_qspidev_s *priv,
+                              const struct qspi_meminfo_s *meminfo,
+                              uint32_t lpto)
+{
+  uint32_t regval;
+  struct qspi_xctnspec_s xctn;
+
+  /* Abort anything in-progress */
+
+  qspi_abort(priv);
+
+  /* Wait till BUSY flag reset */
+
+  qspi_waitstatusflags(priv, QSPI_SR_BUSY, 0);
+
+  /* if we want the 'low-power timeout counter' */
+
+  if (lpto > 0)
+    {
+      /* Set the Low Power Timeout value (automatically de-assert
+       * CS if memory is not accessed for a while)
+       */
+
+      qspi_putreg(priv, lpto, STM32_QUADSPI_LPTR_OFFSET);
+
+      /* Clear Timeout interrupt */
+
+      qspi_putreg(&g_qspi0dev, QSPI_FCR_CTOF, STM32_QUADSPI_FCR_OFFSET);
+
+#ifdef CONFIG_STM32H7_QSPI_INTERRUPTS
+      /* Enable Timeout interrupt */
+
+      regval  = qspi_getreg(priv, STM32_QUADSPI_CR_OFFSET);
+      regval |= (QSPI_CR_TCEN | QSPI_CR_TOIE);
+      qspi_putreg(priv, regval, STM32_QUADSPI_CR_OFFSET);
+#endif
+    }
+  else
+    {
+      regval  = qspi_getreg(priv, STM32_QUADSPI_CR_OFFSET);
+      regval &= ~QSPI_CR_TCEN;
+      qspi_putreg(priv, regval, STM32_QUADSPI_CR_OFFSET);
+    }
+
+  /* create a transaction object */
+
+  qspi_setupxctnfrommem(&xctn, meminfo);
+
+#ifdef CONFIG_STM32H7_QSPI_INTERRUPTS
+  priv->xctn = NULL;
+#endif
+
+  /* set it into the ccr */
+
+  qspi_ccrconfig(priv, &xctn, CCR_FMODE_MEMMAP);
+  priv->memmap = true;
+
+  /* we should be in memory mapped mode now */
+
+  qspi_dumpregs(priv, "After memory mapped:");
+}
+
+#ifdef CONFIG_QSPI_MEMMAP
+/****************************************************************************
+ * Name: qspi_memmap
+ *
+ * Description:
+ *   Switch the controller to memory-mapped mode, or back to indirect mode
+ *   with 'meminfo' NULL.  The caller holds the bus lock.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   meminfo - Describes the read command, or NULL to leave the mode.
+ *   base    - Location to return the address of the window, may be NULL.
+ *
+ * Returned Value:
+ *   Zero (OK)
+ *
+ ****************************************************************************/
+
+static int qspi_memmap(struct qspi_dev_s *dev,
+                       const struct qspi_meminfo_s *meminfo, void **base)
+{
+  struct stm32h7_qspidev_s *priv = (struct stm32h7_qspidev_s *)dev;
+
+  if (meminfo == NULL)
+    {
+      if (priv->memmap)
+        {
+          qspi_abort(priv);
+          priv->memmap = false;
+        }
+
+      return OK;
+    }
+
+  if (!priv->memmap)
+    {
+      qspi_memorymapped(priv, meminfo, 0);
+    }
+
+  if (base != NULL)
+    {
+      *base = (void *)STM32_FMC_BANK4;
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: qspi_hw_initialize
  *
@@ -2706,8 +2840,6 @@ void stm32h7_qspi_enter_memorymapped(struct qspi_dev_s *dev,
                                      uint32_t lpto)
 {
   struct stm32h7_qspidev_s *priv = (struct stm32h7_qspidev_s *)dev;
-  uint32_t regval;
-  struct qspi_xctnspec_s xctn;
 
   /* lock during this mode change */
 
@@ -2719,59 +2851,7 @@ void stm32h7_qspi_enter_memorymapped(struct qspi_dev_s *dev,
       return;
     }
 
-  /* Abort anything in-progress */
-
-  qspi_abort(priv);
-
-  /* Wait till BUSY flag reset */
-
-  qspi_waitstatusflags(priv, QSPI_SR_BUSY, 0);
-
-  /* if we want the 'low-power timeout counter' */
-
-  if (lpto > 0)
-    {
-      /* Set the Low Power Timeout value (automatically de-assert
-       * CS if memory is not accessed for a while)
-       */
-
-      qspi_putreg(priv, lpto, STM32_QUADSPI_LPTR_OFFSET);
-
-      /* Clear Timeout interrupt */
-
-      qspi_putreg(&g_qspi0dev, QSPI_FCR_CTOF, STM32_QUADSPI_FCR_OFFSET);
-
-#ifdef CONFIG_STM32H7_QSPI_INTERRUPTS
-      /* Enable Timeout interrupt */
-
-      regval  = qspi_getreg(priv, STM32_QUADSPI_CR_OFFSET);
-      regval |= (QSPI_CR_TCEN | QSPI_CR_TOIE);
-      qspi_putreg(priv, regval, STM32_QUADSPI_CR_OFFSET);
-#endif
-    }
-  else
-    {
-      regval  = qspi_getreg(priv, STM32_QUADSPI_CR_OFFSET);
-      regval &= ~QSPI_CR_TCEN;
-      qspi_putreg(priv, regval, STM32_QUADSPI_CR_OFFSET);
-    }
-
-  /* create a transaction object */
-
-  qspi_setupxctnfrommem(&xctn, meminfo);
-
-#ifdef CONFIG_STM32H7_QSPI_INTERRUPTS
-  priv->xctn = NULL;
-#endif
-
-  /* set it into the ccr */
-
-  qspi_ccrconfig(priv, &xctn, CCR_FMODE_MEMMAP);
-  priv->memmap = true;
-
-  /* we should be in memory mapped mode now */
-
-  qspi_dumpregs(priv, "After memory mapped:");
+  qspi_memorymapped(priv, meminfo, lpto);
 
   /* finished this mode change */
 
@@ -95,6 +95,12 @@ struct arch_addrenv_s
   /* The page directory root (ttbr0) value */
 
   uintptr_t ttbr0;
+
+  /* The ASID of the address environment and the generation it belongs to,
+   * assigned when the address environment is first selected.
+   */
+
+  uint64_t  asid;
 };
 
 typedef struct arch_addrenv_s arch_addrenv_t;
@@ -102,6 +108,47 @@ typedef struct arch_addrenv_s arch_addrenv_t;
 #endif /* __ASSEMBLY__ */
 #endif /* CONFIG_ARCH_ADDRENV */
 
+/****************************************************************************
+ * Inline functions
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+/****************************************************************************
+ * Name: up_vdso_counter
+ *
+ * Description:
+ *   Read the virtual counter.  With CONFIG_CLOCK_VDSO user mode may read it
+ *   too, see libs/libc/time/lib_clock_gettime.c.
+ *
+ ****************************************************************************/
+
+static inline uint64_t up_vdso_counter(void)
+{
+  uint64_t val;
+
+  __asm__ __volatile__("isb\n\tmrs %0, cntvct_el0" : "=r"(val) :: "memory");
+  return val;
+}
+
+/****************************************************************************
+ * Name: up_vdso_getfreq
+ *
+ * Description:
+ *   Get the frequency of up_vdso_counter() in Hz.
+ *
+ ****************************************************************************/
+
+static inline uint64_t up_vdso_getfreq(void)
+{
+  uint64_t val;
+
+  __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(val));
+  return val;
+}
+
+#endif /* __ASSEMBLY__ */
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
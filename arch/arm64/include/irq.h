@@ -423,6 +423,10 @@ static inline_function void up_set_current_regs(uint64_t *regs)
   __asm__ volatile ("msr " "tpidr_el1" ", %0" : : "r" (regs));
 }
 
+/* Return the program counter saved in an interrupted register context */
+
+#define up_getusrpc(regs) ((uintptr_t)((FAR uint64_t *)(regs))[REG_ELR])
+
 /****************************************************************************
  * Name: up_interrupt_context
  *
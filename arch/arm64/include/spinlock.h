@@ -65,6 +65,8 @@
 #define SP_WFE() __asm__ __volatile__ ("wfe" : : : "memory")
 #define SP_SEV() __asm__ __volatile__ ("sev" : : : "memory")
 
+#define up_cpu_relax() __asm__ __volatile__ ("yield" : : : "memory")
+
 #ifndef __ASSEMBLY__
 
 /* The Type of a spinlock.
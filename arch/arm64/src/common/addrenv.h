@@ -107,6 +107,30 @@ uintptr_t arm64_get_pgtable(arch_addrenv_t *addrenv, uintptr_t vaddr);
 int arm64_map_pages(arch_addrenv_t *addrenv, uintptr_t *pages,
                     unsigned int npages, uintptr_t vaddr, uint64_t prot);
 
+/****************************************************************************
+ * Name: arm64_map_block
+ *
+ * Description:
+ *   Map a large page, i.e. MM_LARGE_NPAGES physically contiguous pages,
+ *   with a single block descriptor in the level MAX_LEVELS-1 table.
+ *
+ * Input Parameters:
+ *   addrenv - Pointer to a structure describing the address environment.
+ *   paddr - The physical address of the large page, aligned to its size.
+ *   vaddr - The virtual address of the large page, aligned to its size.
+ *   prot - MMU flags to use.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EBUSY is returned if part of the
+ *   range is already mapped through a final level page table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PGALLOC_LARGE
+int arm64_map_block(arch_addrenv_t *addrenv, uintptr_t paddr,
+                    uintptr_t vaddr, uint64_t prot);
+#endif
+
 /****************************************************************************
  * Name: arm64_unmap_pages
  *
@@ -59,12 +59,16 @@
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
+#include <sched.h>
+#include <string.h>
 
 #include <nuttx/addrenv.h>
 #include <nuttx/arch.h>
 #include <nuttx/compiler.h>
 #include <nuttx/irq.h>
 #include <nuttx/pgalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 
 #include "addrenv.h"
 #include "barriers.h"
@@ -90,16 +94,172 @@
 static_assert((ARCH_ADDRENV_VBASE & MMU_L2_PAGE_SIZE) == 0,
               "Addrenv start address is not aligned to section boundary");
 
+/* The MMU is set up for 8-bit ASIDs (TCR_EL1.AS = 0).  ASID 0 is never
+ * handed out, the bits above the ASID hold the allocator generation.
+ */
+
+#define ASID_BITS           8
+#define ASID_COUNT          (1 << ASID_BITS)
+#define ASID_MASK           (ASID_COUNT - 1)
+#define ASID_GENERATION(a)  ((a) & ~(uint64_t)ASID_MASK)
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
 extern uintptr_t            g_kernel_mappings;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* ASID allocator state.  An address environment keeps its ASID for as long
+ * as the generation does not change; running out of ASIDs starts a new
+ * generation and flushes the TLB of each CPU on its next switch.
+ */
+
+static spinlock_t g_asid_lock = SP_UNLOCKED;
+static uint64_t   g_asid_generation = ASID_COUNT;
+static uint32_t   g_asid_map[ASID_COUNT / 32];
+static uint32_t   g_asid_next = 1;
+static uint64_t   g_asid_active[CONFIG_SMP_NCPUS];
+static uint64_t   g_asid_reserved[CONFIG_SMP_NCPUS];
+static cpu_set_t  g_asid_flush;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: asid_rollover
+ *
+ * Description:
+ *   Start a new ASID generation.  The ASIDs live on the CPUs stay reserved,
+ *   all the others become free, and every CPU flushes its TLB on its next
+ *   address environment switch.  Called with g_asid_lock held.
+ *
+ ****************************************************************************/
+
+static void asid_rollover(void)
+{
+  uint64_t asid;
+  int cpu;
+
+  g_asid_generation += ASID_COUNT;
+  memset(g_asid_map, 0, sizeof(g_asid_map));
+  g_asid_map[0] = 1;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      asid = g_asid_active[cpu];
+      g_asid_map[(asid & ASID_MASK) / 32] |= 1u << (asid & 31);
+      g_asid_reserved[cpu] = asid;
+      CPU_SET(cpu, &g_asid_flush);
+    }
+}
+
+/****************************************************************************
+ * Name: asid_update_reserved
+ *
+ * Description:
+ *   Move the reserved ASID of a CPU to the current generation.
+ *
+ * Returned Value:
+ *   True if asid was reserved by any CPU.
+ *
+ ****************************************************************************/
+
+static bool asid_update_reserved(uint64_t asid, uint64_t newasid)
+{
+  bool hit = false;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (g_asid_reserved[cpu] == asid)
+        {
+          g_asid_reserved[cpu] = newasid;
+          hit = true;
+        }
+    }
+
+  return hit;
+}
+
+/****************************************************************************
+ * Name: asid_find
+ *
+ * Description:
+ *   Find and claim a free ASID, starting the search at g_asid_next.
+ *
+ * Returned Value:
+ *   The ASID found, or zero if none is free.
+ *
+ ****************************************************************************/
+
+static uint32_t asid_find(void)
+{
+  uint32_t num;
+
+  for (num = g_asid_next; num < ASID_COUNT; num++)
+    {
+      if ((g_asid_map[num / 32] & (1u << (num & 31))) == 0)
+        {
+          g_asid_map[num / 32] |= 1u << (num & 31);
+          g_asid_next = num;
+          return num;
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: asid_new
+ *
+ * Description:
+ *   Give an address environment an ASID of the current generation,
+ *   keeping its previous ASID number if that is still available.  Called
+ *   with g_asid_lock held.
+ *
+ ****************************************************************************/
+
+static uint64_t asid_new(uint64_t asid)
+{
+  uint64_t newasid;
+  uint32_t num;
+
+  if (asid != 0)
+    {
+      num     = asid & ASID_MASK;
+      newasid = g_asid_generation | num;
+
+      if (asid_update_reserved(asid, newasid))
+        {
+          return newasid;
+        }
+
+      if ((g_asid_map[num / 32] & (1u << (num & 31))) == 0)
+        {
+          g_asid_map[num / 32] |= 1u << (num & 31);
+          return newasid;
+        }
+    }
+
+  num = asid_find();
+  if (num == 0)
+    {
+      /* At most one ASID per CPU survives the rollover */
+
+      asid_rollover();
+      g_asid_next = 1;
+      num = asid_find();
+      DEBUGASSERT(num != 0);
+    }
+
+  return g_asid_generation | num;
+}
+
 /****************************************************************************
  * Name: map_spgtables
  *
@@ -564,6 +724,20 @@ int up_addrenv_destroy(arch_addrenv_t *addrenv)
     {
       for (i = 0; i < ENTRIES_PER_PGT; i++, vaddr += pgsize)
         {
+#ifdef CONFIG_MM_PGALLOC_LARGE
+          if ((ptprev[i] & PTE_DESC_TYPE_MASK) == PTE_BLOCK_DESC)
+            {
+              /* A large page, there is no page table to free */
+
+              if (!vaddr_is_shm(vaddr))
+                {
+                  mm_pgfree(mmu_pte_to_paddr(ptprev[i]), MM_LARGE_NPAGES);
+                }
+
+              continue;
+            }
+#endif
+
           ptlast = (uintptr_t *)arm64_pgvaddr(mmu_pte_to_paddr(ptprev[i]));
           if (ptlast)
             {
@@ -738,8 +912,41 @@ ssize_t up_addrenv_heapsize(const arch_addrenv_t *addrenv)
 
 int up_addrenv_select(const arch_addrenv_t *addrenv)
 {
+  irqstate_t flags;
+  uint64_t asid;
+  bool flush;
+  int cpu;
+
   DEBUGASSERT(addrenv && addrenv->ttbr0);
-  mmu_write_ttbr0(addrenv->ttbr0);
+
+  flags = spin_lock_irqsave(&g_asid_lock);
+  cpu   = this_cpu();
+  asid  = addrenv->asid;
+
+  if (ASID_GENERATION(asid) != g_asid_generation)
+    {
+      /* The ASID belongs to the address environment itself, not to the
+       * caller's view of it, hence the cast.
+       */
+
+      asid = asid_new(asid);
+      ((FAR arch_addrenv_t *)addrenv)->asid = asid;
+    }
+
+  flush = CPU_ISSET(cpu, &g_asid_flush);
+  if (flush)
+    {
+      CPU_CLR(cpu, &g_asid_flush);
+    }
+
+  g_asid_active[cpu] = asid;
+
+  /* Entries tagged with other ASIDs stay in the TLB across the switch */
+
+  mmu_switch_ttbr0(addrenv->ttbr0 |
+                   ((asid & ASID_MASK) << TTBR_ASID_SHIFT), flush);
+
+  spin_unlock_irqrestore(&g_asid_lock, flags);
   return OK;
 }
 
@@ -71,6 +71,7 @@ uintptr_t up_addrenv_find_page(arch_addrenv_t *addrenv, uintptr_t vaddr)
   uintptr_t pgdir;
   uintptr_t lnvaddr;
   uintptr_t paddr;
+  uintptr_t entry;
   uint32_t  ptlevel;
 
   /* If vaddr is not user space, get out */
@@ -94,7 +95,18 @@ uintptr_t up_addrenv_find_page(arch_addrenv_t *addrenv, uintptr_t vaddr)
        ptlevel < MMU_PGT_LEVEL_MAX;
        ptlevel++)
     {
-      paddr = mmu_pte_to_paddr(mmu_ln_getentry(ptlevel, lnvaddr, vaddr));
+      entry = mmu_ln_getentry(ptlevel, lnvaddr, vaddr);
+      paddr = mmu_pte_to_paddr(entry);
+
+#ifdef CONFIG_MM_PGALLOC_LARGE
+      if ((entry & PTE_DESC_TYPE_MASK) == PTE_BLOCK_DESC)
+        {
+          /* A large page, the page is somewhere inside of it */
+
+          return paddr + MM_PGALIGNDOWN(vaddr & MM_LARGE_PGMASK);
+        }
+#endif
+
       lnvaddr = arm64_pgvaddr(paddr);
       if (!lnvaddr)
         {
@@ -115,4 +115,34 @@ int up_shmdt(uintptr_t vaddr, unsigned int npages)
   return arm64_unmap_pages(addrenv, vaddr, npages);
 }
 
+/****************************************************************************
+ * Name: up_addrenv_kpage_map
+ *
+ * Description:
+ *   Map a kernel owned page read-only into the shared memory region of an
+ *   address environment.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment.
+ *   page - The page physical address.
+ *   vaddr - The user virtual address of the page.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int up_addrenv_kpage_map(arch_addrenv_t *addrenv, uintptr_t page,
+                         uintptr_t vaddr)
+{
+  /* Sanity checks */
+
+  DEBUGASSERT(addrenv != NULL && page != 0);
+  DEBUGASSERT(vaddr >= CONFIG_ARCH_SHM_VBASE && vaddr < ARCH_SHM_VEND);
+  DEBUGASSERT(MM_ISALIGNED(vaddr));
+
+  return arm64_map_pages(addrenv, &page, 1, vaddr, MMU_URODATA_FLAGS);
+}
+
 #endif /* CONFIG_BUILD_KERNEL */
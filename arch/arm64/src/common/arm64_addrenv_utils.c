@@ -106,6 +106,52 @@ uintptr_t arm64_get_pgtable(arch_addrenv_t *addrenv, uintptr_t vaddr)
   return paddr;
 }
 
+/****************************************************************************
+ * Name: arm64_map_block
+ *
+ * Description:
+ *   Map a large page, i.e. MM_LARGE_NPAGES physically contiguous pages,
+ *   with a single block descriptor in the level MAX_LEVELS-1 table.
+ *
+ * Input Parameters:
+ *   addrenv - Pointer to a structure describing the address environment.
+ *   paddr - The physical address of the large page, aligned to its size.
+ *   vaddr - The virtual address of the large page, aligned to its size.
+ *   prot - MMU flags to use.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EBUSY is returned if part of the
+ *   range is already mapped through a final level page table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_PGALLOC_LARGE
+int arm64_map_block(arch_addrenv_t *addrenv, uintptr_t paddr,
+                    uintptr_t vaddr, uint64_t prot)
+{
+  uintptr_t ptprev;
+  uint32_t  ptlevel;
+
+  DEBUGASSERT(MM_LARGE_ISALIGNED(paddr) && MM_LARGE_ISALIGNED(vaddr));
+
+  ptlevel = MMU_PGT_LEVEL_MAX - 1;
+  ptprev  = arm64_pgvaddr(addrenv->spgtables[ptlevel]);
+  if (!ptprev)
+    {
+      return -EFAULT;
+    }
+
+  if (mmu_ln_getentry(ptlevel, ptprev, vaddr) != 0)
+    {
+      return -EBUSY;
+    }
+
+  prot = (prot & ~(uint64_t)PTE_DESC_TYPE_MASK) | PTE_BLOCK_DESC;
+  mmu_ln_setentry(ptlevel, ptprev, paddr, vaddr, prot);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: arm64_map_pages
  *
@@ -133,6 +179,9 @@ int arm64_map_pages(arch_addrenv_t *addrenv, uintptr_t *pages,
   uintptr_t ptlast;
   uintptr_t ptlevel;
   uintptr_t paddr;
+#ifdef CONFIG_MM_PGALLOC_LARGE
+  unsigned int i;
+#endif
 
   ptlevel = MMU_PGT_LEVEL_MAX;
 
@@ -140,6 +189,33 @@ int arm64_map_pages(arch_addrenv_t *addrenv, uintptr_t *pages,
 
   for (; npages > 0; npages--)
     {
+#ifdef CONFIG_MM_PGALLOC_LARGE
+      /* Map a whole large page with one block descriptor if the next pages
+       * form one.
+       */
+
+      if (npages >= MM_LARGE_NPAGES && MM_LARGE_ISALIGNED(vaddr) &&
+          MM_LARGE_ISALIGNED(pages[0]))
+        {
+          for (i = 1; i < MM_LARGE_NPAGES; i++)
+            {
+              if (pages[i] != pages[0] + (i << MM_PGSHIFT))
+                {
+                  break;
+                }
+            }
+
+          if (i == MM_LARGE_NPAGES &&
+              arm64_map_block(addrenv, pages[0], vaddr, prot) == OK)
+            {
+              pages  += MM_LARGE_NPAGES;
+              npages -= MM_LARGE_NPAGES - 1;
+              vaddr  += MM_LARGE_PGSIZE;
+              continue;
+            }
+        }
+#endif
+
       /* Get the address of the last level page table */
 
       ptlast = arm64_pgvaddr(arm64_get_pgtable(addrenv, vaddr));
@@ -183,6 +259,7 @@ int arm64_unmap_pages(arch_addrenv_t *addrenv, uintptr_t vaddr,
   uintptr_t ptprev;
   uintptr_t ptlevel;
   uintptr_t paddr;
+  uintptr_t entry;
 
   /* Get the current level MAX_LEVELS-1 entry corresponding to this vaddr */
 
@@ -201,7 +278,26 @@ int arm64_unmap_pages(arch_addrenv_t *addrenv, uintptr_t vaddr,
     {
       /* Get the current final level entry corresponding to this vaddr */
 
-      paddr = mmu_pte_to_paddr(mmu_ln_getentry(ptlevel, ptprev, vaddr));
+      entry = mmu_ln_getentry(ptlevel, ptprev, vaddr);
+
+#ifdef CONFIG_MM_PGALLOC_LARGE
+      if ((entry & PTE_DESC_TYPE_MASK) == PTE_BLOCK_DESC)
+        {
+          /* A large page goes away as a whole */
+
+          if (!MM_LARGE_ISALIGNED(vaddr) || npages < MM_LARGE_NPAGES)
+            {
+              return -EINVAL;
+            }
+
+          mmu_ln_clear(ptlevel, ptprev, vaddr);
+          npages -= MM_LARGE_NPAGES - 1;
+          vaddr  += MM_LARGE_PGSIZE;
+          continue;
+        }
+#endif
+
+      paddr = mmu_pte_to_paddr(entry);
       ptlast = arm64_pgvaddr(paddr);
       if (!ptlast)
         {
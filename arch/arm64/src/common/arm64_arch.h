@@ -221,6 +221,9 @@
 /* CPACR_EL1, Architectural Feature Access Control Register */
 #define CPACR_EL1_FPEN_NOTRAP       (0x3 << 20)
 
+/* CNTKCTL_EL1, Counter-timer Kernel Control Register */
+#define CNTKCTL_EL1_EL0VCTEN        BIT(1)
+
 /* SCR_EL3, Secure Configuration Register */
 #define SCR_NS_BIT                  BIT(0)
 #define SCR_IRQ_BIT                 BIT(1)
@@ -251,6 +254,11 @@
 #define CNTV_CTL_ENABLE_BIT         BIT(0)
 #define CNTV_CTL_IMASK_BIT          BIT(1)
 
+/* CNTP_CTL, Counter-timer Physical Timer Control register */
+
+#define CNTP_CTL_ENABLE_BIT         BIT(0)
+#define CNTP_CTL_IMASK_BIT          BIT(1)
+
 /*  Maximum numbers of translation tables
  *      This option specifies the maximum numbers of translation tables
  *  excluding the base translation table. Based on this, translation
@@ -59,6 +59,14 @@ struct arm64_oneshot_lowerhalf_s
   oneshot_callback_t callback;        /* Internal handler that receives callback */
 };
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS_PERCPU
+static uint64_t g_cpu_timer_cycle_per_tick;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -152,6 +160,40 @@ static int arm64_arch_timer_compare_isr(int irq, void *regs, void *arg)
   return OK;
 }
 
+/****************************************************************************
+ * Name: arm64_cpu_timer_isr
+ *
+ * Description:
+ *   Interrupt handler of the per-CPU physical timer.  The timer is stopped
+ *   and the scheduler started it again if the running task still has a
+ *   time slice.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS_PERCPU
+static int arm64_cpu_timer_isr(int irq, void *regs, void *arg)
+{
+  zero_sysreg(cntp_ctl_el0);
+  nxsched_cpu_timer_expiration();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: arm64_cpu_timer_enable
+ *
+ * Description:
+ *   Enable the interrupt of the per-CPU physical timer on this CPU, with
+ *   the timer itself stopped.
+ *
+ ****************************************************************************/
+
+static void arm64_cpu_timer_enable(void)
+{
+  zero_sysreg(cntp_ctl_el0);
+  up_enable_irq(ARM_ARCH_CPU_TIMER_IRQ);
+}
+#endif
+
 /****************************************************************************
  * Name: arm64_tick_max_delay
  *
@@ -381,8 +423,46 @@ void up_timer_initialize(void)
           __func__, freq / 1000000, (freq / 10000) % 100);
 
   up_alarm_set_lowerhalf(arm64_oneshot_initialize());
+
+#ifdef CONFIG_SCHED_TICKLESS_PERCPU
+  g_cpu_timer_cycle_per_tick = freq / TICK_PER_SEC;
+  irq_attach(ARM_ARCH_CPU_TIMER_IRQ, arm64_cpu_timer_isr, NULL);
+  arm64_cpu_timer_enable();
+#endif
 }
 
+#ifdef CONFIG_SCHED_TICKLESS_PERCPU
+/****************************************************************************
+ * Function:  up_cpu_timer_tick_start
+ *
+ * Description:
+ *   Start the EL1 physical timer of this CPU.  See include/nuttx/arch.h.
+ *
+ ****************************************************************************/
+
+int up_cpu_timer_tick_start(clock_t ticks)
+{
+  write_sysreg(read_sysreg(cntpct_el0) +
+               g_cpu_timer_cycle_per_tick * ticks, cntp_cval_el0);
+  write_sysreg(CNTP_CTL_ENABLE_BIT, cntp_ctl_el0);
+  return OK;
+}
+
+/****************************************************************************
+ * Function:  up_cpu_timer_tick_cancel
+ *
+ * Description:
+ *   Stop the EL1 physical timer of this CPU.  See include/nuttx/arch.h.
+ *
+ ****************************************************************************/
+
+int up_cpu_timer_tick_cancel(void)
+{
+  zero_sysreg(cntp_ctl_el0);
+  return OK;
+}
+#endif
+
 #ifdef CONFIG_SMP
 /****************************************************************************
  * Function:  arm64_arch_timer_secondary_init
@@ -417,5 +497,9 @@ void arm64_arch_timer_secondary_init()
 
   arm64_arch_timer_enable(true);
 #endif
+
+#ifdef CONFIG_SCHED_TICKLESS_PERCPU
+  arm64_cpu_timer_enable();
+#endif
 }
 #endif
\ No newline at end of file
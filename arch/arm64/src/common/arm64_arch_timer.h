@@ -40,6 +40,10 @@
 #define ARM_ARCH_TIMER_PRIO    IRQ_DEFAULT_PRIORITY
 #define ARM_ARCH_TIMER_FLAGS   IRQ_TYPE_LEVEL
 
+/* The EL1 physical timer of each CPU expires the time slices */
+
+#define ARM_ARCH_CPU_TIMER_IRQ CONFIG_ARM_TIMER_NON_SECURE_IRQ
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -191,6 +191,12 @@ void arm64_boot_el1_init(void)
 
   write_sysreg((~(uint64_t)0), cntv_cval_el0);
 
+#ifdef CONFIG_CLOCK_VDSO
+  /* Let user mode read the virtual counter for clock_gettime() */
+
+  write_sysreg(CNTKCTL_EL1_EL0VCTEN, cntkctl_el1);
+#endif
+
   /* Enable these if/when we use the corresponding timers.
    * write_cntp_cval_el0(~(uint64_t)0);
    * write_cntps_cval_el1(~(uint64_t)0);
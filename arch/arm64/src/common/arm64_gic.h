@@ -108,6 +108,7 @@
  * GIC architecture version 3 and version 4
  */
 #define GICD_TYPER_RSS              BIT(26)
+#define GICD_TYPER_NO1N             BIT(25)
 #define GICD_TYPER_LPIS             BIT(17)
 #define GICD_TYPER_MBIS             BIT(16)
 #define GICD_TYPER_ESPI             BIT(8)
@@ -256,6 +257,7 @@
 /* GITCD_IROUTER */
 #define GIC_DIST_IROUTER            0x6000
 #define IROUTER(base, n)    (base + GIC_DIST_IROUTER + (n) * 8)
+#define GICD_IROUTER_IRM            BIT(31)
 
 /* BIT(0) reserved for IRQ_ZERO_LATENCY */
 #define IRQ_TYPE_LEVEL              BIT(1)
@@ -80,6 +80,14 @@
 
 static unsigned long g_gic_rdists[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_SMP
+/* The CPUs set by up_affinity_irq() for each SPI, none if the SPI is
+ * routed to the PE on which it is enabled.
+ */
+
+static cpu_set_t g_gic_affinity[NR_IRQS];
+#endif
+
 /***************************************************************************
  * Private Functions
  ***************************************************************************/
@@ -163,6 +171,37 @@ static inline void arm64_gic_write_irouter(uint64_t val, unsigned int intid)
   putreg64(val, addr);
 }
 
+/***************************************************************************
+ * Name: arm64_gic_irq_route
+ *
+ * Description:
+ *   Route an SPI to the CPUs of its affinity:  To any of the CPUs if it is
+ *   set to all of them and the distributor supports 1 of N routing, to the
+ *   first CPU of the set otherwise.  An SPI without affinity is routed to
+ *   the current PE.
+ *
+ ***************************************************************************/
+
+static void arm64_gic_irq_route(unsigned int intid)
+{
+  uint64_t route = GET_MPIDR() & MPIDR_ID_MASK;
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset = intid < NR_IRQS ? g_gic_affinity[intid] : 0;
+
+  if (cpuset == (cpu_set_t)((1u << CONFIG_SMP_NCPUS) - 1) &&
+      (getreg32(GICD_TYPER) & GICD_TYPER_NO1N) == 0)
+    {
+      route = GICD_IROUTER_IRM;
+    }
+  else if (cpuset != 0)
+    {
+      route = arm64_get_mpid(ffs(cpuset) - 1) & MPIDR_ID_MASK;
+    }
+#endif
+
+  arm64_gic_write_irouter(route, intid);
+}
+
 void arm64_gic_irq_set_priority(unsigned int intid, unsigned int prio,
                                 uint32_t flags)
 {
@@ -251,12 +290,13 @@ void arm64_gic_irq_enable(unsigned int intid)
 
   /* Affinity routing is enabled for Non-secure state (GICD_CTLR.ARE_NS
    * is set to '1' when GIC distributor is initialized) ,so need to set
-   * SPI's affinity, now set it to be the PE on which it is enabled.
+   * SPI's affinity, to the CPUs set by up_affinity_irq() or else to
+   * the PE on which it is enabled.
    */
 
   if (GIC_IS_SPI(intid))
     {
-      arm64_gic_write_irouter((GET_MPIDR() & MPIDR_ID_MASK), intid);
+      arm64_gic_irq_route(intid);
     }
 
   putreg32(mask, ISENABLER(GET_DIST_BASE(intid), idx));
@@ -712,14 +752,14 @@ int up_prioritize_irq(int irq, int priority)
 
 void up_affinity_irq(int irq, cpu_set_t cpuset)
 {
-  if (GIC_IS_SPI(irq))
+  if (GIC_IS_SPI(irq) && irq < NR_IRQS)
     {
-      /* Only support interrupt routing mode 0,
-       * so routing to the first cpu in cpuset.
-       */
+#ifdef CONFIG_SMP
+      /* Remember the set, so that it survives up_enable_irq() */
 
-      uint64_t mpid = arm64_get_mpid(ffs(cpuset) - 1);
-      arm64_gic_write_irouter(mpid, irq);
+      g_gic_affinity[irq] = cpuset & ((1u << CONFIG_SMP_NCPUS) - 1);
+#endif
+      arm64_gic_irq_route(irq);
     }
 }
 
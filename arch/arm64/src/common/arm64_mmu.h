@@ -261,6 +261,12 @@
 
 #define MMU_UTEXT_FLAGS             (PTE_BLOCK_DESC_AP_RO | PTE_BLOCK_DESC_PXN | PTE_BLOCK_DESC_AP_USER | PTE_BLOCK_DESC_NG | MMU_MT_NORMAL_FLAGS)
 #define MMU_UDATA_FLAGS             (PTE_BLOCK_DESC_AP_RW | PTE_BLOCK_DESC_PXN | PTE_BLOCK_DESC_AP_USER | PTE_BLOCK_DESC_NG | PTE_BLOCK_DESC_UXN | MMU_MT_NORMAL_FLAGS)
+#define MMU_URODATA_FLAGS           (PTE_BLOCK_DESC_AP_RO | \
+                                     PTE_BLOCK_DESC_PXN | \
+                                     PTE_BLOCK_DESC_AP_USER | \
+                                     PTE_BLOCK_DESC_NG | \
+                                     PTE_BLOCK_DESC_UXN | \
+                                     MMU_MT_NORMAL_FLAGS)
 
 /* I/O region flags */
 
@@ -370,7 +376,8 @@ static inline uintptr_t mmu_ttbr_reg(uintptr_t pgbase, uint16_t asid)
  * Name: mmu_invalidate_tlb_by_vaddr
  *
  * Description:
- *   Flush the TLB for vaddr entry
+ *   Flush the TLB for vaddr entry.  The entries of every ASID are flushed,
+ *   as the address environments keep theirs in the TLB while switched out.
  *
  * Input Parameters:
  *   vaddr - The virtual address to flush
@@ -382,7 +389,7 @@ static inline void mmu_invalidate_tlb_by_vaddr(uintptr_t vaddr)
   __asm__ __volatile__
     (
       "dsb ishst\n"
-      "tlbi vale1is, %0\n"
+      "tlbi vaae1is, %0\n"
       "dsb ish\n"
       "isb"
       :
@@ -446,6 +453,34 @@ static inline uintptr_t mmu_read_ttbr0(void)
   return read_sysreg(ttbr0_el1);
 }
 
+/****************************************************************************
+ * Name: mmu_switch_ttbr0
+ *
+ * Description:
+ *   Write ttbr0 with a tagged (ASID) page directory root.  The TLB entries
+ *   of the other address spaces stay valid, so the local TLB is flushed
+ *   only when asked to.
+ *
+ * Input Parameters:
+ *   reg   - ttbr0 value, including the ASID
+ *   flush - Flush the local TLB after the switch
+ *
+ ****************************************************************************/
+
+static inline void mmu_switch_ttbr0(uintptr_t reg, bool flush)
+{
+  write_sysreg(reg, ttbr0_el1);
+
+  if (flush)
+    {
+      mmu_invalidate_tlbs();
+    }
+  else
+    {
+      __asm__ __volatile__ ("isb" : : : "memory");
+    }
+}
+
 /****************************************************************************
  * Name: mmu_enable
  *
@@ -96,6 +96,9 @@ uintptr_t pgalloc(uintptr_t brkaddr, unsigned int npages)
   uintptr_t              ptlevel;
   uintptr_t              paddr;
   uintptr_t              vaddr;
+#ifdef CONFIG_MM_PGALLOC_LARGE
+  unsigned int           i;
+#endif
 
   DEBUGASSERT(tcb && tcb->addrenv_own);
   addrenv = &tcb->addrenv_own->addrenv;
@@ -125,6 +128,32 @@ uintptr_t pgalloc(uintptr_t brkaddr, unsigned int npages)
 
   for (; npages > 0; npages--)
     {
+#ifdef CONFIG_MM_PGALLOC_LARGE
+      /* Grow the heap by a whole large page where one fits */
+
+      if (npages >= MM_LARGE_NPAGES && MM_LARGE_ISALIGNED(vaddr))
+        {
+          paddr = mm_pgalloc_aligned(MM_LARGE_NPAGES, MM_LARGE_NPAGES);
+          if (paddr)
+            {
+              for (i = 0; i < MM_LARGE_NPAGES; i++)
+                {
+                  arm64_pgwipe(paddr + (i << MM_PGSHIFT));
+                }
+
+              if (arm64_map_block(addrenv, paddr, vaddr,
+                                  MMU_UDATA_FLAGS) == OK)
+                {
+                  npages -= MM_LARGE_NPAGES - 1;
+                  vaddr  += MM_LARGE_PGSIZE;
+                  continue;
+                }
+
+              mm_pgfree(paddr, MM_LARGE_NPAGES);
+            }
+        }
+#endif
+
       /* Get the address of the last level page table */
 
       ptlast = arm64_pgvaddr(arm64_get_pgtable(addrenv, vaddr));
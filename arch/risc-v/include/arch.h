@@ -100,6 +100,12 @@ struct arch_addrenv_s
   /* The page directory root (satp) value */
 
   uintptr_t satp;
+
+  /* The ASID of the address environment and the generation it belongs to,
+   * assigned when the address environment is first selected.
+   */
+
+  uint64_t  asid;
 };
 
 typedef struct arch_addrenv_s arch_addrenv_t;
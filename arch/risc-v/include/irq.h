@@ -730,6 +730,10 @@ static inline_function void up_set_current_regs(uintreg_t *regs)
   g_current_regs[up_cpu_index()] = regs;
 }
 
+/* Return the program counter saved in an interrupted register context */
+
+#define up_getusrpc(regs) ((uintptr_t)((FAR uintreg_t *)(regs))[REG_EPC])
+
 /****************************************************************************
  * Name: up_irq_save
  *
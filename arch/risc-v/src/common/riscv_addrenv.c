@@ -59,12 +59,14 @@
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
+#include <string.h>
 
 #include <nuttx/addrenv.h>
 #include <nuttx/arch.h>
 #include <nuttx/compiler.h>
 #include <nuttx/irq.h>
 #include <nuttx/pgalloc.h>
+#include <nuttx/spinlock.h>
 
 #include <arch/barriers.h>
 
@@ -91,16 +93,149 @@
 static_assert((ARCH_ADDRENV_VBASE & RV_MMU_SECTION_ALIGN) == 0,
               "Addrenv start address is not aligned to section boundary");
 
+/* ASIDs are used on single hart systems only: sfence.vma does not reach
+ * the other harts, so with SMP a page table update could leave stale
+ * entries of a switched out address environment behind.  At most 256
+ * ASIDs are used, whatever the hart implements.  ASID 0 is never handed
+ * out, the bits above the ASID hold the allocator generation.
+ */
+
+#ifndef CONFIG_SMP
+#  define ASID_COUNT          256
+#  define ASID_MASK           (ASID_COUNT - 1)
+#  define ASID_GENERATION(a)  ((a) & ~(uint64_t)ASID_MASK)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
 extern uintptr_t            g_kernel_mappings;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifndef CONFIG_SMP
+static spinlock_t g_asid_lock = SP_UNLOCKED;
+static uint64_t   g_asid_generation = ASID_COUNT;
+static uint32_t   g_asid_map[ASID_COUNT / 32];
+static uint32_t   g_asid_next = 1;
+static uint32_t   g_asid_count;   /* ASIDs implemented, 0 until probed */
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifndef CONFIG_SMP
+
+/****************************************************************************
+ * Name: asid_probe
+ *
+ * Description:
+ *   Find out how many ASID bits the hart implements, by writing ones to
+ *   the satp ASID field and reading it back.  The root page table does not
+ *   change, so this needs no TLB maintenance.
+ *
+ ****************************************************************************/
+
+static void asid_probe(void)
+{
+  uintptr_t satp = mmu_read_satp();
+  uintptr_t asid;
+
+  __asm__ __volatile__
+    (
+      "csrw satp, %0\n"
+      :
+      : "r" (satp | SATP_ASID_MASK)
+      : "memory"
+    );
+
+  asid = (mmu_read_satp() & SATP_ASID_MASK) >> SATP_ASID_SHIFT;
+
+  __asm__ __volatile__
+    (
+      "csrw satp, %0\n"
+      :
+      : "r" (satp)
+      : "memory"
+    );
+
+  g_asid_count = asid + 1 < ASID_COUNT ? asid + 1 : ASID_COUNT;
+}
+
+/****************************************************************************
+ * Name: asid_find
+ *
+ * Description:
+ *   Find and claim a free ASID, starting the search at g_asid_next.
+ *
+ * Returned Value:
+ *   The ASID found, or zero if none is free.
+ *
+ ****************************************************************************/
+
+static uint32_t asid_find(void)
+{
+  uint32_t num;
+
+  for (num = g_asid_next; num < g_asid_count; num++)
+    {
+      if ((g_asid_map[num / 32] & (1u << (num & 31))) == 0)
+        {
+          g_asid_map[num / 32] |= 1u << (num & 31);
+          g_asid_next = num;
+          return num;
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: asid_new
+ *
+ * Description:
+ *   Give an address environment an ASID of the current generation,
+ *   keeping its previous ASID number if that is still available.  Running
+ *   out of ASIDs starts a new generation, which requires a TLB flush.
+ *   Called with g_asid_lock held.
+ *
+ ****************************************************************************/
+
+static uint64_t asid_new(uint64_t asid, FAR bool *flush)
+{
+  uint32_t num = asid & ASID_MASK;
+
+  if (num != 0 && (g_asid_map[num / 32] & (1u << (num & 31))) == 0)
+    {
+      g_asid_map[num / 32] |= 1u << (num & 31);
+      return g_asid_generation | num;
+    }
+
+  num = asid_find();
+  if (num == 0)
+    {
+      /* The address environment switched out keeps no ASID, as the TLB is
+       * flushed together with this switch.
+       */
+
+      g_asid_generation += ASID_COUNT;
+      memset(g_asid_map, 0, sizeof(g_asid_map));
+      g_asid_map[0] = 1;
+      g_asid_next   = 1;
+      *flush        = true;
+
+      num = asid_find();
+    }
+
+  return g_asid_generation | num;
+}
+
+#endif /* !CONFIG_SMP */
+
 /****************************************************************************
  * Name: map_spgtables
  *
@@ -718,8 +853,53 @@ ssize_t up_addrenv_heapsize(const arch_addrenv_t *addrenv)
 
 int up_addrenv_select(const arch_addrenv_t *addrenv)
 {
+#ifndef CONFIG_SMP
+  irqstate_t flags;
+  uint64_t asid;
+  bool flush = false;
+#endif
+
   DEBUGASSERT(addrenv && addrenv->satp);
+
+#ifndef CONFIG_SMP
+  flags = spin_lock_irqsave(&g_asid_lock);
+
+  if (g_asid_count == 0)
+    {
+      asid_probe();
+    }
+
+  /* Too few ASIDs to bother, switch with a full flush */
+
+  if (g_asid_count < 2)
+    {
+      spin_unlock_irqrestore(&g_asid_lock, flags);
+      mmu_write_satp(addrenv->satp);
+      return OK;
+    }
+
+  asid = addrenv->asid;
+  if (ASID_GENERATION(asid) != g_asid_generation)
+    {
+      /* The ASID belongs to the address environment itself, not to the
+       * caller's view of it, hence the cast.
+       */
+
+      asid = asid_new(asid, &flush);
+      ((FAR arch_addrenv_t *)addrenv)->asid = asid;
+    }
+
+  /* Entries tagged with other ASIDs stay in the TLB across the switch */
+
+  mmu_switch_satp(addrenv->satp |
+                  (((uintptr_t)asid << SATP_ASID_SHIFT) & SATP_ASID_MASK),
+                  flush);
+
+  spin_unlock_irqrestore(&g_asid_lock, flags);
+#else
   mmu_write_satp(addrenv->satp);
+#endif
+
   return OK;
 }
 
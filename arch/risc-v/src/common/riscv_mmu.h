@@ -21,6 +21,13 @@
 #ifndef ___ARCH_RISC_V_SRC_COMMON_RISCV_MMU_H_
 #define ___ARCH_RISC_V_SRC_COMMON_RISCV_MMU_H_
 
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -236,6 +243,52 @@ static inline void mmu_write_satp(uintptr_t reg)
     }
 }
 
+/****************************************************************************
+ * Name: mmu_switch_satp
+ *
+ * Description:
+ *   Write satp with a tagged (ASID) page directory root.  The TLB entries
+ *   of the other address spaces stay valid, so the TLB is flushed only when
+ *   asked to.
+ *
+ * Input Parameters:
+ *   reg   - satp value, including the ASID
+ *   flush - Flush the TLB after the switch
+ *
+ ****************************************************************************/
+
+static inline void mmu_switch_satp(uintptr_t reg, bool flush)
+{
+  __asm__ __volatile__
+    (
+      "csrw satp, %0\n"
+      :
+      : "rK" (reg)
+      : "memory"
+    );
+
+  if (flush)
+    {
+      __asm__ __volatile__ ("sfence.vma x0, x0\n" : : : "memory");
+    }
+
+  __asm__ __volatile__
+    (
+      "fence rw, rw\n"
+      "fence.i\n"
+      :
+      :
+      : "memory"
+    );
+
+  /* Flush the MMU Cache if needed (T-Head C906) */
+
+  if (mmu_flush_cache != NULL)
+    {
+      mmu_flush_cache(reg);
+    }
+}
+
 /****************************************************************************
  * Name: mmu_read_satp
  *
@@ -266,7 +319,8 @@ static inline uintptr_t mmu_read_satp(void)
  * Name: mmu_invalidate_tlb_by_vaddr
  *
  * Description:
- *   Flush the TLB for vaddr entry
+ *   Flush the TLB for vaddr entry.  The entries of every ASID are flushed,
+ *   as the address environments keep theirs in the TLB while switched out.
  *
  * Input Parameters:
  *   vaddr - The virtual address to flush
@@ -277,7 +331,7 @@ static inline void mmu_invalidate_tlb_by_vaddr(uintptr_t vaddr)
 {
   __asm__ __volatile__
     (
-      "sfence.vma x0, %0\n"
+      "sfence.vma %0, x0\n"
       :
       : "rK" (vaddr)
       : "memory"
@@ -46,4 +46,21 @@
 #  define QEMU_RV_PLIC_CLAIM     (QEMU_RV_PLIC_BASE + 0x200004)
 #endif
 
+/* The registers of the context of a hart, that has one context for each
+ * of the M and S modes.
+ */
+
+#ifdef CONFIG_ARCH_USE_S_MODE
+#  define QEMU_RV_PLIC_CTX(hart)  (2 * (hart) + 1)
+#else
+#  define QEMU_RV_PLIC_CTX(hart)  (2 * (hart))
+#endif
+
+#define QEMU_RV_PLIC_HART_ENABLE1(hart) \
+  (QEMU_RV_PLIC_BASE + 0x002000 + 0x80 * QEMU_RV_PLIC_CTX(hart))
+#define QEMU_RV_PLIC_HART_THRESHOLD(hart) \
+  (QEMU_RV_PLIC_BASE + 0x200000 + 0x1000 * QEMU_RV_PLIC_CTX(hart))
+#define QEMU_RV_PLIC_HART_CLAIM(hart) \
+  (QEMU_RV_PLIC_HART_THRESHOLD(hart) + 4)
+
 #endif /* __ARCH_RISCV_SRC_QEMU_RV_HARDWARE_QEMU_RV_PLIC_H */
@@ -41,10 +41,76 @@
 #include "qemu_rv_rptun.h"
 #endif
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP) && !defined(CONFIG_ARCH_RV_HAVE_APLIC)
+#  define QEMU_RV_PLIC_PERHART 1
+#  define QEMU_RV_CPU_HART(cpu) ((cpu) + CONFIG_ARCH_RV_HARTID_BASE)
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef QEMU_RV_PLIC_PERHART
+/* The harts of each external interrupt, CPU0 unless up_affinity_irq()
+ * set it otherwise, and whether it is enabled.
+ */
+
+static cpu_set_t g_plic_affinity[64];
+static uint64_t g_plic_enabled;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef QEMU_RV_PLIC_PERHART
+/****************************************************************************
+ * Name: qemu_rv_plic_route
+ *
+ * Description:
+ *   Set the enable bit of an external interrupt in the context of each
+ *   hart of its affinity and clear it in the others.  The PLIC gives an
+ *   interrupt that is enabled in several contexts to the first hart that
+ *   claims it.
+ *
+ ****************************************************************************/
+
+static void qemu_rv_plic_route(int extirq)
+{
+  cpu_set_t cpuset = g_plic_affinity[extirq];
+  uint32_t bit = 1 << (extirq % 32);
+  uintptr_t offset = 4 * (extirq / 32);
+  int cpu;
+
+  if ((g_plic_enabled & ((uint64_t)1 << extirq)) == 0)
+    {
+      cpuset = 0;
+    }
+  else if (cpuset == 0)
+    {
+      cpuset = 1;
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      uintptr_t enable = QEMU_RV_PLIC_HART_ENABLE1(QEMU_RV_CPU_HART(cpu));
+
+      if ((cpuset & (1 << cpu)) != 0)
+        {
+          modifyreg32(enable + offset, 0, bit);
+        }
+      else
+        {
+          modifyreg32(enable + offset, bit, 0);
+        }
+    }
+}
+#endif
+
 #ifdef CONFIG_RPTUN
 static int qemu_ipi_handler(int mcause, void *regs, void *args)
 {
@@ -77,7 +143,15 @@ void up_irqinitialize(void)
 
   /* Disable all global interrupts */
 
-#ifndef CONFIG_ARCH_RV_HAVE_APLIC
+#ifdef QEMU_RV_PLIC_PERHART
+  for (int cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      uintptr_t enable = QEMU_RV_PLIC_HART_ENABLE1(QEMU_RV_CPU_HART(cpu));
+
+      putreg32(0x0, enable);
+      putreg32(0x0, enable + 4);
+    }
+#elif !defined(CONFIG_ARCH_RV_HAVE_APLIC)
   putreg32(0x0, QEMU_RV_PLIC_ENABLE1);
   putreg32(0x0, QEMU_RV_PLIC_ENABLE2);
 #else
@@ -123,7 +197,14 @@ void up_irqinitialize(void)
 
   /* Set irq threshold to 0 (permits all global interrupts) */
 
+#ifdef QEMU_RV_PLIC_PERHART
+  for (id = 0; id < CONFIG_SMP_NCPUS; id++)
+    {
+      putreg32(0, QEMU_RV_PLIC_HART_THRESHOLD(QEMU_RV_CPU_HART(id)));
+    }
+#else
   putreg32(0, QEMU_RV_PLIC_THRESHOLD);
+#endif
 #endif
 
   /* Attach the common interrupt handler */
@@ -206,7 +287,10 @@ void up_disable_irq(int irq)
 
       if (0 <= extirq && extirq <= 63)
         {
-#ifndef CONFIG_ARCH_RV_HAVE_APLIC
+#ifdef QEMU_RV_PLIC_PERHART
+          g_plic_enabled &= ~((uint64_t)1 << extirq);
+          qemu_rv_plic_route(extirq);
+#elif !defined(CONFIG_ARCH_RV_HAVE_APLIC)
           modifyreg32(QEMU_RV_PLIC_ENABLE1 + (4 * (extirq / 32)),
                       1 << (extirq % 32), 0);
 #else
@@ -273,7 +357,10 @@ void up_enable_irq(int irq)
 
       if (0 <= extirq && extirq <= 63)
         {
-#ifndef CONFIG_ARCH_RV_HAVE_APLIC
+#ifdef QEMU_RV_PLIC_PERHART
+          g_plic_enabled |= (uint64_t)1 << extirq;
+          qemu_rv_plic_route(extirq);
+#elif !defined(CONFIG_ARCH_RV_HAVE_APLIC)
           modifyreg32(QEMU_RV_PLIC_ENABLE1 + (4 * (extirq / 32)),
                       0, 1 << (extirq % 32));
 #else
@@ -293,6 +380,30 @@ void up_enable_irq(int irq)
     }
 }
 
+#ifdef QEMU_RV_PLIC_PERHART
+/****************************************************************************
+ * Name: up_affinity_irq
+ *
+ * Description:
+ *   Route the IRQ specified by 'irq' to the harts of 'cpuset'.
+ *
+ ****************************************************************************/
+
+void up_affinity_irq(int irq, cpu_set_t cpuset)
+{
+  int extirq = irq - RISCV_IRQ_EXT;
+  irqstate_t flags;
+
+  if (extirq > 0 && extirq <= 63)
+    {
+      flags = up_irq_save();
+      g_plic_affinity[extirq] = cpuset & ((1u << CONFIG_SMP_NCPUS) - 1);
+      qemu_rv_plic_route(extirq);
+      up_irq_restore(flags);
+    }
+}
+#endif
+
 irqstate_t up_irq_enable(void)
 {
   irqstate_t oldstat;
@@ -73,6 +73,22 @@ static void *riscv_dispatch_irq_ext(uintreg_t irq, uintreg_t *regs)
 
   return regs;
 }
+#elif defined(CONFIG_SMP)
+static void *riscv_dispatch_irq_ext(uintreg_t irq, uintreg_t *regs)
+{
+  uintptr_t claim = QEMU_RV_PLIC_HART_CLAIM(riscv_mhartid());
+  int extirq;
+
+  /* Each hart claims the interrupts routed to its own context */
+
+  while ((extirq = getreg32(claim)) != 0)
+    {
+      regs = riscv_doirq(irq + extirq, regs);
+      putreg32(extirq, claim);
+    }
+
+  return regs;
+}
 #else
 static void *riscv_dispatch_irq_ext(uintreg_t irq, uintreg_t *regs)
 {
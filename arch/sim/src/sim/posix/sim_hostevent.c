@@ -0,0 +1,344 @@
+/****************************************************************************
+ * arch/sim/src/sim/posix/sim_hostevent.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+
+#include "sim_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HOST_EVENT_NFDS 8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A host file descriptor watched on behalf of a simulated device.  The
+ * entry is shared between the event thread and the simulation without a
+ * lock: the simulation may touch it from its interrupt handler, which
+ * could interrupt a holder of any host mutex.
+ */
+
+struct host_event_s
+{
+  atomic_int fd;                 /* Host file descriptor, -1 if unused */
+  atomic_bool armed;             /* Wait for input on fd */
+  atomic_bool pending;           /* Input seen, not reported yet */
+  void *arg;                     /* Returned by host_event_pending */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct host_event_s g_host_event[HOST_EVENT_NFDS];
+static pthread_t g_host_event_cpu;
+static pthread_t g_host_event_thread;
+static int g_host_event_pipe[2] =
+{
+  -1, -1
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: host_event_wakeup
+ *
+ * Description:
+ *   Make the event thread rebuild its set of file descriptors.
+ *
+ ****************************************************************************/
+
+static void host_event_wakeup(void)
+{
+  char c = 0;
+
+  while (write(g_host_event_pipe[1], &c, 1) < 0 && errno == EINTR);
+}
+
+/****************************************************************************
+ * Name: host_event_thread
+ *
+ * Description:
+ *   Sleep in poll() until an armed file descriptor becomes readable, then
+ *   disarm it and interrupt CPU0.  The file descriptor stays disarmed until
+ *   the device has consumed the input, so input that is not read at once
+ *   raises one interrupt only.
+ *
+ ****************************************************************************/
+
+static void *host_event_thread(void *arg)
+{
+  struct pollfd pfds[HOST_EVENT_NFDS + 1];
+  int index[HOST_EVENT_NFDS + 1];
+  char buf[16];
+  bool raise;
+  int nfds;
+  int fd;
+  int i;
+
+  for (; ; )
+    {
+      pfds[0].fd     = g_host_event_pipe[0];
+      pfds[0].events = POLLIN;
+      nfds           = 1;
+
+      for (i = 0; i < HOST_EVENT_NFDS; i++)
+        {
+          fd = atomic_load(&g_host_event[i].fd);
+          if (fd >= 0 && atomic_load(&g_host_event[i].armed))
+            {
+              pfds[nfds].fd     = fd;
+              pfds[nfds].events = POLLIN;
+              index[nfds++]     = i;
+            }
+        }
+
+      if (poll(pfds, nfds, -1) < 0)
+        {
+          continue;
+        }
+
+      if (pfds[0].revents != 0)
+        {
+          while (read(g_host_event_pipe[0], buf, sizeof(buf)) > 0);
+        }
+
+      raise = false;
+
+      for (i = 1; i < nfds; i++)
+        {
+          if ((pfds[i].revents & (POLLIN | POLLHUP | POLLERR)) != 0 &&
+              atomic_exchange(&g_host_event[index[i]].armed, false))
+            {
+              atomic_store(&g_host_event[index[i]].pending, true);
+              raise = true;
+            }
+        }
+
+      if (raise)
+        {
+          pthread_kill(g_host_event_cpu, host_event_irq());
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: host_event_initialize
+ *
+ * Description:
+ *   Start the thread that watches the host file descriptors.  The
+ *   interrupts are delivered to the calling thread, which must be CPU0.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int host_event_initialize(void)
+{
+  sigset_t set;
+  sigset_t oset;
+  int ret;
+  int i;
+
+  for (i = 0; i < HOST_EVENT_NFDS; i++)
+    {
+      atomic_init(&g_host_event[i].fd, -1);
+      atomic_init(&g_host_event[i].armed, false);
+      atomic_init(&g_host_event[i].pending, false);
+    }
+
+  if (pipe(g_host_event_pipe) < 0)
+    {
+      return -errno;
+    }
+
+  fcntl(g_host_event_pipe[0], F_SETFL, O_NONBLOCK);
+  fcntl(g_host_event_pipe[1], F_SETFL, O_NONBLOCK);
+
+  g_host_event_cpu = pthread_self();
+
+  /* The event thread must never run the simulation's signal handlers */
+
+  sigfillset(&set);
+  pthread_sigmask(SIG_SETMASK, &set, &oset);
+  ret = pthread_create(&g_host_event_thread, NULL, host_event_thread, NULL);
+  pthread_sigmask(SIG_SETMASK, &oset, NULL);
+
+  if (ret != 0)
+    {
+      close(g_host_event_pipe[0]);
+      close(g_host_event_pipe[1]);
+      g_host_event_pipe[0] = -1;
+      g_host_event_pipe[1] = -1;
+      return -ret;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: host_event_irq
+ *
+ * Description:
+ *   Get the interrupt raised when an armed file descriptor has input.
+ *
+ ****************************************************************************/
+
+int host_event_irq(void)
+{
+  return SIGIO;
+}
+
+/****************************************************************************
+ * Name: host_event_add
+ *
+ * Description:
+ *   Watch fd on behalf of a device.  arg is what host_event_pending()
+ *   returns for it.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int host_event_add(int fd, void *arg)
+{
+  int i;
+
+  if (g_host_event_pipe[1] < 0)
+    {
+      return -ENODEV;
+    }
+
+  for (i = 0; i < HOST_EVENT_NFDS; i++)
+    {
+      if (atomic_load(&g_host_event[i].fd) < 0)
+        {
+          g_host_event[i].arg = arg;
+          atomic_store(&g_host_event[i].pending, false);
+          atomic_store(&g_host_event[i].armed, false);
+          atomic_store(&g_host_event[i].fd, fd);
+          return 0;
+        }
+    }
+
+  return -ENOSPC;
+}
+
+/****************************************************************************
+ * Name: host_event_remove
+ *
+ * Description:
+ *   Stop watching fd.  This must happen before fd is closed.
+ *
+ ****************************************************************************/
+
+void host_event_remove(int fd)
+{
+  int i;
+
+  for (i = 0; i < HOST_EVENT_NFDS; i++)
+    {
+      if (atomic_load(&g_host_event[i].fd) == fd)
+        {
+          atomic_store(&g_host_event[i].armed, false);
+          atomic_store(&g_host_event[i].pending, false);
+          atomic_store(&g_host_event[i].fd, -1);
+          host_event_wakeup();
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: host_event_arm
+ *
+ * Description:
+ *   Raise the interrupt once the next time fd has input.
+ *
+ ****************************************************************************/
+
+void host_event_arm(int fd)
+{
+  int i;
+
+  for (i = 0; i < HOST_EVENT_NFDS; i++)
+    {
+      if (atomic_load(&g_host_event[i].fd) == fd)
+        {
+          if (!atomic_exchange(&g_host_event[i].armed, true))
+            {
+              host_event_wakeup();
+            }
+
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: host_event_pending
+ *
+ * Description:
+ *   Called from the interrupt handler to get the devices with input.
+ *
+ * Returned Value:
+ *   The arg of a file descriptor with input, each one is reported once;
+ *   NULL when there are no more.
+ *
+ ****************************************************************************/
+
+void *host_event_pending(void)
+{
+  int i;
+
+  for (i = 0; i < HOST_EVENT_NFDS; i++)
+    {
+      if (atomic_exchange(&g_host_event[i].pending, false))
+        {
+          return g_host_event[i].arg;
+        }
+    }
+
+  return NULL;
+}
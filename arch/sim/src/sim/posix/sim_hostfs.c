@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/statvfs.h>
 #include <sys/ioctl.h>
@@ -399,6 +400,34 @@ int host_ftruncate(int fd, nuttx_off_t length)
   return ret;
 }
 
+#ifdef CONFIG_FS_HOSTFS_MMAP
+/****************************************************************************
+ * Name: host_mmap
+ ****************************************************************************/
+
+void *host_mmap(int fd, nuttx_size_t length)
+{
+  void *addr = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+
+  return addr == MAP_FAILED ? NULL : addr;
+}
+
+/****************************************************************************
+ * Name: host_munmap
+ ****************************************************************************/
+
+int host_munmap(void *addr, nuttx_size_t length)
+{
+  int ret = munmap(addr, length);
+  if (ret < 0)
+    {
+      ret = -errno;
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: host_opendir
  ****************************************************************************/
@@ -272,6 +272,17 @@ void sim_timer_update(void);
 
 void sim_uartinit(void);
 
+/* sim_hostevent.c **********************************************************/
+
+#ifdef CONFIG_SIM_HOSTEVENT
+int  host_event_initialize(void);
+int  host_event_irq(void);
+int  host_event_add(int fd, void *arg);
+void host_event_remove(int fd);
+void host_event_arm(int fd);
+void *host_event_pending(void);
+#endif
+
 /* sim_hostuart.c ***********************************************************/
 
 void host_uart_start(void);
@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/irq.h>
 #include <nuttx/serial/serial.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/serial/uart_ram.h>
@@ -68,6 +69,12 @@ struct tty_priv_s
 
   bool          rxint;
 
+#ifdef CONFIG_SIM_HOSTEVENT
+  /* The host raises an interrupt on input or not */
+
+  bool          event;
+#endif
+
   /* Work queue for transmit */
 
   struct work_s worker;
@@ -333,6 +340,14 @@ static void tty_shutdown(struct uart_dev_s *dev)
 
 static int tty_attach(struct uart_dev_s *dev)
 {
+#ifdef CONFIG_SIM_HOSTEVENT
+  struct tty_priv_s *priv = dev->priv;
+
+  /* Without the host events the input is polled */
+
+  priv->event = host_event_add(priv->fd, dev) >= 0;
+#endif
+
   return OK;
 }
 
@@ -348,6 +363,15 @@ static int tty_attach(struct uart_dev_s *dev)
 
 static void tty_detach(struct uart_dev_s *dev)
 {
+#ifdef CONFIG_SIM_HOSTEVENT
+  struct tty_priv_s *priv = dev->priv;
+
+  if (priv->event)
+    {
+      host_event_remove(priv->fd);
+      priv->event = false;
+    }
+#endif
 }
 
 /****************************************************************************
@@ -441,10 +465,52 @@ static void tty_work(void *arg)
 #endif
     }
 
+#ifdef CONFIG_SIM_HOSTEVENT
+  /* Sleep until the host has more input.  Keep polling only while a
+   * writer waits for room on the host side, or while input is left that
+   * did not fit into the RX buffer.
+   */
+
+  if (priv->event && !priv->txint &&
+      !(priv->rxint && host_uart_checkin(priv->fd)))
+    {
+      if (priv->rxint)
+        {
+          host_event_arm(priv->fd);
+        }
+
+      return;
+    }
+#endif
+
   work_queue(HPWORK, &priv->worker,
              tty_work, dev, SIM_UART_WORK_DELAY);
 }
 
+#ifdef CONFIG_SIM_HOSTEVENT
+/****************************************************************************
+ * Name: tty_interrupt
+ *
+ * Description:
+ *   The host has input for some of the ports
+ *
+ ****************************************************************************/
+
+static int tty_interrupt(int irq, void *context, void *arg)
+{
+  struct uart_dev_s *dev;
+  struct tty_priv_s *priv;
+
+  while ((dev = host_event_pending()) != NULL)
+    {
+      priv = dev->priv;
+      work_queue(HPWORK, &priv->worker, tty_work, dev, 0);
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: tty_rxint
  *
@@ -693,6 +759,15 @@ static int sim_uartram_register(const char *devname, bool slave)
 
 void sim_uartinit(void)
 {
+#if defined(CONFIG_SIM_HOSTEVENT) && \
+    (defined(USE_DEVCONSOLE) || CONFIG_SIM_UART_NUMBER > 0)
+  if (host_event_initialize() >= 0)
+    {
+      irq_attach(host_event_irq(), tty_interrupt, NULL);
+      up_enable_irq(host_event_irq());
+    }
+#endif
+
 #ifdef CONFIG_SIM_RAM_UART0
 #  ifdef CONFIG_SIM_RAM_UART0_SLAVE
   sim_uartram_register("/dev/ttyVS0", true);
@@ -58,6 +58,8 @@
 #define SP_DSB() __asm__ __volatile__ ("mfence")
 #define SP_DMB() __asm__ __volatile__ ("mfence")
 
+#define up_cpu_relax() __asm__ __volatile__ ("pause" : : : "memory")
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -34,6 +34,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
@@ -78,6 +79,19 @@ struct audio_upperhalf_s
   mutex_t           lock;             /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   struct file      *usermq;           /* User mode app's message queue */
+#ifdef CONFIG_AUDIO_RING
+  bool              playback;         /* True: configured for output */
+  bool              rrun;             /* True: ring periods are queued */
+  uint8_t           nperiods;         /* Number of periods in the ring */
+  uint8_t           rqidx;            /* Next period to queue */
+  uint32_t          rqueued;          /* Ring position queued to the device */
+  FAR struct audio_ring_s *ring;      /* Ring status, NULL without a ring */
+  FAR struct ap_buffer_s **rapb;      /* The buffer of each period */
+  FAR uint8_t     **rsamp;            /* Sample pointers replaced in rapb[] */
+  FAR uint8_t      *rbase;            /* Start of the sample ring */
+  FAR uint8_t      *ralloc;           /* Ring memory, if not the buffers' own */
+  FAR struct pollfd *fds[CONFIG_AUDIO_RING_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -95,6 +109,15 @@ static ssize_t  audio_write(FAR struct file *filep,
 static int      audio_ioctl(FAR struct file *filep,
                             int cmd,
                             unsigned long arg);
+#ifdef CONFIG_AUDIO_RING
+static void     audio_ring_free(FAR struct audio_upperhalf_s *upper);
+static void     audio_ring_stop(FAR struct audio_upperhalf_s *upper);
+static int      audio_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+static int      audio_poll(FAR struct file *filep,
+                           FAR struct pollfd *fds,
+                           bool setup);
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 static int      audio_start(FAR struct audio_upperhalf_s *upper,
                             FAR void *session);
@@ -123,6 +146,11 @@ static const struct file_operations g_audioops =
   audio_write, /* write */
   NULL,        /* seek */
   audio_ioctl, /* ioctl */
+#ifdef CONFIG_AUDIO_RING
+  audio_mmap,  /* mmap */
+  NULL,        /* truncate */
+  audio_poll,  /* poll */
+#endif
 };
 
 /****************************************************************************
@@ -225,8 +253,19 @@ static int audio_close(FAR struct file *filep)
       DEBUGASSERT(lower->ops->shutdown != NULL);
       audinfo("calling shutdown\n");
 
+#ifdef CONFIG_AUDIO_RING
+      audio_ring_stop(upper);
+#endif
+
       lower->ops->shutdown(lower);
       upper->usermq = NULL;
+
+#ifdef CONFIG_AUDIO_RING
+      if (upper->ring != NULL)
+        {
+          audio_ring_free(upper);
+        }
+#endif
     }
 
   ret = OK;
@@ -292,6 +331,432 @@ static ssize_t audio_write(FAR struct file *filep,
   return 0;
 }
 
+/****************************************************************************
+ * Name: audio_ring_diff
+ *
+ * Description:
+ *   Return the distance from ring position 'b' to ring position 'a'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_RING
+static inline uint32_t audio_ring_diff(FAR struct audio_ring_s *ring,
+                                       uint32_t a, uint32_t b)
+{
+  return (a % ring->boundary + ring->boundary - b % ring->boundary) %
+         ring->boundary;
+}
+
+/****************************************************************************
+ * Name: audio_ring_avail
+ *
+ * Description:
+ *   Return the number of bytes that the application may write (playback)
+ *   or read (capture).
+ *
+ ****************************************************************************/
+
+static uint32_t audio_ring_avail(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_ring_s *ring = upper->ring;
+  uint32_t used;
+
+  if (ring == NULL)
+    {
+      return 0;
+    }
+
+  if (upper->playback)
+    {
+      used = audio_ring_diff(ring, ring->applptr, ring->hwptr);
+      return used < ring->size ? ring->size - used : 0;
+    }
+
+  return audio_ring_diff(ring, ring->hwptr, ring->applptr);
+}
+
+/****************************************************************************
+ * Name: audio_ring_free
+ *
+ * Description:
+ *   Release the sample ring and the buffers of its periods.
+ *
+ ****************************************************************************/
+
+static void audio_ring_free(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  struct audio_buf_desc_s bufdesc;
+  int i;
+
+  for (i = 0; i < upper->nperiods; i++)
+    {
+      if (upper->rapb[i] == NULL)
+        {
+          continue;
+        }
+
+      if (upper->ralloc != NULL)
+        {
+          upper->rapb[i]->samp = upper->rsamp[i];
+        }
+
+      memset(&bufdesc, 0, sizeof(bufdesc));
+      bufdesc.u.buffer = upper->rapb[i];
+      if (lower->ops->freebuffer)
+        {
+          lower->ops->freebuffer(lower, &bufdesc);
+        }
+      else
+        {
+          apb_free(upper->rapb[i]);
+        }
+    }
+
+  kmm_free(upper->rapb);
+  kumm_free(upper->ralloc);
+  kumm_free(upper->ring);
+
+  upper->rapb     = NULL;
+  upper->ralloc   = NULL;
+  upper->ring     = NULL;
+  upper->nperiods = 0;
+}
+
+/****************************************************************************
+ * Name: audio_ring_alloc
+ *
+ * Description:
+ *   Set up the sample ring with one buffer of the lower half per period.
+ *   If the lower half allocates its buffers back to back (as the DMA ring
+ *   of audio_dma does), they are the ring and the samples are never
+ *   copied.  Otherwise the buffers are pointed into a ring allocated here.
+ *
+ ****************************************************************************/
+
+static int audio_ring_alloc(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  struct audio_buf_desc_s bufdesc;
+  struct ap_buffer_info_s info;
+  bool contiguous = true;
+  uint32_t size;
+  int ret;
+  int i;
+
+  info.nbuffers    = CONFIG_AUDIO_NUM_BUFFERS;
+  info.buffer_size = CONFIG_AUDIO_BUFFER_NUMBYTES;
+  if (lower->ops->ioctl != NULL)
+    {
+      lower->ops->ioctl(lower, AUDIOIOC_GETBUFFERINFO,
+                        (unsigned long)((uintptr_t)&info));
+    }
+
+  size = info.nbuffers * info.buffer_size;
+  if (info.nbuffers < 2 || info.nbuffers > UINT8_MAX ||
+      info.buffer_size == 0 || size > 0x40000000)
+    {
+      return -EINVAL;
+    }
+
+  upper->rapb = kmm_zalloc(info.nbuffers * (sizeof(FAR void *) +
+                                            sizeof(FAR uint8_t *)));
+  if (upper->rapb == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->rsamp    = (FAR uint8_t **)&upper->rapb[info.nbuffers];
+  upper->nperiods = info.nbuffers;
+
+  for (i = 0; i < upper->nperiods; i++)
+    {
+      memset(&bufdesc, 0, sizeof(bufdesc));
+      bufdesc.numbytes  = info.buffer_size;
+      bufdesc.u.pbuffer = &upper->rapb[i];
+
+      if (lower->ops->allocbuffer)
+        {
+          ret = lower->ops->allocbuffer(lower, &bufdesc);
+        }
+      else
+        {
+          ret = apb_alloc(&bufdesc);
+        }
+
+      if (ret < 0)
+        {
+          upper->rapb[i] = NULL;
+          goto errout;
+        }
+
+      if (upper->rapb[i]->samp !=
+          upper->rapb[0]->samp + i * info.buffer_size)
+        {
+          contiguous = false;
+        }
+    }
+
+  if (contiguous)
+    {
+      upper->rbase = upper->rapb[0]->samp;
+    }
+  else
+    {
+      upper->ralloc = kumm_memalign(32, size);
+      if (upper->ralloc == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      for (i = 0; i < upper->nperiods; i++)
+        {
+          upper->rsamp[i]      = upper->rapb[i]->samp;
+          upper->rapb[i]->samp = upper->ralloc + i * info.buffer_size;
+        }
+
+      upper->rbase = upper->ralloc;
+    }
+
+  upper->ring = kumm_zalloc(sizeof(struct audio_ring_s));
+  if (upper->ring == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  upper->ring->size     = size;
+  upper->ring->period   = info.buffer_size;
+  upper->ring->boundary = size * (0x40000000 / size);
+  upper->rqueued        = 0;
+  upper->rqidx          = 0;
+  return OK;
+
+errout:
+  audio_ring_free(upper);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_ring_fill
+ *
+ * Description:
+ *   Queue the periods that the device may process to the lower half:  the
+ *   written ones for playback, all the free ones for capture.  Called
+ *   with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void audio_ring_fill(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  FAR struct audio_ring_s *ring = upper->ring;
+  FAR struct ap_buffer_s *apb;
+
+  while (upper->rrun &&
+         audio_ring_diff(ring, upper->rqueued, ring->hwptr) < ring->size &&
+         (!upper->playback ||
+          audio_ring_diff(ring, ring->applptr, upper->rqueued) >=
+          ring->period))
+    {
+      apb          = upper->rapb[upper->rqidx];
+      apb->nbytes  = ring->period;
+      apb->curbyte = 0;
+      apb->flags   = 0;
+
+      if (lower->ops->enqueuebuffer(lower, apb) < 0)
+        {
+          break;
+        }
+
+      upper->rqidx   = (upper->rqidx + 1) % upper->nperiods;
+      upper->rqueued = (upper->rqueued + ring->period) % ring->boundary;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_ring_period
+ *
+ * Description:
+ *   A period of the ring was played or captured:  advance the device
+ *   position, queue the period again if it may be and wake up the waiters.
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void audio_ring_period(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_ring_s *ring = upper->ring;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (!upper->rrun)
+    {
+      leave_critical_section(flags);
+      return;
+    }
+
+  ring->hwptr = (ring->hwptr + ring->period) % ring->boundary;
+
+  /* Capture overruns when the device overwrites unread samples */
+
+  if (!upper->playback &&
+      audio_ring_diff(ring, ring->hwptr, ring->applptr) > ring->size)
+    {
+      ring->xruns++;
+    }
+
+  audio_ring_fill(upper);
+
+  /* Playback underruns when the device has nothing left to play */
+
+  if (upper->playback && upper->rqueued == ring->hwptr)
+    {
+      ring->xruns++;
+    }
+
+  leave_critical_section(flags);
+
+  poll_notify(upper->fds, CONFIG_AUDIO_RING_NPOLLWAITERS,
+              upper->playback ? POLLOUT : POLLIN);
+}
+
+/****************************************************************************
+ * Name: audio_ring_stop
+ *
+ * Description:
+ *   Stop queueing ring periods and rewind the ring.
+ *
+ ****************************************************************************/
+
+static void audio_ring_stop(FAR struct audio_upperhalf_s *upper)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  upper->rrun = false;
+  if (upper->ring != NULL)
+    {
+      upper->ring->hwptr   = 0;
+      upper->ring->applptr = 0;
+      upper->rqueued       = 0;
+      upper->rqidx         = 0;
+    }
+
+  leave_critical_section(flags);
+}
+#endif /* CONFIG_AUDIO_RING */
+
+/****************************************************************************
+ * Name: audio_mmap
+ *
+ * Description:
+ *   Map the sample ring (offset zero) or its status (offset
+ *   AUDIO_RING_MMAP_STATUS), setting up the ring on first use.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_RING
+static int audio_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&upper->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (upper->ring == NULL)
+    {
+      ret = upper->started ? -EBUSY : audio_ring_alloc(upper);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  if (map->offset == AUDIO_RING_MMAP_STATUS &&
+      map->length <= sizeof(struct audio_ring_s))
+    {
+      map->vaddr = upper->ring;
+    }
+  else if (map->offset >= 0 && map->length > 0 &&
+           map->offset + map->length <= upper->ring->size)
+    {
+      map->vaddr = upper->rbase + map->offset;
+    }
+  else
+    {
+      ret = -EINVAL;
+    }
+
+out:
+  nxmutex_unlock(&upper->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_poll
+ *
+ * Description:
+ *   Wait for a period of the sample ring to be available to the
+ *   application.
+ *
+ ****************************************************************************/
+
+static int audio_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  FAR struct pollfd **slot;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&upper->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_AUDIO_RING_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_AUDIO_RING_NPOLLWAITERS)
+        {
+          ret = -EBUSY;
+        }
+      else if (upper->ring != NULL &&
+               audio_ring_avail(upper) >= upper->ring->period)
+        {
+          poll_notify(&fds, 1, upper->playback ? POLLOUT : POLLIN);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  nxmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif /* CONFIG_AUDIO_RING */
+
 /****************************************************************************
  * Name: audio_start
  *
@@ -308,6 +773,9 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
 #endif
 {
   FAR struct audio_lowerhalf_s *lower = upper->dev;
+#ifdef CONFIG_AUDIO_RING
+  irqstate_t flags;
+#endif
   int ret = OK;
 
   DEBUGASSERT(upper != NULL && lower->ops->start != NULL);
@@ -316,6 +784,18 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
 
   if (!upper->started)
     {
+#ifdef CONFIG_AUDIO_RING
+      /* In ring mode, queue the periods before the stream starts */
+
+      if (upper->ring != NULL)
+        {
+          flags = enter_critical_section();
+          upper->rrun = true;
+          audio_ring_fill(upper);
+          leave_critical_section(flags);
+        }
+#endif
+
       /* Invoke the bottom half method to start the audio stream */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -334,6 +814,12 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
 
           upper->started = true;
         }
+#ifdef CONFIG_AUDIO_RING
+      else
+        {
+          audio_ring_stop(upper);
+        }
+#endif
     }
 
   return ret;
@@ -406,6 +892,19 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 #else
           ret = lower->ops->configure(lower, &caps->caps);
 #endif
+
+#ifdef CONFIG_AUDIO_RING
+          /* Remember the direction of the sample ring */
+
+          if (ret >= 0 && caps->caps.ac_type == AUDIO_TYPE_OUTPUT)
+            {
+              upper->playback = true;
+            }
+          else if (ret >= 0 && caps->caps.ac_type == AUDIO_TYPE_INPUT)
+            {
+              upper->playback = false;
+            }
+#endif
         }
         break;
 
@@ -457,6 +956,10 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
           if (upper->started)
             {
+#ifdef CONFIG_AUDIO_RING
+              audio_ring_stop(upper);
+#endif
+
 #ifdef CONFIG_AUDIO_MULTI_SESSION
               session = (FAR void *) arg;
               ret = lower->ops->stop(lower, session);
@@ -576,11 +1079,63 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
           DEBUGASSERT(lower->ops->enqueuebuffer != NULL);
 
+#ifdef CONFIG_AUDIO_RING
+          /* The ring owns the stream once it is mapped */
+
+          if (upper->ring != NULL)
+            {
+              ret = -EBUSY;
+              break;
+            }
+#endif
+
           bufdesc = (FAR struct audio_buf_desc_s *) arg;
           ret = lower->ops->enqueuebuffer(lower, bufdesc->u.buffer);
         }
         break;
 
+#ifdef CONFIG_AUDIO_RING
+      /* AUDIOIOC_RINGSYNC - Queue the periods made available by the
+       *   application to the device.
+       *
+       *   ioctl argument:  None
+       */
+
+      case AUDIOIOC_RINGSYNC:
+        {
+          irqstate_t flags;
+
+          audinfo("AUDIOIOC_RINGSYNC\n");
+
+          if (upper->ring == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          flags = enter_critical_section();
+          audio_ring_fill(upper);
+          leave_critical_section(flags);
+          ret = OK;
+        }
+        break;
+
+      /* The buffers of the ring cannot change under it */
+
+      case AUDIOIOC_SETBUFFERINFO:
+        {
+          if (upper->ring != NULL)
+            {
+              ret = -EBUSY;
+              break;
+            }
+
+          DEBUGASSERT(lower->ops->ioctl != NULL);
+          ret = lower->ops->ioctl(lower, cmd, arg);
+        }
+        break;
+#endif
+
       /* AUDIOIOC_REGISTERMQ - Register a client Message Queue
        *
        * TODO:  This needs to have multi session support.
@@ -838,6 +1393,16 @@ static void audio_callback(FAR void *handle, uint16_t reason,
     {
       case AUDIO_CALLBACK_DEQUEUE:
         {
+#ifdef CONFIG_AUDIO_RING
+          /* Ring periods are not reported by message */
+
+          if (upper->ring != NULL)
+            {
+              audio_ring_period(upper);
+              break;
+            }
+#endif
+
           /* Call the dequeue routine */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
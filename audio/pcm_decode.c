@@ -87,6 +87,7 @@ struct pcm_decode_s
   uint8_t  bpsamp;                 /* Bits per sample: 8 bits = 8, 16 bits = 16 */
   uint8_t  nchannels;              /* Mono=1, Stereo=2 */
   bool     streaming;              /* Streaming PCM data chunk */
+  bool     offload;                /* Compressed data decoded by lower */
 
 #ifndef CONFIG_AUDIO_EXCLUDE_FFORWARD
   /* Fast forward support */
@@ -704,14 +705,15 @@ static int pcm_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
       return ret;
     }
 
-  /* Modify the capabilities reported by the lower driver:
-   * PCM is the only supported format that we will report,
-   * regardless of what the lower driver  reported.
+  /* Modify the capabilities reported by the lower driver:  PCM is always
+   * supported, it is decoded here.  Any other format that the lower driver
+   * reported is decoded by the lower driver itself (e.g. on a DSP), so the
+   * compressed stream is passed through untouched.
    */
 
   if (caps->ac_subtype == AUDIO_TYPE_QUERY)
     {
-      caps->ac_format.hw = (1 << (AUDIO_FMT_PCM - 1));
+      caps->ac_format.hw |= (1 << (AUDIO_FMT_PCM - 1));
     }
 
   return caps->ac_len;
@@ -763,6 +765,16 @@ static int pcm_configure(FAR struct audio_lowerhalf_s *dev,
     }
 #endif
 
+  /* An output in any format other than PCM is offloaded to the lower
+   * driver.
+   */
+
+  if (caps->ac_type == AUDIO_TYPE_OUTPUT)
+    {
+      priv->offload = caps->ac_subtype != AUDIO_TYPE_QUERY &&
+                      caps->ac_subtype != AUDIO_FMT_PCM;
+    }
+
   /* Defer all other operations to the lower device driver */
 
   lower = priv->lower;
@@ -800,6 +812,7 @@ static int pcm_shutdown(FAR struct audio_lowerhalf_s *dev)
   /* We are no longer streaming audio */
 
   priv->streaming = false;
+  priv->offload   = false;
 
   /* Defer the operation to the lower device driver */
 
@@ -1042,6 +1055,13 @@ static int pcm_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
   lower = priv->lower;
   DEBUGASSERT(lower && lower->ops->enqueuebuffer && lower->ops->configure);
 
+  /* A compressed stream goes to the lower driver as it is */
+
+  if (priv->offload)
+    {
+      return lower->ops->enqueuebuffer(lower, apb);
+    }
+
   /* Are we streaming yet? */
 
   if (priv->streaming)
@@ -1101,6 +1121,7 @@ static int pcm_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
 
       caps.ac_len            = sizeof(struct audio_caps_s);
       caps.ac_type           = AUDIO_TYPE_OUTPUT;
+      caps.ac_subtype        = AUDIO_FMT_PCM;
       caps.ac_channels       = priv->nchannels;
 
       caps.ac_controls.hw[0] = (uint16_t)priv->samprate;
@@ -39,6 +39,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/sched.h>
+#include <nuttx/vdso.h>
 #include <sched/sched.h>
 #include <task/spawn.h>
 #include <nuttx/spawn.h>
@@ -283,6 +284,17 @@ int exec_module(FAR struct binary_s *binp,
   binfo("Initialize the user heap (heapsize=%zu)\n",
         up_addrenv_heapsize(addrenv));
   umm_initialize(vheap, up_addrenv_heapsize(addrenv));
+
+#ifdef CONFIG_CLOCK_VDSO
+  /* Map the clock data read by clock_gettime() in user space */
+
+  ret = clock_vdso_map(addrenv);
+  if (ret < 0)
+    {
+      berr("ERROR: clock_vdso_map() failed: %d\n", ret);
+      goto errout_with_addrenv;
+    }
+#endif
 #endif
 
 #if defined(CONFIG_ARCH_ADDRENV) && defined(CONFIG_ARCH_KERNEL_STACK)
@@ -67,6 +67,33 @@ int elf_verifyheader(FAR const Elf_Ehdr *header);
 int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
              size_t readsize, off_t offset);
 
+/****************************************************************************
+ * Name: elf_cache_get
+ *
+ * Description:
+ *   Make the following reads of the file come from a copy of it in memory.
+ *   On the first load the whole file is read into the cache, the next loads
+ *   of the unchanged file do not access the file system.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_IMAGE_CACHE
+void elf_cache_get(FAR const char *filename,
+                   FAR struct elf_loadinfo_s *loadinfo);
+#endif
+
+/****************************************************************************
+ * Name: elf_cache_put
+ *
+ * Description:
+ *   Stop using the cached copy of the file taken by elf_cache_get().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_IMAGE_CACHE
+void elf_cache_put(FAR struct elf_loadinfo_s *loadinfo);
+#endif
+
 /****************************************************************************
  * Name: elf_loadphdrs
  *
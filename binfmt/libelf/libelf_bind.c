@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
+
 #include <inttypes.h>
 #include <stdint.h>
 #include <string.h>
@@ -33,8 +35,8 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/arena.h>
 #include <nuttx/elf.h>
-#include <nuttx/kmalloc.h>
 #include <nuttx/binfmt/elf.h>
 
 #include "libelf.h"
@@ -79,6 +81,20 @@ struct elf_symcache_s
 
 typedef struct elf_symcache_s elf_symcache_t;
 
+/* Symbols resolved so far, shared by all relocation sections of a module
+ * so that every import is looked up only once.  The cache entries and the
+ * relocation buffer all come from one arena released at the end of
+ * elf_bind().
+ */
+
+struct elf_symlru_s
+{
+  dq_queue_t    q;       /* Most recently used first */
+  int           count;   /* Number of entries in q */
+  FAR struct arena_s *arena;
+  FAR void     *relbuf;  /* Buffer of CONFIG_ELF_RELOCATION_BUFFERCOUNT */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -167,6 +183,109 @@ static inline int elf_readrelas(FAR struct elf_loadinfo_s *loadinfo,
                   relsec->sh_offset + offset);
 }
 
+/****************************************************************************
+ * Name: elf_getsym
+ *
+ * Description:
+ *   Return the symbol table entry 'symidx' with its value resolved, reading
+ *   and resolving it only if it is not in the cache yet.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+static int elf_getsym(FAR struct elf_loadinfo_s *loadinfo,
+                      FAR struct elf_symlru_s *lru, int symidx,
+                      FAR const struct symtab_s *exports, int nexports,
+                      FAR Elf_Sym **psym)
+{
+  FAR elf_symcache_t *cache;
+  FAR dq_entry_t *e;
+  int ret;
+
+  /* First try the cache */
+
+  for (e = dq_peek(&lru->q); e; e = dq_next(e))
+    {
+      cache = (FAR elf_symcache_t *)e;
+      if (cache->idx == symidx)
+        {
+          dq_rem(&cache->entry, &lru->q);
+          dq_addfirst(&cache->entry, &lru->q);
+          *psym = &cache->sym;
+          return OK;
+        }
+    }
+
+  /* If the symbol was not found in the cache, we will need to read the
+   * symbol from the file.
+   */
+
+  if (lru->count < CONFIG_ELF_SYMBOL_CACHECOUNT)
+    {
+      cache = arena_alloc(lru->arena, sizeof(elf_symcache_t));
+      if (!cache)
+        {
+          berr("Failed to allocate memory for elf symbols\n");
+          return -ENOMEM;
+        }
+
+      lru->count++;
+    }
+  else
+    {
+      cache = (FAR elf_symcache_t *)dq_remlast(&lru->q);
+    }
+
+  /* Read the symbol table entry into memory */
+
+  ret = elf_readsym(loadinfo, symidx, &cache->sym);
+  if (ret < 0)
+    {
+      berr("Failed to read symbol[%d]: %d\n", symidx, ret);
+      goto errout;
+    }
+
+  /* Get the value of the symbol (in sym.st_value) */
+
+  ret = elf_symvalue(loadinfo, &cache->sym, exports, nexports);
+  if (ret < 0)
+    {
+      /* The special error -ESRCH is returned only in one condition:
+       * The symbol has no name.
+       *
+       * There are a few relocations for a few architectures that do
+       * no depend upon a named symbol.  We don't know if that is the
+       * case here, but we will use a NULL symbol pointer to indicate
+       * that case to up_relocate().  That function can then do what
+       * is best.
+       */
+
+      if (ret != -ESRCH)
+        {
+          berr("Failed to get value of symbol[%d]: %d\n", symidx, ret);
+          goto errout;
+        }
+
+      berr("Undefined symbol[%d] has no name: %d\n", symidx, ret);
+    }
+
+  cache->idx = symidx;
+  dq_addfirst(&cache->entry, &lru->q);
+  *psym = &cache->sym;
+  return OK;
+
+errout:
+
+  /* Entries are not freed one by one, keep this one for reuse */
+
+  cache->idx = -1;
+  dq_addlast(&cache->entry, &lru->q);
+  return ret;
+}
+
 /****************************************************************************
  * Name: elf_relocate and elf_relocateadd
  *
@@ -180,34 +299,24 @@ static inline int elf_readrelas(FAR struct elf_loadinfo_s *loadinfo,
  ****************************************************************************/
 
 static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
+                        FAR struct elf_symlru_s *lru,
                         FAR const struct symtab_s *exports, int nexports)
 {
   FAR Elf_Shdr         *relsec = &loadinfo->shdr[relidx];
   FAR Elf_Shdr         *dstsec = &loadinfo->shdr[relsec->sh_info];
   FAR Elf_Rel          *rels;
   FAR Elf_Rel          *rel;
-  FAR elf_symcache_t   *cache;
   FAR Elf_Sym          *sym;
-  FAR dq_entry_t       *e;
-  dq_queue_t            q;
   uintptr_t             addr;
   int                   symidx;
   int                   ret;
   int                   i;
-  int                   j;
 
   /* Define potential architecture specific elf data container */
 
   ARCH_ELFDATA_DEF;
 
-  rels = kmm_malloc(CONFIG_ELF_RELOCATION_BUFFERCOUNT * sizeof(Elf_Rel));
-  if (rels == NULL)
-    {
-      berr("Failed to allocate memory for elf relocation\n");
-      return -ENOMEM;
-    }
-
-  dq_init(&q);
+  rels = lru->relbuf;
 
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
@@ -216,7 +325,7 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 
   ret = OK;
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf_Rel); i++)
+  for (i = 0; i < relsec->sh_size / sizeof(Elf_Rel); i++)
     {
       /* Read the relocation entry into memory */
 
@@ -241,90 +350,12 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 
       symidx = ELF_R_SYM(rel->r_info);
 
-      /* First try the cache */
-
-      sym = NULL;
-      for (e = dq_peek(&q); e; e = dq_next(e))
-        {
-          cache = (FAR elf_symcache_t *)e;
-          if (cache->idx == symidx)
-            {
-              dq_rem(&cache->entry, &q);
-              dq_addfirst(&cache->entry, &q);
-              sym = &cache->sym;
-              break;
-            }
-        }
-
-      /* If the symbol was not found in the cache, we will need to read the
-       * symbol from the file.
-       */
-
-      if (sym == NULL)
+      ret = elf_getsym(loadinfo, lru, symidx, exports, nexports, &sym);
+      if (ret < 0)
         {
-          if (j < CONFIG_ELF_SYMBOL_CACHECOUNT)
-            {
-              cache = kmm_malloc(sizeof(elf_symcache_t));
-              if (!cache)
-                {
-                  berr("Failed to allocate memory for elf symbols\n");
-                  ret = -ENOMEM;
-                  break;
-                }
-
-              j++;
-            }
-          else
-            {
-              cache = (FAR elf_symcache_t *)dq_remlast(&q);
-            }
-
-          sym = &cache->sym;
-
-          /* Read the symbol table entry into memory */
-
-          ret = elf_readsym(loadinfo, symidx, sym);
-          if (ret < 0)
-            {
-              berr("Section %d reloc %d: Failed to read symbol[%d]: %d\n",
-                   relidx, i, symidx, ret);
-              kmm_free(cache);
-              break;
-            }
-
-          /* Get the value of the symbol (in sym.st_value) */
-
-          ret = elf_symvalue(loadinfo, sym, exports, nexports);
-          if (ret < 0)
-            {
-              /* The special error -ESRCH is returned only in one condition:
-               * The symbol has no name.
-               *
-               * There are a few relocations for a few architectures that do
-               * no depend upon a named symbol.  We don't know if that is the
-               * case here, but we will use a NULL symbol pointer to indicate
-               * that case to up_relocate().  That function can then do what
-               * is best.
-               */
-
-              if (ret == -ESRCH)
-                {
-                  berr("Section %d reloc %d: "
-                       "Undefined symbol[%d] has no name: %d\n",
-                       relidx, i, symidx, ret);
-                }
-              else
-                {
-                  berr("Section %d reloc %d: "
-                       "Failed to get value of symbol[%d]: %d\n",
-                       relidx, i, symidx, ret);
-                  kmm_free(cache);
-                  break;
-                }
-            }
-
-          cache->idx = symidx;
-          dq_addfirst(&cache->entry, &q);
+          berr("Section %d reloc %d: Failed to get symbol[%d]: %d\n",
+               relidx, i, symidx, ret);
+          break;
         }
 
       if (sym->st_shndx == SHN_UNDEF && sym->st_name == 0)
@@ -358,45 +389,28 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
         }
     }
 
-  kmm_free(rels);
-  while ((e = dq_peek(&q)))
-    {
-      dq_rem(e, &q);
-      kmm_free(e);
-    }
-
   return ret;
 }
 
 static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
+                           FAR struct elf_symlru_s *lru,
                            FAR const struct symtab_s *exports, int nexports)
 {
   FAR Elf_Shdr         *relsec = &loadinfo->shdr[relidx];
   FAR Elf_Shdr         *dstsec = &loadinfo->shdr[relsec->sh_info];
   FAR Elf_Rela         *relas;
   FAR Elf_Rela         *rela;
-  FAR elf_symcache_t   *cache;
   FAR Elf_Sym          *sym;
-  FAR dq_entry_t       *e;
-  dq_queue_t            q;
   uintptr_t             addr;
   int                   symidx;
   int                   ret;
   int                   i;
-  int                   j;
 
   /* Define potential architecture specific elf data container */
 
   ARCH_ELFDATA_DEF;
 
-  relas = kmm_malloc(CONFIG_ELF_RELOCATION_BUFFERCOUNT * sizeof(Elf_Rela));
-  if (relas == NULL)
-    {
-      berr("Failed to allocate memory for elf relocation\n");
-      return -ENOMEM;
-    }
-
-  dq_init(&q);
+  relas = lru->relbuf;
 
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
@@ -405,7 +419,7 @@ static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 
   ret = OK;
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf_Rela); i++)
+  for (i = 0; i < relsec->sh_size / sizeof(Elf_Rela); i++)
     {
       /* Read the relocation entry into memory */
 
@@ -430,90 +444,12 @@ static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 
       symidx = ELF_R_SYM(rela->r_info);
 
-      /* First try the cache */
-
-      sym = NULL;
-      for (e = dq_peek(&q); e; e = dq_next(e))
-        {
-          cache = (FAR elf_symcache_t *)e;
-          if (cache->idx == symidx)
-            {
-              dq_rem(&cache->entry, &q);
-              dq_addfirst(&cache->entry, &q);
-              sym = &cache->sym;
-              break;
-            }
-        }
-
-      /* If the symbol was not found in the cache, we will need to read the
-       * symbol from the file.
-       */
-
-      if (sym == NULL)
+      ret = elf_getsym(loadinfo, lru, symidx, exports, nexports, &sym);
+      if (ret < 0)
         {
-          if (j < CONFIG_ELF_SYMBOL_CACHECOUNT)
-            {
-              cache = kmm_malloc(sizeof(elf_symcache_t));
-              if (!cache)
-                {
-                  berr("Failed to allocate memory for elf symbols\n");
-                  ret = -ENOMEM;
-                  break;
-                }
-
-              j++;
-            }
-          else
-            {
-              cache = (FAR elf_symcache_t *)dq_remlast(&q);
-            }
-
-          sym = &cache->sym;
-
-          /* Read the symbol table entry into memory */
-
-          ret = elf_readsym(loadinfo, symidx, sym);
-          if (ret < 0)
-            {
-              berr("Section %d reloc %d: Failed to read symbol[%d]: %d\n",
-                   relidx, i, symidx, ret);
-              kmm_free(cache);
-              break;
-            }
-
-          /* Get the value of the symbol (in sym.st_value) */
-
-          ret = elf_symvalue(loadinfo, sym, exports, nexports);
-          if (ret < 0)
-            {
-              /* The special error -ESRCH is returned only in one condition:
-               * The symbol has no name.
-               *
-               * There are a few relocations for a few architectures that do
-               * no depend upon a named symbol.  We don't know if that is the
-               * case here, but we will use a NULL symbol pointer to indicate
-               * that case to up_relocate().  That function can then do what
-               * is best.
-               */
-
-              if (ret == -ESRCH)
-                {
-                  bwarn("Section %d reloc %d: "
-                       "Undefined symbol[%d] has no name: %d\n",
-                       relidx, i, symidx, ret);
-                }
-              else
-                {
-                  berr("Section %d reloc %d: "
-                       "Failed to get value of symbol[%d]: %d\n",
-                       relidx, i, symidx, ret);
-                  kmm_free(cache);
-                  break;
-                }
-            }
-
-          cache->idx = symidx;
-          dq_addfirst(&cache->entry, &q);
+          berr("Section %d reloc %d: Failed to get symbol[%d]: %d\n",
+               relidx, i, symidx, ret);
+          break;
         }
 
       if (sym->st_shndx == SHN_UNDEF && sym->st_name == 0)
@@ -547,13 +483,6 @@ static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
         }
     }
 
-  kmm_free(relas);
-  while ((e = dq_peek(&q)))
-    {
-      dq_rem(e, &q);
-      kmm_free(e);
-    }
-
   return ret;
 }
 
@@ -577,6 +506,7 @@ static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
              FAR const struct symtab_s *exports, int nexports)
 {
+  struct elf_symlru_s lru;
 #ifdef CONFIG_ARCH_ADDRENV
   int status;
 #endif
@@ -591,6 +521,19 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
       return ret;
     }
 
+  dq_init(&lru.q);
+  lru.count  = 0;
+  lru.arena  = arena_create(0);
+  lru.relbuf = lru.arena != NULL ?
+               arena_alloc(lru.arena, CONFIG_ELF_RELOCATION_BUFFERCOUNT *
+                           MAX(sizeof(Elf_Rel), sizeof(Elf_Rela))) : NULL;
+  if (lru.relbuf == NULL)
+    {
+      berr("Failed to allocate memory for elf relocation\n");
+      arena_destroy(lru.arena);
+      return -ENOMEM;
+    }
+
 #ifdef CONFIG_ARCH_ADDRENV
   /* If CONFIG_ARCH_ADDRENV=y, then the loaded ELF lies in a virtual address
    * space that may not be in place now.  elf_addrenv_select() will
@@ -601,6 +544,7 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
   if (ret < 0)
     {
       berr("ERROR: elf_addrenv_select() failed: %d\n", ret);
+      arena_destroy(lru.arena);
       return ret;
     }
 #endif
@@ -630,11 +574,11 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
 
       if (loadinfo->shdr[i].sh_type == SHT_REL)
         {
-          ret = elf_relocate(loadinfo, i, exports, nexports);
+          ret = elf_relocate(loadinfo, i, &lru, exports, nexports);
         }
       else if (loadinfo->shdr[i].sh_type == SHT_RELA)
         {
-          ret = elf_relocateadd(loadinfo, i, exports, nexports);
+          ret = elf_relocateadd(loadinfo, i, &lru, exports, nexports);
         }
 
       if (ret < 0)
@@ -643,6 +587,8 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
         }
     }
 
+  arena_destroy(lru.arena);
+
 #if defined(CONFIG_ARCH_ADDRENV)
   /* Ensure that the I and D caches are coherent before starting the newly
    * loaded module by cleaning the D cache (i.e., flushing the D cache
@@ -0,0 +1,251 @@
+/****************************************************************************
+ * binfmt/libelf/libelf_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/lib/lib.h>
+#include <nuttx/binfmt/elf.h>
+
+#include "libelf.h"
+
+#ifdef CONFIG_ELF_IMAGE_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A cached copy of an ELF file.  An entry is identified by the path of the
+ * file, its size and its modification time, so a rewritten file is loaded
+ * again.
+ */
+
+struct elf_cache_s
+{
+  FAR char          *path;       /* Path of the file, or NULL if unused */
+  FAR uint8_t       *image;      /* Content of the file */
+  off_t              size;       /* Size of the file */
+  struct timespec    mtime;      /* Modification time of the file */
+  uint32_t           age;        /* Time of the last use */
+  uint16_t           crefs;      /* Number of loads using the image */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct elf_cache_s g_elf_cache[CONFIG_ELF_IMAGE_CACHE_COUNT];
+static mutex_t g_elf_cache_lock = NXMUTEX_INITIALIZER;
+static uint32_t g_elf_cache_age;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_cache_find
+ *
+ * Description:
+ *   Find the entry of the file, or an entry to replace with it.
+ *
+ ****************************************************************************/
+
+static FAR struct elf_cache_s *elf_cache_find(FAR const char *filename,
+                                              FAR const struct stat *buf,
+                                              FAR bool *hit)
+{
+  FAR struct elf_cache_s *victim = NULL;
+  FAR struct elf_cache_s *entry;
+  int i;
+
+  for (i = 0; i < CONFIG_ELF_IMAGE_CACHE_COUNT; i++)
+    {
+      entry = &g_elf_cache[i];
+      if (entry->path != NULL && strcmp(entry->path, filename) == 0 &&
+          entry->size == buf->st_size &&
+          entry->mtime.tv_sec == buf->st_mtim.tv_sec &&
+          entry->mtime.tv_nsec == buf->st_mtim.tv_nsec)
+        {
+          *hit = true;
+          return entry;
+        }
+
+      /* Prefer a free entry, else the least recently used idle one */
+
+      if (entry->crefs == 0 &&
+          (victim == NULL || entry->path == NULL ||
+           (victim->path != NULL &&
+            (int32_t)(entry->age - victim->age) < 0)))
+        {
+          victim = entry;
+        }
+    }
+
+  *hit = false;
+  return victim;
+}
+
+/****************************************************************************
+ * Name: elf_cache_release
+ *
+ * Description:
+ *   Free the image held by an idle entry.
+ *
+ ****************************************************************************/
+
+static void elf_cache_release(FAR struct elf_cache_s *entry)
+{
+  kmm_free(entry->image);
+  lib_free(entry->path);
+  memset(entry, 0, sizeof(struct elf_cache_s));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_cache_get
+ *
+ * Description:
+ *   Make the following reads of the file come from a copy of it in memory.
+ *   On the first load the whole file is read into the cache, the next loads
+ *   of the unchanged file do not access the file system.  Nothing is done
+ *   if the file is too large or all of the entries are in use.
+ *
+ * Input Parameters:
+ *   filename - The path of the opened ELF file.
+ *   loadinfo - Load state information.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void elf_cache_get(FAR const char *filename,
+                   FAR struct elf_loadinfo_s *loadinfo)
+{
+  FAR struct elf_cache_s *entry;
+  FAR uint8_t *image;
+  FAR char *path;
+  struct stat buf;
+  bool hit;
+  int ret;
+
+  if (loadinfo->filelen <= 0 ||
+      loadinfo->filelen > CONFIG_ELF_IMAGE_CACHE_MAXSIZE ||
+      file_fstat(&loadinfo->file, &buf) < 0 ||
+      nxmutex_lock(&g_elf_cache_lock) < 0)
+    {
+      return;
+    }
+
+  entry = elf_cache_find(filename, &buf, &hit);
+  if (entry == NULL)
+    {
+      goto out;
+    }
+
+  if (!hit)
+    {
+      /* The file is read with the lock held so that concurrent loads of it
+       * wait for this one instead of reading it again.
+       */
+
+      path  = strdup(filename);
+      image = kmm_malloc(buf.st_size);
+      ret   = path != NULL && image != NULL ?
+              elf_read(loadinfo, image, buf.st_size, 0) : -ENOMEM;
+      if (ret < 0)
+        {
+          lib_free(path);
+          kmm_free(image);
+          goto out;
+        }
+
+      if (entry->path != NULL)
+        {
+          elf_cache_release(entry);
+        }
+
+      entry->path  = path;
+      entry->image = image;
+      entry->size  = buf.st_size;
+      entry->mtime = buf.st_mtim;
+    }
+
+  binfo("ELF file %s %s the image cache\n", filename,
+        hit ? "found in" : "added to");
+
+  entry->age = ++g_elf_cache_age;
+  entry->crefs++;
+
+  loadinfo->cache     = entry;
+  loadinfo->cachebase = entry->image;
+
+out:
+  nxmutex_unlock(&g_elf_cache_lock);
+}
+
+/****************************************************************************
+ * Name: elf_cache_put
+ *
+ * Description:
+ *   Stop using the cached copy of the file taken by elf_cache_get().
+ *
+ * Input Parameters:
+ *   loadinfo - Load state information.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void elf_cache_put(FAR struct elf_loadinfo_s *loadinfo)
+{
+  FAR struct elf_cache_s *entry = loadinfo->cache;
+
+  if (entry != NULL)
+    {
+      nxmutex_lock(&g_elf_cache_lock);
+      entry->crefs--;
+      nxmutex_unlock(&g_elf_cache_lock);
+
+      loadinfo->cache     = NULL;
+      loadinfo->cachebase = NULL;
+    }
+}
+
+#endif /* CONFIG_ELF_IMAGE_CACHE */
@@ -40,6 +40,7 @@
 #include <nuttx/binfmt/elf.h>
 #include <nuttx/binfmt/binfmt.h>
 #include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
 #include <sched/sched.h>
 
 /****************************************************************************
@@ -57,6 +58,19 @@
 #define ROUNDUP(x, y)     ((x + (y - 1)) / (y)) * (y)
 #define ROUNDDOWN(x ,y)   (((x) / (y)) * (y))
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_COREDUMP_SKIP_FREE
+struct elf_unused_s
+{
+  FAR struct elf_dumpinfo_s *cinfo;
+  uintptr_t pos;   /* Next address of the region to emit */
+  uintptr_t end;   /* End address of the region */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -111,19 +125,17 @@ static int elf_emit(FAR struct elf_dumpinfo_s *cinfo,
 }
 
 /****************************************************************************
- * Name: elf_emit_align
+ * Name: elf_emit_zero
  *
  * Description:
- *   Align the filled data according to the current offset
+ *   Send len zero bytes to binfmt_outstream_s
  *
  ****************************************************************************/
 
-static int elf_emit_align(FAR struct elf_dumpinfo_s *cinfo)
+static int elf_emit_zero(FAR struct elf_dumpinfo_s *cinfo, off_t len)
 {
-  off_t align = ROUNDUP(cinfo->stream->nput,
-                        ELF_PAGESIZE) - cinfo->stream->nput;
   unsigned char null[256];
-  off_t total = align;
+  off_t total = len;
   off_t ret = 0;
 
   memset(null, 0, sizeof(null));
@@ -140,7 +152,23 @@ static int elf_emit_align(FAR struct elf_dumpinfo_s *cinfo)
       total -= ret;
     }
 
-  return ret < 0 ? ret : align;
+  return ret < 0 ? ret : len;
+}
+
+/****************************************************************************
+ * Name: elf_emit_align
+ *
+ * Description:
+ *   Align the filled data according to the current offset
+ *
+ ****************************************************************************/
+
+static int elf_emit_align(FAR struct elf_dumpinfo_s *cinfo)
+{
+  off_t align = ROUNDUP(cinfo->stream->nput,
+                        ELF_PAGESIZE) - cinfo->stream->nput;
+
+  return elf_emit_zero(cinfo, align);
 }
 
 /****************************************************************************
@@ -411,6 +439,66 @@ static void elf_emit_stack(FAR struct elf_dumpinfo_s *cinfo)
     }
 }
 
+/****************************************************************************
+ * Name: elf_emit_unused
+ *
+ * Description:
+ *   Emit the region up to a free heap range, then zeros for the range
+ *   itself.  Ranges behind what was already emitted are dumped as they
+ *   are.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_COREDUMP_SKIP_FREE
+static void elf_emit_unused(FAR void *start, size_t size, FAR void *arg)
+{
+  FAR struct elf_unused_s *unused = arg;
+  uintptr_t begin = MAX((uintptr_t)start, unused->pos);
+  uintptr_t end = MIN((uintptr_t)start + size, unused->end);
+
+  if (begin < end)
+    {
+      elf_emit(unused->cinfo, (FAR void *)unused->pos, begin - unused->pos);
+      elf_emit_zero(unused->cinfo, end - begin);
+      unused->pos = end;
+    }
+}
+
+/****************************************************************************
+ * Name: elf_emit_region
+ *
+ * Description:
+ *   Emit one memory region with the free heap chunks replaced by zeros
+ *
+ ****************************************************************************/
+
+static void elf_emit_region(FAR struct elf_dumpinfo_s *cinfo,
+                            uintptr_t start, uintptr_t end)
+{
+  struct elf_unused_s unused;
+
+  unused.cinfo = cinfo;
+  unused.pos   = start;
+  unused.end   = end;
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  if (g_kmmheap != NULL)
+    {
+      mm_foreach_unused(g_kmmheap, elf_emit_unused, &unused);
+    }
+#endif
+
+#ifdef CONFIG_BUILD_FLAT
+  if (g_mmheap != NULL)
+    {
+      mm_foreach_unused(g_mmheap, elf_emit_unused, &unused);
+    }
+#endif
+
+  elf_emit(cinfo, (FAR void *)unused.pos, unused.end - unused.pos);
+}
+#endif
+
 /****************************************************************************
  * Name: elf_emit_memory
  *
@@ -450,8 +538,13 @@ static void elf_emit_memory(FAR struct elf_dumpinfo_s *cinfo, int memsegs)
         }
       else
         {
+#ifdef CONFIG_ELF_COREDUMP_SKIP_FREE
+          elf_emit_region(cinfo, cinfo->regions[i].start,
+                          cinfo->regions[i].end);
+#else
           elf_emit(cinfo, (FAR void *)cinfo->regions[i].start,
                    cinfo->regions[i].end - cinfo->regions[i].start);
+#endif
         }
 
       /* Align to page */
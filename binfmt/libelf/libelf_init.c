@@ -100,6 +100,41 @@ static inline int elf_fileinfo(FAR struct elf_loadinfo_s *loadinfo)
   return OK;
 }
 
+#ifdef CONFIG_ELF_XIP
+/****************************************************************************
+ * Name: elf_mapxip
+ *
+ * Description:
+ *  Find the address of the file if the file system can access it in place
+ *  (e.g. ROMFS on a memory mapped device).  Only static mappings are used
+ *  since the sections stay in use for the whole life of the program; any
+ *  other file is read as usual.
+ *
+ ****************************************************************************/
+
+static void elf_mapxip(FAR struct elf_loadinfo_s *loadinfo)
+{
+  FAR void *mapped;
+  int ret;
+
+  if (loadinfo->filelen <= 0)
+    {
+      return;
+    }
+
+  ret = file_mmap_direct(&loadinfo->file, loadinfo->filelen, 0, &mapped);
+  if (ret == 0)
+    {
+      binfo("ELF file mapped in place at %p\n", mapped);
+      loadinfo->xipbase = mapped;
+    }
+  else if (ret > 0)
+    {
+      file_munmap(mapped, loadinfo->filelen);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -145,6 +180,18 @@ int elf_init(FAR const char *filename, FAR struct elf_loadinfo_s *loadinfo)
       return ret;
     }
 
+#ifdef CONFIG_ELF_XIP
+  /* Use the file in place if possible */
+
+  elf_mapxip(loadinfo);
+#endif
+
+#ifdef CONFIG_ELF_IMAGE_CACHE
+  /* Read the file from the image cache, or add it */
+
+  elf_cache_get(filename, loadinfo);
+#endif
+
   /* Read the ELF ehdr from offset 0 */
 
   ret = elf_read(loadinfo, (FAR uint8_t *)&loadinfo->ehdr,
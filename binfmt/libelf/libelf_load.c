@@ -29,6 +29,7 @@
 #include <sys/param.h>
 #include <sys/types.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -64,6 +65,54 @@
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_ELF_XIP
+/****************************************************************************
+ * Name: elf_sectionxip
+ *
+ * Description:
+ *   Return true if section 'idx' can be used in place from the memory
+ *   mapped file instead of being copied into RAM: it must be read-only,
+ *   non-executable data with no relocations applied to it, and its file
+ *   offset must satisfy its alignment.  The entry point of a relocatable
+ *   module is an offset into the text allocation, so code is always copied.
+ *
+ ****************************************************************************/
+
+static bool elf_sectionxip(FAR struct elf_loadinfo_s *loadinfo, int idx)
+{
+  FAR Elf_Shdr *shdr = &loadinfo->shdr[idx];
+  uintptr_t addr;
+  int i;
+
+  if (loadinfo->xipbase == NULL || loadinfo->ehdr.e_type != ET_REL ||
+      shdr->sh_type != SHT_PROGBITS ||
+      (shdr->sh_flags & (SHF_ALLOC | SHF_WRITE | SHF_EXECINSTR)) !=
+      SHF_ALLOC)
+    {
+      return false;
+    }
+
+  addr = (uintptr_t)loadinfo->xipbase + shdr->sh_offset;
+  if (shdr->sh_addralign > 1 && (addr & (shdr->sh_addralign - 1)) != 0)
+    {
+      return false;
+    }
+
+  for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf_Shdr *relsec = &loadinfo->shdr[i];
+
+      if ((relsec->sh_type == SHT_REL || relsec->sh_type == SHT_RELA) &&
+          relsec->sh_info == idx && relsec->sh_size > 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: elf_elfsize
  *
@@ -92,6 +141,15 @@ static void elf_elfsize(FAR struct elf_loadinfo_s *loadinfo)
        * execution.
        */
 
+#ifdef CONFIG_ELF_XIP
+      /* Sections used in place need no memory */
+
+      if (elf_sectionxip(loadinfo, i))
+        {
+          continue;
+        }
+#endif
+
       if ((shdr->sh_flags & SHF_ALLOC) != 0)
         {
           /* SHF_WRITE indicates that the section address space is write-
@@ -222,6 +280,19 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
           continue;
         }
 
+#ifdef CONFIG_ELF_XIP
+      /* Point read-only data straight into the mapped file */
+
+      if (elf_sectionxip(loadinfo, i))
+        {
+          binfo("%d. %08lx->%p (XIP)\n", i, (unsigned long)shdr->sh_addr,
+                loadinfo->xipbase + shdr->sh_offset);
+
+          shdr->sh_addr = (uintptr_t)loadinfo->xipbase + shdr->sh_offset;
+          continue;
+        }
+#endif
+
       if (*pptr == NULL)
         {
           if (shdr->sh_type != SHT_NOBITS)
@@ -120,6 +120,40 @@ int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
 
   binfo("Read %zu bytes from offset %" PRIdOFF "\n", readsize, offset);
 
+#ifdef CONFIG_ELF_XIP
+  /* The file is mapped, there is nothing to seek or read */
+
+  if (loadinfo->xipbase != NULL)
+    {
+      if (offset < 0 || offset + readsize > loadinfo->filelen)
+        {
+          berr("Read beyond the end of file\n");
+          return -ENODATA;
+        }
+
+      memcpy(buffer, loadinfo->xipbase + offset, readsize);
+      elf_dumpreaddata(buffer, readsize);
+      return OK;
+    }
+#endif
+
+#ifdef CONFIG_ELF_IMAGE_CACHE
+  /* The file was read into the image cache by an earlier load */
+
+  if (loadinfo->cachebase != NULL)
+    {
+      if (offset < 0 || offset + readsize > loadinfo->filelen)
+        {
+          berr("Read beyond the end of file\n");
+          return -ENODATA;
+        }
+
+      memcpy(buffer, loadinfo->cachebase + offset, readsize);
+      elf_dumpreaddata(buffer, readsize);
+      return OK;
+    }
+#endif
+
   /* Loop until all of the requested data has been read. */
 
   while (readsize > 0)
@@ -70,6 +70,12 @@ int elf_uninit(struct elf_loadinfo_s *loadinfo)
 
   elf_freebuffers(loadinfo);
 
+#ifdef CONFIG_ELF_IMAGE_CACHE
+  /* Release the cached image of the file */
+
+  elf_cache_put(loadinfo);
+#endif
+
   /* Close the ELF file */
 
   if (loadinfo->file.f_inode)
@@ -0,0 +1,125 @@
+/****************************************************************************
+ * crypto/accel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <strings.h>
+
+#include <crypto/accel.h>
+#include <crypto/rijndael.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct crypto_accel_s *g_crypto_accel;
+static bool g_crypto_accel_probed;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crypto_accel
+ *
+ * Description:
+ *   Return the crypto kernels of the running CPU, probing the CPU features
+ *   on first use, or NULL if the CPU has none of the supported extensions.
+ *   Probing has no side effects, so racing first callers are harmless.
+ *
+ ****************************************************************************/
+
+FAR const struct crypto_accel_s *crypto_accel(void)
+{
+  if (!g_crypto_accel_probed)
+    {
+#if defined(CONFIG_ARCH_X86_64)
+      g_crypto_accel = crypto_accel_x86_64();
+#elif defined(CONFIG_ARCH_ARM64)
+      g_crypto_accel = crypto_accel_arm64();
+#endif
+      g_crypto_accel_probed = true;
+    }
+
+  return g_crypto_accel;
+}
+
+/****************************************************************************
+ * Name: crypto_accel_aes_setkey
+ *
+ * Description:
+ *   Expand an AES key into the encryption and decryption schedules used by
+ *   the accelerated AES kernels.  'dk' may be NULL for encryption-only
+ *   contexts.
+ *
+ * Input Parameters:
+ *   accel - The kernels returned by crypto_accel()
+ *   ek    - CRYPTO_ACCEL_AES_RKLEN bytes for the encryption schedule
+ *   dk    - CRYPTO_ACCEL_AES_RKLEN bytes for the decryption schedule
+ *   key   - The cipher key
+ *   len   - The key length in bytes
+ *
+ * Returned Value:
+ *   The number of rounds, or 0 if the key length is not supported.
+ *
+ ****************************************************************************/
+
+unsigned int crypto_accel_aes_setkey(FAR const struct crypto_accel_s *accel,
+                                     FAR uint8_t *ek, FAR uint8_t *dk,
+                                     FAR const uint8_t *key, int len)
+{
+  uint32_t rk[4 * (AES_MAXROUNDS + 1)];
+  unsigned int nr;
+  unsigned int i;
+
+  if (len != 16 && len != 24 && len != 32)
+    {
+      return 0;
+    }
+
+  nr = rijndael_key_setup_enc(rk, key, len * 8);
+
+  /* The table based schedule holds big endian words, the instructions
+   * want the round keys as plain bytes.
+   */
+
+  for (i = 0; i < 4 * (nr + 1); i++)
+    {
+      ek[4 * i]     = rk[i] >> 24;
+      ek[4 * i + 1] = rk[i] >> 16;
+      ek[4 * i + 2] = rk[i] >> 8;
+      ek[4 * i + 3] = rk[i];
+    }
+
+  if (dk != NULL)
+    {
+      accel->aes_deckey(dk, ek, nr);
+    }
+
+  explicit_bzero(rk, sizeof(rk));
+  return nr;
+}
@@ -0,0 +1,475 @@
+/****************************************************************************
+ * crypto/accel_arm64.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* ARMv8 Cryptographic Extension kernels.  The file is built with the
+ * generic arm64 flags, the instructions are enabled per function so that
+ * nothing here runs before crypto_accel_arm64() has seen ID_AA64ISAR0_EL1.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <arm_neon.h>
+
+#include <crypto/accel.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ACCEL_CE          __attribute__((target("+crypto")))
+
+/* ID_AA64ISAR0_EL1 fields */
+
+#define ISAR0_AES(r)      (((r) >> 4) & 0xf)    /* 1: AES, 2: AES + PMULL */
+#define ISAR0_SHA2(r)     (((r) >> 12) & 0xf)   /* 1: SHA256 */
+
+/* Blocks encrypted in parallel to fill the AES pipeline */
+
+#define ACCEL_AES_LANES   4
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint32_t g_sha256_k[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static struct crypto_accel_s g_accel_arm64 =
+{
+  "arm64"
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: accel_aes_deckey
+ *
+ * Description:
+ *   Derive the equivalent inverse cipher schedule used by AESD/AESIMC.
+ *
+ ****************************************************************************/
+
+ACCEL_CE
+static void accel_aes_deckey(FAR uint8_t *dk, FAR const uint8_t *ek,
+                             unsigned int nr)
+{
+  unsigned int i;
+
+  vst1q_u8(dk, vld1q_u8(ek + 16 * nr));
+
+  for (i = 1; i < nr; i++)
+    {
+      vst1q_u8(dk + 16 * i, vaesimcq_u8(vld1q_u8(ek + 16 * (nr - i))));
+    }
+
+  vst1q_u8(dk + 16 * nr, vld1q_u8(ek));
+}
+
+/* AESE/AESD do AddRoundKey first, so round r uses rk[r] and the last round
+ * key is added with a plain XOR.
+ */
+
+ACCEL_CE
+static inline uint8x16_t accel_aes_enc1(FAR const uint8_t *ek,
+                                        unsigned int nr, uint8x16_t b)
+{
+  unsigned int r;
+
+  for (r = 0; r < nr - 1; r++)
+    {
+      b = vaesmcq_u8(vaeseq_u8(b, vld1q_u8(ek + 16 * r)));
+    }
+
+  b = vaeseq_u8(b, vld1q_u8(ek + 16 * (nr - 1)));
+  return veorq_u8(b, vld1q_u8(ek + 16 * nr));
+}
+
+ACCEL_CE
+static void accel_aes_encrypt(FAR const uint8_t *ek, unsigned int nr,
+                              FAR const uint8_t *src, FAR uint8_t *dst,
+                              size_t nblocks)
+{
+  uint8x16_t b[ACCEL_AES_LANES];
+  uint8x16_t k;
+  unsigned int r;
+  unsigned int j;
+
+  for (; nblocks >= ACCEL_AES_LANES; nblocks -= ACCEL_AES_LANES)
+    {
+      for (j = 0; j < ACCEL_AES_LANES; j++)
+        {
+          b[j] = vld1q_u8(src + 16 * j);
+        }
+
+      for (r = 0; r < nr - 1; r++)
+        {
+          k = vld1q_u8(ek + 16 * r);
+          for (j = 0; j < ACCEL_AES_LANES; j++)
+            {
+              b[j] = vaesmcq_u8(vaeseq_u8(b[j], k));
+            }
+        }
+
+      k = vld1q_u8(ek + 16 * (nr - 1));
+      for (j = 0; j < ACCEL_AES_LANES; j++)
+        {
+          b[j] = veorq_u8(vaeseq_u8(b[j], k), vld1q_u8(ek + 16 * nr));
+          vst1q_u8(dst + 16 * j, b[j]);
+        }
+
+      src += 16 * ACCEL_AES_LANES;
+      dst += 16 * ACCEL_AES_LANES;
+    }
+
+  for (; nblocks > 0; nblocks--)
+    {
+      vst1q_u8(dst, accel_aes_enc1(ek, nr, vld1q_u8(src)));
+      src += 16;
+      dst += 16;
+    }
+}
+
+ACCEL_CE
+static void accel_aes_decrypt(FAR const uint8_t *dk, unsigned int nr,
+                              FAR const uint8_t *src, FAR uint8_t *dst,
+                              size_t nblocks)
+{
+  uint8x16_t b;
+  unsigned int r;
+
+  for (; nblocks > 0; nblocks--)
+    {
+      b = vld1q_u8(src);
+      for (r = 0; r < nr - 1; r++)
+        {
+          b = vaesimcq_u8(vaesdq_u8(b, vld1q_u8(dk + 16 * r)));
+        }
+
+      b = vaesdq_u8(b, vld1q_u8(dk + 16 * (nr - 1)));
+      vst1q_u8(dst, veorq_u8(b, vld1q_u8(dk + 16 * nr)));
+
+      src += 16;
+      dst += 16;
+    }
+}
+
+/****************************************************************************
+ * Name: accel_gfmul
+ *
+ * Description:
+ *   Multiply two byte reversed GF(2^128) elements with PMULL.  This is the
+ *   same shift-and-reduce sequence as the x86_64 backend so both produce
+ *   the GCM byte order result of ghash_gfmul().
+ *
+ ****************************************************************************/
+
+ACCEL_CE
+static inline uint8x16_t accel_clmul(uint8x16_t a, int ai,
+                                     uint8x16_t b, int bi)
+{
+  poly64_t pa = vgetq_lane_p64(vreinterpretq_p64_u8(a), 0);
+  poly64_t pb = vgetq_lane_p64(vreinterpretq_p64_u8(b), 0);
+
+  if (ai)
+    {
+      pa = vgetq_lane_p64(vreinterpretq_p64_u8(a), 1);
+    }
+
+  if (bi)
+    {
+      pb = vgetq_lane_p64(vreinterpretq_p64_u8(b), 1);
+    }
+
+  return vreinterpretq_u8_p128(vmull_p64(pa, pb));
+}
+
+/* Whole vector byte shifts, as PSLLDQ/PSRLDQ */
+
+#define ACCEL_SLL(x, n) vextq_u8(vdupq_n_u8(0), (x), 16 - (n))
+#define ACCEL_SRL(x, n) vextq_u8((x), vdupq_n_u8(0), (n))
+
+/* Per 32-bit lane bit shifts */
+
+#define ACCEL_SLL32(x, n) \
+  vreinterpretq_u8_u32(vshlq_n_u32(vreinterpretq_u32_u8(x), (n)))
+#define ACCEL_SRL32(x, n) \
+  vreinterpretq_u8_u32(vshrq_n_u32(vreinterpretq_u32_u8(x), (n)))
+
+ACCEL_CE
+static inline uint8x16_t accel_gfmul(uint8x16_t a, uint8x16_t b)
+{
+  uint8x16_t lo;
+  uint8x16_t mid;
+  uint8x16_t hi;
+  uint8x16_t t1;
+  uint8x16_t t2;
+  uint8x16_t t3;
+
+  lo  = accel_clmul(a, 0, b, 0);
+  mid = veorq_u8(accel_clmul(a, 0, b, 1), accel_clmul(a, 1, b, 0));
+  hi  = accel_clmul(a, 1, b, 1);
+
+  lo  = veorq_u8(lo, ACCEL_SLL(mid, 8));
+  hi  = veorq_u8(hi, ACCEL_SRL(mid, 8));
+
+  /* Shift the product <hi:lo> left by one bit */
+
+  t1  = ACCEL_SRL32(lo, 31);
+  t2  = ACCEL_SRL32(hi, 31);
+  lo  = ACCEL_SLL32(lo, 1);
+  hi  = ACCEL_SLL32(hi, 1);
+
+  t3  = ACCEL_SRL(t1, 12);
+  t2  = ACCEL_SLL(t2, 4);
+  t1  = ACCEL_SLL(t1, 4);
+  lo  = vorrq_u8(lo, t1);
+  hi  = vorrq_u8(hi, t2);
+  hi  = vorrq_u8(hi, t3);
+
+  /* First phase of the reduction */
+
+  t1  = veorq_u8(ACCEL_SLL32(lo, 31), ACCEL_SLL32(lo, 30));
+  t1  = veorq_u8(t1, ACCEL_SLL32(lo, 25));
+  t2  = ACCEL_SRL(t1, 4);
+  t1  = ACCEL_SLL(t1, 12);
+  lo  = veorq_u8(lo, t1);
+
+  /* Second phase of the reduction */
+
+  t1  = veorq_u8(ACCEL_SRL32(lo, 1), ACCEL_SRL32(lo, 2));
+  t1  = veorq_u8(t1, ACCEL_SRL32(lo, 7));
+  t1  = veorq_u8(t1, t2);
+  lo  = veorq_u8(lo, t1);
+
+  return veorq_u8(hi, lo);
+}
+
+ACCEL_CE
+static inline uint8x16_t accel_bswap128(uint8x16_t x)
+{
+  x = vrev64q_u8(x);
+  return vextq_u8(x, x, 8);
+}
+
+ACCEL_CE
+static void accel_ghash(FAR uint8_t *z, FAR const uint8_t *h,
+                        FAR const uint8_t *x, size_t nblocks)
+{
+  uint8x16_t hh = accel_bswap128(vld1q_u8(h));
+  uint8x16_t zz = accel_bswap128(vld1q_u8(z));
+
+  for (; nblocks > 0; nblocks--)
+    {
+      zz = accel_gfmul(veorq_u8(zz, accel_bswap128(vld1q_u8(x))), hh);
+      x += 16;
+    }
+
+  vst1q_u8(z, accel_bswap128(zz));
+}
+
+/****************************************************************************
+ * Name: accel_gcm_crypt
+ *
+ * Description:
+ *   Encrypt ACCEL_AES_LANES counter blocks at a time and fold the
+ *   ciphertext into GHASH, so that the data is only read and written once.
+ *
+ ****************************************************************************/
+
+ACCEL_CE
+static void accel_gcm_crypt(FAR const uint8_t *ek, unsigned int nr,
+                            FAR uint8_t *ctr, FAR uint8_t *z,
+                            FAR const uint8_t *h, FAR const uint8_t *src,
+                            FAR uint8_t *dst, size_t nblocks, bool encrypt)
+{
+  uint8x16_t hh = accel_bswap128(vld1q_u8(h));
+  uint8x16_t zz = accel_bswap128(vld1q_u8(z));
+  uint32x4_t cb = vreinterpretq_u32_u8(vld1q_u8(ctr));
+  uint8x16_t b[ACCEL_AES_LANES];
+  uint8x16_t in[ACCEL_AES_LANES];
+  uint8x16_t k;
+  uint32_t c;
+  unsigned int lanes;
+  unsigned int r;
+  unsigned int j;
+
+  c = __builtin_bswap32(vgetq_lane_u32(cb, 3));
+
+  while (nblocks > 0)
+    {
+      lanes = nblocks < ACCEL_AES_LANES ? nblocks : ACCEL_AES_LANES;
+
+      for (j = 0; j < lanes; j++)
+        {
+          cb   = vsetq_lane_u32(__builtin_bswap32(++c), cb, 3);
+          b[j] = vreinterpretq_u8_u32(cb);
+        }
+
+      for (r = 0; r < nr - 1; r++)
+        {
+          k = vld1q_u8(ek + 16 * r);
+          for (j = 0; j < lanes; j++)
+            {
+              b[j] = vaesmcq_u8(vaeseq_u8(b[j], k));
+            }
+        }
+
+      k = vld1q_u8(ek + 16 * (nr - 1));
+      for (j = 0; j < lanes; j++)
+        {
+          in[j] = vld1q_u8(src + 16 * j);
+          b[j]  = veorq_u8(vaeseq_u8(b[j], k), vld1q_u8(ek + 16 * nr));
+          b[j]  = veorq_u8(b[j], in[j]);
+          vst1q_u8(dst + 16 * j, b[j]);
+        }
+
+      for (j = 0; j < lanes; j++)
+        {
+          zz = veorq_u8(zz, accel_bswap128(encrypt ? b[j] : in[j]));
+          zz = accel_gfmul(zz, hh);
+        }
+
+      src     += 16 * lanes;
+      dst     += 16 * lanes;
+      nblocks -= lanes;
+    }
+
+  vst1q_u8(ctr, vreinterpretq_u8_u32(cb));
+  vst1q_u8(z, accel_bswap128(zz));
+}
+
+ACCEL_CE
+static void accel_sha256(FAR uint32_t *state, FAR const uint8_t *data,
+                         size_t nblocks)
+{
+  uint32x4_t abcd = vld1q_u32(&state[0]);
+  uint32x4_t efgh = vld1q_u32(&state[4]);
+  uint32x4_t save0;
+  uint32x4_t save1;
+  uint32x4_t msg[4];
+  uint32x4_t wk;
+  uint32x4_t tmp;
+  unsigned int i;
+
+  for (; nblocks > 0; nblocks--)
+    {
+      save0 = abcd;
+      save1 = efgh;
+
+      for (i = 0; i < 4; i++)
+        {
+          msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+        }
+
+      for (i = 0; i < 16; i++)
+        {
+          if (i >= 4)
+            {
+              msg[i & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[i & 3],
+                                                           msg[(i + 1) & 3]),
+                                           msg[(i + 2) & 3],
+                                           msg[(i + 3) & 3]);
+            }
+
+          wk   = vaddq_u32(msg[i & 3], vld1q_u32(&g_sha256_k[4 * i]));
+          tmp  = abcd;
+          abcd = vsha256hq_u32(abcd, efgh, wk);
+          efgh = vsha256h2q_u32(efgh, tmp, wk);
+        }
+
+      abcd  = vaddq_u32(abcd, save0);
+      efgh  = vaddq_u32(efgh, save1);
+      data += 64;
+    }
+
+  vst1q_u32(&state[0], abcd);
+  vst1q_u32(&state[4], efgh);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crypto_accel_arm64
+ *
+ * Description:
+ *   Probe ID_AA64ISAR0_EL1 and return the kernels the CPU supports, or
+ *   NULL if it implements none of the AES, PMULL and SHA256 instructions.
+ *
+ ****************************************************************************/
+
+FAR const struct crypto_accel_s *crypto_accel_arm64(void)
+{
+  FAR struct crypto_accel_s *accel = &g_accel_arm64;
+  uint64_t isar0;
+  bool found = false;
+
+  __asm__ volatile ("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+  if (ISAR0_AES(isar0) >= 1)
+    {
+      accel->aes_deckey  = accel_aes_deckey;
+      accel->aes_encrypt = accel_aes_encrypt;
+      accel->aes_decrypt = accel_aes_decrypt;
+      found = true;
+    }
+
+  if (ISAR0_AES(isar0) >= 2)
+    {
+      accel->ghash     = accel_ghash;
+      accel->gcm_crypt = accel_gcm_crypt;
+    }
+
+  if (ISAR0_SHA2(isar0) >= 1)
+    {
+      accel->sha256 = accel_sha256;
+      found = true;
+    }
+
+  return found ? accel : NULL;
+}
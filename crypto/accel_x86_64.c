@@ -0,0 +1,527 @@
+/****************************************************************************
+ * crypto/accel_x86_64.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* AES-NI, PCLMULQDQ and SHA extensions kernels.  The file is built with
+ * the generic x86_64 flags, the instructions are enabled per function so
+ * that nothing here runs before crypto_accel_x86_64() has seen the CPUID
+ * feature bits.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cpuid.h>
+#include <immintrin.h>
+
+#include <crypto/accel.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ACCEL_AES     __attribute__((target("aes,sse4.1")))
+#define ACCEL_GHASH   __attribute__((target("pclmul,ssse3")))
+#define ACCEL_GCM     __attribute__((target("aes,pclmul,sse4.1")))
+#define ACCEL_SHA     __attribute__((target("sha,sse4.1")))
+
+/* CPUID feature bits */
+
+#define CPUID1_ECX_PCLMUL  (1 << 1)
+#define CPUID1_ECX_SSE41   (1 << 19)
+#define CPUID1_ECX_AES     (1 << 25)
+#define CPUID7_EBX_SHA     (1 << 29)
+
+/* Blocks encrypted in parallel to fill the AES pipeline */
+
+#define ACCEL_AES_LANES    4
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint32_t g_sha256_k[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static struct crypto_accel_s g_accel_x86_64 =
+{
+  "x86_64"
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: accel_aes_deckey
+ *
+ * Description:
+ *   Derive the equivalent inverse cipher schedule used by AESDEC.
+ *
+ ****************************************************************************/
+
+ACCEL_AES
+static void accel_aes_deckey(FAR uint8_t *dk, FAR const uint8_t *ek,
+                             unsigned int nr)
+{
+  __m128i rk;
+  unsigned int i;
+
+  rk = _mm_loadu_si128((FAR const __m128i *)(ek + 16 * nr));
+  _mm_storeu_si128((FAR __m128i *)dk, rk);
+
+  for (i = 1; i < nr; i++)
+    {
+      rk = _mm_loadu_si128((FAR const __m128i *)(ek + 16 * (nr - i)));
+      _mm_storeu_si128((FAR __m128i *)(dk + 16 * i), _mm_aesimc_si128(rk));
+    }
+
+  rk = _mm_loadu_si128((FAR const __m128i *)ek);
+  _mm_storeu_si128((FAR __m128i *)(dk + 16 * nr), rk);
+}
+
+ACCEL_AES
+static void accel_aes_encrypt(FAR const uint8_t *ek, unsigned int nr,
+                              FAR const uint8_t *src, FAR uint8_t *dst,
+                              size_t nblocks)
+{
+  FAR const __m128i *rk = (FAR const __m128i *)ek;
+  __m128i b[ACCEL_AES_LANES];
+  __m128i k;
+  unsigned int r;
+  unsigned int j;
+
+  for (; nblocks >= ACCEL_AES_LANES; nblocks -= ACCEL_AES_LANES)
+    {
+      k = _mm_loadu_si128(&rk[0]);
+      for (j = 0; j < ACCEL_AES_LANES; j++)
+        {
+          b[j] = _mm_loadu_si128((FAR const __m128i *)src + j);
+          b[j] = _mm_xor_si128(b[j], k);
+        }
+
+      for (r = 1; r < nr; r++)
+        {
+          k = _mm_loadu_si128(&rk[r]);
+          for (j = 0; j < ACCEL_AES_LANES; j++)
+            {
+              b[j] = _mm_aesenc_si128(b[j], k);
+            }
+        }
+
+      k = _mm_loadu_si128(&rk[nr]);
+      for (j = 0; j < ACCEL_AES_LANES; j++)
+        {
+          b[j] = _mm_aesenclast_si128(b[j], k);
+          _mm_storeu_si128((FAR __m128i *)dst + j, b[j]);
+        }
+
+      src += 16 * ACCEL_AES_LANES;
+      dst += 16 * ACCEL_AES_LANES;
+    }
+
+  for (; nblocks > 0; nblocks--)
+    {
+      b[0] = _mm_loadu_si128((FAR const __m128i *)src);
+      b[0] = _mm_xor_si128(b[0], _mm_loadu_si128(&rk[0]));
+      for (r = 1; r < nr; r++)
+        {
+          b[0] = _mm_aesenc_si128(b[0], _mm_loadu_si128(&rk[r]));
+        }
+
+      b[0] = _mm_aesenclast_si128(b[0], _mm_loadu_si128(&rk[nr]));
+      _mm_storeu_si128((FAR __m128i *)dst, b[0]);
+
+      src += 16;
+      dst += 16;
+    }
+}
+
+ACCEL_AES
+static void accel_aes_decrypt(FAR const uint8_t *dk, unsigned int nr,
+                              FAR const uint8_t *src, FAR uint8_t *dst,
+                              size_t nblocks)
+{
+  FAR const __m128i *rk = (FAR const __m128i *)dk;
+  __m128i b[ACCEL_AES_LANES];
+  __m128i k;
+  unsigned int r;
+  unsigned int j;
+
+  for (; nblocks >= ACCEL_AES_LANES; nblocks -= ACCEL_AES_LANES)
+    {
+      k = _mm_loadu_si128(&rk[0]);
+      for (j = 0; j < ACCEL_AES_LANES; j++)
+        {
+          b[j] = _mm_loadu_si128((FAR const __m128i *)src + j);
+          b[j] = _mm_xor_si128(b[j], k);
+        }
+
+      for (r = 1; r < nr; r++)
+        {
+          k = _mm_loadu_si128(&rk[r]);
+          for (j = 0; j < ACCEL_AES_LANES; j++)
+            {
+              b[j] = _mm_aesdec_si128(b[j], k);
+            }
+        }
+
+      k = _mm_loadu_si128(&rk[nr]);
+      for (j = 0; j < ACCEL_AES_LANES; j++)
+        {
+          b[j] = _mm_aesdeclast_si128(b[j], k);
+          _mm_storeu_si128((FAR __m128i *)dst + j, b[j]);
+        }
+
+      src += 16 * ACCEL_AES_LANES;
+      dst += 16 * ACCEL_AES_LANES;
+    }
+
+  for (; nblocks > 0; nblocks--)
+    {
+      b[0] = _mm_loadu_si128((FAR const __m128i *)src);
+      b[0] = _mm_xor_si128(b[0], _mm_loadu_si128(&rk[0]));
+      for (r = 1; r < nr; r++)
+        {
+          b[0] = _mm_aesdec_si128(b[0], _mm_loadu_si128(&rk[r]));
+        }
+
+      b[0] = _mm_aesdeclast_si128(b[0], _mm_loadu_si128(&rk[nr]));
+      _mm_storeu_si128((FAR __m128i *)dst, b[0]);
+
+      src += 16;
+      dst += 16;
+    }
+}
+
+/****************************************************************************
+ * Name: accel_gfmul
+ *
+ * Description:
+ *   Multiply two byte reversed GF(2^128) elements: carry-less multiply,
+ *   shift the 256-bit product left by one for the reflected bit order and
+ *   reduce modulo x^128 + x^7 + x^2 + x + 1 (Intel GCM white paper).
+ *
+ ****************************************************************************/
+
+ACCEL_GHASH
+static inline __m128i accel_gfmul(__m128i a, __m128i b)
+{
+  __m128i lo;
+  __m128i mid;
+  __m128i hi;
+  __m128i t1;
+  __m128i t2;
+  __m128i t3;
+
+  lo  = _mm_clmulepi64_si128(a, b, 0x00);
+  mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10),
+                      _mm_clmulepi64_si128(a, b, 0x01));
+  hi  = _mm_clmulepi64_si128(a, b, 0x11);
+
+  lo  = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+  hi  = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+  /* Shift the product <hi:lo> left by one bit */
+
+  t1  = _mm_srli_epi32(lo, 31);
+  t2  = _mm_srli_epi32(hi, 31);
+  lo  = _mm_slli_epi32(lo, 1);
+  hi  = _mm_slli_epi32(hi, 1);
+
+  t3  = _mm_srli_si128(t1, 12);
+  t2  = _mm_slli_si128(t2, 4);
+  t1  = _mm_slli_si128(t1, 4);
+  lo  = _mm_or_si128(lo, t1);
+  hi  = _mm_or_si128(hi, t2);
+  hi  = _mm_or_si128(hi, t3);
+
+  /* First phase of the reduction */
+
+  t1  = _mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30));
+  t1  = _mm_xor_si128(t1, _mm_slli_epi32(lo, 25));
+  t2  = _mm_srli_si128(t1, 4);
+  t1  = _mm_slli_si128(t1, 12);
+  lo  = _mm_xor_si128(lo, t1);
+
+  /* Second phase of the reduction */
+
+  t1  = _mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2));
+  t1  = _mm_xor_si128(t1, _mm_srli_epi32(lo, 7));
+  t1  = _mm_xor_si128(t1, t2);
+  lo  = _mm_xor_si128(lo, t1);
+
+  return _mm_xor_si128(hi, lo);
+}
+
+ACCEL_GHASH
+static inline __m128i accel_bswap128(__m128i x)
+{
+  const __m128i rev = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                   8, 9, 10, 11, 12, 13, 14, 15);
+
+  return _mm_shuffle_epi8(x, rev);
+}
+
+ACCEL_GHASH
+static void accel_ghash(FAR uint8_t *z, FAR const uint8_t *h,
+                        FAR const uint8_t *x, size_t nblocks)
+{
+  __m128i hh = accel_bswap128(_mm_loadu_si128((FAR const __m128i *)h));
+  __m128i zz = accel_bswap128(_mm_loadu_si128((FAR const __m128i *)z));
+  __m128i xx;
+
+  for (; nblocks > 0; nblocks--)
+    {
+      xx = accel_bswap128(_mm_loadu_si128((FAR const __m128i *)x));
+      zz = accel_gfmul(_mm_xor_si128(zz, xx), hh);
+      x += 16;
+    }
+
+  _mm_storeu_si128((FAR __m128i *)z, accel_bswap128(zz));
+}
+
+/****************************************************************************
+ * Name: accel_gcm_crypt
+ *
+ * Description:
+ *   Encrypt ACCEL_AES_LANES counter blocks at a time and fold the
+ *   ciphertext into GHASH while the next batch is in flight, so that the
+ *   data is only read and written once.
+ *
+ ****************************************************************************/
+
+ACCEL_GCM
+static void accel_gcm_crypt(FAR const uint8_t *ek, unsigned int nr,
+                            FAR uint8_t *ctr, FAR uint8_t *z,
+                            FAR const uint8_t *h, FAR const uint8_t *src,
+                            FAR uint8_t *dst, size_t nblocks, bool encrypt)
+{
+  FAR const __m128i *rk = (FAR const __m128i *)ek;
+  __m128i hh = accel_bswap128(_mm_loadu_si128((FAR const __m128i *)h));
+  __m128i zz = accel_bswap128(_mm_loadu_si128((FAR const __m128i *)z));
+  __m128i cb = _mm_loadu_si128((FAR const __m128i *)ctr);
+  __m128i b[ACCEL_AES_LANES];
+  __m128i in[ACCEL_AES_LANES];
+  __m128i k;
+  uint32_t c;
+  unsigned int lanes;
+  unsigned int r;
+  unsigned int j;
+
+  c = __builtin_bswap32((uint32_t)_mm_extract_epi32(cb, 3));
+
+  while (nblocks > 0)
+    {
+      lanes = nblocks < ACCEL_AES_LANES ? nblocks : ACCEL_AES_LANES;
+
+      k = _mm_loadu_si128(&rk[0]);
+      for (j = 0; j < lanes; j++)
+        {
+          cb   = _mm_insert_epi32(cb, (int)__builtin_bswap32(++c), 3);
+          b[j] = _mm_xor_si128(cb, k);
+        }
+
+      for (r = 1; r < nr; r++)
+        {
+          k = _mm_loadu_si128(&rk[r]);
+          for (j = 0; j < lanes; j++)
+            {
+              b[j] = _mm_aesenc_si128(b[j], k);
+            }
+        }
+
+      k = _mm_loadu_si128(&rk[nr]);
+      for (j = 0; j < lanes; j++)
+        {
+          in[j] = _mm_loadu_si128((FAR const __m128i *)src + j);
+          b[j]  = _mm_xor_si128(_mm_aesenclast_si128(b[j], k), in[j]);
+          _mm_storeu_si128((FAR __m128i *)dst + j, b[j]);
+        }
+
+      for (j = 0; j < lanes; j++)
+        {
+          zz = _mm_xor_si128(zz, accel_bswap128(encrypt ? b[j] : in[j]));
+          zz = accel_gfmul(zz, hh);
+        }
+
+      src     += 16 * lanes;
+      dst     += 16 * lanes;
+      nblocks -= lanes;
+    }
+
+  _mm_storeu_si128((FAR __m128i *)ctr, cb);
+  _mm_storeu_si128((FAR __m128i *)z, accel_bswap128(zz));
+}
+
+/****************************************************************************
+ * Name: accel_sha256
+ *
+ * Description:
+ *   SHA-256 compression over 'nblocks' 64-byte blocks with the SHA
+ *   extensions.  SHA256RNDS2 keeps the state as ABEF/CDGH pairs, the
+ *   conversion from and to the A..H layout is done once per call.
+ *
+ ****************************************************************************/
+
+ACCEL_SHA
+static void accel_sha256(FAR uint32_t *state, FAR const uint8_t *data,
+                         size_t nblocks)
+{
+  const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bull,
+                                      0x0405060700010203ull);
+  __m128i msg[4];
+  __m128i state0;
+  __m128i state1;
+  __m128i save0;
+  __m128i save1;
+  __m128i tmp;
+  unsigned int i;
+
+  tmp    = _mm_loadu_si128((FAR const __m128i *)&state[0]);
+  state1 = _mm_loadu_si128((FAR const __m128i *)&state[4]);
+
+  tmp    = _mm_shuffle_epi32(tmp, 0xb1);            /* CDAB */
+  state1 = _mm_shuffle_epi32(state1, 0x1b);         /* EFGH */
+  state0 = _mm_alignr_epi8(tmp, state1, 8);         /* ABEF */
+  state1 = _mm_blend_epi16(state1, tmp, 0xf0);      /* CDGH */
+
+  for (; nblocks > 0; nblocks--)
+    {
+      save0 = state0;
+      save1 = state1;
+
+      for (i = 0; i < 16; i++)
+        {
+          if (i < 4)
+            {
+              msg[i] = _mm_loadu_si128((FAR const __m128i *)data + i);
+              msg[i] = _mm_shuffle_epi8(msg[i], mask);
+            }
+          else
+            {
+              tmp = _mm_alignr_epi8(msg[(i + 3) & 3], msg[(i + 2) & 3], 4);
+              msg[i & 3] = _mm_sha256msg1_epu32(msg[i & 3],
+                                                msg[(i + 1) & 3]);
+              msg[i & 3] = _mm_add_epi32(msg[i & 3], tmp);
+              msg[i & 3] = _mm_sha256msg2_epu32(msg[i & 3],
+                                                msg[(i + 3) & 3]);
+            }
+
+          tmp    = _mm_loadu_si128((FAR const __m128i *)&g_sha256_k[4 * i]);
+          tmp    = _mm_add_epi32(msg[i & 3], tmp);
+          state1 = _mm_sha256rnds2_epu32(state1, state0, tmp);
+          tmp    = _mm_shuffle_epi32(tmp, 0x0e);
+          state0 = _mm_sha256rnds2_epu32(state0, state1, tmp);
+        }
+
+      state0 = _mm_add_epi32(state0, save0);
+      state1 = _mm_add_epi32(state1, save1);
+      data  += 64;
+    }
+
+  tmp    = _mm_shuffle_epi32(state0, 0x1b);         /* FEBA */
+  state1 = _mm_shuffle_epi32(state1, 0xb1);         /* DCHG */
+  state0 = _mm_blend_epi16(tmp, state1, 0xf0);      /* DCBA */
+  state1 = _mm_alignr_epi8(state1, tmp, 8);         /* HGFE */
+
+  _mm_storeu_si128((FAR __m128i *)&state[0], state0);
+  _mm_storeu_si128((FAR __m128i *)&state[4], state1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crypto_accel_x86_64
+ *
+ * Description:
+ *   Probe CPUID and return the kernels the CPU supports, or NULL if it has
+ *   none of AES-NI, PCLMULQDQ and the SHA extensions.
+ *
+ ****************************************************************************/
+
+FAR const struct crypto_accel_s *crypto_accel_x86_64(void)
+{
+  FAR struct crypto_accel_s *accel = &g_accel_x86_64;
+  unsigned int eax;
+  unsigned int ebx;
+  unsigned int ecx;
+  unsigned int edx;
+  bool found = false;
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) ||
+      (ecx & CPUID1_ECX_SSE41) == 0)
+    {
+      return NULL;
+    }
+
+  if (ecx & CPUID1_ECX_AES)
+    {
+      accel->aes_deckey  = accel_aes_deckey;
+      accel->aes_encrypt = accel_aes_encrypt;
+      accel->aes_decrypt = accel_aes_decrypt;
+      found = true;
+    }
+
+  if (ecx & CPUID1_ECX_PCLMUL)
+    {
+      accel->ghash = accel_ghash;
+      if (ecx & CPUID1_ECX_AES)
+        {
+          accel->gcm_crypt = accel_gcm_crypt;
+        }
+
+      found = true;
+    }
+
+  if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) &&
+      (ebx & CPUID7_EBX_SHA) != 0)
+    {
+      accel->sha256 = accel_sha256;
+      found = true;
+    }
+
+  return found ? accel : NULL;
+}
@@ -34,6 +34,7 @@
 #include <string.h>
 #include <sys/types.h>
 #include <crypto/aes.h>
+#include <crypto/accel.h>
 
 /****************************************************************************
  * Public Functions
@@ -842,8 +843,28 @@ void aes_ct_bitslice_decrypt(unsigned num_rounds,
   add_round_key(q, skey);
 }
 
+#ifdef CONFIG_CRYPTO_ACCEL
+static FAR const struct crypto_accel_s *aes_accel(void)
+{
+  FAR const struct crypto_accel_s *accel = crypto_accel();
+
+  return accel != NULL && accel->aes_encrypt != NULL ? accel : NULL;
+}
+#endif
+
 int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 {
+#ifdef CONFIG_CRYPTO_ACCEL
+  FAR const struct crypto_accel_s *accel = aes_accel();
+
+  if (accel != NULL)
+    {
+      ctx->num_rounds = crypto_accel_aes_setkey(accel, AES_ACCEL_EK(ctx),
+                                                AES_ACCEL_DK(ctx), key, len);
+      return ctx->num_rounds == 0 ? -1 : 0;
+    }
+#endif
+
   ctx->num_rounds = aes_ct_keysched(ctx->sk, key, len);
   if (ctx->num_rounds == 0)
     {
@@ -857,6 +878,17 @@ int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef CONFIG_CRYPTO_ACCEL
+  FAR const struct crypto_accel_s *accel = aes_accel();
+
+  if (accel != NULL)
+    {
+      accel->aes_encrypt(AES_ACCEL_EK(ctx), ctx->num_rounds,
+                         src, dst, num_blocks);
+      return;
+    }
+#endif
+
   while (num_blocks > 0)
     {
       uint32_t q[8];
@@ -907,6 +939,17 @@ void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
 void aes_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef CONFIG_CRYPTO_ACCEL
+  FAR const struct crypto_accel_s *accel = aes_accel();
+
+  if (accel != NULL)
+    {
+      accel->aes_decrypt(AES_ACCEL_DK(ctx), ctx->num_rounds,
+                         src, dst, num_blocks);
+      return;
+    }
+#endif
+
   while (num_blocks > 0)
     {
       uint32_t q[8];
@@ -43,6 +43,8 @@
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/drivers/drivers.h>
@@ -71,9 +73,30 @@ int cryptodevallowsoft = 0;
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/* A request submitted with CIOCCRYPTM.  It waits on the pending queue of
+ * its session until the worker runs it, then on the done queue of the
+ * fcrypt until it is fetched with CIOCCRYPTMFETCH.
+ */
+
+struct cryptodev_req
+{
+  TAILQ_ENTRY(cryptodev_req) next;
+  FAR struct csession *cse;
+  FAR struct crypt_op *uop;     /* The caller's request, returned on fetch */
+  struct crypt_op cop;          /* Private copy of the request */
+  int status;
+};
+
+TAILQ_HEAD(cryptodev_reqlist, cryptodev_req);
+#endif
+
 struct csession
 {
   TAILQ_ENTRY(csession) next;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  struct cryptodev_reqlist pending; /* Submitted, not yet run */
+#endif
   uint64_t sid;
   uint32_t ses;
 
@@ -95,6 +118,14 @@ struct fcrypt
 {
   TAILQ_HEAD(csessionlist, csession) csessions;
   int sesn;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  mutex_t lock;                  /* Protects the request queues */
+  struct work_s work;            /* Runs the pending requests */
+  struct cryptodev_reqlist done; /* Completed, not yet fetched */
+  int nreqs;                     /* Requests pending or done */
+  bool stop;                     /* Worker must return early */
+  FAR struct pollfd *fds[CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -179,6 +210,17 @@ int cryptodev_dokey(FAR struct crypt_kop *kop, FAR struct crparam *kvp);
 int cryptodev_cb(FAR struct cryptop *);
 int cryptodevkey_cb(FAR struct cryptkop *);
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static void fcrinit(FAR struct fcrypt *fcr);
+static void cryptodev_worker(FAR void *arg);
+static int cryptodev_submit(FAR struct fcrypt *fcr,
+                            FAR struct crypt_mop *mop);
+static int cryptodev_fetch(FAR struct fcrypt *fcr,
+                           FAR struct crypt_fetch *fetch);
+static void cryptodev_flush(FAR struct fcrypt *fcr,
+                            FAR struct csession *cse);
+#endif
+
 /* ARGSUSED */
 
 static ssize_t cryptof_read(FAR struct file *filep,
@@ -351,6 +393,9 @@ bail:
             return -EINVAL;
           }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+        cryptodev_flush(fcr, cse);
+#endif
         csedelete(fcr, cse);
         error = csefree(cse);
         break;
@@ -364,6 +409,14 @@ bail:
 
         error = cryptodev_op(cse, cop);
         break;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      case CIOCCRYPTM:
+        error = cryptodev_submit(fcr, (FAR struct crypt_mop *)arg);
+        break;
+      case CIOCCRYPTMFETCH:
+        error = cryptodev_fetch(fcr, (FAR struct crypt_fetch *)arg);
+        break;
+#endif
       case CIOCKEY:
         error = cryptodev_key((FAR struct crypt_kop *)arg);
         break;
@@ -725,7 +778,59 @@ fail:
 static int cryptof_poll(FAR struct file *filep,
                         FAR struct pollfd *fds, bool setup)
 {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct fcrypt *fcr = filep->f_priv;
+  pollevent_t eventset = 0;
+  int ret = OK;
+  int i;
+
+  nxmutex_lock(&fcr->lock);
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS; i++)
+        {
+          if (fcr->fds[i] == NULL)
+            {
+              fcr->fds[i] = fds;
+              fds->priv = &fcr->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS)
+        {
+          ret = -EBUSY;
+          goto out;
+        }
+
+      /* Completed requests can be fetched, and more can be submitted
+       * while the queue has room.
+       */
+
+      if (!TAILQ_EMPTY(&fcr->done))
+        {
+          eventset |= POLLIN;
+        }
+
+      if (fcr->nreqs < CONFIG_CRYPTO_CRYPTODEV_ASYNC_MAXREQS)
+        {
+          eventset |= POLLOUT;
+        }
+
+      poll_notify(&fds, 1, eventset);
+    }
+  else if (fds->priv != NULL)
+    {
+      *(FAR struct pollfd **)fds->priv = NULL;
+      fds->priv = NULL;
+    }
+
+out:
+  nxmutex_unlock(&fcr->lock);
+  return ret;
+#else
   return 0;
+#endif
 }
 
 /* ARGSUSED */
@@ -734,6 +839,18 @@ static int cryptof_close(FAR struct file *filep)
 {
   FAR struct fcrypt *fcr = filep->f_priv;
   FAR struct csession *cse;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct cryptodev_req *req;
+
+  cryptodev_flush(fcr, NULL);
+  while ((req = TAILQ_FIRST(&fcr->done)) != NULL)
+    {
+      TAILQ_REMOVE(&fcr->done, req, next);
+      kmm_free(req);
+    }
+
+  nxmutex_destroy(&fcr->lock);
+#endif
 
   while ((cse = TAILQ_FIRST(&fcr->csessions)))
     {
@@ -781,6 +898,10 @@ static int cryptof_open(FAR struct file *filep)
     }
 
   TAILQ_INIT(&fcrd->csessions);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  fcrinit(fcrd);
+#endif
+
   TAILQ_FOREACH(cse, &fcr->csessions, next)
     {
       bzero(&crie, sizeof(crie));
@@ -899,8 +1020,16 @@ static int cryptoioctl(FAR struct file *filep, int cmd, unsigned long arg)
   switch (cmd)
     {
       case CRIOGET:
-        fcr = kmm_malloc(sizeof(struct fcrypt));
+        fcr = kmm_zalloc(sizeof(struct fcrypt));
+        if (fcr == NULL)
+          {
+            return -ENOMEM;
+          }
+
         TAILQ_INIT(&fcr->csessions);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+        fcrinit(fcr);
+#endif
 
         fd = file_allocate(&g_cryptoinode, 0,
                            0, fcr, 0, true);
@@ -979,6 +1108,9 @@ FAR struct csession *csecreate(FAR struct fcrypt *fcr, uint64_t sid,
       cse->txform = txform;
       cse->thash = thash;
       cse->error = 0;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      TAILQ_INIT(&cse->pending);
+#endif
       cseadd(fcr, cse);
     }
 
@@ -1004,6 +1136,219 @@ int csefree(FAR struct csession *cse)
   return error;
 }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static void fcrinit(FAR struct fcrypt *fcr)
+{
+  nxmutex_init(&fcr->lock);
+  TAILQ_INIT(&fcr->done);
+  fcr->nreqs = 0;
+  fcr->stop = false;
+}
+
+/* Run the pending requests, taking one request from each session in turn
+ * so that a long batch on one session does not starve the others.
+ * Requests of the same session run in submission order, which keeps
+ * COP_FLAG_UPDATE streams and chained IVs correct.
+ */
+
+static void cryptodev_worker(FAR void *arg)
+{
+  FAR struct fcrypt *fcr = arg;
+  FAR struct cryptodev_req *req;
+  FAR struct csession *cse;
+
+  nxmutex_lock(&fcr->lock);
+  while (!fcr->stop)
+    {
+      req = NULL;
+      TAILQ_FOREACH(cse, &fcr->csessions, next)
+        {
+          req = TAILQ_FIRST(&cse->pending);
+          if (req != NULL)
+            {
+              TAILQ_REMOVE(&cse->pending, req, next);
+
+              /* Rotate the session to the tail for the next round */
+
+              TAILQ_REMOVE(&fcr->csessions, cse, next);
+              TAILQ_INSERT_TAIL(&fcr->csessions, cse, next);
+              break;
+            }
+        }
+
+      if (req == NULL)
+        {
+          break;
+        }
+
+      /* The session cannot go away while this runs: freeing it goes
+       * through cryptodev_flush(), which waits for the worker.
+       */
+
+      nxmutex_unlock(&fcr->lock);
+      req->status = cryptodev_op(req->cse, &req->cop);
+      nxmutex_lock(&fcr->lock);
+
+      TAILQ_INSERT_TAIL(&fcr->done, req, next);
+      poll_notify(fcr->fds, CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS, POLLIN);
+    }
+
+  nxmutex_unlock(&fcr->lock);
+}
+
+/* CIOCCRYPTM: queue a batch of requests.  Returns the number of requests
+ * queued, which is less than mop->count if the queue filled up.
+ */
+
+static int cryptodev_submit(FAR struct fcrypt *fcr,
+                            FAR struct crypt_mop *mop)
+{
+  FAR struct cryptodev_req *req;
+  FAR struct csession *cse;
+  uint32_t i;
+  int ret = 0;
+
+  nxmutex_lock(&fcr->lock);
+
+  for (i = 0; i < mop->count; i++)
+    {
+      if (fcr->nreqs >= CONFIG_CRYPTO_CRYPTODEV_ASYNC_MAXREQS)
+        {
+          break;
+        }
+
+      cse = csefind(fcr, mop->reqs[i].ses);
+      if (cse == NULL)
+        {
+          ret = -EINVAL;
+          break;
+        }
+
+      req = kmm_malloc(sizeof(struct cryptodev_req));
+      if (req == NULL)
+        {
+          ret = -ENOMEM;
+          break;
+        }
+
+      req->cse = cse;
+      req->uop = &mop->reqs[i];
+      req->status = 0;
+      memcpy(&req->cop, &mop->reqs[i], sizeof(struct crypt_op));
+
+      TAILQ_INSERT_TAIL(&cse->pending, req, next);
+      fcr->nreqs++;
+    }
+
+  if (i > 0)
+    {
+      if (!fcr->stop && work_available(&fcr->work))
+        {
+          work_queue(LPWORK, &fcr->work, cryptodev_worker, fcr, 0);
+        }
+
+      ret = i;
+    }
+  else if (ret == 0 && mop->count > 0)
+    {
+      ret = -EAGAIN;
+    }
+
+  nxmutex_unlock(&fcr->lock);
+  return ret;
+}
+
+/* CIOCCRYPTMFETCH: return completed requests without blocking.  Use
+ * poll() for POLLIN to wait for completions.
+ */
+
+static int cryptodev_fetch(FAR struct fcrypt *fcr,
+                           FAR struct crypt_fetch *fetch)
+{
+  FAR struct cryptodev_req *req;
+  uint32_t n = 0;
+
+  nxmutex_lock(&fcr->lock);
+
+  while (n < fetch->count && (req = TAILQ_FIRST(&fcr->done)) != NULL)
+    {
+      TAILQ_REMOVE(&fcr->done, req, next);
+      fcr->nreqs--;
+
+      fetch->results[n].op = req->uop;
+      fetch->results[n].status = req->status;
+      n++;
+
+      kmm_free(req);
+    }
+
+  fetch->count = n;
+
+  if (n > 0)
+    {
+      poll_notify(fcr->fds, CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS, POLLOUT);
+    }
+
+  nxmutex_unlock(&fcr->lock);
+  return OK;
+}
+
+/* Cancel the pending requests of 'cse' (of all sessions if NULL) and wait
+ * for the one being run, so that the session may be freed.  Cancelled
+ * requests complete with -ECANCELED.
+ */
+
+static void cryptodev_flush(FAR struct fcrypt *fcr,
+                            FAR struct csession *cse)
+{
+  FAR struct cryptodev_req *req;
+  FAR struct csession *tmp;
+
+  nxmutex_lock(&fcr->lock);
+  fcr->stop = true;
+
+  TAILQ_FOREACH(tmp, &fcr->csessions, next)
+    {
+      if (cse != NULL && tmp != cse)
+        {
+          continue;
+        }
+
+      while ((req = TAILQ_FIRST(&tmp->pending)) != NULL)
+        {
+          TAILQ_REMOVE(&tmp->pending, req, next);
+          req->status = -ECANCELED;
+          TAILQ_INSERT_TAIL(&fcr->done, req, next);
+        }
+    }
+
+  nxmutex_unlock(&fcr->lock);
+
+  work_cancel_sync(LPWORK, &fcr->work);
+
+  /* Restart the worker for the requests of the other sessions */
+
+  nxmutex_lock(&fcr->lock);
+  fcr->stop = false;
+
+  TAILQ_FOREACH(tmp, &fcr->csessions, next)
+    {
+      if (!TAILQ_EMPTY(&tmp->pending))
+        {
+          work_queue(LPWORK, &fcr->work, cryptodev_worker, fcr, 0);
+          break;
+        }
+    }
+
+  if (!TAILQ_EMPTY(&fcr->done))
+    {
+      poll_notify(fcr->fds, CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS, POLLIN);
+    }
+
+  nxmutex_unlock(&fcr->lock);
+}
+#endif /* CONFIG_CRYPTO_CRYPTODEV_ASYNC */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -438,7 +438,23 @@ int swcr_authenc(FAR struct cryptop *crp)
 
   if (buf)
     {
-      for (i = 0; i < crde->crd_len; i += blksz)
+      /* Full AES-GCM blocks go through the fused CPU instruction path
+       * when there is one, the tail through the loop below.
+       */
+
+      i = 0;
+      if (crp->crp_dst && swe->sw_alg == CRYPTO_AES_GCM_16 &&
+          blksz == GMAC_BLOCK_LEN)
+        {
+          i = blksz * aes_gcm_crypt_accel((caddr_t)swe->sw_kschedule,
+                                          &ctx.aes_gmac_ctx.ghash,
+                                          (FAR const uint8_t *)buf,
+                                          (FAR uint8_t *)crp->crp_dst,
+                                          crde->crd_len / blksz,
+                                          crde->crd_flags & CRD_F_ENCRYPT);
+        }
+
+      for (; i < crde->crd_len; i += blksz)
         {
           len = MIN(crde->crd_len - i, blksz);
           if (len < blksz)
@@ -33,6 +33,7 @@
 #include <sys/param.h>
 #include <crypto/aes.h>
 #include <crypto/gmac.h>
+#include <crypto/accel.h>
 
 /****************************************************************************
  * Public Functions
@@ -40,12 +41,21 @@
 
 void ghash_gfmul(FAR uint32_t *, FAR uint32_t *, FAR uint32_t *);
 void ghash_update_mi(FAR GHASH_CTX *, FAR uint8_t *, size_t);
+#ifdef CONFIG_CRYPTO_ACCEL
+void ghash_update_accel(FAR GHASH_CTX *, FAR uint8_t *, size_t);
+#endif
 
 /* Allow overriding with optimized MD function */
 
+#ifdef CONFIG_CRYPTO_ACCEL
+CODE void (*ghash_update)(FAR GHASH_CTX *,
+                          FAR uint8_t *,
+                          size_t) = ghash_update_accel;
+#else
 CODE void (*ghash_update)(FAR GHASH_CTX *,
                           FAR uint8_t *,
                           size_t) = ghash_update_mi;
+#endif
 
 /* Computes a block multiplication in the GF(2^128) */
 
@@ -116,6 +126,31 @@ void ghash_update_mi(FAR GHASH_CTX *ctx, FAR uint8_t *X, size_t len)
   bcopy(ctx->S, ctx->Z, GMAC_BLOCK_LEN);
 }
 
+#ifdef CONFIG_CRYPTO_ACCEL
+/* Carry-less multiply version, same Z/S contract as ghash_update_mi() */
+
+void ghash_update_accel(FAR GHASH_CTX *ctx, FAR uint8_t *X, size_t len)
+{
+  FAR const struct crypto_accel_s *accel = crypto_accel();
+
+  if (accel == NULL || accel->ghash == NULL)
+    {
+      ghash_update_mi(ctx, X, len);
+      return;
+    }
+
+  if (len >= GMAC_BLOCK_LEN)
+    {
+      accel->ghash(ctx->Z, ctx->H, X, len / GMAC_BLOCK_LEN);
+      bcopy(ctx->Z, ctx->S, GMAC_BLOCK_LEN);
+    }
+  else
+    {
+      bcopy(ctx->S, ctx->Z, GMAC_BLOCK_LEN);
+    }
+}
+#endif
+
 #define AESCTR_NONCESIZE 4
 
 void aes_gmac_init(FAR void *xctx)
@@ -36,8 +36,14 @@
 #include <nuttx/board.h>
 #include <nuttx/clock.h>
 #include <nuttx/mutex.h>
+#include <nuttx/sched.h>
 #include <nuttx/crypto/blake2s.h>
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+#  define KEYSTREAM_ONLY
+#  include "chacha_private.h"
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -45,6 +51,13 @@
 #define ROTL_32(x,n) (((x) << (n)) | ((x) >> (32 - (n))))
 #define ROTR_32(x,n) (((x) >> (n)) | ((x) << (32 - (n))))
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+#  define RNG_KEYSZ    32
+#  define RNG_IVSZ     8
+#  define RNG_SEEDSZ   (RNG_KEYSZ + RNG_IVSZ)
+#  define RNG_BUFSZ    (16 * 64)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -69,10 +82,26 @@ struct rng_s
   volatile uint8_t rd_rotate;
   volatile uint8_t rd_prev_time;
   volatile uint16_t rd_prev_irq;
+  volatile uint32_t rd_seq; /* Incremented by every reseed */
   bool output_initialized;
   struct blake2xs_rng_s blake2xs;
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+/* ChaCha20 output generator of one CPU, keyed from the BLAKE2Xs output.
+ * Only the task running on the CPU uses it, with the scheduler locked.
+ */
+
+struct rng_cpu_s
+{
+  chacha_ctx ctx;
+  uint8_t buf[RNG_BUFSZ];   /* Keystream, the last have bytes unused */
+  size_t have;
+  size_t count;             /* Bytes to output before the next reseed */
+  uint32_t seq;             /* rd_seq of the seed */
+};
+#endif
+
 enum
 {
   POOL_SIZE = ENTROPY_POOL_SIZE,
@@ -102,6 +131,10 @@ static struct rng_s g_rng =
 static struct entropy_pool_s entropy_pool;
 #endif
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+static struct rng_cpu_s g_rng_cpu[CONFIG_SMP_NCPUS];
+#endif
+
 /* Polynomial from paper "The Linux Pseudorandom Number Generator Revisited"
  * x^POOL_SIZE + x^104 + x^76 + x^51 + x^25 + x + 1
  */
@@ -304,6 +337,7 @@ static void rng_reseed(void)
   g_rng.blake2xs.param.node_depth = 0;
 
   g_rng.output_initialized = true;
+  g_rng.rd_seq++;
 }
 
 static void rng_buf_internal(FAR uint8_t *bytes, size_t nbytes)
@@ -357,6 +391,120 @@ static void rng_buf_internal(FAR uint8_t *bytes, size_t nbytes)
     }
 }
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+
+/* The per-CPU ChaCha20 generators follow the arc4random of OpenBSD.  Each
+ * buffer of keystream starts with the key and IV for the next one (fast
+ * key erasure), and output bytes are cleared once used, so a later
+ * compromise of the state reveals nothing that was output before.
+ */
+
+static void rng_cpu_rekey(FAR struct rng_cpu_s *rs,
+                          FAR const uint8_t *seed)
+{
+  int i;
+
+  chacha_encrypt_bytes(&rs->ctx, NULL, rs->buf, RNG_BUFSZ);
+
+  if (seed != NULL)
+    {
+      for (i = 0; i < RNG_SEEDSZ; i++)
+        {
+          rs->buf[i] ^= seed[i];
+        }
+    }
+
+  chacha_keysetup(&rs->ctx, rs->buf, RNG_KEYSZ * 8);
+  chacha_ivsetup(&rs->ctx, rs->buf + RNG_KEYSZ, NULL);
+  explicit_bzero(rs->buf, RNG_SEEDSZ);
+  rs->have = RNG_BUFSZ - RNG_SEEDSZ;
+}
+
+static void rng_cpu_stir(FAR struct rng_cpu_s *rs,
+                         FAR const uint8_t *seed, uint32_t seq)
+{
+  if (rs->count == 0 && rs->seq == 0)
+    {
+      /* First seed of this CPU */
+
+      chacha_keysetup(&rs->ctx, seed, RNG_KEYSZ * 8);
+      chacha_ivsetup(&rs->ctx, seed + RNG_KEYSZ, NULL);
+    }
+  else
+    {
+      rng_cpu_rekey(rs, seed);
+    }
+
+  explicit_bzero(rs->buf, sizeof(rs->buf));
+  rs->have = 0;
+  rs->count = CONFIG_CRYPTO_RANDOM_POOL_RESEED_BYTES;
+  rs->seq = seq;
+}
+
+static bool rng_cpu_needseed(FAR struct rng_cpu_s *rs)
+{
+  /* Reseed after count bytes, after the pool has reseeded, and when the
+   * pool has collected enough new entropy to reseed.
+   */
+
+  return rs->count < RNG_BUFSZ || rs->seq != g_rng.rd_seq ||
+         g_rng.rd_newentr >= MAX_SEED_NEW_ENTROPY_WORDS;
+}
+
+static void rng_cpu_buf(FAR uint8_t *bytes, size_t nbytes)
+{
+  FAR struct rng_cpu_s *rs;
+  FAR uint8_t *keystream;
+  uint8_t seed[RNG_SEEDSZ];
+  uint32_t seq;
+  size_t m;
+
+  while (nbytes > 0)
+    {
+      sched_lock();
+      rs = &g_rng_cpu[this_cpu()];
+
+      if (rng_cpu_needseed(rs))
+        {
+          /* The pool lock may block, so get the seed with the scheduler
+           * unlocked, then install it on whichever CPU we run on now.
+           */
+
+          sched_unlock();
+
+          nxmutex_lock(&g_rng.rd_lock);
+          rng_buf_internal(seed, sizeof(seed));
+          seq = g_rng.rd_seq;
+          nxmutex_unlock(&g_rng.rd_lock);
+
+          sched_lock();
+          rs = &g_rng_cpu[this_cpu()];
+          rng_cpu_stir(rs, seed, seq);
+          explicit_bzero(seed, sizeof(seed));
+        }
+
+      /* At most one buffer of keystream per scheduler lock */
+
+      if (rs->have == 0)
+        {
+          rng_cpu_rekey(rs, NULL);
+        }
+
+      m = MIN(nbytes, rs->have);
+      keystream = rs->buf + RNG_BUFSZ - rs->have;
+      memcpy(bytes, keystream, m);
+      explicit_bzero(keystream, m);
+      rs->have -= m;
+      rs->count -= m;
+
+      sched_unlock();
+
+      bytes += m;
+      nbytes -= m;
+    }
+}
+#endif /* CONFIG_CRYPTO_RANDOM_POOL_PERCPU */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -529,9 +677,13 @@ void up_randompool_initialize(void)
 
 void arc4random_buf(FAR void *bytes, size_t nbytes)
 {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  rng_cpu_buf(bytes, nbytes);
+#else
   nxmutex_lock(&g_rng.rd_lock);
   rng_buf_internal(bytes, nbytes);
   nxmutex_unlock(&g_rng.rd_lock);
+#endif
 }
 
 /****************************************************************************
@@ -34,6 +34,7 @@
 #include <sys/param.h>
 
 #include <crypto/rijndael.h>
+#include <crypto/accel.h>
 
 #undef FULL_UNROLL
 
@@ -1356,6 +1357,19 @@ static void rijndaeldecrypt(FAR const uint32_t *rk,
   PUTU32(pt + 12, s3);
 }
 
+#ifdef CONFIG_CRYPTO_ACCEL
+/* With CPU AES instructions ek and dk hold the byte order schedules of
+ * crypto_accel_aes_setkey() instead of the table based ones.
+ */
+
+static FAR const struct crypto_accel_s *rijndael_accel(void)
+{
+  FAR const struct crypto_accel_s *accel = crypto_accel();
+
+  return accel != NULL && accel->aes_encrypt != NULL ? accel : NULL;
+}
+#endif
+
 /* setup key context for encryption only */
 
 int rijndael_set_key_enc_only(FAR rijndael_ctx *ctx,
@@ -1364,6 +1378,23 @@ int rijndael_set_key_enc_only(FAR rijndael_ctx *ctx,
 {
   int rounds;
 
+#ifdef CONFIG_CRYPTO_ACCEL
+  if (rijndael_accel() != NULL)
+    {
+      rounds = crypto_accel_aes_setkey(rijndael_accel(),
+                                       (FAR uint8_t *)ctx->ek, NULL,
+                                       key, bits / 8);
+      if (rounds == 0)
+        {
+          return -1;
+        }
+
+      ctx->nr = rounds;
+      ctx->enc_only = 1;
+      return 0;
+    }
+#endif
+
   rounds = rijndael_key_setup_enc(ctx->ek, key, bits);
   if (rounds == 0)
     {
@@ -1382,6 +1413,24 @@ int rijndael_set_key(FAR rijndael_ctx *ctx, FAR const u_char *key, int bits)
 {
   int rounds;
 
+#ifdef CONFIG_CRYPTO_ACCEL
+  if (rijndael_accel() != NULL)
+    {
+      rounds = crypto_accel_aes_setkey(rijndael_accel(),
+                                       (FAR uint8_t *)ctx->ek,
+                                       (FAR uint8_t *)ctx->dk,
+                                       key, bits / 8);
+      if (rounds == 0)
+        {
+          return -1;
+        }
+
+      ctx->nr = rounds;
+      ctx->enc_only = 0;
+      return 0;
+    }
+#endif
+
   rounds = rijndael_key_setup_enc(ctx->ek, key, bits);
   if (rounds == 0)
     {
@@ -1403,6 +1452,15 @@ void rijndael_decrypt(FAR rijndael_ctx *ctx,
                       FAR const u_char *src,
                       FAR u_char *dst)
 {
+#ifdef CONFIG_CRYPTO_ACCEL
+  if (rijndael_accel() != NULL)
+    {
+      rijndael_accel()->aes_decrypt((FAR const uint8_t *)ctx->dk, ctx->nr,
+                                    src, dst, 1);
+      return;
+    }
+#endif
+
   rijndaeldecrypt(ctx->dk, ctx->nr, src, dst);
 }
 
@@ -1410,5 +1468,14 @@ void rijndael_encrypt(FAR rijndael_ctx *ctx,
                       FAR const u_char *src,
                       FAR u_char *dst)
 {
+#ifdef CONFIG_CRYPTO_ACCEL
+  if (rijndael_accel() != NULL)
+    {
+      rijndael_accel()->aes_encrypt((FAR const uint8_t *)ctx->ek, ctx->nr,
+                                    src, dst, 1);
+      return;
+    }
+#endif
+
   rijndaelencrypt(ctx->ek, ctx->nr, src, dst);
 }
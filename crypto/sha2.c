@@ -42,6 +42,7 @@
 #include <string.h>
 #include <sys/time.h>
 #include <crypto/sha2.h>
+#include <crypto/accel.h>
 
 /* UNROLLED TRANSFORM LOOP NOTE:
  * You can define SHA2_UNROLL_TRANSFORM to use the unrolled transform
@@ -521,6 +522,30 @@ void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
 
 #endif /* SHA2_UNROLL_TRANSFORM */
 
+/* Process 'nblocks' complete blocks, with the CPU SHA-256 instructions
+ * when available.
+ */
+
+static void sha256blocks(FAR uint32_t *state, FAR const uint8_t *data,
+                         size_t nblocks)
+{
+#ifdef CONFIG_CRYPTO_ACCEL
+  FAR const struct crypto_accel_s *accel = crypto_accel();
+
+  if (accel != NULL && accel->sha256 != NULL)
+    {
+      accel->sha256(state, data, nblocks);
+      return;
+    }
+#endif
+
+  for (; nblocks > 0; nblocks--)
+    {
+      sha256transform(state, data);
+      data += SHA256_BLOCK_LENGTH;
+    }
+}
+
 void sha256update(FAR SHA2_CTX *context,
                   FAR const void *dataptr,
                   size_t len)
@@ -528,6 +553,7 @@ void sha256update(FAR SHA2_CTX *context,
   FAR const uint8_t *data = dataptr;
   size_t freespace;
   size_t usedspace;
+  size_t nblocks;
 
   /* Calling with no data is valid (we do nothing) */
 
@@ -551,7 +577,7 @@ void sha256update(FAR SHA2_CTX *context,
           context->bitcount[0] += freespace << 3;
           len -= freespace;
           data += freespace;
-          sha256transform(context->state.st32, context->buffer);
+          sha256blocks(context->state.st32, context->buffer, 1);
         }
       else
         {
@@ -567,14 +593,16 @@ void sha256update(FAR SHA2_CTX *context,
         }
     }
 
-  while (len >= SHA256_BLOCK_LENGTH)
+  if (len >= SHA256_BLOCK_LENGTH)
     {
       /* Process as many complete blocks as we can */
 
-      sha256transform(context->state.st32, data);
-      context->bitcount[0] += SHA256_BLOCK_LENGTH << 3;
-      len -= SHA256_BLOCK_LENGTH;
-      data += SHA256_BLOCK_LENGTH;
+      nblocks = len / SHA256_BLOCK_LENGTH;
+      sha256blocks(context->state.st32, data, nblocks);
+      nblocks *= SHA256_BLOCK_LENGTH;
+      context->bitcount[0] += nblocks << 3;
+      len -= nblocks;
+      data += nblocks;
     }
 
   if (len > 0)
@@ -625,7 +653,7 @@ void sha256last(FAR SHA2_CTX *context)
 
           /* Do second-to-last transform: */
 
-          sha256transform(context->state.st32, context->buffer);
+          sha256blocks(context->state.st32, context->buffer, 1);
 
           /* And set-up for the last transform: */
 
@@ -651,7 +679,7 @@ void sha256last(FAR SHA2_CTX *context)
 
   /* Final transform: */
 
-  sha256transform(context->state.st32, context->buffer);
+  sha256blocks(context->state.st32, context->buffer, 1);
 }
 
 void sha256final(FAR uint8_t *digest, FAR SHA2_CTX *context)
@@ -67,6 +67,7 @@
 #include <crypto/cast.h>
 #include <crypto/rijndael.h>
 #include <crypto/aes.h>
+#include <crypto/accel.h>
 #include <crypto/cryptodev.h>
 #include <crypto/xform.h>
 #include <crypto/gmac.h>
@@ -635,6 +636,34 @@ void aes_ctr_crypt(caddr_t key, FAR uint8_t *data)
   explicit_bzero(keystream, sizeof(keystream));
 }
 
+/* Encrypt or decrypt 'nblocks' full GCM blocks and update GHASH over the
+ * ciphertext in a single pass with the CPU instructions.  Returns the
+ * number of blocks processed, 0 if the caller has to use the block at a
+ * time path.
+ */
+
+size_t aes_gcm_crypt_accel(caddr_t key, FAR GHASH_CTX *ghash,
+                           FAR const uint8_t *src, FAR uint8_t *dst,
+                           size_t nblocks, int encrypt)
+{
+#ifdef CONFIG_CRYPTO_ACCEL
+  FAR const struct crypto_accel_s *accel = crypto_accel();
+  FAR struct aes_ctr_ctx *ctx = (FAR struct aes_ctr_ctx *)key;
+
+  if (accel != NULL && accel->aes_encrypt != NULL &&
+      accel->gcm_crypt != NULL && nblocks > 0)
+    {
+      accel->gcm_crypt(AES_ACCEL_EK(&ctx->ac_key), ctx->ac_key.num_rounds,
+                       ctx->ac_block, ghash->Z, ghash->H, src, dst,
+                       nblocks, encrypt != 0);
+      bcopy(ghash->Z, ghash->S, GMAC_BLOCK_LEN);
+      return nblocks;
+    }
+#endif
+
+  return 0;
+}
+
 int aes_ctr_setkey(FAR void *sched, FAR uint8_t *key, int len)
 {
   FAR struct aes_ctr_ctx *ctx;
@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 
 #include <unistd.h>
 #include <string.h>
@@ -58,6 +59,10 @@ static ssize_t bch_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen);
 static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
                          size_t buflen);
+static ssize_t bch_readv(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt);
+static ssize_t bch_writev(FAR struct file *filep,
+                          FAR const struct iovec *iov, int iovcnt);
 static int     bch_ioctl(FAR struct file *filep, int cmd,
                          unsigned long arg);
 static int     bch_poll(FAR struct file *filep, FAR struct pollfd *fds,
@@ -80,10 +85,12 @@ const struct file_operations g_bch_fops =
   bch_ioctl,   /* ioctl */
   NULL,        /* mmap */
   NULL,        /* truncate */
-  bch_poll     /* poll */
+  bch_poll,    /* poll */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  , bch_unlink /* unlink */
+  bch_unlink,  /* unlink */
 #endif
+  bch_readv,   /* readv */
+  bch_writev   /* writev */
 };
 
 /****************************************************************************
@@ -347,6 +354,112 @@ static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
   return ret;
 }
 
+/****************************************************************************
+ * Name: bch_readv
+ *
+ * Description:
+ *   Read all segments under one lock.  Segments that share a sector are
+ *   served from the sector buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t bch_readv(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct bchlib_s *bch;
+  ssize_t nread = 0;
+  ssize_t ret;
+  int i;
+
+  DEBUGASSERT(inode->i_private);
+  bch = inode->i_private;
+
+  ret = nxmutex_lock(&bch->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      ret = bchlib_read(bch, iov[i].iov_base, filep->f_pos,
+                        iov[i].iov_len);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      filep->f_pos += ret;
+      nread        += ret;
+      if ((size_t)ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&bch->lock);
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: bch_writev
+ ****************************************************************************/
+
+static ssize_t bch_writev(FAR struct file *filep,
+                          FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct bchlib_s *bch;
+  ssize_t nwritten = 0;
+  ssize_t ret;
+  int i;
+
+  DEBUGASSERT(inode->i_private);
+  bch = inode->i_private;
+
+  if (bch->readonly)
+    {
+      return -EACCES;
+    }
+
+  ret = nxmutex_lock(&bch->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      ret = bchlib_write(bch, iov[i].iov_base, filep->f_pos,
+                         iov[i].iov_len);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      filep->f_pos += ret;
+      nwritten     += ret;
+      if ((size_t)ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&bch->lock);
+  return nwritten > 0 ? nwritten : ret;
+}
+
 /****************************************************************************
  * Name: bch_ioctl
  *
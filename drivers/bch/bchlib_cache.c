@@ -31,6 +31,8 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/fs/procfs.h>
+
 #include "bch.h"
 
 #if defined(CONFIG_BCH_ENCRYPTION)
@@ -125,7 +127,9 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 
       /* Write the sector to the media */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+      ret = PRESSURE_STALL(PRESSURE_IO,
+                           inode->u.i_bops->write(inode, bch->buffer,
+                                                  bch->sector, 1));
       if (ret < 0)
         {
           ferr("Write failed: %zd\n", ret);
@@ -194,7 +198,9 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
           return (int)ret;
         }
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      ret = PRESSURE_STALL(PRESSURE_IO,
+                           inode->u.i_bops->read(inode, bch->buffer,
+                                                 sector, 1));
       if (ret < 0)
         {
           ferr("Read failed: %zd\n", ret);
@@ -32,6 +32,7 @@
 #include <debug.h>
 
 #include <nuttx/drivers/drivers.h>
+#include <nuttx/fs/procfs.h>
 
 #include "bch.h"
 
@@ -146,8 +147,10 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
-                                       sector, nsectors);
+      ret = PRESSURE_STALL(PRESSURE_IO,
+                           bch->inode->u.i_bops->read(bch->inode,
+                                                      (FAR uint8_t *)buffer,
+                                                      sector, nsectors));
       if (ret < 0)
         {
           ferr("ERROR: Read failed: %d\n", ret);
@@ -34,6 +34,7 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/drivers/drivers.h>
+#include <nuttx/fs/procfs.h>
 
 #include "bch.h"
 
@@ -143,8 +144,10 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       /* Write the contiguous sectors */
 
-      ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
-                                        sector, nsectors);
+      ret = PRESSURE_STALL(PRESSURE_IO,
+                           bch->inode->u.i_bops->write(bch->inode,
+                                                       (FAR uint8_t *)buffer,
+                                                       sector, nsectors));
       if (ret < 0)
         {
           ferr("ERROR: Write failed: %d\n", ret);
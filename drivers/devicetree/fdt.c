@@ -23,6 +23,9 @@
  ****************************************************************************/
 
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
 #include <endian.h>
 #include <errno.h>
 #include <assert.h>
@@ -31,6 +34,52 @@
 #include <nuttx/fdt.h>
 #include <libfdt.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_DEVICE_TREE_INDEX
+#  define FDT_INDEX_NBUCKETS  (CONFIG_DEVICE_TREE_INDEX_NCOMPAT / 4 + 1)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_DEVICE_TREE_INDEX
+/* One compatible string of one node.  The entries of a hash chain are
+ * linked in descending node offset order.
+ */
+
+struct fdt_compat_s
+{
+  uint32_t hash;
+  int offset;
+  int16_t next;
+};
+
+struct fdt_phandle_s
+{
+  uint32_t phandle;
+  int offset;
+};
+
+/* Index of the registered tree, built by one walk of the tree in
+ * fdt_register().  A table that overflowed is not used.
+ */
+
+struct fdt_index_s
+{
+  bool compat_valid;
+  bool phandle_valid;
+  int ncompat;
+  int nphandle;
+  int16_t bucket[FDT_INDEX_NBUCKETS];
+  struct fdt_compat_s compat[CONFIG_DEVICE_TREE_INDEX_NCOMPAT];
+  struct fdt_phandle_s phandle[CONFIG_DEVICE_TREE_INDEX_NPHANDLE];
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -39,6 +88,157 @@
 
 static FAR const char *g_fdt_base = NULL;
 
+#ifdef CONFIG_DEVICE_TREE_INDEX
+static struct fdt_index_s g_fdt_index;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_DEVICE_TREE_INDEX
+/****************************************************************************
+ * Name: fdt_hash
+ *
+ * Description:
+ *   FNV-1a hash of a compatible string.
+ *
+ ****************************************************************************/
+
+static uint32_t fdt_hash(FAR const char *str, int len)
+{
+  uint32_t hash = 2166136261u;
+
+  while (len-- > 0 && *str != '\0')
+    {
+      hash = (hash ^ (uint8_t)*str++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: fdt_index_phandle
+ *
+ * Description:
+ *   Insert a phandle into the table sorted by phandle.  Phandles are
+ *   mostly allocated in tree order, so this is an append most of the time.
+ *
+ ****************************************************************************/
+
+static void fdt_index_phandle(FAR struct fdt_index_s *index,
+                              uint32_t phandle, int offset)
+{
+  int i;
+
+  if (index->nphandle >= CONFIG_DEVICE_TREE_INDEX_NPHANDLE)
+    {
+      index->phandle_valid = false;
+      return;
+    }
+
+  for (i = index->nphandle++;
+       i > 0 && index->phandle[i - 1].phandle > phandle; i--)
+    {
+      index->phandle[i] = index->phandle[i - 1];
+    }
+
+  index->phandle[i].phandle = phandle;
+  index->phandle[i].offset  = offset;
+}
+
+/****************************************************************************
+ * Name: fdt_index_compat
+ *
+ * Description:
+ *   Add all of the compatible strings of a node to the hash table.
+ *
+ ****************************************************************************/
+
+static void fdt_index_compat(FAR struct fdt_index_s *index,
+                             FAR const char *list, int len, int offset)
+{
+  FAR struct fdt_compat_s *compat;
+  unsigned int bucket;
+  int slen;
+
+  while (len > 0)
+    {
+      if (index->ncompat >= CONFIG_DEVICE_TREE_INDEX_NCOMPAT)
+        {
+          index->compat_valid = false;
+          return;
+        }
+
+      slen = strnlen(list, len) + 1;
+
+      compat         = &index->compat[index->ncompat];
+      compat->hash   = fdt_hash(list, slen);
+      compat->offset = offset;
+
+      bucket                = compat->hash % FDT_INDEX_NBUCKETS;
+      compat->next          = index->bucket[bucket];
+      index->bucket[bucket] = index->ncompat++;
+
+      list += slen;
+      len  -= slen;
+    }
+}
+
+/****************************************************************************
+ * Name: fdt_index_build
+ *
+ * Description:
+ *   Walk the tree once and index the compatible strings and the phandles
+ *   of all of its nodes.
+ *
+ ****************************************************************************/
+
+static void fdt_index_build(FAR const void *fdt)
+{
+  FAR struct fdt_index_s *index = &g_fdt_index;
+  FAR const char *list;
+  uint32_t phandle;
+  int offset;
+  int len;
+  int i;
+
+  index->compat_valid  = true;
+  index->phandle_valid = true;
+  index->ncompat       = 0;
+  index->nphandle      = 0;
+
+  for (i = 0; i < FDT_INDEX_NBUCKETS; i++)
+    {
+      index->bucket[i] = -1;
+    }
+
+  for (offset = fdt_next_node(fdt, -1, NULL); offset >= 0;
+       offset = fdt_next_node(fdt, offset, NULL))
+    {
+      phandle = fdt_get_phandle(fdt, offset);
+      if (phandle != 0 && index->phandle_valid)
+        {
+          fdt_index_phandle(index, phandle, offset);
+        }
+
+      list = fdt_getprop(fdt, offset, "compatible", &len);
+      if (list != NULL && index->compat_valid)
+        {
+          fdt_index_compat(index, list, len, offset);
+        }
+    }
+
+  if (offset != -FDT_ERR_NOTFOUND)
+    {
+      /* A broken tree, leave it to libfdt to report that */
+
+      index->compat_valid  = false;
+      index->phandle_valid = false;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -56,6 +256,11 @@ int fdt_register(FAR const char *fdt_base)
     }
 
   g_fdt_base = fdt_base;
+
+#ifdef CONFIG_DEVICE_TREE_INDEX
+  fdt_index_build(fdt_base);
+#endif
+
   return OK;
 }
 
@@ -64,6 +269,84 @@ FAR const char *fdt_get(void)
   return g_fdt_base;
 }
 
+int fdt_node_by_compatible(FAR const void *fdt, int startoffset,
+                           FAR const char *compatible)
+{
+#ifdef CONFIG_DEVICE_TREE_INDEX
+  FAR struct fdt_index_s *index = &g_fdt_index;
+  FAR struct fdt_compat_s *compat;
+  uint32_t hash;
+  int offset = -FDT_ERR_NOTFOUND;
+  int i;
+
+  if (fdt == g_fdt_base && index->compat_valid)
+    {
+      hash = fdt_hash(compatible, INT_MAX);
+      for (i = index->bucket[hash % FDT_INDEX_NBUCKETS]; i >= 0;
+           i = compat->next)
+        {
+          compat = &index->compat[i];
+          if (compat->offset <= startoffset)
+            {
+              break;
+            }
+
+          /* The chain is in descending order, the last match is the
+           * first node after startoffset.
+           */
+
+          if (compat->hash == hash && compat->offset != offset &&
+              fdt_node_check_compatible(fdt, compat->offset,
+                                        compatible) == 0)
+            {
+              offset = compat->offset;
+            }
+        }
+
+      return offset;
+    }
+#endif
+
+  return fdt_node_offset_by_compatible(fdt, startoffset, compatible);
+}
+
+int fdt_node_by_phandle(FAR const void *fdt, uint32_t phandle)
+{
+#ifdef CONFIG_DEVICE_TREE_INDEX
+  FAR struct fdt_index_s *index = &g_fdt_index;
+  int low;
+  int high;
+  int mid;
+
+  if (fdt == g_fdt_base && index->phandle_valid)
+    {
+      low  = 0;
+      high = index->nphandle - 1;
+
+      while (low <= high)
+        {
+          mid = (low + high) / 2;
+          if (index->phandle[mid].phandle == phandle)
+            {
+              return index->phandle[mid].offset;
+            }
+          else if (index->phandle[mid].phandle < phandle)
+            {
+              low = mid + 1;
+            }
+          else
+            {
+              high = mid - 1;
+            }
+        }
+
+      return -FDT_ERR_NOTFOUND;
+    }
+#endif
+
+  return fdt_node_offset_by_phandle(fdt, phandle);
+}
+
 int fdt_get_irq(FAR const void *fdt, int nodeoffset,
                 int offset, int irqbase)
 {
@@ -283,7 +566,7 @@ uintptr_t fdt_get_clock_frequency_from_clocks(FAR const void *fdt,
 
   clk_phandle = fdt32_ld(pv + index);
 
-  pv_offset = fdt_node_offset_by_phandle(fdt, clk_phandle);
+  pv_offset = fdt_node_by_phandle(fdt, clk_phandle);
   if (pv_offset < 0)
     {
       return clock_frequency;
@@ -342,8 +625,7 @@ void fdt_node_from_compat(FAR const void *fdt,
     {
       while (true)
         {
-          offset
-              = fdt_node_offset_by_compatible(fdt, offset, *compatible_ids);
+          offset = fdt_node_by_compatible(fdt, offset, *compatible_ids);
           if (offset == -FDT_ERR_NOTFOUND)
             {
               break;
@@ -0,0 +1,298 @@
+/****************************************************************************
+ * drivers/devicetree/fdt_probe.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/fdt.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/queue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <libfdt.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define FDT_PROBE_NWORKERS CONFIG_SCHED_LPNTHREADS
+#else
+#  define FDT_PROBE_NWORKERS 0
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One round of probing, shared by the caller and the workers */
+
+struct fdt_probe_round_s
+{
+  FAR const void *fdt;
+  FAR int *result;                   /* Result of each node, by index */
+  FAR int *offset;                   /* Offset of each node, by index */
+  FAR sq_entry_t *next;              /* Next driver to claim */
+  spinlock_t lock;                   /* Protects next */
+  sem_t done;                        /* Posted by each worker */
+#if FDT_PROBE_NWORKERS > 0
+  struct work_s work[FDT_PROBE_NWORKERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sq_queue_t g_fdt_probe_queue;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fdt_probe_worker
+ *
+ * Description:
+ *   Claim the queued drivers one after the other and probe their nodes
+ *   which were not probed successfully yet, in tree order.
+ *
+ ****************************************************************************/
+
+static void fdt_probe_worker(FAR void *arg)
+{
+  FAR struct fdt_probe_round_s *round = arg;
+  FAR struct fdt_probe_s *probe;
+  irqstate_t flags;
+  int i;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&round->lock);
+      probe = (FAR struct fdt_probe_s *)round->next;
+      if (probe != NULL)
+        {
+          round->next = sq_next(&probe->node);
+        }
+
+      spin_unlock_irqrestore(&round->lock, flags);
+
+      if (probe == NULL)
+        {
+          break;
+        }
+
+      for (i = probe->first; i < probe->first + probe->count; i++)
+        {
+          if (round->result[i] == -EAGAIN)
+            {
+              round->result[i] = probe->probe(round->fdt, round->offset[i]);
+            }
+        }
+    }
+}
+
+#if FDT_PROBE_NWORKERS > 0
+static void fdt_probe_work(FAR void *arg)
+{
+  FAR struct fdt_probe_round_s *round = arg;
+
+  fdt_probe_worker(round);
+  nxsem_post(&round->done);
+}
+#endif
+
+/****************************************************************************
+ * Name: fdt_probe_count
+ *
+ * Description:
+ *   Find the available nodes matching a driver, storing their offsets if
+ *   offset is not NULL.
+ *
+ ****************************************************************************/
+
+static int fdt_probe_count(FAR const void *fdt,
+                           FAR struct fdt_probe_s *probe,
+                           FAR int *offset)
+{
+  FAR const char * const *compat;
+  int count = 0;
+  int node;
+
+  for (compat = probe->compatible_ids; *compat != NULL; compat++)
+    {
+      for (node = fdt_node_by_compatible(fdt, -1, *compat); node >= 0;
+           node = fdt_node_by_compatible(fdt, node, *compat))
+        {
+          if (fdt_device_is_available(fdt, node))
+            {
+              if (offset != NULL)
+                {
+                  offset[count] = node;
+                }
+
+              count++;
+            }
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fdt_probe_register
+ ****************************************************************************/
+
+void fdt_probe_register(FAR struct fdt_probe_s *probe)
+{
+  DEBUGASSERT(probe != NULL && probe->compatible_ids != NULL &&
+              probe->probe != NULL);
+
+  sq_addlast(&probe->node, &g_fdt_probe_queue);
+}
+
+/****************************************************************************
+ * Name: fdt_probe_all
+ ****************************************************************************/
+
+int fdt_probe_all(FAR const void *fdt)
+{
+  FAR struct fdt_probe_round_s *round;
+  FAR struct fdt_probe_s *probe;
+  FAR sq_entry_t *entry;
+  int pending;
+  int last;
+  int total = 0;
+  int ret = OK;
+  int i;
+
+  if (fdt == NULL)
+    {
+      return -EINVAL;
+    }
+
+  for (entry = sq_peek(&g_fdt_probe_queue); entry != NULL;
+       entry = sq_next(entry))
+    {
+      probe        = (FAR struct fdt_probe_s *)entry;
+      probe->first = total;
+      probe->count = fdt_probe_count(fdt, probe, NULL);
+      total       += probe->count;
+    }
+
+  round = kmm_zalloc(sizeof(*round) + 2 * total * sizeof(int));
+  if (round == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  round->fdt    = fdt;
+  round->result = (FAR int *)(round + 1);
+  round->offset = round->result + total;
+  spin_lock_init(&round->lock);
+  nxsem_init(&round->done, 0, 0);
+
+  for (entry = sq_peek(&g_fdt_probe_queue); entry != NULL;
+       entry = sq_next(entry))
+    {
+      probe = (FAR struct fdt_probe_s *)entry;
+      fdt_probe_count(fdt, probe, round->offset + probe->first);
+    }
+
+  for (i = 0; i < total; i++)
+    {
+      round->result[i] = -EAGAIN;
+    }
+
+  /* Probe the nodes until all are done, or until a round makes no
+   * progress and the remaining ones wait for something that never comes.
+   * Each driver probes its own nodes in order in one thread, while
+   * different drivers probe in parallel on the low priority work queue
+   * threads and the caller.
+   */
+
+  pending = total;
+  do
+    {
+      last        = pending;
+      round->next = sq_peek(&g_fdt_probe_queue);
+
+#if FDT_PROBE_NWORKERS > 0
+      for (i = 0; i < FDT_PROBE_NWORKERS; i++)
+        {
+          work_queue(LPWORK, &round->work[i], fdt_probe_work, round, 0);
+        }
+#endif
+
+      fdt_probe_worker(round);
+
+#if FDT_PROBE_NWORKERS > 0
+      for (i = 0; i < FDT_PROBE_NWORKERS; i++)
+        {
+          nxsem_wait_uninterruptible(&round->done);
+        }
+#endif
+
+      for (pending = i = 0; i < total; i++)
+        {
+          if (round->result[i] == -EAGAIN)
+            {
+              pending++;
+            }
+        }
+    }
+  while (pending > 0 && pending < last);
+
+  for (entry = sq_peek(&g_fdt_probe_queue); entry != NULL;
+       entry = sq_next(entry))
+    {
+      probe = (FAR struct fdt_probe_s *)entry;
+      for (i = probe->first; i < probe->first + probe->count; i++)
+        {
+          if (round->result[i] < 0)
+            {
+              _err("ERROR: Probe of %s failed: %d\n",
+                   fdt_get_name(fdt, round->offset[i], NULL),
+                   round->result[i]);
+              ret = round->result[i];
+            }
+        }
+    }
+
+  nxsem_destroy(&round->done);
+  kmm_free(round);
+  return ret;
+}
@@ -0,0 +1,197 @@
+/****************************************************************************
+ * drivers/dma/dma_alloc.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/compiler.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/mm/gran.h>
+#include <nuttx/dma/dma_alloc.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The granule is also the alignment of every buffer.  It must be at least
+ * a D-Cache line, so that two buffers never share a line.
+ */
+
+#define DMA_GRANSIZE  (1 << CONFIG_DMA_ALLOC_LOG2GRAN)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static GRAN_HANDLE g_dma_streaming;
+static GRAN_HANDLE g_dma_coherent;
+
+#if CONFIG_DMA_ALLOC_POOL_SIZE > 0
+static uint8_t g_dma_heap[CONFIG_DMA_ALLOC_POOL_SIZE]
+aligned_data(DMA_GRANSIZE);
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_alloc_initialize
+ *
+ * Description:
+ *   Set up the streaming pool reserved with CONFIG_DMA_ALLOC_POOL_SIZE.
+ *   Called once by drivers_initialize().
+ *
+ ****************************************************************************/
+
+void dma_alloc_initialize(void)
+{
+#if CONFIG_DMA_ALLOC_POOL_SIZE > 0
+  int ret;
+#endif
+
+  DEBUGASSERT(DMA_GRANSIZE >= up_get_dcache_linesize());
+
+#if CONFIG_DMA_ALLOC_POOL_SIZE > 0
+  ret = dma_pool_register(g_dma_heap, sizeof(g_dma_heap), false);
+  if (ret < 0)
+    {
+      dmaerr("ERROR: Failed to set up the DMA pool: %d\n", ret);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: dma_pool_register
+ *
+ * Description:
+ *   Hand a region of memory reserved at boot to the DMA allocator.
+ *
+ * Input Parameters:
+ *   start    - Start of the region, aligned to the granule.
+ *   size     - Size of the region in bytes.
+ *   coherent - True for the coherent pool, false for the streaming pool.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int dma_pool_register(FAR void *start, size_t size, bool coherent)
+{
+  FAR GRAN_HANDLE *pool = coherent ? &g_dma_coherent : &g_dma_streaming;
+
+  DEBUGASSERT(((uintptr_t)start & (DMA_GRANSIZE - 1)) == 0);
+
+  if (*pool != NULL)
+    {
+      return -EBUSY;
+    }
+
+  *pool = gran_initialize(start, size, CONFIG_DMA_ALLOC_LOG2GRAN,
+                          CONFIG_DMA_ALLOC_LOG2GRAN);
+  return *pool != NULL ? OK : -ENOMEM;
+}
+
+/****************************************************************************
+ * Name: dma_alloc
+ *
+ * Description:
+ *   Allocate a physically contiguous, cache line aligned streaming buffer.
+ *
+ ****************************************************************************/
+
+FAR void *dma_alloc(size_t size)
+{
+  if (g_dma_streaming != NULL)
+    {
+      return gran_alloc(g_dma_streaming, size);
+    }
+
+  /* Round up to whole granules so that no other data shares the last
+   * cache line of the buffer.
+   */
+
+  return kmm_memalign(DMA_GRANSIZE, ALIGN_UP(size, DMA_GRANSIZE));
+}
+
+/****************************************************************************
+ * Name: dma_free
+ *
+ * Description:
+ *   Free a buffer from dma_alloc().
+ *
+ ****************************************************************************/
+
+void dma_free(FAR void *mem, size_t size)
+{
+  if (g_dma_streaming != NULL)
+    {
+      gran_free(g_dma_streaming, mem, size);
+    }
+  else
+    {
+      kmm_free(mem);
+    }
+}
+
+/****************************************************************************
+ * Name: dma_alloc_coherent
+ *
+ * Description:
+ *   Allocate a buffer from the coherent pool.
+ *
+ ****************************************************************************/
+
+FAR void *dma_alloc_coherent(size_t size)
+{
+  if (g_dma_coherent == NULL)
+    {
+      return NULL;
+    }
+
+  return gran_alloc(g_dma_coherent, size);
+}
+
+/****************************************************************************
+ * Name: dma_free_coherent
+ *
+ * Description:
+ *   Free a buffer from dma_alloc_coherent().
+ *
+ ****************************************************************************/
+
+void dma_free_coherent(FAR void *mem, size_t size)
+{
+  DEBUGASSERT(g_dma_coherent != NULL);
+  gran_free(g_dma_coherent, mem, size);
+}
@@ -24,6 +24,7 @@
 
 #include <nuttx/clk/clk_provider.h>
 #include <nuttx/crypto/crypto.h>
+#include <nuttx/dma/dma_alloc.h>
 #include <nuttx/drivers/drivers.h>
 #include <nuttx/drivers/rpmsgdev.h>
 #include <nuttx/drivers/rpmsgblk.h>
@@ -37,6 +38,7 @@
 #include <nuttx/net/telnet.h>
 #include <nuttx/note/note_driver.h>
 #include <nuttx/pci/pci.h>
+#include <nuttx/perf_sample.h>
 #include <nuttx/power/pm.h>
 #include <nuttx/power/regulator.h>
 #include <nuttx/reset/reset-controller.h>
@@ -108,6 +110,12 @@ void drivers_initialize(void)
 {
   drivers_trace_begin();
 
+#ifdef CONFIG_DMA_ALLOC
+  /* Reserve the DMA pool before the drivers ask for buffers */
+
+  dma_alloc_initialize();
+#endif
+
   /* Register devices */
 
   syslog_initialize();
@@ -148,6 +156,10 @@ void drivers_initialize(void)
   note_initialize();    /* Non-standard /dev/note */
 #endif
 
+#ifdef CONFIG_PERF_SAMPLE
+  perf_sample_register(); /* Non-standard /dev/perf */
+#endif
+
 #if defined(CONFIG_CLK_RPMSG)
   clk_rpmsg_server_initialize();
 #endif
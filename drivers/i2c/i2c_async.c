@@ -0,0 +1,380 @@
+/****************************************************************************
+ * drivers/i2c/i2c_async.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/i2c/i2c_master.h>
+
+#ifdef CONFIG_I2C_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define I2C_ASYNC_WORK HPWORK
+#else
+#  define I2C_ASYNC_WORK LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The asynchronous request queue of one I2C bus */
+
+struct i2c_async_s
+{
+  FAR struct i2c_master_s *i2c;      /* The bus */
+  spinlock_t lock;                   /* Protects the fields below */
+  FAR struct i2c_request_s *head;    /* Request in progress, then the
+                                      * queued ones */
+  FAR struct i2c_request_s *tail;    /* Last queued request */
+  bool busy;                         /* True while requests are run */
+  struct work_s work;                /* Runs requests without I2C_ASYNC */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_remove
+ *
+ * Description:
+ *   Remove the request at the head of the queue.  If the queue becomes
+ *   empty, it is no longer busy.
+ *
+ ****************************************************************************/
+
+static FAR struct i2c_request_s *
+i2c_async_remove(FAR struct i2c_async_s *async)
+{
+  FAR struct i2c_request_s *req;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&async->lock);
+
+  req = async->head;
+  if (req != NULL)
+    {
+      async->head = req->flink;
+      if (async->head == NULL)
+        {
+          async->tail = NULL;
+        }
+    }
+  else
+    {
+      async->busy = false;
+    }
+
+  spin_unlock_irqrestore(&async->lock, flags);
+  return req;
+}
+
+/****************************************************************************
+ * Name: i2c_async_start
+ *
+ * Description:
+ *   Hand the request at the head of the queue to the lower half.  The
+ *   requests it refuses are completed with the error.
+ *
+ ****************************************************************************/
+
+static void i2c_async_start(FAR struct i2c_async_s *async)
+{
+  FAR struct i2c_request_s *req;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&async->lock);
+      req = async->head;
+      if (req == NULL)
+        {
+          async->busy = false;
+        }
+
+      spin_unlock_irqrestore(&async->lock, flags);
+
+      if (req == NULL)
+        {
+          break;
+        }
+
+      ret = I2C_ASYNC(async->i2c, req);
+      if (ret >= 0)
+        {
+          break;
+        }
+
+      i2cerr("ERROR: I2C_ASYNC failed: %d\n", ret);
+
+      i2c_async_remove(async);
+      req->result = ret;
+      req->callback(req);
+    }
+}
+
+/****************************************************************************
+ * Name: i2c_async_worker
+ *
+ * Description:
+ *   Run the queued requests with I2C_TRANSFER(), for lower halves without
+ *   I2C_ASYNC().
+ *
+ ****************************************************************************/
+
+static void i2c_async_worker(FAR void *arg)
+{
+  FAR struct i2c_async_s *async = arg;
+  FAR struct i2c_request_s *req;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&async->lock);
+      req = async->head;
+      if (req == NULL)
+        {
+          async->busy = false;
+        }
+
+      spin_unlock_irqrestore(&async->lock, flags);
+
+      if (req == NULL)
+        {
+          break;
+        }
+
+      ret = I2C_TRANSFER(async->i2c, req->msgs, req->count);
+      req->result = ret < 0 ? ret : OK;
+
+      i2c_async_remove(async);
+      req->callback(req);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_initialize
+ *
+ * Description:
+ *   Create the asynchronous request queue of an I2C bus.
+ *
+ * Input Parameters:
+ *   i2c - An instance of the lower half I2C driver
+ *
+ * Returned Value:
+ *   The queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct i2c_async_s *i2c_async_initialize(FAR struct i2c_master_s *i2c)
+{
+  FAR struct i2c_async_s *async;
+
+  DEBUGASSERT(i2c != NULL);
+
+  async = kmm_zalloc(sizeof(struct i2c_async_s));
+  if (async != NULL)
+    {
+      async->i2c = i2c;
+      spin_lock_init(&async->lock);
+    }
+
+  return async;
+}
+
+/****************************************************************************
+ * Name: i2c_async_uninitialize
+ *
+ * Description:
+ *   Free a queue created by i2c_async_initialize().
+ *
+ ****************************************************************************/
+
+void i2c_async_uninitialize(FAR struct i2c_async_s *async)
+{
+  DEBUGASSERT(async != NULL && !async->busy);
+  kmm_free(async);
+}
+
+/****************************************************************************
+ * Name: i2c_async_submit
+ *
+ * Description:
+ *   Queue a request and return.
+ *
+ * Input Parameters:
+ *   async - The queue of the bus
+ *   req   - The request to run
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int i2c_async_submit(FAR struct i2c_async_s *async,
+                     FAR struct i2c_request_s *req)
+{
+  irqstate_t flags;
+  bool start;
+
+  if (async == NULL || req == NULL || req->msgs == NULL ||
+      req->count <= 0 || req->callback == NULL)
+    {
+      return -EINVAL;
+    }
+
+  req->flink  = NULL;
+  req->queue  = async;
+  req->result = OK;
+
+  flags = spin_lock_irqsave(&async->lock);
+
+  if (async->tail != NULL)
+    {
+      async->tail->flink = req;
+    }
+  else
+    {
+      async->head = req;
+    }
+
+  async->tail = req;
+
+  /* Only the submitter that finds the queue idle starts it */
+
+  start = !async->busy;
+  async->busy = true;
+
+  spin_unlock_irqrestore(&async->lock, flags);
+
+  if (start)
+    {
+      if (async->i2c->ops->async != NULL)
+        {
+          i2c_async_start(async);
+        }
+      else
+        {
+          work_queue(I2C_ASYNC_WORK, &async->work, i2c_async_worker,
+                     async, 0);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: i2c_async_complete
+ *
+ * Description:
+ *   Called by a lower half that implements I2C_ASYNC() when the request it
+ *   was given is done.
+ *
+ * Input Parameters:
+ *   req    - The request that is done
+ *   result - OK or a negated errno value
+ *
+ ****************************************************************************/
+
+void i2c_async_complete(FAR struct i2c_request_s *req, int result)
+{
+  FAR struct i2c_async_s *async = req->queue;
+
+  DEBUGASSERT(async != NULL && async->head == req);
+
+  i2c_async_remove(async);
+  req->result = result;
+  req->callback(req);
+
+  /* Start the next request right away, from the interrupt handler */
+
+  i2c_async_start(async);
+}
+
+/****************************************************************************
+ * Name: i2c_scan_setup
+ *
+ * Description:
+ *   Build a request that reads the registers of several devices back to
+ *   back in a single sequence.
+ *
+ * Input Parameters:
+ *   req       - The request to build
+ *   msgs      - An array of 2 * nscan messages for the request
+ *   scan      - The devices and registers to read
+ *   nscan     - The number of devices
+ *   frequency - I2C frequency
+ *
+ ****************************************************************************/
+
+void i2c_scan_setup(FAR struct i2c_request_s *req,
+                    FAR struct i2c_msg_s *msgs,
+                    FAR struct i2c_scan_s *scan, int nscan,
+                    uint32_t frequency)
+{
+  int i;
+
+  DEBUGASSERT(req != NULL && msgs != NULL && scan != NULL && nscan > 0);
+
+  for (i = 0; i < nscan; i++, scan++)
+    {
+      /* The register address, then a restarted read */
+
+      msgs->frequency = frequency;
+      msgs->addr      = scan->addr;
+      msgs->flags     = (scan->flags & I2C_M_TEN) | I2C_M_NOSTOP;
+      msgs->buffer    = &scan->reg;
+      msgs->length    = 1;
+      msgs++;
+
+      msgs->frequency = frequency;
+      msgs->addr      = scan->addr;
+      msgs->flags     = (scan->flags & I2C_M_TEN) | I2C_M_READ;
+      msgs->buffer    = scan->buffer;
+      msgs->length    = scan->length;
+      msgs++;
+    }
+
+  req->msgs  = msgs - 2 * nscan;
+  req->count = 2 * nscan;
+}
+
+#endif /* CONFIG_I2C_ASYNC */
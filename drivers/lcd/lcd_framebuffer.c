@@ -26,14 +26,19 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <sys/param.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/board.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/lcd/lcd.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/video/fb.h>
+#include <nuttx/wqueue.h>
 
 #ifdef CONFIG_LCD_FRAMEBUFFER
 
@@ -45,10 +50,34 @@
 
 #define VIDEO_PLANE 0
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+#  ifdef CONFIG_SCHED_LPWORK
+#    define LCDFB_WORK LPWORK
+#  else
+#    define LCDFB_WORK HPWORK
+#  endif
+
+#  define LCDFB_NDAMAGE CONFIG_LCD_FRAMEBUFFER_DAMAGE_NRECTS
+#  define LCDFB_ALIGN   CONFIG_LCD_FRAMEBUFFER_DAMAGE_ALIGN
+#  define LCDFB_PERIOD  USEC2TICK(1000000 / CONFIG_LCD_FRAMEBUFFER_DAMAGE_FPS)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+/* A damaged region of the framebuffer, inclusive coordinates */
+
+struct lcdfb_rect_s
+{
+  fb_coord_t x1;
+  fb_coord_t y1;
+  fb_coord_t x2;
+  fb_coord_t y2;
+};
+#endif
+
 /* This structure describes the LCD framebuffer */
 
 struct lcdfb_dev_s
@@ -63,6 +92,20 @@ struct lcdfb_dev_s
   fb_coord_t yres;                  /* Vertical resolution in pixel rows */
   fb_coord_t stride;                /* Width of a row in bytes */
   uint8_t display;                  /* Display number */
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+  /* Updates are collected here and sent to the LCD once per frame */
+
+  struct work_s work;               /* Flushes the damage */
+  spinlock_t lock;                  /* Protects the fields below */
+  clock_t flushed;                  /* Time of the last flush */
+  uint8_t ndamage;                  /* Number of damaged regions */
+  struct lcdfb_rect_s damage[LCDFB_NDAMAGE];
+#  ifdef CONFIG_FB_SYNC
+  unsigned int nwaiters;            /* Threads waiting for the flush */
+  sem_t flushsem;                   /* Posted after each flush */
+#  endif
+#endif
 };
 
 /****************************************************************************
@@ -71,8 +114,13 @@ struct lcdfb_dev_s
 
 /* Update the LCD when there is a change to the framebuffer */
 
+static int lcdfb_putarea(FAR struct lcdfb_dev_s *priv,
+             FAR const struct fb_area_s *area);
 static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
              FAR const struct fb_area_s *area);
+#if defined(CONFIG_LCD_FRAMEBUFFER_DAMAGE) && defined(CONFIG_FB_SYNC)
+static int lcdfb_waitforvsync(FAR struct fb_vtable_s *vtable);
+#endif
 
 /* Get information about the video controller configuration and the
  * configuration of each color plane.
@@ -152,17 +200,16 @@ static FAR struct lcdfb_dev_s *lcdfb_find(int display)
 }
 
 /****************************************************************************
- * Name: lcdfb_updateearea
+ * Name: lcdfb_putarea
  *
  * Description:
- * Update the LCD when there is a change to the framebuffer.
+ *   Send an area of the framebuffer to the LCD.
  *
  ****************************************************************************/
 
-static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
-                             FAR const struct fb_area_s *area)
+static int lcdfb_putarea(FAR struct lcdfb_dev_s *priv,
+                         FAR const struct fb_area_s *area)
 {
-  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
   FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
   FAR uint8_t *run = priv->fbmem;
   fb_coord_t row;
@@ -255,12 +302,252 @@ static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
         }
     }
 
-  if (pinfo->redraw != NULL)
+  return OK;
+}
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+/****************************************************************************
+ * Name: lcdfb_rect_merge
+ *
+ * Description:
+ *   Grow 'rect' to also cover 'other'.
+ *
+ ****************************************************************************/
+
+static void lcdfb_rect_merge(FAR struct lcdfb_rect_s *rect,
+                             FAR const struct lcdfb_rect_s *other)
+{
+  rect->x1 = MIN(rect->x1, other->x1);
+  rect->y1 = MIN(rect->y1, other->y1);
+  rect->x2 = MAX(rect->x2, other->x2);
+  rect->y2 = MAX(rect->y2, other->y2);
+}
+
+static uint32_t lcdfb_rect_size(FAR const struct lcdfb_rect_s *rect)
+{
+  return (uint32_t)(rect->x2 - rect->x1 + 1) * (rect->y2 - rect->y1 + 1);
+}
+
+/****************************************************************************
+ * Name: lcdfb_flush_work
+ *
+ * Description:
+ *   Send the damaged regions collected during the last frame to the LCD.
+ *
+ ****************************************************************************/
+
+static void lcdfb_flush_work(FAR void *arg)
+{
+  FAR struct lcdfb_dev_s *priv = arg;
+  FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
+  struct lcdfb_rect_s damage[LCDFB_NDAMAGE];
+  struct fb_area_s area;
+  irqstate_t flags;
+  int ndamage;
+  int i;
+#ifdef CONFIG_FB_SYNC
+  unsigned int nwaiters;
+#endif
+
+  flags = spin_lock_irqsave(&priv->lock);
+  ndamage = priv->ndamage;
+  memcpy(damage, priv->damage, ndamage * sizeof(struct lcdfb_rect_s));
+  priv->ndamage = 0;
+  priv->flushed = clock_systime_ticks();
+#ifdef CONFIG_FB_SYNC
+  nwaiters       = priv->nwaiters;
+  priv->nwaiters = 0;
+#endif
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  for (i = 0; i < ndamage; i++)
+    {
+      area.x = damage[i].x1;
+      area.y = damage[i].y1;
+      area.w = damage[i].x2 - damage[i].x1 + 1;
+      area.h = damage[i].y2 - damage[i].y1 + 1;
+      lcdfb_putarea(priv, &area);
+    }
+
+  if (ndamage > 0 && pinfo->redraw != NULL)
     {
       pinfo->redraw(pinfo->dev);
     }
 
-  return OK;
+#ifdef CONFIG_FB_SYNC
+  while (nwaiters-- > 0)
+    {
+      nxsem_post(&priv->flushsem);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: lcdfb_damage
+ *
+ * Description:
+ *   Add an area to the damage of the current frame, and schedule the flush
+ *   of the frame.  Overlapping and adjacent regions are merged, and when
+ *   there are too many regions the two that cost the least to send
+ *   together are merged.
+ *
+ ****************************************************************************/
+
+static void lcdfb_damage(FAR struct lcdfb_dev_s *priv,
+                         FAR const struct fb_area_s *area)
+{
+  struct lcdfb_rect_s rect;
+  irqstate_t flags;
+  sclock_t delay;
+  uint32_t cost;
+  uint32_t best;
+  int merge;
+  int i;
+
+  if (area != NULL)
+    {
+      rect.x1 = MAX(area->x, 0);
+      rect.y1 = MAX(area->y, 0);
+      rect.x2 = MIN(area->x + area->w - 1, priv->xres - 1);
+      rect.y2 = MIN(area->y + area->h - 1, priv->yres - 1);
+      if (rect.x1 > rect.x2 || rect.y1 > rect.y2)
+        {
+          return;
+        }
+    }
+  else
+    {
+      rect.x1 = 0;
+      rect.y1 = 0;
+      rect.x2 = priv->xres - 1;
+      rect.y2 = priv->yres - 1;
+    }
+
+  /* Align the columns for the transfers, and send whole rows when most of
+   * them are damaged anyway, which the LCD can take in a single transfer.
+   */
+
+  rect.x1 &= ~(LCDFB_ALIGN - 1);
+  rect.x2  = MIN(rect.x2 | (LCDFB_ALIGN - 1), priv->xres - 1);
+  if (4 * (rect.x2 - rect.x1 + 1) >= 3 * priv->xres)
+    {
+      rect.x1 = 0;
+      rect.x2 = priv->xres - 1;
+    }
+
+  flags = spin_lock_irqsave(&priv->lock);
+
+  for (i = 0; i < priv->ndamage; )
+    {
+      FAR struct lcdfb_rect_s *other = &priv->damage[i];
+
+      if (other->x1 <= rect.x2 + 1 && rect.x1 <= other->x2 + 1 &&
+          other->y1 <= rect.y2 + 1 && rect.y1 <= other->y2 + 1)
+        {
+          /* Take the region out of the list and start over, the merged
+           * region may now touch regions already checked.
+           */
+
+          lcdfb_rect_merge(&rect, other);
+          priv->damage[i] = priv->damage[--priv->ndamage];
+          i = 0;
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  if (priv->ndamage >= LCDFB_NDAMAGE)
+    {
+      merge = 0;
+      best  = UINT32_MAX;
+
+      for (i = 0; i < priv->ndamage; i++)
+        {
+          struct lcdfb_rect_s both = priv->damage[i];
+
+          lcdfb_rect_merge(&both, &rect);
+          cost = lcdfb_rect_size(&both) - lcdfb_rect_size(&priv->damage[i]);
+          if (cost < best)
+            {
+              best  = cost;
+              merge = i;
+            }
+        }
+
+      lcdfb_rect_merge(&rect, &priv->damage[merge]);
+      priv->damage[merge] = priv->damage[--priv->ndamage];
+    }
+
+  priv->damage[priv->ndamage++] = rect;
+
+  /* Flush at most once per frame period */
+
+  delay = (sclock_t)(priv->flushed + LCDFB_PERIOD - clock_systime_ticks());
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  if (work_available(&priv->work))
+    {
+      work_queue(LCDFB_WORK, &priv->work, lcdfb_flush_work, priv,
+                 delay > 0 ? delay : 0);
+    }
+}
+
+#ifdef CONFIG_FB_SYNC
+/****************************************************************************
+ * Name: lcdfb_waitforvsync
+ *
+ * Description:
+ *   Wait until the damage collected so far has been sent to the LCD.
+ *
+ ****************************************************************************/
+
+static int lcdfb_waitforvsync(FAR struct fb_vtable_s *vtable)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&priv->lock);
+  if (priv->ndamage == 0)
+    {
+      spin_unlock_irqrestore(&priv->lock, flags);
+      return OK;
+    }
+
+  priv->nwaiters++;
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  return nxsem_wait_uninterruptible(&priv->flushsem);
+}
+#endif
+#endif /* CONFIG_LCD_FRAMEBUFFER_DAMAGE */
+
+/****************************************************************************
+ * Name: lcdfb_updateearea
+ *
+ * Description:
+ * Update the LCD when there is a change to the framebuffer.
+ *
+ ****************************************************************************/
+
+static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
+                             FAR const struct fb_area_s *area)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
+  int ret = OK;
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+  lcdfb_damage(priv, area);
+#else
+  ret = lcdfb_putarea(priv, area);
+  if (ret >= 0 && priv->pinfo.redraw != NULL)
+    {
+      priv->pinfo.redraw(priv->pinfo.dev);
+    }
+#endif
+
+  return ret;
 }
 
 /****************************************************************************
@@ -636,7 +923,17 @@ int up_fbinitialize(int display)
   priv->vtable.setpower     = lcdfb_setpower,
   priv->vtable.ioctl        = lcdfb_ioctl,
   priv->vtable.open         = lcdfb_open,
-  priv->vtable.close        = lcdfb_close,
+  priv->vtable.close        = lcdfb_close;
+#if defined(CONFIG_LCD_FRAMEBUFFER_DAMAGE) && defined(CONFIG_FB_SYNC)
+  priv->vtable.waitforvsync = lcdfb_waitforvsync;
+#endif
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+  spin_lock_init(&priv->lock);
+#  ifdef CONFIG_FB_SYNC
+  nxsem_init(&priv->flushsem, 0, 0);
+#  endif
+#endif
 
 #ifdef CONFIG_LCD_EXTERNINIT
   /* Use external graphics driver initialization */
@@ -717,11 +1014,15 @@ int up_fbinitialize(int display)
   area.w = priv->xres;
   area.h = priv->yres;
 
-  ret = lcdfb_updateearea(&priv->vtable, &area);
+  ret = lcdfb_putarea(priv, &area);
   if (ret < 0)
     {
       lcderr("FB update failed: %d\n", ret);
     }
+  else if (priv->pinfo.redraw != NULL)
+    {
+      priv->pinfo.redraw(priv->pinfo.dev);
+    }
 
   /* Turn the LCD on at 75% power */
 
@@ -817,6 +1118,15 @@ void up_fbuninitialize(int display)
               g_lcdfb = priv->flink;
             }
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+          /* Drop the pending damage */
+
+          work_cancel_sync(LCDFB_WORK, &priv->work);
+#  ifdef CONFIG_FB_SYNC
+          nxsem_destroy(&priv->flushsem);
+#  endif
+#endif
+
 #ifndef CONFIG_LCD_EXTERNINIT
           /* Uninitialize the LCD */
 
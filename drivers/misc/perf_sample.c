@@ -0,0 +1,441 @@
+/****************************************************************************
+ * drivers/misc/perf_sample.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/perf_sample.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PERF_SAMPLE_SIZE(nip) \
+  (offsetof(struct perf_sample_s, ps_ip) + (nip) * sizeof(uintptr_t))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The samples of one CPU.  They are written by that CPU only, from the
+ * interrupt handler, and read by any CPU.
+ */
+
+struct perf_sample_cpu_s
+{
+  spinlock_t lock;
+  unsigned int head;                  /* Index of the next sample to write */
+  unsigned int tail;                  /* Index of the next sample to read */
+  unsigned long dropped;              /* Samples lost with a full buffer */
+  struct perf_sample_s buffer[CONFIG_PERF_SAMPLE_NENTRIES];
+};
+
+struct perf_sample_dev_s
+{
+  mutex_t lock;                       /* Serializes open, close and read */
+  sem_t wait;                         /* Wakes up a blocked reader */
+  uint8_t crefs;                      /* Number of opens */
+  volatile bool enabled;              /* True while sampling */
+  volatile bool waiting;              /* True if a reader waits */
+  struct perf_sample_cpu_s cpu[CONFIG_SMP_NCPUS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int perf_sample_open(FAR struct file *filep);
+static int perf_sample_close(FAR struct file *filep);
+static ssize_t perf_sample_read(FAR struct file *filep, FAR char *buffer,
+                                size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_perf_sample_fops =
+{
+  perf_sample_open,  /* open */
+  perf_sample_close, /* close */
+  perf_sample_read,  /* read */
+};
+
+static struct perf_sample_dev_s g_perf_sample =
+{
+  NXMUTEX_INITIALIZER,
+  SEM_INITIALIZER(0),
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: perf_sample_start and perf_sample_stop
+ *
+ * Description:
+ *   Start or stop the performance counter overflow interrupt of the CPU
+ *   these are called on.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PERF_SAMPLE_PMU
+static int perf_sample_start(FAR void *arg)
+{
+  UNUSED(arg);
+  return up_perf_sample_start(CONFIG_PERF_SAMPLE_PERIOD);
+}
+
+static int perf_sample_stop(FAR void *arg)
+{
+  UNUSED(arg);
+  return up_perf_sample_stop();
+}
+
+/****************************************************************************
+ * Name: perf_sample_pmu
+ *
+ * Description:
+ *   Run perf_sample_start() or perf_sample_stop() on all of the CPUs.
+ *
+ ****************************************************************************/
+
+static int perf_sample_pmu(bool start)
+{
+#ifdef CONFIG_SMP
+  return nxsched_smp_call((1 << CONFIG_SMP_NCPUS) - 1,
+                          start ? perf_sample_start : perf_sample_stop,
+                          NULL, true);
+#else
+  return start ? perf_sample_start(NULL) : perf_sample_stop(NULL);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: perf_sample_open
+ ****************************************************************************/
+
+static int perf_sample_open(FAR struct file *filep)
+{
+  FAR struct perf_sample_cpu_s *cpu;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  if ((filep->f_oflags & O_WROK) != 0)
+    {
+      return -EACCES;
+    }
+
+  ret = nxmutex_lock(&g_perf_sample.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (g_perf_sample.crefs++ > 0)
+    {
+      goto out;
+    }
+
+  /* The first open discards the samples of any earlier session */
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      cpu = &g_perf_sample.cpu[i];
+
+      flags = spin_lock_irqsave(&cpu->lock);
+      cpu->head    = 0;
+      cpu->tail    = 0;
+      cpu->dropped = 0;
+      spin_unlock_irqrestore(&cpu->lock, flags);
+    }
+
+  g_perf_sample.enabled = true;
+
+#ifdef CONFIG_PERF_SAMPLE_PMU
+  ret = perf_sample_pmu(true);
+  if (ret < 0)
+    {
+      serr("ERROR: Failed to start the performance counter: %d\n", ret);
+      g_perf_sample.enabled = false;
+      g_perf_sample.crefs--;
+    }
+#endif
+
+out:
+  nxmutex_unlock(&g_perf_sample.lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: perf_sample_close
+ ****************************************************************************/
+
+static int perf_sample_close(FAR struct file *filep)
+{
+  unsigned long dropped = 0;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&g_perf_sample.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (--g_perf_sample.crefs == 0)
+    {
+#ifdef CONFIG_PERF_SAMPLE_PMU
+      perf_sample_pmu(false);
+#endif
+      g_perf_sample.enabled = false;
+
+      for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+        {
+          dropped += g_perf_sample.cpu[i].dropped;
+        }
+
+      if (dropped > 0)
+        {
+          swarn("WARNING: %lu samples dropped\n", dropped);
+        }
+    }
+
+  nxmutex_unlock(&g_perf_sample.lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: perf_sample_copy
+ *
+ * Description:
+ *   Move the whole records buffered by one CPU that fit into the user
+ *   buffer.
+ *
+ ****************************************************************************/
+
+static size_t perf_sample_copy(FAR struct perf_sample_cpu_s *cpu,
+                               FAR char *buffer, size_t buflen)
+{
+  FAR struct perf_sample_s *sample;
+  irqstate_t flags;
+  size_t nread = 0;
+
+  flags = spin_lock_irqsave(&cpu->lock);
+
+  while (cpu->tail != cpu->head)
+    {
+      sample = &cpu->buffer[cpu->tail];
+      if (sample->ps_size > buflen - nread)
+        {
+          break;
+        }
+
+      memcpy(buffer + nread, sample, sample->ps_size);
+      nread += sample->ps_size;
+
+      if (++cpu->tail >= CONFIG_PERF_SAMPLE_NENTRIES)
+        {
+          cpu->tail = 0;
+        }
+    }
+
+  spin_unlock_irqrestore(&cpu->lock, flags);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: perf_sample_read
+ ****************************************************************************/
+
+static ssize_t perf_sample_read(FAR struct file *filep, FAR char *buffer,
+                                size_t buflen)
+{
+  size_t nread = 0;
+  int ret;
+  int i;
+
+  if (buflen < sizeof(struct perf_sample_s))
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&g_perf_sample.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (; ; )
+    {
+      /* Announce the reader before looking at the buffers, so a sample
+       * taken meanwhile posts the semaphore.
+       */
+
+      g_perf_sample.waiting = true;
+
+      for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+        {
+          nread += perf_sample_copy(&g_perf_sample.cpu[i], buffer + nread,
+                                    buflen - nread);
+        }
+
+      if (nread > 0)
+        {
+          break;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      ret = nxsem_wait(&g_perf_sample.wait);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  g_perf_sample.waiting = false;
+  nxmutex_unlock(&g_perf_sample.lock);
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: perf_sample
+ *
+ * Description:
+ *   Record a sample of the thread interrupted on this CPU.  Called from
+ *   the performance counter overflow interrupt or, without one, from the
+ *   system timer interrupt.  Nothing is done unless /dev/perf is open.
+ *
+ * Input Parameters:
+ *   regs - The register context of the interrupted thread.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void perf_sample(FAR void *regs)
+{
+  FAR struct perf_sample_cpu_s *cpu;
+  FAR struct perf_sample_s *sample;
+  irqstate_t flags;
+  unsigned int next;
+  int nip = 1;
+#if CONFIG_PERF_SAMPLE_CALLCHAIN > 0
+  int ret;
+#endif
+
+  if (!g_perf_sample.enabled || regs == NULL)
+    {
+      return;
+    }
+
+  cpu   = &g_perf_sample.cpu[this_cpu()];
+  flags = spin_lock_irqsave(&cpu->lock);
+
+  next = cpu->head + 1;
+  if (next >= CONFIG_PERF_SAMPLE_NENTRIES)
+    {
+      next = 0;
+    }
+
+  if (next == cpu->tail)
+    {
+      cpu->dropped++;
+      spin_unlock_irqrestore(&cpu->lock, flags);
+      return;
+    }
+
+  sample           = &cpu->buffer[cpu->head];
+  sample->ps_ip[0] = up_getusrpc(regs);
+
+#if CONFIG_PERF_SAMPLE_CALLCHAIN > 0
+  ret = up_backtrace(nxsched_self(), (FAR void **)&sample->ps_ip[1],
+                     CONFIG_PERF_SAMPLE_CALLCHAIN, 0);
+  if (ret > 0)
+    {
+      nip += ret;
+    }
+#endif
+
+  sample->ps_size  = PERF_SAMPLE_SIZE(nip);
+  sample->ps_cpu   = this_cpu();
+  sample->ps_nip   = nip;
+  sample->ps_pid   = nxsched_self()->pid;
+  sample->ps_time  = perf_gettime();
+  cpu->head        = next;
+
+  spin_unlock_irqrestore(&cpu->lock, flags);
+
+  if (g_perf_sample.waiting)
+    {
+      g_perf_sample.waiting = false;
+      nxsem_post(&g_perf_sample.wait);
+    }
+}
+
+/****************************************************************************
+ * Name: perf_sample_register
+ *
+ * Description:
+ *   Register the /dev/perf sample stream.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int perf_sample_register(void)
+{
+  return register_driver("/dev/perf", &g_perf_sample_fops, 0444,
+                         &g_perf_sample);
+}
@@ -30,6 +30,12 @@
 #include <stdint.h>
 #include <debug.h>
 
+#ifdef CONFIG_MMCSD_BLKQUEUE
+#  include <nuttx/fs/blkqueue.h>
+#  include <nuttx/spinlock.h>
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -56,6 +62,16 @@
 #define IS_SDV2(t)  (((t) & MMCSD_CARDTYPE_SDV2) != 0)
 #define IS_BLOCK(t) (((t) & MMCSD_CARDTYPE_BLOCK) != 0)
 
+/* Number of requests that the block request queue dispatches at once.
+ * More than one is only useful to collect writes for a packed command.
+ */
+
+#ifdef CONFIG_MMCSD_PACKED
+#  define MMCSD_BLKQUEUE_DEPTH CONFIG_MMCSD_PACKED_MAXWRITES
+#else
+#  define MMCSD_BLKQUEUE_DEPTH 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -96,6 +112,20 @@ struct mmcsd_state_s
   uint8_t  blockshift;             /* Log2 of blocksize */
   uint16_t blocksize;              /* Read block length (== block size) */
   uint32_t nblocks;                /* Number of blocks */
+
+#ifdef CONFIG_MMCSD_BLKQUEUE
+  /* Block request queue, performed by the threads of wqueue */
+
+  struct blk_queue_s queue;        /* Pending block requests */
+  FAR struct kwork_wqueue_s *wqueue;
+  struct work_s work;              /* Performs the dispatched requests */
+  spinlock_t blklock;              /* Protects breq[] */
+  uint8_t nbreq;                   /* Number of dispatched requests */
+  FAR struct blk_request_s *breq[MMCSD_BLKQUEUE_DEPTH];
+#ifdef CONFIG_MMCSD_PACKED
+  uint8_t maxpacked;               /* Max. writes per packed command */
+#endif
+#endif
 };
 
 /****************************************************************************
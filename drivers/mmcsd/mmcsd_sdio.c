@@ -30,6 +30,7 @@
 
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/param.h>
 
 #include <inttypes.h>
 #include <stdint.h>
@@ -40,6 +41,7 @@
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
+#include <endian.h>
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
@@ -96,6 +98,23 @@
 #  define MMCSD_MULTIBLOCK_LIMIT CONFIG_MMCSD_MULTIBLOCK_LIMIT
 #endif
 
+/* Block request queue:  The card performs one request at a time, so the
+ * queue gains by merging adjacent requests into a multi-block transfer.
+ * The requests are performed by a work queue thread of the slot, so that
+ * file systems mounted from the system work queues do not wait on
+ * themselves.
+ */
+
+#ifdef CONFIG_MMCSD_BLKQUEUE
+#  define MMCSD_BLKQUEUE_MAXSECTORS   MIN(MMCSD_MULTIBLOCK_LIMIT, 256)
+
+#  if MMCSD_MULTIBLOCK_LIMIT == 1
+#    define MMCSD_BLKQUEUE_MAXSEGS    1
+#  else
+#    define MMCSD_BLKQUEUE_MAXSEGS    CONFIG_FS_BLKQUEUE_MAXSEGS
+#  endif
+#endif
+
 #define MMCSD_CAPACITY(b, s)    ((s) >= 10 ? (b) << ((s) - 10) : (b) >> (10 - (s)))
 
 #ifdef CONFIG_BOARD_COREDUMP_BLKDEV
@@ -182,7 +201,7 @@ static ssize_t mmcsd_writesingle(FAR struct mmcsd_state_s *priv,
 static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
                                    FAR const uint8_t *buffer,
                                    off_t startblock,
-                                   size_t nblocks);
+                                   size_t nblocks, bool packed);
 #endif
 
 /* Block driver methods *****************************************************/
@@ -199,6 +218,23 @@ static int     mmcsd_geometry(FAR struct inode *inode,
                               FAR struct geometry *geometry);
 static int     mmcsd_ioctl(FAR struct inode *inode, int cmd,
                            unsigned long arg);
+static ssize_t mmcsd_transfer(FAR struct mmcsd_state_s *priv,
+                              FAR uint8_t *buffer, blkcnt_t startsector,
+                              unsigned int nsectors, bool write);
+
+/* Block request queue ******************************************************/
+
+#ifdef CONFIG_MMCSD_BLKQUEUE
+#ifdef CONFIG_MMCSD_PACKED
+static int     mmcsd_blkpacked(FAR struct mmcsd_state_s *priv,
+                               FAR struct blk_request_s **breq, int nreq);
+#endif
+static void    mmcsd_blkrequest(FAR struct mmcsd_state_s *priv,
+                                FAR struct blk_request_s *req);
+static void    mmcsd_blkworker(FAR void *arg);
+static int     mmcsd_blkdispatch(FAR struct blk_queue_s *queue,
+                                 FAR struct blk_request_s *req);
+#endif
 
 /* Initialization/uninitialization/reset ************************************/
 
@@ -236,6 +272,13 @@ static const struct block_operations g_bops =
   mmcsd_ioctl     /* ioctl    */
 };
 
+#ifdef CONFIG_MMCSD_BLKQUEUE
+static const struct blk_queue_ops_s g_blkqops =
+{
+  mmcsd_blkdispatch  /* dispatch */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -1898,14 +1941,16 @@ static ssize_t mmcsd_writesingle(FAR struct mmcsd_state_s *priv,
  * Description:
  *   Write multiple, contiguous blocks of data to the physical device.
  *   This function expects that the data to be written is contained in
- *   one large buffer that is pointed to by buffer.
+ *   one large buffer that is pointed to by buffer.  If packed is true, the
+ *   first block of the buffer is the header of an eMMC packed write.
  *
  ****************************************************************************/
 
 #if MMCSD_MULTIBLOCK_LIMIT != 1
 static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
                                    FAR const uint8_t *buffer,
-                                   off_t startblock, size_t nblocks)
+                                   off_t startblock, size_t nblocks,
+                                   bool packed)
 {
   size_t nbytes = nblocks << priv->blockshift;
   off_t  offset;
@@ -1983,10 +2028,11 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
   /* If this is an SD card, then send ACMD23 (SET_WR_BLK_ERASE_COUNT) just
    * before sending CMD25 (WRITE_MULTIPLE_BLOCK).  This sets the number of
    * write blocks to be pre-erased and might make the following multiple
-   * block write command faster.
+   * block write command faster.  Cards that support CMD23 learn the block
+   * count from it, so the two extra commands are skipped.
    */
 
-  if (IS_SD(priv->type))
+  if (IS_SD(priv->type) && !priv->cmd23support)
     {
       /* Send CMD55, APP_CMD, a verify that good R1 status is returned */
 
@@ -2017,7 +2063,8 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
   if (IS_SD(priv->type) && priv->cmd23support)
 #endif
     {
-      ret = mmcsd_setblockcount(priv, nblocks);
+      ret = mmcsd_setblockcount(priv, packed ? MMC_CMD23_PACKED | nblocks :
+                                               nblocks);
       if (ret != OK)
         {
           return ret;
@@ -2204,74 +2251,120 @@ static int mmcsd_close(FAR struct inode *inode)
 }
 
 /****************************************************************************
- * Name: mmcsd_read
+ * Name: mmcsd_transfer
  *
  * Description:
- *   Read the specified number of sectors from the read-ahead buffer or from
- *   the physical device.
+ *   Read or write the specified number of sectors.  The caller holds the
+ *   slot lock.
  *
  ****************************************************************************/
 
-static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
-                          blkcnt_t startsector, unsigned int nsectors)
+static ssize_t mmcsd_transfer(FAR struct mmcsd_state_s *priv,
+                              FAR uint8_t *buffer, blkcnt_t startsector,
+                              unsigned int nsectors, bool write)
 {
-  FAR struct mmcsd_state_s *priv;
   size_t sector;
   size_t endsector;
-  ssize_t nread;
-  ssize_t ret = nsectors;
-
-  DEBUGASSERT(inode->i_private);
-  priv = inode->i_private;
-  finfo("startsector: %" PRIuOFF " nsectors: %u sectorsize: %d\n",
-        startsector, nsectors, priv->blocksize);
+  ssize_t nxfer;
 
-  if (nsectors > 0)
+  endsector = startsector + nsectors;
+  for (sector = startsector; sector < endsector; sector += nxfer)
     {
-      ret = mmcsd_lock(priv);
-      if (ret < 0)
+#if MMCSD_MULTIBLOCK_LIMIT == 1
+      /* Transfer each block using only the single block transfer method */
+
+      if (write)
         {
-          return ret;
+          nxfer = mmcsd_writesingle(priv, buffer, sector);
         }
-
-      ret = nsectors;
-      endsector = startsector + nsectors;
-      for (sector = startsector; sector < endsector; sector += nread)
+      else
         {
-          /* Read this sector into the user buffer */
-
-#if MMCSD_MULTIBLOCK_LIMIT == 1
-          /* Read each block using only the single block transfer method */
-
-          nread = mmcsd_readsingle(priv, buffer, sector);
+          nxfer = mmcsd_readsingle(priv, buffer, sector);
+        }
 #else
-          nread = endsector - sector;
-          if (nread > MMCSD_MULTIBLOCK_LIMIT)
+      nxfer = endsector - sector;
+      if (nxfer > MMCSD_MULTIBLOCK_LIMIT)
+        {
+          nxfer = MMCSD_MULTIBLOCK_LIMIT;
+        }
+
+      if (write)
+        {
+          if (nxfer == 1)
             {
-              nread = MMCSD_MULTIBLOCK_LIMIT;
+              nxfer = mmcsd_writesingle(priv, buffer, sector);
             }
-
-          if (nread == 1)
+          else
             {
-              nread = mmcsd_readsingle(priv, buffer, sector);
+              nxfer = mmcsd_writemultiple(priv, buffer, sector, nxfer,
+                                          false);
+            }
+        }
+      else
+        {
+          if (nxfer == 1)
+            {
+              nxfer = mmcsd_readsingle(priv, buffer, sector);
             }
           else
             {
-              nread = mmcsd_readmultiple(priv, buffer, sector, nread);
+              nxfer = mmcsd_readmultiple(priv, buffer, sector, nxfer);
             }
+        }
 
 #endif
-          if (nread < 0)
-            {
-              ret = nread;
-              break;
-            }
+      if (nxfer < 0)
+        {
+          return nxfer;
+        }
+
+      /* Increment the buffer pointer by the sector size */
+
+      buffer += nxfer * priv->blocksize;
+    }
+
+  return nsectors;
+}
+
+/****************************************************************************
+ * Name: mmcsd_read
+ *
+ * Description:
+ *   Read the specified number of sectors from the read-ahead buffer or from
+ *   the physical device.
+ *
+ ****************************************************************************/
+
+static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
+                          blkcnt_t startsector, unsigned int nsectors)
+{
+  FAR struct mmcsd_state_s *priv;
+  ssize_t ret = nsectors;
+
+  DEBUGASSERT(inode->i_private);
+  priv = inode->i_private;
+  finfo("startsector: %" PRIuOFF " nsectors: %u sectorsize: %d\n",
+        startsector, nsectors, priv->blocksize);
 
-          /* Increment the buffer pointer by the sector size */
+  if (nsectors > 0)
+    {
+#ifdef CONFIG_MMCSD_BLKQUEUE
+      /* Contexts that cannot wait (e.g. coredump) bypass the queue */
 
-          buffer += nread * priv->blocksize;
+      if (!up_interrupt_context() && !sched_idletask())
+        {
+          return blk_queue_sync(&priv->queue, BLK_REQ_READ, buffer,
+                                startsector, nsectors);
+        }
+#endif
+
+      ret = mmcsd_lock(priv);
+      if (ret < 0)
+        {
+          return ret;
         }
 
+      ret = mmcsd_transfer(priv, buffer, startsector, nsectors, false);
       mmcsd_unlock(priv);
     }
 
@@ -2294,9 +2387,6 @@ static ssize_t mmcsd_write(FAR struct inode *inode,
                            blkcnt_t startsector, unsigned int nsectors)
 {
   FAR struct mmcsd_state_s *priv;
-  size_t sector;
-  size_t endsector;
-  ssize_t nwrite;
   ssize_t ret = nsectors;
 
   DEBUGASSERT(inode->i_private);
@@ -2306,50 +2396,22 @@ static ssize_t mmcsd_write(FAR struct inode *inode,
 
   if (nsectors > 0)
     {
-      ret = mmcsd_lock(priv);
-      if (ret < 0)
+#ifdef CONFIG_MMCSD_BLKQUEUE
+      if (!up_interrupt_context() && !sched_idletask())
         {
-          return ret;
+          return blk_queue_sync(&priv->queue, BLK_REQ_WRITE,
+                                (FAR void *)buffer, startsector, nsectors);
         }
-
-      ret = nsectors;
-      endsector = startsector + nsectors;
-      for (sector = startsector; sector < endsector; sector += nwrite)
-        {
-          /* Write this sector into the user buffer */
-
-#if MMCSD_MULTIBLOCK_LIMIT == 1
-          /* Write each block using only the single block transfer method */
-
-          nwrite = mmcsd_writesingle(priv, buffer, sector);
-#else
-          nwrite = endsector - sector;
-          if (nwrite > MMCSD_MULTIBLOCK_LIMIT)
-            {
-              nwrite = MMCSD_MULTIBLOCK_LIMIT;
-            }
-
-          if (nwrite == 1)
-            {
-              nwrite = mmcsd_writesingle(priv, buffer, sector);
-            }
-          else
-            {
-              nwrite = mmcsd_writemultiple(priv, buffer, sector, nwrite);
-            }
-
 #endif
-          if (nwrite < 0)
-            {
-              ret = nwrite;
-              break;
-            }
 
-          /* Increment the buffer pointer by the sector size */
-
-          buffer += nwrite * priv->blocksize;
+      ret = mmcsd_lock(priv);
+      if (ret < 0)
+        {
+          return ret;
         }
 
+      ret = mmcsd_transfer(priv, (FAR uint8_t *)buffer, startsector,
+                           nsectors, true);
       mmcsd_unlock(priv);
     }
 
@@ -2502,6 +2564,15 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       break;
 #endif
 
+#ifdef CONFIG_MMCSD_BLKQUEUE
+    case BIOC_GETQUEUE: /* Get the block request queue */
+      {
+        *(FAR struct blk_queue_s **)(uintptr_t)arg = &priv->queue;
+        ret = OK;
+      }
+      break;
+#endif
+
     default:
       ret = -ENOTTY;
       break;
@@ -2511,6 +2582,298 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Block request queue
+ ****************************************************************************/
+
+#ifdef CONFIG_MMCSD_BLKQUEUE
+
+#ifdef CONFIG_MMCSD_PACKED
+/****************************************************************************
+ * Name: mmcsd_blkpacked
+ *
+ * Description:
+ *   Write the leading write requests of breq[] with one eMMC packed write
+ *   command, so that the card is busy only once for all of them.  Returns
+ *   the number of requests completed, zero if they must be performed one
+ *   by one.
+ *
+ ****************************************************************************/
+
+static int mmcsd_blkpacked(FAR struct mmcsd_state_s *priv,
+                           FAR struct blk_request_s **breq, int nreq)
+{
+  FAR struct blk_request_s *seg;
+  FAR uint32_t *header;
+  FAR uint8_t *bounce;
+  FAR uint8_t *ptr;
+  size_t nblocks = 1;
+  ssize_t ret;
+  int npacked;
+  int i;
+
+  if (!IS_MMC(priv->type) || !IS_BLOCK(priv->type))
+    {
+      return 0;
+    }
+
+  /* The header block holds the arguments of the entries after the first
+   * two words.
+   */
+
+  nreq = MIN(nreq, MIN(priv->maxpacked, priv->blocksize / 8 - 1));
+  for (npacked = 0; npacked < nreq; npacked++)
+    {
+      if (breq[npacked]->op != BLK_REQ_WRITE ||
+          nblocks + breq[npacked]->total > MIN(MMCSD_MULTIBLOCK_LIMIT,
+                                               UINT16_MAX))
+        {
+          break;
+        }
+
+      nblocks += breq[npacked]->total;
+    }
+
+  if (npacked < 2)
+    {
+      return 0;
+    }
+
+  bounce = kmm_malloc(nblocks * priv->blocksize);
+  if (bounce == NULL)
+    {
+      return 0;
+    }
+
+  header = (FAR uint32_t *)bounce;
+  memset(header, 0, priv->blocksize);
+  header[0] = htole32(MMC_PACKED_HEADER(npacked));
+
+  ptr = bounce + priv->blocksize;
+  for (i = 0; i < npacked; i++)
+    {
+      header[2 * i + 2] = htole32(breq[i]->total);
+      header[2 * i + 3] = htole32(breq[i]->sector);
+
+      for (seg = breq[i]; seg != NULL; seg = seg->merged)
+        {
+          memcpy(ptr, seg->buffer, seg->nsectors * priv->blocksize);
+          ptr += seg->nsectors * priv->blocksize;
+        }
+    }
+
+  ret = mmcsd_lock(priv);
+  if (ret >= 0)
+    {
+      ret = mmcsd_writemultiple(priv, bounce, breq[0]->sector, nblocks,
+                                true);
+      mmcsd_unlock(priv);
+    }
+
+  kmm_free(bounce);
+
+  /* On failure, the requests are simply written again one by one */
+
+  if (ret < 0)
+    {
+      ferr("ERROR: Packed write of %d requests failed: %zd\n",
+           npacked, ret);
+      return 0;
+    }
+
+  for (i = 0; i < npacked; i++)
+    {
+      blk_queue_complete(&priv->queue, breq[i], breq[i]->total);
+    }
+
+  return npacked;
+}
+#endif
+
+/****************************************************************************
+ * Name: mmcsd_blkrequest
+ *
+ * Description:
+ *   Perform one request of the block request queue.  Merged requests whose
+ *   buffers are not contiguous go through a bounce buffer, so that the
+ *   chain is still one multi-block transfer.
+ *
+ ****************************************************************************/
+
+static void mmcsd_blkrequest(FAR struct mmcsd_state_s *priv,
+                             FAR struct blk_request_s *req)
+{
+  FAR struct blk_request_s *seg;
+  FAR uint8_t *bounce = NULL;
+  FAR uint8_t *buffer;
+  FAR uint8_t *ptr;
+  bool write = req->op == BLK_REQ_WRITE;
+  ssize_t nxfer;
+  ssize_t ret;
+
+  ret = mmcsd_lock(priv);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  if (req->op == BLK_REQ_FLUSH)
+    {
+      /* Writes are done when the card leaves the busy state */
+
+      ret = mmcsd_transferready(priv);
+      goto out_with_lock;
+    }
+
+  for (seg = req; seg->merged != NULL; seg = seg->merged)
+    {
+      if (seg->merged->buffer !=
+          seg->buffer + seg->nsectors * priv->blocksize)
+        {
+          break;
+        }
+    }
+
+  buffer = req->buffer;
+  if (seg->merged != NULL)
+    {
+      bounce = kmm_malloc(req->total * priv->blocksize);
+      buffer = bounce;
+    }
+
+  if (buffer == NULL)
+    {
+      /* No bounce buffer, perform the requests one by one */
+
+      ret = 0;
+      for (seg = req; seg != NULL; seg = seg->merged)
+        {
+          nxfer = mmcsd_transfer(priv, seg->buffer, seg->sector,
+                                 seg->nsectors, write);
+          if (nxfer < 0)
+            {
+              ret = ret > 0 ? ret : nxfer;
+              break;
+            }
+
+          ret += nxfer;
+        }
+
+      goto out_with_lock;
+    }
+
+  if (bounce != NULL && write)
+    {
+      for (ptr = bounce, seg = req; seg != NULL; seg = seg->merged)
+        {
+          memcpy(ptr, seg->buffer, seg->nsectors * priv->blocksize);
+          ptr += seg->nsectors * priv->blocksize;
+        }
+    }
+
+  ret = mmcsd_transfer(priv, buffer, req->sector, req->total, write);
+
+  if (bounce != NULL)
+    {
+      if (ret > 0 && !write)
+        {
+          for (ptr = bounce, seg = req; seg != NULL; seg = seg->merged)
+            {
+              memcpy(seg->buffer, ptr, seg->nsectors * priv->blocksize);
+              ptr += seg->nsectors * priv->blocksize;
+            }
+        }
+
+      kmm_free(bounce);
+    }
+
+out_with_lock:
+  mmcsd_unlock(priv);
+out:
+  blk_queue_complete(&priv->queue, req, ret);
+}
+
+/****************************************************************************
+ * Name: mmcsd_blkworker
+ *
+ * Description:
+ *   Perform the dispatched requests of the block request queue on the work
+ *   queue, in the order in which they were dispatched.
+ *
+ ****************************************************************************/
+
+static void mmcsd_blkworker(FAR void *arg)
+{
+  FAR struct mmcsd_state_s *priv = arg;
+  FAR struct blk_request_s *breq[MMCSD_BLKQUEUE_DEPTH];
+  irqstate_t flags;
+  int nreq;
+  int i = 0;
+
+  flags = spin_lock_irqsave(&priv->blklock);
+  nreq = priv->nbreq;
+  memcpy(breq, priv->breq, nreq * sizeof(breq[0]));
+  priv->nbreq = 0;
+  spin_unlock_irqrestore(&priv->blklock, flags);
+
+#ifdef CONFIG_MMCSD_PACKED
+  if (nreq > 1)
+    {
+      i = mmcsd_blkpacked(priv, breq, nreq);
+    }
+#endif
+
+  for (; i < nreq; i++)
+    {
+      mmcsd_blkrequest(priv, breq[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: mmcsd_blkdispatch
+ *
+ * Description:
+ *   Start a request of the block request queue.  The requests dispatched
+ *   while the worker is busy are collected and performed by its next run.
+ *
+ ****************************************************************************/
+
+static int mmcsd_blkdispatch(FAR struct blk_queue_s *queue,
+                             FAR struct blk_request_s *req)
+{
+  FAR struct mmcsd_state_s *priv = queue->priv;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  flags = spin_lock_irqsave(&priv->blklock);
+  DEBUGASSERT(priv->nbreq < MMCSD_BLKQUEUE_DEPTH);
+  priv->breq[priv->nbreq++] = req;
+  spin_unlock_irqrestore(&priv->blklock, flags);
+
+  ret = work_queue_wq(priv->wqueue, &priv->work, mmcsd_blkworker,
+                      priv, 0);
+  if (ret < 0)
+    {
+      flags = spin_lock_irqsave(&priv->blklock);
+      for (i = 0; i < priv->nbreq; i++)
+        {
+          if (priv->breq[i] == req)
+            {
+              priv->nbreq--;
+              memmove(&priv->breq[i], &priv->breq[i + 1],
+                      (priv->nbreq - i) * sizeof(priv->breq[0]));
+              break;
+            }
+        }
+
+      spin_unlock_irqrestore(&priv->blklock, flags);
+    }
+
+  return ret;
+}
+#endif /* CONFIG_MMCSD_BLKQUEUE */
+
 /****************************************************************************
  * Initialization/uninitialization/reset
  ****************************************************************************/
@@ -3035,6 +3398,11 @@ static int mmcsd_read_csd(FAR struct mmcsd_state_s *priv, FAR uint8_t *data)
   priv->nblocks = (buffer[215] << 24) | (buffer[214] << 16) |
                   (buffer[213] << 8) | buffer[212];
 
+#ifdef CONFIG_MMCSD_PACKED
+  priv->maxpacked = buffer[EXT_CSD_REV] >= EXT_CSD_REV_4_5 ?
+                    buffer[EXT_CSD_MAX_PACKED_WRITES] : 0;
+#endif
+
   if (data != NULL)
     {
       memcpy(data, buffer, sizeof(buffer));
@@ -4315,6 +4683,12 @@ int mmcsd_slotinitialize(int minor, FAR struct sdio_dev_s *dev)
   memset(priv, 0, sizeof(struct mmcsd_state_s));
   nxmutex_init(&priv->lock);
 
+#ifdef CONFIG_MMCSD_BLKQUEUE
+  spin_lock_init(&priv->blklock);
+  blk_queue_init(&priv->queue, &g_blkqops, priv, MMCSD_BLKQUEUE_DEPTH,
+                 MMCSD_BLKQUEUE_MAXSECTORS, MMCSD_BLKQUEUE_MAXSEGS);
+#endif
+
   /* Bind the MMCSD driver to the MMCSD state structure */
 
   priv->dev = dev;
@@ -4352,6 +4726,18 @@ int mmcsd_slotinitialize(int minor, FAR struct sdio_dev_s *dev)
         }
     }
 
+#ifdef CONFIG_MMCSD_BLKQUEUE
+  /* Create the thread that performs the queued block requests */
+
+  priv->wqueue = work_queue_create("mmcsd", CONFIG_MMCSD_BLKQUEUE_PRIORITY,
+                                   CONFIG_MMCSD_BLKQUEUE_STACKSIZE, 1);
+  if (priv->wqueue == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_hwinit;
+    }
+#endif
+
   /* Create a MMCSD device name */
 
   snprintf(devname, sizeof(devname), "/dev/mmcsd%d", minor);
@@ -4377,6 +4763,13 @@ int mmcsd_slotinitialize(int minor, FAR struct sdio_dev_s *dev)
   return OK;
 
 errout_with_hwinit:
+#ifdef CONFIG_MMCSD_BLKQUEUE
+  if (priv->wqueue != NULL)
+    {
+      work_queue_free(priv->wqueue);
+    }
+
+#endif
   mmcsd_hwuninitialize(priv);
 errout_with_alloc:
   nxmutex_destroy(&priv->lock);
@@ -60,6 +60,8 @@
 
 #define EXT_CSD_BUS_WIDTH           183     /* WO */
 #define EXT_CSD_HS_TIMING           185     /* R/W */
+#define EXT_CSD_REV                 192     /* RO */
+#define EXT_CSD_MAX_PACKED_WRITES   500     /* RO */
 
 /* EXT_CSD_BUS_WIDTH */
 #define EXT_CSD_BUS_WIDTH_1         (0x00)  /* Card is in 1 bit mode */
@@ -82,6 +84,21 @@
                                      MMC_CMD6_INDEX(EXT_CSD_HS_TIMING) | \
                                      MMC_CMD6_MODE(MMC_CMD6_MODE_WRITE_BYTE))
 
+/* EXT_CSD_REV */
+#define EXT_CSD_REV_4_5             6       /* eMMC 4.5, adds packed commands */
+
+/* Packed write:  CMD23 with the packed flag announces a header block and
+ * the data of all entries, the header holds one pair of CMD23 and CMD25
+ * arguments per entry (little endian words, from word 2).
+ */
+
+#define MMC_CMD23_PACKED            ((uint32_t)1 << 30)
+#define MMC_PACKED_VERSION          (0x01)
+#define MMC_PACKED_WRITE            (0x02)
+#define MMC_PACKED_HEADER(n)        (((uint32_t)(n) << 16) | \
+                                     (MMC_PACKED_WRITE << 8) | \
+                                     MMC_PACKED_VERSION)
+
 /* CMD8 Argument:
  *    [31:12]: Reserved (shall be set to '0')
  *    [11:8]: Supply Voltage (VHS) 0x1 (Range: 2.7-3.6 V)
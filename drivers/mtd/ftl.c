@@ -44,6 +44,8 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/drivers/rwbuffer.h>
 
+#include "ftl.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -794,6 +796,18 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
 
   finfo("path=\"%s\"\n", path);
 
+#ifdef CONFIG_FTL_LOG
+  /* Prefer the log-structured layout if the geometry allows it */
+
+  ret = ftl_log_initialize(path, mtd);
+  if (ret != -ENOTSUP)
+    {
+      return ret;
+    }
+
+  ret = -ENOMEM;
+#endif
+
   /* Allocate a FTL device structure */
 
   dev = kmm_zalloc(sizeof(struct ftl_struct_s));
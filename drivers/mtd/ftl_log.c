@@ -0,0 +1,1531 @@
+/****************************************************************************
+ * drivers/mtd/ftl_log.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Log-structured flash translation layer.
+ *
+ * Sectors are never rewritten in place.  Each write programs the next free
+ * page of the open erase block (the write frontier) and updates a RAM table
+ * that maps logical sectors to physical pages; the previous copy of the
+ * sector becomes garbage.  Erase blocks are reclaimed by a garbage
+ * collector that copies the still valid pages of a victim block to the
+ * frontier and erases the victim.
+ *
+ * On-flash layout of an erase block:
+ *
+ *   page 0                    Block header:  magic and erase count.  It is
+ *                             written right after the block is erased.
+ *   page 1 ...                A sequence of groups.  Each group is up to
+ *                             'groupmax' data pages followed by a summary
+ *                             page that lists the logical sector of each
+ *                             data page and carries a sequence number.
+ *
+ * A group becomes durable when its summary is written:  When the group is
+ * full, when the block is full, on BIOC_FLUSH, on close and when the
+ * device has been idle for one garbage collector interval.  At mount, the
+ * summaries are replayed from the newest to the oldest to rebuild the map.
+ * Data pages without a summary, e.g. after a power loss, are ignored and
+ * the previous copy of their sectors is used.
+ *
+ * Victims are the closed blocks with the fewest valid pages.  Free blocks
+ * are allocated by lowest erase count (dynamic wear leveling) and, when
+ * the device is idle, the closed block with the lowest erase count is
+ * recycled once it lags too far behind the most worn block (static wear
+ * leveling).
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/crc32.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mtd/mtd.h>
+
+#include "ftl.h"
+
+#ifdef CONFIG_FTL_LOG
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FTL_LOG_HDR_MAGIC   0x48544c46  /* "FLTH" */
+#define FTL_LOG_SUM_MAGIC   0x53544c46  /* "FLTS" */
+#define FTL_LOG_VERSION     1
+
+#define FTL_LOG_NONE        UINT32_MAX  /* No block, unmapped sector */
+
+/* Erase block states */
+
+#define FTL_LOG_FREE        0           /* Erased, header written */
+#define FTL_LOG_OPEN        1           /* The write frontier */
+#define FTL_LOG_FULL        2           /* Closed, or of unknown content */
+#define FTL_LOG_BAD         3           /* Bad or worn out */
+
+/* Free blocks kept for the relocations of the garbage collector */
+
+#define FTL_LOG_MINFREE     2
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The header of the first page of an erase block */
+
+struct ftl_log_header_s
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t ec;                     /* Erase count */
+  uint32_t crc;
+};
+
+/* The header of a summary page, followed by 'count' logical sectors */
+
+struct ftl_log_summary_s
+{
+  uint32_t magic;
+  uint32_t seq;                    /* Increases with each summary */
+  uint16_t count;                  /* Number of data pages in the group */
+  uint16_t reserved;
+  uint32_t crc;
+};
+
+/* A data page of the open group, remembered to relocate it */
+
+struct ftl_log_pending_s
+{
+  uint32_t logical;
+  uint32_t phys;
+};
+
+struct ftl_log_block_s
+{
+  uint32_t ec;                     /* Erase count */
+  uint32_t seq;                    /* Sequence number of the last summary */
+  uint16_t valid;                  /* Number of pages mapped in the block */
+  uint16_t last;                   /* Page of the last summary, 0 if none */
+  uint8_t  state;                  /* See FTL_LOG_* definitions */
+  bool     retired;                /* Mark bad instead of erasing */
+};
+
+struct ftl_log_s
+{
+  FAR struct mtd_dev_s *mtd;       /* Contained MTD interface */
+  struct mtd_geometry_s geo;       /* Device geometry */
+  mutex_t               lock;      /* Protects the whole state */
+  sem_t                 gcsem;     /* Wakes up the collector thread */
+  FAR struct ftl_log_block_s *blocks;
+  FAR uint32_t         *l2p;       /* Logical sector to physical page */
+  FAR uint8_t          *sum;       /* Summary of the open group */
+  FAR uint8_t          *page;      /* Page copied by the collector */
+  FAR uint8_t          *scan;      /* Summary read by the collector */
+  FAR uint8_t          *rbuf;      /* Page copied after a program error */
+  FAR struct ftl_log_pending_s *pending;
+  uint32_t              nlogical;  /* Number of exported sectors */
+  uint32_t              seq;       /* Sequence number of the next summary */
+  uint32_t              openblk;   /* Open block or FTL_LOG_NONE */
+  uint32_t              nfree;     /* Number of free blocks */
+  uint32_t              maxec;     /* Highest erase count */
+  uint16_t              blkper;    /* R/W blocks per erase block */
+  uint16_t              openpage;  /* Next page of the open block */
+  uint16_t              ngroup;    /* Data pages in the open group */
+  uint16_t              groupmax;  /* Data pages per summary */
+  uint16_t              dense;     /* Data pages of a block of full groups */
+  uint16_t              refs;      /* Number of references */
+  bool                  unlinked;  /* The driver has been unlinked */
+  bool                  dirty;     /* Written since the last collector pass */
+  bool                  exiting;   /* The collector thread must exit */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     ftl_log_open(FAR struct inode *inode);
+static int     ftl_log_close(FAR struct inode *inode);
+static ssize_t ftl_log_read(FAR struct inode *inode,
+                 FAR unsigned char *buffer, blkcnt_t start_sector,
+                 unsigned int nsectors);
+static ssize_t ftl_log_write(FAR struct inode *inode,
+                 FAR const unsigned char *buffer, blkcnt_t start_sector,
+                 unsigned int nsectors);
+static int     ftl_log_geometry(FAR struct inode *inode,
+                 FAR struct geometry *geometry);
+static int     ftl_log_ioctl(FAR struct inode *inode, int cmd,
+                 unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     ftl_log_unlink(FAR struct inode *inode);
+#endif
+static void    ftl_log_free(FAR struct ftl_log_s *dev);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_ftl_log_bops =
+{
+  ftl_log_open,     /* open     */
+  ftl_log_close,    /* close    */
+  ftl_log_read,     /* read     */
+  ftl_log_write,    /* write    */
+  ftl_log_geometry, /* geometry */
+  ftl_log_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , ftl_log_unlink  /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_log_entries
+ *
+ * Description: Return the logical sectors that follow a summary header.
+ *
+ ****************************************************************************/
+
+static inline FAR uint32_t *ftl_log_entries(FAR uint8_t *buffer)
+{
+  return (FAR uint32_t *)(buffer + sizeof(struct ftl_log_summary_s));
+}
+
+/****************************************************************************
+ * Name: ftl_log_erased
+ *
+ * Description: Check whether a page reads as erased.
+ *
+ ****************************************************************************/
+
+static bool ftl_log_erased(FAR const uint8_t *buffer, size_t size)
+{
+  while (size-- > 0)
+    {
+      if (*buffer++ != 0xff)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: ftl_log_readpage and ftl_log_writepage
+ *
+ * Description: Read or program one page.
+ *
+ ****************************************************************************/
+
+static int ftl_log_readpage(FAR struct ftl_log_s *dev, uint32_t phys,
+                            FAR uint8_t *buffer)
+{
+  ssize_t ret = MTD_BREAD(dev->mtd, phys, 1, buffer);
+
+  if (ret == 1 || ret == -EUCLEAN)
+    {
+      return OK;
+    }
+
+  return ret < 0 ? ret : -EIO;
+}
+
+static int ftl_log_writepage(FAR struct ftl_log_s *dev, uint32_t phys,
+                             FAR const uint8_t *buffer)
+{
+  ssize_t ret = MTD_BWRITE(dev->mtd, phys, 1, buffer);
+
+  if (ret == 1)
+    {
+      return OK;
+    }
+
+  ferr("ERROR: Write page %" PRIu32 " failed: %zd\n", phys, ret);
+  return ret < 0 ? ret : -EIO;
+}
+
+/****************************************************************************
+ * Name: ftl_log_check_header
+ *
+ * Description: Validate the block header in 'buffer'.
+ *
+ ****************************************************************************/
+
+static bool ftl_log_check_header(FAR const uint8_t *buffer)
+{
+  FAR const struct ftl_log_header_s *hdr =
+    (FAR const struct ftl_log_header_s *)buffer;
+
+  return hdr->magic == FTL_LOG_HDR_MAGIC &&
+         hdr->version == FTL_LOG_VERSION &&
+         hdr->crc == crc32(buffer, offsetof(struct ftl_log_header_s, crc));
+}
+
+/****************************************************************************
+ * Name: ftl_log_check_summary
+ *
+ * Description: Validate the summary in 'buffer', read from page 'page'.
+ *
+ ****************************************************************************/
+
+static bool ftl_log_check_summary(FAR struct ftl_log_s *dev,
+                                  FAR uint8_t *buffer, uint16_t page)
+{
+  FAR struct ftl_log_summary_s *sum =
+    (FAR struct ftl_log_summary_s *)buffer;
+  uint32_t crc;
+  bool ok;
+
+  if (sum->magic != FTL_LOG_SUM_MAGIC || sum->count == 0 ||
+      sum->count > dev->groupmax || sum->count >= page)
+    {
+      return false;
+    }
+
+  crc      = sum->crc;
+  sum->crc = 0;
+  ok       = crc == crc32(buffer, sizeof(*sum) +
+                                  sum->count * sizeof(uint32_t));
+  sum->crc = crc;
+  return ok;
+}
+
+/****************************************************************************
+ * Name: ftl_log_map
+ *
+ * Description: Map a logical sector to a physical page.
+ *
+ ****************************************************************************/
+
+static void ftl_log_map(FAR struct ftl_log_s *dev, uint32_t logical,
+                        uint32_t phys)
+{
+  uint32_t old = dev->l2p[logical];
+
+  if (old != FTL_LOG_NONE)
+    {
+      DEBUGASSERT(dev->blocks[old / dev->blkper].valid > 0);
+      dev->blocks[old / dev->blkper].valid--;
+    }
+
+  dev->l2p[logical] = phys;
+  dev->blocks[phys / dev->blkper].valid++;
+}
+
+/****************************************************************************
+ * Name: ftl_log_erase
+ *
+ * Description:
+ *   Erase a block and write its header, or mark it bad if it is retired or
+ *   cannot be erased.
+ *
+ ****************************************************************************/
+
+static int ftl_log_erase(FAR struct ftl_log_s *dev, uint32_t blk)
+{
+  FAR struct ftl_log_block_s *b = &dev->blocks[blk];
+  FAR struct ftl_log_header_s *hdr;
+  int ret = -EIO;
+
+  DEBUGASSERT(b->state == FTL_LOG_FULL && b->valid == 0);
+
+  if (!b->retired)
+    {
+      ret = MTD_ERASE(dev->mtd, blk, 1);
+      if (ret >= 0)
+        {
+          b->ec++;
+
+          /* The page buffer is free:  The collector erases the victim
+           * after copying its valid pages.
+           */
+
+          memset(dev->page, 0xff, dev->geo.blocksize);
+          hdr          = (FAR struct ftl_log_header_s *)dev->page;
+          hdr->magic   = FTL_LOG_HDR_MAGIC;
+          hdr->version = FTL_LOG_VERSION;
+          hdr->ec      = b->ec;
+          hdr->crc     = crc32(dev->page,
+                               offsetof(struct ftl_log_header_s, crc));
+
+          ret = ftl_log_writepage(dev, blk * dev->blkper, dev->page);
+        }
+    }
+
+  if (ret < 0)
+    {
+      ferr("ERROR: Retiring erase block %" PRIu32 "\n", blk);
+      MTD_MARKBAD(dev->mtd, blk);
+      b->state = FTL_LOG_BAD;
+      return ret;
+    }
+
+  b->state = FTL_LOG_FREE;
+  b->last  = 0;
+  b->seq   = 0;
+  dev->nfree++;
+  dev->maxec = MAX(dev->maxec, b->ec);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_open_block
+ *
+ * Description: Open the free block with the lowest erase count.
+ *
+ ****************************************************************************/
+
+static int ftl_log_open_block(FAR struct ftl_log_s *dev)
+{
+  FAR struct ftl_log_block_s *b;
+  uint32_t best = FTL_LOG_NONE;
+  uint32_t i;
+
+  DEBUGASSERT(dev->openblk == FTL_LOG_NONE);
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      b = &dev->blocks[i];
+      if (b->state == FTL_LOG_FREE &&
+          (best == FTL_LOG_NONE || b->ec < dev->blocks[best].ec))
+        {
+          best = i;
+        }
+    }
+
+  if (best == FTL_LOG_NONE)
+    {
+      return -ENOSPC;
+    }
+
+  dev->blocks[best].state = FTL_LOG_OPEN;
+  dev->openblk  = best;
+  dev->openpage = 1;
+  dev->ngroup   = 0;
+  dev->nfree--;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_close_block
+ *
+ * Description: Close the open block; it becomes a collector candidate.
+ *
+ ****************************************************************************/
+
+static void ftl_log_close_block(FAR struct ftl_log_s *dev, bool retire)
+{
+  FAR struct ftl_log_block_s *b = &dev->blocks[dev->openblk];
+
+  b->state     = FTL_LOG_FULL;
+  b->retired   = retire;
+  dev->openblk = FTL_LOG_NONE;
+}
+
+/****************************************************************************
+ * Name: ftl_log_write_summary
+ *
+ * Description:
+ *   Write the summary of the open group.  On failure the group is left
+ *   open for the caller to relocate.
+ *
+ ****************************************************************************/
+
+static int ftl_log_write_summary(FAR struct ftl_log_s *dev)
+{
+  FAR struct ftl_log_summary_s *sum =
+    (FAR struct ftl_log_summary_s *)dev->sum;
+  FAR struct ftl_log_block_s *b = &dev->blocks[dev->openblk];
+  size_t len;
+  int ret;
+
+  len = sizeof(*sum) + dev->ngroup * sizeof(uint32_t);
+  memset(dev->sum + len, 0xff, dev->geo.blocksize - len);
+  sum->magic    = FTL_LOG_SUM_MAGIC;
+  sum->seq      = dev->seq;
+  sum->count    = dev->ngroup;
+  sum->reserved = 0;
+  sum->crc      = 0;
+  sum->crc      = crc32(dev->sum, len);
+
+  ret = ftl_log_writepage(dev, dev->openblk * dev->blkper + dev->openpage,
+                          dev->sum);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  b->last = dev->openpage;
+  b->seq  = dev->seq++;
+  dev->openpage++;
+  dev->ngroup = 0;
+
+  /* A single page left cannot hold a data page and its summary */
+
+  if (dev->openpage >= dev->blkper - 1)
+    {
+      ftl_log_close_block(dev, false);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_program
+ *
+ * Description:
+ *   Program one data page at the write frontier, without committing the
+ *   group.  On failure the group is left open for the caller to relocate.
+ *
+ ****************************************************************************/
+
+static int ftl_log_program(FAR struct ftl_log_s *dev, uint32_t logical,
+                           FAR const uint8_t *buffer)
+{
+  uint32_t phys;
+  int ret;
+
+  if (dev->openblk == FTL_LOG_NONE)
+    {
+      ret = ftl_log_open_block(dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  phys = dev->openblk * dev->blkper + dev->openpage;
+  ret  = ftl_log_writepage(dev, phys, buffer);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ftl_log_map(dev, logical, phys);
+  ftl_log_entries(dev->sum)[dev->ngroup++] = logical;
+  dev->openpage++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_full
+ *
+ * Description: Check whether the open group must be committed now.
+ *
+ ****************************************************************************/
+
+static inline bool ftl_log_full(FAR struct ftl_log_s *dev)
+{
+  return dev->ngroup == dev->groupmax || dev->openpage == dev->blkper - 1;
+}
+
+/****************************************************************************
+ * Name: ftl_log_relocate
+ *
+ * Description:
+ *   Handle a program error in the open block:  Retire the block and
+ *   program the data pages of its open group again from a new block,
+ *   retiring every block that fails in turn.  The pages still read from the
+ *   retired blocks until the collector copies their committed data away.
+ *
+ ****************************************************************************/
+
+static int ftl_log_relocate(FAR struct ftl_log_s *dev)
+{
+  FAR struct ftl_log_pending_s *p = dev->pending;
+  FAR uint32_t *entries = ftl_log_entries(dev->sum);
+  uint32_t first;
+  uint16_t n;
+  uint16_t k;
+  uint16_t i;
+  int ret;
+
+  /* Remember the open group, then retire its block */
+
+  n     = dev->ngroup;
+  first = dev->openblk * dev->blkper + dev->openpage - n;
+  for (i = 0; i < n; i++)
+    {
+      p[i].logical = entries[i];
+      p[i].phys    = first + i;
+    }
+
+  ftl_log_close_block(dev, true);
+
+  for (i = 0; i < n; )
+    {
+      if (dev->l2p[p[i].logical] != p[i].phys)
+        {
+          i++;
+          continue;
+        }
+
+      ret = ftl_log_readpage(dev, p[i].phys, dev->rbuf);
+      if (ret < 0)
+        {
+          ferr("ERROR: Lost sector %" PRIu32 "\n", p[i].logical);
+          i++;
+          continue;
+        }
+
+      ret = ftl_log_program(dev, p[i].logical, dev->rbuf);
+      if (ret >= 0)
+        {
+          i++;
+          if (ftl_log_full(dev))
+            {
+              ret = ftl_log_write_summary(dev);
+            }
+        }
+
+      if (ret == -ENOSPC)
+        {
+          return ret;
+        }
+      else if (ret < 0)
+        {
+          /* The new block failed too:  Its open group and the pages not
+           * relocated yet form the new list.  The group holds at most the
+           * 'i' pages relocated so far.
+           */
+
+          k     = dev->ngroup;
+          first = dev->openblk * dev->blkper + dev->openpage - k;
+          memmove(&p[k], &p[i], (n - i) * sizeof(*p));
+          n = k + n - i;
+          for (i = 0; i < k; i++)
+            {
+              p[i].logical = entries[i];
+              p[i].phys    = first + i;
+            }
+
+          ftl_log_close_block(dev, true);
+          i = 0;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_commit
+ *
+ * Description: Make the open group durable.
+ *
+ ****************************************************************************/
+
+static int ftl_log_commit(FAR struct ftl_log_s *dev)
+{
+  int ret;
+
+  while (dev->ngroup > 0)
+    {
+      ret = ftl_log_write_summary(dev);
+      if (ret < 0)
+        {
+          ret = ftl_log_relocate(dev);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_append
+ *
+ * Description: Write one sector at the write frontier.
+ *
+ ****************************************************************************/
+
+static int ftl_log_append(FAR struct ftl_log_s *dev, uint32_t logical,
+                          FAR const uint8_t *buffer)
+{
+  int ret;
+
+  for (; ; )
+    {
+      ret = ftl_log_program(dev, logical, buffer);
+      if (ret >= 0)
+        {
+          return ftl_log_full(dev) ? ftl_log_commit(dev) : OK;
+        }
+      else if (ret == -ENOSPC)
+        {
+          return ret;
+        }
+
+      ret = ftl_log_relocate(dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: ftl_log_victim
+ *
+ * Description:
+ *   Select the closed block with the fewest valid pages, or with 'wear' a
+ *   retired block or the one with the lowest erase count.  Blocks that hold
+ *   a block worth of valid pages, and retired blocks, do not free a block
+ *   and are only collected with 'wear'.
+ *
+ ****************************************************************************/
+
+static uint32_t ftl_log_victim(FAR struct ftl_log_s *dev, bool wear)
+{
+  FAR struct ftl_log_block_s *b;
+  uint32_t best = FTL_LOG_NONE;
+  uint32_t i;
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      b = &dev->blocks[i];
+      if (b->state != FTL_LOG_FULL)
+        {
+          continue;
+        }
+
+      if (wear)
+        {
+          if (b->retired)
+            {
+              return i;
+            }
+
+          if (best == FTL_LOG_NONE || b->ec < dev->blocks[best].ec)
+            {
+              best = i;
+            }
+        }
+      else if (!b->retired && b->valid < dev->dense &&
+               (best == FTL_LOG_NONE ||
+                b->valid < dev->blocks[best].valid))
+        {
+          best = i;
+        }
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: ftl_log_collect
+ *
+ * Description:
+ *   Copy the valid pages of a closed block to the write frontier, commit
+ *   them and erase the block.
+ *
+ ****************************************************************************/
+
+static int ftl_log_collect(FAR struct ftl_log_s *dev, uint32_t blk)
+{
+  FAR struct ftl_log_block_s *b = &dev->blocks[blk];
+  FAR struct ftl_log_summary_s *sum =
+    (FAR struct ftl_log_summary_s *)dev->scan;
+  FAR uint32_t *entries = ftl_log_entries(dev->scan);
+  uint32_t base = blk * dev->blkper;
+  uint32_t phys;
+  uint16_t page = b->last;
+  uint16_t first;
+  uint16_t i;
+  int ret;
+
+  finfo("Collect block %" PRIu32 " valid %u\n", blk, b->valid);
+
+  while (page > 0 && b->valid > 0)
+    {
+      ret = ftl_log_readpage(dev, base + page, dev->scan);
+      if (ret < 0 || !ftl_log_check_summary(dev, dev->scan, page))
+        {
+          break;
+        }
+
+      first = page - sum->count;
+      for (i = 0; i < sum->count && b->valid > 0; i++)
+        {
+          phys = base + first + i;
+          if (entries[i] >= dev->nlogical || dev->l2p[entries[i]] != phys)
+            {
+              continue;
+            }
+
+          ret = ftl_log_readpage(dev, phys, dev->page);
+          if (ret >= 0)
+            {
+              ret = ftl_log_append(dev, entries[i], dev->page);
+            }
+
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      page = first - 1;
+    }
+
+  if (b->valid > 0)
+    {
+      ferr("ERROR: Block %" PRIu32 " keeps %u valid pages\n",
+           blk, b->valid);
+      return -EIO;
+    }
+
+  /* The copies must be durable before the originals are erased */
+
+  ret = ftl_log_commit(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* A block that fails to erase is retired:  The collection succeeded */
+
+  ftl_log_erase(dev, blk);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_reserve
+ *
+ * Description:
+ *   Collect blocks until the collector has its free blocks in reserve.
+ *
+ ****************************************************************************/
+
+static int ftl_log_reserve(FAR struct ftl_log_s *dev)
+{
+  uint32_t victim;
+  int ret;
+
+  while (dev->nfree < FTL_LOG_MINFREE)
+    {
+      victim = ftl_log_victim(dev, false);
+      if (victim == FTL_LOG_NONE)
+        {
+          return dev->nfree > 0 || dev->openblk != FTL_LOG_NONE ?
+                 OK : -ENOSPC;
+        }
+
+      ret = ftl_log_collect(dev, victim);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_gcthread
+ *
+ * Description:
+ *   Commit the open group and collect blocks while the device is idle.
+ *   The thread frees the device when it exits.
+ *
+ ****************************************************************************/
+
+static int ftl_log_gcthread(int argc, FAR char *argv[])
+{
+  FAR struct ftl_log_s *dev =
+    (FAR struct ftl_log_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+  uint32_t victim;
+
+  for (; ; )
+    {
+      nxsem_tickwait(&dev->gcsem, MSEC2TICK(CONFIG_FTL_LOG_GC_INTERVAL));
+
+      nxmutex_lock(&dev->lock);
+      if (dev->exiting)
+        {
+          nxmutex_unlock(&dev->lock);
+          break;
+        }
+
+      if (!dev->dirty)
+        {
+          ftl_log_commit(dev);
+
+          /* Level the wear first:  It does not happen while writing */
+
+          victim = ftl_log_victim(dev, true);
+          if (victim != FTL_LOG_NONE && !dev->blocks[victim].retired &&
+              dev->maxec - dev->blocks[victim].ec <
+              CONFIG_FTL_LOG_WEAR_THRESHOLD)
+            {
+              victim = FTL_LOG_NONE;
+            }
+
+          if (victim == FTL_LOG_NONE &&
+              dev->nfree < CONFIG_FTL_LOG_GC_FREEBLOCKS)
+            {
+              victim = ftl_log_victim(dev, false);
+            }
+
+          /* Collecting a block may take a free block before it frees
+           * one, and retired blocks are not freed at all.
+           */
+
+          if (victim != FTL_LOG_NONE &&
+              dev->nfree >= (dev->blocks[victim].retired ?
+                             FTL_LOG_MINFREE : 1))
+            {
+              ftl_log_collect(dev, victim);
+            }
+        }
+
+      dev->dirty = false;
+      nxmutex_unlock(&dev->lock);
+    }
+
+  ftl_log_free(dev);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_scan_block
+ *
+ * Description:
+ *   Read the header of a block and find its last summary.
+ *
+ ****************************************************************************/
+
+static void ftl_log_scan_block(FAR struct ftl_log_s *dev, uint32_t blk)
+{
+  FAR struct ftl_log_block_s *b = &dev->blocks[blk];
+  FAR struct ftl_log_header_s *hdr =
+    (FAR struct ftl_log_header_s *)dev->scan;
+  FAR struct ftl_log_summary_s *sum =
+    (FAR struct ftl_log_summary_s *)dev->scan;
+  uint32_t base = blk * dev->blkper;
+  bool written = false;
+  uint16_t page;
+
+  /* Blocks without a header are of unknown content:  They are erased
+   * when they are collected.
+   */
+
+  b->state = FTL_LOG_FULL;
+  if (MTD_ISBAD(dev->mtd, blk) > 0)
+    {
+      b->state = FTL_LOG_BAD;
+      return;
+    }
+
+  if (ftl_log_readpage(dev, base, dev->scan) < 0 ||
+      !ftl_log_check_header(dev->scan))
+    {
+      return;
+    }
+
+  b->ec      = hdr->ec;
+  dev->maxec = MAX(dev->maxec, b->ec);
+
+  /* Pages are programmed in order:  The last summary is the last valid
+   * one, later pages belong to an uncommitted group.
+   */
+
+  for (page = dev->blkper - 1; page > 0; page--)
+    {
+      if (ftl_log_readpage(dev, base + page, dev->scan) < 0)
+        {
+          written = true;
+        }
+      else if (ftl_log_check_summary(dev, dev->scan, page))
+        {
+          b->last = page;
+          b->seq  = sum->seq;
+          dev->seq = MAX(dev->seq, sum->seq + 1);
+          return;
+        }
+      else if (!ftl_log_erased(dev->scan, dev->geo.blocksize))
+        {
+          written = true;
+        }
+    }
+
+  if (!written)
+    {
+      b->state = FTL_LOG_FREE;
+      dev->nfree++;
+    }
+}
+
+/****************************************************************************
+ * Name: ftl_log_replay_block
+ *
+ * Description:
+ *   Map the sectors of the summaries of a block that are not mapped by a
+ *   newer summary.
+ *
+ ****************************************************************************/
+
+static void ftl_log_replay_block(FAR struct ftl_log_s *dev, uint32_t blk)
+{
+  FAR struct ftl_log_block_s *b = &dev->blocks[blk];
+  FAR struct ftl_log_summary_s *sum =
+    (FAR struct ftl_log_summary_s *)dev->scan;
+  FAR uint32_t *entries = ftl_log_entries(dev->scan);
+  uint32_t base = blk * dev->blkper;
+  uint16_t page = b->last;
+  uint16_t first;
+  int i;
+
+  while (page > 0)
+    {
+      if (ftl_log_readpage(dev, base + page, dev->scan) < 0 ||
+          !ftl_log_check_summary(dev, dev->scan, page))
+        {
+          ferr("ERROR: Broken summary chain in block %" PRIu32 "\n", blk);
+          break;
+        }
+
+      first = page - sum->count;
+      for (i = sum->count - 1; i >= 0; i--)
+        {
+          if (entries[i] < dev->nlogical &&
+              dev->l2p[entries[i]] == FTL_LOG_NONE)
+            {
+              dev->l2p[entries[i]] = base + first + i;
+              b->valid++;
+            }
+        }
+
+      page = first - 1;
+    }
+}
+
+/****************************************************************************
+ * Name: ftl_log_compare
+ *
+ * Description: Order blocks by decreasing summary sequence number.
+ *
+ ****************************************************************************/
+
+static int ftl_log_compare(FAR const void *a, FAR const void *b)
+{
+  FAR const uint32_t *x = a;
+  FAR const uint32_t *y = b;
+
+  return x[0] < y[0] ? 1 : x[0] > y[0] ? -1 : 0;
+}
+
+/****************************************************************************
+ * Name: ftl_log_mount
+ *
+ * Description:
+ *   Scan the device and rebuild the map from the summaries, newest first.
+ *
+ ****************************************************************************/
+
+static int ftl_log_mount(FAR struct ftl_log_s *dev)
+{
+  FAR uint32_t *order;
+  uint32_t count = 0;
+  uint32_t i;
+
+  /* Pairs of (sequence number, block) of the blocks with summaries */
+
+  order = kmm_malloc(dev->geo.neraseblocks * 2 * sizeof(uint32_t));
+  if (order == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      ftl_log_scan_block(dev, i);
+      if (dev->blocks[i].last > 0)
+        {
+          order[2 * count]     = dev->blocks[i].seq;
+          order[2 * count + 1] = i;
+          count++;
+        }
+    }
+
+  qsort(order, count, 2 * sizeof(uint32_t), ftl_log_compare);
+
+  for (i = 0; i < count; i++)
+    {
+      ftl_log_replay_block(dev, order[2 * i + 1]);
+    }
+
+  kmm_free(order);
+
+  finfo("%" PRIu32 " blocks with data, %" PRIu32 " free, max ec %" PRIu32
+        "\n", count, dev->nfree, dev->maxec);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_free
+ *
+ * Description: Free the device.
+ *
+ ****************************************************************************/
+
+static void ftl_log_free(FAR struct ftl_log_s *dev)
+{
+  nxmutex_destroy(&dev->lock);
+  nxsem_destroy(&dev->gcsem);
+  kmm_free(dev->pending);
+  kmm_free(dev->rbuf);
+  kmm_free(dev->scan);
+  kmm_free(dev->page);
+  kmm_free(dev->sum);
+  kmm_free(dev->l2p);
+  kmm_free(dev->blocks);
+  kmm_free(dev);
+}
+
+/****************************************************************************
+ * Name: ftl_log_release
+ *
+ * Description:
+ *   Ask the collector thread to free the device once it is neither open
+ *   nor registered.  Called with the lock held.
+ *
+ ****************************************************************************/
+
+static void ftl_log_release(FAR struct ftl_log_s *dev)
+{
+  if (dev->refs == 0 && dev->unlinked)
+    {
+      dev->exiting = true;
+      nxsem_post(&dev->gcsem);
+    }
+}
+
+/****************************************************************************
+ * Name: ftl_log_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+static int ftl_log_open(FAR struct inode *inode)
+{
+  FAR struct ftl_log_s *dev;
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+  nxmutex_lock(&dev->lock);
+  dev->refs++;
+  nxmutex_unlock(&dev->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_close
+ *
+ * Description: close the block device
+ *
+ ****************************************************************************/
+
+static int ftl_log_close(FAR struct inode *inode)
+{
+  FAR struct ftl_log_s *dev;
+  int ret;
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+  nxmutex_lock(&dev->lock);
+  ret = ftl_log_commit(dev);
+  dev->refs--;
+  ftl_log_release(dev);
+  nxmutex_unlock(&dev->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_read
+ *
+ * Description:  Read the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_log_read(FAR struct inode *inode,
+                            FAR unsigned char *buffer,
+                            blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct ftl_log_s *dev;
+  uint32_t phys;
+  size_t count;
+  size_t nread = 0;
+  ssize_t ret = 0;
+
+  finfo("sector: %" PRIuOFF " nsectors: %u\n", start_sector, nsectors);
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+  if (start_sector >= dev->nlogical)
+    {
+      return -EINVAL;
+    }
+
+  nsectors = MIN(nsectors, dev->nlogical - start_sector);
+
+  nxmutex_lock(&dev->lock);
+  while (nread < nsectors)
+    {
+      /* Read pages that are contiguous on flash at once */
+
+      phys = dev->l2p[start_sector + nread];
+      for (count = 1; nread + count < nsectors; count++)
+        {
+          if (phys == FTL_LOG_NONE ?
+              dev->l2p[start_sector + nread + count] != FTL_LOG_NONE :
+              dev->l2p[start_sector + nread + count] != phys + count)
+            {
+              break;
+            }
+        }
+
+      if (phys == FTL_LOG_NONE)
+        {
+          memset(buffer, 0xff, count * dev->geo.blocksize);
+        }
+      else
+        {
+          ret = MTD_BREAD(dev->mtd, phys, count, buffer);
+          if (ret != count && ret != -EUCLEAN)
+            {
+              ferr("ERROR: Read %zu pages at %" PRIu32 " failed: %zd\n",
+                   count, phys, ret);
+              break;
+            }
+        }
+
+      nread  += count;
+      buffer += count * dev->geo.blocksize;
+    }
+
+  nxmutex_unlock(&dev->lock);
+  return nread > 0 ? (ssize_t)nread : ret < 0 ? ret : -EIO;
+}
+
+/****************************************************************************
+ * Name: ftl_log_write
+ *
+ * Description: Write the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_log_write(FAR struct inode *inode,
+                             FAR const unsigned char *buffer,
+                             blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct ftl_log_s *dev;
+  unsigned int nwritten;
+  int ret = OK;
+
+  finfo("sector: %" PRIuOFF " nsectors: %u\n", start_sector, nsectors);
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+  if (start_sector >= dev->nlogical)
+    {
+      return -EINVAL;
+    }
+
+  nsectors = MIN(nsectors, dev->nlogical - start_sector);
+
+  nxmutex_lock(&dev->lock);
+  for (nwritten = 0; nwritten < nsectors; nwritten++)
+    {
+      ret = ftl_log_reserve(dev);
+      if (ret >= 0)
+        {
+          ret = ftl_log_append(dev, start_sector + nwritten, buffer);
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      buffer += dev->geo.blocksize;
+    }
+
+  dev->dirty = true;
+  nxmutex_unlock(&dev->lock);
+  return nwritten > 0 ? (ssize_t)nwritten : ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int ftl_log_geometry(FAR struct inode *inode,
+                            FAR struct geometry *geometry)
+{
+  FAR struct ftl_log_s *dev;
+
+  finfo("Entry\n");
+
+  if (geometry)
+    {
+      dev = inode->i_private;
+      geometry->geo_available     = true;
+      geometry->geo_mediachanged  = false;
+      geometry->geo_writeenabled  = true;
+      geometry->geo_nsectors      = dev->nlogical;
+      geometry->geo_sectorsize    = dev->geo.blocksize;
+
+      strlcpy(geometry->geo_model, dev->geo.model,
+              sizeof(geometry->geo_model));
+
+      finfo("nsectors: %" PRIuOFF " sectorsize: %u\n",
+            geometry->geo_nsectors, geometry->geo_sectorsize);
+
+      return OK;
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: ftl_log_ioctl
+ *
+ * Description: Flush the open group and pass other commands to the MTD
+ *
+ ****************************************************************************/
+
+static int ftl_log_ioctl(FAR struct inode *inode, int cmd,
+                         unsigned long arg)
+{
+  FAR struct ftl_log_s *dev;
+  int ret;
+
+  finfo("Entry\n");
+  DEBUGASSERT(inode->i_private);
+
+  dev = inode->i_private;
+
+  if (cmd == BIOC_FLUSH)
+    {
+      nxmutex_lock(&dev->lock);
+      ret = ftl_log_commit(dev);
+      nxmutex_unlock(&dev->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ret = MTD_IOCTL(dev->mtd, cmd, arg);
+  if (ret < 0 && ret != -ENOTTY)
+    {
+      ferr("ERROR: MTD ioctl(%04x) failed: %d\n", cmd, ret);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_unlink
+ *
+ * Description: Unlink the device
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int ftl_log_unlink(FAR struct inode *inode)
+{
+  FAR struct ftl_log_s *dev;
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+  nxmutex_lock(&dev->lock);
+  dev->unlinked = true;
+  ftl_log_release(dev);
+  nxmutex_unlock(&dev->lock);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_log_initialize
+ *
+ * Description:
+ *   Register a log-structured block driver on top of an MTD device.
+ *
+ * Input Parameters:
+ *   path - The block device path.
+ *   mtd  - The MTD device that supports the FLASH interface.
+ *
+ ****************************************************************************/
+
+int ftl_log_initialize(FAR const char *path, FAR struct mtd_dev_s *mtd)
+{
+  FAR struct ftl_log_s *dev;
+  FAR char *argv[2];
+  char arg1[32];
+  uint32_t usable;
+  uint16_t pages;
+  int ret;
+
+  dev = kmm_zalloc(sizeof(struct ftl_log_s));
+  if (dev == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  dev->mtd     = mtd;
+  dev->openblk = FTL_LOG_NONE;
+  nxmutex_init(&dev->lock);
+  nxsem_init(&dev->gcsem, 0, 0);
+
+  ret = MTD_IOCTL(mtd, MTDIOC_GEOMETRY,
+                  (unsigned long)((uintptr_t)&dev->geo));
+  if (ret < 0)
+    {
+      ferr("ERROR: MTD ioctl(MTDIOC_GEOMETRY) failed: %d\n", ret);
+      goto errout;
+    }
+
+  /* A block needs a header, a data page and a summary, and a summary
+   * needs room for a few entries.
+   */
+
+  dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
+  usable      = dev->geo.neraseblocks *
+                (100 - CONFIG_FTL_LOG_OVERPROVISION) / 100;
+  if (dev->blkper < 4 || dev->geo.blocksize < 64 ||
+      usable <= FTL_LOG_MINFREE)
+    {
+      ret = -ENOTSUP;
+      goto errout;
+    }
+
+  /* The capacity is based on blocks of full groups, which the collector
+   * produces.  Blocks of partial groups hold fewer pages and are collected
+   * first.
+   */
+
+  dev->groupmax = MIN((dev->geo.blocksize -
+                       sizeof(struct ftl_log_summary_s)) / sizeof(uint32_t),
+                      dev->blkper - 2);
+  pages         = dev->blkper - 1;
+  dev->dense    = pages / (dev->groupmax + 1) * dev->groupmax;
+  if (pages % (dev->groupmax + 1) > 1)
+    {
+      dev->dense += pages % (dev->groupmax + 1) - 1;
+    }
+
+  dev->nlogical = (usable - FTL_LOG_MINFREE) * dev->dense;
+
+  dev->blocks  = kmm_zalloc(dev->geo.neraseblocks *
+                            sizeof(struct ftl_log_block_s));
+  dev->l2p     = kmm_malloc(dev->nlogical * sizeof(uint32_t));
+  dev->sum     = kmm_malloc(dev->geo.blocksize);
+  dev->page    = kmm_malloc(dev->geo.blocksize);
+  dev->scan    = kmm_malloc(dev->geo.blocksize);
+  dev->rbuf    = kmm_malloc(dev->geo.blocksize);
+  dev->pending = kmm_malloc(dev->groupmax *
+                            sizeof(struct ftl_log_pending_s));
+  if (dev->blocks == NULL || dev->l2p == NULL || dev->sum == NULL ||
+      dev->page == NULL || dev->scan == NULL || dev->rbuf == NULL ||
+      dev->pending == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  memset(dev->l2p, 0xff, dev->nlogical * sizeof(uint32_t));
+
+  ret = ftl_log_mount(dev);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  snprintf(arg1, sizeof(arg1), "%p", dev);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  ret = kthread_create("ftl_gc", CONFIG_FTL_LOG_GC_PRIORITY,
+                       CONFIG_FTL_LOG_GC_STACKSIZE, ftl_log_gcthread, argv);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to start the collector: %d\n", ret);
+      goto errout;
+    }
+
+  ret = register_blockdriver(path, &g_ftl_log_bops, 0, dev);
+  if (ret < 0)
+    {
+      ferr("ERROR: register_blockdriver failed: %d\n", -ret);
+
+      nxmutex_lock(&dev->lock);
+      dev->unlinked = true;
+      ftl_log_release(dev);
+      nxmutex_unlock(&dev->lock);
+    }
+
+  return ret;
+
+errout:
+  ftl_log_free(dev);
+  return ret;
+}
+
+#endif /* CONFIG_FTL_LOG */
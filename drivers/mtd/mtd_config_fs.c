@@ -84,6 +84,22 @@
 #define NVS_ALIGN_SIZE                  CONFIG_MTD_WRITE_ALIGN_SIZE
 #define NVS_ALIGN_UP(x)                 (((x) + NVS_ALIGN_SIZE - 1) & ~(NVS_ALIGN_SIZE - 1))
 
+/* The RAM index of the newest ate of each key.  Hash ids are never 0, and
+ * special ates are never indexed, so these ids can mark the free slots.
+ */
+
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX
+#  define NVS_INDEX_EMPTY               0
+#  define NVS_INDEX_REMOVED             NVS_SPECIAL_ATE_ID
+#  define NVS_INDEX_NONE                0xffffffff
+#  define NVS_INDEX_MINSIZE             32
+#else
+#  define nvs_index_update(fs, id, from, to)
+#  define nvs_index_drop(fs, addr)
+#  define nvs_index_free(fs)
+#  define nvs_index_build(fs)           0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -102,8 +118,24 @@ struct nvs_fs
   uint32_t              data_wra;      /* Next data write address */
   uint32_t              step_addr;     /* For traverse */
   mutex_t               nvs_lock;
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX
+  FAR struct nvs_index_s *index;       /* Newest ate of each key */
+  uint32_t              index_mask;    /* Number of index slots - 1 */
+  uint32_t              index_count;   /* Keys in the index */
+  uint32_t              index_used;    /* Slots not empty */
+#endif
 };
 
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX
+/* Index slot, one for each key that has an ate in flash */
+
+struct nvs_index_s
+{
+  uint32_t id;           /* Hash id of the key */
+  uint32_t addr;         /* Address of the newest ate of the key */
+};
+#endif
+
 /* Allocation Table Entry */
 
 begin_packed_struct struct nvs_ate
@@ -928,6 +960,318 @@ static int nvs_expire_ate(FAR struct nvs_fs *fs, uint32_t addr)
                        expired, sizeof(expired));
 }
 
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX
+
+/****************************************************************************
+ * Name: nvs_index_free
+ *
+ * Description:
+ *   Drop the index, lookups walk the ates in flash again.
+ *
+ ****************************************************************************/
+
+static void nvs_index_free(FAR struct nvs_fs *fs)
+{
+  kmm_free(fs->index);
+  fs->index = NULL;
+}
+
+/****************************************************************************
+ * Name: nvs_index_resize
+ *
+ * Description:
+ *   Move the keys to a new index of size slots, dropping the removed ones.
+ *
+ ****************************************************************************/
+
+static int nvs_index_resize(FAR struct nvs_fs *fs, uint32_t size)
+{
+  FAR struct nvs_index_s *index;
+  uint32_t i;
+  uint32_t j;
+
+  index = kmm_zalloc(size * sizeof(struct nvs_index_s));
+  if (index == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; fs->index != NULL && i <= fs->index_mask; i++)
+    {
+      if (fs->index[i].id != NVS_INDEX_EMPTY &&
+          fs->index[i].id != NVS_INDEX_REMOVED)
+        {
+          j = fs->index[i].id & (size - 1);
+          while (index[j].id != NVS_INDEX_EMPTY)
+            {
+              j = (j + 1) & (size - 1);
+            }
+
+          index[j] = fs->index[i];
+        }
+    }
+
+  kmm_free(fs->index);
+  fs->index = index;
+  fs->index_mask = size - 1;
+  fs->index_used = fs->index_count;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: nvs_index_add
+ *
+ * Description:
+ *   Add the newest ate of a key that is not in the index yet.  If the
+ *   index can't grow it is dropped.
+ *
+ ****************************************************************************/
+
+static void nvs_index_add(FAR struct nvs_fs *fs, uint32_t id, uint32_t addr)
+{
+  uint32_t size;
+  uint32_t i;
+
+  if (fs->index == NULL)
+    {
+      return;
+    }
+
+  /* Keep at least a quarter of the slots empty so probing stays short */
+
+  size = fs->index_mask + 1;
+  if ((fs->index_used + 1) * 4 > size * 3)
+    {
+      if ((fs->index_count + 1) * 2 > size)
+        {
+          size *= 2;
+        }
+
+      if (nvs_index_resize(fs, size) < 0)
+        {
+          fwarn("No memory for the index, walking the ates\n");
+          nvs_index_free(fs);
+          return;
+        }
+    }
+
+  i = id & fs->index_mask;
+  while (fs->index[i].id != NVS_INDEX_EMPTY &&
+         fs->index[i].id != NVS_INDEX_REMOVED)
+    {
+      i = (i + 1) & fs->index_mask;
+    }
+
+  if (fs->index[i].id == NVS_INDEX_EMPTY)
+    {
+      fs->index_used++;
+    }
+
+  fs->index[i].id = id;
+  fs->index[i].addr = addr;
+  fs->index_count++;
+}
+
+/****************************************************************************
+ * Name: nvs_index_update
+ *
+ * Description:
+ *   The newest ate of a key moved from addr from to addr to.  A key that
+ *   is not found at from is added.
+ *
+ ****************************************************************************/
+
+static void nvs_index_update(FAR struct nvs_fs *fs, uint32_t id,
+                             uint32_t from, uint32_t to)
+{
+  uint32_t i;
+
+  if (fs->index == NULL)
+    {
+      return;
+    }
+
+  for (i = id & fs->index_mask; fs->index[i].id != NVS_INDEX_EMPTY;
+       i = (i + 1) & fs->index_mask)
+    {
+      if (fs->index[i].id == id && fs->index[i].addr == from)
+        {
+          fs->index[i].addr = to;
+          return;
+        }
+    }
+
+  nvs_index_add(fs, id, to);
+}
+
+/****************************************************************************
+ * Name: nvs_index_drop
+ *
+ * Description:
+ *   Remove the keys whose newest ate is in the block at addr, the block is
+ *   about to be erased.  gc has moved all the keys still alive, so only
+ *   deleted keys are left there.
+ *
+ ****************************************************************************/
+
+static void nvs_index_drop(FAR struct nvs_fs *fs, uint32_t addr)
+{
+  uint32_t i;
+
+  for (i = 0; fs->index != NULL && i <= fs->index_mask; i++)
+    {
+      if (fs->index[i].id != NVS_INDEX_EMPTY &&
+          fs->index[i].id != NVS_INDEX_REMOVED &&
+          (fs->index[i].addr & ADDR_BLOCK_MASK) ==
+          (addr & ADDR_BLOCK_MASK))
+        {
+          fs->index[i].id = NVS_INDEX_REMOVED;
+          fs->index_count--;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nvs_index_find
+ *
+ * Description:
+ *   Look up the newest ate of key.  This reads the ate and the key of the
+ *   keys with the same hash id only.
+ *
+ * Returned Value:
+ *   0 if found, -ENOENT if the key has no ate, else a flash error.
+ *
+ ****************************************************************************/
+
+static int nvs_index_find(FAR struct nvs_fs *fs, uint32_t id,
+                          FAR const uint8_t *key, size_t key_size,
+                          FAR struct nvs_ate *ate, FAR uint32_t *ate_addr)
+{
+  uint32_t addr;
+  uint32_t i;
+  int rc;
+
+  for (i = id & fs->index_mask; fs->index[i].id != NVS_INDEX_EMPTY;
+       i = (i + 1) & fs->index_mask)
+    {
+      if (fs->index[i].id != id)
+        {
+          continue;
+        }
+
+      addr = fs->index[i].addr;
+      rc = nvs_flash_ate_rd(fs, addr, ate);
+      if (rc)
+        {
+          return rc;
+        }
+
+      if (ate->key_len == key_size &&
+          !nvs_flash_block_cmp(fs, (addr & ADDR_BLOCK_MASK) + ate->offset,
+                               key, key_size))
+        {
+          *ate_addr = addr;
+          return 0;
+        }
+
+      fwarn("hash conflict\n");
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: nvs_index_build
+ *
+ * Description:
+ *   Index the newest ate of each key with one walk over all the ates.
+ *   The walk goes from the newest ate to the oldest, so the first ate seen
+ *   of a key is its newest one.  Without memory for the index, lookups
+ *   walk the ates in flash instead.
+ *
+ ****************************************************************************/
+
+static int nvs_index_build(FAR struct nvs_fs *fs)
+{
+  struct nvs_ate wlk_ate;
+  struct nvs_ate idx_ate;
+  uint32_t wlk_addr;
+  uint32_t rd_addr;
+  uint32_t addr;
+  uint32_t i;
+  int rc;
+
+  nvs_index_free(fs);
+  fs->index_count = 0;
+  if (nvs_index_resize(fs, NVS_INDEX_MINSIZE) < 0)
+    {
+      fwarn("No memory for the index, walking the ates\n");
+      return 0;
+    }
+
+  wlk_addr = fs->ate_wra;
+  do
+    {
+      rd_addr = wlk_addr;
+      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
+      if (rc)
+        {
+          goto errout;
+        }
+
+      if (wlk_ate.id == NVS_SPECIAL_ATE_ID || !nvs_ate_valid(fs, &wlk_ate))
+        {
+          continue;
+        }
+
+      /* Skip the older ates of a key already in the index */
+
+      for (i = wlk_ate.id & fs->index_mask;
+           fs->index[i].id != NVS_INDEX_EMPTY;
+           i = (i + 1) & fs->index_mask)
+        {
+          if (fs->index[i].id != wlk_ate.id)
+            {
+              continue;
+            }
+
+          addr = fs->index[i].addr;
+          rc = nvs_flash_ate_rd(fs, addr, &idx_ate);
+          if (rc)
+            {
+              goto errout;
+            }
+
+          if (idx_ate.key_len == wlk_ate.key_len &&
+              !nvs_flash_direct_cmp(fs, (addr & ADDR_BLOCK_MASK) +
+                                    idx_ate.offset,
+                                    (rd_addr & ADDR_BLOCK_MASK) +
+                                    wlk_ate.offset, wlk_ate.key_len))
+            {
+              break;
+            }
+        }
+
+      if (fs->index[i].id == NVS_INDEX_EMPTY)
+        {
+          nvs_index_add(fs, wlk_ate.id, rd_addr);
+          if (fs->index == NULL)
+            {
+              return 0;
+            }
+        }
+    }
+  while (wlk_addr != fs->ate_wra);
+
+  finfo("%" PRIu32 " keys indexed\n", fs->index_count);
+  return 0;
+
+errout:
+  nvs_index_free(fs);
+  return rc;
+}
+#endif /* CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX */
+
 /****************************************************************************
  * Name: nvs_gc
  *
@@ -1036,6 +1380,9 @@ static int nvs_gc(FAR struct nvs_fs *fs)
             {
               return rc;
             }
+
+          nvs_index_update(fs, gc_ate.id, gc_prev_addr,
+                           fs->ate_wra + sizeof(struct nvs_ate));
         }
     }
   while (gc_prev_addr != stop_addr);
@@ -1049,6 +1396,7 @@ gc_done:
 
   /* Erase the gc'ed block */
 
+  nvs_index_drop(fs, sec_addr);
   rc = nvs_flash_erase_block(fs, sec_addr);
   if (rc)
     {
@@ -1084,6 +1432,7 @@ static int nvs_startup(FAR struct nvs_fs *fs)
 
   fs->ate_wra = 0;
   fs->data_wra = 0;
+  nvs_index_free(fs);
 
   /* Get the device geometry. (Casting to uintptr_t first eliminates
    * complaints on some architectures where the sizeof long is different
@@ -1423,6 +1772,11 @@ end:
       rc = nvs_add_gc_done_ate(fs);
     }
 
+  if (!rc)
+    {
+      rc = nvs_index_build(fs);
+    }
+
   finfo("%" PRIu32 " Eraseblocks of %" PRIu32 " bytes\n",
         fs->nblocks, fs->blocksize);
   finfo("alloc wra: %" PRIu32 ", 0x%" PRIx32 "\n",
@@ -1434,80 +1788,119 @@ end:
 }
 
 /****************************************************************************
- * Name: nvs_read_entry
+ * Name: nvs_find_ate
  *
  * Description:
- *   Read An entry from the file system. But expired ones will return
- *   -ENOENT.
+ *   Find the newest ate of key, expired or not.
  *
  * Input Parameters:
  *   fs       - Pointer to file system.
- *   key      - Key of the entry to be read.
+ *   hash_id  - Hash id of the key.
+ *   key      - Key of the entry to be found.
  *   key_size - Size of key.
- *   data     - Pointer to data buffer.
- *   len      - Number of bytes to be read.
+ *   ate      - The found ate.
  *   ate_addr - The addr of found ate.
  *
  * Returned Value:
- *   Number of bytes read. On success, it will be equal to the number
- *   of bytes requested to be read. When the return value is larger than the
- *   number of bytes requested to read this indicates not all bytes were
- *   read, and more data is available. On error returns -ERRNO code.
+ *   0 if found, -ENOENT if the key has no ate, else -ERRNO code.
  *
  ****************************************************************************/
 
-static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
-                size_t key_size, FAR void *data, size_t len,
-                FAR uint32_t *ate_addr)
+static int nvs_find_ate(FAR struct nvs_fs *fs, uint32_t hash_id,
+                        FAR const uint8_t *key, size_t key_size,
+                        FAR struct nvs_ate *ate, FAR uint32_t *ate_addr)
 {
   int rc;
   uint32_t wlk_addr;
   uint32_t rd_addr;
-  uint32_t hist_addr;
-  struct nvs_ate wlk_ate;
-  uint32_t hash_id;
 
-  hash_id = nvs_fnv_hash(key, key_size) % 0xfffffffd + 1;
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX
+  if (fs->index != NULL)
+    {
+      return nvs_index_find(fs, hash_id, key, key_size, ate, ate_addr);
+    }
+#endif
+
   wlk_addr = fs->ate_wra;
-  rd_addr = wlk_addr;
 
   do
     {
       rd_addr = wlk_addr;
-      hist_addr = wlk_addr;
-      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
+      rc = nvs_prev_ate(fs, &wlk_addr, ate);
       if (rc)
         {
           ferr("Walk to previous ate failed, rc=%d\n", rc);
           return rc;
         }
 
-      if ((wlk_ate.id == hash_id) && (nvs_ate_valid(fs, &wlk_ate)))
+      if ((ate->id == hash_id) && (nvs_ate_valid(fs, ate)))
         {
-          if ((wlk_ate.key_len == key_size)
+          if ((ate->key_len == key_size)
               && (!nvs_flash_block_cmp(fs,
-              (rd_addr & ADDR_BLOCK_MASK) + wlk_ate.offset, key, key_size)))
+              (rd_addr & ADDR_BLOCK_MASK) + ate->offset, key, key_size)))
             {
-              /* It is old or deleted, return -ENOENT */
-
-              if (wlk_ate.expired[0] != fs->erasestate)
-                {
-                  return -ENOENT;
-                }
-              break;
+              *ate_addr = rd_addr;
+              return 0;
             }
           else
             {
               fwarn("hash conflict\n");
             }
         }
+    }
+  while (wlk_addr != fs->ate_wra);
 
-      if (wlk_addr == fs->ate_wra)
-        {
-          return -ENOENT;
-        }
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: nvs_read_entry
+ *
+ * Description:
+ *   Read An entry from the file system. But expired ones will return
+ *   -ENOENT.
+ *
+ * Input Parameters:
+ *   fs       - Pointer to file system.
+ *   key      - Key of the entry to be read.
+ *   key_size - Size of key.
+ *   data     - Pointer to data buffer.
+ *   len      - Number of bytes to be read.
+ *   ate_addr - The addr of found ate.
+ *
+ * Returned Value:
+ *   Number of bytes read. On success, it will be equal to the number
+ *   of bytes requested to be read. When the return value is larger than the
+ *   number of bytes requested to read this indicates not all bytes were
+ *   read, and more data is available. On error returns -ERRNO code.
+ *
+ ****************************************************************************/
+
+static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
+                size_t key_size, FAR void *data, size_t len,
+                FAR uint32_t *ate_addr)
+{
+  int rc;
+  uint32_t rd_addr;
+  uint32_t hist_addr;
+  struct nvs_ate wlk_ate;
+  uint32_t hash_id;
+
+  hash_id = nvs_fnv_hash(key, key_size) % 0xfffffffd + 1;
+  rc = nvs_find_ate(fs, hash_id, key, key_size, &wlk_ate, &hist_addr);
+  if (rc)
+    {
+      return rc;
     }
-  while (true);
+
+  /* It is old or deleted, return -ENOENT */
+
+  if (wlk_ate.expired[0] != fs->erasestate)
+    {
+      return -ENOENT;
+    }
+
+  rd_addr = hist_addr;
 
   if (data && len)
     {
@@ -1554,7 +1947,6 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
   size_t data_size;
   size_t key_size;
   struct nvs_ate wlk_ate;
-  uint32_t wlk_addr;
   uint32_t rd_addr;
   uint32_t hist_addr;
   uint16_t required_space = 0;
@@ -1600,38 +1992,14 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
 
   /* Find latest entry with same id. */
 
-  wlk_addr = fs->ate_wra;
-
-  while (1)
+  rc = nvs_find_ate(fs, hash_id, key, key_size, &wlk_ate, &hist_addr);
+  if (rc == 0)
     {
-      rd_addr = wlk_addr;
-      hist_addr = wlk_addr;
-      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
-      if (rc)
-        {
-          return rc;
-        }
-
-      if ((wlk_ate.id == hash_id) && (nvs_ate_valid(fs, &wlk_ate)))
-        {
-          if ((wlk_ate.key_len == key_size)
-              && !nvs_flash_block_cmp(fs,
-                                      (rd_addr & ADDR_BLOCK_MASK) +
-                                      wlk_ate.offset, key, key_size))
-            {
-              prev_found = true;
-              break;
-            }
-          else
-            {
-              fwarn("hash conflict\n");
-            }
-        }
-
-      if (wlk_addr == fs->ate_wra)
-        {
-          break;
-        }
+      prev_found = true;
+    }
+  else if (rc != -ENOENT)
+    {
+      return rc;
     }
 
   if (prev_found)
@@ -1640,7 +2008,7 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
 
       /* Previous entry found. */
 
-      rd_addr &= ADDR_BLOCK_MASK;
+      rd_addr = hist_addr & ADDR_BLOCK_MASK;
 
       if (pdata->len == 0)
         {
@@ -1748,11 +2116,17 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
                                    pdata->configdata, pdata->len);
           if (rc)
             {
+              /* The ate may or may not be there, stop using the index */
+
               fwarn("Write entry failed\n");
+              nvs_index_free(fs);
               return rc;
             }
 
           finfo("Write entry success\n");
+          nvs_index_update(fs, hash_id,
+                           prev_found ? hist_addr : NVS_INDEX_NONE,
+                           fs->ate_wra + sizeof(struct nvs_ate));
 
           /* Expiring the old ate if exists.
            * After this operation, only the latest ate is valid.
@@ -1785,6 +2159,7 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
       rc = nvs_gc(fs);
       if (rc)
         {
+          nvs_index_free(fs);
           return rc;
         }
 
@@ -2120,6 +2495,10 @@ int mtdconfig_register_by_path(FAR struct mtd_dev_s *mtd,
   /* Initialize the mtdnvs device structure */
 
   fs->mtd = mtd;
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_INDEX
+  fs->index = NULL;
+#endif
+
   ret = nxmutex_init(&fs->nvs_lock);
   if (ret < 0)
     {
@@ -2144,6 +2523,7 @@ int mtdconfig_register_by_path(FAR struct mtd_dev_s *mtd,
   return ret;
 
 mutex_err:
+  nvs_index_free(fs);
   nxmutex_destroy(&fs->nvs_lock);
 
 errout:
@@ -2188,6 +2568,7 @@ int mtdconfig_unregister_by_path(FAR const char *path)
 
   inode = file.f_inode;
   fs = inode->i_private;
+  nvs_index_free(fs);
   nxmutex_destroy(&fs->nvs_lock);
   kmm_free(fs);
   file_close(&file);
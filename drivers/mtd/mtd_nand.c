@@ -39,6 +39,8 @@
 #include <nuttx/config.h>
 #include <nuttx/mtd/nand_config.h>
 
+#include <sys/param.h>
+
 #include <inttypes.h>
 #include <string.h>
 #include <assert.h>
@@ -90,6 +92,12 @@ static int      nand_eraseblock(FAR struct nand_dev_s *nand,
                                 off_t block, bool scrub);
 static int      nand_readpage(FAR struct nand_dev_s *nand, off_t block,
                               unsigned int page, FAR uint8_t *data);
+static int      nand_readpages(FAR struct nand_dev_s *nand, off_t block,
+                               unsigned int page, unsigned int npages,
+                               FAR uint8_t *data);
+static int      nand_writepages(FAR struct nand_dev_s *nand, off_t block,
+                                unsigned int page, unsigned int npages,
+                                FAR const uint8_t *data);
 static int      nand_writepage(FAR struct nand_dev_s *nand, off_t block,
                                unsigned int page, FAR const void *data);
 
@@ -521,6 +529,138 @@ static int nand_writepage(FAR struct nand_dev_s *nand, off_t block,
     }
 }
 
+/****************************************************************************
+ * Name: nand_readpages
+ *
+ * Description:
+ *   Reads the data areas of consecutive pages of one block.  The lower half
+ *   reads them all at once if it supports that, e.g. with the cache read
+ *   commands.  Otherwise they are read one page at a time.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the pages to read reside.
+ *   page   - Number of the first page to read inside the given block.
+ *   npages - Number of pages to read, not beyond the end of the block.
+ *   data   - Buffer where the data areas will be stored.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *   -EUCLEAN is returned if bit errors were corrected.
+ *
+ ****************************************************************************/
+
+static int nand_readpages(FAR struct nand_dev_s *nand, off_t block,
+                          unsigned int page, unsigned int npages,
+                          FAR uint8_t *data)
+{
+  FAR struct nand_raw_s *raw = nand->raw;
+  uint16_t pagesize;
+  bool fixedecc = false;
+  int ret;
+
+  /* Software ECC needs the spare area of each page */
+
+  if (npages > 1 && raw->readpages != NULL
+#ifdef CONFIG_MTD_NAND_SWECC
+      && raw->ecctype != NANDECC_SWECC
+#endif
+     )
+    {
+#ifdef CONFIG_MTD_NAND_BLOCKCHECK
+      if (nand_checkblock(nand, block) != GOODBLOCK)
+        {
+          ferr("ERROR: Block is BAD\n");
+          return -EAGAIN;
+        }
+#endif
+
+      return NAND_READPAGES(raw, block, page, npages, data);
+    }
+
+  pagesize = nandmodel_getpagesize(&raw->model);
+
+  for (; npages > 0; npages--, page++, data += pagesize)
+    {
+      ret = nand_readpage(nand, block, page, data);
+      if (ret == -EUCLEAN)
+        {
+          fixedecc = true;
+        }
+      else if (ret < 0)
+        {
+          ferr("ERROR: nand_readpage failed block=%" PRIdOFF
+               " page=%d: %d\n", block, page, ret);
+          return ret;
+        }
+    }
+
+  return fixedecc ? -EUCLEAN : OK;
+}
+
+/****************************************************************************
+ * Name: nand_writepages
+ *
+ * Description:
+ *   Writes the data areas of consecutive pages of one block.  The lower
+ *   half writes them all at once if it supports that, e.g. with the cache
+ *   program command.  Otherwise they are written one page at a time.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the pages to write reside.
+ *   page   - Number of the first page to write inside the given block.
+ *   npages - Number of pages to write, not beyond the end of the block.
+ *   data   - Buffer containing the data to be written.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+static int nand_writepages(FAR struct nand_dev_s *nand, off_t block,
+                           unsigned int page, unsigned int npages,
+                           FAR const uint8_t *data)
+{
+  FAR struct nand_raw_s *raw = nand->raw;
+  uint16_t pagesize;
+  int ret;
+
+  /* Software ECC needs to write the spare area of each page */
+
+  if (npages > 1 && raw->writepages != NULL
+#ifdef CONFIG_MTD_NAND_SWECC
+      && raw->ecctype != NANDECC_SWECC
+#endif
+     )
+    {
+#ifdef CONFIG_MTD_NAND_BLOCKCHECK
+      if (nand_checkblock(nand, block) != GOODBLOCK)
+        {
+          ferr("ERROR: Block is BAD\n");
+          return -EAGAIN;
+        }
+#endif
+
+      return NAND_WRITEPAGES(raw, block, page, npages, data);
+    }
+
+  pagesize = nandmodel_getpagesize(&raw->model);
+
+  for (; npages > 0; npages--, page++, data += pagesize)
+    {
+      ret = nand_writepage(nand, block, page, data);
+      if (ret < 0)
+        {
+          ferr("ERROR: nand_writepage failed block=%ld page=%d: %d\n",
+               (long)block, page, ret);
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: nand_erase
  *
@@ -578,6 +718,7 @@ static ssize_t nand_bread(FAR struct mtd_dev_s *dev, off_t startpage,
   bool fixedecc = false;
   unsigned int pagesperblock;
   unsigned int page;
+  unsigned int count;
   uint16_t pagesize;
   size_t remaining;
   off_t maxblock;
@@ -609,9 +750,11 @@ static ssize_t nand_bread(FAR struct mtd_dev_s *dev, off_t startpage,
 
   nxmutex_lock(&nand->lock);
 
-  /* Then read every page from NAND */
+  /* Then read every page from NAND, as many pages of one block as
+   * possible at a time.
+   */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= count)
     {
       /* Check for attempt to read beyond the end of NAND */
 
@@ -624,34 +767,24 @@ static ssize_t nand_bread(FAR struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
-      /* Read the next page from NAND */
+      /* Read the next pages from NAND */
 
-      ret = nand_readpage(nand, block, page, buffer);
+      count = MIN(remaining, pagesperblock - page);
+      ret   = nand_readpages(nand, block, page, count, buffer);
       if (ret == -EUCLEAN)
         {
           fixedecc = true;
         }
       else if (ret < 0)
         {
-          ferr("ERROR: nand_readpage failed block=%" PRIdOFF
-               " page=%d: %d\n", block, page, ret);
           goto errout_with_lock;
         }
 
-      /* Increment the page number.  If we exceed the number of
-       * pages per block, then reset the page number and bump up
-       * the block number.
-       */
+      /* Continue with the first page of the next block */
 
-      if (++page >= pagesperblock)
-        {
-          page = 0;
-          block++;
-        }
-
-      /* Increment the buffer point by the size of one page */
-
-      buffer += pagesize;
+      page = 0;
+      block++;
+      buffer += (size_t)count * pagesize;
     }
 
   nxmutex_unlock(&nand->lock);
@@ -678,6 +811,7 @@ static ssize_t nand_bwrite(FAR struct mtd_dev_s *dev, off_t startpage,
   FAR struct nand_model_s *model;
   unsigned int pagesperblock;
   unsigned int page;
+  unsigned int count;
   uint16_t pagesize;
   size_t remaining;
   off_t maxblock;
@@ -709,9 +843,11 @@ static ssize_t nand_bwrite(FAR struct mtd_dev_s *dev, off_t startpage,
 
   nxmutex_lock(&nand->lock);
 
-  /* Then write every page into NAND */
+  /* Then write every page into NAND, as many pages of one block as
+   * possible at a time.
+   */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= count)
     {
       /* Check for attempt to write beyond the end of NAND */
 
@@ -724,30 +860,20 @@ static ssize_t nand_bwrite(FAR struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
-      /* Write the next page into NAND */
+      /* Write the next pages into NAND */
 
-      ret = nand_writepage(nand, block, page, buffer);
+      count = MIN(remaining, pagesperblock - page);
+      ret   = nand_writepages(nand, block, page, count, buffer);
       if (ret < 0)
         {
-          ferr("ERROR: nand_writepage failed block=%ld page=%d: %d\n",
-               (long)block, page, ret);
           goto errout_with_lock;
         }
 
-      /* Increment the page number.  If we exceed the number of
-       * pages per block, then reset the page number and bump up
-       * the block number.
-       */
-
-      if (++page >= pagesperblock)
-        {
-          page = 0;
-          block++;
-        }
-
-      /* Increment the buffer point by the size of one page */
+      /* Continue with the first page of the next block */
 
-      buffer += pagesize;
+      page = 0;
+      block++;
+      buffer += (size_t)count * pagesize;
     }
 
   nxmutex_unlock(&nand->lock);
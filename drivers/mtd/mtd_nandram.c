@@ -489,6 +489,8 @@ FAR struct mtd_dev_s *nand_ram_initialize(struct nand_raw_s *raw)
   raw->eraseblock      = nand_ram_eraseblock;
   raw->rawread         = nand_ram_rawread;
   raw->rawwrite        = nand_ram_rawwrite;
+  raw->readpages       = NULL;
+  raw->writepages      = NULL;
 
   return nand_raw_initialize(raw);
 }
@@ -311,6 +311,11 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
 
   onfi->buswidth = (*(FAR uint8_t *)(parmtab + 6)) & 0x01;
 
+  /* Features and optional commands supported (bytes 6-9) */
+
+  onfi->features = *(FAR uint16_t *)(FAR void *)(parmtab + 6);
+  onfi->optcmds  = *(FAR uint16_t *)(FAR void *)(parmtab + 8);
+
   /* Get number of data bytes per page (bytes 80-83 in the param table) */
 
   onfi->pagesize =  *(FAR uint32_t *)(FAR void *)(parmtab + 80);
@@ -345,6 +350,8 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
   finfo("  luns:          %d\n",          onfi->luns);
   finfo("  eccsize:       %d\n",          onfi->eccsize);
   finfo("  model:         0x%02x\n",      onfi->model);
+  finfo("  features:      0x%04x\n",      onfi->features);
+  finfo("  optcmds:       0x%04x\n",      onfi->optcmds);
   finfo("  sparesize:     %d\n",          onfi->sparesize);
   finfo("  pagesperblock: %d\n",          onfi->pagesperblock);
   finfo("  blocksperlun:  %d\n",          onfi->blocksperlun);
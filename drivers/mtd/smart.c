@@ -293,6 +293,11 @@ struct smart_struct_s
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR uint8_t          *erasecounts;      /* Number of erases for each erase block */
 #endif
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+  FAR uint16_t         *allocindex;       /* Tree of blocks by free count */
+  FAR uint16_t         *gcindex;          /* Tree of blocks by release count */
+  uint32_t              indexsize;        /* Number of leaves of the trees */
+#endif
 #ifdef CONFIG_MTD_SMART_ALLOC_DEBUG
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
@@ -443,6 +448,15 @@ static int     smart_relocate_static_data(FAR struct smart_struct_s *dev,
                                           uint16_t block);
 #endif
 
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+static void    smart_index_update(FAR struct smart_struct_s *dev,
+                                  uint16_t block);
+static void    smart_index_build(FAR struct smart_struct_s *dev);
+#else
+#  define smart_index_update(dev, block)
+#  define smart_index_build(dev)
+#endif
+
 static int     smart_relocate_sector(FAR struct smart_struct_s *dev,
                                      uint16_t oldsector, uint16_t newsector);
 
@@ -1188,6 +1202,14 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
     }
 #endif
 
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+  if (dev->allocindex != NULL)
+    {
+      smart_free(dev, dev->allocindex);
+      dev->allocindex = NULL;
+    }
+#endif
+
   /* Allocate a virtual to physical sector map buffer.  Also allocate
    * the storage space for releasecount and freecounts.
    */
@@ -1329,6 +1351,26 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
   dev->uneven_wearcount = 0;
 #endif
 
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+  /* Allocate the allocation and garbage collection trees */
+
+  for (dev->indexsize = 1; dev->indexsize < dev->neraseblocks; )
+    {
+      dev->indexsize <<= 1;
+    }
+
+  dev->allocindex = (FAR uint16_t *)smart_malloc(dev,
+    dev->indexsize * 4 * sizeof(uint16_t), "Alloc index");
+  if (!dev->allocindex)
+    {
+      ferr("ERROR: Error allocating allocation index\n");
+      goto errexit;
+    }
+
+  dev->gcindex = dev->allocindex + dev->indexsize * 2;
+  smart_index_build(dev);
+#endif
+
   /* Allocate a read/write buffer */
 
   dev->rwbuffer = (FAR char *)smart_malloc(dev, size, "RW Buffer");
@@ -1382,6 +1424,14 @@ errexit:
     }
 #endif
 
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+  if (dev->allocindex)
+    {
+      smart_free(dev, dev->allocindex);
+      dev->allocindex = NULL;
+    }
+#endif
+
   return -ENOMEM;
 }
 
@@ -1898,6 +1948,8 @@ static int smart_set_wear_level(FAR struct smart_struct_s *dev,
       dev->wearstatus[block >> SMART_WEAR_BIT_DIVIDE] |= bits;
     }
 
+  smart_index_update(dev, block);
+
   /* Mark wear bits as dirty */
 
   dev->wearflags |= SMART_WEARFLAGS_WRITE_NEEDED;
@@ -1932,6 +1984,229 @@ static int smart_set_wear_level(FAR struct smart_struct_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: smart_index_key
+ *
+ * Description: Returns the key of an erase block in the allocation index
+ *              (its free sector count) or in the garbage collection index
+ *              (its released sector count).  Worn blocks have key 0, so
+ *              they are never selected through the index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+static int smart_index_key(FAR struct smart_struct_s *dev,
+                           FAR const uint16_t *index, uint16_t block)
+{
+  FAR uint8_t *pcount;
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  uint8_t worn;
+#endif
+
+  if (block == 0xffff)
+    {
+      return -1;
+    }
+
+  if (index == dev->allocindex)
+    {
+      pcount = dev->freecount;
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      worn   = SMART_WEAR_FULL_RELOCATE_THRESHOLD;
+#endif
+    }
+  else
+    {
+      pcount = dev->releasecount;
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      worn   = SMART_WEAR_REORG_THRESHOLD;
+#endif
+    }
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  if (smart_get_wear_level(dev, block) >= worn)
+    {
+      return 0;
+    }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+  return smart_get_count(dev, pcount, block);
+#else
+  return pcount[block];
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_index_best
+ *
+ * Description: Returns the better of two erase blocks in an index: the one
+ *              with the greater key, or the lower block number if the keys
+ *              are equal.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+static uint16_t smart_index_best(FAR struct smart_struct_s *dev,
+                                 FAR const uint16_t *index,
+                                 uint16_t block1, uint16_t block2)
+{
+  int key1 = smart_index_key(dev, index, block1);
+  int key2 = smart_index_key(dev, index, block2);
+
+  if (key1 > key2 || (key1 == key2 && block1 < block2))
+    {
+      return block1;
+    }
+
+  return block2;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_index_update
+ *
+ * Description: Updates the position of an erase block in the allocation
+ *              and garbage collection indexes after its counts or its wear
+ *              level changed.
+ *
+ *              Each index is a tournament tree: leaf indexsize + n holds
+ *              block n, and every other node holds the best block of its
+ *              two children, so node 1 holds the best block of all.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+static void smart_index_update(FAR struct smart_struct_s *dev,
+                               uint16_t block)
+{
+  FAR uint16_t *alloc = dev->allocindex;
+  FAR uint16_t *gc = dev->gcindex;
+  uint32_t node;
+
+  for (node = (dev->indexsize + block) >> 1; node > 0; node >>= 1)
+    {
+      alloc[node] = smart_index_best(dev, alloc, alloc[node * 2],
+                                     alloc[node * 2 + 1]);
+      gc[node]    = smart_index_best(dev, gc, gc[node * 2],
+                                     gc[node * 2 + 1]);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_index_build
+ *
+ * Description: Rebuilds the allocation and garbage collection indexes from
+ *              the counts and wear levels of every erase block.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+static void smart_index_build(FAR struct smart_struct_s *dev)
+{
+  FAR uint16_t *alloc = dev->allocindex;
+  FAR uint16_t *gc = dev->gcindex;
+  uint32_t node;
+
+  for (node = 0; node < dev->indexsize; node++)
+    {
+      alloc[dev->indexsize + node] = node < dev->neraseblocks ?
+                                     node : 0xffff;
+      gc[dev->indexsize + node]    = alloc[dev->indexsize + node];
+    }
+
+  for (node = dev->indexsize - 1; node > 0; node--)
+    {
+      alloc[node] = smart_index_best(dev, alloc, alloc[node * 2],
+                                     alloc[node * 2 + 1]);
+      gc[node]    = smart_index_best(dev, gc, gc[node * 2],
+                                     gc[node * 2 + 1]);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_index_find
+ *
+ * Description: Returns the best erase block in [first, last) of an index,
+ *              or 0xffff if none of them has a key greater than zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+static uint16_t smart_index_find(FAR struct smart_struct_s *dev,
+                                 FAR const uint16_t *index,
+                                 uint32_t first, uint32_t last)
+{
+  uint16_t best = 0xffff;
+
+  for (first += dev->indexsize, last += dev->indexsize; first < last;
+       first >>= 1, last >>= 1)
+    {
+      if (first & 1)
+        {
+          best = smart_index_best(dev, index, best, index[first++]);
+        }
+
+      if (last & 1)
+        {
+          best = smart_index_best(dev, index, best, index[--last]);
+        }
+    }
+
+  return smart_index_key(dev, index, best) > 0 ? best : 0xffff;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_index_findalloc
+ *
+ * Description: Returns the unworn erase block with the most free sectors,
+ *              or 0xffff if there is none.  Like the scan in
+ *              smart_findfreephyssector(), the blocks are searched starting
+ *              at lastallocblock and the block before it is only selected
+ *              if no other block has free sectors.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+static uint16_t smart_index_findalloc(FAR struct smart_struct_s *dev)
+{
+  uint16_t start = dev->lastallocblock;
+  uint16_t prev;
+  uint16_t block1;
+  uint16_t block2 = 0xffff;
+
+  if (start == 0)
+    {
+      prev   = dev->neraseblocks - 1;
+      block1 = smart_index_find(dev, dev->allocindex, 0, prev);
+    }
+  else
+    {
+      prev   = start - 1;
+      block1 = smart_index_find(dev, dev->allocindex, start,
+                                dev->neraseblocks);
+      block2 = smart_index_find(dev, dev->allocindex, 0, prev);
+    }
+
+  if (smart_index_key(dev, dev->allocindex, block2) >
+      smart_index_key(dev, dev->allocindex, block1))
+    {
+      block1 = block2;
+    }
+
+  if (block1 == 0xffff)
+    {
+      block1 = smart_index_find(dev, dev->allocindex, prev, prev + 1);
+    }
+
+  return block1;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_scan
  *
@@ -2063,6 +2338,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
       dev->freecount[sector] = dev->availsectperblk - prerelease;
       dev->releasecount[sector] = prerelease;
 #endif
+      smart_index_update(dev, sector);
     }
 
   /* Initialize the sector map */
@@ -2131,6 +2407,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 #else
       dev->freecount[sector / dev->sectorsperblk]--;
 #endif
+      smart_index_update(dev, sector / dev->sectorsperblk);
       dev->freesectors--;
 
       /* Test if this sector has been release and if it has,
@@ -2151,6 +2428,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 #else
           dev->releasecount[sector / dev->sectorsperblk]++;
 #endif
+          smart_index_update(dev, sector / dev->sectorsperblk);
           continue;
         }
 
@@ -2566,6 +2844,8 @@ static int smart_scan(FAR struct smart_struct_s *dev)
                           sector / dev->sectorsperblk, 1);
 #endif
 #endif
+          smart_index_update(dev, newsector / dev->sectorsperblk);
+          smart_index_update(dev, sector / dev->sectorsperblk);
         }
     }
 
@@ -2581,6 +2861,10 @@ static int smart_scan(FAR struct smart_struct_s *dev)
   smart_read_wearstatus(dev);
 #endif
 
+  /* Rebuild the allocation index from the counts and wear levels */
+
+  smart_index_build(dev);
+
   finfo("SMART Scan\n");
   finfo("   Erase size:   %10d\n", dev->sectorsperblk * dev->sectorsize);
   finfo("   Erase count:  %10d\n", dev->neraseblocks);
@@ -2761,6 +3045,7 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev,
       dev->releasecount[block] = prerelease;
       dev->freecount[block] = dev->availsectperblk - prerelease;
 #endif
+      smart_index_update(dev, block);
 
       /* Now that we have erased this block and updated the release / free
        * counts, if we are in WEAR LEVELING enabled mode, we must check if
@@ -3004,6 +3289,7 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev,
 #else
           dev->freecount[block]--;
 #endif /* CONFIG_MTD_SMART_PACK_COUNTS */
+          smart_index_update(dev, block);
         }
 
 #ifdef CONFIG_SMART_LOCAL_CHECKFREE
@@ -3291,6 +3577,7 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev,
       dev->releasecount[x] = prerelease;
       dev->freecount[x] = dev->availsectperblk - prerelease;
 #endif
+      smart_index_update(dev, x);
     }
 
   /* Account for the format sector */
@@ -3300,6 +3587,7 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev,
 #else
   dev->freecount[0]--;
 #endif
+  smart_index_update(dev, 0);
 
   /* Now initialize the logical to physical sector map */
 
@@ -3537,6 +3825,7 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev,
 #endif
   dev->freecount[block] = 0;
 #endif
+  smart_index_update(dev, block);
 
   /* Next move all live data in the block to a new home. */
 
@@ -3643,6 +3932,7 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev,
 #else
       dev->freecount[newsector / dev->sectorsperblk]--;
 #endif
+      smart_index_update(dev, newsector / dev->sectorsperblk);
     }
 
   /* Now erase the erase block */
@@ -3696,6 +3986,7 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev,
   dev->freecount[block]    = dev->availsectperblk - prerelease;
   dev->releasecount[block] = prerelease;
 #endif
+  smart_index_update(dev, block);
 
 #ifdef CONFIG_SMART_LOCAL_CHECKFREE
   if (smart_checkfree(dev, __LINE__) != OK)
@@ -3725,6 +4016,7 @@ errout:
 #else
   dev->freecount[block] = freecount;
 #endif
+  smart_index_update(dev, block);
   return ret;
 }
 
@@ -3778,6 +4070,18 @@ retry:
       dev->lastallocblock = 0;
     }
 
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+  /* Look up the unworn block with the most free sectors in the index.
+   * Only if there is none, scan the blocks to find a worn one.
+   */
+
+  allocblock = smart_index_findalloc(dev);
+  if (allocblock != 0xffff)
+    {
+      goto found;
+    }
+#endif
+
   block = dev->lastallocblock;
   for (i = 0; i < dev->neraseblocks; i++)
     {
@@ -3921,6 +4225,10 @@ retry:
         }
     }
 
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+found:
+#endif
+
   /* Now find a free physical sector within this selected erase block to
    * allocate.
    */
@@ -4024,13 +4332,15 @@ retry:
 static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 {
   uint16_t collectblock;
+#ifndef CONFIG_MTD_SMART_ALLOC_INDEX
   uint16_t releasemax;
-  bool collect = true;
   int x;
-  int ret;
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
   uint8_t count;
 #endif
+#endif
+  bool collect = true;
+  int ret;
 
   while (collect)
     {
@@ -4059,6 +4369,10 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
         {
           /* Find the block with the most released sectors */
 
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+          collectblock = smart_index_find(dev, dev->gcindex, 0,
+                                          dev->neraseblocks);
+#else
           collectblock = 0xffff;
           releasemax = 0;
           for (x = 0; x < dev->neraseblocks; x++)
@@ -4087,6 +4401,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
                 }
 #endif
             }
+#endif
 
 #if 0
           releasemax = smart_get_count(dev, dev->releasecount, collectblock);
@@ -4893,6 +5208,8 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
       dev->releasecount[block]++;
       dev->freecount[physsector / dev->sectorsperblk]--;
 #endif
+      smart_index_update(dev, block);
+      smart_index_update(dev, physsector / dev->sectorsperblk);
       dev->freesectors--;
       dev->releasesectors++;
 
@@ -5354,6 +5671,7 @@ static inline int smart_allocsector(FAR struct smart_struct_s *dev,
 #else
   dev->freecount[physicalsector / dev->sectorsperblk]--;
 #endif
+  smart_index_update(dev, physicalsector / dev->sectorsperblk);
   dev->freesectors--;
 
   /* Return the logical sector number */
@@ -5456,6 +5774,7 @@ static inline int smart_freesector(FAR struct smart_struct_s *dev,
 #else
   dev->releasecount[block]++;
 #endif
+  smart_index_update(dev, block);
 
   /* Unmap this logical sector */
 
@@ -6044,6 +6363,7 @@ static int smart_fsck_directory(FAR struct smart_struct_s *dev,
 #else
       dev->freecount[newsector / dev->sectorsperblk]--;
 #endif
+      smart_index_update(dev, newsector / dev->sectorsperblk);
     }
 
   kmm_free(rwbuffer);
@@ -6323,6 +6643,9 @@ errout:
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   smart_free(dev, dev->erasecounts);
 #endif
+#ifdef CONFIG_MTD_SMART_ALLOC_INDEX
+  smart_free(dev, dev->allocindex);
+#endif
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
   if (rootdirdev)
     {
@@ -36,6 +36,7 @@
 #include <debug.h>
 #include <inttypes.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
 #include <nuttx/fs/ioctl.h>
@@ -345,6 +346,9 @@ struct w25qxxxjv_dev_s
   uint8_t                currentdie;  /* Number of current active die */
   FAR uint8_t           *cmdbuf;      /* Allocated command buffer */
   FAR uint8_t           *readbuf;     /* Allocated status read buffer */
+#ifdef CONFIG_QSPI_MEMMAP
+  FAR uint8_t           *xipbase;     /* Memory-mapped window, NULL if none */
+#endif
 
 #ifdef CONFIG_W25QXXXJV_SECTOR512
   uint8_t                flags;       /* Buffered sector flags */
@@ -359,8 +363,15 @@ struct w25qxxxjv_dev_s
 
 /* Locking */
 
-static void w25qxxxjv_lock(FAR struct qspi_dev_s *qspi);
-static inline void w25qxxxjv_unlock(FAR struct qspi_dev_s *qspi);
+static void w25qxxxjv_lock(FAR struct w25qxxxjv_dev_s *priv);
+static void w25qxxxjv_unlock(FAR struct w25qxxxjv_dev_s *priv);
+#ifdef CONFIG_QSPI_MEMMAP
+static void w25qxxxjv_memmap(FAR struct w25qxxxjv_dev_s *priv);
+static void w25qxxxjv_invalidate(FAR struct w25qxxxjv_dev_s *priv,
+                                 off_t offset, size_t nbytes);
+#else
+#  define w25qxxxjv_invalidate(p,o,n)
+#endif
 
 /* Low-level message helpers */
 
@@ -449,8 +460,10 @@ static int  w25qxxxjv_ioctl(FAR struct mtd_dev_s *dev,
  * Name: w25qxxxjv_lock
  ****************************************************************************/
 
-static void w25qxxxjv_lock(FAR struct qspi_dev_s *qspi)
+static void w25qxxxjv_lock(FAR struct w25qxxxjv_dev_s *priv)
 {
+  FAR struct qspi_dev_s *qspi = priv->qspi;
+
   /* On QuadSPI buses where there are multiple devices, it will be necessary
    * to lock QuadSPI to have exclusive access to the buses for a sequence of
    * transfers.  The bus should be locked before the chip is selected.
@@ -462,6 +475,15 @@ static void w25qxxxjv_lock(FAR struct qspi_dev_s *qspi)
 
   (void)QSPI_LOCK(qspi, true);
 
+#ifdef CONFIG_QSPI_MEMMAP
+  /* Commands cannot be sent while the FLASH is memory-mapped */
+
+  if (priv->xipbase != NULL)
+    {
+      QSPI_MEMMAP(qspi, NULL, NULL);
+    }
+#endif
+
   /* After locking the QuadSPI bus, the we also need call the setfrequency,
    * setbits, and setmode methods to make sure that the QuadSPI is properly
    * configured for the device. If the QuadSPI bus is being shared, then it
@@ -477,10 +499,67 @@ static void w25qxxxjv_lock(FAR struct qspi_dev_s *qspi)
  * Name: w25qxxxjv_unlock
  ****************************************************************************/
 
-static inline void w25qxxxjv_unlock(FAR struct qspi_dev_s *qspi)
+static void w25qxxxjv_unlock(FAR struct w25qxxxjv_dev_s *priv)
+{
+#ifdef CONFIG_QSPI_MEMMAP
+  if (priv->xipbase != NULL)
+    {
+      w25qxxxjv_memmap(priv);
+    }
+#endif
+
+  (void)QSPI_LOCK(priv->qspi, false);
+}
+
+#ifdef CONFIG_QSPI_MEMMAP
+/****************************************************************************
+ * Name: w25qxxxjv_memmap
+ *
+ * Description:
+ *   Map the FLASH into the window of the QuadSPI controller, reading it
+ *   with the same command as w25qxxxjv_read_byte().  The caller holds the
+ *   bus lock.  xipbase is left NULL if the controller cannot map it.
+ *
+ ****************************************************************************/
+
+static void w25qxxxjv_memmap(FAR struct w25qxxxjv_dev_s *priv)
+{
+  struct qspi_meminfo_s meminfo;
+  FAR void *base = NULL;
+
+  memset(&meminfo, 0, sizeof(meminfo));
+  meminfo.flags   = QSPIMEM_READ | QSPIMEM_QUADIO;
+  meminfo.addrlen = priv->addresslen;
+  meminfo.dummies = CONFIG_W25QXXXJV_DUMMIES;
+  meminfo.cmd     = (priv->addresslen == 4) ? W25QXXXJV_FAST_READ_QUADIO_4BT
+                    : W25QXXXJV_FAST_READ_QUADIO;
+
+  if (QSPI_MEMMAP(priv->qspi, &meminfo, &base) < 0)
+    {
+      base = NULL;
+    }
+
+  priv->xipbase = base;
+}
+
+/****************************************************************************
+ * Name: w25qxxxjv_invalidate
+ *
+ * Description:
+ *   Discard the cached copy of a modified range of the memory-mapped FLASH.
+ *
+ ****************************************************************************/
+
+static void w25qxxxjv_invalidate(FAR struct w25qxxxjv_dev_s *priv,
+                                 off_t offset, size_t nbytes)
 {
-  (void)QSPI_LOCK(qspi, false);
+  if (priv->xipbase != NULL)
+    {
+      up_invalidate_dcache((uintptr_t)priv->xipbase + offset,
+                           (uintptr_t)priv->xipbase + offset + nbytes);
+    }
 }
+#endif
 
 /****************************************************************************
  * Name: w25qxxxjv_command
@@ -687,7 +766,7 @@ static inline int w25qxxxjv_readid(FAR struct w25qxxxjv_dev_s *priv)
 {
   /* Lock the QuadSPI bus and configure the bus. */
 
-  w25qxxxjv_lock(priv->qspi);
+  w25qxxxjv_lock(priv);
 
   /* Read the JEDEC ID */
 
@@ -695,7 +774,7 @@ static inline int w25qxxxjv_readid(FAR struct w25qxxxjv_dev_s *priv)
 
   /* Unlock the bus */
 
-  w25qxxxjv_unlock(priv->qspi);
+  w25qxxxjv_unlock(priv);
 
   finfo("Manufacturer: %02x Device Type %02x, Capacity: %02x\n",
         priv->cmdbuf[0], priv->cmdbuf[1], priv->cmdbuf[2]);
@@ -1353,13 +1432,22 @@ static int w25qxxxjv_erase(FAR struct mtd_dev_s *dev, off_t startblock,
 #ifdef CONFIG_W25QXXXJV_SECTOR512
   int ret;
 #endif
+#ifdef CONFIG_QSPI_MEMMAP
+#  ifdef CONFIG_W25QXXXJV_SECTOR512
+  uint8_t shift = W25QXXXJV_SECTOR512_SHIFT;
+#  else
+  uint8_t shift = priv->sectorshift;
+#  endif
+  off_t offset = startblock << shift;
+  size_t nbytes = nblocks << shift;
+#endif
 
   finfo("startblock: %08" PRIxOFF " nblocks: %d\n",
         startblock, (int)nblocks);
 
   /* Lock access to the SPI bus until we complete the erase */
 
-  w25qxxxjv_lock(priv->qspi);
+  w25qxxxjv_lock(priv);
 
   while (blocksleft-- > 0)
     {
@@ -1383,7 +1471,8 @@ static int w25qxxxjv_erase(FAR struct mtd_dev_s *dev, off_t startblock,
     }
 #endif
 
-  w25qxxxjv_unlock(priv->qspi);
+  w25qxxxjv_invalidate(priv, offset, nbytes);
+  w25qxxxjv_unlock(priv);
 
   return (int)nblocks;
 }
@@ -1453,7 +1542,7 @@ static ssize_t w25qxxxjv_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
 
   /* Lock the QuadSPI bus and write all of the pages to FLASH */
 
-  w25qxxxjv_lock(priv->qspi);
+  w25qxxxjv_lock(priv);
 
 #if defined(CONFIG_W25QXXXJV_SECTOR512)
   ret = w25qxxxjv_write_cache(priv, buffer, startblock, nblocks);
@@ -1471,7 +1560,15 @@ static ssize_t w25qxxxjv_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
     }
 #endif
 
-  w25qxxxjv_unlock(priv->qspi);
+#ifdef CONFIG_W25QXXXJV_SECTOR512
+  w25qxxxjv_invalidate(priv, startblock << W25QXXXJV_SECTOR512_SHIFT,
+                       nblocks << W25QXXXJV_SECTOR512_SHIFT);
+#else
+  w25qxxxjv_invalidate(priv, startblock << priv->pageshift,
+                       nblocks << priv->pageshift);
+#endif
+
+  w25qxxxjv_unlock(priv);
 
   return ret < 0 ? ret : nblocks;
 }
@@ -1488,12 +1585,26 @@ static ssize_t w25qxxxjv_read(FAR struct mtd_dev_s *dev, off_t offset,
 
   finfo("offset: %08" PRIxOFF " nbytes: %d\n", offset, (int)nbytes);
 
+#ifdef CONFIG_QSPI_MEMMAP
+  /* Copy from the memory-mapped window, only the bus lock is needed to
+   * keep the FLASH mapped.
+   */
+
+  if (priv->xipbase != NULL)
+    {
+      (void)QSPI_LOCK(priv->qspi, true);
+      memcpy(buffer, priv->xipbase + offset, nbytes);
+      (void)QSPI_LOCK(priv->qspi, false);
+      return (ssize_t)nbytes;
+    }
+#endif
+
   /* Lock the QuadSPI bus and select this FLASH part */
 
-  w25qxxxjv_lock(priv->qspi);
+  w25qxxxjv_lock(priv);
 
   ret = w25qxxxjv_read_byte(priv, buffer, offset, nbytes);
-  w25qxxxjv_unlock(priv->qspi);
+  w25qxxxjv_unlock(priv);
 
   if (ret < 0)
     {
@@ -1584,9 +1695,16 @@ static int w25qxxxjv_ioctl(FAR struct mtd_dev_s *dev, int cmd,
         {
           /* Erase the entire device */
 
-          w25qxxxjv_lock(priv->qspi);
+          w25qxxxjv_lock(priv);
           ret = w25qxxxjv_erase_chip(priv);
-          w25qxxxjv_unlock(priv->qspi);
+#ifdef CONFIG_QSPI_MEMMAP
+          if (priv->xipbase != NULL)
+            {
+              up_invalidate_dcache_all();
+            }
+#endif
+
+          w25qxxxjv_unlock(priv);
         }
         break;
 
@@ -1596,7 +1714,9 @@ static int w25qxxxjv_ioctl(FAR struct mtd_dev_s *dev, int cmd,
             (FAR const struct mtd_protect_s *)((uintptr_t)arg);
 
           DEBUGASSERT(prot);
+          w25qxxxjv_lock(priv);
           ret = w25qxxxjv_protect(priv, prot->startblock, prot->nblocks);
+          w25qxxxjv_unlock(priv);
         }
         break;
 
@@ -1606,10 +1726,30 @@ static int w25qxxxjv_ioctl(FAR struct mtd_dev_s *dev, int cmd,
             (FAR const struct mtd_protect_s *)((uintptr_t)arg);
 
           DEBUGASSERT(prot);
+          w25qxxxjv_lock(priv);
           ret = w25qxxxjv_unprotect(priv, prot->startblock, prot->nblocks);
+          w25qxxxjv_unlock(priv);
         }
         break;
 
+#ifdef CONFIG_QSPI_MEMMAP
+      case BIOC_XIPBASE:
+        {
+          FAR void **ppv = (FAR void **)arg;
+
+          if (priv->xipbase == NULL)
+            {
+              ret = -ENOTTY;
+            }
+          else if (ppv != NULL)
+            {
+              *ppv = priv->xipbase;
+              ret  = OK;
+            }
+        }
+        break;
+#endif
+
       case MTDIOC_ERASESTATE:
         {
           FAR uint8_t *result = (FAR uint8_t *)arg;
@@ -1713,14 +1853,14 @@ FAR struct mtd_dev_s *w25qxxxjv_initialize(FAR struct qspi_dev_s *qspi,
 
       if (priv->addresslen == 4)
         {
-          w25qxxxjv_lock(priv->qspi);
+          w25qxxxjv_lock(priv);
           ret = w25qxxxjv_command(priv->qspi, W25QXXXJV_ENTER_4BT_MODE);
           if (ret != OK)
             {
               ferr("ERROR: Failed to enter 4 byte mode\n");
             }
 
-          w25qxxxjv_unlock(priv->qspi);
+          w25qxxxjv_unlock(priv);
         }
 
       /* Unprotect FLASH sectors if so requested. */
@@ -1738,6 +1878,20 @@ FAR struct mtd_dev_s *w25qxxxjv_initialize(FAR struct qspi_dev_s *qspi,
 
       w25qxxxjv_quad_enable(priv);
 
+#ifdef CONFIG_QSPI_MEMMAP
+      /* Read the FLASH through the memory-mapped window if the controller
+       * supports it.  Multi-die parts need a die select command, so they
+       * keep using indirect reads.
+       */
+
+      if (priv->numofdies == 0)
+        {
+          (void)QSPI_LOCK(qspi, true);
+          w25qxxxjv_memmap(priv);
+          (void)QSPI_LOCK(qspi, false);
+        }
+#endif
+
 #ifdef CONFIG_W25QXXXJV_SECTOR512  /* Simulate a 512 byte sector */
       /* Allocate a buffer for the erase block cache */
 
@@ -63,10 +63,18 @@
 #define IGC_TX_QUOTA           IGC_TX_DESC
 #define IGC_RX_QUOTA           (IGC_RX_DESC + CONFIG_NET_IGC_RXSPARE)
 
+/* RX/TX queue pairs, each one has its own MSI-X vector */
+
+#ifdef CONFIG_NET_IGC_NQUEUES
+#  define IGC_NQUEUES          CONFIG_NET_IGC_NQUEUES
+#else
+#  define IGC_NQUEUES          1
+#endif
+
 /* NOTE: CONFIG_IOB_ALIGNMENT must match system D-CACHE line size */
 
-#if CONFIG_IOB_NBUFFERS < IGC_RX_QUOTA + IGC_TX_QUOTA
-#  error CONFIG_IOB_NBUFFERS must be > (IGC_RX_QUOTA + IGC_TX_QUOTA)
+#if CONFIG_IOB_NBUFFERS < (IGC_RX_QUOTA + IGC_TX_QUOTA) * IGC_NQUEUES
+#  error CONFIG_IOB_NBUFFERS must be > (IGC_RX_QUOTA + IGC_TX_QUOTA) * queues
 #endif
 
 #if CONFIG_IOB_BUFSIZE < IGC_PKTBUF_SIZE
@@ -95,6 +103,21 @@
 #define IGC_MSIX_IVAR0         (IGC_IVAR0_RXQ0_VAL | IGC_IVAR0_TXQ0_VAL)
 #define IGC_MSIX_IVARMSC       (IGC_IVARMSC_OTHER_VAL)
 
+/* With several queues, the vector n serves the queue pair n and vector 0
+ * also serves the other causes (link status).
+ */
+
+#define IGC_GPIE_MSIX_MULTI    (IGC_GPIE_NSICR | IGC_GPIE_MSIX | \
+                                IGC_GPIE_EIAME | IGC_GPIE_PBASUPPORT)
+#define IGC_MSIX_IMS_OTHER     (IGC_IC_LSC | IGC_IC_RXMISS)
+
+/* Hash TCP and UDP flows on their ports, other IP packets on addresses */
+
+#define IGC_MRQC_RSS           (IGC_MRQC_MRQE_RSS | IGC_MRQC_RSS_IPV4 | \
+                                IGC_MRQC_RSS_TCPIPV4 | IGC_MRQC_RSS_UDPIPV4 | \
+                                IGC_MRQC_RSS_IPV6 | IGC_MRQC_RSS_TCPIPV6 | \
+                                IGC_MRQC_RSS_UDPIPV6)
+
 /*****************************************************************************
  * Private Types
  *****************************************************************************/
@@ -107,17 +130,13 @@ struct igc_type_s
   uint32_t mta_regs;            /* MTA registers */
 };
 
-/* IGC private data */
+/* IGC RX/TX queue pair */
 
-struct igc_driver_s
+struct igc_driver_s;
+struct igc_queue_s
 {
-  /* This holds the information visible to the NuttX network */
-
-  struct netdev_lowerhalf_s dev;
-
-  /* Driver state */
-
-  bool bifup;
+  FAR struct igc_driver_s *priv;
+  int                      qid;
 
   /* Packets list */
 
@@ -132,12 +151,30 @@ struct igc_driver_s
   size_t tx_now;
   size_t tx_done;
   size_t rx_now;
+};
+
+/* IGC private data */
+
+struct igc_driver_s
+{
+  /* This holds the information visible to the NuttX network */
+
+  struct netdev_lowerhalf_s dev;
+
+  /* Driver state */
+
+  bool bifup;
+
+  /* Queue pairs, as many as MSI-X vectors could be allocated */
+
+  struct igc_queue_s queue[IGC_NQUEUES];
+  int                nqueues;
 
   /* PCI data */
 
   FAR struct pci_device_s     *pcidev;
   FAR const struct igc_type_s *type;
-  int                          irq;
+  int                          irq[IGC_NQUEUES];
   uint64_t                     base;
 
 #ifdef CONFIG_NET_MCASTGROUP
@@ -166,16 +203,33 @@ static void igc_dump_mem(FAR struct igc_driver_s *priv, FAR const char *msg);
 
 /* Common TX logic */
 
+static int igc_transmit_ring(FAR struct igc_queue_s *queue,
+                             FAR netpkt_t *pkt);
 static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
                         FAR netpkt_t *pkt);
 
 /* Interrupt handling */
 
+static FAR netpkt_t *igc_receive_ring(FAR struct igc_queue_s *queue,
+                                      FAR uint8_t *offload);
 static FAR netpkt_t *igc_receive(FAR struct netdev_lowerhalf_s *dev);
+static void igc_txdone_ring(FAR struct igc_queue_s *queue);
 static void igc_txdone(FAR struct netdev_lowerhalf_s *dev);
 
+#if IGC_NQUEUES > 1
+static int igc_transmit_queue(FAR struct netdev_lowerhalf_s *dev, int qid,
+                              FAR netpkt_t *pkt);
+static FAR netpkt_t *igc_receive_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int qid, FAR uint8_t *offload);
+static void igc_reclaim_queue(FAR struct netdev_lowerhalf_s *dev, int qid);
+#endif
+
+static void igc_link_status(FAR struct igc_driver_s *priv);
 static void igc_msix_interrupt(FAR struct igc_driver_s *priv);
 static int igc_interrupt(int irq, FAR void *context, FAR void *arg);
+#if IGC_NQUEUES > 1
+static int igc_queue_interrupt(int irq, FAR void *context, FAR void *arg);
+#endif
 
 /* NuttX callback functions */
 
@@ -194,6 +248,9 @@ static int igc_rmmac(FAR struct netdev_lowerhalf_s *dev,
 /* Initialization */
 
 static void igc_disable(FAR struct igc_driver_s *priv);
+#if IGC_NQUEUES > 1
+static void igc_rss_init(FAR struct igc_driver_s *priv);
+#endif
 static void igc_enable(FAR struct igc_driver_s *priv);
 static int igc_initialize(FAR struct igc_driver_s *priv);
 static int igc_probe(FAR struct pci_device_s *dev);
@@ -223,6 +280,18 @@ static const struct pci_device_id_s g_igc_id_table[] =
   { }
 };
 
+#if IGC_NQUEUES > 1
+/* RSS hash key, the usual default of multi-queue NICs */
+
+static const uint8_t g_igc_rss_key[IGC_RSSRK_REGS * 4] =
+{
+  0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2, 0x41, 0x67,
+  0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0, 0xd0, 0xca, 0x2b, 0xcb,
+  0xae, 0x7b, 0x30, 0xb4, 0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30,
+  0xf2, 0x0c, 0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa,
+};
+#endif
+
 static struct pci_driver_s g_pci_igc_drv =
 {
   .id_table = g_igc_id_table,
@@ -239,6 +308,11 @@ static const struct netdev_ops_s g_igc_ops =
   .addmac   = igc_addmac,
   .rmmac    = igc_rmmac,
 #endif
+#if IGC_NQUEUES > 1
+  .transmit_queue = igc_transmit_queue,
+  .receive_queue  = igc_receive_queue,
+  .reclaim_queue  = igc_reclaim_queue,
+#endif
 };
 
 /*****************************************************************************
@@ -410,30 +484,31 @@ static void igc_dump_mem(FAR struct igc_driver_s *priv, FAR const char *msg)
 #endif
 
 /*****************************************************************************
- * Name: igc_transmit
+ * Name: igc_transmit_ring
  *
  * Description:
- *   Start hardware transmission.  Called either from the txdone interrupt
- *   handling or from watchdog based polling.
+ *   Start hardware transmission on a TX queue.
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   queue - Reference to the queue pair
+ *   pkt   - The packet to send
  *
  * Returned Value:
- *   None
+ *   OK on success; a negated errno value on failure.
  *
  * Assumptions:
- *   The network is locked.
+ *   The queue is locked.
  *
  *****************************************************************************/
 
-static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
-                          FAR netpkt_t *pkt)
+static int igc_transmit_ring(FAR struct igc_queue_s *queue,
+                             FAR netpkt_t *pkt)
 {
-  FAR struct igc_driver_s *priv = (FAR struct igc_driver_s *)dev;
-  uint64_t                 pa   = 0;
-  int                      desc = priv->tx_now;
-  size_t                   len  = netpkt_getdatalen(dev, pkt);
+  FAR struct igc_driver_s       *priv = queue->priv;
+  FAR struct netdev_lowerhalf_s *dev  = &priv->dev;
+  uint64_t                       pa   = 0;
+  int                            desc = queue->tx_now;
+  size_t                         len  = netpkt_getdatalen(dev, pkt);
 
   ninfo("transmit\n");
 
@@ -447,28 +522,43 @@ static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
 
   /* Store TX packet reference */
 
-  priv->tx_pkt[priv->tx_now] = pkt;
+  queue->tx_pkt[queue->tx_now] = pkt;
 
   /* Prepare next TX descriptor */
 
-  priv->tx_now = (priv->tx_now + 1) % IGC_TX_DESC;
+  queue->tx_now = (queue->tx_now + 1) % IGC_TX_DESC;
 
   /* Setup TX descriptor */
 
   pa = up_addrenv_va_to_pa(netpkt_getdata(dev, pkt));
 
-  priv->tx[desc].addr   = pa;
-  priv->tx[desc].len    = len;
-  priv->tx[desc].cmd    = (IGC_TDESC_CMD_EOP | IGC_TDESC_CMD_IFCS |
-                           IGC_TDESC_CMD_RS);
-  priv->tx[desc].cso    = 0;
-  priv->tx[desc].status = 0;
+  queue->tx[desc].addr   = pa;
+  queue->tx[desc].len    = len;
+  queue->tx[desc].cmd    = (IGC_TDESC_CMD_EOP | IGC_TDESC_CMD_IFCS |
+                            IGC_TDESC_CMD_RS);
+  queue->tx[desc].cso    = 0;
+  queue->tx[desc].css    = 0;
+  queue->tx[desc].status = 0;
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Let the MAC complete the checksum that the stack left, the legacy
+   * descriptor gives its offsets from the Ethernet header.
+   */
+
+  if ((dev->netdev.d_offload & NETDEV_OFFLOAD_TXCSUM) != 0)
+    {
+      queue->tx[desc].css  = ETH_HDRLEN + dev->netdev.d_csum_start;
+      queue->tx[desc].cso  = queue->tx[desc].css +
+                             dev->netdev.d_csum_offset;
+      queue->tx[desc].cmd |= IGC_TDESC_CMD_IC;
+    }
+#endif
 
   SP_DSB();
 
   /* Update TX tail */
 
-  igc_putreg_mem(priv, IGC_TDT0, priv->tx_now);
+  igc_putreg_mem(priv, IGC_TDT(queue->qid), queue->tx_now);
 
   ninfodumpbuffer("Transmitted:", netpkt_getdata(dev, pkt), len);
 
@@ -476,10 +566,11 @@ static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
 }
 
 /*****************************************************************************
- * Name: igc_receive
+ * Name: igc_transmit
  *
  * Description:
- *   An interrupt was received indicating the availability of a new RX packet
+ *   Start hardware transmission.  Called either from the txdone interrupt
+ *   handling or from watchdog based polling.
  *
  * Input Parameters:
  *   priv - Reference to the driver state structure
@@ -492,19 +583,48 @@ static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
  *
  *****************************************************************************/
 
-static FAR netpkt_t * igc_receive(FAR struct netdev_lowerhalf_s *dev)
+static int igc_transmit(FAR struct netdev_lowerhalf_s *dev,
+                        FAR netpkt_t *pkt)
 {
   FAR struct igc_driver_s *priv = (FAR struct igc_driver_s *)dev;
-  FAR netpkt_t            *pkt  = NULL;
-  FAR struct igc_rx_leg_s *rx   = NULL;
-  int                      desc = 0;
 
-  desc = priv->rx_now;
+  return igc_transmit_ring(&priv->queue[0], pkt);
+}
+
+/*****************************************************************************
+ * Name: igc_receive_ring
+ *
+ * Description:
+ *   Take the next received packet from an RX queue.
+ *
+ * Input Parameters:
+ *   queue   - Reference to the queue pair
+ *   offload - Returns the RX offload flags of the packet
+ *
+ * Returned Value:
+ *   The received packet, NULL if there is none.
+ *
+ * Assumptions:
+ *   The queue is locked.
+ *
+ *****************************************************************************/
+
+static FAR netpkt_t *igc_receive_ring(FAR struct igc_queue_s *queue,
+                                      FAR uint8_t *offload)
+{
+  FAR struct igc_driver_s       *priv = queue->priv;
+  FAR struct netdev_lowerhalf_s *dev  = &priv->dev;
+  FAR netpkt_t                  *pkt  = NULL;
+  FAR struct igc_rx_leg_s       *rx   = NULL;
+  int                            desc = 0;
+  uint8_t                        status;
+
+  desc = queue->rx_now;
 
   /* Get RX descriptor and RX packet */
 
-  rx = &priv->rx[desc];
-  pkt = priv->rx_pkt[desc];
+  rx = &queue->rx[desc];
+  pkt = queue->rx_pkt[desc];
 
   /* Check if descriptor done */
 
@@ -515,12 +635,12 @@ static FAR netpkt_t * igc_receive(FAR struct netdev_lowerhalf_s *dev)
 
   /* Next descriptor */
 
-  priv->rx_now = (priv->rx_now + 1) % IGC_RX_DESC;
+  queue->rx_now = (queue->rx_now + 1) % IGC_RX_DESC;
 
   /* Allocate new rx packet */
 
-  priv->rx_pkt[desc] = netpkt_alloc(dev, NETPKT_RX);
-  if (priv->rx_pkt[desc] == NULL)
+  queue->rx_pkt[desc] = netpkt_alloc(dev, NETPKT_RX);
+  if (queue->rx_pkt[desc] == NULL)
     {
       nerr("alloc pkt_new failed\n");
       PANIC();
@@ -529,36 +649,49 @@ static FAR netpkt_t * igc_receive(FAR struct netdev_lowerhalf_s *dev)
   /* Set packet length */
 
   netpkt_setdatalen(dev, pkt, rx->len);
+  status = rx->status;
 
   /* Store new packet in RX descriptor ring */
 
   rx->addr   = up_addrenv_va_to_pa(
-               netpkt_getdata(dev, priv->rx_pkt[desc]));
+               netpkt_getdata(dev, queue->rx_pkt[desc]));
   rx->len    = 0;
   rx->status = 0;
 
   /* Update RX tail */
 
-  igc_putreg_mem(priv, IGC_RDT0, desc);
+  igc_putreg_mem(priv, IGC_RDT(queue->qid), desc);
 
   /* Handle errros */
 
   if (rx->errors)
     {
       nerr("RX error reported (%"PRIu8")\n", rx->errors);
-      NETDEV_RXERRORS(&priv->dev);
+      NETDEV_RXERRORS(&dev->netdev);
       netpkt_free(dev, pkt, NETPKT_RX);
       return NULL;
     }
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* The TCP/UDP checksum was verified, errors are handled above */
+
+  if ((status & IGC_RDESC_STATUS_L4CS) != 0)
+    {
+      *offload |= NETDEV_OFFLOAD_RXCSUM;
+    }
+#else
+  UNUSED(status);
+  UNUSED(offload);
+#endif
+
   return pkt;
 }
 
 /*****************************************************************************
- * Name: igc_txdone
+ * Name: igc_receive
  *
  * Description:
- *   An interrupt was received indicating that the last TX packet(s) is done
+ *   An interrupt was received indicating the availability of a new RX packet
  *
  * Input Parameters:
  *   priv - Reference to the driver state structure
@@ -571,35 +704,144 @@ static FAR netpkt_t * igc_receive(FAR struct netdev_lowerhalf_s *dev)
  *
  *****************************************************************************/
 
-static void igc_txdone(FAR struct netdev_lowerhalf_s *dev)
+static FAR netpkt_t *igc_receive(FAR struct netdev_lowerhalf_s *dev)
 {
-  FAR struct igc_driver_s *priv = (FAR struct igc_driver_s *)dev;
+  FAR struct igc_driver_s *priv    = (FAR struct igc_driver_s *)dev;
+  uint8_t                  offload = 0;
+  FAR netpkt_t            *pkt;
+
+  pkt = igc_receive_ring(&priv->queue[0], &offload);
+#ifdef CONFIG_NETDEV_OFFLOAD
+  dev->netdev.d_offload |= offload;
+#endif
 
-  while (priv->tx_now != priv->tx_done)
+  return pkt;
+}
+
+/*****************************************************************************
+ * Name: igc_txdone_ring
+ *
+ * Description:
+ *   Free the packets sent by a TX queue.
+ *
+ * Input Parameters:
+ *   queue - Reference to the queue pair
+ *
+ *****************************************************************************/
+
+static void igc_txdone_ring(FAR struct igc_queue_s *queue)
+{
+  FAR struct netdev_lowerhalf_s *dev = &queue->priv->dev;
+
+  while (queue->tx_now != queue->tx_done)
     {
-      if (priv->tx[priv->tx_done].status == 0)
+      if (queue->tx[queue->tx_done].status == 0)
         {
           break;
         }
 
-      if (!(priv->tx[priv->tx_done].status & IGC_TDESC_STATUS_DD))
+      if (!(queue->tx[queue->tx_done].status & IGC_TDESC_STATUS_DD))
         {
-          nerr("tx failed: 0x%" PRIx32 "\n", priv->tx[priv->tx_done].status);
-          NETDEV_TXERRORS(priv->dev);
+          nerr("tx failed: 0x%" PRIx32 "\n",
+               queue->tx[queue->tx_done].status);
+          NETDEV_TXERRORS(&dev->netdev);
         }
 
       /* Free net packet */
 
-      netpkt_free(dev, priv->tx_pkt[priv->tx_done], NETPKT_TX);
+      netpkt_free(dev, queue->tx_pkt[queue->tx_done], NETPKT_TX);
 
       /* Next descriptor */
 
-      priv->tx_done = (priv->tx_done + 1) % IGC_TX_DESC;
+      queue->tx_done = (queue->tx_done + 1) % IGC_TX_DESC;
     }
+}
+
+/*****************************************************************************
+ * Name: igc_txdone
+ *
+ * Description:
+ *   An interrupt was received indicating that the last TX packet(s) is done
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ *****************************************************************************/
+
+static void igc_txdone(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct igc_driver_s *priv = (FAR struct igc_driver_s *)dev;
 
+  igc_txdone_ring(&priv->queue[0]);
   netdev_lower_txdone(dev);
 }
 
+#if IGC_NQUEUES > 1
+/*****************************************************************************
+ * Name: igc_transmit_queue/receive_queue/reclaim_queue
+ *
+ * Description:
+ *   The queue operations, called by the thread of the queue 'qid'.  The TX
+ *   packets are only freed here, the interrupt of a queue just wakes its
+ *   thread up.
+ *
+ *****************************************************************************/
+
+static int igc_transmit_queue(FAR struct netdev_lowerhalf_s *dev, int qid,
+                              FAR netpkt_t *pkt)
+{
+  FAR struct igc_driver_s *priv = (FAR struct igc_driver_s *)dev;
+
+  return igc_transmit_ring(&priv->queue[qid], pkt);
+}
+
+static FAR netpkt_t *igc_receive_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int qid, FAR uint8_t *offload)
+{
+  FAR struct igc_driver_s *priv = (FAR struct igc_driver_s *)dev;
+
+  return igc_receive_ring(&priv->queue[qid], offload);
+}
+
+static void igc_reclaim_queue(FAR struct netdev_lowerhalf_s *dev, int qid)
+{
+  FAR struct igc_driver_s *priv = (FAR struct igc_driver_s *)dev;
+
+  igc_txdone_ring(&priv->queue[qid]);
+}
+#endif
+
+/*****************************************************************************
+ * Name: igc_link_status
+ *
+ * Description:
+ *   Report a link status change to the network.
+ *
+ *****************************************************************************/
+
+static void igc_link_status(FAR struct igc_driver_s *priv)
+{
+  uint32_t tmp;
+
+  tmp = igc_getreg_mem(priv, IGC_STATUS);
+  if (tmp & IGC_STATUS_LU)
+    {
+      ninfo("Link up, status = 0x%x\n", tmp);
+      netdev_lower_carrier_on(&priv->dev);
+    }
+  else
+    {
+      ninfo("Link down\n");
+      netdev_lower_carrier_off(&priv->dev);
+    }
+}
+
 /*****************************************************************************
  * Name: igc_misx_interrupt
  *
@@ -621,7 +863,6 @@ static void igc_msix_interrupt(FAR struct igc_driver_s *priv)
 {
   uint32_t icr  = 0;
   uint32_t eicr = 0;
-  uint32_t tmp  = 0;
 
   /* Get interrupts */
 
@@ -648,17 +889,7 @@ static void igc_msix_interrupt(FAR struct igc_driver_s *priv)
 
   if (icr & IGC_IC_LSC)
     {
-      tmp = igc_getreg_mem(priv, IGC_STATUS);
-      if (tmp & IGC_STATUS_LU)
-        {
-          ninfo("Link up, status = 0x%x\n", tmp);
-          netdev_lower_carrier_on(&priv->dev);
-        }
-      else
-        {
-          ninfo("Link down\n");
-          netdev_lower_carrier_off(&priv->dev);
-        }
+      igc_link_status(priv);
     }
 
   /* Receiver Miss */
@@ -711,6 +942,48 @@ static int igc_interrupt(int irq, FAR void *context, FAR void *arg)
   return OK;
 }
 
+#if IGC_NQUEUES > 1
+/*****************************************************************************
+ * Name: igc_queue_interrupt
+ *
+ * Description:
+ *   MSI-X vector handler of a queue pair, with several queues.  The vector
+ *   is masked by the hardware when it fires, wake up the thread of the
+ *   queue and unmask it.  Vector 0 also gets the other causes.
+ *
+ *****************************************************************************/
+
+static int igc_queue_interrupt(int irq, FAR void *context, FAR void *arg)
+{
+  FAR struct igc_queue_s  *queue = (FAR struct igc_queue_s *)arg;
+  FAR struct igc_driver_s *priv;
+  uint32_t                 icr;
+
+  DEBUGASSERT(queue != NULL);
+  priv = queue->priv;
+
+  if (queue->qid == 0)
+    {
+      icr = igc_getreg_mem(priv, IGC_ICR);
+      if (icr & IGC_IC_LSC)
+        {
+          igc_link_status(priv);
+        }
+
+      if (icr & IGC_IC_RXMISS)
+        {
+          nerr("Receiver Miss\n");
+        }
+    }
+
+  netdev_lower_rxready_queue(&priv->dev, queue->qid);
+  netdev_lower_txdone_queue(&priv->dev, queue->qid);
+
+  igc_putreg_mem(priv, IGC_EIMS, 1 << queue->qid);
+  return OK;
+}
+#endif
+
 /*****************************************************************************
  * Name: igc_ifup
  *
@@ -926,22 +1199,30 @@ static int igc_rmmac(FAR struct netdev_lowerhalf_s *dev,
 static void igc_disable(FAR struct igc_driver_s *priv)
 {
   int i = 0;
+  int q = 0;
 
-  /* Reset Tx tail */
+  for (q = 0; q < priv->nqueues; q++)
+    {
+      /* Reset Tx tail */
 
-  igc_putreg_mem(priv, IGC_TDH0, 0);
-  igc_putreg_mem(priv, IGC_TDT0, 0);
+      igc_putreg_mem(priv, IGC_TDH(q), 0);
+      igc_putreg_mem(priv, IGC_TDT(q), 0);
 
-  /* Reset Rx tail */
+      /* Reset Rx tail */
 
-  igc_putreg_mem(priv, IGC_RDH0, 0);
-  igc_putreg_mem(priv, IGC_RDT0, 0);
+      igc_putreg_mem(priv, IGC_RDH(q), 0);
+      igc_putreg_mem(priv, IGC_RDT(q), 0);
+    }
 
   /* Disable interrupts */
 
-  igc_putreg_mem(priv, IGC_EIMC, IGC_MSIX_EIMS);
-  igc_putreg_mem(priv, IGC_IMC, IGC_MSIX_IMS);
-  up_disable_irq(priv->irq);
+  igc_putreg_mem(priv, IGC_EIMC, 0xffffffff);
+  igc_putreg_mem(priv, IGC_IMC, 0xffffffff);
+
+  for (q = 0; q < priv->nqueues; q++)
+    {
+      up_disable_irq(priv->irq[q]);
+    }
 
   /* Disable Transmiter */
 
@@ -953,9 +1234,12 @@ static void igc_disable(FAR struct igc_driver_s *priv)
 
   /* Free RX packets */
 
-  for (i = 0; i < IGC_RX_DESC; i += 1)
+  for (q = 0; q < priv->nqueues; q++)
     {
-      netpkt_free(&priv->dev, priv->rx_pkt[i], NETPKT_RX);
+      for (i = 0; i < IGC_RX_DESC; i += 1)
+        {
+          netpkt_free(&priv->dev, priv->queue[q].rx_pkt[i], NETPKT_RX);
+        }
     }
 }
 
@@ -978,6 +1262,48 @@ static void igc_phy_reset(FAR struct igc_driver_s *priv)
   up_udelay(100);
 }
 
+#if IGC_NQUEUES > 1
+/*****************************************************************************
+ * Name: igc_rss_init
+ *
+ * Description:
+ *   Configure the RSS: the hash key, and the redirection table that spreads
+ *   the hash values evenly over the RX queues.
+ *
+ *****************************************************************************/
+
+static void igc_rss_init(FAR struct igc_driver_s *priv)
+{
+  uint32_t regval = 0;
+  int      i      = 0;
+  int      j      = 0;
+
+  for (i = 0; i < IGC_RETA_REGS; i++)
+    {
+      regval = 0;
+      for (j = 0; j < 4; j++)
+        {
+          regval |= (uint32_t)((i * 4 + j) % priv->nqueues) << (j * 8);
+        }
+
+      igc_putreg_mem(priv, IGC_RETA + (i << 2), regval);
+    }
+
+  /* The key registers are little endian */
+
+  for (i = 0; i < IGC_RSSRK_REGS; i++)
+    {
+      regval = (uint32_t)g_igc_rss_key[i * 4] |
+               ((uint32_t)g_igc_rss_key[i * 4 + 1] << 8) |
+               ((uint32_t)g_igc_rss_key[i * 4 + 2] << 16) |
+               ((uint32_t)g_igc_rss_key[i * 4 + 3] << 24);
+      igc_putreg_mem(priv, IGC_RSSRK + (i << 2), regval);
+    }
+
+  igc_putreg_mem(priv, IGC_MRQC, IGC_MRQC_RSS);
+}
+#endif
+
 /*****************************************************************************
  * Name: igc_enable
  *
@@ -992,6 +1318,7 @@ static void igc_enable(FAR struct igc_driver_s *priv)
   uint64_t pa     = 0;
   uint32_t regval = 0;
   int      i      = 0;
+  int      q      = 0;
 
   /* Reset PHY */
 
@@ -1004,67 +1331,87 @@ static void igc_enable(FAR struct igc_driver_s *priv)
       igc_putreg_mem(priv, IGC_MTA + (i << 2), 0);
     }
 
-  /* Allocate RX packets */
-
-  for (i = 0; i < IGC_RX_DESC; i += 1)
+  for (q = 0; q < priv->nqueues; q++)
     {
-      priv->rx_pkt[i] = netpkt_alloc(dev, NETPKT_RX);
-      if (priv->rx_pkt[i] == NULL)
-        {
-          nerr("alloc rx_pkt failed\n");
-          PANIC();
-        }
+      FAR struct igc_queue_s *queue = &priv->queue[q];
 
-      /* Configure RX descriptor */
+      /* Allocate RX packets */
 
-      priv->rx[i].addr   = up_addrenv_va_to_pa(
-                           netpkt_getdata(dev, priv->rx_pkt[i]));
-      priv->rx[i].len    = 0;
-      priv->rx[i].status = 0;
-    }
+      for (i = 0; i < IGC_RX_DESC; i += 1)
+        {
+          queue->rx_pkt[i] = netpkt_alloc(dev, NETPKT_RX);
+          if (queue->rx_pkt[i] == NULL)
+            {
+              nerr("alloc rx_pkt failed\n");
+              PANIC();
+            }
+
+          /* Configure RX descriptor */
+
+          queue->rx[i].addr   = up_addrenv_va_to_pa(
+                                netpkt_getdata(dev, queue->rx_pkt[i]));
+          queue->rx[i].len    = 0;
+          queue->rx[i].status = 0;
+        }
 
-  /* Setup TX descriptor */
+      /* Setup TX descriptor */
 
-  /* The address passed to the NIC must be physical */
+      /* The address passed to the NIC must be physical */
 
-  pa = up_addrenv_va_to_pa(priv->tx);
+      pa = up_addrenv_va_to_pa(queue->tx);
 
-  regval = (uint32_t)pa;
-  igc_putreg_mem(priv, IGC_TDBAL0, regval);
-  regval = (uint32_t)(pa >> 32);
-  igc_putreg_mem(priv, IGC_TDBAH0, regval);
+      regval = (uint32_t)pa;
+      igc_putreg_mem(priv, IGC_TDBAL(q), regval);
+      regval = (uint32_t)(pa >> 32);
+      igc_putreg_mem(priv, IGC_TDBAH(q), regval);
 
-  regval = IGC_TX_DESC * sizeof(struct igc_tx_leg_s);
-  igc_putreg_mem(priv, IGC_TDLEN0, regval);
+      regval = IGC_TX_DESC * sizeof(struct igc_tx_leg_s);
+      igc_putreg_mem(priv, IGC_TDLEN(q), regval);
 
-  priv->tx_now = 0;
+      queue->tx_now  = 0;
+      queue->tx_done = 0;
 
-  /* Reset TX tail */
+      /* Reset TX tail */
 
-  igc_putreg_mem(priv, IGC_TDH0, 0);
-  igc_putreg_mem(priv, IGC_TDT0, 0);
+      igc_putreg_mem(priv, IGC_TDH(q), 0);
+      igc_putreg_mem(priv, IGC_TDT(q), 0);
 
-  /* Setup RX descriptor */
+      /* Setup RX descriptor */
 
-  /* The address passed to the NIC must be physical */
+      /* The address passed to the NIC must be physical */
 
-  pa = up_addrenv_va_to_pa(priv->rx);
+      pa = up_addrenv_va_to_pa(queue->rx);
 
-  regval = (uint32_t)pa;
-  igc_putreg_mem(priv, IGC_RDBAL0, regval);
-  regval = (uint32_t)(pa >> 32);
-  igc_putreg_mem(priv, IGC_RDBAH0, regval);
+      regval = (uint32_t)pa;
+      igc_putreg_mem(priv, IGC_RDBAL(q), regval);
+      regval = (uint32_t)(pa >> 32);
+      igc_putreg_mem(priv, IGC_RDBAH(q), regval);
 
-  regval = IGC_RX_DESC * sizeof(struct igc_rx_leg_s);
-  igc_putreg_mem(priv, IGC_RDLEN0, regval);
+      regval = IGC_RX_DESC * sizeof(struct igc_rx_leg_s);
+      igc_putreg_mem(priv, IGC_RDLEN(q), regval);
 
-  priv->rx_now = 0;
+      queue->rx_now = 0;
+    }
 
   /* Enable interrupts */
 
-  igc_putreg_mem(priv, IGC_EIMS, IGC_MSIX_EIMS);
-  igc_putreg_mem(priv, IGC_IMS, IGC_MSIX_IMS);
-  up_enable_irq(priv->irq);
+#if IGC_NQUEUES > 1
+  if (priv->nqueues > 1)
+    {
+      igc_putreg_mem(priv, IGC_EIMS, (1 << priv->nqueues) - 1);
+      igc_putreg_mem(priv, IGC_IMS, IGC_MSIX_IMS_OTHER);
+    }
+  else
+#endif
+    {
+      igc_putreg_mem(priv, IGC_EIMS, IGC_MSIX_EIMS);
+      igc_putreg_mem(priv, IGC_IMS, IGC_MSIX_IMS);
+    }
+
+  for (q = 0; q < priv->nqueues; q++)
+    {
+      up_enable_irq(priv->irq[q]);
+    }
 
   /* Set link up */
 
@@ -1076,6 +1423,15 @@ static void igc_enable(FAR struct igc_driver_s *priv)
   regval |= IGC_TCTL_EN | IGC_TCTL_PSP;
   igc_putreg_mem(priv, IGC_TCTL, regval);
 
+#if IGC_NQUEUES > 1
+  /* Spread the received flows over the RX queues */
+
+  if (priv->nqueues > 1)
+    {
+      igc_rss_init(priv);
+    }
+#endif
+
   /* Setup and enable Receiver */
 
   regval = (IGC_RCTL_EN | IGC_RCTL_MPE |
@@ -1085,22 +1441,33 @@ static void igc_enable(FAR struct igc_driver_s *priv)
 #endif
   igc_putreg_mem(priv, IGC_RCTL, regval);
 
-  /* Enable TX queeu */
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Verify the IP and TCP/UDP checksums of received packets */
+
+  regval = igc_getreg_mem(priv, IGC_RXCSUM);
+  regval |= IGC_RXCSUM_IPOFL | IGC_RXCSUM_TUOFL;
+  igc_putreg_mem(priv, IGC_RXCSUM, regval);
+#endif
+
+  for (q = 0; q < priv->nqueues; q++)
+    {
+      /* Enable TX queeu */
 
-  regval = igc_getreg_mem(priv, IGC_TXDCTL0);
-  regval |= IGC_TXDCTL_ENABLE;
-  igc_putreg_mem(priv, IGC_TXDCTL0, regval);
+      regval = igc_getreg_mem(priv, IGC_TXDCTL(q));
+      regval |= IGC_TXDCTL_ENABLE;
+      igc_putreg_mem(priv, IGC_TXDCTL(q), regval);
 
-  /* Enable RX queue */
+      /* Enable RX queue */
 
-  regval = igc_getreg_mem(priv, IGC_RXDCTL0);
-  regval |= IGC_RXDCTL_ENABLE;
-  igc_putreg_mem(priv, IGC_RXDCTL0, regval);
+      regval = igc_getreg_mem(priv, IGC_RXDCTL(q));
+      regval |= IGC_RXDCTL_ENABLE;
+      igc_putreg_mem(priv, IGC_RXDCTL(q), regval);
 
-  /* Reset RX tail - after queue is enabled */
+      /* Reset RX tail - after queue is enabled */
 
-  igc_putreg_mem(priv, IGC_RDH0, 0);
-  igc_putreg_mem(priv, IGC_RDT0, IGC_RX_DESC);
+      igc_putreg_mem(priv, IGC_RDH(q), 0);
+      igc_putreg_mem(priv, IGC_RDT(q), IGC_RX_DESC);
+    }
 
 #ifdef CONFIG_DEBUG_NET_INFO
   /* Dump memory */
@@ -1122,27 +1489,52 @@ static int igc_initialize(FAR struct igc_driver_s *priv)
   uint32_t regval = 0;
   uint64_t mac    = 0;
   int      ret    = OK;
+  int      i      = 0;
+
+  /* Allocate MSI, one vector per queue pair if possible */
 
-  /* Allocate MSI */
+  ret = pci_alloc_irq(priv->pcidev, priv->irq, IGC_NQUEUES);
+  if (ret <= 0 && IGC_NQUEUES > 1)
+    {
+      ret = pci_alloc_irq(priv->pcidev, priv->irq, 1);
+    }
 
-  ret = pci_alloc_irq(priv->pcidev, &priv->irq, 1);
-  if (ret != 1)
+  if (ret <= 0)
     {
       nerr("Failed to allocate MSI %d\n", ret);
-      return ret;
+      return ret < 0 ? ret : -ENOTSUP;
+    }
+
+  priv->nqueues = ret;
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      priv->queue[i].priv = priv;
+      priv->queue[i].qid  = i;
     }
 
   /* Attach IRQ */
 
-  irq_attach(priv->irq, igc_interrupt, priv);
+#if IGC_NQUEUES > 1
+  if (priv->nqueues > 1)
+    {
+      for (i = 0; i < priv->nqueues; i++)
+        {
+          irq_attach(priv->irq[i], igc_queue_interrupt, &priv->queue[i]);
+        }
+    }
+  else
+#endif
+    {
+      irq_attach(priv->irq[0], igc_interrupt, priv);
+    }
 
   /* Connect MSI */
 
-  ret = pci_connect_irq(priv->pcidev, &priv->irq, 1);
+  ret = pci_connect_irq(priv->pcidev, priv->irq, priv->nqueues);
   if (ret != OK)
     {
       nerr("Failed to connect MSI %d\n", ret);
-      pci_release_irq(priv->pcidev, &priv->irq, 1);
+      pci_release_irq(priv->pcidev, priv->irq, priv->nqueues);
 
       return -ENOTSUP;
     }
@@ -1152,23 +1544,60 @@ static int igc_initialize(FAR struct igc_driver_s *priv)
   igc_putreg_mem(priv, IGC_EIMC, 0xffffffff);
   igc_putreg_mem(priv, IGC_IMC, 0xffffffff);
 
-  /* Configure MSI-X */
+#if IGC_NQUEUES > 1
+  if (priv->nqueues > 1)
+    {
+      /* Configure MSI-X, the vector n serves the RX and TX queues n */
+
+      for (i = 0; i < priv->nqueues; i++)
+        {
+          regval  = igc_getreg_mem(priv, IGC_IVAR(i >> 1));
+          regval &= ~((0xff << IGC_IVAR_RXQ_SHIFT(i)) |
+                      (0xff << IGC_IVAR_TXQ_SHIFT(i)));
+          regval |= (i | IGC_IVAR_VAL) << IGC_IVAR_RXQ_SHIFT(i);
+          regval |= (i | IGC_IVAR_VAL) << IGC_IVAR_TXQ_SHIFT(i);
+          igc_putreg_mem(priv, IGC_IVAR(i >> 1), regval);
+
+          /* Configure Interrupt Throttle */
+
+          igc_putreg_mem(priv, IGC_EITR(i), (IGC_INTERRUPT_INTERVAL << 2));
+        }
+
+      igc_putreg_mem(priv, IGC_IVARMSC, IGC_MSIX_IVARMSC);
+
+      /* Enable MSI-X with one vector per queue, auto cleared and masked */
+
+      regval = (1 << priv->nqueues) - 1;
+      igc_putreg_mem(priv, IGC_GPIE, IGC_GPIE_MSIX_MULTI);
+      igc_putreg_mem(priv, IGC_EIAC, regval);
+      igc_putreg_mem(priv, IGC_EIAM, regval);
+      igc_putreg_mem(priv, IGC_EIMS, regval);
+
+      /* Configure Other causes */
 
-  igc_putreg_mem(priv, IGC_IVAR0, IGC_MSIX_IVAR0);
-  igc_putreg_mem(priv, IGC_IVARMSC, IGC_MSIX_IVARMSC);
+      igc_putreg_mem(priv, IGC_IMS, IGC_MSIX_IMS_OTHER);
+    }
+  else
+#endif
+    {
+      /* Configure MSI-X */
+
+      igc_putreg_mem(priv, IGC_IVAR0, IGC_MSIX_IVAR0);
+      igc_putreg_mem(priv, IGC_IVARMSC, IGC_MSIX_IVARMSC);
 
-  /* Enable MSI-X Single Vector */
+      /* Enable MSI-X Single Vector */
 
-  igc_putreg_mem(priv, IGC_GPIE, IGC_GPIE_MSIX_SINGLE);
-  igc_putreg_mem(priv, IGC_EIMS, IGC_MSIX_EIMS);
+      igc_putreg_mem(priv, IGC_GPIE, IGC_GPIE_MSIX_SINGLE);
+      igc_putreg_mem(priv, IGC_EIMS, IGC_MSIX_EIMS);
 
-  /* Configure Other causes */
+      /* Configure Other causes */
 
-  igc_putreg_mem(priv, IGC_IMS, IGC_MSIX_IMS);
+      igc_putreg_mem(priv, IGC_IMS, IGC_MSIX_IMS);
 
-  /* Configure Interrupt Throttle */
+      /* Configure Interrupt Throttle */
 
-  igc_putreg_mem(priv, IGC_EITR0, (IGC_INTERRUPT_INTERVAL << 2));
+      igc_putreg_mem(priv, IGC_EITR0, (IGC_INTERRUPT_INTERVAL << 2));
+    }
 
   /* Get MAC if valid */
 
@@ -1201,6 +1630,7 @@ static int igc_probe(FAR struct pci_device_s *dev)
   FAR struct igc_driver_s       *priv   = NULL;
   FAR struct netdev_lowerhalf_s *netdev = NULL;
   int                            ret    = -ENOMEM;
+  int                            i      = 0;
 
   /* Get type data associated with this PCI device card */
 
@@ -1223,42 +1653,47 @@ static int igc_probe(FAR struct pci_device_s *dev)
 
   priv->pcidev = dev;
 
-  /* Allocate TX descriptors */
-
-  priv->tx = kmm_memalign(type->desc_align,
-                          IGC_TX_DESC * sizeof(struct igc_tx_leg_s));
-  if (priv->tx == NULL)
+  for (i = 0; i < IGC_NQUEUES; i++)
     {
-      nerr("alloc tx failed %d\n", errno);
-      goto errout;
-    }
+      FAR struct igc_queue_s *queue = &priv->queue[i];
 
-  /* Allocate RX descriptors */
+      /* Allocate TX descriptors */
 
-  priv->rx = kmm_memalign(type->desc_align,
-                          IGC_RX_DESC * sizeof(struct igc_rx_leg_s));
-  if (priv->rx == NULL)
-    {
-      nerr("alloc rx failed %d\n", errno);
-      goto errout;
-    }
+      queue->tx = kmm_memalign(type->desc_align,
+                               IGC_TX_DESC * sizeof(struct igc_tx_leg_s));
+      if (queue->tx == NULL)
+        {
+          nerr("alloc tx failed %d\n", errno);
+          goto errout;
+        }
 
-  /* Allocate TX packet pointer array */
+      /* Allocate RX descriptors */
 
-  priv->tx_pkt = kmm_zalloc(IGC_TX_DESC * sizeof(netpkt_t *));
-  if (priv->tx_pkt == NULL)
-    {
-      nerr("alloc tx_pkt failed\n");
-      goto errout;
-    }
+      queue->rx = kmm_memalign(type->desc_align,
+                               IGC_RX_DESC * sizeof(struct igc_rx_leg_s));
+      if (queue->rx == NULL)
+        {
+          nerr("alloc rx failed %d\n", errno);
+          goto errout;
+        }
 
-  /* Allocate RX packet pointer array */
+      /* Allocate TX packet pointer array */
 
-  priv->rx_pkt = kmm_zalloc(IGC_RX_DESC * sizeof(netpkt_t *));
-  if (priv->rx_pkt == NULL)
-    {
-      nerr("alloc rx_pkt failed\n");
-      goto errout;
+      queue->tx_pkt = kmm_zalloc(IGC_TX_DESC * sizeof(netpkt_t *));
+      if (queue->tx_pkt == NULL)
+        {
+          nerr("alloc tx_pkt failed\n");
+          goto errout;
+        }
+
+      /* Allocate RX packet pointer array */
+
+      queue->rx_pkt = kmm_zalloc(IGC_RX_DESC * sizeof(netpkt_t *));
+      if (queue->rx_pkt == NULL)
+        {
+          nerr("alloc rx_pkt failed\n");
+          goto errout;
+        }
     }
 
 #ifdef CONFIG_NET_MCASTGROUP
@@ -1302,15 +1737,37 @@ static int igc_probe(FAR struct pci_device_s *dev)
 
   /* Register the network device */
 
-  netdev->quota[NETPKT_TX] = IGC_TX_QUOTA;
-  netdev->quota[NETPKT_RX] = IGC_RX_QUOTA;
+  netdev->quota[NETPKT_TX] = IGC_TX_QUOTA * priv->nqueues;
+  netdev->quota[NETPKT_RX] = IGC_RX_QUOTA * priv->nqueues;
   netdev->ops = &g_igc_ops;
 
+#if IGC_NQUEUES > 1
+  if (priv->nqueues > 1)
+    {
+      netdev->rxqueues = priv->nqueues;
+      netdev->txqueues = priv->nqueues;
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* TSO would need the advanced descriptors, only checksums are left to
+   * the MAC.
+   */
+
+  netdev->netdev.d_features = NETDEV_FEATURE_TXCSUM | NETDEV_FEATURE_RXCSUM;
+#endif
+
   return netdev_lower_register(netdev, NET_LL_ETHERNET);
 
 errout:
-  kmm_free(priv->tx);
-  kmm_free(priv->rx);
+  for (i = 0; i < IGC_NQUEUES; i++)
+    {
+      kmm_free(priv->queue[i].tx);
+      kmm_free(priv->queue[i].rx);
+      kmm_free(priv->queue[i].tx_pkt);
+      kmm_free(priv->queue[i].rx_pkt);
+    }
+
 #ifdef CONFIG_NET_MCASTGROUP
   kmm_free(priv->mta);
 #endif
@@ -81,6 +81,8 @@
 #define IGC_IVAR0                 (0x1700)   /* Interrupt Vector Allocation Registers  */
 #define IGC_IVARMSC               (0x1740)   /* Interrupt Vector Allocation Registers - MISC */
 #define IGC_EITR0                 (0x1680)   /* Extended Interrupt Throttling Rate 0 - 24 */
+#define IGC_EITR(n)               (IGC_EITR0 + ((n) << 2))
+#define IGC_IVAR(n)               (IGC_IVAR0 + ((n) << 2))
 #define IGC_GPIE                  (0x1514)   /* General Purpose Interrupt Enable */
 #define IGC_PBACL                 (0x5b68)   /* MSI-X PBA Clear */
 #define IGC_PICAUSE               (0x5b88)   /* PCIe Interrupt Cause */
@@ -102,6 +104,12 @@
 #define IGC_RDT0                  (0xc018)   /* Rx Descriptor Tail */
 #define IGC_RXDCTL0               (0xc028)   /* Receive Descriptor Control Queue */
 #define IGC_RXCTL0                (0xc014)   /* Receive Queue DCA CTRL Register */
+#define IGC_RDBAL(n)              (IGC_RDBAL0 + ((n) << 6))
+#define IGC_RDBAH(n)              (IGC_RDBAH0 + ((n) << 6))
+#define IGC_RDLEN(n)              (IGC_RDLEN0 + ((n) << 6))
+#define IGC_RDH(n)                (IGC_RDH0 + ((n) << 6))
+#define IGC_RDT(n)                (IGC_RDT0 + ((n) << 6))
+#define IGC_RXDCTL(n)             (IGC_RXDCTL0 + ((n) << 6))
 #define IGC_RXCSUM                (0x5000)   /* Receive Checksum Control */
 #define IGC_RLPML                 (0x5004)   /* Receive Long packet maximal length */
 #define IGC_RFCTL                 (0x5008)   /* Receive Filter Control Register */
@@ -136,6 +144,12 @@
 #define IGC_TXCTL0                (0xe014)   /* Tx DCA CTRL Register Queue */
 #define IGC_TDWBAL0               (0xe038)   /* Transmit Descriptor WB Address Low Queue */
 #define IGC_TDWBAH0               (0xe03c)   /* Transmit Descriptor WB Address High Queue */
+#define IGC_TDBAL(n)              (IGC_TDBAL0 + ((n) << 6))
+#define IGC_TDBAH(n)              (IGC_TDBAH0 + ((n) << 6))
+#define IGC_TDLEN(n)              (IGC_TDLEN0 + ((n) << 6))
+#define IGC_TDH(n)                (IGC_TDH0 + ((n) << 6))
+#define IGC_TDT(n)                (IGC_TDT0 + ((n) << 6))
+#define IGC_TXDCTL(n)             (IGC_TXDCTL0 + ((n) << 6))
 
 /* Transmit Scheduling Registers */
 
@@ -357,6 +371,12 @@
 #define IGC_RCTL_SECRC            (1 << 26)  /* Bit 26: Strip Ethernet CRC from incoming packet */
                                              /* Bits 27-31: Reserved */
 
+/* Receive Checksum Control */
+
+#define IGC_RXCSUM_PCSS_SHIFT     (0)        /* Bits 0-7: Checksum start */
+#define IGC_RXCSUM_IPOFL          (1 << 8)   /* Bit 8: IP checksum offload */
+#define IGC_RXCSUM_TUOFL          (1 << 9)   /* Bit 9: TCP/UDP csum offload */
+
 /* Receive Descriptor Control */
 
 #define IGC_RXDCTL_PTHRESH_SHIFT  (0)       /* Bits 0-4: Prefetch Threshold */
@@ -423,6 +443,12 @@
 #define IGC_IVAR0_TXQ0_SHIFT      (8)        /* Bits 8-12: MSI-X vector assigned to TxQ0 */
 #define IGC_IVAR0_TXQ0_VAL        (1 << 7)   /* Bit 7: Valid bit for TxQ0 */
 
+/* Interrupt Vector Allocation Registers (n), two queues per register */
+
+#define IGC_IVAR_RXQ_SHIFT(q)     (((q) & 1) << 4)       /* RxQ(q) vector */
+#define IGC_IVAR_TXQ_SHIFT(q)     ((((q) & 1) << 4) + 8) /* TxQ(q) vector */
+#define IGC_IVAR_VAL              (1 << 7)               /* Valid bit */
+
 /* Interrupt Vector Allocation Registers - Misc */
 
 #define IGC_IVARMSC_TCPTIM        (0)        /* Bits 0-5: MSI-X vectorassigned to TCP timer interrupt */
@@ -433,6 +459,19 @@
 #define IGC_IVARMSC_OTHER_VAL     (1 << 15)  /* Bit 15: Enable bit for Ohter Cause */
                                              /* Bits 20-30: Reserved */
 
+/* Multiple Receive Queues Command */
+
+#define IGC_MRQC_MRQE_RSS         (2 << 0)   /* Bits 0-2: RSS only */
+#define IGC_MRQC_RSS_TCPIPV4      (1 << 16)  /* Bit 16: Hash TCP over IPv4 */
+#define IGC_MRQC_RSS_IPV4         (1 << 17)  /* Bit 17: Hash IPv4 */
+#define IGC_MRQC_RSS_IPV6         (1 << 20)  /* Bit 20: Hash IPv6 */
+#define IGC_MRQC_RSS_TCPIPV6      (1 << 21)  /* Bit 21: Hash TCP over IPv6 */
+#define IGC_MRQC_RSS_UDPIPV4      (1 << 22)  /* Bit 22: Hash UDP over IPv4 */
+#define IGC_MRQC_RSS_UDPIPV6      (1 << 23)  /* Bit 23: Hash UDP over IPv6 */
+
+#define IGC_RETA_REGS             (32)       /* 128 one-byte entries */
+#define IGC_RSSRK_REGS            (10)       /* 40-byte key */
+
 /* General Purpose Interrupt Enable */
 
 #define IGC_GPIE_NSICR            (1 << 0)   /* Bit 0: Non Selective Interrupt Clear on Read */
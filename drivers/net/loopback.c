@@ -70,6 +70,9 @@
 struct lo_driver_s
 {
   bool lo_bifup;               /* true:ifup false:ifdown */
+#ifdef CONFIG_NET_LOOPBACK_FASTPATH
+  bool lo_polling;             /* true:a poll runs in the sender */
+#endif
   struct work_s lo_work;       /* For deferring poll work to the work queue */
 
   /* This holds the information visible to the NuttX network */
@@ -199,7 +202,13 @@ static void lo_txavail_work(FAR void *arg)
        * return stop
        */
 
+#ifdef CONFIG_NET_LOOPBACK_FASTPATH
+      priv->lo_polling = true;
+#endif
       while (devif_poll(&priv->lo_dev, NULL));
+#ifdef CONFIG_NET_LOOPBACK_FASTPATH
+      priv->lo_polling = false;
+#endif
     }
 
   net_unlock();
@@ -228,6 +237,26 @@ static int lo_txavail(FAR struct net_driver_s *dev)
 {
   FAR struct lo_driver_s *priv = (FAR struct lo_driver_s *)dev->d_private;
 
+#ifdef CONFIG_NET_LOOPBACK_FASTPATH
+  /* Poll right away in the context of the sender, so the I/O buffer chain
+   * that it filled is passed to the input of the receiving connection in
+   * the same call, without a round trip through the work queue.  This is
+   * not possible from an interrupt handler, within a poll of this device
+   * or if another thread holds the network.
+   */
+
+  if (priv->lo_bifup && !priv->lo_polling && !up_interrupt_context() &&
+      net_trylock() >= 0)
+    {
+      priv->lo_polling = true;
+      while (devif_poll(&priv->lo_dev, NULL));
+      priv->lo_polling = false;
+
+      net_unlock();
+      return OK;
+    }
+#endif
+
   /* Is our single work structure available?  It may not be if there are
    * pending interrupt actions and we will have to ignore the Tx
    * availability action.
@@ -29,11 +29,16 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/param.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/crc32.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/can.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/ip.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
@@ -47,6 +52,7 @@
 #define NETDEV_TX_CONTINUE 1 /* Return value for devif_poll */
 
 #define NETDEV_THREAD_NAME_FMT "netdev-%s"
+#define NETDEV_QUEUE_NAME_FMT  "netdev-%s-%d"
 
 #ifdef CONFIG_NETDEV_HPWORK_THREAD
 #  define NETDEV_WORK HPWORK
@@ -60,10 +66,60 @@
 #  define NETDEV_THREAD_COUNT 1
 #endif
 
+/* With CONFIG_NET_LOCK_SPLIT, the lower half is accessed under the device
+ * lock only, and the network lock is taken just around the calls into the
+ * protocol stack.  Otherwise, the whole work runs with the network locked.
+ */
+
+#ifdef CONFIG_NET_LOCK_SPLIT
+#  define netdev_upper_stack_lock(dev) \
+     do { net_lock(); netdev_lock(dev); } while (0)
+#  define netdev_upper_stack_unlock(dev) \
+     do { netdev_unlock(dev); net_unlock(); } while (0)
+#else
+#  define netdev_upper_stack_lock(dev)
+#  define netdev_upper_stack_unlock(dev)
+#endif
+
+#ifdef CONFIG_NETDEV_SOFT_RSS
+#  define NETDEV_RSS_QUEUES MIN(CONFIG_SMP_NCPUS, CONFIG_NETDEV_MAX_QUEUES)
+#  define NETDEV_RSS_KEYLEN 40
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/* This structure describes one queue of the upper half, it is served by
+ * its own thread.
+ */
+
+struct netdev_upperhalf_s;
+struct netdev_upper_queue_s
+{
+  FAR struct netdev_upperhalf_s *upper;
+  int     qid;
+  pid_t   tid;
+  sem_t   sem;
+  sem_t   sem_exit;
+
+  /* Serializes the queue operations of the lower half on this queue */
+
+  mutex_t lock;
+
+#ifdef CONFIG_NETDEV_SOFT_RSS
+  /* Packets steered to this queue by the software RSS */
+
+  spinlock_t    backlock;
+  uint16_t      head;
+  uint16_t      tail;
+  FAR netpkt_t *backlog[CONFIG_NETDEV_SOFT_RSS_BACKLOG];
+  uint8_t       offload[CONFIG_NETDEV_SOFT_RSS_BACKLOG];
+#endif
+};
+#endif
+
 /* This structure describes the state of the upper half driver */
 
 struct netdev_upperhalf_s
@@ -72,7 +128,10 @@ struct netdev_upperhalf_s
 
   /* Deferring poll work to work queue or thread */
 
-#ifdef CONFIG_NETDEV_WORK_THREAD
+#if defined(CONFIG_NETDEV_MULTIQUEUE)
+  struct netdev_upper_queue_s queue[CONFIG_NETDEV_MAX_QUEUES];
+  int nqueues;
+#elif defined(CONFIG_NETDEV_WORK_THREAD)
   pid_t tid[NETDEV_THREAD_COUNT];
   sem_t sem[NETDEV_THREAD_COUNT];
   sem_t sem_exit[NETDEV_THREAD_COUNT];
@@ -85,7 +144,44 @@ struct netdev_upperhalf_s
 #if CONFIG_IOB_NCHAINS > 0
   struct iob_queue_s txq;
 #endif
+
+  /* TX packets taken from the stack but not yet given to the lower half */
+
+#ifdef CONFIG_NETDEV_BATCH
+  FAR netpkt_t *txbatch[CONFIG_NETDEV_BATCH_SIZE];
+  int ntxbatch;
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_SOFT_RSS
+/* The default RSS key of most multi-queue NICs, so that the software RSS
+ * spreads the flows like their hardware does.
+ */
+
+static const uint8_t g_netdev_rss_key[NETDEV_RSS_KEYLEN] =
+{
+  0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2, 0x41, 0x67,
+  0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0, 0xd0, 0xca, 0x2b, 0xcb,
+  0xae, 0x7b, 0x30, 0xb4, 0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30,
+  0xf2, 0x0c, 0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa,
 };
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_BATCH
+static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev);
+static int netdev_upper_txbatch_flush(FAR struct netdev_upperhalf_s *upper);
+#endif
+#ifdef CONFIG_NETDEV_SOFT_RSS
+static void netdev_upper_post(FAR sem_t *sem);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -221,6 +317,205 @@ netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev)
   return upper;
 }
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/****************************************************************************
+ * Name: netdev_upper_toeplitz
+ *
+ * Description:
+ *   Compute the Toeplitz hash of 'len' bytes with the RSS key.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_SOFT_RSS
+static uint32_t netdev_upper_toeplitz(FAR const uint8_t *data, int len)
+{
+  FAR const uint8_t *rsskey = g_netdev_rss_key;
+  uint32_t key  = ((uint32_t)rsskey[0] << 24) | ((uint32_t)rsskey[1] << 16) |
+                  ((uint32_t)rsskey[2] << 8) | rsskey[3];
+  uint32_t hash = 0;
+  int i;
+  int j;
+
+  DEBUGASSERT(len + 4 <= NETDEV_RSS_KEYLEN);
+
+  for (i = 0; i < len; i++)
+    {
+      for (j = 7; j >= 0; j--)
+        {
+          if ((data[i] & (1 << j)) != 0)
+            {
+              hash ^= key;
+            }
+
+          key = (key << 1) | ((rsskey[i + 4] >> j) & 1);
+        }
+    }
+
+  return hash;
+}
+#else
+#  define netdev_upper_toeplitz(data, len) crc32(data, len)
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_flowhash
+ *
+ * Description:
+ *   Hash the addresses and the TCP/UDP ports of a packet, like the RSS of
+ *   multi-queue NICs.  The packets that are not IP get zero, the packets
+ *   without ports (IP fragments and other protocols) are hashed on their
+ *   addresses only.
+ *
+ ****************************************************************************/
+
+static uint32_t netdev_upper_flowhash(FAR struct netdev_lowerhalf_s *lower,
+                                      FAR netpkt_t *pkt)
+{
+  FAR struct net_driver_s *dev  = &lower->netdev;
+  FAR const uint8_t       *ip   = IOB_DATA(pkt);
+  unsigned int             len  = pkt->io_len;
+  unsigned int             hlen = 0;
+  unsigned int             alen = 0;
+  uint8_t                  tuple[36];
+  uint8_t                  proto = 0;
+
+#if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_DRIVERS_IEEE80211)
+  if (NET_LL_HDRLEN(dev) == ETH_HDRLEN)
+    {
+      FAR const struct eth_hdr_s *eth =
+        (FAR const struct eth_hdr_s *)(ip - ETH_HDRLEN);
+
+      if (eth->type != HTONS(ETHTYPE_IP) && eth->type != HTONS(ETHTYPE_IP6))
+        {
+          return 0;
+        }
+    }
+  else
+#endif
+  if (NET_LL_HDRLEN(dev) != 0)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (len >= IPv4_HDRLEN && (ip[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR const struct ipv4_hdr_s *ipv4 = (FAR const struct ipv4_hdr_s *)ip;
+
+      alen  = 4;
+      proto = ipv4->proto;
+      memcpy(tuple, ipv4->srcipaddr, 2 * alen);
+
+      /* Only the first fragment has the ports */
+
+      if ((ipv4->ipoffset[0] & 0x3f) == 0 && ipv4->ipoffset[1] == 0)
+        {
+          hlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+        }
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (len >= IPv6_HDRLEN && (ip[0] & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      FAR const struct ipv6_hdr_s *ipv6 = (FAR const struct ipv6_hdr_s *)ip;
+
+      alen  = 16;
+      proto = ipv6->proto;
+      hlen  = IPv6_HDRLEN;
+      memcpy(tuple, ipv6->srcipaddr, 2 * alen);
+    }
+  else
+#endif
+    {
+      return 0;
+    }
+
+  if (hlen > 0 && len >= hlen + 4 &&
+      (proto == IP_PROTO_TCP || proto == IP_PROTO_UDP))
+    {
+      /* Both TCP and UDP start with the source and destination ports */
+
+      memcpy(tuple + 2 * alen, ip + hlen, 4);
+      return netdev_upper_toeplitz(tuple, 2 * alen + 4);
+    }
+
+  return netdev_upper_toeplitz(tuple, 2 * alen);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_transmit
+ *
+ * Description:
+ *   Give a packet to the lower half.  With several TX queues, the queue is
+ *   chosen by the hash of the flow of the packet, so that all the packets
+ *   of a socket leave through the same queue and stay in order.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_transmit(FAR struct netdev_upperhalf_s *upper,
+                                 FAR netpkt_t *pkt)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct netdev_upper_queue_s *queue;
+  int ret;
+
+  if (lower->txqueues <= 1)
+    {
+      return lower->ops->transmit(lower, pkt);
+    }
+
+  queue = &upper->queue[netdev_upper_flowhash(lower, pkt) % lower->txqueues];
+
+  nxmutex_lock(&queue->lock);
+  ret = lower->ops->transmit_queue(lower, queue->qid, pkt);
+  nxmutex_unlock(&queue->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_reclaim
+ *
+ * Description:
+ *   Reclaim the packets sent by all the TX queues of the lower half.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_reclaim(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  int qid;
+
+  if (lower->txqueues <= 1)
+    {
+      if (lower->ops->reclaim)
+        {
+          netdev_lock(&lower->netdev);
+          lower->ops->reclaim(lower);
+          netdev_unlock(&lower->netdev);
+        }
+
+      return;
+    }
+
+  if (lower->ops->reclaim_queue)
+    {
+      for (qid = 0; qid < lower->txqueues; qid++)
+        {
+          nxmutex_lock(&upper->queue[qid].lock);
+          lower->ops->reclaim_queue(lower, qid);
+          nxmutex_unlock(&upper->queue[qid].lock);
+        }
+    }
+}
+#else
+#  define netdev_upper_transmit(upper, pkt) \
+     (upper)->lower->ops->transmit((upper)->lower, pkt)
+#endif
+
 /****************************************************************************
  * Name: netdev_upper_can_tx
  *
@@ -237,11 +532,21 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   int quota = netdev_lower_quota_load(lower, NETPKT_TX);
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (quota <= 0)
+    {
+      netdev_upper_reclaim(upper);
+      quota = netdev_lower_quota_load(lower, NETPKT_TX);
+    }
+#else
   if (quota <= 0 && lower->ops->reclaim)
     {
+      netdev_lock(&lower->netdev);
       lower->ops->reclaim(lower);
+      netdev_unlock(&lower->netdev);
       quota = netdev_lower_quota_load(lower, NETPKT_TX);
     }
+#endif
 
   return quota > 0;
 }
@@ -265,6 +570,8 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
  * Returned Value:
  *   Negated errno value - Error number that occurs.
  *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
+ *   0                   - With CONFIG_NETDEV_BATCH, the packet is added to
+ *                         the TX batch which is not full yet.
  *
  * Assumptions:
  *   Called with the network locked.
@@ -290,14 +597,46 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
   pkt = netpkt_get(dev, NETPKT_TX);
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev) &&
+      !NETDEV_IS_GSO(dev))
     {
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
     }
   else
     {
-      ret = lower->ops->transmit(lower, pkt);
+#ifdef CONFIG_NETDEV_BATCH
+#  ifdef CONFIG_NETDEV_OFFLOAD
+      /* The offload state of the packet is only kept in dev until the
+       * next packet, so the packet is sent right after the batch.
+       */
+
+      if ((dev->d_offload & NETDEV_OFFLOAD_TXCSUM) != 0 ||
+          dev->d_gso_size > 0)
+        {
+          netdev_upper_txbatch_flush(upper);
+          ret = lower->ops->transmit(lower, pkt);
+        }
+      else
+#  endif
+        {
+          /* Keep polling the stack until the batch is full or the quota
+           * is exhausted, netdev_upper_txbatch_flush() sends the whole
+           * batch.
+           */
+
+          upper->txbatch[upper->ntxbatch++] = pkt;
+          if (upper->ntxbatch < CONFIG_NETDEV_BATCH_SIZE &&
+              netdev_lower_quota_load(lower, NETPKT_TX) > 0)
+            {
+              return 0;
+            }
+
+          return NETDEV_TX_CONTINUE;
+        }
+#else
+      ret = netdev_upper_transmit(upper, pkt);
+#endif
     }
 
   if (ret != OK)
@@ -314,6 +653,71 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
   return NETDEV_TX_CONTINUE;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_txbatch_flush
+ *
+ * Description:
+ *   Give the packets collected by netdev_upper_txpoll() to the lower half,
+ *   the packets that the lower half does not accept are dropped.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *
+ * Returned Value:
+ *   Zero (OK) if all packets are sent, negated errno value otherwise.
+ *
+ * Assumptions:
+ *   Called with the device locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_BATCH
+static int netdev_upper_txbatch_flush(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  int                            n     = upper->ntxbatch;
+  int                            sent  = 0;
+  int                            ret   = OK;
+
+  if (n == 0)
+    {
+      return OK;
+    }
+
+  if (lower->ops->transmit_batch != NULL)
+    {
+      ret = lower->ops->transmit_batch(lower, upper->txbatch, n);
+      if (ret >= 0)
+        {
+          sent = ret;
+          ret  = sent < n ? -EBUSY : OK;
+        }
+    }
+  else
+    {
+      for (; sent < n; sent++)
+        {
+          ret = lower->ops->transmit(lower, upper->txbatch[sent]);
+          if (ret != OK)
+            {
+              break;
+            }
+        }
+    }
+
+  /* Stop sending on any error, like netdev_upper_txpoll() does */
+
+  for (; sent < n; sent++)
+    {
+      NETDEV_TXERRORS(&lower->netdev);
+      netpkt_free(lower, upper->txbatch[sent], NETPKT_TX);
+    }
+
+  upper->ntxbatch = 0;
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_upper_tx
  *
@@ -333,24 +737,76 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NETDEV_BATCH
+static int netdev_upper_tx(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret = OK;
+  int err;
+
+#if CONFIG_IOB_NCHAINS > 0
+  netdev_lock(dev);
+  while (ret == OK && !IOB_QEMPTY(&upper->txq))
+    {
+      /* Put the packet back to the device and add it to the batch */
+
+      netdev_iob_replace(dev, iob_remove_queue(&upper->txq));
+      ret = netdev_upper_txpoll(dev);
+    }
+
+  if (ret != OK)
+    {
+      /* The batch is full (or failed), send it before polling the stack */
+
+      err = netdev_upper_txbatch_flush(upper);
+      netdev_unlock(dev);
+      return err < 0 ? err : ret;
+    }
+
+  netdev_unlock(dev);
+#endif
+
+  /* Fill the rest of the batch from the net stack */
+
+  netdev_upper_stack_lock(dev);
+  ret = devif_poll(dev, netdev_upper_txpoll);
+  netdev_lock(dev);
+  err = netdev_upper_txbatch_flush(upper);
+  netdev_unlock(dev);
+  netdev_upper_stack_unlock(dev);
+  return err < 0 ? err : ret;
+}
+#else
 static int netdev_upper_tx(FAR struct net_driver_s *dev)
 {
 #if CONFIG_IOB_NCHAINS > 0
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+#endif
+  int ret;
 
+#if CONFIG_IOB_NCHAINS > 0
+  netdev_lock(dev);
   if (!IOB_QEMPTY(&upper->txq))
     {
       /* Put the packet back to the device */
 
       netdev_iob_replace(dev, iob_remove_queue(&upper->txq));
-      return netdev_upper_txpoll(dev);
+      ret = netdev_upper_txpoll(dev);
+      netdev_unlock(dev);
+      return ret;
     }
+
+  netdev_unlock(dev);
 #endif
 
   /* No more TX packets in queue, poll the net stack to get more packets */
 
-  return devif_poll(dev, netdev_upper_txpoll);
+  netdev_upper_stack_lock(dev);
+  ret = devif_poll(dev, netdev_upper_txpoll);
+  netdev_upper_stack_unlock(dev);
+  return ret;
 }
+#endif
 
 /****************************************************************************
  * Name: netdev_upper_txavail_work
@@ -414,6 +870,11 @@ static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
   /* Fall back to send the packet directly if we don't have IOB queue. */
 
   netdev_upper_txpoll(dev);
+#  ifdef CONFIG_NETDEV_BATCH
+  netdev_lock(dev);
+  netdev_upper_txbatch_flush(dev->d_private);
+  netdev_unlock(dev);
+#  endif
 #endif
 }
 #endif
@@ -553,133 +1014,526 @@ static void ip_input(FAR struct net_driver_s *dev)
       ninfo("IPv6 frame\n");
       NETDEV_RXIPV6(dev);
 
-      /* Give the IPv6 packet to the network layer */
+      /* Give the IPv6 packet to the network layer */
+
+      ipv6_input(dev);
+    }
+  else
+#endif
+    {
+      ninfo("INFO: Dropped, Unknown type\n");
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+    }
+
+  /* If the above function invocation resulted in data
+   * that should be sent out on the network,
+   * the field d_len will set to a value > 0.
+   */
+
+  if (dev->d_len > 0)
+    {
+      /* And queue the packet for sending later.
+       * Note: RX is tried before TX, so we don't need to call txavail here.
+       */
+
+      netdev_upper_queue_tx(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_input
+ *
+ * Description:
+ *   Pass one received packet into the network stack.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   pkt   - The received packet
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_input(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s       *dev   = &lower->netdev;
+
+  if (!IFF_IS_UP(dev->d_flags))
+    {
+      /* Interface down, drop frame */
+
+      NETDEV_RXDROPPED(dev);
+      netpkt_free(lower, pkt, NETPKT_RX);
+      return;
+    }
+
+  netpkt_put(dev, pkt, NETPKT_RX);
+  NETDEV_RXPACKETS(dev);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+  switch (dev->d_lltype)
+    {
+#ifdef CONFIG_NET_LOOPBACK
+    case NET_LL_LOOPBACK:
+#endif
+#ifdef CONFIG_NET_ETHERNET
+    case NET_LL_ETHERNET:
+#endif
+#ifdef CONFIG_DRIVERS_IEEE80211
+    case NET_LL_IEEE80211:
+#endif
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+      eth_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_MBIM
+    case NET_LL_MBIM:
+      ip_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_CAN
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
+#endif
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
+    }
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  dev->d_offload &= ~NETDEV_OFFLOAD_RXCSUM;
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_upper_input_queue
+ *
+ * Description:
+ *   Pass a packet received by a queue thread into the stack, with the RX
+ *   offload flags reported for this packet by the lower half.
+ *
+ * Assumptions:
+ *   Called without the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static void netdev_upper_input_queue(FAR struct netdev_upperhalf_s *upper,
+                                     FAR netpkt_t *pkt, uint8_t offload)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+
+  net_lock();
+  netdev_lock(dev);
+#ifdef CONFIG_NETDEV_OFFLOAD
+  dev->d_offload = (dev->d_offload & ~NETDEV_OFFLOAD_RXCSUM) |
+                   (offload & NETDEV_OFFLOAD_RXCSUM);
+#else
+  UNUSED(offload);
+#endif
+  netdev_upper_input(upper, pkt);
+  netdev_unlock(dev);
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_steer
+ *
+ * Description:
+ *   Software RSS: queue a packet received on the single RX queue of the
+ *   lower half to the thread chosen by the hash of its flow.
+ *
+ * Returned Value:
+ *   False if the packet belongs to the calling thread (queue 0) and is left
+ *   to the caller, true if it was queued or dropped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_SOFT_RSS
+static bool netdev_upper_steer(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt, uint8_t offload)
+{
+  FAR struct netdev_upper_queue_s *queue;
+  irqstate_t flags;
+  uint16_t next;
+
+  if (upper->nqueues <= 1)
+    {
+      return false;
+    }
+
+  queue = &upper->queue[netdev_upper_flowhash(upper->lower, pkt) %
+                        upper->nqueues];
+  if (queue->qid == 0)
+    {
+      return false;
+    }
+
+  flags = spin_lock_irqsave(&queue->backlock);
+  next  = (queue->head + 1) % CONFIG_NETDEV_SOFT_RSS_BACKLOG;
+  if (next == queue->tail)
+    {
+      spin_unlock_irqrestore(&queue->backlock, flags);
+
+      /* The thread is late, drop the packet like a full RX ring would */
+
+      NETDEV_RXDROPPED(&upper->lower->netdev);
+      netpkt_free(upper->lower, pkt, NETPKT_RX);
+      return true;
+    }
+
+  queue->backlog[queue->head] = pkt;
+  queue->offload[queue->head] = offload;
+  queue->head = next;
+  spin_unlock_irqrestore(&queue->backlock, flags);
+
+  netdev_upper_post(&queue->sem);
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_receive_batch
+ *
+ * Description:
+ *   Receive up to 'n' packets from the lower half.
+ *
+ * Assumptions:
+ *   Called with the device locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_BATCH
+static int netdev_upper_receive_batch(FAR struct netdev_lowerhalf_s *lower,
+                                      FAR netpkt_t **pkts, int n)
+{
+  int i;
+
+  if (lower->ops->receive_batch != NULL)
+    {
+      return lower->ops->receive_batch(lower, pkts, n);
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      pkts[i] = lower->ops->receive(lower);
+      if (pkts[i] == NULL)
+        {
+          break;
+        }
+    }
+
+  return i;
+}
+#endif
+
+/****************************************************************************
+ * Function: netdev_upper_rxpoll_work
+ *
+ * Description:
+ *   Try to receive packets from device and pass packets into IP
+ *   stack and send packets which is from IP stack if necessary.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *
+ * Returned Value:
+ *   True if the RX budget is exhausted and more packets may be pending.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+#ifdef CONFIG_NETDEV_BATCH
+  FAR netpkt_t *pkts[CONFIG_NETDEV_BATCH_SIZE];
+  int budget = CONFIG_NETDEV_RX_BUDGET;
+#ifdef CONFIG_NET_LATENCY
+  clock_t stamp;
+#endif
+  int n;
+  int i;
+
+  /* Receive a batch from the lower half, then pass the whole batch into
+   * the stack with a single lock round trip.
+   */
+
+  while (budget > 0)
+    {
+      netdev_lock(&lower->netdev);
+      n = netdev_upper_receive_batch(lower, pkts,
+                                     MIN(budget, CONFIG_NETDEV_BATCH_SIZE));
+      netdev_unlock(&lower->netdev);
+
+      if (n <= 0)
+        {
+          return false;
+        }
+
+      budget -= n;
+
+#ifdef CONFIG_NET_LATENCY
+      stamp = perf_gettime();
+#endif
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+      /* The lower half can only tell about the last packet of a batch */
+
+      lower->netdev.d_offload &= ~NETDEV_OFFLOAD_RXCSUM;
+#endif
+
+      netdev_upper_stack_lock(&lower->netdev);
+      for (i = 0; i < n; i++)
+        {
+#ifdef CONFIG_NET_LATENCY
+          lower->netdev.d_rxstamp = stamp;
+#endif
+          netdev_upper_input(upper, pkts[i]);
+        }
+
+      netdev_upper_stack_unlock(&lower->netdev);
+    }
+
+  return true;
+#else
+  FAR netpkt_t *pkt;
+#ifdef CONFIG_NETDEV_SOFT_RSS
+  uint8_t offload = 0;
+#elif defined(CONFIG_NET_LATENCY)
+  clock_t stamp;
+#endif
+
+  /* Loop while receive() successfully retrieves valid Ethernet frames. */
+
+  for (; ; )
+    {
+      netdev_lock(&lower->netdev);
+#ifdef CONFIG_NETDEV_OFFLOAD
+      lower->netdev.d_offload &= ~NETDEV_OFFLOAD_RXCSUM;
+#endif
+      pkt = lower->ops->receive(lower);
+#if defined(CONFIG_NETDEV_SOFT_RSS) && defined(CONFIG_NETDEV_OFFLOAD)
+      offload = lower->netdev.d_offload & NETDEV_OFFLOAD_RXCSUM;
+#endif
+      netdev_unlock(&lower->netdev);
+
+      if (pkt == NULL)
+        {
+          return false;
+        }
+
+#ifdef CONFIG_NETDEV_SOFT_RSS
+      if (netdev_upper_steer(upper, pkt, offload))
+        {
+          continue;
+        }
+
+      /* Other queue threads may have used d_offload in between */
+
+      netdev_upper_input_queue(upper, pkt, offload);
+#else
+#  ifdef CONFIG_NET_LATENCY
+      stamp = perf_gettime();
+#  endif
+      netdev_upper_stack_lock(&lower->netdev);
+#  ifdef CONFIG_NET_LATENCY
+      lower->netdev.d_rxstamp = stamp;
+#  endif
+      netdev_upper_input(upper, pkt);
+      netdev_upper_stack_unlock(&lower->netdev);
+#endif
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_upper_work
+ *
+ * Description:
+ *   Perform an out-of-cycle poll on a dedicated thread or the worker thread.
+ *
+ * Input Parameters:
+ *   arg - Reference to the upper half driver structure (cast to void *)
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NETDEV_MULTIQUEUE
+static void netdev_upper_work(FAR void *arg)
+{
+  FAR struct netdev_upperhalf_s *upper = arg;
+  bool more;
 
-      ipv6_input(dev);
-    }
-  else
-#endif
-    {
-      ninfo("INFO: Dropped, Unknown type\n");
-      NETDEV_RXDROPPED(dev);
-      dev->d_len = 0;
-    }
+  /* RX may release quota and driver buffer, so do RX first. */
 
-  /* If the above function invocation resulted in data
-   * that should be sent out on the network,
-   * the field d_len will set to a value > 0.
-   */
+#ifdef CONFIG_NET_LOCK_SPLIT
+  more = netdev_upper_rxpoll_work(upper);
+  netdev_upper_txavail_work(upper);
+#else
+  net_lock();
+  more = netdev_upper_rxpoll_work(upper);
+  netdev_upper_txavail_work(upper);
+  net_unlock();
+#endif
 
-  if (dev->d_len > 0)
+#ifdef CONFIG_NETDEV_BATCH
+  if (more)
     {
-      /* And queue the packet for sending later.
-       * Note: RX is tried before TX, so we don't need to call txavail here.
-       */
+      /* Come back later for the packets left by the RX budget */
 
-      netdev_upper_queue_tx(dev);
+      netdev_upper_queue_work(&upper->lower->netdev);
     }
+#else
+  UNUSED(more);
+#endif
 }
 #endif
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
 /****************************************************************************
- * Function: netdev_upper_rxpoll_work
+ * Name: netdev_upper_rxqueue_work
  *
  * Description:
- *   Try to receive packets from device and pass packets into IP
- *   stack and send packets which is from IP stack if necessary.
- *
- * Input Parameters:
- *   upper - Reference to the upper half driver structure
- *
- * Assumptions:
- *   Called with the network locked.
+ *   Receive the packets of one hardware RX queue and pass them into the
+ *   stack.  The queue is only locked while the lower half handles its ring,
+ *   so the queues fill and refill their rings in parallel.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static void netdev_upper_rxqueue_work(FAR struct netdev_upper_queue_s *queue)
 {
+  FAR struct netdev_upperhalf_s *upper = queue->upper;
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
-  FAR struct net_driver_s       *dev   = &lower->netdev;
-  FAR netpkt_t                  *pkt;
-
-  /* Loop while receive() successfully retrieves valid Ethernet frames. */
+  FAR netpkt_t *pkt;
+  uint8_t offload;
 
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  for (; ; )
     {
-      if (!IFF_IS_UP(dev->d_flags))
-        {
-          /* Interface down, drop frame */
+      offload = 0;
 
-          NETDEV_RXDROPPED(dev);
-          netpkt_free(lower, pkt, NETPKT_RX);
-          continue;
+      nxmutex_lock(&queue->lock);
+      pkt = lower->ops->receive_queue(lower, queue->qid, &offload);
+      nxmutex_unlock(&queue->lock);
+
+      if (pkt == NULL)
+        {
+          return;
         }
 
-      netpkt_put(dev, pkt, NETPKT_RX);
-      NETDEV_RXPACKETS(dev);
+      netdev_upper_input_queue(upper, pkt, offload);
+    }
+}
 
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
+/****************************************************************************
+ * Name: netdev_upper_backlog_work
+ *
+ * Description:
+ *   Pass the packets steered to a queue by the software RSS into the stack.
+ *
+ ****************************************************************************/
 
-      pkt_input(dev);
-#endif
+#ifdef CONFIG_NETDEV_SOFT_RSS
+static void netdev_upper_backlog_work(FAR struct netdev_upper_queue_s *queue)
+{
+  FAR netpkt_t *pkt;
+  irqstate_t flags;
+  uint8_t offload;
 
-      switch (dev->d_lltype)
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&queue->backlock);
+      if (queue->head == queue->tail)
         {
-#ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
-#endif
-#ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
-#endif
-#ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
-#endif
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
-#endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
+          spin_unlock_irqrestore(&queue->backlock, flags);
+          return;
         }
+
+      pkt         = queue->backlog[queue->tail];
+      offload     = queue->offload[queue->tail];
+      queue->tail = (queue->tail + 1) % CONFIG_NETDEV_SOFT_RSS_BACKLOG;
+      spin_unlock_irqrestore(&queue->backlock, flags);
+
+      netdev_upper_input_queue(queue->upper, pkt, offload);
     }
 }
 
 /****************************************************************************
- * Name: netdev_upper_work
+ * Name: netdev_upper_backlog_free
  *
  * Description:
- *   Perform an out-of-cycle poll on a dedicated thread or the worker thread.
+ *   Drop the packets left in the backlog of a queue.
  *
- * Input Parameters:
- *   arg - Reference to the upper half driver structure (cast to void *)
+ ****************************************************************************/
+
+static void netdev_upper_backlog_free(FAR struct netdev_upper_queue_s *queue)
+{
+  while (queue->head != queue->tail)
+    {
+      netpkt_free(queue->upper->lower, queue->backlog[queue->tail],
+                  NETPKT_RX);
+      queue->tail = (queue->tail + 1) % CONFIG_NETDEV_SOFT_RSS_BACKLOG;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_queue_run
+ *
+ * Description:
+ *   The work of one queue thread: its RX queue (or, with a single RX queue,
+ *   the packets steered to it), then the TX poll of the device.
  *
  ****************************************************************************/
 
-static void netdev_upper_work(FAR void *arg)
+static void netdev_upper_queue_run(FAR struct netdev_upper_queue_s *queue)
 {
-  FAR struct netdev_upperhalf_s *upper = arg;
+  FAR struct netdev_upperhalf_s *upper = queue->upper;
 
   /* RX may release quota and driver buffer, so do RX first. */
 
+  if (upper->lower->rxqueues > 1)
+    {
+      if (queue->qid < upper->lower->rxqueues)
+        {
+          netdev_upper_rxqueue_work(queue);
+        }
+    }
+  else if (queue->qid == 0)
+    {
+      net_lock();
+      netdev_upper_rxpoll_work(upper);
+      net_unlock();
+    }
+
+#ifdef CONFIG_NETDEV_SOFT_RSS
+  netdev_upper_backlog_work(queue);
+#endif
+
+#ifdef CONFIG_NET_LOCK_SPLIT
+  netdev_upper_txavail_work(upper);
+#else
   net_lock();
-  netdev_upper_rxpoll_work(upper);
   netdev_upper_txavail_work(upper);
   net_unlock();
+#endif
 }
+#endif
 
 /****************************************************************************
  * Name: netdev_upper_wait
@@ -702,6 +1556,24 @@ static int netdev_upper_wait(FAR sem_t *sem)
 #endif
 }
 
+/****************************************************************************
+ * Name: netdev_upper_post
+ *
+ * Description:
+ *   Wake up a dedicated thread, if it is not already going to run.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_post(FAR sem_t *sem)
+{
+  int semcount;
+
+  if (nxsem_get_value(sem, &semcount) == OK && semcount <= 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
 /****************************************************************************
  * Name: netdev_upper_loop
  *
@@ -710,6 +1582,7 @@ static int netdev_upper_wait(FAR sem_t *sem)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NETDEV_MULTIQUEUE
 static int netdev_upper_loop(int argc, FAR char *argv[])
 {
   FAR struct netdev_upperhalf_s *upper =
@@ -736,6 +1609,43 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
 }
 #endif
 
+/****************************************************************************
+ * Name: netdev_upper_queue_loop
+ *
+ * Description:
+ *   The loop for the dedicated thread of a queue, pinned to a CPU so that
+ *   the packets of a queue, and so of a flow, stay on one CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int netdev_upper_queue_loop(int argc, FAR char *argv[])
+{
+  FAR struct netdev_upper_queue_s *queue =
+    (FAR struct netdev_upper_queue_s *)
+    ((uintptr_t)strtoul(argv[1], NULL, 16));
+
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+
+  CPU_ZERO(&cpuset);
+  CPU_SET(queue->qid % CONFIG_SMP_NCPUS, &cpuset);
+  sched_setaffinity(0, sizeof(cpu_set_t), &cpuset);
+#endif
+
+  while (netdev_upper_wait(&queue->sem) == OK &&
+         queue->tid != INVALID_PROCESS_ID)
+    {
+      netdev_upper_queue_run(queue);
+    }
+
+  nwarn("WARNING: Netdev queue thread quitting.");
+  nxsem_post(&queue->sem_exit);
+  return 0;
+}
+#endif
+#endif
+
 /****************************************************************************
  * Name: netdev_upper_queue_work
  *
@@ -751,15 +1661,12 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
 
-#ifdef CONFIG_NETDEV_WORK_THREAD
-  int cpu = this_cpu();
-  int semcount;
+#if defined(CONFIG_NETDEV_MULTIQUEUE)
+  /* Poll from the queue thread of this CPU */
 
-  if (nxsem_get_value(&upper->sem[cpu], &semcount) == OK &&
-      semcount <= 0)
-    {
-      nxsem_post(&upper->sem[cpu]);
-    }
+  netdev_upper_post(&upper->queue[this_cpu() % upper->nqueues].sem);
+#elif defined(CONFIG_NETDEV_WORK_THREAD)
+  netdev_upper_post(&upper->sem[this_cpu()]);
 #else
   if (work_available(&upper->work))
     {
@@ -1030,6 +1937,40 @@ int netdev_upper_wireless_ioctl(FAR struct netdev_lowerhalf_s *lower,
 }
 #endif  /* CONFIG_NETDEV_WIRELESS_HANDLER */
 
+/****************************************************************************
+ * Name: netdev_upper_lock_queues/unlock_queues
+ *
+ * Description:
+ *   Lock all the queues of the device, for the operations of the lower half
+ *   that change all the rings.  Called with the device locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static void netdev_upper_lock_queues(FAR struct netdev_upperhalf_s *upper)
+{
+  int i;
+
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      nxmutex_lock(&upper->queue[i].lock);
+    }
+}
+
+static void netdev_upper_unlock_queues(FAR struct netdev_upperhalf_s *upper)
+{
+  int i;
+
+  for (i = upper->nqueues - 1; i >= 0; i--)
+    {
+      nxmutex_unlock(&upper->queue[i].lock);
+    }
+}
+#else
+#  define netdev_upper_lock_queues(upper)
+#  define netdev_upper_unlock_queues(upper)
+#endif
+
 /****************************************************************************
  * Name: netdev_upper_ifup/ifdown/addmac/rmmac/ioctl
  *
@@ -1042,7 +1983,39 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
 
-#ifdef CONFIG_NETDEV_WORK_THREAD
+#if defined(CONFIG_NETDEV_MULTIQUEUE)
+  int i;
+
+  /* Try to bring up a dedicated thread for each queue. */
+
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      FAR struct netdev_upper_queue_s *queue = &upper->queue[i];
+
+      if (queue->tid <= 0)
+        {
+          FAR char *argv[2];
+          char      arg1[32];
+          char      name[32];
+
+          snprintf(arg1, sizeof(arg1), "%p", queue);
+          argv[0] = arg1;
+          argv[1] = NULL;
+
+          snprintf(name, sizeof(name), NETDEV_QUEUE_NAME_FMT,
+                   dev->d_ifname, i);
+
+          queue->tid = kthread_create(name,
+                                      CONFIG_NETDEV_WORK_THREAD_PRIORITY,
+                                      CONFIG_DEFAULT_TASK_STACKSIZE,
+                                      netdev_upper_queue_loop, argv);
+          if (queue->tid < 0)
+            {
+              return queue->tid;
+            }
+        }
+    }
+#elif defined(CONFIG_NETDEV_WORK_THREAD)
   int i;
 
   /* Try to bring up a dedicated thread for work. */
@@ -1080,7 +2053,14 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 
   if (upper->lower->ops->ifup)
     {
-      return upper->lower->ops->ifup(upper->lower);
+      int ret;
+
+      netdev_lock(dev);
+      netdev_upper_lock_queues(upper);
+      ret = upper->lower->ops->ifup(upper->lower);
+      netdev_upper_unlock_queues(upper);
+      netdev_unlock(dev);
+      return ret;
     }
 
   return -ENOSYS;
@@ -1096,7 +2076,14 @@ static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
 
   if (upper->lower->ops->ifdown)
     {
-      return upper->lower->ops->ifdown(upper->lower);
+      int ret;
+
+      netdev_lock(dev);
+      netdev_upper_lock_queues(upper);
+      ret = upper->lower->ops->ifdown(upper->lower);
+      netdev_upper_unlock_queues(upper);
+      netdev_unlock(dev);
+      return ret;
     }
 
   return -ENOSYS;
@@ -1152,7 +2139,14 @@ static int netdev_upper_ioctl(FAR struct net_driver_s *dev, int cmd,
 
   if (lower->ops->ioctl)
     {
-      return lower->ops->ioctl(lower, cmd, arg);
+      int ret;
+
+      netdev_lock(dev);
+      netdev_upper_lock_queues(upper);
+      ret = lower->ops->ioctl(lower, cmd, arg);
+      netdev_upper_unlock_queues(upper);
+      netdev_unlock(dev);
+      return ret;
     }
 
   return -ENOTTY;
@@ -1195,11 +2189,50 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
       return -EINVAL;
     }
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (dev->rxqueues > CONFIG_NETDEV_MAX_QUEUES ||
+      dev->txqueues > CONFIG_NETDEV_MAX_QUEUES ||
+      (dev->rxqueues > 1 && dev->ops->receive_queue == NULL) ||
+      (dev->txqueues > 1 && dev->ops->transmit_queue == NULL))
+    {
+      return -EINVAL;
+    }
+#endif
+
   if ((upper = netdev_upper_alloc(dev)) == NULL)
     {
       return -ENOMEM;
     }
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* One thread per hardware queue, or per CPU for the software RSS of a
+   * single RX queue.
+   */
+
+  upper->nqueues = MAX(MAX(dev->rxqueues, dev->txqueues), 1);
+#ifdef CONFIG_NETDEV_SOFT_RSS
+  if (dev->rxqueues <= 1)
+    {
+      upper->nqueues = MAX(upper->nqueues, NETDEV_RSS_QUEUES);
+    }
+#endif
+
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      FAR struct netdev_upper_queue_s *queue = &upper->queue[i];
+
+      queue->upper = upper;
+      queue->qid   = i;
+      queue->tid   = INVALID_PROCESS_ID;
+      nxsem_init(&queue->sem, 0, 0);
+      nxsem_init(&queue->sem_exit, 0, 0);
+      nxmutex_init(&queue->lock);
+#ifdef CONFIG_NETDEV_SOFT_RSS
+      spin_lock_init(&queue->backlock);
+#endif
+    }
+#endif
+
   dev->netdev.d_ifup    = netdev_upper_ifup;
   dev->netdev.d_ifdown  = netdev_upper_ifdown;
   dev->netdev.d_txavail = netdev_upper_txavail;
@@ -1219,7 +2252,7 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
       dev->netdev.d_private = NULL;
     }
 
-#ifdef CONFIG_NETDEV_WORK_THREAD
+#if defined(CONFIG_NETDEV_WORK_THREAD) && !defined(CONFIG_NETDEV_MULTIQUEUE)
   for (i = 0; i < NETDEV_THREAD_COUNT; i++)
     {
       upper->tid[i] = INVALID_PROCESS_ID;
@@ -1265,7 +2298,28 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
       return ret;
     }
 
-#ifdef CONFIG_NETDEV_WORK_THREAD
+#if defined(CONFIG_NETDEV_MULTIQUEUE)
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      FAR struct netdev_upper_queue_s *queue = &upper->queue[i];
+
+      if (queue->tid > 0)
+        {
+          /* Try to tear down the dedicated thread of the queue. */
+
+          queue->tid = INVALID_PROCESS_ID;
+          nxsem_post(&queue->sem);
+          nxsem_wait(&queue->sem_exit);
+        }
+
+#ifdef CONFIG_NETDEV_SOFT_RSS
+      netdev_upper_backlog_free(queue);
+#endif
+      nxsem_destroy(&queue->sem);
+      nxsem_destroy(&queue->sem_exit);
+      nxmutex_destroy(&queue->lock);
+    }
+#elif defined(CONFIG_NETDEV_WORK_THREAD)
   for (i = 0; i < NETDEV_THREAD_COUNT; i++)
     {
       if (upper->tid[i] > 0)
@@ -1340,8 +2394,20 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev)
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 {
 #if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Without a queue given, wake up all the RX queues */
+
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+  int qid;
+
+  for (qid = 0; qid < MAX(dev->rxqueues, 1); qid++)
+    {
+      netdev_upper_post(&upper->queue[qid].sem);
+    }
+#else
   netdev_upper_queue_work(&dev->netdev);
 #endif
+#endif
 }
 
 /****************************************************************************
@@ -1363,6 +2429,43 @@ void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
 #endif
 }
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue/txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet ready to read, or a TX
+ *   packet sent, on the hardware queue 'qid'.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   qid - The queue index
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int qid)
+{
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  netdev_upper_post(&upper->queue[qid % upper->nqueues].sem);
+#endif
+}
+
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev, int qid)
+{
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+#endif
+
+  NETDEV_TXDONE(&dev->netdev);
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+  netdev_upper_post(&upper->queue[qid % upper->nqueues].sem);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
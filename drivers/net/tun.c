@@ -66,6 +66,7 @@
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ethernet.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/net/tun.h>
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TUN)
@@ -101,6 +102,32 @@
 #  define CONFIG_TUN_NINTERFACES 1
 #endif
 
+#ifndef CONFIG_NET_TUN_NQUEUES
+#  define CONFIG_NET_TUN_NQUEUES 1
+#endif
+
+#ifndef CONFIG_NET_TUN_QUEUELEN
+#  define CONFIG_NET_TUN_QUEUELEN 1
+#endif
+
+/* Each queue holds up to CONFIG_NET_TUN_QUEUELEN packets polled from the
+ * network and as many replies to written packets.
+ */
+
+#define TUN_RINGSIZE      (2 * CONFIG_NET_TUN_QUEUELEN)
+
+/* TUNSETIFF flags that are kept per interface */
+
+#define TUN_IFF_FEATURES  (IFF_MULTI_QUEUE | IFF_VNET_HDR | IFF_BATCH)
+
+/* Size of the headers before each packet read or written */
+
+#define TUN_HDRLEN(priv) \
+  ((((priv)->flags & IFF_BATCH) != 0 ? \
+    sizeof(struct tun_batch_hdr_s) : 0) + \
+   (((priv)->flags & IFF_VNET_HDR) != 0 ? \
+    sizeof(struct tun_vnet_hdr_s) : 0))
+
 /* This is a helper pointer for accessing the contents of the Ethernet
  * header.
  */
@@ -113,6 +140,39 @@
  * Private Types
  ****************************************************************************/
 
+/* A packet waiting to be read, either polled from the network or sent by
+ * the network in reply to a written packet.
+ */
+
+struct tun_pkt_s
+{
+  FAR struct iob_s *buf;
+  uint16_t          len;
+  bool              reply;     /* true: reply to a written packet */
+#ifdef CONFIG_NETDEV_OFFLOAD
+  struct tun_vnet_hdr_s vhdr;  /* Offload state of the packet */
+#endif
+};
+
+/* The tun_queue_s holds the state of one file descriptor attached to an
+ * interface.  There is more than one only with IFF_MULTI_QUEUE.
+ */
+
+struct tun_queue_s
+{
+  FAR struct tun_device_s *priv; /* The interface, NULL if detached */
+  bool              read_wait;
+  bool              write_wait;
+  FAR struct pollfd *poll_fds;
+  sem_t             read_wait_sem;
+  sem_t             write_wait_sem;
+  uint8_t           head;      /* Index of the oldest packet in pkts[] */
+  uint8_t           npkts;     /* Number of packets in pkts[] */
+  uint8_t           npolled;   /* Of which polled from the network */
+  uint8_t           nreplies;  /* Of which replies to written packets */
+  struct tun_pkt_s  pkts[TUN_RINGSIZE];
+};
+
 /* The tun_device_s encapsulates all state information for a single hardware
  * interface
  */
@@ -120,22 +180,15 @@
 struct tun_device_s
 {
   bool              bifup;     /* true:ifup false:ifdown */
-  bool              read_wait;
-  bool              write_wait;
+  uint8_t           nqueues;   /* Number of queues in active[] */
+  uint32_t          flags;     /* See TUN_IFF_FEATURES */
   struct work_s     work;      /* For deferring poll work to the work queue */
-  FAR struct pollfd *poll_fds;
   mutex_t           lock;
-  sem_t             read_wait_sem;
-  sem_t             write_wait_sem;
-  size_t            read_d_len;
-  size_t            write_d_len;
 
-  /* These packet buffer arrays required 16-bit alignment.  That alignment
-   * is assured only by the preceding wide data types.
-   */
+  /* The attached queues, active[] is in attach order and compact */
 
-  FAR struct iob_s *read_buf;
-  FAR struct iob_s *write_buf;
+  FAR struct tun_queue_s *active[CONFIG_NET_TUN_NQUEUES];
+  struct tun_queue_s queues[CONFIG_NET_TUN_NQUEUES];
 
   /* This holds the information visible to the NuttX network */
 
@@ -154,20 +207,18 @@ struct tun_driver_s
 
 /* Common TX logic */
 
-static void tun_fd_transmit(FAR struct tun_device_s *priv);
+static bool tun_txready(FAR struct tun_device_s *priv);
+static FAR struct tun_queue_s *tun_txqueue(FAR struct tun_device_s *priv);
+static void tun_fd_transmit(FAR struct tun_queue_s *queue, bool reply);
 static int  tun_txpoll(FAR struct net_driver_s *dev);
-#ifdef CONFIG_NET_ETHERNET
-static int  tun_txpoll_tap(FAR struct net_driver_s *dev);
-#endif
-static int  tun_txpoll_tun(FAR struct net_driver_s *dev);
 
 /* Interrupt handling */
 
-static void tun_net_receive(FAR struct tun_device_s *priv);
+static void tun_net_receive(FAR struct tun_queue_s *queue);
 #ifdef CONFIG_NET_ETHERNET
-static void tun_net_receive_tap(FAR struct tun_device_s *priv);
+static void tun_net_receive_tap(FAR struct tun_queue_s *queue);
 #endif
-static void tun_net_receive_tun(FAR struct tun_device_s *priv);
+static void tun_net_receive_tun(FAR struct tun_queue_s *queue);
 
 static void tun_txdone(FAR struct tun_device_s *priv);
 
@@ -181,9 +232,15 @@ static int tun_addmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
 static int tun_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
 #endif
 
+static int tun_queue_attach(FAR struct tun_device_s *priv,
+                            FAR struct file *filep);
+static void tun_queue_detach(FAR struct tun_queue_s *queue);
 static int tun_dev_init(FAR struct tun_device_s *priv,
                         FAR struct file *filep,
-                        FAR const char *devfmt, bool tun);
+                        FAR const char *devfmt, uint32_t flags);
+static int tun_dev_attach(FAR struct tun_driver_s *tun,
+                          FAR struct file *filep,
+                          FAR const struct ifreq *ifr);
 static void tun_dev_uninit(FAR struct tun_device_s *priv);
 
 /* File interface */
@@ -229,148 +286,235 @@ static const struct file_operations g_tun_file_ops =
  * Name: tun_pollnotify
  ****************************************************************************/
 
-static void tun_pollnotify(FAR struct tun_device_s *priv,
+static void tun_pollnotify(FAR struct tun_queue_s *queue,
                            pollevent_t eventset)
 {
-  FAR struct pollfd *fds = priv->poll_fds;
+  FAR struct pollfd *fds = queue->poll_fds;
 
-  if (priv->read_wait && (eventset & POLLIN))
+  if (queue->read_wait && (eventset & POLLIN))
     {
-      priv->read_wait = false;
-      nxsem_post(&priv->read_wait_sem);
+      queue->read_wait = false;
+      nxsem_post(&queue->read_wait_sem);
     }
 
-  if (priv->write_wait && (eventset & POLLOUT))
+  if (queue->write_wait && (eventset & POLLOUT))
     {
-      priv->write_wait = false;
-      nxsem_post(&priv->write_wait_sem);
+      queue->write_wait = false;
+      nxsem_post(&queue->write_wait_sem);
     }
 
   poll_notify(&fds, 1, eventset);
 }
 
 /****************************************************************************
- * Name: tun_fd_transmit
+ * Name: tun_txready
  *
  * Description:
- *   Start hardware transmission.  Called either from the txdone interrupt
- *   handling or from watchdog based polling.
- *
- * Input Parameters:
- *   priv - Reference to the driver state structure
- *
- * Returned Value:
- *   None
- *
- * Assumptions:
- *   May or may not be called from an interrupt handler.  In either case,
- *   global interrupts are disabled, either explicitly or indirectly through
- *   interrupt handling logic.
+ *   Check if every attached queue has room for another packet polled from
+ *   the network.  The packet is only hashed to its queue once it is built,
+ *   so all of them must have room.
  *
  ****************************************************************************/
 
-static void tun_fd_transmit(FAR struct tun_device_s *priv)
+static bool tun_txready(FAR struct tun_device_s *priv)
 {
-  tun_pollnotify(priv, POLLIN);
+  int i;
+
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      if (priv->active[i]->npolled >= CONFIG_NET_TUN_QUEUELEN)
+        {
+          return false;
+        }
+    }
+
+  return priv->nqueues > 0;
 }
 
 /****************************************************************************
- * Name: tun_txpoll
+ * Name: tun_flowhash
  *
  * Description:
- *   The transmitter is available, check if the network has any outgoing
- *   packets ready to send.  This is a callback from devif_poll().
- *   devif_poll() may be called:
- *
- *   1. When the preceding TX packet send is complete,
- *   2. When the preceding TX packet send timesout and the interface is reset
- *   3. During normal TX polling
- *
- * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
- *
- * Returned Value:
- *   OK on success; a negated errno on failure
- *
- * Assumptions:
- *   May or may not be called from an interrupt handler.  In either case,
- *   global interrupts are disabled, either explicitly or indirectly through
- *   interrupt handling logic.
+ *   Hash the addresses and the ports of the packet in d_iob, non IP packets
+ *   all hash to zero.
  *
  ****************************************************************************/
 
-static int tun_txpoll(FAR struct net_driver_s *dev)
+static uint32_t tun_flowhash(FAR struct net_driver_s *dev)
 {
-  FAR struct tun_device_s *priv = (FAR struct tun_device_s *)dev->d_private;
-  int ret;
-
-  DEBUGASSERT(priv->read_buf == NULL);
+  FAR const uint16_t *words;
+  uint32_t hash = 2166136261u;
+  uint16_t iplen;
+  uint8_t proto;
+  int nwords;
+  int i;
 
-  NETDEV_TXPACKETS(dev);
-#ifdef CONFIG_NET_PKT
-  /* When packet sockets are enabled, feed the frame into the tap */
-
-  pkt_input(dev);
+#ifdef CONFIG_NET_ETHERNET
+  if (dev->d_lltype == NET_LL_ETHERNET &&
+      ETHBUF->type != HTONS(ETHTYPE_IP) &&
+      ETHBUF->type != HTONS(ETHTYPE_IP6))
+    {
+      return 0;
+    }
 #endif
 
-  priv->read_d_len = dev->d_len;
-  priv->read_buf   = dev->d_iob;
-  netdev_iob_clear(dev);
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      words  = IPv4BUF->srcipaddr;
+      nwords = 4;
+      proto  = IPv4BUF->proto;
+      iplen  = (IPv4BUF->vhl & IPv4_HLMASK) << 2;
 
-#ifdef CONFIG_NET_ETHERNET
-  if (dev->d_lltype == NET_LL_ETHERNET)
+      /* Only the first fragment has the ports */
+
+      if ((IPv4BUF->ipoffset[0] &
+           ((IP_FLAG_MOREFRAGS | 0x1fff) >> 8)) != 0 ||
+          IPv4BUF->ipoffset[1] != 0)
+        {
+          proto = 0;
+        }
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
     {
-      ret = tun_txpoll_tap(dev);
+      words  = IPv6BUF->srcipaddr;
+      nwords = 16;
+      proto  = IPv6BUF->proto;
+      iplen  = IPv6_HDRLEN;
     }
   else
 #endif
     {
-      ret = tun_txpoll_tun(dev);
+      return 0;
     }
 
-  return ret;
+  /* The source and destination addresses follow each other */
+
+  for (i = 0; i < nwords; i++)
+    {
+      hash = (hash ^ words[i]) * 16777619u;
+    }
+
+  if ((proto == IP_PROTO_TCP || proto == IP_PROTO_UDP) &&
+      iplen + 2 * sizeof(uint16_t) <= dev->d_iob->io_len)
+    {
+      words = (FAR const uint16_t *)IPBUF(iplen);
+      hash  = (hash ^ words[0]) * 16777619u;
+      hash  = (hash ^ words[1]) * 16777619u;
+    }
+
+  return hash ^ (hash >> 16);
 }
 
 /****************************************************************************
- * Name: tun_txpoll_tap : for tap (ethernet bridge) mode
+ * Name: tun_txqueue
  *
  * Description:
- *   The transmitter is available, check if the network has any outgoing
- *   packets ready to send.  This is a callback from devif_poll().
- *   devif_poll() may be called:
+ *   Select the queue of the flow of the packet in d_iob.
  *
- *   1. When the preceding TX packet send is complete,
- *   2. When the preceding TX packet send timesout and the interface is reset
- *   3. During normal TX polling
+ ****************************************************************************/
+
+static FAR struct tun_queue_s *tun_txqueue(FAR struct tun_device_s *priv)
+{
+  if (priv->nqueues == 1)
+    {
+      return priv->active[0];
+    }
+
+  return priv->active[tun_flowhash(&priv->dev) % priv->nqueues];
+}
+
+/****************************************************************************
+ * Name: tun_vnet_txhdr
+ *
+ * Description:
+ *   Describe the checksum and segmentation left to the reader of the
+ *   packet in d_iob.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+static void tun_vnet_txhdr(FAR struct net_driver_s *dev,
+                           FAR struct tun_vnet_hdr_s *vhdr)
+{
+  FAR struct tcp_hdr_s *tcp;
+
+  memset(vhdr, 0, sizeof(*vhdr));
+  if ((dev->d_offload & NETDEV_OFFLOAD_TXCSUM) == 0)
+    {
+      return;
+    }
+
+  vhdr->flags       = TUN_VNET_HDR_F_NEEDS_CSUM;
+  vhdr->csum_start  = NET_LL_HDRLEN(dev) + dev->d_csum_start;
+  vhdr->csum_offset = dev->d_csum_offset;
+
+  if (NETDEV_IS_GSO(dev))
+    {
+      tcp = (FAR struct tcp_hdr_s *)IPBUF(dev->d_csum_start);
+
+      vhdr->gso_type = IFF_IS_IPv6(dev->d_flags) ?
+                       TUN_VNET_HDR_GSO_TCPV6 : TUN_VNET_HDR_GSO_TCPV4;
+      vhdr->gso_size = dev->d_gso_size;
+      vhdr->hdr_len  = vhdr->csum_start + ((tcp->tcpoffset >> 4) << 2);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tun_fd_transmit
+ *
+ * Description:
+ *   Start hardware transmission: queue the packet in d_iob to be read from
+ *   the file descriptor of the queue.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
+ *   queue - Reference to the queue that the packet is read from
+ *   reply - true if the packet is a reply to a written packet
  *
  * Returned Value:
- *   OK on success; a negated errno on failure
+ *   None
  *
  * Assumptions:
- *   May or may not be called from an interrupt handler.  In either case,
- *   global interrupts are disabled, either explicitly or indirectly through
- *   interrupt handling logic.
+ *   The network and the device are locked and the queue has room for the
+ *   packet.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_ETHERNET
-static int tun_txpoll_tap(FAR struct net_driver_s *dev)
+static void tun_fd_transmit(FAR struct tun_queue_s *queue, bool reply)
 {
-  FAR struct tun_device_s *priv = (FAR struct tun_device_s *)dev->d_private;
+  FAR struct net_driver_s *dev = &queue->priv->dev;
+  FAR struct tun_pkt_s *pkt;
 
-  /* Send the packet */
+  DEBUGASSERT(queue->npkts < TUN_RINGSIZE);
 
-  tun_fd_transmit(priv);
+  pkt        = &queue->pkts[(queue->head + queue->npkts) % TUN_RINGSIZE];
+  pkt->buf   = dev->d_iob;
+  pkt->len   = dev->d_len;
+  pkt->reply = reply;
+#ifdef CONFIG_NETDEV_OFFLOAD
+  tun_vnet_txhdr(dev, &pkt->vhdr);
+#endif
+  netdev_iob_clear(dev);
 
-  return 1;
+  queue->npkts++;
+  if (reply)
+    {
+      queue->nreplies++;
+    }
+  else
+    {
+      queue->npolled++;
+    }
+
+  tun_pollnotify(queue, POLLIN);
 }
-#endif
 
 /****************************************************************************
- * Name: tun_txpoll_tun : for tun (IP tunneling) mode
+ * Name: tun_txpoll
  *
  * Description:
  *   The transmitter is available, check if the network has any outgoing
@@ -394,13 +538,24 @@ static int tun_txpoll_tap(FAR struct net_driver_s *dev)
  *
  ****************************************************************************/
 
-static int tun_txpoll_tun(FAR struct net_driver_s *dev)
+static int tun_txpoll(FAR struct net_driver_s *dev)
 {
   FAR struct tun_device_s *priv = (FAR struct tun_device_s *)dev->d_private;
 
-  tun_fd_transmit(priv);
+  NETDEV_TXPACKETS(dev);
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+  /* Send the packet to the queue of its flow, and keep polling while all
+   * the queues have room.
+   */
+
+  tun_fd_transmit(tun_txqueue(priv), false);
 
-  return 1;
+  return tun_txready(priv) ? 0 : 1;
 }
 
 /****************************************************************************
@@ -411,7 +566,7 @@ static int tun_txpoll_tun(FAR struct net_driver_s *dev)
  *   packet
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   queue - Reference to the queue that the packet was written to
  *
  * Returned Value:
  *   None
@@ -421,17 +576,17 @@ static int tun_txpoll_tun(FAR struct net_driver_s *dev)
  *
  ****************************************************************************/
 
-static void tun_net_receive(FAR struct tun_device_s *priv)
+static void tun_net_receive(FAR struct tun_queue_s *queue)
 {
 #ifdef CONFIG_NET_ETHERNET
-  if (priv->dev.d_lltype == NET_LL_ETHERNET)
+  if (queue->priv->dev.d_lltype == NET_LL_ETHERNET)
     {
-      tun_net_receive_tap(priv);
+      tun_net_receive_tap(queue);
     }
   else
 #endif
     {
-      tun_net_receive_tun(priv);
+      tun_net_receive_tun(queue);
     }
 }
 
@@ -442,7 +597,7 @@ static void tun_net_receive(FAR struct tun_device_s *priv)
  *   An interrupt was received indicating the availability of a new RX packet
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   queue - Reference to the queue that the packet was written to
  *
  * Returned Value:
  *   None
@@ -453,8 +608,9 @@ static void tun_net_receive(FAR struct tun_device_s *priv)
  ****************************************************************************/
 
 #ifdef CONFIG_NET_ETHERNET
-static void tun_net_receive_tap(FAR struct tun_device_s *priv)
+static void tun_net_receive_tap(FAR struct tun_queue_s *queue)
 {
+  FAR struct tun_device_s *priv = queue->priv;
   FAR struct net_driver_s *dev = &priv->dev;
 
   /* Copy the data data from the hardware to priv->dev.d_buf.  Set amount of
@@ -516,11 +672,7 @@ static void tun_net_receive_tap(FAR struct tun_device_s *priv)
     {
       /* And send the packet */
 
-      DEBUGASSERT(priv->write_buf == NULL);
-      priv->write_d_len = priv->dev.d_len;
-      priv->write_buf   = priv->dev.d_iob;
-      netdev_iob_clear(&priv->dev);
-      tun_fd_transmit(priv);
+      tun_fd_transmit(queue, true);
     }
 }
 #endif
@@ -533,7 +685,7 @@ static void tun_net_receive_tap(FAR struct tun_device_s *priv)
  *   packet
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   queue - Reference to the queue that the packet was written to
  *
  * Returned Value:
  *   None
@@ -543,9 +695,9 @@ static void tun_net_receive_tap(FAR struct tun_device_s *priv)
  *
  ****************************************************************************/
 
-static void tun_net_receive_tun(FAR struct tun_device_s *priv)
+static void tun_net_receive_tun(FAR struct tun_queue_s *queue)
 {
-  FAR struct net_driver_s *dev = &priv->dev;
+  FAR struct net_driver_s *dev = &queue->priv->dev;
 
   /* Copy the data data from the hardware to dev->d_buf.  Set amount of
    * data in dev->d_len
@@ -596,11 +748,7 @@ static void tun_net_receive_tun(FAR struct tun_device_s *priv)
 
   if (dev->d_len > 0)
     {
-      DEBUGASSERT(priv->write_buf == NULL);
-      priv->write_d_len = dev->d_len;
-      priv->write_buf   = dev->d_iob;
-      netdev_iob_clear(dev);
-      tun_fd_transmit(priv);
+      tun_fd_transmit(queue, true);
     }
 }
 
@@ -623,13 +771,12 @@ static void tun_net_receive_tun(FAR struct tun_device_s *priv)
 
 static void tun_txdone(FAR struct tun_device_s *priv)
 {
-  /* Check for errors and update statistics */
-
-  NETDEV_TXDONE(&priv->dev);
+  /* Then poll the network for new XMIT data, if all the queues have room */
 
-  /* Then poll the network for new XMIT data */
-
-  devif_poll(&priv->dev, tun_txpoll);
+  if (tun_txready(priv))
+    {
+      devif_poll(&priv->dev, tun_txpoll);
+    }
 }
 
 /****************************************************************************
@@ -737,7 +884,7 @@ static void tun_txavail_work(FAR void *arg)
 
   /* Check if there is room to hold another network packet. */
 
-  if (priv->read_d_len != 0)
+  if (!tun_txready(priv))
     {
       nxmutex_unlock(&priv->lock);
       return;
@@ -849,6 +996,78 @@ static int tun_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac)
 }
 #endif
 
+/****************************************************************************
+ * Name: tun_queue_attach
+ *
+ * Description:
+ *   Attach a new queue of the interface to the file.
+ *
+ * Returned Value:
+ *   OK on success; -EBUSY if all the queues are in use.
+ *
+ * Assumptions:
+ *   The device is locked, or not yet registered.
+ *
+ ****************************************************************************/
+
+static int tun_queue_attach(FAR struct tun_device_s *priv,
+                            FAR struct file *filep)
+{
+  FAR struct tun_queue_s *queue;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_TUN_NQUEUES; i++)
+    {
+      queue = &priv->queues[i];
+      if (queue->priv == NULL)
+        {
+          memset(queue, 0, sizeof(struct tun_queue_s));
+          queue->priv = priv;
+          nxsem_init(&queue->read_wait_sem, 0, 0);
+          nxsem_init(&queue->write_wait_sem, 0, 0);
+
+          priv->active[priv->nqueues++] = queue;
+          filep->f_priv = queue; /* Set link to TUN queue */
+          return OK;
+        }
+    }
+
+  return -EBUSY;
+}
+
+/****************************************************************************
+ * Name: tun_queue_detach
+ *
+ * Description:
+ *   Detach the queue from its interface and drop the packets not read.
+ *
+ * Assumptions:
+ *   The device is locked.
+ *
+ ****************************************************************************/
+
+static void tun_queue_detach(FAR struct tun_queue_s *queue)
+{
+  FAR struct tun_device_s *priv = queue->priv;
+  int i;
+
+  while (queue->npkts > 0)
+    {
+      iob_free_chain(queue->pkts[queue->head].buf);
+      queue->head = (queue->head + 1) % TUN_RINGSIZE;
+      queue->npkts--;
+    }
+
+  /* Keep active[] compact, the flows of the last queue move */
+
+  for (i = 0; priv->active[i] != queue; i++);
+  priv->active[i] = priv->active[--priv->nqueues];
+
+  nxsem_destroy(&queue->read_wait_sem);
+  nxsem_destroy(&queue->write_wait_sem);
+  queue->priv = NULL;
+}
+
 /****************************************************************************
  * Name: tun_dev_init
  *
@@ -866,13 +1085,14 @@ static int tun_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac)
 
 static int tun_dev_init(FAR struct tun_device_s *priv,
                         FAR struct file *filep,
-                        FAR const char *devfmt, bool tun)
+                        FAR const char *devfmt, uint32_t flags)
 {
   int ret;
 
   /* Initialize the driver structure */
 
   memset(priv, 0, sizeof(struct tun_device_s));
+  priv->flags         = flags & TUN_IFF_FEATURES;
   priv->dev.d_ifup    = tun_ifup;     /* I/F up (new IP address) callback */
   priv->dev.d_ifdown  = tun_ifdown;   /* I/F down callback */
   priv->dev.d_txavail = tun_txavail;  /* New TX data callback */
@@ -882,11 +1102,21 @@ static int tun_dev_init(FAR struct tun_device_s *priv,
 #endif
   priv->dev.d_private = priv;         /* Used to recover private state from dev */
 
-  /* Initialize the mutual exlcusion and wait semaphore */
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* With the virtio net header, checksums and TCP segmentation are left to
+   * the reader, that also reports the checksums that it verified.
+   */
+
+  if ((flags & IFF_VNET_HDR) != 0)
+    {
+      priv->dev.d_features = NETDEV_FEATURE_TXCSUM | NETDEV_FEATURE_RXCSUM |
+                             NETDEV_FEATURE_TSO4 | NETDEV_FEATURE_TSO6;
+    }
+#endif
+
+  /* Initialize the mutual exlcusion */
 
   nxmutex_init(&priv->lock);
-  nxsem_init(&priv->read_wait_sem, 0, 0);
-  nxsem_init(&priv->write_wait_sem, 0, 0);
 
   /* Assign d_ifname if specified. */
 
@@ -897,17 +1127,72 @@ static int tun_dev_init(FAR struct tun_device_s *priv,
 
   /* Register the device with the OS so that socket IOCTLs can be performed */
 
-  ret = netdev_register(&priv->dev, tun ? NET_LL_TUN : NET_LL_ETHERNET);
+  ret = netdev_register(&priv->dev, (flags & IFF_MASK) == IFF_TUN ?
+                                    NET_LL_TUN : NET_LL_ETHERNET);
   if (ret != OK)
     {
       nxmutex_destroy(&priv->lock);
-      nxsem_destroy(&priv->read_wait_sem);
-      nxsem_destroy(&priv->write_wait_sem);
       return ret;
     }
 
-  filep->f_priv = priv; /* Set link to TUN device */
-  return ret;
+  /* The first queue of a new device is always free */
+
+  return tun_queue_attach(priv, filep);
+}
+
+/****************************************************************************
+ * Name: tun_dev_attach
+ *
+ * Description:
+ *   Attach another queue of an existing IFF_MULTI_QUEUE interface to the
+ *   file.
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no interface of this name, another
+ *   negated errno on failure.
+ *
+ * Assumptions:
+ *   The driver is locked.
+ *
+ ****************************************************************************/
+
+static int tun_dev_attach(FAR struct tun_driver_s *tun,
+                          FAR struct file *filep,
+                          FAR const struct ifreq *ifr)
+{
+  FAR struct tun_device_s *priv;
+  int intf;
+  int ret;
+
+  for (intf = 0; intf < CONFIG_TUN_NINTERFACES; intf++)
+    {
+      priv = &g_tun_devices[intf];
+      if ((tun->free_tuns & (1 << intf)) != 0 ||
+          strncmp(priv->dev.d_ifname, ifr->ifr_name, IFNAMSIZ) != 0)
+        {
+          continue;
+        }
+
+      /* All the queues of an interface are set up alike */
+
+      if (priv->flags != (ifr->ifr_flags & TUN_IFF_FEATURES) ||
+          (priv->dev.d_lltype == NET_LL_TUN) !=
+          ((ifr->ifr_flags & IFF_MASK) == IFF_TUN))
+        {
+          return -EINVAL;
+        }
+
+      ret = nxmutex_lock(&priv->lock);
+      if (ret >= 0)
+        {
+          ret = tun_queue_attach(priv, filep);
+          nxmutex_unlock(&priv->lock);
+        }
+
+      return ret;
+    }
+
+  return -ENOENT;
 }
 
 /****************************************************************************
@@ -927,8 +1212,6 @@ static void tun_dev_uninit(FAR struct tun_device_s *priv)
   netdev_unregister(&priv->dev);
 
   nxmutex_destroy(&priv->lock);
-  nxsem_destroy(&priv->read_wait_sem);
-  nxsem_destroy(&priv->write_wait_sem);
 }
 
 /****************************************************************************
@@ -939,21 +1222,36 @@ static int tun_close(FAR struct file *filep)
 {
   FAR struct inode *inode       = filep->f_inode;
   FAR struct tun_driver_s *tun  = inode->i_private;
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct tun_queue_s *queue = filep->f_priv;
+  FAR struct tun_device_s *priv;
   int intf;
   int ret;
 
-  if (priv == NULL)
+  if (queue == NULL)
     {
       return OK;
     }
 
+  priv = queue->priv;
   intf = priv - g_tun_devices;
   ret  = nxmutex_lock(&tun->lock);
   if (ret >= 0)
     {
-      tun->free_tuns |= (1 << intf);
-      tun_dev_uninit(priv);
+      nxmutex_lock(&priv->lock);
+      tun_queue_detach(queue);
+      nxmutex_unlock(&priv->lock);
+
+      if (priv->nqueues == 0)
+        {
+          tun->free_tuns |= (1 << intf);
+          tun_dev_uninit(priv);
+        }
+      else
+        {
+          /* The poll may have been waiting for room in this queue */
+
+          tun_txavail(&priv->dev);
+        }
 
       nxmutex_unlock(&tun->lock);
     }
@@ -961,6 +1259,132 @@ static int tun_close(FAR struct file *filep)
   return ret;
 }
 
+/****************************************************************************
+ * Name: tun_vnet_input
+ *
+ * Description:
+ *   Apply the virtio net header of a written packet to the packet in d_iob.
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if the header does not match the packet.
+ *
+ ****************************************************************************/
+
+static int tun_vnet_input(FAR struct net_driver_s *dev,
+                          FAR const struct tun_vnet_hdr_s *vhdr)
+{
+  uint8_t llhdrlen = NET_LL_HDRLEN(dev);
+  uint16_t start;
+  uint16_t sum;
+
+  /* The network does not take TCP super-segments */
+
+  if (vhdr->gso_type != TUN_VNET_HDR_GSO_NONE)
+    {
+      return -EINVAL;
+    }
+
+  if ((vhdr->flags & TUN_VNET_HDR_F_NEEDS_CSUM) != 0)
+    {
+      /* Complete the checksum, so that the packet can also be forwarded.
+       * The checksum field holds the sum of the pseudo-header.
+       */
+
+      if (vhdr->csum_start < llhdrlen ||
+          vhdr->csum_start + vhdr->csum_offset + sizeof(uint16_t) >
+          dev->d_len)
+        {
+          return -EINVAL;
+        }
+
+      start = vhdr->csum_start - llhdrlen;
+      sum   = ~chksum_iob(0, dev->d_iob, start);
+      sum   = HTONS(sum == 0 ? 0xffff : sum);
+
+      iob_trycopyin(dev->d_iob, (FAR const uint8_t *)&sum, sizeof(sum),
+                    start + vhdr->csum_offset, false);
+#ifdef CONFIG_NETDEV_OFFLOAD
+      dev->d_offload |= NETDEV_OFFLOAD_RXCSUM;
+#endif
+    }
+#ifdef CONFIG_NETDEV_OFFLOAD
+  else if ((vhdr->flags & TUN_VNET_HDR_F_DATA_VALID) != 0)
+    {
+      dev->d_offload |= NETDEV_OFFLOAD_RXCSUM;
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tun_write_packet
+ *
+ * Description:
+ *   Pass one written packet to the network.
+ *
+ * Returned Value:
+ *   OK on success; Negated errno on failure.
+ *
+ * Assumptions:
+ *   The device is locked and the queue has room for a reply.
+ *
+ ****************************************************************************/
+
+static int tun_write_packet(FAR struct tun_queue_s *queue,
+                            FAR const struct tun_vnet_hdr_s *vhdr,
+                            FAR const char *buffer, size_t buflen)
+{
+  FAR struct net_driver_s *dev = &queue->priv->dev;
+  uint8_t llhdrlen = NET_LL_HDRLEN(dev);
+  int ret;
+
+  if (buflen > CONFIG_NET_TUN_PKTSIZE)
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+  netdev_iob_release(dev);
+  ret = netdev_iob_prepare(dev, false, 0);
+  dev->d_buf = NULL;
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = iob_trycopyin(dev->d_iob, (FAR const uint8_t *)buffer,
+                      buflen, -llhdrlen, false);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  dev->d_len = buflen;
+
+  if (vhdr != NULL)
+    {
+      ret = tun_vnet_input(dev, vhdr);
+      if (ret < 0)
+        {
+          netdev_iob_release(dev);
+          goto errout;
+        }
+    }
+
+  tun_net_receive(queue);
+#ifdef CONFIG_NETDEV_OFFLOAD
+  dev->d_offload &= ~NETDEV_OFFLOAD_RXCSUM;
+#endif
+
+  net_unlock();
+  return OK;
+
+errout:
+  net_unlock();
+  return ret;
+}
+
 /****************************************************************************
  * Name: tun_write
  ****************************************************************************/
@@ -968,75 +1392,110 @@ static int tun_close(FAR struct file *filep)
 static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
                          size_t buflen)
 {
-  FAR struct tun_device_s *priv = filep->f_priv;
-  uint8_t llhdrlen;
+  FAR struct tun_queue_s *queue = filep->f_priv;
+  FAR struct tun_device_s *priv;
+  struct tun_batch_hdr_s bhdr;
+  struct tun_vnet_hdr_s vhdr;
+  size_t offset = 0;
+  size_t hdrlen;
+  size_t pktlen;
   ssize_t ret;
 
-  if (priv == NULL || buflen > CONFIG_NET_TUN_PKTSIZE)
+  if (queue == NULL)
     {
       return -EINVAL;
     }
 
-  llhdrlen = NET_LL_HDRLEN(&priv->dev);
+  priv   = queue->priv;
+  hdrlen = TUN_HDRLEN(priv);
 
-  for (; ; )
+  /* Write must return immediately if interrupted by a signal (or if the
+   * thread is canceled) and no data has yet been written.
+   */
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
     {
-      /* Write must return immediately if interrupted by a signal (or if the
-       * thread is canceled) and no data has yet been written.
+      return ret;
+    }
+
+  while (offset < buflen)
+    {
+      /* Find the packet and its headers, there is only one packet in the
+       * buffer without IFF_BATCH.
        */
 
-      ret = nxmutex_lock(&priv->lock);
-      if (ret < 0)
+      if (buflen - offset < hdrlen)
         {
-          return ret;
+          ret = -EINVAL;
+          break;
         }
 
-      /* Check if there are free space to write */
+      pktlen = buflen - offset - hdrlen;
+      if ((priv->flags & IFF_BATCH) != 0)
+        {
+          memcpy(&bhdr, buffer + offset, sizeof(bhdr));
+          if (bhdr.len > pktlen)
+            {
+              ret = -EINVAL;
+              break;
+            }
 
-      if (priv->write_d_len == 0)
+          pktlen = bhdr.len;
+        }
+
+      if ((priv->flags & IFF_VNET_HDR) != 0)
         {
-          net_lock();
-          netdev_iob_release(&priv->dev);
-          ret = netdev_iob_prepare(&priv->dev, false, 0);
-          priv->dev.d_buf = NULL;
-          if (ret < 0)
+          memcpy(&vhdr, buffer + offset + hdrlen - sizeof(vhdr),
+                 sizeof(vhdr));
+        }
+
+      /* Wait if there is no room for a reply, unless some packets were
+       * already written.
+       */
+
+      if (queue->nreplies >= CONFIG_NET_TUN_QUEUELEN)
+        {
+          if (offset > 0)
             {
-              net_unlock();
               break;
             }
 
-          ret = iob_trycopyin(priv->dev.d_iob, (FAR const uint8_t *)buffer,
-                              buflen, -llhdrlen, false);
-          if (ret < 0)
+          if ((filep->f_oflags & O_NONBLOCK) != 0)
             {
-              net_unlock();
+              ret = -EAGAIN;
               break;
             }
 
-          priv->dev.d_len = buflen;
+          queue->write_wait = true;
+          nxmutex_unlock(&priv->lock);
+          nxsem_wait(&queue->write_wait_sem);
 
-          tun_net_receive(priv);
-          net_unlock();
+          ret = nxmutex_lock(&priv->lock);
+          if (ret < 0)
+            {
+              return ret;
+            }
 
-          ret = buflen;
-          break;
+          continue;
         }
 
-      /* Wait if there are no free space to write */
-
-      if ((filep->f_oflags & O_NONBLOCK) != 0)
+      ret = tun_write_packet(queue, (priv->flags & IFF_VNET_HDR) != 0 ?
+                             &vhdr : NULL, buffer + offset + hdrlen, pktlen);
+      if (ret < 0)
         {
-          ret = -EAGAIN;
           break;
         }
 
-      priv->write_wait = true;
-      nxmutex_unlock(&priv->lock);
-      nxsem_wait(&priv->write_wait_sem);
+      offset += hdrlen + pktlen;
+      if ((priv->flags & IFF_BATCH) != 0)
+        {
+          offset = TUN_BATCH_ALIGN(offset);
+        }
     }
 
   nxmutex_unlock(&priv->lock);
-  return ret;
+  return offset > 0 ? MIN(offset, buflen) : ret;
 }
 
 /****************************************************************************
@@ -1046,15 +1505,24 @@ static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
 static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen)
 {
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct tun_queue_s *queue = filep->f_priv;
+  FAR struct tun_device_s *priv;
+  FAR struct tun_pkt_s *pkt;
+  struct tun_batch_hdr_s bhdr;
+  bool polled = false;
+  bool replied = false;
+  size_t offset = 0;
+  size_t hdrlen;
   uint8_t llhdrlen;
   ssize_t ret;
 
-  if (priv == NULL)
+  if (queue == NULL)
     {
       return -EINVAL;
     }
 
+  priv     = queue->priv;
+  hdrlen   = TUN_HDRLEN(priv);
   llhdrlen = NET_LL_HDRLEN(&priv->dev);
 
   for (; ; )
@@ -1069,64 +1537,97 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
           return ret;
         }
 
-      /* Check if there are data to read in write buffer */
+      /* Check if there are data to read */
 
-      if (priv->write_d_len > 0)
+      if (queue->npkts > 0)
         {
-          if (buflen < priv->write_d_len)
-            {
-              ret = -EINVAL;
-              break;
-            }
+          break;
+        }
 
-          iob_copyout((FAR uint8_t *)buffer, priv->write_buf,
-                      priv->write_d_len, -llhdrlen);
-          ret = priv->write_d_len;
+      /* Wait if there are no data to read */
 
-          iob_free_chain(priv->write_buf);
-          priv->write_buf   = NULL;
-          priv->write_d_len = 0;
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          nxmutex_unlock(&priv->lock);
+          return -EAGAIN;
+        }
 
-          NETDEV_TXDONE(&priv->dev);
-          tun_pollnotify(priv, POLLOUT);
+      queue->read_wait = true;
+      nxmutex_unlock(&priv->lock);
+      nxsem_wait(&queue->read_wait_sem);
+    }
+
+  /* Copy out the oldest packets, only one without IFF_BATCH */
+
+  ret = -EINVAL;
+  while (queue->npkts > 0)
+    {
+      pkt = &queue->pkts[queue->head];
+      if (offset + hdrlen + pkt->len > buflen)
+        {
           break;
         }
 
-      /* Check if there are data to read in read buffer */
+      if ((priv->flags & IFF_BATCH) != 0)
+        {
+          bhdr.len      = pkt->len;
+          bhdr.reserved = 0;
+          memcpy(buffer + offset, &bhdr, sizeof(bhdr));
+          offset += sizeof(bhdr);
+        }
 
-      if (priv->read_d_len > 0)
+      if ((priv->flags & IFF_VNET_HDR) != 0)
         {
-          if (buflen < priv->read_d_len)
-            {
-              ret = -EINVAL;
-              break;
-            }
+#ifdef CONFIG_NETDEV_OFFLOAD
+          memcpy(buffer + offset, &pkt->vhdr, sizeof(pkt->vhdr));
+#else
+          memset(buffer + offset, 0, sizeof(struct tun_vnet_hdr_s));
+#endif
+          offset += sizeof(struct tun_vnet_hdr_s);
+        }
 
-          iob_copyout((FAR uint8_t *)buffer, priv->read_buf,
-                      priv->read_d_len, -llhdrlen);
-          ret = priv->read_d_len;
+      iob_copyout((FAR uint8_t *)buffer + offset, pkt->buf, pkt->len,
+                  -llhdrlen);
+      offset += pkt->len;
+      ret     = offset;
 
-          iob_free_chain(priv->read_buf);
-          priv->read_buf   = NULL;
-          priv->read_d_len = 0;
+      iob_free_chain(pkt->buf);
+      pkt->buf = NULL;
 
-          net_lock();
-          tun_txdone(priv);
-          net_unlock();
-          break;
+      if (pkt->reply)
+        {
+          queue->nreplies--;
+          replied = true;
+        }
+      else
+        {
+          queue->npolled--;
+          polled = true;
         }
 
-      /* Wait if there are no data to read */
+      queue->head = (queue->head + 1) % TUN_RINGSIZE;
+      queue->npkts--;
 
-      if ((filep->f_oflags & O_NONBLOCK) != 0)
+      NETDEV_TXDONE(&priv->dev);
+
+      if ((priv->flags & IFF_BATCH) == 0)
         {
-          ret = -EAGAIN;
           break;
         }
 
-      priv->read_wait = true;
-      nxmutex_unlock(&priv->lock);
-      nxsem_wait(&priv->read_wait_sem);
+      offset = TUN_BATCH_ALIGN(offset);
+    }
+
+  if (replied)
+    {
+      tun_pollnotify(queue, POLLOUT);
+    }
+
+  if (polled)
+    {
+      net_lock();
+      tun_txdone(priv);
+      net_unlock();
     }
 
   nxmutex_unlock(&priv->lock);
@@ -1140,18 +1641,20 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
 static int tun_poll(FAR struct file *filep,
                     FAR struct pollfd *fds, bool setup)
 {
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct tun_queue_s *queue = filep->f_priv;
+  FAR struct tun_device_s *priv;
   pollevent_t eventset;
   int ret;
 
   /* Some sanity checking */
 
-  if (priv == NULL || fds == NULL)
+  if (queue == NULL || fds == NULL)
     {
       return -EINVAL;
     }
 
-  ret = nxmutex_lock(&priv->lock);
+  priv = queue->priv;
+  ret  = nxmutex_lock(&priv->lock);
   if (ret < 0)
     {
       return ret;
@@ -1159,28 +1662,26 @@ static int tun_poll(FAR struct file *filep,
 
   if (setup)
     {
-      if (priv->poll_fds)
+      if (queue->poll_fds)
         {
           ret = -EBUSY;
           goto errout;
         }
 
-      priv->poll_fds = fds;
+      queue->poll_fds = fds;
 
       eventset = 0;
 
-      /* If write buffer is empty notify App.  */
+      /* If there is room for a reply notify App.  */
 
-      if (priv->write_d_len == 0)
+      if (queue->nreplies < CONFIG_NET_TUN_QUEUELEN)
         {
           eventset |= POLLOUT;
         }
 
-      /* The write buffer sometimes could be used for TX.
-       * So check it too.
-       */
+      /* Both the polled packets and the replies are read. */
 
-      if (priv->read_d_len != 0 || priv->write_d_len != 0)
+      if (queue->npkts != 0)
         {
           eventset |= POLLIN;
         }
@@ -1189,7 +1690,7 @@ static int tun_poll(FAR struct file *filep,
     }
   else
     {
-      priv->poll_fds = NULL;
+      queue->poll_fds = NULL;
     }
 
 errout:
@@ -1205,7 +1706,8 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   FAR struct inode *inode       = filep->f_inode;
   FAR struct tun_driver_s *tun  = inode->i_private;
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct tun_queue_s *queue = filep->f_priv;
+  FAR struct tun_device_s *priv;
   int ret = OK;
 
   if (cmd == TUNSETIFF)
@@ -1214,7 +1716,7 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       int intf;
       FAR struct ifreq *ifr = (FAR struct ifreq *)arg;
 
-      if (priv != NULL || ifr == NULL ||
+      if (queue != NULL || ifr == NULL ||
          ((ifr->ifr_flags & IFF_MASK) != IFF_TUN &&
           (ifr->ifr_flags & IFF_MASK) != IFF_TAP))
         {
@@ -1227,6 +1729,20 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           return ret;
         }
 
+      /* With IFF_MULTI_QUEUE, the name of an existing interface attaches
+       * another queue to it.
+       */
+
+      if ((ifr->ifr_flags & IFF_MULTI_QUEUE) != 0 && *ifr->ifr_name)
+        {
+          ret = tun_dev_attach(tun, filep, ifr);
+          if (ret != -ENOENT)
+            {
+              nxmutex_unlock(&tun->lock);
+              return ret;
+            }
+        }
+
       free_tuns = tun->free_tuns;
 
       if (free_tuns == 0)
@@ -1241,7 +1757,7 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       ret = tun_dev_init(&g_tun_devices[intf], filep,
                          *ifr->ifr_name ? ifr->ifr_name : NULL,
-                         (ifr->ifr_flags & IFF_MASK) == IFF_TUN);
+                         ifr->ifr_flags);
       if (ret != OK)
         {
           nxmutex_unlock(&tun->lock);
@@ -1250,7 +1766,7 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       tun->free_tuns &= ~(1 << intf);
 
-      priv = filep->f_priv;
+      priv = &g_tun_devices[intf];
       strlcpy(ifr->ifr_name, priv->dev.d_ifname, IFNAMSIZ);
       nxmutex_unlock(&tun->lock);
 
@@ -1259,29 +1775,29 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   else if (cmd == TUNGETIFF)
     {
       FAR struct ifreq *ifr = (FAR struct ifreq *)arg;
-      if (priv == NULL || ifr == NULL)
+      if (queue == NULL || ifr == NULL)
         {
           return -EINVAL;
         }
 
-      strlcpy(ifr->ifr_name, priv->dev.d_ifname, IFNAMSIZ);
+      strlcpy(ifr->ifr_name, queue->priv->dev.d_ifname, IFNAMSIZ);
 
       return OK;
     }
   else if (cmd == TUNSETCARRIER)
     {
-      if (priv == NULL || arg == 0)
+      if (queue == NULL || arg == 0)
         {
           return -EINVAL;
         }
 
       if (*(FAR int *)((uintptr_t)arg))
         {
-          netdev_carrier_on(&priv->dev);
+          netdev_carrier_on(&queue->priv->dev);
         }
       else
         {
-          netdev_carrier_off(&priv->dev);
+          netdev_carrier_off(&queue->priv->dev);
         }
 
       return OK;
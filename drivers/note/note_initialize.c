@@ -27,6 +27,7 @@
 #include <nuttx/note/note_driver.h>
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/note/notectl_driver.h>
+#include <nuttx/note/noteperfetto_driver.h>
 #include <nuttx/note/notesnap_driver.h>
 #include <nuttx/segger/note_rtt.h>
 #include <nuttx/segger/sysview.h>
@@ -112,6 +113,15 @@ int note_initialize(void)
     }
 #endif
 
+#ifdef CONFIG_DRIVERS_NOTEPERFETTO
+  ret = noteperfetto_register();
+  if (ret < 0)
+    {
+      serr("noteperfetto_register failed %d\n", ret);
+      return ret;
+    }
+#endif
+
 #ifdef CONFIG_DRIVERS_NOTECTL
   ret = notectl_register();
   if (ret < 0)
@@ -0,0 +1,785 @@
+/****************************************************************************
+ * drivers/note/noteperfetto_driver.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/note/note_driver.h>
+#include <nuttx/note/noteperfetto_driver.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The reader looks for new notes this often while the buffer is empty */
+
+#define NOTEPERFETTO_POLL_USEC   10000
+
+/* The largest packet one note turns into: the note payload or two task
+ * names, plus the protobuf framing.
+ */
+
+#define NOTEPERFETTO_PACKET_MAX  (UINT8_MAX + 2 * CONFIG_TASK_NAME_SIZE + 64)
+
+/* Protobuf wire types */
+
+#define PB_VARINT                0
+#define PB_LEN                   2
+
+/* The field numbers of the Perfetto trace messages which are used */
+
+#define TRACE_PACKET             1   /* Trace.packet */
+#define PACKET_FTRACE_EVENTS     1   /* TracePacket.ftrace_events */
+#define BUNDLE_CPU               1   /* FtraceEventBundle.cpu */
+#define BUNDLE_EVENT             2   /* FtraceEventBundle.event */
+#define EVENT_TIMESTAMP          1   /* FtraceEvent.timestamp */
+#define EVENT_PID                2   /* FtraceEvent.pid */
+#define EVENT_PRINT              3   /* FtraceEvent.print */
+#define EVENT_SCHED_SWITCH       4   /* FtraceEvent.sched_switch */
+#define EVENT_SCHED_WAKING       20  /* FtraceEvent.sched_waking */
+#define EVENT_IRQ_ENTRY          36  /* FtraceEvent.irq_handler_entry */
+#define EVENT_IRQ_EXIT           37  /* FtraceEvent.irq_handler_exit */
+#define EVENT_TASK_NEWTASK       235 /* FtraceEvent.task_newtask */
+
+/* Linux task states as seen by sched_switch.prev_state */
+
+#define NOTEPERFETTO_RUNNABLE    0x00
+#define NOTEPERFETTO_SLEEPING    0x01
+#define NOTEPERFETTO_DEAD        0x80
+
+/* In NuttX, PID number less than NCPUS are idle tasks.
+ * In Linux, there is only one idle task of PID 0.
+ */
+
+#define noteperfetto_pid(pid)   ((pid) < CONFIG_SMP_NCPUS ? 0 : (pid))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The scheduling state of one CPU, rebuilt from the notes as they are
+ * converted.  A NOTE_SUSPEND and the following NOTE_RESUME make up one
+ * sched_switch.
+ */
+
+struct noteperfetto_cpu_s
+{
+  pid_t current_pid;                /* The running task, -1 if unknown */
+  uint8_t current_priority;
+  uint8_t current_state;            /* The state of the suspended task */
+  pid_t next_pid;                   /* The task resumed */
+  uint8_t next_priority;
+  int intr_nest;                    /* Nesting of interrupt handlers */
+  bool pendingswitch;               /* Switch at interrupt exit */
+};
+
+struct noteperfetto_s
+{
+  struct note_driver_s driver;
+  spinlock_t lock;                  /* Protects the ring buffer */
+  mutex_t mutex;                    /* Serializes the readers */
+  unsigned int head;                /* The next byte to write */
+  unsigned int tail;                /* The next byte to read */
+  unsigned long dropped;            /* Notes lost with a full buffer */
+  struct noteperfetto_cpu_s cpu[CONFIG_SMP_NCPUS];
+  uint8_t buffer[CONFIG_DRIVERS_NOTEPERFETTO_BUFSIZE];
+};
+
+/* A note read back from the ring buffer, aligned for its fields */
+
+union noteperfetto_note_u
+{
+  struct note_common_s cmn;
+  uint8_t data[UINT8_MAX + 1];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void noteperfetto_add(FAR struct note_driver_s *drv,
+                             FAR const void *note, size_t notelen);
+static int noteperfetto_open(FAR struct file *filep);
+static ssize_t noteperfetto_read(FAR struct file *filep,
+                                 FAR char *buffer, size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct note_driver_ops_s g_noteperfetto_ops =
+{
+  noteperfetto_add
+};
+
+static const struct file_operations g_noteperfetto_fops =
+{
+  noteperfetto_open,  /* open */
+  NULL,               /* close */
+  noteperfetto_read,  /* read */
+};
+
+static struct noteperfetto_s g_noteperfetto =
+{
+  {&g_noteperfetto_ops},
+  SP_UNLOCKED,
+  NXMUTEX_INITIALIZER,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pb_varint, pb_uint and pb_string
+ *
+ * Description:
+ *   Encode a varint, a varint field and a length delimited field.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *pb_varint(FAR uint8_t *p, uint64_t value)
+{
+  while (value >= 0x80)
+    {
+      *p++ = (uint8_t)value | 0x80;
+      value >>= 7;
+    }
+
+  *p++ = (uint8_t)value;
+  return p;
+}
+
+static FAR uint8_t *pb_uint(FAR uint8_t *p, uint32_t field, uint64_t value)
+{
+  p = pb_varint(p, (field << 3) | PB_VARINT);
+  return pb_varint(p, value);
+}
+
+static FAR uint8_t *pb_string(FAR uint8_t *p, uint32_t field,
+                              FAR const char *str, size_t len)
+{
+  p = pb_varint(p, (field << 3) | PB_LEN);
+  p = pb_varint(p, len);
+  memcpy(p, str, len);
+  return p + len;
+}
+
+/****************************************************************************
+ * Name: pb_begin and pb_end
+ *
+ * Description:
+ *   Open a nested message and close it once its length is known.  The
+ *   length is always stored as a two byte varint, which protobuf decoders
+ *   accept, so nothing has to be moved when the message is closed.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *pb_begin(FAR uint8_t *p, uint32_t field,
+                             FAR uint8_t **len)
+{
+  p = pb_varint(p, (field << 3) | PB_LEN);
+  *len = p;
+  return p + 2;
+}
+
+static FAR uint8_t *pb_end(FAR uint8_t *p, FAR uint8_t *len)
+{
+  size_t size = p - len - 2;
+
+  DEBUGASSERT(size < 0x4000);
+  len[0] = (size & 0x7f) | 0x80;
+  len[1] = size >> 7;
+  return p;
+}
+
+/****************************************************************************
+ * Name: noteperfetto_name
+ ****************************************************************************/
+
+static FAR const char *noteperfetto_name(pid_t pid)
+{
+  FAR const char *name = NULL;
+
+#if CONFIG_DRIVERS_NOTE_TASKNAME_BUFSIZE > 0
+  name = note_get_taskname(pid);
+#endif
+
+  return name != NULL ? name : "<noname>";
+}
+
+/****************************************************************************
+ * Name: noteperfetto_comm
+ ****************************************************************************/
+
+static FAR uint8_t *noteperfetto_comm(FAR uint8_t *p, uint32_t field,
+                                      pid_t pid)
+{
+  FAR const char *name = noteperfetto_name(pid);
+
+  return pb_string(p, field, name, strnlen(name, CONFIG_TASK_NAME_SIZE));
+}
+
+/****************************************************************************
+ * Name: noteperfetto_state
+ ****************************************************************************/
+
+static int noteperfetto_state(uint8_t state)
+{
+  if (state == 0)
+    {
+      return NOTEPERFETTO_DEAD;
+    }
+
+  return state <= LAST_READY_TO_RUN_STATE ? NOTEPERFETTO_RUNNABLE :
+                                            NOTEPERFETTO_SLEEPING;
+}
+
+/****************************************************************************
+ * Name: noteperfetto_switch
+ *
+ * Description:
+ *   Encode the sched_switch from the running task to the resumed one.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *noteperfetto_switch(FAR uint8_t *p,
+                                        FAR struct noteperfetto_cpu_s *cctx)
+{
+  FAR uint8_t *len;
+
+  p = pb_begin(p, EVENT_SCHED_SWITCH, &len);
+  p = noteperfetto_comm(p, 1, cctx->current_pid);
+  p = pb_uint(p, 2, noteperfetto_pid(cctx->current_pid));
+  p = pb_uint(p, 3, cctx->current_priority);
+  p = pb_uint(p, 4, noteperfetto_state(cctx->current_state));
+  p = noteperfetto_comm(p, 5, cctx->next_pid);
+  p = pb_uint(p, 6, noteperfetto_pid(cctx->next_pid));
+  p = pb_uint(p, 7, cctx->next_priority);
+  p = pb_end(p, len);
+
+  cctx->current_pid      = cctx->next_pid;
+  cctx->current_priority = cctx->next_priority;
+  cctx->pendingswitch    = false;
+  return p;
+}
+
+/****************************************************************************
+ * Name: noteperfetto_print
+ *
+ * Description:
+ *   Encode a print event, in the "B|pid|name" and "E|pid" form of the
+ *   atrace markers for the slices.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *noteperfetto_print(FAR uint8_t *p, uintptr_t ip,
+                                       FAR const char *fmt, ...)
+{
+  char buf[UINT8_MAX + 16];
+  FAR uint8_t *len;
+  va_list ap;
+  int n;
+
+  va_start(ap, fmt);
+  n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+
+  p = pb_begin(p, EVENT_PRINT, &len);
+  p = pb_uint(p, 1, ip);
+  p = pb_string(p, 2, buf, MIN(n, sizeof(buf) - 1));
+  return pb_end(p, len);
+}
+
+/****************************************************************************
+ * Name: noteperfetto_event
+ *
+ * Description:
+ *   Encode the ftrace event of one note, after the timestamp and pid.
+ *   Notes without an equivalent only update the state of their CPU.
+ *
+ * Returned Value:
+ *   The end of the event, or p if the note produced no event.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *noteperfetto_event(FAR uint8_t *p,
+                                       FAR union noteperfetto_note_u *note,
+                                       FAR struct noteperfetto_cpu_s *cctx)
+{
+  FAR struct note_common_s *cmn = &note->cmn;
+  pid_t pid = noteperfetto_pid(cmn->nc_pid);
+  FAR uint8_t *len;
+
+  if (cctx->current_pid < 0)
+    {
+      cctx->current_pid      = cmn->nc_pid;
+      cctx->current_priority = cmn->nc_priority;
+    }
+
+  switch (cmn->nc_type)
+    {
+      case NOTE_START:
+        {
+          FAR struct note_start_s *nst = (FAR struct note_start_s *)note;
+
+          p = pb_begin(p, EVENT_TASK_NEWTASK, &len);
+          p = pb_uint(p, 1, pid);
+#if CONFIG_TASK_NAME_SIZE > 0
+          p = pb_string(p, 2, nst->nst_name,
+                        strnlen(nst->nst_name, cmn->nc_length -
+                                sizeof(struct note_start_s) + 1));
+#else
+          UNUSED(nst);
+          p = noteperfetto_comm(p, 2, cmn->nc_pid);
+#endif
+          p = pb_end(p, len);
+        }
+        break;
+
+      case NOTE_STOP:
+        cctx->current_state = 0;
+        break;
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SWITCH
+      case NOTE_SUSPEND:
+        cctx->current_state = ((FAR struct note_suspend_s *)note)->nsu_state;
+        break;
+
+      case NOTE_RESUME:
+        cctx->next_pid      = cmn->nc_pid;
+        cctx->next_priority = cmn->nc_priority;
+
+        if (cctx->intr_nest == 0)
+          {
+            p = noteperfetto_switch(p, cctx);
+          }
+        else
+          {
+            /* The switch happens when the interrupt handler returns */
+
+            p = pb_begin(p, EVENT_SCHED_WAKING, &len);
+            p = noteperfetto_comm(p, 1, cmn->nc_pid);
+            p = pb_uint(p, 2, pid);
+            p = pb_uint(p, 3, cmn->nc_priority);
+            p = pb_uint(p, 4, 1);
+            p = pb_uint(p, 5, cctx - g_noteperfetto.cpu);
+            p = pb_end(p, len);
+            cctx->pendingswitch = true;
+          }
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
+      case NOTE_PREEMPT_LOCK:
+      case NOTE_PREEMPT_UNLOCK:
+        p = noteperfetto_print(p, 0, "%c|%d|sched_lock",
+                               cmn->nc_type == NOTE_PREEMPT_LOCK ?
+                               'B' : 'E', pid);
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
+      case NOTE_CSECTION_ENTER:
+      case NOTE_CSECTION_LEAVE:
+        p = noteperfetto_print(p, 0, "%c|%d|csection",
+                               cmn->nc_type == NOTE_CSECTION_ENTER ?
+                               'B' : 'E', pid);
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SYSCALL
+      case NOTE_SYSCALL_ENTER:
+        p = noteperfetto_print(p, 0, "B|%d|syscall %d", pid,
+                               ((FAR struct note_syscall_enter_s *)
+                                note)->nsc_nr);
+        break;
+
+      case NOTE_SYSCALL_LEAVE:
+        p = noteperfetto_print(p, 0, "E|%d", pid);
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+      case NOTE_IRQ_ENTER:
+        {
+          FAR struct note_irqhandler_s *nih =
+            (FAR struct note_irqhandler_s *)note;
+          char name[24];
+
+          snprintf(name, sizeof(name), "%p", (FAR void *)nih->nih_handler);
+          p = pb_begin(p, EVENT_IRQ_ENTRY, &len);
+          p = pb_uint(p, 1, nih->nih_irq);
+          p = pb_string(p, 2, name, strlen(name));
+          p = pb_end(p, len);
+          cctx->intr_nest++;
+        }
+        break;
+
+      case NOTE_IRQ_LEAVE:
+        {
+          FAR struct note_irqhandler_s *nih =
+            (FAR struct note_irqhandler_s *)note;
+
+          p = pb_begin(p, EVENT_IRQ_EXIT, &len);
+          p = pb_uint(p, 1, nih->nih_irq);
+          p = pb_uint(p, 2, 1);
+          p = pb_end(p, len);
+
+          if (cctx->intr_nest > 0)
+            {
+              cctx->intr_nest--;
+            }
+        }
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+      case NOTE_DUMP_STRING:
+        {
+          FAR struct note_string_s *nst = (FAR struct note_string_s *)note;
+          int n = cmn->nc_length - sizeof(struct note_string_s) + 1;
+
+          if (n == 2 && (nst->nst_data[0] == 'B' || nst->nst_data[0] == 'E'))
+            {
+              p = noteperfetto_print(p, nst->nst_ip, "%c|%d|%p",
+                                     nst->nst_data[0], pid,
+                                     (FAR void *)nst->nst_ip);
+            }
+          else
+            {
+              p = noteperfetto_print(p, nst->nst_ip, "%.*s",
+                                     n, nst->nst_data);
+            }
+        }
+        break;
+
+      case NOTE_DUMP_BEGIN:
+      case NOTE_DUMP_END:
+        {
+          FAR struct note_binary_s *nbi = (FAR struct note_binary_s *)note;
+          char c = cmn->nc_type == NOTE_DUMP_BEGIN ? 'B' : 'E';
+          int n = cmn->nc_length - SIZEOF_NOTE_BINARY(0);
+
+          if (n > 0)
+            {
+              p = noteperfetto_print(p, nbi->nbi_ip, "%c|%d|%.*s", c, pid,
+                                     n, (FAR const char *)nbi->nbi_data);
+            }
+          else
+            {
+              p = noteperfetto_print(p, nbi->nbi_ip, "%c|%d|%p", c, pid,
+                                     (FAR void *)nbi->nbi_ip);
+            }
+        }
+        break;
+#endif
+
+      default:
+        break;
+    }
+
+  return p;
+}
+
+/****************************************************************************
+ * Name: noteperfetto_cpu
+ ****************************************************************************/
+
+static FAR struct noteperfetto_cpu_s *
+noteperfetto_cpu(FAR union noteperfetto_note_u *note)
+{
+#ifdef CONFIG_SMP
+  return &g_noteperfetto.cpu[note->cmn.nc_cpu];
+#else
+  return &g_noteperfetto.cpu[0];
+#endif
+}
+
+/****************************************************************************
+ * Name: noteperfetto_encode
+ *
+ * Description:
+ *   Encode one note as a trace packet holding an ftrace event bundle.
+ *
+ * Returned Value:
+ *   The size of the packet, zero if the note has no equivalent.
+ *
+ ****************************************************************************/
+
+static size_t noteperfetto_encode(FAR uint8_t *packet,
+                                  FAR union noteperfetto_note_u *note,
+                                  FAR struct noteperfetto_cpu_s *cctx)
+{
+  FAR uint8_t *bundle;
+  FAR uint8_t *event;
+  FAR uint8_t *start;
+  FAR uint8_t *pkt;
+  FAR uint8_t *p;
+
+  p = pb_begin(packet, TRACE_PACKET, &pkt);
+  p = pb_begin(p, PACKET_FTRACE_EVENTS, &bundle);
+  p = pb_uint(p, BUNDLE_CPU, cctx - g_noteperfetto.cpu);
+  p = pb_begin(p, BUNDLE_EVENT, &event);
+  p = pb_uint(p, EVENT_TIMESTAMP,
+              (uint64_t)note->cmn.nc_systime_sec * NSEC_PER_SEC +
+              note->cmn.nc_systime_nsec);
+  p = pb_uint(p, EVENT_PID, noteperfetto_pid(note->cmn.nc_pid));
+
+  start = p;
+  p = noteperfetto_event(p, note, cctx);
+  if (p == start)
+    {
+      return 0;
+    }
+
+  p = pb_end(p, event);
+  p = pb_end(p, bundle);
+  p = pb_end(p, pkt);
+
+  return p - packet;
+}
+
+/****************************************************************************
+ * Name: noteperfetto_peek
+ *
+ * Description:
+ *   Copy the oldest note out of the ring buffer without removing it.
+ *
+ * Returned Value:
+ *   The length of the note, zero if the buffer is empty.
+ *
+ ****************************************************************************/
+
+static size_t noteperfetto_peek(FAR union noteperfetto_note_u *note)
+{
+  FAR struct noteperfetto_s *drv = &g_noteperfetto;
+  irqstate_t flags;
+  size_t notelen = 0;
+  size_t space;
+
+  flags = spin_lock_irqsave_wo_note(&drv->lock);
+
+  if (drv->tail != drv->head)
+    {
+      notelen = drv->buffer[drv->tail];
+      space   = MIN(notelen, CONFIG_DRIVERS_NOTEPERFETTO_BUFSIZE -
+                             drv->tail);
+      memcpy(note->data, drv->buffer + drv->tail, space);
+      memcpy(note->data + space, drv->buffer, notelen - space);
+    }
+
+  spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+  return notelen;
+}
+
+/****************************************************************************
+ * Name: noteperfetto_add
+ *
+ * Description:
+ *   Add the variable length note to the ring buffer.  The notes are only
+ *   converted by the reader, so this stays as cheap as noteram.
+ *
+ ****************************************************************************/
+
+static void noteperfetto_add(FAR struct note_driver_s *driver,
+                             FAR const void *note, size_t notelen)
+{
+  FAR struct noteperfetto_s *drv = (FAR struct noteperfetto_s *)driver;
+  irqstate_t flags;
+  unsigned int used;
+  size_t space;
+
+  flags = spin_lock_irqsave_wo_note(&drv->lock);
+
+  used = (drv->head + CONFIG_DRIVERS_NOTEPERFETTO_BUFSIZE - drv->tail) %
+         CONFIG_DRIVERS_NOTEPERFETTO_BUFSIZE;
+
+  /* Keep the newest notes in the reader's view consistent: drop the new
+   * note rather than overwrite one the reader may be converting.
+   */
+
+  if (CONFIG_DRIVERS_NOTEPERFETTO_BUFSIZE - 1 - used < notelen)
+    {
+      drv->dropped++;
+      spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+      return;
+    }
+
+  space = MIN(notelen, CONFIG_DRIVERS_NOTEPERFETTO_BUFSIZE - drv->head);
+  memcpy(drv->buffer + drv->head, note, space);
+  memcpy(drv->buffer, (FAR const uint8_t *)note + space, notelen - space);
+
+  drv->head = (drv->head + notelen) % CONFIG_DRIVERS_NOTEPERFETTO_BUFSIZE;
+
+  spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+}
+
+/****************************************************************************
+ * Name: noteperfetto_open
+ ****************************************************************************/
+
+static int noteperfetto_open(FAR struct file *filep)
+{
+  int i;
+
+  if ((filep->f_oflags & O_WROK) != 0)
+    {
+      return -EACCES;
+    }
+
+  /* A new trace starts without knowing what runs on each CPU */
+
+  nxmutex_lock(&g_noteperfetto.mutex);
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      memset(&g_noteperfetto.cpu[i], 0, sizeof(g_noteperfetto.cpu[i]));
+      g_noteperfetto.cpu[i].current_pid = -1;
+    }
+
+  nxmutex_unlock(&g_noteperfetto.mutex);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: noteperfetto_read
+ *
+ * Description:
+ *   Convert the buffered notes into whole trace packets.  The packets can
+ *   simply be concatenated, so the device can be copied to a file or a
+ *   socket as it is and opened with the Perfetto UI or trace_processor.
+ *   The read blocks while there is nothing to convert, unless the device
+ *   was opened with O_NONBLOCK.
+ *
+ ****************************************************************************/
+
+static ssize_t noteperfetto_read(FAR struct file *filep,
+                                 FAR char *buffer, size_t buflen)
+{
+  FAR struct noteperfetto_s *drv = &g_noteperfetto;
+  FAR struct noteperfetto_cpu_s *cctx;
+  struct noteperfetto_cpu_s saved;
+  union noteperfetto_note_u note;
+  uint8_t packet[NOTEPERFETTO_PACKET_MAX];
+  size_t nread = 0;
+  size_t notelen;
+  size_t len;
+  int ret;
+
+  if (buflen < NOTEPERFETTO_PACKET_MAX)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&drv->mutex);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (; ; )
+    {
+      notelen = noteperfetto_peek(&note);
+      if (notelen == 0)
+        {
+          if (nread > 0)
+            {
+              break;
+            }
+
+          if ((filep->f_oflags & O_NONBLOCK) != 0)
+            {
+              ret = -EAGAIN;
+              break;
+            }
+
+          ret = nxsig_usleep(NOTEPERFETTO_POLL_USEC);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      cctx  = noteperfetto_cpu(&note);
+      saved = *cctx;
+
+      len = noteperfetto_encode(packet, &note, cctx);
+      if (len > buflen - nread)
+        {
+          /* Keep the note for the next read, as if it was never seen */
+
+          *cctx = saved;
+          break;
+        }
+
+      memcpy(buffer + nread, packet, len);
+      nread += len;
+
+      /* Only the reader moves the tail */
+
+      drv->tail = (drv->tail + notelen) %
+                  CONFIG_DRIVERS_NOTEPERFETTO_BUFSIZE;
+    }
+
+  nxmutex_unlock(&drv->mutex);
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: noteperfetto_register
+ ****************************************************************************/
+
+int noteperfetto_register(void)
+{
+  int ret;
+
+  ret = register_driver("/dev/note/perfetto", &g_noteperfetto_fops, 0444,
+                        &g_noteperfetto);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return note_driver_register(&g_noteperfetto.driver);
+}
@@ -31,7 +31,10 @@
 #include <errno.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
+#include <sys/param.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched.h>
 #include <nuttx/sched_note.h>
@@ -72,6 +75,20 @@
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+/* The circular buffer of one CPU.  The positions are free running, the
+ * index in the buffer is the position modulo the buffer size.
+ */
+
+struct noteram_ring_s
+{
+  volatile unsigned int nr_head;  /* Next write position, owner CPU only */
+  volatile unsigned int nr_tail;  /* Oldest note, owner CPU only */
+  volatile unsigned int nr_start; /* Oldest note after clear, reader only */
+  unsigned int nr_read;           /* Next read position, reader only */
+};
+#endif
+
 struct noteram_driver_s
 {
   struct note_driver_s driver;
@@ -82,6 +99,10 @@ struct noteram_driver_s
   volatile unsigned int ni_tail;
   volatile unsigned int ni_read;
   spinlock_t lock;
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  unsigned int ni_ringsize;
+  struct noteram_ring_s ni_ring[NCPUS];
+#endif
 };
 
 /* The structure to hold the context data of trace dump */
@@ -159,6 +180,259 @@ struct noteram_driver_s g_noteram_driver =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+
+/****************************************************************************
+ * Name: noteram_ring_size
+ *
+ * Description:
+ *   Size of the circular buffer of each CPU: The largest power of two that
+ *   fits the share of the CPU in the note buffer.
+ *
+ ****************************************************************************/
+
+static unsigned int noteram_ring_size(FAR struct noteram_driver_s *drv)
+{
+  unsigned int size = drv->ni_ringsize;
+
+  if (size == 0)
+    {
+      DEBUGASSERT(drv->ni_bufsize / NCPUS > 0);
+
+      /* All CPUs compute the same value, no need to serialize */
+
+      size = 1u << (flsl(drv->ni_bufsize / NCPUS) - 1);
+      drv->ni_ringsize = size;
+    }
+
+  return size;
+}
+
+/****************************************************************************
+ * Name: noteram_ring_oldest
+ *
+ * Description:
+ *   Position of the oldest note of a CPU that is still readable.
+ *
+ ****************************************************************************/
+
+static inline unsigned int
+noteram_ring_oldest(FAR struct noteram_ring_s *ring)
+{
+  unsigned int tail = ring->nr_tail;
+  unsigned int start = ring->nr_start;
+
+  return (int)(start - tail) > 0 ? start : tail;
+}
+
+/****************************************************************************
+ * Name: noteram_ring_copy
+ *
+ * Description:
+ *   Copy 'len' bytes at position 'pos' out of the circular buffer of a CPU.
+ *
+ ****************************************************************************/
+
+static void noteram_ring_copy(FAR struct noteram_driver_s *drv, int cpu,
+                              unsigned int pos, FAR void *buffer,
+                              unsigned int len)
+{
+  unsigned int size = noteram_ring_size(drv);
+  FAR uint8_t *base = drv->ni_buffer + cpu * size;
+  unsigned int index = pos & (size - 1);
+  unsigned int space = MIN(size - index, len);
+
+  memcpy(buffer, base + index, space);
+  memcpy((FAR uint8_t *)buffer + space, base, len - space);
+}
+
+/****************************************************************************
+ * Name: noteram_ring_peek
+ *
+ * Description:
+ *   Get the common header of the next unread note of a CPU.  Notes that
+ *   were overwritten before they could be read are skipped.
+ *
+ * Returned Value:
+ *   True if a note is available.
+ *
+ * Assumptions:
+ *   The reader lock is held.
+ *
+ ****************************************************************************/
+
+static bool noteram_ring_peek(FAR struct noteram_driver_s *drv, int cpu,
+                              FAR struct note_common_s *note)
+{
+  FAR struct noteram_ring_s *ring = &drv->ni_ring[cpu];
+  unsigned int oldest;
+  unsigned int head;
+
+  for (; ; )
+    {
+      head = ring->nr_head;
+      SP_DMB();
+
+      oldest = noteram_ring_oldest(ring);
+      if ((int)(ring->nr_read - oldest) < 0)
+        {
+          ring->nr_read = oldest;
+        }
+
+      if (ring->nr_read == head)
+        {
+          return false;
+        }
+
+      noteram_ring_copy(drv, cpu, ring->nr_read, note, sizeof(*note));
+
+      /* The writer moves the tail before it overwrites a note, so the copy
+       * is only valid if the note is still after the tail.
+       */
+
+      SP_DMB();
+      if ((int)(ring->nr_read - ring->nr_tail) >= 0)
+        {
+          return true;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: noteram_buffer_clear
+ *
+ * Description:
+ *   Clear all contents of the circular buffer.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
+{
+  int cpu;
+
+  /* The tail belongs to the writer, which moves it up to nr_start */
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      FAR struct noteram_ring_s *ring = &drv->ni_ring[cpu];
+
+      ring->nr_start = ring->nr_head;
+      ring->nr_read  = ring->nr_start;
+    }
+
+  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+    {
+      drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_DISABLE;
+    }
+}
+
+/****************************************************************************
+ * Name: noteram_rewind
+ *
+ * Description:
+ *   Reset the read position to the oldest note.
+ *
+ ****************************************************************************/
+
+static void noteram_rewind(FAR struct noteram_driver_s *drv)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      drv->ni_ring[cpu].nr_read = noteram_ring_oldest(&drv->ni_ring[cpu]);
+    }
+}
+
+/****************************************************************************
+ * Name: noteram_get
+ *
+ * Description:
+ *   Get the oldest unread note of all CPUs, merging the circular buffers
+ *   of the CPUs by timestamp.
+ *
+ * Input Parameters:
+ *   buffer - Location to return the next note
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   On success, the positive, non-zero length of the return note is
+ *   provided.  Zero is returned only if the circular buffer is empty.  A
+ *   negated errno value is returned in the event of any failure.
+ *
+ ****************************************************************************/
+
+static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
+                           FAR uint8_t *buffer, size_t buflen)
+{
+  FAR struct noteram_ring_s *ring;
+  struct note_common_s best;
+  struct note_common_s note;
+  unsigned int notelen;
+  int bestcpu;
+  int cpu;
+
+  DEBUGASSERT(buffer != NULL);
+
+  for (; ; )
+    {
+      bestcpu = -1;
+      for (cpu = 0; cpu < NCPUS; cpu++)
+        {
+          if (!noteram_ring_peek(drv, cpu, &note))
+            {
+              continue;
+            }
+
+          if (bestcpu < 0 ||
+              note.nc_systime_sec < best.nc_systime_sec ||
+              (note.nc_systime_sec == best.nc_systime_sec &&
+               note.nc_systime_nsec < best.nc_systime_nsec))
+            {
+              best    = note;
+              bestcpu = cpu;
+            }
+        }
+
+      if (bestcpu < 0)
+        {
+          return 0;
+        }
+
+      ring    = &drv->ni_ring[bestcpu];
+      notelen = best.nc_length;
+
+      /* Is the user buffer large enough to hold the note? */
+
+      if (buflen < notelen)
+        {
+          /* Skip the large note so that we do not get constipated. */
+
+          ring->nr_read += notelen;
+          return -EFBIG;
+        }
+
+      noteram_ring_copy(drv, bestcpu, ring->nr_read, buffer, notelen);
+
+      /* Start over if the note was overwritten while copying */
+
+      SP_DMB();
+      if ((int)(ring->nr_read - ring->nr_tail) >= 0)
+        {
+          ring->nr_read += notelen;
+          return notelen;
+        }
+    }
+}
+
+#else /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
 /****************************************************************************
  * Name: noteram_buffer_clear
  *
@@ -312,6 +586,19 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
   drv->ni_tail = noteram_next(drv, tail, length);
 }
 
+/****************************************************************************
+ * Name: noteram_rewind
+ *
+ * Description:
+ *   Reset the read index to the oldest note.
+ *
+ ****************************************************************************/
+
+static void noteram_rewind(FAR struct noteram_driver_s *drv)
+{
+  drv->ni_read = drv->ni_tail;
+}
+
 /****************************************************************************
  * Name: noteram_get
  *
@@ -392,6 +679,8 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
   return notelen;
 }
 
+#endif /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
 /****************************************************************************
  * Name: noteram_open
  ****************************************************************************/
@@ -404,7 +693,7 @@ static int noteram_open(FAR struct file *filep)
 
   /* Reset the read index of the circular buffer */
 
-  drv->ni_read = drv->ni_tail;
+  noteram_rewind(drv);
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -546,6 +835,82 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+static void noteram_add(FAR struct note_driver_s *driver,
+                        FAR const void *note, size_t notelen)
+{
+  FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+  unsigned int size = noteram_ring_size(drv);
+  FAR struct noteram_ring_s *ring;
+  FAR uint8_t *base;
+  unsigned int index;
+  unsigned int space;
+  unsigned int head;
+  unsigned int tail;
+  irqstate_t flags;
+  int cpu;
+
+  /* Only this CPU writes its buffer, keep out the local interrupts and
+   * there is no need for a lock.
+   */
+
+  flags = up_irq_save();
+
+  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+    {
+      up_irq_restore(flags);
+      return;
+    }
+
+  DEBUGASSERT(note != NULL && notelen < size);
+
+  cpu  = this_cpu();
+  ring = &drv->ni_ring[cpu];
+  base = drv->ni_buffer + cpu * size;
+  head = ring->nr_head;
+  tail = noteram_ring_oldest(ring);
+
+  if (size - (head - tail) < notelen)
+    {
+      if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
+        {
+          /* Stop recording if not in overwrite mode */
+
+          drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
+          up_irq_restore(flags);
+          return;
+        }
+
+      /* Remove the notes at the tail, make sure there is enough space */
+
+      do
+        {
+          tail += base[tail & (size - 1)];
+        }
+      while (size - (head - tail) < notelen);
+    }
+
+  /* Publish the new tail before the old notes are overwritten */
+
+  if (tail != ring->nr_tail)
+    {
+      ring->nr_tail = tail;
+      SP_DMB();
+    }
+
+  index = head & (size - 1);
+  space = MIN(size - index, notelen);
+  memcpy(base + index, note, space);
+  memcpy(base, (FAR const uint8_t *)note + space, notelen - space);
+
+  /* Publish the note with a single store of the head */
+
+  SP_DMB();
+  ring->nr_head = head + notelen;
+
+  up_irq_restore(flags);
+}
+#else
 static void noteram_add(FAR struct note_driver_s *driver,
                         FAR const void *note, size_t notelen)
 {
@@ -597,6 +962,7 @@ static void noteram_add(FAR struct note_driver_s *driver,
   drv->ni_head = noteram_next(drv, head, notelen);
   spin_unlock_irqrestore_wo_note(&drv->lock, flags);
 }
+#endif
 
 /****************************************************************************
  * Name: noteram_dump_init_context
@@ -1143,6 +1509,10 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
   drv->ni_head = 0;
   drv->ni_tail = 0;
   drv->ni_read = 0;
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  drv->ni_ringsize = 0;
+  memset(drv->ni_ring, 0, sizeof(drv->ni_ring));
+#endif
 
   ret = note_driver_register(&drv->driver);
   if (ret < 0)
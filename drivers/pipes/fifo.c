@@ -49,10 +49,12 @@ static const struct file_operations g_fifo_fops =
   pipecommon_ioctl,    /* ioctl */
   NULL,                /* mmap */
   NULL,                /* truncate */
-  pipecommon_poll      /* poll */
+  pipecommon_poll,     /* poll */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  , pipecommon_unlink  /* unlink */
+  pipecommon_unlink,   /* unlink */
 #endif
+  pipecommon_readv,    /* readv */
+  pipecommon_writev    /* writev */
 };
 
 /****************************************************************************
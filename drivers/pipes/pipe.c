@@ -65,7 +65,12 @@ static const struct file_operations g_pipe_fops =
   pipecommon_ioctl,    /* ioctl */
   pipe_mmap,           /* mmap */
   NULL,                /* truncate */
-  pipecommon_poll      /* poll */
+  pipecommon_poll,     /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  NULL,                /* unlink */
+#endif
+  pipecommon_readv,    /* readv */
+  pipecommon_writev    /* writev */
 };
 
 static mutex_t g_pipelock = NXMUTEX_INITIALIZER;
@@ -28,6 +28,7 @@
 #include <sys/stat.h>
 #include <sys/ioctl.h>
 #include <sys/param.h>
+#include <sys/uio.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -79,6 +80,396 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_waitdata
+ *
+ * Description:
+ *   Wait until the pipe is not empty.  The device lock is held on entry;
+ *   it is still held if data is available and released otherwise.
+ *
+ * Returned Value:
+ *   The number of bytes in the pipe; zero at the end of file (there are no
+ *   writers), or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_waitdata(FAR struct pipe_dev_s *dev,
+                                   bool nonblock)
+{
+  int ret;
+
+  while (circbuf_is_empty(&dev->d_buffer))
+    {
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return 0;
+        }
+
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (nonblock)
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      /* Otherwise, wait for something to be written to the pipe */
+
+      nxmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_rdsem);
+
+      if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
+        {
+          /* May fail because a signal was received or if the task was
+           * canceled.
+           */
+
+          return ret;
+        }
+    }
+
+  return circbuf_used(&dev->d_buffer);
+}
+
+/****************************************************************************
+ * Name: pipecommon_readdone
+ *
+ * Description:
+ *   Notify the writers after data was removed from the pipe.
+ *
+ ****************************************************************************/
+
+static void pipecommon_readdone(FAR struct pipe_dev_s *dev)
+{
+  /* Notify all poll/select waiters that they can write to the
+   * FIFO when buffer can accept more than d_polloutthrd bytes.
+   */
+
+  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+    }
+
+  /* Notify all waiting writers that bytes have been removed from the
+   * buffer.
+   */
+
+  pipecommon_wakeup(&dev->d_wrsem);
+}
+
+/****************************************************************************
+ * Name: pipecommon_writedone
+ *
+ * Description:
+ *   Notify the readers after data was added to the pipe.
+ *
+ ****************************************************************************/
+
+static void pipecommon_writedone(FAR struct pipe_dev_s *dev)
+{
+  /* Notify all poll/select waiters that they can read from the FIFO when
+   * buffer used exceeds poll threshold.
+   */
+
+  if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+    }
+
+  /* Notify all of the waiting readers that more data is available */
+
+  pipecommon_wakeup(&dev->d_rdsem);
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitspace
+ *
+ * Description:
+ *   Wait until the pipe is not full.  The device lock is held on entry;
+ *   it is still held on success and released on failure.
+ *
+ ****************************************************************************/
+
+static int pipecommon_waitspace(FAR struct pipe_dev_s *dev, bool nonblock)
+{
+  int ret;
+
+  for (; ; )
+    {
+      if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return -EPIPE;
+        }
+
+      if (!circbuf_is_full(&dev->d_buffer))
+        {
+          return OK;
+        }
+
+      if (nonblock)
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_wrsem);
+      if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_readiov
+ ****************************************************************************/
+
+static ssize_t pipecommon_readiov(FAR struct pipe_dev_s *dev,
+                                  FAR const struct iovec *iov, int iovcnt,
+                                  bool nonblock)
+{
+  ssize_t nread = 0;
+  size_t  len   = 0;
+  ssize_t n;
+  int     ret;
+  int     i;
+
+  DEBUGASSERT(dev);
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* Make sure that we have exclusive access to the device structure */
+
+  ret = nxmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      /* May fail because a signal was received or if the task was
+       * canceled.
+       */
+
+      return ret;
+    }
+
+  /* If the pipe is empty, then wait for something to be written to it */
+
+  n = pipecommon_waitdata(dev, nonblock);
+  if (n <= 0)
+    {
+      return n;
+    }
+
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte), filling the segments in order.
+   */
+
+  for (i = 0; i < iovcnt && !circbuf_is_empty(&dev->d_buffer); i++)
+    {
+      n = circbuf_read(&dev->d_buffer, iov[i].iov_base, iov[i].iov_len);
+      pipe_dumpbuffer("From PIPE:", iov[i].iov_base, n);
+      nread += n;
+    }
+
+  pipecommon_readdone(dev);
+
+  nxmutex_unlock(&dev->d_bflock);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipecommon_writeiov
+ *
+ * Description:
+ *   Write all segments under one lock, so that a gathered write is not
+ *   interleaved with the writes of other writers.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_writeiov(FAR struct pipe_dev_s *dev,
+                                   FAR const struct iovec *iov, int iovcnt,
+                                   bool nonblock)
+{
+  ssize_t nwritten = 0;
+  size_t  len      = 0;
+  size_t  off      = 0;
+  ssize_t last;
+  int     ret;
+  int     i;
+
+  DEBUGASSERT(dev);
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)iov[i].iov_base,
+                      iov[i].iov_len);
+      len += iov[i].iov_len;
+    }
+
+  /* Handle zero-length writes */
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* At present, this method cannot be called from interrupt handlers.  That
+   * is because it calls nxmutex_lock() and nxmutex_lock() cannot be called
+   * form interrupt level. This actually happens fairly commonly
+   * IF [a-z]err() is called from interrupt handlers and stdout is being
+   * redirected via a pipe.  In that case, the debug output will try to go
+   * out the pipe (interrupt handlers should use the _err() APIs).
+   *
+   * On the other hand, it would be very valuable to be able to feed the pipe
+   * from an interrupt handler!  TODO:  Consider disabling interrupts instead
+   * of taking semaphores so that pipes can be written from interrupt
+   * handlers.
+   */
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  /* Make sure that we have exclusive access to the device structure */
+
+  ret = nxmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      /* May fail because a signal was received or if the task was
+       * canceled.
+       */
+
+      return ret;
+    }
+
+  /* Loop until all of the bytes have been written */
+
+  last = 0;
+  i    = 0;
+  for (; ; )
+    {
+      /* REVISIT:  "If all file descriptors referring to the read end of a
+       * pipe have been closed, then a write will cause a SIGPIPE signal to
+       * be generated for the calling process.  If the calling process is
+       * ignoring this signal, then write(2) fails with the error EPIPE."
+       */
+
+      if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return nwritten == 0 ? -EPIPE : nwritten;
+        }
+
+      /* Would the next write overflow the circular buffer? */
+
+      if (!circbuf_is_full(&dev->d_buffer))
+        {
+          /* Copy segments until the buffer is full */
+
+          while (i < iovcnt && !circbuf_is_full(&dev->d_buffer))
+            {
+              ssize_t n = circbuf_write(&dev->d_buffer,
+                                        (FAR const char *)iov[i].iov_base +
+                                        off, iov[i].iov_len - off);
+
+              nwritten += n;
+              off      += n;
+              if (off == iov[i].iov_len)
+                {
+                  off = 0;
+                  i++;
+                }
+            }
+
+          if ((size_t)nwritten == len)
+            {
+              /* Notify all poll/select waiters that they can read from the
+               * FIFO when buffer used exceeds poll threshold.
+               */
+
+              if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
+                {
+                  poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS,
+                              POLLIN);
+                }
+
+              /* Yes.. Notify all of the waiting readers that more data is
+               * available.
+               */
+
+              pipecommon_wakeup(&dev->d_rdsem);
+
+              /* Return the number of bytes written */
+
+              nxmutex_unlock(&dev->d_bflock);
+              return len;
+            }
+        }
+      else
+        {
+          /* There is not enough room for the next byte.  Was anything
+           * written in this pass?
+           */
+
+          if (last < nwritten)
+            {
+              /* Notify all poll/select waiters that they can read from the
+               * FIFO.
+               */
+
+              poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+
+              /* Yes.. Notify all of the waiting readers that more data is
+               * available.
+               */
+
+              pipecommon_wakeup(&dev->d_rdsem);
+            }
+
+          last = nwritten;
+
+          /* If O_NONBLOCK was set, then return partial bytes written or
+           * EGAIN.
+           */
+
+          if (nonblock)
+            {
+              if (nwritten == 0)
+                {
+                  nwritten = -EAGAIN;
+                }
+
+              nxmutex_unlock(&dev->d_bflock);
+              return nwritten;
+            }
+
+          /* There is more to be written.. wait for data to be removed from
+           * the pipe
+           */
+
+          nxmutex_unlock(&dev->d_bflock);
+          ret = nxsem_wait(&dev->d_wrsem);
+          if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
+            {
+              /* Either call nxsem_wait may fail because a signal was
+               * received or if the task was canceled.
+               */
+
+              return nwritten == 0 ? (ssize_t)ret : nwritten;
+            }
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -390,263 +781,412 @@ int pipecommon_close(FAR struct file *filep)
        * device structure as well to prevent a memory leak.
        */
 
-      if (PIPE_IS_UNLINKED(dev->d_flags))
-        {
-          pipecommon_freedev(dev);
-          return OK;
-        }
-#endif
-    }
+      if (PIPE_IS_UNLINKED(dev->d_flags))
+        {
+          pipecommon_freedev(dev);
+          return OK;
+        }
+#endif
+    }
+
+  nxmutex_unlock(&dev->d_bflock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pipecommon_read
+ ****************************************************************************/
+
+ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
+{
+  struct iovec iov;
+
+  iov.iov_base = buffer;
+  iov.iov_len  = len;
+  return pipecommon_readv(filep, &iov, 1);
+}
+
+/****************************************************************************
+ * Name: pipecommon_readv
+ ****************************************************************************/
+
+ssize_t pipecommon_readv(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  return pipecommon_readiov(inode->i_private, iov, iovcnt,
+                            (filep->f_oflags & O_NONBLOCK) != 0);
+}
+
+/****************************************************************************
+ * Name: pipecommon_write
+ ****************************************************************************/
+
+ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t len)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR char *)buffer;
+  iov.iov_len  = len;
+  return pipecommon_writev(filep, &iov, 1);
+}
+
+/****************************************************************************
+ * Name: pipecommon_writev
+ ****************************************************************************/
 
-  nxmutex_unlock(&dev->d_bflock);
-  return OK;
+ssize_t pipecommon_writev(FAR struct file *filep,
+                          FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  return pipecommon_writeiov(inode->i_private, iov, iovcnt,
+                             (filep->f_oflags & O_NONBLOCK) != 0);
 }
 
 /****************************************************************************
- * Name: pipecommon_read
+ * Name: pipecommon_splice_read
+ *
+ * Description:
+ *   Move up to len bytes out of the pipe into another file.  The data is
+ *   written to the file straight from the pipe buffer; it is removed from
+ *   the pipe as far as the file accepted it.
+ *
+ * Input Parameters:
+ *   filep    - The read end of the pipe
+ *   outfile  - The file that receives the data, not a pipe
+ *   offset   - The position to write at, or NULL to use the file position
+ *   len      - The largest number of bytes to move
+ *   nonblock - Do not wait for data in the pipe
+ *
+ * Returned Value:
+ *   The number of bytes moved; zero at the end of file, or a negated errno
+ *   value on failure.
+ *
  ****************************************************************************/
 
-ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
+ssize_t pipecommon_splice_read(FAR struct file *filep,
+                               FAR struct file *outfile,
+                               FAR off_t *offset, size_t len, bool nonblock)
 {
   FAR struct inode      *inode = filep->f_inode;
   FAR struct pipe_dev_s *dev   = inode->i_private;
+  FAR void              *buf;
   ssize_t                nread = 0;
-  int                    ret;
+  ssize_t                ret;
+  size_t                 n;
 
   DEBUGASSERT(dev);
 
-  if (len == 0)
-    {
-      return 0;
-    }
-
-  /* Make sure that we have exclusive access to the device structure */
-
   ret = nxmutex_lock(&dev->d_bflock);
   if (ret < 0)
     {
-      /* May fail because a signal was received or if the task was
-       * canceled.
-       */
+      return ret;
+    }
 
+  ret = pipecommon_waitdata(dev, nonblock);
+  if (ret <= 0)
+    {
       return ret;
     }
 
-  /* If the pipe is empty, then wait for something to be written to it */
+  /* At most two contiguous segments, before and after the wrap */
 
-  while (circbuf_is_empty(&dev->d_buffer))
+  while ((size_t)nread < len)
     {
-      /* If there are no writers on the pipe, then return end of file */
-
-      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+      buf = circbuf_get_readptr(&dev->d_buffer, &n);
+      if (n == 0)
         {
-          nxmutex_unlock(&dev->d_bflock);
-          return 0;
+          break;
         }
 
-      /* If O_NONBLOCK was set, then return EGAIN */
-
-      if (filep->f_oflags & O_NONBLOCK)
+      n = MIN(n, len - nread);
+      if (offset != NULL)
         {
-          nxmutex_unlock(&dev->d_bflock);
-          return -EAGAIN;
+          ret = file_pwrite(outfile, buf, n, *offset);
+        }
+      else
+        {
+          ret = file_write(outfile, buf, n);
         }
 
-      /* Otherwise, wait for something to be written to the pipe */
+      if (ret <= 0)
+        {
+          if (nread == 0)
+            {
+              nread = ret;
+            }
 
-      nxmutex_unlock(&dev->d_bflock);
-      ret = nxsem_wait(&dev->d_rdsem);
+          break;
+        }
 
-      if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
+      pipe_dumpbuffer("From PIPE:", buf, ret);
+      circbuf_readcommit(&dev->d_buffer, ret);
+      if (offset != NULL)
         {
-          /* May fail because a signal was received or if the task was
-           * canceled.
-           */
+          *offset += ret;
+        }
 
-          return ret;
+      nread += ret;
+      if ((size_t)ret < n)
+        {
+          break;
         }
     }
 
-  /* Then return whatever is available in the pipe (which is at least one
-   * byte).
-   */
-
-  nread = circbuf_read(&dev->d_buffer, buffer, len);
-
-  /* Notify all poll/select waiters that they can write to the
-   * FIFO when buffer can accept more than d_polloutthrd bytes.
-   */
-
-  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
+  if (nread > 0)
     {
-      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+      pipecommon_readdone(dev);
     }
 
-  /* Notify all waiting writers that bytes have been removed from the
-   * buffer.
-   */
-
-  pipecommon_wakeup(&dev->d_wrsem);
-
   nxmutex_unlock(&dev->d_bflock);
-  pipe_dumpbuffer("From PIPE:", buffer, nread);
   return nread;
 }
 
 /****************************************************************************
- * Name: pipecommon_write
+ * Name: pipecommon_splice_write
+ *
+ * Description:
+ *   Move up to len bytes from another file into the pipe.  The data is
+ *   read from the file straight into the pipe buffer.
+ *
+ * Input Parameters:
+ *   filep    - The write end of the pipe
+ *   infile   - The file that provides the data, not a pipe
+ *   offset   - The position to read at, or NULL to use the file position
+ *   len      - The largest number of bytes to move
+ *   nonblock - Do not wait for room in the pipe
+ *
+ * Returned Value:
+ *   The number of bytes moved; zero at the end of the input file, or a
+ *   negated errno value on failure.
+ *
  ****************************************************************************/
 
-ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t len)
+ssize_t pipecommon_splice_write(FAR struct file *filep,
+                                FAR struct file *infile,
+                                FAR off_t *offset, size_t len,
+                                bool nonblock)
 {
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
+  FAR void              *buf;
   ssize_t                nwritten = 0;
-  ssize_t                last;
-  int                    ret;
+  ssize_t                ret;
+  size_t                 n;
 
   DEBUGASSERT(dev);
-  pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)buffer, len);
-
-  /* Handle zero-length writes */
 
-  if (len == 0)
+  ret = nxmutex_lock(&dev->d_bflock);
+  if (ret < 0)
     {
-      return 0;
+      return ret;
     }
 
-  /* At present, this method cannot be called from interrupt handlers.  That
-   * is because it calls nxmutex_lock() and nxmutex_lock() cannot be called
-   * form interrupt level. This actually happens fairly commonly
-   * IF [a-z]err() is called from interrupt handlers and stdout is being
-   * redirected via a pipe.  In that case, the debug output will try to go
-   * out the pipe (interrupt handlers should use the _err() APIs).
-   *
-   * On the other hand, it would be very valuable to be able to feed the pipe
-   * from an interrupt handler!  TODO:  Consider disabling interrupts instead
-   * of taking semaphores so that pipes can be written from interrupt
-   * handlers.
-   */
-
-  DEBUGASSERT(up_interrupt_context() == false);
-
-  /* Make sure that we have exclusive access to the device structure */
-
-  ret = nxmutex_lock(&dev->d_bflock);
+  ret = pipecommon_waitspace(dev, nonblock);
   if (ret < 0)
     {
-      /* May fail because a signal was received or if the task was
-       * canceled.
-       */
-
       return ret;
     }
 
-  /* Loop until all of the bytes have been written */
-
-  last = 0;
-  for (; ; )
+  while ((size_t)nwritten < len)
     {
-      /* REVISIT:  "If all file descriptors referring to the read end of a
-       * pipe have been closed, then a write will cause a SIGPIPE signal to
-       * be generated for the calling process.  If the calling process is
-       * ignoring this signal, then write(2) fails with the error EPIPE."
-       */
+      buf = circbuf_get_writeptr(&dev->d_buffer, &n);
+      if (n == 0)
+        {
+          break;
+        }
 
-      if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+      n = MIN(n, len - nwritten);
+      if (offset != NULL)
         {
-          nxmutex_unlock(&dev->d_bflock);
-          return nwritten == 0 ? -EPIPE : nwritten;
+          ret = file_pread(infile, buf, n, *offset);
+        }
+      else
+        {
+          ret = file_read(infile, buf, n);
         }
 
-      /* Would the next write overflow the circular buffer? */
+      if (ret <= 0)
+        {
+          if (nwritten == 0)
+            {
+              nwritten = ret;
+            }
 
-      if (!circbuf_is_full(&dev->d_buffer))
+          break;
+        }
+
+      pipe_dumpbuffer("To PIPE:", buf, ret);
+      circbuf_writecommit(&dev->d_buffer, ret);
+      if (offset != NULL)
         {
-          /* Loop until all of the bytes have been written */
+          *offset += ret;
+        }
 
-          nwritten += circbuf_write(&dev->d_buffer,
-                                    buffer + nwritten, len - nwritten);
+      nwritten += ret;
+      if ((size_t)ret < n)
+        {
+          break;
+        }
+    }
 
-          if ((size_t)nwritten == len)
-            {
-              /* Notify all poll/select waiters that they can read from the
-               * FIFO when buffer used exceeds poll threshold.
-               */
+  if (nwritten > 0)
+    {
+      pipecommon_writedone(dev);
+    }
 
-              if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
-                {
-                  poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS,
-                              POLLIN);
-                }
+  nxmutex_unlock(&dev->d_bflock);
+  return nwritten;
+}
 
-              /* Yes.. Notify all of the waiting readers that more data is
-               * available.
-               */
+/****************************************************************************
+ * Name: pipecommon_transfer
+ *
+ * Description:
+ *   Copy up to len bytes from one pipe buffer to another, and remove them
+ *   from the first pipe unless this is a tee.  Both locks are taken, in
+ *   address order so that opposite transfers do not deadlock.
+ *
+ * Input Parameters:
+ *   infile   - The read end of the source pipe
+ *   outfile  - The write end of the destination pipe
+ *   len      - The largest number of bytes to copy
+ *   consume  - Remove the bytes from the source pipe (splice, not tee)
+ *   nonblock - Do not wait for data or room
+ *
+ * Returned Value:
+ *   The number of bytes copied; zero at the end of file, or a negated
+ *   errno value on failure.
+ *
+ ****************************************************************************/
 
-              pipecommon_wakeup(&dev->d_rdsem);
+ssize_t pipecommon_transfer(FAR struct file *infile,
+                            FAR struct file *outfile, size_t len,
+                            bool consume, bool nonblock)
+{
+  FAR struct pipe_dev_s *in  = infile->f_inode->i_private;
+  FAR struct pipe_dev_s *out = outfile->f_inode->i_private;
+  FAR struct pipe_dev_s *first;
+  FAR struct pipe_dev_s *second;
+  FAR sem_t             *sem;
+  FAR void              *buf;
+  size_t                 ncopied = 0;
+  size_t                 n;
+  int                    ret;
 
-              /* Return the number of bytes written */
+  DEBUGASSERT(in && out);
 
-              nxmutex_unlock(&dev->d_bflock);
-              return len;
-            }
+  if (in == out)
+    {
+      return -EINVAL;
+    }
+
+  first  = in < out ? in : out;
+  second = in < out ? out : in;
+
+  for (; ; )
+    {
+      ret = nxmutex_lock(&first->d_bflock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = nxmutex_lock(&second->d_bflock);
+      if (ret < 0)
+        {
+          nxmutex_unlock(&first->d_bflock);
+          return ret;
+        }
+
+      if (circbuf_is_empty(&in->d_buffer))
+        {
+          ret = in->d_nwriters <= 0 && PIPE_IS_POLICY_0(in->d_flags) ?
+                0 : -EAGAIN;
+          sem = &in->d_rdsem;
+        }
+      else if (out->d_nreaders <= 0 && PIPE_IS_POLICY_0(out->d_flags))
+        {
+          ret = -EPIPE;
+          sem = NULL;
+        }
+      else if (circbuf_is_full(&out->d_buffer))
+        {
+          ret = -EAGAIN;
+          sem = &out->d_wrsem;
         }
       else
         {
-          /* There is not enough room for the next byte.  Was anything
-           * written in this pass?
-           */
+          break;
+        }
 
-          if (last < nwritten)
-            {
-              /* Notify all poll/select waiters that they can read from the
-               * FIFO.
-               */
+      nxmutex_unlock(&second->d_bflock);
+      nxmutex_unlock(&first->d_bflock);
 
-              poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+      if (ret != -EAGAIN || nonblock)
+        {
+          return ret;
+        }
 
-              /* Yes.. Notify all of the waiting readers that more data is
-               * available.
-               */
+      ret = nxsem_wait(sem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
 
-              pipecommon_wakeup(&dev->d_rdsem);
-            }
+  len = MIN(len, circbuf_used(&in->d_buffer));
+  while (ncopied < len)
+    {
+      buf = circbuf_get_writeptr(&out->d_buffer, &n);
+      if (n == 0)
+        {
+          break;
+        }
 
-          last = nwritten;
+      n = MIN(n, len - ncopied);
+      circbuf_peekat(&in->d_buffer, in->d_buffer.tail + ncopied, buf, n);
+      circbuf_writecommit(&out->d_buffer, n);
+      ncopied += n;
+    }
 
-          /* If O_NONBLOCK was set, then return partial bytes written or
-           * EGAIN.
-           */
+  if (consume)
+    {
+      circbuf_readcommit(&in->d_buffer, ncopied);
+      pipecommon_readdone(in);
+    }
 
-          if (filep->f_oflags & O_NONBLOCK)
-            {
-              if (nwritten == 0)
-                {
-                  nwritten = -EAGAIN;
-                }
+  pipecommon_writedone(out);
 
-              nxmutex_unlock(&dev->d_bflock);
-              return nwritten;
-            }
+  nxmutex_unlock(&second->d_bflock);
+  nxmutex_unlock(&first->d_bflock);
+  return ncopied;
+}
 
-          /* There is more to be written.. wait for data to be removed from
-           * the pipe
-           */
+/****************************************************************************
+ * Name: pipecommon_vmsplice
+ *
+ * Description:
+ *   Write the segments to the write end of a pipe, or read them from the
+ *   read end.
+ *
+ ****************************************************************************/
 
-          nxmutex_unlock(&dev->d_bflock);
-          ret = nxsem_wait(&dev->d_wrsem);
-          if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
-            {
-              /* Either call nxsem_wait may fail because a signal was
-               * received or if the task was canceled.
-               */
+ssize_t pipecommon_vmsplice(FAR struct file *filep,
+                            FAR const struct iovec *iov, int iovcnt,
+                            bool nonblock)
+{
+  FAR struct inode *inode = filep->f_inode;
 
-              return nwritten == 0 ? (ssize_t)ret : nwritten;
-            }
-        }
+  if ((filep->f_oflags & O_WROK) != 0)
+    {
+      return pipecommon_writeiov(inode->i_private, iov, iovcnt, nonblock);
     }
+
+  return pipecommon_readiov(inode->i_private, iov, iovcnt, nonblock);
 }
 
 /****************************************************************************
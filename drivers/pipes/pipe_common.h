@@ -151,6 +151,7 @@ extern "C"
 
 struct file;  /* Forward reference */
 struct inode; /* Forward reference */
+struct iovec; /* Forward reference */
 
 FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize);
 void    pipecommon_freedev(FAR struct pipe_dev_s *dev);
@@ -158,6 +159,23 @@ int     pipecommon_open(FAR struct file *filep);
 int     pipecommon_close(FAR struct file *filep);
 ssize_t pipecommon_read(FAR struct file *, FAR char *, size_t);
 ssize_t pipecommon_write(FAR struct file *, FAR const char *, size_t);
+ssize_t pipecommon_readv(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt);
+ssize_t pipecommon_writev(FAR struct file *filep,
+                          FAR const struct iovec *iov, int iovcnt);
+ssize_t pipecommon_splice_read(FAR struct file *filep,
+                               FAR struct file *outfile,
+                               FAR off_t *offset, size_t len, bool nonblock);
+ssize_t pipecommon_splice_write(FAR struct file *filep,
+                                FAR struct file *infile,
+                                FAR off_t *offset, size_t len,
+                                bool nonblock);
+ssize_t pipecommon_transfer(FAR struct file *infile,
+                            FAR struct file *outfile, size_t len,
+                            bool consume, bool nonblock);
+ssize_t pipecommon_vmsplice(FAR struct file *filep,
+                            FAR const struct iovec *iov, int iovcnt,
+                            bool nonblock);
 int     pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 int     pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
                                bool setup);
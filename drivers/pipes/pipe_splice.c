@@ -0,0 +1,307 @@
+/****************************************************************************
+ * drivers/pipes/pipe_splice.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "pipe_common.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pipe_nonblock
+ *
+ * Description:
+ *   A pipe end does not block if the call or the pipe asks for it.
+ *
+ ****************************************************************************/
+
+static bool pipe_nonblock(FAR struct file *filep, unsigned int flags)
+{
+  return (flags & SPLICE_F_NONBLOCK) != 0 ||
+         (filep->f_oflags & O_NONBLOCK) != 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t len, unsigned int flags)
+{
+  bool inpipe  = INODE_IS_PIPE(infile->f_inode);
+  bool outpipe = INODE_IS_PIPE(outfile->f_inode);
+
+  if ((infile->f_oflags & O_RDOK) == 0 || (outfile->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  /* The position of a pipe can't be given */
+
+  if ((inpipe && inoff != NULL) || (outpipe && outoff != NULL))
+    {
+      return -ESPIPE;
+    }
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  if (inpipe && outpipe)
+    {
+      return pipecommon_transfer(infile, outfile, len, true,
+                                 pipe_nonblock(infile, flags) ||
+                                 pipe_nonblock(outfile, flags));
+    }
+  else if (inpipe)
+    {
+      return pipecommon_splice_read(infile, outfile, outoff, len,
+                                    pipe_nonblock(infile, flags));
+    }
+  else if (outpipe)
+    {
+      return pipecommon_splice_write(outfile, infile, inoff, len,
+                                     pipe_nonblock(outfile, flags));
+    }
+
+  /* One of the files must be a pipe */
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: file_tee
+ *
+ * Description:
+ *   Equivalent to the standard tee function except that is accepts struct
+ *   file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags)
+{
+  if (!INODE_IS_PIPE(infile->f_inode) || !INODE_IS_PIPE(outfile->f_inode))
+    {
+      return -EINVAL;
+    }
+
+  if ((infile->f_oflags & O_RDOK) == 0 || (outfile->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  return pipecommon_transfer(infile, outfile, len, false,
+                             pipe_nonblock(infile, flags) ||
+                             pipe_nonblock(outfile, flags));
+}
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves data between two file descriptors, one of which must
+ *   refer to a pipe.  The data is copied once, between the pipe buffer
+ *   and the other file, without going through a user buffer.
+ *
+ * Input Parameters:
+ *   fdin    - The descriptor to read from
+ *   offin   - The position to read at if fdin is not a pipe, or NULL to
+ *             use and update the file position.  It is updated.
+ *   fdout   - The descriptor to write to
+ *   offout  - The position to write at if fdout is not a pipe, or NULL
+ *   len     - The largest number of bytes to move
+ *   flags   - SPLICE_F_NONBLOCK makes the pipe operations non-blocking;
+ *             the other flags are hints that are ignored.
+ *
+ * Returned Value:
+ *   The number of bytes moved; zero at the end of the input.  On error,
+ *   -1 is returned, and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fdin, FAR off_t *offin, int fdout, FAR off_t *offout,
+               size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = fs_getfilep(fdin, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fdout, &outfile);
+  if (ret < 0)
+    {
+      fs_putfilep(infile);
+      goto errout;
+    }
+
+  ret = file_splice(infile, offin, outfile, offout, len, flags);
+  fs_putfilep(outfile);
+  fs_putfilep(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   tee() duplicates up to len bytes of the pipe fdin into the pipe fdout
+ *   without consuming them.
+ *
+ * Returned Value:
+ *   The number of bytes duplicated; zero if fdin is empty and has no
+ *   writers.  On error, -1 is returned, and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fdin, int fdout, size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = fs_getfilep(fdin, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fdout, &outfile);
+  if (ret < 0)
+    {
+      fs_putfilep(infile);
+      goto errout;
+    }
+
+  ret = file_tee(infile, outfile, len, flags);
+  fs_putfilep(outfile);
+  fs_putfilep(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: vmsplice
+ *
+ * Description:
+ *   vmsplice() writes the segments to the pipe fd if it is the write end,
+ *   or fills them from the pipe if it is the read end.  There are no pages
+ *   to give away in the flat NuttX address space, so the data is copied
+ *   once, like writev() and readv().
+ *
+ * Returned Value:
+ *   The number of bytes transferred.  On error, -1 is returned, and errno
+ *   is set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t vmsplice(int fd, FAR const struct iovec *iov, size_t nr_segs,
+                 unsigned int flags)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  if (nr_segs > IOV_MAX)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!INODE_IS_PIPE(filep->f_inode))
+    {
+      ret = -EBADF;
+    }
+  else
+    {
+      ret = pipecommon_vmsplice(filep, iov, nr_segs,
+                                pipe_nonblock(filep, flags));
+    }
+
+  fs_putfilep(filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
@@ -0,0 +1,627 @@
+/****************************************************************************
+ * drivers/power/cpufreq/cpufreq.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <sched.h>
+#include <sys/param.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/power/pm.h>
+
+#include "cpufreq.h"
+
+#ifdef CONFIG_CPUFREQ
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct cpufreq_qos
+{
+  struct list_node node;
+  FAR struct cpufreq_policy_s *p;
+  unsigned int min;
+  unsigned int max;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_PM
+static int cpufreq_pm_prepare(FAR struct pm_callback_s *cb, int domain,
+                              enum pm_state_e pmstate);
+static void cpufreq_pm_notify(FAR struct pm_callback_s *cb, int domain,
+                              enum pm_state_e pmstate);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static mutex_t g_cpufreq_lock = NXMUTEX_INITIALIZER;
+static FAR struct cpufreq_policy_s *g_cpufreq_policy[CONFIG_SMP_NCPUS];
+
+#ifdef CONFIG_PM
+static struct pm_callback_s g_cpufreq_pmcb =
+{
+  .prepare = cpufreq_pm_prepare,
+  .notify  = cpufreq_pm_notify,
+};
+
+static bool g_cpufreq_pmregistered;
+static bool g_cpufreq_pmsuspended;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpufreq_find_index
+ *
+ * Description:
+ *   Return the index of the lowest frequency not below 'freq' and not
+ *   above 'max', or of the highest frequency not above 'max' if there is
+ *   none.
+ *
+ ****************************************************************************/
+
+static unsigned int cpufreq_find_index(FAR struct cpufreq_policy_s *p,
+                                       unsigned int freq, unsigned int max)
+{
+  FAR const struct cpufreq_frequency_table *table = p->table;
+  unsigned int below = 0;
+  unsigned int best = 0;
+  bool found = false;
+  unsigned int i;
+
+  for (i = 0; table[i].frequency != CPUFREQ_TABLE_END; i++)
+    {
+      unsigned int f = table[i].frequency;
+
+      if (f > max)
+        {
+          continue;
+        }
+
+      if (f >= freq && (!found || f < table[best].frequency))
+        {
+          best  = i;
+          found = true;
+        }
+
+      if (f > table[below].frequency || table[below].frequency > max)
+        {
+          below = i;
+        }
+    }
+
+  return found ? best : below;
+}
+
+/****************************************************************************
+ * Name: cpufreq_qos_aggregate
+ ****************************************************************************/
+
+static void cpufreq_qos_aggregate(FAR struct cpufreq_policy_s *p)
+{
+  FAR struct cpufreq_qos *qos;
+
+  p->min = p->fmin;
+  p->max = p->fmax;
+
+  list_for_every_entry(&p->qos, qos, struct cpufreq_qos, node)
+    {
+      p->min = MAX(p->min, qos->min);
+      p->max = MIN(p->max, qos->max);
+    }
+
+  if (p->max < p->fmin)
+    {
+      p->max = p->fmin;
+    }
+
+  if (p->min > p->max)
+    {
+      p->min = p->max;
+    }
+}
+
+/****************************************************************************
+ * Name: cpufreq_pm_prepare / cpufreq_pm_notify
+ *
+ * Description:
+ *   Suspend all policies when the system enters standby or sleep, and
+ *   resume them when it is back.  A policy that is being changed keeps the
+ *   system out of those states.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PM
+static int cpufreq_pm_prepare(FAR struct pm_callback_s *cb, int domain,
+                              enum pm_state_e pmstate)
+{
+  int cpu;
+
+  if (pmstate < PM_STANDBY)
+    {
+      return OK;
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (g_cpufreq_policy[cpu] != NULL &&
+          nxmutex_is_locked(&g_cpufreq_policy[cpu]->lock))
+        {
+          return -EBUSY;
+        }
+    }
+
+  return OK;
+}
+
+static void cpufreq_pm_notify(FAR struct pm_callback_s *cb, int domain,
+                              enum pm_state_e pmstate)
+{
+  FAR struct cpufreq_policy_s *p;
+  bool suspend = pmstate >= PM_STANDBY;
+  int cpu;
+
+  if (suspend == g_cpufreq_pmsuspended)
+    {
+      return;
+    }
+
+  g_cpufreq_pmsuspended = suspend;
+
+  /* Policies are listed once per CPU, handle each on its first CPU */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      p = g_cpufreq_policy[cpu];
+      if (p == NULL || p->suspended ||
+          (p->cpus & ((1 << cpu) - 1)) != 0)
+        {
+          continue;
+        }
+
+      if (suspend && p->policy.driver->suspend)
+        {
+          p->policy.driver->suspend(&p->policy);
+        }
+      else if (!suspend && p->policy.driver->resume)
+        {
+          p->policy.driver->resume(&p->policy);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpufreq_update
+ ****************************************************************************/
+
+int cpufreq_update(FAR struct cpufreq_policy_s *p)
+{
+  unsigned int index;
+  int ret;
+
+  if (p->suspended)
+    {
+      return OK;
+    }
+
+  index = cpufreq_find_index(p, MAX(p->target, p->min), p->max);
+  if (index == p->cur)
+    {
+      return OK;
+    }
+
+  ret = p->policy.driver->target_index(&p->policy, index);
+  if (ret < 0)
+    {
+      pwrerr("ERROR: Set %u kHz failed: %d\n", p->table[index].frequency,
+             ret);
+      return ret;
+    }
+
+  pwrinfo("%u kHz\n", p->table[index].frequency);
+  p->cur = index;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cpufreq_init
+ ****************************************************************************/
+
+int cpufreq_init(FAR struct cpufreq_driver *driver)
+{
+  return cpufreq_init_cluster(driver, (1 << CONFIG_SMP_NCPUS) - 1);
+}
+
+/****************************************************************************
+ * Name: cpufreq_init_cluster
+ ****************************************************************************/
+
+int cpufreq_init_cluster(FAR struct cpufreq_driver *driver, cpu_set_t cpus)
+{
+  FAR struct cpufreq_policy_s *p;
+  unsigned int i;
+  int cpu;
+  int ret;
+
+  DEBUGASSERT(driver != NULL && driver->get_table != NULL &&
+              driver->target_index != NULL);
+
+  cpus &= (1 << CONFIG_SMP_NCPUS) - 1;
+  if (cpus == 0)
+    {
+      return -EINVAL;
+    }
+
+  p = kmm_zalloc(sizeof(*p));
+  if (p == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  p->policy.driver = driver;
+  p->cpus          = cpus;
+  p->table         = driver->get_table(&p->policy);
+  if (p->table == NULL ||
+      p->table[0].frequency == CPUFREQ_TABLE_END)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  p->fmin = p->table[0].frequency;
+  for (i = 0; p->table[i].frequency != CPUFREQ_TABLE_END; i++)
+    {
+      p->fmin = MIN(p->fmin, p->table[i].frequency);
+      p->fmax = MAX(p->fmax, p->table[i].frequency);
+    }
+
+  nxmutex_init(&p->lock);
+  list_initialize(&p->qos);
+  cpufreq_qos_aggregate(p);
+
+  /* Start at the highest frequency until the governor has a sample.  The
+   * current index is unknown, force the first update.
+   */
+
+  p->target = p->fmax;
+  p->cur    = i;
+
+  nxmutex_lock(&g_cpufreq_lock);
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (CPU_ISSET(cpu, &cpus) && g_cpufreq_policy[cpu] != NULL)
+        {
+          nxmutex_unlock(&g_cpufreq_lock);
+          nxmutex_destroy(&p->lock);
+          ret = -EEXIST;
+          goto errout;
+        }
+    }
+
+  nxmutex_lock(&p->lock);
+  ret = cpufreq_update(p);
+  nxmutex_unlock(&p->lock);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_cpufreq_lock);
+      nxmutex_destroy(&p->lock);
+      goto errout;
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (CPU_ISSET(cpu, &cpus))
+        {
+          g_cpufreq_policy[cpu] = p;
+        }
+    }
+
+#ifdef CONFIG_PM
+  if (!g_cpufreq_pmregistered)
+    {
+      g_cpufreq_pmregistered = pm_register(&g_cpufreq_pmcb) >= 0;
+    }
+#endif
+
+  nxmutex_unlock(&g_cpufreq_lock);
+
+#ifdef CONFIG_CPUFREQ_SCHEDUTIL
+  schedutil_start(p);
+#endif
+
+  return OK;
+
+errout:
+  kmm_free(p);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cpufreq_uninit
+ ****************************************************************************/
+
+int cpufreq_uninit(void)
+{
+  FAR struct cpufreq_policy_s *p;
+  FAR struct cpufreq_qos *qos;
+  FAR struct cpufreq_qos *tmp;
+  int cpu;
+  int i;
+
+  nxmutex_lock(&g_cpufreq_lock);
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      p = g_cpufreq_policy[cpu];
+      if (p == NULL)
+        {
+          continue;
+        }
+
+      for (i = cpu; i < CONFIG_SMP_NCPUS; i++)
+        {
+          if (g_cpufreq_policy[i] == p)
+            {
+              g_cpufreq_policy[i] = NULL;
+            }
+        }
+
+#ifdef CONFIG_CPUFREQ_SCHEDUTIL
+      schedutil_stop(p);
+#endif
+
+      list_for_every_entry_safe(&p->qos, qos, tmp, struct cpufreq_qos,
+                                node)
+        {
+          list_delete(&qos->node);
+          kmm_free(qos);
+        }
+
+      nxmutex_destroy(&p->lock);
+      kmm_free(p);
+    }
+
+#ifdef CONFIG_PM
+  if (g_cpufreq_pmregistered)
+    {
+      pm_unregister(&g_cpufreq_pmcb);
+      g_cpufreq_pmregistered = false;
+    }
+#endif
+
+  nxmutex_unlock(&g_cpufreq_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cpufreq_policy_get
+ ****************************************************************************/
+
+FAR struct cpufreq_policy *cpufreq_policy_get(void)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (g_cpufreq_policy[cpu] != NULL)
+        {
+          return &g_cpufreq_policy[cpu]->policy;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: cpufreq_cpu_policy
+ ****************************************************************************/
+
+FAR struct cpufreq_policy *cpufreq_cpu_policy(int cpu)
+{
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS || g_cpufreq_policy[cpu] == NULL)
+    {
+      return NULL;
+    }
+
+  return &g_cpufreq_policy[cpu]->policy;
+}
+
+/****************************************************************************
+ * Name: cpufreq_get_table
+ ****************************************************************************/
+
+FAR const struct cpufreq_frequency_table *
+cpufreq_get_table(FAR struct cpufreq_policy *policy)
+{
+  return ((FAR struct cpufreq_policy_s *)policy)->table;
+}
+
+/****************************************************************************
+ * Name: cpufreq_qos_add_request
+ ****************************************************************************/
+
+FAR struct cpufreq_qos *
+cpufreq_qos_add_request(FAR struct cpufreq_policy *policy, int min, int max)
+{
+  FAR struct cpufreq_policy_s *p = (FAR struct cpufreq_policy_s *)policy;
+  FAR struct cpufreq_qos *qos;
+
+  if (p == NULL || min < 0 || max < min)
+    {
+      return NULL;
+    }
+
+  qos = kmm_malloc(sizeof(*qos));
+  if (qos == NULL)
+    {
+      return NULL;
+    }
+
+  qos->p   = p;
+  qos->min = min;
+  qos->max = max;
+
+  nxmutex_lock(&p->lock);
+  list_add_tail(&p->qos, &qos->node);
+  cpufreq_qos_aggregate(p);
+  cpufreq_update(p);
+  nxmutex_unlock(&p->lock);
+
+  return qos;
+}
+
+/****************************************************************************
+ * Name: cpufreq_qos_update_request
+ ****************************************************************************/
+
+int cpufreq_qos_update_request(FAR struct cpufreq_qos *qos, int min,
+                               int max)
+{
+  FAR struct cpufreq_policy_s *p;
+  int ret;
+
+  if (qos == NULL || min < 0 || max < min)
+    {
+      return -EINVAL;
+    }
+
+  p = qos->p;
+
+  nxmutex_lock(&p->lock);
+  qos->min = min;
+  qos->max = max;
+  cpufreq_qos_aggregate(p);
+  ret = cpufreq_update(p);
+  nxmutex_unlock(&p->lock);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cpufreq_qos_remove_request
+ ****************************************************************************/
+
+int cpufreq_qos_remove_request(FAR struct cpufreq_qos *qos)
+{
+  FAR struct cpufreq_policy_s *p;
+  int ret;
+
+  if (qos == NULL)
+    {
+      return -EINVAL;
+    }
+
+  p = qos->p;
+
+  nxmutex_lock(&p->lock);
+  list_delete(&qos->node);
+  cpufreq_qos_aggregate(p);
+  ret = cpufreq_update(p);
+  nxmutex_unlock(&p->lock);
+
+  kmm_free(qos);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cpufreq_suspend
+ ****************************************************************************/
+
+int cpufreq_suspend(FAR struct cpufreq_policy *policy)
+{
+  FAR struct cpufreq_policy_s *p = (FAR struct cpufreq_policy_s *)policy;
+  int ret = OK;
+
+  nxmutex_lock(&p->lock);
+
+  if (!p->suspended)
+    {
+      if (policy->driver->suspend)
+        {
+          ret = policy->driver->suspend(policy);
+        }
+
+      p->suspended = ret >= 0;
+    }
+
+  nxmutex_unlock(&p->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cpufreq_resume
+ ****************************************************************************/
+
+int cpufreq_resume(FAR struct cpufreq_policy *policy)
+{
+  FAR struct cpufreq_policy_s *p = (FAR struct cpufreq_policy_s *)policy;
+  unsigned int cur;
+  int ret = OK;
+
+  nxmutex_lock(&p->lock);
+
+  if (p->suspended)
+    {
+      if (policy->driver->resume)
+        {
+          ret = policy->driver->resume(policy);
+        }
+
+      if (ret >= 0)
+        {
+          /* The driver may have changed the clock while suspended */
+
+          cur          = p->cur;
+          p->suspended = false;
+          p->cur       = ~0u;
+          ret          = cpufreq_update(p);
+          if (ret < 0)
+            {
+              p->cur = cur;
+            }
+        }
+    }
+
+  nxmutex_unlock(&p->lock);
+  return ret;
+}
+
+#endif /* CONFIG_CPUFREQ */
@@ -0,0 +1,108 @@
+/****************************************************************************
+ * drivers/power/cpufreq/cpufreq.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __DRIVERS_POWER_CPUFREQ_CPUFREQ_H
+#define __DRIVERS_POWER_CPUFREQ_CPUFREQ_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/cpufreq.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+
+#ifdef CONFIG_CPUFREQ
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* State of the schedutil governor for one policy */
+
+#ifdef CONFIG_CPUFREQ_SCHEDUTIL
+struct schedutil_s
+{
+  struct work_s work;                    /* Periodic sample */
+  clock_t total[CONFIG_SMP_NCPUS];       /* Load counts of the last sample */
+  clock_t active[CONFIG_SMP_NCPUS];
+  clock_t raised;                        /* Time of the last increase */
+  volatile bool boost;                   /* Go to the maximum now */
+  bool running;
+};
+#endif
+
+/* A frequency domain */
+
+struct cpufreq_policy_s
+{
+  struct cpufreq_policy policy;          /* Public part, must be first */
+  FAR const struct cpufreq_frequency_table *table;
+  cpu_set_t cpus;                        /* CPUs of the cluster */
+  mutex_t lock;                          /* Protects all below */
+  struct list_node qos;                  /* List of struct cpufreq_qos */
+  unsigned int fmin;                     /* Range of the table */
+  unsigned int fmax;
+  unsigned int min;                      /* Range allowed by QoS */
+  unsigned int max;
+  unsigned int target;                   /* Frequency asked by the governor */
+  unsigned int cur;                      /* Table index set in the driver */
+  bool suspended;
+#ifdef CONFIG_CPUFREQ_SCHEDUTIL
+  struct schedutil_s gov;
+#endif
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpufreq_update
+ *
+ * Description:
+ *   Apply the governor target, clamped to the QoS range, to the driver.
+ *   The policy lock must be held.
+ *
+ ****************************************************************************/
+
+int cpufreq_update(FAR struct cpufreq_policy_s *p);
+
+/****************************************************************************
+ * Name: schedutil_start / schedutil_stop
+ *
+ * Description:
+ *   Start and stop the load driven governor of a policy.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CPUFREQ_SCHEDUTIL
+void schedutil_start(FAR struct cpufreq_policy_s *p);
+void schedutil_stop(FAR struct cpufreq_policy_s *p);
+#endif
+
+#endif /* CONFIG_CPUFREQ */
+#endif /* __DRIVERS_POWER_CPUFREQ_CPUFREQ_H */
@@ -0,0 +1,214 @@
+/****************************************************************************
+ * drivers/power/cpufreq/schedutil_governor.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <stdint.h>
+#include <sys/param.h>
+
+#include <nuttx/irq.h>
+
+#include "cpufreq.h"
+
+#ifdef CONFIG_CPUFREQ_SCHEDUTIL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SCHEDUTIL_PERIOD MSEC2TICK(CONFIG_CPUFREQ_SCHEDUTIL_PERIOD)
+#define SCHEDUTIL_HOLD   MSEC2TICK(CONFIG_CPUFREQ_SCHEDUTIL_DOWN_DELAY)
+
+/* Utilization is a fraction of SCHEDUTIL_SCALE.  The next frequency is
+ * chosen so that the load would be 80% of it: freq * util * 5 / 4.
+ */
+
+#define SCHEDUTIL_SCALE  1024
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: schedutil_util
+ *
+ * Description:
+ *   Return the utilization of the busiest CPU of the policy since the last
+ *   sample.
+ *
+ ****************************************************************************/
+
+static uint32_t schedutil_util(FAR struct cpufreq_policy_s *p)
+{
+  FAR struct schedutil_s *gov = &p->gov;
+  struct cpuload_s cpuload;
+  uint32_t util = 0;
+  clock_t active;
+  clock_t total;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (!CPU_ISSET(cpu, &p->cpus) ||
+          clock_cpuload_cpu(cpu, &cpuload) < 0)
+        {
+          continue;
+        }
+
+      total  = cpuload.total - gov->total[cpu];
+      active = cpuload.active - gov->active[cpu];
+      gov->total[cpu]  = cpuload.total;
+      gov->active[cpu] = cpuload.active;
+
+      if (total > 0)
+        {
+          util = MAX(util, (uint32_t)((uint64_t)active * SCHEDUTIL_SCALE /
+                                      total));
+        }
+    }
+
+  return MIN(util, SCHEDUTIL_SCALE);
+}
+
+/****************************************************************************
+ * Name: schedutil_worker
+ *
+ * Description:
+ *   Sample the load and choose the next frequency.  The load is measured
+ *   at the current frequency, so the next one is scaled from it.  A higher
+ *   frequency is applied at once, a lower one only after the frequency
+ *   was not raised for the down delay, so that short idle gaps do not
+ *   make the frequency oscillate.
+ *
+ ****************************************************************************/
+
+static void schedutil_worker(FAR void *arg)
+{
+  FAR struct cpufreq_policy_s *p = arg;
+  FAR struct schedutil_s *gov = &p->gov;
+  clock_t now = clock_systime_ticks();
+  unsigned int target;
+  unsigned int cur;
+  uint32_t util;
+
+  util = schedutil_util(p);
+
+  nxmutex_lock(&p->lock);
+
+  if (gov->boost)
+    {
+      gov->boost = false;
+      target     = p->fmax;
+    }
+  else
+    {
+      cur    = p->table[p->cur].frequency;
+      target = (uint64_t)cur * util * 5 / (4 * SCHEDUTIL_SCALE);
+    }
+
+  if (target > p->target)
+    {
+      gov->raised = now;
+      p->target   = target;
+      cpufreq_update(p);
+    }
+  else if (target < p->target && now - gov->raised >= SCHEDUTIL_HOLD)
+    {
+      p->target = target;
+      cpufreq_update(p);
+    }
+
+  nxmutex_unlock(&p->lock);
+
+  if (gov->running)
+    {
+      work_queue(HPWORK, &gov->work, schedutil_worker, p,
+                 gov->boost ? 0 : SCHEDUTIL_PERIOD);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: schedutil_start
+ ****************************************************************************/
+
+void schedutil_start(FAR struct cpufreq_policy_s *p)
+{
+  FAR struct schedutil_s *gov = &p->gov;
+  struct cpuload_s cpuload;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (clock_cpuload_cpu(cpu, &cpuload) >= 0)
+        {
+          gov->total[cpu]  = cpuload.total;
+          gov->active[cpu] = cpuload.active;
+        }
+    }
+
+  gov->raised  = clock_systime_ticks();
+  gov->running = true;
+  work_queue(HPWORK, &gov->work, schedutil_worker, p, SCHEDUTIL_PERIOD);
+}
+
+/****************************************************************************
+ * Name: schedutil_stop
+ ****************************************************************************/
+
+void schedutil_stop(FAR struct cpufreq_policy_s *p)
+{
+  p->gov.running = false;
+  work_cancel_sync(HPWORK, &p->gov.work);
+}
+
+/****************************************************************************
+ * Name: cpufreq_boost
+ ****************************************************************************/
+
+#ifdef CONFIG_CPUFREQ_SCHEDUTIL_RTBOOST
+void cpufreq_boost(int cpu)
+{
+  FAR struct cpufreq_policy_s *p;
+  irqstate_t flags;
+
+  p = (FAR struct cpufreq_policy_s *)cpufreq_cpu_policy(cpu);
+  if (p == NULL || !p->gov.running || p->gov.boost ||
+      p->target >= p->fmax)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  p->gov.boost = true;
+  work_queue(HPWORK, &p->gov.work, schedutil_worker, p, 0);
+  leave_critical_section(flags);
+}
+#endif
+
+#endif /* CONFIG_CPUFREQ_SCHEDUTIL */
@@ -0,0 +1,537 @@
+/****************************************************************************
+ * drivers/power/pm/pm_hibernate.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <setjmp.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/crc32.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/memoryregion.h>
+#include <nuttx/streams.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mtd/mtd.h>
+#include <nuttx/power/pm.h>
+
+#include <lzf.h>
+
+#ifdef CONFIG_PM_HIBERNATE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PM_HIBERNATE_MAGIC    0x4e425848  /* Image header */
+#define PM_HIBERNATE_END      0x444e4548  /* Image trailer */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The image is the header, the regions compressed by the LZF stream, a
+ * region always starting a new LZF block, and the trailer.
+ */
+
+struct pm_hibernate_region_s
+{
+  uintptr_t start;
+  uintptr_t end;
+};
+
+struct pm_hibernate_header_s
+{
+  uint32_t magic;
+  uint32_t nregions;
+  uintptr_t id;                      /* Identifies the firmware */
+  struct pm_hibernate_region_s region[CONFIG_PM_HIBERNATE_NREGIONS];
+};
+
+struct pm_hibernate_trailer_s
+{
+  uint32_t magic;
+  uint32_t crc;                      /* CRC32 of the LZF blocks */
+};
+
+/* Checksums what the LZF stream writes to the MTD stream */
+
+struct pm_hibernate_crcstream_s
+{
+  struct lib_outstream_s common;
+  FAR struct lib_outstream_s *backend;
+  uint32_t crc;
+};
+
+struct pm_hibernate_s
+{
+  jmp_buf ctx;                       /* Where the resumed image continues */
+  struct pm_hibernate_header_s header;
+  FAR const uint8_t *image;          /* Image to restore, memory mapped */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct pm_hibernate_s g_pm_hibernate;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_hibernate_id
+ *
+ * Description:
+ *   An image only fits the firmware that wrote it.  Anything changing the
+ *   layout of the firmware is very likely to move this function or the
+ *   state saved by setjmp().
+ *
+ ****************************************************************************/
+
+static uintptr_t pm_hibernate_id(void)
+{
+  return (uintptr_t)pm_hibernate_id ^ (uintptr_t)&g_pm_hibernate ^
+         sizeof(struct pm_hibernate_s);
+}
+
+/****************************************************************************
+ * Name: pm_hibernate_crcputs and pm_hibernate_crcflush
+ ****************************************************************************/
+
+static int pm_hibernate_crcputs(FAR struct lib_outstream_s *self,
+                                FAR const void *buf, int len)
+{
+  FAR struct pm_hibernate_crcstream_s *stream =
+    (FAR struct pm_hibernate_crcstream_s *)self;
+  int ret;
+
+  ret = lib_stream_puts(stream->backend, buf, len);
+  if (ret > 0)
+    {
+      stream->crc   = crc32part(buf, ret, stream->crc);
+      self->nput   += ret;
+    }
+
+  return ret;
+}
+
+static int pm_hibernate_crcflush(FAR struct lib_outstream_s *self)
+{
+  FAR struct pm_hibernate_crcstream_s *stream =
+    (FAR struct pm_hibernate_crcstream_s *)self;
+
+  return lib_stream_flush(stream->backend);
+}
+
+/****************************************************************************
+ * Name: pm_hibernate_write
+ *
+ * Description:
+ *   Write the image of the regions to the hibernation partition.
+ *
+ ****************************************************************************/
+
+static int pm_hibernate_write(FAR struct pm_hibernate_s *priv,
+                              FAR struct lib_mtdoutstream_s *mtd,
+                              FAR struct lib_lzfoutstream_s *lzf)
+{
+  FAR struct pm_hibernate_header_s *header = &priv->header;
+  struct pm_hibernate_crcstream_s crcstream;
+  struct pm_hibernate_trailer_s trailer;
+  uint32_t i;
+  int ret;
+
+  memset(&crcstream, 0, sizeof(crcstream));
+  crcstream.common.puts  = pm_hibernate_crcputs;
+  crcstream.common.flush = pm_hibernate_crcflush;
+  crcstream.backend      = &mtd->common;
+  lib_lzfoutstream(lzf, &crcstream.common);
+
+  ret = lib_stream_puts(&mtd->common, header, sizeof(*header));
+
+  for (i = 0; ret >= 0 && i < header->nregions; i++)
+    {
+      ret = lib_stream_puts(&lzf->common,
+                            (FAR const void *)header->region[i].start,
+                            header->region[i].end - header->region[i].start);
+      if (ret >= 0)
+        {
+          /* The next region starts a new block */
+
+          ret = lib_stream_flush(&lzf->common);
+        }
+    }
+
+  if (ret >= 0)
+    {
+      trailer.magic = PM_HIBERNATE_END;
+      trailer.crc   = crcstream.crc;
+
+      ret = lib_stream_puts(&mtd->common, &trailer, sizeof(trailer));
+      if (ret >= 0)
+        {
+          ret = lib_stream_flush(&mtd->common);
+        }
+    }
+
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: pm_hibernate_block
+ *
+ * Description:
+ *   Parse the header of the LZF block at ptr.
+ *
+ * Returned Value:
+ *   The size of the block, or zero if there is no block at ptr.
+ *
+ ****************************************************************************/
+
+static size_t pm_hibernate_block(FAR const uint8_t *ptr,
+                                 FAR size_t *hlen, FAR size_t *clen,
+                                 FAR size_t *ulen)
+{
+  if (ptr[0] != 'Z' || ptr[1] != 'V')
+    {
+      return 0;
+    }
+
+  if (ptr[2] == LZF_TYPE0_HDR)
+    {
+      *hlen = LZF_TYPE0_HDR_SIZE;
+      *clen = (ptr[3] << 8) | ptr[4];
+      *ulen = *clen;
+    }
+  else if (ptr[2] == LZF_TYPE1_HDR)
+    {
+      *hlen = LZF_TYPE1_HDR_SIZE;
+      *clen = (ptr[3] << 8) | ptr[4];
+      *ulen = (ptr[5] << 8) | ptr[6];
+    }
+  else
+    {
+      return 0;
+    }
+
+  return *hlen + *clen;
+}
+
+/****************************************************************************
+ * Name: pm_hibernate_verify
+ *
+ * Description:
+ *   Check that the image is complete, intact and was written by this
+ *   firmware, before anything is overwritten.
+ *
+ ****************************************************************************/
+
+static int pm_hibernate_verify(FAR const uint8_t *image, size_t size,
+                               FAR const struct memory_region_s *scratch)
+{
+  FAR const struct pm_hibernate_header_s *header =
+    (FAR const struct pm_hibernate_header_s *)image;
+  struct pm_hibernate_trailer_s trailer;
+  FAR const uint8_t *ptr;
+  size_t total = 0;
+  size_t hlen;
+  size_t clen;
+  size_t ulen;
+  size_t len;
+  uint32_t i;
+
+  if (header->magic != PM_HIBERNATE_MAGIC ||
+      header->id != pm_hibernate_id() ||
+      header->nregions > CONFIG_PM_HIBERNATE_NREGIONS)
+    {
+      return -ENOENT;
+    }
+
+  for (i = 0; i < header->nregions; i++)
+    {
+      if (header->region[i].start < scratch->end &&
+          header->region[i].end > scratch->start)
+        {
+          return -EINVAL;
+        }
+
+      total += header->region[i].end - header->region[i].start;
+    }
+
+  ptr   = image + sizeof(*header);
+  size -= sizeof(*header);
+
+  while (size >= LZF_MAX_HDR_SIZE &&
+         (len = pm_hibernate_block(ptr, &hlen, &clen, &ulen)) > 0 &&
+         len <= size && ulen <= total)
+    {
+      ptr   += len;
+      size  -= len;
+      total -= ulen;
+    }
+
+  if (total != 0 || size < sizeof(trailer))
+    {
+      return -EIO;
+    }
+
+  memcpy(&trailer, ptr, sizeof(trailer));
+  if (trailer.magic != PM_HIBERNATE_END ||
+      trailer.crc != crc32(image + sizeof(*header),
+                           ptr - image - sizeof(*header)))
+    {
+      return -EIO;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pm_hibernate_restore
+ *
+ * Description:
+ *   The restore thread, running on the scratch memory.  It copies what it
+ *   needs to its stack, disables interrupts for good, overwrites the
+ *   regions with the image and continues where pm_hibernate() saved the
+ *   context.  Nothing in the regions can be used from here on.
+ *
+ ****************************************************************************/
+
+static int pm_hibernate_restore(int argc, FAR char *argv[])
+{
+  FAR const struct pm_hibernate_header_s *header;
+  FAR const uint8_t *block;
+  FAR uint8_t *dst;
+  FAR uint8_t *end;
+  size_t hlen;
+  size_t clen;
+  size_t ulen;
+  uint32_t i;
+
+  header = (FAR const struct pm_hibernate_header_s *)g_pm_hibernate.image;
+  block  = g_pm_hibernate.image + sizeof(*header);
+
+  up_irq_save();
+
+  for (i = 0; i < header->nregions; i++)
+    {
+      dst = (FAR uint8_t *)header->region[i].start;
+      end = (FAR uint8_t *)header->region[i].end;
+
+      while (dst < end)
+        {
+          pm_hibernate_block(block, &hlen, &clen, &ulen);
+          if (block[2] == LZF_TYPE0_HDR)
+            {
+              memcpy(dst, block + hlen, ulen);
+            }
+          else if (lzf_decompress(block + hlen, clen, dst, ulen) != ulen)
+            {
+              /* The image was verified, but the memory is lost anyway */
+
+              up_systemreset();
+            }
+
+          block += hlen + clen;
+          dst   += ulen;
+        }
+    }
+
+  longjmp(g_pm_hibernate.ctx, 1);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_hibernate
+ ****************************************************************************/
+
+int pm_hibernate(FAR const struct memory_region_s *regions)
+{
+  FAR struct pm_hibernate_s *priv = &g_pm_hibernate;
+  FAR struct pm_hibernate_header_s *header = &priv->header;
+  FAR struct lib_lzfoutstream_s *lzf;
+  struct lib_mtdoutstream_s mtd;
+  irqstate_t flags;
+  bool found = false;
+  int ret;
+  int i;
+
+  /* The state of this file must be part of the image */
+
+  memset(header, 0, sizeof(*header));
+  for (i = 0; regions[i].start < regions[i].end; i++)
+    {
+      if (i >= CONFIG_PM_HIBERNATE_NREGIONS)
+        {
+          return -E2BIG;
+        }
+
+      header->region[i].start = regions[i].start;
+      header->region[i].end   = regions[i].end;
+
+      if ((uintptr_t)priv >= regions[i].start &&
+          (uintptr_t)(priv + 1) <= regions[i].end)
+        {
+          found = true;
+        }
+    }
+
+  if (!found)
+    {
+      return -EINVAL;
+    }
+
+  header->magic    = PM_HIBERNATE_MAGIC;
+  header->nregions = i;
+  header->id       = pm_hibernate_id();
+
+  lzf = kmm_malloc(sizeof(*lzf));
+  if (lzf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = lib_mtdoutstream_open(&mtd, CONFIG_PM_HIBERNATE_MTD);
+  if (ret < 0)
+    {
+      goto errout_with_lzf;
+    }
+
+  /* Freeze the system with the drivers suspended while it is saved, the
+   * MTD driver of the hibernation partition must work that way.
+   */
+
+  flags = enter_critical_section();
+
+  ret = pm_changestate(PM_IDLE_DOMAIN, PM_SLEEP);
+  if (ret < 0)
+    {
+      goto errout_with_irq;
+    }
+
+  if (setjmp(priv->ctx) == 0)
+    {
+      ret = pm_hibernate_write(priv, &mtd, lzf);
+    }
+  else
+    {
+      /* Resumed.  The image is used once, erase its header. */
+
+      MTD_ERASE(mtd.inode->u.i_mtd, 0, 1);
+      ret = 1;
+    }
+
+  pm_changestate(PM_IDLE_DOMAIN, PM_NORMAL);
+
+errout_with_irq:
+  leave_critical_section(flags);
+  lib_mtdoutstream_close(&mtd);
+
+errout_with_lzf:
+  kmm_free(lzf);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pm_hibernate_resume
+ ****************************************************************************/
+
+int pm_hibernate_resume(FAR void *scratch, size_t size)
+{
+  FAR struct pm_hibernate_s *priv = &g_pm_hibernate;
+  struct memory_region_s region;
+  struct mtd_geometry_s geo;
+  FAR struct inode *inode;
+  FAR void *image = NULL;
+  int ret;
+
+  ret = find_mtddriver(CONFIG_PM_HIBERNATE_MTD, &inode);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The image is read through the memory mapping of the partition, as the
+   * MTD driver will be gone as soon as its memory is overwritten.
+   */
+
+  ret = MTD_IOCTL(inode->u.i_mtd, MTDIOC_GEOMETRY,
+                  (unsigned long)(uintptr_t)&geo);
+  if (ret >= 0)
+    {
+      ret = MTD_IOCTL(inode->u.i_mtd, BIOC_XIPBASE,
+                      (unsigned long)(uintptr_t)&image);
+    }
+
+  close_mtddriver(inode);
+  if (ret < 0 || image == NULL)
+    {
+      return ret < 0 ? ret : -ENOTSUP;
+    }
+
+  region.start = (uintptr_t)scratch;
+  region.end   = (uintptr_t)scratch + size;
+
+  ret = pm_hibernate_verify(image, geo.erasesize * geo.neraseblocks,
+                            &region);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* There is no way back once the restore thread runs */
+
+  priv->image = image;
+
+  ret = kthread_create_with_stack("hibernate", SCHED_PRIORITY_MAX,
+                                  scratch, size, pm_hibernate_restore,
+                                  NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  sched_yield();
+  PANIC();
+  return -EIO;
+}
+
+#endif /* CONFIG_PM_HIBERNATE */
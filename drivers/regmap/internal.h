@@ -32,6 +32,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* The largest number of registers regmap_sync() writes at once */
+
+#define REGCACHE_BLOCK_MAX 16
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -39,6 +43,27 @@
 typedef CODE void (*regmap_lock_t)(FAR void *);
 typedef CODE void (*regmap_unlock_t)(FAR void *);
 
+#ifdef CONFIG_REGMAP_CACHE
+struct regmap_s;
+
+/* Operations of a register cache.  read() returns -ENOENT for a register
+ * that is not cached.  sync() passes the runs of adjacent dirty registers
+ * to regcache_sync_block() in ascending order.
+ */
+
+struct regcache_ops_s
+{
+  CODE int (*init)(FAR struct regmap_s *map);
+  CODE void (*exit)(FAR struct regmap_s *map);
+  CODE int (*read)(FAR struct regmap_s *map, unsigned int reg,
+                   FAR unsigned int *val);
+  CODE int (*write)(FAR struct regmap_s *map, unsigned int reg,
+                    unsigned int val, bool dirty);
+  CODE int (*sync)(FAR struct regmap_s *map);
+  CODE void (*mark_dirty)(FAR struct regmap_s *map);
+};
+#endif
+
 /* Configuration for the register map of a device.
  * This structure is only used inside regmap.
  */
@@ -79,9 +104,43 @@ struct regmap_s
 
   int reg_stride;
 
+#ifdef CONFIG_REGMAP_CACHE
+  /* Register cache, cache_ops is NULL if registers are not cached. */
+
+  FAR const struct regcache_ops_s *cache_ops;
+  FAR void *cache;
+  unsigned int max_register;
+  CODE bool (*volatile_reg)(unsigned int reg);
+  CODE bool (*precious_reg)(unsigned int reg);
+  bool cache_only;
+  bool use_single_write;
+#endif
+
   /* Prevent fragmentation */
 
   mutex_t mutex[0];
 };
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_REGMAP_CACHE
+extern const struct regcache_ops_s g_regcache_flat_ops;
+extern const struct regcache_ops_s g_regcache_rbtree_ops;
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_REGMAP_CACHE
+int regcache_init(FAR struct regmap_s *map,
+                  FAR const struct regmap_config_s *config);
+void regcache_exit(FAR struct regmap_s *map);
+bool regcache_volatile(FAR struct regmap_s *map, unsigned int reg);
+int regcache_sync_block(FAR struct regmap_s *map, unsigned int reg,
+                        FAR const unsigned int *vals, unsigned int count);
+#endif
+
 #endif /* __DRIVERS_REGMAP_INTERNAL_H */
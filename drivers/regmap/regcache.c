@@ -0,0 +1,205 @@
+/****************************************************************************
+ * drivers/regmap/regcache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/regmap/regmap.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include "internal.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: regcache_init
+ *
+ * Description:
+ *   Create the register cache selected by the configuration and fill it
+ *   with the register defaults.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regcache_init(FAR struct regmap_s *map,
+                  FAR const struct regmap_config_s *config)
+{
+  unsigned int i;
+  int ret;
+
+  switch (config->cache_type)
+    {
+      case REGCACHE_NONE:
+        return OK;
+
+      case REGCACHE_FLAT:
+        map->cache_ops = &g_regcache_flat_ops;
+        break;
+
+      case REGCACHE_RBTREE:
+        map->cache_ops = &g_regcache_rbtree_ops;
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  map->max_register     = config->max_register;
+  map->volatile_reg     = config->volatile_reg;
+  map->precious_reg     = config->precious_reg;
+  map->use_single_write = config->use_single_write;
+
+  ret = map->cache_ops->init(map);
+  if (ret < 0)
+    {
+      map->cache_ops = NULL;
+      return ret;
+    }
+
+  for (i = 0; i < config->num_reg_defaults; i++)
+    {
+      FAR const struct reg_default_s *def = &config->reg_defaults[i];
+
+      if (regcache_volatile(map, def->reg))
+        {
+          continue;
+        }
+
+      ret = map->cache_ops->write(map, def->reg, def->def, false);
+      if (ret < 0)
+        {
+          regcache_exit(map);
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: regcache_exit
+ *
+ * Description:
+ *   Free the register cache.
+ *
+ ****************************************************************************/
+
+void regcache_exit(FAR struct regmap_s *map)
+{
+  if (map->cache_ops != NULL)
+    {
+      map->cache_ops->exit(map);
+      map->cache_ops = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: regcache_volatile
+ *
+ * Description:
+ *   Return true if the register is not cached: there is no cache, the
+ *   register is beyond max_register, or it is volatile or precious.
+ *
+ ****************************************************************************/
+
+bool regcache_volatile(FAR struct regmap_s *map, unsigned int reg)
+{
+  if (map->cache_ops == NULL)
+    {
+      return true;
+    }
+
+  if (map->max_register != 0 && reg > map->max_register)
+    {
+      return true;
+    }
+
+  if (map->volatile_reg != NULL && map->volatile_reg(reg))
+    {
+      return true;
+    }
+
+  return map->precious_reg != NULL && map->precious_reg(reg);
+}
+
+/****************************************************************************
+ * Name: regcache_sync_block
+ *
+ * Description:
+ *   Write count adjacent registers from reg on.  They are sent in a single
+ *   bus write unless the device or the bus cannot do it.
+ *
+ * Input Parameters:
+ *   map   - The register map.
+ *   reg   - The first register.
+ *   vals  - The values of the registers.
+ *   count - The number of registers, at most REGCACHE_BLOCK_MAX.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regcache_sync_block(FAR struct regmap_s *map, unsigned int reg,
+                        FAR const unsigned int *vals, unsigned int count)
+{
+  uint8_t buf[sizeof(uint32_t) * (REGCACHE_BLOCK_MAX + 1)];
+  unsigned int len = 0;
+  unsigned int i;
+  int ret = OK;
+  int j;
+
+  DEBUGASSERT(count > 0 && count <= REGCACHE_BLOCK_MAX);
+
+  if (count == 1 || map->use_single_write || map->write == NULL ||
+      map->reg_bytes > 4 || map->val_bytes > 4)
+    {
+      for (i = 0; i < count && ret >= 0; i++)
+        {
+          ret = map->reg_write(map->bus, reg + i * map->reg_stride,
+                               vals[i]);
+        }
+
+      return ret;
+    }
+
+  for (j = map->reg_bytes - 1; j >= 0; j--)
+    {
+      buf[len++] = reg >> (8 * j);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      for (j = map->val_bytes - 1; j >= 0; j--)
+        {
+          buf[len++] = vals[i] >> (8 * j);
+        }
+    }
+
+  return map->write(map->bus, buf, len);
+}
@@ -0,0 +1,213 @@
+/****************************************************************************
+ * drivers/regmap/regcache_flat.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/regmap/regmap.h>
+#include <nuttx/kmalloc.h>
+
+#include <errno.h>
+#include <debug.h>
+
+#include "internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FLAT_NWORDS(n)        (((n) + 31) / 32)
+#define FLAT_TEST(map, i)     (((map)[(i) / 32] >> ((i) % 32)) & 1)
+#define FLAT_SET(map, i)      ((map)[(i) / 32] |= UINT32_C(1) << ((i) % 32))
+#define FLAT_CLEAR(map, i)    ((map)[(i) / 32] &= ~(UINT32_C(1) << ((i) % 32)))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* All registers up to max_register, with a bit per register telling if
+ * it is cached and another if it is dirty.
+ */
+
+struct regcache_flat_s
+{
+  unsigned int nregs;
+  FAR uint32_t *valid;
+  FAR uint32_t *dirty;
+  unsigned int values[1];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int regcache_flat_init(FAR struct regmap_s *map);
+static void regcache_flat_exit(FAR struct regmap_s *map);
+static int regcache_flat_read(FAR struct regmap_s *map, unsigned int reg,
+                              FAR unsigned int *val);
+static int regcache_flat_write(FAR struct regmap_s *map, unsigned int reg,
+                               unsigned int val, bool dirty);
+static int regcache_flat_sync(FAR struct regmap_s *map);
+static void regcache_flat_mark_dirty(FAR struct regmap_s *map);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct regcache_ops_s g_regcache_flat_ops =
+{
+  regcache_flat_init,       /* init */
+  regcache_flat_exit,       /* exit */
+  regcache_flat_read,       /* read */
+  regcache_flat_write,      /* write */
+  regcache_flat_sync,       /* sync */
+  regcache_flat_mark_dirty, /* mark_dirty */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int regcache_flat_init(FAR struct regmap_s *map)
+{
+  FAR struct regcache_flat_s *flat;
+  unsigned int nregs = map->max_register / map->reg_stride + 1;
+  size_t nwords = FLAT_NWORDS(nregs);
+
+  flat = kmm_zalloc(sizeof(*flat) + (nregs - 1) * sizeof(unsigned int) +
+                    2 * nwords * sizeof(uint32_t));
+  if (flat == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  flat->nregs = nregs;
+  flat->valid = (FAR uint32_t *)&flat->values[nregs];
+  flat->dirty = flat->valid + nwords;
+  map->cache  = flat;
+
+  return OK;
+}
+
+static void regcache_flat_exit(FAR struct regmap_s *map)
+{
+  kmm_free(map->cache);
+  map->cache = NULL;
+}
+
+static int regcache_flat_read(FAR struct regmap_s *map, unsigned int reg,
+                              FAR unsigned int *val)
+{
+  FAR struct regcache_flat_s *flat = map->cache;
+  unsigned int index = reg / map->reg_stride;
+
+  if (index >= flat->nregs || !FLAT_TEST(flat->valid, index))
+    {
+      return -ENOENT;
+    }
+
+  *val = flat->values[index];
+  return OK;
+}
+
+static int regcache_flat_write(FAR struct regmap_s *map, unsigned int reg,
+                               unsigned int val, bool dirty)
+{
+  FAR struct regcache_flat_s *flat = map->cache;
+  unsigned int index = reg / map->reg_stride;
+
+  if (index >= flat->nregs)
+    {
+      return -EINVAL;
+    }
+
+  flat->values[index] = val;
+  FLAT_SET(flat->valid, index);
+
+  if (dirty)
+    {
+      FLAT_SET(flat->dirty, index);
+    }
+  else
+    {
+      FLAT_CLEAR(flat->dirty, index);
+    }
+
+  return OK;
+}
+
+static int regcache_flat_sync(FAR struct regmap_s *map)
+{
+  FAR struct regcache_flat_s *flat = map->cache;
+  unsigned int start;
+  unsigned int count;
+  unsigned int i;
+  int ret;
+
+  for (start = 0; start < flat->nregs; start += count)
+    {
+      /* Skip a whole word of clean registers at once */
+
+      if (start % 32 == 0 && flat->dirty[start / 32] == 0)
+        {
+          count = 32;
+          continue;
+        }
+
+      count = 0;
+      while (start + count < flat->nregs && count < REGCACHE_BLOCK_MAX &&
+             FLAT_TEST(flat->dirty, start + count))
+        {
+          count++;
+        }
+
+      if (count == 0)
+        {
+          count = 1;
+          continue;
+        }
+
+      ret = regcache_sync_block(map, start * map->reg_stride,
+                                &flat->values[start], count);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      for (i = start; i < start + count; i++)
+        {
+          FLAT_CLEAR(flat->dirty, i);
+        }
+    }
+
+  return OK;
+}
+
+static void regcache_flat_mark_dirty(FAR struct regmap_s *map)
+{
+  FAR struct regcache_flat_s *flat = map->cache;
+  unsigned int i;
+
+  for (i = 0; i < FLAT_NWORDS(flat->nregs); i++)
+    {
+      flat->dirty[i] = flat->valid[i];
+    }
+}
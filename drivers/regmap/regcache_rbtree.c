@@ -0,0 +1,236 @@
+/****************************************************************************
+ * drivers/regmap/regcache_rbtree.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/regmap/regmap.h>
+#include <nuttx/kmalloc.h>
+
+#include <sys/tree.h>
+#include <errno.h>
+#include <debug.h>
+
+#include "internal.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node per register that was accessed, so sparse register maps only
+ * pay for the registers they use.
+ */
+
+struct regcache_rbnode_s
+{
+  RB_ENTRY(regcache_rbnode_s) link;
+  unsigned int reg;
+  unsigned int val;
+  bool dirty;
+};
+
+RB_HEAD(regcache_rbtree_s, regcache_rbnode_s);
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int regcache_rbtree_init(FAR struct regmap_s *map);
+static void regcache_rbtree_exit(FAR struct regmap_s *map);
+static int regcache_rbtree_read(FAR struct regmap_s *map, unsigned int reg,
+                                FAR unsigned int *val);
+static int regcache_rbtree_write(FAR struct regmap_s *map,
+                                 unsigned int reg, unsigned int val,
+                                 bool dirty);
+static int regcache_rbtree_sync(FAR struct regmap_s *map);
+static void regcache_rbtree_mark_dirty(FAR struct regmap_s *map);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct regcache_ops_s g_regcache_rbtree_ops =
+{
+  regcache_rbtree_init,       /* init */
+  regcache_rbtree_exit,       /* exit */
+  regcache_rbtree_read,       /* read */
+  regcache_rbtree_write,      /* write */
+  regcache_rbtree_sync,       /* sync */
+  regcache_rbtree_mark_dirty, /* mark_dirty */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int regcache_rbtree_compare(FAR struct regcache_rbnode_s *a,
+                                   FAR struct regcache_rbnode_s *b)
+{
+  return a->reg < b->reg ? -1 : a->reg > b->reg;
+}
+
+/****************************************************************************
+ * Name: RB_GENERATE_STATIC
+ ****************************************************************************/
+
+RB_GENERATE_STATIC(regcache_rbtree_s, regcache_rbnode_s, link,
+                   regcache_rbtree_compare)
+
+static FAR struct regcache_rbnode_s *
+regcache_rbtree_find(FAR struct regmap_s *map, unsigned int reg)
+{
+  struct regcache_rbnode_s search;
+
+  search.reg = reg;
+  return RB_FIND(regcache_rbtree_s, map->cache, &search);
+}
+
+static int regcache_rbtree_init(FAR struct regmap_s *map)
+{
+  FAR struct regcache_rbtree_s *tree;
+
+  tree = kmm_malloc(sizeof(*tree));
+  if (tree == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  RB_INIT(tree);
+  map->cache = tree;
+  return OK;
+}
+
+static void regcache_rbtree_exit(FAR struct regmap_s *map)
+{
+  FAR struct regcache_rbtree_s *tree = map->cache;
+  FAR struct regcache_rbnode_s *node;
+  FAR struct regcache_rbnode_s *temp;
+
+  RB_FOREACH_SAFE(node, regcache_rbtree_s, tree, temp)
+    {
+      RB_REMOVE(regcache_rbtree_s, tree, node);
+      kmm_free(node);
+    }
+
+  kmm_free(tree);
+  map->cache = NULL;
+}
+
+static int regcache_rbtree_read(FAR struct regmap_s *map, unsigned int reg,
+                                FAR unsigned int *val)
+{
+  FAR struct regcache_rbnode_s *node;
+
+  node = regcache_rbtree_find(map, reg);
+  if (node == NULL)
+    {
+      return -ENOENT;
+    }
+
+  *val = node->val;
+  return OK;
+}
+
+static int regcache_rbtree_write(FAR struct regmap_s *map,
+                                 unsigned int reg, unsigned int val,
+                                 bool dirty)
+{
+  FAR struct regcache_rbnode_s *node;
+
+  node = regcache_rbtree_find(map, reg);
+  if (node == NULL)
+    {
+      node = kmm_malloc(sizeof(*node));
+      if (node == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      node->reg = reg;
+      RB_INSERT(regcache_rbtree_s, map->cache, node);
+    }
+
+  node->val   = val;
+  node->dirty = dirty;
+  return OK;
+}
+
+static int regcache_rbtree_sync(FAR struct regmap_s *map)
+{
+  FAR struct regcache_rbnode_s *block[REGCACHE_BLOCK_MAX];
+  unsigned int vals[REGCACHE_BLOCK_MAX];
+  FAR struct regcache_rbnode_s *node;
+  unsigned int count = 0;
+  unsigned int i;
+  int ret;
+
+  /* The registers are visited in ascending order, a run of dirty
+   * registers ends at a gap, at a clean register or when it is full.
+   */
+
+  node = RB_MIN(regcache_rbtree_s, map->cache);
+  for (; ; )
+    {
+      if (count > 0 && (node == NULL || !node->dirty ||
+                        count == REGCACHE_BLOCK_MAX ||
+                        node->reg != block[0]->reg +
+                                     count * map->reg_stride))
+        {
+          ret = regcache_sync_block(map, block[0]->reg, vals, count);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          for (i = 0; i < count; i++)
+            {
+              block[i]->dirty = false;
+            }
+
+          count = 0;
+        }
+
+      if (node == NULL)
+        {
+          break;
+        }
+
+      if (node->dirty)
+        {
+          block[count] = node;
+          vals[count++] = node->val;
+        }
+
+      node = RB_NEXT(regcache_rbtree_s, map->cache, node);
+    }
+
+  return OK;
+}
+
+static void regcache_rbtree_mark_dirty(FAR struct regmap_s *map)
+{
+  FAR struct regcache_rbnode_s *node;
+
+  RB_FOREACH(node, regcache_rbtree_s, map->cache)
+    {
+      node->dirty = true;
+    }
+}
@@ -59,6 +59,126 @@ static void regmap_unlock_mutex(FAR void *context)
   nxmutex_unlock(&map->mutex[0]);
 }
 
+/****************************************************************************
+ * Name: regmap_get_val and regmap_set_val
+ *
+ * Description:
+ *   Load or store a register value of val_bytes bytes.
+ *
+ ****************************************************************************/
+
+static unsigned int regmap_get_val(FAR struct regmap_s *map,
+                                   FAR const void *buf)
+{
+  switch (map->val_bytes)
+    {
+      case 1:
+        return *(FAR const uint8_t *)buf;
+      case 2:
+        return *(FAR const uint16_t *)buf;
+      default:
+        return *(FAR const uint32_t *)buf;
+    }
+}
+
+static void regmap_set_val(FAR struct regmap_s *map, FAR void *buf,
+                           unsigned int val)
+{
+  switch (map->val_bytes)
+    {
+      case 1:
+        *(FAR uint8_t *)buf = val;
+        break;
+      case 2:
+        *(FAR uint16_t *)buf = val;
+        break;
+      default:
+        *(FAR uint32_t *)buf = val;
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: regmap_read_unlocked
+ *
+ * Description:
+ *   Read a register from the cache, or from the device if it is not
+ *   cached.  A cacheable register read from the device is cached.
+ *
+ ****************************************************************************/
+
+static int regmap_read_unlocked(FAR struct regmap_s *map, unsigned int reg,
+                                FAR unsigned int *val)
+{
+  uint32_t buf = 0;
+  int ret;
+#ifdef CONFIG_REGMAP_CACHE
+  bool cached = !regcache_volatile(map, reg);
+
+  if (cached && map->cache_ops->read(map, reg, val) >= 0)
+    {
+      return OK;
+    }
+
+  if (map->cache_only)
+    {
+      return -EBUSY;
+    }
+#endif
+
+  ret = map->reg_read(map->bus, reg, &buf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *val = regmap_get_val(map, &buf);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (cached)
+    {
+      map->cache_ops->write(map, reg, *val, false);
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: regmap_write_unlocked
+ *
+ * Description:
+ *   Write a register to the device and update its cached value.  In the
+ *   cache-only mode, only the cache is updated and the register is marked
+ *   dirty.
+ *
+ ****************************************************************************/
+
+static int regmap_write_unlocked(FAR struct regmap_s *map, unsigned int reg,
+                                 unsigned int val)
+{
+  int ret;
+#ifdef CONFIG_REGMAP_CACHE
+  bool cached = !regcache_volatile(map, reg);
+
+  if (map->cache_only)
+    {
+      return cached ? map->cache_ops->write(map, reg, val, true) : -EBUSY;
+    }
+#endif
+
+  ret = map->reg_write(map->bus, reg, val);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (ret >= 0 && cached)
+    {
+      map->cache_ops->write(map, reg, val, false);
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -138,6 +258,19 @@ FAR struct regmap_s *regmap_init(FAR struct regmap_bus_s *bus,
   map->read  = bus->read;
   map->write = bus->write;
 
+#ifdef CONFIG_REGMAP_CACHE
+  if (regcache_init(map, config) < 0)
+    {
+      if (!config->disable_locking)
+        {
+          nxmutex_destroy(&map->mutex[0]);
+        }
+
+      kmm_free(map);
+      return NULL;
+    }
+#endif
+
   return map;
 }
 
@@ -171,7 +304,7 @@ int regmap_write(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
-  ret = map->reg_write(map->bus, reg, val);
+  ret = regmap_write_unlocked(map, reg, val);
 
   map->unlock(map);
 
@@ -212,9 +345,44 @@ int regmap_bulk_write(FAR struct regmap_s *map, unsigned int reg,
   DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
 
   map->lock(map);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (map->cache_ops != NULL && map->cache_only)
+    {
+      for (i = 0; i < val_count; i++)
+        {
+          ptr = (FAR uint8_t *)val + (i * val_bytes);
+          ret = regmap_write_unlocked(map, reg + (i * map->reg_stride),
+                                      regmap_get_val(map, ptr));
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      goto out;
+    }
+#endif
+
   if (map->write != NULL)
     {
       ret = map->write(map->bus, val, val_bytes * val_count);
+#ifdef CONFIG_REGMAP_CACHE
+      if (ret >= 0 && map->cache_ops != NULL)
+        {
+          for (i = 0; i < val_count; i++)
+            {
+              ptr  = (FAR uint8_t *)val + (i * val_bytes);
+              ival = reg + (i * map->reg_stride);
+              if (!regcache_volatile(map, ival))
+                {
+                  map->cache_ops->write(map, ival, regmap_get_val(map, ptr),
+                                        false);
+                }
+            }
+        }
+#endif
+
       goto out;
     }
 
@@ -237,7 +405,7 @@ int regmap_bulk_write(FAR struct regmap_s *map, unsigned int reg,
             goto out;
         }
 
-      ret = map->reg_write(map->bus, reg + (i * map->reg_stride), ival);
+      ret = regmap_write_unlocked(map, reg + (i * map->reg_stride), ival);
       if (ret < 0)
         {
           break;
@@ -278,7 +446,22 @@ int regmap_read(FAR struct regmap_s *map, unsigned int reg, FAR void *val)
 
   map->lock(map);
 
-  ret = map->reg_read(map->bus, reg, val);
+#ifdef CONFIG_REGMAP_CACHE
+  if (map->cache_ops != NULL)
+    {
+      unsigned int ival;
+
+      ret = regmap_read_unlocked(map, reg, &ival);
+      if (ret >= 0)
+        {
+          regmap_set_val(map, val, ival);
+        }
+    }
+  else
+#endif
+    {
+      ret = map->reg_read(map->bus, reg, val);
+    }
 
   map->unlock(map);
   return ret;
@@ -320,6 +503,33 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
+#ifdef CONFIG_REGMAP_CACHE
+  /* Serve the registers from the cache if they are all cached */
+
+  if (map->cache_ops != NULL)
+    {
+      for (i = 0; i < val_count; i++)
+        {
+          unsigned int creg = reg + (i * map->reg_stride);
+
+          ret = regcache_volatile(map, creg) ? -ENOENT :
+                map->cache_ops->read(map, creg, &ival);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          regmap_set_val(map, u8 + i * map->val_bytes, ival);
+        }
+
+      if (ret >= 0 || map->cache_only)
+        {
+          map->unlock(map);
+          return ret < 0 ? -EBUSY : ret;
+        }
+    }
+#endif
+
   if (map->read != NULL)
     {
       ret = map->read(map->bus, &reg, map->reg_bytes, val, val_count);
@@ -357,6 +567,142 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write of a register.  Only the bits set in mask are
+ *   changed, and the register is not written if they already have the
+ *   requested value.  A cached register is not read from the device.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - the bits to change.
+ *   val  - the new value of these bits.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val)
+{
+  unsigned int orig;
+  unsigned int tmp;
+  int ret;
+
+  DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
+
+#ifdef CONFIG_REGMAP_CACHE
+  /* Reading a precious register would lose its content */
+
+  if (map->precious_reg != NULL && map->precious_reg(reg))
+    {
+      return -EINVAL;
+    }
+#endif
+
+  map->lock(map);
+
+  ret = regmap_read_unlocked(map, reg, &orig);
+  if (ret >= 0)
+    {
+      tmp = (orig & ~mask) | (val & mask);
+      if (tmp != orig)
+        {
+          ret = regmap_write_unlocked(map, reg, tmp);
+        }
+    }
+
+  map->unlock(map);
+  return ret;
+}
+
+#ifdef CONFIG_REGMAP_CACHE
+/****************************************************************************
+ * Name: regmap_cache_only
+ *
+ * Description:
+ *   Enable or disable the cache-only mode, for instance while the device
+ *   is suspended.  In this mode writes of cached registers only update
+ *   the cache and mark them dirty, and accesses to the other registers
+ *   fail with -EBUSY.
+ *
+ * Input Parameters:
+ *   map    - regmap handler, from regmap bus init function return.
+ *   enable - true to enter the cache-only mode.
+ *
+ ****************************************************************************/
+
+void regmap_cache_only(FAR struct regmap_s *map, bool enable)
+{
+  map->lock(map);
+  map->cache_only = enable;
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regmap_mark_dirty
+ *
+ * Description:
+ *   Mark all cached registers dirty, so the next regmap_sync() writes them
+ *   all, for instance after the device lost its state.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ ****************************************************************************/
+
+void regmap_mark_dirty(FAR struct regmap_s *map)
+{
+  map->lock(map);
+
+  if (map->cache_ops != NULL)
+    {
+      map->cache_ops->mark_dirty(map);
+    }
+
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regmap_sync
+ *
+ * Description:
+ *   Write the dirty registers of the cache to the device.  Runs of
+ *   adjacent registers are written in a single bulk transfer.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -EBUSY if the
+ *   map is in cache-only mode.
+ *
+ ****************************************************************************/
+
+int regmap_sync(FAR struct regmap_s *map)
+{
+  int ret = OK;
+
+  map->lock(map);
+
+  if (map->cache_only)
+    {
+      ret = -EBUSY;
+    }
+  else if (map->cache_ops != NULL)
+    {
+      ret = map->cache_ops->sync(map);
+    }
+
+  map->unlock(map);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: regmap_exit
  *
@@ -372,6 +718,10 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
 
 void regmap_exit(FAR struct regmap_s *map)
 {
+#ifdef CONFIG_REGMAP_CACHE
+  regcache_exit(map);
+#endif
+
   if (!map->disable_locking)
     {
       nxmutex_destroy(&map->mutex[0]);
@@ -22,7 +22,9 @@
  * Included Files
  ****************************************************************************/
 
+#include <debug.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
@@ -40,6 +42,11 @@
 #define RPMSG_PORT_BUF_TO_NODE(q,b) ((q)->node + ((FAR void *)(b) - (q)->buf) / (q)->len)
 #define RPMSG_PORT_NODE_TO_BUF(q,n) ((q)->buf + (((n) - (q)->node)) * (q)->len)
 
+#ifdef CONFIG_RPMSG_PORT_TX_COALESCE
+#  define RPMSG_PORT_TX_COALESCE_TICKS \
+          USEC2TICK(CONFIG_RPMSG_PORT_TX_COALESCE_LATENCY)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -259,6 +266,50 @@ rpmsg_port_get_tx_payload_buffer(FAR struct rpmsg_device *rdev,
   return RPMSG_LOCATE_DATA(hdr->buf);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_notify_tx_ready
+ *
+ * Description:
+ *   Tell the driver that the tx queue has buffers to send.  With
+ *   CONFIG_RPMSG_PORT_TX_COALESCE, the first buffer queued to an idle
+ *   queue is notified at once; the buffers queued while the driver is
+ *   still busy are notified together once they reach
+ *   CONFIG_RPMSG_PORT_TX_COALESCE_BATCH, or after
+ *   CONFIG_RPMSG_PORT_TX_COALESCE_LATENCY at the latest.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_PORT_TX_COALESCE
+static void rpmsg_port_notify_tx_worker(FAR void *arg)
+{
+  FAR struct rpmsg_port_s *port = arg;
+
+  port->ops->notify_tx_ready(port);
+}
+#endif
+
+static void rpmsg_port_notify_tx_ready(FAR struct rpmsg_port_s *port)
+{
+#ifdef CONFIG_RPMSG_PORT_TX_COALESCE
+  uint16_t nused = rpmsg_port_queue_nused(&port->txq);
+
+  if (nused > 1 && nused < CONFIG_RPMSG_PORT_TX_COALESCE_BATCH)
+    {
+      if (work_available(&port->txwork))
+        {
+          work_queue(HPWORK, &port->txwork, rpmsg_port_notify_tx_worker,
+                     port, RPMSG_PORT_TX_COALESCE_TICKS);
+        }
+
+      return;
+    }
+
+  work_cancel(HPWORK, &port->txwork);
+#endif
+
+  port->ops->notify_tx_ready(port);
+}
+
 /****************************************************************************
  * Name: rpmsg_port_send_offchannel_nocopy
  ****************************************************************************/
@@ -286,7 +337,7 @@ static int rpmsg_port_send_offchannel_nocopy(FAR struct rpmsg_device *rdev,
   rpmsg_port_queue_add_buffer(&port->txq, hdr);
   if (port->ops->notify_tx_ready)
     {
-      port->ops->notify_tx_ready(port);
+      rpmsg_port_notify_tx_ready(port);
     }
 
   return len;
@@ -636,6 +687,10 @@ void rpmsg_port_uninitialize(FAR struct rpmsg_port_s *port)
         }
     }
 
+#ifdef CONFIG_RPMSG_PORT_TX_COALESCE
+  work_cancel_sync(HPWORK, &port->txwork);
+#endif
+
   metal_mutex_deinit(&rdev->lock);
   rpmsg_port_destroy_queues(port);
 }
@@ -720,6 +775,131 @@ void rpmsg_port_queue_add_buffer(FAR struct rpmsg_port_queue_s *queue,
   rpmsg_port_post(&queue->ready.sem);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_frame_append
+ ****************************************************************************/
+
+bool rpmsg_port_frame_append(FAR struct rpmsg_port_header_s *frame,
+                             uint16_t size,
+                             FAR struct rpmsg_port_header_s *hdr,
+                             uint16_t cmd)
+{
+  FAR struct rpmsg_port_header_s *sub;
+
+  if (frame->len + hdr->len > size)
+    {
+      return false;
+    }
+
+  sub = (FAR struct rpmsg_port_header_s *)((FAR uint8_t *)frame +
+                                           frame->len);
+  memcpy(sub, hdr, hdr->len);
+  sub->crc = 0;
+  sub->cmd = cmd;
+  sub->avail = 0;
+
+  frame->len += hdr->len;
+  return true;
+}
+
+/****************************************************************************
+ * Name: rpmsg_port_queue_aggregate
+ ****************************************************************************/
+
+uint16_t rpmsg_port_queue_aggregate(FAR struct rpmsg_port_queue_s *queue,
+                                    FAR struct rpmsg_port_header_s *frame,
+                                    uint16_t cmd, uint16_t max)
+{
+  FAR struct rpmsg_port_header_s *hdr = NULL;
+  FAR struct list_node *node;
+  irqstate_t flags;
+  uint16_t count = 0;
+
+  while (count < max)
+    {
+      /* Only take the head buffer out if it fits in the rest of the frame,
+       * so that the order of the ready list is kept.
+       */
+
+      flags = spin_lock_irqsave(&queue->ready.lock);
+      node = list_peek_head(&queue->ready.head);
+      if (node != NULL)
+        {
+          hdr = RPMSG_PORT_NODE_TO_BUF(queue, node);
+          if (frame->len + hdr->len > queue->len)
+            {
+              node = NULL;
+            }
+          else
+            {
+              list_delete(node);
+              queue->ready.num--;
+            }
+        }
+
+      spin_unlock_irqrestore(&queue->ready.lock, flags);
+      if (node == NULL)
+        {
+          break;
+        }
+
+      rpmsg_port_frame_append(frame, queue->len, hdr, cmd);
+      rpmsg_port_queue_return_buffer(queue, hdr);
+      count++;
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: rpmsg_port_queue_split
+ ****************************************************************************/
+
+int rpmsg_port_queue_split(FAR struct rpmsg_port_s *port,
+                           FAR struct rpmsg_port_queue_s *queue,
+                           FAR struct rpmsg_port_header_s *frame,
+                           rpmsg_port_rx_cb_t callback)
+{
+  FAR struct rpmsg_port_header_s *sub;
+  FAR struct rpmsg_port_header_s *hdr;
+  uint16_t offset = sizeof(struct rpmsg_port_header_s);
+  int count = 0;
+
+  while (offset < frame->len)
+    {
+      sub = (FAR struct rpmsg_port_header_s *)((FAR uint8_t *)frame +
+                                               offset);
+      if (sub->len < sizeof(struct rpmsg_port_header_s) ||
+          sub->len > frame->len - offset)
+        {
+          rpmsgerr("bad sub frame len %u at %u\n", sub->len, offset);
+          return -EINVAL;
+        }
+
+      hdr = rpmsg_port_queue_get_available_buffer(queue, callback != NULL);
+      if (hdr == NULL)
+        {
+          rpmsgerr("no rx buffer for sub frame %d\n", count);
+          return -ENOMEM;
+        }
+
+      memcpy(hdr, sub, sub->len);
+      if (callback != NULL)
+        {
+          callback(port, hdr);
+        }
+      else
+        {
+          rpmsg_port_queue_add_buffer(queue, hdr);
+        }
+
+      offset += sub->len;
+      count++;
+    }
+
+  return count;
+}
+
 /****************************************************************************
  * Name: rpmsg_port_register
  ****************************************************************************/
@@ -32,6 +32,7 @@
 #include <nuttx/list.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/rpmsg/rpmsg.h>
 #include <nuttx/rpmsg/rpmsg_port.h>
 
@@ -124,6 +125,12 @@ struct rpmsg_port_s
   /* Ops need implemented by drivers under port layer */
 
   const FAR struct rpmsg_port_ops_s *ops;
+
+#ifdef CONFIG_RPMSG_PORT_TX_COALESCE
+  /* Delayed tx ready notification of a coalesced burst */
+
+  struct work_s                     txwork;
+#endif
 };
 
 #ifndef __ASSEMBLY__
@@ -218,6 +225,80 @@ rpmsg_port_queue_get_buffer(FAR struct rpmsg_port_queue_s *queue,
 void rpmsg_port_queue_add_buffer(FAR struct rpmsg_port_queue_s *queue,
                                  FAR struct rpmsg_port_header_s *hdr);
 
+/****************************************************************************
+ * Name: rpmsg_port_frame_append
+ *
+ * Description:
+ *   Append a copy of a buffer to an aggregated frame as a sub frame. A sub
+ *   frame is a complete struct rpmsg_port_header_s followed by its payload,
+ *   so the len of the header delimits it. The frame's len must be set to
+ *   the size of struct rpmsg_port_header_s before the first append.
+ *
+ * Input Parameters:
+ *   frame - The aggregated frame.
+ *   size  - The size of the frame buffer.
+ *   hdr   - The buffer to be appended.
+ *   cmd   - The cmd of the sub frame.
+ *
+ * Returned Value:
+ *   True if the buffer is appended, false if there is no room for it.
+ *
+ ****************************************************************************/
+
+bool rpmsg_port_frame_append(FAR struct rpmsg_port_header_s *frame,
+                             uint16_t size,
+                             FAR struct rpmsg_port_header_s *hdr,
+                             uint16_t cmd);
+
+/****************************************************************************
+ * Name: rpmsg_port_queue_aggregate
+ *
+ * Description:
+ *   Move buffers from the head of the ready list of the queue into an
+ *   aggregated frame while they fit, and return them to the free list.
+ *   The frame must be a buffer of the same queue.
+ *
+ * Input Parameters:
+ *   queue - The queue to be aggregated from.
+ *   frame - The aggregated frame, see rpmsg_port_frame_append.
+ *   cmd   - The cmd of the sub frames.
+ *   max   - The maximum number of buffers to be aggregated.
+ *
+ * Returned Value:
+ *   Number of buffers aggregated.
+ *
+ ****************************************************************************/
+
+uint16_t rpmsg_port_queue_aggregate(FAR struct rpmsg_port_queue_s *queue,
+                                    FAR struct rpmsg_port_header_s *frame,
+                                    uint16_t cmd, uint16_t max);
+
+/****************************************************************************
+ * Name: rpmsg_port_queue_split
+ *
+ * Description:
+ *   Copy each sub frame of an aggregated frame into a buffer of the free
+ *   list of the queue. Without a callback the buffers are added to the
+ *   ready list and no free buffer is waited for, which is safe in the
+ *   interrupt context. With a callback each buffer is handed to it and a
+ *   free buffer is waited for.
+ *
+ * Input Parameters:
+ *   port     - The port the frame is received from.
+ *   queue    - The queue to be split to.
+ *   frame    - The aggregated frame, it is not released.
+ *   callback - The rx callback or NULL.
+ *
+ * Returned Value:
+ *   Number of sub frames on success or a negative value on failure.
+ *
+ ****************************************************************************/
+
+int rpmsg_port_queue_split(FAR struct rpmsg_port_s *port,
+                           FAR struct rpmsg_port_queue_s *queue,
+                           FAR struct rpmsg_port_header_s *frame,
+                           rpmsg_port_rx_cb_t callback);
+
 /****************************************************************************
  * Name: rpmsg_port_queue_navail
  *
@@ -56,6 +56,7 @@ enum rpmsg_port_spi_cmd_e
   RPMSG_PORT_SPI_CMD_CONNECT = 0x01,
   RPMSG_PORT_SPI_CMD_AVAIL,
   RPMSG_PORT_SPI_CMD_DATA,
+  RPMSG_PORT_SPI_CMD_AGGR,
 };
 
 struct rpmsg_port_spi_s
@@ -78,6 +79,12 @@ struct rpmsg_port_spi_s
 
   FAR struct rpmsg_port_header_s *cmdhdr;
 
+#ifdef CONFIG_RPMSG_PORT_AGGREGATE
+  /* Reserved for aggregated data send */
+
+  FAR struct rpmsg_port_header_s *aggrhdr;
+#endif
+
   /* Used for sync data state between sreq_handler and complete_handler */
 
   FAR struct rpmsg_port_header_s *txhdr;
@@ -185,6 +192,41 @@ static void rpmsg_port_spi_register_cb(FAR struct rpmsg_port_s *port,
   rpspi->rxcb = callback;
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_spi_aggregate
+ *
+ * Description:
+ *   Pack the queued tx buffers into the aggregated frame, no more than the
+ *   peer can receive. The peer splits the frame to its rx buffers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_PORT_AGGREGATE
+static FAR struct rpmsg_port_header_s *
+rpmsg_port_spi_aggregate(FAR struct rpmsg_port_spi_s *rpspi)
+{
+  FAR struct rpmsg_port_header_s *txhdr = rpspi->aggrhdr;
+
+  if (rpspi->txavail < 2 || rpmsg_port_queue_nused(&rpspi->port.txq) < 2)
+    {
+      return NULL;
+    }
+
+  txhdr->len = sizeof(struct rpmsg_port_header_s);
+  txhdr->cmd = RPMSG_PORT_SPI_CMD_AGGR;
+  if (rpmsg_port_queue_aggregate(&rpspi->port.txq, txhdr,
+                                 RPMSG_PORT_SPI_CMD_DATA,
+                                 rpspi->txavail) == 0)
+    {
+      return NULL;
+    }
+
+  return txhdr;
+}
+#else
+#  define rpmsg_port_spi_aggregate(rpspi) NULL
+#endif
+
 /****************************************************************************
  * Name: rpmsg_port_spi_exchange
  ****************************************************************************/
@@ -208,11 +250,15 @@ static void rpmsg_port_spi_exchange(FAR struct rpmsg_port_spi_s *rpspi)
   else if (rpspi->txavail > 0 &&
            rpmsg_port_queue_nused(&rpspi->port.txq) > 0)
     {
-      txhdr = rpmsg_port_queue_get_buffer(&rpspi->port.txq, false);
-      DEBUGASSERT(txhdr != NULL);
+      txhdr = rpmsg_port_spi_aggregate(rpspi);
+      if (txhdr == NULL)
+        {
+          txhdr = rpmsg_port_queue_get_buffer(&rpspi->port.txq, false);
+          DEBUGASSERT(txhdr != NULL);
 
-      txhdr->cmd = RPMSG_PORT_SPI_CMD_DATA;
-      rpspi->txhdr = txhdr;
+          txhdr->cmd = RPMSG_PORT_SPI_CMD_DATA;
+          rpspi->txhdr = txhdr;
+        }
     }
   else
     {
@@ -288,7 +334,16 @@ static void rpmsg_port_spi_complete_handler(FAR void *arg)
         }
     }
 
-  if (rpspi->rxhdr->cmd != RPMSG_PORT_SPI_CMD_AVAIL)
+  if (rpspi->rxhdr->cmd == RPMSG_PORT_SPI_CMD_AGGR)
+    {
+      /* The rx buffer is kept, the peer has counted one rx buffer for
+       * each sub frame.
+       */
+
+      rpmsg_port_queue_split(&rpspi->port, &rpspi->port.rxq,
+                             rpspi->rxhdr, NULL);
+    }
+  else if (rpspi->rxhdr->cmd != RPMSG_PORT_SPI_CMD_AVAIL)
     {
       rpmsg_port_queue_add_buffer(&rpspi->port.rxq, rpspi->rxhdr);
       rpspi->rxhdr = rpmsg_port_queue_get_available_buffer(
@@ -560,6 +615,12 @@ rpmsg_port_spi_initialize(FAR const struct rpmsg_port_config_s *cfg,
     &rpspi->port.rxq, true);
   DEBUGASSERT(rpspi->cmdhdr != NULL && rpspi->rxhdr != NULL);
 
+#ifdef CONFIG_RPMSG_PORT_AGGREGATE
+  rpspi->aggrhdr = rpmsg_port_queue_get_available_buffer(
+    &rpspi->port.txq, true);
+  DEBUGASSERT(rpspi->aggrhdr != NULL);
+#endif
+
   rpspi->rxthres = rpmsg_port_queue_navail(&rpspi->port.rxq) *
                    CONFIG_RPMSG_PORT_SPI_RX_THRESHOLD / 100;
 
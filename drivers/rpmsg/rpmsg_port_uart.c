@@ -49,6 +49,9 @@
 
 #define RPMSG_PORT_UART_BUFLEN             256
 
+#define RPMSG_PORT_UART_CMD_DATA           0
+#define RPMSG_PORT_UART_CMD_AGGR           1
+
 #define RPMSG_PORT_UART_RX_WAIT_START      1
 #define RPMSG_PORT_UART_RX_RECV_NORMAL     2
 #define RPMSG_PORT_UART_RX_RECV_ESCAPE     3
@@ -86,7 +89,8 @@ struct rpmsg_port_uart_s
  ****************************************************************************/
 
 static void rpmsg_port_uart_send_data(FAR struct rpmsg_port_uart_s *rpuart,
-                                      FAR struct rpmsg_port_header_s *hdr);
+                                      FAR struct rpmsg_port_header_s *hdr,
+                                      uint16_t cmd);
 
 static void rpmsg_port_uart_register_callback(FAR struct rpmsg_port_s *port,
                                               rpmsg_port_rx_cb_t callback);
@@ -192,17 +196,62 @@ static void rpmsg_port_uart_send_frame(FAR struct rpmsg_port_uart_s *rpuart,
  ****************************************************************************/
 
 static void rpmsg_port_uart_send_data(FAR struct rpmsg_port_uart_s *rpuart,
-                                      FAR struct rpmsg_port_header_s *hdr)
+                                      FAR struct rpmsg_port_header_s *hdr,
+                                      uint16_t cmd)
 {
   rpmsgdbg("Send data len: %" PRIu16 "\n", hdr->len);
 
-  hdr->cmd = 0;
+  hdr->cmd = cmd;
   hdr->avail = 0;
   hdr->crc = rpmsg_port_uart_crc16(hdr);
 
   rpmsg_port_uart_send_frame(rpuart, hdr, hdr->len);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_uart_aggregate
+ *
+ * Description:
+ *   Pack the tx buffer and the ones queued behind it into one frame, so
+ *   that a burst is sent as one frame. Return the buffer unchanged if
+ *   nothing is queued behind it or no frame buffer is free.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RPMSG_PORT_AGGREGATE
+static FAR struct rpmsg_port_header_s *
+rpmsg_port_uart_aggregate(FAR struct rpmsg_port_uart_s *rpuart,
+                          FAR struct rpmsg_port_header_s *hdr)
+{
+  FAR struct rpmsg_port_queue_s *txq = &rpuart->port.txq;
+  FAR struct rpmsg_port_header_s *frame;
+
+  if (rpmsg_port_queue_nused(txq) == 0)
+    {
+      return hdr;
+    }
+
+  frame = rpmsg_port_queue_get_available_buffer(txq, false);
+  if (frame == NULL)
+    {
+      return hdr;
+    }
+
+  frame->len = sizeof(struct rpmsg_port_header_s);
+  if (!rpmsg_port_frame_append(frame, txq->len, hdr,
+                               RPMSG_PORT_UART_CMD_DATA))
+    {
+      rpmsg_port_queue_return_buffer(txq, frame);
+      return hdr;
+    }
+
+  rpmsg_port_queue_return_buffer(txq, hdr);
+  rpmsg_port_queue_aggregate(txq, frame, RPMSG_PORT_UART_CMD_DATA,
+                             UINT16_MAX);
+  return frame;
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsg_port_uart_send_connect_req
  ****************************************************************************/
@@ -359,7 +408,17 @@ static int rpmsg_port_uart_rx_thread(int argc, FAR char *argv[])
                     DEBUGASSERT(hdr->crc == 0 ||
                                 hdr->crc == rpmsg_port_uart_crc16(hdr));
 
-                    if (rpuart->rx_cb != NULL)
+                    if (rpuart->rx_cb == NULL)
+                      {
+                        rpmsg_port_queue_return_buffer(rxq, hdr);
+                      }
+                    else if (hdr->cmd == RPMSG_PORT_UART_CMD_AGGR)
+                      {
+                        rpmsg_port_queue_split(&rpuart->port, rxq, hdr,
+                                               rpuart->rx_cb);
+                        rpmsg_port_queue_return_buffer(rxq, hdr);
+                      }
+                    else
                       {
                         rpuart->rx_cb(&rpuart->port, hdr);
                       }
@@ -414,7 +473,20 @@ static int rpmsg_port_uart_tx_thread(int argc, FAR char *argv[])
 
       while ((hdr = rpmsg_port_queue_get_buffer(txq, true)) != NULL)
         {
-          rpmsg_port_uart_send_data(rpuart, hdr);
+#ifdef CONFIG_RPMSG_PORT_AGGREGATE
+          FAR struct rpmsg_port_header_s *frame =
+            rpmsg_port_uart_aggregate(rpuart, hdr);
+
+          if (frame != hdr)
+            {
+              rpmsg_port_uart_send_data(rpuart, frame,
+                                        RPMSG_PORT_UART_CMD_AGGR);
+              rpmsg_port_queue_return_buffer(txq, frame);
+              continue;
+            }
+#endif
+
+          rpmsg_port_uart_send_data(rpuart, hdr, RPMSG_PORT_UART_CMD_DATA);
           rpmsg_port_queue_return_buffer(txq, hdr);
         }
     }
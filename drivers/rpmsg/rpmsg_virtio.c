@@ -32,6 +32,7 @@
 #include <nuttx/kthread.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/rpmsg/rpmsg_virtio.h>
+#include <metal/atomic.h>
 #include <rpmsg/rpmsg_internal.h>
 
 /****************************************************************************
@@ -47,6 +48,11 @@
 
 #define RPMSG_VIRTIO_CMD_PANIC  0x1
 
+#ifdef CONFIG_RPMSG_VIRTIO_EVENT_IDX
+#  define RPMSG_VIRTIO_COALESCE_TICKS \
+          USEC2TICK(CONFIG_RPMSG_VIRTIO_COALESCE_LATENCY)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -63,6 +69,9 @@ struct rpmsg_virtio_priv_s
   sem_t                         semtx;
   sem_t                         semrx;
   pid_t                         tid;
+#ifdef CONFIG_RPMSG_VIRTIO_EVENT_IDX
+  uint16_t                      rxbatch;
+#endif
 };
 
 /****************************************************************************
@@ -192,7 +201,11 @@ static uint32_t rpmsg_virtio_get_features_(FAR struct virtio_device *vdev)
 {
   FAR struct rpmsg_virtio_priv_s *priv = rpmsg_virtio_get_priv(vdev);
 
-  return priv->rsc->rpmsg_vdev.dfeatures;
+#ifdef CONFIG_RPMSG_VIRTIO_EVENT_IDX
+  return priv->rsc->rpmsg_vdev.dfeatures | VIRTIO_RING_F_EVENT_IDX;
+#else
+  return priv->rsc->rpmsg_vdev.dfeatures & ~VIRTIO_RING_F_EVENT_IDX;
+#endif
 }
 
 static void rpmsg_virtio_set_features(FAR struct virtio_device *vdev,
@@ -451,6 +464,103 @@ static void rpmsg_virtio_wakeup_rx(FAR struct rpmsg_virtio_priv_s *priv)
     }
 }
 
+#ifdef CONFIG_RPMSG_VIRTIO_EVENT_IDX
+/* The index of the next buffer the peer produces into the rx queue: the
+ * used ring for the host, the available ring for the remote.
+ */
+
+static uint16_t rpmsg_virtio_rx_index(FAR struct rpmsg_virtio_device *rvdev)
+{
+  FAR struct virtqueue *vq = rvdev->rvq;
+
+  if (rpmsg_virtio_get_role(rvdev) == RPMSG_HOST)
+    {
+      return vq->vq_used_cons_idx;
+    }
+  else
+    {
+      return vq->vq_available_idx;
+    }
+}
+
+static uint16_t
+rpmsg_virtio_rx_pending(FAR struct rpmsg_virtio_device *rvdev)
+{
+  FAR struct virtqueue *vq = rvdev->rvq;
+
+  if (rpmsg_virtio_get_role(rvdev) == RPMSG_HOST)
+    {
+      return vq->vq_ring.used->idx - vq->vq_used_cons_idx;
+    }
+  else
+    {
+      return vq->vq_ring.avail->idx - vq->vq_available_idx;
+    }
+}
+
+/* Ask the peer to notify only once 'ndesc' + 1 more buffers are queued to
+ * the rx queue, and return true if that many buffers already arrived, in
+ * which case no notification will come for them.
+ */
+
+static bool rpmsg_virtio_rx_event(FAR struct rpmsg_virtio_device *rvdev,
+                                  uint16_t ndesc)
+{
+  FAR struct virtqueue *vq = rvdev->rvq;
+  uint16_t idx = rpmsg_virtio_rx_index(rvdev) + ndesc;
+
+  if (rpmsg_virtio_get_role(rvdev) == RPMSG_HOST)
+    {
+      vring_used_event(&vq->vq_ring) = idx;
+    }
+  else
+    {
+      vring_avail_event(&vq->vq_ring) = idx;
+    }
+
+  atomic_thread_fence(memory_order_seq_cst);
+  return rpmsg_virtio_rx_pending(rvdev) > ndesc;
+}
+
+/* Process the rx queue and coalesce the next notifications: a wakeup that
+ * found a burst of buffers asks for the next notification after as many
+ * buffers, up to CONFIG_RPMSG_VIRTIO_COALESCE_BATCH, and is bounded by
+ * CONFIG_RPMSG_VIRTIO_COALESCE_LATENCY in case the burst stops early.  A
+ * wakeup that found a single buffer asks for a notification per buffer.
+ */
+
+static void rpmsg_virtio_rx_coalesce(FAR struct rpmsg_virtio_priv_s *priv)
+{
+  FAR struct rpmsg_virtio_device *rvdev = &priv->rvdev;
+  uint16_t count;
+
+  if (priv->rxbatch > 0)
+    {
+      nxsem_tickwait_uninterruptible(&priv->semrx,
+                                     RPMSG_VIRTIO_COALESCE_TICKS);
+    }
+  else
+    {
+      nxsem_wait_uninterruptible(&priv->semrx);
+    }
+
+  count = rpmsg_virtio_rx_index(rvdev);
+  virtqueue_notification(rvdev->rvq);
+  count = rpmsg_virtio_rx_index(rvdev) - count;
+
+  priv->rxbatch = MIN(count, CONFIG_RPMSG_VIRTIO_COALESCE_BATCH);
+  if (priv->rxbatch > 0)
+    {
+      priv->rxbatch--;
+    }
+
+  if (rpmsg_virtio_rx_event(rvdev, priv->rxbatch))
+    {
+      rpmsg_virtio_wakeup_rx(priv);
+    }
+}
+#endif
+
 static void rpmsg_virtio_command(FAR struct rpmsg_virtio_priv_s *priv)
 {
   FAR struct rpmsg_virtio_rsc_s *rsc = priv->rsc;
@@ -631,10 +741,18 @@ static int rpmsg_virtio_thread(int argc, FAR char *argv[])
       return ret;
     }
 
+#ifdef CONFIG_RPMSG_VIRTIO_EVENT_IDX
+  rpmsg_virtio_rx_event(&priv->rvdev, 0);
+#endif
+
   while (1)
     {
+#ifdef CONFIG_RPMSG_VIRTIO_EVENT_IDX
+      rpmsg_virtio_rx_coalesce(priv);
+#else
       nxsem_wait_uninterruptible(&priv->semrx);
       virtqueue_notification(priv->rvdev.rvq);
+#endif
     }
 
   return 0;
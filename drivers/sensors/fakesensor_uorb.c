@@ -56,6 +56,7 @@ struct fakesensor_s
   struct file data;
   uint32_t interval;
   uint32_t batch;
+  struct sensor_fifo_s fifo;
   int raw_start;
   FAR const char *file_path;
   sem_t wakeup;
@@ -74,6 +75,8 @@ static int fakesensor_set_interval(FAR struct sensor_lowerhalf_s *lower,
 static int fakesensor_batch(FAR struct sensor_lowerhalf_s *lower,
                             FAR struct file *filep,
                             FAR uint32_t *latency_us);
+static int fakesensor_fifo_read(FAR struct sensor_lowerhalf_s *lower,
+                                FAR void *buffer, uint32_t nsamples);
 static int fakegnss_activate(FAR struct gnss_lowerhalf_s *lower,
                              FAR struct file *filep, bool sw);
 static int fakegnss_set_interval(FAR struct gnss_lowerhalf_s *lower,
@@ -92,6 +95,7 @@ static struct sensor_ops_s g_fakesensor_ops =
   .activate = fakesensor_activate,
   .set_interval = fakesensor_set_interval,
   .batch = fakesensor_batch,
+  .fifo_read = fakesensor_fifo_read,
 };
 
 static struct gnss_ops_s g_fakegnss_ops =
@@ -153,45 +157,33 @@ static int fakesensor_read_csv_header(FAR struct fakesensor_s *sensor)
 }
 
 static inline void fakesensor_read_accel(FAR struct fakesensor_s *sensor,
-                                         uint64_t event_timestamp)
+                                         FAR struct sensor_accel *accel)
 {
-  struct sensor_accel accel;
   char raw[50];
   fakesensor_read_csv_line(
           &sensor->data, raw, sizeof(raw), sensor->raw_start);
-  sscanf(raw, "%f,%f,%f\n", &accel.x, &accel.y, &accel.z);
-  accel.temperature = NAN;
-  accel.timestamp = event_timestamp;
-  sensor->lower.push_event(sensor->lower.priv, &accel,
-                    sizeof(struct sensor_accel));
+  sscanf(raw, "%f,%f,%f\n", &accel->x, &accel->y, &accel->z);
+  accel->temperature = NAN;
 }
 
 static inline void fakesensor_read_mag(FAR struct fakesensor_s *sensor,
-                                       uint64_t event_timestamp)
+                                       FAR struct sensor_mag *mag)
 {
-  struct sensor_mag mag;
   char raw[50];
   fakesensor_read_csv_line(
           &sensor->data, raw, sizeof(raw), sensor->raw_start);
-  sscanf(raw, "%f,%f,%f\n", &mag.x, &mag.y, &mag.z);
-  mag.temperature = NAN;
-  mag.timestamp = event_timestamp;
-  sensor->lower.push_event(sensor->lower.priv, &mag,
-                           sizeof(struct sensor_mag));
+  sscanf(raw, "%f,%f,%f\n", &mag->x, &mag->y, &mag->z);
+  mag->temperature = NAN;
 }
 
 static inline void fakesensor_read_gyro(FAR struct fakesensor_s *sensor,
-                                        uint64_t event_timestamp)
+                                        FAR struct sensor_gyro *gyro)
 {
-  struct sensor_gyro gyro;
   char raw[50];
   fakesensor_read_csv_line(
           &sensor->data, raw, sizeof(raw), sensor->raw_start);
-  sscanf(raw, "%f,%f,%f\n", &gyro.x, &gyro.y, &gyro.z);
-  gyro.temperature = NAN;
-  gyro.timestamp = event_timestamp;
-  sensor->lower.push_event(sensor->lower.priv, &gyro,
-                    sizeof(struct sensor_gyro));
+  sscanf(raw, "%f,%f,%f\n", &gyro->x, &gyro->y, &gyro->z);
+  gyro->temperature = NAN;
 }
 
 static inline void fakesensor_read_gnss(FAR struct fakesensor_s *sensor)
@@ -245,6 +237,7 @@ static int fakesensor_set_interval(FAR struct sensor_lowerhalf_s *lower,
   FAR struct fakesensor_s *sensor = container_of(lower,
                                                  struct fakesensor_s, lower);
   sensor->interval = *period_us;
+  sensor->fifo.interval = *period_us;
   return OK;
 }
 
@@ -275,30 +268,59 @@ static int fakesensor_batch(FAR struct sensor_lowerhalf_s *lower,
   return OK;
 }
 
+static int fakesensor_fifo_read(FAR struct sensor_lowerhalf_s *lower,
+                                FAR void *buffer, uint32_t nsamples)
+{
+  FAR struct fakesensor_s *sensor = container_of(lower,
+                                                 struct fakesensor_s, lower);
+  uint32_t i;
+
+  for (i = 0; i < nsamples; i++)
+    {
+      switch (sensor->type)
+        {
+          case SENSOR_TYPE_ACCELEROMETER:
+            fakesensor_read_accel(sensor,
+                                  (FAR struct sensor_accel *)buffer + i);
+            break;
+
+          case SENSOR_TYPE_MAGNETIC_FIELD:
+            fakesensor_read_mag(sensor, (FAR struct sensor_mag *)buffer + i);
+            break;
+
+          case SENSOR_TYPE_GYROSCOPE:
+            fakesensor_read_gyro(sensor,
+                                 (FAR struct sensor_gyro *)buffer + i);
+            break;
+
+          default:
+            snerr("fakesensor: unsupported type sensor type\n");
+            return -ENOTSUP;
+        }
+    }
+
+  return nsamples;
+}
+
 void fakesensor_push_event(FAR struct fakesensor_s *sensor,
                            uint64_t event_timestamp)
 {
   switch (sensor->type)
   {
-    case SENSOR_TYPE_ACCELEROMETER:
-      fakesensor_read_accel(sensor, event_timestamp);
-      break;
-
-    case SENSOR_TYPE_MAGNETIC_FIELD:
-      fakesensor_read_mag(sensor, event_timestamp);
-      break;
-
-    case SENSOR_TYPE_GYROSCOPE:
-      fakesensor_read_gyro(sensor, event_timestamp);
-      break;
-
     case SENSOR_TYPE_GNSS:
     case SENSOR_TYPE_GNSS_SATELLITE:
       fakesensor_read_gnss(sensor);
       break;
 
     default:
-      snerr("fakesensor: unsupported type sensor type\n");
+
+      /* A batch is pushed at once, like a hardware FIFO at its
+       * watermark.
+       */
+
+      sensor_push_fifo(&sensor->lower, &sensor->fifo,
+                       sensor->batch ? sensor->batch / sensor->interval : 1,
+                       event_timestamp);
       break;
   }
 }
@@ -335,23 +357,7 @@ static int fakesensor_thread(int argc, char** argv)
 
           /* Notify upper */
 
-          if (sensor->batch)
-            {
-              uint32_t batch_num = sensor->batch / sensor->interval;
-              uint64_t event_timestamp =
-                  sensor_get_timestamp() - sensor->interval * batch_num;
-              int i;
-
-              for (i = 0; i < batch_num; i++)
-                {
-                  fakesensor_push_event(sensor, event_timestamp);
-                  event_timestamp += sensor->interval;
-                }
-            }
-          else
-            {
-              fakesensor_push_event(sensor, sensor_get_timestamp());
-            }
+          fakesensor_push_event(sensor, sensor_get_timestamp());
         }
 
       /* Close csv file handle when running change true to false */
@@ -412,6 +418,38 @@ int fakesensor_init(int type, FAR const char *file_name,
   sensor->file_path = file_name;
   sensor->type = type;
 
+  /* The buffer for a batch of samples */
+
+  switch (type)
+    {
+      case SENSOR_TYPE_ACCELEROMETER:
+        sensor->fifo.esize = sizeof(struct sensor_accel);
+        break;
+
+      case SENSOR_TYPE_MAGNETIC_FIELD:
+        sensor->fifo.esize = sizeof(struct sensor_mag);
+        break;
+
+      case SENSOR_TYPE_GYROSCOPE:
+        sensor->fifo.esize = sizeof(struct sensor_gyro);
+        break;
+
+      default:
+        break;
+    }
+
+  if (sensor->fifo.esize > 0)
+    {
+      sensor->fifo.depth  = batch_number > 0 ? batch_number : 1;
+      sensor->fifo.buffer = kmm_malloc(sensor->fifo.depth *
+                                       sensor->fifo.esize);
+      if (sensor->fifo.buffer == NULL)
+        {
+          kmm_free(sensor);
+          return -ENOMEM;
+        }
+    }
+
   nxsem_init(&sensor->wakeup, 0, 0);
 
   /* Create thread for sensor */
@@ -424,6 +462,7 @@ int fakesensor_init(int type, FAR const char *file_name,
                        fakesensor_thread, argv);
   if (ret < 0)
     {
+      kmm_free(sensor->fifo.buffer);
       kmm_free(sensor);
       return ERROR;
     }
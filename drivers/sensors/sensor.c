@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
@@ -38,6 +39,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/circbuf.h>
 #include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/sensors/sensor.h>
 
 /****************************************************************************
@@ -100,6 +102,10 @@ struct sensor_user_s
   bool             flushing;   /* The is used to indicate user is flushing */
   sem_t            buffersem;  /* Wakeup user waiting for data in circular buffer */
   size_t           bufferpos;  /* The index of user generation in buffer */
+#ifdef CONFIG_SENSORS_MMAP
+  bool             mapped;     /* The user reads the samples from the ring */
+  uint32_t         ringpos;    /* The ring head reported to the user */
+#endif
 
   /* The subscriber info
    * Support multi advertisers to subscribe their own data when they
@@ -119,6 +125,9 @@ struct sensor_upperhalf_s
   struct circbuf_s   buffer;             /* The circular buffer of data */
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_ring_s *ring;        /* The header of the buffer */
+#endif
 };
 
 /****************************************************************************
@@ -135,6 +144,10 @@ static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
                             size_t buflen);
 static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
+#ifdef CONFIG_SENSORS_MMAP
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
@@ -206,7 +219,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_MMAP
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -368,6 +385,56 @@ update:
   return ret;
 }
 
+static int sensor_init_buffer(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  size_t size = lower->nbuffer * upper->state.esize;
+  FAR void *base = NULL;
+  int ret;
+
+  if (circbuf_is_init(&upper->buffer))
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_SENSORS_MMAP
+  /* The samples follow the ring header, so both can be mapped */
+
+  upper->ring = kmm_zalloc(sizeof(struct sensor_ring_s) + size);
+  if (upper->ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->ring->nbuffer = lower->nbuffer;
+  upper->ring->esize   = upper->state.esize;
+  base                 = upper->ring + 1;
+#endif
+
+  ret = circbuf_init(&upper->buffer, base, size);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+#ifdef CONFIG_SENSORS_MMAP
+  kmm_free(upper->ring);
+  upper->ring = NULL;
+#endif
+  return ret;
+}
+
 static void sensor_generate_timing(FAR struct sensor_upperhalf_s *upper,
                                    unsigned long nums)
 {
@@ -1035,6 +1102,18 @@ static int sensor_poll(FAR struct file *filep,
                 }
             }
         }
+#ifdef CONFIG_SENSORS_MMAP
+      else if (user->mapped)
+        {
+          /* Report the samples written since the last report */
+
+          if (user->ringpos != upper->ring->head)
+            {
+              user->ringpos = upper->ring->head;
+              eventset |= POLLIN;
+            }
+        }
+#endif
       else if (sensor_is_updated(upper, user))
         {
           eventset |= POLLIN;
@@ -1058,11 +1137,58 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR struct sensor_user_s *user = filep->f_priv;
+  size_t size;
+  int ret;
+
+  /* The ring is read-only, and there is none if the samples are fetched
+   * from the lower half driver.
+   */
+
+  if (lower->ops->fetch != NULL)
+    {
+      return -ENODEV;
+    }
+
+  if ((map->prot & PROT_WRITE) != 0)
+    {
+      return -EACCES;
+    }
+
+  nxrmutex_lock(&upper->lock);
+  ret = sensor_init_buffer(upper);
+  if (ret >= 0)
+    {
+      size = sizeof(struct sensor_ring_s) + upper->buffer.size;
+      if (map->offset >= 0 && (size_t)map->offset < size &&
+          map->length <= size - map->offset)
+        {
+          map->vaddr    = (FAR char *)upper->ring + map->offset;
+          user->mapped  = true;
+          user->ringpos = upper->ring->head;
+        }
+      else
+        {
+          ret = -EINVAL;
+        }
+    }
+
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes)
 {
   FAR struct sensor_upperhalf_s *upper = priv;
-  FAR struct sensor_lowerhalf_s *lower = upper->lower;
   FAR struct sensor_user_s *user;
   unsigned long envcount;
   int semcount;
@@ -1093,32 +1219,42 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
       return -EINVAL;
     }
 
-  if (!circbuf_is_init(&upper->buffer))
-    {
-      /* Initialize sensor buffer when data is first generated */
-
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
-      if (ret < 0)
-        {
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
+  /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
-      if (ret < 0)
-        {
-          circbuf_uninit(&upper->buffer);
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
+  ret = sensor_init_buffer(upper);
+  if (ret < 0)
+    {
+      nxrmutex_unlock(&upper->lock);
+      return ret;
     }
 
   circbuf_overwrite(&upper->buffer, data, bytes);
   sensor_generate_timing(upper, envcount);
+
+#ifdef CONFIG_SENSORS_MMAP
+  /* Publish the samples to the users of the mapped ring */
+
+  SP_DMB();
+  upper->ring->head = upper->timing.head / TIMING_BUF_ESIZE;
+#endif
+
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
+#ifdef CONFIG_SENSORS_MMAP
+      if (user->mapped)
+        {
+          /* A waiting user reads up to the new head after the wakeup */
+
+          if (user->fds != NULL)
+            {
+              user->ringpos = upper->ring->head;
+              sensor_pollnotify_one(user, POLLIN, SENSOR_ROLE_RD);
+            }
+
+          continue;
+        }
+#endif
+
       if (sensor_is_updated(upper, user))
         {
           nxsem_get_value(&user->buffersem, &semcount);
@@ -1190,6 +1326,85 @@ void sensor_remap_vector_raw16(FAR const int16_t *in, FAR int16_t *out,
   memcpy(out, tmp, sizeof(tmp));
 }
 
+/****************************************************************************
+ * Name: sensor_push_fifo
+ *
+ * Description:
+ *   Lower half driver calls this function when its hardware FIFO holds
+ *   'nsamples' samples.  The samples are read with sensor_ops_s::fifo_read,
+ *   stamped and pushed as one batch.
+ *
+ * Input Parameters:
+ *   lower     - The instance of lower half sensor driver.
+ *   fifo      - The batch buffer of the lower half driver.
+ *   nsamples  - The number of samples in the hardware FIFO.
+ *   timestamp - The time of the watermark, in us.
+ *
+ * Returned Value:
+ *   The number of bytes pushed on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t sensor_push_fifo(FAR struct sensor_lowerhalf_s *lower,
+                         FAR struct sensor_fifo_s *fifo,
+                         uint32_t nsamples, uint64_t timestamp)
+{
+  FAR uint8_t *sample;
+  uint64_t period;
+  int ret;
+  int i;
+
+  if (lower->ops->fifo_read == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  if (nsamples > fifo->depth)
+    {
+      nsamples = fifo->depth;
+    }
+
+  if (nsamples == 0)
+    {
+      return 0;
+    }
+
+  ret = lower->ops->fifo_read(lower, fifo->buffer, nsamples);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  /* The samples were taken since the previous watermark.  Don't trust the
+   * measured period if the sensor was stopped in between.
+   */
+
+  period = fifo->interval;
+  if (fifo->timestamp != 0 && timestamp > fifo->timestamp)
+    {
+      uint64_t measured = (timestamp - fifo->timestamp) / ret;
+
+      if (period == 0 || (measured >= period / 2 && measured <= period * 2))
+        {
+          period = measured;
+        }
+    }
+
+  fifo->timestamp = timestamp;
+
+  sample = fifo->buffer;
+  for (i = 0; i < ret; i++)
+    {
+      uint64_t stamp = timestamp - (ret - 1 - i) * period;
+
+      memcpy(sample, &stamp, sizeof(stamp));
+      sample += fifo->esize;
+    }
+
+  return lower->push_event(lower->priv, fifo->buffer, ret * fifo->esize);
+}
+
 /****************************************************************************
  * Name: sensor_register
  *
@@ -1400,5 +1615,9 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
       circbuf_uninit(&upper->timing);
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  kmm_free(upper->ring);
+#endif
+
   kmm_free(upper);
 }
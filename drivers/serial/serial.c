@@ -27,6 +27,7 @@
 #include <ctype.h>
 #include <sys/types.h>
 #include <sys/param.h>
+#include <sys/uio.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <time.h>
@@ -108,6 +109,8 @@ static ssize_t uart_read(FAR struct file *filep,
 static ssize_t uart_write(FAR struct file *filep,
                           FAR const char *buffer,
                           size_t buflen);
+static ssize_t uart_writev(FAR struct file *filep,
+                           FAR const struct iovec *iov, int iovcnt);
 static int     uart_ioctl(FAR struct file *filep,
                           int cmd, unsigned long arg);
 static int     uart_poll(FAR struct file *filep,
@@ -140,10 +143,12 @@ static const struct file_operations g_serialops =
   uart_ioctl,   /* ioctl */
   NULL,         /* mmap */
   NULL,         /* truncate */
-  uart_poll     /* poll */
+  uart_poll,    /* poll */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  , uart_unlink /* unlink */
+  uart_unlink,  /* unlink */
 #endif
+  NULL,         /* readv */
+  uart_writev   /* writev */
 };
 
 #ifdef CONFIG_TTY_LAUNCH
@@ -1189,12 +1194,34 @@ static ssize_t uart_read(FAR struct file *filep,
 
 static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
                           size_t buflen)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR char *)buffer;
+  iov.iov_len  = buflen;
+  return uart_writev(filep, &iov, 1);
+}
+
+/****************************************************************************
+ * Name: uart_writev
+ *
+ * Description:
+ *   Copy all segments into the TX buffer while holding the xmit lock, so
+ *   that e.g. a line and its newline are not split by other writers.
+ *
+ ****************************************************************************/
+
+static ssize_t uart_writev(FAR struct file *filep,
+                           FAR const struct iovec *iov, int iovcnt)
 {
   FAR struct inode *inode    = filep->f_inode;
   FAR uart_dev_t   *dev      = inode->i_private;
-  ssize_t           nwritten = buflen;
+  FAR const char   *buffer;
+  ssize_t           nwritten = 0;
+  size_t            buflen;
   bool              oktoblock;
-  int               ret;
+  int               ret      = OK;
+  int               i;
   char              ch;
 
   /* We may receive serial writes through this path from interrupt handlers
@@ -1218,10 +1245,20 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
 #endif
 
       flags = enter_critical_section();
-      ret = uart_irqwrite(dev, buffer, buflen);
+      for (i = 0; i < iovcnt; i++)
+        {
+          ret = uart_irqwrite(dev, iov[i].iov_base, iov[i].iov_len);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          nwritten += ret;
+        }
+
       leave_critical_section(flags);
 
-      return ret;
+      return nwritten > 0 ? nwritten : ret;
     }
 
   /* Only one user can access dev->xmit.head at a time */
@@ -1263,80 +1300,77 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
    */
 
   uart_disabletxint(dev);
-  for (; buflen; buflen--)
+  for (i = 0; i < iovcnt && ret >= 0; i++)
     {
-      ch  = *buffer++;
-      ret = OK;
-
-      /* Do output post-processing */
+      buffer = iov[i].iov_base;
+      buflen = iov[i].iov_len;
 
-      if ((dev->tc_oflag & OPOST) != 0)
+      for (; buflen; buflen--)
         {
-          /* Mapping CR to NL? */
+          ch  = *buffer++;
+          ret = OK;
 
-          if ((ch == '\r') && (dev->tc_oflag & OCRNL) != 0)
+          /* Do output post-processing */
+
+          if ((dev->tc_oflag & OPOST) != 0)
             {
-              ch = '\n';
-            }
+              /* Mapping CR to NL? */
 
-          /* Are we interested in newline processing? */
+              if ((ch == '\r') && (dev->tc_oflag & OCRNL) != 0)
+                {
+                  ch = '\n';
+                }
 
-          if ((ch == '\n') && (dev->tc_oflag & (ONLCR | ONLRET)) != 0)
-            {
-              ret = uart_putxmitchar(dev, '\r', oktoblock);
-            }
+              /* Are we interested in newline processing? */
 
-          /* Specifically not handled:
-           *
-           * OXTABS - primarily a full-screen terminal optimization
-           * ONOEOT - Unix interoperability hack
-           * OLCUC  - Not specified by POSIX
-           * ONOCR  - low-speed interactive optimization
-           */
-        }
+              if ((ch == '\n') && (dev->tc_oflag & (ONLCR | ONLRET)) != 0)
+                {
+                  ret = uart_putxmitchar(dev, '\r', oktoblock);
+                }
 
-      /* Put the character into the transmit buffer */
+              /* Specifically not handled:
+               *
+               * OXTABS - primarily a full-screen terminal optimization
+               * ONOEOT - Unix interoperability hack
+               * OLCUC  - Not specified by POSIX
+               * ONOCR  - low-speed interactive optimization
+               */
+            }
 
-      if (ret >= 0)
-        {
-          ret = uart_putxmitchar(dev, ch, oktoblock);
-        }
+          /* Put the character into the transmit buffer */
 
-      /* uart_putxmitchar() might return an error under one of two
-       * conditions:  (1) The wait for buffer space might have been
-       * interrupted by a signal (ret should be -EINTR), (2) if
-       * CONFIG_SERIAL_REMOVABLE is defined, then uart_putxmitchar()
-       * might also return if the serial device was disconnected
-       * (with -ENOTCONN), or (3) if O_NONBLOCK is specified, then
-       * then uart_putxmitchar() might return -EAGAIN if the output
-       * TX buffer is full.
-       */
+          if (ret >= 0)
+            {
+              ret = uart_putxmitchar(dev, ch, oktoblock);
+            }
 
-      if (ret < 0)
-        {
-          /* POSIX requires that we return -1 and errno set if no data was
-           * transferred.  Otherwise, we return the number of bytes in the
-           * interrupted transfer.
+          /* uart_putxmitchar() might return an error under one of two
+           * conditions:  (1) The wait for buffer space might have been
+           * interrupted by a signal (ret should be -EINTR), (2) if
+           * CONFIG_SERIAL_REMOVABLE is defined, then uart_putxmitchar()
+           * might also return if the serial device was disconnected
+           * (with -ENOTCONN), or (3) if O_NONBLOCK is specified, then
+           * then uart_putxmitchar() might return -EAGAIN if the output
+           * TX buffer is full.
            */
 
-          if (buflen < (size_t)nwritten)
+          if (ret < 0)
             {
-              /* Some data was transferred.  Return the number of bytes that
-               * were successfully transferred.
+              /* POSIX requires that we return -1 and errno set if no data
+               * was transferred.  Otherwise, we return the number of bytes
+               * in the interrupted transfer.  The VFS layer will set the
+               * errno value appropriately.
                */
 
-              nwritten -= buflen;
-            }
-          else
-            {
-              /* No data was transferred. Return the negated errno value.
-               * The VFS layer will set the errno value appropriately).
-               */
+              if (nwritten == 0)
+                {
+                  nwritten = ret;
+                }
 
-              nwritten = ret;
+              break;
             }
 
-          break;
+          nwritten++;
         }
     }
 
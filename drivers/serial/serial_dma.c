@@ -359,4 +359,159 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_circular
+ *
+ * Description:
+ *   Account for the bytes that a circular Rx DMA has written to the RX
+ *   buffer.  In this mode the lower half runs one DMA transfer forever
+ *   over the whole dev->recv buffer, so no bytes are copied and no DMA
+ *   has to be re-armed.  The lower half calls this function from its
+ *   half-transfer, transfer-complete and line-idle interrupts with the
+ *   current DMA write position.
+ *
+ *   Waiting readers are woken once per burst:  While the line is busy,
+ *   they are only woken if c_cc[VMIN] bytes are buffered and the buffer
+ *   is half full, so a stream of half-transfer interrupts does not wake
+ *   them for each half buffer.  When the line goes idle, the burst is
+ *   over:  They are woken if VMIN bytes are buffered, or if any bytes are
+ *   buffered and VTIME is set (the idle line is the inter-byte timer) or
+ *   termios is not enabled.
+ *
+ * Input Parameters:
+ *   dev  - The serial device
+ *   pos  - The index in dev->recv.buffer that the DMA will write next
+ *   idle - True if called because the line went idle
+ *
+ * Assumptions:
+ *   Called from the interrupt handler of the lower half.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA_CIRCULAR
+void uart_recvchars_circular(FAR uart_dev_t *dev, size_t pos, bool idle)
+{
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  size_t nbuffered;
+  size_t nfree;
+  size_t nbytes;
+  bool wakeup;
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  int signo = 0;
+#endif
+
+  DEBUGASSERT(pos < rxbuf->size);
+
+  if (rxbuf->head >= rxbuf->tail)
+    {
+      nbuffered = rxbuf->head - rxbuf->tail;
+    }
+  else
+    {
+      nbuffered = rxbuf->size - rxbuf->tail + rxbuf->head;
+    }
+
+  if (pos >= rxbuf->head)
+    {
+      nbytes = pos - rxbuf->head;
+    }
+  else
+    {
+      nbytes = rxbuf->size - rxbuf->head + pos;
+    }
+
+  nfree = rxbuf->size - 1 - nbuffered;
+  if (nbytes > nfree)
+    {
+      /* The DMA has overwritten bytes that were not read yet.  They are
+       * lost anyway:  Just resynchronize with the DMA.
+       */
+
+      _err("ERROR: Rx DMA overrun, %zu bytes lost\n", nbytes - nfree);
+    }
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  /* Check if the SIGINT character is anywhere in the new bytes */
+
+  if (nbytes > 0)
+    {
+      if (pos > rxbuf->head)
+        {
+          signo = uart_check_special(dev, &rxbuf->buffer[rxbuf->head],
+                                     nbytes);
+        }
+      else
+        {
+          signo = uart_check_special(dev, &rxbuf->buffer[rxbuf->head],
+                                     rxbuf->size - rxbuf->head);
+          if (signo == 0)
+            {
+              signo = uart_check_special(dev, rxbuf->buffer, pos);
+            }
+        }
+    }
+#endif
+
+  rxbuf->head = pos;
+
+  if (rxbuf->head >= rxbuf->tail)
+    {
+      nbuffered = rxbuf->head - rxbuf->tail;
+    }
+  else
+    {
+      nbuffered = rxbuf->size - rxbuf->tail + rxbuf->head;
+    }
+
+#ifdef CONFIG_SERIAL_IFLOWCONTROL
+  /* Let the lower half throttle the sender before the DMA catches up with
+   * the reader.
+   */
+
+#ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
+  if (nbuffered >= (CONFIG_SERIAL_IFLOWCONTROL_UPPER_WATERMARK *
+                    rxbuf->size) / 100)
+#else
+  if (nbuffered >= rxbuf->size - 1)
+#endif
+    {
+      uart_rxflowcontrol(dev, nbuffered, true);
+    }
+#endif
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  if (idle)
+    {
+      wakeup = nbuffered > 0 &&
+               (nbuffered >= dev->minrecv || dev->timeout != 0);
+    }
+  else
+    {
+      wakeup = nbuffered > 0 && nbuffered >= dev->minrecv &&
+               nbuffered >= rxbuf->size / 2;
+    }
+#else
+  wakeup = nbuffered > 0 && (idle || nbuffered >= rxbuf->size / 2);
+#endif
+
+  if (wakeup)
+    {
+      uart_datareceived(dev);
+    }
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  /* Send the signal if necessary */
+
+  if (signo != 0)
+    {
+      nxsig_kill(dev->pid, signo);
+      uart_reset_sem(dev);
+    }
+#endif
+}
+#endif
+
 #endif /* CONFIG_SERIAL_TXDMA || CONFIG_SERIAL_RXDMA */
@@ -0,0 +1,388 @@
+/****************************************************************************
+ * drivers/spi/spi_async.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/spi/spi.h>
+#include <nuttx/spi/spi_transfer.h>
+
+#ifdef CONFIG_SPI_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define SPI_ASYNC_WORK HPWORK
+#else
+#  define SPI_ASYNC_WORK LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The asynchronous message queue of one SPI bus */
+
+struct spi_async_s
+{
+  FAR struct spi_dev_s *spi;          /* The bus */
+  spinlock_t lock;                    /* Protects the fields below */
+  FAR struct spi_message_s *head;     /* Message in progress, then the
+                                       * queued ones */
+  FAR struct spi_message_s *tail;     /* Last queued message */
+  bool busy;                          /* True while messages are run */
+  struct work_s work;                 /* Runs messages without SPI_ASYNC */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_async_remove
+ *
+ * Description:
+ *   Remove the message at the head of the queue.  If the queue becomes
+ *   empty, it is no longer busy.
+ *
+ ****************************************************************************/
+
+static FAR struct spi_message_s *
+spi_async_remove(FAR struct spi_async_s *async)
+{
+  FAR struct spi_message_s *msg;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&async->lock);
+
+  msg = async->head;
+  if (msg != NULL)
+    {
+      async->head = msg->flink;
+      if (async->head == NULL)
+        {
+          async->tail = NULL;
+        }
+    }
+  else
+    {
+      async->busy = false;
+    }
+
+  spin_unlock_irqrestore(&async->lock, flags);
+  return msg;
+}
+
+/****************************************************************************
+ * Name: spi_async_start
+ *
+ * Description:
+ *   Hand the message at the head of the queue to the lower half.  The
+ *   messages it refuses are completed with the error.
+ *
+ ****************************************************************************/
+
+static void spi_async_start(FAR struct spi_async_s *async)
+{
+  FAR struct spi_message_s *msg;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&async->lock);
+      msg = async->head;
+      if (msg == NULL)
+        {
+          async->busy = false;
+        }
+
+      spin_unlock_irqrestore(&async->lock, flags);
+
+      if (msg == NULL)
+        {
+          break;
+        }
+
+      ret = SPI_ASYNC(async->spi, msg);
+      if (ret >= 0)
+        {
+          break;
+        }
+
+      spierr("ERROR: SPI_ASYNC failed: %d\n", ret);
+
+      spi_async_remove(async);
+      msg->result = ret;
+      msg->callback(msg);
+    }
+}
+
+/****************************************************************************
+ * Name: spi_async_worker
+ *
+ * Description:
+ *   Run the queued messages with spi_transfer(), for lower halves without
+ *   SPI_ASYNC().
+ *
+ ****************************************************************************/
+
+static void spi_async_worker(FAR void *arg)
+{
+  FAR struct spi_async_s *async = arg;
+  FAR struct spi_message_s *msg;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&async->lock);
+      msg = async->head;
+      if (msg == NULL)
+        {
+          async->busy = false;
+        }
+
+      spin_unlock_irqrestore(&async->lock, flags);
+
+      if (msg == NULL)
+        {
+          break;
+        }
+
+      msg->result = spi_transfer(async->spi, msg->seq);
+
+      spi_async_remove(async);
+      msg->callback(msg);
+    }
+}
+
+/****************************************************************************
+ * Name: spi_async_wakeup
+ *
+ * Description:
+ *   The callback of the messages of spi_async_transfer().
+ *
+ ****************************************************************************/
+
+static void spi_async_wakeup(FAR struct spi_message_s *msg)
+{
+  nxsem_post(msg->arg);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_async_initialize
+ *
+ * Description:
+ *   Create the asynchronous message queue of an SPI bus.
+ *
+ * Input Parameters:
+ *   spi - An instance of the lower half SPI driver
+ *
+ * Returned Value:
+ *   The queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct spi_async_s *spi_async_initialize(FAR struct spi_dev_s *spi)
+{
+  FAR struct spi_async_s *async;
+
+  DEBUGASSERT(spi != NULL);
+
+  async = kmm_zalloc(sizeof(struct spi_async_s));
+  if (async != NULL)
+    {
+      async->spi = spi;
+      spin_lock_init(&async->lock);
+    }
+
+  return async;
+}
+
+/****************************************************************************
+ * Name: spi_async_uninitialize
+ *
+ * Description:
+ *   Free a queue created by spi_async_initialize().
+ *
+ ****************************************************************************/
+
+void spi_async_uninitialize(FAR struct spi_async_s *async)
+{
+  DEBUGASSERT(async != NULL && !async->busy);
+  kmm_free(async);
+}
+
+/****************************************************************************
+ * Name: spi_async_submit
+ *
+ * Description:
+ *   Queue a message and return.
+ *
+ * Input Parameters:
+ *   async - The queue of the bus
+ *   msg   - The message to transfer
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_async_submit(FAR struct spi_async_s *async,
+                     FAR struct spi_message_s *msg)
+{
+  irqstate_t flags;
+  bool start;
+
+  if (async == NULL || msg == NULL || msg->seq == NULL ||
+      msg->callback == NULL)
+    {
+      return -EINVAL;
+    }
+
+  msg->flink  = NULL;
+  msg->queue  = async;
+  msg->result = OK;
+
+  flags = spin_lock_irqsave(&async->lock);
+
+  if (async->tail != NULL)
+    {
+      async->tail->flink = msg;
+    }
+  else
+    {
+      async->head = msg;
+    }
+
+  async->tail = msg;
+
+  /* Only the submitter that finds the queue idle starts it */
+
+  start = !async->busy;
+  async->busy = true;
+
+  spin_unlock_irqrestore(&async->lock, flags);
+
+  if (start)
+    {
+      if (async->spi->ops->async != NULL)
+        {
+          spi_async_start(async);
+        }
+      else
+        {
+          work_queue(SPI_ASYNC_WORK, &async->work, spi_async_worker,
+                     async, 0);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spi_async_transfer
+ *
+ * Description:
+ *   Queue a sequence of transfers and wait for it.
+ *
+ * Input Parameters:
+ *   async - The queue of the bus
+ *   seq   - Describes the sequence of transfers.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_async_transfer(FAR struct spi_async_s *async,
+                       FAR struct spi_sequence_s *seq)
+{
+  struct spi_message_s msg;
+  sem_t sem;
+  int ret;
+
+  nxsem_init(&sem, 0, 0);
+
+  msg.seq      = seq;
+  msg.callback = spi_async_wakeup;
+  msg.arg      = &sem;
+
+  ret = spi_async_submit(async, &msg);
+  if (ret >= 0)
+    {
+      /* The message is on the queue, it must not go away before it is
+       * done.
+       */
+
+      nxsem_wait_uninterruptible(&sem);
+      ret = msg.result;
+    }
+
+  nxsem_destroy(&sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: spi_async_complete
+ *
+ * Description:
+ *   Called by a lower half that implements SPI_ASYNC() when the message it
+ *   was given is done.
+ *
+ * Input Parameters:
+ *   msg    - The message that is done
+ *   result - OK or a negated errno value
+ *
+ ****************************************************************************/
+
+void spi_async_complete(FAR struct spi_message_s *msg, int result)
+{
+  FAR struct spi_async_s *async = msg->queue;
+
+  DEBUGASSERT(async != NULL && async->head == msg);
+
+  spi_async_remove(async);
+  msg->result = result;
+  msg->callback(msg);
+
+  /* Start the next message right away, from the interrupt handler */
+
+  spi_async_start(async);
+}
+
+#endif /* CONFIG_SPI_ASYNC */
@@ -39,6 +39,7 @@
 #include <debug.h>
 #include <ctype.h>
 #include <sys/boardctl.h>
+#include <sys/param.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
@@ -50,6 +51,10 @@
 #include <nuttx/compiler.h>
 #include <nuttx/list.h>
 #include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/streams.h>
+
+#include "syslog.h"
 
 #ifdef CONFIG_RAMLOG
 
@@ -59,6 +64,32 @@
 
 #define RAMLOG_MAGIC_NUMBER 0x12345678
 
+#ifdef CONFIG_RAMLOG_BINARY
+#  define RAMLOG_MAGIC_BINARY 0x12345679
+
+/* The SYSLOG RAM log is a sequence of records */
+
+#  define RAMLOG_ISBINARY(priv) ((priv) == &g_sysdev)
+
+/* Record types */
+
+#  define RAMLOG_RECORD_TEXT   0 /* Text written to the device */
+#  define RAMLOG_RECORD_FORMAT 1 /* A syslog() message */
+#  define RAMLOG_RECORD_TIME   2 /* The time in full, after a long gap */
+
+#  define RAMLOG_RECORD_MAX \
+     (sizeof(struct ramlog_record_s) + \
+      MAX(sizeof(struct ramlog_format_s) + CONFIG_RAMLOG_BINARY_ARGSIZE, \
+          CONFIG_RAMLOG_BINARY_LINESIZE))
+
+/* The records refer to the format strings of the image that wrote them.
+ * A log kept across a reset is dropped if the address of this driver
+ * changed, a cheap sign of another image.
+ */
+
+#  define RAMLOG_IMAGE ((uintptr_t)&g_ramlogfops)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -67,14 +98,54 @@ struct ramlog_header_s
 {
   uint32_t          rl_magic;    /* The rl_magic number for ramlog buffer init */
   volatile uint32_t rl_head;     /* The head index (where data is added,natural growth) */
+#ifdef CONFIG_RAMLOG_BINARY
+  uint32_t          rl_oldest;   /* The index of the oldest record */
+  uintptr_t         rl_image;    /* RAMLOG_IMAGE of the writer */
+  uint64_t          rl_oldtime;  /* The time of the oldest record (us) */
+  uint64_t          rl_lasttime; /* The time of the newest record (us) */
+#endif
   char              rl_buffer[]; /* Circular RAM buffer */
 };
 
+#ifdef CONFIG_RAMLOG_BINARY
+/* The header of a record, followed by rc_len - sizeof(ramlog_record_s)
+ * bytes of data.  Records are not aligned in the buffer.
+ */
+
+begin_packed_struct struct ramlog_record_s
+{
+  uint16_t          rc_len;      /* The size of the record */
+  uint8_t           rc_type;     /* RAMLOG_RECORD_* */
+  uint8_t           rc_priority; /* The message priority */
+  uint32_t          rc_delta;    /* Microseconds since the previous record */
+} end_packed_struct;
+
+/* The data of a RAMLOG_RECORD_FORMAT record, followed by the arguments
+ * saved by syslog_pack().
+ */
+
+begin_packed_struct struct ramlog_format_s
+{
+  FAR const IPTR char *rf_fmt;   /* The format string */
+  pid_t             rf_pid;      /* The thread that generated the message */
+  uint8_t           rf_cpu;      /* The CPU that generated the message */
+} end_packed_struct;
+#endif
+
 struct ramlog_user_s
 {
   struct list_node  rl_node;       /* The list_node of reader */
   volatile uint32_t rl_tail;       /* The tail index (where data is removed) */
   uint32_t          rl_threashold; /* The threashold of the reader to read log */
+#ifdef CONFIG_RAMLOG_BINARY
+  uint64_t          rl_time;       /* The time of the last record read */
+  uint16_t          rl_textpos;    /* The next character of rl_text to read */
+  uint16_t          rl_textlen;    /* The length of rl_text */
+
+  /* The last record read, formatted as text */
+
+  char              rl_text[CONFIG_RAMLOG_BINARY_LINESIZE];
+#endif
 #ifndef CONFIG_RAMLOG_NONBLOCKING
   sem_t             rl_waitsem;    /* Used to wait for data */
 #endif
@@ -148,9 +219,9 @@ static const struct file_operations g_ramlogfops =
 #ifdef CONFIG_RAMLOG_SYSLOG
 #  ifdef RAMLOG_BUFFER_SECTION
 static uint32_t g_sysbuffer[CONFIG_RAMLOG_BUFSIZE / 4]
-                       locate_data(RAMLOG_BUFFER_SECTION);
+                       aligned_data(8) locate_data(RAMLOG_BUFFER_SECTION);
 #  else
-static uint32_t g_sysbuffer[CONFIG_RAMLOG_BUFSIZE / 4];
+static uint32_t g_sysbuffer[CONFIG_RAMLOG_BUFSIZE / 4] aligned_data(8);
 #  endif
 
 /* This is the device structure for the console or syslogging function.  It
@@ -234,6 +305,72 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv)
     }
 }
 
+/****************************************************************************
+ * Name: ramlog_notify
+ ****************************************************************************/
+
+static void ramlog_notify(FAR struct ramlog_dev_s *priv)
+{
+  /* Lock the scheduler do NOT switch out */
+
+  if (!up_interrupt_context())
+    {
+      sched_lock();
+    }
+
+#ifndef CONFIG_RAMLOG_NONBLOCKING
+  /* Are there threads waiting for read data? */
+
+  ramlog_readnotify(priv);
+#endif
+  /* Notify all poll/select waiters that they can read from the FIFO */
+
+  ramlog_pollnotify(priv);
+
+  /* Unlock the scheduler */
+
+  if (!up_interrupt_context())
+    {
+      sched_unlock();
+    }
+}
+
+/****************************************************************************
+ * Name: ramlog_initbuf
+ *
+ * Description:
+ *   Reset the SYSLOG RAM log unless it was kept across a reset.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_SYSLOG
+static void ramlog_initbuf(FAR struct ramlog_dev_s *priv)
+{
+  FAR struct ramlog_header_s *header = priv->rl_header;
+
+  if (priv != &g_sysdev)
+    {
+      return;
+    }
+
+#ifdef CONFIG_RAMLOG_BINARY
+  if (header->rl_magic != RAMLOG_MAGIC_BINARY ||
+      header->rl_image != RAMLOG_IMAGE)
+    {
+      memset(header, 0, sizeof(g_sysbuffer));
+      header->rl_magic = RAMLOG_MAGIC_BINARY;
+      header->rl_image = RAMLOG_IMAGE;
+    }
+#else
+  if (header->rl_magic != RAMLOG_MAGIC_NUMBER)
+    {
+      memset(header, 0, sizeof(g_sysbuffer));
+      header->rl_magic = RAMLOG_MAGIC_NUMBER;
+    }
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: ramlog_copybuf
  ****************************************************************************/
@@ -267,6 +404,371 @@ static void ramlog_copybuf(FAR struct ramlog_dev_s *priv,
   header->rl_head += len;
 }
 
+#ifdef CONFIG_RAMLOG_BINARY
+
+/****************************************************************************
+ * Name: ramlog_peekbuf
+ *
+ * Description:
+ *   Copy data out of the circular buffer, starting at the given index.
+ *
+ ****************************************************************************/
+
+static void ramlog_peekbuf(FAR struct ramlog_dev_s *priv, uint32_t index,
+                           FAR void *buffer, size_t len)
+{
+  FAR char *buf = priv->rl_header->rl_buffer;
+  uint32_t offset = index % priv->rl_bufsize;
+  uint32_t tail = priv->rl_bufsize - offset;
+
+  if (len > tail)
+    {
+      memcpy(buffer, &buf[offset], tail);
+      memcpy((FAR char *)buffer + tail, buf, len - tail);
+    }
+  else
+    {
+      memcpy(buffer, &buf[offset], len);
+    }
+}
+
+/****************************************************************************
+ * Name: ramlog_time
+ *
+ * Description:
+ *   Get the time of a record in microseconds, zero without timestamps.
+ *
+ ****************************************************************************/
+
+static uint64_t ramlog_time(void)
+{
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec ts;
+
+  syslog_timestamp(&ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+#else
+  return 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: ramlog_makeroom
+ *
+ * Description:
+ *   Drop the oldest records until a record of len bytes fits.
+ *
+ ****************************************************************************/
+
+static void ramlog_makeroom(FAR struct ramlog_dev_s *priv, size_t len)
+{
+  FAR struct ramlog_header_s *header = priv->rl_header;
+  struct ramlog_record_s record;
+  uint64_t time;
+
+  while (header->rl_head - header->rl_oldest + len > priv->rl_bufsize)
+    {
+      ramlog_peekbuf(priv, header->rl_oldest, &record, sizeof(record));
+      if (record.rc_len < sizeof(record) ||
+          record.rc_len > header->rl_head - header->rl_oldest)
+        {
+          /* The records are corrupted, drop all of them */
+
+          header->rl_oldest = header->rl_head;
+          break;
+        }
+
+      header->rl_oldest += record.rc_len;
+      if (header->rl_oldest == header->rl_head)
+        {
+          break;
+        }
+
+      /* Keep the time of the new oldest record */
+
+      ramlog_peekbuf(priv, header->rl_oldest, &record, sizeof(record));
+      if (record.rc_type == RAMLOG_RECORD_TIME)
+        {
+          ramlog_peekbuf(priv, header->rl_oldest + sizeof(record),
+                         &time, sizeof(time));
+          header->rl_oldtime = time;
+        }
+      else
+        {
+          header->rl_oldtime += record.rc_delta;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: ramlog_putrecord
+ ****************************************************************************/
+
+static void ramlog_putrecord(FAR struct ramlog_dev_s *priv, uint8_t type,
+                             uint8_t priority, uint64_t now,
+                             FAR const void *data, size_t len)
+{
+  FAR struct ramlog_header_s *header = priv->rl_header;
+  struct ramlog_record_s record;
+
+  if (sizeof(record) + len > priv->rl_bufsize)
+    {
+      return;
+    }
+
+  record.rc_len      = sizeof(record) + len;
+  record.rc_type     = type;
+  record.rc_priority = priority;
+  record.rc_delta    = now - header->rl_lasttime;
+
+  ramlog_makeroom(priv, record.rc_len);
+  if (header->rl_oldest == header->rl_head)
+    {
+      header->rl_oldtime = now;
+    }
+
+  ramlog_copybuf(priv, (FAR const char *)&record, sizeof(record));
+  ramlog_copybuf(priv, data, len);
+  header->rl_lasttime = now;
+}
+
+/****************************************************************************
+ * Name: ramlog_addrecord
+ *
+ * Description:
+ *   Add a record to the SYSLOG RAM log, dropping the oldest records to make
+ *   room for it.
+ *
+ ****************************************************************************/
+
+static void ramlog_addrecord(FAR struct ramlog_dev_s *priv, uint8_t type,
+                             uint8_t priority, FAR const void *data,
+                             size_t len)
+{
+  FAR struct ramlog_header_s *header = priv->rl_header;
+  irqstate_t flags;
+  uint64_t now;
+
+  flags = enter_critical_section();
+
+  ramlog_initbuf(priv);
+
+  /* Keep the time monotonic, and save it in full after a gap that does not
+   * fit in the delta.
+   */
+
+  now = ramlog_time();
+  if (now < header->rl_lasttime)
+    {
+      now = header->rl_lasttime;
+    }
+
+  if (now - header->rl_lasttime > UINT32_MAX)
+    {
+      ramlog_putrecord(priv, RAMLOG_RECORD_TIME, 0, now, &now, sizeof(now));
+    }
+
+  ramlog_putrecord(priv, type, priority, now, data, len);
+  ramlog_notify(priv);
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: ramlog_addtext
+ ****************************************************************************/
+
+static ssize_t ramlog_addtext(FAR struct ramlog_dev_s *priv,
+                              FAR const char *buffer, size_t len)
+{
+  size_t nwritten;
+  size_t ncopy;
+
+  for (nwritten = 0; nwritten < len; nwritten += ncopy)
+    {
+      ncopy = MIN(len - nwritten, CONFIG_RAMLOG_BINARY_LINESIZE);
+      ramlog_addrecord(priv, RAMLOG_RECORD_TEXT, 0, &buffer[nwritten],
+                       ncopy);
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: ramlog_decode
+ *
+ * Description:
+ *   Format a record into the text buffer of a reader.
+ *
+ ****************************************************************************/
+
+static void ramlog_decode(FAR struct ramlog_user_s *upriv,
+                          FAR const struct ramlog_record_s *record,
+                          FAR const uint8_t *data, size_t len)
+{
+  struct lib_memoutstream_s stream;
+  struct ramlog_format_s format;
+  struct timespec ts;
+
+  upriv->rl_textpos = 0;
+  upriv->rl_textlen = 0;
+
+  switch (record->rc_type)
+    {
+      case RAMLOG_RECORD_TEXT:
+        upriv->rl_textlen = MIN(len, sizeof(upriv->rl_text));
+        memcpy(upriv->rl_text, data, upriv->rl_textlen);
+        break;
+
+      case RAMLOG_RECORD_FORMAT:
+        if (len < sizeof(format))
+          {
+            break;
+          }
+
+        memcpy(&format, data, sizeof(format));
+        ts.tv_sec  = upriv->rl_time / USEC_PER_SEC;
+        ts.tv_nsec = upriv->rl_time % USEC_PER_SEC * NSEC_PER_USEC;
+
+        /* Keep room for the newline */
+
+        lib_memoutstream(&stream, upriv->rl_text,
+                         sizeof(upriv->rl_text) - 1);
+        syslog_header(&stream.common, record->rc_priority, &ts,
+                      format.rf_cpu, format.rf_pid);
+        syslog_unpack(&stream.common, format.rf_fmt, data + sizeof(format),
+                      len - sizeof(format));
+
+        upriv->rl_textlen = stream.common.nput;
+        if (upriv->rl_textlen == 0 ||
+            upriv->rl_text[upriv->rl_textlen - 1] != '\n')
+          {
+            upriv->rl_text[upriv->rl_textlen++] = '\n';
+          }
+        break;
+
+      case RAMLOG_RECORD_TIME:
+        if (len == sizeof(upriv->rl_time))
+          {
+            memcpy(&upriv->rl_time, data, len);
+          }
+        break;
+
+      default:
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: ramlog_readrecords
+ *
+ * Description:
+ *   Read the SYSLOG RAM log.  Each record is copied out of the buffer and
+ *   formatted as a line of text outside of the critical section.
+ *
+ ****************************************************************************/
+
+static ssize_t ramlog_readrecords(FAR struct file *filep, FAR char *buffer,
+                                  size_t len)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct ramlog_dev_s *priv = inode->i_private;
+  FAR struct ramlog_header_s *header = priv->rl_header;
+  FAR struct ramlog_user_s *upriv = filep->f_priv;
+  uint8_t data[RAMLOG_RECORD_MAX];
+  struct ramlog_record_s record;
+  irqstate_t flags;
+  ssize_t nread = 0;
+  size_t ncopy;
+
+  DEBUGASSERT(!up_interrupt_context());
+
+  while ((size_t)nread < len)
+    {
+      /* Return the rest of the last record first */
+
+      if (upriv->rl_textpos < upriv->rl_textlen)
+        {
+          ncopy = MIN(upriv->rl_textlen - upriv->rl_textpos, len - nread);
+          memcpy(&buffer[nread], &upriv->rl_text[upriv->rl_textpos], ncopy);
+          upriv->rl_textpos += ncopy;
+          nread += ncopy;
+          continue;
+        }
+
+      flags = enter_critical_section();
+
+      ramlog_initbuf(priv);
+
+      /* Start again from the oldest record if the next one was dropped or
+       * the buffer was flushed.
+       */
+
+      if ((int32_t)(upriv->rl_tail - header->rl_oldest) < 0 ||
+          (int32_t)(header->rl_head - upriv->rl_tail) < 0)
+        {
+          upriv->rl_tail = header->rl_oldest;
+        }
+
+      if (upriv->rl_tail == header->rl_head)
+        {
+#ifdef CONFIG_RAMLOG_NONBLOCKING
+          /* Return what we have (with zero mean the end-of-file) */
+
+          leave_critical_section(flags);
+          break;
+#else
+          int ret;
+
+          if (nread > 0 || (filep->f_oflags & O_NONBLOCK) != 0)
+            {
+              leave_critical_section(flags);
+              if (nread == 0)
+                {
+                  nread = -EAGAIN;
+                }
+
+              break;
+            }
+
+          ret = nxsem_wait(&upriv->rl_waitsem);
+          leave_critical_section(flags);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          continue;
+#endif /* CONFIG_RAMLOG_NONBLOCKING */
+        }
+
+      ramlog_peekbuf(priv, upriv->rl_tail, &record, sizeof(record));
+      if (record.rc_len < sizeof(record) || record.rc_len > sizeof(data) ||
+          record.rc_len > header->rl_head - upriv->rl_tail)
+        {
+          /* Skip the records that are corrupted */
+
+          upriv->rl_tail = header->rl_head;
+          leave_critical_section(flags);
+          continue;
+        }
+
+      ramlog_peekbuf(priv, upriv->rl_tail, data, record.rc_len);
+      upriv->rl_time  = upriv->rl_tail == header->rl_oldest ?
+                        header->rl_oldtime :
+                        upriv->rl_time + record.rc_delta;
+      upriv->rl_tail += record.rc_len;
+
+      leave_critical_section(flags);
+
+      ramlog_decode(upriv, &record, data + sizeof(record),
+                    record.rc_len - sizeof(record));
+    }
+
+  return nread;
+}
+#endif /* CONFIG_RAMLOG_BINARY */
+
 /****************************************************************************
  * Name: ramlog_addbuf
  ****************************************************************************/
@@ -274,7 +776,7 @@ static void ramlog_copybuf(FAR struct ramlog_dev_s *priv,
 static ssize_t ramlog_addbuf(FAR struct ramlog_dev_s *priv,
                              FAR const char *buffer, size_t len)
 {
-#if defined(CONFIG_RAMLOG_SYSLOG) || defined(CONFIG_RAMLOG_CRLF)
+#ifdef CONFIG_RAMLOG_CRLF
   FAR struct ramlog_header_s *header = priv->rl_header;
 #endif
   size_t buflen = len;
@@ -290,11 +792,7 @@ static ssize_t ramlog_addbuf(FAR struct ramlog_dev_s *priv,
   flags = enter_critical_section();
 
 #ifdef CONFIG_RAMLOG_SYSLOG
-  if (header->rl_magic != RAMLOG_MAGIC_NUMBER && priv == &g_sysdev)
-    {
-      memset(header, 0, sizeof(g_sysbuffer));
-      header->rl_magic = RAMLOG_MAGIC_NUMBER;
-    }
+  ramlog_initbuf(priv);
 #endif
 
   if (buflen > priv->rl_bufsize)
@@ -337,28 +835,7 @@ static ssize_t ramlog_addbuf(FAR struct ramlog_dev_s *priv,
 
   if (len > 0)
     {
-      /* Lock the scheduler do NOT switch out */
-
-      if (!up_interrupt_context())
-        {
-          sched_lock();
-        }
-
-#ifndef CONFIG_RAMLOG_NONBLOCKING
-      /* Are there threads waiting for read data? */
-
-      ramlog_readnotify(priv);
-#endif
-      /* Notify all poll/select waiters that they can read from the FIFO */
-
-      ramlog_pollnotify(priv);
-
-      /* Unlock the scheduler */
-
-      if (!up_interrupt_context())
-        {
-          sched_unlock();
-        }
+      ramlog_notify(priv);
     }
 
   /* We always have to return the number of bytes requested and NOT the
@@ -393,6 +870,13 @@ static ssize_t ramlog_file_read(FAR struct file *filep, FAR char *buffer,
 
   DEBUGASSERT(!up_interrupt_context());
 
+#ifdef CONFIG_RAMLOG_BINARY
+  if (RAMLOG_ISBINARY(priv))
+    {
+      return ramlog_readrecords(filep, buffer, len);
+    }
+#endif
+
   /* Get exclusive access to the rl_tail index */
 
   flags = enter_critical_section();
@@ -508,6 +992,13 @@ static ssize_t ramlog_file_write(FAR struct file *filep,
   FAR struct inode *inode = filep->f_inode;
   FAR struct ramlog_dev_s *priv = inode->i_private;
 
+#ifdef CONFIG_RAMLOG_BINARY
+  if (RAMLOG_ISBINARY(priv))
+    {
+      return ramlog_addtext(priv, buffer, len);
+    }
+#endif
+
   return ramlog_addbuf(priv, buffer, len);
 }
 
@@ -536,6 +1027,9 @@ static int ramlog_file_ioctl(FAR struct file *filep, int cmd,
         break;
       case BIOC_FLUSH:
         priv->rl_header->rl_head = 0;
+#ifdef CONFIG_RAMLOG_BINARY
+        priv->rl_header->rl_oldest = 0;
+#endif
         break;
       default:
         ret = -ENOTTY;
@@ -631,8 +1125,19 @@ static int ramlog_file_open(FAR struct file *filep)
 
   flags = enter_critical_section();
   list_add_tail(&priv->rl_list, &upriv->rl_node);
-  upriv->rl_tail = header->rl_head > priv->rl_bufsize ?
-                   header->rl_head - priv->rl_bufsize : 0;
+#ifdef CONFIG_RAMLOG_BINARY
+  if (RAMLOG_ISBINARY(priv))
+    {
+      ramlog_initbuf(priv);
+      upriv->rl_tail = header->rl_oldest;
+    }
+  else
+#endif
+    {
+      upriv->rl_tail = header->rl_head > priv->rl_bufsize ?
+                       header->rl_head - priv->rl_bufsize : 0;
+    }
+
   leave_critical_section(flags);
 
   filep->f_priv = upriv;
@@ -738,9 +1243,15 @@ int ramlog_putc(FAR syslog_channel_t *channel, int ch)
 
   UNUSED(channel);
 
+#ifndef CONFIG_RAMLOG_BINARY
   /* Add the character to the RAMLOG */
 
   ramlog_addbuf(&g_sysdev, &cch, 1);
+#else
+  /* The messages of syslog() were saved by ramlog_vsyslog() */
+
+  UNUSED(cch);
+#endif
 
   /* Return the character added on success */
 
@@ -750,7 +1261,39 @@ int ramlog_putc(FAR syslog_channel_t *channel, int ch)
 ssize_t ramlog_write(FAR syslog_channel_t *channel,
                      FAR const char *buffer, size_t buflen)
 {
+#ifdef CONFIG_RAMLOG_BINARY
+  return buflen;
+#else
   return ramlog_addbuf(&g_sysdev, buffer, buflen);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: ramlog_vsyslog
+ *
+ * Description:
+ *   Save a syslog() message as a record of the SYSLOG RAM log.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_BINARY
+void ramlog_vsyslog(int priority, FAR const IPTR char *fmt, va_list ap)
+{
+  uint8_t data[sizeof(struct ramlog_format_s) +
+               CONFIG_RAMLOG_BINARY_ARGSIZE];
+  struct ramlog_format_s format;
+  size_t len;
+
+  format.rf_fmt = fmt;
+  format.rf_pid = nxsched_gettid();
+  format.rf_cpu = this_cpu();
+  memcpy(data, &format, sizeof(format));
+
+  len = syslog_pack(data + sizeof(format), CONFIG_RAMLOG_BINARY_ARGSIZE,
+                    fmt, ap);
+  ramlog_addrecord(&g_sysdev, RAMLOG_RECORD_FORMAT, priority, data,
+                   sizeof(format) + len);
 }
 #endif
 
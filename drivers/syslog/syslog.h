@@ -27,7 +27,13 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/streams.h>
 
 /****************************************************************************
  * Public Data
@@ -228,6 +234,152 @@ int syslog_add_intbuffer(int ch);
 int syslog_flush_intbuffer(bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_timestamp
+ *
+ * Description:
+ *   Get the time to prepend to a message, zero until the hardware timer is
+ *   available.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+void syslog_timestamp(FAR struct timespec *ts);
+#endif
+
+/****************************************************************************
+ * Name: syslog_header
+ *
+ * Description:
+ *   Write the configured prefix of a message to a syslog stream.
+ *
+ * Input Parameters:
+ *   stream   - The syslog stream
+ *   priority - The message priority
+ *   ts       - The time of the message (unused without timestamps)
+ *   cpu      - The CPU that generated the message
+ *   pid      - The thread that generated the message
+ *
+ * Returned Value:
+ *   The number of characters written.
+ *
+ ****************************************************************************/
+
+int syslog_header(FAR struct lib_outstream_s *stream, int priority,
+                  FAR const struct timespec *ts, int cpu, pid_t pid);
+
+/****************************************************************************
+ * Name: syslog_trailer
+ *
+ * Description:
+ *   Terminate a message written to a syslog stream.
+ *
+ * Returned Value:
+ *   The number of characters written.
+ *
+ ****************************************************************************/
+
+int syslog_trailer(FAR struct lib_syslograwstream_s *stream);
+
+/****************************************************************************
+ * Name: syslog_pack
+ *
+ * Description:
+ *   Save the arguments of a message, in the order of the conversions of
+ *   its format string, so that it can be formatted later.  Strings are
+ *   copied; packing stops at the first argument that does not fit.
+ *
+ * Input Parameters:
+ *   buf  - The buffer that receives the arguments
+ *   size - The size of the buffer
+ *   fmt  - The format string, which must outlive the buffer
+ *   ap   - The arguments of the message
+ *
+ * Returned Value:
+ *   The number of bytes used in the buffer.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SYSLOG_DEFERRED) || defined(CONFIG_RAMLOG_BINARY)
+size_t syslog_pack(FAR uint8_t *buf, size_t size,
+                   FAR const IPTR char *fmt, va_list ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_unpack
+ *
+ * Description:
+ *   Format a message from the arguments saved by syslog_pack().
+ *
+ * Input Parameters:
+ *   stream - The stream that receives the message
+ *   fmt    - The format string that was packed
+ *   buf    - The saved arguments
+ *   len    - The number of bytes saved
+ *
+ * Returned Value:
+ *   The number of characters written.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SYSLOG_DEFERRED) || defined(CONFIG_RAMLOG_BINARY)
+int syslog_unpack(FAR struct lib_outstream_s *stream,
+                  FAR const IPTR char *fmt, FAR const uint8_t *buf,
+                  size_t len);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_initialize
+ *
+ * Description:
+ *   Start the thread that formats and writes the deferred messages.  The
+ *   messages are written synchronously until then.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_write
+ *
+ * Description:
+ *   Save the format string and the arguments of a message in the ring of
+ *   the current CPU for the drain thread.
+ *
+ * Input Parameters:
+ *   priority - The message priority
+ *   fmt      - The format string, that must stay valid until it is drained
+ *   ap       - The arguments
+ *
+ * Returned Value:
+ *   True if the message was deferred (or dropped because the ring is
+ *   full); false if it must be written synchronously.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+bool syslog_deferred_write(int priority, FAR const IPTR char *fmt,
+                           FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_flush
+ *
+ * Description:
+ *   Format and write all of the deferred messages now, unless another
+ *   thread is already doing so.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+void syslog_deferred_flush(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
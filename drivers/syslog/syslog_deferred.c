@@ -0,0 +1,339 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <syslog.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/streams.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SYSLOG_DMASK      (CONFIG_SYSLOG_DEFERRED_NENTRIES - 1)
+
+#if (CONFIG_SYSLOG_DEFERRED_NENTRIES & SYSLOG_DMASK) != 0
+#  error CONFIG_SYSLOG_DEFERRED_NENTRIES must be a power of two
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One deferred message */
+
+struct syslog_dentry_s
+{
+  FAR const IPTR char *fmt;    /* The format string */
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec ts;          /* The time of the message */
+#endif
+  pid_t    pid;                /* The thread that generated the message */
+  uint8_t  priority;           /* The message priority */
+  uint16_t len;                /* The number of bytes in data[] */
+
+  /* The packed arguments */
+
+  uint8_t  data[CONFIG_SYSLOG_DEFERRED_ARGSIZE];
+};
+
+/* The messages deferred on one CPU.  Only that CPU, with its interrupts
+ * disabled, fills entries and advances the head; only the thread that
+ * holds g_syslog_ddraining writes entries out and advances the tail.
+ */
+
+struct syslog_dring_s
+{
+  atomic_uint head;            /* Next entry to fill */
+  atomic_uint tail;            /* Next entry to write out */
+  atomic_uint dropped;         /* Messages lost since the last drain */
+  struct syslog_dentry_s entry[CONFIG_SYSLOG_DEFERRED_NENTRIES];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_dring_s g_syslog_dring[CONFIG_SMP_NCPUS];
+static sem_t g_syslog_dsem = SEM_INITIALIZER(0);
+static atomic_bool g_syslog_ddraining;
+static pid_t g_syslog_dpid;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_doutput
+ *
+ * Description:
+ *   Write a deferred message out to the channels.
+ *
+ ****************************************************************************/
+
+static void syslog_doutput(int cpu, FAR const struct syslog_dentry_s *entry)
+{
+  struct lib_syslograwstream_s stream;
+  FAR const struct timespec *ts = NULL;
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  ts = &entry->ts;
+#endif
+
+  lib_syslograwstream_open(&stream);
+  syslog_header(&stream.common, entry->priority, ts, cpu, entry->pid);
+  syslog_unpack(&stream.common, entry->fmt, entry->data, entry->len);
+  syslog_trailer(&stream);
+  lib_syslograwstream_close(&stream);
+}
+
+/****************************************************************************
+ * Name: syslog_ddrain
+ *
+ * Description:
+ *   Write out the messages deferred on one CPU.
+ *
+ * Returned Value:
+ *   True if there was anything to write.
+ *
+ ****************************************************************************/
+
+static bool syslog_ddrain(int cpu, FAR struct syslog_dring_s *ring)
+{
+  struct lib_syslograwstream_s stream;
+  unsigned int dropped;
+  unsigned int head;
+  unsigned int tail;
+
+  tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+  while (tail != head)
+    {
+      syslog_doutput(cpu, &ring->entry[tail & SYSLOG_DMASK]);
+      atomic_store_explicit(&ring->tail, ++tail, memory_order_release);
+    }
+
+  dropped = atomic_exchange(&ring->dropped, 0);
+  if (dropped > 0)
+    {
+      lib_syslograwstream_open(&stream);
+      lib_sprintf_internal(&stream.common,
+                           "[CPU%d] %u syslog messages dropped\n",
+                           cpu, dropped);
+      lib_syslograwstream_close(&stream);
+    }
+
+  return tail != atomic_load_explicit(&ring->head, memory_order_acquire) ||
+         dropped > 0;
+}
+
+/****************************************************************************
+ * Name: syslog_dthread
+ *
+ * Description:
+ *   The drain thread.  It sleeps until a CPU queues work on an empty ring.
+ *
+ ****************************************************************************/
+
+static int syslog_dthread(int argc, FAR char *argv[])
+{
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&g_syslog_dsem);
+      syslog_deferred_flush();
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_deferred_initialize
+ *
+ * Description:
+ *   Start the thread that formats and writes the deferred messages.  The
+ *   messages are written synchronously until then.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int syslog_deferred_initialize(void)
+{
+  int pid;
+
+  pid = kthread_create("syslogd", CONFIG_SYSLOG_DEFERRED_PRIORITY,
+                       CONFIG_SYSLOG_DEFERRED_STACKSIZE,
+                       syslog_dthread, NULL);
+  if (pid < 0)
+    {
+      return pid;
+    }
+
+  g_syslog_dpid = pid;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_write
+ *
+ * Description:
+ *   Save the format string and the arguments of a message in the ring of
+ *   the current CPU for the drain thread.  No lock is taken:  The ring
+ *   belongs to the CPU and its interrupts are disabled while the entry is
+ *   filled.
+ *
+ * Input Parameters:
+ *   priority - The message priority
+ *   fmt      - The format string, that must stay valid until it is drained
+ *   ap       - The arguments
+ *
+ * Returned Value:
+ *   True if the message was deferred (or dropped because the ring is
+ *   full); false if it must be written synchronously.
+ *
+ ****************************************************************************/
+
+bool syslog_deferred_write(int priority, FAR const IPTR char *fmt,
+                           FAR va_list *ap)
+{
+  FAR struct syslog_dentry_s *entry;
+  FAR struct syslog_dring_s *ring;
+  irqstate_t flags;
+  unsigned int head;
+
+  if (g_syslog_dpid <= 0 || priority <= LOG_CRIT)
+    {
+      return false;
+    }
+
+  flags = up_irq_save();
+  ring  = &g_syslog_dring[this_cpu()];
+  head  = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+  if (head - atomic_load_explicit(&ring->tail, memory_order_acquire) >=
+      CONFIG_SYSLOG_DEFERRED_NENTRIES)
+    {
+      atomic_fetch_add(&ring->dropped, 1);
+      up_irq_restore(flags);
+      return true;
+    }
+
+  entry           = &ring->entry[head & SYSLOG_DMASK];
+  entry->fmt      = fmt;
+  entry->pid      = nxsched_gettid();
+  entry->priority = priority;
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  syslog_timestamp(&entry->ts);
+#endif
+
+  entry->len      = syslog_pack(entry->data, sizeof(entry->data), fmt, *ap);
+
+  atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+  up_irq_restore(flags);
+
+  /* Wake up the drain thread if it may have found the ring empty.  It
+   * checks the rings again after it has written them out, so an entry
+   * that it was not done with is not missed.
+   */
+
+  if (atomic_load_explicit(&ring->tail, memory_order_acquire) == head)
+    {
+      nxsem_post(&g_syslog_dsem);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_flush
+ *
+ * Description:
+ *   Format and write all of the deferred messages now, unless another
+ *   thread is already doing so.
+ *
+ ****************************************************************************/
+
+void syslog_deferred_flush(void)
+{
+  bool more;
+  int cpu;
+
+  do
+    {
+      if (atomic_exchange(&g_syslog_ddraining, true))
+        {
+          return;
+        }
+
+      do
+        {
+          more = false;
+          for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+            {
+              more |= syslog_ddrain(cpu, &g_syslog_dring[cpu]);
+            }
+        }
+      while (more);
+
+      atomic_store(&g_syslog_ddraining, false);
+
+      /* A message may have been queued by a CPU that woke up a thread that
+       * found us draining:  Check again now that we are done.
+       */
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          FAR struct syslog_dring_s *ring = &g_syslog_dring[cpu];
+
+          if (atomic_load(&ring->head) != atomic_load(&ring->tail))
+            {
+              more = true;
+            }
+        }
+    }
+  while (more);
+}
+
+#endif /* CONFIG_SYSLOG_DEFERRED */
@@ -0,0 +1,545 @@
+/****************************************************************************
+ * drivers/syslog/syslog_pack.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <nuttx/streams.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The longest conversion specification that is rebuilt for formatting */
+
+#define SYSLOG_SPECLEN    32
+
+/* Save one argument of the given type, or fetch it and format it */
+
+#define SYSLOG_PACK(buf, size, len, ap, type) \
+  do \
+    { \
+      type v_ = va_arg(ap, type); \
+      if (!syslog_put(buf, size, &(len), &v_, sizeof(v_))) \
+        { \
+          return len; \
+        } \
+    } \
+  while (0)
+
+#define SYSLOG_UNPACK(stream, buf, len, off, spec, type, ret) \
+  do \
+    { \
+      type v_; \
+      if (!syslog_get(buf, len, &(off), &v_, sizeof(v_))) \
+        { \
+          return ret; \
+        } \
+      ret += lib_sprintf_internal(stream, spec, v_); \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The type of the argument of a conversion */
+
+enum syslog_arg_e
+{
+  SYSLOG_ARG_NONE = 0,         /* "%%" or unknown, no argument */
+  SYSLOG_ARG_INT,              /* int, also char and short promoted */
+  SYSLOG_ARG_LONG,             /* long */
+#ifdef CONFIG_HAVE_LONG_LONG
+  SYSLOG_ARG_LLONG,            /* long long */
+#endif
+  SYSLOG_ARG_INTMAX,           /* intmax_t */
+  SYSLOG_ARG_SIZE,             /* size_t */
+  SYSLOG_ARG_PTRDIFF,          /* ptrdiff_t */
+  SYSLOG_ARG_PTR,              /* void * */
+  SYSLOG_ARG_DOUBLE,           /* double, also float promoted */
+#ifdef CONFIG_HAVE_LONG_DOUBLE
+  SYSLOG_ARG_LDOUBLE,          /* long double */
+#endif
+  SYSLOG_ARG_STR,              /* The string is copied into the buffer */
+  SYSLOG_ARG_COUNT             /* "%n", the pointer is ignored */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_parse
+ *
+ * Description:
+ *   Parse the conversion specification that follows a '%'.
+ *
+ * Input Parameters:
+ *   fmt    - The character after the '%'
+ *   type   - Returns the type of the argument
+ *   nstars - Returns the number of '*' width and precision arguments
+ *
+ * Returned Value:
+ *   The character after the conversion specification.
+ *
+ ****************************************************************************/
+
+static FAR const IPTR char *syslog_parse(FAR const IPTR char *fmt,
+                                         FAR uint8_t *type,
+                                         FAR uint8_t *nstars)
+{
+  char lmod = '\0';
+  char conv;
+
+  *nstars = 0;
+
+  /* Flags, width and precision */
+
+  while (*fmt == '-' || *fmt == '+' || *fmt == ' ' || *fmt == '#' ||
+         *fmt == '0' || *fmt == '\'')
+    {
+      fmt++;
+    }
+
+  if (*fmt == '*')
+    {
+      (*nstars)++;
+      fmt++;
+    }
+
+  while (*fmt >= '0' && *fmt <= '9')
+    {
+      fmt++;
+    }
+
+  if (*fmt == '.')
+    {
+      fmt++;
+      if (*fmt == '*')
+        {
+          (*nstars)++;
+          fmt++;
+        }
+
+      while (*fmt >= '0' && *fmt <= '9')
+        {
+          fmt++;
+        }
+    }
+
+  /* Length modifier: "hh" is recorded as 'H' and "ll" as 'q' */
+
+  switch (*fmt)
+    {
+      case 'h':
+      case 'l':
+        lmod = *fmt++;
+        if (*fmt == lmod)
+          {
+            lmod = lmod == 'h' ? 'H' : 'q';
+            fmt++;
+          }
+        break;
+
+      case 'j':
+      case 'z':
+      case 't':
+      case 'L':
+        lmod = *fmt++;
+        break;
+
+      default:
+        break;
+    }
+
+  conv = *fmt;
+  if (conv != '\0')
+    {
+      fmt++;
+    }
+
+  switch (conv)
+    {
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+        switch (lmod)
+          {
+            case 'l':
+              *type = SYSLOG_ARG_LONG;
+              break;
+
+            case 'q':
+#ifdef CONFIG_HAVE_LONG_LONG
+              *type = SYSLOG_ARG_LLONG;
+#else
+              *type = SYSLOG_ARG_LONG;
+#endif
+              break;
+
+            case 'j':
+              *type = SYSLOG_ARG_INTMAX;
+              break;
+
+            case 'z':
+              *type = SYSLOG_ARG_SIZE;
+              break;
+
+            case 't':
+              *type = SYSLOG_ARG_PTRDIFF;
+              break;
+
+            default:
+              *type = SYSLOG_ARG_INT;
+              break;
+          }
+        break;
+
+      case 'c':
+        *type = SYSLOG_ARG_INT;
+        break;
+
+      case 'p':
+        *type = SYSLOG_ARG_PTR;
+        break;
+
+      case 's':
+        *type = SYSLOG_ARG_STR;
+        break;
+
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+#ifdef CONFIG_HAVE_LONG_DOUBLE
+        *type = lmod == 'L' ? SYSLOG_ARG_LDOUBLE : SYSLOG_ARG_DOUBLE;
+#else
+        *type = SYSLOG_ARG_DOUBLE;
+#endif
+        break;
+
+      case 'n':
+        *type = SYSLOG_ARG_COUNT;
+        break;
+
+      default:
+        *type = SYSLOG_ARG_NONE;
+        break;
+    }
+
+  return fmt;
+}
+
+/****************************************************************************
+ * Name: syslog_put/syslog_get
+ *
+ * Description:
+ *   Append one argument to a buffer, or fetch the next one.
+ *
+ ****************************************************************************/
+
+static bool syslog_put(FAR uint8_t *buf, size_t size, FAR size_t *len,
+                       FAR const void *value, size_t vsize)
+{
+  if (*len + vsize > size)
+    {
+      return false;
+    }
+
+  memcpy(&buf[*len], value, vsize);
+  *len += vsize;
+  return true;
+}
+
+static bool syslog_get(FAR const uint8_t *buf, size_t len, FAR size_t *off,
+                       FAR void *value, size_t vsize)
+{
+  if (*off + vsize > len)
+    {
+      return false;
+    }
+
+  memcpy(value, &buf[*off], vsize);
+  *off += vsize;
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_pack
+ *
+ * Description:
+ *   Save the arguments of a message in the order of the conversions.
+ *   Packing stops at the first argument that does not fit.
+ *
+ * Returned Value:
+ *   The number of bytes used in the buffer.
+ *
+ ****************************************************************************/
+
+size_t syslog_pack(FAR uint8_t *buf, size_t size,
+                   FAR const IPTR char *fmt, va_list ap)
+{
+  FAR const char *str;
+  uint8_t nstars;
+  uint8_t type;
+  size_t len = 0;
+  size_t n;
+
+  while (*fmt != '\0')
+    {
+      if (*fmt++ != '%')
+        {
+          continue;
+        }
+
+      fmt = syslog_parse(fmt, &type, &nstars);
+      while (nstars-- > 0)
+        {
+          SYSLOG_PACK(buf, size, len, ap, int);
+        }
+
+      switch (type)
+        {
+          case SYSLOG_ARG_INT:
+            SYSLOG_PACK(buf, size, len, ap, int);
+            break;
+
+          case SYSLOG_ARG_LONG:
+            SYSLOG_PACK(buf, size, len, ap, long);
+            break;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+          case SYSLOG_ARG_LLONG:
+            SYSLOG_PACK(buf, size, len, ap, long long);
+            break;
+#endif
+
+          case SYSLOG_ARG_INTMAX:
+            SYSLOG_PACK(buf, size, len, ap, intmax_t);
+            break;
+
+          case SYSLOG_ARG_SIZE:
+            SYSLOG_PACK(buf, size, len, ap, size_t);
+            break;
+
+          case SYSLOG_ARG_PTRDIFF:
+            SYSLOG_PACK(buf, size, len, ap, ptrdiff_t);
+            break;
+
+          case SYSLOG_ARG_PTR:
+            SYSLOG_PACK(buf, size, len, ap, FAR void *);
+            break;
+
+          case SYSLOG_ARG_DOUBLE:
+            SYSLOG_PACK(buf, size, len, ap, double);
+            break;
+
+#ifdef CONFIG_HAVE_LONG_DOUBLE
+          case SYSLOG_ARG_LDOUBLE:
+            SYSLOG_PACK(buf, size, len, ap, long double);
+            break;
+#endif
+
+          case SYSLOG_ARG_STR:
+
+            /* Copy as much of the string as fits, with its terminator */
+
+            str = va_arg(ap, FAR const char *);
+            if (str == NULL)
+              {
+                str = "(null)";
+              }
+
+            if (len >= size)
+              {
+                return len;
+              }
+
+            n = strnlen(str, size - len - 1);
+            memcpy(&buf[len], str, n);
+            buf[len + n] = '\0';
+            len += n + 1;
+            break;
+
+          case SYSLOG_ARG_COUNT:
+            (void)va_arg(ap, FAR int *);
+            break;
+
+          default:
+            break;
+        }
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: syslog_unpack
+ *
+ * Description:
+ *   Format a message from the arguments saved by syslog_pack().  Each
+ *   conversion is rebuilt, with the '*' replaced by the saved values, and
+ *   formatted with its own argument.  Formatting stops at the first
+ *   argument that was not saved.
+ *
+ * Returned Value:
+ *   The number of characters written.
+ *
+ ****************************************************************************/
+
+int syslog_unpack(FAR struct lib_outstream_s *stream,
+                  FAR const IPTR char *fmt, FAR const uint8_t *buf,
+                  size_t len)
+{
+  FAR const IPTR char *start;
+  FAR const char *str;
+  char spec[SYSLOG_SPECLEN];
+  uint8_t nstars;
+  uint8_t type;
+  size_t off = 0;
+  size_t n;
+  int ret = 0;
+  int star;
+
+  while (*fmt != '\0')
+    {
+      if (*fmt != '%')
+        {
+          lib_stream_putc(stream, *fmt++);
+          ret++;
+          continue;
+        }
+
+      start = fmt;
+      fmt   = syslog_parse(fmt + 1, &type, &nstars);
+
+      for (n = 0; start < fmt; start++)
+        {
+          if (*start == '*')
+            {
+              if (!syslog_get(buf, len, &off, &star, sizeof(star)))
+                {
+                  return ret;
+                }
+
+              n += snprintf(&spec[n], sizeof(spec) - n, "%d", star);
+            }
+          else
+            {
+              spec[n++] = *start;
+            }
+
+          if (n >= sizeof(spec) - 1)
+            {
+              return ret;
+            }
+        }
+
+      spec[n] = '\0';
+
+      switch (type)
+        {
+          case SYSLOG_ARG_INT:
+            SYSLOG_UNPACK(stream, buf, len, off, spec, int, ret);
+            break;
+
+          case SYSLOG_ARG_LONG:
+            SYSLOG_UNPACK(stream, buf, len, off, spec, long, ret);
+            break;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+          case SYSLOG_ARG_LLONG:
+            SYSLOG_UNPACK(stream, buf, len, off, spec, long long, ret);
+            break;
+#endif
+
+          case SYSLOG_ARG_INTMAX:
+            SYSLOG_UNPACK(stream, buf, len, off, spec, intmax_t, ret);
+            break;
+
+          case SYSLOG_ARG_SIZE:
+            SYSLOG_UNPACK(stream, buf, len, off, spec, size_t, ret);
+            break;
+
+          case SYSLOG_ARG_PTRDIFF:
+            SYSLOG_UNPACK(stream, buf, len, off, spec, ptrdiff_t, ret);
+            break;
+
+          case SYSLOG_ARG_PTR:
+            SYSLOG_UNPACK(stream, buf, len, off, spec, FAR void *, ret);
+            break;
+
+          case SYSLOG_ARG_DOUBLE:
+            SYSLOG_UNPACK(stream, buf, len, off, spec, double, ret);
+            break;
+
+#ifdef CONFIG_HAVE_LONG_DOUBLE
+          case SYSLOG_ARG_LDOUBLE:
+            SYSLOG_UNPACK(stream, buf, len, off, spec, long double, ret);
+            break;
+#endif
+
+          case SYSLOG_ARG_STR:
+            str = (FAR const char *)&buf[off];
+            n   = strnlen(str, len - off);
+            if (n == len - off)
+              {
+                return ret;
+              }
+
+            off += n + 1;
+            ret += lib_sprintf_internal(stream, spec, str);
+            break;
+
+          case SYSLOG_ARG_COUNT:
+            break;
+
+          default:
+            ret += lib_sprintf_internal(stream, spec);
+            break;
+        }
+    }
+
+  return ret;
+}
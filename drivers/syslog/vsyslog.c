@@ -30,8 +30,10 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/init.h>
+#include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/streams.h>
+#include <nuttx/syslog/ramlog.h>
 #include <nuttx/syslog/syslog.h>
 
 #include "syslog.h"
@@ -67,90 +69,96 @@ static FAR const char * const g_priority_str[] =
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nx_vsyslog
+ * Name: syslog_timestamp
  *
  * Description:
- *   nx_vsyslog() handles the system logging system calls. It is functionally
- *   equivalent to vsyslog() except that (1) the per-process priority
- *   filtering has already been performed and the va_list parameter is
- *   passed by reference.  That is because the va_list is a structure in
- *   some compilers and passing of structures in the NuttX sycalls does
- *   not work.
+ *   Get the time to prepend to a message.  Since debug output may be
+ *   generated very early in the start-up sequence, hardware timer support
+ *   may not yet be available:  The time is zero then.
  *
  ****************************************************************************/
 
-int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
-{
-  struct lib_syslograwstream_s stream;
-  int ret = 0;
-#if CONFIG_TASK_NAME_SIZE > 0 && defined(CONFIG_SYSLOG_PROCESS_NAME)
-  FAR struct tcb_s *tcb = nxsched_get_tcb(nxsched_gettid());
-#endif
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  struct timespec ts;
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  struct tm tm;
-  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
-#  endif
-#endif
-
-  /* Wrap the low-level output in a stream object and let lib_vsprintf
-   * do the work.
-   */
-
-  lib_syslograwstream_open(&stream);
-
 #ifdef CONFIG_SYSLOG_TIMESTAMP
-  ts.tv_sec = 0;
-  ts.tv_nsec = 0;
-
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  memset(&tm, 0, sizeof(tm));
-#  endif
-
-  /* Get the current time.  Since debug output may be generated very early
-   * in the start-up sequence, hardware timer support may not yet be
-   * available.
-   */
+void syslog_timestamp(FAR struct timespec *ts)
+{
+  ts->tv_sec = 0;
+  ts->tv_nsec = 0;
 
   if (OSINIT_HW_READY())
     {
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
       /* Use CLOCK_REALTIME if so configured */
 
-      clock_gettime(CLOCK_REALTIME, &ts);
+      clock_gettime(CLOCK_REALTIME, ts);
 #  else
       /* Prefer monotonic when enabled, as it can be synchronized to
        * RTC with clock_resynchronize.
        */
 
-      clock_gettime(CLOCK_MONOTONIC, &ts);
+      clock_gettime(CLOCK_MONOTONIC, ts);
 #  endif
+    }
+}
+#endif
 
-      /* Prepend the message with the current time, if available */
+/****************************************************************************
+ * Name: syslog_header
+ *
+ * Description:
+ *   Write the configured prefix of a message: The time from
+ *   syslog_timestamp(), the CPU, the thread ID, the priority, etc.
+ *
+ * Input Parameters:
+ *   stream   - The syslog stream
+ *   priority - The message priority
+ *   ts       - The time of the message (unused without timestamps)
+ *   cpu      - The CPU that generated the message
+ *   pid      - The thread that generated the message
+ *
+ * Returned Value:
+ *   The number of characters written.
+ *
+ ****************************************************************************/
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-#    if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
-      localtime_r(&ts.tv_sec, &tm);
-#    else
-      gmtime_r(&ts.tv_sec, &tm);
-#    endif
+int syslog_header(FAR struct lib_outstream_s *stream, int priority,
+                  FAR const struct timespec *ts, int cpu, pid_t pid)
+{
+  int ret = 0;
+#if CONFIG_TASK_NAME_SIZE > 0 && defined(CONFIG_SYSLOG_PROCESS_NAME)
+  FAR struct tcb_s *tcb = nxsched_get_tcb(pid);
+#endif
+#if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+  struct tm tm;
+  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
+
+  memset(&tm, 0, sizeof(tm));
+
+  /* Prepend the message with the current time, if available */
+
+  if (ts->tv_sec != 0 || ts->tv_nsec != 0)
+    {
+#  if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
+      localtime_r(&ts->tv_sec, &tm);
+#  else
+      gmtime_r(&ts->tv_sec, &tm);
 #  endif
     }
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   date_buf[0] = '\0';
   strftime(date_buf, CONFIG_SYSLOG_TIMESTAMP_BUFFER,
            CONFIG_SYSLOG_TIMESTAMP_FORMAT, &tm);
-#  endif
 #endif
 
+  UNUSED(ts);
+  UNUSED(cpu);
+  UNUSED(pid);
+
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT) || defined(CONFIG_SYSLOG_TIMESTAMP) || \
     defined(CONFIG_SMP) || defined(CONFIG_SYSLOG_PROCESSID) || \
     defined(CONFIG_SYSLOG_PRIORITY) || defined(CONFIG_SYSLOG_PREFIX) || \
     defined(CONFIG_SYSLOG_PROCESS_NAME)
 
-  ret = lib_sprintf_internal(&stream.common,
+  ret = lib_sprintf_internal(stream,
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
   /* Reset the terminal style. */
 
@@ -204,24 +212,24 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_TIMESTAMP
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_FORMAT_MICROSECOND)
-                             , date_buf, ts.tv_nsec / NSEC_PER_USEC
+                             , date_buf, ts->tv_nsec / NSEC_PER_USEC
 #    else
                              , date_buf
 #    endif
 #  else
-                             , (uintmax_t)ts.tv_sec
-                             , ts.tv_nsec / NSEC_PER_USEC
+                             , (uintmax_t)ts->tv_sec
+                             , ts->tv_nsec / NSEC_PER_USEC
 #  endif
 #endif
 
 #if defined(CONFIG_SMP)
-                             , up_cpu_index()
+                             , cpu
 #endif
 
 #if defined(CONFIG_SYSLOG_PROCESSID)
   /* Prepend the Thread ID */
 
-                             , nxsched_gettid()
+                             , pid
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
@@ -251,22 +259,97 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 
 #endif /* CONFIG_SYSLOG_COLOR_OUTPUT || CONFIG_SYSLOG_TIMESTAMP || ... */
 
-  /* Generate the output */
+  return ret;
+}
 
-  ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
+/****************************************************************************
+ * Name: syslog_trailer
+ *
+ * Description:
+ *   Terminate a message written to a syslog stream with a newline, if it
+ *   does not have one, and reset the terminal style.
+ *
+ * Returned Value:
+ *   The number of characters written.
+ *
+ ****************************************************************************/
+
+int syslog_trailer(FAR struct lib_syslograwstream_s *stream)
+{
+  int ret = 0;
 
-  if (stream.last_ch != '\n')
+  if (stream->last_ch != '\n')
     {
-      lib_stream_putc(&stream.common, '\n');
+      lib_stream_putc(&stream->common, '\n');
       ret++;
     }
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
   /* Reset the terminal style back to normal. */
 
-  ret += lib_stream_puts(&stream.common, "\e[0m", sizeof("\e[0m"));
+  ret += lib_stream_puts(&stream->common, "\e[0m", sizeof("\e[0m"));
 #endif
 
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nx_vsyslog
+ *
+ * Description:
+ *   nx_vsyslog() handles the system logging system calls. It is functionally
+ *   equivalent to vsyslog() except that (1) the per-process priority
+ *   filtering has already been performed and the va_list parameter is
+ *   passed by reference.  That is because the va_list is a structure in
+ *   some compilers and passing of structures in the NuttX sycalls does
+ *   not work.
+ *
+ ****************************************************************************/
+
+int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  struct lib_syslograwstream_s stream;
+  struct timespec ts;
+#ifdef CONFIG_RAMLOG_BINARY
+  va_list copy;
+#endif
+  int ret;
+
+#ifdef CONFIG_RAMLOG_BINARY
+  /* Save the message in the RAM log before the arguments are consumed */
+
+  va_copy(copy, *ap);
+  ramlog_vsyslog(priority, fmt, copy);
+  va_end(copy);
+#endif
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Leave the formatting and the output to the drain thread */
+
+  if (syslog_deferred_write(priority, fmt, ap))
+    {
+      return 0;
+    }
+#endif
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  syslog_timestamp(&ts);
+#endif
+
+  /* Wrap the low-level output in a stream object and let lib_vsprintf
+   * do the work.
+   */
+
+  lib_syslograwstream_open(&stream);
+
+  ret  = syslog_header(&stream.common, priority, &ts, this_cpu(),
+                       nxsched_gettid());
+
+  /* Generate the output */
+
+  ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
+  ret += syslog_trailer(&stream);
+
   /* Flush and destroy the syslog stream buffer */
 
   lib_syslograwstream_close(&stream);
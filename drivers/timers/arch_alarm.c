@@ -26,6 +26,9 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
+#include <nuttx/irq.h>
+#include <nuttx/list.h>
 #include <nuttx/timers/arch_alarm.h>
 
 /****************************************************************************
@@ -42,10 +45,24 @@
 
 static FAR struct oneshot_lowerhalf_s *g_oneshot_lower;
 
-#ifndef CONFIG_SCHED_TICKLESS
+#if !defined(CONFIG_SCHED_TICKLESS) && !defined(CONFIG_HRTIMER)
 static clock_t g_current_tick;
 #endif
 
+#ifdef CONFIG_HRTIMER
+/* The high resolution timers share the oneshot timer with the scheduler.
+ * The queue is sorted by the earliest expiration of the timers, and is
+ * protected by the critical section, as the watchdog list is.
+ */
+
+static struct list_node g_hrtimer_queue =
+  LIST_INITIAL_VALUE(g_hrtimer_queue);
+static uint64_t g_hrtimer_maxdelay;   /* Longest oneshot delay (ns) */
+static int      g_hrtimer_nested;     /* Non-zero while timers expire */
+static clock_t  g_alarm_tick;         /* Tick the scheduler waits for */
+static bool     g_alarm_armed;        /* True if g_alarm_tick is valid */
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -113,6 +130,148 @@ static void udelay_coarse(useconds_t microseconds)
     }
 }
 
+#ifdef CONFIG_HRTIMER
+static void oneshot_callback(FAR struct oneshot_lowerhalf_s *lower,
+                             FAR void *arg);
+
+/****************************************************************************
+ * Name: alarm_current
+ *
+ * Description:
+ *   Return the time of the oneshot timer in nanoseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t alarm_current(void)
+{
+  struct timespec ts;
+
+  ONESHOT_CURRENT(g_oneshot_lower, &ts);
+  return clock_time2nsec(&ts);
+}
+
+/****************************************************************************
+ * Name: alarm_reprogram
+ *
+ * Description:
+ *   Program the oneshot timer for the earliest of the next scheduler tick
+ *   and the latest expiration of each timer.  The timers whose earliest
+ *   expiration has passed by then expire with it, so timers with slack
+ *   share one interrupt.
+ *
+ * Assumptions:
+ *   Called in the critical section.
+ *
+ ****************************************************************************/
+
+static void alarm_reprogram(void)
+{
+  FAR struct hrtimer_s *timer;
+  struct timespec ts;
+  uint64_t deadline = UINT64_MAX;
+  uint64_t now;
+
+  if (g_hrtimer_nested > 0)
+    {
+      return;
+    }
+
+  if (g_alarm_armed)
+    {
+      deadline = (uint64_t)g_alarm_tick * NSEC_PER_TICK;
+    }
+
+  /* No timer later in the queue can expire before one that expires at
+   * the earliest after the deadline.
+   */
+
+  list_for_every_entry(&g_hrtimer_queue, timer, struct hrtimer_s, node)
+    {
+      if (timer->expired >= deadline)
+        {
+          break;
+        }
+
+      if (timer->expired + timer->slack < deadline)
+        {
+          deadline = timer->expired + timer->slack;
+        }
+    }
+
+  if (deadline == UINT64_MAX)
+    {
+      ONESHOT_CANCEL(g_oneshot_lower, &ts);
+      return;
+    }
+
+  now      = alarm_current();
+  deadline = deadline > now ? deadline - now : 0;
+  if (deadline > g_hrtimer_maxdelay)
+    {
+      deadline = g_hrtimer_maxdelay;
+    }
+
+  clock_nsec2time(&ts, deadline);
+  ONESHOT_START(g_oneshot_lower, oneshot_callback, NULL, &ts);
+}
+
+/****************************************************************************
+ * Name: oneshot_callback
+ *
+ * Description:
+ *   Run the scheduler tick if it is due, then expire the high resolution
+ *   timers.
+ *
+ ****************************************************************************/
+
+static void oneshot_callback(FAR struct oneshot_lowerhalf_s *lower,
+                             FAR void *arg)
+{
+  FAR struct hrtimer_s *timer;
+  irqstate_t flags;
+  hrtentry_t func;
+  clock_t ticks;
+  uint64_t now;
+
+  flags = enter_critical_section();
+  g_hrtimer_nested++;
+
+  ONESHOT_TICK_CURRENT(g_oneshot_lower, &ticks);
+  if (g_alarm_armed && clock_compare(g_alarm_tick, ticks))
+    {
+#ifdef CONFIG_SCHED_TICKLESS
+      g_alarm_armed = false;
+      nxsched_alarm_tick_expiration(ticks);
+#else
+      do
+        {
+          nxsched_process_timer();
+        }
+      while (clock_compare(++g_alarm_tick, ticks));
+#endif
+    }
+
+  now = alarm_current();
+  while (!list_is_empty(&g_hrtimer_queue))
+    {
+      timer = list_first_entry(&g_hrtimer_queue, struct hrtimer_s, node);
+      if (timer->expired > now)
+        {
+          break;
+        }
+
+      list_delete(&timer->node);
+
+      func        = timer->func;
+      timer->func = NULL;
+      func(timer);
+    }
+
+  g_hrtimer_nested--;
+  alarm_reprogram();
+  leave_critical_section(flags);
+}
+#else
 static void oneshot_callback(FAR struct oneshot_lowerhalf_s *lower,
                              FAR void *arg)
 {
@@ -138,6 +297,7 @@ static void oneshot_callback(FAR struct oneshot_lowerhalf_s *lower,
   ONESHOT_TICK_START(g_oneshot_lower, oneshot_callback, NULL, delta);
 #endif
 }
+#endif /* CONFIG_HRTIMER */
 
 /****************************************************************************
  * Public Functions
@@ -148,13 +308,31 @@ void up_alarm_set_lowerhalf(FAR struct oneshot_lowerhalf_s *lower)
 #ifdef CONFIG_SCHED_TICKLESS
   clock_t ticks;
 #endif
+#ifdef CONFIG_HRTIMER
+  struct timespec ts;
+  irqstate_t flags;
+#endif
 
   g_oneshot_lower = lower;
 
 #ifdef CONFIG_SCHED_TICKLESS
   ONESHOT_TICK_MAX_DELAY(g_oneshot_lower, &ticks);
   g_oneshot_maxticks = ticks < UINT32_MAX ? ticks : UINT32_MAX;
-#else
+#endif
+
+#ifdef CONFIG_HRTIMER
+  ONESHOT_MAX_DELAY(g_oneshot_lower, &ts);
+  g_hrtimer_maxdelay = clock_time2nsec(&ts);
+
+#  ifndef CONFIG_SCHED_TICKLESS
+  flags = enter_critical_section();
+  ONESHOT_TICK_CURRENT(g_oneshot_lower, &g_alarm_tick);
+  g_alarm_tick++;
+  g_alarm_armed = true;
+  alarm_reprogram();
+  leave_critical_section(flags);
+#  endif
+#elif !defined(CONFIG_SCHED_TICKLESS)
   ONESHOT_TICK_CURRENT(g_oneshot_lower, &g_current_tick);
   ONESHOT_TICK_START(g_oneshot_lower, oneshot_callback, NULL, 1);
 #endif
@@ -285,7 +463,18 @@ int weak_function up_alarm_tick_cancel(FAR clock_t *ticks)
 
   if (g_oneshot_lower != NULL)
     {
+#ifdef CONFIG_HRTIMER
+      /* Keep the oneshot timer running for the high resolution timers */
+
+      irqstate_t flags = enter_critical_section();
+
+      g_alarm_armed = false;
+      alarm_reprogram();
+      leave_critical_section(flags);
+      ret = OK;
+#else
       ret = ONESHOT_TICK_CANCEL(g_oneshot_lower, ticks);
+#endif
       ONESHOT_TICK_CURRENT(g_oneshot_lower, ticks);
     }
 
@@ -324,6 +513,15 @@ int weak_function up_alarm_tick_start(clock_t ticks)
 
   if (g_oneshot_lower != NULL)
     {
+#ifdef CONFIG_HRTIMER
+      irqstate_t flags = enter_critical_section();
+
+      g_alarm_tick  = ticks;
+      g_alarm_armed = true;
+      alarm_reprogram();
+      leave_critical_section(flags);
+      ret = OK;
+#else
       clock_t now;
       clock_t delta;
 
@@ -336,12 +534,140 @@ int weak_function up_alarm_tick_start(clock_t ticks)
 
       ret = ONESHOT_TICK_START(g_oneshot_lower, oneshot_callback,
                                NULL, delta);
+#endif
     }
 
   return ret;
 }
 #endif
 
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the current time of the high resolution timers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+uint64_t hrtimer_gettime(void)
+{
+  return g_oneshot_lower != NULL ? alarm_current() : 0;
+}
+
+/****************************************************************************
+ * Name: hrtimer_abstime
+ *
+ * Description:
+ *   Convert an absolute time of a clock into the time of the high
+ *   resolution timers.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_abstime(clockid_t clockid,
+                         FAR const struct timespec *abstime)
+{
+  struct timespec now;
+  uint64_t expired = hrtimer_gettime();
+  uint64_t target;
+  uint64_t base;
+
+  if (clock_gettime(clockid, &now) < 0)
+    {
+      return expired;
+    }
+
+  target = clock_time2nsec(abstime);
+  base   = clock_time2nsec(&now);
+  return target > base ? expired + (target - base) : expired;
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start a high resolution timer, or restart it with a new expiration.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t expired,
+                  uint32_t slack, hrtentry_t func, FAR void *arg)
+{
+  FAR struct hrtimer_s *curr;
+  irqstate_t flags;
+
+  if (timer == NULL || func == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (g_oneshot_lower == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  flags = enter_critical_section();
+
+  if (HRTIMER_ISACTIVE(timer))
+    {
+      list_delete(&timer->node);
+    }
+
+  timer->expired = expired;
+  timer->slack   = slack;
+  timer->func    = func;
+  timer->arg     = arg;
+
+  /* Insert the timer after the timers that expire at the same time */
+
+  list_for_every_entry(&g_hrtimer_queue, curr, struct hrtimer_s, node)
+    {
+      if (curr->expired > expired)
+        {
+          break;
+        }
+    }
+
+  list_add_before(&curr->node, &timer->node);
+  alarm_reprogram();
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a high resolution timer.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer)
+{
+  irqstate_t flags;
+
+  if (timer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  if (HRTIMER_ISACTIVE(timer))
+    {
+      list_delete(&timer->node);
+      timer->func = NULL;
+
+      /* A later deadline only costs a spurious interrupt, so the oneshot
+       * timer is left as it is.
+       */
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+#endif /* CONFIG_HRTIMER */
+
 /****************************************************************************
  * Name: up_perf_*
  *
@@ -36,7 +36,9 @@
 #include <stdbool.h>
 #include <sys/poll.h>
 
+#include <nuttx/mutex.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/queue.h>
 #include <nuttx/usb/usbdev.h>
 #include <nuttx/usb/cdc.h>
 #include <nuttx/usb/cdcncm.h>
@@ -73,7 +75,7 @@
 /* TX timeout = 1 minute */
 
 #define CDCNCM_TXTIMEOUT             (60*CLK_TCK)
-#define CDCNCM_DGRAM_COMBINE_PERIOD   1
+#define CDCNCM_DGRAM_COMBINE_PERIOD   CONFIG_CDCNCM_TXFLUSH_PERIOD
 
 #define NTB_DEFAULT_IN_SIZE           16384
 #define NTB_OUT_SIZE                  16384
@@ -288,6 +290,14 @@ begin_packed_struct struct usb_cdc_ncm_ntb_parameters_s
   uint16_t ntboutmaxdatagrams;
 } end_packed_struct;
 
+/* Container to support a list of requests */
+
+struct cdcncm_req_s
+{
+  FAR struct cdcncm_req_s *flink;    /* Implements a singly linked list */
+  FAR struct usbdev_req_s *req;      /* The contained request */
+};
+
 /* The cdcncm_driver_s encapsulates all state information for a single
  * hardware interface
  */
@@ -305,11 +315,14 @@ struct cdcncm_driver_s
   FAR struct usbdev_ep_s     *epbulkout;   /* Bulk OUT endpoint */
   uint8_t                     config;      /* Selected configuration number */
 
-  FAR struct usbdev_req_s    *rdreq;       /* Single read request */
-  bool                        rxpending;   /* Packet available in rdreq */
+  struct cdcncm_req_s         rdreqs[CONFIG_CDCNCM_NRDREQS];
+  sq_queue_t                  rxpending;   /* Read requests holding an NTB */
 
-  FAR struct usbdev_req_s    *wrreq;       /* Single write request */
-  sem_t                       wrreq_idle;  /* Is the wrreq available? */
+  struct cdcncm_req_s         wrreqs[CONFIG_CDCNCM_NWRREQS];
+  sq_queue_t                  txfree;      /* Available write requests */
+  FAR struct usbdev_req_s    *wrreq;       /* Write request being filled */
+  uint8_t                     nwrq;        /* Write requests in flight */
+  mutex_t                     txlock;      /* Protects the NTB being filled */
   bool                        txdone;      /* Did a write request complete? */
   enum ncm_notify_state_e     notify;      /* State of notify */
   FAR const struct ndp_parser_opts_s
@@ -334,6 +347,7 @@ struct cdcncm_driver_s
   struct netdev_lowerhalf_s   dev;         /* Interface understood by the
                                             * network */
   netpkt_queue_t              rx_queue;    /* RX packet queue */
+  netpkt_queue_t              tx_queue;    /* TX packets waiting for an NTB */
 };
 
 /* The cdcmbim_driver_s encapsulates all state information for a single
@@ -369,7 +383,8 @@ static int     cdcmbim_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
 /* Interrupt handling */
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *priv);
+static void cdcncm_receive(FAR struct cdcncm_driver_s *priv,
+                           FAR struct usbdev_req_s *req);
 static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv);
 
 static void cdcncm_interrupt_work(FAR void *arg);
@@ -892,36 +907,38 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
 }
 
 /****************************************************************************
- * Name: cdcncm_transmit_work
+ * Name: cdcncm_transmit_flush
  *
  * Description:
- *   Send NTB to the USB device for ethernet frame transmission
+ *   Complete the NTB being filled and send it to the host
  *
  * Input Parameters:
- *   arg - Reference to the driver state structure
+ *   self - Reference to the driver state structure
  *
  * Returned Value:
  *   None
  *
+ * Assumptions:
+ *   Called with txlock held.
+ *
  ****************************************************************************/
 
-static void cdcncm_transmit_work(FAR void *arg)
+static void cdcncm_transmit_flush(FAR struct cdcncm_driver_s *self)
 {
-  FAR struct cdcncm_driver_s *self = arg;
   FAR const struct ndp_parser_opts_s *opts = self->parseropts;
+  FAR struct usbdev_req_s *req = self->wrreq;
   FAR uint8_t *tmp;
   const int dgramidxlen = 2 * opts->dgramitemlen;
   const int ndpalign = g_ntbparameters.ndpinalignment;
+  irqstate_t flags;
   int ncblen;
   int ndpindex;
   int totallen;
+  int ret;
 
-  /* Wait until the USB device request for Ethernet frame transmissions
-   * becomes available.
-   */
-
-  while (nxsem_wait(&self->wrreq_idle) != OK)
+  if (req == NULL || self->dgramcount == 0)
     {
+      return;
     }
 
   ncblen   = opts->nthsize;
@@ -929,25 +946,141 @@ static void cdcncm_transmit_work(FAR void *arg)
 
   /* Fill NCB */
 
-  tmp      = self->wrreq->buf + 8; /* Offset to block length */
-  totallen = self->dgramaddr - self->wrreq->buf;
+  tmp      = req->buf + 8; /* Offset to block length */
+  totallen = self->dgramaddr - req->buf;
   cdcncm_put(&tmp, opts->blocklen, totallen);
 
   /* Fill NDP */
 
-  tmp = self->wrreq->buf + ndpindex + 4; /* Offset to ndp length */
+  tmp = req->buf + ndpindex + 4; /* Offset to ndp length */
   cdcncm_put(&tmp, 2, opts->ndpsize + (self->dgramcount + 1) * dgramidxlen);
 
   tmp += opts->reserved1 + opts->nextndpindex + opts->reserved2 +
          self->dgramcount * dgramidxlen;
   self->dgramcount = 0;
+  self->wrreq      = NULL;
 
   cdcncm_put(&tmp, opts->dgramitemlen, 0);
   cdcncm_put(&tmp, opts->dgramitemlen, 0);
 
-  self->wrreq->len = totallen;
+  req->len = totallen;
+
+  flags = enter_critical_section();
+  self->nwrq++;
+  ret = EP_SUBMIT(self->epbulkin, req);
+  if (ret != OK)
+    {
+      uerr("EP_SUBMIT failed. ret %d\n", ret);
+      self->nwrq--;
+      sq_addlast((FAR sq_entry_t *)req->priv, &self->txfree);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: cdcncm_transmit_work
+ *
+ * Description:
+ *   Send the NTB being filled once the aggregation period expired
+ *
+ * Input Parameters:
+ *   arg - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void cdcncm_transmit_work(FAR void *arg)
+{
+  FAR struct cdcncm_driver_s *self = arg;
+
+  nxmutex_lock(&self->txlock);
+  cdcncm_transmit_flush(self);
+  nxmutex_unlock(&self->txlock);
+}
+
+/****************************************************************************
+ * Name: cdcncm_transmit_packet
+ *
+ * Description:
+ *   Add one packet to the NTB being filled.  The NTB is sent at once when
+ *   it is full or when no other NTB is in flight, otherwise it collects
+ *   datagrams until the aggregation period expires or an earlier NTB
+ *   completes.
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *   pkt  - The packet to be sent, freed here
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with txlock held and a write request in self->wrreq.
+ *
+ ****************************************************************************/
+
+static void cdcncm_transmit_packet(FAR struct cdcncm_driver_s *self,
+                                   FAR netpkt_t *pkt)
+{
+  cdcncm_transmit_format(self, pkt);
+  netpkt_free(&self->dev, pkt, NETPKT_TX);
+
+  if ((self->wrreq->buf + NTB_OUT_SIZE - self->dgramaddr <
+       self->dev.netdev.d_pktsize) || self->dgramcount >= TX_MAX_NUM_DPE ||
+      self->nwrq == 0)
+    {
+      work_cancel(ETHWORK, &self->delaywork);
+      cdcncm_transmit_flush(self);
+    }
+  else if (self->dgramcount == 1)
+    {
+      /* Start the aggregation period with the first datagram only, so
+       * a steady packet stream cannot postpone the NTB forever.
+       */
+
+      work_queue(ETHWORK, &self->delaywork, cdcncm_transmit_work, self,
+                 MSEC2TICK(CDCNCM_DGRAM_COMBINE_PERIOD));
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_getwrreq
+ *
+ * Description:
+ *   Make sure that there is a write request to fill with datagrams
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   True if self->wrreq is available, false if all requests are in flight.
+ *
+ * Assumptions:
+ *   Called with txlock held.
+ *
+ ****************************************************************************/
+
+static bool cdcncm_getwrreq(FAR struct cdcncm_driver_s *self)
+{
+  FAR struct cdcncm_req_s *container;
+  irqstate_t flags;
+
+  if (self->wrreq == NULL)
+    {
+      flags     = enter_critical_section();
+      container = (FAR struct cdcncm_req_s *)sq_remfirst(&self->txfree);
+      leave_critical_section(flags);
+
+      if (container != NULL)
+        {
+          self->wrreq = container->req;
+        }
+    }
 
-  EP_SUBMIT(self->epbulkin, self->wrreq);
+  return self->wrreq != NULL;
 }
 
 /****************************************************************************
@@ -995,20 +1128,22 @@ static int cdcncm_packet_handler(FAR struct cdcncm_driver_s *self,
  * Name: cdcncm_receive
  *
  * Description:
- *   An interrupt was received indicating the availability of a new RX packet
+ *   Hand the datagrams of a received NTB to the network
  *
  * Input Parameters:
  *   self - Reference to the driver state structure
+ *   req  - The read request holding the NTB
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
+static void cdcncm_receive(FAR struct cdcncm_driver_s *self,
+                           FAR struct usbdev_req_s *req)
 {
   FAR const struct ndp_parser_opts_s *opts = self->parseropts;
-  FAR uint8_t *tmp = self->rdreq->buf;
+  FAR uint8_t *tmp = req->buf;
   uint32_t ntbmax = g_ntbparameters.ntboutmaxsize;
   uint32_t blocklen;
   uint32_t ndplen;
@@ -1019,7 +1154,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
   if (GETUINT32(tmp) != opts->nthsign)
     {
-      uerr("Wrong NTH SIGN, skblen %zu\n", self->rdreq->xfrd);
+      uerr("Wrong NTH SIGN, skblen %zu\n", req->xfrd);
       return;
     }
 
@@ -1059,7 +1194,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
           return;
         }
 
-      tmp = self->rdreq->buf + ndpindex;
+      tmp = req->buf + ndpindex;
 
       if (GETUINT32(tmp) != self->ndpsign)
         {
@@ -1103,7 +1238,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
           /* Copy the data from the hardware to self->rx_queue. */
 
-          cdcncm_packet_handler(self, self->rdreq->buf + index, dglen);
+          cdcncm_packet_handler(self, req->buf + index, dglen);
 
           ndplen -= 2 * (opts->dgramitemlen);
         }
@@ -1128,6 +1263,28 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
 static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv)
 {
+  FAR netpkt_t *pkt;
+
+  /* Move the packets held back for lack of a free write request into the
+   * requests that just completed.
+   */
+
+  nxmutex_lock(&priv->txlock);
+  while (!IOB_QEMPTY(&priv->tx_queue) && cdcncm_getwrreq(priv))
+    {
+      pkt = netpkt_remove_queue(&priv->tx_queue);
+      cdcncm_transmit_packet(priv, pkt);
+    }
+
+  /* Don't keep a partial NTB waiting once the bulk IN pipe is idle */
+
+  if (priv->nwrq == 0)
+    {
+      cdcncm_transmit_flush(priv);
+    }
+
+  nxmutex_unlock(&priv->txlock);
+
   /* In any event, poll the network for new TX data */
 
   netdev_lower_txdone(&priv->dev);
@@ -1153,18 +1310,29 @@ static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv)
 static void cdcncm_interrupt_work(FAR void *arg)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+  FAR struct cdcncm_req_s *container;
   irqstate_t flags;
 
-  /* Check if we received an incoming packet, if so, call cdcncm_receive() */
+  /* Parse every NTB received meanwhile, if any, with cdcncm_receive() and
+   * give each read request back to the bulk OUT endpoint.
+   */
 
-  if (self->rxpending)
+  for (; ; )
     {
-      cdcncm_receive(self);
+      flags     = enter_critical_section();
+      container = (FAR struct cdcncm_req_s *)sq_remfirst(&self->rxpending);
+      leave_critical_section(flags);
+
+      if (container == NULL)
+        {
+          break;
+        }
+
+      cdcncm_receive(self, container->req);
       netdev_lower_rxready(&self->dev);
 
       flags = enter_critical_section();
-      self->rxpending = false;
-      EP_SUBMIT(self->epbulkout, self->rdreq);
+      EP_SUBMIT(self->epbulkout, container->req);
       leave_critical_section(flags);
     }
 
@@ -1280,31 +1448,33 @@ static int cdcncm_ifdown(FAR struct netdev_lowerhalf_s *dev)
  *   pkt - The packet to be sent
  *
  * Returned Value:
- *   OK on success
+ *   OK on success; a negated errno value if the packet was not taken.
  *
  ****************************************************************************/
 
 static int cdcncm_send(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt)
 {
   FAR struct cdcncm_driver_s *self;
+  int ret = OK;
 
   self = container_of(dev, struct cdcncm_driver_s, dev);
-  cdcncm_transmit_format(self, pkt);
-  netpkt_free(dev, pkt, NETPKT_TX);
 
-  if ((self->wrreq->buf + NTB_OUT_SIZE - self->dgramaddr <
-       self->dev.netdev.d_pktsize) || self->dgramcount >= TX_MAX_NUM_DPE)
+  nxmutex_lock(&self->txlock);
+  if (IOB_QEMPTY(&self->tx_queue) && cdcncm_getwrreq(self))
     {
-      work_cancel(ETHWORK, &self->delaywork);
-      cdcncm_transmit_work(self);
+      cdcncm_transmit_packet(self, pkt);
     }
   else
     {
-      work_queue(ETHWORK, &self->delaywork, cdcncm_transmit_work, self,
-                 MSEC2TICK(CDCNCM_DGRAM_COMBINE_PERIOD));
+      /* All write requests are in flight.  Hold the packet, and with it
+       * its TX quota, until cdcncm_txdone() finds a free request.
+       */
+
+      ret = netpkt_tryadd_queue(pkt, &self->tx_queue);
     }
 
-  return OK;
+  nxmutex_unlock(&self->txlock);
+  return ret;
 }
 
 /****************************************************************************
@@ -1480,8 +1650,7 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
     {
       case 0:  /* Normal completion */
         {
-          DEBUGASSERT(!self->rxpending);
-          self->rxpending = true;
+          sq_addlast((FAR sq_entry_t *)req->priv, &self->rxpending);
           work_queue(ETHWORK, &self->irqwork,
                      cdcncm_interrupt_work, self, 0);
         }
@@ -1493,7 +1662,7 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
       default: /* Some other error occurred */
         {
           uerr("req->result: %hd\n", req->result);
-          EP_SUBMIT(self->epbulkout, self->rdreq);
+          EP_SUBMIT(self->epbulkout, req);
         }
         break;
     }
@@ -1512,21 +1681,17 @@ static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
                               FAR struct usbdev_req_s *req)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
-  int rc;
+  irqstate_t flags;
 
   uinfo("buf: %p, flags 0x%hhx, len %zu, xfrd %zu, result %hd\n",
         req->buf, req->flags, req->len, req->xfrd, req->result);
 
-  /* The single USB device write request is available for upcoming
-   * transmissions again.
-   */
-
-  rc = nxsem_post(&self->wrreq_idle);
+  /* The write request is available for upcoming transmissions again */
 
-  if (rc != OK)
-    {
-      nerr("nxsem_post failed! rc: %d\n", rc);
-    }
+  flags = enter_critical_section();
+  sq_addlast((FAR sq_entry_t *)req->priv, &self->txfree);
+  self->nwrq--;
+  leave_critical_section(flags);
 
   /* Inform the network layer that an Ethernet frame was transmitted. */
 
@@ -1564,6 +1729,10 @@ static void cdcncm_resetconfig(FAR struct cdcncm_driver_s *self)
       EP_DISABLE(self->epbulkin);
       EP_DISABLE(self->epbulkout);
       self->notify = NCM_NOTIFY_SPEED;
+
+      /* NTBs received but not parsed yet are stale now */
+
+      sq_init(&self->rxpending);
     }
 
   self->parseropts = &g_ndp16_opts;
@@ -1583,6 +1752,7 @@ static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
 {
   struct usb_ss_epdesc_s epdesc;
   int ret;
+  int i;
 
   if (config == self->config)
     {
@@ -1635,14 +1805,16 @@ static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
 
   /* Queue read requests in the bulk OUT endpoint */
 
-  DEBUGASSERT(!self->rxpending);
+  DEBUGASSERT(sq_empty(&self->rxpending));
 
-  self->rdreq->callback = cdcncm_rdcomplete,
-  ret = EP_SUBMIT(self->epbulkout, self->rdreq);
-  if (ret != OK)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      uerr("EP_SUBMIT failed. ret %d\n", ret);
-      goto error;
+      ret = EP_SUBMIT(self->epbulkout, self->rdreqs[i].req);
+      if (ret != OK)
+        {
+          uerr("EP_SUBMIT failed. ret %d\n", ret);
+          goto error;
+        }
     }
 
   /* We are successfully configured */
@@ -2471,7 +2643,9 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
                        FAR struct usbdev_s *dev)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  FAR struct cdcncm_req_s *container;
   int ret = OK;
+  int i;
 
   uinfo("\n");
 
@@ -2529,39 +2703,45 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
 
   /* Pre-allocate read requests. The buffer size is NTB_DEFAULT_IN_SIZE. */
 
-  self->rdreq = usbdev_allocreq(self->epbulkout, NTB_DEFAULT_IN_SIZE);
-  if (self->rdreq == NULL)
+  sq_init(&self->rxpending);
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
-    }
-
-  self->rdreq->callback = cdcncm_rdcomplete;
-
-  /* Pre-allocate a single write request. Buffer size is NTB_OUT_SIZE */
+      container      = &self->rdreqs[i];
+      container->req = usbdev_allocreq(self->epbulkout,
+                                       NTB_DEFAULT_IN_SIZE);
+      if (container->req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
 
-  self->wrreq = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
-  if (self->wrreq == NULL)
-    {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
+      container->req->priv     = container;
+      container->req->callback = cdcncm_rdcomplete;
     }
 
-  self->wrreq->callback = cdcncm_wrcomplete;
-
-  /* The single write request just allocated is available now. */
-
-  ret = nxsem_init(&self->wrreq_idle, 0, 1);
+  /* Pre-allocate write requests. The buffer size is NTB_OUT_SIZE. */
 
-  if (ret != OK)
+  sq_init(&self->txfree);
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      uerr("nxsem_init failed. ret: %d\n", ret);
-      goto error;
+      container      = &self->wrreqs[i];
+      container->req = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
+      if (container->req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
+
+      container->req->priv     = container;
+      container->req->callback = cdcncm_wrcomplete;
+      sq_addlast((FAR sq_entry_t *)container, &self->txfree);
     }
 
-  self->txdone    = false;
+  self->wrreq  = NULL;
+  self->nwrq   = 0;
+  self->txdone = false;
 
 #ifndef CONFIG_CDCNCM_COMPOSITE
 #ifdef CONFIG_USBDEV_SELFPOWERED
@@ -2586,6 +2766,7 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
                           FAR struct usbdev_s *dev)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  int i;
 
 #ifdef CONFIG_DEBUG_FEATURES
   if (!driver || !dev)
@@ -2625,10 +2806,13 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * been returned to the free list at this time -- we don't check)
    */
 
-  if (self->rdreq != NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      usbdev_freereq(self->epbulkout, self->rdreq);
-      self->rdreq = NULL;
+      if (self->rdreqs[i].req != NULL)
+        {
+          usbdev_freereq(self->epbulkout, self->rdreqs[i].req);
+          self->rdreqs[i].req = NULL;
+        }
     }
 
   /* Free the bulk OUT endpoint */
@@ -2643,12 +2827,19 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * of them)
    */
 
-  if (self->wrreq != NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      usbdev_freereq(self->epbulkin, self->wrreq);
-      self->wrreq = NULL;
+      if (self->wrreqs[i].req != NULL)
+        {
+          usbdev_freereq(self->epbulkin, self->wrreqs[i].req);
+          self->wrreqs[i].req = NULL;
+        }
     }
 
+  sq_init(&self->txfree);
+  self->wrreq      = NULL;
+  self->dgramcount = 0;
+
   /* Free the bulk IN endpoint */
 
   if (self->epbulkin)
@@ -2657,9 +2848,10 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
       self->epbulkin = NULL;
     }
 
-  /* Clear out all data in the rx_queue */
+  /* Clear out all data in the rx_queue and the tx_queue */
 
   netpkt_free_queue(&self->rx_queue);
+  netpkt_free_queue(&self->tx_queue);
 }
 
 static int cdcncm_setup(FAR struct usbdevclass_driver_s *driver,
@@ -2883,6 +3075,7 @@ static int cdcncm_classobject(int minor,
     }
 
   self->isncm = true;
+  nxmutex_init(&self->txlock);
 
   /* Network device initialization */
 
@@ -2960,6 +3153,7 @@ static int cdcmbim_classobject(int minor,
 
   ncm = &self->ncmdriver;
   ncm->isncm = false;
+  nxmutex_init(&ncm->txlock);
 
   /* Network device initialization */
 
@@ -3059,6 +3253,7 @@ static void cdcncm_uninitialize(FAR struct usbdevclass_driver_s *classdev)
 
   /* And free the driver structure */
 
+  nxmutex_destroy(&self->txlock);
   kmm_free(self);
 }
 
@@ -3104,6 +3299,7 @@ static void cdcmbim_uninitialize(FAR struct usbdevclass_driver_s *classdev)
 
   /* And free the driver structure */
 
+  nxmutex_destroy(&self->ncmdriver.txlock);
   nxmutex_destroy(&self->lock);
   nxsem_destroy(&self->read_sem);
   kmm_free(self);
@@ -81,6 +81,8 @@ struct usbdev_fs_ep_s
   FAR usbdev_fs_waiter_sem_t *sems;       /* List of blocking request */
   struct sq_queue_s           reqq;       /* Available request containers */
   FAR struct usbdev_fs_req_s *reqbuffer;  /* Request buffer */
+  uint16_t                    reqnum;     /* Number of requests */
+  uint8_t                     npackets;   /* Max packets per request */
   FAR struct pollfd          *fds[CONFIG_USBDEV_FS_NPOLLWAITERS];
 
   /* These member is valid for endpoint 0 */
@@ -136,6 +138,8 @@ static ssize_t usbdev_fs_read(FAR struct file *filep, FAR char *buffer,
                               size_t len);
 static ssize_t usbdev_fs_write(FAR struct file *filep,
                                FAR const char *buffer, size_t len);
+static int usbdev_fs_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg);
 static int usbdev_fs_poll(FAR struct file *filep, FAR struct pollfd *fds,
                           bool setup);
 
@@ -164,7 +168,7 @@ static const struct file_operations g_usbdev_fs_fops =
   usbdev_fs_read,  /* read */
   usbdev_fs_write, /* write */
   NULL,            /* seek */
-  NULL,            /* ioctl */
+  usbdev_fs_ioctl, /* ioctl */
   NULL,            /* mmap */
   NULL,            /* truncate */
   usbdev_fs_poll   /* poll */
@@ -233,9 +237,10 @@ static int usbdev_fs_submit_wrreq(FAR struct usbdev_ep_s *ep,
 static int usbdev_fs_submit_rdreq(FAR struct usbdev_ep_s *ep,
                                   FAR struct usbdev_fs_req_s *container)
 {
+  FAR struct usbdev_fs_ep_s *fs_ep = (FAR struct usbdev_fs_ep_s *)ep->fs;
   FAR struct usbdev_req_s *req = container->req;
 
-  req->len = ep->maxpacket;
+  req->len = ep->maxpacket * fs_ep->npackets;
   return EP_SUBMIT(ep, req);
 }
 
@@ -700,12 +705,13 @@ static ssize_t usbdev_fs_read(FAR struct file *filep, FAR char *buffer,
           PANIC();
         }
 
-      /* The container buffer length is less than the maximum length.
-       * It is an independent packet of requests and needs to be
-       * returned directly.
+      /* The container buffer length is less than the maximum length,
+       * or the transfer ended with a short packet.  It is an independent
+       * packet of requests and needs to be returned directly.
        */
 
-      if (reqlen < fs_ep->ep->maxpacket)
+      if (reqlen < fs_ep->ep->maxpacket ||
+          container->req->xfrd < container->req->len)
         {
           break;
         }
@@ -791,9 +797,9 @@ static ssize_t usbdev_fs_write(FAR struct file *filep,
 
       /* Fill the request with data */
 
-      if (len > fs_ep->ep->maxpacket)
+      if (len > fs_ep->ep->maxpacket * fs_ep->npackets)
         {
-          cur_len = fs_ep->ep->maxpacket;
+          cur_len = fs_ep->ep->maxpacket * fs_ep->npackets;
         }
       else
         {
@@ -830,6 +836,107 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: usbdev_fs_ioctl
+ *
+ * Description:
+ *   Return the number of bytes that can be read or written without
+ *   blocking, so that event driven users can size their transfers.
+ *
+ ****************************************************************************/
+
+static int usbdev_fs_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct usbdev_fs_ep_s *fs_ep = inode->i_private;
+  FAR struct usbdev_fs_req_s *container;
+  FAR int *value = (FAR int *)((uintptr_t)arg);
+  FAR sq_entry_t *entry;
+  irqstate_t flags;
+  int ret;
+
+  if (value == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&fs_ep->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (fs_ep->unlinked)
+    {
+      ret = -ENOTCONN;
+      goto errout;
+    }
+
+  if (fs_ep == &fs_ep->dev->eps[0])
+    {
+      ret = -ENOTTY;
+      goto errout;
+    }
+
+  switch (cmd)
+    {
+      /* Bytes received in the requests waiting to be read */
+
+      case FIONREAD:
+        if (USB_ISEPIN(fs_ep->ep->eplog))
+          {
+            ret = -ENOTTY;
+            break;
+          }
+
+        *value = 0;
+        flags  = enter_critical_section();
+        for (entry = sq_peek(&fs_ep->reqq); entry; entry = sq_next(entry))
+          {
+            container = container_of(entry, struct usbdev_fs_req_s, node);
+            *value   += container->req->xfrd - container->offset;
+          }
+
+        leave_critical_section(flags);
+        break;
+
+      /* Bytes that the idle requests can take */
+
+      case FIONSPACE:
+        if (!USB_ISEPIN(fs_ep->ep->eplog))
+          {
+            ret = -ENOTTY;
+            break;
+          }
+
+        *value = sq_count(&fs_ep->reqq) *
+                 fs_ep->ep->maxpacket * fs_ep->npackets;
+        break;
+
+      /* Bytes in the requests still in flight */
+
+      case FIONWRITE:
+        if (!USB_ISEPIN(fs_ep->ep->eplog))
+          {
+            ret = -ENOTTY;
+            break;
+          }
+
+        *value = (fs_ep->reqnum - sq_count(&fs_ep->reqq)) *
+                 fs_ep->ep->maxpacket * fs_ep->npackets;
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+errout:
+  nxmutex_unlock(&fs_ep->lock);
+  return ret;
+}
+
 /****************************************************************************
  * Name: usbdev_fs_poll
  *
@@ -1002,6 +1109,18 @@ static int usbdev_fs_ep_bind(FAR struct usbdev_s *dev, uint8_t epno,
 
   nxmutex_init(&fs_ep->lock);
 
+  /* Bulk requests may carry several packets */
+
+  fs_ep->reqnum   = epinfo->reqnum;
+  fs_ep->npackets = 1;
+  if (epno != 0 && (epinfo->desc.attr & USB_EP_ATTR_XFERTYPE_MASK) ==
+                   USB_EP_ATTR_XFER_BULK)
+    {
+      fs_ep->npackets = USB_ISEPIN(epinfo->desc.addr) ?
+                        CONFIG_USBDEV_FS_WRREQ_NPACKETS :
+                        CONFIG_USBDEV_FS_RDREQ_NPACKETS;
+    }
+
   /* Initialize request queue */
 
   sq_init(&fs_ep->reqq);
@@ -1086,7 +1205,8 @@ static int usbdev_fs_ep_bind(FAR struct usbdev_s *dev, uint8_t epno,
       FAR struct usbdev_fs_req_s *container;
 
       container = &fs_ep->reqbuffer[i];
-      container->req = usbdev_allocreq(fs_ep->ep, reqsize);
+      container->req = usbdev_allocreq(fs_ep->ep,
+                                       reqsize * fs_ep->npackets);
       if (container->req == NULL)
         {
           usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_RDALLOCREQ), -ENOMEM);
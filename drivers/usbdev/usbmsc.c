@@ -1298,6 +1298,10 @@ int usbmsc_configure(unsigned int nluns, FAR void **handle)
   nxsem_init(&priv->thsynch, 0, 0);
   nxmutex_init(&priv->thlock);
   nxsem_init(&priv->thwaitsem, 0, 0);
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+  nxsem_init(&priv->iostart, 0, 0);
+  nxsem_init(&priv->iodone, 0, 0);
+#endif
 
   sq_init(&priv->wrreqlist);
   priv->nluns = nluns;
@@ -1391,6 +1395,7 @@ int usbmsc_bindlun(FAR void *handle, FAR const char *drvrpath,
   FAR struct usbmsc_lun_s *lun;
   FAR struct inode *inode;
   struct geometry geo;
+  size_t iosize;
   int ret;
 
 #ifdef CONFIG_DEBUG_FEATURES
@@ -1466,47 +1471,56 @@ int usbmsc_bindlun(FAR void *handle, FAR const char *drvrpath,
 
   memset(lun, 0, sizeof(struct usbmsc_lun_s));
 
-  /* Allocate an I/O buffer big enough to hold one hardware sector.  SCSI
-   * commands are processed one at a time so all LUNs may share a single I/O
-   * buffer.  The I/O buffer will be allocated so that is it as large as the
-   * largest block device sector size
+  /* Allocate an I/O buffer big enough to hold USBMSC_IONSECTORS hardware
+   * sectors.  SCSI commands are processed one at a time so all LUNs may
+   * share a single I/O buffer.  The I/O buffer will be allocated so that
+   * is it as large as the largest block device sector size
    */
 
-  if (!priv->iobuffer)
+  iosize = geo.geo_sectorsize * USBMSC_IONSECTORS;
+
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+  /* The I/O thread needs a second buffer of the same size */
+
+  if (!priv->iobuffer2 || priv->iosize < iosize)
     {
-#ifdef CONFIG_USBMSC_WRMULTIPLE
-      priv->iobuffer = kmm_malloc(geo.geo_sectorsize *
-                                  CONFIG_USBMSC_NWRREQS);
-#else
-      priv->iobuffer = kmm_malloc(geo.geo_sectorsize);
+      FAR void *tmp;
+
+      tmp = kmm_realloc(priv->iobuffer2, iosize);
+      if (!tmp)
+        {
+          usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_ALLOCIOBUFFER), iosize);
+          return -ENOMEM;
+        }
+
+      priv->iobuffer2 = (FAR uint8_t *)tmp;
+    }
 #endif
+
+  if (!priv->iobuffer)
+    {
+      priv->iobuffer = kmm_malloc(iosize);
       if (!priv->iobuffer)
         {
-          usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_ALLOCIOBUFFER),
-                   geo.geo_sectorsize);
+          usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_ALLOCIOBUFFER), iosize);
           return -ENOMEM;
         }
 
-#ifdef CONFIG_USBMSC_WRMULTIPLE
-      priv->iosize = geo.geo_sectorsize * CONFIG_USBMSC_NWRREQS;
-#else
-      priv->iosize = geo.geo_sectorsize;
-#endif
+      priv->iosize = iosize;
     }
-  else if (priv->iosize < geo.geo_sectorsize)
+  else if (priv->iosize < iosize)
     {
       FAR void *tmp;
 
-      tmp = kmm_realloc(priv->iobuffer, geo.geo_sectorsize);
+      tmp = kmm_realloc(priv->iobuffer, iosize);
       if (!tmp)
         {
-          usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_REALLOCIOBUFFER),
-                   geo.geo_sectorsize);
+          usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_REALLOCIOBUFFER), iosize);
           return -ENOMEM;
         }
 
       priv->iobuffer = (FAR uint8_t *)tmp;
-      priv->iosize   = geo.geo_sectorsize;
+      priv->iosize   = iosize;
     }
 
   lun->inode       = inode;
@@ -1856,6 +1870,16 @@ void usbmsc_uninitialize(FAR void *handle)
       kmm_free(priv->iobuffer);
     }
 
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+  if (priv->iobuffer2)
+    {
+      kmm_free(priv->iobuffer2);
+    }
+
+  nxsem_destroy(&priv->iostart);
+  nxsem_destroy(&priv->iodone);
+#endif
+
   /* Uninitialize and release the driver structure */
 
   nxsem_destroy(&priv->thsynch);
@@ -85,6 +85,14 @@
 #  define CONFIG_USBMSC_NRDREQS 4
 #endif
 
+/* Number of sectors that the I/O buffer holds */
+
+#if defined(CONFIG_USBMSC_WRMULTIPLE) || defined(CONFIG_USBMSC_RDMULTIPLE)
+#  define USBMSC_IONSECTORS CONFIG_USBMSC_NWRREQS
+#else
+#  define USBMSC_IONSECTORS 1
+#endif
+
 /* Logical endpoint numbers / max packet sizes */
 
 #ifndef CONFIG_USBMSC_COMPOSITE
@@ -410,6 +418,7 @@ struct usbmsc_dev_s
   uint16_t          nsectbytes;       /* Bytes buffered in iobuffer[] */
   uint16_t          nreqbytes;        /* Bytes buffered in head write requests */
   uint16_t          iosize;           /* Size of iobuffer[] */
+  uint16_t          niobytes;         /* Bytes read into iobuffer[] */
   uint32_t          cbwlen;           /* Length of data from CBW */
   uint32_t          cbwtag;           /* Tag from the CBW */
   union
@@ -421,6 +430,24 @@ struct usbmsc_dev_s
   uint32_t          residue;          /* Untransferred amount reported in the CSW */
   uint8_t          *iobuffer;         /* Buffer for data transfers */
 
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+  /* Block device I/O thread.  It reads into or writes from iobuffer2[]
+   * while the SCSI thread moves iobuffer[] from or to the USB requests.
+   */
+
+  pid_t             iopid;            /* The I/O thread task ID */
+  sem_t             iostart;          /* Posted to start an I/O request */
+  sem_t             iodone;           /* Posted when the I/O request is done */
+  bool              iobusy;           /* An I/O request is in progress */
+  bool              iowrite;          /* The I/O request is a write */
+  bool              ioexit;           /* The I/O thread is asked to exit */
+  uint16_t          ionsectors;       /* Sectors of the I/O request */
+  uint32_t          iosector;         /* First sector of the I/O request */
+  ssize_t           ioresult;         /* Result of the I/O request */
+  FAR struct usbmsc_lun_s *iolun;     /* LUN of the I/O request */
+  uint8_t          *iobuffer2;        /* Second buffer for data transfers */
+#endif
+
   /* Write request list */
 
   struct sq_queue_s wrreqlist;        /* List of empty write request containers */
@@ -47,6 +47,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <unistd.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
@@ -166,10 +167,23 @@ static inline int usbmsc_setupcmd(FAR struct usbmsc_dev_s *priv,
 static int usbmsc_idlestate(FAR struct usbmsc_dev_s *priv);
 static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv);
 static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv);
+static ssize_t usbmsc_writesectors(FAR struct usbmsc_dev_s *priv,
+                                   uint16_t nsectors);
 static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv);
 static int usbmsc_cmdfinishstate(FAR struct usbmsc_dev_s *priv);
 static int usbmsc_cmdstatusstate(FAR struct usbmsc_dev_s *priv);
 
+/* Block Device I/O Thread **************************************************/
+
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+static ssize_t usbmsc_iotransfer(FAR struct usbmsc_dev_s *priv);
+static int usbmsc_iothread(int argc, FAR char *argv[]);
+static void usbmsc_iostart(FAR struct usbmsc_dev_s *priv, bool write,
+                           uint16_t nsectors);
+static ssize_t usbmsc_iowait(FAR struct usbmsc_dev_s *priv);
+static void usbmsc_ioswap(FAR struct usbmsc_dev_s *priv);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -1725,6 +1739,136 @@ static int inline usbmsc_setupcmd(FAR struct usbmsc_dev_s *priv,
   return ret;
 }
 
+/****************************************************************************
+ * Name: usbmsc_iotransfer
+ *
+ * Description:
+ *   Perform the block device transfer described by the I/O request fields
+ *   on iobuffer2[].
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+static ssize_t usbmsc_iotransfer(FAR struct usbmsc_dev_s *priv)
+{
+  if (priv->iowrite)
+    {
+      return USBMSC_DRVR_WRITE(priv->iolun, priv->iobuffer2,
+                               priv->iosector, priv->ionsectors);
+    }
+
+  return USBMSC_DRVR_READ(priv->iolun, priv->iobuffer2,
+                          priv->iosector, priv->ionsectors);
+}
+
+/****************************************************************************
+ * Name: usbmsc_iothread
+ *
+ * Description:
+ *   This is the main function of the block device I/O thread.  It performs
+ *   the transfers started by the SCSI worker thread, so that the block
+ *   device works on one buffer while the other one is moved from or to the
+ *   USB requests.
+ *
+ ****************************************************************************/
+
+static int usbmsc_iothread(int argc, FAR char *argv[])
+{
+  FAR struct usbmsc_dev_s *priv =
+    (FAR struct usbmsc_dev_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&priv->iostart);
+      if (priv->ioexit)
+        {
+          break;
+        }
+
+      priv->ioresult = usbmsc_iotransfer(priv);
+      nxsem_post(&priv->iodone);
+    }
+
+  nxsem_post(&priv->iodone);
+  return EXIT_SUCCESS;
+}
+
+/****************************************************************************
+ * Name: usbmsc_iostart
+ *
+ * Description:
+ *   Start reading nsectors from priv->sector into iobuffer2[] or writing
+ *   them from iobuffer2[].  The transfer is done inline if the I/O thread
+ *   could not be started.
+ *
+ ****************************************************************************/
+
+static void usbmsc_iostart(FAR struct usbmsc_dev_s *priv, bool write,
+                           uint16_t nsectors)
+{
+  DEBUGASSERT(!priv->iobusy);
+
+  priv->iolun      = priv->lun;
+  priv->iowrite    = write;
+  priv->iosector   = priv->sector;
+  priv->ionsectors = nsectors;
+  priv->iobusy     = true;
+
+  if (priv->iopid > 0)
+    {
+      nxsem_post(&priv->iostart);
+    }
+  else
+    {
+      priv->ioresult = usbmsc_iotransfer(priv);
+    }
+}
+
+/****************************************************************************
+ * Name: usbmsc_iowait
+ *
+ * Description:
+ *   Wait for the transfer started by usbmsc_iostart(), if any.
+ *
+ * Returned Value:
+ *   The result of the block driver read or write method, OK if no transfer
+ *   was in progress.
+ *
+ ****************************************************************************/
+
+static ssize_t usbmsc_iowait(FAR struct usbmsc_dev_s *priv)
+{
+  if (!priv->iobusy)
+    {
+      return OK;
+    }
+
+  if (priv->iopid > 0)
+    {
+      nxsem_wait_uninterruptible(&priv->iodone);
+    }
+
+  priv->iobusy = false;
+  return priv->ioresult;
+}
+
+/****************************************************************************
+ * Name: usbmsc_ioswap
+ *
+ * Description:
+ *   Exchange iobuffer[] and iobuffer2[].
+ *
+ ****************************************************************************/
+
+static void usbmsc_ioswap(FAR struct usbmsc_dev_s *priv)
+{
+  FAR uint8_t *tmp = priv->iobuffer;
+
+  priv->iobuffer  = priv->iobuffer2;
+  priv->iobuffer2 = tmp;
+}
+#endif
+
 /****************************************************************************
  * Name: usbmsc_idlestate
  *
@@ -1929,6 +2073,12 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
   priv->nsectbytes   = 0;
   priv->nreqbytes    = 0;
 
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+  /* Drop the read ahead of an aborted read command */
+
+  usbmsc_iowait(priv);
+#endif
+
   /* Get exclusive access to the block driver */
 
   ret = nxmutex_lock(&priv->thlock);
@@ -2243,6 +2393,12 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   ssize_t nread;
   FAR uint8_t *src;
   FAR uint8_t *dest;
+#ifdef CONFIG_USBMSC_RDMULTIPLE
+  uint16_t maxsectors = priv->iosize / lun->sectorsize;
+#else
+  uint16_t maxsectors = 1;
+#endif
+  uint16_t nsectors;
   int nbytes;
   int ret;
 
@@ -2259,9 +2415,25 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 
       if (priv->nsectbytes <= 0)
         {
-          /* Yes.. read the next sector */
+          /* Yes.. read the next sectors */
+
+          nsectors = MIN(priv->u.xfrlen, maxsectors);
+
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+          /* Take the sectors read ahead, if any */
 
-          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
+          if (!priv->iobusy)
+            {
+              usbmsc_iostart(priv, false, nsectors);
+            }
+
+          nread    = usbmsc_iowait(priv);
+          nsectors = priv->ionsectors;
+          usbmsc_ioswap(priv);
+#else
+          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector,
+                                   nsectors);
+#endif
           if (nread < 0)
             {
               usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL),
@@ -2271,9 +2443,19 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
               break;
             }
 
-          priv->nsectbytes = lun->sectorsize;
-          priv->u.xfrlen--;
-          priv->sector++;
+          priv->niobytes   = lun->sectorsize * nsectors;
+          priv->nsectbytes = priv->niobytes;
+          priv->u.xfrlen  -= nsectors;
+          priv->sector    += nsectors;
+
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+          /* Read the following sectors while these are sent */
+
+          if (priv->u.xfrlen > 0)
+            {
+              usbmsc_iostart(priv, false, MIN(priv->u.xfrlen, maxsectors));
+            }
+#endif
         }
 
       /* Check if there is a request in the wrreqlist that we will be able to
@@ -2301,7 +2483,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * OR (2) all of the data available in the sector buffer.
        */
 
-      src    = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
+      src    = &priv->iobuffer[priv->niobytes - priv->nsectbytes];
       dest   = &req->buf[priv->nreqbytes];
 
       nbytes = MIN(priv->epbulkin->maxpacket - priv->nreqbytes,
@@ -2364,6 +2546,56 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   return OK;
 }
 
+/****************************************************************************
+ * Name: usbmsc_writesectors
+ *
+ * Description:
+ *   Write the nsectors buffered in iobuffer[] to priv->sector.  With
+ *   CONFIG_USBMSC_DOUBLEBUFFER, the write is only started once the previous
+ *   one is complete, and iobuffer[] is free for the next sectors on return.
+ *   A zero nsectors then just waits for the previous write.
+ *
+ * Returned Value:
+ *   A negated errno value if this or the previous write failed.  The sense
+ *   data of the LUN is set in that case.
+ *
+ ****************************************************************************/
+
+static ssize_t usbmsc_writesectors(FAR struct usbmsc_dev_s *priv,
+                                   uint16_t nsectors)
+{
+  FAR struct usbmsc_lun_s *lun = priv->lun;
+  ssize_t nwritten;
+
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+  nwritten = usbmsc_iowait(priv);
+  if (nwritten < 0)
+    {
+      /* The residue was already reduced by the failed sectors */
+
+      lun->sd        = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
+      lun->sdinfo    = priv->iosector;
+      priv->residue += lun->sectorsize * priv->ionsectors;
+      return nwritten;
+    }
+
+  if (nsectors > 0)
+    {
+      usbmsc_ioswap(priv);
+      usbmsc_iostart(priv, true, nsectors);
+    }
+#else
+  nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer, priv->sector, nsectors);
+  if (nwritten < 0)
+    {
+      lun->sd     = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
+      lun->sdinfo = priv->sector;
+    }
+#endif
+
+  return nwritten;
+}
+
 /****************************************************************************
  * Name: usbmsc_cmdwritestate
  *
@@ -2486,14 +2718,11 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
             {
               /* Yes.. Write next sectors */
 
-              nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer,
-                                           priv->sector, nrbufs);
+              nwritten = usbmsc_writesectors(priv, nrbufs);
               if (nwritten < 0)
                 {
                   usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL),
                            -nwritten);
-                  lun->sd     = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
-                  lun->sdinfo = priv->sector;
                   goto errout;
                 }
 
@@ -2507,14 +2736,11 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
             {
               /* Yes.. Write the next sector */
 
-              nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer,
-                                           priv->sector, 1);
+              nwritten = usbmsc_writesectors(priv, 1);
               if (nwritten < 0)
                 {
                   usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL),
                            -nwritten);
-                  lun->sd     = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
-                  lun->sdinfo = priv->sector;
                   goto errout;
                 }
 
@@ -2552,6 +2778,15 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
     }
 
 errout:
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+  /* Wait for the last sectors to be written */
+
+  if (priv->iobusy && usbmsc_writesectors(priv, 0) < 0)
+    {
+      usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL), 0);
+    }
+#endif
+
   usbtrace(TRACE_CLASSSTATE(USBMSC_CLASSSTATE_CMDWRITECMDFINISH),
            priv->u.xfrlen);
   priv->thstate  = USBMSC_STATE_CMDFINISH;
@@ -2838,6 +3073,10 @@ int usbmsc_scsi_main(int argc, FAR char *argv[])
   irqstate_t flags;
   uint16_t eventset;
   int ret;
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+  FAR char *ioargv[2];
+  char arg1[32];
+#endif
 
   uinfo("Started\n");
 
@@ -2887,6 +3126,28 @@ int usbmsc_scsi_main(int argc, FAR char *argv[])
   priv->theventset = USBMSC_EVENT_NOEVENTS;
   nxmutex_unlock(&priv->thlock);
 
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+  /* Start the block device I/O thread.  Without it, the transfers are
+   * simply done inline.
+   */
+
+  snprintf(arg1, sizeof(arg1), "%p", priv);
+  ioargv[0] = arg1;
+  ioargv[1] = NULL;
+
+  priv->ioexit = false;
+  ret = kthread_create("usbmsc_io", CONFIG_USBMSC_SCSI_PRIO,
+                       CONFIG_USBMSC_SCSI_STACKSIZE, usbmsc_iothread,
+                       ioargv);
+  if (ret < 0)
+    {
+      uerr("ERROR: Failed to start the I/O thread: %d\n", ret);
+      ret = 0;
+    }
+
+  priv->iopid = (pid_t)ret;
+#endif
+
   /* Then loop until we are asked to terminate */
 
   while ((eventset & USBMSC_EVENT_TERMINATEREQUEST) == 0)
@@ -3035,6 +3296,19 @@ int usbmsc_scsi_main(int argc, FAR char *argv[])
       while (ret == OK);
     }
 
+#ifdef CONFIG_USBMSC_DOUBLEBUFFER
+  /* Stop the block device I/O thread */
+
+  usbmsc_iowait(priv);
+  if (priv->iopid > 0)
+    {
+      priv->ioexit = true;
+      nxsem_post(&priv->iostart);
+      nxsem_wait_uninterruptible(&priv->iodone);
+      priv->iopid = 0;
+    }
+#endif
+
   /* Transition to the TERMINATED state and exit */
 
   priv->thstate = USBMSC_STATE_TERMINATED;
@@ -40,7 +40,9 @@
 
 #include <nuttx/random.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/usrsock.h>
 
@@ -52,6 +54,14 @@
 #  define CONFIG_NET_USRSOCKDEV_NPOLLWAITERS 1
 #endif
 
+#ifdef CONFIG_NET_USRSOCK_RING
+#  define USRSOCK_RING_MASK (CONFIG_NET_USRSOCK_RING_SIZE - 1)
+#  if (CONFIG_NET_USRSOCK_RING_SIZE & USRSOCK_RING_MASK) != 0 || \
+      CONFIG_NET_USRSOCK_RING_SIZE < 64
+#    error CONFIG_NET_USRSOCK_RING_SIZE must be a power of two, at least 64
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -67,6 +77,10 @@ struct usrsockdev_s
     size_t                  pos;    /* Reader position on request buffer */
   } req;
   FAR struct pollfd *pollfds[CONFIG_NET_USRSOCKDEV_NPOLLWAITERS];
+#ifdef CONFIG_NET_USRSOCK_RING
+  FAR struct usrsock_ring_s *ring;  /* The shared ring, kept once allocated */
+  bool mapped;                      /* The daemon uses the ring */
+#endif
 };
 
 /****************************************************************************
@@ -85,6 +99,12 @@ static int usrsockdev_open(FAR struct file *filep);
 static int usrsockdev_close(FAR struct file *filep);
 static int usrsockdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
+#ifdef CONFIG_NET_USRSOCK_RING
+static int usrsockdev_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+static int usrsockdev_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -97,8 +117,13 @@ static const struct file_operations g_usrsockdevops =
   usrsockdev_read,    /* read */
   usrsockdev_write,   /* write */
   usrsockdev_seek,    /* seek */
+#ifdef CONFIG_NET_USRSOCK_RING
+  usrsockdev_ioctl,   /* ioctl */
+  usrsockdev_mmap,    /* mmap */
+#else
   NULL,               /* ioctl */
   NULL,               /* mmap */
+#endif
   NULL,               /* truncate */
   usrsockdev_poll     /* poll */
 };
@@ -128,6 +153,261 @@ static bool usrsockdev_is_opened(FAR struct usrsockdev_s *dev)
   return ret;
 }
 
+/****************************************************************************
+ * Name: usrsockdev_response
+ *
+ * Description:
+ *   Handle a response or event from the daemon.  Called with devlock held.
+ *
+ ****************************************************************************/
+
+static ssize_t usrsockdev_response(FAR struct usrsockdev_s *dev,
+                                   FAR const char *buffer, size_t len)
+{
+  bool req_done = false;
+  ssize_t ret;
+
+  ret = usrsock_response(buffer, len, &req_done);
+  if (req_done && dev->req.iov)
+    {
+      dev->req.iov = NULL;
+      dev->req.pos = 0;
+      dev->req.iovcnt = 0;
+    }
+
+  return ret;
+}
+
+#ifdef CONFIG_NET_USRSOCK_RING
+
+/****************************************************************************
+ * Name: usrsockdev_ring_put
+ *
+ * Description:
+ *   Put a request in the request area of the ring.  Called with devlock
+ *   held.
+ *
+ * Returned Value:
+ *   True if the request was put in the ring, false if it has to be read()
+ *   from the device instead.
+ *
+ ****************************************************************************/
+
+static bool usrsockdev_ring_put(FAR struct usrsockdev_s *dev,
+                                FAR const struct iovec *iov,
+                                unsigned int iovcnt)
+{
+  FAR struct usrsock_ring_s *ring = dev->ring;
+  FAR uint8_t *area = (FAR uint8_t *)(ring + 1);
+  uint32_t head = ring->req.head;
+  uint32_t tail = __atomic_load_n(&ring->req.tail, __ATOMIC_ACQUIRE);
+  uint32_t off = head & USRSOCK_RING_MASK;
+  uint32_t need;
+  size_t len = 0;
+  unsigned int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
+  need = sizeof(uint32_t) + ALIGN_UP(len, USRSOCK_RING_ALIGN);
+  if (len > CONFIG_NET_USRSOCK_RING_SIZE ||
+      need > CONFIG_NET_USRSOCK_RING_SIZE)
+    {
+      return false;
+    }
+
+  /* Skip the end of the area if the request does not fit there */
+
+  if (off + need > CONFIG_NET_USRSOCK_RING_SIZE)
+    {
+      if (head + (CONFIG_NET_USRSOCK_RING_SIZE - off) + need - tail >
+          CONFIG_NET_USRSOCK_RING_SIZE)
+        {
+          return false;
+        }
+
+      *(FAR uint32_t *)(area + off) = 0;
+      head += CONFIG_NET_USRSOCK_RING_SIZE - off;
+      off   = 0;
+    }
+  else if (head + need - tail > CONFIG_NET_USRSOCK_RING_SIZE)
+    {
+      return false;
+    }
+
+  *(FAR uint32_t *)(area + off) = len;
+  usrsock_iovec_get(area + off + sizeof(uint32_t), len, iov, iovcnt, 0,
+                    NULL);
+
+  __atomic_store_n(&ring->req.head, head + need, __ATOMIC_RELEASE);
+  return true;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_ring_pending
+ ****************************************************************************/
+
+static bool usrsockdev_ring_pending(FAR struct usrsockdev_s *dev)
+{
+  return dev->mapped &&
+         __atomic_load_n(&dev->ring->req.tail, __ATOMIC_ACQUIRE) !=
+         dev->ring->req.head;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_doorbell
+ *
+ * Description:
+ *   Handle all of the messages in the response area of the ring.  Called
+ *   with devlock held.
+ *
+ * Returned Value:
+ *   The number of messages handled, or a negated errno value if the area
+ *   is corrupted.
+ *
+ ****************************************************************************/
+
+static int usrsockdev_doorbell(FAR struct usrsockdev_s *dev)
+{
+  FAR struct usrsock_ring_s *ring = dev->ring;
+  FAR const uint8_t *area = (FAR const uint8_t *)(ring + 1) +
+                            CONFIG_NET_USRSOCK_RING_SIZE;
+  uint32_t tail = ring->resp.tail;
+  uint32_t head = __atomic_load_n(&ring->resp.head, __ATOMIC_ACQUIRE);
+  FAR const char *msg;
+  uint32_t off;
+  uint32_t len;
+  ssize_t ret;
+  int count = 0;
+
+  if (head - tail > CONFIG_NET_USRSOCK_RING_SIZE)
+    {
+      return -EINVAL;
+    }
+
+  while (tail != head)
+    {
+      off = tail & USRSOCK_RING_MASK;
+      len = *(FAR const uint32_t *)(area + off);
+      if (len == 0)
+        {
+          tail += CONFIG_NET_USRSOCK_RING_SIZE - off;
+          continue;
+        }
+
+      if (len > CONFIG_NET_USRSOCK_RING_SIZE - off - sizeof(uint32_t))
+        {
+          nerr("ERROR: Bad message length %" PRIu32 "\n", len);
+          return -EINVAL;
+        }
+
+      /* A message may be handled in several steps, e.g. the header of a
+       * data response and then its data.
+       */
+
+      msg = (FAR const char *)area + off + sizeof(uint32_t);
+      tail += sizeof(uint32_t) + ALIGN_UP(len, USRSOCK_RING_ALIGN);
+      do
+        {
+          ret = usrsockdev_response(dev, msg, len);
+          if (ret <= 0)
+            {
+              nwarn("WARNING: Dropped message: %zd\n", ret);
+              break;
+            }
+
+          msg += ret;
+          len -= ret;
+        }
+      while (len > 0);
+
+      __atomic_store_n(&ring->resp.tail, tail, __ATOMIC_RELEASE);
+      count++;
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_ioctl
+ ****************************************************************************/
+
+static int usrsockdev_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg)
+{
+  FAR struct usrsockdev_s *dev = filep->f_inode->i_private;
+  int ret;
+
+  if (cmd != USRSOCKIOC_DOORBELL)
+    {
+      return -ENOTTY;
+    }
+
+  ret = nxmutex_lock(&dev->devlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = dev->mapped ? usrsockdev_doorbell(dev) : -ENXIO;
+
+  nxmutex_unlock(&dev->devlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_mmap
+ ****************************************************************************/
+
+static int usrsockdev_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map)
+{
+  FAR struct usrsockdev_s *dev = filep->f_inode->i_private;
+  size_t size = sizeof(struct usrsock_ring_s) +
+                2 * CONFIG_NET_USRSOCK_RING_SIZE;
+  int ret;
+
+  if (map->offset < 0 || (size_t)map->offset >= size ||
+      map->length > size - map->offset)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&dev->devlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The daemon accesses the ring directly, so it is allocated from the
+   * user heap.  It is never freed because the daemon may keep it mapped
+   * after closing the device.
+   */
+
+  if (dev->ring == NULL)
+    {
+      dev->ring = kumm_zalloc(size);
+      if (dev->ring == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      dev->ring->size = CONFIG_NET_USRSOCK_RING_SIZE;
+    }
+
+  map->vaddr  = (FAR char *)dev->ring + map->offset;
+  dev->mapped = true;
+
+errout:
+  nxmutex_unlock(&dev->devlock);
+  return ret;
+}
+
+#endif /* CONFIG_NET_USRSOCK_RING */
+
 /****************************************************************************
  * Name: usrsockdev_read
  ****************************************************************************/
@@ -265,7 +545,6 @@ static ssize_t usrsockdev_write(FAR struct file *filep,
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct usrsockdev_s *dev;
-  bool req_done = false;
   ssize_t ret = 0;
 
   if (len == 0)
@@ -288,13 +567,7 @@ static ssize_t usrsockdev_write(FAR struct file *filep,
       return ret;
     }
 
-  ret = usrsock_response(buffer, len, &req_done);
-  if (req_done && dev->req.iov)
-    {
-      dev->req.iov = NULL;
-      dev->req.pos = 0;
-      dev->req.iovcnt = 0;
-    }
+  ret = usrsockdev_response(dev, buffer, len);
 
   nxmutex_unlock(&dev->devlock);
   return ret;
@@ -375,6 +648,17 @@ static int usrsockdev_close(FAR struct file *filep)
   dev->req.iovcnt = 0;
   dev->req.pos = 0;
 
+#ifdef CONFIG_NET_USRSOCK_RING
+  /* The next daemon starts with empty areas, if it maps the device */
+
+  if (dev->ring != NULL)
+    {
+      memset(dev->ring, 0, 2 * sizeof(struct usrsock_ring_area_s));
+    }
+
+  dev->mapped = false;
+#endif
+
   nxmutex_unlock(&dev->devlock);
   usrsock_abort();
 
@@ -449,6 +733,12 @@ static int usrsockdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
         {
           poll_notify(&fds, 1, POLLIN);
         }
+#ifdef CONFIG_NET_USRSOCK_RING
+      else if (usrsockdev_ring_pending(dev))
+        {
+          poll_notify(&fds, 1, POLLIN);
+        }
+#endif
     }
   else
     {
@@ -493,9 +783,19 @@ int usrsock_request(FAR struct iovec *iov, unsigned int iovcnt)
   if (usrsockdev_is_opened(dev))
     {
       DEBUGASSERT(dev->req.iov == NULL);
-      dev->req.iov = iov;
-      dev->req.pos = 0;
-      dev->req.iovcnt = iovcnt;
+
+#ifdef CONFIG_NET_USRSOCK_RING
+      /* The request is copied to the ring, or left to be read() if it does
+       * not fit.
+       */
+
+      if (!dev->mapped || !usrsockdev_ring_put(dev, iov, iovcnt))
+#endif
+        {
+          dev->req.iov = iov;
+          dev->req.pos = 0;
+          dev->req.iovcnt = iovcnt;
+        }
 
       /* Notify daemon of new request. */
 
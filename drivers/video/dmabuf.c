@@ -0,0 +1,420 @@
+/****************************************************************************
+ * drivers/video/dmabuf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/video/dmabuf.h>
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int dmabuf_close(FAR struct file *filep);
+static int dmabuf_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map);
+static int dmabuf_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_dmabuf_fops =
+{
+  NULL,          /* open */
+  dmabuf_close,  /* close */
+  NULL,          /* read */
+  NULL,          /* write */
+  NULL,          /* seek */
+  NULL,          /* ioctl */
+  dmabuf_mmap,   /* mmap */
+  NULL,          /* truncate */
+  dmabuf_poll    /* poll */
+};
+
+static struct inode g_dmabuf_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_dmabuf_fops        /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int dmabuf_close(FAR struct file *filep)
+{
+  dmabuf_put(filep->f_priv);
+  return OK;
+}
+
+static int dmabuf_munmap(FAR struct task_group_s *group,
+                         FAR struct mm_map_entry_s *entry,
+                         FAR void *start, size_t length)
+{
+  return mm_map_remove(get_group_mm(group), entry);
+}
+
+static int dmabuf_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct dmabuf_s *buf = filep->f_priv;
+
+  if (map->offset < 0 || map->length == 0 ||
+      map->offset + map->length > buf->size)
+    {
+      return -EINVAL;
+    }
+
+  map->vaddr  = (FAR uint8_t *)buf->vaddr + map->offset;
+  map->munmap = dmabuf_munmap;
+  return mm_map_add(get_current_mm(), map);
+}
+
+static int dmabuf_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup)
+{
+  FAR struct dmabuf_s *buf = filep->f_priv;
+  FAR struct pollfd **slot;
+  irqstate_t flags;
+  bool ready;
+  int i;
+
+  flags = spin_lock_irqsave(&buf->lock);
+
+  if (!setup)
+    {
+      slot = (FAR struct pollfd **)fds->priv;
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+        }
+
+      spin_unlock_irqrestore(&buf->lock, flags);
+      return OK;
+    }
+
+  for (i = 0; i < CONFIG_VIDEO_DMABUF_NPOLLWAITERS; i++)
+    {
+      if (buf->fds[i] == NULL)
+        {
+          buf->fds[i] = fds;
+          fds->priv   = &buf->fds[i];
+          break;
+        }
+    }
+
+  ready = buf->fences == 0;
+  spin_unlock_irqrestore(&buf->lock, flags);
+
+  if (i >= CONFIG_VIDEO_DMABUF_NPOLLWAITERS)
+    {
+      return -EBUSY;
+    }
+
+  /* The buffer is ready to be read and written when no write is in
+   * progress.
+   */
+
+  if (ready)
+    {
+      poll_notify(&fds, 1, POLLIN | POLLOUT);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dmabuf_create
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_create(FAR void *vaddr, size_t size,
+                                   dmabuf_release_t release,
+                                   FAR void *priv)
+{
+  FAR struct dmabuf_s *buf;
+
+  buf = kmm_zalloc(sizeof(struct dmabuf_s));
+  if (buf == NULL)
+    {
+      return NULL;
+    }
+
+  buf->vaddr   = vaddr;
+  buf->size    = size;
+  buf->release = release;
+  buf->priv    = priv;
+  buf->refs    = 1;
+
+  spin_lock_init(&buf->lock);
+  nxsem_init(&buf->fencesem, 0, 0);
+  return buf;
+}
+
+/****************************************************************************
+ * Name: dmabuf_slice
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_slice(FAR struct dmabuf_s *parent,
+                                  size_t offset, size_t size)
+{
+  FAR struct dmabuf_s *buf;
+
+  if (offset > parent->size || size > parent->size - offset)
+    {
+      return NULL;
+    }
+
+  buf = dmabuf_create((FAR uint8_t *)parent->vaddr + offset, size,
+                      NULL, NULL);
+  if (buf != NULL)
+    {
+      dmabuf_get(parent);
+      buf->parent = parent;
+    }
+
+  return buf;
+}
+
+/****************************************************************************
+ * Name: dmabuf_get
+ ****************************************************************************/
+
+void dmabuf_get(FAR struct dmabuf_s *buf)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&buf->lock);
+  DEBUGASSERT(buf->refs > 0);
+  buf->refs++;
+  spin_unlock_irqrestore(&buf->lock, flags);
+}
+
+/****************************************************************************
+ * Name: dmabuf_put
+ ****************************************************************************/
+
+void dmabuf_put(FAR struct dmabuf_s *buf)
+{
+  irqstate_t flags;
+  unsigned int refs;
+
+  flags = spin_lock_irqsave(&buf->lock);
+  DEBUGASSERT(buf->refs > 0);
+  refs = --buf->refs;
+  spin_unlock_irqrestore(&buf->lock, flags);
+
+  if (refs > 0)
+    {
+      return;
+    }
+
+  if (buf->parent != NULL)
+    {
+      dmabuf_put(buf->parent);
+    }
+  else if (buf->release != NULL)
+    {
+      buf->release(buf);
+    }
+
+  nxsem_destroy(&buf->fencesem);
+  kmm_free(buf);
+}
+
+/****************************************************************************
+ * Name: dmabuf_export
+ ****************************************************************************/
+
+int dmabuf_export(FAR struct dmabuf_s *buf, int oflags)
+{
+  int fd;
+
+  dmabuf_get(buf);
+
+  fd = file_allocate(&g_dmabuf_inode, O_RDWR | oflags, 0, buf, 0, true);
+  if (fd < 0)
+    {
+      verr("ERROR: Failed to allocate a descriptor: %d\n", fd);
+      dmabuf_put(buf);
+    }
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: dmabuf_import
+ ****************************************************************************/
+
+int dmabuf_import(int fd, FAR struct dmabuf_s **buf)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (filep->f_inode != &g_dmabuf_inode)
+    {
+      ret = -EINVAL;
+    }
+  else
+    {
+      *buf = filep->f_priv;
+      dmabuf_get(*buf);
+    }
+
+  fs_putfilep(filep);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dmabuf_fence_begin
+ ****************************************************************************/
+
+void dmabuf_fence_begin(FAR struct dmabuf_s *buf)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&buf->lock);
+  buf->fences++;
+  spin_unlock_irqrestore(&buf->lock, flags);
+}
+
+/****************************************************************************
+ * Name: dmabuf_fence_end
+ ****************************************************************************/
+
+void dmabuf_fence_end(FAR struct dmabuf_s *buf)
+{
+  irqstate_t flags;
+  unsigned int waiters = 0;
+  bool done;
+
+  flags = spin_lock_irqsave(&buf->lock);
+  DEBUGASSERT(buf->fences > 0);
+  done = --buf->fences == 0;
+  if (done)
+    {
+      waiters = buf->waiters;
+    }
+
+  spin_unlock_irqrestore(&buf->lock, flags);
+
+  if (done)
+    {
+      /* Wake up every waiter, they check the fences again themselves */
+
+      while (waiters-- > 0)
+        {
+          nxsem_post(&buf->fencesem);
+        }
+
+      poll_notify(buf->fds, CONFIG_VIDEO_DMABUF_NPOLLWAITERS,
+                  POLLIN | POLLOUT);
+    }
+}
+
+/****************************************************************************
+ * Name: dmabuf_fence_wait
+ ****************************************************************************/
+
+int dmabuf_fence_wait(FAR struct dmabuf_s *buf, unsigned int msec)
+{
+  clock_t deadline = clock_systime_ticks() + MSEC2TICK(msec);
+  irqstate_t flags;
+  sclock_t delay;
+  int ret = OK;
+
+  flags = spin_lock_irqsave(&buf->lock);
+
+  while (buf->fences > 0)
+    {
+      if (msec == 0)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      delay = (sclock_t)(deadline - clock_systime_ticks());
+      if (msec != DMABUF_WAIT_FOREVER && delay <= 0)
+        {
+          ret = -ETIMEDOUT;
+          break;
+        }
+
+      buf->waiters++;
+      spin_unlock_irqrestore(&buf->lock, flags);
+
+      if (msec == DMABUF_WAIT_FOREVER)
+        {
+          ret = nxsem_wait(&buf->fencesem);
+        }
+      else
+        {
+          ret = nxsem_tickwait(&buf->fencesem, delay);
+        }
+
+      flags = spin_lock_irqsave(&buf->lock);
+      buf->waiters--;
+
+      /* A timeout is reported by the deadline check above */
+
+      if (ret < 0 && ret != -ETIMEDOUT)
+        {
+          break;
+        }
+
+      ret = OK;
+    }
+
+  spin_unlock_irqrestore(&buf->lock, flags);
+  return ret;
+}
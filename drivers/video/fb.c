@@ -33,12 +33,14 @@
 #include <assert.h>
 #include <debug.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <poll.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/video/fb.h>
+#include <nuttx/video/dmabuf.h>
 #include <nuttx/clock.h>
 #include <nuttx/wdog.h>
 #include <nuttx/mm/circbuf.h>
@@ -68,6 +70,18 @@ struct fb_priv_s
 #endif
 };
 
+#ifdef CONFIG_VIDEO_DMABUF
+/* A shared buffer queued by FBIOPAN_DMABUF, held until another pan info is
+ * displayed after its own.
+ */
+
+struct fb_dmabuf_s
+{
+  FAR struct dmabuf_s *buf;
+  uint32_t seq;                   /* Sequence number of its pan info */
+};
+#endif
+
 struct fb_paninfo_s
 {
   FAR struct circbuf_s buf;       /* Pan buffer queued list */
@@ -91,6 +105,13 @@ struct fb_chardev_s
   FAR struct fb_priv_s *head;
   FAR struct fb_paninfo_s *paninfo; /* Pan info array */
   size_t paninfo_count;             /* Pan info count */
+#ifdef CONFIG_VIDEO_DMABUF
+  uint32_t panadded;                /* Pan infos queued without overlay */
+  uint32_t panremoved;              /* Pan infos displayed without overlay */
+  FAR struct fb_dmabuf_s *dmabuf;   /* Held shared buffers, oldest first */
+  uint8_t ndmabuf;                  /* Number of held shared buffers */
+  uint8_t maxdmabuf;                /* Size of dmabuf[] */
+#endif
 };
 
 struct fb_panelinfo_s
@@ -112,6 +133,10 @@ static int     fb_add_paninfo(FAR struct fb_chardev_s *fb,
                               int overlay);
 static int     fb_clear_paninfo(FAR struct fb_chardev_s *fb,
                                 int overlay);
+#ifdef CONFIG_VIDEO_DMABUF
+static int     fb_pan_dmabuf(FAR struct fb_chardev_s *fb, int fd,
+                             bool nonblock);
+#endif
 static int     fb_open(FAR struct file *filep);
 static int     fb_close(FAR struct file *filep);
 static ssize_t fb_read(FAR struct file *filep, FAR char *buffer,
@@ -212,6 +237,12 @@ static int fb_add_paninfo(FAR struct fb_chardev_s *fb,
     {
       gwarn("WARNING: circbuf_write(panbuf) failed\n");
     }
+#ifdef CONFIG_VIDEO_DMABUF
+  else if (overlay == FB_NO_OVERLAY)
+    {
+      fb->panadded++;
+    }
+#endif
 
   /* Re-enable interrupts */
 
@@ -246,12 +277,159 @@ static int fb_clear_paninfo(FAR struct fb_chardev_s *fb,
 
   circbuf_reset(panbuf);
 
+#ifdef CONFIG_VIDEO_DMABUF
+  /* The dropped pan infos will never be displayed */
+
+  if (overlay == FB_NO_OVERLAY)
+    {
+      fb->panremoved = fb->panadded;
+    }
+#endif
+
   /* Re-enable interrupts */
 
   leave_critical_section(flags);
   return OK;
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+/****************************************************************************
+ * Name: fb_pan_dmabuf
+ *
+ * Description:
+ *   Queue the shared buffer referred to by 'fd' for display, once its
+ *   writers are done with it.  The buffer is held until the display moved
+ *   on to a later pan info.
+ *
+ ****************************************************************************/
+
+static int fb_pan_dmabuf(FAR struct fb_chardev_s *fb, int fd,
+                         bool nonblock)
+{
+  struct fb_panelinfo_s panelinfo;
+  struct fb_videoinfo_s vinfo;
+  union fb_paninfo_u paninfo;
+  FAR struct dmabuf_s *buf;
+  FAR struct dmabuf_s *done;
+  irqstate_t flags;
+  int ret;
+
+  /* Only the drivers scanning out the fbmem of the pan infos can */
+
+  if (!fb->vtable->pandmabuf)
+    {
+      return -ENOTTY;
+    }
+
+  ret = fb_get_planeinfo(fb, &paninfo.planeinfo, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = fb->vtable->getvideoinfo(fb->vtable, &vinfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (fb->dmabuf == NULL)
+    {
+      ret = fb_get_panelinfo(fb, &panelinfo, FB_NO_OVERLAY);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* The queued pan infos, and the one on display */
+
+      fb->maxdmabuf = panelinfo.fbcount + 1;
+      fb->dmabuf = kmm_zalloc(fb->maxdmabuf * sizeof(struct fb_dmabuf_s));
+      if (fb->dmabuf == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  ret = dmabuf_import(fd, &buf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (buf->size < paninfo.planeinfo.stride * vinfo.yres)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = dmabuf_fence_wait(buf, nonblock ? 0 : DMABUF_WAIT_FOREVER);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  /* Drop the buffers that the display moved past */
+
+  for (; ; )
+    {
+      done  = NULL;
+      flags = enter_critical_section();
+      if (fb->ndmabuf > 0 &&
+          (int32_t)(fb->panremoved - fb->dmabuf[0].seq) > 1)
+        {
+          done = fb->dmabuf[0].buf;
+          fb->ndmabuf--;
+          memmove(&fb->dmabuf[0], &fb->dmabuf[1],
+                  fb->ndmabuf * sizeof(struct fb_dmabuf_s));
+        }
+
+      leave_critical_section(flags);
+      if (done == NULL)
+        {
+          break;
+        }
+
+      dmabuf_put(done);
+    }
+
+  paninfo.planeinfo.fbmem   = buf->vaddr;
+  paninfo.planeinfo.fblen   = buf->size;
+  paninfo.planeinfo.xoffset = 0;
+  paninfo.planeinfo.yoffset = 0;
+
+  if (fb->vtable->pandisplay != NULL)
+    {
+      fb->vtable->pandisplay(fb->vtable, &paninfo.planeinfo);
+    }
+
+  flags = enter_critical_section();
+  if (fb->ndmabuf >= fb->maxdmabuf)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      fb->dmabuf[fb->ndmabuf].seq = fb->panadded;
+      ret = fb_add_paninfo(fb, &paninfo, FB_NO_OVERLAY);
+      if (ret >= 0)
+        {
+          fb->dmabuf[fb->ndmabuf++].buf = buf;
+        }
+    }
+
+  leave_critical_section(flags);
+  if (ret >= 0)
+    {
+      return OK;
+    }
+
+errout:
+  dmabuf_put(buf);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: fb_open
  ****************************************************************************/
@@ -887,6 +1065,10 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
           memcpy(&paninfo, pinfo, sizeof(*pinfo));
 
+          /* The pan is within the frame buffer memory */
+
+          paninfo.planeinfo.fbmem = NULL;
+
           if (fb->vtable->pandisplay != NULL)
             {
               fb->vtable->pandisplay(fb->vtable, pinfo);
@@ -902,6 +1084,15 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_VIDEO_DMABUF
+      case FBIOPAN_DMABUF:
+        {
+          ret = fb_pan_dmabuf(fb, (int)arg,
+                              (filep->f_oflags & O_NONBLOCK) != 0);
+        }
+        break;
+#endif
+
       case FBIOSET_VSYNCOFFSET:
         {
           fb->vsyncoffset = USEC2TICK(arg);
@@ -1525,6 +1716,13 @@ int fb_remove_paninfo(FAR struct fb_vtable_s *vtable, int overlay)
   ret = circbuf_skip(panbuf, sizeof(union fb_paninfo_u));
   DEBUGASSERT(ret <= 0 || ret == sizeof(union fb_paninfo_u));
 
+#ifdef CONFIG_VIDEO_DMABUF
+  if (ret > 0 && overlay == FB_NO_OVERLAY)
+    {
+      fb->panremoved++;
+    }
+#endif
+
   /* Re-enable interrupts */
 
   leave_critical_section(flags);
@@ -459,9 +459,17 @@ static int goldfish_gpu_fb_vsync_thread(int argc, FAR char** argv)
 
           if (fb_peek_paninfo(&fb->vtable, &info, FB_NO_OVERLAY) == OK)
             {
-              FAR void *buf = fb->planeinfo.fbmem +
-                              fb->planeinfo.stride *
-                              info.planeinfo.yoffset;
+              FAR void *buf = info.planeinfo.fbmem;
+
+              /* Unless showing a shared buffer, pan within our own memory.
+               * The host is given a copy of the frame either way.
+               */
+
+              if (buf == NULL)
+                {
+                  buf = fb->planeinfo.fbmem + fb->planeinfo.stride *
+                        info.planeinfo.yoffset;
+                }
 
               goldfish_gpu_fb_commit(fb, buf);
               fb_remove_paninfo(&fb->vtable, FB_NO_OVERLAY);
@@ -562,6 +570,9 @@ int goldfish_gpu_fb_register(int display)
 
   fb->vtable.getplaneinfo = goldfish_gpu_fb_getplaneinfo;
   fb->vtable.getvideoinfo = goldfish_gpu_fb_getvideoinfo;
+#ifdef CONFIG_VIDEO_DMABUF
+  fb->vtable.pandmabuf    = true;
+#endif
 
   /* Create the vsync thread */
 
@@ -107,6 +107,10 @@ struct capture_type_inf_s
   struct v4l2_fract      frame_interval;
   video_framebuff_t      bufinf;
   FAR uint8_t            *bufheap;   /* for V4L2_MEMORY_MMAP buffers */
+#ifdef CONFIG_VIDEO_DMABUF
+  FAR struct dmabuf_s    *heap;      /* bufheap, once buffers are exported */
+  FAR struct dmabuf_s    *expbuf[V4L2_REQBUFS_COUNT_MAX];
+#endif
   FAR struct pollfd      *fds;
   uint32_t               seqnum;
 };
@@ -285,6 +289,10 @@ static int capture_enum_frminterval(FAR struct file *filep,
                                     FAR struct v4l2_frmivalenum *f);
 static int capture_enum_frmsize(FAR struct file *filep,
                                 FAR struct v4l2_frmsizeenum *f);
+#ifdef CONFIG_VIDEO_DMABUF
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *exp);
+#endif
 
 /* File operations function */
 
@@ -337,7 +345,15 @@ static const struct v4l2_ops_s g_capture_vops =
   capture_s_ext_ctrls_scene,          /* s_ext_ctrls_scene */
   capture_enum_fmt,                   /* enum_fmt */
   capture_enum_frminterval,           /* enum_frminterval */
-  capture_enum_frmsize                /* enum_frmsize */
+  capture_enum_frmsize,               /* enum_frmsize */
+#ifdef CONFIG_VIDEO_DMABUF
+  NULL,                               /* cropcap */
+  NULL,                               /* dqevent */
+  NULL,                               /* subscribe_event */
+  NULL,                               /* decoder_cmd */
+  NULL,                               /* encoder_cmd */
+  capture_expbuf,                     /* expbuf */
+#endif
 };
 
 static const struct file_operations g_capture_fops =
@@ -1175,17 +1191,53 @@ static void initialize_resources(FAR capture_mng_t *cmng)
   initialize_scenes_parameter(cmng);
 }
 
-static void cleanup_streamresources(FAR capture_type_inf_t *type_inf,
-                                    FAR capture_mng_t *cmng)
+#ifdef CONFIG_VIDEO_DMABUF
+static void release_heap(FAR struct dmabuf_s *buf)
 {
-  video_framebuff_uninit(&type_inf->bufinf);
-  nxsem_destroy(&type_inf->wait_capture.dqbuf_wait_flg);
-  nxmutex_destroy(&type_inf->lock_state);
+  FAR struct imgdata_s *imgdata = buf->priv;
+
+  if (imgdata->ops->free)
+    {
+      imgdata->ops->free(imgdata, buf->vaddr);
+    }
+  else
+    {
+      kumm_free(buf->vaddr);
+    }
+}
+#endif
+
+static void free_heap(FAR capture_type_inf_t *type_inf,
+                      FAR struct imgdata_s *imgdata)
+{
+#ifdef CONFIG_VIDEO_DMABUF
+  int i;
+
+  for (i = 0; i < V4L2_REQBUFS_COUNT_MAX; i++)
+    {
+      if (type_inf->expbuf[i] != NULL)
+        {
+          dmabuf_put(type_inf->expbuf[i]);
+          type_inf->expbuf[i] = NULL;
+        }
+    }
+
+  /* The exported buffers still open keep the memory until closed */
+
+  if (type_inf->heap != NULL)
+    {
+      dmabuf_put(type_inf->heap);
+      type_inf->heap    = NULL;
+      type_inf->bufheap = NULL;
+      return;
+    }
+#endif
+
   if (type_inf->bufheap != NULL)
     {
-      if (cmng->imgdata->ops->free)
+      if (imgdata->ops->free)
         {
-          cmng->imgdata->ops->free(cmng->imgdata, type_inf->bufheap);
+          imgdata->ops->free(imgdata, type_inf->bufheap);
         }
       else
         {
@@ -1196,6 +1248,15 @@ static void cleanup_streamresources(FAR capture_type_inf_t *type_inf,
     }
 }
 
+static void cleanup_streamresources(FAR capture_type_inf_t *type_inf,
+                                    FAR capture_mng_t *cmng)
+{
+  video_framebuff_uninit(&type_inf->bufinf);
+  nxsem_destroy(&type_inf->wait_capture.dqbuf_wait_flg);
+  nxmutex_destroy(&type_inf->lock_state);
+  free_heap(type_inf, cmng->imgdata);
+}
+
 static void cleanup_scene_parameter(FAR capture_scene_params_t **vsp)
 {
   FAR capture_scene_params_t *sp = *vsp;
@@ -2170,17 +2231,7 @@ static int capture_reqbufs(FAR struct file *filep,
                                               reqbufs->count);
       if (ret == OK && reqbufs->memory == V4L2_MEMORY_MMAP)
         {
-          if (type_inf->bufheap != NULL)
-            {
-              if (imgdata->ops->free)
-                {
-                    imgdata->ops->free(imgdata, type_inf->bufheap);
-                }
-              else
-                {
-                  kumm_free(type_inf->bufheap);
-                }
-            }
+          free_heap(type_inf, imgdata);
 
           if (imgdata->ops->alloc)
             {
@@ -2243,6 +2294,9 @@ static int capture_qbuf(FAR struct file *filep,
   FAR vbuf_container_t *container;
   enum capture_state_e next_capture_state;
   irqstate_t flags;
+#ifdef CONFIG_VIDEO_DMABUF
+  int ret = OK;
+#endif
 
   if (cmng == NULL || buf == NULL)
     {
@@ -2255,7 +2309,8 @@ static int capture_qbuf(FAR struct file *filep,
       return -EINVAL;
     }
 
-  if (!is_bufsize_sufficient(cmng, buf->length))
+  if (buf->memory != V4L2_MEMORY_DMABUF &&
+      !is_bufsize_sufficient(cmng, buf->length))
     {
       return -EINVAL;
     }
@@ -2274,7 +2329,33 @@ static int capture_qbuf(FAR struct file *filep,
       container->buf.length = get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]);
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
+
+#ifdef CONFIG_VIDEO_DMABUF
+      /* Let the readers of the exported buffer wait for the frame */
+
+      if (buf->index < V4L2_REQBUFS_COUNT_MAX &&
+          type_inf->expbuf[buf->index] != NULL)
+        {
+          ret = video_framebuff_attach(container,
+                                       type_inf->expbuf[buf->index],
+                                       true, false);
+        }
+#endif
+    }
+#ifdef CONFIG_VIDEO_DMABUF
+  else if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      ret = video_framebuff_import(container,
+                            get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]),
+                            true, false);
+    }
+
+  if (ret < 0)
+    {
+      video_framebuff_free_container(&type_inf->bufinf, container);
+      return ret;
     }
+#endif
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -2389,12 +2470,75 @@ static int capture_dqbuf(FAR struct file *filep,
       type_inf->wait_capture.done_container = NULL;
     }
 
+#ifdef CONFIG_VIDEO_DMABUF
+  video_framebuff_release(container);
+#endif
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   return OK;
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *exp)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR capture_mng_t *cmng = inode->i_private;
+  FAR capture_type_inf_t *type_inf;
+  size_t buf_size;
+  int fd;
+
+  if (cmng == NULL || exp == NULL)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = get_capture_type_inf(cmng, exp->type);
+  if (type_inf == NULL || type_inf->bufheap == NULL ||
+      exp->index >= type_inf->bufinf.container_size)
+    {
+      return -EINVAL;
+    }
+
+  buf_size = get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]);
+
+  /* The MMAP memory now belongs to the exported buffers as well, so it
+   * outlives REQBUFS and close() until they are all closed.
+   */
+
+  if (type_inf->heap == NULL)
+    {
+      type_inf->heap = dmabuf_create(type_inf->bufheap,
+                                     type_inf->bufinf.container_size *
+                                     buf_size, release_heap, cmng->imgdata);
+      if (type_inf->heap == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  if (type_inf->expbuf[exp->index] == NULL)
+    {
+      type_inf->expbuf[exp->index] =
+        dmabuf_slice(type_inf->heap, exp->index * buf_size, buf_size);
+      if (type_inf->expbuf[exp->index] == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  fd = dmabuf_export(type_inf->expbuf[exp->index], exp->flags & O_CLOEXEC);
+  if (fd < 0)
+    {
+      return fd;
+    }
+
+  exp->fd = fd;
+  return OK;
+}
+#endif
+
 static int capture_cancel_dqbuf(FAR struct file *filep,
                                 enum v4l2_buf_type type)
 {
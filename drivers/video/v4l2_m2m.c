@@ -61,6 +61,10 @@ struct codec_type_inf_s
   video_framebuff_t bufinf;
   FAR uint8_t       *bufheap;   /* for V4L2_MEMORY_MMAP buffers */
   bool              buflast;
+#ifdef CONFIG_VIDEO_DMABUF
+  FAR struct dmabuf_s *heap;    /* bufheap, once buffers are exported */
+  FAR struct dmabuf_s *expbuf[V4L2_REQBUFS_COUNT_MAX];
+#endif
 };
 
 typedef struct codec_type_inf_s codec_type_inf_t;
@@ -150,6 +154,10 @@ static int codec_decoder_cmd(FAR struct file *filep,
                              FAR struct v4l2_decoder_cmd *cmd);
 static int codec_encoder_cmd(FAR struct file *filep,
                              FAR struct v4l2_encoder_cmd *cmd);
+#ifdef CONFIG_VIDEO_DMABUF
+static int codec_expbuf(FAR struct file *filep,
+                        FAR struct v4l2_exportbuffer *exp);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -195,7 +203,10 @@ static const struct v4l2_ops_s g_codec_vops =
   codec_dqevent,         /* dqevent */
   codec_subscribe_event, /* subscribe_event */
   codec_decoder_cmd,     /* decoder_cmd */
-  codec_encoder_cmd      /* encoder_cmd */
+  codec_encoder_cmd,     /* encoder_cmd */
+#ifdef CONFIG_VIDEO_DMABUF
+  codec_expbuf,          /* expbuf */
+#endif
 };
 
 static const struct file_operations g_codec_fops =
@@ -228,6 +239,35 @@ codec_get_type_inf(FAR struct codec_file_s *cfile, int type)
     }
 }
 
+static void codec_free_heap(FAR codec_type_inf_t *type_inf)
+{
+#ifdef CONFIG_VIDEO_DMABUF
+  int i;
+
+  for (i = 0; i < V4L2_REQBUFS_COUNT_MAX; i++)
+    {
+      if (type_inf->expbuf[i] != NULL)
+        {
+          dmabuf_put(type_inf->expbuf[i]);
+          type_inf->expbuf[i] = NULL;
+        }
+    }
+
+  /* The exported buffers still open keep the memory until closed */
+
+  if (type_inf->heap != NULL)
+    {
+      dmabuf_put(type_inf->heap);
+      type_inf->heap    = NULL;
+      type_inf->bufheap = NULL;
+      return;
+    }
+#endif
+
+  kumm_free(type_inf->bufheap);
+  type_inf->bufheap = NULL;
+}
+
 static int codec_querycap(FAR struct file *filep,
                           FAR struct v4l2_capability *cap)
 {
@@ -304,7 +344,7 @@ static int codec_reqbufs(FAR struct file *filep,
                                           reqbufs->count);
   if (ret == 0 && reqbufs->memory == V4L2_MEMORY_MMAP)
     {
-      kumm_free(type_inf->bufheap);
+      codec_free_heap(type_inf);
       type_inf->bufheap = kumm_memalign(32, reqbufs->count * buf_size);
       if (type_inf->bufheap == NULL)
         {
@@ -368,6 +408,11 @@ static int codec_qbuf(FAR struct file *filep,
   FAR codec_type_inf_t *type_inf;
   FAR vbuf_container_t *container;
   size_t buf_size;
+#ifdef CONFIG_VIDEO_DMABUF
+  bool nonblock = (filep->f_oflags & O_NONBLOCK) != 0;
+  bool write;
+  int ret = OK;
+#endif
 
   if (buf == NULL)
     {
@@ -380,6 +425,20 @@ static int codec_qbuf(FAR struct file *filep,
       return -EINVAL;
     }
 
+  if (V4L2_TYPE_IS_OUTPUT(buf->type))
+    {
+      buf_size = CODEC_OUTPUT_G_BUFSIZE(cmng->codec, cfile->priv);
+    }
+  else
+    {
+      buf_size = CODEC_CAPTURE_G_BUFSIZE(cmng->codec, cfile->priv);
+    }
+
+  if (buf->memory == V4L2_MEMORY_MMAP && buf_size == 0)
+    {
+      return -EINVAL;
+    }
+
   container = video_framebuff_get_container(&type_inf->bufinf);
   if (container == NULL)
     {
@@ -388,28 +447,43 @@ static int codec_qbuf(FAR struct file *filep,
     }
 
   memcpy(&container->buf, buf, sizeof(struct v4l2_buffer));
+
+#ifdef CONFIG_VIDEO_DMABUF
+  /* The codec writes the capture buffers and reads the output ones */
+
+  write = !V4L2_TYPE_IS_OUTPUT(buf->type);
+#endif
+
   if (buf->memory == V4L2_MEMORY_MMAP)
     {
       /* only use userptr inside the container */
 
-      if (V4L2_TYPE_IS_OUTPUT(buf->type))
-        {
-          buf_size = CODEC_OUTPUT_G_BUFSIZE(cmng->codec, cfile->priv);
-        }
-      else
-        {
-          buf_size = CODEC_CAPTURE_G_BUFSIZE(cmng->codec, cfile->priv);
-        }
+      container->buf.length    = buf_size;
+      container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
+                                 container->buf.length * buf->index);
 
-      if (buf_size == 0)
+#ifdef CONFIG_VIDEO_DMABUF
+      if (buf->index < V4L2_REQBUFS_COUNT_MAX &&
+          type_inf->expbuf[buf->index] != NULL)
         {
-          return -EINVAL;
+          ret = video_framebuff_attach(container,
+                                       type_inf->expbuf[buf->index],
+                                       write, nonblock);
         }
+#endif
+    }
+#ifdef CONFIG_VIDEO_DMABUF
+  else if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      ret = video_framebuff_import(container, buf_size, write, nonblock);
+    }
 
-      container->buf.length    = buf_size;
-      container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
-                                 container->buf.length * buf->index);
+  if (ret < 0)
+    {
+      video_framebuff_free_container(&type_inf->bufinf, container);
+      return ret;
     }
+#endif
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -457,6 +531,9 @@ static int codec_dqbuf(FAR struct file *filep,
       return -EAGAIN;
     }
 
+#ifdef CONFIG_VIDEO_DMABUF
+  video_framebuff_release(container);
+#endif
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
   video_framebuff_free_container(&type_inf->bufinf, container);
 
@@ -856,13 +933,86 @@ static int codec_close(FAR struct file *filep)
 
   video_framebuff_uninit(&cfile->capture_inf.bufinf);
   video_framebuff_uninit(&cfile->output_inf.bufinf);
-  kumm_free(cfile->capture_inf.bufheap);
-  kumm_free(cfile->output_inf.bufheap);
+  codec_free_heap(&cfile->capture_inf);
+  codec_free_heap(&cfile->output_inf);
   kmm_free(cfile);
 
   return OK;
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static void codec_release_heap(FAR struct dmabuf_s *buf)
+{
+  kumm_free(buf->vaddr);
+}
+
+static int codec_expbuf(FAR struct file *filep,
+                        FAR struct v4l2_exportbuffer *exp)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR codec_mng_t *cmng = inode->i_private;
+  FAR codec_file_t *cfile = filep->f_priv;
+  FAR codec_type_inf_t *type_inf;
+  size_t buf_size;
+  int fd;
+
+  if (exp == NULL)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = codec_get_type_inf(cfile, exp->type);
+  if (type_inf->bufheap == NULL ||
+      exp->index >= type_inf->bufinf.container_size)
+    {
+      return -EINVAL;
+    }
+
+  if (V4L2_TYPE_IS_OUTPUT(exp->type))
+    {
+      buf_size = CODEC_OUTPUT_G_BUFSIZE(cmng->codec, cfile->priv);
+    }
+  else
+    {
+      buf_size = CODEC_CAPTURE_G_BUFSIZE(cmng->codec, cfile->priv);
+    }
+
+  /* The MMAP memory now belongs to the exported buffers as well, so it
+   * outlives REQBUFS and close() until they are all closed.
+   */
+
+  if (type_inf->heap == NULL)
+    {
+      type_inf->heap = dmabuf_create(type_inf->bufheap,
+                                     type_inf->bufinf.container_size *
+                                     buf_size, codec_release_heap, NULL);
+      if (type_inf->heap == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  if (type_inf->expbuf[exp->index] == NULL)
+    {
+      type_inf->expbuf[exp->index] =
+        dmabuf_slice(type_inf->heap, exp->index * buf_size, buf_size);
+      if (type_inf->expbuf[exp->index] == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  fd = dmabuf_export(type_inf->expbuf[exp->index], exp->flags & O_CLOEXEC);
+  if (fd < 0)
+    {
+      return fd;
+    }
+
+  exp->fd = fd;
+  return OK;
+}
+#endif
+
 static int codec_munmap(FAR struct task_group_s *group,
                         FAR struct mm_map_entry_s *entry,
                         FAR void *start, size_t length)
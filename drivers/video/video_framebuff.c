@@ -27,6 +27,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/video/dmabuf.h>
 
 #include "video_framebuff.h"
 
@@ -52,6 +53,20 @@ static void init_buf_chain(video_framebuff_t *fbuf)
     }
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static void release_all(video_framebuff_t *fbuf)
+{
+  int i;
+
+  for (i = 0; i < fbuf->container_size; i++)
+    {
+      video_framebuff_release(&fbuf->vbuf_alloced[i]);
+    }
+}
+#else
+#  define release_all(fbuf)
+#endif
+
 static inline bool is_last_one(video_framebuff_t *fbuf)
 {
   return fbuf->vbuf_top == fbuf->vbuf_tail;
@@ -109,6 +124,10 @@ int video_framebuff_realloc_container(video_framebuff_t *fbuf, int sz)
       return OK;
     }
 
+  /* Drop the shared buffers of the containers being discarded */
+
+  release_all(fbuf);
+
   if (sz > 0)
     {
       vbuf = kmm_realloc(fbuf->vbuf_alloced, sizeof(vbuf_container_t) * sz);
@@ -230,11 +249,22 @@ video_framebuff_get_vacant_container(video_framebuff_t *fbuf)
 
 void video_framebuff_capture_done(video_framebuff_t *fbuf)
 {
+#ifdef CONFIG_VIDEO_DMABUF
+  vbuf_container_t *done = NULL;
+#endif
   irqstate_t flags;
 
   flags = spin_lock_irqsave(&fbuf->lock_queue);
   if (fbuf->vbuf_next != NULL)
     {
+#ifdef CONFIG_VIDEO_DMABUF
+      if (fbuf->vbuf_next->fenced)
+        {
+          done = fbuf->vbuf_next;
+          done->fenced = false;
+        }
+
+#endif
       fbuf->vbuf_next = fbuf->vbuf_next->next;
       if (fbuf->vbuf_next == fbuf->vbuf_top)  /* RING mode case. */
         {
@@ -244,6 +274,15 @@ void video_framebuff_capture_done(video_framebuff_t *fbuf)
     }
 
   spin_unlock_irqrestore(&fbuf->lock_queue, flags);
+
+#ifdef CONFIG_VIDEO_DMABUF
+  /* The frame is complete, let the readers of the buffer in */
+
+  if (done != NULL)
+    {
+      dmabuf_fence_end(done->dmabuf);
+    }
+#endif
 }
 
 void video_framebuff_change_mode(video_framebuff_t  *fbuf,
@@ -287,3 +326,87 @@ vbuf_container_t *video_framebuff_pop_curr_container(video_framebuff_t *fbuf)
   spin_unlock_irqrestore(&fbuf->lock_queue, flags);
   return ret;
 }
+
+#ifdef CONFIG_VIDEO_DMABUF
+int video_framebuff_attach(vbuf_container_t *cnt, struct dmabuf_s *dmabuf,
+                           bool write, bool nonblock)
+{
+  int ret;
+
+  /* Do not read a frame still being written by another device */
+
+  if (!write)
+    {
+      ret = dmabuf_fence_wait(dmabuf, nonblock ? 0 : DMABUF_WAIT_FOREVER);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  dmabuf_get(dmabuf);
+  cnt->dmabuf = dmabuf;
+  cnt->fenced = write;
+  if (write)
+    {
+      dmabuf_fence_begin(dmabuf);
+    }
+
+  return OK;
+}
+
+int video_framebuff_import(vbuf_container_t *cnt, size_t length, bool write,
+                           bool nonblock)
+{
+  struct dmabuf_s *dmabuf;
+  int fd = cnt->buf.m.fd;
+  int ret;
+
+  ret = dmabuf_import(fd, &dmabuf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (dmabuf->size < length)
+    {
+      ret = -EINVAL;
+    }
+  else
+    {
+      ret = video_framebuff_attach(cnt, dmabuf, write, nonblock);
+    }
+
+  if (ret >= 0)
+    {
+      cnt->fd            = fd;
+      cnt->buf.m.userptr = (unsigned long)dmabuf->vaddr;
+      cnt->buf.length    = dmabuf->size;
+    }
+
+  dmabuf_put(dmabuf);
+  return ret;
+}
+
+void video_framebuff_release(vbuf_container_t *cnt)
+{
+  if (cnt->dmabuf == NULL)
+    {
+      return;
+    }
+
+  if (cnt->fenced)
+    {
+      cnt->fenced = false;
+      dmabuf_fence_end(cnt->dmabuf);
+    }
+
+  if (cnt->buf.memory == V4L2_MEMORY_DMABUF)
+    {
+      cnt->buf.m.fd = cnt->fd;
+    }
+
+  dmabuf_put(cnt->dmabuf);
+  cnt->dmabuf = NULL;
+}
+#endif
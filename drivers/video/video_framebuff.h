@@ -29,6 +29,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/spinlock.h>
+#include <nuttx/video/dmabuf.h>
 
 /****************************************************************************
  * Public Types
@@ -38,6 +39,11 @@ struct vbuf_container_s
 {
   struct v4l2_buffer       buf;   /* Buffer information */
   struct vbuf_container_s *next;  /* Pointer to next buffer */
+#ifdef CONFIG_VIDEO_DMABUF
+  FAR struct dmabuf_s     *dmabuf; /* Shared buffer behind buf */
+  int                      fd;     /* Descriptor of a V4L2_MEMORY_DMABUF */
+  bool                     fenced; /* The device is writing dmabuf */
+#endif
 };
 
 typedef struct vbuf_container_s vbuf_container_t;
@@ -88,4 +94,24 @@ void              video_framebuff_capture_done
 void              video_framebuff_change_mode
                        (video_framebuff_t *fbuf, enum v4l2_buf_mode mode);
 
+#ifdef CONFIG_VIDEO_DMABUF
+/* Shared buffer interface.  video_framebuff_attach() makes the container
+ * hold a reference to dmabuf and a fence if the device writes into it, or
+ * waits for the writes into it to complete if the device reads it.
+ * video_framebuff_import() attaches the buffer of the V4L2_MEMORY_DMABUF
+ * descriptor in cnt->buf.m.fd and points cnt->buf.m.userptr at it.
+ * video_framebuff_release() undoes both, ahead of returning cnt->buf to
+ * the user.
+ */
+
+int               video_framebuff_attach
+                       (vbuf_container_t *cnt, struct dmabuf_s *dmabuf,
+                        bool write, bool nonblock);
+int               video_framebuff_import
+                       (vbuf_container_t *cnt, size_t length, bool write,
+                        bool nonblock);
+void              video_framebuff_release
+                       (vbuf_container_t *cnt);
+#endif
+
 #endif  /* __DRIVERS_VIDEO_VIDEO_FRAMEBUFF_H */
@@ -462,6 +462,7 @@ int vnc_raw(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect)
 
           size += SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0));
           src   = session->outbuf;
+          session->nsent += size;
 
           /* At the very last most, make certain that the color format
            * has not changed asynchronously.
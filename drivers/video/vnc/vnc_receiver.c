@@ -291,6 +291,17 @@ int vnc_receiver(FAR struct vnc_session_s *session)
                   rect.w = rfb_getbe16(update->width);
                   rect.h = rfb_getbe16(update->height);
 
+#ifdef CONFIG_VNCSERVER_SHADOW
+                  /* A non-incremental request asks for the whole contents,
+                   * even if the client should already have them.
+                   */
+
+                  if (!update->incremental)
+                    {
+                      session->refresh = true;
+                    }
+#endif
+
                   ret = vnc_update_rectangle(session, &rect, false);
                   if (ret < 0)
                     {
@@ -469,6 +480,12 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
   /* Assume that there are no common encodings (other than RAW) */
 
   session->rre = false;
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  session->copyrect = false;
+#endif
+#ifdef CONFIG_VNCSERVER_ZRLE
+  session->zrle = false;
+#endif
 
   /* Loop for each client supported encoding */
 
@@ -485,6 +502,18 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
         {
           session->rre = true;
         }
+#ifdef CONFIG_VNCSERVER_COPYRECT
+      else if (encoding == RFB_ENCODING_COPYRECT)
+        {
+          session->copyrect = true;
+        }
+#endif
+#ifdef CONFIG_VNCSERVER_ZRLE
+      else if (encoding == RFB_ENCODING_ZRLE)
+        {
+          session->zrle = true;
+        }
+#endif
     }
 
   session->change = true;
@@ -260,6 +260,7 @@ int vnc_rre(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect)
                 }
 
               DEBUGASSERT(nsent == nbytes);
+              session->nsent += nbytes;
               updinfo("Sent {(%d, %d),(%d, %d)}\n",
                       rect->x, rect->y, rect->w, rect->h);
               return nbytes;
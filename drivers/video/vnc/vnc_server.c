@@ -87,7 +87,8 @@ FAR struct vnc_session_s *g_vnc_sessions[RFB_MAX_DISPLAYS];
  ****************************************************************************/
 
 static void vnc_reset_session(FAR struct vnc_session_s *session,
-                              FAR uint8_t *fb, int display)
+                              FAR uint8_t *fb, FAR uint8_t *shadow,
+                              int display)
 {
   int i;
 
@@ -124,6 +125,19 @@ static void vnc_reset_session(FAR struct vnc_session_s *session,
   session->state   = VNCSERVER_INITIALIZED;
   session->nwhupd  = 0;
   session->change  = true;
+  session->nsent   = 0;
+
+#ifdef CONFIG_VNCSERVER_SHADOW
+  /* The new client has nothing yet */
+
+  session->shadow  = shadow;
+  session->refresh = true;
+#endif
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+  session->zstream   = false;
+  session->bandwidth = 0;
+#endif
 
 #ifdef CONFIG_VNCSERVER_TOUCH
   session->touch.maxpoint = 1;
@@ -225,6 +239,7 @@ errout_with_listener:
 int vnc_server(int argc, FAR char *argv[])
 {
   FAR struct vnc_session_s *session;
+  FAR uint8_t *shadow = NULL;
   FAR uint8_t *fb;
   int display;
   int ret;
@@ -269,6 +284,19 @@ int vnc_server(int argc, FAR char *argv[])
       goto errout_with_post;
     }
 
+#ifdef CONFIG_VNCSERVER_SHADOW
+  /* Allocate the shadow copy of what the client has displayed */
+
+  shadow = kmm_zalloc(RFB_SIZE);
+  if (shadow == NULL)
+    {
+      gerr("ERROR: Failed to allocate shadow framebuffer: %lu KB\n",
+           (unsigned long)(RFB_SIZE / 1024));
+      ret = -ENOMEM;
+      goto errout_with_fb;
+    }
+#endif
+
   /* Allocate a session structure for this display */
 
   session = kmm_zalloc(sizeof(struct vnc_session_s));
@@ -276,7 +304,7 @@ int vnc_server(int argc, FAR char *argv[])
     {
       gerr("ERROR: Failed to allocate session\n");
       ret = -ENOMEM;
-      goto errout_with_fb;
+      goto errout_with_shadow;
     }
 
   g_vnc_sessions[display] = session;
@@ -289,7 +317,7 @@ int vnc_server(int argc, FAR char *argv[])
 
   /* Inform any waiter that we have started */
 
-  vnc_reset_session(session, fb, display);
+  vnc_reset_session(session, fb, shadow, display);
   nxsem_post(&g_fbstartup[display].fbinit);
 
   /* Loop... handling each each VNC client connection to this display.  Only
@@ -302,7 +330,7 @@ int vnc_server(int argc, FAR char *argv[])
        * for the next connection.
        */
 
-      vnc_reset_session(session, fb, display);
+      vnc_reset_session(session, fb, shadow, display);
       g_fbstartup[display].result = -EBUSY;
 
       /* Establish a connection with the VNC client */
@@ -362,7 +390,12 @@ int vnc_server(int argc, FAR char *argv[])
         }
     }
 
+errout_with_shadow:
+  kmm_free(shadow);
+
+#ifdef CONFIG_VNCSERVER_SHADOW
 errout_with_fb:
+#endif
   kmm_free(fb);
 
 errout_with_post:
@@ -138,6 +138,14 @@
 #define VNCSERVER_UPDATE_BUFSIZE \
   (CONFIG_VNCSERVER_UPDATE_BUFSIZE + SIZEOF_RFB_FRAMEBUFFERUPDATE_S(0))
 
+#ifndef CONFIG_VNCSERVER_TILESIZE
+#  define CONFIG_VNCSERVER_TILESIZE 16
+#endif
+
+#ifndef CONFIG_VNCSERVER_ZRLE_MAXRATE
+#  define CONFIG_VNCSERVER_ZRLE_MAXRATE 0
+#endif
+
 /* Local framebuffer characteristics in bytes */
 
 #define RFB_BYTESPERPIXEL   ((RFB_BITSPERPIXEL + 7) >> 3)
@@ -207,7 +215,20 @@ struct vnc_session_s
   volatile uint8_t bpp;        /* Remote bits per pixel */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+#ifdef CONFIG_VNCSERVER_COPYRECT
+  volatile bool copyrect;      /* True: Remote supports CopyRect encoding */
+#endif
+#ifdef CONFIG_VNCSERVER_ZRLE
+  volatile bool zrle;          /* True: Remote supports ZRLE encoding */
+  bool zstream;                /* True: The ZRLE zlib stream is started */
+  uint32_t bandwidth;          /* Measured send rate in bytes per second */
+#endif
   FAR uint8_t *fb;             /* Allocated local frame buffer */
+#ifdef CONFIG_VNCSERVER_SHADOW
+  FAR uint8_t *shadow;         /* The frame buffer as the client has it */
+  volatile bool refresh;       /* True: Send updates without comparing */
+#endif
+  size_t nsent;                /* Bytes of updates sent to the client */
 
   /* VNC client input support */
 
@@ -484,6 +505,93 @@ int vnc_rre(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect);
 
 int vnc_raw(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect);
 
+/****************************************************************************
+ * Name: vnc_zrle
+ *
+ * Description:
+ *  Send the framebuffer update using the ZRLE encoding.  Each tile is
+ *  sent as solid, packed palette, RLE, palette RLE or raw, whichever is
+ *  smallest.  The zlib stream carries the tiles in stored blocks.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value is returned on failure that
+ *   indicates the nature of the failure.  A failure is only returned
+ *   in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+int vnc_zrle(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect);
+#endif
+
+/****************************************************************************
+ * Name: vnc_shadow_changed
+ *
+ * Description:
+ *  Compare a rectangle of the local framebuffer with the shadow copy of
+ *  the client framebuffer.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   True if any pixel in the rectangle differs from the shadow copy.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_SHADOW
+bool vnc_shadow_changed(FAR struct vnc_session_s *session,
+                        FAR const struct fb_area_s *rect);
+
+/****************************************************************************
+ * Name: vnc_shadow_sync
+ *
+ * Description:
+ *  Copy a rectangle of the local framebuffer to the shadow copy.  This is
+ *  done before the rectangle is encoded.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vnc_shadow_sync(FAR struct vnc_session_s *session,
+                     FAR const struct fb_area_s *rect);
+#endif
+
+/****************************************************************************
+ * Name: vnc_copyrect
+ *
+ * Description:
+ *  Check if the contents of the rectangle have been scrolled vertically
+ *  since the client was updated.  If so, send a CopyRect update for the
+ *  moved part and apply the same copy to the shadow framebuffer, so that
+ *  only the newly exposed part is left to be encoded.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   One if a CopyRect update was sent, zero if no scroll was found.  A
+ *   negated errno value is returned on a network failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_COPYRECT
+int vnc_copyrect(FAR struct vnc_session_s *session,
+                 FAR const struct fb_area_s *rect);
+#endif
+
 /****************************************************************************
  * Name: vnc_key_map
  *
@@ -0,0 +1,322 @@
+/****************************************************************************
+ * drivers/video/vnc/vnc_shadow.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Address of a pixel in the local or the shadow framebuffer */
+
+#define VNC_PIXEL(b,x,y) \
+  ((b) + RFB_STRIDE * (y) + RFB_BYTESPERPIXEL * (x))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_rows_equal
+ *
+ * Description:
+ *   Compare rows of the local framebuffer with rows of the shadow
+ *   framebuffer dy rows below them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_COPYRECT
+static bool vnc_rows_equal(FAR struct vnc_session_s *session,
+                           FAR const struct fb_area_s *rect,
+                           fb_coord_t y, fb_coord_t nrows, int dy)
+{
+  size_t width = RFB_BYTESPERPIXEL * rect->w;
+
+  for (; nrows > 0; nrows--, y++)
+    {
+      if (memcmp(VNC_PIXEL(session->fb, rect->x, y),
+                 VNC_PIXEL(session->shadow, rect->x, y + dy), width) != 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: vnc_send_copyrect
+ *
+ * Description:
+ *   Send a CopyRect update.
+ *
+ ****************************************************************************/
+
+static int vnc_send_copyrect(FAR struct vnc_session_s *session,
+                             FAR const struct fb_area_s *dest,
+                             fb_coord_t srcx, fb_coord_t srcy)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  FAR struct rfb_copyrect_encoding_s *copyrect;
+  FAR const uint8_t *src;
+  size_t size;
+  ssize_t nsent;
+
+  update   = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+  copyrect = (FAR struct rfb_copyrect_encoding_s *)update->rect[0].data;
+
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect, 1);
+
+  rfb_putbe16(update->rect[0].xpos, dest->x);
+  rfb_putbe16(update->rect[0].ypos, dest->y);
+  rfb_putbe16(update->rect[0].width, dest->w);
+  rfb_putbe16(update->rect[0].height, dest->h);
+  rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_COPYRECT);
+
+  rfb_putbe16(copyrect->xpos, srcx);
+  rfb_putbe16(copyrect->ypos, srcy);
+
+  src  = session->outbuf;
+  size = SIZEOF_RFB_FRAMEBUFFERUPDATE_S(
+           SIZEOF_RFB_RECTANGE_S(sizeof(struct rfb_copyrect_encoding_s)));
+  session->nsent += size;
+
+  do
+    {
+      nsent = psock_send(&session->connect, src, size, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send CopyRect FrameBufferUpdate failed: %d\n",
+               (int)nsent);
+          return (int)nsent;
+        }
+
+      DEBUGASSERT(nsent <= size);
+      src  += nsent;
+      size -= nsent;
+    }
+  while (size > 0);
+
+  updinfo("Copied {(%d, %d),(%d, %d)} from (%d, %d)\n",
+          dest->x, dest->y, dest->w, dest->h, srcx, srcy);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_shadow_changed
+ *
+ * Description:
+ *  Compare a rectangle of the local framebuffer with the shadow copy of
+ *  the client framebuffer.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   True if any pixel in the rectangle differs from the shadow copy.
+ *
+ ****************************************************************************/
+
+bool vnc_shadow_changed(FAR struct vnc_session_s *session,
+                        FAR const struct fb_area_s *rect)
+{
+  size_t width = RFB_BYTESPERPIXEL * rect->w;
+  fb_coord_t y;
+
+  for (y = rect->y; y < rect->y + rect->h; y++)
+    {
+      if (memcmp(VNC_PIXEL(session->fb, rect->x, y),
+                 VNC_PIXEL(session->shadow, rect->x, y), width) != 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: vnc_shadow_sync
+ *
+ * Description:
+ *  Copy a rectangle of the local framebuffer to the shadow copy.  This is
+ *  done before the rectangle is encoded.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vnc_shadow_sync(FAR struct vnc_session_s *session,
+                     FAR const struct fb_area_s *rect)
+{
+  size_t width = RFB_BYTESPERPIXEL * rect->w;
+  fb_coord_t y;
+
+  for (y = rect->y; y < rect->y + rect->h; y++)
+    {
+      memcpy(VNC_PIXEL(session->shadow, rect->x, y),
+             VNC_PIXEL(session->fb, rect->x, y), width);
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_copyrect
+ *
+ * Description:
+ *  Check if the contents of the rectangle have been scrolled vertically
+ *  since the client was updated.  If so, send a CopyRect update for the
+ *  moved part and apply the same copy to the shadow framebuffer, so that
+ *  only the newly exposed part is left to be encoded.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   One if a CopyRect update was sent, zero if no scroll was found.  A
+ *   negated errno value is returned on a network failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_COPYRECT
+int vnc_copyrect(FAR struct vnc_session_s *session,
+                 FAR const struct fb_area_s *rect)
+{
+  struct fb_area_s dest;
+  fb_coord_t probe;
+  fb_coord_t y;
+  int maxdy;
+  int dy;
+  int ret;
+
+  /* Only worth it for areas of a few tiles.  A scroll by dy is accepted
+   * only if at least half of the rows moved.
+   */
+
+  if (rect->w < CONFIG_VNCSERVER_TILESIZE ||
+      rect->h < 2 * CONFIG_VNCSERVER_TILESIZE)
+    {
+      return 0;
+    }
+
+  /* The middle row is part of the moved area for any accepted dy.  It
+   * must have changed, otherwise there is nothing to look for.
+   */
+
+  probe = rect->y + rect->h / 2;
+  if (vnc_rows_equal(session, rect, probe, 1, 0))
+    {
+      return 0;
+    }
+
+  maxdy = rect->h / 2;
+  for (dy = -maxdy; dy <= maxdy; dy++)
+    {
+      /* The new row y shows what the client has at row y + dy */
+
+      if (dy == 0 || !vnc_rows_equal(session, rect, probe, 1, dy))
+        {
+          continue;
+        }
+
+      dest.x = rect->x;
+      dest.w = rect->w;
+      dest.y = dy > 0 ? rect->y : rect->y - dy;
+      dest.h = rect->h - (dy > 0 ? dy : -dy);
+
+      if (!vnc_rows_equal(session, &dest, dest.y, dest.h, dy))
+        {
+          continue;
+        }
+
+      ret = vnc_send_copyrect(session, &dest, dest.x, dest.y + dy);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* The client now has the moved rows, do the same in the shadow */
+
+      if (dy > 0)
+        {
+          for (y = dest.y; y < dest.y + dest.h; y++)
+            {
+              memcpy(VNC_PIXEL(session->shadow, dest.x, y),
+                     VNC_PIXEL(session->shadow, dest.x, y + dy),
+                     RFB_BYTESPERPIXEL * dest.w);
+            }
+        }
+      else
+        {
+          for (y = dest.y + dest.h; y-- > dest.y; )
+            {
+              memcpy(VNC_PIXEL(session->shadow, dest.x, y),
+                     VNC_PIXEL(session->shadow, dest.x, y + dy),
+                     RFB_BYTESPERPIXEL * dest.w);
+            }
+        }
+
+      return 1;
+    }
+
+  return 0;
+}
+#endif
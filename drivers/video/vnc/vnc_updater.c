@@ -24,8 +24,11 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
+#include <inttypes.h>
 #include <string.h>
 #include <sched.h>
+#include <nuttx/clock.h>
 #include <nuttx/irq.h>
 #include <pthread.h>
 #include <assert.h>
@@ -343,6 +346,208 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
   DEBUGASSERT(session->queuesem.semcount <= CONFIG_VNCSERVER_NUPDATES);
 }
 
+/****************************************************************************
+ * Name: vnc_encode
+ *
+ * Description:
+ *  Send one rectangle with the best encoding for the client.  ZRLE is used
+ *  while the measured bandwidth is below CONFIG_VNCSERVER_ZRLE_MAXRATE,
+ *  otherwise the cheaper RRE/RAW encodings are used.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle to be sent.
+ *
+ * Returned Value:
+ *   A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_encode(FAR struct vnc_session_s *session,
+                      FAR struct fb_area_s *rect)
+{
+  int ret;
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+  if (session->zrle &&
+      (CONFIG_VNCSERVER_ZRLE_MAXRATE == 0 ||
+       session->bandwidth < CONFIG_VNCSERVER_ZRLE_MAXRATE * 1024))
+    {
+      return vnc_zrle(session, rect);
+    }
+#endif
+
+  /* Attempt to use RRE encoding */
+
+  ret = vnc_rre(session, rect);
+  if (ret == 0)
+    {
+      /* Perform the framebuffer update using the default RAW encoding */
+
+      ret = vnc_raw(session, rect);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: vnc_update_tiles
+ *
+ * Description:
+ *  Compare the rectangle tile by tile with the shadow framebuffer and send
+ *  only the tiles that changed.  Adjacent changed tiles in a row of tiles
+ *  are sent as one rectangle.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle to be updated.
+ *
+ * Returned Value:
+ *   A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_SHADOW
+static int vnc_update_tiles(FAR struct vnc_session_s *session,
+                            FAR const struct fb_area_s *rect)
+{
+  struct fb_area_s tile;
+  struct fb_area_s run;
+  fb_coord_t xend = rect->x + rect->w;
+  fb_coord_t yend = rect->y + rect->h;
+  int ret;
+
+  for (tile.y = rect->y; tile.y < yend; tile.y += tile.h)
+    {
+      tile.h = MIN(CONFIG_VNCSERVER_TILESIZE, yend - tile.y);
+      run.y  = tile.y;
+      run.h  = tile.h;
+      run.w  = 0;
+
+      for (tile.x = rect->x; tile.x <= xend; tile.x += tile.w)
+        {
+          tile.w = MIN(CONFIG_VNCSERVER_TILESIZE, xend - tile.x);
+
+          /* Extend the run with a changed tile.  Otherwise, or at the end
+           * of the row, send the run collected so far.
+           */
+
+          if (tile.w > 0 && vnc_shadow_changed(session, &tile))
+            {
+              if (run.w == 0)
+                {
+                  run.x = tile.x;
+                }
+
+              run.w += tile.w;
+              continue;
+            }
+
+          if (run.w > 0)
+            {
+              vnc_shadow_sync(session, &run);
+              ret = vnc_encode(session, &run);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              run.w = 0;
+            }
+
+          if (tile.w == 0)
+            {
+              break;
+            }
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: vnc_send_update
+ *
+ * Description:
+ *  Send one dequeued update.  With the shadow framebuffer, only what the
+ *  client does not already have is sent: scrolled content is moved with
+ *  CopyRect and unchanged tiles are skipped.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   update  - The dequeued update.
+ *
+ * Returned Value:
+ *   A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_send_update(FAR struct vnc_session_s *session,
+                           FAR struct vnc_fbupdate_s *update)
+{
+#ifdef CONFIG_VNCSERVER_ZRLE
+  clock_t start = clock_systime_ticks();
+  clock_t elapsed;
+  size_t nsent = session->nsent;
+  uint32_t rate;
+#endif
+  int ret;
+
+#ifdef CONFIG_VNCSERVER_SHADOW
+  if (session->refresh)
+    {
+      /* The client asked for everything, send without comparing */
+
+      if (update->whupd)
+        {
+          session->refresh = false;
+        }
+
+      vnc_shadow_sync(session, &update->rect);
+      ret = vnc_encode(session, &update->rect);
+    }
+  else
+    {
+      ret = 0;
+#ifdef CONFIG_VNCSERVER_COPYRECT
+      if (session->copyrect)
+        {
+          ret = vnc_copyrect(session, &update->rect);
+        }
+#endif
+
+      if (ret >= 0)
+        {
+          ret = vnc_update_tiles(session, &update->rect);
+        }
+    }
+#else
+  ret = vnc_encode(session, &update->rect);
+#endif
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+  /* Measure the send rate of large updates, which are limited by the
+   * network rather than by the encoder.
+   */
+
+  nsent   = session->nsent - nsent;
+  elapsed = clock_systime_ticks() - start;
+  if (ret >= 0 && nsent >= CONFIG_VNCSERVER_UPDATE_BUFSIZE * 4)
+    {
+      rate = (uint32_t)MIN((uint64_t)nsent * TICK_PER_SEC /
+                           MAX(elapsed, 1), UINT32_MAX);
+      session->bandwidth = session->bandwidth == 0 ? rate :
+                           session->bandwidth - session->bandwidth / 4 +
+                           rate / 4;
+      updinfo("Sent %zu bytes in %lu ticks, bandwidth %" PRIu32 "\n",
+              nsent, (unsigned long)elapsed, session->bandwidth);
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: vnc_updater
  *
@@ -400,15 +605,7 @@ static FAR void *vnc_updater(FAR void *arg)
               srcrect->rect.x, srcrect->rect.y,
               srcrect->rect.w, srcrect->rect.h);
 
-      /* Attempt to use RRE encoding */
-
-      ret = vnc_rre(session, &srcrect->rect);
-      if (ret == 0)
-        {
-          /* Perform the framebuffer update using the default RAW encoding */
-
-          ret = vnc_raw(session, &srcrect->rect);
-        }
+      ret = vnc_send_update(session, srcrect);
 
       /* Release the update structure */
 
@@ -0,0 +1,690 @@
+/****************************************************************************
+ * drivers/video/vnc/vnc_zrle.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* ZRLE tiles are at most 64x64 pixels */
+
+#define ZRLE_TILESIZE       64
+
+/* The largest palette kept while analyzing a tile.  Bigger palettes only
+ * pay off for palette RLE with very long runs.
+ */
+
+#define ZRLE_MAXPALETTE     16
+
+/* The tile data is rendered at a fixed offset in the update buffer,
+ * behind the FramebufferUpdate and rectangle headers, the ZRLE length,
+ * the zlib stream header (only sent once per connection) and the header
+ * of a stored deflate block.  The headers are then filled in backwards.
+ */
+
+#define ZRLE_HDRSIZE \
+  SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0))
+#define ZRLE_ZHDRSIZE       2
+#define ZRLE_BLKHDRSIZE     5
+#define ZRLE_DATAOFFSET     (ZRLE_HDRSIZE + 4 + ZRLE_ZHDRSIZE + \
+                             ZRLE_BLKHDRSIZE)
+
+/* A stored deflate block holds at most 65535 bytes */
+
+#define ZRLE_MAXDATA        65535
+
+/* Number of bytes used to encode a run length */
+
+#define ZRLE_RUNBYTES(n)    (((n) - 1) / 255 + 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one ZRLE update */
+
+struct vnc_zrle_s
+{
+  FAR struct vnc_session_s *session;
+
+  union
+  {
+    vnc_convert8_t bpp8;
+    vnc_convert16_t bpp16;
+    vnc_convert32_t bpp32;
+  } convert;
+
+  uint8_t bytesperpixel;     /* Bytes per client pixel */
+  uint8_t cpsize;            /* Bytes per CPIXEL */
+  bool bigendian;            /* True: Client pixels are big-endian */
+
+  /* Tile analysis results */
+
+  uint32_t palette[ZRLE_MAXPALETTE];
+  unsigned int npalette;     /* > ZRLE_MAXPALETTE if too many colors */
+  size_t rlesize;            /* Size of the plain RLE runs */
+  size_t palrlesize;         /* Size of the palette RLE runs */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_zrle_pixel
+ *
+ * Description:
+ *   Get one pixel from the local framebuffer in the client color format.
+ *
+ ****************************************************************************/
+
+static uint32_t vnc_zrle_pixel(FAR struct vnc_zrle_s *zrle,
+                               fb_coord_t x, fb_coord_t y)
+{
+  FAR const lfb_color_t *src = (FAR const lfb_color_t *)
+    (zrle->session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * x);
+
+  if (zrle->bytesperpixel == 1)
+    {
+      return zrle->convert.bpp8(*src);
+    }
+  else if (zrle->bytesperpixel == 2)
+    {
+      return zrle->convert.bpp16(*src);
+    }
+  else
+    {
+      return zrle->convert.bpp32(*src);
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_putcpixel
+ *
+ * Description:
+ *   Put one CPIXEL to the update buffer.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *vnc_zrle_putcpixel(FAR struct vnc_zrle_s *zrle,
+                                       FAR uint8_t *dest, uint32_t pixel)
+{
+  switch (zrle->cpsize)
+    {
+      case 1:
+        *dest = (uint8_t)pixel;
+        break;
+
+      case 2:
+        if (zrle->bigendian)
+          {
+            rfb_putbe16(dest, (uint16_t)pixel);
+          }
+        else
+          {
+            rfb_putle16(dest, (uint16_t)pixel);
+          }
+        break;
+
+      case 3:
+
+        /* The three least significant bytes of the pixel */
+
+        if (zrle->bigendian)
+          {
+            dest[0] = (uint8_t)(pixel >> 16);
+            dest[1] = (uint8_t)(pixel >> 8);
+            dest[2] = (uint8_t)pixel;
+          }
+        else
+          {
+            dest[0] = (uint8_t)pixel;
+            dest[1] = (uint8_t)(pixel >> 8);
+            dest[2] = (uint8_t)(pixel >> 16);
+          }
+        break;
+
+      default:
+        if (zrle->bigendian)
+          {
+            rfb_putbe32(dest, pixel);
+          }
+        else
+          {
+            rfb_putle32(dest, pixel);
+          }
+        break;
+    }
+
+  return dest + zrle->cpsize;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_putrun
+ *
+ * Description:
+ *   Put a run length to the update buffer.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *vnc_zrle_putrun(FAR uint8_t *dest, size_t run)
+{
+  for (run--; run >= 255; run -= 255)
+    {
+      *dest++ = 255;
+    }
+
+  *dest++ = (uint8_t)run;
+  return dest;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_index
+ *
+ * Description:
+ *   Return the palette index of a pixel.
+ *
+ ****************************************************************************/
+
+static unsigned int vnc_zrle_index(FAR struct vnc_zrle_s *zrle,
+                                   uint32_t pixel)
+{
+  unsigned int i;
+
+  for (i = 0; i < zrle->npalette && zrle->palette[i] != pixel; i++)
+    {
+    }
+
+  return i;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_putrle
+ *
+ * Description:
+ *   Put one run of the plain or palette RLE sub-encodings.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *vnc_zrle_putrle(FAR struct vnc_zrle_s *zrle,
+                                    FAR uint8_t *dest, uint8_t subencoding,
+                                    uint32_t pixel, size_t run)
+{
+  if (subencoding == RFB_SUBENCODING_RLE)
+    {
+      dest = vnc_zrle_putcpixel(zrle, dest, pixel);
+      return vnc_zrle_putrun(dest, run);
+    }
+
+  /* A palette index, with the top bit set if a run length follows */
+
+  if (run == 1)
+    {
+      *dest++ = vnc_zrle_index(zrle, pixel);
+      return dest;
+    }
+
+  *dest++ = vnc_zrle_index(zrle, pixel) | 0x80;
+  return vnc_zrle_putrun(dest, run);
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_addrun
+ *
+ * Description:
+ *   Account a completed run in the sizes of the RLE sub-encodings.
+ *
+ ****************************************************************************/
+
+static void vnc_zrle_addrun(FAR struct vnc_zrle_s *zrle, size_t run)
+{
+  zrle->rlesize += zrle->cpsize + ZRLE_RUNBYTES(run);
+  zrle->palrlesize += run > 1 ? 1 + ZRLE_RUNBYTES(run) : 1;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_analyze
+ *
+ * Description:
+ *   Collect the palette and the run lengths of a tile.
+ *
+ ****************************************************************************/
+
+static void vnc_zrle_analyze(FAR struct vnc_zrle_s *zrle,
+                             fb_coord_t x0, fb_coord_t y0,
+                             fb_coord_t w, fb_coord_t h)
+{
+  uint32_t prev = 0;
+  uint32_t pixel;
+  size_t run = 0;
+  fb_coord_t x;
+  fb_coord_t y;
+
+  zrle->npalette   = 0;
+  zrle->rlesize    = 0;
+  zrle->palrlesize = 0;
+
+  for (y = y0; y < y0 + h; y++)
+    {
+      for (x = x0; x < x0 + w; x++)
+        {
+          pixel = vnc_zrle_pixel(zrle, x, y);
+
+          /* Runs may continue from one row to the next */
+
+          if (run > 0 && pixel == prev)
+            {
+              run++;
+              continue;
+            }
+
+          if (run > 0)
+            {
+              vnc_zrle_addrun(zrle, run);
+            }
+
+          prev = pixel;
+          run  = 1;
+
+          if (zrle->npalette <= ZRLE_MAXPALETTE &&
+              vnc_zrle_index(zrle, pixel) == zrle->npalette)
+            {
+              if (zrle->npalette < ZRLE_MAXPALETTE)
+                {
+                  zrle->palette[zrle->npalette] = pixel;
+                }
+
+              zrle->npalette++;
+            }
+        }
+    }
+
+  vnc_zrle_addrun(zrle, run);
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_tile
+ *
+ * Description:
+ *   Encode one tile with the smallest sub-encoding.
+ *
+ * Returned Value:
+ *   The size of the encoded tile in bytes.
+ *
+ ****************************************************************************/
+
+static size_t vnc_zrle_tile(FAR struct vnc_zrle_s *zrle,
+                            fb_coord_t x0, fb_coord_t y0,
+                            fb_coord_t w, fb_coord_t h,
+                            FAR uint8_t *dest)
+{
+  FAR uint8_t *start = dest;
+  uint8_t subencoding;
+  size_t packedsize = SIZE_MAX;
+  size_t palrlesize = SIZE_MAX;
+  size_t size;
+  unsigned int bits = 0;
+  unsigned int i;
+  uint32_t prev = 0;
+  uint32_t pixel;
+  size_t run = 0;
+  fb_coord_t x;
+  fb_coord_t y;
+
+  vnc_zrle_analyze(zrle, x0, y0, w, h);
+
+  if (zrle->npalette == 1)
+    {
+      *dest++ = RFB_SUBENCODING_SOLID;
+      dest = vnc_zrle_putcpixel(zrle, dest, zrle->palette[0]);
+      return dest - start;
+    }
+
+  /* Pick the smallest sub-encoding */
+
+  if (zrle->npalette <= ZRLE_MAXPALETTE)
+    {
+      bits = zrle->npalette == 2 ? 1 : zrle->npalette <= 4 ? 2 : 4;
+      packedsize = zrle->npalette * zrle->cpsize +
+                   h * ((w * bits + 7) >> 3);
+      palrlesize = zrle->npalette * zrle->cpsize + zrle->palrlesize;
+    }
+
+  subencoding = RFB_SUBENCODING_RAW;
+  size = (size_t)w * h * zrle->cpsize;
+
+  if (zrle->rlesize < size)
+    {
+      subencoding = RFB_SUBENCODING_RLE;
+      size = zrle->rlesize;
+    }
+
+  if (packedsize < size)
+    {
+      subencoding = zrle->npalette;
+      size = packedsize;
+    }
+
+  if (palrlesize < size)
+    {
+      subencoding = RFB_SUBENCODING_PALRLE - 1 + zrle->npalette;
+      size = palrlesize;
+    }
+
+  *dest++ = subencoding;
+
+  if (subencoding == RFB_SUBENCODING_RAW)
+    {
+      for (y = y0; y < y0 + h; y++)
+        {
+          for (x = x0; x < x0 + w; x++)
+            {
+              dest = vnc_zrle_putcpixel(zrle, dest,
+                                        vnc_zrle_pixel(zrle, x, y));
+            }
+        }
+
+      return dest - start;
+    }
+
+  if (subencoding != RFB_SUBENCODING_RLE)
+    {
+      for (i = 0; i < zrle->npalette; i++)
+        {
+          dest = vnc_zrle_putcpixel(zrle, dest, zrle->palette[i]);
+        }
+    }
+
+  if (subencoding < RFB_SUBENCODING_RLE)
+    {
+      /* Packed palette, each row starts at a byte boundary */
+
+      for (y = y0; y < y0 + h; y++)
+        {
+          unsigned int shift = 8;
+
+          *dest = 0;
+          for (x = x0; x < x0 + w; x++)
+            {
+              if (shift == 0)
+                {
+                  *++dest = 0;
+                  shift = 8;
+                }
+
+              shift -= bits;
+              *dest |= vnc_zrle_index(zrle, vnc_zrle_pixel(zrle, x, y)) <<
+                       shift;
+            }
+
+          dest++;
+        }
+
+      return dest - start;
+    }
+
+  /* Plain or palette RLE, runs continue from one row to the next */
+
+  for (y = y0; y < y0 + h; y++)
+    {
+      for (x = x0; x < x0 + w; x++)
+        {
+          pixel = vnc_zrle_pixel(zrle, x, y);
+          if (run > 0 && pixel == prev)
+            {
+              run++;
+              continue;
+            }
+
+          if (run > 0)
+            {
+              dest = vnc_zrle_putrle(zrle, dest, subencoding, prev, run);
+            }
+
+          prev = pixel;
+          run  = 1;
+        }
+    }
+
+  dest = vnc_zrle_putrle(zrle, dest, subencoding, prev, run);
+  return dest - start;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_send
+ *
+ * Description:
+ *   Wrap the encoded tile in a stored deflate block and send it as one
+ *   ZRLE rectangle.
+ *
+ ****************************************************************************/
+
+static int vnc_zrle_send(FAR struct vnc_session_s *session,
+                         fb_coord_t x, fb_coord_t y,
+                         fb_coord_t w, fb_coord_t h, size_t size)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  FAR uint8_t *hdr = session->outbuf + ZRLE_DATAOFFSET;
+  FAR const uint8_t *src;
+  size_t zlen = size + ZRLE_BLKHDRSIZE;
+  ssize_t nsent;
+
+  /* A stored block which is not the final block of the stream */
+
+  hdr -= ZRLE_BLKHDRSIZE;
+  hdr[0] = 0;
+  rfb_putle16(&hdr[1], (uint16_t)size);
+  rfb_putle16(&hdr[3], (uint16_t)~size);
+
+  /* The zlib header starts the stream, which is then never finished */
+
+  if (!session->zstream)
+    {
+      hdr -= ZRLE_ZHDRSIZE;
+      hdr[0] = 0x78;
+      hdr[1] = 0x01;
+      zlen += ZRLE_ZHDRSIZE;
+      session->zstream = true;
+    }
+
+  hdr -= 4;
+  rfb_putbe32(hdr, zlen);
+
+  update = (FAR struct rfb_framebufferupdate_s *)(hdr - ZRLE_HDRSIZE);
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect, 1);
+
+  rfb_putbe16(update->rect[0].xpos, x);
+  rfb_putbe16(update->rect[0].ypos, y);
+  rfb_putbe16(update->rect[0].width, w);
+  rfb_putbe16(update->rect[0].height, h);
+  rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_ZRLE);
+
+  src  = (FAR const uint8_t *)update;
+  size = ZRLE_HDRSIZE + 4 + zlen;
+  session->nsent += size;
+
+  do
+    {
+      nsent = psock_send(&session->connect, src, size, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send ZRLE FrameBufferUpdate failed: %d\n",
+               (int)nsent);
+          return (int)nsent;
+        }
+
+      DEBUGASSERT(nsent <= size);
+      src  += nsent;
+      size -= nsent;
+    }
+  while (size > 0);
+
+  updinfo("Sent {(%d, %d),(%d, %d)}\n", x, y, x + w - 1, y + h - 1);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_zrle
+ *
+ * Description:
+ *  Send the framebuffer update using the ZRLE encoding.  Each tile is
+ *  sent as solid, packed palette, RLE, palette RLE or raw, whichever is
+ *  smallest.  The zlib stream carries the tiles in stored blocks.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value is returned on failure that
+ *   indicates the nature of the failure.  A failure is only returned
+ *   in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_zrle(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect)
+{
+  struct vnc_zrle_s zrle;
+  fb_coord_t tilew;
+  fb_coord_t tileh;
+  fb_coord_t updw;
+  fb_coord_t updh;
+  fb_coord_t x;
+  fb_coord_t y;
+  size_t maxdata;
+  size_t size;
+  uint8_t colorfmt;
+  int ret;
+
+  zrle.session       = session;
+  zrle.bytesperpixel = (session->bpp + 7) >> 3;
+  zrle.cpsize        = zrle.bytesperpixel;
+  zrle.bigendian     = session->bigendian;
+
+  colorfmt = session->colorfmt;
+  switch (colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+        zrle.convert.bpp8 = vnc_convert_rgb8_222;
+        break;
+
+      case FB_FMT_RGB8_332:
+        zrle.convert.bpp8 = vnc_convert_rgb8_332;
+        break;
+
+      case FB_FMT_RGB16_555:
+        zrle.convert.bpp16 = vnc_convert_rgb16_555;
+        break;
+
+      case FB_FMT_RGB16_565:
+        zrle.convert.bpp16 = vnc_convert_rgb16_565;
+        break;
+
+      case FB_FMT_RGB32:
+
+        /* Depth 24 fits in the three least significant bytes */
+
+        zrle.convert.bpp32 = vnc_convert_rgb32_888;
+        zrle.cpsize = 3;
+        break;
+
+      default:
+        gerr("ERROR: Unrecognized color format: %d\n", session->colorfmt);
+        return -EINVAL;
+    }
+
+  /* Size the rectangles so that even a raw tile fits in the update buffer.
+   * Each rectangle then holds a single tile.
+   */
+
+  maxdata = sizeof(session->outbuf) - ZRLE_DATAOFFSET;
+  if (maxdata > ZRLE_MAXDATA)
+    {
+      maxdata = ZRLE_MAXDATA;
+    }
+
+  tilew = MIN(rect->w, ZRLE_TILESIZE);
+  tilew = MIN(tilew, (maxdata - 1) / zrle.cpsize);
+  tileh = MIN(ZRLE_TILESIZE, (maxdata - 1) / (tilew * zrle.cpsize));
+  DEBUGASSERT(tilew > 0 && tileh > 0);
+
+  for (y = rect->y; y < rect->y + rect->h; y += updh)
+    {
+      updh = MIN(tileh, rect->y + rect->h - y);
+      for (x = rect->x; x < rect->x + rect->w; x += updw)
+        {
+          updw = MIN(tilew, rect->x + rect->w - x);
+
+          /* Stop if the color format changes asynchronously */
+
+          if (colorfmt != session->colorfmt)
+            {
+              return OK;
+            }
+
+          size = vnc_zrle_tile(&zrle, x, y, updw, updh,
+                               session->outbuf + ZRLE_DATAOFFSET);
+          DEBUGASSERT(size <= maxdata);
+
+          ret = vnc_zrle_send(session, x, y, updw, updh, size);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
@@ -22,13 +22,17 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
+
 #include <debug.h>
 #include <errno.h>
 #include <stdio.h>
 
+#include <nuttx/fs/blkqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mutex.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/virtio/virtio.h>
 
@@ -40,12 +44,22 @@
 
 #define VIRTIO_BLK_REQ_HEADER_SIZE  sizeof(struct virtio_blk_req_s)
 #define VIRTIO_BLK_RESP_HEADER_SIZE sizeof(struct virtio_blk_resp_s)
+#define VIRTIO_BLK_RANGE_SIZE       sizeof(struct virtio_blk_range_s)
+
+/* Block feature bits */
+
+#define VIRTIO_BLK_F_SEG_MAX        2
+#define VIRTIO_BLK_F_MQ             12
+#define VIRTIO_BLK_F_DISCARD        13
+#define VIRTIO_BLK_F_WRITE_ZEROES   14
 
 /* Block request type */
 
 #define VIRTIO_BLK_T_IN             0  /* READ */
 #define VIRTIO_BLK_T_OUT            1  /* WRITE */
 #define VIRTIO_BLK_T_FLUSH          4  /* FLUSH */
+#define VIRTIO_BLK_T_DISCARD        11 /* DISCARD */
+#define VIRTIO_BLK_T_WRITE_ZEROES   13 /* WRITE ZEROES */
 
 /* Block request return status */
 
@@ -57,6 +71,18 @@
 
 #define VIRTIO_BLK_SECTOR_SIZE      512
 
+/* Largest merged request of the block request queue */
+
+#define VIRTIO_BLK_MAX_SECTORS      256
+
+/* With the request queue, each CPU dispatches to its own virtqueue */
+
+#if defined(CONFIG_FS_BLKQUEUE) && defined(CONFIG_SMP)
+#  define VIRTIO_BLK_MAX_VQS        CONFIG_SMP_NCPUS
+#else
+#  define VIRTIO_BLK_MAX_VQS        1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -70,6 +96,15 @@ begin_packed_struct struct virtio_blk_req_s
   uint64_t sector;
 } end_packed_struct;
 
+/* Sector range of a discard or write zeroes request */
+
+begin_packed_struct struct virtio_blk_range_s
+{
+  uint64_t sector;
+  uint32_t nsectors;
+  uint32_t flags;
+} end_packed_struct;
+
 /* Block request in header */
 
 begin_packed_struct struct virtio_blk_resp_s
@@ -110,9 +145,24 @@ struct virtio_blk_priv_s
   FAR struct virtio_device     *vdev;           /* Virtio deivce */
   FAR struct virtio_blk_req_s  *req;            /* Virtio block out header */
   FAR struct virtio_blk_resp_s *resp;           /* Virtio block in header */
+  FAR struct virtio_blk_range_s *range;         /* Discard range */
   mutex_t                       lock;           /* Lock */
   uint64_t                      nsectors;       /* Sectore numbers */
+  uint32_t                      maxdiscard;     /* Discard sectors or 0 */
+  uint32_t                      maxzeroes;      /* Zeroes sectors or 0 */
+  int                           nvqs;           /* Request virtqueues */
   char                          name[NAME_MAX]; /* Device name */
+#ifdef CONFIG_FS_BLKQUEUE
+  struct blk_queue_s            queue;          /* Block request queue */
+  spinlock_t                    vqlock;         /* Virtqueue lock */
+  FAR struct virtio_blk_req_s  *qreq;           /* Out header per slot */
+  FAR struct virtio_blk_resp_s *qresp;          /* In header per slot */
+  FAR struct virtio_blk_range_s *qrange;        /* Discard range per slot */
+
+  /* Requests in flight, the slot address is the virtqueue cookie */
+
+  FAR struct blk_request_s     *slot[CONFIG_DRIVERS_VIRTIO_BLK_QUEUE_DEPTH];
+#endif
 };
 
 /****************************************************************************
@@ -136,7 +186,14 @@ static int     virtio_blk_geometry(FAR struct inode *inode,
                                    FAR struct geometry *geometry);
 static int     virtio_blk_ioctl(FAR struct inode *inode, int cmd,
                                 unsigned long arg);
-static int     virtio_blk_flush(FAR struct virtio_blk_priv_s *priv);
+#ifdef CONFIG_FS_BLKQUEUE
+static int     virtio_blk_dispatch(FAR struct blk_queue_s *queue,
+                                   FAR struct blk_request_s *req);
+#else
+static int     virtio_blk_command(FAR struct virtio_blk_priv_s *priv,
+                                  uint32_t type, blkcnt_t sector,
+                                  unsigned int nsectors);
+#endif
 
 /* Other functions */
 
@@ -169,12 +226,82 @@ static const struct block_operations g_virtio_blk_bops =
   virtio_blk_ioctl     /* ioctl    */
 };
 
+#ifdef CONFIG_FS_BLKQUEUE
+static const struct blk_queue_ops_s g_virtio_blk_qops =
+{
+  virtio_blk_dispatch  /* dispatch */
+};
+#endif
+
 static int g_virtio_blk_idx = 0;
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: virtio_blk_get_buffer
+ *
+ * Description:
+ *   Return the cookie of the next used buffer of the virtqueue
+ *
+ ****************************************************************************/
+
+static FAR void *virtio_blk_get_buffer(FAR struct virtio_blk_priv_s *priv,
+                                       FAR struct virtqueue *vq)
+{
+#ifdef CONFIG_FS_BLKQUEUE
+  FAR void *cookie;
+  irqstate_t flags;
+
+  flags  = spin_lock_irqsave(&priv->vqlock);
+  cookie = virtqueue_get_buffer(vq, NULL, NULL);
+  spin_unlock_irqrestore(&priv->vqlock, flags);
+  return cookie;
+#else
+  return virtqueue_get_buffer(vq, NULL, NULL);
+#endif
+}
+
+/****************************************************************************
+ * Name: virtio_blk_handle
+ *
+ * Description:
+ *   Handle a completed request:  The cookie is either the slot of a queued
+ *   request or the semaphore of a synchronous request.
+ *
+ ****************************************************************************/
+
+static void virtio_blk_handle(FAR struct virtio_blk_priv_s *priv,
+                              FAR void *cookie)
+{
+#ifdef CONFIG_FS_BLKQUEUE
+  FAR struct blk_request_s **slot = cookie;
+
+  if (slot >= &priv->slot[0] &&
+      slot < &priv->slot[CONFIG_DRIVERS_VIRTIO_BLK_QUEUE_DEPTH])
+    {
+      FAR struct blk_request_s *req = *slot;
+      int idx = slot - priv->slot;
+
+      *slot = NULL;
+      if (priv->qresp[idx].status != VIRTIO_BLK_S_OK)
+        {
+          vrterr("Request %d Error\n", req->op);
+          blk_queue_complete(&priv->queue, req, -EIO);
+        }
+      else
+        {
+          blk_queue_complete(&priv->queue, req, req->total);
+        }
+
+      return;
+    }
+#endif
+
+  nxsem_post(cookie);
+}
+
 /****************************************************************************
  * Name: virtio_blk_wait_complete
  *
@@ -183,21 +310,22 @@ static int g_virtio_blk_idx = 0;
  *
  ****************************************************************************/
 
-static void virtio_blk_wait_complete(FAR struct virtqueue *vq,
+static void virtio_blk_wait_complete(FAR struct virtio_blk_priv_s *priv,
+                                     FAR struct virtqueue *vq,
                                      FAR sem_t *respsem)
 {
   if (up_interrupt_context())
     {
       for (; ; )
         {
-          FAR sem_t * tmpsem = virtqueue_get_buffer(vq, NULL, NULL);
-          if (tmpsem == respsem)
+          FAR void *cookie = virtio_blk_get_buffer(priv, vq);
+          if (cookie == respsem)
             {
               break;
             }
-          else if (tmpsem != NULL)
+          else if (cookie != NULL)
             {
-              nxsem_post(tmpsem);
+              virtio_blk_handle(priv, cookie);
             }
         }
     }
@@ -222,6 +350,9 @@ static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
   FAR struct virtio_device *vdev = priv->vdev;
   FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
   FAR struct virtqueue_buf vb[3];
+#ifdef CONFIG_FS_BLKQUEUE
+  irqstate_t flags;
+#endif
   sem_t respsem;
   ssize_t ret;
   int readnum;
@@ -261,18 +392,27 @@ static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
   vb[2].buf = priv->resp;
   vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
   readnum = write ? 2 : 1;
+#ifdef CONFIG_FS_BLKQUEUE
+  flags = spin_lock_irqsave(&priv->vqlock);
+#endif
   ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum, &respsem);
+  if (ret >= 0)
+    {
+      virtqueue_kick(vq);
+    }
+
+#ifdef CONFIG_FS_BLKQUEUE
+  spin_unlock_irqrestore(&priv->vqlock, flags);
+#endif
   if (ret < 0)
     {
       vrterr("virtqueue_add_buffer failed, ret=%zd\n", ret);
       goto err;
     }
 
-  virtqueue_kick(vq);
-
   /* Wait for the request completion */
 
-  virtio_blk_wait_complete(vq, &respsem);
+  virtio_blk_wait_complete(priv, vq, &respsem);
 
   if (priv->resp->status != VIRTIO_BLK_S_OK)
     {
@@ -336,6 +476,17 @@ static ssize_t virtio_blk_read(FAR struct inode *inode,
 
   DEBUGASSERT(inode->i_private);
   priv = inode->i_private;
+
+#ifdef CONFIG_FS_BLKQUEUE
+  /* Only the interrupt context (e.g. coredump) bypasses the queue */
+
+  if (!up_interrupt_context())
+    {
+      return blk_queue_sync(&priv->queue, BLK_REQ_READ, buffer,
+                            startsector, nsectors);
+    }
+#endif
+
   return virtio_blk_rdwr(priv, buffer, startsector, nsectors, false);
 }
 
@@ -356,6 +507,15 @@ static ssize_t virtio_blk_write(FAR struct inode *inode,
 
   DEBUGASSERT(inode->i_private);
   priv = inode->i_private;
+
+#ifdef CONFIG_FS_BLKQUEUE
+  if (!up_interrupt_context())
+    {
+      return blk_queue_sync(&priv->queue, BLK_REQ_WRITE, (FAR void *)buffer,
+                            startsector, nsectors);
+    }
+#endif
+
   return virtio_blk_rdwr(priv, (FAR void *)buffer, startsector, nsectors,
                          true);
 }
@@ -390,15 +550,141 @@ static int virtio_blk_geometry(FAR struct inode *inode,
 }
 
 /****************************************************************************
- * Name: virtio_blk_ioctl
+ * Name: virtio_blk_dispatch
+ *
+ * Description:
+ *   Start a request of the block request queue.  The merged requests are
+ *   chained in one virtqueue request.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLKQUEUE
+static int virtio_blk_dispatch(FAR struct blk_queue_s *queue,
+                               FAR struct blk_request_s *req)
+{
+  FAR struct virtio_blk_priv_s *priv = queue->priv;
+  FAR struct virtqueue_buf vb[CONFIG_FS_BLKQUEUE_MAXSEGS + 2];
+  FAR struct blk_request_s *seg;
+  FAR struct virtqueue *vq;
+  irqstate_t flags;
+  int nbufs = 1;
+  int idx;
+  int ret;
+  int i;
+
+  /* The queue never has more requests in flight than slots */
+
+  flags = spin_lock_irqsave(&priv->vqlock);
+  for (idx = 0; priv->slot[idx] != NULL; idx++)
+    {
+      DEBUGASSERT(idx + 1 < queue->depth);
+    }
+
+  priv->qreq[idx].reserved = 0;
+  priv->qresp[idx].status  = VIRTIO_BLK_S_IOERR;
+
+  if (req->op == BLK_REQ_FLUSH)
+    {
+      priv->qreq[idx].type   = VIRTIO_BLK_T_FLUSH;
+      priv->qreq[idx].sector = 0;
+    }
+  else if (req->op == BLK_REQ_DISCARD || req->op == BLK_REQ_ZEROES)
+    {
+      priv->qreq[idx].type     = req->op == BLK_REQ_DISCARD ?
+                                 VIRTIO_BLK_T_DISCARD :
+                                 VIRTIO_BLK_T_WRITE_ZEROES;
+      priv->qreq[idx].sector   = 0;
+      priv->qrange[idx].sector   = req->sector;
+      priv->qrange[idx].nsectors = req->nsectors;
+      priv->qrange[idx].flags    = 0;
+
+      vb[nbufs].buf = &priv->qrange[idx];
+      vb[nbufs].len = VIRTIO_BLK_RANGE_SIZE;
+      nbufs++;
+    }
+  else
+    {
+      priv->qreq[idx].type   = req->op == BLK_REQ_WRITE ?
+                               VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
+      priv->qreq[idx].sector = req->sector;
+
+      for (seg = req; seg != NULL; seg = seg->merged)
+        {
+          vb[nbufs].buf = seg->buffer;
+          vb[nbufs].len = seg->nsectors * VIRTIO_BLK_SECTOR_SIZE;
+          nbufs++;
+        }
+    }
+
+  /* Buffer 0: the block out header;
+   * Buffers 1..n: the data of each merged request, or the discard range;
+   * Buffer n + 1: the block in header, return the status.
+   */
+
+  vb[0].buf     = &priv->qreq[idx];
+  vb[0].len     = VIRTIO_BLK_REQ_HEADER_SIZE;
+  vb[nbufs].buf = &priv->qresp[idx];
+  vb[nbufs].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+
+  /* Start with the virtqueue of this CPU.  The depth of the queue leaves
+   * room for the request in one of the virtqueues.
+   */
+
+  for (i = 0; ; i++)
+    {
+      vq = priv->vdev->vrings_info[(this_cpu() + i) % priv->nvqs].vq;
+      if (vq->vq_free_cnt > nbufs)
+        {
+          break;
+        }
+
+      DEBUGASSERT(i + 1 < priv->nvqs);
+    }
+
+  if (req->op == BLK_REQ_READ)
+    {
+      ret = virtqueue_add_buffer(vq, vb, 1, nbufs, &priv->slot[idx]);
+    }
+  else
+    {
+      ret = virtqueue_add_buffer(vq, vb, nbufs, 1, &priv->slot[idx]);
+    }
+
+  if (ret >= 0)
+    {
+      priv->slot[idx] = req;
+      virtqueue_kick(vq);
+    }
+
+  spin_unlock_irqrestore(&priv->vqlock, flags);
+
+  if (ret < 0)
+    {
+      vrterr("virtqueue_add_buffer failed, ret=%d\n", ret);
+      return -EIO;
+    }
+
+  return OK;
+}
+#else
+
+/****************************************************************************
+ * Name: virtio_blk_command
+ *
+ * Description:
+ *   Run a flush, discard or write zeroes request and wait for it.
+ *
  ****************************************************************************/
 
-static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
+static int virtio_blk_command(FAR struct virtio_blk_priv_s *priv,
+                              uint32_t type, blkcnt_t sector,
+                              unsigned int nsectors)
 {
   FAR struct virtio_device *vdev = priv->vdev;
   FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
-  FAR struct virtqueue_buf vb[2];
+  FAR struct virtqueue_buf vb[3];
   sem_t respsem;
+  int nbufs = 1;
   int ret;
 
   ret = nxmutex_lock(&priv->lock);
@@ -411,16 +697,28 @@ static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
 
   /* Build the block request */
 
-  priv->req->type     = VIRTIO_BLK_T_FLUSH;
+  priv->req->type     = type;
   priv->req->reserved = 0;
   priv->req->sector   = 0;
   priv->resp->status  = VIRTIO_BLK_S_IOERR;
 
   vb[0].buf = priv->req;
   vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = priv->resp;
-  vb[1].len = VIRTIO_BLK_RESP_HEADER_SIZE;
-  ret = virtqueue_add_buffer(vq, vb, 1, 1, &respsem);
+
+  if (type != VIRTIO_BLK_T_FLUSH)
+    {
+      priv->range->sector   = sector;
+      priv->range->nsectors = nsectors;
+      priv->range->flags    = 0;
+
+      vb[nbufs].buf = priv->range;
+      vb[nbufs].len = VIRTIO_BLK_RANGE_SIZE;
+      nbufs++;
+    }
+
+  vb[nbufs].buf = priv->resp;
+  vb[nbufs].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+  ret = virtqueue_add_buffer(vq, vb, nbufs, 1, &respsem);
   if (ret < 0)
     {
       goto err;
@@ -433,7 +731,7 @@ static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
   nxsem_wait_uninterruptible(&respsem);
   if (priv->resp->status != VIRTIO_BLK_S_OK)
     {
-      vrterr("Flush Error\n");
+      vrterr("Request %" PRIu32 " Error\n", type);
       ret = -EIO;
     }
 
@@ -441,6 +739,59 @@ err:
   nxmutex_unlock(&priv->lock);
   return ret;
 }
+#endif
+
+/****************************************************************************
+ * Name: virtio_blk_discard
+ *
+ * Description:
+ *   Discard or zero a range of sectors, split in the largest requests that
+ *   the device accepts.
+ *
+ ****************************************************************************/
+
+static int virtio_blk_discard(FAR struct virtio_blk_priv_s *priv,
+                              FAR const uint64_t *range, bool zero)
+{
+  uint64_t sector = range[0];
+  uint64_t nsectors = range[1];
+  uint32_t max = zero ? priv->maxzeroes : priv->maxdiscard;
+  unsigned int n;
+  int ret;
+
+  if (max == 0)
+    {
+      return -ENOTSUP;
+    }
+
+  if (sector > priv->nsectors || nsectors > priv->nsectors - sector)
+    {
+      return -EINVAL;
+    }
+
+  while (nsectors > 0)
+    {
+      n = MIN(nsectors, max);
+#ifdef CONFIG_FS_BLKQUEUE
+      ret = blk_queue_sync(&priv->queue,
+                           zero ? BLK_REQ_ZEROES : BLK_REQ_DISCARD,
+                           NULL, sector, n);
+#else
+      ret = virtio_blk_command(priv, zero ? VIRTIO_BLK_T_WRITE_ZEROES :
+                                            VIRTIO_BLK_T_DISCARD,
+                               sector, n);
+#endif
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      sector   += n;
+      nsectors -= n;
+    }
+
+  return OK;
+}
 
 /****************************************************************************
  * Name: virtio_blk_ioctl
@@ -458,8 +809,25 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
   switch (cmd)
     {
       case BIOC_FLUSH:
-        ret = virtio_blk_flush(priv);
+#ifdef CONFIG_FS_BLKQUEUE
+        ret = blk_queue_sync(&priv->queue, BLK_REQ_FLUSH, NULL, 0, 0);
+#else
+        ret = virtio_blk_command(priv, VIRTIO_BLK_T_FLUSH, 0, 0);
+#endif
+        break;
+
+      case BIOC_DISCARD:
+      case BIOC_ZEROOUT:
+        ret = virtio_blk_discard(priv, (FAR const uint64_t *)(uintptr_t)arg,
+                                 cmd == BIOC_ZEROOUT);
+        break;
+
+#ifdef CONFIG_FS_BLKQUEUE
+      case BIOC_GETQUEUE:
+        *(FAR struct blk_queue_s **)(uintptr_t)arg = &priv->queue;
+        ret = OK;
         break;
+#endif
     }
 
   return ret;
@@ -471,12 +839,12 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
 
 static void virtio_blk_done(FAR struct virtqueue *vq)
 {
-  FAR sem_t *respsem;
+  FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
+  FAR void *cookie;
 
-  respsem = virtqueue_get_buffer(vq, NULL, NULL);
-  if (respsem != NULL)
+  while ((cookie = virtio_blk_get_buffer(priv, vq)) != NULL)
     {
-      nxsem_post(respsem);
+      virtio_blk_handle(priv, cookie);
     }
 }
 
@@ -487,23 +855,33 @@ static void virtio_blk_done(FAR struct virtqueue *vq)
 static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqname[1];
-  vq_callback callback[1];
+  FAR const char *vqname[VIRTIO_BLK_MAX_VQS];
+  vq_callback callback[VIRTIO_BLK_MAX_VQS];
+#ifdef CONFIG_FS_BLKQUEUE
+  uint32_t segmax = CONFIG_FS_BLKQUEUE_MAXSEGS;
+  int depth = 0;
+#endif
   int ret;
+  int i;
 
   priv->vdev = vdev;
   vdev->priv = priv;
   nxmutex_init(&priv->lock);
 
-  /* Alloc the request and in header from tansport layer */
+  /* Alloc the request and in header from tansport layer, the discard
+   * range follows the request header.
+   */
 
-  priv->req = virtio_alloc_buf(vdev, sizeof(*priv->req), 16);
+  priv->req = virtio_alloc_buf(vdev, sizeof(*priv->req) +
+                               sizeof(*priv->range), 16);
   if (priv->req == NULL)
     {
       ret = -ENOMEM;
       goto err_with_lock;
     }
 
+  priv->range = (FAR struct virtio_blk_range_s *)(priv->req + 1);
+
   priv->resp = virtio_alloc_buf(vdev, sizeof(*priv->resp), 16);
   if (priv->resp == NULL)
     {
@@ -511,26 +889,115 @@ static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
       goto err_with_req;
     }
 
+#ifdef CONFIG_FS_BLKQUEUE
+  spin_lock_init(&priv->vqlock);
+  priv->qreq = virtio_alloc_buf(vdev, (sizeof(*priv->qreq) +
+                                 sizeof(*priv->qrange)) *
+                                CONFIG_DRIVERS_VIRTIO_BLK_QUEUE_DEPTH, 16);
+  priv->qresp = virtio_alloc_buf(vdev, sizeof(*priv->qresp) *
+                                 CONFIG_DRIVERS_VIRTIO_BLK_QUEUE_DEPTH, 16);
+  if (priv->qreq == NULL || priv->qresp == NULL)
+    {
+      ret = -ENOMEM;
+      goto err_with_queue;
+    }
+
+  priv->qrange = (FAR struct virtio_blk_range_s *)
+                 &priv->qreq[CONFIG_DRIVERS_VIRTIO_BLK_QUEUE_DEPTH];
+#endif
+
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_set_features(vdev, 0);
+  virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_SEG_MAX) |
+#if VIRTIO_BLK_MAX_VQS > 1
+                                  (1UL << VIRTIO_BLK_F_MQ) |
+#endif
+                                  (1UL << VIRTIO_BLK_F_DISCARD) |
+                                  (1UL << VIRTIO_BLK_F_WRITE_ZEROES));
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqname[0]   = "virtio_blk_vq";
-  callback[0] = virtio_blk_done;
-  ret = virtio_create_virtqueues(vdev, 0, 1, vqname, callback);
+  priv->nvqs = 1;
+#if VIRTIO_BLK_MAX_VQS > 1
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_MQ))
+    {
+      uint16_t nqueues = 1;
+
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                num_queues, &nqueues);
+      priv->nvqs = MAX(MIN(nqueues, VIRTIO_BLK_MAX_VQS), 1);
+    }
+#endif
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_DISCARD))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                max_discard_sectors, &priv->maxdiscard);
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_WRITE_ZEROES))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                max_write_zeroes_sectors, &priv->maxzeroes);
+    }
+
+  for (i = 0; i < priv->nvqs; i++)
+    {
+      vqname[i]   = "virtio_blk_vq";
+      callback[i] = virtio_blk_done;
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, priv->nvqs, vqname, callback);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
       goto err_with_resp;
     }
 
+#ifdef CONFIG_FS_BLKQUEUE
+  /* Each request takes its data buffers and two headers, and the device
+   * may take fewer data buffers per request.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_SEG_MAX))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s, seg_max,
+                                &segmax);
+      segmax = MAX(MIN(segmax, CONFIG_FS_BLKQUEUE_MAXSEGS), 1);
+    }
+
+  for (i = 0; i < priv->nvqs; i++)
+    {
+      depth += vdev->vrings_info[i].vq->vq_nentries / (segmax + 2);
+    }
+
+  blk_queue_init(&priv->queue, &g_virtio_blk_qops, priv,
+                 MIN(CONFIG_DRIVERS_VIRTIO_BLK_QUEUE_DEPTH, depth),
+                 VIRTIO_BLK_MAX_SECTORS, segmax);
+#endif
+
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
-  virtqueue_enable_cb(vdev->vrings_info[0].vq);
+  for (i = 0; i < priv->nvqs; i++)
+    {
+      virtqueue_enable_cb(vdev->vrings_info[i].vq);
+    }
+
   return OK;
 
 err_with_resp:
+#ifdef CONFIG_FS_BLKQUEUE
+err_with_queue:
+  if (priv->qresp != NULL)
+    {
+      virtio_free_buf(vdev, priv->qresp);
+    }
+
+  if (priv->qreq != NULL)
+    {
+      virtio_free_buf(vdev, priv->qreq);
+    }
+#endif
+
   virtio_free_buf(vdev, priv->resp);
 err_with_req:
   virtio_free_buf(vdev, priv->req);
@@ -549,6 +1016,10 @@ static void virtio_blk_uninit(FAR struct virtio_blk_priv_s *priv)
 
   virtio_reset_device(vdev);
   virtio_delete_virtqueues(vdev);
+#ifdef CONFIG_FS_BLKQUEUE
+  virtio_free_buf(vdev, priv->qresp);
+  virtio_free_buf(vdev, priv->qreq);
+#endif
   virtio_free_buf(vdev, priv->resp);
   virtio_free_buf(vdev, priv->req);
   nxmutex_destroy(&priv->lock);
@@ -27,10 +27,12 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/compiler.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/net/wifi_sim.h>
 
@@ -42,31 +44,84 @@
 
 /* Virtio net feature bits */
 
-#define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CSUM       0
+#define VIRTIO_NET_F_GUEST_CSUM 1
+#define VIRTIO_NET_F_MAC        5
+#define VIRTIO_NET_F_GUEST_TSO4 7
+#define VIRTIO_NET_F_GUEST_TSO6 8
+#define VIRTIO_NET_F_HOST_TSO4  11
+#define VIRTIO_NET_F_HOST_TSO6  12
+#define VIRTIO_NET_F_MRG_RXBUF  15
+#define VIRTIO_NET_F_CTRL_VQ    17
+#define VIRTIO_NET_F_MQ         22
 
-/* Virtio net header size and packet buffer size */
+/* Virtio net control commands */
+
+#define VIRTIO_NET_OK                 0
+#define VIRTIO_NET_CTRL_MQ            4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+
+/* Polls of the control virtqueue, 100us apart, before giving up */
+
+#define VIRTIO_NET_CTRL_POLLS         1000
+
+/* Virtio net header flags and GSO types */
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM   1
+#define VIRTIO_NET_HDR_F_DATA_VALID   2
+
+#define VIRTIO_NET_HDR_GSO_TCPV4      1
+#define VIRTIO_NET_HDR_GSO_TCPV6      4
+
+/* Virtio net header size and packet buffer size, the header only has the
+ * num_buffers field with VIRTIO_NET_F_MRG_RXBUF.
+ */
 
 #define VIRTIO_NET_HDRSIZE    (sizeof(struct virtio_net_hdr_s))
+#define VIRTIO_NET_HDRSIZE_LEGACY 10
 #define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
 
-/* Virtio net virtqueue index and number */
+/* Virtio net virtqueue index and number, the queue pair q uses the
+ * virtqueues 2q (RX) and 2q + 1 (TX), the control virtqueue comes after
+ * all the pairs of the device.
+ */
 
 #define VIRTIO_NET_RX         0
 #define VIRTIO_NET_TX         1
 #define VIRTIO_NET_NUM        2
 
+#define VIRTIO_NET_RXQ(q)     (2 * (q) + VIRTIO_NET_RX)
+#define VIRTIO_NET_TXQ(q)     (2 * (q) + VIRTIO_NET_TX)
+#define VIRTIO_NET_QID(vq)    ((vq)->vq_queue_index / 2)
+
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_QUEUES
+#  define VIRTIO_NET_MAX_PAIRS CONFIG_DRIVERS_VIRTIO_NET_QUEUES
+#else
+#  define VIRTIO_NET_MAX_PAIRS 1
+#endif
+
+#define VIRTIO_NET_MAX_VQS    (2 * VIRTIO_NET_MAX_PAIRS + 1)
+
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
     ((VIRTIO_NET_MAX_PKT_SIZE + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
 
+/* A TCP super-segment may span more I/O buffers than a frame */
+
+#if defined(CONFIG_NET_TCP_GSO) && VIRTIO_NET_MAX_NIOB < 16
+#  define VIRTIO_NET_TX_NIOB  16
+#else
+#  define VIRTIO_NET_TX_NIOB  VIRTIO_NET_MAX_NIOB
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* Virtio net header, just define it here for further, now only use it
- * to calculate the virto net header size, see marco VIRTIO_NET_HDRSIZE
+/* Virtio net header, placed right before the Ethernet header of each
+ * packet.  Only priv->hdrsize bytes of it are used.
  */
 
 begin_packed_struct struct virtio_net_hdr_s
@@ -77,6 +132,9 @@ begin_packed_struct struct virtio_net_hdr_s
   uint16_t gso_size;
   uint16_t csum_start;
   uint16_t csum_offset;
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF
+  uint16_t num_buffers;                      /* VIRTIO_NET_F_MRG_RXBUF */
+#endif
 } end_packed_struct;
 
 /* The definition of the struct virtio_net_config refers to the link
@@ -97,6 +155,20 @@ begin_packed_struct struct virtio_net_config_s
   uint32_t supported_hash_types;
 } end_packed_struct;
 
+/* Control command to set the number of queue pairs, the ack is written by
+ * the device.
+ */
+
+#if VIRTIO_NET_MAX_PAIRS > 1
+begin_packed_struct struct virtio_net_ctrl_mq_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t pairs;
+  uint8_t  ack;
+} end_packed_struct;
+#endif
+
 struct virtio_net_priv_s
 {
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -113,7 +185,17 @@ struct virtio_net_priv_s
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
-  int                       bufnum;    /* TX and RX Buffer number */
+  int                       bufnum;    /* TX and RX Buffer number per queue */
+  size_t                    hdrsize;   /* Virtio net header size in use */
+  int                       npairs;    /* Queue pairs in use */
+
+  /* RX buffers queued on each queue pair */
+
+  int                       rxnum[VIRTIO_NET_MAX_PAIRS];
+
+#if VIRTIO_NET_MAX_PAIRS > 1
+  struct virtio_net_ctrl_mq_s ctrl;    /* Control command buffer */
+#endif
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -129,6 +211,10 @@ struct virtio_net_priv_s
  *                          = sizeof(uintptr) + 10 + 14
  *                          = 32 (64-Bit)
  *                          = 28 (32-Bit)
+ *
+ * and 2 bytes more with CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF.  Without
+ * VIRTIO_NET_F_MRG_RXBUF the header is 2 bytes shorter than vhdr, and the
+ * packet pointer is moved forward by as much.
  */
 
 begin_packed_struct struct virtio_net_llhdr_s
@@ -161,6 +247,14 @@ static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev,
                             int cmd, unsigned long arg);
 #endif
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev);
+#if VIRTIO_NET_MAX_PAIRS > 1
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 int qid, FAR netpkt_t *pkt);
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int qid, FAR uint8_t *offload);
+static void virtio_net_txfree_queue(FAR struct netdev_lowerhalf_s *dev,
+                                    int qid);
+#endif
 
 static int  virtio_net_probe(FAR struct virtio_device *vdev);
 static void virtio_net_remove(FAR struct virtio_device *vdev);
@@ -190,7 +284,12 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+#if VIRTIO_NET_MAX_PAIRS > 1
+  virtio_net_send_queue,
+  virtio_net_recv_queue,
+  virtio_net_txfree_queue,
+#endif
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -207,25 +306,37 @@ static uint8_t g_netdev_num = 0;
 
 static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
                                 FAR struct virtqueue *vq, FAR netpkt_t *pkt,
-                                unsigned int vq_id)
+                                unsigned int vq_id,
+                                FAR const struct virtio_net_hdr_s *vhdr)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
   FAR struct virtio_net_llhdr_s *hdr;
-  struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB + 1];
-  struct iovec iov[VIRTIO_NET_MAX_NIOB];
+  struct virtqueue_buf vb[VIRTIO_NET_TX_NIOB + 1];
+  struct iovec iov[VIRTIO_NET_TX_NIOB];
   int iov_cnt;
   int i;
 
   /* Convert netpkt to virtqueue_buf */
 
-  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_NIOB);
+  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_TX_NIOB);
 
-  /* Alloc cookie and net header from transport layer */
+  /* Alloc cookie and net header from transport layer, the header ends
+   * where the packet starts.
+   */
 
   hdr = (FAR struct virtio_net_llhdr_s *)
-          ((FAR uint8_t *)iov[0].iov_base - VIRTIO_NET_LLHDRSIZE);
+          ((FAR uint8_t *)iov[0].iov_base - priv->hdrsize -
+           offsetof(struct virtio_net_llhdr_s, vhdr));
   DEBUGASSERT((FAR uint8_t *)hdr >= netpkt_getbase(pkt));
-  memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
+  if (vhdr != NULL)
+    {
+      memcpy(&hdr->vhdr, vhdr, priv->hdrsize);
+    }
+  else
+    {
+      memset(&hdr->vhdr, 0, priv->hdrsize);
+    }
+
   hdr->pkt = pkt;
 
   /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
@@ -235,9 +346,9 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       /* Append the virtio net header to the first buffer */
 
       vb[0].buf = &hdr->vhdr;
-      vb[0].len = iov[0].iov_len + VIRTIO_NET_HDRSIZE;
+      vb[0].len = iov[0].iov_len + priv->hdrsize;
 
-#if VIRTIO_NET_MAX_NIOB > 1
+#if VIRTIO_NET_TX_NIOB > 1
       for (i = 1; i < iov_cnt; i++)
         {
           vb[i].buf = iov[i].iov_base;
@@ -250,7 +361,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       /* Buffer 0 is only for virtio net header */
 
       vb[0].buf = &hdr->vhdr;
-      vb[0].len = VIRTIO_NET_HDRSIZE;
+      vb[0].len = priv->hdrsize;
 
       for (i = 0; i < iov_cnt; i++)
         {
@@ -262,7 +373,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     }
 
   vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+  if (vq_id % 2 == VIRTIO_NET_RX)
     {
       return virtqueue_add_buffer(vq, vb, 0, iov_cnt, hdr);
     }
@@ -276,14 +387,19 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
  * Name: virtio_net_rxfill
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev, int qid)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_RXQ(qid)].vq;
   FAR netpkt_t *pkt;
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  /* Keep at most bufnum buffers per queue, so that no queue takes the RX
+   * quota of the others.
+   */
+
+  for (i = 0; priv->rxnum[qid] < priv->bufnum; i++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
@@ -306,7 +422,13 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Add buffer to RX virtqueue */
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      if (virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RXQ(qid), NULL) < 0)
+        {
+          netpkt_free(dev, pkt, NETPKT_RX);
+          break;
+        }
+
+      priv->rxnum[qid]++;
     }
 
   if (i > 0)
@@ -316,13 +438,15 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 }
 
 /****************************************************************************
- * Name: virtio_net_txfree
+ * Name: virtio_net_txfree_queue
  ****************************************************************************/
 
-static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_txfree_queue(FAR struct netdev_lowerhalf_s *dev,
+                                    int qid)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_TXQ(qid)].vq;
   FAR struct virtio_net_llhdr_s *hdr;
 
   while (1)
@@ -340,6 +464,15 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
     }
 }
 
+/****************************************************************************
+ * Name: virtio_net_txfree
+ ****************************************************************************/
+
+static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+{
+  virtio_net_txfree_queue(dev, 0);
+}
+
 /****************************************************************************
  * Name: virtio_net_ifup
  ****************************************************************************/
@@ -347,6 +480,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -363,8 +497,11 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb(priv->vdev->vrings_info[VIRTIO_NET_RX].vq);
-  virtio_net_rxfill(dev);
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtqueue_enable_cb(priv->vdev->vrings_info[VIRTIO_NET_RXQ(i)].vq);
+      virtio_net_rxfill(dev, i);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -387,7 +524,7 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < 2 * priv->npairs; i++)
     {
       virtqueue_disable_cb(priv->vdev->vrings_info[i].vq);
     }
@@ -406,18 +543,69 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 }
 
 /****************************************************************************
- * Name: virtio_net_send
+ * Name: virtio_net_txhdr
+ *
+ * Description:
+ *   Describe the checksum and segmentation left to the device in the
+ *   virtio net header of the packet being sent.
+ *
+ * Returned Value:
+ *   The header, or NULL if nothing is left to the device.
+ *
  ****************************************************************************/
 
-static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
-                           FAR netpkt_t *pkt)
+#ifdef CONFIG_NETDEV_OFFLOAD
+static FAR struct virtio_net_hdr_s *
+virtio_net_txhdr(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                 FAR struct virtio_net_hdr_s *vhdr)
+{
+  FAR struct net_driver_s *netdev = &dev->netdev;
+  FAR struct tcp_hdr_s *tcp;
+
+  if ((netdev->d_offload & NETDEV_OFFLOAD_TXCSUM) == 0)
+    {
+      return NULL;
+    }
+
+  memset(vhdr, 0, sizeof(*vhdr));
+  vhdr->flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+  vhdr->csum_start  = ETH_HDRLEN + netdev->d_csum_start;
+  vhdr->csum_offset = netdev->d_csum_offset;
+
+  if (NETDEV_IS_GSO(netdev))
+    {
+      tcp = (FAR struct tcp_hdr_s *)
+              (netpkt_getdata(dev, pkt) + vhdr->csum_start);
+
+      vhdr->gso_type = IFF_IS_IPv6(netdev->d_flags) ?
+                       VIRTIO_NET_HDR_GSO_TCPV6 : VIRTIO_NET_HDR_GSO_TCPV4;
+      vhdr->gso_size = netdev->d_gso_size;
+      vhdr->hdr_len  = vhdr->csum_start + ((tcp->tcpoffset >> 4) << 2);
+    }
+
+  return vhdr;
+}
+#else
+#  define virtio_net_txhdr(dev, pkt, vhdr) NULL
+#endif
+
+/****************************************************************************
+ * Name: virtio_net_send_queue
+ ****************************************************************************/
+
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 int qid, FAR netpkt_t *pkt)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_TXQ(qid)].vq;
+  struct virtio_net_hdr_s vhdr;
+  int ret;
 
   /* Check the send length */
 
-  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE)
+  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE &&
+      !NETDEV_IS_GSO(&dev->netdev))
     {
       vrterr("net send buffer too large\n");
       return -EINVAL;
@@ -425,58 +613,170 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* Add buffer to vq and notify the other side */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
+  ret = virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TXQ(qid),
+                             virtio_net_txhdr(dev, pkt, &vhdr));
+  if (ret < 0)
+    {
+      vrterr("virtqueue_add_buffer failed, ret=%d\n", ret);
+      return ret;
+    }
+
   virtqueue_kick(vq);
 
   /* Try return Netpkt TX buffer to upper-half. */
 
-  virtio_net_txfree(dev);
+  virtio_net_txfree_queue(dev, qid);
 
-  /* If we have no buffer left, enable TX done callback. */
+  /* If we have no buffer left, enable TX done callback.  Buffers used
+   * before the callback is enabled would not be notified, free them now.
+   */
 
-  if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
+  if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0 &&
+      virtqueue_enable_cb(vq) != 0)
     {
-      virtqueue_enable_cb(vq);
+      virtio_net_txfree_queue(dev, qid);
     }
 
   return OK;
 }
 
 /****************************************************************************
- * Name: virtio_net_recv
+ * Name: virtio_net_send
  ****************************************************************************/
 
-static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  return virtio_net_send_queue(dev, 0, pkt);
+}
+
+/****************************************************************************
+ * Name: virtio_net_recv_merge
+ *
+ * Description:
+ *   Append the other buffers of a packet received over several buffers
+ *   (VIRTIO_NET_F_MRG_RXBUF) to its first buffer.  These buffers have no
+ *   virtio net header, the data starts where the header would be.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF
+static int virtio_net_recv_merge(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR struct virtqueue *vq, int qid,
+                                 FAR struct virtio_net_llhdr_s *hdr)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtio_net_llhdr_s *next;
+  uint16_t nbufs = hdr->vhdr.num_buffers;
+  uint32_t len;
+
+  while (--nbufs > 0)
+    {
+      next = virtqueue_get_buffer(vq, &len, NULL);
+      if (next == NULL)
+        {
+          vrterr("Missing %u buffers of a packet\n", nbufs);
+          return -EIO;
+        }
+
+      priv->rxnum[qid]--;
+
+      iob_reserve(next->pkt, (FAR uint8_t *)&next->vhdr -
+                             netpkt_getbase(next->pkt));
+      iob_update_pktlen(next->pkt, len, false);
+      iob_concat(hdr->pkt, next->pkt);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: virtio_net_recv_queue
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int qid, FAR uint8_t *offload)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_RXQ(qid)].vq;
   FAR struct virtio_net_llhdr_s *hdr;
   uint32_t len;
 
   /* Fill the free Netpkt RX buffer to the RX virtqueue */
 
-  virtio_net_rxfill(dev);
+  virtio_net_rxfill(dev, qid);
 
   /* Get received buffer form RX virtqueue */
 
   hdr = virtqueue_get_buffer(vq, &len, NULL);
   if (hdr == NULL)
     {
-      /* If we have no buffer left, enable RX callback. */
+      /* If we have no buffer left, enable RX callback.  A buffer used
+       * before the callback is enabled would not be notified, so check
+       * again.
+       */
 
-      virtqueue_enable_cb(vq);
+      if (virtqueue_enable_cb(vq) != 0)
+        {
+          hdr = virtqueue_get_buffer(vq, &len, NULL);
+        }
 
-      vrtinfo("get NULL buffer\n");
-      return NULL;
+      if (hdr == NULL)
+        {
+          vrtinfo("get NULL buffer\n");
+          return NULL;
+        }
     }
 
+  priv->rxnum[qid]--;
+
   /* Set the received pkt length */
 
-  netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
+  netpkt_setdatalen(dev, hdr->pkt, len - priv->hdrsize);
+
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF
+  if (hdr->vhdr.num_buffers > 1 &&
+      virtio_net_recv_merge(dev, vq, qid, hdr) < 0)
+    {
+      netpkt_free(dev, hdr->pkt, NETPKT_RX);
+      return NULL;
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* A partial checksum comes from the host, that will not corrupt it */
+
+  if ((hdr->vhdr.flags & (VIRTIO_NET_HDR_F_DATA_VALID |
+                          VIRTIO_NET_HDR_F_NEEDS_CSUM)) != 0)
+    {
+      *offload |= NETDEV_OFFLOAD_RXCSUM;
+    }
+#else
+  UNUSED(offload);
+#endif
   vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
   return hdr->pkt;
 }
 
+/****************************************************************************
+ * Name: virtio_net_recv
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  uint8_t offload = 0;
+  FAR netpkt_t *pkt;
+
+  pkt = virtio_net_recv_queue(dev, 0, &offload);
+#ifdef CONFIG_NETDEV_OFFLOAD
+  dev->netdev.d_offload |= offload;
+#endif
+
+  return pkt;
+}
+
 #ifdef CONFIG_NET_MCASTGROUP
 /****************************************************************************
  * Name: virtio_net_addmac
@@ -520,6 +820,15 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
   virtqueue_disable_cb(vq);
+#if VIRTIO_NET_MAX_PAIRS > 1
+  if (priv->npairs > 1)
+    {
+      netdev_lower_rxready_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                 VIRTIO_NET_QID(vq));
+      return;
+    }
+#endif
+
   netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
 }
 
@@ -532,9 +841,70 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
   virtqueue_disable_cb(vq);
+#if VIRTIO_NET_MAX_PAIRS > 1
+  if (priv->npairs > 1)
+    {
+      netdev_lower_txdone_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                VIRTIO_NET_QID(vq));
+      return;
+    }
+#endif
+
   netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
 }
 
+/****************************************************************************
+ * Name: virtio_net_set_pairs
+ *
+ * Description:
+ *   Ask the device to spread the received flows over 'pairs' queue pairs,
+ *   through the control virtqueue.  The device answers at once, so poll.
+ *
+ ****************************************************************************/
+
+#if VIRTIO_NET_MAX_PAIRS > 1
+static int virtio_net_set_pairs(FAR struct virtio_net_priv_s *priv,
+                                FAR struct virtqueue *vq, int pairs)
+{
+  FAR struct virtio_net_ctrl_mq_s *ctrl = &priv->ctrl;
+  struct virtqueue_buf vb[3];
+  int ret;
+  int i;
+
+  ctrl->class = VIRTIO_NET_CTRL_MQ;
+  ctrl->cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  ctrl->pairs = pairs;
+  ctrl->ack   = ~VIRTIO_NET_OK;
+
+  vb[0].buf = &ctrl->class;
+  vb[0].len = 2;
+  vb[1].buf = &ctrl->pairs;
+  vb[1].len = sizeof(ctrl->pairs);
+  vb[2].buf = &ctrl->ack;
+  vb[2].len = sizeof(ctrl->ack);
+
+  ret = virtqueue_add_buffer(vq, vb, 2, 1, ctrl);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  virtqueue_kick(vq);
+
+  for (i = 0; i < VIRTIO_NET_CTRL_POLLS; i++)
+    {
+      if (virtqueue_get_buffer(vq, NULL, NULL) != NULL)
+        {
+          return ctrl->ack == VIRTIO_NET_OK ? OK : -EIO;
+        }
+
+      up_udelay(100);
+    }
+
+  return -ETIMEDOUT;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -542,9 +912,11 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char *vqnames[VIRTIO_NET_MAX_VQS];
+  vq_callback callbacks[VIRTIO_NET_MAX_VQS];
+  int nvqs = VIRTIO_NET_NUM;
   int ret;
+  int i;
 
   priv->vdev = vdev;
   vdev->priv = priv;
@@ -553,15 +925,78 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
   virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
+#ifdef CONFIG_NETDEV_OFFLOAD
+                                  (1UL << VIRTIO_NET_F_CSUM) |
+#  ifndef CONFIG_NET_IPFORWARD
+                                  (1UL << VIRTIO_NET_F_GUEST_CSUM) |
+#  endif
+#  ifdef CONFIG_NET_TCP_GSO
+                                  (1UL << VIRTIO_NET_F_HOST_TSO4) |
+                                  (1UL << VIRTIO_NET_F_HOST_TSO6) |
+#  endif
+#  if defined(CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF) && \
+      !defined(CONFIG_NET_IPFORWARD)
+                                  (1UL << VIRTIO_NET_F_GUEST_TSO4) |
+                                  (1UL << VIRTIO_NET_F_GUEST_TSO6) |
+#  endif
+#endif
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF
+                                  (1UL << VIRTIO_NET_F_MRG_RXBUF) |
+#endif
+                                  VIRTIO_RING_F_EVENT_IDX |
+#if VIRTIO_NET_MAX_PAIRS > 1
+                                  (1UL << VIRTIO_NET_F_CTRL_VQ) |
+                                  (1UL << VIRTIO_NET_F_MQ) |
+#endif
                                   (1UL << VIRTIO_F_ANY_LAYOUT));
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks);
+  priv->npairs  = 1;
+  priv->hdrsize = VIRTIO_NET_HDRSIZE_LEGACY;
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MRG_RXBUF))
+    {
+      priv->hdrsize = VIRTIO_NET_HDRSIZE;
+    }
+#endif
+
+#if VIRTIO_NET_MAX_PAIRS > 1
+  /* The control virtqueue follows all the queue pairs of the device, so
+   * the pairs are only used when the device has no more than we can take.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_MQ))
+    {
+      uint16_t pairs = 0;
+
+      virtio_read_config(vdev,
+                         offsetof(struct virtio_net_config_s,
+                                  max_virtqueue_pairs),
+                         &pairs, sizeof(pairs));
+      if (pairs > 1 && pairs <= VIRTIO_NET_MAX_PAIRS)
+        {
+          priv->npairs = pairs;
+          nvqs = 2 * pairs + 1;
+        }
+    }
+#endif
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      vqnames[VIRTIO_NET_RXQ(i)]   = "virtio_net_rx";
+      vqnames[VIRTIO_NET_TXQ(i)]   = "virtio_net_tx";
+      callbacks[VIRTIO_NET_RXQ(i)] = virtio_net_rxready;
+      callbacks[VIRTIO_NET_TXQ(i)] = virtio_net_txdone;
+    }
+
+  if (nvqs > VIRTIO_NET_NUM)
+    {
+      vqnames[nvqs - 1]   = "virtio_net_ctrl";
+      callbacks[nvqs - 1] = NULL;
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -570,6 +1005,21 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+#if VIRTIO_NET_MAX_PAIRS > 1
+  if (priv->npairs > 1)
+    {
+      ret = virtio_net_set_pairs(priv, vdev->vrings_info[nvqs - 1].vq,
+                                 priv->npairs);
+      if (ret < 0)
+        {
+          /* The device keeps receiving on the first pair only */
+
+          vrtwarn("Set %d queue pairs failed, ret=%d\n", priv->npairs, ret);
+          priv->npairs = 1;
+        }
+    }
+#endif
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
@@ -577,7 +1027,8 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
    * 1/4 for the TX netpkts, 1/4 for the RX netpkts.
    */
 
-  priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
+  priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4 /
+                 priv->npairs;
 #endif
   priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs,
                      priv->bufnum);
@@ -586,6 +1037,49 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
   return OK;
 }
 
+/****************************************************************************
+ * Name: virtio_net_set_features
+ *
+ * Description:
+ *   Advertise the offloads negotiated with the device to the stack.  The
+ *   device only segments TCP when it also completes the checksum.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+static void virtio_net_set_features(FAR struct virtio_net_priv_s *priv)
+{
+  FAR struct net_driver_s *netdev =
+                   &((FAR struct netdev_lowerhalf_s *)&priv->lower)->netdev;
+  FAR struct virtio_device *vdev = priv->vdev;
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CSUM))
+    {
+      netdev->d_features |= NETDEV_FEATURE_TXCSUM;
+
+      if (virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO4))
+        {
+          netdev->d_features |= NETDEV_FEATURE_TSO4;
+        }
+
+      if (virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO6))
+        {
+          netdev->d_features |= NETDEV_FEATURE_TSO6;
+        }
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_GUEST_CSUM))
+    {
+      netdev->d_features |= NETDEV_FEATURE_RXCSUM;
+    }
+
+  /* A super-segment must fit the TX buffers of one packet */
+
+  netdev->d_gso_maxsize = MIN(VIRTIO_NET_TX_NIOB * CONFIG_IOB_BUFSIZE -
+                              CONFIG_NET_LL_GUARDSIZE, UINT16_MAX);
+}
+#endif
+
 static void virtio_net_set_macaddr(FAR struct virtio_net_priv_s *priv)
 {
   FAR struct net_driver_s *dev =
@@ -650,10 +1144,22 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   /* Initialize the netdev lower half */
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
-  netdev->quota[NETPKT_RX] = priv->bufnum;
-  netdev->quota[NETPKT_TX] = priv->bufnum;
+  netdev->quota[NETPKT_RX] = priv->bufnum * priv->npairs;
+  netdev->quota[NETPKT_TX] = priv->bufnum * priv->npairs;
   netdev->ops = &g_virtio_net_ops;
 
+#if VIRTIO_NET_MAX_PAIRS > 1
+  if (priv->npairs > 1)
+    {
+      netdev->rxqueues = priv->npairs;
+      netdev->txqueues = priv->npairs;
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  virtio_net_set_features(priv);
+#endif
+
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
    * no more WiFi interfaces will be created.
@@ -39,6 +39,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 
@@ -73,6 +74,31 @@ struct cromfs_file_s
   FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
 };
 
+#if CONFIG_FS_CROMFS_CACHE_SIZE > 0
+/* A decompressed block in the cache of the volume, identified by the
+ * volume offset of its compressed data.
+ */
+
+struct cromfs_block_s
+{
+  uint32_t cb_offset;                       /* Volume offset, zero if free */
+  uint32_t cb_age;                          /* Last use, for LRU replacement */
+  uint16_t cb_ulen;                         /* Length of decompressed data */
+  FAR uint8_t *cb_data;                     /* cv_bsize bytes */
+};
+
+/* The cache of decompressed blocks, shared by all open files */
+
+struct cromfs_cache_s
+{
+  mutex_t cc_lock;                          /* Protects the cache */
+  uint32_t cc_clock;                        /* Age of the most recent use */
+  unsigned int cc_nblocks;                  /* Number of blocks */
+  unsigned int cc_nmounts;                  /* Number of mounts */
+  FAR struct cromfs_block_s *cc_blocks;
+};
+#endif
+
 /* This is the form of the callback from cromfs_foreach_node(): */
 
 typedef CODE int (*cromfs_foreach_t)(FAR const struct cromfs_volume_s *fs,
@@ -114,6 +140,9 @@ static FAR void *cromfs_offset2addr(FAR const struct cromfs_volume_s *fs,
                                     uint32_t offset);
 static uint32_t cromfs_addr2offset(FAR const struct cromfs_volume_s *fs,
                                    FAR const void *addr);
+static unsigned int cromfs_decompress(FAR const struct cromfs_volume_s *fs,
+                                      FAR const uint8_t *src, uint16_t clen,
+                                      FAR uint8_t *dest);
 static int      cromfs_follow_link(FAR const struct cromfs_volume_s *fs,
                                    FAR const struct cromfs_node_s **ppnode,
                                    bool follow,
@@ -225,6 +254,15 @@ const struct mountpt_operations g_cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+#if CONFIG_FS_CROMFS_CACHE_SIZE > 0
+/* Since there is a single image, its cache is global as well */
+
+static struct cromfs_cache_s g_cromfs_cache =
+{
+  NXMUTEX_INITIALIZER
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -293,6 +331,84 @@ static uint32_t cromfs_addr2offset(FAR const struct cromfs_volume_s *fs,
   return offset;
 }
 
+/****************************************************************************
+ * Name: cromfs_decompress
+ *
+ * Description:
+ *   Decompress the LZF block at 'src' into 'dest', a buffer of cv_bsize
+ *   bytes.  Recently used blocks are kept decompressed in the cache, so
+ *   random reads do not decompress the same block over and over.
+ *
+ ****************************************************************************/
+
+static unsigned int cromfs_decompress(FAR const struct cromfs_volume_s *fs,
+                                      FAR const uint8_t *src, uint16_t clen,
+                                      FAR uint8_t *dest)
+{
+#if CONFIG_FS_CROMFS_CACHE_SIZE > 0
+  FAR struct cromfs_cache_s *cache = &g_cromfs_cache;
+  FAR struct cromfs_block_s *victim;
+  FAR struct cromfs_block_s *blk;
+  uint32_t voloffs;
+  unsigned int i;
+#endif
+  unsigned int decomplen;
+
+#if CONFIG_FS_CROMFS_CACHE_SIZE > 0
+  voloffs = cromfs_addr2offset(fs, src);
+
+  nxmutex_lock(&cache->cc_lock);
+  for (i = 0; i < cache->cc_nblocks; i++)
+    {
+      blk = &cache->cc_blocks[i];
+      if (blk->cb_offset == voloffs)
+        {
+          memcpy(dest, blk->cb_data, blk->cb_ulen);
+          blk->cb_age = ++cache->cc_clock;
+          nxmutex_unlock(&cache->cc_lock);
+          return blk->cb_ulen;
+        }
+    }
+
+  nxmutex_unlock(&cache->cc_lock);
+#endif
+
+  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
+
+#if CONFIG_FS_CROMFS_CACHE_SIZE > 0
+  if (decomplen > 0 && cache->cc_nblocks > 0)
+    {
+      /* Replace a free or the least recently used block */
+
+      nxmutex_lock(&cache->cc_lock);
+      victim = &cache->cc_blocks[0];
+      for (i = 0; i < cache->cc_nblocks; i++)
+        {
+          blk = &cache->cc_blocks[i];
+          if (blk->cb_offset == 0)
+            {
+              victim = blk;
+              break;
+            }
+
+          if (cache->cc_clock - blk->cb_age >
+              cache->cc_clock - victim->cb_age)
+            {
+              victim = blk;
+            }
+        }
+
+      memcpy(victim->cb_data, dest, decomplen);
+      victim->cb_offset = voloffs;
+      victim->cb_ulen   = decomplen;
+      victim->cb_age    = ++cache->cc_clock;
+      nxmutex_unlock(&cache->cc_lock);
+    }
+#endif
+
+  return decomplen;
+}
+
 /****************************************************************************
  * Name: cromfs_follow_link
  *
@@ -997,20 +1113,22 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
               src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
               voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
+              if (voloffs == ff->ff_offset)
+                {
+                  memcpy(dest, ff->ff_buffer, copysize);
+                }
+              else
                 {
                   unsigned int decomplen;
 
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+                  decomplen = cromfs_decompress(fs, src, clen, dest);
+                  UNUSED(decomplen);
+                  DEBUGASSERT(decomplen >= copysize);
                 }
 
               finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32
                     " ulen=%" PRIu16 " ff_offset=%" PRIu32 " copysize=%u\n",
                     voloffs, blkoffs, ulen, ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
             }
           else
             {
@@ -1040,8 +1158,8 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
                 {
                   unsigned int decomplen;
 
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
-                                             fs->cv_bsize);
+                  decomplen = cromfs_decompress(fs, src, clen,
+                                                ff->ff_buffer);
 
                   ff->ff_offset = voloffs;
                   ff->ff_ulen   = decomplen;
@@ -1431,6 +1549,48 @@ static int cromfs_bind(FAR struct inode *blkdriver, FAR const void *data,
   DEBUGASSERT(blkdriver == NULL && handle != NULL);
   DEBUGASSERT(g_cromfs_image.cv_magic == CROMFS_MAGIC);
 
+#if CONFIG_FS_CROMFS_CACHE_SIZE > 0
+  /* Allocate the cache of decompressed blocks with the first mount */
+
+  nxmutex_lock(&g_cromfs_cache.cc_lock);
+  if (g_cromfs_cache.cc_nmounts++ == 0)
+    {
+      FAR const struct cromfs_volume_s *fs = &g_cromfs_image;
+      FAR struct cromfs_block_s *blocks;
+      FAR uint8_t *data;
+      unsigned int nblocks;
+      unsigned int i;
+
+      nblocks = CONFIG_FS_CROMFS_CACHE_SIZE / fs->cv_bsize;
+      if (nblocks > 0)
+        {
+          blocks = kmm_zalloc(nblocks * (sizeof(struct cromfs_block_s) +
+                                         fs->cv_bsize));
+          if (blocks == NULL)
+            {
+              /* Work without the cache */
+
+              ferr("ERROR: Failed to allocate the block cache\n");
+              nblocks = 0;
+            }
+          else
+            {
+              data = (FAR uint8_t *)&blocks[nblocks];
+              for (i = 0; i < nblocks; i++)
+                {
+                  blocks[i].cb_data = data + i * fs->cv_bsize;
+                }
+
+              g_cromfs_cache.cc_blocks = blocks;
+            }
+        }
+
+      g_cromfs_cache.cc_nblocks = nblocks;
+    }
+
+  nxmutex_unlock(&g_cromfs_cache.cc_lock);
+#endif
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)&g_cromfs_image;
@@ -1450,6 +1610,21 @@ static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 {
   finfo("handle: %p blkdriver: %p flags: %02x\n",
         handle, blkdriver, flags);
+
+#if CONFIG_FS_CROMFS_CACHE_SIZE > 0
+  /* Free the cache of decompressed blocks with the last mount */
+
+  nxmutex_lock(&g_cromfs_cache.cc_lock);
+  if (--g_cromfs_cache.cc_nmounts == 0)
+    {
+      kmm_free(g_cromfs_cache.cc_blocks);
+      g_cromfs_cache.cc_blocks  = NULL;
+      g_cromfs_cache.cc_nblocks = 0;
+    }
+
+  nxmutex_unlock(&g_cromfs_cache.cc_lock);
+#endif
+
   return OK;
 }
 
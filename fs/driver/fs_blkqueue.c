@@ -0,0 +1,472 @@
+/****************************************************************************
+ * fs/driver/fs_blkqueue.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/fs/blkqueue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Batch numbers wrap around */
+
+#define BATCH_BEFORE(a, b)  ((int)((a) - (b)) < 0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct blk_sync_s
+{
+  struct blk_request_s req;
+  sem_t sem;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blk_queue_overlap
+ *
+ * Description:
+ *   Return true if 'req' must not be reordered with any request of the
+ *   list of the current batch:  Both touch the same sectors and at least
+ *   one of them modifies them.
+ *
+ ****************************************************************************/
+
+static bool blk_queue_overlap(FAR struct blk_queue_s *queue,
+                              FAR struct blk_request_s *list,
+                              FAR struct blk_request_s *req)
+{
+  for (; list != NULL; list = list->flink)
+    {
+      if (list->batch == queue->batch &&
+          (list->op != BLK_REQ_READ || req->op != BLK_REQ_READ) &&
+          list->sector < req->sector + req->nsectors &&
+          req->sector < list->sector + list->total)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: blk_queue_merge
+ *
+ * Description:
+ *   Try to merge 'req' at the end or at the beginning of a pending request
+ *   of the same batch.
+ *
+ ****************************************************************************/
+
+static bool blk_queue_merge(FAR struct blk_queue_s *queue,
+                            FAR struct blk_request_s *req)
+{
+  FAR struct blk_request_s **pprev;
+  FAR struct blk_request_s *pend;
+
+  for (pprev = &queue->pending; (pend = *pprev) != NULL;
+       pprev = &pend->flink)
+    {
+      if (pend->batch != req->batch || pend->op != req->op ||
+          req->op > BLK_REQ_WRITE || pend->nsegs >= queue->maxsegs ||
+          pend->total + req->nsectors > queue->maxsectors)
+        {
+          continue;
+        }
+
+      if (pend->sector + pend->total == req->sector)
+        {
+          pend->tail->merged = req;
+          pend->tail         = req;
+          pend->total       += req->nsectors;
+          pend->nsegs++;
+          return true;
+        }
+
+      if (req->sector + req->nsectors == pend->sector)
+        {
+          req->merged = pend;
+          req->tail   = pend->tail;
+          req->total  = req->nsectors + pend->total;
+          req->nsegs  = pend->nsegs + 1;
+          req->flink  = pend->flink;
+          pend->flink = NULL;
+          *pprev      = req;
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: blk_queue_insert
+ *
+ * Description:
+ *   Insert 'req' in the pending list that is sorted by batch, then sector.
+ *
+ ****************************************************************************/
+
+static void blk_queue_insert(FAR struct blk_queue_s *queue,
+                             FAR struct blk_request_s *req)
+{
+  FAR struct blk_request_s **pprev;
+  FAR struct blk_request_s *pend;
+
+  for (pprev = &queue->pending; (pend = *pprev) != NULL;
+       pprev = &pend->flink)
+    {
+      if (BATCH_BEFORE(req->batch, pend->batch) ||
+          (req->batch == pend->batch && req->sector < pend->sector))
+        {
+          break;
+        }
+    }
+
+  req->flink = pend;
+  *pprev     = req;
+}
+
+/****************************************************************************
+ * Name: blk_queue_next
+ *
+ * Description:
+ *   Remove the next request to dispatch from the pending list, or return
+ *   NULL if none can be dispatched now.  Within a batch, requests are
+ *   dispatched in ascending sector order from the current position, then
+ *   the scan restarts from the lowest sector (C-LOOK).  A batch starts only
+ *   when all the requests of the previous one are done.  Called with the
+ *   queue locked.
+ *
+ ****************************************************************************/
+
+static FAR struct blk_request_s *
+blk_queue_next(FAR struct blk_queue_s *queue)
+{
+  FAR struct blk_request_s **pfirst;
+  FAR struct blk_request_s **pprev;
+  FAR struct blk_request_s *pend;
+  FAR struct blk_request_s *req;
+  unsigned int batch;
+
+  req = queue->pending;
+  if (req == NULL || queue->nplug > 0 || queue->nactive >= queue->depth ||
+      (queue->nactive > 0 && req->batch != queue->curbatch))
+    {
+      return NULL;
+    }
+
+  batch  = req->batch;
+  pfirst = &queue->pending;
+  for (pprev = pfirst; (pend = *pprev) != NULL && pend->batch == batch;
+       pprev = &pend->flink)
+    {
+      if (pend->sector >= queue->position)
+        {
+          pfirst = pprev;
+          break;
+        }
+    }
+
+  req     = *pfirst;
+  *pfirst = req->flink;
+
+  req->flink      = queue->active;
+  queue->active   = req;
+  queue->curbatch = batch;
+  queue->position = req->sector + req->total;
+  queue->nactive++;
+  return req;
+}
+
+/****************************************************************************
+ * Name: blk_queue_finish
+ *
+ * Description:
+ *   Retire a dispatched request and complete all the requests merged in it.
+ *
+ ****************************************************************************/
+
+static void blk_queue_finish(FAR struct blk_queue_s *queue,
+                             FAR struct blk_request_s *req, ssize_t result)
+{
+  FAR struct blk_request_s **pprev;
+  FAR struct blk_request_s *next;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&queue->lock);
+  for (pprev = &queue->active; *pprev != NULL; pprev = &(*pprev)->flink)
+    {
+      if (*pprev == req)
+        {
+          *pprev = req->flink;
+          queue->nactive--;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&queue->lock, flags);
+
+  /* The driver reports the sectors transferred from the start of the
+   * chain:  Give each request its share.  The callback may free the
+   * request, so fetch the link first.
+   */
+
+  for (; req != NULL; req = next)
+    {
+      next        = req->merged;
+      req->merged = NULL;
+      req->flink  = NULL;
+
+      if (result < 0 || req->op == BLK_REQ_FLUSH)
+        {
+          req->result = result;
+        }
+      else
+        {
+          req->result = MIN((size_t)result, req->nsectors);
+          result     -= req->result;
+        }
+
+      req->complete(req);
+    }
+}
+
+/****************************************************************************
+ * Name: blk_queue_run
+ *
+ * Description:
+ *   Dispatch as many pending requests as the driver accepts.
+ *
+ ****************************************************************************/
+
+static void blk_queue_run(FAR struct blk_queue_s *queue)
+{
+  FAR struct blk_request_s *req;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&queue->lock);
+      req = blk_queue_next(queue);
+      spin_unlock_irqrestore(&queue->lock, flags);
+
+      if (req == NULL)
+        {
+          break;
+        }
+
+      ret = queue->ops->dispatch(queue, req);
+      if (ret < 0)
+        {
+          blk_queue_finish(queue, req, ret);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: blk_queue_sync_complete
+ ****************************************************************************/
+
+static void blk_queue_sync_complete(FAR struct blk_request_s *req)
+{
+  FAR struct blk_sync_s *sync = req->priv;
+
+  nxsem_post(&sync->sem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blk_queue_init
+ ****************************************************************************/
+
+void blk_queue_init(FAR struct blk_queue_s *queue,
+                    FAR const struct blk_queue_ops_s *ops, FAR void *priv,
+                    uint16_t depth, uint16_t maxsectors, uint8_t maxsegs)
+{
+  DEBUGASSERT(queue != NULL && ops != NULL && ops->dispatch != NULL);
+
+  memset(queue, 0, sizeof(*queue));
+  spin_lock_init(&queue->lock);
+  queue->ops        = ops;
+  queue->priv       = priv;
+  queue->depth      = MAX(depth, 1);
+  queue->maxsectors = MAX(maxsectors, 1);
+  queue->maxsegs    = MIN(MAX(maxsegs, 1), CONFIG_FS_BLKQUEUE_MAXSEGS);
+}
+
+/****************************************************************************
+ * Name: blk_queue_submit
+ ****************************************************************************/
+
+int blk_queue_submit(FAR struct blk_queue_s *queue,
+                     FAR struct blk_request_s *req)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(queue != NULL && req != NULL && req->complete != NULL);
+
+  if (req->op > BLK_REQ_ZEROES ||
+      (req->op != BLK_REQ_FLUSH && req->nsectors == 0))
+    {
+      return -EINVAL;
+    }
+
+  req->flink  = NULL;
+  req->merged = NULL;
+  req->tail   = req;
+  req->total  = req->op == BLK_REQ_FLUSH ? 0 : req->nsectors;
+  req->nsegs  = 1;
+  req->result = 0;
+
+  flags = spin_lock_irqsave(&queue->lock);
+
+  if (req->op == BLK_REQ_FLUSH)
+    {
+      /* A flush is a barrier:  It is alone in its batch, which starts when
+       * all the earlier requests are done.
+       */
+
+      req->batch = ++queue->batch;
+      queue->batch++;
+      blk_queue_insert(queue, req);
+    }
+  else
+    {
+      /* Requests that depend on each other go to a new batch, so that they
+       * execute in submission order.
+       */
+
+      if (blk_queue_overlap(queue, queue->pending, req) ||
+          blk_queue_overlap(queue, queue->active, req))
+        {
+          queue->batch++;
+        }
+
+      req->batch = queue->batch;
+      if (!blk_queue_merge(queue, req))
+        {
+          blk_queue_insert(queue, req);
+        }
+    }
+
+  spin_unlock_irqrestore(&queue->lock, flags);
+
+  blk_queue_run(queue);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blk_queue_plug
+ ****************************************************************************/
+
+void blk_queue_plug(FAR struct blk_queue_s *queue)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&queue->lock);
+  queue->nplug++;
+  spin_unlock_irqrestore(&queue->lock, flags);
+}
+
+/****************************************************************************
+ * Name: blk_queue_unplug
+ ****************************************************************************/
+
+void blk_queue_unplug(FAR struct blk_queue_s *queue)
+{
+  irqstate_t flags;
+  bool run;
+
+  flags = spin_lock_irqsave(&queue->lock);
+  DEBUGASSERT(queue->nplug > 0);
+  run = --queue->nplug == 0;
+  spin_unlock_irqrestore(&queue->lock, flags);
+
+  if (run)
+    {
+      blk_queue_run(queue);
+    }
+}
+
+/****************************************************************************
+ * Name: blk_queue_complete
+ ****************************************************************************/
+
+void blk_queue_complete(FAR struct blk_queue_s *queue,
+                        FAR struct blk_request_s *req, ssize_t result)
+{
+  blk_queue_finish(queue, req, result);
+  blk_queue_run(queue);
+}
+
+/****************************************************************************
+ * Name: blk_queue_sync
+ ****************************************************************************/
+
+ssize_t blk_queue_sync(FAR struct blk_queue_s *queue, uint8_t op,
+                       FAR void *buffer, blkcnt_t sector,
+                       unsigned int nsectors)
+{
+  struct blk_sync_s sync;
+  ssize_t ret;
+
+  nxsem_init(&sync.sem, 0, 0);
+
+  sync.req.buffer   = buffer;
+  sync.req.sector   = sector;
+  sync.req.nsectors = nsectors;
+  sync.req.op       = op;
+  sync.req.complete = blk_queue_sync_complete;
+  sync.req.priv     = &sync;
+
+  ret = blk_queue_submit(queue, &sync.req);
+  if (ret >= 0)
+    {
+      nxsem_wait_uninterruptible(&sync.sem);
+      ret = sync.req.result;
+    }
+
+  nxsem_destroy(&sync.sem);
+  return ret;
+}
@@ -0,0 +1,1027 @@
+/****************************************************************************
+ * fs/driver/fs_blockcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mount.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+
+#include "driver/driver.h"
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BCACHE_WAYS      CONFIG_FS_BLOCKCACHE_WAYS
+#define BCACHE_READAHEAD CONFIG_FS_BLOCKCACHE_READAHEAD
+
+/* Maximum number of dirty sectors written back with one request */
+
+#define BCACHE_NRUN      8
+
+/* Size of the bounce buffer in sectors.  Write-back and read-ahead use
+ * separate parts of it, as the sectors just read ahead may evict dirty
+ * sectors.
+ */
+
+#define BCACHE_NBOUNCE   (BCACHE_NRUN + BCACHE_READAHEAD)
+
+#define BCACHE_INVALID   ((blkcnt_t)-1)
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BLOCKCACHE)
+#  define BCACHE_PROCFS  1
+#  define BCACHE_LINELEN 96
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached sector */
+
+struct bcache_block_s
+{
+  blkcnt_t sector;             /* Cached sector or BCACHE_INVALID */
+  bool dirty;                  /* Not yet written to the parent */
+  FAR uint8_t *data;           /* Sector data */
+};
+
+/* The state of one block cache.  The sector 's' is cached in the set
+ * 's % nsets', and the ways of each set are kept in LRU order with the
+ * most recently used sector first.
+ */
+
+struct bcache_dev_s
+{
+  FAR struct bcache_dev_s *flink;  /* Next block cache */
+  FAR struct inode *parent;        /* The cached block driver */
+  mutex_t lock;                    /* Serializes the cache */
+  blksize_t sectorsize;            /* Size of one sector */
+  blkcnt_t nsectors;               /* Number of sectors of the parent */
+  blkcnt_t nextread;               /* Sector of the next sequential read */
+  unsigned int nsets;              /* Number of sets */
+  unsigned int nblocks;            /* Number of cached sectors */
+  unsigned int crefs;              /* Number of opens */
+  FAR struct bcache_block_s *blocks;
+  FAR uint8_t *bounce;             /* Write-back buffer */
+  FAR uint8_t *ahead;              /* Read-ahead buffer, after bounce */
+
+  /* Statistics */
+
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t readaheads;
+  uint32_t writebacks;
+};
+
+#ifdef BCACHE_PROCFS
+struct bcache_file_s
+{
+  struct procfs_file_s base;       /* Base open file structure */
+  char line[BCACHE_LINELEN];       /* Pre-allocated buffer for lines */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     bcache_open(FAR struct inode *inode);
+static int     bcache_close(FAR struct inode *inode);
+static ssize_t bcache_read(FAR struct inode *inode,
+                           FAR unsigned char *buffer,
+                           blkcnt_t start_sector, unsigned int nsectors);
+static ssize_t bcache_write(FAR struct inode *inode,
+                            FAR const unsigned char *buffer,
+                            blkcnt_t start_sector, unsigned int nsectors);
+static int     bcache_geometry(FAR struct inode *inode,
+                               FAR struct geometry *geometry);
+static int     bcache_ioctl(FAR struct inode *inode, int cmd,
+                            unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     bcache_unlink(FAR struct inode *inode);
+#endif
+
+#ifdef BCACHE_PROCFS
+static int     bcache_procfs_open(FAR struct file *filep,
+                                  FAR const char *relpath,
+                                  int oflags, mode_t mode);
+static int     bcache_procfs_close(FAR struct file *filep);
+static ssize_t bcache_procfs_read(FAR struct file *filep,
+                                  FAR char *buffer, size_t buflen);
+static int     bcache_procfs_dup(FAR const struct file *oldp,
+                                 FAR struct file *newp);
+static int     bcache_procfs_stat(FAR const char *relpath,
+                                  FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_bcache_bops =
+{
+  bcache_open,     /* open     */
+  bcache_close,    /* close    */
+  bcache_read,     /* read     */
+  bcache_write,    /* write    */
+  bcache_geometry, /* geometry */
+  bcache_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , bcache_unlink  /* unlink   */
+#endif
+};
+
+/* All the block caches, for procfs */
+
+static FAR struct bcache_dev_s *g_bcache_head;
+static mutex_t g_bcache_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef BCACHE_PROCFS
+const struct procfs_operations g_blockcache_operations =
+{
+  bcache_procfs_open,  /* open */
+  bcache_procfs_close, /* close */
+  bcache_procfs_read,  /* read */
+  NULL,                /* write */
+  NULL,                /* poll */
+  bcache_procfs_dup,   /* dup */
+  NULL,                /* opendir */
+  NULL,                /* closedir */
+  NULL,                /* readdir */
+  NULL,                /* rewinddir */
+  bcache_procfs_stat   /* stat */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bcache_set
+ *
+ * Description:
+ *   Return the first way of the set that holds 'sector'.
+ *
+ ****************************************************************************/
+
+static inline FAR struct bcache_block_s *
+bcache_set(FAR struct bcache_dev_s *dev, blkcnt_t sector)
+{
+  return &dev->blocks[(sector % dev->nsets) * BCACHE_WAYS];
+}
+
+/****************************************************************************
+ * Name: bcache_find
+ *
+ * Description:
+ *   Look up 'sector' in the cache, and make it the most recently used
+ *   sector of its set if 'touch' is true.
+ *
+ * Returned Value:
+ *   The cached sector, or NULL if the sector is not cached.
+ *
+ ****************************************************************************/
+
+static FAR struct bcache_block_s *
+bcache_find(FAR struct bcache_dev_s *dev, blkcnt_t sector, bool touch)
+{
+  FAR struct bcache_block_s *set = bcache_set(dev, sector);
+  struct bcache_block_s block;
+  int way;
+
+  for (way = 0; way < BCACHE_WAYS; way++)
+    {
+      if (set[way].sector == sector)
+        {
+          if (touch && way > 0)
+            {
+              block = set[way];
+              memmove(&set[1], &set[0], way * sizeof(block));
+              set[0] = block;
+              way    = 0;
+            }
+
+          return &set[way];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: bcache_writeback
+ *
+ * Description:
+ *   Write a dirty sector back to the parent, together with the dirty
+ *   sectors around it so that the parent gets a single request.
+ *
+ ****************************************************************************/
+
+static int bcache_writeback(FAR struct bcache_dev_s *dev,
+                            FAR struct bcache_block_s *block)
+{
+  FAR struct inode *parent = dev->parent;
+  FAR struct bcache_block_s *run[BCACHE_NRUN];
+  FAR struct bcache_block_s *next;
+  blkcnt_t first = block->sector;
+  int nrun = 1;
+  int ret;
+  int i;
+
+  /* Extend the run backward, then forward */
+
+  while (first > 0 && nrun < BCACHE_NRUN &&
+         (next = bcache_find(dev, first - 1, false)) != NULL && next->dirty)
+    {
+      first--;
+      nrun++;
+    }
+
+  for (i = 0; i < nrun; i++)
+    {
+      run[i] = bcache_find(dev, first + i, false);
+    }
+
+  while (nrun < BCACHE_NRUN &&
+         (next = bcache_find(dev, first + nrun, false)) != NULL &&
+         next->dirty)
+    {
+      run[nrun++] = next;
+    }
+
+  if (nrun == 1)
+    {
+      ret = parent->u.i_bops->write(parent, block->data, first, 1);
+    }
+  else
+    {
+      for (i = 0; i < nrun; i++)
+        {
+          memcpy(dev->bounce + i * dev->sectorsize, run[i]->data,
+                 dev->sectorsize);
+        }
+
+      ret = parent->u.i_bops->write(parent, dev->bounce, first, nrun);
+    }
+
+  if (ret < 0)
+    {
+      ferr("ERROR: Write back of sector %" PRIuOFF " failed: %d\n",
+           (off_t)first, ret);
+      return ret;
+    }
+
+  for (i = 0; i < nrun; i++)
+    {
+      run[i]->dirty = false;
+    }
+
+  dev->writebacks += nrun;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_alloc
+ *
+ * Description:
+ *   Get a way for 'sector' by evicting the least recently used sector of
+ *   its set, and make it the most recently used one.
+ *
+ ****************************************************************************/
+
+static FAR struct bcache_block_s *
+bcache_alloc(FAR struct bcache_dev_s *dev, blkcnt_t sector)
+{
+  FAR struct bcache_block_s *set = bcache_set(dev, sector);
+  FAR struct bcache_block_s *lru = &set[BCACHE_WAYS - 1];
+  struct bcache_block_s block;
+
+  if (lru->sector != BCACHE_INVALID && lru->dirty &&
+      bcache_writeback(dev, lru) < 0)
+    {
+      return NULL;
+    }
+
+  block = *lru;
+  memmove(&set[1], &set[0], (BCACHE_WAYS - 1) * sizeof(block));
+  set[0]        = block;
+  set[0].sector = sector;
+  set[0].dirty  = false;
+  return &set[0];
+}
+
+/****************************************************************************
+ * Name: bcache_fill
+ *
+ * Description:
+ *   Add clean sectors just read from the parent to the cache.
+ *
+ ****************************************************************************/
+
+static void bcache_fill(FAR struct bcache_dev_s *dev,
+                        FAR const uint8_t *buffer, blkcnt_t sector,
+                        unsigned int nsectors)
+{
+  FAR struct bcache_block_s *block;
+
+  for (; nsectors > 0; nsectors--, sector++, buffer += dev->sectorsize)
+    {
+      block = bcache_alloc(dev, sector);
+      if (block != NULL)
+        {
+          memcpy(block->data, buffer, dev->sectorsize);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bcache_readahead
+ *
+ * Description:
+ *   Read the sectors following a sequential read into the cache.
+ *
+ ****************************************************************************/
+
+#if BCACHE_READAHEAD > 0
+static void bcache_readahead(FAR struct bcache_dev_s *dev, blkcnt_t sector)
+{
+  FAR struct inode *parent = dev->parent;
+  unsigned int nsectors = 0;
+  ssize_t ret;
+
+  while (nsectors < BCACHE_READAHEAD && sector + nsectors < dev->nsectors &&
+         bcache_find(dev, sector + nsectors, false) == NULL)
+    {
+      nsectors++;
+    }
+
+  if (nsectors == 0)
+    {
+      return;
+    }
+
+  ret = parent->u.i_bops->read(parent, dev->ahead, sector, nsectors);
+  if (ret > 0)
+    {
+      bcache_fill(dev, dev->ahead, sector, ret);
+      dev->readaheads += ret;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: bcache_flush
+ *
+ * Description:
+ *   Write all dirty sectors back to the parent.
+ *
+ ****************************************************************************/
+
+static int bcache_flush(FAR struct bcache_dev_s *dev)
+{
+  unsigned int i;
+  int ret = OK;
+
+  for (i = 0; i < dev->nblocks; i++)
+    {
+      FAR struct bcache_block_s *block = &dev->blocks[i];
+
+      if (block->sector != BCACHE_INVALID && block->dirty)
+        {
+          int err = bcache_writeback(dev, block);
+          if (err < 0)
+            {
+              ret = err;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_invalidate
+ *
+ * Description:
+ *   Drop all cached sectors, dirty or not.
+ *
+ ****************************************************************************/
+
+static void bcache_invalidate(FAR struct bcache_dev_s *dev)
+{
+  unsigned int i;
+
+  for (i = 0; i < dev->nblocks; i++)
+    {
+      dev->blocks[i].sector = BCACHE_INVALID;
+      dev->blocks[i].dirty  = false;
+    }
+
+  dev->nextread = BCACHE_INVALID;
+}
+
+/****************************************************************************
+ * Name: bcache_free
+ ****************************************************************************/
+
+static void bcache_free(FAR struct bcache_dev_s *dev)
+{
+  nxmutex_destroy(&dev->lock);
+  kmm_free(dev->bounce);
+  kmm_free(dev);
+}
+
+/****************************************************************************
+ * Name: bcache_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+static int bcache_open(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret = OK;
+
+  if (parent->u.i_bops->open)
+    {
+      ret = parent->u.i_bops->open(parent);
+    }
+
+  if (ret >= 0)
+    {
+      nxmutex_lock(&dev->lock);
+      dev->crefs++;
+      nxmutex_unlock(&dev->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_close
+ *
+ * Description: Close the block device, the last close flushes the cache
+ *
+ ****************************************************************************/
+
+static int bcache_close(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret = OK;
+
+  nxmutex_lock(&dev->lock);
+  DEBUGASSERT(dev->crefs > 0);
+  if (--dev->crefs == 0)
+    {
+      ret = bcache_flush(dev);
+    }
+
+  nxmutex_unlock(&dev->lock);
+
+  if (parent->u.i_bops->close)
+    {
+      int err = parent->u.i_bops->close(parent);
+      if (err < 0)
+        {
+          ret = err;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_read
+ *
+ * Description:  Read the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t bcache_read(FAR struct inode *inode,
+                           FAR unsigned char *buffer,
+                           blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  FAR struct bcache_block_s *block;
+  unsigned int nrun;
+  unsigned int i;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < nsectors; i += nrun)
+    {
+      block = bcache_find(dev, start_sector + i, true);
+      if (block != NULL)
+        {
+          memcpy(buffer + i * dev->sectorsize, block->data,
+                 dev->sectorsize);
+          dev->hits++;
+          nrun = 1;
+          continue;
+        }
+
+      /* Read the whole run of missing sectors with one request */
+
+      for (nrun = 1; i + nrun < nsectors; nrun++)
+        {
+          if (bcache_find(dev, start_sector + i + nrun, false) != NULL)
+            {
+              break;
+            }
+        }
+
+      ret = parent->u.i_bops->read(parent, buffer + i * dev->sectorsize,
+                                   start_sector + i, nrun);
+      if (ret <= 0)
+        {
+          goto out;
+        }
+
+      nrun = ret;
+      dev->misses += nrun;
+
+      /* Do not let a large transfer flush the whole cache */
+
+      if (nsectors < dev->nblocks)
+        {
+          bcache_fill(dev, buffer + i * dev->sectorsize,
+                      start_sector + i, nrun);
+        }
+    }
+
+#if BCACHE_READAHEAD > 0
+  if (start_sector == dev->nextread)
+    {
+      bcache_readahead(dev, start_sector + nsectors);
+    }
+#endif
+
+  dev->nextread = start_sector + nsectors;
+
+out:
+  nxmutex_unlock(&dev->lock);
+  return i > 0 ? (ssize_t)i : ret;
+}
+
+/****************************************************************************
+ * Name: bcache_write
+ *
+ * Description: Write (or buffer) the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t bcache_write(FAR struct inode *inode,
+                            FAR const unsigned char *buffer,
+                            blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  FAR struct bcache_block_s *block;
+  unsigned int i;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#ifdef CONFIG_FS_BLOCKCACHE_WRITEBACK
+  if (nsectors < dev->nblocks)
+    {
+      for (i = 0; i < nsectors; i++)
+        {
+          block = bcache_find(dev, start_sector + i, true);
+          if (block == NULL)
+            {
+              block = bcache_alloc(dev, start_sector + i);
+              if (block == NULL)
+                {
+                  break;
+                }
+            }
+
+          memcpy(block->data, buffer + i * dev->sectorsize,
+                 dev->sectorsize);
+          block->dirty = true;
+        }
+
+      nxmutex_unlock(&dev->lock);
+      return i > 0 ? (ssize_t)i : -EIO;
+    }
+#endif
+
+  /* Write through, and keep the cached copies up to date */
+
+  ret = parent->u.i_bops->write(parent, buffer, start_sector, nsectors);
+  for (i = 0; ret > 0 && i < ret; i++)
+    {
+      block = bcache_find(dev, start_sector + i, false);
+      if (block != NULL)
+        {
+          memcpy(block->data, buffer + i * dev->sectorsize,
+                 dev->sectorsize);
+          block->dirty = false;
+        }
+    }
+
+  nxmutex_unlock(&dev->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int bcache_geometry(FAR struct inode *inode,
+                           FAR struct geometry *geometry)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret;
+
+  ret = parent->u.i_bops->geometry(parent, geometry);
+  if (ret >= 0 && geometry->geo_mediachanged)
+    {
+      /* Nothing that is cached belongs to the new media */
+
+      nxmutex_lock(&dev->lock);
+      bcache_invalidate(dev);
+      dev->nsectors = geometry->geo_nsectors;
+      nxmutex_unlock(&dev->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_ioctl
+ ****************************************************************************/
+
+static int bcache_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret = OK;
+
+  if (cmd == BIOC_FLUSH || cmd == BIOC_XIPBASE)
+    {
+      /* Make the parent see all the data written so far */
+
+      nxmutex_lock(&dev->lock);
+      ret = bcache_flush(dev);
+      nxmutex_unlock(&dev->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+  else if (cmd == BIOC_GETQUEUE)
+    {
+      /* Requests queued to the parent would bypass the cache */
+
+      return -ENOTTY;
+    }
+
+  if (parent->u.i_bops->ioctl == NULL)
+    {
+      return cmd == BIOC_FLUSH ? OK : -ENOTTY;
+    }
+
+  ret = parent->u.i_bops->ioctl(parent, cmd, arg);
+  if (cmd == BIOC_FLUSH && ret == -ENOTTY)
+    {
+      ret = OK;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_unlink
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int bcache_unlink(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev = inode->i_private;
+  FAR struct bcache_dev_s **pprev;
+
+  nxmutex_lock(&g_bcache_lock);
+  for (pprev = &g_bcache_head; *pprev != NULL; pprev = &(*pprev)->flink)
+    {
+      if (*pprev == dev)
+        {
+          *pprev = dev->flink;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_bcache_lock);
+
+  bcache_flush(dev);
+  inode_release(dev->parent);
+  bcache_free(dev);
+  return OK;
+}
+#endif
+
+#ifdef BCACHE_PROCFS
+
+/****************************************************************************
+ * Name: bcache_procfs_open
+ ****************************************************************************/
+
+static int bcache_procfs_open(FAR struct file *filep,
+                              FAR const char *relpath,
+                              int oflags, mode_t mode)
+{
+  FAR struct bcache_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  procfile = kmm_zalloc(sizeof(struct bcache_file_s));
+  if (procfile == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_procfs_close
+ ****************************************************************************/
+
+static int bcache_procfs_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_procfs_read
+ ****************************************************************************/
+
+static ssize_t bcache_procfs_read(FAR struct file *filep,
+                                  FAR char *buffer, size_t buflen)
+{
+  FAR struct bcache_file_s *procfile = filep->f_priv;
+  FAR struct bcache_dev_s *dev;
+  size_t totalsize;
+  size_t linesize;
+  size_t copysize;
+  off_t offset = filep->f_pos;
+
+  DEBUGASSERT(procfile != NULL);
+
+  linesize  = procfs_snprintf(procfile->line, BCACHE_LINELEN,
+                              "%-16s%8s%11s%11s%11s%11s\n",
+                              "Device", "Sectors", "Hits", "Misses",
+                              "Readahead", "Writeback");
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  nxmutex_lock(&g_bcache_lock);
+  for (dev = g_bcache_head; dev != NULL; dev = dev->flink)
+    {
+      buffer   += copysize;
+      buflen   -= copysize;
+
+      linesize  = procfs_snprintf(procfile->line, BCACHE_LINELEN,
+                                  "%-16s%8u%11" PRIu32 "%11" PRIu32
+                                  "%11" PRIu32 "%11" PRIu32 "\n",
+                                  dev->parent->i_name, dev->nblocks,
+                                  dev->hits, dev->misses,
+                                  dev->readaheads, dev->writebacks);
+      copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                &offset);
+      totalsize += copysize;
+    }
+
+  nxmutex_unlock(&g_bcache_lock);
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: bcache_procfs_dup
+ ****************************************************************************/
+
+static int bcache_procfs_dup(FAR const struct file *oldp,
+                             FAR struct file *newp)
+{
+  FAR struct bcache_file_s *newattr;
+
+  newattr = kmm_malloc(sizeof(struct bcache_file_s));
+  if (newattr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldp->f_priv, sizeof(struct bcache_file_s));
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_procfs_stat
+ ****************************************************************************/
+
+static int bcache_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+#endif /* BCACHE_PROCFS */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: register_blockcache
+ *
+ * Description:
+ *   Register a block driver at 'path' that caches the sectors of the
+ *   block driver at 'parent'.  The file systems and the character drivers
+ *   that are opened on the new driver share the cache.
+ *
+ * Input Parameters:
+ *   path     - The path to the caching block driver inode
+ *   mode     - Access privileges
+ *   parent   - The path to the cached block driver
+ *   nsectors - The number of sectors to cache, rounded down to a multiple
+ *              of CONFIG_FS_BLOCKCACHE_WAYS
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int register_blockcache(FAR const char *path, mode_t mode,
+                        FAR const char *parent, unsigned int nsectors)
+{
+  FAR struct bcache_dev_s *dev;
+  FAR struct inode *inode;
+  struct geometry geo;
+  unsigned int nsets;
+  unsigned int i;
+  size_t size;
+  int ret;
+
+  nsets = nsectors / BCACHE_WAYS;
+  if (nsets == 0)
+    {
+      return -EINVAL;
+    }
+
+  if (mode & (S_IWOTH | S_IWGRP | S_IWUSR))
+    {
+      ret = find_blockdriver(parent, 0, &inode);
+    }
+  else
+    {
+      ret = find_blockdriver(parent, MS_RDONLY, &inode);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = inode->u.i_bops->geometry(inode, &geo);
+  if (ret < 0)
+    {
+      goto errout_with_inode;
+    }
+
+  /* Allocate the cache state, the sector descriptors and the sector data
+   * in one chunk, and the bounce buffer separately.
+   */
+
+  nsectors = nsets * BCACHE_WAYS;
+  size     = sizeof(*dev) + nsectors * sizeof(struct bcache_block_s);
+  dev      = kmm_zalloc(size + nsectors * geo.geo_sectorsize);
+  if (dev == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_inode;
+    }
+
+  dev->bounce = kmm_malloc(BCACHE_NBOUNCE * geo.geo_sectorsize);
+  if (dev->bounce == NULL)
+    {
+      kmm_free(dev);
+      ret = -ENOMEM;
+      goto errout_with_inode;
+    }
+
+  nxmutex_init(&dev->lock);
+  dev->parent     = inode;
+  dev->sectorsize = geo.geo_sectorsize;
+  dev->nsectors   = geo.geo_nsectors;
+  dev->nsets      = nsets;
+  dev->nblocks    = nsectors;
+  dev->blocks     = (FAR struct bcache_block_s *)(dev + 1);
+  dev->ahead      = dev->bounce + BCACHE_NRUN * geo.geo_sectorsize;
+
+  for (i = 0; i < nsectors; i++)
+    {
+      dev->blocks[i].data = (FAR uint8_t *)dev + size +
+                            i * geo.geo_sectorsize;
+    }
+
+  bcache_invalidate(dev);
+
+  ret = register_blockdriver(path, &g_bcache_bops, mode, dev);
+  if (ret < 0)
+    {
+      bcache_free(dev);
+      goto errout_with_inode;
+    }
+
+  /* Keep the reference to the parent inode until unlink */
+
+  nxmutex_lock(&g_bcache_lock);
+  dev->flink    = g_bcache_head;
+  g_bcache_head = dev;
+  nxmutex_unlock(&g_bcache_lock);
+  return OK;
+
+errout_with_inode:
+  inode_release(inode);
+  return ret;
+}
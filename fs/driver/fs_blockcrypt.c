@@ -0,0 +1,551 @@
+/****************************************************************************
+ * fs/driver/fs_blockcrypt.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mount.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+#include <strings.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+
+#include <crypto/cryptodev.h>
+
+#include "driver/driver.h"
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of sectors handed to the crypto engine with one request */
+
+#define BCRYPT_NBATCH    CONFIG_FS_BLOCKCRYPT_BATCH
+
+/* AES-XTS: the tweak is the 64-bit sector number, 16-byte cipher blocks
+ * and one AES key for the data plus one for the tweak.
+ */
+
+#define BCRYPT_IVSIZE    8
+#define BCRYPT_BLOCKSIZE 16
+#define BCRYPT_MAXKEY    64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bcrypt_dev_s
+{
+  FAR struct inode *parent;     /* The encrypted block driver */
+  mutex_t lock;                 /* Serializes the request and bounce buffer */
+  uint64_t sid;                 /* Crypto session */
+  blksize_t sectorsize;         /* Size of one sector */
+  FAR struct cryptop *crp;      /* One descriptor per sector of a batch */
+  FAR uint8_t *bounce;          /* Ciphertext of the sectors being written */
+  uint8_t iv[BCRYPT_IVSIZE];    /* Last IV, written back by the engine */
+  uint8_t key[BCRYPT_MAXKEY];   /* Kept to re-create a migrated session */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     bcrypt_open(FAR struct inode *inode);
+static int     bcrypt_close(FAR struct inode *inode);
+static ssize_t bcrypt_read(FAR struct inode *inode,
+                           FAR unsigned char *buffer,
+                           blkcnt_t start_sector, unsigned int nsectors);
+static ssize_t bcrypt_write(FAR struct inode *inode,
+                            FAR const unsigned char *buffer,
+                            blkcnt_t start_sector, unsigned int nsectors);
+static int     bcrypt_geometry(FAR struct inode *inode,
+                               FAR struct geometry *geometry);
+static int     bcrypt_ioctl(FAR struct inode *inode, int cmd,
+                            unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     bcrypt_unlink(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_bcrypt_bops =
+{
+  bcrypt_open,     /* open     */
+  bcrypt_close,    /* close    */
+  bcrypt_read,     /* read     */
+  bcrypt_write,    /* write    */
+  bcrypt_geometry, /* geometry */
+  bcrypt_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , bcrypt_unlink  /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bcrypt_crypt
+ *
+ * Description:
+ *   Encrypt or decrypt 'nsectors' (at most BCRYPT_NBATCH) consecutive
+ *   sectors with a single crypto request.  Each sector is one descriptor
+ *   of the request with the sector number as its XTS tweak, so the engine
+ *   sees the whole batch at once.  'src' and 'dst' may be the same.
+ *
+ ****************************************************************************/
+
+static int bcrypt_crypt(FAR struct bcrypt_dev_s *dev,
+                        FAR const uint8_t *src, FAR uint8_t *dst,
+                        blkcnt_t sector, unsigned int nsectors,
+                        bool encrypt)
+{
+  FAR struct cryptop *crp = dev->crp;
+  FAR struct cryptodesc *crd;
+  FAR struct cryptodesc *last = NULL;
+  FAR struct cryptodesc *next;
+  unsigned int i;
+  uint64_t iv;
+  int retry;
+  int ret;
+
+  DEBUGASSERT(nsectors > 0 && nsectors <= BCRYPT_NBATCH);
+
+  for (i = 0, crd = crp->crp_desc; i < nsectors; i++, crd = crd->crd_next)
+    {
+      iv = sector + i;
+      memcpy(crd->crd_iv, &iv, BCRYPT_IVSIZE);
+
+      crd->crd_skip  = i * dev->sectorsize;
+      crd->crd_len   = dev->sectorsize;
+      crd->crd_flags = CRD_F_IV_EXPLICIT | CRD_F_IV_PRESENT |
+                       (encrypt ? CRD_F_ENCRYPT : 0);
+      last = crd;
+    }
+
+  /* Cut the descriptor chain after the last sector of this batch */
+
+  next = last->crd_next;
+  last->crd_next = NULL;
+
+  for (retry = 0; ; retry++)
+    {
+      crp->crp_sid   = dev->sid;
+      crp->crp_ilen  = nsectors * dev->sectorsize;
+      crp->crp_olen  = crp->crp_ilen;
+      crp->crp_etype = 0;
+      crp->crp_flags = CRYPTO_F_NOQUEUE;
+      crp->crp_buf   = (FAR void *)src;
+      crp->crp_dst   = (caddr_t)dst;
+      crp->crp_iv    = (caddr_t)dev->iv;
+
+      ret = crypto_invoke(crp);
+      if (ret == 0)
+        {
+          ret = crp->crp_etype;
+        }
+
+      /* The session moved to another driver, run it there once */
+
+      if (ret != -EAGAIN || retry > 0)
+        {
+          break;
+        }
+
+      dev->sid = crp->crp_sid;
+    }
+
+  last->crd_next = next;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcrypt_free
+ ****************************************************************************/
+
+static void bcrypt_free(FAR struct bcrypt_dev_s *dev)
+{
+  if (dev->crp != NULL)
+    {
+      crypto_freereq(dev->crp);
+      crypto_freesession(dev->sid);
+    }
+
+  nxmutex_destroy(&dev->lock);
+  explicit_bzero(dev->key, sizeof(dev->key));
+  kmm_free(dev->bounce);
+  kmm_free(dev);
+}
+
+/****************************************************************************
+ * Name: bcrypt_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+static int bcrypt_open(FAR struct inode *inode)
+{
+  FAR struct bcrypt_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret = OK;
+
+  if (parent->u.i_bops->open)
+    {
+      ret = parent->u.i_bops->open(parent);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcrypt_close
+ *
+ * Description: Close the block device
+ *
+ ****************************************************************************/
+
+static int bcrypt_close(FAR struct inode *inode)
+{
+  FAR struct bcrypt_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret = OK;
+
+  if (parent->u.i_bops->close)
+    {
+      ret = parent->u.i_bops->close(parent);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcrypt_read
+ *
+ * Description:
+ *   Read the whole request from the parent with one transfer, then decrypt
+ *   it in place batch by batch.
+ *
+ ****************************************************************************/
+
+static ssize_t bcrypt_read(FAR struct inode *inode,
+                           FAR unsigned char *buffer,
+                           blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct bcrypt_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  FAR uint8_t *data;
+  unsigned int nbatch;
+  unsigned int i;
+  ssize_t ret;
+  int err;
+
+  ret = parent->u.i_bops->read(parent, buffer, start_sector, nsectors);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  err = nxmutex_lock(&dev->lock);
+  if (err < 0)
+    {
+      return err;
+    }
+
+  for (i = 0; i < (unsigned int)ret; i += nbatch)
+    {
+      nbatch = MIN(ret - i, BCRYPT_NBATCH);
+      data   = buffer + i * dev->sectorsize;
+
+      err = bcrypt_crypt(dev, data, data, start_sector + i, nbatch, false);
+      if (err < 0)
+        {
+          ferr("ERROR: decrypt sector %" PRIuOFF " failed: %d\n",
+               (off_t)(start_sector + i), err);
+          break;
+        }
+    }
+
+  nxmutex_unlock(&dev->lock);
+
+  /* Never hand out sectors that are still ciphertext */
+
+  return i > 0 ? (ssize_t)i : err;
+}
+
+/****************************************************************************
+ * Name: bcrypt_write
+ *
+ * Description:
+ *   Encrypt the sectors into the bounce buffer and write them to the
+ *   parent, BCRYPT_NBATCH sectors at a time.
+ *
+ ****************************************************************************/
+
+static ssize_t bcrypt_write(FAR struct inode *inode,
+                            FAR const unsigned char *buffer,
+                            blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct bcrypt_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  unsigned int nbatch;
+  unsigned int i;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < nsectors; i += ret)
+    {
+      nbatch = MIN(nsectors - i, BCRYPT_NBATCH);
+
+      ret = bcrypt_crypt(dev, buffer + i * dev->sectorsize, dev->bounce,
+                         start_sector + i, nbatch, true);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      ret = parent->u.i_bops->write(parent, dev->bounce,
+                                    start_sector + i, nbatch);
+      if (ret <= 0)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&dev->lock);
+  return i > 0 ? (ssize_t)i : ret;
+}
+
+/****************************************************************************
+ * Name: bcrypt_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int bcrypt_geometry(FAR struct inode *inode,
+                           FAR struct geometry *geometry)
+{
+  FAR struct bcrypt_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+
+  return parent->u.i_bops->geometry(parent, geometry);
+}
+
+/****************************************************************************
+ * Name: bcrypt_ioctl
+ ****************************************************************************/
+
+static int bcrypt_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct bcrypt_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+
+  /* A direct mapping or the request queue of the parent would expose the
+   * ciphertext.
+   */
+
+  if (cmd == BIOC_XIPBASE || cmd == BIOC_GETQUEUE)
+    {
+      return -ENOTTY;
+    }
+
+  if (parent->u.i_bops->ioctl == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  return parent->u.i_bops->ioctl(parent, cmd, arg);
+}
+
+/****************************************************************************
+ * Name: bcrypt_unlink
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int bcrypt_unlink(FAR struct inode *inode)
+{
+  FAR struct bcrypt_dev_s *dev = inode->i_private;
+
+  inode_release(dev->parent);
+  bcrypt_free(dev);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: register_blockcrypt
+ *
+ * Description:
+ *   Register a block driver at 'path' that encrypts the sectors of the
+ *   block driver at 'parent' with AES-XTS, using the sector number as the
+ *   tweak.  The work goes through the crypto framework, so a hardware
+ *   engine is used when one supports AES-XTS.
+ *
+ * Input Parameters:
+ *   path   - The path to the encrypting block driver inode
+ *   mode   - Access privileges
+ *   parent - The path to the encrypted block driver
+ *   key    - The XTS key: the data key followed by the tweak key
+ *   keylen - The key length in bytes, 32 (AES-128) or 64 (AES-256)
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int register_blockcrypt(FAR const char *path, mode_t mode,
+                        FAR const char *parent, FAR const uint8_t *key,
+                        size_t keylen)
+{
+  FAR struct bcrypt_dev_s *dev;
+  FAR struct cryptodesc *crd;
+  FAR struct inode *inode;
+  struct cryptoini cri;
+  struct geometry geo;
+  int ret;
+
+  if (key == NULL || (keylen != 32 && keylen != BCRYPT_MAXKEY))
+    {
+      return -EINVAL;
+    }
+
+  if (mode & (S_IWOTH | S_IWGRP | S_IWUSR))
+    {
+      ret = find_blockdriver(parent, 0, &inode);
+    }
+  else
+    {
+      ret = find_blockdriver(parent, MS_RDONLY, &inode);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = inode->u.i_bops->geometry(inode, &geo);
+  if (ret < 0)
+    {
+      goto errout_with_inode;
+    }
+
+  /* XTS is used without ciphertext stealing */
+
+  if (geo.geo_sectorsize == 0 || geo.geo_sectorsize % BCRYPT_BLOCKSIZE)
+    {
+      ret = -EINVAL;
+      goto errout_with_inode;
+    }
+
+  dev = kmm_zalloc(sizeof(*dev));
+  if (dev == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_inode;
+    }
+
+  nxmutex_init(&dev->lock);
+  dev->parent     = inode;
+  dev->sectorsize = geo.geo_sectorsize;
+  memcpy(dev->key, key, keylen);
+
+  dev->bounce = kmm_malloc(BCRYPT_NBATCH * geo.geo_sectorsize);
+  if (dev->bounce == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_dev;
+    }
+
+  /* Open the session, a hardware driver is preferred if there is one */
+
+  memset(&cri, 0, sizeof(cri));
+  cri.cri_alg  = CRYPTO_AES_XTS;
+  cri.cri_klen = keylen * 8;
+  cri.cri_key  = (caddr_t)dev->key;
+
+  ret = crypto_newsession(&dev->sid, &cri, 0);
+  if (ret < 0)
+    {
+      ferr("ERROR: no AES-XTS crypto driver: %d\n", ret);
+      goto errout_with_dev;
+    }
+
+  /* Allocate the descriptors of a full batch once */
+
+  dev->crp = crypto_getreq(BCRYPT_NBATCH);
+  if (dev->crp == NULL)
+    {
+      crypto_freesession(dev->sid);
+      ret = -ENOMEM;
+      goto errout_with_dev;
+    }
+
+  for (crd = dev->crp->crp_desc; crd != NULL; crd = crd->crd_next)
+    {
+      crd->crd_alg  = CRYPTO_AES_XTS;
+      crd->crd_klen = keylen * 8;
+      crd->crd_key  = (caddr_t)dev->key;
+    }
+
+  ret = register_blockdriver(path, &g_bcrypt_bops, mode, dev);
+  if (ret < 0)
+    {
+      goto errout_with_dev;
+    }
+
+  /* Keep the reference to the parent inode until unlink */
+
+  return OK;
+
+errout_with_dev:
+  bcrypt_free(dev);
+
+errout_with_inode:
+  inode_release(inode);
+  return ret;
+}
@@ -28,6 +28,7 @@
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <sys/mount.h>
+#include <sys/param.h>
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -615,6 +616,29 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
       num_traversed = 1;
     }
 
+#ifdef CONFIG_FAT_EXTENT_CACHE
+  /* Skip the part of the chain that is already known */
+
+  if (num_traversed > 0 && MIN(num_clu, new_num_clu) > num_traversed)
+    {
+      uint32_t index;
+      uint32_t known;
+
+      if (fat_extent_lookup(ff, MIN(num_clu, new_num_clu) - 1,
+                            &index, &known) &&
+          index + 1 > num_traversed)
+        {
+          cluster = known;
+          num_traversed = index + 1;
+        }
+    }
+
+  if (num_traversed > 0)
+    {
+      fat_extent_add(ff, num_traversed - 1, cluster);
+    }
+#endif
+
   /* Traverse the existing chain */
 
   for (i = num_traversed; i < num_clu && i < new_num_clu; i++)
@@ -627,6 +651,10 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
         {
           return -EIO;
         }
+
+#ifdef CONFIG_FAT_EXTENT_CACHE
+      fat_extent_add(ff, i, cluster);
+#endif
     }
 
   if (read)
@@ -679,6 +707,10 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+#ifdef CONFIG_FAT_EXTENT_CACHE
+      fat_extent_add(ff, i, cluster);
+#endif
+
       /* zero area (2) */
 
       ret = fat_zero_cluster(fs, cluster, 0, clu_size);
@@ -702,6 +734,10 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+#ifdef CONFIG_FAT_EXTENT_CACHE
+      fat_extent_add(ff, i, cluster);
+#endif
+
       /* zero area (3) */
 
       zero_end = filep->f_pos & (clu_size -1);
@@ -1485,6 +1521,14 @@ static int fat_sync(FAR struct file *filep)
        */
 
       ret          = fat_updatefsinfo(fs);
+      if (ret >= 0)
+        {
+          /* Then make sure that nothing stays in a write-back cache of
+           * the block driver.
+           */
+
+          ret = fat_hwflush(fs);
+        }
     }
 
 errout_with_lock:
@@ -1594,6 +1638,10 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+#ifdef CONFIG_FAT_EXTENT_CACHE
+  newff->ff_nextents         = oldff->ff_nextents;         /* Cached extents */
+  memcpy(newff->ff_extents, oldff->ff_extents, sizeof(newff->ff_extents));
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -1928,6 +1976,26 @@ static int fat_truncate(FAR struct file *filep, off_t length)
 
       if (ret >= 0)
         {
+#ifdef CONFIG_FAT_EXTENT_CACHE
+          FAR struct fat_file_s *tmp;
+          uint32_t nclusters;
+
+          /* Forget the removed clusters in every open instance of the
+           * file.
+           */
+
+          nclusters = DIV_ROUND_UP(length, fs->fs_fatsecperclus *
+                                           fs->fs_hwsectorsize);
+          for (tmp = fs->fs_head; tmp != NULL; tmp = tmp->ff_next)
+            {
+              if (tmp->ff_dirsector == ff->ff_dirsector &&
+                  tmp->ff_dirindex == ff->ff_dirindex)
+                {
+                  fat_extent_truncate(tmp, nclusters);
+                }
+            }
+#endif
+
           /* The truncation has completed without error.  Update the file
            * size.
            */
@@ -2353,6 +2421,10 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  fat_freemap_release(fs);
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   kmm_free(fs);
   return OK;
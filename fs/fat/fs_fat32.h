@@ -887,7 +887,22 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FAT_FREEMAP
+  FAR uint32_t *fs_freemap;        /* Bitmap of the allocated clusters */
+  bool     fs_nofreemap;           /* true: The bitmap could not be built */
+#endif
+};
+
+/* This structure describes a run of contiguous clusters of a file */
+
+#ifdef CONFIG_FAT_EXTENT_CACHE
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* Index of the first cluster in the file */
+  uint32_t fe_cluster;             /* Number of the first cluster on media */
+  uint32_t fe_count;               /* Number of clusters in the run */
 };
+#endif
 
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
@@ -909,6 +924,10 @@ struct fat_file_s
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   off_t    ff_pos;                 /* Current position in the file */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#ifdef CONFIG_FAT_EXTENT_CACHE
+  uint8_t  ff_nextents;            /* Number of valid entries in ff_extents */
+  struct fat_extent_s ff_extents[CONFIG_FAT_EXTENT_CACHE_SIZE];
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1035,6 +1054,7 @@ EXTERN int    fat_hwread(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
                          off_t sector, unsigned int nsectors);
 EXTERN int    fat_hwwrite(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
                           off_t sector, unsigned int nsectors);
+EXTERN int    fat_hwflush(FAR struct fat_mountpt_s *fs);
 
 /* Cluster / cluster chain access helpers */
 
@@ -1051,6 +1071,22 @@ EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
+#ifdef CONFIG_FAT_FREEMAP
+EXTERN void   fat_freemap_release(FAR struct fat_mountpt_s *fs);
+#endif
+
+/* Per-file cache of the cluster chain */
+
+#ifdef CONFIG_FAT_EXTENT_CACHE
+EXTERN bool   fat_extent_lookup(FAR struct fat_file_s *ff, uint32_t index,
+                                FAR uint32_t *pindex,
+                                FAR uint32_t *pcluster);
+EXTERN void   fat_extent_add(FAR struct fat_file_s *ff, uint32_t index,
+                             uint32_t cluster);
+EXTERN void   fat_extent_truncate(FAR struct fat_file_s *ff,
+                                  uint32_t nclusters);
+#endif
+
 /* Help for traversing directory trees and accessing directory entries */
 
 EXTERN int    fat_nextdirentry(FAR struct fat_mountpt_s *fs,
@@ -30,6 +30,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <time.h>
 #include <assert.h>
 #include <errno.h>
@@ -38,10 +39,20 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/procfs.h>
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of 32-bit words in the free cluster bitmap */
+
+#define FREEMAP_NWORDS(fs) (((fs)->fs_nclusters + 31) >> 5)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -263,6 +274,163 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_freemap_mark
+ *
+ * Description:
+ *   Record in the free cluster bitmap whether a cluster is allocated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static void fat_freemap_mark(FAR struct fat_mountpt_s *fs, uint32_t cluster,
+                             bool used)
+{
+  uint32_t index = cluster - 2;
+  uint32_t mask  = (uint32_t)1 << (index & 31);
+
+  if (used)
+    {
+      fs->fs_freemap[index >> 5] |= mask;
+    }
+  else
+    {
+      fs->fs_freemap[index >> 5] &= ~mask;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_freemap_build
+ *
+ * Description:
+ *   Build the free cluster bitmap by scanning the whole FAT, unless that
+ *   was already done.  The free cluster count is refreshed on the way.
+ *
+ * Returned Value:
+ *   true if the bitmap is available.
+ *
+ ****************************************************************************/
+
+static bool fat_freemap_build(FAR struct fat_mountpt_s *fs)
+{
+  uint32_t nwords = FREEMAP_NWORDS(fs);
+  uint32_t nfreeclusters = 0;
+  uint32_t cluster;
+  off_t next;
+
+  if (fs->fs_freemap != NULL)
+    {
+      return true;
+    }
+  else if (fs->fs_nofreemap)
+    {
+      return false;
+    }
+
+  fs->fs_freemap = kmm_zalloc(nwords * sizeof(uint32_t));
+  if (fs->fs_freemap == NULL)
+    {
+      fwarn("WARNING: No memory for the free cluster bitmap\n");
+      fs->fs_nofreemap = true;
+      return false;
+    }
+
+  for (cluster = 2; cluster < fs->fs_nclusters + 2; cluster++)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          /* Don't scan the FAT again on each allocation of a volume that
+           * cannot be read, fall back to the linear search for good.
+           */
+
+          fwarn("WARNING: Cannot read the FAT for the bitmap: %jd\n",
+                (intmax_t)next);
+          fat_freemap_release(fs);
+          fs->fs_nofreemap = true;
+          return false;
+        }
+      else if (next != 0)
+        {
+          fat_freemap_mark(fs, cluster, true);
+        }
+      else
+        {
+          nfreeclusters++;
+        }
+    }
+
+  /* The bits past the last cluster never describe a free cluster */
+
+  if ((fs->fs_nclusters & 31) != 0)
+    {
+      fs->fs_freemap[nwords - 1] |= UINT32_MAX << (fs->fs_nclusters & 31);
+    }
+
+  if (fs->fs_fsifreecount != nfreeclusters)
+    {
+      fs->fs_fsifreecount = nfreeclusters;
+      if (fs->fs_type == FSTYPE_FAT32)
+        {
+          fs->fs_fsidirty = true;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: fat_freemap_find
+ *
+ * Description:
+ *   Find the first free cluster after 'startcluster', wrapping back to the
+ *   beginning of the volume.  32 clusters are examined at a time.
+ *
+ * Returned Value:
+ *   0: no free cluster, >=2: the free cluster number
+ *
+ ****************************************************************************/
+
+static uint32_t fat_freemap_find(FAR struct fat_mountpt_s *fs,
+                                 uint32_t startcluster)
+{
+  uint32_t nwords = FREEMAP_NWORDS(fs);
+  uint32_t index  = startcluster - 1;
+  uint32_t word;
+  uint32_t bits;
+  uint32_t i;
+
+  if (startcluster < 1 || index >= fs->fs_nclusters)
+    {
+      index = 0;
+    }
+
+  /* The first word is visited twice: once for the clusters after the
+   * start, then after the wrap for the ones before it.
+   */
+
+  word = index >> 5;
+  bits = ~fs->fs_freemap[word] & (UINT32_MAX << (index & 31));
+
+  for (i = 0; i <= nwords; i++)
+    {
+      if (bits != 0)
+        {
+          return (word << 5) + ffs(bits) - 1 + 2;
+        }
+
+      if (++word >= nwords)
+        {
+          word = 0;
+        }
+
+      bits = ~fs->fs_freemap[word];
+    }
+
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -721,8 +889,10 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->read)
         {
-          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
-                                                       sector, nsectors);
+          ssize_t nsectorsread =
+              PRESSURE_STALL(PRESSURE_IO,
+                             inode->u.i_bops->read(inode, buffer,
+                                                   sector, nsectors));
           if (nsectorsread == nsectors)
             {
               ret = OK;
@@ -755,7 +925,9 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
       if (inode && inode->u.i_bops && inode->u.i_bops->write)
         {
           ssize_t nsectorswritten =
-              inode->u.i_bops->write(inode, buffer, sector, nsectors);
+              PRESSURE_STALL(PRESSURE_IO,
+                             inode->u.i_bops->write(inode, buffer,
+                                                    sector, nsectors));
 
           if (nsectorswritten == nsectors)
             {
@@ -771,6 +943,32 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_hwflush
+ *
+ * Description:
+ *   Ask the block driver to commit any sectors that it buffers, e.g. a
+ *   write-back block cache.  Drivers that do not buffer are not an error.
+ *
+ ****************************************************************************/
+
+int fat_hwflush(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct inode *inode = fs->fs_blkdriver;
+  int ret = OK;
+
+  if (inode && inode->u.i_bops && inode->u.i_bops->ioctl)
+    {
+      ret = inode->u.i_bops->ioctl(inode, BIOC_FLUSH, 0);
+      if (ret == -ENOTTY)
+        {
+          ret = OK;
+        }
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: fat_cluster2sector
  *
@@ -1096,6 +1294,14 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
+
+#ifdef CONFIG_FAT_FREEMAP
+      if (fs->fs_freemap != NULL && clusterno >= 2)
+        {
+          fat_freemap_mark(fs, clusterno, nextcluster != 0);
+        }
+#endif
+
       return OK;
     }
 
@@ -1219,6 +1425,21 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  /* Find the next free cluster in memory if the bitmap is available */
+
+  if (fat_freemap_build(fs))
+    {
+      newcluster = fat_freemap_find(fs, startcluster);
+      if (newcluster == 0)
+        {
+          return 0;
+        }
+
+      goto found;
+    }
+#endif
+
   /* Loop until (1) we discover that there are not free clusters
    * (return 0), an errors occurs (return -errno), or (3) we find
    * the next cluster (return the new cluster number).
@@ -1277,6 +1498,10 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
         }
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+found:
+#endif
+
   /* We get here only if we break out with an available cluster
    * number in 'newcluster'  Now mark that cluster as in-use.
    */
@@ -1316,6 +1541,225 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   return newcluster;
 }
 
+/****************************************************************************
+ * Name: fat_freemap_release
+ *
+ * Description:
+ *   Free the free cluster bitmap.  It will be rebuilt when needed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+void fat_freemap_release(FAR struct fat_mountpt_s *fs)
+{
+  kmm_free(fs->fs_freemap);
+  fs->fs_freemap = NULL;
+}
+#endif
+
+#ifdef CONFIG_FAT_EXTENT_CACHE
+
+/****************************************************************************
+ * Name: fat_extent_search
+ *
+ * Description:
+ *   Binary search of the last cached extent that starts at or before the
+ *   file cluster 'index'.
+ *
+ * Returned Value:
+ *   The position of the extent in ff_extents, or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int fat_extent_search(FAR struct fat_file_s *ff, uint32_t index)
+{
+  int lo = 0;
+  int hi = ff->ff_nextents;
+
+  while (lo < hi)
+    {
+      int mid = (lo + hi) / 2;
+
+      if (ff->ff_extents[mid].fe_index <= index)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  return lo - 1;
+}
+
+/****************************************************************************
+ * Name: fat_extent_lookup
+ *
+ * Description:
+ *   Find the cached cluster closest to, but not after, the file cluster
+ *   'index'.
+ *
+ * Returned Value:
+ *   true if a cluster was found.  Its index in the file and its number on
+ *   the media are returned in 'pindex' and 'pcluster'.
+ *
+ ****************************************************************************/
+
+bool fat_extent_lookup(FAR struct fat_file_s *ff, uint32_t index,
+                       FAR uint32_t *pindex, FAR uint32_t *pcluster)
+{
+  FAR struct fat_extent_s *ext;
+  int pos;
+
+  pos = fat_extent_search(ff, index);
+  if (pos < 0)
+    {
+      return false;
+    }
+
+  ext = &ff->ff_extents[pos];
+  if (index >= ext->fe_index + ext->fe_count)
+    {
+      index = ext->fe_index + ext->fe_count - 1;
+    }
+
+  *pindex   = index;
+  *pcluster = ext->fe_cluster + (index - ext->fe_index);
+  return true;
+}
+
+/****************************************************************************
+ * Name: fat_extent_add
+ *
+ * Description:
+ *   Record that the file cluster 'index' is the cluster 'cluster' on the
+ *   media.  Clusters are normally added in the order of the chain, so the
+ *   extents are extended in place most of the time.
+ *
+ ****************************************************************************/
+
+void fat_extent_add(FAR struct fat_file_s *ff, uint32_t index,
+                    uint32_t cluster)
+{
+  FAR struct fat_extent_s *ext;
+  int victim;
+  int pos;
+  int i;
+
+  pos = fat_extent_search(ff, index);
+  if (pos >= 0)
+    {
+      ext = &ff->ff_extents[pos];
+      if (index < ext->fe_index + ext->fe_count)
+        {
+          /* Already known */
+
+          return;
+        }
+
+      if (index == ext->fe_index + ext->fe_count &&
+          cluster == ext->fe_cluster + ext->fe_count)
+        {
+          ext->fe_count++;
+
+          /* Merge with the next extent if the gap is now closed */
+
+          if (pos + 1 < ff->ff_nextents &&
+              ext[1].fe_index == index + 1 &&
+              ext[1].fe_cluster == cluster + 1)
+            {
+              ext->fe_count += ext[1].fe_count;
+              ff->ff_nextents--;
+              memmove(&ext[1], &ext[2],
+                      (ff->ff_nextents - pos - 1) * sizeof(*ext));
+            }
+
+          return;
+        }
+    }
+
+  /* Prepend to the next extent if it follows contiguously */
+
+  if (pos + 1 < ff->ff_nextents)
+    {
+      ext = &ff->ff_extents[pos + 1];
+      if (ext->fe_index == index + 1 && ext->fe_cluster == cluster + 1)
+        {
+          ext->fe_index--;
+          ext->fe_cluster--;
+          ext->fe_count++;
+          return;
+        }
+    }
+
+  /* Forget the shortest extent if the cache is full:  It is the cheapest
+   * one to find again by following the chain.
+   */
+
+  if (ff->ff_nextents >= CONFIG_FAT_EXTENT_CACHE_SIZE)
+    {
+      victim = 0;
+      for (i = 1; i < ff->ff_nextents; i++)
+        {
+          if (ff->ff_extents[i].fe_count < ff->ff_extents[victim].fe_count)
+            {
+              victim = i;
+            }
+        }
+
+      ff->ff_nextents--;
+      memmove(&ff->ff_extents[victim], &ff->ff_extents[victim + 1],
+              (ff->ff_nextents - victim) * sizeof(*ext));
+      if (victim <= pos)
+        {
+          pos--;
+        }
+    }
+
+  /* Insert a new extent after 'pos' */
+
+  pos++;
+  ext = &ff->ff_extents[pos];
+  memmove(&ext[1], ext, (ff->ff_nextents - pos) * sizeof(*ext));
+  ff->ff_nextents++;
+
+  ext->fe_index   = index;
+  ext->fe_cluster = cluster;
+  ext->fe_count   = 1;
+}
+
+/****************************************************************************
+ * Name: fat_extent_truncate
+ *
+ * Description:
+ *   Forget the clusters past the first 'nclusters' of the file.
+ *
+ ****************************************************************************/
+
+void fat_extent_truncate(FAR struct fat_file_s *ff, uint32_t nclusters)
+{
+  FAR struct fat_extent_s *ext;
+
+  while (ff->ff_nextents > 0)
+    {
+      ext = &ff->ff_extents[ff->ff_nextents - 1];
+      if (ext->fe_index + ext->fe_count <= nclusters)
+        {
+          break;
+        }
+
+      if (ext->fe_index < nclusters)
+        {
+          ext->fe_count = nclusters - ext->fe_index;
+          break;
+        }
+
+      ff->ff_nextents--;
+    }
+}
+#endif /* CONFIG_FAT_EXTENT_CACHE */
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 
@@ -36,6 +37,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -52,6 +55,19 @@
 
 #define HOSTFS_RETRY_DELAY_MS       10
 
+#if CONFIG_FS_HOSTFS_BLOCKSIZE == 0
+#  define hostfs_flush(fs, hf)        OK
+#  define hostfs_flush_all(fs, hf)
+#endif
+
+#if CONFIG_FS_HOSTFS_BLOCKSIZE == 0 && CONFIG_FS_HOSTFS_STATCACHE == 0
+#  define hostfs_changed(fs, hf)
+#endif
+
+#ifndef CONFIG_FS_HOSTFS_MMAP
+#  define hostfs_unmap(fs)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -235,6 +251,511 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0 || defined(CONFIG_FS_HOSTFS_MMAP)
+/****************************************************************************
+ * Name: hostfs_seekto
+ *
+ * Description: Move the host file position to pos, unless it is there
+ *   already.
+ *
+ ****************************************************************************/
+
+static int hostfs_seekto(FAR struct hostfs_ofile_s *hf, off_t pos)
+{
+  off_t ret;
+
+  if (hf->hpos != pos)
+    {
+      ret = host_lseek(hf->fd, pos, pos, SEEK_SET);
+      if (ret < 0)
+        {
+          hf->hpos = -1;
+          return ret;
+        }
+
+      hf->hpos = ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_hread and hostfs_hwrite
+ *
+ * Description: Read or write the host file at pos.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_hread(FAR struct hostfs_ofile_s *hf, off_t pos,
+                            FAR char *buffer, size_t buflen)
+{
+  ssize_t ret;
+
+  ret = hostfs_seekto(hf, pos);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = host_read(hf->fd, buffer, buflen);
+  hf->hpos = ret < 0 ? -1 : hf->hpos + ret;
+  return ret;
+}
+
+static ssize_t hostfs_hwrite(FAR struct hostfs_ofile_s *hf, off_t pos,
+                             FAR const char *buffer, size_t buflen)
+{
+  ssize_t ret;
+
+  /* The host appends wherever the position is */
+
+  if ((hf->oflags & O_APPEND) == 0)
+    {
+      ret = hostfs_seekto(hf, pos);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ret = host_write(hf->fd, buffer, buflen);
+  if (ret < 0 || (hf->oflags & O_APPEND) != 0)
+    {
+      hf->hpos = -1;
+    }
+  else
+    {
+      hf->hpos += ret;
+    }
+
+  return ret;
+}
+#endif
+
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0 || CONFIG_FS_HOSTFS_STATCACHE > 0
+/****************************************************************************
+ * Name: hostfs_changed
+ *
+ * Description: Called after the host files were changed through the
+ *   mount: data read ahead by any file other than hf may be stale, and so
+ *   may any cached stat() result.
+ *
+ ****************************************************************************/
+
+static void hostfs_changed(FAR struct hostfs_mountpt_s *fs,
+                           FAR struct hostfs_ofile_s *hf)
+{
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0
+  FAR struct hostfs_ofile_s *file;
+
+  for (file = fs->fs_head; file != NULL; file = file->fnext)
+    {
+      if (file != hf && !file->dirty)
+        {
+          file->blen = 0;
+        }
+    }
+#endif
+
+#if CONFIG_FS_HOSTFS_STATCACHE > 0
+  fs->fs_gen++;
+#endif
+}
+#endif
+
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0
+/****************************************************************************
+ * Name: hostfs_flush
+ *
+ * Description: Write the data written behind by hf to the host.
+ *
+ ****************************************************************************/
+
+static int hostfs_flush(FAR struct hostfs_mountpt_s *fs,
+                        FAR struct hostfs_ofile_s *hf)
+{
+  size_t nwritten = 0;
+  ssize_t ret = OK;
+
+  if (!hf->dirty)
+    {
+      return OK;
+    }
+
+  hf->dirty = false;
+
+  /* The data is not kept once written, as a short buffer stands for the
+   * end of the file.
+   */
+
+  while (nwritten < hf->blen)
+    {
+      ret = hostfs_hwrite(hf, hf->boff + nwritten, hf->buf + nwritten,
+                          hf->blen - nwritten);
+      if (ret <= 0)
+        {
+          ret = ret < 0 ? ret : -EIO;
+          break;
+        }
+
+      nwritten += ret;
+    }
+
+  hf->blen = 0;
+  hostfs_changed(fs, hf);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_flush_all
+ *
+ * Description: Write the data written behind by all of the files of the
+ *   mount but hf, before the host is asked about or accesses any of them.
+ *   An error is reported by the next write, sync or close of the file.
+ *
+ ****************************************************************************/
+
+static void hostfs_flush_all(FAR struct hostfs_mountpt_s *fs,
+                             FAR struct hostfs_ofile_s *hf)
+{
+  FAR struct hostfs_ofile_s *file;
+  int ret;
+
+  for (file = fs->fs_head; file != NULL; file = file->fnext)
+    {
+      if (file != hf && file->dirty)
+        {
+          ret = hostfs_flush(fs, file);
+          if (ret < 0 && file->error == 0)
+            {
+              file->error = ret;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: hostfs_error
+ *
+ * Description: Return and clear the error of an earlier write behind.
+ *
+ ****************************************************************************/
+
+static int hostfs_error(FAR struct hostfs_ofile_s *hf)
+{
+  int ret = hf->error;
+
+  hf->error = 0;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hostfs_bread
+ *
+ * Description: Read through the buffer of the file.  The buffer holds one
+ *   aligned block of CONFIG_FS_HOSTFS_BLOCKSIZE bytes, reads that are not
+ *   smaller go straight to the buffer of the caller.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_bread(FAR struct hostfs_mountpt_s *fs,
+                            FAR struct hostfs_ofile_s *hf, off_t pos,
+                            FAR char *buffer, size_t buflen)
+{
+  size_t nread = 0;
+  ssize_t ret;
+  off_t off;
+  size_t n;
+
+  ret = hostfs_flush(fs, hf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (nread < buflen)
+    {
+      off = pos + nread - hf->boff;
+      if (off >= 0 && off < (off_t)hf->blen)
+        {
+          n = MIN(buflen - nread, hf->blen - off);
+          memcpy(buffer + nread, hf->buf + off, n);
+          nread += n;
+
+          /* A short block ends at the end of the file */
+
+          if (hf->blen < CONFIG_FS_HOSTFS_BLOCKSIZE)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      if (buflen - nread >= CONFIG_FS_HOSTFS_BLOCKSIZE)
+        {
+          ret = hostfs_hread(hf, pos + nread, buffer + nread,
+                             buflen - nread);
+          if (ret > 0)
+            {
+              nread += ret;
+            }
+
+          break;
+        }
+
+      hf->boff = (pos + nread) / CONFIG_FS_HOSTFS_BLOCKSIZE *
+                 CONFIG_FS_HOSTFS_BLOCKSIZE;
+      hf->blen = 0;
+
+      ret = hostfs_hread(hf, hf->boff, hf->buf, CONFIG_FS_HOSTFS_BLOCKSIZE);
+      if (ret <= 0 || pos + (off_t)nread >= hf->boff + ret)
+        {
+          hf->blen = MAX(ret, 0);
+          break;
+        }
+
+      hf->blen = ret;
+    }
+
+  return nread > 0 ? (ssize_t)nread : ret;
+}
+
+/****************************************************************************
+ * Name: hostfs_bwrite
+ *
+ * Description: Gather small sequential writes in the buffer of the file.
+ *   Others first write what was gathered and then go to the host.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_bwrite(FAR struct hostfs_mountpt_s *fs,
+                             FAR struct hostfs_ofile_s *hf, off_t pos,
+                             FAR const char *buffer, size_t buflen)
+{
+  ssize_t ret;
+
+  if (buflen < CONFIG_FS_HOSTFS_BLOCKSIZE && (hf->oflags & O_APPEND) == 0)
+    {
+      if (!hf->dirty || pos != hf->boff + hf->blen ||
+          hf->blen + buflen > CONFIG_FS_HOSTFS_BLOCKSIZE)
+        {
+          ret = hostfs_flush(fs, hf);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          hf->boff  = pos;
+          hf->blen  = 0;
+          hf->dirty = true;
+        }
+
+      memcpy(hf->buf + hf->blen, buffer, buflen);
+      hf->blen += buflen;
+      return buflen;
+    }
+
+  ret = hostfs_flush(fs, hf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  hf->blen = 0;
+  ret = hostfs_hwrite(hf, pos, buffer, buflen);
+  hostfs_changed(fs, hf);
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_FS_HOSTFS_MMAP
+/****************************************************************************
+ * Name: hostfs_unmap
+ *
+ * Description: Drop the mappings of all of the files of the mount, as
+ *   access to a mapping beyond the end of a truncated file faults.
+ *
+ ****************************************************************************/
+
+static void hostfs_unmap(FAR struct hostfs_mountpt_s *fs)
+{
+  FAR struct hostfs_ofile_s *file;
+
+  for (file = fs->fs_head; file != NULL; file = file->fnext)
+    {
+      if (file->map != NULL)
+        {
+          host_munmap((FAR void *)file->map, file->maplen);
+          file->map    = NULL;
+          file->maplen = 0;
+        }
+    }
+}
+#endif
+
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0 || defined(CONFIG_FS_HOSTFS_MMAP)
+/****************************************************************************
+ * Name: hostfs_cacheinit
+ *
+ * Description: Map a regular file opened read-only, or allocate the buffer
+ *   of any other regular file.
+ *
+ ****************************************************************************/
+
+static void hostfs_cacheinit(FAR struct hostfs_ofile_s *hf)
+{
+  struct stat buf;
+
+  if (host_fstat(hf->fd, &buf) < 0 || !S_ISREG(buf.st_mode))
+    {
+      return;
+    }
+
+#ifdef CONFIG_FS_HOSTFS_MMAP
+  if ((hf->oflags & O_WROK) == 0 && buf.st_size > 0)
+    {
+      hf->map = host_mmap(hf->fd, buf.st_size);
+      if (hf->map != NULL)
+        {
+          hf->maplen = buf.st_size;
+          return;
+        }
+    }
+#endif
+
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0
+  hf->buf = kmm_malloc(CONFIG_FS_HOSTFS_BLOCKSIZE);
+#endif
+}
+
+/****************************************************************************
+ * Name: hostfs_pread and hostfs_pwrite
+ *
+ * Description: Read or write the file at pos, through its mapping or its
+ *   buffer if it has one.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_pread(FAR struct hostfs_mountpt_s *fs,
+                            FAR struct hostfs_ofile_s *hf, off_t pos,
+                            FAR char *buffer, size_t buflen)
+{
+  hostfs_flush_all(fs, hf);
+
+#ifdef CONFIG_FS_HOSTFS_MMAP
+  if (pos < (off_t)hf->maplen)
+    {
+      buflen = MIN(buflen, hf->maplen - pos);
+      memcpy(buffer, hf->map + pos, buflen);
+      return buflen;
+    }
+#endif
+
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0
+  if (hf->buf != NULL)
+    {
+      return hostfs_bread(fs, hf, pos, buffer, buflen);
+    }
+#endif
+
+  return hostfs_hread(hf, pos, buffer, buflen);
+}
+
+static ssize_t hostfs_pwrite(FAR struct hostfs_mountpt_s *fs,
+                             FAR struct hostfs_ofile_s *hf, off_t pos,
+                             FAR const char *buffer, size_t buflen)
+{
+  ssize_t ret;
+
+  hostfs_flush_all(fs, hf);
+
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0
+  ret = hostfs_error(hf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (hf->buf != NULL)
+    {
+      return hostfs_bwrite(fs, hf, pos, buffer, buflen);
+    }
+#endif
+
+  ret = hostfs_hwrite(hf, pos, buffer, buflen);
+  hostfs_changed(fs, hf);
+  return ret;
+}
+#endif
+
+#if CONFIG_FS_HOSTFS_STATCACHE > 0
+/****************************************************************************
+ * Name: hostfs_attr_lookup
+ *
+ * Description: Find the cached result of a stat() of path.
+ *
+ ****************************************************************************/
+
+static FAR struct hostfs_attr_s *
+hostfs_attr_lookup(FAR struct hostfs_mountpt_s *fs, FAR const char *path)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_STATCACHE; i++)
+    {
+      if (fs->fs_attr[i].path != NULL &&
+          strcmp(fs->fs_attr[i].path, path) == 0)
+        {
+          return &fs->fs_attr[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: hostfs_attr_update
+ *
+ * Description: Cache the result of a stat() of path, replacing the oldest
+ *   entry if path is not cached yet.
+ *
+ ****************************************************************************/
+
+static void hostfs_attr_update(FAR struct hostfs_mountpt_s *fs,
+                               FAR const char *path, int ret,
+                               FAR const struct stat *buf)
+{
+  FAR struct hostfs_attr_s *attr;
+  size_t len;
+
+  attr = hostfs_attr_lookup(fs, path);
+  if (attr == NULL)
+    {
+      attr = &fs->fs_attr[fs->fs_attrnext];
+      fs->fs_attrnext = (fs->fs_attrnext + 1) % CONFIG_FS_HOSTFS_STATCACHE;
+
+      len = strlen(path) + 1;
+      kmm_free(attr->path);
+      attr->path = kmm_malloc(len);
+      if (attr->path == NULL)
+        {
+          return;
+        }
+
+      memcpy(attr->path, path, len);
+    }
+
+  attr->stamp = clock_systime_ticks();
+  attr->gen   = fs->fs_gen;
+  attr->ret   = ret;
+  if (ret >= 0)
+    {
+      memcpy(&attr->buf, buf, sizeof(attr->buf));
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -270,10 +791,14 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
       return ret;
     }
 
+  /* The host must see the data written behind by the other files */
+
+  hostfs_flush_all(fs, NULL);
+
   /* Allocate memory for the open file */
 
   len = strlen(relpath);
-  hf = kmm_malloc(sizeof(*hf) + len);
+  hf = kmm_zalloc(sizeof(*hf) + len);
   if (hf == NULL)
     {
       ret = -ENOMEM;
@@ -312,6 +837,24 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
         }
     }
 
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0 || defined(CONFIG_FS_HOSTFS_MMAP)
+  hf->hpos   = filep->f_pos;
+  hf->oflags = oflags;
+  hostfs_cacheinit(hf);
+#endif
+
+  /* A new or truncated file makes cached data and attributes stale */
+
+  if ((oflags & O_TRUNC) != 0)
+    {
+      hostfs_unmap(fs);
+    }
+
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      hostfs_changed(fs, hf);
+    }
+
   /* Attach the private date to the struct file instance */
 
   filep->f_priv = hf;
@@ -389,6 +932,25 @@ static int hostfs_close(FAR struct file *filep)
       goto okout;
     }
 
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0
+  /* Write what is still buffered and report any earlier error of that */
+
+  ret = hostfs_flush(fs, hf);
+  if (ret >= 0)
+    {
+      ret = hostfs_error(hf);
+    }
+
+  kmm_free(hf->buf);
+#endif
+
+#ifdef CONFIG_FS_HOSTFS_MMAP
+  if (hf->map != NULL)
+    {
+      host_munmap((FAR void *)hf->map, hf->maplen);
+    }
+#endif
+
   /* Remove ourselves from the linked list */
 
   nextfile = fs->fs_head;
@@ -430,7 +992,7 @@ static int hostfs_close(FAR struct file *filep)
 
 okout:
   nxmutex_unlock(&g_lock);
-  return OK;
+  return ret < 0 ? ret : OK;
 }
 
 /****************************************************************************
@@ -467,7 +1029,11 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0 || defined(CONFIG_FS_HOSTFS_MMAP)
+  ret = hostfs_pread(fs, hf, filep->f_pos, buffer, buflen);
+#else
   ret = host_read(hf->fd, buffer, buflen);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -519,7 +1085,12 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
 
   /* Call the host to perform the write */
 
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0 || defined(CONFIG_FS_HOSTFS_MMAP)
+  ret = hostfs_pwrite(fs, hf, filep->f_pos, buffer, buflen);
+#else
   ret = host_write(hf->fd, buffer, buflen);
+  hostfs_changed(fs, hf);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -561,6 +1132,24 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
       return ret;
     }
 
+  /* The end of the file must include the data written behind */
+
+  ret = hostfs_flush(fs, hf);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0 || defined(CONFIG_FS_HOSTFS_MMAP)
+  /* The host position may not be the file position */
+
+  if (whence == SEEK_CUR)
+    {
+      offset += filep->f_pos;
+      whence  = SEEK_SET;
+    }
+#endif
+
   /* Call our internal routine to perform the seek */
 
   ret = host_lseek(hf->fd, filep->f_pos, offset, whence);
@@ -569,6 +1158,12 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
       filep->f_pos = ret;
     }
 
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0 || defined(CONFIG_FS_HOSTFS_MMAP)
+  hf->hpos = ret;
+#endif
+
+errout_with_lock:
+
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -604,6 +1199,18 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+  /* The host must see the file as the caller does */
+
+  ret = hostfs_flush(fs, hf);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0 || defined(CONFIG_FS_HOSTFS_MMAP)
+  hostfs_seekto(hf, filep->f_pos);
+#endif
+
   /* Call our internal routine to perform the ioctl */
 
   ret = host_ioctl(hf->fd, cmd, arg);
@@ -627,6 +1234,7 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
     }
 
+errout_with_lock:
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -666,10 +1274,18 @@ static int hostfs_sync(FAR struct file *filep)
       return ret;
     }
 
+  ret = hostfs_flush(fs, hf);
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0
+  if (ret >= 0)
+    {
+      ret = hostfs_error(hf);
+    }
+#endif
+
   host_sync(hf->fd);
 
   nxmutex_unlock(&g_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -742,6 +1358,7 @@ static int hostfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 
   /* Call the host to perform the read */
 
+  hostfs_flush_all(fs, NULL);
   ret = host_fstat(hf->fd, buf);
 
   nxmutex_unlock(&g_lock);
@@ -788,7 +1405,9 @@ static int hostfs_fchstat(FAR const struct file *filep,
 
   /* Call the host to perform the change */
 
+  hostfs_flush_all(fs, NULL);
   ret = host_fchstat(hf->fd, buf, flags);
+  hostfs_changed(fs, NULL);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -829,7 +1448,10 @@ static int hostfs_ftruncate(FAR struct file *filep, off_t length)
 
   /* Call the host to perform the truncate */
 
+  hostfs_flush_all(fs, NULL);
+  hostfs_unmap(fs);
   ret = host_ftruncate(hf->fd, length);
+  hostfs_changed(fs, NULL);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1121,6 +1743,9 @@ static int hostfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
                          unsigned int flags)
 {
   FAR struct hostfs_mountpt_s *fs = (FAR struct hostfs_mountpt_s *)handle;
+#if CONFIG_FS_HOSTFS_STATCACHE > 0
+  int i;
+#endif
   int ret;
 
   if (!fs)
@@ -1150,6 +1775,14 @@ static int hostfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
     }
 
   nxmutex_unlock(&g_lock);
+
+#if CONFIG_FS_HOSTFS_STATCACHE > 0
+  for (i = 0; i < CONFIG_FS_HOSTFS_STATCACHE; i++)
+    {
+      kmm_free(fs->fs_attr[i].path);
+    }
+#endif
+
   kmm_free(fs);
   return ret;
 }
@@ -1182,6 +1815,7 @@ static int hostfs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
 
   /* Call the host fs to perform the statfs */
 
+  hostfs_flush_all(fs, NULL);
   ret = host_statfs(fs->fs_root, buf);
   buf->f_type = HOSTFS_MAGIC;
 
@@ -1222,7 +1856,9 @@ static int hostfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Call the host fs to perform the unlink */
 
+  hostfs_flush_all(fs, NULL);
   ret = host_unlink(path);
+  hostfs_changed(fs, NULL);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1262,7 +1898,9 @@ static int hostfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the mkdir */
 
+  hostfs_flush_all(fs, NULL);
   ret = host_mkdir(path, mode);
+  hostfs_changed(fs, NULL);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1303,7 +1941,9 @@ int hostfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Call the host FS to do the mkdir */
 
+  hostfs_flush_all(fs, NULL);
   ret = host_rmdir(path);
+  hostfs_changed(fs, NULL);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1347,7 +1987,9 @@ int hostfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
 
   /* Call the host FS to do the mkdir */
 
+  hostfs_flush_all(fs, NULL);
   ret = host_rename(oldpath, newpath);
+  hostfs_changed(fs, NULL);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1364,6 +2006,9 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                        FAR struct stat *buf)
 {
   FAR struct hostfs_mountpt_s *fs;
+#if CONFIG_FS_HOSTFS_STATCACHE > 0
+  FAR struct hostfs_attr_s *attr;
+#endif
   char path[HOSTFS_MAX_PATH];
   int ret;
 
@@ -1381,6 +2026,26 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
       return ret;
     }
 
+  hostfs_flush_all(fs, NULL);
+
+#if CONFIG_FS_HOSTFS_STATCACHE > 0
+  /* Nothing was changed through the mount since the path was cached */
+
+  attr = hostfs_attr_lookup(fs, relpath);
+  if (attr != NULL && attr->gen == fs->fs_gen &&
+      clock_systime_ticks() - attr->stamp <
+      MSEC2TICK(CONFIG_FS_HOSTFS_STATCACHE_TIMEOUT))
+    {
+      ret = attr->ret;
+      if (ret >= 0)
+        {
+          memcpy(buf, &attr->buf, sizeof(*buf));
+        }
+
+      goto errout_with_lock;
+    }
+#endif
+
   /* Append to the host's root directory */
 
   hostfs_mkpath(fs, relpath, path, sizeof(path));
@@ -1389,6 +2054,15 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   ret = host_stat(path, buf);
 
+#if CONFIG_FS_HOSTFS_STATCACHE > 0
+  if (ret >= 0 || ret == -ENOENT)
+    {
+      hostfs_attr_update(fs, relpath, ret, buf);
+    }
+
+errout_with_lock:
+#endif
+
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -1427,7 +2101,9 @@ static int hostfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the chstat operation */
 
+  hostfs_flush_all(fs, NULL);
   ret = host_chstat(path, buf, flags);
+  hostfs_changed(fs, NULL);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -28,8 +28,10 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -51,9 +53,36 @@ struct hostfs_ofile_s
   int16_t                   crefs;   /* Reference count */
   mode_t                    oflags;  /* Open mode */
   int                       fd;
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0 || defined(CONFIG_FS_HOSTFS_MMAP)
+  off_t                     hpos;    /* Position of the host file or -1 */
+#endif
+#if CONFIG_FS_HOSTFS_BLOCKSIZE > 0
+  int                       error;   /* Error of a write behind */
+  FAR char                 *buf;     /* Data read ahead or written behind */
+  off_t                     boff;    /* File offset of the data in buf */
+  size_t                    blen;    /* Number of bytes in buf */
+  bool                      dirty;   /* True if buf is to be written */
+#endif
+#ifdef CONFIG_FS_HOSTFS_MMAP
+  FAR const char           *map;     /* Host mapping of a read-only file */
+  size_t                    maplen;  /* Size of the mapping */
+#endif
   char                      relpath[1];
 };
 
+#if CONFIG_FS_HOSTFS_STATCACHE > 0
+/* The result of a stat() of a path, a missing file included */
+
+struct hostfs_attr_s
+{
+  FAR char                 *path;
+  clock_t                   stamp;   /* Time of the stat() */
+  unsigned int              gen;     /* fs_gen at the time of the stat() */
+  int                       ret;
+  struct stat               buf;
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of
  * this structure is retained as inode private data on each mountpoint that
  * is mounted with a hostfs filesystem.
@@ -63,6 +92,11 @@ struct hostfs_mountpt_s
 {
   FAR struct hostfs_ofile_s *fs_head;      /* A singly-linked list of open files */
   char                       fs_root[HOSTFS_MAX_PATH];
+#if CONFIG_FS_HOSTFS_STATCACHE > 0
+  unsigned int               fs_gen;       /* Changed by every modification */
+  unsigned int               fs_attrnext;  /* Next entry of fs_attr to reuse */
+  struct hostfs_attr_s       fs_attr[CONFIG_FS_HOSTFS_STATCACHE];
+#endif
 };
 
 /****************************************************************************
@@ -54,10 +54,83 @@
 #include "sched/sched.h"
 #include "inode/inode.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The maximum number of rows in the fl_files array */
+
+#define FILES_MAXROWS (OPEN_MAX / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK + 1)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: files_index
+ *
+ * Description:
+ *   Return the file at row l1 and column l2 without taking the lock.  The
+ *   caller has checked l1 against fl_rows.  The array of rows is only ever
+ *   replaced once, when the pre-allocated row is outgrown, and the rows are
+ *   not freed before files_putlist(), so the only race is with a row that
+ *   files_extend() is just adding; that case retries with the lock held.
+ *
+ ****************************************************************************/
+
+static FAR struct file *files_index(FAR struct filelist *list,
+                                    int l1, int l2)
+{
+  FAR struct file **files = list->fl_files;
+  FAR struct file *row = NULL;
+  irqstate_t flags;
+
+  if (l1 == 0 || files != &list->fl_prefile)
+    {
+      row = files[l1];
+    }
+
+  if (row == NULL)
+    {
+      flags = spin_lock_irqsave(NULL);
+      row = list->fl_files[l1];
+      spin_unlock_irqrestore(NULL, flags);
+      DEBUGASSERT(row != NULL);
+    }
+
+  return &row[l2];
+}
+
+/****************************************************************************
+ * Name: files_tryref
+ *
+ * Description:
+ *   Take a reference to a file unless its reference count already dropped
+ *   to zero, i.e. the file is being closed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_REFCOUNT
+static bool files_tryref(FAR struct file *filep)
+{
+  int refs = atomic_load(&filep->f_refs);
+
+  do
+    {
+      if (refs == 0)
+        {
+          return false;
+        }
+    }
+  while (!atomic_compare_exchange_weak_explicit(&filep->f_refs, &refs,
+                                                refs + 1,
+                                                memory_order_acquire,
+                                                memory_order_relaxed));
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: files_fget_by_index
  ****************************************************************************/
@@ -68,9 +141,40 @@ static FAR struct file *files_fget_by_index(FAR struct filelist *list,
   FAR struct file *filep;
   irqstate_t flags;
 
+  /* Looking up an open file takes no lock:  The reference count is only
+   * taken while it is not zero and a slot that is not open yet is let go
+   * again.
+   */
+
+  if (new == NULL)
+    {
+      filep = files_index(list, l1, l2);
+#ifdef CONFIG_FS_REFCOUNT
+      if (!files_tryref(filep))
+        {
+          return NULL;
+        }
+
+      if (filep->f_inode == NULL)
+        {
+          fs_putfilep(filep);
+          return NULL;
+        }
+#else
+      if (filep->f_inode == NULL)
+        {
+          return NULL;
+        }
+#endif
+
+      return filep;
+    }
+
+  /* Reserving a slot for dup2() serializes with file_allocate_from_tcb() */
+
   flags = spin_lock_irqsave(NULL);
 
-  filep = &list->fl_files[l1][l2];
+  filep = files_index(list, l1, l2);
 #ifdef CONFIG_FS_REFCOUNT
   if (filep->f_inode != NULL)
     {
@@ -78,33 +182,20 @@ static FAR struct file *files_fget_by_index(FAR struct filelist *list,
        * released, At this point we should return a null pointer
        */
 
-      if (filep->f_refs == 0)
+      if (!files_tryref(filep))
         {
           filep = NULL;
         }
-      else
-        {
-          filep->f_refs++;
-        }
-    }
-  else if (new == NULL)
-    {
-      filep = NULL;
     }
-  else if (filep->f_refs)
+  else if (atomic_load(&filep->f_refs) != 0)
     {
-      filep->f_refs++;
+      atomic_fetch_add(&filep->f_refs, 1);
     }
   else
     {
-      filep->f_refs = 2;
+      atomic_store(&filep->f_refs, 2);
       *new = true;
     }
-#else
-  if (filep->f_inode == NULL && new == NULL)
-    {
-      filep = NULL;
-    }
 #endif
 
   spin_unlock_irqrestore(NULL, flags);
@@ -118,11 +209,10 @@ static FAR struct file *files_fget_by_index(FAR struct filelist *list,
 static int files_extend(FAR struct filelist *list, size_t row)
 {
   FAR struct file **files;
+  FAR struct file *tmp;
+  irqstate_t flags;
   uint8_t orig_rows;
-  FAR void *tmp;
-  int flags;
   int i;
-  int j;
 
   orig_rows = list->fl_rows;
   if (row <= orig_rows)
@@ -130,73 +220,73 @@ static int files_extend(FAR struct filelist *list, size_t row)
       return 0;
     }
 
-  if (CONFIG_NFILE_DESCRIPTORS_PER_BLOCK * orig_rows > OPEN_MAX)
+  if (CONFIG_NFILE_DESCRIPTORS_PER_BLOCK * orig_rows > OPEN_MAX ||
+      row > FILES_MAXROWS)
     {
       files_dumplist(list);
       return -EMFILE;
     }
 
-  files = kmm_malloc(sizeof(FAR struct file *) * row);
-  DEBUGASSERT(files);
-  if (files == NULL)
-    {
-      return -ENFILE;
-    }
+  /* The array of rows is allocated at its maximum size when the
+   * pre-allocated row is outgrown and it is never replaced afterwards, so
+   * that files_index() can use it without a lock.
+   */
 
-  i = orig_rows;
-  do
+  if (list->fl_files == &list->fl_prefile)
     {
-      files[i] = kmm_zalloc(sizeof(struct file) *
-                            CONFIG_NFILE_DESCRIPTORS_PER_BLOCK);
-      if (files[i] == NULL)
+      files = kmm_zalloc(sizeof(FAR struct file *) * FILES_MAXROWS);
+      DEBUGASSERT(files);
+      if (files == NULL)
         {
-          while (--i >= orig_rows)
-            {
-              kmm_free(files[i]);
-            }
-
-          kmm_free(files);
           return -ENFILE;
         }
-    }
-  while (++i < row);
 
-  flags = spin_lock_irqsave(NULL);
+      files[0] = list->fl_prefile;
 
-  /* To avoid race condition, if the file list is updated by other threads
-   * and list rows is greater or equal than temp list,
-   * release the obsolete buffers
-   */
+      flags = spin_lock_irqsave(NULL);
+      if (list->fl_files == &list->fl_prefile)
+        {
+          list->fl_files = files;
+          files = NULL;
+        }
 
-  if (orig_rows != list->fl_rows && list->fl_rows >= row)
-    {
       spin_unlock_irqrestore(NULL, flags);
 
-      for (j = orig_rows; j < i; j++)
+      if (files != NULL)
         {
-          kmm_free(files[j]);
+          kmm_free(files);
         }
-
-      kmm_free(files);
-
-      return OK;
     }
 
-  if (list->fl_files != NULL)
+  for (i = orig_rows; i < row; i++)
     {
-      memcpy(files, list->fl_files,
-             list->fl_rows * sizeof(FAR struct file *));
-    }
+      tmp = kmm_zalloc(sizeof(struct file) *
+                       CONFIG_NFILE_DESCRIPTORS_PER_BLOCK);
+      if (tmp == NULL)
+        {
+          return -ENFILE;
+        }
 
-  tmp = list->fl_files;
-  list->fl_files = files;
-  list->fl_rows = row;
+      flags = spin_lock_irqsave(NULL);
 
-  spin_unlock_irqrestore(NULL, flags);
+      /* To avoid race condition, if the file list was extended by other
+       * threads, release the obsolete buffer.
+       */
 
-  if (tmp != NULL && tmp != &list->fl_prefile)
-    {
-      kmm_free(tmp);
+      if (list->fl_rows > i)
+        {
+          spin_unlock_irqrestore(NULL, flags);
+          kmm_free(tmp);
+          continue;
+        }
+
+      /* Publish the row before the count that makes it reachable */
+
+      list->fl_files[i] = tmp;
+      SP_DMB();
+      list->fl_rows = i + 1;
+
+      spin_unlock_irqrestore(NULL, flags);
     }
 
   return OK;
@@ -595,7 +685,8 @@ int file_allocate_from_tcb(FAR struct tcb_s *tcb, FAR struct inode *inode,
               filep->f_inode  = inode;
               filep->f_priv   = priv;
 #ifdef CONFIG_FS_REFCOUNT
-              filep->f_refs   = 1;
+              atomic_store_explicit(&filep->f_refs, 1,
+                                    memory_order_release);
 #endif
 
               goto found;
@@ -819,12 +910,8 @@ void fs_reffilep(FAR struct file *filep)
 {
   /* This interface is used to increase the reference count of filep */
 
-  irqstate_t flags;
-
   DEBUGASSERT(filep);
-  flags = spin_lock_irqsave(NULL);
-  filep->f_refs++;
-  spin_unlock_irqrestore(NULL, flags);
+  atomic_fetch_add(&filep->f_refs, 1);
 }
 
 /****************************************************************************
@@ -841,16 +928,12 @@ void fs_reffilep(FAR struct file *filep)
 
 int fs_putfilep(FAR struct file *filep)
 {
-  irqstate_t flags;
   int ret = 0;
   int refs;
 
   DEBUGASSERT(filep);
-  flags = spin_lock_irqsave(NULL);
-
-  refs = --filep->f_refs;
-
-  spin_unlock_irqrestore(NULL, flags);
+  refs = atomic_fetch_sub_explicit(&filep->f_refs, 1,
+                                   memory_order_acq_rel) - 1;
 
   /* If refs is zero, the close() had called, closing it now. */
 
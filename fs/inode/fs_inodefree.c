@@ -62,6 +62,16 @@ void inode_free(FAR struct inode *node)
       inode_free(node->i_peer);
       inode_free(node->i_child);
 
+#ifdef CONFIG_FS_INODE_HASH
+      /* The children of an unlinked inode are still indexed, and the
+       * last reference may be released without the inode lock.
+       */
+
+      inode_lock();
+      inode_hash_remove(node);
+      inode_unlock();
+#endif
+
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
       /* If the inode is a symbolic link, the free the path to the linked
        * entity.
@@ -0,0 +1,208 @@
+/****************************************************************************
+ * fs/inode/fs_inodehash.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_HASH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define INODE_HASH_MASK (CONFIG_FS_INODE_HASH_BUCKETS - 1)
+
+#if (CONFIG_FS_INODE_HASH_BUCKETS & INODE_HASH_MASK) != 0
+#  error CONFIG_FS_INODE_HASH_BUCKETS must be a power of two
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Every inode with a parent is linked in the bucket of its parent and
+ * name.  The table is protected by the inode lock.
+ */
+
+static FAR struct inode *g_inode_hash[CONFIG_FS_INODE_HASH_BUCKETS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_hash_name
+ *
+ * Description:
+ *   Hash a path segment, up to the '/' delimiter or the NUL terminator.
+ *
+ ****************************************************************************/
+
+static uint32_t inode_hash_name(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0' && *name != '/')
+    {
+      hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: inode_hash_bucket
+ ****************************************************************************/
+
+static inline FAR struct inode **
+inode_hash_bucket(FAR struct inode *parent, uint32_t hash)
+{
+  uintptr_t key = (uintptr_t)parent;
+
+  return &g_inode_hash[(hash ^ key ^ (key >> 7)) & INODE_HASH_MASK];
+}
+
+/****************************************************************************
+ * Name: inode_hash_match
+ *
+ * Description:
+ *   Check whether the path segment 'name' is the name of 'node'.
+ *
+ ****************************************************************************/
+
+static bool inode_hash_match(FAR const char *name, FAR struct inode *node)
+{
+  FAR const char *nname = node->i_name;
+
+  while (*nname != '\0' && *nname == *name)
+    {
+      nname++;
+      name++;
+    }
+
+  return *nname == '\0' && (*name == '\0' || *name == '/');
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_hash_insert
+ *
+ * Description:
+ *   Index an inode that was just linked below its parent.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+void inode_hash_insert(FAR struct inode *node)
+{
+  FAR struct inode **bucket;
+
+  DEBUGASSERT(node->i_parent != NULL);
+
+  node->i_hash  = inode_hash_name(node->i_name);
+  bucket        = inode_hash_bucket(node->i_parent, node->i_hash);
+  node->i_hnext = *bucket;
+  *bucket       = node;
+}
+
+/****************************************************************************
+ * Name: inode_hash_remove
+ *
+ * Description:
+ *   Remove an inode from the index before it is unlinked from its parent.
+ *   Inodes that are not indexed are ignored.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+void inode_hash_remove(FAR struct inode *node)
+{
+  FAR struct inode **link;
+
+  if (node->i_parent == NULL)
+    {
+      return;
+    }
+
+  link = inode_hash_bucket(node->i_parent, node->i_hash);
+  while (*link != NULL)
+    {
+      if (*link == node)
+        {
+          *link         = node->i_hnext;
+          node->i_hnext = NULL;
+          break;
+        }
+
+      link = &(*link)->i_hnext;
+    }
+}
+
+/****************************************************************************
+ * Name: inode_hash_find
+ *
+ * Description:
+ *   Find the child of 'parent' named by the path segment 'name'.
+ *
+ * Returned Value:
+ *   The child inode or NULL if it is not indexed.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+FAR struct inode *inode_hash_find(FAR struct inode *parent,
+                                  FAR const char *name)
+{
+  FAR struct inode *node;
+  uint32_t hash = inode_hash_name(name);
+
+  for (node = *inode_hash_bucket(parent, hash); node != NULL;
+       node = node->i_hnext)
+    {
+      if (node->i_hash == hash && node->i_parent == parent &&
+          inode_hash_match(name, node))
+        {
+          return node;
+        }
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_FS_INODE_HASH */
@@ -58,6 +58,9 @@ static FAR struct inode *inode_unlink(FAR const char *path)
 {
   struct inode_search_s desc;
   FAR struct inode *node = NULL;
+#ifdef CONFIG_FS_INODE_HASH
+  FAR struct inode *peer;
+#endif
   int ret;
 
   /* Verify parameters.  Ignore null paths */
@@ -77,6 +80,22 @@ static FAR struct inode *inode_unlink(FAR const char *path)
       node = desc.node;
       DEBUGASSERT(node != NULL);
 
+      inode_hash_remove(node);
+
+#ifdef CONFIG_FS_INODE_HASH
+      /* A lookup served by the hash table does not return the peer to the
+       * "left" of the node, find it here.
+       */
+
+      DEBUGASSERT(desc.parent != NULL);
+      desc.peer = NULL;
+      for (peer = desc.parent->i_child; peer != node; peer = peer->i_peer)
+        {
+          DEBUGASSERT(peer != NULL);
+          desc.peer = peer;
+        }
+#endif
+
       /* If peer is non-null, then remove the node from the right of
        * of that peer node.
        */
@@ -126,6 +126,8 @@ static void inode_insert(FAR struct inode *node,
       node->i_parent  = parent;
       parent->i_child = node;
     }
+
+  inode_hash_insert(node);
 }
 
 /****************************************************************************
@@ -239,7 +239,29 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
   while (node != NULL)
     {
-      int result = _inode_compare(name, node);
+#ifdef CONFIG_FS_INODE_HASH
+      FAR struct inode *child = NULL;
+#endif
+      int result;
+
+#ifdef CONFIG_FS_INODE_HASH
+      /* At the start of each level, look the name up in the hash table
+       * instead of scanning the peers.  The scan still handles the names
+       * that are not found, so that 'left' is the insertion point.  'left'
+       * is left NULL for a hit; inode_unlink() finds it when it needs it.
+       */
+
+      if (left == NULL && above != NULL &&
+          (child = inode_hash_find(above, name)) != NULL)
+        {
+          node   = child;
+          result = 0;
+        }
+      else
+#endif
+        {
+          result = _inode_compare(name, node);
+        }
 
       /* Case 1:  The name is less than the name of the node.
        * Since the names are ordered, these means that there
@@ -95,7 +95,8 @@
  *  node     - INPUT:  (not used)
  *             OUTPUT: On success, holds the pointer to the inode found.
  *  peer     - INPUT:  (not used)
- *             OUTPUT: The inode to the "left" of the inode found.
+ *             OUTPUT: The inode to the "left" of the inode found.  Not
+ *                     set for an inode found through the inode hash table.
  *  parent   - INPUT:  (not used)
  *             OUTPUT: The inode to the "above" of the inode found.
  *  relpath  - INPUT:  (not used)
@@ -311,6 +312,29 @@ void inode_free(FAR struct inode *node);
 
 const char *inode_nextname(FAR const char *name);
 
+/****************************************************************************
+ * Name: inode_hash_insert, inode_hash_remove and inode_hash_find
+ *
+ * Description:
+ *   Maintain and query the index of the inodes by parent and name, which
+ *   lets inode_search() skip the ordered scan of the peers at each level.
+ *   An inode is inserted once it is linked below its parent and removed
+ *   before it is unlinked or its parent changes.
+ *
+ *   NOTE: Caller must hold the inode semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_HASH
+void inode_hash_insert(FAR struct inode *node);
+void inode_hash_remove(FAR struct inode *node);
+FAR struct inode *inode_hash_find(FAR struct inode *parent,
+                                  FAR const char *name);
+#else
+#  define inode_hash_insert(node)
+#  define inode_hash_remove(node)
+#endif
+
 /****************************************************************************
  * Name: inode_root_reserve
  *
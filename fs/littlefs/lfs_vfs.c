@@ -59,10 +59,30 @@ struct littlefs_dir_s
   struct lfs_dir        dir;
 };
 
+#if CONFIG_FS_LITTLEFS_READAHEAD_SIZE > 0
+/* The readahead window of an open file.  Small reads of littlefs, one
+ * cache_size at a time, are served from a window filled by one large
+ * device read while the file is read sequentially.
+ */
+
+struct littlefs_readahead_s
+{
+  FAR uint8_t          *buffer; /* Window, allocated on first use */
+  lfs_block_t           block;  /* littlefs block of the window */
+  lfs_off_t             off;    /* Offset of the window in the block */
+  lfs_size_t            size;   /* Valid bytes in the window, 0 if empty */
+  unsigned int          gen;    /* Write generation the window was read at */
+  off_t                 next;   /* File position after the last read */
+};
+#endif
+
 struct littlefs_file_s
 {
   struct lfs_file       file;
   int                   refs;
+#if CONFIG_FS_LITTLEFS_READAHEAD_SIZE > 0
+  struct littlefs_readahead_s ra;
+#endif
 };
 
 /* This structure represents the overall mountpoint state. An instance of
@@ -77,6 +97,11 @@ struct littlefs_mountpt_s
   struct mtd_geometry_s geo;
   struct lfs_config     cfg;
   struct lfs            lfs;
+#if CONFIG_FS_LITTLEFS_READAHEAD_SIZE > 0
+  FAR struct littlefs_file_s *rafile; /* File read sequentially */
+  lfs_size_t            rasize;       /* Size of the readahead windows */
+  unsigned int          gen;          /* Counts programs and erases */
+#endif
 };
 
 /****************************************************************************
@@ -305,6 +330,9 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
     }
 
   priv->refs = 1;
+#if CONFIG_FS_LITTLEFS_READAHEAD_SIZE > 0
+  memset(&priv->ra, 0, sizeof(priv->ra));
+#endif
 
   /* Lock */
 
@@ -398,6 +426,9 @@ static int littlefs_close(FAR struct file *filep)
   nxmutex_unlock(&fs->lock);
   if (priv->refs <= 0)
     {
+#if CONFIG_FS_LITTLEFS_READAHEAD_SIZE > 0
+      kmm_free(priv->ra.buffer);
+#endif
       kmm_free(priv);
     }
 
@@ -441,6 +472,15 @@ static ssize_t littlefs_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#if CONFIG_FS_LITTLEFS_READAHEAD_SIZE > 0
+  /* Read ahead only if this read continues the previous one */
+
+  if (filep->f_pos == priv->ra.next)
+    {
+      fs->rafile = priv;
+    }
+#endif
+
   ret = littlefs_convert_result(lfs_file_read(&fs->lfs, &priv->file,
                                               buffer, buflen));
   if (ret > 0)
@@ -448,6 +488,11 @@ static ssize_t littlefs_read(FAR struct file *filep, FAR char *buffer,
       filep->f_pos += ret;
     }
 
+#if CONFIG_FS_LITTLEFS_READAHEAD_SIZE > 0
+  fs->rafile    = NULL;
+  priv->ra.next = filep->f_pos;
+#endif
+
 out:
   nxmutex_unlock(&fs->lock);
   return ret;
@@ -943,9 +988,9 @@ static int littlefs_rewinddir(FAR struct inode *mountpt,
  *
  ****************************************************************************/
 
-static int littlefs_read_block(FAR const struct lfs_config *c,
-                               lfs_block_t block, lfs_off_t off,
-                               FAR void *buffer, lfs_size_t size)
+static int littlefs_read_device(FAR const struct lfs_config *c,
+                                lfs_block_t block, lfs_off_t off,
+                                FAR void *buffer, lfs_size_t size)
 {
   FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
@@ -967,6 +1012,58 @@ static int littlefs_read_block(FAR const struct lfs_config *c,
   return ret >= 0 ? OK : ret;
 }
 
+static int littlefs_read_block(FAR const struct lfs_config *c,
+                               lfs_block_t block, lfs_off_t off,
+                               FAR void *buffer, lfs_size_t size)
+{
+#if CONFIG_FS_LITTLEFS_READAHEAD_SIZE > 0
+  FAR struct littlefs_mountpt_s *fs = c->context;
+  FAR struct littlefs_readahead_s *ra;
+  int ret;
+
+  /* Serve the reads of a file read sequentially from its window.  The
+   * window is refilled up to the end of the littlefs block, and dropped
+   * after anything has been programmed or erased.
+   */
+
+  if (fs->rafile != NULL && size < fs->rasize)
+    {
+      ra = &fs->rafile->ra;
+      if (ra->gen != fs->gen || ra->block != block || off < ra->off ||
+          off + size > ra->off + ra->size)
+        {
+          if (ra->buffer == NULL)
+            {
+              ra->buffer = kmm_malloc(fs->rasize);
+              if (ra->buffer == NULL)
+                {
+                  goto direct;
+                }
+            }
+
+          ra->size = lfs_min(fs->rasize, c->block_size - off);
+          ret = littlefs_read_device(c, block, off, ra->buffer, ra->size);
+          if (ret < 0)
+            {
+              ra->size = 0;
+              return ret;
+            }
+
+          ra->block = block;
+          ra->off   = off;
+          ra->gen   = fs->gen;
+        }
+
+      memcpy(buffer, ra->buffer + (off - ra->off), size);
+      return OK;
+    }
+
+direct:
+#endif
+
+  return littlefs_read_device(c, block, off, buffer, size);
+}
+
 /****************************************************************************
  * Name: littlefs_write_block
  ****************************************************************************/
@@ -980,6 +1077,10 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
   FAR struct inode *drv = fs->drv;
   int ret;
 
+#if CONFIG_FS_LITTLEFS_READAHEAD_SIZE > 0
+  fs->gen++;
+#endif
+
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
@@ -1006,6 +1107,10 @@ static int littlefs_erase_block(FAR const struct lfs_config *c,
   FAR struct inode *drv = fs->drv;
   int ret = OK;
 
+#if CONFIG_FS_LITTLEFS_READAHEAD_SIZE > 0
+  fs->gen++;
+#endif
+
   if (INODE_IS_MTD(drv))
     {
       FAR struct mtd_geometry_s *geo = &fs->geo;
@@ -1148,13 +1253,33 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.cache_size     = fs->geo.blocksize *
                            CONFIG_FS_LITTLEFS_CACHE_SIZE_FACTOR;
 
+  /* By default the lookahead bitmap covers the whole device, up to
+   * CONFIG_FS_LITTLEFS_LOOKAHEAD_MAX bytes, so that one traversal of the
+   * filesystem finds the free blocks of many allocations.
+   */
+
 #if CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE == 0
   fs->cfg.lookahead_size = lfs_min(lfs_alignup(fs->cfg.block_count, 64) / 8,
-                                   fs->cfg.read_size);
+                                   lfs_max(CONFIG_FS_LITTLEFS_LOOKAHEAD_MAX,
+                                           fs->cfg.read_size));
+  fs->cfg.lookahead_size = lfs_alignup(fs->cfg.lookahead_size, 8);
 #else
   fs->cfg.lookahead_size = CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE;
 #endif
 
+#if CONFIG_FS_LITTLEFS_READAHEAD_SIZE > 0
+  /* The readahead windows hold whole device blocks, and are only used if
+   * larger than the caches of littlefs.
+   */
+
+  fs->rasize = CONFIG_FS_LITTLEFS_READAHEAD_SIZE / fs->geo.blocksize *
+               fs->geo.blocksize;
+  if (fs->rasize <= fs->cfg.cache_size)
+    {
+      fs->rasize = 0;
+    }
+#endif
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
@@ -28,6 +28,7 @@
 #include <sys/mman.h>
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <debug.h>
@@ -35,6 +36,7 @@
 #include <nuttx/kmalloc.h>
 
 #include "inode/inode.h"
+#include "fs_pagecache.h"
 #include "fs_rammap.h"
 #include "fs_anonmap.h"
 
@@ -48,7 +50,8 @@
 
 static int file_mmap_(FAR struct file *filep, FAR void *start,
                       size_t length, int prot, int flags, off_t offset,
-                      enum mm_map_type_e type, FAR void **mapped)
+                      enum mm_map_type_e type, bool direct,
+                      FAR void **mapped)
 {
   int ret = -ENOTTY;
 
@@ -151,7 +154,15 @@ static int file_mmap_(FAR struct file *filep, FAR void *start,
       ret = filep->f_inode->u.i_ops->mmap(filep, &entry);
     }
 
-  if (ret == -ENOTTY)
+  if (ret == -ENOTTY && !direct && type == MAP_USER &&
+      (flags & MAP_SHARED) != 0)
+    {
+      /* Share the pages of the file with the other processes mapping it */
+
+      ret = pagecache_map(filep, &entry);
+    }
+
+  if (ret == -ENOTTY && !direct)
     {
       /* Caller request the private mapping. Or not directly mappable,
        * probably because the underlying media doesn't support random access.
@@ -170,6 +181,13 @@ out:
   if (ret >= OK)
     {
       *mapped = entry.vaddr;
+
+      /* Tell the caller whether the mapping has to be released */
+
+      if (direct)
+        {
+          ret = entry.munmap != NULL;
+        }
     }
 
   return ret;
@@ -193,7 +211,29 @@ int file_mmap(FAR struct file *filep, FAR void *start, size_t length,
               int prot, int flags, off_t offset, FAR void **mapped)
 {
   return file_mmap_(filep, start, length,
-                    prot, flags, offset, MAP_KERNEL, mapped);
+                    prot, flags, offset, MAP_KERNEL, false, mapped);
+}
+
+/****************************************************************************
+ * Name: file_mmap_direct
+ *
+ * Description:
+ *   Map a region of a file that the file system or the driver can access
+ *   in place.  Unlike file_mmap(), the file is never copied into RAM.
+ *
+ * Returned Value:
+ *   Zero (OK) if the region is a static address that need not be unmapped;
+ *   one if the mapping must be released with file_munmap(); a negated
+ *   errno value on failure.  -ENOTTY means that the region cannot be
+ *   accessed in place.
+ *
+ ****************************************************************************/
+
+int file_mmap_direct(FAR struct file *filep, size_t length, off_t offset,
+                     FAR void **mapped)
+{
+  return file_mmap_(filep, NULL, length, PROT_READ, MAP_SHARED, offset,
+                    MAP_KERNEL, true, mapped);
 }
 
 /****************************************************************************
@@ -285,7 +325,7 @@ FAR void *mmap(FAR void *start, size_t length, int prot, int flags,
     }
 
   ret = file_mmap_(filep, start, length,
-                   prot, flags, offset, MAP_USER, &mapped);
+                   prot, flags, offset, MAP_USER, false, &mapped);
   if (filep)
     {
       fs_putfilep(filep);
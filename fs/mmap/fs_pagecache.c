@@ -0,0 +1,497 @@
+/****************************************************************************
+ * fs/mmap/fs_pagecache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/lib/lib.h>
+#include <nuttx/mutex.h>
+#include <nuttx/pgalloc.h>
+#include <nuttx/queue.h>
+#include <nuttx/sched.h>
+
+#include "fs_pagecache.h"
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The cached pages of one file.  pages[i] is the physical page holding
+ * file page 'i', or zero if that page has not been mapped yet.
+ */
+
+struct pagecache_s
+{
+  FAR struct pagecache_s *flink;
+  FAR struct inode *inode;       /* Inode of the file or its mount point */
+  struct timespec mtime;         /* Modification time of the file ... */
+  off_t size;                    /* ... and its size, as last seen */
+  unsigned int refs;             /* Number of mappings of the file */
+  bool stale;                    /* Out of g_pagecache, file changed */
+  size_t npages;                 /* Size of pages[] */
+  FAR uintptr_t *pages;
+  char path[1];                  /* Full path identifying the file */
+};
+
+/* One mapping of a cached file */
+
+struct pagecache_map_s
+{
+  FAR struct pagecache_s *cache;
+  FAR struct file *filep;        /* For write back */
+  size_t first;                  /* File page of the first mapped page */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sq_queue_t g_pagecache;
+static mutex_t g_pagecache_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_get
+ *
+ * Description:
+ *   Find the page cache of the file 'path' of 'inode' or create an empty
+ *   one, and take a reference to it.  If the size or the modification time
+ *   of the file are no longer those of the cache, the file was written or
+ *   truncated without going through the cache.  The cache is then left to
+ *   its current mappings and a new one is created.  Called with
+ *   g_pagecache_lock held.
+ *
+ ****************************************************************************/
+
+static FAR struct pagecache_s *pagecache_get(FAR struct inode *inode,
+                                             FAR const char *path,
+                                             FAR const struct stat *buf)
+{
+  FAR struct pagecache_s *cache;
+
+  for (cache = (FAR struct pagecache_s *)sq_peek(&g_pagecache);
+       cache != NULL; cache = cache->flink)
+    {
+      if (cache->inode == inode && strcmp(cache->path, path) == 0)
+        {
+          if (cache->size == buf->st_size &&
+              cache->mtime.tv_sec == buf->st_mtim.tv_sec &&
+              cache->mtime.tv_nsec == buf->st_mtim.tv_nsec)
+            {
+              cache->refs++;
+              return cache;
+            }
+
+          sq_rem((FAR sq_entry_t *)cache, &g_pagecache);
+          cache->stale = true;
+          break;
+        }
+    }
+
+  cache = kmm_zalloc(sizeof(struct pagecache_s) + strlen(path));
+  if (cache != NULL)
+    {
+      strcpy(cache->path, path);
+      cache->inode = inode;
+      cache->mtime = buf->st_mtim;
+      cache->size  = buf->st_size;
+      cache->refs  = 1;
+      sq_addlast((FAR sq_entry_t *)cache, &g_pagecache);
+    }
+
+  return cache;
+}
+
+/****************************************************************************
+ * Name: pagecache_put
+ *
+ * Description:
+ *   Drop a reference to a page cache, freeing the cached pages with the
+ *   last reference.  Called with g_pagecache_lock held.
+ *
+ ****************************************************************************/
+
+static void pagecache_put(FAR struct pagecache_s *cache)
+{
+  size_t i;
+
+  if (--cache->refs > 0)
+    {
+      return;
+    }
+
+  for (i = 0; i < cache->npages; i++)
+    {
+      if (cache->pages[i] != 0)
+        {
+          mm_pgfree(cache->pages[i], 1);
+        }
+    }
+
+  if (!cache->stale)
+    {
+      sq_rem((FAR sq_entry_t *)cache, &g_pagecache);
+    }
+
+  kmm_free(cache->pages);
+  kmm_free(cache);
+}
+
+/****************************************************************************
+ * Name: pagecache_fill
+ *
+ * Description:
+ *   Make sure that file pages [first, first + npages) are in the cache,
+ *   reading the missing ones from the file.  Called with g_pagecache_lock
+ *   held.
+ *
+ ****************************************************************************/
+
+static int pagecache_fill(FAR struct pagecache_s *cache,
+                          FAR struct file *filep, size_t first,
+                          size_t npages)
+{
+  FAR uintptr_t *pages;
+  FAR uint8_t *vaddr;
+  uintptr_t page;
+  ssize_t nread;
+  size_t i;
+
+  if (first + npages > cache->npages)
+    {
+      pages = kmm_realloc(cache->pages,
+                          (first + npages) * sizeof(uintptr_t));
+      if (pages == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      memset(&pages[cache->npages], 0,
+             (first + npages - cache->npages) * sizeof(uintptr_t));
+      cache->pages  = pages;
+      cache->npages = first + npages;
+    }
+
+  for (i = first; i < first + npages; i++)
+    {
+      if (cache->pages[i] != 0)
+        {
+          continue;
+        }
+
+      page = mm_pgalloc(1);
+      if (page == 0)
+        {
+          return -ENOMEM;
+        }
+
+      vaddr = (FAR uint8_t *)up_addrenv_page_vaddr(page);
+      nread = file_pread(filep, vaddr, MM_PGSIZE, (off_t)i * MM_PGSIZE);
+      if (nread < 0)
+        {
+          ferr("ERROR: Read of page %zu failed: %zd\n", i, nread);
+          mm_pgfree(page, 1);
+          return nread;
+        }
+
+      /* Zero any memory beyond the end of file */
+
+      memset(vaddr + nread, 0, MM_PGSIZE - nread);
+      cache->pages[i] = page;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: msync_pagecache
+ *
+ * Description:
+ *   Write the mapped pages in [start, start + length) back to the file.
+ *
+ ****************************************************************************/
+
+static int msync_pagecache(FAR struct mm_map_entry_s *entry,
+                           FAR void *start, size_t length, int flags)
+{
+  FAR struct pagecache_map_s *map = entry->priv.p;
+  FAR struct pagecache_s *cache = map->cache;
+  FAR uint8_t *vaddr;
+  struct stat buf;
+  ssize_t nwrite;
+  size_t offset;
+  size_t first;
+  size_t last;
+  size_t i;
+  off_t pos;
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (length > entry->length - offset)
+    {
+      length = entry->length - offset;
+    }
+
+  if (length == 0)
+    {
+      return OK;
+    }
+
+  /* The mapping may extend beyond the end of file, that part is not
+   * written back.
+   */
+
+  nwrite = file_fstat(map->filep, &buf);
+  if (nwrite < 0)
+    {
+      return nwrite;
+    }
+
+  first = map->first + offset / MM_PGSIZE;
+  last  = map->first + (offset + length - 1) / MM_PGSIZE;
+
+  nxmutex_lock(&g_pagecache_lock);
+
+  for (i = first; i <= last; i++)
+    {
+      pos = (off_t)i * MM_PGSIZE;
+      if (pos >= buf.st_size)
+        {
+          break;
+        }
+
+      vaddr  = (FAR uint8_t *)up_addrenv_page_vaddr(cache->pages[i]);
+      nwrite = file_pwrite(map->filep, vaddr,
+                           MIN(MM_PGSIZE, buf.st_size - pos), pos);
+      if (nwrite < 0)
+        {
+          ferr("ERROR: Write of page %zu failed: %zd\n", i, nwrite);
+          break;
+        }
+    }
+
+  /* The file now matches the cache again, as far as it was written */
+
+  if (file_fstat(map->filep, &buf) >= 0)
+    {
+      cache->mtime = buf.st_mtim;
+      cache->size  = buf.st_size;
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+  return nwrite < 0 ? nwrite : OK;
+}
+
+/****************************************************************************
+ * Name: unmap_pagecache
+ ****************************************************************************/
+
+static int unmap_pagecache(FAR struct task_group_s *group,
+                           FAR struct mm_map_entry_s *entry,
+                           FAR void *start, size_t length)
+{
+  FAR struct pagecache_map_s *map = entry->priv.p;
+  int ret = OK;
+
+  /* Partial unmap is not supported */
+
+  if (start != entry->vaddr || length != entry->length)
+    {
+      return -EINVAL;
+    }
+
+  /* Unmap the pages from the user's address space.  The address
+   * environment is already gone if the process is exiting (group NULL).
+   */
+
+  if (group != NULL)
+    {
+      ret = up_shmdt((uintptr_t)entry->vaddr, MM_NPAGES(entry->length));
+      vm_release_region(get_group_mm(group), entry->vaddr, entry->length);
+    }
+
+  nxmutex_lock(&g_pagecache_lock);
+  pagecache_put(map->cache);
+  nxmutex_unlock(&g_pagecache_lock);
+
+  fs_putfilep(map->filep);
+  kmm_free(map);
+
+  /* Then remove the mapping from the list */
+
+  mm_map_remove(get_group_mm(group), entry);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_map
+ *
+ * Description:
+ *   Map a region of a file shared into the address space of the calling
+ *   process.  The file pages are kept in physical pages that are shared by
+ *   every process mapping the same file, and read from the file only the
+ *   first time that they are mapped.
+ *
+ * Input Parameters:
+ *   filep  - file descriptor of the backing file -- required.
+ *   entry  - mapping entry, with a page aligned offset
+ *
+ * Returned Value:
+ *   On success, pagecache_map() returns OK and the region is added to the
+ *   mappings of the process.  -ENOTTY is returned if the file cannot be
+ *   identified, the caller should then fall back to a private copy.
+ *   Otherwise a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int pagecache_map(FAR struct file *filep, FAR struct mm_map_entry_s *entry)
+{
+  FAR struct mm_map_s *mm = get_current_mm();
+  FAR struct pagecache_map_s *map;
+  FAR struct pagecache_s *cache;
+  struct stat buf;
+  FAR char *path;
+  FAR void *vaddr;
+  size_t npages;
+  int ret;
+
+  if ((entry->offset & (MM_PGSIZE - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = file_fstat(filep, &buf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Files are identified by their full path.  Without one, each mapping
+   * gets its own copy of the file instead.
+   */
+
+  path = lib_get_pathbuffer();
+  if (path == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = file_ioctl(filep, FIOC_FILEPATH, (unsigned long)(uintptr_t)path);
+  if (ret < 0)
+    {
+      lib_put_pathbuffer(path);
+      return -ENOTTY;
+    }
+
+  map = kmm_zalloc(sizeof(struct pagecache_map_s));
+  if (map == NULL)
+    {
+      lib_put_pathbuffer(path);
+      return -ENOMEM;
+    }
+
+  npages     = MM_NPAGES(entry->length);
+  map->first = entry->offset / MM_PGSIZE;
+
+  nxmutex_lock(&g_pagecache_lock);
+
+  cache = pagecache_get(filep->f_inode, path, &buf);
+  lib_put_pathbuffer(path);
+  if (cache == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+
+  ret = pagecache_fill(cache, filep, map->first, npages);
+  if (ret < 0)
+    {
+      goto errout_with_cache;
+    }
+
+  /* Map the shared pages into the user address space */
+
+  vaddr = vm_alloc_region(mm, NULL, npages * MM_PGSIZE);
+  if (vaddr == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_cache;
+    }
+
+  ret = up_shmat(&cache->pages[map->first], npages, (uintptr_t)vaddr);
+  if (ret < 0)
+    {
+      goto errout_with_region;
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+
+  fs_reffilep(filep);
+  map->cache    = cache;
+  map->filep    = filep;
+  entry->vaddr  = vaddr;
+  entry->priv.p = map;
+  entry->munmap = unmap_pagecache;
+  entry->msync  = msync_pagecache;
+
+  ret = mm_map_add(mm, entry);
+  if (ret < 0)
+    {
+      unmap_pagecache(this_task()->group, entry, vaddr, entry->length);
+    }
+
+  return ret;
+
+errout_with_region:
+  vm_release_region(mm, vaddr, npages * MM_PGSIZE);
+errout_with_cache:
+  pagecache_put(cache);
+errout_with_lock:
+  nxmutex_unlock(&g_pagecache_lock);
+  kmm_free(map);
+  return ret;
+}
@@ -0,0 +1,68 @@
+/****************************************************************************
+ * fs/mmap/fs_pagecache.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __FS_MMAP_FS_PAGECACHE_H
+#define __FS_MMAP_FS_PAGECACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <nuttx/mm/map.h>
+
+#ifdef CONFIG_FS_PAGECACHE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_map
+ *
+ * Description:
+ *   Map a region of a file shared into the address space of the calling
+ *   process.  The file pages are kept in physical pages that are shared by
+ *   every process mapping the same file, and read from the file only the
+ *   first time that they are mapped.
+ *
+ * Input Parameters:
+ *   filep  - file descriptor of the backing file -- required.
+ *   entry  - mapping entry, with a page aligned offset
+ *
+ * Returned Value:
+ *   On success, pagecache_map() returns OK and the region is added to the
+ *   mappings of the process.  -ENOTTY is returned if the file cannot be
+ *   identified, the caller should then fall back to a private copy.
+ *   Otherwise a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int pagecache_map(FAR struct file *filep, FAR struct mm_map_entry_s *entry);
+
+#else
+#  define pagecache_map(file, entry) (-ENOTTY)
+#endif /* CONFIG_FS_PAGECACHE */
+
+#endif /* __FS_MMAP_FS_PAGECACHE_H */
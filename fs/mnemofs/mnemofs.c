@@ -160,6 +160,11 @@ static int     mnemofs_rename(FAR struct inode *mountpt,
 static int     mnemofs_stat(FAR struct inode *mountpt,
                             FAR const char *relpath, FAR struct stat *buf);
 
+#ifdef CONFIG_MNEMOFS_LAZYFLUSH
+static void    mnemofs_flush_worker(FAR void *arg);
+#endif
+static int     mnemofs_flush_lazy(FAR struct mfs_sb_s *sb);
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -471,7 +476,7 @@ static int mnemofs_close(FAR struct file *filep)
 
   if (f->com->refcount == 0)
     {
-      ret = mnemofs_flush(sb);
+      ret = mnemofs_flush_lazy(sb);
       if (predict_false(ret < 0))
         {
           finfo("Error while flushing. Ret: %d.", ret);
@@ -483,7 +488,7 @@ static int mnemofs_close(FAR struct file *filep)
 
       finfo("Open file structure freed.");
 
-      ret = mnemofs_flush(sb);
+      ret = mnemofs_flush_lazy(sb);
       if (predict_false(ret < 0))
         {
           goto errout_with_fcom;
@@ -1697,6 +1702,16 @@ static int mnemofs_unbind(FAR void *handle, FAR struct inode **driver,
 
   *driver = sb->drv;
 
+#ifdef CONFIG_MNEMOFS_LAZYFLUSH
+  /* Write out the files closed since the last flush. */
+
+  work_cancel_sync(LPWORK, &sb->flush_work);
+
+  nxmutex_lock(&MFS_LOCK(sb));
+  mnemofs_flush(sb);
+  nxmutex_unlock(&MFS_LOCK(sb));
+#endif
+
   mfs_jrnl_free(sb);
   mfs_ba_free(sb);
 
@@ -2244,6 +2259,87 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: mnemofs_flush_worker
+ *
+ * Description:
+ *   Flushes the LRU from the low priority work queue.
+ *
+ * Input Parameters:
+ *   arg - Superblock instance of the device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MNEMOFS_LAZYFLUSH
+static void mnemofs_flush_worker(FAR void *arg)
+{
+  int                  ret;
+  FAR struct mfs_sb_s *sb  = arg;
+
+  ret = nxmutex_lock(&MFS_LOCK(sb));
+  if (ret < 0)
+    {
+      return;
+    }
+
+  finfo("Delayed flush started.");
+
+  /* If this fails, the changes stay in the LRU and the next close tries
+   * again.
+   */
+
+  ret = mnemofs_flush(sb);
+  if (predict_false(ret < 0))
+    {
+      ferr("Delayed flush failed. Ret: %d.", ret);
+    }
+
+  nxmutex_unlock(&MFS_LOCK(sb));
+}
+#endif
+
+/****************************************************************************
+ * Name: mnemofs_flush_lazy
+ *
+ * Description:
+ *   Flush the LRU after a file is closed. With CONFIG_MNEMOFS_LAZYFLUSH the
+ *   flush is delayed by up to CONFIG_MNEMOFS_FLUSH_DELAY ms, so that the
+ *   files closed meanwhile are written together and their parents and the
+ *   journal are updated only once. The LRU is flushed right away once it is
+ *   half full, as it can not be flushed node by node.
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ * Returned Value:
+ *   0   - OK
+ *   < 0 - Error
+ *
+ * Assumptions/Limitations:
+ *   The file system lock is held.
+ *
+ ****************************************************************************/
+
+static int mnemofs_flush_lazy(FAR struct mfs_sb_s *sb)
+{
+#ifdef CONFIG_MNEMOFS_LAZYFLUSH
+  if (list_length(&MFS_LRU(sb)) < CONFIG_MNEMOFS_NLRU / 2)
+    {
+      /* The first close after a flush sets the deadline for all. */
+
+      if (work_available(&sb->flush_work))
+        {
+          work_queue(LPWORK, &sb->flush_work, mnemofs_flush_worker, sb,
+                     MSEC2TICK(CONFIG_MNEMOFS_FLUSH_DELAY));
+        }
+
+      return OK;
+    }
+#endif
+
+  return mnemofs_flush(sb);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
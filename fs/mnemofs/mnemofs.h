@@ -59,6 +59,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/list.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -197,6 +198,9 @@ struct mfs_sb_s
   struct list_node        lru;
   struct list_node        of;            /* open files. */
   bool                    flush;
+#ifdef CONFIG_MNEMOFS_LAZYFLUSH
+  struct work_s           flush_work;    /* Delayed flush of the LRU. */
+#endif
 };
 
 /* This is for *dir VFS methods. */
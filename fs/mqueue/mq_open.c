@@ -123,14 +123,22 @@ static int nxmq_file_poll(FAR struct file *filep,
           goto errout;
         }
 
+#ifdef CONFIG_MQ_RING
+      /* The ring is used without this critical section.  Pairs with the
+       * fence of nxmq_ring_notify().
+       */
+
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+
       /* Immediately notify on any of the requested events */
 
-      if (msgq->nmsgs < msgq->maxmsgs)
+      if (nxmq_nmsgs(msgq) < msgq->maxmsgs)
         {
           eventset |= POLLOUT;
         }
 
-      if (msgq->nmsgs > 0)
+      if (nxmq_nmsgs(msgq) > 0)
         {
           eventset |= POLLIN;
         }
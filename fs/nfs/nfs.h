@@ -125,6 +125,20 @@ EXTERN int nfs_finddir(FAR struct nfsmount *nmp, FAR const char *relpath,
               FAR struct nfs_fattr *attributes, FAR char *filename);
 EXTERN void nfs_attrupdate(FAR struct nfsnode *np,
               FAR struct nfs_fattr *attributes);
+EXTERN int  nfs_request_send(FAR struct nfsmount *nmp, int procnum,
+              FAR void *request, size_t reqlen, FAR uint32_t *xid);
+EXTERN int  nfs_request_wait(FAR struct nfsmount *nmp,
+              FAR void *response, size_t resplen, FAR uint32_t *xid);
+EXTERN int  nfs_attrcheck(FAR struct nfsmount *nmp, FAR struct nfsnode *np);
+EXTERN ssize_t nfs_fileread(FAR struct nfsmount *nmp,
+              FAR struct nfsnode *np, off_t pos, FAR char *buffer,
+              size_t buflen);
+EXTERN ssize_t nfs_filewrite(FAR struct nfsmount *nmp,
+              FAR struct nfsnode *np, off_t pos, FAR const char *buffer,
+              size_t buflen);
+EXTERN int  nfs_fileflush(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+              bool commit);
+EXTERN void nfs_filerelease(FAR struct nfsnode *np);
 
 #undef EXTERN
 #if defined(__cplusplus)
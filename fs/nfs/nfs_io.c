@@ -0,0 +1,903 @@
+/****************************************************************************
+ * fs/nfs/nfs_io.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+
+#include "nfs.h"
+#include "rpc.h"
+#include "nfs_proto.h"
+#include "nfs_node.h"
+#include "nfs_mount.h"
+#include "xdr_subs.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One READ or WRITE call in flight */
+
+struct nfs_slot_s
+{
+  uint32_t xid;               /* Transaction ID, zero if the slot is free */
+  size_t   index;             /* Position of the data in the buffer */
+  size_t   nbytes;            /* Number of bytes requested */
+};
+
+/* A READ or WRITE transfer split into calls of at most 'chunk' bytes, up
+ * to CONFIG_NFS_RPC_WINDOW of which are in flight at the same time.
+ */
+
+struct nfs_window_s
+{
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  FAR uint8_t         *buffer;  /* Data read or to be written */
+  off_t                pos;     /* File offset of buffer[0] */
+  size_t               chunk;   /* Maximum data in one call */
+  size_t               next;    /* Index of the first byte not requested */
+  size_t               end;     /* Size of the transfer, reduced at EOF */
+  int                  procnum; /* NFSPROC_READ or NFSPROC_WRITE */
+  int                  stable;  /* Stability requested by the writes */
+  struct nfs_slot_s    slot[CONFIG_NFS_RPC_WINDOW];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nfs_fmtfhandle
+ *
+ * Description:
+ *   Format the file handle and the file offset that begin the arguments of
+ *   the READ, WRITE and COMMIT calls.
+ *
+ ****************************************************************************/
+
+static FAR uint32_t *nfs_fmtfhandle(FAR struct nfsnode *np,
+                                    FAR uint32_t *ptr, off_t pos,
+                                    FAR size_t *reqlen)
+{
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  txdr_hyper((uint64_t)pos, ptr);
+  ptr    += 2;
+
+  *reqlen = sizeof(uint32_t) + uint32_alignup(np->n_fhsize) +
+            2 * sizeof(uint32_t);
+  return ptr;
+}
+
+/****************************************************************************
+ * Name: nfs_setverf
+ *
+ * Description:
+ *   Remember the write verifier returned for UNSTABLE data and note if it
+ *   differs from the one seen before.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+static void nfs_setverf(FAR struct nfsnode *np, FAR const uint8_t *verf)
+{
+  if ((np->n_flags & NFSNODE_UNSTABLE) != 0 &&
+      memcmp(np->n_wverf, verf, NFSX_V3WRITEVERF) != 0)
+    {
+      np->n_flags |= NFSNODE_VERFCHANGED;
+    }
+
+  memcpy(np->n_wverf, verf, NFSX_V3WRITEVERF);
+  np->n_flags |= NFSNODE_UNSTABLE;
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_window_send
+ *
+ * Description:
+ *   Send the call of one slot.  A slot with a transaction ID is sent again
+ *   with the same ID.
+ *
+ ****************************************************************************/
+
+static int nfs_window_send(FAR struct nfs_window_s *w,
+                           FAR struct nfs_slot_s *slot)
+{
+  FAR struct nfsmount *nmp = w->nmp;
+  FAR uint32_t *ptr;
+  FAR void *request;
+  size_t reqlen;
+
+  if (w->procnum == NFSPROC_READ)
+    {
+      request = &nmp->nm_msgbuffer.read;
+      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+      ptr     = nfs_fmtfhandle(w->np, ptr, w->pos + slot->index, &reqlen);
+
+      *ptr    = txdr_unsigned(slot->nbytes);
+      reqlen += sizeof(uint32_t);
+    }
+  else
+    {
+      /* The WRITE call message lies in the I/O buffer */
+
+      request = nmp->nm_iobuffer;
+      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
+                  nmp->nm_iobuffer)->write;
+      ptr     = nfs_fmtfhandle(w->np, ptr, w->pos + slot->index, &reqlen);
+
+      *ptr++  = txdr_unsigned(slot->nbytes);
+      *ptr++  = txdr_unsigned(w->stable);
+      *ptr++  = txdr_unsigned(slot->nbytes);
+      reqlen += 3 * sizeof(uint32_t);
+
+      memcpy(ptr, w->buffer + slot->index, slot->nbytes);
+      reqlen += uint32_alignup(slot->nbytes);
+    }
+
+  finfo("Send %d xid %" PRIu32 " offset %jd size %zu\n", w->procnum,
+        slot->xid, (intmax_t)(w->pos + slot->index), slot->nbytes);
+  return nfs_request_send(nmp, w->procnum, request, reqlen, &slot->xid);
+}
+
+/****************************************************************************
+ * Name: nfs_window_fill
+ *
+ * Description:
+ *   Send new calls until the window is full or the transfer is requested
+ *   completely.
+ *
+ ****************************************************************************/
+
+static int nfs_window_fill(FAR struct nfs_window_s *w)
+{
+  FAR struct nfs_slot_s *slot;
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_RPC_WINDOW && w->next < w->end; i++)
+    {
+      slot = &w->slot[i];
+      if (slot->xid != 0)
+        {
+          continue;
+        }
+
+      slot->index  = w->next;
+      slot->nbytes = MIN(w->chunk, w->end - w->next);
+
+      ret = nfs_window_send(w, slot);
+      if (ret < 0)
+        {
+          slot->xid = 0;
+          return ret;
+        }
+
+      w->next += slot->nbytes;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_window_resend
+ *
+ * Description:
+ *   Send all calls in flight again after a timeout or a reconnection.
+ *
+ ****************************************************************************/
+
+static int nfs_window_resend(FAR struct nfs_window_s *w)
+{
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_RPC_WINDOW; i++)
+    {
+      if (w->slot[i].xid != 0)
+        {
+          ret = nfs_window_send(w, &w->slot[i]);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_window_find
+ *
+ * Description:
+ *   Return the slot waiting for the reply with this transaction ID, or
+ *   NULL if the reply belongs to no call in flight (a duplicate reply to
+ *   a retransmission or a reply to an abandoned call).
+ *
+ ****************************************************************************/
+
+static FAR struct nfs_slot_s *nfs_window_find(FAR struct nfs_window_s *w,
+                                              uint32_t xid)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_RPC_WINDOW; i++)
+    {
+      if (xid != 0 && w->slot[i].xid == xid)
+        {
+          return &w->slot[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: nfs_window_busy
+ ****************************************************************************/
+
+static bool nfs_window_busy(FAR struct nfs_window_s *w)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_RPC_WINDOW; i++)
+    {
+      if (w->slot[i].xid != 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nfs_window_done
+ *
+ * Description:
+ *   Process the reply of one slot, found in the I/O buffer.  The slot is
+ *   freed, or sent again for the rest of its data after a short transfer.
+ *
+ ****************************************************************************/
+
+static int nfs_window_done(FAR struct nfs_window_s *w,
+                           FAR struct nfs_slot_s *slot)
+{
+  FAR struct nfsmount *nmp = w->nmp;
+  FAR struct nfsnode *np = w->np;
+  FAR uint32_t *ptr;
+  uint32_t nbytes;
+  uint32_t eof = 0;
+
+  if (w->procnum == NFSPROC_READ)
+    {
+      ptr = (FAR uint32_t *)
+        &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+
+      /* Check if attributes are included in the response */
+
+      if (*ptr++ != 0)
+        {
+          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+          ptr += uint32_increment(sizeof(struct nfs_fattr));
+        }
+
+      /* Skip the count, get the EOF indication and the data length */
+
+      ptr++;
+      eof    = *ptr++;
+      nbytes = fxdr_unsigned(uint32_t, *ptr);
+      ptr++;
+
+      if (nbytes > slot->nbytes)
+        {
+          return -EIO;
+        }
+
+      memcpy(w->buffer + slot->index, ptr, nbytes);
+
+      if (eof != 0 && slot->index + nbytes < w->end)
+        {
+          w->end = slot->index + nbytes;
+        }
+    }
+  else
+    {
+      ptr = (FAR uint32_t *)
+        &((FAR struct rpc_reply_write *)nmp->nm_iobuffer)->write;
+
+      /* Skip the WCC attributes, update the file attributes if present */
+
+      if (*ptr++ != 0)
+        {
+          ptr += uint32_increment(sizeof(struct wcc_attr));
+        }
+
+      if (*ptr++ != 0)
+        {
+          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+          ptr += uint32_increment(sizeof(struct nfs_fattr));
+        }
+
+      nbytes = fxdr_unsigned(uint32_t, *ptr);
+      ptr++;
+
+      if (nbytes < 1 || nbytes > slot->nbytes)
+        {
+          return -EIO;
+        }
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+      if (fxdr_unsigned(uint32_t, *ptr) == NFSV3WRITE_UNSTABLE)
+        {
+          nfs_setverf(np, (FAR const uint8_t *)(ptr + 1));
+        }
+#endif
+    }
+
+  slot->xid = 0;
+
+  /* The server may transfer less than requested.  Ask for the rest. */
+
+  if (eof == 0 && nbytes < slot->nbytes)
+    {
+      if (nbytes == 0)
+        {
+          return -EIO;
+        }
+
+      slot->index  += nbytes;
+      slot->nbytes -= nbytes;
+      return nfs_window_send(w, slot);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_window_run
+ *
+ * Description:
+ *   Perform a windowed transfer.  Replies are matched to the calls by
+ *   their transaction ID and may arrive in any order.  After a timeout,
+ *   all calls in flight are sent again.
+ *
+ * Returned Value:
+ *   The number of bytes transferred (less than requested only at the end
+ *   of the file) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_window_run(FAR struct nfs_window_s *w)
+{
+  FAR struct nfsmount *nmp = w->nmp;
+  FAR struct nfs_slot_s *slot;
+  bool reconnected = false;
+  uint32_t xid;
+  int retries = 0;
+  int ret;
+
+  memset(w->slot, 0, sizeof(w->slot));
+  w->next = 0;
+
+  for (; ; )
+    {
+      xid = 0;
+      ret = nfs_window_fill(w);
+      if (ret == OK)
+        {
+          if (!nfs_window_busy(w))
+            {
+              break;
+            }
+
+          ret = nfs_request_wait(nmp, nmp->nm_iobuffer, nmp->nm_buflen,
+                                 &xid);
+        }
+
+      if (ret == -ENOTCONN && !reconnected)
+        {
+          finfo("Reconnect due to timeout\n");
+
+          reconnected = true;
+          ret = rpcclnt_connect(nmp->nm_rpcclnt);
+          if (ret == OK)
+            {
+              ret = nfs_window_resend(w);
+            }
+
+          if (ret < 0)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      if (ret == -EAGAIN || ret == -ETIMEDOUT)
+        {
+          if (++retries >= nmp->nm_rpcclnt->rc_retry)
+            {
+              break;
+            }
+
+          ret = nfs_window_resend(w);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      /* Ignore the replies to calls that are not in flight anymore */
+
+      slot = nfs_window_find(w, xid);
+      if (slot == NULL)
+        {
+          if (xid == 0)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      retries = 0;
+      ret = nfs_window_done(w, slot);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  if (ret < 0)
+    {
+      ferr("ERROR: NFS procedure %d failed: %d\n", w->procnum, ret);
+      return ret;
+    }
+
+  return w->end;
+}
+
+/****************************************************************************
+ * Name: nfs_readrpcs
+ *
+ * Description:
+ *   Read into the buffer with a window of READ calls.
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_readrpcs(FAR struct nfsmount *nmp,
+                            FAR struct nfsnode *np, off_t pos,
+                            FAR char *buffer, size_t buflen)
+{
+  struct nfs_window_s w;
+
+  w.nmp     = nmp;
+  w.np      = np;
+  w.buffer  = (FAR uint8_t *)buffer;
+  w.pos     = pos;
+  w.end     = buflen;
+  w.procnum = NFSPROC_READ;
+  w.stable  = 0;
+
+  /* Each reply must fit into the I/O buffer */
+
+  w.chunk   = MIN(nmp->nm_rsize,
+                  nmp->nm_buflen - SIZEOF_rpc_reply_read(0));
+
+  return nfs_window_run(&w);
+}
+
+/****************************************************************************
+ * Name: nfs_writerpcs
+ *
+ * Description:
+ *   Write the buffer with a window of WRITE calls.
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_writerpcs(FAR struct nfsmount *nmp,
+                             FAR struct nfsnode *np, off_t pos,
+                             FAR const char *buffer, size_t buflen,
+                             int stable)
+{
+  struct nfs_window_s w;
+  ssize_t ret;
+
+  w.nmp     = nmp;
+  w.np      = np;
+  w.buffer  = (FAR uint8_t *)buffer;
+  w.pos     = pos;
+  w.end     = buflen;
+  w.procnum = NFSPROC_WRITE;
+  w.stable  = stable;
+
+  /* Each call must fit into the I/O buffer */
+
+  w.chunk   = MIN(nmp->nm_wsize,
+                  nmp->nm_buflen - SIZEOF_rpc_call_write(0));
+
+  ret = nfs_window_run(&w);
+
+  /* The replies may arrive out of order, so the attributes of the last
+   * one do not necessarily include all of the data.
+   */
+
+  if (ret > 0 && pos + ret > np->n_size)
+    {
+      np->n_size = pos + ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nfs_commit
+ *
+ * Description:
+ *   Make the data of the UNSTABLE writes stable on the server.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int nfs_commit(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  FAR uint32_t *ptr;
+  size_t reqlen;
+  int ret;
+
+  /* A count of zero commits everything from the offset on */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.commit.commit;
+  ptr     = nfs_fmtfhandle(np, ptr, 0, &reqlen);
+  *ptr    = 0;
+  reqlen += sizeof(uint32_t);
+
+  nfs_statistics(NFSPROC_COMMIT);
+  ret = nfs_request(nmp, NFSPROC_COMMIT,
+                    &nmp->nm_msgbuffer.commit, reqlen,
+                    nmp->nm_iobuffer, nmp->nm_buflen);
+  if (ret < 0)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  ptr = (FAR uint32_t *)
+    &((FAR struct rpc_reply_commit *)nmp->nm_iobuffer)->commit;
+
+  if (*ptr++ != 0)
+    {
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  if (*ptr++ != 0)
+    {
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* A new verifier means that the server restarted since some of the
+   * writes and may have lost their data.
+   */
+
+  nfs_setverf(np, (FAR const uint8_t *)ptr);
+
+  ret = (np->n_flags & NFSNODE_VERFCHANGED) != 0 ? -EIO : OK;
+  np->n_flags &= ~(NFSNODE_UNSTABLE | NFSNODE_VERFCHANGED);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nfs_attrcheck
+ *
+ * Description:
+ *   Fetch the attributes of an open file again if they are older than
+ *   CONFIG_NFS_ATTRCACHE_TIMEO seconds.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nfs_attrcheck(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+#if CONFIG_NFS_ATTRCACHE_TIMEO > 0
+  FAR struct rpc_call_fs *getattr;
+  FAR struct rpc_reply_getattr *reply;
+  int ret;
+
+  if (clock_systime_ticks() - np->n_attrstamp <
+      SEC2TICK(CONFIG_NFS_ATTRCACHE_TIMEO))
+    {
+      return OK;
+    }
+
+  getattr = &nmp->nm_msgbuffer.fsinfo;
+  getattr->fs.fsroot.length = txdr_unsigned(np->n_fhsize);
+  memcpy(&getattr->fs.fsroot.handle, &np->n_fhandle, np->n_fhsize);
+
+  nfs_statistics(NFSPROC_GETATTR);
+  ret = nfs_request(nmp, NFSPROC_GETATTR,
+                    getattr, sizeof(uint32_t) +
+                    uint32_alignup(np->n_fhsize),
+                    nmp->nm_iobuffer, nmp->nm_buflen);
+  if (ret < 0)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  reply = (FAR struct rpc_reply_getattr *)nmp->nm_iobuffer;
+  nfs_attrupdate(np, &reply->attr);
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_fileread
+ *
+ * Description:
+ *   Read from an open file, through the read cache if it is enabled.
+ *   Sequential reads fill the whole cache, so that the following reads
+ *   are served from memory.  Other reads only fetch what they need.
+ *
+ * Returned Value:
+ *   The number of bytes read on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t nfs_fileread(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                     off_t pos, FAR char *buffer, size_t buflen)
+{
+#ifdef CONFIG_NFS_READCACHE
+  ssize_t nread = 0;
+  ssize_t ret = 0;
+  size_t nbytes;
+
+  while (buflen > 0)
+    {
+      /* Copy what the cache holds */
+
+      if (np->n_rclen > 0 && pos >= np->n_rcoff &&
+          pos < np->n_rcoff + (off_t)np->n_rclen)
+        {
+          nbytes = MIN(buflen, np->n_rcoff + np->n_rclen - pos);
+          memcpy(buffer, np->n_rcache + (pos - np->n_rcoff), nbytes);
+
+          pos    += nbytes;
+          buffer += nbytes;
+          buflen -= nbytes;
+          nread  += nbytes;
+          continue;
+        }
+
+      if (np->n_rcache == NULL && buflen < CONFIG_NFS_READCACHE_SIZE)
+        {
+          np->n_rcache = kmm_malloc(CONFIG_NFS_READCACHE_SIZE);
+        }
+
+      /* Large reads go directly to the caller buffer */
+
+      if (buflen >= CONFIG_NFS_READCACHE_SIZE || np->n_rcache == NULL)
+        {
+          ret = nfs_readrpcs(nmp, np, pos, buffer, buflen);
+          if (ret > 0)
+            {
+              pos   += ret;
+              nread += ret;
+            }
+
+          break;
+        }
+
+      /* Refill the cache, reading ahead for a sequential reader */
+
+      nbytes = buflen;
+      if (pos == np->n_rdnext)
+        {
+          nbytes = MIN(CONFIG_NFS_READCACHE_SIZE, np->n_size - pos);
+        }
+
+      np->n_rclen = 0;
+      ret = nfs_readrpcs(nmp, np, pos, (FAR char *)np->n_rcache, nbytes);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      np->n_rcoff = pos;
+      np->n_rclen = ret;
+    }
+
+  np->n_rdnext = pos;
+  return nread > 0 ? nread : ret;
+#else
+  return nfs_readrpcs(nmp, np, pos, buffer, buflen);
+#endif
+}
+
+/****************************************************************************
+ * Name: nfs_filewrite
+ *
+ * Description:
+ *   Write to an open file.  With write-behind, small sequential writes are
+ *   collected and sent as UNSTABLE writes when the buffer is full or
+ *   flushed.  Otherwise the data is written FILESYNC before returning.
+ *
+ * Returned Value:
+ *   The number of bytes written on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t nfs_filewrite(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                      off_t pos, FAR const char *buffer, size_t buflen)
+{
+#ifdef CONFIG_NFS_WRITEBEHIND
+  int ret;
+#endif
+
+#ifdef CONFIG_NFS_READCACHE
+  np->n_rclen = 0;
+#endif
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+  /* Send the buffered data first unless the new data continues it */
+
+  if (np->n_wblen > 0 &&
+      (pos != np->n_wboff + (off_t)np->n_wblen ||
+       np->n_wblen + buflen > CONFIG_NFS_WRITEBEHIND_SIZE))
+    {
+      ret = nfs_fileflush(nmp, np, false);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (np->n_wbuf == NULL && buflen < CONFIG_NFS_WRITEBEHIND_SIZE)
+    {
+      np->n_wbuf = kmm_malloc(CONFIG_NFS_WRITEBEHIND_SIZE);
+    }
+
+  if (buflen >= CONFIG_NFS_WRITEBEHIND_SIZE || np->n_wbuf == NULL)
+    {
+      return nfs_writerpcs(nmp, np, pos, buffer, buflen,
+                           NFSV3WRITE_UNSTABLE);
+    }
+
+  if (np->n_wblen == 0)
+    {
+      np->n_wboff = pos;
+    }
+
+  memcpy(np->n_wbuf + np->n_wblen, buffer, buflen);
+  np->n_wblen += buflen;
+
+  if (pos + buflen > np->n_size)
+    {
+      np->n_size = pos + buflen;
+    }
+
+  return buflen;
+#else
+  return nfs_writerpcs(nmp, np, pos, buffer, buflen, NFSV3WRITE_FILESYNC);
+#endif
+}
+
+/****************************************************************************
+ * Name: nfs_fileflush
+ *
+ * Description:
+ *   Send the data held in the write-behind buffer and, if commit is true,
+ *   make all of the UNSTABLE data of the file stable with one COMMIT.  The
+ *   buffer is emptied even if the write fails; the error is reported once.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nfs_fileflush(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                  bool commit)
+{
+#ifdef CONFIG_NFS_WRITEBEHIND
+  ssize_t ret;
+  size_t nbytes;
+
+  if (np->n_wblen > 0)
+    {
+      nbytes      = np->n_wblen;
+      np->n_wblen = 0;
+
+      ret = nfs_writerpcs(nmp, np, np->n_wboff, (FAR const char *)np->n_wbuf,
+                          nbytes, NFSV3WRITE_UNSTABLE);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (commit && (np->n_flags & NFSNODE_UNSTABLE) != 0)
+    {
+      return nfs_commit(nmp, np);
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_filerelease
+ *
+ * Description:
+ *   Free the buffers of a file that is closed.
+ *
+ ****************************************************************************/
+
+void nfs_filerelease(FAR struct nfsnode *np)
+{
+#ifdef CONFIG_NFS_READCACHE
+  kmm_free(np->n_rcache);
+  np->n_rcache = NULL;
+#endif
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+  kmm_free(np->n_wbuf);
+  np->n_wbuf = NULL;
+#endif
+}
@@ -48,8 +48,19 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/clock.h>
+
 #include "nfs_proto.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values for the n_flags field */
+
+#define NFSNODE_UNSTABLE    (1 << 0) /* UNSTABLE writes wait for a COMMIT */
+#define NFSNODE_VERFCHANGED (1 << 1) /* The server write verifier changed */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -70,6 +81,23 @@ struct nfsnode
   struct timespec     n_ctime;      /* File creation time */
   nfsfh_t             n_fhandle;    /* NFS File Handle */
   uint64_t            n_size;       /* Current size of file */
+  clock_t             n_attrstamp;  /* Time the attributes were fetched */
+#ifdef CONFIG_NFS_READCACHE
+  FAR uint8_t        *n_rcache;     /* Read cache, allocated on first use */
+  off_t               n_rcoff;      /* File offset of the read cache */
+  size_t              n_rclen;      /* Valid bytes in the read cache */
+  off_t               n_rdnext;     /* Offset of a sequential next read */
+#endif
+#ifdef CONFIG_NFS_WRITEBEHIND
+  FAR uint8_t        *n_wbuf;       /* Write-behind buffer */
+  off_t               n_wboff;      /* File offset of the buffered data */
+  size_t              n_wblen;      /* Bytes in the write-behind buffer */
+  uint8_t             n_flags;      /* See NFSNODE_* definitions */
+
+  /* Write verifier of the UNSTABLE data */
+
+  uint8_t             n_wverf[NFSX_V3WRITEVERF];
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
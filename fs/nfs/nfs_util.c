@@ -99,6 +99,37 @@ static inline int nfs_pathsegment(FAR const char **path, FAR char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: nfs_checkreply
+ *
+ * Description:
+ *   Verify the NFS level status of an RPC reply.
+ *
+ ****************************************************************************/
+
+static int nfs_checkreply(FAR void *response)
+{
+  struct nfs_reply_header replyh;
+
+  memcpy(&replyh, response, sizeof(struct nfs_reply_header));
+
+  if (replyh.nfs_status != 0)
+    {
+      /* NFS_ERRORS are the same as NuttX errno values */
+
+      return -fxdr_unsigned(uint32_t, replyh.nfs_status);
+    }
+
+  if (replyh.rh.rpc_verfi.authtype != 0)
+    {
+      ferr("ERROR: NFS authtype %d from server\n",
+           fxdr_unsigned(int, replyh.rh.rpc_verfi.authtype));
+      return -EOPNOTSUPP;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -120,7 +151,6 @@ int nfs_request(FAR struct nfsmount *nmp, int procnum,
                 FAR void *response, size_t resplen)
 {
   FAR struct rpcclnt *clnt = nmp->nm_rpcclnt;
-  struct nfs_reply_header replyh;
   int error;
 
   error = rpcclnt_request(clnt, procnum, NFS_PROG, NFS_VER3,
@@ -156,25 +186,61 @@ int nfs_request(FAR struct nfsmount *nmp, int procnum,
         }
     }
 
-  memcpy(&replyh, response, sizeof(struct nfs_reply_header));
-
-  if (replyh.nfs_status != 0)
+  error = nfs_checkreply(response);
+  if (error == OK)
     {
-      /* NFS_ERRORS are the same as NuttX errno values */
-
-      return -fxdr_unsigned(uint32_t, replyh.nfs_status);
+      finfo("NFS_SUCCESS\n");
     }
 
-  if (replyh.rh.rpc_verfi.authtype != 0)
+  return error;
+}
+
+/****************************************************************************
+ * Name: nfs_request_send
+ *
+ * Description:
+ *   Send one NFS call without waiting for the reply.  See
+ *   rpcclnt_send_call() for the meaning of xid.
+ *
+ * Returned Value:
+ *   Zero on success; a negative errno value on failure.
+ *
+ ****************************************************************************/
+
+int nfs_request_send(FAR struct nfsmount *nmp, int procnum,
+                     FAR void *request, size_t reqlen, FAR uint32_t *xid)
+{
+  nfs_statistics(procnum);
+  return rpcclnt_send_call(nmp->nm_rpcclnt, procnum, NFS_PROG, NFS_VER3,
+                           request, reqlen, xid);
+}
+
+/****************************************************************************
+ * Name: nfs_request_wait
+ *
+ * Description:
+ *   Receive the reply to any of the calls sent by nfs_request_send() and
+ *   verify its NFS level status.  The transaction ID of the reply is
+ *   returned in xid, also when the call failed on the server.
+ *
+ * Returned Value:
+ *   Zero on success; a negative errno value on failure.
+ *
+ ****************************************************************************/
+
+int nfs_request_wait(FAR struct nfsmount *nmp, FAR void *response,
+                     size_t resplen, FAR uint32_t *xid)
+{
+  int error;
+
+  *xid  = 0;
+  error = rpcclnt_wait_reply(nmp->nm_rpcclnt, response, resplen, xid);
+  if (error != OK)
     {
-      error = -EOPNOTSUPP;
-      ferr("ERROR: NFS authtype %d from server\n",
-           fxdr_unsigned(int, replyh.rh.rpc_verfi.authtype));
       return error;
     }
 
-  finfo("NFS_SUCCESS\n");
-  return OK;
+  return nfs_checkreply(response);
 }
 
 /****************************************************************************
@@ -514,6 +580,22 @@ int nfs_finddir(FAR struct nfsmount *nmp, FAR const char *relpath,
 
 void nfs_attrupdate(FAR struct nfsnode *np, FAR struct nfs_fattr *attributes)
 {
+#ifdef CONFIG_NFS_READCACHE
+  struct timespec mtime;
+  uint64_t size;
+
+  /* Drop the cached data if the file was changed */
+
+  size = fxdr_hyper(&attributes->fa_size);
+  fxdr_nfsv3time(&attributes->fa_mtime, &mtime);
+
+  if (size != np->n_size || mtime.tv_sec != np->n_mtime.tv_sec ||
+      mtime.tv_nsec != np->n_mtime.tv_nsec)
+    {
+      np->n_rclen = 0;
+    }
+#endif
+
   /* Save a few of the files attribute values in file structure (host
    * order).
    */
@@ -525,4 +607,6 @@ void nfs_attrupdate(FAR struct nfsnode *np, FAR struct nfs_fattr *attributes)
   fxdr_nfsv3time(&attributes->fa_atime, &np->n_atime);
   fxdr_nfsv3time(&attributes->fa_mtime, &np->n_mtime);
   fxdr_nfsv3time(&attributes->fa_ctime, &np->n_ctime);
+
+  np->n_attrstamp = clock_systime_ticks();
 }
@@ -768,6 +768,7 @@ static int nfs_close(FAR struct file *filep)
   FAR struct nfsnode  *np;
   FAR struct nfsnode  *prev;
   FAR struct nfsnode  *curr;
+  int flushret;
   int ret;
 
   /* Sanity checks */
@@ -808,6 +809,16 @@ static int nfs_close(FAR struct file *filep)
 
   else
     {
+      /* Write out and COMMIT the data still held back.  A failure is
+       * reported, but the file is closed anyway.
+       */
+
+      flushret = nfs_fileflush(nmp, np, true);
+      if (flushret < 0)
+        {
+          ferr("ERROR: nfs_fileflush failed: %d\n", flushret);
+        }
+
       /* Assume file structure won't be found. This should never happen. */
 
       ret = -EINVAL;
@@ -837,8 +848,9 @@ static int nfs_close(FAR struct file *filep)
 
               /* Then deallocate the file structure and return success */
 
+              nfs_filerelease(np);
               kmm_free(np);
-              ret = OK;
+              ret = flushret;
               break;
             }
         }
@@ -861,14 +873,9 @@ static int nfs_close(FAR struct file *filep)
 static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen)
 {
-  FAR struct nfsmount       *nmp;
-  FAR struct nfsnode        *np;
-  ssize_t                    readsize;
-  ssize_t                    tmp;
-  ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
-  int                        ret = 0;
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  ssize_t              ret;
 
   finfo("Read %zu bytes from offset %jd\n",
         buflen, (intmax_t)filep->f_pos);
@@ -887,138 +894,50 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
   ret = nxmutex_lock(&nmp->nm_lock);
   if (ret < 0)
     {
-      return (ssize_t)ret;
+      return ret;
     }
 
-  /* Get the number of bytes left in the file and truncate read count so that
-   * it does not exceed the number of bytes left in the file.
+  /* Write out any data held back, then make sure that the file size is
+   * not older than the attribute cache timeout.
    */
 
-  tmp = np->n_size - filep->f_pos;
-  if (buflen > tmp)
+  ret = nfs_fileflush(nmp, np, false);
+  if (ret == OK)
     {
-      buflen = tmp;
-      finfo("Read size truncated to %zu\n", buflen);
+      ret = nfs_attrcheck(nmp, np);
     }
 
-  /* Now loop until we fill the user buffer (or hit the end of the file) */
-
-  for (bytesread = 0; bytesread < buflen; )
+  if (ret < 0)
     {
-      /* Make sure that the attempted read size does not exceed the RPC
-       * maximum
-       */
-
-      readsize = buflen - bytesread;
-      if (readsize > nmp->nm_rsize)
-        {
-          readsize = nmp->nm_rsize;
-        }
-
-      /* Make sure that the attempted read size does not exceed the IO buffer
-       * size
-       */
-
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
-        {
-          readsize -= (tmp - nmp->nm_buflen);
-        }
-
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Set the readsize */
-
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
-
-      /* Perform the read */
-
-      finfo("Reading %zu bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      ret = nfs_request(nmp, NFSPROC_READ,
-                        &nmp->nm_msgbuffer.read, reqlen,
-                        nmp->nm_iobuffer, nmp->nm_buflen);
-      if (ret)
-        {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
-          goto errout_with_lock;
-        }
-
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
-       */
-
-      ptr = (FAR uint32_t *)
-        &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
-
-      /* Check if attributes are included in the responses */
-
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
-
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
-
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
-
-      ptr++;
-
-      /* Next comes an EOF indication.  Save that in tmp for now. */
-
-      tmp = *ptr++;
-
-      /* Then the length of the read data followed by the read data itself */
-
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
-
-      /* Copy the read data into the user buffer */
+      goto errout_with_lock;
+    }
 
-      memcpy(buffer, ptr, readsize);
+  /* Get the number of bytes left in the file and truncate read count so that
+   * it does not exceed the number of bytes left in the file.
+   */
 
-      /* Update the read state data */
+  if (filep->f_pos >= np->n_size)
+    {
+      goto errout_with_lock;
+    }
 
-      filep->f_pos += readsize;
-      bytesread    += readsize;
-      buffer       += readsize;
+  if (buflen > np->n_size - filep->f_pos)
+    {
+      buflen = np->n_size - filep->f_pos;
+      finfo("Read size truncated to %zu\n", buflen);
+    }
 
-      /* Check if we hit the end of file */
+  /* Now read with a window of READ RPCs, or from the read cache */
 
-      if (tmp != 0)
-        {
-          break;
-        }
+  ret = nfs_fileread(nmp, np, filep->f_pos, buffer, buflen);
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
     }
 
 errout_with_lock:
   nxmutex_unlock(&nmp->nm_lock);
-  return bytesread > 0 ? bytesread : ret;
+  return ret;
 }
 
 /****************************************************************************
@@ -1035,15 +954,7 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
 {
   FAR struct nfsmount *nmp;
   FAR struct nfsnode  *np;
-  ssize_t              writesize;
-  ssize_t              bufsize;
-  ssize_t              byteswritten = 0;
-  size_t               reqlen;
-  FAR uint32_t        *ptr;
-  uint32_t             tmp;
-  int                  commit = 0;
-  int                  committed = NFSV3WRITE_FILESYNC;
-  int                  ret;
+  ssize_t              ret;
 
   finfo("Write %zu bytes to offset %jd\n",
         buflen, (intmax_t)filep->f_pos);
@@ -1062,7 +973,7 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
   ret = nxmutex_lock(&nmp->nm_lock);
   if (ret < 0)
     {
-      return (ssize_t)ret;
+      return ret;
     }
 
   /* Check if the file size would exceed the range of off_t */
@@ -1073,141 +984,17 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
       goto errout_with_lock;
     }
 
-  /* Now loop until we send the entire user buffer */
+  /* Send the data with a window of WRITE RPCs, or buffer it */
 
-  for (byteswritten = 0; byteswritten < buflen; )
+  ret = nfs_filewrite(nmp, np, filep->f_pos, buffer, buflen);
+  if (ret > 0)
     {
-      /* Make sure that the attempted write size does not exceed the RPC
-       * maximum.
-       */
-
-      writesize = buflen - byteswritten;
-      if (writesize > nmp->nm_wsize)
-        {
-          writesize = nmp->nm_wsize;
-        }
-
-      /* Make sure that the attempted read size does not exceed the IO
-       * buffer size.
-       */
-
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
-        {
-          writesize -= (bufsize - nmp->nm_buflen);
-        }
-
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls message lies in the I/O buffer
-       */
-
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
-                  nmp->nm_iobuffer)->write;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy the count and stable values */
-
-      *ptr++  = txdr_unsigned(writesize);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy a chunk of the user data into the I/O buffer */
-
-      *ptr++  = txdr_unsigned(writesize);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
-
-      /* Perform the write */
-
-      nfs_statistics(NFSPROC_WRITE);
-      ret = nfs_request(nmp, NFSPROC_WRITE,
-                        nmp->nm_iobuffer, reqlen,
-                        &nmp->nm_msgbuffer.write,
-                        sizeof(struct rpc_reply_write));
-      if (ret)
-        {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
-          goto errout_with_lock;
-        }
-
-      /* Get a pointer to the WRITE reply data */
-
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
-
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
-
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
-
-          ptr += uint32_increment(sizeof(struct wcc_attr));
-        }
-
-      /* Check if normal file attributes follow */
-
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
-
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
-
-      /* Get the count of bytes actually written */
-
-      tmp = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
-
-      if (tmp < 1 || tmp > writesize)
-        {
-          ret = -EIO;
-          goto errout_with_lock;
-        }
-
-      writesize = tmp;
-
-      /* Determine the lowest commitment level obtained by any of the RPCs. */
-
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
-        {
-          committed = commit;
-        }
-      else if (committed == NFSV3WRITE_DATASYNC &&
-               commit == NFSV3WRITE_UNSTABLE)
-        {
-          committed = commit;
-        }
-
-      /* Update the read state data */
-
-      filep->f_pos += writesize;
-      byteswritten += writesize;
-      buffer       += writesize;
+      filep->f_pos += ret;
     }
 
 errout_with_lock:
   nxmutex_unlock(&nmp->nm_lock);
-  return byteswritten > 0 ? byteswritten : ret;
+  return ret;
 }
 
 /****************************************************************************
@@ -1285,7 +1072,29 @@ static off_t nfs_seek(FAR struct file *filep, off_t offset, int whence)
 
 static int nfs_sync(FAR struct file *filep)
 {
-  return 0;
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  int                  ret;
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  nmp = filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
+
+  DEBUGASSERT(nmp != NULL);
+
+  ret = nxmutex_lock(&nmp->nm_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Send the buffered data and COMMIT all of the UNSTABLE writes */
+
+  ret = nfs_fileflush(nmp, np, true);
+
+  nxmutex_unlock(&nmp->nm_lock);
+  return ret;
 }
 
 /****************************************************************************
@@ -1368,6 +1177,22 @@ static int nfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
       return ret;
     }
 
+  /* Write out any data held back and refresh attributes older than the
+   * attribute cache timeout.
+   */
+
+  ret = nfs_fileflush(nmp, np, false);
+  if (ret == OK)
+    {
+      ret = nfs_attrcheck(nmp, np);
+    }
+
+  if (ret < 0)
+    {
+      nxmutex_unlock(&nmp->nm_lock);
+      return ret;
+    }
+
   /* Extract the file mode, file type, and file size from the nfsnode
    * structure.
    */
@@ -1420,7 +1245,11 @@ static int nfs_fchstat(FAR const struct file *filep,
 
   /* Change the file mode, owner, group and time. */
 
-  ret = nfs_filechstat(nmp, np, buf, flags);
+  ret = nfs_fileflush(nmp, np, false);
+  if (ret == OK)
+    {
+      ret = nfs_filechstat(nmp, np, buf, flags);
+    }
 
   nxmutex_unlock(&nmp->nm_lock);
   return ret;
@@ -1459,7 +1288,11 @@ static int nfs_truncate(FAR struct file *filep, off_t length)
       /* Then perform the SETATTR RPC to set the new file size */
 
       buf.st_size = length;
-      ret = nfs_filechstat(nmp, np, &buf, CH_STAT_SIZE);
+      ret = nfs_fileflush(nmp, np, false);
+      if (ret == OK)
+        {
+          ret = nfs_filechstat(nmp, np, &buf, CH_STAT_SIZE);
+        }
 
       nxmutex_unlock(&nmp->nm_lock);
     }
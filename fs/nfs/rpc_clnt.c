@@ -150,6 +150,7 @@ static int rpcclnt_reply(FAR struct rpcclnt *rpc, uint32_t xid,
                          FAR void *reply, size_t resplen);
 static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
                               uint32_t xid, int procid, int prog, int vers);
+static int rpcclnt_accepted(FAR struct rpc_reply_header *replymsg);
 
 /****************************************************************************
  * Private Functions
@@ -501,6 +502,38 @@ static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
   ch->rpc_verf.authlen   = 0;
 }
 
+/****************************************************************************
+ * Name: rpcclnt_accepted
+ *
+ * Description:
+ *   Check that the server accepted and successfully executed the call.
+ *
+ ****************************************************************************/
+
+static int rpcclnt_accepted(FAR struct rpc_reply_header *replymsg)
+{
+  uint32_t tmp;
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->type);
+  if (tmp != RPC_MSGACCEPTED)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->status);
+  if (tmp == RPC_SUCCESS)
+    {
+      finfo("RPC_SUCCESS\n");
+    }
+  else
+    {
+      ferr("ERROR: Unsupported RPC type: %" PRId32 "\n", tmp);
+      return -EOPNOTSUPP;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -763,8 +796,6 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
                     int version, FAR void *request, size_t reqlen,
                     FAR void *response, size_t resplen)
 {
-  FAR struct rpc_reply_header *replymsg;
-  uint32_t tmp;
   uint32_t xid;
   int retries = 0;
   int error = 0;
@@ -840,24 +871,77 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
 
   /* Break down the RPC header and check if it is OK */
 
-  replymsg = (FAR struct rpc_reply_header *)response;
+  return rpcclnt_accepted((FAR struct rpc_reply_header *)response);
+}
 
-  tmp = fxdr_unsigned(uint32_t, replymsg->type);
-  if (tmp != RPC_MSGACCEPTED)
+/****************************************************************************
+ * Name: rpcclnt_send_call
+ *
+ * Description:
+ *   Format and send one RPC CALL message without waiting for the reply.
+ *   This lets the caller keep several calls in flight and collect the
+ *   replies with rpcclnt_wait_reply().
+ *
+ *   If *xid is zero, a new transaction ID is assigned and returned in it.
+ *   Otherwise the call is a retransmission and reuses that ID, so that the
+ *   server may answer it from its duplicate request cache.
+ *
+ ****************************************************************************/
+
+int rpcclnt_send_call(FAR struct rpcclnt *rpc, int procnum, int prog,
+                      int version, FAR void *request, size_t reqlen,
+                      FAR uint32_t *xid)
+{
+  /* Zero is reserved to mean "no transaction" */
+
+  while (*xid == 0)
     {
-      return -EOPNOTSUPP;
+      *xid = ++rpc->rc_xid;
     }
 
-  tmp = fxdr_unsigned(uint32_t, replymsg->status);
-  if (tmp == RPC_SUCCESS)
+  rpcclnt_fmtheader((FAR struct rpc_call_header *)request,
+                    *xid, prog, version, procnum);
+
+  rpc_statistics(rpcrequests);
+  return rpcclnt_send(rpc, request,
+                      reqlen + sizeof(struct rpc_call_header));
+}
+
+/****************************************************************************
+ * Name: rpcclnt_wait_reply
+ *
+ * Description:
+ *   Receive the next RPC REPLY message, whichever call it answers.  The
+ *   transaction ID of the reply is returned in *xid, also when the server
+ *   rejected the call.
+ *
+ ****************************************************************************/
+
+int rpcclnt_wait_reply(FAR struct rpcclnt *rpc, FAR void *response,
+                       size_t resplen, FAR uint32_t *xid)
+{
+  FAR struct rpc_reply_header *replymsg;
+  int error;
+
+  error = rpcclnt_receive(rpc, response, resplen);
+  if (error != OK)
     {
-      finfo("RPC_SUCCESS\n");
+      if (error == -EAGAIN || error == -ETIMEDOUT)
+        {
+          rpc_statistics(rpctimeouts);
+        }
+
+      return error;
     }
-  else
+
+  replymsg = (FAR struct rpc_reply_header *)response;
+  if (replymsg->rp_direction != rpc_reply)
     {
-      ferr("ERROR: Unsupported RPC type: %" PRId32 "\n", tmp);
-      return -EOPNOTSUPP;
+      ferr("ERROR: Different RPC REPLY returned\n");
+      rpc_statistics(rpcinvalid);
+      return -EPROTO;
     }
 
-  return OK;
+  *xid = fxdr_unsigned(uint32_t, replymsg->rp_xid);
+  return rpcclnt_accepted(replymsg);
 }
@@ -48,6 +48,13 @@
 
  #define ROUND_UP(x, y) (((x) + (y) - 1) / (y) * (y))
 
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+#  define INOTIFY_POOL_NAMELEN \
+     ROUND_UP(CONFIG_FS_NOTIFY_EVENT_NAMELEN, sizeof(struct inotify_event))
+#  define INOTIFY_POOL_EVENTSIZE \
+     (sizeof(struct inotify_event_s) + INOTIFY_POOL_NAMELEN)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -62,6 +69,11 @@ struct inotify_device_s
   uint32_t           event_size;  /* Size of the queue (bytes) */
   uint32_t           event_count; /* Number of pending events */
   FAR struct pollfd *fds[CONFIG_FS_NOTIFY_FD_POLLWAITERS];
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  struct list_node   pool;        /* List of free preallocated events */
+  FAR char          *pool_start;  /* The preallocated events */
+  FAR char          *pool_end;
+#endif
 };
 
 struct inotify_event_s
@@ -93,6 +105,7 @@ struct inotify_global_s
   int      watch_cookie;       /* Watch cookie */
   uint32_t read_count;         /* Number of read events */
   uint32_t write_count;        /* Number of write events */
+  uint32_t generation;         /* Changes when a path may gain a watch */
   struct   hsearch_data hash;  /* Hash table for watch lists */
 };
 
@@ -140,7 +153,8 @@ static struct inode g_inotify_inode =
 
 static struct inotify_global_s g_inotify =
 {
-  .lock = NXMUTEX_INITIALIZER,
+  .lock       = NXMUTEX_INITIALIZER,
+  .generation = 1,
 };
 
 /****************************************************************************
@@ -190,6 +204,24 @@ static int notify_check_mask(uint32_t mask)
           -EBADF : OK;
 }
 
+/****************************************************************************
+ * Name: notify_bump_generation
+ *
+ * Description:
+ *   Forget which open files were found to have no watch on their path.
+ *
+ ****************************************************************************/
+
+static void notify_bump_generation(void)
+{
+  /* Zero means "not looked up yet" in struct file */
+
+  if (++g_inotify.generation == 0)
+    {
+      g_inotify.generation = 1;
+    }
+}
+
 /****************************************************************************
  * Name: inotify_alloc_event
  *
@@ -199,8 +231,8 @@ static int notify_check_mask(uint32_t mask)
  ****************************************************************************/
 
 static FAR struct inotify_event_s *
-inotify_alloc_event(int wd, uint32_t mask, uint32_t cookie,
-                    FAR const char *name)
+inotify_alloc_event(FAR struct inotify_device_s *dev, int wd,
+                    uint32_t mask, uint32_t cookie, FAR const char *name)
 {
   FAR struct inotify_event_s *event;
   size_t len = 0;
@@ -210,10 +242,20 @@ inotify_alloc_event(int wd, uint32_t mask, uint32_t cookie,
       len = ROUND_UP(strlen(name) + 1, sizeof(struct inotify_event));
     }
 
-  event = kmm_malloc(sizeof(struct inotify_event_s) + len);
-  if (event == NULL)
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  if (len <= INOTIFY_POOL_NAMELEN && !list_is_empty(&dev->pool))
     {
-      return NULL;
+      event = list_remove_head_type(&dev->pool, struct inotify_event_s,
+                                    node);
+    }
+  else
+#endif
+    {
+      event = kmm_malloc(sizeof(struct inotify_event_s) + len);
+      if (event == NULL)
+        {
+          return NULL;
+        }
     }
 
   event->event.wd     = wd;
@@ -229,6 +271,71 @@ inotify_alloc_event(int wd, uint32_t mask, uint32_t cookie,
   return event;
 }
 
+/****************************************************************************
+ * Name: inotify_free_event
+ *
+ * Description:
+ *   Return an event to the pool of the device or to the heap.
+ *
+ ****************************************************************************/
+
+static void inotify_free_event(FAR struct inotify_device_s *dev,
+                               FAR struct inotify_event_s *event)
+{
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  if ((FAR char *)event >= dev->pool_start &&
+      (FAR char *)event < dev->pool_end)
+    {
+      list_add_head(&dev->pool, &event->node);
+      return;
+    }
+#endif
+
+  kmm_free(event);
+}
+
+/****************************************************************************
+ * Name: inotify_merge_event
+ *
+ * Description:
+ *   Check if the latest queued event of the same watch and name is
+ *   identical to a new one, and still unread.  Only the last
+ *   CONFIG_FS_NOTIFY_MERGE_DEPTH events are searched.
+ *
+ ****************************************************************************/
+
+static bool inotify_merge_event(FAR struct inotify_device_s *dev, int wd,
+                                uint32_t mask, uint32_t cookie,
+                                FAR const char *name)
+{
+  FAR struct inotify_event_s *last;
+  int depth = 0;
+
+  list_for_every_entry_reverse(&dev->events, last, struct inotify_event_s,
+                               node)
+    {
+      if (depth++ >= CONFIG_FS_NOTIFY_MERGE_DEPTH)
+        {
+          break;
+        }
+
+      if (last->event.wd != wd ||
+          (name == NULL && last->event.len != 0) ||
+          (name != NULL &&
+           (last->event.len == 0 || strcmp(name, last->event.name) != 0)))
+        {
+          continue;
+        }
+
+      /* Moves are paired by their cookie, never merge them */
+
+      return last->event.mask == mask && last->event.cookie == cookie &&
+             cookie == 0;
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: inotify_queue_event
  *
@@ -242,22 +349,13 @@ static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
                                 FAR const char *name)
 {
   FAR struct inotify_event_s *event;
-  FAR struct inotify_event_s *last;
   int semcnt;
 
-  if (!list_is_empty(&dev->events))
-    {
-      /* Drop this event if it is a dupe of the previous */
+  /* Drop this event if it repeats an unread one */
 
-      last = list_last_entry(&dev->events,
-                             struct inotify_event_s, node);
-      if (last->event.mask == mask && last->event.wd == wd &&
-          last->event.cookie == cookie &&
-          ((name == NULL && last->event.len == 0) ||
-           (name && last->event.len && !strcmp(name, last->event.name))))
-        {
-          return;
-        }
+  if (inotify_merge_event(dev, wd, mask, cookie, name))
+    {
+      return;
     }
 
   if (dev->event_count > CONFIG_FS_NOTIFY_MAX_EVENTS)
@@ -268,11 +366,11 @@ static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
 
   if (dev->event_count == CONFIG_FS_NOTIFY_MAX_EVENTS)
     {
-      event = inotify_alloc_event(-1, IN_Q_OVERFLOW, cookie, NULL);
+      event = inotify_alloc_event(dev, -1, IN_Q_OVERFLOW, cookie, NULL);
     }
   else
     {
-      event = inotify_alloc_event(wd, mask, cookie, name);
+      event = inotify_alloc_event(dev, wd, mask, cookie, name);
     }
 
   if (event == NULL)
@@ -347,7 +445,7 @@ static void inotify_remove_event(FAR struct inotify_device_s *dev,
   list_delete(&event->node);
   dev->event_size -= sizeof(struct inotify_event) + event->event.len;
   dev->event_count--;
-  kmm_free(event);
+  inotify_free_event(dev, event);
 }
 
 /****************************************************************************
@@ -361,8 +459,19 @@ static void inotify_remove_event(FAR struct inotify_device_s *dev,
 static FAR struct inotify_device_s *inotify_alloc_device(void)
 {
   FAR struct inotify_device_s *dev;
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  FAR char *event;
+#endif
+
+  /* The preallocated events follow the device structure */
 
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  dev = kmm_zalloc(ROUND_UP(sizeof(struct inotify_device_s),
+                            sizeof(uintptr_t)) +
+                   CONFIG_FS_NOTIFY_EVENT_POOL * INOTIFY_POOL_EVENTSIZE);
+#else
   dev = kmm_zalloc(sizeof(struct inotify_device_s));
+#endif
   if (dev == NULL)
     {
       return dev;
@@ -373,6 +482,23 @@ static FAR struct inotify_device_s *inotify_alloc_device(void)
   nxsem_init(&dev->sem, 0, 0);
   list_initialize(&dev->events);
   list_initialize(&dev->watches);
+
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  list_initialize(&dev->pool);
+  dev->pool_start = (FAR char *)dev +
+                    ROUND_UP(sizeof(struct inotify_device_s),
+                             sizeof(uintptr_t));
+  dev->pool_end   = dev->pool_start +
+                    CONFIG_FS_NOTIFY_EVENT_POOL * INOTIFY_POOL_EVENTSIZE;
+
+  for (event = dev->pool_start; event < dev->pool_end;
+       event += INOTIFY_POOL_EVENTSIZE)
+    {
+      list_add_tail(&dev->pool,
+                    &((FAR struct inotify_event_s *)event)->node);
+    }
+#endif
+
   return dev;
 }
 
@@ -761,6 +887,9 @@ inotify_alloc_watch_list(FAR const char *path)
       return NULL;
     }
 
+  /* Open files may have been found to have no watch on this path */
+
+  notify_bump_generation();
   return list;
 }
 
@@ -839,11 +968,12 @@ inotify_queue_watch_list_event(FAR struct inotify_watch_list_s *list,
  * Name: inotify_queue_parent_event
  *
  * Description:
- *   Queue an event to the inotify inode.
+ *   Queue an event to the inotify inode.  Return true if the parent
+ *   directory is watched.
  *
  ****************************************************************************/
 
-static void inotify_queue_parent_event(FAR char *path, uint32_t mask,
+static bool inotify_queue_parent_event(FAR char *path, uint32_t mask,
                                        uint32_t cookie)
 {
   FAR struct inotify_watch_list_s *list;
@@ -852,43 +982,48 @@ static void inotify_queue_parent_event(FAR char *path, uint32_t mask,
   name = basename(path);
   if (name == NULL || name == path)
     {
-      return;
+      return false;
     }
 
   *(name - 1) = '\0';
   list = inotify_get_watch_list(path);
-  if (list != NULL)
+  if (list == NULL)
     {
-      inotify_queue_watch_list_event(list, mask | IN_ISDIR, cookie, name);
+      return false;
     }
+
+  inotify_queue_watch_list_event(list, mask | IN_ISDIR, cookie, name);
+  return true;
 }
 
 /****************************************************************************
  * Name: notify_queue_path_event
  *
  * Description:
- *   Send the notification by the path.
+ *   Send the notification by the path.  Return true if the path or its
+ *   parent directory is watched.
  *
  ****************************************************************************/
 
-static void notify_queue_path_event(FAR const char *path, uint32_t mask)
+static bool notify_queue_path_event(FAR const char *path, uint32_t mask)
 {
   FAR struct inotify_watch_list_s *list;
   FAR char *abspath;
   FAR char *pathbuffer;
   uint32_t cookie = 0;
+  bool watched;
 
   pathbuffer = lib_get_pathbuffer();
   if (pathbuffer == NULL)
     {
-      return;
+      return true;
     }
 
   abspath = lib_realpath(path, pathbuffer, true);
   if (abspath == NULL)
     {
       lib_put_pathbuffer(pathbuffer);
-      return;
+      return true;
     }
 
   if (mask & IN_MOVE)
@@ -902,11 +1037,11 @@ static void notify_queue_path_event(FAR const char *path, uint32_t mask)
     }
 
   list = inotify_get_watch_list(abspath);
-  inotify_queue_parent_event(abspath, mask, cookie);
+  watched = inotify_queue_parent_event(abspath, mask, cookie);
   lib_put_pathbuffer(pathbuffer);
   if (list == NULL)
     {
-      return;
+      return watched;
     }
 
   if (mask & IN_MOVED_FROM)
@@ -930,6 +1065,8 @@ static void notify_queue_path_event(FAR const char *path, uint32_t mask)
     {
       inotify_queue_watch_list_event(list, mask, cookie, NULL);
     }
+
+  return true;
 }
 
 /****************************************************************************
@@ -977,8 +1114,17 @@ static inline void notify_queue_filep_event(FAR struct file *filep,
       return;
     }
 
+  /* Skip the path lookup if the file was found to be unwatched and no
+   * watch was added since.
+   */
+
   nxmutex_lock(&g_inotify.lock);
   ret = notify_check_mask(mask);
+  if (ret >= 0 && filep->f_notify == g_inotify.generation)
+    {
+      ret = -ENOENT;
+    }
+
   nxmutex_unlock(&g_inotify.lock);
   if (ret < 0)
     {
@@ -1004,7 +1150,11 @@ static inline void notify_queue_filep_event(FAR struct file *filep,
     }
 
   nxmutex_lock(&g_inotify.lock);
-  notify_queue_path_event(pathbuffer, mask);
+  if (!notify_queue_path_event(pathbuffer, mask))
+    {
+      filep->f_notify = g_inotify.generation;
+    }
+
   lib_put_pathbuffer(pathbuffer);
   nxmutex_unlock(&g_inotify.lock);
 }
@@ -1507,5 +1657,9 @@ void notify_rename(FAR const char *oldpath, bool oldisdir,
   nxmutex_lock(&g_inotify.lock);
   notify_queue_path_event(oldpath, oldmask);
   notify_queue_path_event(newpath, newmask);
+
+  /* The open files below the new path may now be watched */
+
+  notify_bump_generation();
   nxmutex_unlock(&g_inotify.lock);
 }
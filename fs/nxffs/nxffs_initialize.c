@@ -537,6 +537,13 @@ int nxffs_bind(FAR struct inode *blkdriver, FAR const void *data,
 
   DEBUGASSERT(g_volume.cache);
   *handle = &g_volume;
+
+#ifdef CONFIG_NXFFS_BGPACK
+  /* Files deleted before the volume was mounted are not known yet */
+
+  g_volume.bgneeded = true;
+  nxffs_bgpack(&g_volume);
+#endif
 #endif
   return OK;
 }
@@ -564,6 +571,14 @@ int nxffs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return -ENOSYS;
     }
 
-  return g_volume.ofiles ? -EBUSY : OK;
+  if (g_volume.ofiles)
+    {
+      return -EBUSY;
+    }
+
+#ifdef CONFIG_NXFFS_BGPACK
+  work_cancel_sync(LPWORK, &g_volume.bgwork);
+#endif
+  return OK;
 #endif
 }
@@ -30,6 +30,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/crc32.h>
 #include <nuttx/kmalloc.h>
 
@@ -177,6 +178,10 @@ static inline bool nxffs_packvalid(FAR struct nxffs_pack_s *pack)
  *   if there are no valid blocks or if there are no valid inode headers
  *   after the first valid block.
  *
+ *   If the beginning of the volume is known to be packed already, the
+ *   offset to the end of the packed region is returned instead.  In that
+ *   case pack->src.entry.name is NULL if no valid inode header follows.
+ *
  ****************************************************************************/
 
 static inline off_t nxffs_mediacheck(FAR struct nxffs_volume_s *volume,
@@ -207,6 +212,17 @@ static inline off_t nxffs_mediacheck(FAR struct nxffs_volume_s *volume,
   volume->iooffset = SIZEOF_NXFFS_BLOCK_HDR;
   froffset         = nxffs_iotell(volume);
 
+  /* Nothing below volume->pkoffset was deleted since the last time that the
+   * volume was packed.  There is no need to read those inode headers again.
+   */
+
+  if (volume->pkoffset > froffset)
+    {
+      froffset = volume->pkoffset;
+      nxffs_nextentry(volume, froffset, &pack->src.entry);
+      return froffset;
+    }
+
   /* Get the offset to the first valid inode entry after this free offset */
 
   ret = nxffs_nextentry(volume, froffset, &pack->src.entry);
@@ -1243,6 +1259,56 @@ static inline int nxffs_packwriter(FAR struct nxffs_volume_s *volume,
   return -ENOSYS;
 }
 
+/****************************************************************************
+ * Name: nxffs_bgworker
+ *
+ * Description:
+ *   Pack the volume if it is idle and running out of free FLASH, then check
+ *   again later.
+ *
+ *   Packing cannot be stopped part way, the inodes not yet moved would then
+ *   be found twice.  So the whole volume is packed at once, but only when
+ *   no file is open and before the free FLASH runs out.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+static void nxffs_bgworker(FAR void *arg)
+{
+  FAR struct nxffs_volume_s *volume = arg;
+  off_t avail;
+  int ret;
+
+  /* Don't wait for the volume, it is not idle if somebody holds it */
+
+  if (nxmutex_trylock(&volume->lock) >= 0)
+    {
+      avail = (off_t)volume->nblocks * volume->geo.blocksize -
+              volume->froffset;
+
+      if (volume->ofiles == NULL && volume->bgneeded &&
+          avail < (off_t)CONFIG_NXFFS_BGPACK_RESERVE * volume->geo.erasesize)
+        {
+          /* Don't try again until more files are deleted */
+
+          volume->bgneeded = false;
+
+          finfo("Packing, %jd bytes free\n", (intmax_t)avail);
+          ret = nxffs_pack(volume);
+          if (ret < 0)
+            {
+              ferr("ERROR: Failed to pack the volume: %d\n", -ret);
+            }
+        }
+
+      nxmutex_unlock(&volume->lock);
+    }
+
+  work_queue(LPWORK, &volume->bgwork, nxffs_bgworker, volume,
+             MSEC2TICK(CONFIG_NXFFS_BGPACK_INTERVAL));
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1335,10 +1401,19 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
     }
 
   /* There is a valid format and valid inodes on the media.. setup up to
-   * begin the packing operation.
+   * begin the packing operation.  If there are no valid inodes after the
+   * packed region, then only the end of FLASH can be recovered.
    */
 
-  ret = nxffs_startpos(volume, &pack, &iooffset);
+  if (pack.src.entry.name == NULL)
+    {
+      ret = -ENOSPC;
+    }
+  else
+    {
+      ret = nxffs_startpos(volume, &pack, &iooffset);
+    }
+
   if (ret < 0)
     {
       /* This is a normal situation if the volume is full */
@@ -1605,8 +1680,46 @@ start_pack:
         }
     }
 
+  /* All valid inodes now precede the free FLASH offset.  The data of a
+   * file being written may have been moved there too, so don't trust the
+   * free offset in that case.
+   */
+
+  volume->pkoffset = nxffs_findwriter(volume) ? 0 : volume->froffset;
+#ifdef CONFIG_NXFFS_BGPACK
+  volume->bgneeded = false;
+#endif
+
 errout_with_pack:
+  if (ret < 0)
+    {
+      volume->pkoffset = 0;
+    }
+
   nxffs_freeentry(&pack.src.entry);
   nxffs_freeentry(&pack.dest.entry);
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxffs_bgpack
+ *
+ * Description:
+ *   Start packing the volume in the background while it is idle.  See
+ *   CONFIG_NXFFS_BGPACK.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+void nxffs_bgpack(FAR struct nxffs_volume_s *volume)
+{
+  work_queue(LPWORK, &volume->bgwork, nxffs_bgworker, volume,
+             MSEC2TICK(CONFIG_NXFFS_BGPACK_INTERVAL));
+}
+#endif
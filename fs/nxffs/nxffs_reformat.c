@@ -279,6 +279,13 @@ int nxffs_reformat(FAR struct nxffs_volume_s *volume)
       return ret;
     }
 
+  /* There is nothing left to pack */
+
+  volume->pkoffset = 0;
+#ifdef CONFIG_NXFFS_BGPACK
+  volume->bgneeded = false;
+#endif
+
   /* Check for bad blocks */
 
   ret = nxffs_badblocks(volume);
@@ -112,8 +112,20 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name)
     {
       ferr("ERROR: Failed to write block %jd: %d\n",
            (intmax_t)volume->ioblock, ret);
+      goto errout_with_entry;
+    }
+
+  /* The volume is no longer packed beyond the deleted inode */
+
+  if (entry.hoffset < volume->pkoffset)
+    {
+      volume->pkoffset = entry.hoffset;
     }
 
+#ifdef CONFIG_NXFFS_BGPACK
+  volume->bgneeded = true;
+#endif
+
 errout_with_entry:
   nxffs_freeentry(&entry);
 errout:
@@ -54,7 +54,7 @@
  * to handle the longest line generated by this logic.
  */
 
-#define CRITMON_LINELEN 64
+#define CRITMON_LINELEN 96
 
 /****************************************************************************
  * Private Types
@@ -282,6 +282,84 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: critmon_read_top
+ *
+ * Description:
+ *   Generate one line per recorded interval of a top table:
+ *   <name>,<pid>,<cpu>,<time>,<entry>,<exit>[,<backtrace>...]
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_TOPN > 0
+static ssize_t critmon_read_top(FAR struct critmon_file_s *attr,
+                                FAR char *buffer, size_t buflen,
+                                FAR off_t *offset, FAR const char *name,
+                                FAR const struct critmon_top_s *table)
+{
+  FAR const struct critmon_top_s *top;
+  struct timespec elapsed;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize = 0;
+  int i;
+#if CONFIG_SCHED_CRITMONITOR_TOPN_BACKTRACE > 0
+  int j;
+#endif
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_TOPN && buflen > 0; i++)
+    {
+      top = &table[i];
+      if (top->elapsed == 0)
+        {
+          continue;
+        }
+
+      perf_convert(top->elapsed, &elapsed);
+      linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                                 "%s,%d,%d,%lu.%09lu,%p,%p", name,
+                                 (int)top->pid, top->cpu,
+                                 (unsigned long)elapsed.tv_sec,
+                                 (unsigned long)elapsed.tv_nsec,
+                                 top->entry, top->exit);
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+
+#if CONFIG_SCHED_CRITMONITOR_TOPN_BACKTRACE > 0
+      for (j = 0; j < CONFIG_SCHED_CRITMONITOR_TOPN_BACKTRACE &&
+                  top->backtrace[j] != NULL && buflen > 0; j++)
+        {
+          linesize = procfs_snprintf(attr->line, CRITMON_LINELEN, ",%p",
+                                     top->backtrace[j]);
+          copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                                   offset);
+
+          totalsize += copysize;
+          buffer    += copysize;
+          buflen    -= copysize;
+        }
+#endif
+
+      if (buflen > 0)
+        {
+          linesize = procfs_snprintf(attr->line, CRITMON_LINELEN, "\n");
+          copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                                   offset);
+
+          totalsize += copysize;
+          buffer    += copysize;
+          buflen    -= copysize;
+        }
+    }
+
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_read
  ****************************************************************************/
@@ -318,6 +396,26 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#if CONFIG_SCHED_CRITMONITOR_TOPN > 0
+  /* Then the longest intervals recorded */
+
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
+  if (ret < buflen)
+    {
+      ret += critmon_read_top(attr, buffer + ret, buflen - ret, &offset,
+                              "preemption", g_premp_top);
+    }
+#  endif
+
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
+  if (ret < buflen)
+    {
+      ret += critmon_read_top(attr, buffer + ret, buflen - ret, &offset,
+                              "csection", g_crit_top);
+    }
+#  endif
+#endif
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -0,0 +1,729 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsfsbench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <debug.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FSBENCH_NPERCENTILES  3
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum fsbench_op_e
+{
+  FSBENCH_READ = 0,
+  FSBENCH_WRITE,
+  FSBENCH_FSYNC,
+  FSBENCH_CREATE,
+  FSBENCH_STAT,
+  FSBENCH_UNLINK,
+  FSBENCH_NOPS
+};
+
+struct fsbench_s;
+
+struct fsbench_workload_s
+{
+  FAR const char *name;
+  bool random;                      /* Random instead of sequential offsets */
+  bool sync;                        /* fsync() after each write */
+  uint8_t readpct;                  /* Percentage of reads */
+  CODE int (*run)(FAR struct fsbench_s *bench,
+                  FAR const struct fsbench_workload_s *workload);
+};
+
+/* The statistics of one operation.  The latency of each call is kept
+ * while running, for the percentiles.
+ */
+
+struct fsbench_result_s
+{
+  size_t count;
+  uint64_t bytes;
+  clock_t total;
+  FAR clock_t *latency;
+  clock_t percentile[FSBENCH_NPERCENTILES];
+};
+
+struct fsbench_s
+{
+  mutex_t lock;                     /* One run or read at a time */
+  FAR const struct fsbench_workload_s *workload;
+  char path[PATH_MAX];
+  size_t bsize;                     /* Bytes per read or write */
+  size_t count;                     /* Number of operations */
+  off_t fsize;                      /* Span of the offsets */
+  uint32_t seed;
+  FAR uint8_t *buffer;
+  int error;                        /* Error of the last run */
+  struct fsbench_result_s result[FSBENCH_NOPS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     fsbench_io(FAR struct fsbench_s *bench,
+                          FAR const struct fsbench_workload_s *workload);
+static int     fsbench_meta(FAR struct fsbench_s *bench,
+                            FAR const struct fsbench_workload_s *workload);
+
+static int     fsbench_open(FAR struct file *filep, FAR const char *relpath,
+                            int oflags, mode_t mode);
+static int     fsbench_close(FAR struct file *filep);
+static ssize_t fsbench_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static ssize_t fsbench_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen);
+static int     fsbench_dup(FAR const struct file *oldp,
+                           FAR struct file *newp);
+static int     fsbench_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct fsbench_workload_s g_fsbench_workloads[] =
+{
+  { "seqwrite",  false, false, 0,   fsbench_io   },
+  { "seqread",   false, false, 100, fsbench_io   },
+  { "randwrite", true,  false, 0,   fsbench_io   },
+  { "randread",  true,  false, 100, fsbench_io   },
+  { "mixed",     true,  false, 70,  fsbench_io   },
+  { "fsync",     false, true,  0,   fsbench_io   },
+  { "meta",      false, false, 0,   fsbench_meta },
+};
+
+static FAR const char * const g_fsbench_ops[FSBENCH_NOPS] =
+{
+  "read", "write", "fsync", "create", "stat", "unlink"
+};
+
+/* Percentiles in per mille */
+
+static const uint16_t g_fsbench_permille[FSBENCH_NPERCENTILES] =
+{
+  500, 990, 999
+};
+
+static struct fsbench_s g_fsbench =
+{
+  NXMUTEX_INITIALIZER
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct procfs_operations g_fsbench_operations =
+{
+  fsbench_open,   /* open */
+  fsbench_close,  /* close */
+  fsbench_read,   /* read */
+  fsbench_write,  /* write */
+  NULL,           /* poll */
+
+  fsbench_dup,    /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  fsbench_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fsbench_random
+ *
+ * Description:
+ *   xorshift32, seeded the same for every run so that runs compare.
+ *
+ ****************************************************************************/
+
+static uint32_t fsbench_random(FAR struct fsbench_s *bench)
+{
+  uint32_t x = bench->seed;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  bench->seed = x;
+  return x;
+}
+
+/****************************************************************************
+ * Name: fsbench_us
+ ****************************************************************************/
+
+static uint64_t fsbench_us(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: fsbench_add
+ *
+ * Description:
+ *   Account one call of an operation that started at 'start'.
+ *
+ ****************************************************************************/
+
+static void fsbench_add(FAR struct fsbench_s *bench, int op, clock_t start,
+                        ssize_t nbytes)
+{
+  FAR struct fsbench_result_s *result = &bench->result[op];
+  clock_t elapsed = perf_gettime() - start;
+
+  if (nbytes < 0)
+    {
+      return;
+    }
+
+  if (result->latency == NULL)
+    {
+      result->latency = kmm_malloc(bench->count * sizeof(clock_t));
+    }
+
+  if (result->latency != NULL && result->count < bench->count)
+    {
+      result->latency[result->count] = elapsed;
+    }
+
+  result->count++;
+  result->bytes += nbytes;
+  result->total += elapsed;
+}
+
+/****************************************************************************
+ * Name: fsbench_compare
+ ****************************************************************************/
+
+static int fsbench_compare(FAR const void *a, FAR const void *b)
+{
+  clock_t x = *(FAR const clock_t *)a;
+  clock_t y = *(FAR const clock_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+/****************************************************************************
+ * Name: fsbench_finish
+ *
+ * Description:
+ *   Reduce the latencies of the run to the percentiles and free them.
+ *
+ ****************************************************************************/
+
+static void fsbench_finish(FAR struct fsbench_s *bench)
+{
+  FAR struct fsbench_result_s *result;
+  size_t nsamples;
+  int op;
+  int i;
+
+  for (op = 0; op < FSBENCH_NOPS; op++)
+    {
+      result = &bench->result[op];
+      if (result->latency == NULL)
+        {
+          continue;
+        }
+
+      nsamples = MIN(result->count, bench->count);
+      if (nsamples > 0)
+        {
+          qsort(result->latency, nsamples, sizeof(clock_t),
+                fsbench_compare);
+
+          for (i = 0; i < FSBENCH_NPERCENTILES; i++)
+            {
+              result->percentile[i] =
+                result->latency[(nsamples - 1) * g_fsbench_permille[i] /
+                                1000];
+            }
+        }
+
+      kmm_free(result->latency);
+      result->latency = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: fsbench_fill
+ *
+ * Description:
+ *   Write the part of the file that is missing before a read workload.
+ *   This is not measured.
+ *
+ ****************************************************************************/
+
+static int fsbench_fill(FAR struct fsbench_s *bench, FAR struct file *filep,
+                        off_t size)
+{
+  off_t offset;
+  ssize_t ret;
+
+  offset = file_seek(filep, size - size % bench->bsize, SEEK_SET);
+  if (offset < 0)
+    {
+      return offset;
+    }
+
+  for (; offset < bench->fsize; offset += ret)
+    {
+      ret = file_write(filep, bench->buffer, bench->bsize);
+      if (ret <= 0)
+        {
+          return ret < 0 ? ret : -ENOSPC;
+        }
+    }
+
+  return file_fsync(filep);
+}
+
+/****************************************************************************
+ * Name: fsbench_io
+ *
+ * Description:
+ *   Run a data workload on a file, or on a block or MTD device which the
+ *   VFS opens through the BCH and FTL layers.
+ *
+ ****************************************************************************/
+
+static int fsbench_io(FAR struct fsbench_s *bench,
+                      FAR const struct fsbench_workload_s *workload)
+{
+  off_t nblocks = bench->fsize / bench->bsize;
+  struct file file;
+  struct stat st;
+  clock_t start;
+  off_t offset;
+  ssize_t ret;
+  bool device;
+  bool isread;
+  size_t i;
+
+  ret    = nx_stat(bench->path, &st, 1);
+  device = ret >= 0 && (S_ISBLK(st.st_mode) || S_ISMTD(st.st_mode));
+  if (ret < 0)
+    {
+      st.st_size = 0;
+    }
+
+  ret = file_open(&file, bench->path, device ? O_RDWR : O_RDWR | O_CREAT,
+                  0666);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (workload->readpct > 0 && !device && st.st_size < bench->fsize)
+    {
+      ret = fsbench_fill(bench, &file, st.st_size);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  for (i = 0; i < bench->count; i++)
+    {
+      if (workload->random)
+        {
+          offset = fsbench_random(bench) % nblocks * bench->bsize;
+        }
+      else
+        {
+          offset = i % nblocks * bench->bsize;
+        }
+
+      isread = workload->readpct > fsbench_random(bench) % 100;
+      start  = perf_gettime();
+      ret    = file_seek(&file, offset, SEEK_SET);
+      if (ret >= 0)
+        {
+          ret = isread ? file_read(&file, bench->buffer, bench->bsize) :
+                         file_write(&file, bench->buffer, bench->bsize);
+        }
+
+      fsbench_add(bench, isread ? FSBENCH_READ : FSBENCH_WRITE, start, ret);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      if (workload->sync)
+        {
+          start = perf_gettime();
+          ret   = file_fsync(&file);
+          fsbench_add(bench, FSBENCH_FSYNC, start, ret < 0 ? ret : 0);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+    }
+
+out:
+  file_close(&file);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_meta
+ *
+ * Description:
+ *   Create, stat and unlink 'count' empty files in the directory.
+ *
+ ****************************************************************************/
+
+static int fsbench_meta(FAR struct fsbench_s *bench,
+                        FAR const struct fsbench_workload_s *workload)
+{
+  FAR char *name = (FAR char *)bench->buffer;
+  struct file file;
+  struct stat st;
+  clock_t start;
+  size_t i;
+  int ret = OK;
+
+  for (i = 0; i < bench->count && ret >= 0; i++)
+    {
+      snprintf(name, bench->bsize, "%s/fsbench%zu", bench->path, i);
+      start = perf_gettime();
+      ret   = file_open(&file, name, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+      if (ret >= 0)
+        {
+          ret = file_close(&file);
+        }
+
+      fsbench_add(bench, FSBENCH_CREATE, start, 0);
+    }
+
+  for (i = 0; i < bench->count && ret >= 0; i++)
+    {
+      snprintf(name, bench->bsize, "%s/fsbench%zu", bench->path, i);
+      start = perf_gettime();
+      ret   = nx_stat(name, &st, 1);
+      fsbench_add(bench, FSBENCH_STAT, start, ret);
+    }
+
+  /* Remove whatever was created, also after an error */
+
+  for (i = 0; i < bench->count; i++)
+    {
+      snprintf(name, bench->bsize, "%s/fsbench%zu", bench->path, i);
+      start = perf_gettime();
+      if (nx_unlink(name) < 0)
+        {
+          break;
+        }
+
+      fsbench_add(bench, FSBENCH_UNLINK, start, 0);
+    }
+
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_parse
+ *
+ * Description:
+ *   Parse "<workload> <path> [bsize [count [fsize]]]".
+ *
+ ****************************************************************************/
+
+static int fsbench_parse(FAR struct fsbench_s *bench, FAR char *cmd)
+{
+  FAR char *token[5] =
+    {
+      NULL
+    };
+
+  FAR char *save;
+  int i;
+
+  for (i = 0; i < 5; i++)
+    {
+      token[i] = strtok_r(i == 0 ? cmd : NULL, " \t\n", &save);
+      if (token[i] == NULL)
+        {
+          break;
+        }
+    }
+
+  if (i < 2 || strlen(token[1]) >= PATH_MAX)
+    {
+      return -EINVAL;
+    }
+
+  bench->workload = NULL;
+  for (i = 0; i < nitems(g_fsbench_workloads); i++)
+    {
+      if (strcmp(token[0], g_fsbench_workloads[i].name) == 0)
+        {
+          bench->workload = &g_fsbench_workloads[i];
+        }
+    }
+
+  if (bench->workload == NULL)
+    {
+      return -EINVAL;
+    }
+
+  strlcpy(bench->path, token[1], sizeof(bench->path));
+  bench->bsize = token[2] ? strtoul(token[2], NULL, 0) :
+                            CONFIG_FS_PROCFS_FSBENCH_BSIZE;
+  bench->count = token[3] ? strtoul(token[3], NULL, 0) :
+                            CONFIG_FS_PROCFS_FSBENCH_COUNT;
+  bench->fsize = token[4] ? strtoul(token[4], NULL, 0) :
+                            bench->bsize * bench->count;
+
+  /* The metadata workload builds the file names in the buffer */
+
+  if (bench->workload->run == fsbench_meta)
+    {
+      bench->bsize = MAX(bench->bsize, PATH_MAX);
+    }
+
+  if (bench->bsize == 0 || bench->count == 0 ||
+      bench->fsize < bench->bsize)
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_open
+ ****************************************************************************/
+
+static int fsbench_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct procfs_file_s *priv;
+
+  priv = kmm_zalloc(sizeof(struct procfs_file_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_close
+ ****************************************************************************/
+
+static int fsbench_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_read
+ *
+ * Description:
+ *   Report the last run as CSV, one line per operation that was made.
+ *
+ ****************************************************************************/
+
+static ssize_t fsbench_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct fsbench_s *bench = &g_fsbench;
+  FAR struct fsbench_result_s *result;
+  off_t offset = filep->f_pos;
+  uint64_t usec;
+  int ret;
+  int op;
+
+  ret = nxmutex_lock(&bench->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  procfs_sprintf(buffer, buflen, &offset,
+                 "workload,path,bsize,op,count,bytes,usec,kib_s,iops,"
+                 "p50_us,p99_us,p999_us,error\n");
+
+  for (op = 0; bench->workload != NULL && op < FSBENCH_NOPS; op++)
+    {
+      result = &bench->result[op];
+      if (result->count == 0)
+        {
+          continue;
+        }
+
+      usec = MAX(fsbench_us(result->total), 1);
+      procfs_sprintf(buffer, buflen, &offset,
+                     "%s,%s,%zu,%s,%zu,%" PRIu64 ",%" PRIu64 ",%" PRIu64
+                     ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+                     ",%d\n", bench->workload->name, bench->path,
+                     bench->bsize, g_fsbench_ops[op], result->count,
+                     result->bytes, usec,
+                     result->bytes * USEC_PER_SEC / 1024 / usec,
+                     (uint64_t)result->count * USEC_PER_SEC / usec,
+                     fsbench_us(result->percentile[0]),
+                     fsbench_us(result->percentile[1]),
+                     fsbench_us(result->percentile[2]),
+                     bench->error);
+    }
+
+  nxmutex_unlock(&bench->lock);
+
+  if (offset >= 0)
+    {
+      return 0;
+    }
+
+  filep->f_pos += -offset;
+  return -offset;
+}
+
+/****************************************************************************
+ * Name: fsbench_write
+ *
+ * Description:
+ *   Run the workload that is written, in the context of the writer.
+ *
+ ****************************************************************************/
+
+static ssize_t fsbench_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  FAR struct fsbench_s *bench = &g_fsbench;
+  FAR char *cmd;
+  int ret;
+
+  cmd = kmm_malloc(buflen + 1);
+  if (cmd == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(cmd, buffer, buflen);
+  cmd[buflen] = '\0';
+
+  ret = nxmutex_lock(&bench->lock);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  memset(bench->result, 0, sizeof(bench->result));
+  ret = fsbench_parse(bench, cmd);
+  if (ret < 0)
+    {
+      bench->workload = NULL;
+      goto errout_with_lock;
+    }
+
+  bench->buffer = kmm_malloc(bench->bsize);
+  if (bench->buffer == NULL)
+    {
+      bench->workload = NULL;
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+
+  memset(bench->buffer, 0x5a, bench->bsize);
+  bench->seed  = 0x12345678;
+  bench->error = bench->workload->run(bench, bench->workload);
+  fsbench_finish(bench);
+
+  kmm_free(bench->buffer);
+  bench->buffer = NULL;
+  ret = buflen;
+
+errout_with_lock:
+  nxmutex_unlock(&bench->lock);
+errout:
+  kmm_free(cmd);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fsbench_dup
+ ****************************************************************************/
+
+static int fsbench_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct procfs_file_s *priv;
+
+  priv = kmm_malloc(sizeof(struct procfs_file_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(priv, oldp->f_priv, sizeof(struct procfs_file_s));
+  newp->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_stat
+ ****************************************************************************/
+
+static int fsbench_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
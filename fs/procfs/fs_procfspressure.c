@@ -24,11 +24,14 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <poll.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <sys/stat.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
@@ -36,10 +39,41 @@
 #include <nuttx/queue.h>
 #include <nuttx/spinlock.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+#  define PRESSURE_NFILES     (1 + PRESSURE_NSTALLS)
+#else
+#  define PRESSURE_NFILES     1
+#endif
+
+/* The running averages of the stall percentage are updated every two
+ * seconds, with the decay factors of Linux for 10s, 60s and 300s in
+ * fixed point.
+ */
+
+#define PRESSURE_AVG_PERIOD   (2 * TICK_PER_SEC)
+#define PRESSURE_FIXED_1      2048
+#define PRESSURE_NAVGS        3
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+struct pressure_stall_s
+{
+  dq_queue_t queue;                 /* Files opened on the resource */
+  unsigned int nstalled;            /* Number of tasks waiting */
+  clock_t start;                    /* Start of the current stall */
+  clock_t total;                    /* Stall time before the current stall */
+  clock_t avgtotal;                 /* Stall time at the last average */
+  uint32_t avg[PRESSURE_NAVGS];     /* Averages, percent in fixed point */
+};
+#endif
+
 struct pressure_file_s
 {
   struct procfs_file_s base;        /* Base open file structure */
@@ -48,6 +82,14 @@ struct pressure_file_s
   size_t threshold;                 /* Memory notification threshold */
   clock_t lasttick;                 /* Last time notified */
   clock_t interval;                 /* Notification interval in us */
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+
+  /* The resource of a stall file, NULL for the memory file */
+
+  FAR struct pressure_stall_s *stall;
+  clock_t winstall;                 /* Stall time at the window start */
+  bool notified;                    /* Notified in the current window */
+#endif
 };
 
 /****************************************************************************
@@ -59,6 +101,28 @@ static spinlock_t g_pressure_lock;
 static size_t g_remaining;
 static size_t g_largest;
 
+/* The files of the directory, memory first then in PRESSURE_* order */
+
+static FAR const char * const g_pressure_names[PRESSURE_NFILES] =
+{
+  "memory"
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+  , "cpu"
+  , "io"
+  , "net"
+#endif
+};
+
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+static struct pressure_stall_s g_pressure_stall[PRESSURE_NSTALLS];
+static clock_t g_pressure_avgtick;
+
+static const uint32_t g_pressure_exp[PRESSURE_NAVGS] =
+{
+  1677, 1981, 2034                  /* exp(-2/10), exp(-2/60), exp(-2/300) */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -105,6 +169,256 @@ const struct procfs_operations g_pressure_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: pressure_find
+ *
+ * Description:
+ *   Return the index of the file 'relpath' in g_pressure_names, or a
+ *   negated errno value.
+ *
+ ****************************************************************************/
+
+static int pressure_find(FAR const char *relpath)
+{
+  int i;
+
+  if (strncmp(relpath, "pressure/", 9) == 0)
+    {
+      for (i = 0; i < PRESSURE_NFILES; i++)
+        {
+          if (strcmp(relpath + 9, g_pressure_names[i]) == 0)
+            {
+              return i;
+            }
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: pressure_queue
+ *
+ * Description:
+ *   Return the list of the files opened on the same resource as 'priv'.
+ *
+ ****************************************************************************/
+
+static FAR dq_queue_t *pressure_queue(FAR struct pressure_file_s *priv)
+{
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+  if (priv->stall != NULL)
+    {
+      return &priv->stall->queue;
+    }
+#endif
+
+  return &g_pressure_memory_queue;
+}
+
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+/****************************************************************************
+ * Name: pressure_stall_time
+ *
+ * Description:
+ *   Return the total stall time of a resource in clock ticks, including
+ *   the stall in progress.
+ *
+ ****************************************************************************/
+
+static clock_t pressure_stall_time(FAR struct pressure_stall_s *stall,
+                                   clock_t current)
+{
+  clock_t total = stall->total;
+
+  if (stall->nstalled > 0)
+    {
+      total += current - stall->start;
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: pressure_stall_trigger
+ *
+ * Description:
+ *   Start a new window of the trigger of 'priv' if the current one ended,
+ *   and return true if the trigger fires: the stall time in the window
+ *   exceeds the threshold for the first time and a thread polls the file.
+ *
+ ****************************************************************************/
+
+static bool pressure_stall_trigger(FAR struct pressure_file_s *priv,
+                                   clock_t current)
+{
+  clock_t total = pressure_stall_time(priv->stall, current);
+
+  if (priv->threshold == 0)
+    {
+      return false;
+    }
+
+  if (current - priv->lasttick >= priv->interval)
+    {
+      priv->lasttick = current;
+      priv->winstall = total;
+      priv->notified = false;
+    }
+
+  if (priv->notified || priv->fds == NULL ||
+      total - priv->winstall < priv->threshold)
+    {
+      return false;
+    }
+
+  priv->notified = true;
+  return true;
+}
+
+/****************************************************************************
+ * Name: pressure_stall_notify
+ *
+ * Description:
+ *   Fire the triggers of a resource.  Called and returns with
+ *   g_pressure_lock held, which is released while notifying.
+ *
+ ****************************************************************************/
+
+static irqstate_t pressure_stall_notify(FAR struct pressure_stall_s *stall,
+                                        clock_t current, irqstate_t flags)
+{
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *tmp;
+
+  dq_for_every_safe(&stall->queue, entry, tmp)
+    {
+      FAR struct pressure_file_s *pressure =
+          container_of(entry, struct pressure_file_s, entry);
+
+      if (pressure_stall_trigger(pressure, current))
+        {
+          spin_unlock_irqrestore(&g_pressure_lock, flags);
+          poll_notify(&pressure->fds, 1, POLLPRI);
+          flags = spin_lock_irqsave(&g_pressure_lock);
+        }
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: pressure_stall_average
+ *
+ * Description:
+ *   Fold the stall time of the last period into the running averages of a
+ *   resource.
+ *
+ ****************************************************************************/
+
+static void pressure_stall_average(FAR struct pressure_stall_s *stall,
+                                   clock_t current, clock_t period)
+{
+  clock_t total = pressure_stall_time(stall, current);
+  uint32_t pct;
+  int i;
+
+  pct = (uint64_t)(total - stall->avgtotal) * 100 * PRESSURE_FIXED_1 /
+        period;
+  if (pct > 100 * PRESSURE_FIXED_1)
+    {
+      pct = 100 * PRESSURE_FIXED_1;
+    }
+
+  stall->avgtotal = total;
+
+  for (i = 0; i < PRESSURE_NAVGS; i++)
+    {
+      stall->avg[i] = (stall->avg[i] * g_pressure_exp[i] +
+                       pct * (PRESSURE_FIXED_1 - g_pressure_exp[i])) /
+                      PRESSURE_FIXED_1;
+    }
+}
+
+/****************************************************************************
+ * Name: pressure_stall_read
+ *
+ * Description:
+ *   Format the pressure of a resource like Linux does.
+ *
+ ****************************************************************************/
+
+static ssize_t pressure_stall_read(FAR struct pressure_stall_s *stall,
+                                   FAR char *buf, size_t buflen)
+{
+  uint32_t avg[PRESSURE_NAVGS];
+  irqstate_t flags;
+  clock_t total;
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+  total = pressure_stall_time(stall, clock_systime_ticks());
+  memcpy(avg, stall->avg, sizeof(avg));
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+
+  return procfs_snprintf(buf, buflen,
+                         "some avg10=%" PRIu32 ".%02" PRIu32
+                         " avg60=%" PRIu32 ".%02" PRIu32
+                         " avg300=%" PRIu32 ".%02" PRIu32
+                         " total=%" PRIu64 "\n",
+                         avg[0] / PRESSURE_FIXED_1,
+                         avg[0] % PRESSURE_FIXED_1 * 100 / PRESSURE_FIXED_1,
+                         avg[1] / PRESSURE_FIXED_1,
+                         avg[1] % PRESSURE_FIXED_1 * 100 / PRESSURE_FIXED_1,
+                         avg[2] / PRESSURE_FIXED_1,
+                         avg[2] % PRESSURE_FIXED_1 * 100 / PRESSURE_FIXED_1,
+                         (uint64_t)TICK2USEC(total));
+}
+
+/****************************************************************************
+ * Name: pressure_stall_write
+ *
+ * Description:
+ *   Arm the trigger of a resource with "<stall us> <window us>".
+ *
+ ****************************************************************************/
+
+static ssize_t pressure_stall_write(FAR struct pressure_file_s *priv,
+                                    FAR const char *buffer, size_t buflen)
+{
+  FAR char *endptr;
+  unsigned long threshold;
+  unsigned long window;
+  irqstate_t flags;
+  clock_t current;
+
+  /* Accept the "some <stall us> <window us>" format of Linux too */
+
+  if (strncmp(buffer, "some ", 5) == 0)
+    {
+      buffer += 5;
+    }
+
+  threshold = strtoul(buffer, &endptr, 0);
+  window    = strtoul(endptr, NULL, 0);
+  if (threshold == 0 || window == 0 || threshold > window)
+    {
+      return -EINVAL;
+    }
+
+  flags   = spin_lock_irqsave(&g_pressure_lock);
+  current = clock_systime_ticks();
+
+  priv->threshold = USEC2TICK(threshold) > 0 ? USEC2TICK(threshold) : 1;
+  priv->interval  = USEC2TICK(window) > 0 ? USEC2TICK(window) : 1;
+  priv->lasttick  = current;
+  priv->winstall  = pressure_stall_time(priv->stall, current);
+  priv->notified  = false;
+
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+  return buflen;
+}
+#endif /* CONFIG_FS_PROCFS_PRESSURE_STALL */
+
 /****************************************************************************
  * Name: pressure_open
  ****************************************************************************/
@@ -114,11 +428,13 @@ static int pressure_open(FAR struct file *filep, FAR const char *relpath,
 {
   FAR struct pressure_file_s *priv;
   uint32_t flags;
+  int index;
 
-  if (strcmp(relpath, "pressure/memory") != 0)
+  index = pressure_find(relpath);
+  if (index < 0)
     {
       ferr("ERROR: relpath is invalid: %s\n", relpath);
-      return -ENOENT;
+      return index;
     }
 
   priv = kmm_zalloc(sizeof(struct pressure_file_s));
@@ -127,10 +443,17 @@ static int pressure_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+  if (index > 0)
+    {
+      priv->stall = &g_pressure_stall[index - 1];
+    }
+#endif
+
   flags = spin_lock_irqsave(&g_pressure_lock);
   priv->interval = CLOCK_MAX;
   filep->f_priv = priv;
-  dq_addfirst(&priv->entry, &g_pressure_memory_queue);
+  dq_addfirst(&priv->entry, pressure_queue(priv));
   spin_unlock_irqrestore(&g_pressure_lock, flags);
   return OK;
 }
@@ -145,7 +468,7 @@ static int pressure_close(FAR struct file *filep)
   uint32_t flags;
 
   flags = spin_lock_irqsave(&g_pressure_lock);
-  dq_rem(&priv->entry, &g_pressure_memory_queue);
+  dq_rem(&priv->entry, pressure_queue(priv));
   spin_unlock_irqrestore(&g_pressure_lock, flags);
   free(priv);
   return OK;
@@ -158,6 +481,9 @@ static int pressure_close(FAR struct file *filep)
 static ssize_t pressure_read(FAR struct file *filep, FAR char *buffer,
                              size_t buflen)
 {
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+  FAR struct pressure_file_s *priv = filep->f_priv;
+#endif
   char buf[128];
   uint32_t flags;
   size_t remain;
@@ -165,13 +491,23 @@ static ssize_t pressure_read(FAR struct file *filep, FAR char *buffer,
   off_t offset;
   ssize_t ret;
 
-  flags   = spin_lock_irqsave(&g_pressure_lock);
-  remain  = g_remaining;
-  largest = g_largest;
-  spin_unlock_irqrestore(&g_pressure_lock, flags);
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+  if (priv->stall != NULL)
+    {
+      ret = pressure_stall_read(priv->stall, buf, sizeof(buf));
+    }
+  else
+#endif
+    {
+      flags   = spin_lock_irqsave(&g_pressure_lock);
+      remain  = g_remaining;
+      largest = g_largest;
+      spin_unlock_irqrestore(&g_pressure_lock, flags);
 
-  ret = procfs_snprintf(buf, sizeof(buf), "remaining %zu, largest:%zu\n",
-                        remain, largest);
+      ret = procfs_snprintf(buf, sizeof(buf),
+                            "remaining %zu, largest:%zu\n",
+                            remain, largest);
+    }
 
   if (ret > buflen)
     {
@@ -203,6 +539,13 @@ static ssize_t pressure_write(FAR struct file *filep, FAR const char *buffer,
       return -EINVAL;
     }
 
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+  if (priv->stall != NULL)
+    {
+      return pressure_stall_write(priv, buffer, buflen);
+    }
+#endif
+
   threshold = strtoul(buffer, &endptr, 0);
   if (threshold == 0)
     {
@@ -252,6 +595,25 @@ static int pressure_poll(FAR struct file *filep, FAR struct pollfd *fds,
           priv->fds = fds;
           fds->priv = &priv->fds;
 
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+          /* A stall trigger fires at once if the threshold of its window
+           * is already reached.
+           */
+
+          if (priv->stall != NULL)
+            {
+              bool notify = pressure_stall_trigger(priv, current);
+
+              spin_unlock_irqrestore(&g_pressure_lock, flags);
+              if (notify)
+                {
+                  poll_notify(&priv->fds, 1, POLLPRI);
+                }
+
+              return OK;
+            }
+#endif
+
           /* If the remaining memory is less than the threshold and
            * lasttick is CLOCK_MAX, it means the event is triggered for
            * the first time and we should always send a notification.
@@ -300,7 +662,7 @@ static int pressure_dup(FAR const struct file *oldp, FAR struct file *newp)
 
   flags = spin_lock_irqsave(&g_pressure_lock);
   memcpy(newpriv, oldpriv, sizeof(struct pressure_file_s));
-  dq_addfirst(&newpriv->entry, &g_pressure_memory_queue);
+  dq_addfirst(&newpriv->entry, pressure_queue(newpriv));
   newpriv->fds = NULL;
   newp->f_priv = newpriv;
   spin_unlock_irqrestore(&g_pressure_lock, flags);
@@ -326,7 +688,7 @@ static int pressure_opendir(FAR const char *relpath,
     }
 
   level->level    = 1;
-  level->nentries = 1;
+  level->nentries = PRESSURE_NFILES;
 
   *dir = (FAR struct fs_dirent_s *)level;
   return OK;
@@ -361,7 +723,8 @@ static int pressure_readdir(FAR struct fs_dirent_s *dir,
     }
 
   entry->d_type = DTYPE_FILE;
-  strncpy(entry->d_name, "memory", sizeof(entry->d_name));
+  strlcpy(entry->d_name, g_pressure_names[level->index],
+          sizeof(entry->d_name));
   level->index++;
   return OK;
 }
@@ -392,7 +755,7 @@ static int pressure_stat(const char *relpath, struct stat *buf)
     {
       buf->st_mode = S_IFDIR | S_IROTH | S_IRGRP | S_IRUSR;
     }
-  else if (strcmp(relpath, "pressure/memory") == 0)
+  else if (pressure_find(relpath) >= 0)
     {
       buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWOTH |
                      S_IWGRP | S_IWUSR;
@@ -467,3 +830,85 @@ void mm_notify_pressure(size_t remaining, size_t largest)
   spin_unlock_irqrestore(&g_pressure_lock, flags);
 }
 
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+/****************************************************************************
+ * Name: pressure_stall_enter
+ ****************************************************************************/
+
+void pressure_stall_enter(int resource)
+{
+  FAR struct pressure_stall_s *stall = &g_pressure_stall[resource];
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+  if (stall->nstalled++ == 0)
+    {
+      stall->start = clock_systime_ticks();
+    }
+
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+}
+
+/****************************************************************************
+ * Name: pressure_stall_leave
+ ****************************************************************************/
+
+ssize_t pressure_stall_leave(int resource, ssize_t ret)
+{
+  FAR struct pressure_stall_s *stall = &g_pressure_stall[resource];
+  clock_t current = clock_systime_ticks();
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+  DEBUGASSERT(stall->nstalled > 0);
+
+  if (--stall->nstalled == 0)
+    {
+      stall->total += current - stall->start;
+    }
+
+  flags = pressure_stall_notify(stall, current, flags);
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pressure_stall_tick
+ ****************************************************************************/
+
+void pressure_stall_tick(bool stalled)
+{
+  clock_t current = clock_systime_ticks();
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+
+  /* The CPU pressure is sampled, each stalled tick counts as a whole */
+
+  if (stalled)
+    {
+      g_pressure_stall[PRESSURE_CPU].total++;
+    }
+
+  if (current - g_pressure_avgtick >= PRESSURE_AVG_PERIOD)
+    {
+      for (i = 0; i < PRESSURE_NSTALLS; i++)
+        {
+          pressure_stall_average(&g_pressure_stall[i], current,
+                                 current - g_pressure_avgtick);
+        }
+
+      g_pressure_avgtick = current;
+    }
+
+  /* Also fire the triggers of the stalls that are still in progress */
+
+  for (i = 0; i < PRESSURE_NSTALLS; i++)
+    {
+      flags = pressure_stall_notify(&g_pressure_stall[i], current, flags);
+    }
+
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+}
+#endif /* CONFIG_FS_PROCFS_PRESSURE_STALL */
@@ -93,6 +93,9 @@ enum proc_node_e
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+  PROC_STAT,                          /* Task/thread statistics */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   PROC_HEAP,                          /* Task heap info */
 #endif
@@ -184,6 +187,11 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+static ssize_t proc_taskstat(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
 static ssize_t proc_heap(FAR struct proc_file_s *procfile,
                          FAR struct tcb_s *tcb, FAR char *buffer,
@@ -296,6 +304,13 @@ static const struct proc_node_s g_critmon =
 };
 #endif
 
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+static const struct proc_node_s g_stat =
+{
+  "stat",          "stat",    (uint8_t)PROC_STAT,        DTYPE_FILE        /* Task/thread statistics */
+};
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static const struct proc_node_s g_heap =
 {
@@ -350,6 +365,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
 #endif
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+  &g_stat,         /* Task/thread statistics */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -379,6 +397,9 @@ static const struct proc_node_s * const g_level0info[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
 #endif
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+  &g_stat,         /* Task/thread statistics */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -860,7 +881,7 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
   /* Reset the maximum */
 
   tcb->run_max = 0;
-  perf_convert(tcb->run_time, &runtime);
+  perf_convert(nxsched_get_runtime(tcb), &runtime);
 
   /* Output the maximum time the thread has run and
    * the total time the thread has run
@@ -882,6 +903,71 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_taskstat
+ *
+ * Description:
+ *   Show the fields of the Linux /proc/<pid>/stat file that apply, up to
+ *   the nice value.  The run time of the thread is reported as user time in
+ *   clock ticks; there is no separate accounting of the system time.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+static ssize_t proc_taskstat(FAR struct proc_file_s *procfile,
+                             FAR struct tcb_s *tcb, FAR char *buffer,
+                             size_t buflen, off_t offset)
+{
+  FAR const char *name;
+  struct timespec runtime;
+  clock_t utime;
+  size_t linesize;
+  char state;
+
+#if CONFIG_TASK_NAME_SIZE > 0
+  name = tcb->name;
+#else
+  name = "<noname>";
+#endif
+
+  switch (tcb->task_state)
+    {
+      case TSTATE_TASK_PENDING:
+      case TSTATE_TASK_READYTORUN:
+      case TSTATE_TASK_RUNNING:
+        state = 'R';
+        break;
+
+#ifdef CONFIG_SIG_SIGSTOP_ACTION
+      case TSTATE_TASK_STOPPED:
+        state = 'T';
+        break;
+#endif
+
+      default:
+        state = 'S';
+        break;
+    }
+
+  perf_convert(nxsched_get_runtime(tcb), &runtime);
+  utime = (clock_t)runtime.tv_sec * TICK_PER_SEC +
+          runtime.tv_nsec / NSEC_PER_TICK;
+
+  /* pid (comm) state ppid pgrp session tty_nr tpgid flags minflt cminflt
+   * majflt cmajflt utime stime cutime cstime priority nice
+   */
+
+  linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                             "%d (%s) %c %d %d %d 0 0 0 0 0 0 0 "
+                             "%lu 0 0 0 %d 0\n",
+                             tcb->pid, name, state, tcb->group->tg_ppid,
+                             tcb->group->tg_pid, tcb->group->tg_pid,
+                             (unsigned long)utime, tcb->sched_priority);
+
+  return procfs_memcpy(procfile->line, linesize, buffer, buflen, &offset);
+}
+#endif
+
 /****************************************************************************
  * Name: proc_heap
  ****************************************************************************/
@@ -1617,6 +1703,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 #endif
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+    case PROC_STAT: /* Task/thread statistics */
+      ret = proc_taskstat(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
     case PROC_HEAP: /* Task heap info */
       ret = proc_heap(procfile, tcb, buffer, buflen, filep->f_pos);
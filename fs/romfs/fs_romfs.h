@@ -122,6 +122,18 @@
  */
 
 struct romfs_file_s;
+struct romfs_nodeinfo_s;
+
+#ifdef CONFIG_FS_ROMFS_PATHINDEX
+/* One slot of the path hash index */
+
+struct romfs_pathent_s
+{
+  uint32_t rp_hash;                        /* Hash of the full path */
+  FAR struct romfs_nodeinfo_s *rp_node;    /* The node, NULL if free */
+};
+#endif
+
 struct romfs_mountpt_s
 {
   FAR struct inode *rm_blkdriver; /* The block driver inode that hosts the romfs */
@@ -129,6 +141,10 @@ struct romfs_mountpt_s
   FAR struct romfs_nodeinfo_s *rm_root; /* The node for root node */
 #else
   uint32_t rm_rootoffset;         /* Saved offset to the first root directory entry */
+#endif
+#ifdef CONFIG_FS_ROMFS_PATHINDEX
+  FAR struct romfs_pathent_s *rm_index; /* Path hash index or NULL */
+  uint32_t rm_indexmask;                /* Number of slots minus one */
 #endif
   bool     rm_mounted;            /* true: The file system is ready */
   uint16_t rm_hwsectorsize;       /* HW: Sector size reported by block driver */
@@ -166,6 +182,9 @@ struct romfs_nodeinfo_s
 #ifdef CONFIG_FS_ROMFS_CACHE_NODE
   FAR struct romfs_nodeinfo_s **rn_child;  /* The node array for link to lower level */
   uint16_t rn_count;                       /* The count of node in rn_child level */
+#ifdef CONFIG_FS_ROMFS_PATHINDEX
+  FAR struct romfs_nodeinfo_s *rn_parent;  /* The directory of the entry */
+#endif
   uint8_t  rn_namesize;                    /* The length of name of the entry */
   char     rn_name[1];                     /* The name to the entry */
 #endif
@@ -211,6 +230,9 @@ int  romfs_datastart(FAR struct romfs_mountpt_s *rm,
 #ifdef CONFIG_FS_ROMFS_CACHE_NODE
 void romfs_freenode(FAR struct romfs_nodeinfo_s *node);
 #endif
+#ifdef CONFIG_FS_ROMFS_PATHINDEX
+void romfs_freeindex(FAR struct romfs_mountpt_s *rm);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
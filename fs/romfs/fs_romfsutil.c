@@ -37,6 +37,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/procfs.h>
 
 #include "fs_romfs.h"
 
@@ -48,6 +49,11 @@
 #define LINK_FOLLOWED     1
 #define NODEINFO_NINCR    4
 
+/* FNV-1a hash of the full path of a node, see romfs_pathhash() */
+
+#define PATHHASH_BASIS    2166136261u
+#define PATHHASH_PRIME    16777619u
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -487,6 +493,10 @@ static int romfs_cachenode(FAR struct romfs_mountpt_s *rm,
               nodeinfo->rn_count--;
               return ret;
             }
+
+#ifdef CONFIG_FS_ROMFS_PATHINDEX
+          (*child)->rn_parent = nodeinfo;
+#endif
         }
 
       next &= RFNEXT_OFFSETMASK;
@@ -504,6 +514,241 @@ static int romfs_cachenode(FAR struct romfs_mountpt_s *rm,
 }
 #endif
 
+/****************************************************************************
+ * Name: romfs_pathhash
+ *
+ * Description:
+ *   Add one path component to the hash of the path of its directory.  The
+ *   hash of the root directory is PATHHASH_BASIS and every component is
+ *   hashed as '/' followed by its name, so "a//b/" hashes like "a/b".
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_PATHINDEX
+static uint32_t romfs_pathhash(uint32_t hash, FAR const char *name,
+                               size_t len)
+{
+  hash = (hash ^ '/') * PATHHASH_PRIME;
+  while (len-- > 0)
+    {
+      hash = (hash ^ (uint8_t)*name++) * PATHHASH_PRIME;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: romfs_countnode
+ *
+ * Description:
+ *   Return the number of cached nodes below a directory
+ *
+ ****************************************************************************/
+
+static uint32_t romfs_countnode(FAR struct romfs_nodeinfo_s *nodeinfo)
+{
+  uint32_t count = 0;
+  int i;
+
+  if (IS_DIRECTORY(nodeinfo->rn_next))
+    {
+      for (i = 0; i < nodeinfo->rn_count; i++)
+        {
+          count += 1 + romfs_countnode(nodeinfo->rn_child[i]);
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: romfs_indexnode
+ *
+ * Description:
+ *   Insert all nodes below a directory into the path hash index
+ *
+ ****************************************************************************/
+
+static void romfs_indexnode(FAR struct romfs_mountpt_s *rm,
+                            FAR struct romfs_nodeinfo_s *nodeinfo,
+                            uint32_t hash)
+{
+  FAR struct romfs_nodeinfo_s *child;
+  uint32_t chash;
+  uint32_t ndx;
+  int i;
+
+  if (!IS_DIRECTORY(nodeinfo->rn_next))
+    {
+      return;
+    }
+
+  for (i = 0; i < nodeinfo->rn_count; i++)
+    {
+      child = nodeinfo->rn_child[i];
+      chash = romfs_pathhash(hash, child->rn_name, child->rn_namesize);
+
+      /* Linear probing, the table is never more than half full */
+
+      ndx = chash & rm->rm_indexmask;
+      while (rm->rm_index[ndx].rp_node != NULL)
+        {
+          ndx = (ndx + 1) & rm->rm_indexmask;
+        }
+
+      rm->rm_index[ndx].rp_hash = chash;
+      rm->rm_index[ndx].rp_node = child;
+
+      romfs_indexnode(rm, child, chash);
+    }
+}
+
+/****************************************************************************
+ * Name: romfs_buildindex
+ *
+ * Description:
+ *   Build the path hash index of the cached nodes when the file system is
+ *   mounted.  Without memory, lookups just walk the cached directories.
+ *
+ ****************************************************************************/
+
+static void romfs_buildindex(FAR struct romfs_mountpt_s *rm)
+{
+  uint32_t count;
+  uint32_t nslots;
+
+  count = romfs_countnode(rm->rm_root);
+  if (count == 0)
+    {
+      return;
+    }
+
+  for (nslots = 4; nslots < 2 * count; nslots <<= 1);
+
+  rm->rm_index = kmm_zalloc(nslots * sizeof(struct romfs_pathent_s));
+  if (rm->rm_index == NULL)
+    {
+      ferr("ERROR: Failed to allocate the path index\n");
+      return;
+    }
+
+  rm->rm_indexmask = nslots - 1;
+  romfs_indexnode(rm, rm->rm_root, PATHHASH_BASIS);
+}
+
+/****************************************************************************
+ * Name: romfs_checkpath
+ *
+ * Description:
+ *   Check that a node found by its hash really has the path [path, end),
+ *   by comparing the components from the last one up to the root.
+ *
+ ****************************************************************************/
+
+static bool romfs_checkpath(FAR struct romfs_nodeinfo_s *nodeinfo,
+                            FAR const char *path, FAR const char *end)
+{
+  FAR const char *start;
+
+  for (; ; )
+    {
+      while (end > path && *(end - 1) == '/')
+        {
+          end--;
+        }
+
+      if (end == path)
+        {
+          return nodeinfo->rn_parent == NULL;
+        }
+
+      if (nodeinfo->rn_parent == NULL)
+        {
+          return false;
+        }
+
+      for (start = end; start > path && *(start - 1) != '/'; start--);
+
+      if (end - start != nodeinfo->rn_namesize ||
+          memcmp(start, nodeinfo->rn_name, end - start) != 0)
+        {
+          return false;
+        }
+
+      nodeinfo = nodeinfo->rn_parent;
+      end      = start;
+    }
+}
+
+/****************************************************************************
+ * Name: romfs_lookupindex
+ *
+ * Description:
+ *   Look up a path in the path hash index.  Returns NULL if the path is
+ *   not in the index; the caller then walks the directories, which also
+ *   provides the right error code.
+ *
+ ****************************************************************************/
+
+static FAR struct romfs_nodeinfo_s *
+romfs_lookupindex(FAR struct romfs_mountpt_s *rm, FAR const char *path)
+{
+  FAR struct romfs_nodeinfo_s *nodeinfo;
+  FAR const char *entryname = path;
+  FAR const char *end = path;
+  uint32_t hash = PATHHASH_BASIS;
+  uint32_t ndx;
+  size_t entrylen;
+
+  if (rm->rm_index == NULL)
+    {
+      return NULL;
+    }
+
+  for (; ; )
+    {
+      while (*entryname == '/')
+        {
+          entryname++;
+        }
+
+      if (*entryname == '\0')
+        {
+          break;
+        }
+
+      end = strchrnul(entryname, '/');
+      entrylen = end - entryname;
+
+      /* Long names are truncated by the directory walk, leave it to it */
+
+      if (entrylen > NAME_MAX)
+        {
+          return NULL;
+        }
+
+      hash = romfs_pathhash(hash, entryname, entrylen);
+      entryname = end;
+    }
+
+  for (ndx = hash & rm->rm_indexmask;
+       (nodeinfo = rm->rm_index[ndx].rp_node) != NULL;
+       ndx = (ndx + 1) & rm->rm_indexmask)
+    {
+      if (rm->rm_index[ndx].rp_hash == hash &&
+          romfs_checkpath(nodeinfo, path, entryname))
+        {
+          /* A trailing '/' is only accepted after a directory */
+
+          return *end == '\0' || IS_DIRECTORY(nodeinfo->rn_next) ?
+                 nodeinfo : NULL;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -538,7 +783,9 @@ int romfs_hwread(FAR struct romfs_mountpt_s *rm, FAR uint8_t *buffer,
       ssize_t nsectorsread = -ENODEV;
 
       nsectorsread =
-        inode->u.i_bops->read(inode, buffer, sector, nsectors);
+        PRESSURE_STALL(PRESSURE_IO,
+                       inode->u.i_bops->read(inode, buffer, sector,
+                                             nsectors));
 
       if (nsectorsread == (ssize_t)nsectors)
         {
@@ -738,6 +985,10 @@ int romfs_fsconfigure(FAR struct romfs_mountpt_s *rm)
       romfs_freenode(rm->rm_root);
       return ndx;
     }
+
+#  ifdef CONFIG_FS_ROMFS_PATHINDEX
+  romfs_buildindex(rm);
+#  endif
 #else
   rm->rm_rootoffset = ROMFS_ALIGNUP(ROMFS_VHDR_VOLNAME + strlen(name) + 1);
 #endif
@@ -872,6 +1123,23 @@ void romfs_freenode(FAR struct romfs_nodeinfo_s *nodeinfo)
 }
 #endif
 
+/****************************************************************************
+ * Name: romfs_freeindex
+ *
+ * Description:
+ *   free the path hash index when filesystem is unmounted
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_PATHINDEX
+void romfs_freeindex(FAR struct romfs_mountpt_s *rm)
+{
+  kmm_free(rm->rm_index);
+  rm->rm_index     = NULL;
+  rm->rm_indexmask = 0;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_finddirentry
  *
@@ -885,6 +1153,9 @@ int romfs_finddirentry(FAR struct romfs_mountpt_s *rm,
                        FAR struct romfs_nodeinfo_s *nodeinfo,
                        FAR const char *path)
 {
+#ifdef CONFIG_FS_ROMFS_PATHINDEX
+  FAR struct romfs_nodeinfo_s *cnodeinfo;
+#endif
   FAR const char *entryname;
   FAR const char *terminator;
   int entrylen;
@@ -907,6 +1178,17 @@ int romfs_finddirentry(FAR struct romfs_mountpt_s *rm,
       return OK;
     }
 
+#ifdef CONFIG_FS_ROMFS_PATHINDEX
+  /* Try the path hash index first */
+
+  cnodeinfo = romfs_lookupindex(rm, path);
+  if (cnodeinfo != NULL)
+    {
+      memcpy(nodeinfo, cnodeinfo, sizeof(*nodeinfo));
+      return OK;
+    }
+#endif
+
   /* Then loop for each directory/file component in the full path */
 
   entryname  = path;
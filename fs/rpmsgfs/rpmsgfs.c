@@ -36,6 +36,7 @@
 #include <debug.h>
 #include <limits.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -50,6 +51,10 @@
 
 #define RPMSGFS_RETRY_DELAY_MS       10
 
+/* Space for the directory entries returned by one readdir request */
+
+#define RPMSGFS_READDIR_BUFSIZE      512
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -58,6 +63,9 @@ struct rpmsgfs_dir_s
 {
   struct fs_dirent_s base;
   FAR void *dir;
+  size_t    pos;                       /* Offset of the next entry in buf */
+  size_t    len;                       /* Size of the entries in buf */
+  char      buf[RPMSGFS_READDIR_BUFSIZE];
 };
 
 /* This structure describes the state of one open file.  This structure
@@ -70,7 +78,28 @@ struct rpmsgfs_ofile_s
   int16_t                    crefs;    /* Reference count */
   mode_t                     oflags;   /* Open mode */
   int                        fd;
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  FAR char                   *rbuf;    /* Data read ahead */
+  size_t                     rpos;     /* Offset of the next byte in rbuf */
+  size_t                     rlen;     /* Number of bytes in rbuf */
+  struct rpmsgfs_lease_s     rlease;   /* Lease on the data in rbuf */
+  struct rpmsgfs_lease_s     stlease;  /* Lease on stbuf */
+  bool                       stvalid;  /* True if stbuf was filled */
+  struct stat                stbuf;    /* Attributes of the file */
+#endif
+};
+
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+/* The result of a stat() of a path, a missing file included */
+
+struct rpmsgfs_attr_s
+{
+  struct rpmsgfs_lease_s     lease;
+  FAR char                   *path;
+  int                        ret;
+  struct stat                buf;
 };
+#endif
 
 /* This structure represents the overall mountpoint state.  An instance of
  * this structure is retained as inode private data on each mountpoint that
@@ -84,6 +113,10 @@ struct rpmsgfs_mountpt_s
   char                       fs_root[PATH_MAX];
   void                       *handle;
   int                        timeout;  /* Connect timeout */
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  unsigned int               fs_attrnext;
+  struct rpmsgfs_attr_s      fs_attr[CONFIG_FS_RPMSGFS_ATTRCACHE_NENTRIES];
+#endif
 };
 
 /****************************************************************************
@@ -259,6 +292,9 @@ static void rpmsgfs_mkpath(FAR struct rpmsgfs_mountpt_s *fs,
       ret = rpmsgfs_client_stat(fs->handle, fs->fs_root, &buf);
       if (ret == 0)
         {
+          /* Connected, there is no need to check again */
+
+          fs->timeout = 0;
           break;
         }
 
@@ -267,6 +303,187 @@ static void rpmsgfs_mkpath(FAR struct rpmsgfs_mountpt_s *fs,
     }
 }
 
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+/****************************************************************************
+ * Name: rpmsgfs_drop_readahead
+ *
+ * Description: Discard the data read ahead and move the host file position
+ *   back to the position of the caller.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_drop_readahead(FAR struct rpmsgfs_mountpt_s *fs,
+                                  FAR struct rpmsgfs_ofile_s *hf)
+{
+  off_t ret;
+
+  if (hf->rpos < hf->rlen)
+    {
+      ret = rpmsgfs_client_lseek(fs->handle, hf->fd,
+                                 -(off_t)(hf->rlen - hf->rpos), SEEK_CUR);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  hf->rpos = 0;
+  hf->rlen = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_readahead
+ *
+ * Description: Serve reads smaller than CONFIG_FS_RPMSGFS_READAHEAD from
+ *   data fetched that many bytes at a time.  Larger reads go directly to
+ *   the buffer of the caller.
+ *
+ ****************************************************************************/
+
+static ssize_t rpmsgfs_readahead(FAR struct rpmsgfs_mountpt_s *fs,
+                                 FAR struct rpmsgfs_ofile_s *hf,
+                                 FAR char *buffer, size_t buflen)
+{
+  size_t nread = 0;
+  ssize_t ret = 0;
+  size_t n;
+
+  /* Data read ahead under an expired or broken lease may be stale */
+
+  if (hf->rpos < hf->rlen &&
+      !rpmsgfs_client_lease_valid(fs->handle, &hf->rlease))
+    {
+      ret = rpmsgfs_drop_readahead(fs, hf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  while (nread < buflen)
+    {
+      if (hf->rpos < hf->rlen)
+        {
+          n = MIN(buflen - nread, hf->rlen - hf->rpos);
+          memcpy(buffer + nread, hf->rbuf + hf->rpos, n);
+          hf->rpos += n;
+          nread    += n;
+
+          /* A short read ahead stopped at the end of the file */
+
+          if (hf->rpos == hf->rlen &&
+              hf->rlen < CONFIG_FS_RPMSGFS_READAHEAD)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      if (hf->rbuf == NULL && buflen - nread < CONFIG_FS_RPMSGFS_READAHEAD)
+        {
+          hf->rbuf = kmm_malloc(CONFIG_FS_RPMSGFS_READAHEAD);
+        }
+
+      if (hf->rbuf == NULL || buflen - nread >= CONFIG_FS_RPMSGFS_READAHEAD)
+        {
+          ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer + nread,
+                                    buflen - nread);
+          if (ret > 0)
+            {
+              nread += ret;
+            }
+
+          break;
+        }
+
+      /* Take the lease before asking for the data, so a change notified
+       * while the data is on its way is not missed.
+       */
+
+      rpmsgfs_client_lease(fs->handle, &hf->rlease);
+      ret = rpmsgfs_client_read(fs->handle, hf->fd, hf->rbuf,
+                                CONFIG_FS_RPMSGFS_READAHEAD);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      hf->rpos = 0;
+      hf->rlen = ret;
+    }
+
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_attr_lookup
+ *
+ * Description: Find the cached result of a stat() of path.
+ *
+ ****************************************************************************/
+
+static FAR struct rpmsgfs_attr_s *
+rpmsgfs_attr_lookup(FAR struct rpmsgfs_mountpt_s *fs, FAR const char *path)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_RPMSGFS_ATTRCACHE_NENTRIES; i++)
+    {
+      if (fs->fs_attr[i].path != NULL &&
+          strcmp(fs->fs_attr[i].path, path) == 0)
+        {
+          return &fs->fs_attr[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_attr_update
+ *
+ * Description: Cache the result of a stat() of path, replacing the oldest
+ *   entry if path is not cached yet.
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_attr_update(FAR struct rpmsgfs_mountpt_s *fs,
+                                FAR const char *path,
+                                FAR const struct rpmsgfs_lease_s *lease,
+                                int ret, FAR const struct stat *buf)
+{
+  FAR struct rpmsgfs_attr_s *attr;
+  size_t len;
+
+  attr = rpmsgfs_attr_lookup(fs, path);
+  if (attr == NULL)
+    {
+      attr = &fs->fs_attr[fs->fs_attrnext];
+      fs->fs_attrnext = (fs->fs_attrnext + 1) %
+                        CONFIG_FS_RPMSGFS_ATTRCACHE_NENTRIES;
+
+      len = strlen(path) + 1;
+      kmm_free(attr->path);
+      attr->path = kmm_malloc(len);
+      if (attr->path == NULL)
+        {
+          return;
+        }
+
+      memcpy(attr->path, path, len);
+    }
+
+  attr->lease = *lease;
+  attr->ret   = ret;
+  if (ret >= 0)
+    {
+      attr->buf = *buf;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsgfs_open
  ****************************************************************************/
@@ -303,7 +520,7 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Allocate memory for the open file */
 
-  hf = kmm_malloc(sizeof *hf);
+  hf = kmm_zalloc(sizeof *hf);
   if (hf == NULL)
     {
       ret = -ENOMEM;
@@ -455,6 +672,9 @@ static int rpmsgfs_close(FAR struct file *filep)
   /* Now free the pointer */
 
   filep->f_priv = NULL;
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  kmm_free(hf->rbuf);
+#endif
   kmm_free(hf);
 
 okout:
@@ -496,7 +716,11 @@ static ssize_t rpmsgfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  ret = rpmsgfs_readahead(fs, hf, buffer, buflen);
+#else
   ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -546,6 +770,14 @@ static ssize_t rpmsgfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_lock;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  ret = rpmsgfs_drop_readahead(fs, hf);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+#endif
+
   /* Call the host to perform the write */
 
   ret = rpmsgfs_client_write(fs->handle, hf->fd, buffer, buflen);
@@ -590,6 +822,18 @@ static off_t rpmsgfs_seek(FAR struct file *filep, off_t offset, int whence)
       return ret;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  /* The host file position is ahead by the data still read ahead */
+
+  if (whence == SEEK_CUR)
+    {
+      offset -= (off_t)(hf->rlen - hf->rpos);
+    }
+
+  hf->rpos = 0;
+  hf->rlen = 0;
+#endif
+
   /* Call our internal routine to perform the seek */
 
   ret = rpmsgfs_client_lseek(fs->handle, hf->fd, offset, whence);
@@ -633,6 +877,15 @@ static int rpmsgfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  ret = rpmsgfs_drop_readahead(fs, hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&fs->fs_lock);
+      return ret;
+    }
+#endif
+
   /* Call our internal routine to perform the ioctl */
 
   ret = rpmsgfs_client_ioctl(fs->handle, hf->fd, cmd, arg);
@@ -754,10 +1007,29 @@ static int rpmsgfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
       return ret;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  if (hf->stvalid && rpmsgfs_client_lease_valid(fs->handle, &hf->stlease))
+    {
+      memcpy(buf, &hf->stbuf, sizeof(*buf));
+      nxmutex_unlock(&fs->fs_lock);
+      return OK;
+    }
+
+  rpmsgfs_client_lease(fs->handle, &hf->stlease);
+#endif
+
   /* Call the host to perform the read */
 
   ret = rpmsgfs_client_fstat(fs->handle, hf->fd, buf);
 
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  hf->stvalid = ret >= 0;
+  if (hf->stvalid)
+    {
+      memcpy(&hf->stbuf, buf, sizeof(hf->stbuf));
+    }
+#endif
+
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
@@ -841,6 +1113,15 @@ static int rpmsgfs_truncate(FAR struct file *filep, off_t length)
       return ret;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  ret = rpmsgfs_drop_readahead(fs, hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&fs->fs_lock);
+      return ret;
+    }
+#endif
+
   /* Call the host to perform the truncate */
 
   ret = rpmsgfs_client_ftruncate(fs->handle, hf->fd, length);
@@ -963,8 +1244,9 @@ static int rpmsgfs_readdir(FAR struct inode *mountpt,
                            FAR struct dirent *entry)
 {
   FAR struct rpmsgfs_mountpt_s *fs;
+  FAR struct rpmsgfs_dirent_s *dirent;
   FAR struct rpmsgfs_dir_s *rdir;
-  int ret;
+  ssize_t ret;
 
   /* Sanity checks */
 
@@ -983,9 +1265,28 @@ static int rpmsgfs_readdir(FAR struct inode *mountpt,
       return ret;
     }
 
-  /* Call the host OS's readdir function */
+  /* Ask the host for the next batch of entries once the last is used up */
 
-  ret = rpmsgfs_client_readdir(fs->handle, rdir->dir, entry);
+  if (rdir->pos >= rdir->len)
+    {
+      ret = rpmsgfs_client_readdir(fs->handle, rdir->dir, rdir->buf,
+                                   sizeof(rdir->buf));
+      rdir->pos = 0;
+      rdir->len = ret > 0 ? ret : 0;
+      if (ret == 0)
+        {
+          ret = -ENOENT;
+        }
+    }
+
+  if (rdir->pos < rdir->len)
+    {
+      dirent = (FAR struct rpmsgfs_dirent_s *)&rdir->buf[rdir->pos];
+      strlcpy(entry->d_name, dirent->name, sizeof(entry->d_name));
+      entry->d_type = dirent->type;
+      rdir->pos += dirent->reclen;
+      ret = OK;
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -1024,6 +1325,8 @@ static int rpmsgfs_rewinddir(FAR struct inode *mountpt,
 
   /* Call the host and let it do all the work */
 
+  rdir->pos = 0;
+  rdir->len = 0;
   rpmsgfs_client_rewinddir(fs->handle, rdir->dir);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1157,6 +1460,9 @@ static int rpmsgfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 {
   FAR struct rpmsgfs_mountpt_s *fs = (FAR struct rpmsgfs_mountpt_s *)handle;
   int ret;
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  int i;
+#endif
 
   if (!fs)
     {
@@ -1191,6 +1497,13 @@ static int rpmsgfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return ret;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  for (i = 0; i < CONFIG_FS_RPMSGFS_ATTRCACHE_NENTRIES; i++)
+    {
+      kmm_free(fs->fs_attr[i].path);
+    }
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   kmm_free(fs);
   return 0;
@@ -1404,6 +1717,10 @@ static int rpmsgfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                         FAR struct stat *buf)
 {
   FAR struct rpmsgfs_mountpt_s *fs;
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  FAR struct rpmsgfs_attr_s *attr;
+  struct rpmsgfs_lease_s lease;
+#endif
   char path[PATH_MAX];
   int ret;
 
@@ -1425,10 +1742,34 @@ static int rpmsgfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   rpmsgfs_mkpath(fs, relpath, path, sizeof(path));
 
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  attr = rpmsgfs_attr_lookup(fs, path);
+  if (attr != NULL && rpmsgfs_client_lease_valid(fs->handle, &attr->lease))
+    {
+      ret = attr->ret;
+      if (ret >= 0)
+        {
+          memcpy(buf, &attr->buf, sizeof(*buf));
+        }
+
+      nxmutex_unlock(&fs->fs_lock);
+      return ret;
+    }
+
+  rpmsgfs_client_lease(fs->handle, &lease);
+#endif
+
   /* Call the host FS to do the stat operation */
 
   ret = rpmsgfs_client_stat(fs->handle, path, buf);
 
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+  if (ret >= 0 || ret == -ENOENT)
+    {
+      rpmsgfs_attr_update(fs, path, &lease, ret, buf);
+    }
+#endif
+
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
@@ -29,6 +29,8 @@
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <sys/param.h>
+#include <stdbool.h>
+#include <time.h>
 
 /****************************************************************************
  * Pre-processor definitions
@@ -58,6 +60,8 @@
 #define RPMSGFS_STAT            20
 #define RPMSGFS_FCHSTAT         21
 #define RPMSGFS_CHSTAT          22
+#define RPMSGFS_READDIRS        23
+#define RPMSGFS_INVALIDATE      24
 
 /****************************************************************************
  * Public Types
@@ -168,6 +172,28 @@ begin_packed_struct struct rpmsgfs_readdir_s
   char                    name[0];
 } end_packed_struct;
 
+/* RPMSGFS_READDIRS returns as many entries as fit into the smaller of
+ * the response and the size asked for, packed one after the other, and
+ * the total size of them as the result.  A result of zero marks the end
+ * of the directory.
+ */
+
+begin_packed_struct struct rpmsgfs_dirent_s
+{
+  uint8_t                 type;
+  uint8_t                 reserved;
+  uint16_t                reclen;   /* Size of the entry, name included */
+  char                    name[0];
+} end_packed_struct;
+
+begin_packed_struct struct rpmsgfs_readdirs_s
+{
+  struct rpmsgfs_header_s header;
+  int32_t                 fd;
+  uint32_t                size;
+  char                    buf[0];
+} end_packed_struct;
+
 #define rpmsgfs_rewinddir_s rpmsgfs_close_s
 #define rpmsgfs_closedir_s rpmsgfs_close_s
 
@@ -214,6 +240,24 @@ begin_packed_struct struct rpmsgfs_fchstat_s
 
 #define rpmsgfs_chstat_s rpmsgfs_fchstat_s
 
+/* RPMSGFS_INVALIDATE is sent by the server, with no response expected,
+ * to break the leases of a client on its cached data when another client
+ * changed the file system.
+ */
+
+#define rpmsgfs_invalidate_s rpmsgfs_header_s
+
+/* A lease on data cached by the client.  It ends after
+ * CONFIG_FS_RPMSGFS_LEASE milliseconds, or earlier when the file system
+ * is changed through the same mount or the server breaks it.
+ */
+
+struct rpmsgfs_lease_s
+{
+  clock_t                 stamp;
+  uint32_t                generation;
+};
+
 /****************************************************************************
  * Internal function prototypes
  ****************************************************************************/
@@ -237,8 +281,8 @@ int       rpmsgfs_client_fchstat(FAR void *handle, int fd,
                                  FAR const struct stat *buf, int flags);
 int       rpmsgfs_client_ftruncate(FAR void *handle, int fd, off_t length);
 FAR void *rpmsgfs_client_opendir(FAR void *handle, FAR const char *name);
-int       rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
-                                 FAR struct dirent *entry);
+ssize_t   rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
+                                 FAR void *buf, size_t size);
 void      rpmsgfs_client_rewinddir(FAR void *handle, FAR void *dirp);
 int       rpmsgfs_client_bind(FAR void **handle, FAR const char *cpuname);
 int       rpmsgfs_client_unbind(FAR void *handle);
@@ -255,6 +299,12 @@ int       rpmsgfs_client_stat(FAR void *handle, FAR const char *path,
                               FAR struct stat *buf);
 int       rpmsgfs_client_chstat(FAR void *handle, FAR const char *path,
                                 FAR const struct stat *buf, int flags);
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+void      rpmsgfs_client_lease(FAR void *handle,
+                               FAR struct rpmsgfs_lease_s *lease);
+bool      rpmsgfs_client_lease_valid(FAR void *handle,
+                               FAR const struct rpmsgfs_lease_s *lease);
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
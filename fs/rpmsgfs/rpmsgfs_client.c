@@ -29,6 +29,7 @@
 #include <sys/uio.h>
 #include <fcntl.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/rptun/openamp.h>
@@ -45,6 +46,7 @@ struct rpmsgfs_s
   struct rpmsg_endpoint ept;
   char                  cpuname[RPMSG_NAME_SIZE];
   sem_t                 wait;
+  volatile uint32_t     generation; /* Changes when the leases break */
 };
 
 struct rpmsgfs_cookie_s
@@ -67,9 +69,12 @@ static int rpmsgfs_read_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgfs_ioctl_handler(FAR struct rpmsg_endpoint *ept,
                                  FAR void *data, size_t len,
                                  uint32_t src, FAR void *priv);
-static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
-                                  FAR void *data, size_t len,
-                                  uint32_t src, FAR void *priv);
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv);
+static int rpmsgfs_invalidate_handler(FAR struct rpmsg_endpoint *ept,
+                                      FAR void *data, size_t len,
+                                      uint32_t src, FAR void *priv);
 static int rpmsgfs_statfs_handler(FAR struct rpmsg_endpoint *ept,
                                   FAR void *data, size_t len,
                                   uint32_t src, FAR void *priv);
@@ -105,7 +110,6 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_FSTAT]     = rpmsgfs_stat_handler,
   [RPMSGFS_FTRUNCATE] = rpmsgfs_default_handler,
   [RPMSGFS_OPENDIR]   = rpmsgfs_default_handler,
-  [RPMSGFS_READDIR]   = rpmsgfs_readdir_handler,
   [RPMSGFS_REWINDDIR] = rpmsgfs_default_handler,
   [RPMSGFS_CLOSEDIR]  = rpmsgfs_default_handler,
   [RPMSGFS_STATFS]    = rpmsgfs_statfs_handler,
@@ -116,6 +120,8 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_default_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_default_handler,
+  [RPMSGFS_READDIRS]  = rpmsgfs_readdirs_handler,
+  [RPMSGFS_INVALIDATE] = rpmsgfs_invalidate_handler,
 };
 
 /****************************************************************************
@@ -186,21 +192,21 @@ static int rpmsgfs_ioctl_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
-static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
-                                   FAR void *data, size_t len,
-                                   uint32_t src, FAR void *priv)
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv)
 {
   FAR struct rpmsgfs_header_s *header = data;
   FAR struct rpmsgfs_cookie_s *cookie =
       (struct rpmsgfs_cookie_s *)(uintptr_t)header->cookie;
-  FAR struct rpmsgfs_readdir_s *rsp = data;
-  FAR struct dirent *entry = cookie->data;
+  FAR struct rpmsgfs_readdirs_s *rsp = data;
+  FAR struct iovec *iov = cookie->data;
 
   cookie->result = header->result;
-  if (cookie->result >= 0)
+  if (cookie->result > 0)
     {
-      strlcpy(entry->d_name, rsp->name, sizeof(entry->d_name));
-      entry->d_type = rsp->type;
+      cookie->result = MIN(cookie->result, iov->iov_len);
+      memcpy(iov->iov_base, rsp->buf, cookie->result);
     }
 
   rpmsg_post(ept, &cookie->sem);
@@ -208,6 +214,16 @@ static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+static int rpmsgfs_invalidate_handler(FAR struct rpmsg_endpoint *ept,
+                                      FAR void *data, size_t len,
+                                      uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_s *fs = ept->priv;
+
+  fs->generation++;
+  return 0;
+}
+
 static int rpmsgfs_statfs_handler(FAR struct rpmsg_endpoint *ept,
                                   FAR void *data, size_t len,
                                   uint32_t src, FAR void *priv)
@@ -318,6 +334,7 @@ static void rpmsgfs_device_destroy(FAR struct rpmsg_device *rdev,
   if (strcmp(priv->cpuname, rpmsg_get_cpuname(rdev)) == 0)
     {
       rpmsg_destroy_ept(&priv->ept);
+      priv->generation++;
     }
 }
 
@@ -328,7 +345,8 @@ static int rpmsgfs_ept_cb(FAR struct rpmsg_endpoint *ept,
   FAR struct rpmsgfs_header_s *header = data;
   uint32_t command = header->command;
 
-  if (command < nitems(g_rpmsgfs_handler))
+  if (command < nitems(g_rpmsgfs_handler) &&
+      g_rpmsgfs_handler[command] != NULL)
     {
       return g_rpmsgfs_handler[command](ept, data, len, src, priv);
     }
@@ -385,6 +403,18 @@ fail:
   return ret;
 }
 
+/* Called after a change to the file system through this client, so none
+ * of the data cached under an earlier lease is used any more.
+ */
+
+static int rpmsgfs_changed(FAR void *handle, int ret)
+{
+  FAR struct rpmsgfs_s *priv = handle;
+
+  priv->generation++;
+  return ret;
+}
+
 static ssize_t rpmsgfs_ioctl_arglen(int cmd)
 {
   switch (cmd)
@@ -415,6 +445,7 @@ int rpmsgfs_client_open(FAR void *handle, FAR const char *pathname,
   FAR struct rpmsgfs_open_s *msg;
   uint32_t space;
   size_t len;
+  int ret;
 
   len = sizeof(*msg) + strlen(pathname) + 1;
 
@@ -430,8 +461,14 @@ int rpmsgfs_client_open(FAR void *handle, FAR const char *pathname,
   msg->mode  = mode;
   strlcpy(msg->pathname, pathname, space - sizeof(*msg));
 
-  return rpmsgfs_send_recv(priv, RPMSGFS_OPEN, false,
-          (struct rpmsgfs_header_s *)msg, len, NULL);
+  ret = rpmsgfs_send_recv(priv, RPMSGFS_OPEN, false,
+                          (struct rpmsgfs_header_s *)msg, len, NULL);
+  if ((flags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      rpmsgfs_changed(priv, ret);
+    }
+
+  return ret;
 }
 
 int rpmsgfs_client_close(FAR void *handle, int fd)
@@ -455,8 +492,9 @@ ssize_t rpmsgfs_client_read(FAR void *handle, int fd,
       .iov_len  = 0,
     };
 
+  FAR struct rpmsgfs_read_s *msg;
   struct rpmsgfs_cookie_s cookie;
-  struct rpmsgfs_read_s msg;
+  uint32_t space;
   int ret = 0;
 
   if (!buf || count <= 0)
@@ -464,18 +502,24 @@ ssize_t rpmsgfs_client_read(FAR void *handle, int fd,
       return 0;
     }
 
+  msg = rpmsgfs_get_tx_payload_buffer(priv, &space);
+  if (msg == NULL)
+    {
+      return -ENOMEM;
+    }
+
   memset(&cookie, 0, sizeof(cookie));
 
   nxsem_init(&cookie.sem, 0, 0);
   cookie.data = &read;
 
-  msg.header.command = RPMSGFS_READ;
-  msg.header.result  = -ENXIO;
-  msg.header.cookie  = (uintptr_t)&cookie;
-  msg.fd             = fd;
-  msg.count          = count;
+  msg->header.command = RPMSGFS_READ;
+  msg->header.result  = -ENXIO;
+  msg->header.cookie  = (uintptr_t)&cookie;
+  msg->fd             = fd;
+  msg->count          = count;
 
-  ret = rpmsg_send(&priv->ept, &msg, sizeof(msg));
+  ret = rpmsg_send_nocopy(&priv->ept, msg, sizeof(*msg));
   if (ret < 0)
     {
       goto out;
@@ -558,7 +602,7 @@ ssize_t rpmsgfs_client_write(FAR void *handle, int fd,
 
 out:
   nxsem_destroy(&cookie.sem);
-  return ret < 0 ? ret : count;
+  return rpmsgfs_changed(priv, ret < 0 ? ret : count);
 }
 
 off_t rpmsgfs_client_lseek(FAR void *handle, int fd,
@@ -667,8 +711,10 @@ int rpmsgfs_client_ftruncate(FAR void *handle, int fd, off_t length)
     .length = length,
   };
 
-  return rpmsgfs_send_recv(handle, RPMSGFS_FTRUNCATE, true,
-          (struct rpmsgfs_header_s *)&msg, sizeof(msg), NULL);
+  return rpmsgfs_changed(handle,
+           rpmsgfs_send_recv(handle, RPMSGFS_FTRUNCATE, true,
+                             (struct rpmsgfs_header_s *)&msg, sizeof(msg),
+                             NULL));
 }
 
 FAR void *rpmsgfs_client_opendir(FAR void *handle, FAR const char *name)
@@ -697,16 +743,23 @@ FAR void *rpmsgfs_client_opendir(FAR void *handle, FAR const char *name)
   return ret < 0 ? NULL : (FAR void *)((uintptr_t)ret);
 }
 
-int rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
-                           FAR struct dirent *entry)
+ssize_t rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
+                               FAR void *buf, size_t size)
 {
-  struct rpmsgfs_readdir_s msg =
+  struct rpmsgfs_readdirs_s msg =
   {
-    .fd = (uintptr_t)dirp,
+    .fd   = (uintptr_t)dirp,
+    .size = size,
   };
 
-  return rpmsgfs_send_recv(handle, RPMSGFS_READDIR, true,
-          (struct rpmsgfs_header_s *)&msg, sizeof(msg), entry);
+  struct iovec entries =
+  {
+    .iov_base = buf,
+    .iov_len  = size,
+  };
+
+  return rpmsgfs_send_recv(handle, RPMSGFS_READDIRS, true,
+          (struct rpmsgfs_header_s *)&msg, sizeof(msg), &entries);
 }
 
 void rpmsgfs_client_rewinddir(FAR void *handle, FAR void *dirp)
@@ -823,8 +876,9 @@ int rpmsgfs_client_unlink(FAR void *handle, FAR const char *pathname)
 
   strlcpy(msg->pathname, pathname, space - sizeof(*msg));
 
-  return rpmsgfs_send_recv(priv, RPMSGFS_UNLINK, false,
-          (struct rpmsgfs_header_s *)msg, len, NULL);
+  return rpmsgfs_changed(priv,
+           rpmsgfs_send_recv(priv, RPMSGFS_UNLINK, false,
+                             (struct rpmsgfs_header_s *)msg, len, NULL));
 }
 
 int rpmsgfs_client_mkdir(FAR void *handle, FAR const char *pathname,
@@ -846,8 +900,9 @@ int rpmsgfs_client_mkdir(FAR void *handle, FAR const char *pathname,
   msg->mode = mode;
   strlcpy(msg->pathname, pathname, space - sizeof(*msg));
 
-  return rpmsgfs_send_recv(priv, RPMSGFS_MKDIR, false,
-          (struct rpmsgfs_header_s *)msg, len, NULL);
+  return rpmsgfs_changed(priv,
+           rpmsgfs_send_recv(priv, RPMSGFS_MKDIR, false,
+                             (struct rpmsgfs_header_s *)msg, len, NULL));
 }
 
 int rpmsgfs_client_rmdir(FAR void *handle, FAR const char *pathname)
@@ -869,8 +924,9 @@ int rpmsgfs_client_rmdir(FAR void *handle, FAR const char *pathname)
 
   strlcpy(msg->pathname, pathname, space - sizeof(*msg));
 
-  return rpmsgfs_send_recv(priv, RPMSGFS_RMDIR, false,
-          (struct rpmsgfs_header_s *)msg, len, NULL);
+  return rpmsgfs_changed(priv,
+           rpmsgfs_send_recv(priv, RPMSGFS_RMDIR, false,
+                             (struct rpmsgfs_header_s *)msg, len, NULL));
 }
 
 int rpmsgfs_client_rename(FAR void *handle, FAR const char *oldpath,
@@ -900,8 +956,9 @@ int rpmsgfs_client_rename(FAR void *handle, FAR const char *oldpath,
   memcpy(msg->pathname, oldpath, oldlen);
   memcpy(msg->pathname + alignlen, newpath, newlen);
 
-  return rpmsgfs_send_recv(priv, RPMSGFS_RENAME, false,
-          (struct rpmsgfs_header_s *)msg, len, NULL);
+  return rpmsgfs_changed(priv,
+           rpmsgfs_send_recv(priv, RPMSGFS_RENAME, false,
+                             (struct rpmsgfs_header_s *)msg, len, NULL));
 }
 
 int rpmsgfs_client_stat(FAR void *handle, FAR const char *path,
@@ -953,8 +1010,10 @@ int rpmsgfs_client_fchstat(FAR void *handle, int fd,
     .fd               = fd,
   };
 
-  return rpmsgfs_send_recv(handle, RPMSGFS_FCHSTAT, true,
-          (struct rpmsgfs_header_s *)&msg, sizeof(msg), NULL);
+  return rpmsgfs_changed(handle,
+           rpmsgfs_send_recv(handle, RPMSGFS_FCHSTAT, true,
+                             (struct rpmsgfs_header_s *)&msg, sizeof(msg),
+                             NULL));
 }
 
 int rpmsgfs_client_chstat(FAR void *handle, FAR const char *path,
@@ -995,6 +1054,28 @@ int rpmsgfs_client_chstat(FAR void *handle, FAR const char *path,
 
   strlcpy(msg->pathname, path, space - sizeof(*msg));
 
-  return rpmsgfs_send_recv(priv, RPMSGFS_CHSTAT, false,
-          (struct rpmsgfs_header_s *)msg, len, NULL);
+  return rpmsgfs_changed(priv,
+           rpmsgfs_send_recv(priv, RPMSGFS_CHSTAT, false,
+                             (struct rpmsgfs_header_s *)msg, len, NULL));
+}
+
+#ifdef CONFIG_FS_RPMSGFS_CACHE
+void rpmsgfs_client_lease(FAR void *handle,
+                          FAR struct rpmsgfs_lease_s *lease)
+{
+  FAR struct rpmsgfs_s *priv = handle;
+
+  lease->generation = priv->generation;
+  lease->stamp      = clock_systime_ticks();
+}
+
+bool rpmsgfs_client_lease_valid(FAR void *handle,
+                                FAR const struct rpmsgfs_lease_s *lease)
+{
+  FAR struct rpmsgfs_s *priv = handle;
+
+  return lease->generation == priv->generation &&
+         clock_systime_ticks() - lease->stamp <
+         MSEC2TICK(CONFIG_FS_RPMSGFS_LEASE);
 }
+#endif
@@ -32,7 +32,9 @@
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/list.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/rptun/openamp.h>
 
@@ -45,11 +47,13 @@
 struct rpmsgfs_server_s
 {
   struct rpmsg_endpoint ept;
+  struct list_node      node;      /* Entry of g_rpmsgfs_servers */
   FAR struct file     **files;
   FAR void            **dirs;
   int                   file_rows;
   int                   dir_nums;
   mutex_t               lock;
+  bool                  leased;    /* The client may cache data */
 };
 
 /****************************************************************************
@@ -92,6 +96,9 @@ static int rpmsgfs_opendir_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
                                    FAR void *data, size_t len,
                                    uint32_t src, FAR void *priv);
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv);
 static int rpmsgfs_rewinddir_handler(FAR struct rpmsg_endpoint *ept,
                                      FAR void *data, size_t len,
                                      uint32_t src, FAR void *priv);
@@ -162,8 +169,15 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_fchstat_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_chstat_handler,
+  [RPMSGFS_READDIRS]  = rpmsgfs_readdirs_handler,
 };
 
+/* All of the clients, to break their leases */
+
+static struct list_node g_rpmsgfs_servers =
+  LIST_INITIAL_VALUE(g_rpmsgfs_servers);
+static mutex_t g_rpmsgfs_servers_lock = NXMUTEX_INITIALIZER;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -328,6 +342,61 @@ static FAR void *rpmsgfs_get_dir(
   return dir;
 }
 
+/* Get a tx buffer for the response to 'data' and copy the request header
+ * into it, so the handler fills the response in place and sends it with
+ * rpmsg_send_nocopy() instead of copying the rx buffer back.
+ */
+
+static FAR void *rpmsgfs_get_response(FAR struct rpmsg_endpoint *ept,
+                                      FAR const void *data,
+                                      FAR uint32_t *space)
+{
+  FAR void *rsp;
+
+  rsp = rpmsg_get_tx_payload_buffer(ept, space, true);
+  if (rsp != NULL)
+    {
+      memcpy(rsp, data, sizeof(struct rpmsgfs_header_s));
+    }
+
+  return rsp;
+}
+
+/* A client that got file data or attributes may cache them under a lease.
+ * A change to the file system through one client breaks the leases of all
+ * of the others, which cache nothing until they get data again.  The
+ * notification is not waited for: if it can not be sent, the lease still
+ * ends after its timeout.
+ */
+
+static void rpmsgfs_grant_lease(FAR struct rpmsgfs_server_s *priv)
+{
+  priv->leased = true;
+}
+
+static void rpmsgfs_break_leases(FAR struct rpmsgfs_server_s *priv)
+{
+  FAR struct rpmsgfs_server_s *server;
+  struct rpmsgfs_invalidate_s msg =
+  {
+    .command = RPMSGFS_INVALIDATE,
+  };
+
+  nxmutex_lock(&g_rpmsgfs_servers_lock);
+
+  list_for_every_entry(&g_rpmsgfs_servers, server,
+                       struct rpmsgfs_server_s, node)
+    {
+      if (server != priv && server->leased)
+        {
+          server->leased = false;
+          rpmsg_trysend(&server->ept, &msg, sizeof(msg));
+        }
+    }
+
+  nxmutex_unlock(&g_rpmsgfs_servers_lock);
+}
+
 static int rpmsgfs_open_handler(FAR struct rpmsg_endpoint *ept,
                                 FAR void *data, size_t len,
                                 uint32_t src, FAR void *priv)
@@ -346,6 +415,11 @@ static int rpmsgfs_open_handler(FAR struct rpmsg_endpoint *ept,
         }
     }
 
+  if ((msg->flags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      rpmsgfs_break_leases(priv);
+    }
+
   msg->header.result = ret;
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
@@ -380,6 +454,7 @@ static int rpmsgfs_read_handler(FAR struct rpmsg_endpoint *ept,
   uint32_t space;
 
   filep = rpmsgfs_get_file(priv, msg->fd);
+  rpmsgfs_grant_lease(priv);
 
   while (read < msg->count)
     {
@@ -439,6 +514,8 @@ static int rpmsgfs_write_handler(FAR struct rpmsg_endpoint *ept,
 
           written += ret;
         }
+
+      rpmsgfs_break_leases(priv);
     }
 
   if (msg->header.cookie != 0)
@@ -537,9 +614,17 @@ static int rpmsgfs_fstat_handler(FAR struct rpmsg_endpoint *ept,
                                  uint32_t src, FAR void *priv)
 {
   FAR struct rpmsgfs_fstat_s *msg = data;
+  FAR struct rpmsgfs_fstat_s *rsp;
   FAR struct file *filep;
   int ret = -ENOENT;
   struct stat buf;
+  uint32_t space;
+
+  rsp = rpmsgfs_get_response(ept, msg, &space);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
 
   filep = rpmsgfs_get_file(priv, msg->fd);
   if (filep != NULL)
@@ -547,27 +632,28 @@ static int rpmsgfs_fstat_handler(FAR struct rpmsg_endpoint *ept,
       ret = file_fstat(filep, &buf);
       if (ret >= 0)
         {
-          msg->buf.dev       = buf.st_dev;
-          msg->buf.ino       = buf.st_ino;
-          msg->buf.mode      = buf.st_mode;
-          msg->buf.nlink     = buf.st_nlink;
-          msg->buf.uid       = buf.st_uid;
-          msg->buf.gid       = buf.st_gid;
-          msg->buf.rdev      = buf.st_rdev;
-          msg->buf.size      = buf.st_size;
-          msg->buf.atim_sec  = buf.st_atim.tv_sec;
-          msg->buf.atim_nsec = buf.st_atim.tv_nsec;
-          msg->buf.mtim_sec  = buf.st_mtim.tv_sec;
-          msg->buf.mtim_nsec = buf.st_mtim.tv_nsec;
-          msg->buf.ctim_sec  = buf.st_ctim.tv_sec;
-          msg->buf.ctim_nsec = buf.st_ctim.tv_nsec;
-          msg->buf.blksize   = buf.st_blksize;
-          msg->buf.blocks    = buf.st_blocks;
+          rpmsgfs_grant_lease(priv);
+          rsp->buf.dev       = buf.st_dev;
+          rsp->buf.ino       = buf.st_ino;
+          rsp->buf.mode      = buf.st_mode;
+          rsp->buf.nlink     = buf.st_nlink;
+          rsp->buf.uid       = buf.st_uid;
+          rsp->buf.gid       = buf.st_gid;
+          rsp->buf.rdev      = buf.st_rdev;
+          rsp->buf.size      = buf.st_size;
+          rsp->buf.atim_sec  = buf.st_atim.tv_sec;
+          rsp->buf.atim_nsec = buf.st_atim.tv_nsec;
+          rsp->buf.mtim_sec  = buf.st_mtim.tv_sec;
+          rsp->buf.mtim_nsec = buf.st_mtim.tv_nsec;
+          rsp->buf.ctim_sec  = buf.st_ctim.tv_sec;
+          rsp->buf.ctim_nsec = buf.st_ctim.tv_nsec;
+          rsp->buf.blksize   = buf.st_blksize;
+          rsp->buf.blocks    = buf.st_blocks;
         }
     }
 
-  msg->header.result = ret;
-  return rpmsg_send(ept, msg, sizeof(*msg));
+  rsp->header.result = ret;
+  return rpmsg_send_nocopy(ept, rsp, sizeof(*rsp));
 }
 
 static int rpmsgfs_ftruncate_handler(FAR struct rpmsg_endpoint *ept,
@@ -582,6 +668,7 @@ static int rpmsgfs_ftruncate_handler(FAR struct rpmsg_endpoint *ept,
   if (filep != NULL)
     {
       ret = file_truncate(filep, msg->length);
+      rpmsgfs_break_leases(priv);
     }
 
   msg->header.result = ret;
@@ -615,29 +702,98 @@ static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
                                    uint32_t src, FAR void *priv)
 {
   FAR struct rpmsgfs_readdir_s *msg = data;
+  FAR struct rpmsgfs_readdir_s *rsp;
   FAR struct dirent *entry;
   int ret = -ENOENT;
   FAR void *dir;
+  uint32_t space;
   size_t size;
 
+  rsp = rpmsgfs_get_response(ept, msg, &space);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  len = sizeof(*rsp);
+  rsp->fd = msg->fd;
+
   dir = rpmsgfs_get_dir(priv, msg->fd);
   if (dir)
     {
       entry = readdir(dir);
       if (entry)
         {
-          size = MIN(rpmsg_get_tx_buffer_size(ept->rdev),
-                     rpmsg_get_rx_buffer_size(ept->rdev));
-          size = MIN(size - len, strlen(entry->d_name) + 1);
-          msg->type = entry->d_type;
-          strlcpy(msg->name, entry->d_name, size);
+          size = MIN(space - len, strlen(entry->d_name) + 1);
+          rsp->type = entry->d_type;
+          strlcpy(rsp->name, entry->d_name, size);
           len += size;
           ret = 0;
         }
     }
 
-  msg->header.result = ret;
-  return rpmsg_send(ept, msg, len);
+  rsp->header.result = ret;
+  return rpmsg_send_nocopy(ept, rsp, len);
+}
+
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_readdirs_s *msg = data;
+  FAR struct rpmsgfs_readdirs_s *rsp;
+  FAR struct rpmsgfs_dirent_s *dirent;
+  FAR struct dirent *entry;
+  int ret = -ENOENT;
+  FAR void *dir;
+  uint32_t space;
+  size_t namelen;
+  size_t reclen;
+  off_t pos;
+
+  rsp = rpmsgfs_get_response(ept, msg, &space);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  rsp->fd   = msg->fd;
+  rsp->size = msg->size;
+  space     = MIN(space - sizeof(*rsp), msg->size);
+
+  dir = rpmsgfs_get_dir(priv, msg->fd);
+  if (dir)
+    {
+      ret = 0;
+
+      while ((pos = telldir(dir)) >= 0 && (entry = readdir(dir)) != NULL)
+        {
+          namelen = strlen(entry->d_name) + 1;
+          reclen  = ALIGN_UP(sizeof(*dirent) + namelen, 4);
+          if (ret + reclen > space)
+            {
+              if (ret > 0 || space <= sizeof(*dirent))
+                {
+                  /* Leave the entry to the next request */
+
+                  seekdir(dir, pos);
+                  break;
+                }
+
+              namelen = space - sizeof(*dirent);
+              reclen  = space;
+            }
+
+          dirent         = (FAR struct rpmsgfs_dirent_s *)(rsp->buf + ret);
+          dirent->type   = entry->d_type;
+          dirent->reclen = reclen;
+          strlcpy(dirent->name, entry->d_name, namelen);
+          ret           += reclen;
+        }
+    }
+
+  rsp->header.result = ret;
+  return rpmsg_send_nocopy(ept, rsp, sizeof(*rsp) + MAX(ret, 0));
 }
 
 static int rpmsgfs_rewinddir_handler(FAR struct rpmsg_endpoint *ept,
@@ -682,9 +838,17 @@ static int rpmsgfs_statfs_handler(FAR struct rpmsg_endpoint *ept,
                                   uint32_t src, FAR void *priv)
 {
   FAR struct rpmsgfs_statfs_s *msg = data;
+  FAR struct rpmsgfs_statfs_s *rsp;
   struct statfs buf;
+  uint32_t space;
   int ret;
 
+  rsp = rpmsgfs_get_response(ept, msg, &space);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
+
   ret = statfs(msg->pathname, &buf);
   if (ret)
     {
@@ -692,18 +856,18 @@ static int rpmsgfs_statfs_handler(FAR struct rpmsg_endpoint *ept,
     }
   else
     {
-      msg->type    = buf.f_type;
-      msg->namelen = buf.f_namelen;
-      msg->bsize   = buf.f_bsize;
-      msg->blocks  = buf.f_blocks;
-      msg->bfree   = buf.f_bfree;
-      msg->bavail  = buf.f_bavail;
-      msg->files   = buf.f_files;
-      msg->ffree   = buf.f_ffree;
+      rsp->type    = buf.f_type;
+      rsp->namelen = buf.f_namelen;
+      rsp->bsize   = buf.f_bsize;
+      rsp->blocks  = buf.f_blocks;
+      rsp->bfree   = buf.f_bfree;
+      rsp->bavail  = buf.f_bavail;
+      rsp->files   = buf.f_files;
+      rsp->ffree   = buf.f_ffree;
     }
 
-  msg->header.result = ret;
-  return rpmsg_send(ept, msg, sizeof(*msg));
+  rsp->header.result = ret;
+  return rpmsg_send_nocopy(ept, rsp, sizeof(*rsp));
 }
 
 static int rpmsgfs_unlink_handler(FAR struct rpmsg_endpoint *ept,
@@ -713,6 +877,7 @@ static int rpmsgfs_unlink_handler(FAR struct rpmsg_endpoint *ept,
   FAR struct rpmsgfs_unlink_s *msg = data;
 
   msg->header.result = nx_unlink(msg->pathname);
+  rpmsgfs_break_leases(priv);
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
 
@@ -725,6 +890,7 @@ static int rpmsgfs_mkdir_handler(FAR struct rpmsg_endpoint *ept,
 
   ret = mkdir(msg->pathname, msg->mode);
   msg->header.result = ret ? -get_errno() : 0;
+  rpmsgfs_break_leases(priv);
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
 
@@ -737,6 +903,7 @@ static int rpmsgfs_rmdir_handler(FAR struct rpmsg_endpoint *ept,
 
   ret = rmdir(msg->pathname);
   msg->header.result = ret ? -get_errno() : 0;
+  rpmsgfs_break_leases(priv);
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
 
@@ -754,6 +921,7 @@ static int rpmsgfs_rename_handler(FAR struct rpmsg_endpoint *ept,
 
   ret = rename(msg->pathname, newpath);
   msg->header.result = ret ? -get_errno() : 0;
+  rpmsgfs_break_leases(priv);
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
 
@@ -762,32 +930,41 @@ static int rpmsgfs_stat_handler(FAR struct rpmsg_endpoint *ept,
                                 uint32_t src, FAR void *priv)
 {
   FAR struct rpmsgfs_stat_s *msg = data;
+  FAR struct rpmsgfs_stat_s *rsp;
   struct stat buf;
+  uint32_t space;
   int ret;
 
+  rsp = rpmsgfs_get_response(ept, msg, &space);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
+
   ret = nx_stat(msg->pathname, &buf, 1);
+  rpmsgfs_grant_lease(priv);
   if (ret >= 0)
     {
-      msg->buf.dev       = buf.st_dev;
-      msg->buf.ino       = buf.st_ino;
-      msg->buf.mode      = buf.st_mode;
-      msg->buf.nlink     = buf.st_nlink;
-      msg->buf.uid       = buf.st_uid;
-      msg->buf.gid       = buf.st_gid;
-      msg->buf.rdev      = buf.st_rdev;
-      msg->buf.size      = buf.st_size;
-      msg->buf.atim_sec  = buf.st_atim.tv_sec;
-      msg->buf.atim_nsec = buf.st_atim.tv_nsec;
-      msg->buf.mtim_sec  = buf.st_mtim.tv_sec;
-      msg->buf.mtim_nsec = buf.st_mtim.tv_nsec;
-      msg->buf.ctim_sec  = buf.st_ctim.tv_sec;
-      msg->buf.ctim_nsec = buf.st_ctim.tv_nsec;
-      msg->buf.blksize   = buf.st_blksize;
-      msg->buf.blocks    = buf.st_blocks;
+      rsp->buf.dev       = buf.st_dev;
+      rsp->buf.ino       = buf.st_ino;
+      rsp->buf.mode      = buf.st_mode;
+      rsp->buf.nlink     = buf.st_nlink;
+      rsp->buf.uid       = buf.st_uid;
+      rsp->buf.gid       = buf.st_gid;
+      rsp->buf.rdev      = buf.st_rdev;
+      rsp->buf.size      = buf.st_size;
+      rsp->buf.atim_sec  = buf.st_atim.tv_sec;
+      rsp->buf.atim_nsec = buf.st_atim.tv_nsec;
+      rsp->buf.mtim_sec  = buf.st_mtim.tv_sec;
+      rsp->buf.mtim_nsec = buf.st_mtim.tv_nsec;
+      rsp->buf.ctim_sec  = buf.st_ctim.tv_sec;
+      rsp->buf.ctim_nsec = buf.st_ctim.tv_nsec;
+      rsp->buf.blksize   = buf.st_blksize;
+      rsp->buf.blocks    = buf.st_blocks;
     }
 
-  msg->header.result = ret;
-  return rpmsg_send(ept, msg, sizeof(*msg));
+  rsp->header.result = ret;
+  return rpmsg_send_nocopy(ept, rsp, sizeof(*rsp));
 }
 
 static int rpmsgfs_fchstat_handler(FAR struct rpmsg_endpoint *ept,
@@ -820,6 +997,7 @@ static int rpmsgfs_fchstat_handler(FAR struct rpmsg_endpoint *ept,
       buf.st_blocks       = msg->buf.blocks;
 
       ret = file_fchstat(filep, &buf, msg->flags);
+      rpmsgfs_break_leases(priv);
     }
 
   msg->header.result = ret;
@@ -887,6 +1065,7 @@ static int rpmsgfs_chstat_handler(FAR struct rpmsg_endpoint *ept,
     }
 
 out:
+  rpmsgfs_break_leases(priv);
   msg->header.result = ret;
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
@@ -921,7 +1100,12 @@ static void rpmsgfs_ns_bind(FAR struct rpmsg_device *rdev,
     {
       nxmutex_destroy(&priv->lock);
       kmm_free(priv);
+      return;
     }
+
+  nxmutex_lock(&g_rpmsgfs_servers_lock);
+  list_add_tail(&g_rpmsgfs_servers, &priv->node);
+  nxmutex_unlock(&g_rpmsgfs_servers_lock);
 }
 
 static void rpmsgfs_ns_unbind(FAR struct rpmsg_endpoint *ept)
@@ -930,6 +1114,10 @@ static void rpmsgfs_ns_unbind(FAR struct rpmsg_endpoint *ept)
   int i;
   int j;
 
+  nxmutex_lock(&g_rpmsgfs_servers_lock);
+  list_delete(&priv->node);
+  nxmutex_unlock(&g_rpmsgfs_servers_lock);
+
   for (i = 0; i < priv->file_rows; i++)
     {
       for (j = 0; j < CONFIG_NFILE_DESCRIPTORS_PER_BLOCK; j++)
@@ -30,8 +30,10 @@
 #include <nuttx/mm/mm.h>
 
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <assert.h>
 #include <fcntl.h>
+#include <string.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -47,10 +49,14 @@ static ssize_t sock_file_read(FAR struct file *filep, FAR char *buffer,
                               size_t buflen);
 static ssize_t sock_file_write(FAR struct file *filep,
                                FAR const char *buffer, size_t buflen);
+static ssize_t sock_file_writev(FAR struct file *filep,
+                                FAR const struct iovec *iov, int iovcnt);
 static int sock_file_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg);
 static int sock_file_poll(FAR struct file *filep, struct pollfd *fds,
                           bool setup);
+static int sock_file_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map);
 static int sock_file_truncate(FAR struct file *filep, off_t length);
 
 /****************************************************************************
@@ -65,9 +71,14 @@ static const struct file_operations g_sock_fileops =
   sock_file_write,    /* write */
   NULL,               /* seek */
   sock_file_ioctl,    /* ioctl */
-  NULL,               /* mmap */
+  sock_file_mmap,     /* mmap */
   sock_file_truncate, /* truncate */
-  sock_file_poll      /* poll */
+  sock_file_poll,     /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  NULL,               /* unlink */
+#endif
+  NULL,               /* readv */
+  sock_file_writev    /* writev */
 };
 
 static struct inode g_sock_inode =
@@ -129,6 +140,58 @@ static ssize_t sock_file_write(FAR struct file *filep,
   return psock_send(filep->f_priv, buffer, buflen, 0);
 }
 
+static ssize_t sock_file_writev(FAR struct file *filep,
+                                FAR const struct iovec *iov, int iovcnt)
+{
+  struct msghdr msg;
+  ssize_t nsent = 0;
+  ssize_t ret;
+  int i;
+
+  if (iovcnt == 0)
+    {
+      return 0;
+    }
+
+  /* A gathered write is one sendmsg(), i.e. one datagram on message
+   * oriented sockets.
+   */
+
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov    = (FAR struct iovec *)iov;
+  msg.msg_iovlen = iovcnt;
+
+  ret = psock_sendmsg(filep->f_priv, &msg, 0);
+  if (ret != -ENOTSUP)
+    {
+      return ret;
+    }
+
+  /* The address family sends one segment at a time only */
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      ret = psock_send(filep->f_priv, iov[i].iov_base, iov[i].iov_len, 0);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      nsent += ret;
+      if ((size_t)ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return nsent > 0 ? nsent : ret;
+}
+
 static int sock_file_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg)
 {
@@ -141,6 +204,19 @@ static int sock_file_poll(FAR struct file *filep, FAR struct pollfd *fds,
   return psock_poll(filep->f_priv, fds, setup);
 }
 
+static int sock_file_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map)
+{
+  FAR struct socket *psock = filep->f_priv;
+
+  if (psock->s_sockif == NULL || psock->s_sockif->si_mmap == NULL)
+    {
+      return -ENODEV;
+    }
+
+  return psock->s_sockif->si_mmap(psock, map);
+}
+
 static int sock_file_truncate(FAR struct file *filep, off_t length)
 {
   return -EINVAL;
@@ -51,10 +51,16 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
+#if !defined(CONFIG_FS_TMPFS_PAGED) && \
+    CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
 #  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
+#if defined(CONFIG_FS_TMPFS_PAGED) && \
+    (TMPFS_PAGESIZE & (TMPFS_PAGESIZE - 1)) != 0
+#  error CONFIG_FS_TMPFS_PAGESIZE must be a power of two
+#endif
+
 #define tmpfs_lock(fs) \
            nxrmutex_lock(&fs->tfs_lock)
 #define tmpfs_lock_object(to) \
@@ -93,6 +99,13 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+#ifdef CONFIG_FS_TMPFS_PAGED
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo);
+static void tmpfs_read_pages(FAR struct tmpfs_file_s *tfo,
+              FAR char *buffer, size_t pos, size_t len);
+static int  tmpfs_write_pages(FAR struct tmpfs_file_s *tfo,
+              FAR const char *buffer, size_t pos, size_t len);
+#endif
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
@@ -267,6 +280,182 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
  * Name: tmpfs_realloc_file
  ****************************************************************************/
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
+                              size_t newsize)
+{
+  FAR uint8_t **newpages;
+  size_t npages = TMPFS_NPAGES(newsize);
+  size_t count;
+  size_t i;
+
+  if (newsize < tfo->tfo_size)
+    {
+      /* Shrinking ... Free the pages past the new end of the file */
+
+      for (i = npages; i < tfo->tfo_npages; i++)
+        {
+          if (tfo->tfo_pages[i] != NULL)
+            {
+              fs_heap_free(tfo->tfo_pages[i]);
+              tfo->tfo_pages[i] = NULL;
+              tfo->tfo_alloc -= TMPFS_PAGESIZE;
+            }
+        }
+
+      /* And zero the rest of the last page so that growing the file again
+       * exposes zeros.
+       */
+
+      if (TMPFS_PAGEOFF(newsize) != 0 && tfo->tfo_pages[npages - 1] != NULL)
+        {
+          memset(tfo->tfo_pages[npages - 1] + TMPFS_PAGEOFF(newsize), 0,
+                 TMPFS_PAGESIZE - TMPFS_PAGEOFF(newsize));
+        }
+
+      if (npages == 0)
+        {
+          fs_heap_free(tfo->tfo_pages);
+          tfo->tfo_pages  = NULL;
+          tfo->tfo_npages = 0;
+        }
+    }
+  else if (npages > tfo->tfo_npages)
+    {
+      /* Growing past the page table ... Double its size, the data pages
+       * are only allocated when they are written.
+       */
+
+      count = tfo->tfo_npages * 2;
+      if (count < npages)
+        {
+          count = npages;
+        }
+
+      if (count > SIZE_MAX / sizeof(FAR uint8_t *))
+        {
+          return -ENOMEM;
+        }
+
+      newpages = fs_heap_realloc(tfo->tfo_pages,
+                                 count * sizeof(FAR uint8_t *));
+      if (newpages == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      memset(&newpages[tfo->tfo_npages], 0,
+             (count - tfo->tfo_npages) * sizeof(FAR uint8_t *));
+      tfo->tfo_pages  = newpages;
+      tfo->tfo_npages = count;
+    }
+
+  tfo->tfo_size = newsize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_pages
+ ****************************************************************************/
+
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo)
+{
+  size_t i;
+
+  for (i = 0; i < tfo->tfo_npages; i++)
+    {
+      fs_heap_free(tfo->tfo_pages[i]);
+    }
+
+  fs_heap_free(tfo->tfo_pages);
+  tfo->tfo_pages  = NULL;
+  tfo->tfo_npages = 0;
+  tfo->tfo_alloc  = 0;
+}
+
+/****************************************************************************
+ * Name: tmpfs_read_pages
+ *
+ * Description:
+ *   Copy file data out of the pages.  Holes read as zeros.
+ *
+ ****************************************************************************/
+
+static void tmpfs_read_pages(FAR struct tmpfs_file_s *tfo,
+                             FAR char *buffer, size_t pos, size_t len)
+{
+  FAR uint8_t *page;
+  size_t nbytes;
+
+  while (len > 0)
+    {
+      page   = tfo->tfo_pages[TMPFS_PAGE(pos)];
+      nbytes = TMPFS_PAGESIZE - TMPFS_PAGEOFF(pos);
+      if (nbytes > len)
+        {
+          nbytes = len;
+        }
+
+      if (page != NULL)
+        {
+          memcpy(buffer, page + TMPFS_PAGEOFF(pos), nbytes);
+        }
+      else
+        {
+          memset(buffer, 0, nbytes);
+        }
+
+      buffer += nbytes;
+      pos    += nbytes;
+      len    -= nbytes;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_write_pages
+ *
+ * Description:
+ *   Copy file data into the pages, allocating the missing ones.  The page
+ *   table must already cover the range.
+ *
+ ****************************************************************************/
+
+static int tmpfs_write_pages(FAR struct tmpfs_file_s *tfo,
+                             FAR const char *buffer, size_t pos, size_t len)
+{
+  FAR uint8_t **page;
+  size_t nbytes;
+
+  while (len > 0)
+    {
+      page = &tfo->tfo_pages[TMPFS_PAGE(pos)];
+      if (*page == NULL)
+        {
+          *page = fs_heap_zalloc(TMPFS_PAGESIZE);
+          if (*page == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          tfo->tfo_alloc += TMPFS_PAGESIZE;
+        }
+
+      nbytes = TMPFS_PAGESIZE - TMPFS_PAGEOFF(pos);
+      if (nbytes > len)
+        {
+          nbytes = len;
+        }
+
+      memcpy(*page + TMPFS_PAGEOFF(pos), buffer, nbytes);
+
+      buffer += nbytes;
+      pos    += nbytes;
+      len    -= nbytes;
+    }
+
+  return OK;
+}
+#else
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
                               size_t newsize)
 {
@@ -340,6 +529,7 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
   tfo->tfo_data  = newdata;
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
@@ -378,7 +568,11 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
+#ifdef CONFIG_FS_TMPFS_PAGED
+      tmpfs_free_pages(tfo);
+#else
       fs_heap_free(tfo->tfo_data);
+#endif
       fs_heap_free(tfo);
     }
 
@@ -577,7 +771,12 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_parent = parent;
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tfo->tfo_npages = 0;
+  tfo->tfo_pages  = NULL;
+#else
   tfo->tfo_data   = NULL;
+#endif
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -1176,7 +1375,11 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 
       tmptfo             = (FAR struct tmpfs_file_s *)to;
       tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s);
-      tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+      if (to->to_alloc > tmptfo->tfo_size)
+        {
+          tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+        }
+
       tmpbuf->tsf_files++;
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
@@ -1252,7 +1455,11 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+      tmpfs_free_pages(tfo);
+#else
       fs_heap_free(tfo->tfo_data);
+#endif
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1573,6 +1780,10 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tmpfs_read_pages(tfo, buffer, startpos, nread);
+  filep->f_pos += nread;
+#else
   if (tfo->tfo_data != NULL)
     {
       memcpy(buffer, &tfo->tfo_data[startpos], nread);
@@ -1582,6 +1793,7 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
     {
       DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
     }
+#endif
 
   /* Release the lock on the file */
 
@@ -1600,6 +1812,9 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+#ifdef CONFIG_FS_TMPFS_PAGED
+  size_t oldsize;
+#endif
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1631,6 +1846,9 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   nwritten = buflen;
   endpos   = startpos + buflen;
+#ifdef CONFIG_FS_TMPFS_PAGED
+  oldsize  = tfo->tfo_size;
+#endif
 
   if (endpos > tfo->tfo_size)
     {
@@ -1645,6 +1863,20 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+  ret = tmpfs_write_pages(tfo, buffer, startpos, nwritten);
+  if (ret < 0)
+    {
+      /* Out of memory: Do not leave the file extended */
+
+      if (oldsize < tfo->tfo_size)
+        {
+          tmpfs_realloc_file(tfo, oldsize);
+        }
+
+      goto errout_with_lock;
+    }
+#else
   if (tfo->tfo_data != NULL)
     {
       memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
@@ -1653,6 +1885,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
     {
       DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
     }
+#endif
 
   filep->f_pos = endpos;
 
@@ -1772,22 +2005,72 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 
   DEBUGASSERT(tfo != NULL);
 
+  /* The size and the page table may change while the file is not locked */
+
+  ret = tmpfs_lock_file(tfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = -EINVAL;
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
+#ifdef CONFIG_FS_TMPFS_PAGED
+      FAR uint8_t **page;
+
+      /* Only a range within one page is contiguous in memory.  Let the
+       * caller copy the file otherwise.
+       */
+
+      if (TMPFS_PAGE(map->offset) !=
+          TMPFS_PAGE(map->offset + map->length - 1))
+        {
+          ret = -ENOTTY;
+          goto errout_with_lock;
+        }
+
+      page = &tfo->tfo_pages[TMPFS_PAGE(map->offset)];
+      if (*page == NULL)
+        {
+          *page = fs_heap_zalloc(TMPFS_PAGESIZE);
+          if (*page == NULL)
+            {
+              ret = -ENOMEM;
+              goto errout_with_lock;
+            }
+
+          tfo->tfo_alloc += TMPFS_PAGESIZE;
+        }
+
+      map->vaddr = *page + TMPFS_PAGEOFF(map->offset);
+#else
       map->vaddr = tfo->tfo_data + map->offset;
+#endif
       map->priv.p = tfo;
       map->munmap = tmpfs_unmap;
-      ret = mm_map_add(get_current_mm(), map);
 
-      if (ret >= 0)
+      /* munmap() takes the lock of the file with the lock of the mappings
+       * held, so add the mapping with a reference but without the lock.
+       */
+
+      tfo->tfo_refs++;
+      tmpfs_unlock_file(tfo);
+
+      ret = mm_map_add(get_current_mm(), map);
+      if (ret < 0)
         {
-          tmpfs_lock_file(tfo);
-          tfo->tfo_refs++;
-          tmpfs_unlock_file(tfo);
+          tmpfs_release_file(tfo);
         }
+
+      return ret;
     }
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+errout_with_lock:
+#endif
+  tmpfs_unlock_file(tfo);
   return ret;
 }
 
@@ -1956,14 +2239,16 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
           goto errout_with_lock;
         }
 
+#ifndef CONFIG_FS_TMPFS_PAGED
       /* If the size has increased, then we need to zero the newly added
-       * memory.
+       * memory.  Pages are kept zeroed past the end of file instead.
        */
 
       if (length > oldsize)
         {
           memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
         }
+#endif
 
       ret = OK;
     }
@@ -2406,7 +2691,11 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
+#ifdef CONFIG_FS_TMPFS_PAGED
+      tmpfs_free_pages(tfo);
+#else
       fs_heap_free(tfo->tfo_data);
+#endif
       fs_heap_free(tfo);
     }
 
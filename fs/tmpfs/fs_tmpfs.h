@@ -40,6 +40,15 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* Paged file storage */
+
+#ifdef CONFIG_FS_TMPFS_PAGED
+#  define TMPFS_PAGESIZE    CONFIG_FS_TMPFS_PAGESIZE
+#  define TMPFS_PAGE(o)     ((o) / TMPFS_PAGESIZE)
+#  define TMPFS_PAGEOFF(o)  ((o) & (TMPFS_PAGESIZE - 1))
+#  define TMPFS_NPAGES(s)   (((s) + TMPFS_PAGESIZE - 1) / TMPFS_PAGESIZE)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -103,7 +112,9 @@ struct tmpfs_directory_s
 
 #define SIZEOF_TMPFS_DIRECTORY(n) ((n) * sizeof(struct tmpfs_dirent_s))
 
-/* The form of a regular file memory object
+/* The form of a regular file memory object.  With CONFIG_FS_TMPFS_PAGED,
+ * tfo_alloc counts the bytes of the allocated pages and the bytes of the
+ * pages past tfo_size are always zero.
  *
  * NOTE that in this very simplified implementation, there is no per-open
  * state.  The file memory object also serves as the open file object,
@@ -126,7 +137,12 @@ struct tmpfs_file_s
 
   uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
   size_t        tfo_size;  /* Valid file size */
+#ifdef CONFIG_FS_TMPFS_PAGED
+  size_t        tfo_npages; /* Number of entries in tfo_pages */
+  FAR uint8_t **tfo_pages;  /* File data pages, NULL for holes */
+#else
   FAR uint8_t  *tfo_data;  /* File data starts here */
+#endif
 };
 
 /* This structure represents one instance of a TMPFS file system */
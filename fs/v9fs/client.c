@@ -294,6 +294,17 @@ begin_packed_struct struct v9fs_rwrite_s
 #define v9fs_readdir_s v9fs_write_s
 #define v9fs_rreaddir_s v9fs_rwrite_s
 
+/* One of the Tread or Twrite requests of a transfer */
+
+struct v9fs_io_s
+{
+  struct v9fs_payload_s payload;
+  struct v9fs_write_s   request;
+  struct v9fs_rwrite_s  response;
+  struct iovec          wiov[2];
+  struct iovec          riov[2];
+};
+
 begin_packed_struct struct v9fs_fsync_s
 {
   struct v9fs_header_s header;
@@ -534,6 +545,51 @@ static void v9fs_fid_destroy(FAR struct v9fs_client_s *client,
   kmm_free(fidp);
 }
 
+/****************************************************************************
+ * v9fs_client_submit
+ ****************************************************************************/
+
+static int v9fs_client_submit(FAR struct v9fs_transport_s *transport,
+                              FAR struct v9fs_payload_s *payload,
+                              FAR struct iovec *wiov, size_t wcount,
+                              FAR struct iovec *riov, size_t rcount,
+                              uint16_t tag)
+{
+  int ret;
+
+  nxsem_init(&payload->resp, 0, 0);
+  payload->wiov = wiov;
+  payload->riov = riov;
+  payload->wcount = wcount;
+  payload->rcount = rcount;
+  payload->tag = tag;
+  payload->ret = -EIO;
+
+  ret = v9fs_transport_request(transport, payload);
+  if (ret < 0)
+    {
+      nxsem_destroy(&payload->resp);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * v9fs_client_wait
+ ****************************************************************************/
+
+static int v9fs_client_wait(FAR struct v9fs_payload_s *payload)
+{
+  /* The transport owns the payload and its buffers until the response
+   * arrives, so the wait must not be interrupted.
+   */
+
+  nxsem_wait_uninterruptible(&payload->resp);
+  nxsem_destroy(&payload->resp);
+
+  return payload->ret;
+}
+
 /****************************************************************************
  * v9fs_client_rpc
  ****************************************************************************/
@@ -546,25 +602,149 @@ static int v9fs_client_rpc(FAR struct v9fs_transport_s *transport,
   struct v9fs_payload_s payload;
   int ret;
 
-  nxsem_init(&payload.resp, 0, 0);
-  payload.wiov = wiov;
-  payload.riov = riov;
-  payload.wcount = wcount;
-  payload.rcount = rcount;
-  payload.tag = tag;
-  payload.ret = -EIO;
-
-  ret = v9fs_transport_request(transport, &payload);
+  ret = v9fs_client_submit(transport, &payload, wiov, wcount,
+                           riov, rcount, tag);
   if (ret < 0)
     {
-      nxsem_destroy(&payload.resp);
       return ret;
     }
 
-  nxsem_wait(&payload.resp);
-  nxsem_destroy(&payload.resp);
+  return v9fs_client_wait(&payload);
+}
+
+/****************************************************************************
+ * v9fs_client_submitio
+ *
+ * Description:
+ *   Queue one Tread or Twrite of at most one I/O unit.  The data moves
+ *   directly between the caller buffer and the transport.
+ *
+ ****************************************************************************/
+
+static int v9fs_client_submitio(FAR struct v9fs_client_s *client,
+                                FAR struct v9fs_io_s *io, uint32_t fid,
+                                bool write, FAR uint8_t *buffer,
+                                off_t offset, size_t count)
+{
+  /* size[4] Tread tag[2] fid[4] offset[8] count[4]
+   * size[4] Rread tag[2] count[4] data[count]
+   *
+   * size[4] Twrite tag[2] fid[4] offset[8] count[4] data[count]
+   * size[4] Rwrite tag[2] count[4]
+   */
+
+  io->request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
+                            V9FS_BIT32SZ;
+  io->request.header.type = write ? V9FS_TWRITE : V9FS_TREAD;
+  io->request.header.tag = v9fs_get_tagid(client);
+  io->request.fid = fid;
+  io->request.offset = offset;
+  io->request.count = count;
+
+  io->wiov[0].iov_base = &io->request;
+  io->wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
+                        V9FS_BIT32SZ;
+  io->riov[0].iov_base = &io->response;
+  io->riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
+
+  if (write)
+    {
+      io->request.header.size += count;
+      io->wiov[1].iov_base = buffer;
+      io->wiov[1].iov_len = count;
+      return v9fs_client_submit(client->transport, &io->payload,
+                                io->wiov, 2, io->riov, 1,
+                                io->request.header.tag);
+    }
+
+  io->riov[1].iov_base = buffer;
+  io->riov[1].iov_len = count;
+  return v9fs_client_submit(client->transport, &io->payload,
+                            io->wiov, 1, io->riov, 2,
+                            io->request.header.tag);
+}
+
+/****************************************************************************
+ * v9fs_client_transfer
+ *
+ * Description:
+ *   Read or write with up to CONFIG_V9FS_NREQUESTS requests in flight.
+ *   The responses are consumed in order; a failed or short transfer ends
+ *   the operation and the requests after it are discarded.
+ *
+ ****************************************************************************/
+
+static ssize_t v9fs_client_transfer(FAR struct v9fs_client_s *client,
+                                    uint32_t fid, FAR uint8_t *buffer,
+                                    off_t offset, size_t buflen,
+                                    bool write)
+{
+  struct v9fs_io_s io[CONFIG_V9FS_NREQUESTS];
+  FAR struct v9fs_fid_s *fidp;
+  size_t ndone = 0;
+  size_t queued;
+  bool stop = false;
+  int ret = 0;
+  int tmp;
+  int n;
+  int i;
+
+  fidp = idr_find(client->fids, fid);
+  if (fidp == NULL)
+    {
+      return -ENOENT;
+    }
+
+  while (ndone < buflen && !stop)
+    {
+      for (n = 0, queued = ndone; n < CONFIG_V9FS_NREQUESTS &&
+                                  queued < buflen; n++)
+        {
+          tmp = v9fs_client_submitio(client, &io[n], fid, write,
+                                     buffer + queued, offset + queued,
+                                     MIN(buflen - queued, fidp->iounit));
+          if (tmp < 0)
+            {
+              ret = tmp;
+              stop = true;
+              break;
+            }
+
+          queued += io[n].request.count;
+        }
+
+      for (i = 0; i < n; i++)
+        {
+          /* Skip the responses that follow a failed or short one */
+
+          tmp = v9fs_client_wait(&io[i].payload);
+          if (ndone != io[i].request.offset - offset)
+            {
+              continue;
+            }
 
-  return payload.ret;
+          if (tmp < 0)
+            {
+              ret = tmp;
+              stop = true;
+            }
+          else if (io[i].response.count > io[i].request.count)
+            {
+              ret = -EIO;
+              stop = true;
+            }
+          else
+            {
+              ndone += io[i].response.count;
+              if (io[i].response.count < io[i].request.count)
+                {
+                  stop = true;
+                }
+            }
+        }
+    }
+
+  return ndone ? ndone : ret;
 }
 
 /****************************************************************************
@@ -858,6 +1038,7 @@ int v9fs_client_chstat(FAR struct v9fs_client_s *client, uint32_t fid,
   struct v9fs_lerror_s response;
   struct iovec wiov[1];
   struct iovec riov[1];
+  int ret;
 
   /* size[4] Tsetattr tag[2] fid[4] valid[4] mode[4] uid[4] gid[4] size[8]
    *                  atime_sec[8] atime_nsec[8] mtime_sec[8] mtime_nsec[8]
@@ -888,8 +1069,10 @@ int v9fs_client_chstat(FAR struct v9fs_client_s *client, uint32_t fid,
   riov[0].iov_base = &response;
   riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
 
-  return v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
-                         request.header.tag);
+  ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
+                        request.header.tag);
+  v9fs_cache_invalidate(client);
+  return ret;
 }
 
 /****************************************************************************
@@ -899,61 +1082,7 @@ int v9fs_client_chstat(FAR struct v9fs_client_s *client, uint32_t fid,
 ssize_t v9fs_client_read(FAR struct v9fs_client_s *client, uint32_t fid,
                          FAR void *buffer, off_t offset, size_t buflen)
 {
-  FAR struct v9fs_fid_s *fidp;
-  struct v9fs_read_s request;
-  struct v9fs_rread_s response;
-  struct iovec wiov[1];
-  struct iovec riov[2];
-  size_t nread = 0;
-  int ret = 0;
-
-  /* size[4] Tread tag[2] fid[4] offset[8] count[4]
-   * size[4] Rread tag[2] count[4] data[count]
-   */
-
-  fidp = idr_find(client->fids, fid);
-  if (fidp == NULL)
-    {
-      return -ENOENT;
-    }
-
-  while (buflen > 0)
-    {
-      request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                            V9FS_BIT32SZ;
-      request.header.type = V9FS_TREAD;
-      request.header.tag = v9fs_get_tagid(client);
-      request.fid = fid;
-      request.offset = offset;
-      request.count = buflen > fidp->iounit ? fidp->iounit : buflen;
-
-      wiov[0].iov_base = &request;
-      wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                        V9FS_BIT32SZ;
-      riov[0].iov_base = &response;
-      riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
-      riov[1].iov_base = (FAR void *)buffer;
-      riov[1].iov_len = request.count;
-
-      ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 2,
-                            request.header.tag);
-      if (ret < 0)
-        {
-          break;
-        }
-
-      if (response.count == 0)
-        {
-          break;
-        }
-
-      nread += response.count;
-      offset += response.count;
-      buffer += response.count;
-      buflen -= response.count;
-    }
-
-  return nread ? nread : ret;
+  return v9fs_client_transfer(client, fid, buffer, offset, buflen, false);
 }
 
 /****************************************************************************
@@ -1075,56 +1204,12 @@ ssize_t v9fs_client_write(FAR struct v9fs_client_s *client, uint32_t fid,
                           FAR const void *buffer, off_t offset,
                           size_t buflen)
 {
-  FAR struct v9fs_fid_s *fidp;
-  struct v9fs_write_s request;
-  struct v9fs_rwrite_s response;
-  struct iovec wiov[2];
-  struct iovec riov[1];
-  size_t nwrite = 0;
-  int ret = 0;
-
-  /* size[4] Twrite tag[2] fid[4] offset[8] count[4] data[count]
-   * size[4] Rwrite tag[2] count[4]
-   */
-
-  fidp = idr_find(client->fids, fid);
-  if (fidp == NULL)
-    {
-      return -ENOENT;
-    }
-
-  while (buflen > 0)
-    {
-      request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                            V9FS_BIT32SZ + request.count;
-      request.header.type = V9FS_TWRITE;
-      request.header.tag = v9fs_get_tagid(client);
-      request.fid = fid;
-      request.offset = offset;
-      request.count = buflen > fidp->iounit ? fidp->iounit : buflen;
+  ssize_t ret;
 
-      wiov[0].iov_base = &request;
-      wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                        V9FS_BIT32SZ;
-      wiov[1].iov_base = (FAR void *)buffer;
-      wiov[1].iov_len = request.count;
-      riov[0].iov_base = &response;
-      riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
-
-      ret = v9fs_client_rpc(client->transport, wiov, 2, riov, 1,
-                            request.header.tag);
-      if (ret < 0)
-        {
-          break;
-        }
-
-      nwrite += response.count;
-      offset += response.count;
-      buffer += response.count;
-      buflen -= response.count;
-    }
-
-  return nwrite ? nwrite : ret;
+  ret = v9fs_client_transfer(client, fid, (FAR uint8_t *)buffer, offset,
+                             buflen, true);
+  v9fs_cache_invalidate(client);
+  return ret;
 }
 
 /****************************************************************************
@@ -1170,6 +1255,7 @@ int v9fs_client_rename(FAR struct v9fs_client_s *client, uint32_t fid,
   struct v9fs_lerror_s response;
   struct iovec wiov[1];
   struct iovec riov[1];
+  int ret;
 
   /* size[4] Trename tag[2] fid[4] dfid[4] name[s]
    * size[4] Rrename tag[2]
@@ -1190,8 +1276,10 @@ int v9fs_client_rename(FAR struct v9fs_client_s *client, uint32_t fid,
   riov[0].iov_base = &response;
   riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
 
-  return v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
-                         request.header.tag);
+  ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
+                        request.header.tag);
+  v9fs_cache_invalidate(client);
+  return ret;
 }
 
 /****************************************************************************
@@ -1204,6 +1292,7 @@ int v9fs_client_remove(FAR struct v9fs_client_s *client, uint32_t fid)
   struct v9fs_lerror_s response;
   struct iovec wiov[1];
   struct iovec riov[1];
+  int ret;
 
   /* size[4] Tremove tag[2] fid[4]
    * size[4] Rremove tag[2]
@@ -1223,8 +1312,10 @@ int v9fs_client_remove(FAR struct v9fs_client_s *client, uint32_t fid)
   riov[0].iov_base = &response;
   riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
 
-  return v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
-                         request.header.tag);
+  ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
+                        request.header.tag);
+  v9fs_cache_invalidate(client);
+  return ret;
 }
 
 /****************************************************************************
@@ -1262,6 +1353,7 @@ int v9fs_client_unlink(FAR struct v9fs_client_s *client, uint32_t fid,
 
   ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
                         request.header.tag);
+  v9fs_cache_invalidate(client);
   if (ret < 0)
     {
       return ret;
@@ -1283,6 +1375,7 @@ int v9fs_client_mkdir(FAR struct v9fs_client_s *client, uint32_t fid,
   struct iovec riov[1];
   uint32_t gid = getgid();
   off_t offset = 0;
+  int ret;
 
   /* size[4] Tmkdir tag[2] dfid[4] name[s] mode[4] gid[4]
    * size[4] Rmkdir tag[2] qid[13]
@@ -1306,8 +1399,10 @@ int v9fs_client_mkdir(FAR struct v9fs_client_s *client, uint32_t fid,
   riov[0].iov_base = &response;
   riov[0].iov_len = V9FS_HDRSZ + V9FS_QIDSZ;
 
-  return v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
-                         request.header.tag);
+  ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
+                        request.header.tag);
+  v9fs_cache_invalidate(client);
+  return ret;
 }
 
 /****************************************************************************
@@ -1359,6 +1454,7 @@ int v9fs_client_create(FAR struct v9fs_client_s *client, uint32_t fid,
 
   ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
                         request.header.tag);
+  v9fs_cache_invalidate(client);
   if (ret < 0)
     {
       return ret;
@@ -1410,6 +1506,11 @@ int v9fs_client_open(FAR struct v9fs_client_s *client,
 
   ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 1,
                         request.header.tag);
+  if ((oflags & O_TRUNC) != 0)
+    {
+      v9fs_cache_invalidate(client);
+    }
+
   if (ret < 0)
     {
       return ret;
@@ -1472,6 +1573,13 @@ int v9fs_client_walk(FAR struct v9fs_client_s *client, FAR const char *path,
    * size[4] Rwalk tag[2] nwqid[2] nwqid*(wqid[13])
    */
 
+  /* A path known not to exist needs no walk */
+
+  if (childname == NULL && v9fs_cache_lookup(client, path, NULL) == -ENOENT)
+    {
+      return -ENOENT;
+    }
+
   /* Parse path info, We need to skip parsing the root path */
 
   start = path;
@@ -1582,6 +1690,11 @@ int v9fs_client_walk(FAR struct v9fs_client_s *client, FAR const char *path,
                         riov, 2, request.header.tag);
   if (ret < 0)
     {
+      if (ret == -ENOENT && childname == NULL)
+        {
+          v9fs_cache_update(client, path, ret, NULL);
+        }
+
       v9fs_fid_destroy(client, newfid);
       newfid = ret;
     }
@@ -1710,6 +1823,14 @@ int v9fs_client_uninit(FAR struct v9fs_client_s *client)
   v9fs_transport_destroy(client->transport);
   nxmutex_destroy(&client->lock);
   idr_destroy(client->fids);
+
+#ifdef CONFIG_V9FS_CACHE
+  for (ret = 0; ret < CONFIG_V9FS_CACHE_NENTRIES; ret++)
+    {
+      kmm_free(client->cache[ret].path);
+    }
+#endif
+
   return 0;
 }
 
@@ -1789,3 +1910,128 @@ int v9fs_fid_get(FAR struct v9fs_client_s *client, uint32_t fid)
   nxmutex_unlock(&client->lock);
   return 0;
 }
+
+#ifdef CONFIG_V9FS_CACHE
+/****************************************************************************
+ * v9fs_cache_lookup
+ *
+ * Description:
+ *   Look for the result of an earlier stat() of the path.  Returns OK with
+ *   the attributes in buf, -ENOENT if the path did not exist, or -EAGAIN
+ *   if nothing valid is cached.
+ *
+ ****************************************************************************/
+
+int v9fs_cache_lookup(FAR struct v9fs_client_s *client,
+                      FAR const char *path, FAR struct stat *buf)
+{
+  FAR struct v9fs_cache_s *entry;
+  int ret = -EAGAIN;
+  int i;
+
+  nxmutex_lock(&client->lock);
+  for (i = 0; i < CONFIG_V9FS_CACHE_NENTRIES; i++)
+    {
+      entry = &client->cache[i];
+      if (entry->path == NULL || strcmp(entry->path, path) != 0)
+        {
+          continue;
+        }
+
+      if (clock_systime_ticks() - entry->stamp <
+          MSEC2TICK(CONFIG_V9FS_CACHE_TIMEOUT))
+        {
+          ret = entry->ret;
+          if (ret == OK && buf != NULL)
+            {
+              memcpy(buf, &entry->buf, sizeof(struct stat));
+            }
+        }
+
+      break;
+    }
+
+  nxmutex_unlock(&client->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * v9fs_cache_update
+ *
+ * Description:
+ *   Remember the result of a stat() of the path, replacing the oldest
+ *   entry if the path is not cached yet.
+ *
+ ****************************************************************************/
+
+void v9fs_cache_update(FAR struct v9fs_client_s *client,
+                       FAR const char *path, int ret,
+                       FAR const struct stat *buf)
+{
+  FAR struct v9fs_cache_s *entry = NULL;
+  size_t len;
+  int i;
+
+  nxmutex_lock(&client->lock);
+  for (i = 0; i < CONFIG_V9FS_CACHE_NENTRIES; i++)
+    {
+      if (client->cache[i].path != NULL &&
+          strcmp(client->cache[i].path, path) == 0)
+        {
+          entry = &client->cache[i];
+          break;
+        }
+    }
+
+  if (entry == NULL)
+    {
+      entry = &client->cache[client->cache_next];
+      if (++client->cache_next >= CONFIG_V9FS_CACHE_NENTRIES)
+        {
+          client->cache_next = 0;
+        }
+
+      kmm_free(entry->path);
+      len = strlen(path) + 1;
+      entry->path = kmm_malloc(len);
+      if (entry->path == NULL)
+        {
+          nxmutex_unlock(&client->lock);
+          return;
+        }
+
+      memcpy(entry->path, path, len);
+    }
+
+  entry->stamp = clock_systime_ticks();
+  entry->ret = ret;
+  if (ret == OK)
+    {
+      memcpy(&entry->buf, buf, sizeof(struct stat));
+    }
+
+  nxmutex_unlock(&client->lock);
+}
+
+/****************************************************************************
+ * v9fs_cache_invalidate
+ *
+ * Description:
+ *   Forget all cached results.  Called after every change made through
+ *   the client.
+ *
+ ****************************************************************************/
+
+void v9fs_cache_invalidate(FAR struct v9fs_client_s *client)
+{
+  int i;
+
+  nxmutex_lock(&client->lock);
+  for (i = 0; i < CONFIG_V9FS_CACHE_NENTRIES; i++)
+    {
+      client->cache[i].ret = -EAGAIN;
+    }
+
+  nxmutex_unlock(&client->lock);
+}
+#endif
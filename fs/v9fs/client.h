@@ -25,6 +25,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/clock.h>
 #include <nuttx/idr.h>
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
@@ -68,6 +69,18 @@ struct v9fs_transport_ops_s
   CODE void (*destroy)(FAR struct v9fs_transport_s *transport);
 };
 
+#ifdef CONFIG_V9FS_CACHE
+/* The result of a stat() of a path: its attributes or -ENOENT */
+
+struct v9fs_cache_s
+{
+  FAR char   *path;
+  clock_t     stamp;
+  int         ret;
+  struct stat buf;
+};
+#endif
+
 struct v9fs_client_s
 {
   FAR struct v9fs_transport_s *transport;
@@ -76,6 +89,10 @@ struct v9fs_client_s
   uint32_t                     root_fid;
   uint32_t                     tag_id;
   mutex_t                      lock;
+#ifdef CONFIG_V9FS_CACHE
+  unsigned int                 cache_next;
+  struct v9fs_cache_s          cache[CONFIG_V9FS_CACHE_NENTRIES];
+#endif
 };
 
 /****************************************************************************
@@ -125,5 +142,17 @@ void v9fs_transport_destroy(FAR struct v9fs_transport_s *transport);
 void v9fs_transport_done(FAR struct v9fs_payload_s *cookie, int ret);
 int v9fs_fid_put(FAR struct v9fs_client_s *client, uint32_t fid);
 int v9fs_fid_get(FAR struct v9fs_client_s *client, uint32_t fid);
+#ifdef CONFIG_V9FS_CACHE
+int v9fs_cache_lookup(FAR struct v9fs_client_s *client,
+                      FAR const char *path, FAR struct stat *buf);
+void v9fs_cache_update(FAR struct v9fs_client_s *client,
+                       FAR const char *path, int ret,
+                       FAR const struct stat *buf);
+void v9fs_cache_invalidate(FAR struct v9fs_client_s *client);
+#else
+#  define v9fs_cache_lookup(c,p,b)   (-EAGAIN)
+#  define v9fs_cache_update(c,p,r,b)
+#  define v9fs_cache_invalidate(c)
+#endif
 
 #endif /* __FS_V9FS_CLIENT_H */
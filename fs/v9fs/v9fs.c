@@ -28,6 +28,7 @@
 #include <inttypes.h>
 #include <libgen.h>
 #include <string.h>
+#include <sys/param.h>
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
@@ -54,6 +55,7 @@ struct v9fs_vfs_dirent_s
   off_t              offset;
   off_t              head;
   size_t             size;
+  size_t             bufsize;
   uint8_t            buffer[1];
 };
 
@@ -520,6 +522,7 @@ static int v9fs_vfs_opendir(FAR struct inode *mountpt,
 {
   FAR struct v9fs_vfs_dirent_s *fsdir;
   FAR struct v9fs_client_s *client;
+  size_t bufsize;
   uint32_t fid;
   int ret;
 
@@ -531,12 +534,15 @@ static int v9fs_vfs_opendir(FAR struct inode *mountpt,
 
   client = mountpt->i_private;
 
-  fsdir = kmm_zalloc(sizeof(struct v9fs_vfs_dirent_s) + client->msize);
+  bufsize = MIN(client->msize, CONFIG_V9FS_READDIR_BUFSIZE);
+  fsdir = kmm_zalloc(sizeof(struct v9fs_vfs_dirent_s) + bufsize);
   if (fsdir == NULL)
     {
       return -ENOMEM;
     }
 
+  fsdir->bufsize = bufsize;
+
   ret = v9fs_client_walk(client, relpath, NULL);
   if (ret < 0)
     {
@@ -615,7 +621,7 @@ static int v9fs_vfs_readdir(FAR struct inode *mountpt,
       if (fsdir->head == fsdir->size)
         {
           ret = v9fs_client_readdir(client, fsdir->fid, fsdir->buffer,
-                                    fsdir->offset, client->msize);
+                                    fsdir->offset, fsdir->bufsize);
           if (ret < 0)
             {
               break;
@@ -889,6 +895,12 @@ static int v9fs_vfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
   client = mountpt->i_private;
   memset(buf, 0, sizeof(struct stat));
 
+  ret = v9fs_cache_lookup(client, relpath, buf);
+  if (ret != -EAGAIN)
+    {
+      return ret;
+    }
+
   ret = v9fs_client_walk(client, relpath, NULL);
   if (ret < 0)
     {
@@ -899,6 +911,11 @@ static int v9fs_vfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
   fid = ret;
   ret = v9fs_client_stat(client, fid, buf);
   v9fs_fid_put(client, fid);
+  if (ret == OK)
+    {
+      v9fs_cache_update(client, relpath, ret, buf);
+    }
+
   return ret;
 }
 
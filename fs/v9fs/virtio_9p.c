@@ -52,6 +52,7 @@ struct virtio_9p_priv_s
   struct v9fs_transport_s   transport;
   struct virtio_driver      vdrv;
   spinlock_t                lock;
+  struct list_node          pending;  /* Requests waiting for descriptors */
   char                      tag[0];
 };
 
@@ -64,6 +65,8 @@ struct virtio_9p_priv_s
 static int virtio_9p_create(FAR struct v9fs_transport_s **transport,
                             FAR const char *args);
 static void virtio_9p_destroy(FAR struct v9fs_transport_s *transport);
+static int virtio_9p_add(FAR struct virtio_9p_priv_s *priv,
+                         FAR struct v9fs_payload_s *payload);
 static int virtio_9p_request(FAR struct v9fs_transport_s *transport,
                              FAR struct v9fs_payload_s *payload);
 static void virtio_9p_done(FAR struct virtqueue *vq);
@@ -116,6 +119,7 @@ static int virtio_9p_create(FAR struct v9fs_transport_s **transport,
     }
 
   spin_lock_init(&priv->lock);
+  list_initialize(&priv->pending);
   memcpy(priv->tag, start, length);
   priv->vdrv.device = VIRTIO_ID_9P;
   priv->vdrv.probe = virtio_9p_probe;
@@ -144,20 +148,28 @@ static void virtio_9p_destroy(FAR struct v9fs_transport_s *transport)
 }
 
 /****************************************************************************
- * Name: virtio_9p_request
+ * Name: virtio_9p_add
+ *
+ * Description:
+ *   Add the buffers of a request to the virtqueue, or queue the request
+ *   until enough descriptors are free.  Called with the lock held.
+ *
  ****************************************************************************/
 
-static int virtio_9p_request(FAR struct v9fs_transport_s *transport,
-                             FAR struct v9fs_payload_s *payload)
+static int virtio_9p_add(FAR struct virtio_9p_priv_s *priv,
+                         FAR struct v9fs_payload_s *payload)
 {
-  FAR struct virtio_9p_priv_s *priv =
-             container_of(transport, struct virtio_9p_priv_s, transport);
   FAR struct virtqueue *vq = priv->vdev->vrings_info[0].vq;
   struct virtqueue_buf vb[payload->wcount + payload->rcount];
-  irqstate_t flags;
   size_t i;
   int ret;
 
+  if (vq->vq_free_cnt < payload->wcount + payload->rcount)
+    {
+      list_add_tail(&priv->pending, &payload->node);
+      return OK;
+    }
+
   for (i = 0; i < payload->wcount; i++)
     {
       vb[i].buf = payload->wiov[i].iov_base;
@@ -170,17 +182,50 @@ static int virtio_9p_request(FAR struct v9fs_transport_s *transport,
       vb[payload->wcount + i].len = payload->riov[i].iov_len;
     }
 
-  flags = spin_lock_irqsave(&priv->lock);
   ret = virtqueue_add_buffer(vq, vb, payload->wcount, payload->rcount,
                              payload);
   if (ret < 0)
     {
       vrterr("virtqueue_add_buffer failed, ret=%d\n", ret);
-      goto out;
+      return ret;
     }
 
   virtqueue_kick(vq);
-out:
+  return ret;
+}
+
+/****************************************************************************
+ * Name: virtio_9p_request
+ *
+ * Description:
+ *   Start a request without waiting for it.  Any number of requests may
+ *   be in flight; virtio_9p_done() completes them in the order the device
+ *   finishes them.
+ *
+ ****************************************************************************/
+
+static int virtio_9p_request(FAR struct v9fs_transport_s *transport,
+                             FAR struct v9fs_payload_s *payload)
+{
+  FAR struct virtio_9p_priv_s *priv =
+             container_of(transport, struct virtio_9p_priv_s, transport);
+  irqstate_t flags;
+  int ret;
+
+  flags = spin_lock_irqsave(&priv->lock);
+
+  /* Keep the order of the requests already waiting for descriptors */
+
+  if (!list_is_empty(&priv->pending))
+    {
+      list_add_tail(&priv->pending, &payload->node);
+      ret = OK;
+    }
+  else
+    {
+      ret = virtio_9p_add(priv, payload);
+    }
+
   spin_unlock_irqrestore(&priv->lock, flags);
   return ret;
 }
@@ -193,6 +238,8 @@ static void virtio_9p_done(FAR struct virtqueue *vq)
 {
   FAR struct virtio_9p_priv_s *priv = vq->vq_dev->priv;
   FAR struct v9fs_payload_s *payload;
+  irqstate_t flags;
+  int ret;
 
   for (; ; )
     {
@@ -204,6 +251,30 @@ static void virtio_9p_done(FAR struct virtqueue *vq)
 
       v9fs_transport_done(payload, 0);
     }
+
+  /* Move the waiting requests into the descriptors just freed */
+
+  flags = spin_lock_irqsave(&priv->lock);
+  while (!list_is_empty(&priv->pending))
+    {
+      payload = list_first_entry(&priv->pending, struct v9fs_payload_s,
+                                 node);
+      if (vq->vq_free_cnt < payload->wcount + payload->rcount)
+        {
+          break;
+        }
+
+      list_delete(&payload->node);
+      ret = virtio_9p_add(priv, payload);
+      if (ret < 0)
+        {
+          spin_unlock_irqrestore(&priv->lock, flags);
+          v9fs_transport_done(payload, ret);
+          flags = spin_lock_irqsave(&priv->lock);
+        }
+    }
+
+  spin_unlock_irqrestore(&priv->lock, flags);
 }
 
 /****************************************************************************
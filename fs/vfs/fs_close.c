@@ -125,6 +125,10 @@ int file_close(FAR struct file *filep)
 #ifdef CONFIG_FDSAN
       filep->f_tag_fdsan = 0;
 #endif
+
+#ifdef CONFIG_FS_NOTIFY
+      filep->f_notify = 0;
+#endif
     }
 
   return ret;
@@ -110,6 +110,9 @@ int file_dup3(FAR struct file *filep1, FAR struct file *filep2, int flags)
   filep2->f_priv  = NULL;
   filep2->f_pos   = filep1->f_pos;
   filep2->f_inode = inode;
+#ifdef CONFIG_FS_NOTIFY
+  filep2->f_notify = 0;
+#endif
 
   /* Call the open method on the file, driver, mountpoint so that it
    * can maintain the correct open counts.
@@ -40,6 +40,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 
@@ -49,9 +50,14 @@
 
 struct epoll_node_s
 {
-  struct list_node         node;
+  struct list_node         node;     /* Node in the setup, oneshot or free
+                                      * list.
+                                      */
+  struct list_node         rnode;    /* Node in the ready or rearm list */
   epoll_data_t             data;
-  bool                     notified;
+  bool                     notified; /* rnode is in the ready or rearm
+                                      * list.
+                                      */
   struct pollfd            pfd;
   FAR struct epoll_head_s *eph;
 };
@@ -64,13 +70,23 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
-  struct list_node      setup;    /* The setup list, store all the setuped
-                                   * epoll node.
+  spinlock_t            spinlock; /* Protects the ready list, which is
+                                   * filled from the poll callback.
                                    */
-  struct list_node      teardown; /* The teardown list, store all the epoll
-                                   * node notified after epoll_wait finish,
-                                   * these epoll node should be setup again
-                                   * to check the pending poll notification.
+  struct list_node      setup;    /* The setup list, store all the epoll
+                                   * node that is registered with its fd.
+                                   * The registration persists across
+                                   * epoll_wait calls.
+                                   */
+  struct list_node      ready;    /* The ready list, store all the epoll
+                                   * node notified by epoll_default_cb()
+                                   * and not yet reported by epoll_wait.
+                                   */
+  struct list_node      rearm;    /* The rearm list, store all the level
+                                   * triggered epoll node reported by the
+                                   * last epoll_wait, these epoll node
+                                   * should be setup again to check if the
+                                   * event is still pending.
                                    */
   struct list_node      oneshot;  /* The oneshot list, store all the epoll
                                    * node notified after epoll_wait and with
@@ -100,6 +116,7 @@ static int epoll_do_poll(FAR struct file *filep,
 static int epoll_setup(FAR epoll_head_t *eph);
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents);
+static void epoll_unready(FAR epoll_node_t *epn);
 
 /****************************************************************************
  * Private Data
@@ -234,13 +251,15 @@ static int epoll_do_create(int size, int flags)
   eph->size = size;
   nxmutex_init(&eph->lock);
   nxsem_init(&eph->sem, 0, 0);
+  spin_lock_init(&eph->spinlock);
 
   /* List initialize */
 
   epn = (FAR epoll_node_t *)(eph + 1);
 
   list_initialize(&eph->setup);
-  list_initialize(&eph->teardown);
+  list_initialize(&eph->ready);
+  list_initialize(&eph->rearm);
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
@@ -265,11 +284,45 @@ static int epoll_do_create(int size, int flags)
   return fd;
 }
 
+/****************************************************************************
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Remove an epoll node from the ready or rearm list, if it is queued
+ *   in one of them.
+ *
+ * Input Parameters:
+ *   epn - The epoll node
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR epoll_node_t *epn)
+{
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->spinlock);
+  if (epn->notified)
+    {
+      list_delete(&epn->rnode);
+      epn->notified = false;
+    }
+
+  spin_unlock_irqrestore(&eph->spinlock, flags);
+}
+
 /****************************************************************************
  * Name: epoll_setup
  *
  * Description:
- *   Setup all the fd.
+ *   Setup again the level triggered fd reported by the last epoll_wait, to
+ *   check whether the event is still pending.  The fd whose event is still
+ *   pending will be queued to the ready list again by epoll_default_cb().
+ *   Only the fd in the rearm list are touched, so the cost is proportional
+ *   to the number of fd reported, not to the number of fd registered.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -281,8 +334,8 @@ static int epoll_do_create(int size, int flags)
 
 static int epoll_setup(FAR epoll_head_t *eph)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  irqstate_t flags;
   int ret;
 
   ret = nxmutex_lock(&eph->lock);
@@ -291,24 +344,40 @@ static int epoll_setup(FAR epoll_head_t *eph)
       return ret;
     }
 
-  list_for_every_entry_safe(&eph->teardown, epn, tepn, epoll_node_t, node)
+  for (; ; )
     {
-      /* Setup again to check the notified pollfd last epoll_wait() to
-       * cover the situation several poll event pending on one fd.
-       */
+      flags = spin_lock_irqsave(&eph->spinlock);
+      if (list_is_empty(&eph->rearm))
+        {
+          spin_unlock_irqrestore(&eph->spinlock, flags);
+          break;
+        }
 
+      epn = container_of(list_remove_head(&eph->rearm), epoll_node_t,
+                         rnode);
       epn->notified    = false;
       epn->pfd.revents = 0;
+      spin_unlock_irqrestore(&eph->spinlock, flags);
+
+      /* Setup again to check the pollfd notified last epoll_wait() to
+       * cover the situation several poll event pending on one fd.
+       */
+
+      poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
       ret = poll_fdsetup(epn->pfd.fd, &epn->pfd, true);
       if (ret < 0)
         {
           ferr("epoll setup failed, fd=%d, events=%08" PRIx32 ", ret=%d\n",
                epn->pfd.fd, epn->pfd.events, ret);
+
+          /* The fd is not registered anymore, keep it out of the setup
+           * list until it is modified or deleted by epoll_ctl.
+           */
+
+          list_delete(&epn->node);
+          list_add_tail(&eph->oneshot, &epn->node);
           break;
         }
-
-      list_delete(&epn->node);
-      list_add_tail(&eph->setup, &epn->node);
     }
 
   nxmutex_unlock(&eph->lock);
@@ -319,8 +388,11 @@ static int epoll_setup(FAR epoll_head_t *eph)
  * Name: epoll_teardown
  *
  * Description:
- *   Teardown all the notifed fd and check the notified fd's event with user
- *   expected event.
+ *   Collect the events of the fd in the ready list.  Level triggered fd
+ *   are moved to the rearm list, to be checked again by the next
+ *   epoll_wait; oneshot fd are unregistered and moved to the oneshot list;
+ *   edge triggered fd stay registered and are reported again only after
+ *   a new notification.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -336,42 +408,72 @@ static int epoll_setup(FAR epoll_head_t *eph)
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  pollevent_t revents;
+  irqstate_t flags;
   int i = 0;
 
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  while (i < maxevents)
     {
-      /* Only check the notifed fd */
+      flags = spin_lock_irqsave(&eph->spinlock);
+      if (list_is_empty(&eph->ready))
+        {
+          spin_unlock_irqrestore(&eph->spinlock, flags);
+          break;
+        }
 
-      if (!epn->notified)
+      epn = container_of(list_remove_head(&eph->ready), epoll_node_t,
+                         rnode);
+      revents          = epn->pfd.revents;
+      epn->pfd.revents = 0;
+
+      if (revents != 0 &&
+          (epn->pfd.events & (EPOLLONESHOT | EPOLLET)) == 0)
         {
-          continue;
+          /* Level triggered, check the fd again in the next epoll_wait */
+
+          list_add_tail(&eph->rearm, &epn->rnode);
+        }
+      else
+        {
+          epn->notified = false;
         }
 
-      /* Teradown all the notified fd */
+      spin_unlock_irqrestore(&eph->spinlock, flags);
 
-      poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
-      list_delete(&epn->node);
+      if (revents == 0)
+        {
+          continue;
+        }
 
-      if (epn->pfd.revents != 0 && i < maxevents)
+      evs[i].data     = epn->data;
+      evs[i++].events = revents;
+
+      if ((epn->pfd.events & EPOLLONESHOT) != 0)
         {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
-            {
-              list_add_tail(&eph->oneshot, &epn->node);
-            }
-          else
-            {
-              list_add_tail(&eph->teardown, &epn->node);
-            }
+          /* Teardown the oneshot fd, it can be reset by epoll_ctl */
+
+          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+          epoll_unready(epn);
+          list_delete(&epn->node);
+          list_add_tail(&eph->oneshot, &epn->node);
         }
-      else
+    }
+
+  /* Leave the wakeup pending if more events are ready than the caller can
+   * receive, so that the next epoll_wait returns them without waiting.
+   */
+
+  if (!list_is_empty(&eph->ready))
+    {
+      int semcount = 0;
+
+      nxsem_get_value(&eph->sem, &semcount);
+      if (semcount < 1)
         {
-          list_add_tail(&eph->teardown, &epn->node);
+          nxsem_post(&eph->sem);
         }
     }
 
@@ -384,7 +486,8 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
  *
  * Description:
  *   The default epoll callback function, this function do the final step of
- *   poll notification.
+ *   poll notification: queue the epoll node to the ready list and wake up
+ *   the waiter.
  *
  * Input Parameters:
  *   fds - The fds
@@ -397,16 +500,32 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
   int semcount = 0;
 
-  epn->notified = true;
-  if (fds->revents != 0)
+  if (fds->revents == 0)
     {
-      nxsem_get_value(&epn->eph->sem, &semcount);
-      if (semcount < 1)
-        {
-          nxsem_post(&epn->eph->sem);
-        }
+      return;
+    }
+
+  /* A node that is already in the ready or rearm list is checked by the
+   * next epoll_wait anyway.
+   */
+
+  flags = spin_lock_irqsave(&eph->spinlock);
+  if (!epn->notified)
+    {
+      epn->notified = true;
+      list_add_tail(&eph->ready, &epn->rnode);
+    }
+
+  spin_unlock_irqrestore(&eph->spinlock, flags);
+
+  nxsem_get_value(&eph->sem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&eph->sem);
     }
 }
 
@@ -510,15 +629,6 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
               }
           }
 
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
         list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
           {
             if (epn->pfd.fd == fd)
@@ -556,20 +666,26 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         epn->eph         = eph;
         epn->data        = ev->data;
         epn->notified    = false;
-        epn->pfd.events  = ev->events | POLLALWAYS;
+        epn->pfd.events  = ev->events;
         epn->pfd.fd      = fd;
         epn->pfd.arg     = epn;
         epn->pfd.cb      = epoll_default_cb;
         epn->pfd.revents = 0;
 
+        /* Add the node to the setup list before the setup, the callback
+         * may be run at once if the fd is already ready.
+         */
+
+        list_add_tail(&eph->setup, &epn->node);
         ret = poll_fdsetup(fd, &epn->pfd, true);
         if (ret < 0)
           {
+            epoll_unready(epn);
+            list_delete(&epn->node);
             list_add_tail(&eph->free, &epn->node);
             goto err;
           }
 
-        list_add_tail(&eph->setup, &epn->node);
         break;
 
       case EPOLL_CTL_DEL:
@@ -579,16 +695,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             if (epn->pfd.fd == fd)
               {
                 poll_fdsetup(fd, &epn->pfd, false);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
+                epoll_unready(epn);
                 list_delete(&epn->node);
                 list_add_tail(&eph->free, &epn->node);
                 goto out;
@@ -613,47 +720,23 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
           {
             if (epn->pfd.fd == fd)
               {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
+                epn->data = ev->data;
+                if (epn->pfd.events != ev->events)
                   {
                     poll_fdsetup(fd, &epn->pfd, false);
+                    epoll_unready(epn);
 
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.fd      = fd;
-                    epn->pfd.revents = 0;
-
-                    ret = poll_fdsetup(fd, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-                  }
-
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.fd      = fd;
+                    epn->pfd.events  = ev->events;
                     epn->pfd.revents = 0;
 
                     ret = poll_fdsetup(fd, &epn->pfd, true);
                     if (ret < 0)
                       {
+                        epoll_unready(epn);
+                        list_delete(&epn->node);
+                        list_add_tail(&eph->oneshot, &epn->node);
                         goto err;
                       }
-
-                    list_delete(&epn->node);
-                    list_add_tail(&eph->setup, &epn->node);
                   }
 
                 goto out;
@@ -666,18 +749,22 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
               {
                 epn->notified    = false;
                 epn->data        = ev->data;
-                epn->pfd.events  = ev->events | POLLALWAYS;
+                epn->pfd.events  = ev->events;
                 epn->pfd.fd      = fd;
                 epn->pfd.revents = 0;
 
+                list_delete(&epn->node);
+                list_add_tail(&eph->setup, &epn->node);
+
                 ret = poll_fdsetup(fd, &epn->pfd, true);
                 if (ret < 0)
                   {
+                    epoll_unready(epn);
+                    list_delete(&epn->node);
+                    list_add_tail(&eph->oneshot, &epn->node);
                     goto err;
                   }
 
-                list_delete(&epn->node);
-                list_add_tail(&eph->setup, &epn->node);
                 break;
               }
           }
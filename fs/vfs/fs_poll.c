@@ -31,6 +31,8 @@
 #include <debug.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
@@ -51,6 +53,29 @@ struct pollfd_s
   nfds_t nfds;
 };
 
+#ifdef CONFIG_FS_POLL_CACHE
+/* The registration of one descriptor kept across the poll() calls of a
+ * thread.  The driver references pfd, so it lives in the cache and not in
+ * the caller's array, and the file is referenced so that it stays the
+ * same file while registered.
+ */
+
+struct poll_cache_entry_s
+{
+  struct pollfd pfd;                 /* Registered with the driver */
+  FAR struct file *filep;            /* Referenced while registered */
+  bool rearm;                        /* Setup again on the next call */
+};
+
+struct poll_cache_s
+{
+  FAR const struct pollfd *fds;      /* The array the cache was built for */
+  nfds_t nfds;                       /* Its number of entries */
+  sem_t sem;                         /* Posted by the registered drivers */
+  struct poll_cache_entry_s entry[1];
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -187,6 +212,221 @@ static void poll_cleanup(FAR void *arg)
   poll_teardown(fdsinfo->fds, fdsinfo->nfds, &count, OK);
 }
 
+#ifdef CONFIG_FS_POLL_CACHE
+/****************************************************************************
+ * Name: poll_cache_teardown
+ *
+ * Description:
+ *   Unregister one cached descriptor from its driver and let its file go.
+ *
+ ****************************************************************************/
+
+static void poll_cache_teardown(FAR struct poll_cache_entry_s *entry)
+{
+  if (entry->filep != NULL)
+    {
+      file_poll(entry->filep, &entry->pfd, false);
+      fs_putfilep(entry->filep);
+      entry->filep = NULL;
+    }
+
+  entry->rearm = true;
+}
+
+/****************************************************************************
+ * Name: poll_cache_setup
+ *
+ * Description:
+ *   Register one cached descriptor with its driver.
+ *
+ ****************************************************************************/
+
+static int poll_cache_setup(FAR struct poll_cache_s *cache,
+                            FAR struct poll_cache_entry_s *entry)
+{
+  FAR struct file *filep;
+  int ret;
+
+  entry->pfd.arg     = &cache->sem;
+  entry->pfd.cb      = poll_default_cb;
+  entry->pfd.revents = 0;
+  entry->pfd.priv    = NULL;
+  entry->rearm       = false;
+
+  if (entry->pfd.fd < 0)
+    {
+      return OK;
+    }
+
+  ret = fs_getfilep(entry->pfd.fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_poll(filep, &entry->pfd, true);
+  if (ret < 0)
+    {
+      fs_putfilep(filep);
+      return ret;
+    }
+
+  entry->filep = filep;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: poll_cache_update
+ *
+ * Description:
+ *   Bring the cached registration of the thread in line with the array.
+ *   Only the descriptors whose fd or events changed, whose file was
+ *   closed since, or which reported events last time are set up again.
+ *   The latter may still be ready without their driver posting again.
+ *
+ ****************************************************************************/
+
+static int poll_cache_update(FAR struct tcb_s *rtcb,
+                             FAR struct pollfd *fds, nfds_t nfds)
+{
+  FAR struct poll_cache_s *cache = rtcb->pollcache;
+  FAR struct poll_cache_entry_s *entry;
+  nfds_t i;
+  int ret;
+
+  if (cache == NULL || cache->fds != fds || cache->nfds != nfds)
+    {
+      poll_cache_release(rtcb);
+
+      cache = kmm_zalloc(sizeof(struct poll_cache_s) +
+                         (nfds - 1) * sizeof(struct poll_cache_entry_s));
+      if (cache == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      cache->fds  = fds;
+      cache->nfds = nfds;
+      nxsem_init(&cache->sem, 0, 0);
+
+      for (i = 0; i < nfds; i++)
+        {
+          cache->entry[i].rearm = true;
+        }
+
+      rtcb->pollcache = cache;
+    }
+  else
+    {
+      /* The wakeups of the events already reported are stale */
+
+      while (nxsem_trywait(&cache->sem) >= 0);
+    }
+
+  for (i = 0; i < nfds; i++)
+    {
+      entry = &cache->entry[i];
+
+      /* The reference of the cache keeps a closed file open, so a file
+       * left with that reference only was closed by the caller.
+       */
+
+      if (entry->pfd.fd != fds[i].fd ||
+          entry->pfd.events != fds[i].events ||
+          (entry->filep != NULL && atomic_load(&entry->filep->f_refs) < 2))
+        {
+          poll_cache_teardown(entry);
+          entry->pfd.fd     = fds[i].fd;
+          entry->pfd.events = fds[i].events;
+        }
+
+      if (entry->rearm)
+        {
+          poll_cache_teardown(entry);
+          ret = poll_cache_setup(cache, entry);
+          if (ret < 0)
+            {
+              poll_cache_release(rtcb);
+              fds[i].revents = POLLERR;
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: poll_cache_wait
+ *
+ * Description:
+ *   poll() on the cached registration of the calling thread.
+ *
+ ****************************************************************************/
+
+static int poll_cache_wait(FAR struct pollfd *fds, nfds_t nfds,
+                           int timeout)
+{
+  FAR struct tcb_s *rtcb = nxsched_self();
+  FAR struct poll_cache_s *cache;
+  pollevent_t revents;
+  int count = 0;
+  nfds_t i;
+  int ret;
+
+  ret = poll_cache_update(rtcb, fds, nfds);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  cache = rtcb->pollcache;
+  for (i = 0; i < nfds; i++)
+    {
+      if (cache->entry[i].pfd.revents != 0)
+        {
+          count++;
+        }
+    }
+
+  /* The events which came in since the last call were reported through
+   * revents already, their wakeups were dropped.
+   */
+
+  if (count == 0 && timeout > 0)
+    {
+      ret = nxsem_tickwait(&cache->sem, MSEC2TICK(timeout));
+      if (ret == -ETIMEDOUT)
+        {
+          ret = OK;
+        }
+    }
+  else if (count == 0 && timeout < 0)
+    {
+      ret = nxsem_wait(&cache->sem);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  count = 0;
+  for (i = 0; i < nfds; i++)
+    {
+      revents = cache->entry[i].pfd.revents;
+      fds[i].revents = revents;
+      if (revents != 0)
+        {
+          cache->entry[i].rearm = true;
+          count++;
+        }
+    }
+
+  return count;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -223,6 +463,41 @@ int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
   return ret;
 }
 
+/****************************************************************************
+ * Name: poll_cache_release
+ *
+ * Description:
+ *   Unregister the descriptors cached by the last poll() of a thread and
+ *   release their files.  Called when the thread exits.
+ *
+ * Input Parameters:
+ *   tcb - The thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+void poll_cache_release(FAR struct tcb_s *tcb)
+{
+  FAR struct poll_cache_s *cache = tcb->pollcache;
+  nfds_t i;
+
+  if (cache != NULL)
+    {
+      tcb->pollcache = NULL;
+      for (i = 0; i < cache->nfds; i++)
+        {
+          poll_cache_teardown(&cache->entry[i]);
+        }
+
+      nxsem_destroy(&cache->sem);
+      kmm_free(cache);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: poll_default_cb
  *
@@ -422,6 +697,21 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 
   enter_cancellation_point();
 
+#ifdef CONFIG_FS_POLL_CACHE
+  if (nfds > 0)
+    {
+      ret = poll_cache_wait(fds, nfds, timeout);
+      leave_cancellation_point();
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          return ERROR;
+        }
+
+      return ret;
+    }
+#endif
+
 #ifdef CONFIG_BUILD_KERNEL
   /* Allocate kernel memory for the fds */
 
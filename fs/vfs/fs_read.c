@@ -25,11 +25,13 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sched.h>
 #include <assert.h>
 #include <errno.h>
+#include <limits.h>
 
 #include <nuttx/cancelpt.h>
 
@@ -187,3 +189,190 @@ ssize_t read(int fd, FAR void *buf, size_t nbytes)
   leave_cancellation_point();
   return ret;
 }
+
+/****************************************************************************
+ * Name: file_readv
+ *
+ * Description:
+ *   file_readv() is an internal OS interface.  It is functionally similar
+ *   to the standard readv() interface except:
+ *
+ *    - It does not modify the errno variable,
+ *    - It is not a cancellation point,
+ *    - It accepts a file structure instance instead of file descriptor.
+ *
+ * Input Parameters:
+ *   filep  - File structure instance
+ *   iov    - The segments to fill
+ *   iovcnt - The number of segments
+ *
+ * Returned Value:
+ *   The positive non-zero number of bytes read on success, 0 on if an
+ *   end-of-file condition, or a negated errno value on any failure.
+ *
+ ****************************************************************************/
+
+ssize_t file_readv(FAR struct file *filep,
+                   FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct inode *inode;
+  ssize_t ntotal = 0;
+  ssize_t ret = -EBADF;
+  int i;
+
+  DEBUGASSERT(filep);
+  inode = filep->f_inode;
+
+  /* Was this file opened for read access? */
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EACCES;
+    }
+
+  if (inode == NULL || inode->u.i_ops == NULL)
+    {
+      return -EBADF;
+    }
+
+  /* The readv method is not common to the driver and the mountpoint
+   * operations.
+   */
+
+  if (!INODE_IS_MOUNTPT(inode) && inode->u.i_ops->readv != NULL)
+    {
+      ret = inode->u.i_ops->readv(filep, iov, iovcnt);
+    }
+  else if (inode->u.i_ops->read != NULL)
+    {
+      /* Read the segments one by one up to the first short read */
+
+      for (i = 0, ret = 0; i < iovcnt; i++)
+        {
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
+
+          ret = inode->u.i_ops->read(filep, iov[i].iov_base,
+                                     iov[i].iov_len);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          ntotal += ret;
+          if ((size_t)ret < iov[i].iov_len)
+            {
+              break;
+            }
+        }
+
+      if (ret >= 0 || ntotal > 0)
+        {
+          ret = ntotal;
+        }
+    }
+
+#ifdef CONFIG_FS_NOTIFY
+  if (ret > 0)
+    {
+      notify_read(filep);
+    }
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nx_readv
+ *
+ * Description:
+ *   nx_readv() is an internal OS interface.  It is functionally similar to
+ *   the standard readv() interface except:
+ *
+ *    - It does not modify the errno variable, and
+ *    - It is not a cancellation point.
+ *
+ * Input Parameters:
+ *   fd     - File descriptor to read from
+ *   iov    - The segments to fill
+ *   iovcnt - The number of segments
+ *
+ * Returned Value:
+ *   The positive non-zero number of bytes read on success, 0 on if an
+ *   end-of-file condition, or a negated errno value on any failure.
+ *
+ ****************************************************************************/
+
+ssize_t nx_readv(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct file *filep;
+  size_t total = 0;
+  ssize_t ret;
+  int i;
+
+  if (iovcnt < 0 || (iov == NULL && iovcnt > 0))
+    {
+      return -EINVAL;
+    }
+
+  /* The total length must fit in the return value */
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len > SSIZE_MAX - total)
+        {
+          return -EINVAL;
+        }
+
+      total += iov[i].iov_len;
+    }
+
+  ret = (ssize_t)fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_readv(filep, iov, iovcnt);
+  fs_putfilep(filep);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: readv
+ *
+ * Description:
+ *   The standard, POSIX readv interface.  The segments are filled in order
+ *   as if by one read() of their total length.
+ *
+ * Input Parameters:
+ *   fd     - File descriptor to read from
+ *   iov    - The segments to fill
+ *   iovcnt - The number of segments
+ *
+ * Returned Value:
+ *   The positive non-zero number of bytes read on success, 0 on if an
+ *   end-of-file condition, or -1 on failure with errno set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t readv(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t ret;
+
+  /* readv() is a cancellation point */
+
+  enter_cancellation_point();
+
+  ret = nx_readv(fd, iov, iovcnt);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
@@ -67,6 +67,7 @@ static int pseudorename(FAR const char *oldpath, FAR struct inode *oldinode,
 {
   struct inode_search_s newdesc;
   FAR struct inode *newinode;
+  FAR struct inode *child;
   FAR char *subdir = NULL;
 #ifdef CONFIG_FS_NOTIFY
   bool isdir = INODE_IS_PSEUDODIR(oldinode);
@@ -240,7 +241,14 @@ next_subdir:
       goto errout_with_lock;
     }
 
-  /* Remove all of the children from the unlinked inode */
+  /* Move all of the children from the unlinked inode to the new one */
+
+  for (child = newinode->i_child; child != NULL; child = child->i_peer)
+    {
+      inode_hash_remove(child);
+      child->i_parent = newinode;
+      inode_hash_insert(child);
+    }
 
   oldinode->i_child  = NULL;
   oldinode->i_parent = NULL;
@@ -31,6 +31,7 @@
 
 #include <debug.h>
 
+#include <nuttx/hrtimer.h>
 #include <nuttx/wdog.h>
 #include <nuttx/mutex.h>
 
@@ -61,9 +62,15 @@ struct timerfd_priv_s
   mutex_t                   lock;    /* Enforces device exclusive access */
   FAR timerfd_waiter_sem_t *rdsems;  /* List of blocking readers */
   int                       clock;   /* Clock to use as the timing base */
+#ifdef CONFIG_HRTIMER
+  uint64_t                  period;  /* If non-zero, the period (ns) of
+                                      * repetitive timers */
+  struct hrtimer_s          hrtimer; /* The timer that provides the timing */
+#else
   int                       delay;   /* If non-zero, used to reset repetitive
                                       * timers */
   struct wdog_s             wdog;    /* The watchdog that provides the timing */
+#endif
   timerfd_t                 counter; /* timerfd counter */
   uint8_t                   crefs;   /* References counts on timerfd (max: 255) */
 
@@ -98,6 +105,9 @@ static FAR struct timerfd_priv_s *timerfd_allocdev(void);
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev);
 
 static void timerfd_timeout(wdparm_t arg);
+#ifdef CONFIG_HRTIMER
+static void timerfd_hrtimeout(FAR struct hrtimer_s *timer);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -154,7 +164,11 @@ static FAR struct timerfd_priv_s *timerfd_allocdev(void)
 
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev)
 {
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&dev->hrtimer);
+#else
   wd_cancel(&dev->wdog);
+#endif
   nxmutex_unlock(&dev->lock);
   nxmutex_destroy(&dev->lock);
   kmm_free(dev);
@@ -396,12 +410,23 @@ static void timerfd_timeout(wdparm_t arg)
 
   dev->counter++;
 
-  /* If this is a repetitive timer, then restart the watchdog */
+  /* If this is a repetitive timer, then restart the watchdog.  The high
+   * resolution timer restarts from its own expiration, so the period
+   * does not drift with the interrupt latency.
+   */
 
+#ifdef CONFIG_HRTIMER
+  if (dev->period > 0)
+    {
+      hrtimer_start(&dev->hrtimer, dev->hrtimer.expired + dev->period,
+                    CONFIG_HRTIMER_SLACK, timerfd_hrtimeout, dev);
+    }
+#else
   if (dev->delay > 0)
     {
       wd_start(&dev->wdog, dev->delay, timerfd_timeout, arg);
     }
+#endif
 
 #ifdef CONFIG_TIMER_FD_POLL
   /* Notify all poll/select waiters */
@@ -423,6 +448,13 @@ static void timerfd_timeout(wdparm_t arg)
   leave_critical_section(intflags);
 }
 
+#ifdef CONFIG_HRTIMER
+static void timerfd_hrtimeout(FAR struct hrtimer_s *timer)
+{
+  timerfd_timeout((wdparm_t)timer->arg);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -486,7 +518,11 @@ int timerfd_settime(int fd, int flags,
   FAR struct timerfd_priv_s *dev;
   FAR struct file *filep;
   irqstate_t intflags;
+#ifdef CONFIG_HRTIMER
+  uint64_t expired;
+#else
   sclock_t delay;
+#endif
   int ret;
 
   /* Some sanity checks */
@@ -526,6 +562,11 @@ int timerfd_settime(int fd, int flags,
 
   if (old_value)
     {
+#ifdef CONFIG_HRTIMER
+      clock_nsec2time(&old_value->it_value,
+                      hrtimer_gettimeleft(&dev->hrtimer));
+      clock_nsec2time(&old_value->it_interval, dev->period);
+#else
       /* Get the number of ticks before the underlying watchdog expires */
 
       delay = wd_gettime(&dev->wdog);
@@ -534,13 +575,18 @@ int timerfd_settime(int fd, int flags,
 
       clock_ticks2time(&old_value->it_value, delay);
       clock_ticks2time(&old_value->it_interval, dev->delay);
+#endif
     }
 
   /* Disarm the timer (in case the timer was already armed when
    * timerfd_settime() is called).
    */
 
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&dev->hrtimer);
+#else
   wd_cancel(&dev->wdog);
+#endif
 
   /* Clear expiration counter */
 
@@ -557,6 +603,25 @@ int timerfd_settime(int fd, int flags,
       return OK;
     }
 
+#ifdef CONFIG_HRTIMER
+  /* Setup up any repetitive timer, then the first expiration.  A time in
+   * the past expires at once.
+   */
+
+  dev->period = clock_time2nsec(&new_value->it_interval);
+
+  if ((flags & TFD_TIMER_ABSTIME) != 0)
+    {
+      expired = hrtimer_abstime(dev->clock, &new_value->it_value);
+    }
+  else
+    {
+      expired = hrtimer_gettime() + clock_time2nsec(&new_value->it_value);
+    }
+
+  ret = hrtimer_start(&dev->hrtimer, expired, CONFIG_HRTIMER_SLACK,
+                      timerfd_hrtimeout, dev);
+#else
   /* Setup up any repetitive timer */
 
   delay = clock_time2ticks(&new_value->it_interval);
@@ -596,6 +661,7 @@ int timerfd_settime(int fd, int flags,
   /* Then start the watchdog */
 
   ret = wd_start(&dev->wdog, delay, timerfd_timeout, (wdparm_t)dev);
+#endif
   if (ret < 0)
     {
       leave_critical_section(intflags);
@@ -617,7 +683,9 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 {
   FAR struct timerfd_priv_s *dev;
   FAR struct file *filep;
+#ifndef CONFIG_HRTIMER
   sclock_t ticks;
+#endif
   int ret;
 
   /* Some sanity checks */
@@ -644,6 +712,11 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 
   dev = (FAR struct timerfd_priv_s *)filep->f_priv;
 
+#ifdef CONFIG_HRTIMER
+  clock_nsec2time(&curr_value->it_value,
+                  hrtimer_gettimeleft(&dev->hrtimer));
+  clock_nsec2time(&curr_value->it_interval, dev->period);
+#else
   /* Get the number of ticks before the underlying watchdog expires */
 
   ticks = wd_gettime(&dev->wdog);
@@ -652,6 +725,7 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 
   clock_ticks2time(&curr_value->it_value, ticks);
   clock_ticks2time(&curr_value->it_interval, dev->delay);
+#endif
   fs_putfilep(filep);
   return OK;
 
@@ -0,0 +1,977 @@
+/****************************************************************************
+ * fs/vfs/fs_uring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <sys/uring.h>
+
+#include <poll.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+#include <nuttx/net/net.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Request states, changed under the ring spinlock */
+
+#define URING_REQ_FREE      0  /* In the free list */
+#define URING_REQ_ISSUED    1  /* Being issued by uring_enter() */
+#define URING_REQ_ARMING    2  /* Poll being set up */
+#define URING_REQ_ARMED     3  /* Waiting for the poll callback */
+#define URING_REQ_TIMER     4  /* Waiting for the timeout */
+#define URING_REQ_WORK      5  /* Queued to or running on a worker */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct uring_s;
+
+/* One submitted request */
+
+struct uring_req_s
+{
+  struct list_node     node;     /* Free or wait list */
+  FAR struct uring_s  *ring;     /* The owning ring */
+  FAR struct file     *filep;    /* The target file, NULL if none */
+  struct uring_sqe     sqe;      /* Copy of the submission entry */
+  struct pollfd        pfd;      /* Poll of the target file */
+  struct wdog_s        wdog;     /* TIMEOUT request timer */
+  struct work_s        work;     /* Worker item */
+  uint8_t              state;    /* See URING_REQ_* definitions */
+  bool                 polled;   /* The poll is set up */
+  bool                 ready;    /* The poll fired during its setup */
+};
+
+/* The kernel side of a ring pair */
+
+struct uring_s
+{
+  mutex_t              lock;     /* Serializes the submitters */
+  spinlock_t           spinlock; /* Protects the lists and the CQ tail */
+  sem_t                waitsem;  /* Wakes up uring_enter() waiters */
+  sem_t                idlesem;  /* Wakes up the close */
+  int                  crefs;    /* Reference count */
+  int                  nwaiters; /* Number of uring_enter() waiters */
+  unsigned int         inflight; /* Number of requests not completed */
+  bool                 closing;  /* The last reference is being closed */
+  uint32_t             sqhead;   /* Private copy of the SQ head */
+  uint32_t             cqtail;   /* Private copy of the CQ tail */
+  FAR struct uring_ring *sq;     /* Shared rings */
+  FAR struct uring_sqe *sqes;
+  FAR struct uring_ring *cq;
+  FAR struct uring_cqe *cqes;
+  FAR void            *mem;      /* Shared memory */
+  FAR struct kwork_wqueue_s *wqueue;
+  struct list_node     free;     /* Free requests */
+  struct list_node     wait;     /* Requests waiting for a poll or timer */
+  struct uring_req_s   reqs[1];  /* cq->entries requests */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int uring_open(FAR struct file *filep);
+static int uring_close(FAR struct file *filep);
+
+static void uring_arm(FAR struct uring_req_s *req, pollevent_t events);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_uring_ops =
+{
+  uring_open,       /* open */
+  uring_close,      /* close */
+  NULL,             /* read */
+  NULL,             /* write */
+  NULL,             /* seek */
+  NULL,             /* ioctl */
+  NULL,             /* mmap */
+  NULL,             /* truncate */
+  NULL              /* poll */
+};
+
+static struct inode g_uring_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_uring_ops          /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uring_post
+ *
+ * Description:
+ *   Post the completion entry of a request and free it.  Called from an
+ *   interrupt handler only for requests that have no file.
+ *
+ ****************************************************************************/
+
+static void uring_post(FAR struct uring_req_s *req, ssize_t res)
+{
+  FAR struct uring_s *ring = req->ring;
+  FAR struct uring_cqe *cqe;
+  irqstate_t flags;
+  bool wakeup;
+  bool idle;
+
+  if (req->filep != NULL)
+    {
+      fs_putfilep(req->filep);
+      req->filep = NULL;
+    }
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+
+  cqe = &ring->cqes[ring->cqtail & ring->cq->mask];
+  cqe->user_data = req->sqe.user_data;
+  cqe->res       = res;
+  cqe->flags     = 0;
+
+  /* Make the entry visible before the tail */
+
+  SP_DMB();
+  ring->cq->tail = ++ring->cqtail;
+
+  req->state = URING_REQ_FREE;
+  list_add_tail(&ring->free, &req->node);
+
+  ring->inflight--;
+  wakeup = ring->nwaiters > 0;
+  idle   = ring->closing && ring->inflight == 0;
+
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  if (wakeup)
+    {
+      nxsem_post(&ring->waitsem);
+    }
+
+  if (idle)
+    {
+      nxsem_post(&ring->idlesem);
+    }
+}
+
+/****************************************************************************
+ * Name: uring_perform
+ *
+ * Description:
+ *   Perform a data transfer or fsync request.  Socket requests do not wait
+ *   if 'nonblock' is true.
+ *
+ ****************************************************************************/
+
+static ssize_t uring_perform(FAR struct uring_req_s *req, bool nonblock)
+{
+  FAR struct uring_sqe *sqe = &req->sqe;
+#ifdef CONFIG_NET
+  FAR struct socket *psock;
+  int msgflags;
+#endif
+
+  switch (sqe->opcode)
+    {
+      case URING_OP_READ:
+        if (sqe->off == URING_OFF_CURRENT)
+          {
+            return file_read(req->filep, sqe->addr, sqe->len);
+          }
+
+        return file_pread(req->filep, sqe->addr, sqe->len, sqe->off);
+
+      case URING_OP_WRITE:
+        if (sqe->off == URING_OFF_CURRENT)
+          {
+            return file_write(req->filep, sqe->addr, sqe->len);
+          }
+
+        return file_pwrite(req->filep, sqe->addr, sqe->len, sqe->off);
+
+      case URING_OP_FSYNC:
+        return file_fsync(req->filep);
+
+#ifdef CONFIG_NET
+      case URING_OP_SEND:
+      case URING_OP_RECV:
+        psock = file_socket(req->filep);
+        if (psock == NULL)
+          {
+            return -ENOTSOCK;
+          }
+
+        msgflags = sqe->op_flags | (nonblock ? MSG_DONTWAIT : 0);
+        if (sqe->opcode == URING_OP_SEND)
+          {
+            return psock_send(psock, sqe->addr, sqe->len, msgflags);
+          }
+
+        return psock_recv(psock, sqe->addr, sqe->len, msgflags);
+#endif
+
+      default:
+        return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Name: uring_ready
+ *
+ * Description:
+ *   Complete a request whose poll fired.  The poll is torn down.
+ *
+ ****************************************************************************/
+
+static void uring_ready(FAR struct uring_req_s *req)
+{
+  ssize_t ret;
+
+  switch (req->sqe.opcode)
+    {
+      case URING_OP_POLL:
+        ret = req->pfd.revents;
+        break;
+
+      case URING_OP_SEND:
+      case URING_OP_RECV:
+
+        /* Another reader may have taken the data:  Wait again */
+
+        ret = uring_perform(req, true);
+        if (ret == -EAGAIN)
+          {
+            uring_arm(req, req->pfd.events);
+            return;
+          }
+        break;
+
+      default:
+        ret = uring_perform(req, false);
+        break;
+    }
+
+  uring_post(req, ret);
+}
+
+/****************************************************************************
+ * Name: uring_worker
+ ****************************************************************************/
+
+static void uring_worker(FAR void *arg)
+{
+  FAR struct uring_req_s *req = arg;
+
+  if (req->polled)
+    {
+      file_poll(req->filep, &req->pfd, false);
+      req->polled = false;
+      uring_ready(req);
+    }
+  else
+    {
+      uring_post(req, uring_perform(req, false));
+    }
+}
+
+/****************************************************************************
+ * Name: uring_queue
+ *
+ * Description:
+ *   Run a request on a worker thread of the ring.
+ *
+ ****************************************************************************/
+
+static void uring_queue(FAR struct uring_req_s *req)
+{
+  int ret;
+
+  req->state = URING_REQ_WORK;
+  ret = work_queue_wq(req->ring->wqueue, &req->work, uring_worker, req, 0);
+  DEBUGASSERT(ret >= 0);
+  UNUSED(ret);
+}
+
+/****************************************************************************
+ * Name: uring_poll_cb
+ *
+ * Description:
+ *   The poll callback of a request.  May be called from an interrupt
+ *   handler.
+ *
+ ****************************************************************************/
+
+static void uring_poll_cb(FAR struct pollfd *fds)
+{
+  FAR struct uring_req_s *req = fds->arg;
+  FAR struct uring_s *ring = req->ring;
+  irqstate_t flags;
+  bool queue = false;
+
+  if (fds->revents == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  if (req->state == URING_REQ_ARMING)
+    {
+      /* Already ready: uring_arm() completes the request at once */
+
+      req->ready = true;
+    }
+  else if (req->state == URING_REQ_ARMED)
+    {
+      list_delete(&req->node);
+      req->state = URING_REQ_WORK;
+      queue = true;
+    }
+
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  if (queue)
+    {
+      uring_queue(req);
+    }
+}
+
+/****************************************************************************
+ * Name: uring_arm
+ *
+ * Description:
+ *   Wait for the target file of a request to become ready.  If it is ready
+ *   already, the request completes in the caller context.
+ *
+ ****************************************************************************/
+
+static void uring_arm(FAR struct uring_req_s *req, pollevent_t events)
+{
+  FAR struct uring_s *ring = req->ring;
+  irqstate_t flags;
+  int ret;
+
+  req->pfd.fd      = req->sqe.fd;
+  req->pfd.events  = events | POLLERR | POLLHUP;
+  req->pfd.revents = 0;
+  req->pfd.arg     = req;
+  req->pfd.cb      = uring_poll_cb;
+  req->ready       = false;
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  if (ring->closing)
+    {
+      spin_unlock_irqrestore(&ring->spinlock, flags);
+      uring_post(req, -ECANCELED);
+      return;
+    }
+
+  req->state = URING_REQ_ARMING;
+  list_add_tail(&ring->wait, &req->node);
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  ret = file_poll(req->filep, &req->pfd, true);
+
+  /* uring_cancel() skips the requests being armed */
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  if (ret < 0 || req->ready || ring->closing)
+    {
+      list_delete(&req->node);
+      req->state = URING_REQ_ISSUED;
+    }
+  else
+    {
+      req->polled = true;
+      req->state  = URING_REQ_ARMED;
+    }
+
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  if (ret >= 0 && !req->ready && req->state == URING_REQ_ISSUED)
+    {
+      file_poll(req->filep, &req->pfd, false);
+      uring_post(req, -ECANCELED);
+    }
+  else if (ret == -ENOSYS && req->sqe.opcode != URING_OP_POLL)
+    {
+      /* The file cannot be polled:  Just wait on a worker */
+
+      uring_queue(req);
+    }
+  else if (ret < 0)
+    {
+      uring_post(req, ret);
+    }
+  else if (req->state == URING_REQ_ISSUED)
+    {
+      file_poll(req->filep, &req->pfd, false);
+      uring_ready(req);
+    }
+}
+
+/****************************************************************************
+ * Name: uring_timeout
+ ****************************************************************************/
+
+static void uring_timeout(wdparm_t arg)
+{
+  FAR struct uring_req_s *req = (FAR struct uring_req_s *)arg;
+  FAR struct uring_s *ring = req->ring;
+  irqstate_t flags;
+  bool expired = false;
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  if (req->state == URING_REQ_TIMER)
+    {
+      list_delete(&req->node);
+      req->state = URING_REQ_ISSUED;
+      expired = true;
+    }
+
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  if (expired)
+    {
+      uring_post(req, -ETIME);
+    }
+}
+
+/****************************************************************************
+ * Name: uring_issue
+ *
+ * Description:
+ *   Start a request just taken from the submission queue.  Requests that
+ *   can complete without waiting complete at once:  Sockets are tried
+ *   without blocking and other pollable files are waited for with a poll
+ *   callback instead of a thread.  File system I/O and fsync run on the
+ *   worker threads.
+ *
+ ****************************************************************************/
+
+static void uring_issue(FAR struct uring_req_s *req)
+{
+  FAR struct uring_sqe *sqe = &req->sqe;
+  FAR struct inode *inode;
+  struct timespec ts;
+  irqstate_t flags;
+  ssize_t ret;
+
+  if (sqe->opcode == URING_OP_NOP)
+    {
+      uring_post(req, OK);
+      return;
+    }
+
+  if (sqe->opcode == URING_OP_TIMEOUT)
+    {
+      if (sqe->addr == NULL)
+        {
+          uring_post(req, -EINVAL);
+          return;
+        }
+
+      memcpy(&ts, sqe->addr, sizeof(ts));
+
+      flags = spin_lock_irqsave(&req->ring->spinlock);
+      req->state = URING_REQ_TIMER;
+      list_add_tail(&req->ring->wait, &req->node);
+      spin_unlock_irqrestore(&req->ring->spinlock, flags);
+
+      wd_start(&req->wdog, clock_time2ticks(&ts), uring_timeout,
+               (wdparm_t)req);
+      return;
+    }
+
+  ret = fs_getfilep(sqe->fd, &req->filep);
+  if (ret < 0)
+    {
+      req->filep = NULL;
+      uring_post(req, ret);
+      return;
+    }
+
+  inode = req->filep->f_inode;
+  switch (sqe->opcode)
+    {
+      case URING_OP_READ:
+      case URING_OP_WRITE:
+        if (INODE_IS_MOUNTPT(inode) || INODE_IS_BLOCK(inode) ||
+            INODE_IS_MTD(inode))
+          {
+            uring_queue(req);
+          }
+        else
+          {
+            uring_arm(req, sqe->opcode == URING_OP_READ ? POLLIN : POLLOUT);
+          }
+        break;
+
+      case URING_OP_FSYNC:
+        uring_queue(req);
+        break;
+
+      case URING_OP_POLL:
+        uring_arm(req, sqe->op_flags);
+        break;
+
+#ifdef CONFIG_NET
+      case URING_OP_SEND:
+      case URING_OP_RECV:
+        ret = uring_perform(req, true);
+        if (ret != -EAGAIN)
+          {
+            uring_post(req, ret);
+          }
+        else
+          {
+            uring_arm(req, sqe->opcode == URING_OP_RECV ? POLLIN : POLLOUT);
+          }
+        break;
+#endif
+
+      default:
+        uring_post(req, -EINVAL);
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: uring_cancel
+ *
+ * Description:
+ *   Complete the requests that wait for a poll or a timer with ECANCELED.
+ *
+ ****************************************************************************/
+
+static void uring_cancel(FAR struct uring_s *ring)
+{
+  FAR struct uring_req_s *req;
+  FAR struct uring_req_s *tmp;
+  struct list_node cancel;
+  irqstate_t flags;
+
+  list_initialize(&cancel);
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  list_for_every_entry_safe(&ring->wait, req, tmp, struct uring_req_s, node)
+    {
+      if (req->state != URING_REQ_ARMING)
+        {
+          list_delete(&req->node);
+          req->state = URING_REQ_ISSUED;
+          list_add_tail(&cancel, &req->node);
+        }
+    }
+
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  while (!list_is_empty(&cancel))
+    {
+      req = container_of(list_remove_head(&cancel),
+                         struct uring_req_s, node);
+      if (req->polled)
+        {
+          file_poll(req->filep, &req->pfd, false);
+          req->polled = false;
+        }
+      else
+        {
+          wd_cancel(&req->wdog);
+        }
+
+      uring_post(req, -ECANCELED);
+    }
+}
+
+/****************************************************************************
+ * Name: uring_open
+ ****************************************************************************/
+
+static int uring_open(FAR struct file *filep)
+{
+  FAR struct uring_s *ring = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ring->crefs++;
+  nxmutex_unlock(&ring->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: uring_close
+ ****************************************************************************/
+
+static int uring_close(FAR struct file *filep)
+{
+  FAR struct uring_s *ring = filep->f_priv;
+  irqstate_t flags;
+  bool busy;
+  int ret;
+
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (--ring->crefs > 0)
+    {
+      nxmutex_unlock(&ring->lock);
+      return OK;
+    }
+
+  nxmutex_unlock(&ring->lock);
+
+  /* Cancel what may wait forever, and wait for the worker requests */
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  ring->closing = true;
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  uring_cancel(ring);
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  busy = ring->inflight > 0;
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  if (busy)
+    {
+      nxsem_wait_uninterruptible(&ring->idlesem);
+    }
+
+  work_queue_free(ring->wqueue);
+  nxsem_destroy(&ring->idlesem);
+  nxsem_destroy(&ring->waitsem);
+  nxmutex_destroy(&ring->lock);
+  kumm_free(ring->mem);
+  kmm_free(ring);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: uring_submit
+ *
+ * Description:
+ *   Issue up to 'to_submit' submission queue entries.
+ *
+ ****************************************************************************/
+
+static int uring_submit(FAR struct uring_s *ring, unsigned int to_submit)
+{
+  FAR struct uring_req_s *req;
+  irqstate_t flags;
+  uint32_t nready;
+  uint32_t ncq;
+  int ret;
+  int n;
+
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nready = ring->sq->tail - ring->sqhead;
+  if (nready > ring->sq->entries)
+    {
+      nxmutex_unlock(&ring->lock);
+      return -EINVAL;
+    }
+
+  /* Read the entries after the tail */
+
+  SP_DMB();
+
+  for (n = 0; n < MIN(to_submit, nready); n++)
+    {
+      /* Each request needs a completion queue entry */
+
+      flags = spin_lock_irqsave(&ring->spinlock);
+      ncq = ring->cqtail - ring->cq->head;
+      if (ring->inflight + ncq >= ring->cq->entries)
+        {
+          spin_unlock_irqrestore(&ring->spinlock, flags);
+          break;
+        }
+
+      req = container_of(list_remove_head(&ring->free),
+                         struct uring_req_s, node);
+      req->state = URING_REQ_ISSUED;
+      ring->inflight++;
+      spin_unlock_irqrestore(&ring->spinlock, flags);
+
+      memcpy(&req->sqe, &ring->sqes[ring->sqhead & ring->sq->mask],
+             sizeof(req->sqe));
+      ring->sq->head = ++ring->sqhead;
+
+      uring_issue(req);
+    }
+
+  nxmutex_unlock(&ring->lock);
+  return n == 0 && to_submit > 0 && nready > 0 ? -EBUSY : n;
+}
+
+/****************************************************************************
+ * Name: uring_wait
+ *
+ * Description:
+ *   Wait until the completion queue holds 'min_complete' entries.
+ *
+ ****************************************************************************/
+
+static int uring_wait(FAR struct uring_s *ring, unsigned int min_complete)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  while (ring->cqtail - ring->cq->head < min_complete)
+    {
+      ring->nwaiters++;
+      spin_unlock_irqrestore(&ring->spinlock, flags);
+
+      ret = nxsem_wait(&ring->waitsem);
+
+      flags = spin_lock_irqsave(&ring->spinlock);
+      ring->nwaiters--;
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uring_setup
+ ****************************************************************************/
+
+int uring_setup(unsigned int entries, FAR struct uring_params *params)
+{
+  FAR struct uring_s *ring;
+  FAR uint8_t *mem;
+  uint32_t sqentries;
+  uint32_t cqentries;
+  uint32_t i;
+  int ret;
+  int fd;
+
+  if (params == NULL || params->flags != 0 || entries == 0 ||
+      entries > CONFIG_FS_URING_MAXENTRIES)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  sqentries = 1;
+  while (sqentries < entries)
+    {
+      sqentries <<= 1;
+    }
+
+  cqentries = 2 * sqentries;
+
+  ring = kmm_zalloc(sizeof(struct uring_s) +
+                    (cqentries - 1) * sizeof(struct uring_req_s));
+  if (ring == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  /* The rings live in memory that the application can access */
+
+  mem = kumm_zalloc(2 * sizeof(struct uring_ring) +
+                    sqentries * sizeof(struct uring_sqe) +
+                    cqentries * sizeof(struct uring_cqe));
+  if (mem == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_ring;
+    }
+
+  ring->mem  = mem;
+  ring->sq   = (FAR struct uring_ring *)mem;
+  ring->cq   = ring->sq + 1;
+  ring->sqes = (FAR struct uring_sqe *)(ring->cq + 1);
+  ring->cqes = (FAR struct uring_cqe *)(ring->sqes + sqentries);
+
+  ring->sq->mask    = sqentries - 1;
+  ring->sq->entries = sqentries;
+  ring->cq->mask    = cqentries - 1;
+  ring->cq->entries = cqentries;
+
+  ring->wqueue = work_queue_create("uring", CONFIG_FS_URING_PRIORITY,
+                                   CONFIG_FS_URING_STACKSIZE,
+                                   CONFIG_FS_URING_NTHREADS);
+  if (ring->wqueue == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_mem;
+    }
+
+  nxmutex_init(&ring->lock);
+  spin_lock_init(&ring->spinlock);
+  nxsem_init(&ring->waitsem, 0, 0);
+  nxsem_init(&ring->idlesem, 0, 0);
+  list_initialize(&ring->free);
+  list_initialize(&ring->wait);
+
+  for (i = 0; i < cqentries; i++)
+    {
+      ring->reqs[i].ring = ring;
+      list_add_tail(&ring->free, &ring->reqs[i].node);
+    }
+
+  ring->crefs = 1;
+
+  fd = file_allocate(&g_uring_inode, O_RDWR | O_CLOEXEC, 0, ring, 0, true);
+  if (fd < 0)
+    {
+      ret = fd;
+      goto errout_with_wqueue;
+    }
+
+  params->sq_entries = sqentries;
+  params->cq_entries = cqentries;
+  params->sq         = ring->sq;
+  params->sqes       = ring->sqes;
+  params->cq         = ring->cq;
+  params->cqes       = ring->cqes;
+  return fd;
+
+errout_with_wqueue:
+  nxsem_destroy(&ring->idlesem);
+  nxsem_destroy(&ring->waitsem);
+  nxmutex_destroy(&ring->lock);
+  work_queue_free(ring->wqueue);
+errout_with_mem:
+  kumm_free(mem);
+errout_with_ring:
+  kmm_free(ring);
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: uring_enter
+ ****************************************************************************/
+
+int uring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                unsigned int flags)
+{
+  FAR struct uring_s *ring;
+  FAR struct file *filep;
+  int submitted = 0;
+  int ret;
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (filep->f_inode->u.i_ops != &g_uring_ops ||
+      (flags & ~URING_ENTER_GETEVENTS) != 0)
+    {
+      ret = filep->f_inode->u.i_ops != &g_uring_ops ? -EBADF : -EINVAL;
+      goto errout_with_filep;
+    }
+
+  ring = filep->f_priv;
+
+  if (to_submit > 0)
+    {
+      ret = uring_submit(ring, to_submit);
+      if (ret < 0)
+        {
+          goto errout_with_filep;
+        }
+
+      submitted = ret;
+    }
+
+  if ((flags & URING_ENTER_GETEVENTS) != 0 && min_complete > 0)
+    {
+      ret = uring_wait(ring, MIN(min_complete, ring->cq->entries));
+      if (ret < 0 && submitted == 0)
+        {
+          goto errout_with_filep;
+        }
+    }
+
+  fs_putfilep(filep);
+  return submitted;
+
+errout_with_filep:
+  fs_putfilep(filep);
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
@@ -25,11 +25,13 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sched.h>
 #include <errno.h>
 #include <assert.h>
+#include <limits.h>
 
 #include <nuttx/cancelpt.h>
 
@@ -220,3 +222,198 @@ ssize_t write(int fd, FAR const void *buf, size_t nbytes)
   leave_cancellation_point();
   return ret;
 }
+
+/****************************************************************************
+ * Name: file_writev
+ *
+ * Description:
+ *   Equivalent to the standard writev() function except that is accepts a
+ *   struct file instance instead of a file descriptor.  It is functionally
+ *   equivalent to writev() except that in addition to the differences in
+ *   input parameters:
+ *
+ *  - It does not modify the errno variable,
+ *  - It is not a cancellation point, and
+ *
+ * Input Parameters:
+ *   filep  - Instance of struct file to use with the write
+ *   iov    - The segments to write
+ *   iovcnt - The number of segments
+ *
+ * Returned Value:
+ *  On success, the number of bytes written are returned (zero indicates
+ *  nothing was written).  On any failure, a negated errno value is returned
+ *  (see comments with write() for a description of the appropriate errno
+ *  values).
+ *
+ ****************************************************************************/
+
+ssize_t file_writev(FAR struct file *filep,
+                    FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct inode *inode;
+  ssize_t ntotal = 0;
+  ssize_t ret;
+  int i;
+
+  /* Was this file opened for write access? */
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EACCES;
+    }
+
+  inode = filep->f_inode;
+  if (!inode || !inode->u.i_ops)
+    {
+      return -EBADF;
+    }
+
+  /* The writev method is not common to the driver and the mountpoint
+   * operations.
+   */
+
+  if (!INODE_IS_MOUNTPT(inode) && inode->u.i_ops->writev)
+    {
+      ret = inode->u.i_ops->writev(filep, iov, iovcnt);
+    }
+  else if (inode->u.i_ops->write)
+    {
+      /* Write the segments one by one up to the first short write */
+
+      for (i = 0, ret = 0; i < iovcnt; i++)
+        {
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
+
+          ret = inode->u.i_ops->write(filep, iov[i].iov_base,
+                                      iov[i].iov_len);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          ntotal += ret;
+          if ((size_t)ret < iov[i].iov_len)
+            {
+              break;
+            }
+        }
+
+      if (ret >= 0 || ntotal > 0)
+        {
+          ret = ntotal;
+        }
+    }
+  else
+    {
+      return -EBADF;
+    }
+
+#ifdef CONFIG_FS_NOTIFY
+  if (ret > 0)
+    {
+      notify_write(filep);
+    }
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nx_writev
+ *
+ * Description:
+ *  nx_writev() is an internal OS function.  It is functionally equivalent
+ *  to writev() except that:
+ *
+ *  - It does not modify the errno variable, and
+ *  - It is not a cancellation point.
+ *
+ * Input Parameters:
+ *   fd     - file descriptor to write to
+ *   iov    - The segments to write
+ *   iovcnt - The number of segments
+ *
+ * Returned Value:
+ *  On success, the number of bytes written are returned (zero indicates
+ *  nothing was written).  On any failure, a negated errno value is returned
+ *  (see comments with write() for a description of the appropriate errno
+ *  values).
+ *
+ ****************************************************************************/
+
+ssize_t nx_writev(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct file *filep;
+  size_t total = 0;
+  ssize_t ret;
+  int i;
+
+  if (iovcnt < 0 || (iov == NULL && iovcnt > 0))
+    {
+      return -EINVAL;
+    }
+
+  /* The total length must fit in the return value */
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len > SSIZE_MAX - total)
+        {
+          return -EINVAL;
+        }
+
+      total += iov[i].iov_len;
+    }
+
+  ret = (ssize_t)fs_getfilep(fd, &filep);
+  if (ret >= 0)
+    {
+      ret = file_writev(filep, iov, iovcnt);
+      fs_putfilep(filep);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: writev
+ *
+ * Description:
+ *  writev() writes the segments described by iov, in order, to the file
+ *  referenced by the file descriptor fd.  Drivers that provide the writev
+ *  method receive all of the segments in one call.
+ *
+ * Input Parameters:
+ *   fd     - file descriptor to write to
+ *   iov    - The segments to write
+ *   iovcnt - The number of segments
+ *
+ * Returned Value:
+ *  On success, the number of bytes written are returned (zero indicates
+ *  nothing was written). On error, -1 is returned, and errno is set
+ *  appropriately (see write()).
+ *
+ ****************************************************************************/
+
+ssize_t writev(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t ret;
+
+  /* writev() is a cancellation point */
+
+  enter_cancellation_point();
+
+  ret = nx_writev(fd, iov, iovcnt);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
@@ -35,10 +35,35 @@
 
 #include <unzip.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_ZIPFS_CACHE_SIZE > 0
+#  define ZIPFS_CACHE_NBLOCKS \
+     (CONFIG_ZIPFS_CACHE_SIZE / CONFIG_ZIPFS_CACHE_BLKSIZE)
+#else
+#  define ZIPFS_CACHE_NBLOCKS 0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* A block of decompressed data in the cache of the mount.  Blocks are
+ * aligned to CONFIG_ZIPFS_CACHE_BLKSIZE in the uncompressed entry, and the
+ * entry is identified by the position of its central directory record.
+ */
+
+struct zipfs_block_s
+{
+  ZPOS64_T entry;                   /* Central directory position of entry */
+  off_t block;                      /* Block number in the entry */
+  uint32_t age;                     /* Last use, for LRU replacement */
+  uint16_t len;                     /* Valid bytes, zero if the slot is free */
+  FAR uint8_t *data;                /* CONFIG_ZIPFS_CACHE_BLKSIZE bytes */
+};
+
 struct zipfs_dir_s
 {
   struct fs_dirent_s base;
@@ -49,6 +74,11 @@ struct zipfs_dir_s
 
 struct zipfs_mountpt_s
 {
+#if ZIPFS_CACHE_NBLOCKS > 0
+  mutex_t lock;                     /* Protects the cache */
+  uint32_t clock;                   /* Age of the most recent use */
+  struct zipfs_block_s cache[ZIPFS_CACHE_NBLOCKS];
+#endif
   char abspath[1];
 };
 
@@ -57,6 +87,9 @@ struct zipfs_file_s
   unzFile uf;
   mutex_t lock;
   FAR char *seekbuf;
+  ZPOS64_T entry;                   /* Central directory position of entry */
+  off_t size;                       /* Uncompressed size of the entry */
+  off_t pos;                        /* Offset of the next inflated byte */
   char relpath[1];
 };
 
@@ -242,6 +275,8 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
 {
   FAR struct zipfs_mountpt_s *fs = filep->f_inode->i_private;
   FAR struct zipfs_file_s *fp;
+  unz_file_info64 file_info;
+  unz64_file_pos filepos;
   int ret;
 
   DEBUGASSERT(fs != NULL);
@@ -277,9 +312,21 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
       goto err_with_zip;
     }
 
+  ret = zipfs_convert_result(unzGetCurrentFileInfo64(fp->uf, &file_info,
+                                                     NULL, 0, NULL, 0,
+                                                     NULL, 0));
+  if (ret < 0)
+    {
+      goto err_with_zip;
+    }
+
+  ret = zipfs_convert_result(unzGetFilePos64(fp->uf, &filepos));
   if (ret == OK)
     {
       fp->seekbuf = NULL;
+      fp->entry   = filepos.pos_in_zip_directory;
+      fp->size    = file_info.uncompressed_size;
+      fp->pos     = 0;
       strcpy(fp->relpath, relpath);
       filep->f_priv = fp;
     }
@@ -308,23 +355,52 @@ static int zipfs_close(FAR struct file *filep)
   return ret;
 }
 
-static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
-                          size_t buflen)
+static int zipfs_rewind(FAR struct zipfs_file_s *fp)
 {
-  FAR struct zipfs_file_s *fp = filep->f_priv;
-  ssize_t ret;
+  int ret;
 
-  nxmutex_lock(&fp->lock);
-  ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer, buflen));
-  if (ret > 0)
+  /* Restart inflating the entry from its beginning.  The archive stays
+   * open and positioned on the entry.
+   */
+
+  ret = zipfs_convert_result(unzCloseCurrentFile(fp->uf));
+  if (ret >= 0)
     {
-      filep->f_pos += ret;
+      ret = zipfs_convert_result(unzOpenCurrentFile(fp->uf));
     }
 
-  nxmutex_unlock(&fp->lock);
+  fp->pos = 0;
   return ret;
 }
 
+static ssize_t zipfs_inflate(FAR struct zipfs_file_s *fp,
+                             FAR char *buffer, size_t buflen)
+{
+  size_t nread = 0;
+  int ret;
+
+  while (nread < buflen)
+    {
+      ret = unzReadCurrentFile(fp->uf, buffer + nread, buflen - nread);
+      ret = zipfs_convert_result(ret);
+      if (ret <= 0)
+        {
+          if (nread == 0)
+            {
+              return ret;
+            }
+
+          break;
+        }
+
+      nread += ret;
+    }
+
+  fp->pos += nread;
+  return nread;
+}
+
+#if ZIPFS_CACHE_NBLOCKS == 0
 static off_t zipfs_skip(FAR struct zipfs_file_s *fp, off_t amount)
 {
   off_t next = 0;
@@ -347,8 +423,7 @@ static off_t zipfs_skip(FAR struct zipfs_file_s *fp, off_t amount)
           remain = CONFIG_ZIPFS_SEEK_BUFSIZE;
         }
 
-      remain = unzReadCurrentFile(fp->uf, fp->seekbuf, remain);
-      remain = zipfs_convert_result(remain);
+      remain = zipfs_inflate(fp, fp->seekbuf, remain);
       if (remain <= 0)
         {
           return next ? next : remain;
@@ -359,84 +434,243 @@ static off_t zipfs_skip(FAR struct zipfs_file_s *fp, off_t amount)
 
   return next;
 }
+#else
+static ssize_t zipfs_cache_read(FAR struct zipfs_mountpt_s *fs,
+                                FAR struct zipfs_file_s *fp,
+                                off_t pos, FAR char *buffer,
+                                size_t buflen)
+{
+  FAR struct zipfs_block_s *blk;
+  off_t block = pos / CONFIG_ZIPFS_CACHE_BLKSIZE;
+  size_t offset = pos % CONFIG_ZIPFS_CACHE_BLKSIZE;
+  ssize_t ret = 0;
+  int i;
+
+  nxmutex_lock(&fs->lock);
+  for (i = 0; i < ZIPFS_CACHE_NBLOCKS; i++)
+    {
+      blk = &fs->cache[i];
+      if (blk->len > offset && blk->entry == fp->entry &&
+          blk->block == block)
+        {
+          ret = blk->len - offset;
+          if ((size_t)ret > buflen)
+            {
+              ret = buflen;
+            }
+
+          memcpy(buffer, blk->data + offset, ret);
+          blk->age = ++fs->clock;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&fs->lock);
+  return ret;
+}
 
-static off_t zipfs_seek(FAR struct file *filep, off_t offset,
-                        int whence)
+static void zipfs_cache_add(FAR struct zipfs_mountpt_s *fs,
+                            FAR struct zipfs_file_s *fp, off_t block,
+                            FAR const char *data, size_t len)
 {
-  FAR struct zipfs_mountpt_s *fs = filep->f_inode->i_private;
-  FAR struct zipfs_file_s *fp = filep->f_priv;
-  unz_file_info64 file_info;
-  off_t ret = 0;
+  FAR struct zipfs_block_s *victim = &fs->cache[0];
+  FAR struct zipfs_block_s *blk;
+  int i;
 
-  nxmutex_lock(&fp->lock);
-  switch (whence)
+  nxmutex_lock(&fs->lock);
+  for (i = 0; i < ZIPFS_CACHE_NBLOCKS; i++)
     {
-      case SEEK_SET:
-        break;
-      case SEEK_CUR:
-        offset += filep->f_pos;
-        break;
-      case SEEK_END:
-        ret = unzGetCurrentFileInfo64(fp->uf, &file_info,
-                                      NULL, 0, NULL, 0, NULL, 0);
-        ret = zipfs_convert_result(ret);
-        if (ret < 0)
-          {
-            goto err_with_lock;
-          }
-
-          offset += file_info.uncompressed_size;
-        break;
-      default:
-        ret = -EINVAL;
-        goto err_with_lock;
+      blk = &fs->cache[i];
+      if (blk->len == 0)
+        {
+          victim = blk;
+          break;
+        }
+
+      if (fs->clock - blk->age > fs->clock - victim->age)
+        {
+          victim = blk;
+        }
     }
 
-  if (filep->f_pos == offset)
+  memcpy(victim->data, data, len);
+  victim->entry = fp->entry;
+  victim->block = block;
+  victim->len   = len;
+  victim->age   = ++fs->clock;
+  nxmutex_unlock(&fs->lock);
+}
+
+static int zipfs_cache_fill(FAR struct zipfs_mountpt_s *fs,
+                            FAR struct zipfs_file_s *fp, off_t pos)
+{
+  off_t start = pos - pos % CONFIG_ZIPFS_CACHE_BLKSIZE;
+  ssize_t ret;
+
+  if (fp->seekbuf == NULL)
     {
-      goto err_with_lock;
+      fp->seekbuf = kmm_malloc(CONFIG_ZIPFS_CACHE_BLKSIZE);
+      if (fp->seekbuf == NULL)
+        {
+          return -ENOMEM;
+        }
     }
-  else if (filep->f_pos > offset)
+
+  if (fp->pos > start)
     {
-      ret = zipfs_convert_result(unzClose(fp->uf));
+      ret = zipfs_rewind(fp);
       if (ret < 0)
         {
-          goto err_with_lock;
+          return ret;
         }
+    }
+
+  /* Inflate up to the block containing 'pos', keeping each block that is
+   * passed in the cache.  A later seek back into them will not need to
+   * inflate the entry again from its beginning.
+   */
+
+  while (fp->pos <= start)
+    {
+      off_t block = fp->pos / CONFIG_ZIPFS_CACHE_BLKSIZE;
 
-      fp->uf = unzOpen2_64(fs->abspath, &zipfs_real_ops);
-      if (fp->uf == NULL)
+      ret = zipfs_inflate(fp, fp->seekbuf, CONFIG_ZIPFS_CACHE_BLKSIZE);
+      if (ret <= 0)
         {
-          ret = -EINVAL;
-          goto err_with_lock;
+          return ret < 0 ? ret : -EIO;
         }
 
-      ret = zipfs_convert_result(unzLocateFile(fp->uf, fp->relpath, 0));
-      if (ret < 0)
+      zipfs_cache_add(fs, fp, block, fp->seekbuf, ret);
+    }
+
+  return OK;
+}
+#endif
+
+static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+#if ZIPFS_CACHE_NBLOCKS > 0
+  FAR struct zipfs_mountpt_s *fs = filep->f_inode->i_private;
+#endif
+  FAR struct zipfs_file_s *fp = filep->f_priv;
+  size_t nread = 0;
+  ssize_t ret = 0;
+
+  nxmutex_lock(&fp->lock);
+
+  if (filep->f_pos >= fp->size)
+    {
+      goto out;
+    }
+
+  if (buflen > fp->size - filep->f_pos)
+    {
+      buflen = fp->size - filep->f_pos;
+    }
+
+  while (nread < buflen)
+    {
+#if ZIPFS_CACHE_NBLOCKS > 0
+      /* Copy from the decompressed blocks of the mount, filling the
+       * missing block first.
+       */
+
+      ret = zipfs_cache_read(fs, fp, filep->f_pos, buffer + nread,
+                             buflen - nread);
+      if (ret == 0)
         {
-          goto err_with_lock;
+          ret = zipfs_cache_fill(fs, fp, filep->f_pos);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          continue;
         }
+#else
+      /* The seek was only recorded, move the inflate stream there now */
 
-      ret = zipfs_convert_result(unzOpenCurrentFile(fp->uf));
-      if (ret < 0)
+      if (fp->pos != filep->f_pos)
         {
-          goto err_with_lock;
+          if (fp->pos > filep->f_pos)
+            {
+              ret = zipfs_rewind(fp);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+
+          ret = zipfs_skip(fp, filep->f_pos - fp->pos);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          if (fp->pos != filep->f_pos)
+            {
+              ret = -EIO;
+              break;
+            }
         }
 
-      filep->f_pos = 0;
+      ret = zipfs_inflate(fp, buffer + nread, buflen - nread);
+      if (ret <= 0)
+        {
+          break;
+        }
+#endif
+
+      filep->f_pos += ret;
+      nread        += ret;
     }
 
-  ret = zipfs_skip(fp, offset - filep->f_pos);
-  if (ret < 0)
+out:
+  nxmutex_unlock(&fp->lock);
+  return nread > 0 ? nread : ret;
+}
+
+static off_t zipfs_seek(FAR struct file *filep, off_t offset,
+                        int whence)
+{
+  FAR struct zipfs_file_s *fp = filep->f_priv;
+  off_t ret = 0;
+
+  /* Only the file position is updated here, zipfs_read() moves the inflate
+   * stream when it is needed.  So pread(), which seeks back and forth,
+   * leaves the stream of the sequential reads alone.
+   */
+
+  nxmutex_lock(&fp->lock);
+  switch (whence)
+    {
+      case SEEK_SET:
+        break;
+      case SEEK_CUR:
+        offset += filep->f_pos;
+        break;
+      case SEEK_END:
+        offset += fp->size;
+        break;
+      default:
+        ret = -EINVAL;
+        goto err_with_lock;
+    }
+
+  if (offset < 0)
     {
+      ret = -EINVAL;
       goto err_with_lock;
     }
 
-  if (ret >= 0)
+  if (offset > fp->size)
     {
-      filep->f_pos += ret;
+      offset = fp->size;
     }
 
+  filep->f_pos = offset;
+
 err_with_lock:
   nxmutex_unlock(&fp->lock);
   return ret < 0 ? ret : filep->f_pos;
@@ -578,6 +812,10 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
 {
   FAR struct zipfs_mountpt_s *fs;
   unzFile uf;
+#if ZIPFS_CACHE_NBLOCKS > 0
+  FAR uint8_t *blocks;
+  int i;
+#endif
 
   if (data == NULL)
     {
@@ -598,6 +836,25 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
     }
 
   unzClose(uf);
+
+#if ZIPFS_CACHE_NBLOCKS > 0
+  /* Allocate the decompressed block cache shared by the open files */
+
+  blocks = kmm_malloc(ZIPFS_CACHE_NBLOCKS * CONFIG_ZIPFS_CACHE_BLKSIZE);
+  if (blocks == NULL)
+    {
+      kmm_free(fs);
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < ZIPFS_CACHE_NBLOCKS; i++)
+    {
+      fs->cache[i].data = blocks + i * CONFIG_ZIPFS_CACHE_BLKSIZE;
+    }
+
+  nxmutex_init(&fs->lock);
+#endif
+
   strcpy(fs->abspath, data);
   *handle = fs;
 
@@ -607,6 +864,13 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
 static int zipfs_unbind(FAR void *handle, FAR struct inode **driver,
                         unsigned int flags)
 {
+#if ZIPFS_CACHE_NBLOCKS > 0
+  FAR struct zipfs_mountpt_s *fs = handle;
+
+  nxmutex_destroy(&fs->lock);
+  kmm_free(fs->cache[0].data);
+#endif
+
   kmm_free(handle);
   return OK;
 }
@@ -29,7 +29,9 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/nx/nxglib.h>
 
@@ -173,26 +175,20 @@
 #endif /* CONFIG_NX_ANTIALIASING */
 #else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
 
+/* Fill and copy whole machine words at a time.  The rows being copied may
+ * overlap when a rectangle is moved horizontally.
+ */
+
+#if NXGLIB_BITSPERPIXEL == 16
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
-     nxgl_coord_t     _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-       } \
-   }
+     nxgl_memset16((FAR uint16_t *)(dest), (value), (width))
+#else
+#  define NXGL_MEMSET(dest,value,width) \
+     nxgl_memset32((FAR uint32_t *)(dest), (value), (width))
+#endif
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
-     FAR NXGL_PIXEL_T *_sptr = (FAR NXGL_PIXEL_T*)(src); \
-     nxgl_coord_t      _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+     memmove((dest), (src), (size_t)(width) * sizeof(NXGL_PIXEL_T))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -228,6 +224,97 @@ extern "C"
  * Public Functions Definitions
  ****************************************************************************/
 
+#if NXGLIB_BITSPERPIXEL == 16
+/****************************************************************************
+ * Name: nxgl_memset16
+ *
+ * Description:
+ *   Fill a run of 16-bit pixels, storing a machine word of pixels at a time
+ *   once the destination is aligned.
+ *
+ ****************************************************************************/
+
+static inline void nxgl_memset16(FAR uint16_t *dest, uint16_t value,
+                                 size_t npixels)
+{
+  uintptr_t wide;
+
+  if ((value >> 8) == (value & 0xff))
+    {
+      memset(dest, value & 0xff, npixels * sizeof(uint16_t));
+      return;
+    }
+
+  while (npixels > 0 && ((uintptr_t)dest & (sizeof(uintptr_t) - 1)) != 0)
+    {
+      *dest++ = value;
+      npixels--;
+    }
+
+  wide  = value;
+  wide |= wide << 16;
+#if UINTPTR_MAX > UINT32_MAX
+  wide |= wide << 32;
+#endif
+
+  for (; npixels >= sizeof(uintptr_t) / sizeof(uint16_t);
+       npixels -= sizeof(uintptr_t) / sizeof(uint16_t))
+    {
+      *(FAR uintptr_t *)dest = wide;
+      dest += sizeof(uintptr_t) / sizeof(uint16_t);
+    }
+
+  while (npixels-- > 0)
+    {
+      *dest++ = value;
+    }
+}
+#elif NXGLIB_BITSPERPIXEL == 32
+/****************************************************************************
+ * Name: nxgl_memset32
+ *
+ * Description:
+ *   Fill a run of 32-bit pixels, storing a machine word of pixels at a time
+ *   once the destination is aligned.
+ *
+ ****************************************************************************/
+
+static inline void nxgl_memset32(FAR uint32_t *dest, uint32_t value,
+                                 size_t npixels)
+{
+  uintptr_t wide;
+
+  if (value == (value & 0xff) * UINT32_C(0x01010101))
+    {
+      memset(dest, value & 0xff, npixels * sizeof(uint32_t));
+      return;
+    }
+
+  while (npixels > 0 && ((uintptr_t)dest & (sizeof(uintptr_t) - 1)) != 0)
+    {
+      *dest++ = value;
+      npixels--;
+    }
+
+  wide = value;
+#if UINTPTR_MAX > UINT32_MAX
+  wide |= wide << 32;
+#endif
+
+  for (; npixels >= sizeof(uintptr_t) / sizeof(uint32_t);
+       npixels -= sizeof(uintptr_t) / sizeof(uint32_t))
+    {
+      *(FAR uintptr_t *)dest = wide;
+      dest += sizeof(uintptr_t) / sizeof(uint32_t);
+    }
+
+  while (npixels-- > 0)
+    {
+      *dest++ = value;
+    }
+}
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -276,6 +276,18 @@ int nxmu_mousein(FAR struct nxmu_state_s *nxmu,
 void nxmu_kbdin(FAR struct nxmu_state_s *nxmu, uint8_t nch, FAR uint8_t *ch);
 #endif
 
+/****************************************************************************
+ * Name: nxmu_cmdring
+ *
+ * Description:
+ *   Execute all drawing commands in the command ring of a client.
+ *
+ ****************************************************************************/
+
+#ifdef NX_CMDRING
+void nxmu_cmdring(FAR struct nxmu_conn_s *conn);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,178 @@
+/****************************************************************************
+ * graphics/nxmu/nxmu_cmdring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/nx/nxmu.h>
+
+#include "nxmu.h"
+
+#ifdef NX_CMDRING
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmu_cmdexec
+ *
+ * Description:
+ *   Execute one command from the ring.  Only commands that need no reply
+ *   other than a semaphore are queued in the ring.
+ *
+ ****************************************************************************/
+
+static void nxmu_cmdexec(FAR struct nxsvrmsg_s *msg)
+{
+  switch (msg->msgid)
+    {
+      case NX_SVRMSG_SETPIXEL:
+        {
+          FAR struct nxsvrmsg_setpixel_s *setmsg =
+            (FAR struct nxsvrmsg_setpixel_s *)msg;
+          nxbe_setpixel(setmsg->wnd, &setmsg->pos, setmsg->color);
+        }
+        break;
+
+      case NX_SVRMSG_FILL:
+        {
+          FAR struct nxsvrmsg_fill_s *fillmsg =
+            (FAR struct nxsvrmsg_fill_s *)msg;
+          nxbe_fill(fillmsg->wnd, &fillmsg->rect, fillmsg->color);
+        }
+        break;
+
+      case NX_SVRMSG_FILLTRAP:
+        {
+          FAR struct nxsvrmsg_filltrapezoid_s *trapmsg =
+            (FAR struct nxsvrmsg_filltrapezoid_s *)msg;
+          nxbe_filltrapezoid(trapmsg->wnd, &trapmsg->clip,
+                             &trapmsg->trap, trapmsg->color);
+        }
+        break;
+
+      case NX_SVRMSG_MOVE:
+        {
+          FAR struct nxsvrmsg_move_s *movemsg =
+            (FAR struct nxsvrmsg_move_s *)msg;
+          nxbe_move(movemsg->wnd, &movemsg->rect, &movemsg->offset);
+        }
+        break;
+
+      case NX_SVRMSG_BITMAP:
+        {
+          /* The image is read in place from the client memory */
+
+          FAR struct nxsvrmsg_bitmap_s *bmpmsg =
+            (FAR struct nxsvrmsg_bitmap_s *)msg;
+          nxbe_bitmap(bmpmsg->wnd, &bmpmsg->dest, bmpmsg->src,
+                      &bmpmsg->origin, bmpmsg->stride);
+
+          if (bmpmsg->sem_done)
+            {
+              nxsem_post(bmpmsg->sem_done);
+            }
+        }
+        break;
+
+      case NX_SVRMSG_FENCE:
+        {
+          FAR struct nxsvrmsg_fence_s *fencemsg =
+            (FAR struct nxsvrmsg_fence_s *)msg;
+          nxsem_post(fencemsg->sem_done);
+        }
+        break;
+
+      default:
+        gerr("ERROR: Unexpected ring command: %" PRId32 "\n", msg->msgid);
+        break;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmu_cmdring
+ *
+ * Description:
+ *   Execute all drawing commands in the command ring of a client.
+ *
+ * Input Parameters:
+ *   conn - The client connection
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmu_cmdring(FAR struct nxmu_conn_s *conn)
+{
+  FAR struct nxmu_cmdring_s *ring = conn->ring;
+  FAR uint8_t *buffer = (FAR uint8_t *)ring->buffer;
+  unsigned int head;
+  unsigned int tail;
+  uint32_t msglen;
+
+  /* Clear the request first: a command written after this point makes
+   * the client send a new request, one written before is seen below.
+   */
+
+  atomic_store(&ring->pending, 0);
+
+  tail = atomic_load(&ring->tail);
+  while (tail != (head = atomic_load(&ring->head)))
+    {
+      while (tail != head)
+        {
+          msglen = *(FAR uint32_t *)&buffer[tail & NX_CMDRING_MASK];
+          if (msglen == 0)
+            {
+              /* Skip the unused end of the ring */
+
+              tail += CONFIG_NX_CMDRING_SIZE - (tail & NX_CMDRING_MASK);
+              continue;
+            }
+
+          nxmu_cmdexec((FAR struct nxsvrmsg_s *)
+                       &buffer[(tail & NX_CMDRING_MASK) + sizeof(uint32_t)]);
+          tail += NX_CMDRING_RECLEN(msglen);
+        }
+
+      atomic_store(&ring->tail, tail);
+    }
+
+  if (atomic_exchange(&ring->waiting, 0) != 0)
+    {
+      nxsem_post(&ring->space);
+    }
+}
+
+#endif /* NX_CMDRING */
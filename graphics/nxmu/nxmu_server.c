@@ -574,6 +574,24 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
             }
             break;
 
+#ifdef NX_CMDRING
+          case NX_SVRMSG_CMDRING: /* Execute the commands in a client ring */
+            {
+              FAR struct nxsvrmsg_s *ringmsg =
+                (FAR struct nxsvrmsg_s *)buffer;
+              nxmu_cmdring(ringmsg->conn);
+            }
+            break;
+#endif
+
+          case NX_SVRMSG_FENCE: /* All previous commands are done */
+            {
+              FAR struct nxsvrmsg_fence_s *fencemsg =
+                (FAR struct nxsvrmsg_fence_s *)buffer;
+              nxsem_post(fencemsg->sem_done);
+            }
+            break;
+
           /* Messages sent to the background window *************************/
 
           case NX_CLIMSG_REDRAW: /* Re-draw the background window */
@@ -0,0 +1,147 @@
+/****************************************************************************
+ * include/crypto/accel.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_CRYPTO_ACCEL_H
+#define __INCLUDE_CRYPTO_ACCEL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef CONFIG_CRYPTO_ACCEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of one expanded AES key schedule in the byte order used by the CPU
+ * AES instructions: (AES_MAXROUNDS + 1) round keys of 16 bytes.
+ */
+
+#define CRYPTO_ACCEL_AES_RKLEN  (15 * 16)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* CPU instruction backed crypto kernels.  A backend leaves the operations
+ * the CPU cannot do NULL and the portable C code is used for those.
+ *
+ * AES round keys are FIPS-197 byte order; 'dk' is the equivalent inverse
+ * cipher schedule (InvMixColumns applied to the inner round keys, in
+ * reverse order).  GHASH state and subkey are GCM byte order.
+ */
+
+struct crypto_accel_s
+{
+  FAR const char *name;
+
+  CODE void (*aes_deckey)(FAR uint8_t *dk, FAR const uint8_t *ek,
+                          unsigned int nr);
+  CODE void (*aes_encrypt)(FAR const uint8_t *ek, unsigned int nr,
+                           FAR const uint8_t *src, FAR uint8_t *dst,
+                           size_t nblocks);
+  CODE void (*aes_decrypt)(FAR const uint8_t *dk, unsigned int nr,
+                           FAR const uint8_t *src, FAR uint8_t *dst,
+                           size_t nblocks);
+
+  /* Z = (Z ^ X[i]) * H over 'nblocks' 16-byte blocks */
+
+  CODE void (*ghash)(FAR uint8_t *z, FAR const uint8_t *h,
+                     FAR const uint8_t *x, size_t nblocks);
+
+  /* Fused AES-CTR + GHASH for GCM.  'ctr' is incremented (32-bit big
+   * endian in its last word) before each block is encrypted, GHASH runs
+   * over the ciphertext.
+   */
+
+  CODE void (*gcm_crypt)(FAR const uint8_t *ek, unsigned int nr,
+                         FAR uint8_t *ctr, FAR uint8_t *z,
+                         FAR const uint8_t *h, FAR const uint8_t *src,
+                         FAR uint8_t *dst, size_t nblocks, bool encrypt);
+
+  CODE void (*sha256)(FAR uint32_t *state, FAR const uint8_t *data,
+                      size_t nblocks);
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: crypto_accel
+ *
+ * Description:
+ *   Return the crypto kernels of the running CPU, probing the CPU features
+ *   on first use, or NULL if the CPU has none of the supported extensions.
+ *
+ ****************************************************************************/
+
+FAR const struct crypto_accel_s *crypto_accel(void);
+
+/****************************************************************************
+ * Name: crypto_accel_aes_setkey
+ *
+ * Description:
+ *   Expand an AES key into the encryption and decryption schedules used by
+ *   the accelerated AES kernels.
+ *
+ * Returned Value:
+ *   The number of rounds, or 0 if the key length is not supported.
+ *
+ ****************************************************************************/
+
+unsigned int crypto_accel_aes_setkey(FAR const struct crypto_accel_s *accel,
+                                     FAR uint8_t *ek, FAR uint8_t *dk,
+                                     FAR const uint8_t *key, int len);
+
+/* Architecture backends, probed by crypto_accel() */
+
+#ifdef CONFIG_ARCH_X86_64
+FAR const struct crypto_accel_s *crypto_accel_x86_64(void);
+#endif
+
+#ifdef CONFIG_ARCH_ARM64
+FAR const struct crypto_accel_s *crypto_accel_arm64(void);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_CRYPTO_ACCEL */
+#endif /* __INCLUDE_CRYPTO_ACCEL_H */
@@ -47,6 +47,14 @@ typedef struct aes_ctx
   unsigned num_rounds;
 } AES_CTX;
 
+/* With CPU AES instructions (CONFIG_CRYPTO_ACCEL) sk_exp holds the
+ * encryption schedule followed by the decryption schedule, in the byte
+ * order used by the instructions.
+ */
+
+#define AES_ACCEL_EK(ctx) ((FAR uint8_t *)(ctx)->sk_exp)
+#define AES_ACCEL_DK(ctx) ((FAR uint8_t *)(ctx)->sk_exp + 15 * 16)
+
 int aes_setkey(FAR AES_CTX *, FAR const uint8_t *, int);
 void aes_encrypt(FAR AES_CTX *, FAR const uint8_t *, FAR uint8_t *);
 void aes_decrypt(FAR AES_CTX *, FAR const uint8_t *, FAR uint8_t *);
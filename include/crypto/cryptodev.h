@@ -357,6 +357,30 @@ struct crypt_op
   caddr_t aad;
 };
 
+/* CIOCCRYPTM submits a batch of crypt_op requests to be run in the
+ * background; the requests and the buffers they point to must stay valid
+ * until their result is fetched.  CIOCCRYPTMFETCH returns completed
+ * requests, poll() reports POLLIN when there are some.
+ */
+
+struct crypt_mop
+{
+  uint32_t count;                /* Number of requests */
+  FAR struct crypt_op *reqs;     /* Requests to run */
+};
+
+struct crypt_result
+{
+  FAR struct crypt_op *op;       /* The request as passed to CIOCCRYPTM */
+  int status;                    /* 0 or a negated errno value */
+};
+
+struct crypt_fetch
+{
+  uint32_t count;                /* In: room in results, out: filled */
+  FAR struct crypt_result *results;
+};
+
 /* hamc buffer, software & hardware need it */
 
 extern const uint8_t hmac_ipad_buffer[HMAC_MAX_BLOCK_LEN];
@@ -377,6 +401,8 @@ extern const uint8_t hmac_opad_buffer[HMAC_MAX_BLOCK_LEN];
 #define CIOCCRYPT               103
 #define CIOCKEY                 104
 #define CIOCASYMFEAT            105
+#define CIOCCRYPTM              106
+#define CIOCCRYPTMFETCH         107
 
 int crypto_newsession(FAR uint64_t *, FAR struct cryptoini *, int);
 int crypto_freesession(uint64_t);
@@ -58,6 +58,8 @@ int rijndael_set_key_enc_only(FAR rijndael_ctx *, FAR const u_char *, int);
 void rijndael_decrypt(FAR rijndael_ctx *, FAR const u_char *, FAR u_char *);
 void rijndael_encrypt(FAR rijndael_ctx *, FAR const u_char *, FAR u_char *);
 
+int rijndael_key_setup_enc(FAR uint32_t *, FAR const uint8_t *, int);
+
 int rijndael_keysetupenc(unsigned int [],
                          const unsigned char [],
                          int);
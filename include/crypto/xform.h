@@ -132,4 +132,7 @@ extern const struct auth_hash auth_hash_sha2_512;
 extern const struct auth_hash auth_hash_crc32;
 extern const struct auth_hash auth_hash_cmac_aes_128;
 
+size_t aes_gcm_crypt_accel(caddr_t, FAR GHASH_CTX *, FAR const uint8_t *,
+                           FAR uint8_t *, size_t, int);
+
 #endif /* __INCLUDE_CRYPTO_XFORM_H */
@@ -511,6 +511,19 @@ void park_transform(FAR phase_angle_f32_t *angle, FAR ab_frame_f32_t *ab,
 void inv_park_transform(FAR phase_angle_f32_t *angle, FAR dq_frame_f32_t *dq,
                         FAR ab_frame_f32_t *ab);
 
+/* Transformations of several motors at once */
+
+void clarke_transform_batch(FAR const abc_frame_f32_t *abc,
+                            FAR ab_frame_f32_t *ab, size_t n);
+void inv_clarke_transform_batch(FAR const ab_frame_f32_t *ab,
+                                FAR abc_frame_f32_t *abc, size_t n);
+void park_transform_batch(FAR const phase_angle_f32_t *angle,
+                          FAR const ab_frame_f32_t *ab,
+                          FAR dq_frame_f32_t *dq, size_t n);
+void inv_park_transform_batch(FAR const phase_angle_f32_t *angle,
+                              FAR const dq_frame_f32_t *dq,
+                              FAR ab_frame_f32_t *ab, size_t n);
+
 /* Phase angle related functions */
 
 void angle_norm(FAR float *angle, float per, float bottom, float top);
@@ -521,6 +534,8 @@ void phase_angle_update(FAR struct phase_angle_f32_s *angle, float val);
 
 void svm3_init(FAR struct svm3_state_f32_s *s);
 void svm3(FAR struct svm3_state_f32_s *s, FAR ab_frame_f32_t *ab);
+void svm3_batch(FAR struct svm3_state_f32_s *s,
+                FAR const ab_frame_f32_t *v_ab, size_t n);
 void svm3_current_correct(FAR struct svm3_state_f32_s *s,
                           FAR float *c0, FAR float *c1, FAR float *c2);
 
@@ -152,6 +152,13 @@
 #define F_SEAL_WRITE        0x0008 /* Prevent writes */
 #define F_SEAL_FUTURE_WRITE 0x0010 /* Prevent future writes while mapped */
 
+/* Flags for splice(), tee() and vmsplice() */
+
+#define SPLICE_F_MOVE       0x0001 /* Move instead of copying (a hint) */
+#define SPLICE_F_NONBLOCK   0x0002 /* Do not block on the pipes */
+#define SPLICE_F_MORE       0x0004 /* More data will follow (a hint) */
+#define SPLICE_F_GIFT       0x0008 /* Give the pages away (a hint) */
+
 /* int creat(const char *path, mode_t mode);
  *
  * is equivalent to open with O_WRONLY|O_CREAT|O_TRUNC.
@@ -213,6 +220,16 @@ int fcntl(int fd, int cmd, ...);
 
 int posix_fallocate(int fd, off_t offset, off_t len);
 
+/* Linux pipe transfer interfaces */
+
+struct iovec; /* Forward reference */
+
+ssize_t splice(int fdin, FAR off_t *offin, int fdout, FAR off_t *offout,
+               size_t len, unsigned int flags);
+ssize_t tee(int fdin, int fdout, size_t len, unsigned int flags);
+ssize_t vmsplice(int fd, FAR const struct iovec *iov, size_t nr_segs,
+                 unsigned int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
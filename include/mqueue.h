@@ -34,6 +34,13 @@
 
 #define MQ_NONBLOCK O_NONBLOCK
 
+/* Non-standard mq_flags of mq_open():  messages of exactly mq_msgsize bytes
+ * and priority zero, exchanged through a preallocated lock-free ring
+ * (CONFIG_MQ_RING).
+ */
+
+#define MQ_RING     (1 << 30)
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
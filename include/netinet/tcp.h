@@ -56,4 +56,9 @@
                                            * Argument: max retry count */
 #define TCP_MAXSEG    (__SO_PROTOCOL + 4) /* The maximum segment size */
 
+/* Congestion control algorithm.  Argument: name string */
+
+#define TCP_CONGESTION  (__SO_PROTOCOL + 5)
+#define TCP_CA_NAME_MAX 16                  /* Size of the algorithm name */
+
 #endif /* __INCLUDE_NETINET_TCP_H */
@@ -31,6 +31,14 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* UDP protocol (SOL_UDP) socket options */
+
+#define UDP_SEGMENT   (__SO_PROTOCOL + 0) /* Segment the sent data in
+                                           * datagrams of this size.
+                                           * Argument: int */
+#define UDP_GRO       (__SO_PROTOCOL + 1) /* Receive several datagrams
+                                           * at once.  Argument: int */
+
 /* UDP header as specified by RFC 768, August 1980. */
 
 struct udphdr
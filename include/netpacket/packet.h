@@ -28,6 +28,46 @@
 #include <nuttx/config.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* SOL_PACKET socket options */
+
+#define PACKET_RX_RING          5   /* Arg: struct tpacket_req3 */
+#define PACKET_STATISTICS       6   /* Arg: struct tpacket_stats_v3 */
+#define PACKET_VERSION          10  /* Arg: int, one of TPACKET_Vx */
+#define PACKET_TX_RING          13  /* Arg: struct tpacket_req3 */
+
+/* Ring layout versions.  Only TPACKET_V3 is implemented. */
+
+#define TPACKET_V1              0
+#define TPACKET_V2              1
+#define TPACKET_V3              2
+
+/* Values of the per-frame tp_status and the per-block block_status words.
+ * A slot owned by the kernel reads TP_STATUS_KERNEL (RX) or
+ * TP_STATUS_AVAILABLE (TX); user space hands it back by writing that same
+ * value once it has consumed (RX) or by writing TP_STATUS_SEND_REQUEST
+ * once it has filled (TX) the slot.
+ */
+
+#define TP_STATUS_KERNEL        0
+#define TP_STATUS_USER          (1 << 0)
+#define TP_STATUS_LOSING        (1 << 2)
+#define TP_STATUS_BLK_TMO       (1 << 5)
+
+#define TP_STATUS_AVAILABLE     0
+#define TP_STATUS_SEND_REQUEST  (1 << 0)
+#define TP_STATUS_SENDING       (1 << 1)
+#define TP_STATUS_WRONG_FORMAT  (1 << 2)
+
+/* Frame and block alignment inside the ring */
+
+#define TPACKET_ALIGNMENT       16
+#define TPACKET_ALIGN(x)        (((x) + TPACKET_ALIGNMENT - 1) & \
+                                 ~(TPACKET_ALIGNMENT - 1))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -43,4 +83,86 @@ struct sockaddr_ll
   unsigned char  sll_addr[8];
 };
 
+/* Ring geometry passed with PACKET_RX_RING / PACKET_TX_RING.  The ring is
+ * tp_block_nr blocks of tp_block_size bytes; TX frames are tp_frame_size
+ * bytes each and RX frames are packed variably inside each block.
+ */
+
+struct tpacket_req3
+{
+  unsigned int tp_block_size;      /* Minimal size of contiguous block */
+  unsigned int tp_block_nr;        /* Number of blocks */
+  unsigned int tp_frame_size;      /* Size of frame */
+  unsigned int tp_frame_nr;        /* Total number of frames */
+  unsigned int tp_retire_blk_tov;  /* Block retire timeout in msec */
+  unsigned int tp_sizeof_priv;     /* Private data area per block */
+  unsigned int tp_feature_req_word;
+};
+
+/* PACKET_STATISTICS result, the counters are cleared on each read */
+
+struct tpacket_stats_v3
+{
+  unsigned int tp_packets;
+  unsigned int tp_drops;
+  unsigned int tp_freeze_q_cnt;    /* Times a full ring stalled input */
+};
+
+struct tpacket_bd_ts
+{
+  unsigned int ts_sec;
+  unsigned int ts_nsec;
+};
+
+/* RX block header, at the start of every block */
+
+struct tpacket_hdr_v1
+{
+  uint32_t block_status;           /* TP_STATUS_KERNEL or TP_STATUS_USER */
+  uint32_t num_pkts;               /* Frames in this block */
+  uint32_t offset_to_first_pkt;    /* From the start of the block */
+  uint32_t blk_len;                /* Bytes used in this block */
+  uint64_t seq_num;                /* Block sequence number */
+  struct tpacket_bd_ts ts_first_pkt;
+  struct tpacket_bd_ts ts_last_pkt;
+};
+
+union tpacket_bd_header_u
+{
+  struct tpacket_hdr_v1 bh1;
+};
+
+struct tpacket_block_desc
+{
+  uint32_t version;
+  uint32_t offset_to_priv;
+  union tpacket_bd_header_u hdr;
+};
+
+struct tpacket_hdr_variant1
+{
+  uint32_t tp_rxhash;
+  uint32_t tp_vlan_tci;
+  uint16_t tp_vlan_tpid;
+  uint16_t tp_padding;
+};
+
+/* Per-frame header.  The link-layer frame starts tp_mac bytes from the
+ * header and a struct sockaddr_ll follows the header.
+ */
+
+struct tpacket3_hdr
+{
+  uint32_t tp_next_offset;         /* To the next frame, 0 for the last */
+  uint32_t tp_sec;
+  uint32_t tp_nsec;
+  uint32_t tp_snaplen;             /* Bytes stored in the ring */
+  uint32_t tp_len;                 /* Bytes on the wire */
+  uint32_t tp_status;
+  uint16_t tp_mac;                 /* Offset of the link-layer header */
+  uint16_t tp_net;                 /* Offset of the network header */
+  struct tpacket_hdr_variant1 hv1;
+  uint8_t  tp_padding[8];
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
@@ -1624,6 +1624,41 @@ int up_shmat(FAR uintptr_t *pages, unsigned int npages, uintptr_t vaddr);
 int up_shmdt(uintptr_t vaddr, unsigned int npages);
 #endif
 
+/****************************************************************************
+ * Name: up_addrenv_kpage_map
+ *
+ * Description:
+ *   Map a kernel owned page read-only into the shared memory region of an
+ *   address environment, which need not be the current one.  The page is
+ *   not freed when the address environment is destroyed.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment.
+ *   page - The page physical address.
+ *   vaddr - The user virtual address of the page.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_ARCH_HAVE_VDSO) && defined(CONFIG_ARCH_ADDRENV)
+int up_addrenv_kpage_map(FAR arch_addrenv_t *addrenv, uintptr_t page,
+                         uintptr_t vaddr);
+#endif
+
+/****************************************************************************
+ * Name: up_vdso_counter and up_vdso_getfreq
+ *
+ * Description:
+ *   uint64_t up_vdso_counter(void) reads a free running counter that user
+ *   mode may read too, and uint64_t up_vdso_getfreq(void) returns its
+ *   frequency.  Both are inline functions in arch/arch.h, so that the
+ *   C library can use them.
+ *
+ ****************************************************************************/
+
 /****************************************************************************
  * Interfaces required for ELF module support
  *
@@ -2029,6 +2064,36 @@ int up_timer_tick_start(clock_t ticks);
 #  endif
 #endif
 
+/****************************************************************************
+ * Name: up_cpu_timer_tick_start and up_cpu_timer_tick_cancel
+ *
+ * Description:
+ *   Start or stop the private timer of the calling CPU.
+ *   nxsched_cpu_timer_expiration() will be called on that CPU 'ticks'
+ *   clock ticks after up_cpu_timer_tick_start(), unless the timer is
+ *   started again or canceled before.  The timer is only used to expire
+ *   the time slice of the task running on the CPU, so an idle CPU does not
+ *   get any interrupt from it.
+ *
+ *   Provided by platform-specific code and called from the RTOS base code.
+ *
+ * Input Parameters:
+ *   ticks - The number of clock ticks until the expiration.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled on the CPU that owns the timer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS_PERCPU
+int up_cpu_timer_tick_start(clock_t ticks);
+int up_cpu_timer_tick_cancel(void);
+#endif
+
 /****************************************************************************
  * Name: up_getsp
  *
@@ -2548,6 +2613,30 @@ void nxsched_alarm_expiration(FAR const struct timespec *ts);
 void nxsched_alarm_tick_expiration(clock_t ticks);
 #endif
 
+/****************************************************************************
+ * Name:  nxsched_cpu_timer_expiration
+ *
+ * Description:
+ *   If CONFIG_SCHED_TICKLESS_PERCPU is defined, then this function is
+ *   provided by the RTOS base code and called from platform-specific code
+ *   when the private timer of the current CPU expires.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions/Limitations:
+ *   Base code implementation assumes that this function is called from
+ *   interrupt handling logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS_PERCPU
+void nxsched_cpu_timer_expiration(void);
+#endif
+
 /****************************************************************************
  * Name:  nxsched_get_next_expired
  *
@@ -2936,6 +3025,42 @@ unsigned long up_perf_gettime(void);
 unsigned long up_perf_getfreq(void);
 void up_perf_convert(unsigned long elapsed, FAR struct timespec *ts);
 
+/****************************************************************************
+ * Name: up_getusrpc
+ *
+ * Description:
+ *   Return the program counter saved in the register context of an
+ *   interrupted thread, e.g. up_current_regs() in an interrupt handler.
+ *   Usually provided as a macro by arch/irq.h.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_ARCH_HAVE_PERF_SAMPLE) && !defined(up_getusrpc)
+uintptr_t up_getusrpc(FAR void *regs);
+#endif
+
+/****************************************************************************
+ * Name: up_perf_sample_start and up_perf_sample_stop
+ *
+ * Description:
+ *   Start or stop the performance counter overflow interrupt of this CPU.
+ *   Once started, the interrupt handler calls perf_sample() with the
+ *   interrupted register context every 'period' counted events and
+ *   re-arms the counter.
+ *
+ * Input Parameters:
+ *   period - The number of events between two samples.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_PERF_SAMPLE_PMU
+int up_perf_sample_start(unsigned long period);
+int up_perf_sample_stop(void);
+#endif
+
 /****************************************************************************
  * Name: up_show_cpuinfo
  *
@@ -2986,6 +3111,32 @@ bool up_fpucmp(FAR const void *saveregs1, FAR const void *saveregs2);
 #define up_fpucmp(r1, r2) (true)
 #endif
 
+/****************************************************************************
+ * Name: up_chksum
+ *
+ * Description:
+ *   Calculate the one's complement sum of the 16-bit words of a buffer, as
+ *   loaded in native byte order from the buffer address.  A trailing odd
+ *   byte is summed as a word padded with zero.  The buffer may have any
+ *   alignment.  This is the inner loop of the Internet checksum of the
+ *   network stack, see RFC1071.
+ *
+ *   This function must be provided via the architecture-specific logic if
+ *   CONFIG_ARCH_HAVE_CHKSUM is selected.
+ *
+ * Input Parameters:
+ *   data - Beginning of the data to sum.
+ *   len  - Length of the data in bytes.
+ *
+ * Returned Value:
+ *   The sum, folded to 16 bits.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_CHKSUM
+uint16_t up_chksum(FAR const void *data, size_t len);
+#endif
+
 #ifdef CONFIG_ARCH_HAVE_DEBUG
 
 /****************************************************************************
@@ -0,0 +1,116 @@
+/****************************************************************************
+ * include/nuttx/arena.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_ARENA_H
+#define __INCLUDE_NUTTX_ARENA_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* An arena hands out memory from large blocks taken from the heap.  The
+ * allocations are not freed one by one: arena_reset() releases all of
+ * them at once, keeping the first block for the next use, and
+ * arena_destroy() returns everything to the heap.
+ */
+
+struct arena_s;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: arena_create
+ *
+ * Description:
+ *   Create an arena that grows by blocks of 'blocksize' bytes.  The first
+ *   block is allocated with the arena itself.
+ *
+ * Input Parameters:
+ *   blocksize - The size of the blocks, zero selects a default size.
+ *
+ * Returned Value:
+ *   The new arena, or NULL if out of memory.
+ *
+ ****************************************************************************/
+
+FAR struct arena_s *arena_create(size_t blocksize);
+
+/****************************************************************************
+ * Name: arena_alloc and arena_zalloc
+ *
+ * Description:
+ *   Allocate 'size' bytes from the arena, aligned for any type.  A request
+ *   larger than a block gets a block of its own.  arena_zalloc() also
+ *   clears the memory.
+ *
+ * Returned Value:
+ *   The allocated memory, or NULL if out of memory.
+ *
+ ****************************************************************************/
+
+FAR void *arena_alloc(FAR struct arena_s *arena, size_t size);
+FAR void *arena_zalloc(FAR struct arena_s *arena, size_t size);
+
+/****************************************************************************
+ * Name: arena_reset
+ *
+ * Description:
+ *   Free all of the allocations of the arena at once.  The first block is
+ *   kept, so an arena reused for operations of similar size does not
+ *   touch the heap again.
+ *
+ ****************************************************************************/
+
+void arena_reset(FAR struct arena_s *arena);
+
+/****************************************************************************
+ * Name: arena_destroy
+ *
+ * Description:
+ *   Free the arena together with all of its allocations.
+ *
+ ****************************************************************************/
+
+void arena_destroy(FAR struct arena_s *arena);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_ARENA_H */
@@ -92,6 +92,14 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_RINGSYNC - Hand the periods that the application has written
+ *                     to (playback) or read from (capture) the mapped
+ *                     sample ring to the device.  Only needed after the
+ *                     device ran out of periods, the period interrupts
+ *                     keep it supplied otherwise.
+ *
+ *   ioctl argument:  None
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -115,6 +123,7 @@
 #define AUDIOIOC_GETLATENCY         _AUDIOIOC(19)
 #define AUDIOIOC_FLUSH              _AUDIOIOC(20)
 #define AUDIOIOC_GETPOSITION        _AUDIOIOC(21)
+#define AUDIOIOC_RINGSYNC           _AUDIOIOC(22)
 
 /* Audio Device Types *******************************************************/
 
@@ -450,6 +459,27 @@ struct ap_buffer_info_s
   apb_samp_t  buffer_size;  /* Preferred size of the buffers */
 };
 
+/* Ring buffer streaming:  mmap() of the audio device at offset zero maps
+ * a ring of 'size' bytes that the device plays from or captures to, one
+ * period at a time.  mmap() at AUDIO_RING_MMAP_STATUS maps this structure.
+ * The positions count bytes and wrap at 'boundary', a multiple of 'size',
+ * so that 'ptr % size' is the offset in the ring.  The application
+ * advances applptr after writing (playback) or reading (capture) the ring
+ * and waits for periods with poll().
+ */
+
+#define AUDIO_RING_MMAP_STATUS      0x40000000
+
+struct audio_ring_s
+{
+  uint32_t          size;       /* Size of the sample ring in bytes */
+  uint32_t          period;     /* Bytes per period */
+  uint32_t          boundary;   /* The positions wrap at this value */
+  volatile uint32_t hwptr;      /* Bytes played or captured by the device */
+  volatile uint32_t applptr;    /* Bytes written or read by the application */
+  volatile uint32_t xruns;      /* Number of underruns or overruns */
+};
+
 /* This structure describes an Audio Pipeline Buffer */
 
 struct ap_buffer_s
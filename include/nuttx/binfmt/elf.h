@@ -94,6 +94,13 @@ struct elf_loadinfo_s
   FAR Elf_Phdr      *phdr;       /* Buffered ELF program headers */
   FAR Elf_Shdr      *shdr;       /* Buffered ELF section headers */
   uint8_t           *iobuffer;   /* File I/O buffer */
+#ifdef CONFIG_ELF_XIP
+  FAR const uint8_t *xipbase;    /* File mapped in place, or NULL */
+#endif
+#ifdef CONFIG_ELF_IMAGE_CACHE
+  FAR const uint8_t *cachebase;  /* Cached copy of the file, or NULL */
+  FAR void          *cache;      /* Image cache entry in use */
+#endif
 
   /* Constructors and destructors */
 
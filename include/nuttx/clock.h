@@ -739,6 +739,27 @@ int clock_systime_timespec(FAR struct timespec *ts);
 int clock_cpuload(int pid, FAR struct cpuload_s *cpuload);
 #endif
 
+/****************************************************************************
+ * Name:  clock_cpuload_cpu
+ *
+ * Description:
+ *   Return the free running load counts of one CPU: 'total' counts all
+ *   ticks of the CPU and 'active' the ticks not spent in its IDLE thread.
+ *   Unlike the per-thread counts, these are never scaled back.
+ *
+ * Input Parameters:
+ *   cpu - The CPU of interest.
+ *   cpuload - The location to return the counts
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if 'cpu' is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_CPULOAD_NONE
+int clock_cpuload_cpu(int cpu, FAR struct cpuload_s *cpuload);
+#endif
+
 /****************************************************************************
  * Name:  nxsched_oneshot_extclk
  *
@@ -0,0 +1,219 @@
+/****************************************************************************
+ * include/nuttx/cpufreq.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CPUFREQ_H
+#define __INCLUDE_NUTTX_CPUFREQ_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Marks the end of a frequency table */
+
+#define CPUFREQ_TABLE_END (~0u)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One operating point of a CPU cluster.  The table of a driver ends with
+ * an entry of CPUFREQ_TABLE_END, it does not need to be sorted.
+ */
+
+struct cpufreq_frequency_table
+{
+  unsigned int frequency;                /* In kHz */
+};
+
+/* A frequency domain: the CPUs that share one clock and one supply.  The
+ * rest of the structure is private to the cpufreq framework.
+ */
+
+struct cpufreq_policy
+{
+  FAR struct cpufreq_driver *driver;     /* The lower half, must be first */
+};
+
+/* A frequency range requested by a user of the framework (e.g. thermal) */
+
+struct cpufreq_qos;
+
+/* The lower half implemented by the clock driver of a cluster.
+ * target_index() switches to an entry of the table returned by
+ * get_table().  It is called from thread context and may block, so the
+ * driver can sequence the supply through the regulator framework: raise
+ * the voltage before raising the clock, lower it after lowering the clock.
+ */
+
+struct cpufreq_driver
+{
+  CODE FAR const struct cpufreq_frequency_table *
+  (*get_table)(FAR struct cpufreq_policy *policy);
+  CODE int (*target_index)(FAR struct cpufreq_policy *policy,
+                           unsigned int index);
+  CODE int (*get_frequency)(FAR struct cpufreq_policy *policy);
+  CODE int (*suspend)(FAR struct cpufreq_policy *policy);
+  CODE int (*resume)(FAR struct cpufreq_policy *policy);
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_CPUFREQ
+
+/****************************************************************************
+ * Name: cpufreq_init
+ *
+ * Description:
+ *   Register the cpufreq driver of a system whose CPUs all share one
+ *   clock.
+ *
+ * Input Parameters:
+ *   driver - The lower half driver.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cpufreq_init(FAR struct cpufreq_driver *driver);
+
+/****************************************************************************
+ * Name: cpufreq_init_cluster
+ *
+ * Description:
+ *   Register the cpufreq driver of one cluster, e.g. the big or the LITTLE
+ *   cores of a big.LITTLE SoC.  Each cluster gets its own policy and is
+ *   scaled independently.
+ *
+ * Input Parameters:
+ *   driver - The lower half driver of the cluster.
+ *   cpus   - The CPUs of the cluster.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cpufreq_init_cluster(FAR struct cpufreq_driver *driver, cpu_set_t cpus);
+
+/****************************************************************************
+ * Name: cpufreq_uninit
+ *
+ * Description:
+ *   Unregister all cpufreq drivers.
+ *
+ ****************************************************************************/
+
+int cpufreq_uninit(void);
+
+/****************************************************************************
+ * Name: cpufreq_policy_get / cpufreq_cpu_policy
+ *
+ * Description:
+ *   Return the policy of the first registered cluster, or the policy of
+ *   the cluster of a CPU.  NULL is returned if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct cpufreq_policy *cpufreq_policy_get(void);
+FAR struct cpufreq_policy *cpufreq_cpu_policy(int cpu);
+
+/****************************************************************************
+ * Name: cpufreq_get_table
+ *
+ * Description:
+ *   Return the frequency table of a policy.
+ *
+ ****************************************************************************/
+
+FAR const struct cpufreq_frequency_table *
+cpufreq_get_table(FAR struct cpufreq_policy *policy);
+
+/****************************************************************************
+ * Name: cpufreq_qos_add_request / cpufreq_qos_update_request /
+ *       cpufreq_qos_remove_request
+ *
+ * Description:
+ *   Constrain the frequency of a policy to [min, max] kHz.  The policy
+ *   runs in the intersection of all requested ranges; if they do not
+ *   intersect, the lowest maximum wins.
+ *
+ ****************************************************************************/
+
+FAR struct cpufreq_qos *
+cpufreq_qos_add_request(FAR struct cpufreq_policy *policy, int min,
+                        int max);
+int cpufreq_qos_update_request(FAR struct cpufreq_qos *qos, int min,
+                               int max);
+int cpufreq_qos_remove_request(FAR struct cpufreq_qos *qos);
+
+/****************************************************************************
+ * Name: cpufreq_suspend / cpufreq_resume
+ *
+ * Description:
+ *   Stop and restart frequency changes of a policy.  While suspended, the
+ *   frequency is left as the driver's suspend() sets it.
+ *
+ ****************************************************************************/
+
+int cpufreq_suspend(FAR struct cpufreq_policy *policy);
+int cpufreq_resume(FAR struct cpufreq_policy *policy);
+
+/****************************************************************************
+ * Name: cpufreq_boost
+ *
+ * Description:
+ *   Ask the governor to raise the frequency of the cluster of a CPU to the
+ *   maximum now, instead of at its next sample.  This is called by the
+ *   scheduler when a real-time thread runs.  It may be called from an
+ *   interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CPUFREQ_SCHEDUTIL_RTBOOST
+void cpufreq_boost(int cpu);
+#endif
+
+#endif /* CONFIG_CPUFREQ */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_CPUFREQ_H */
@@ -0,0 +1,232 @@
+/****************************************************************************
+ * include/nuttx/dma/dma_alloc.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DMA_DMA_ALLOC_H
+#define __INCLUDE_NUTTX_DMA_DMA_ALLOC_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/dma/dma.h>
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: dma_map
+ *
+ * Description:
+ *   Hand a cacheable (streaming) buffer over to a DMA transfer.  Data the
+ *   CPU wrote is cleaned to memory for DMA_MEM_TO_DEV, the buffer is
+ *   removed from the D-Cache for DMA_DEV_TO_MEM, and both are done for
+ *   DMA_MEM_TO_MEM.  Partial cache lines at the ends of a DMA_DEV_TO_MEM
+ *   buffer are cleaned first, so neighbouring data is not lost.
+ *
+ *   Not needed for memory from dma_alloc_coherent().
+ *
+ * Input Parameters:
+ *   buf - The buffer.
+ *   len - The size of the buffer in bytes.
+ *   dir - The direction of the transfer, DMA_MEM_TO_DEV, DMA_DEV_TO_MEM or
+ *         DMA_MEM_TO_MEM (both ways).
+ *
+ ****************************************************************************/
+
+static inline void dma_map(FAR const void *buf, size_t len, int dir)
+{
+  uintptr_t start = (uintptr_t)buf;
+  uintptr_t end   = start + len;
+  size_t line     = up_get_dcache_linesize();
+
+  if (dir == DMA_MEM_TO_DEV)
+    {
+      up_clean_dcache(start, end);
+    }
+  else if (dir == DMA_DEV_TO_MEM)
+    {
+      if (line > 0 && ((start | end) & (line - 1)) != 0)
+        {
+          up_flush_dcache(start, start + 1);
+          up_flush_dcache(end - 1, end);
+        }
+
+      up_invalidate_dcache(start, end);
+    }
+  else
+    {
+      up_flush_dcache(start, end);
+    }
+}
+
+/****************************************************************************
+ * Name: dma_unmap
+ *
+ * Description:
+ *   Take a streaming buffer back from a completed DMA transfer.  Lines the
+ *   CPU may have fetched speculatively while the transfer ran are dropped
+ *   for DMA_DEV_TO_MEM and DMA_MEM_TO_MEM, so the CPU sees the data the
+ *   device wrote.
+ *
+ * Input Parameters:
+ *   buf - The buffer.
+ *   len - The size of the buffer in bytes.
+ *   dir - The direction that was passed to dma_map().
+ *
+ ****************************************************************************/
+
+static inline void dma_unmap(FAR const void *buf, size_t len, int dir)
+{
+  if (dir != DMA_MEM_TO_DEV)
+    {
+      up_invalidate_dcache((uintptr_t)buf, (uintptr_t)buf + len);
+    }
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_DMA_ALLOC
+
+/****************************************************************************
+ * Name: dma_alloc_initialize
+ *
+ * Description:
+ *   Set up the streaming pool reserved with CONFIG_DMA_ALLOC_POOL_SIZE.
+ *   Called once by drivers_initialize().
+ *
+ ****************************************************************************/
+
+void dma_alloc_initialize(void);
+
+/****************************************************************************
+ * Name: dma_pool_register
+ *
+ * Description:
+ *   Hand a region of memory reserved at boot to the DMA allocator.  A
+ *   coherent region must be mapped uncached (or be coherent with the DMA
+ *   masters by other means) by the board's MMU/MPU set-up.  There is one
+ *   pool of each kind, registered before the first allocation from it.
+ *
+ * Input Parameters:
+ *   start    - Start of the region, aligned to the granule.
+ *   size     - Size of the region in bytes.
+ *   coherent - True for the coherent pool, false for the streaming pool.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure: -EBUSY if the pool is already there, -ENOMEM if the region
+ *   is too small.
+ *
+ ****************************************************************************/
+
+int dma_pool_register(FAR void *start, size_t size, bool coherent);
+
+/****************************************************************************
+ * Name: dma_alloc
+ *
+ * Description:
+ *   Allocate a physically contiguous, cache line aligned streaming buffer,
+ *   to be used with dma_map() and dma_unmap().  Taken from the streaming
+ *   pool, or from the kernel heap if there is none.
+ *
+ * Input Parameters:
+ *   size - The size of the buffer in bytes.
+ *
+ * Returned Value:
+ *   The buffer; NULL if there is no memory.
+ *
+ ****************************************************************************/
+
+FAR void *dma_alloc(size_t size);
+
+/****************************************************************************
+ * Name: dma_free
+ *
+ * Description:
+ *   Free a buffer from dma_alloc().
+ *
+ * Input Parameters:
+ *   mem  - The buffer.
+ *   size - The size that was passed to dma_alloc().
+ *
+ ****************************************************************************/
+
+void dma_free(FAR void *mem, size_t size);
+
+/****************************************************************************
+ * Name: dma_alloc_coherent
+ *
+ * Description:
+ *   Allocate a buffer from the coherent pool.  It needs no cache
+ *   maintenance, so it suits descriptor rings and buffers the CPU and the
+ *   device both touch often.
+ *
+ * Input Parameters:
+ *   size - The size of the buffer in bytes.
+ *
+ * Returned Value:
+ *   The buffer; NULL if there is no memory or no coherent pool.
+ *
+ ****************************************************************************/
+
+FAR void *dma_alloc_coherent(size_t size);
+
+/****************************************************************************
+ * Name: dma_free_coherent
+ *
+ * Description:
+ *   Free a buffer from dma_alloc_coherent().
+ *
+ * Input Parameters:
+ *   mem  - The buffer.
+ *   size - The size that was passed to dma_alloc_coherent().
+ *
+ ****************************************************************************/
+
+void dma_free_coherent(FAR void *mem, size_t size);
+
+#endif /* CONFIG_DMA_ALLOC */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_DMA_DMA_ALLOC_H */
@@ -30,6 +30,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <nuttx/compiler.h>
+#include <nuttx/queue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -55,6 +56,22 @@ struct fdt_header_s
   uint32_t size_dt_struct;
 };
 
+#ifdef CONFIG_DEVICE_TREE_PROBE
+/* A driver queued by fdt_probe_register().  probe() is called for each of
+ * the available nodes matching one of compatible_ids, and may return
+ * -EAGAIN if something the node depends on was not probed yet.
+ */
+
+struct fdt_probe_s
+{
+  sq_entry_t node;                          /* Used internally */
+  FAR const char * const *compatible_ids;   /* NULL terminated */
+  CODE int (*probe)(FAR const void *fdt, int offset);
+  int first;                                /* Used internally */
+  int count;                                /* Used internally */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -78,6 +95,46 @@ struct fdt_header_s
 
 int fdt_register(FAR const char *fdt_base);
 
+/****************************************************************************
+ * Name: fdt_node_by_compatible
+ *
+ * Description:
+ *   Like fdt_node_offset_by_compatible(), but looked up in the index built
+ *   by fdt_register() for the registered FDT if CONFIG_DEVICE_TREE_INDEX
+ *   is enabled.  The registered FDT must not be modified then.
+ *
+ * Input Parameters:
+ *   fdt - The pointer to the raw FDT.
+ *   startoffset - Only nodes after this one are found, -1 for all.
+ *   compatible - The compatible string to look for.
+ *
+ * Return:
+ *   The offset of the first matching node, -FDT_ERR_NOTFOUND if none.
+ *
+ ****************************************************************************/
+
+int fdt_node_by_compatible(FAR const void *fdt, int startoffset,
+                           FAR const char *compatible);
+
+/****************************************************************************
+ * Name: fdt_node_by_phandle
+ *
+ * Description:
+ *   Like fdt_node_offset_by_phandle(), but looked up in the index built by
+ *   fdt_register() for the registered FDT if CONFIG_DEVICE_TREE_INDEX is
+ *   enabled.
+ *
+ * Input Parameters:
+ *   fdt - The pointer to the raw FDT.
+ *   phandle - The phandle to look for.
+ *
+ * Return:
+ *   The offset of the node, -FDT_ERR_NOTFOUND if none.
+ *
+ ****************************************************************************/
+
+int fdt_node_by_phandle(FAR const void *fdt, uint32_t phandle);
+
 /****************************************************************************
  * Name: fdt_get
  *
@@ -409,4 +466,40 @@ int fdt_load_prop_u32(FAR const void *fdt, int offset,
                       FAR const char *property, int index,
                       FAR uint32_t *value);
 
+#ifdef CONFIG_DEVICE_TREE_PROBE
+/****************************************************************************
+ * Name: fdt_probe_register
+ *
+ * Description:
+ *   Queue a driver to be probed by fdt_probe_all().  Drivers are queued
+ *   during the single threaded board initialization.
+ *
+ * Input Parameters:
+ *   probe - The driver, which must stay valid.
+ *
+ ****************************************************************************/
+
+void fdt_probe_register(FAR struct fdt_probe_s *probe);
+
+/****************************************************************************
+ * Name: fdt_probe_all
+ *
+ * Description:
+ *   Probe the available nodes of all of the queued drivers.  Different
+ *   drivers are probed in parallel on the low priority work queue threads,
+ *   so drivers must not depend on each other except through -EAGAIN.
+ *   Nodes deferred with -EAGAIN are probed again as long as others make
+ *   progress.
+ *
+ * Input Parameters:
+ *   fdt - The pointer to the raw FDT.
+ *
+ * Returns:
+ *   OK if all of the nodes were probed, otherwise the last error.
+ *
+ ****************************************************************************/
+
+int fdt_probe_all(FAR const void *fdt);
+#endif
+
 #endif /* __INCLUDE_NUTTX_FDT_H */
@@ -0,0 +1,229 @@
+/****************************************************************************
+ * include/nuttx/fs/blkqueue.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_BLKQUEUE_H
+#define __INCLUDE_NUTTX_FS_BLKQUEUE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/spinlock.h>
+
+#ifdef CONFIG_FS_BLKQUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Block request operations */
+
+#define BLK_REQ_READ      0  /* Read sectors into the request buffer */
+#define BLK_REQ_WRITE     1  /* Write sectors from the request buffer */
+#define BLK_REQ_FLUSH     2  /* Commit the device write cache */
+#define BLK_REQ_DISCARD   3  /* Sectors are unused, contents undefined */
+#define BLK_REQ_ZEROES    4  /* Zero the sectors, no data buffer */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One asynchronous block request.  The submitter owns the request and
+ * initializes the buffer, sector, nsectors, op, complete and priv fields;
+ * the other fields are private to the queue until 'complete' is called.
+ * Discard and write zeroes requests have no buffer, are never merged and
+ * are only submitted by drivers that support them.
+ *
+ * Adjacent requests may be merged before they are dispatched:  The driver
+ * then receives the first request with the others linked to it through
+ * 'merged', in sector order.  'total' is the number of sectors of the
+ * whole chain and 'nsegs' the number of requests in it.
+ *
+ * 'complete' may be called from an interrupt handler or from the thread of
+ * the driver, and must not wait.
+ */
+
+struct blk_request_s;
+typedef CODE void (*blk_complete_t)(FAR struct blk_request_s *req);
+
+struct blk_request_s
+{
+  FAR struct blk_request_s *flink;   /* Queue link */
+  FAR struct blk_request_s *merged;  /* Next request merged in this one */
+  FAR struct blk_request_s *tail;    /* Last request merged in this one */
+  FAR uint8_t   *buffer;             /* Data buffer */
+  blkcnt_t       sector;             /* First sector */
+  unsigned int   nsectors;           /* Number of sectors */
+  unsigned int   total;              /* Number of sectors with merged ones */
+  unsigned int   batch;              /* Reordering domain */
+  uint8_t        op;                 /* See BLK_REQ_* definitions */
+  uint8_t        nsegs;              /* Number of requests in the chain */
+  ssize_t        result;             /* Sectors transferred or -errno */
+  blk_complete_t complete;           /* Called when the request is done */
+  FAR void      *priv;               /* Submitter private data */
+};
+
+/* The driver side of a queue */
+
+struct blk_queue_s;
+struct blk_queue_ops_s
+{
+  /* Start a (possibly merged) request.  Called with at most 'depth'
+   * requests outstanding, possibly from the context of
+   * blk_queue_complete().  The driver calls blk_queue_complete() when the
+   * request is done, or returns a negated errno value if it cannot be
+   * started.
+   */
+
+  CODE int (*dispatch)(FAR struct blk_queue_s *queue,
+                       FAR struct blk_request_s *req);
+};
+
+/* The submission and completion state of one device */
+
+struct blk_queue_s
+{
+  FAR const struct blk_queue_ops_s *ops;
+  FAR void *priv;                    /* Driver private data */
+  FAR struct blk_request_s *pending; /* Not dispatched, in elevator order */
+  FAR struct blk_request_s *active;  /* Dispatched to the driver */
+  spinlock_t   lock;                 /* Protects the queue */
+  blkcnt_t     position;             /* Sector after the last dispatched */
+  unsigned int batch;                /* Batch of new requests */
+  unsigned int curbatch;             /* Batch of the active requests */
+  uint16_t     depth;                /* Maximum active requests */
+  uint16_t     nactive;              /* Number of active requests */
+  uint16_t     nplug;                /* Plug nesting count */
+  uint16_t     maxsectors;           /* Maximum sectors of a merged request */
+  uint8_t      maxsegs;              /* Maximum requests merged in one */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: blk_queue_init
+ *
+ * Description:
+ *   Initialize the request queue of a block driver.
+ *
+ * Input Parameters:
+ *   queue      - The queue to initialize
+ *   ops        - The driver dispatch operation
+ *   priv       - Driver private data
+ *   depth      - Number of requests that the driver can have in flight
+ *   maxsectors - Largest merged request, in sectors
+ *   maxsegs    - Largest number of requests merged in one, at most
+ *                CONFIG_FS_BLKQUEUE_MAXSEGS
+ *
+ ****************************************************************************/
+
+void blk_queue_init(FAR struct blk_queue_s *queue,
+                    FAR const struct blk_queue_ops_s *ops, FAR void *priv,
+                    uint16_t depth, uint16_t maxsectors, uint8_t maxsegs);
+
+/****************************************************************************
+ * Name: blk_queue_submit
+ *
+ * Description:
+ *   Queue a request, merging it with an adjacent pending request if
+ *   possible, and dispatch requests unless the queue is plugged.  Requests
+ *   that overlap, and flushes, are never reordered.  May be called from
+ *   interrupt handlers.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if the request is invalid.
+ *   The completion callback is called in any case once the request is
+ *   accepted.
+ *
+ ****************************************************************************/
+
+int blk_queue_submit(FAR struct blk_queue_s *queue,
+                     FAR struct blk_request_s *req);
+
+/****************************************************************************
+ * Name: blk_queue_plug and blk_queue_unplug
+ *
+ * Description:
+ *   Hold back the dispatch of requests while a batch is submitted, so that
+ *   they can be sorted and merged.  Plugs nest; the last unplug dispatches.
+ *
+ ****************************************************************************/
+
+void blk_queue_plug(FAR struct blk_queue_s *queue);
+void blk_queue_unplug(FAR struct blk_queue_s *queue);
+
+/****************************************************************************
+ * Name: blk_queue_complete
+ *
+ * Description:
+ *   Called by the driver when a dispatched request is done.  'result' is
+ *   the number of sectors transferred from the start of the chain, or a
+ *   negated errno value.  The completion callback of each merged request
+ *   is called, then more requests are dispatched.
+ *
+ ****************************************************************************/
+
+void blk_queue_complete(FAR struct blk_queue_s *queue,
+                        FAR struct blk_request_s *req, ssize_t result);
+
+/****************************************************************************
+ * Name: blk_queue_sync
+ *
+ * Description:
+ *   Submit one request and wait for its completion.  This is meant for the
+ *   read, write and ioctl methods of drivers that use a queue, so that the
+ *   synchronous and the asynchronous requests are ordered together.  Must
+ *   not be called from interrupt handlers.
+ *
+ * Returned Value:
+ *   The number of sectors transferred or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t blk_queue_sync(FAR struct blk_queue_s *queue, uint8_t op,
+                       FAR void *buffer, blkcnt_t sector,
+                       unsigned int nsectors);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_BLKQUEUE */
+#endif /* __INCLUDE_NUTTX_FS_BLKQUEUE_H */
@@ -176,6 +176,7 @@ struct inode;
 struct stat;
 struct statfs;
 struct pollfd;
+struct iovec;
 struct mtd_dev_s;
 struct tcb_s;
 
@@ -234,6 +235,15 @@ struct file_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   CODE int     (*unlink)(FAR struct inode *inode);
 #endif
+
+  /* Optional scatter/gather methods.  readv() and writev() fall back to
+   * one read() or write() call per segment if these are NULL.
+   */
+
+  CODE ssize_t (*readv)(FAR struct file *filep,
+                        FAR const struct iovec *iov, int iovcnt);
+  CODE ssize_t (*writev)(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt);
 };
 
 /* This structure provides information about the state of a block driver */
@@ -427,6 +437,10 @@ struct inode
   struct timespec   i_ctime;    /* Time of last status change */
 #endif
   FAR void         *i_private;  /* Per inode driver private data */
+#ifdef CONFIG_FS_INODE_HASH
+  FAR struct inode *i_hnext;    /* Link in the lookup hash bucket */
+  uint32_t          i_hash;     /* Hash of i_name */
+#endif
   char              i_name[1];  /* Name of inode (variable) */
 };
 
@@ -468,7 +482,7 @@ struct file
 {
   int               f_oflags;   /* Open mode flags */
 #ifdef CONFIG_FS_REFCOUNT
-  int               f_refs;     /* Reference count */
+  atomic_int        f_refs;     /* Reference count */
 #endif
   off_t             f_pos;      /* File position */
   FAR struct inode *f_inode;    /* Driver or file system interface */
@@ -488,6 +502,10 @@ struct file
 #if CONFIG_FS_LOCK_BUCKET_SIZE > 0
   bool              locked; /* Filelock state: false - unlocked, true - locked */
 #endif
+
+#ifdef CONFIG_FS_NOTIFY
+  uint32_t          f_notify;   /* Watch generation the path was unwatched */
+#endif
 };
 
 /* This defines a two layer array of files indexed by the file descriptor.
@@ -547,6 +565,10 @@ struct filelist
  *     +----------------------+
  *                              <- fs_bufend   Points to the end of the
  *                                             buffer+1
+ *
+ * The buffers of stdin, stdout and stderr are in struct streamlist, the
+ * other streams allocate theirs when they are opened.  setvbuf() may
+ * replace the buffer with one of any size.
  */
 
 #ifdef CONFIG_FILE_STREAM
@@ -561,9 +583,6 @@ struct file_struct
   FAR char               *fs_bufend;    /* Pointer to 1 past end of buffer */
   FAR char               *fs_bufpos;    /* Current position in buffer */
   FAR char               *fs_bufread;   /* Pointer to 1 past last buffered read char. */
-#  if CONFIG_STDIO_BUFFER_SIZE > 0
-  char                    fs_buffer[CONFIG_STDIO_BUFFER_SIZE];
-#  endif
 #endif
   uint16_t                fs_oflags;    /* Open mode flags */
   uint8_t                 fs_flags;     /* Stream flags */
@@ -578,6 +597,9 @@ struct streamlist
   mutex_t                 sl_lock;   /* For thread safety */
   struct file_struct      sl_std[3];
   sq_queue_t              sl_queue;
+#if !defined(CONFIG_STDIO_DISABLE_BUFFERING) && CONFIG_STDIO_BUFFER_SIZE > 0
+  char                    sl_buffer[3][CONFIG_STDIO_BUFFER_SIZE];
+#endif
 };
 #endif /* CONFIG_FILE_STREAM */
 
@@ -690,6 +712,56 @@ int register_blockpartition(FAR const char *partition,
                             off_t firstsector, off_t nsectors);
 #endif
 
+/****************************************************************************
+ * Name: register_blockcache
+ *
+ * Description:
+ *   Register a block driver at 'path' that caches the sectors of the block
+ *   driver at 'parent'.  Written sectors are kept until eviction, the last
+ *   close or BIOC_FLUSH if CONFIG_FS_BLOCKCACHE_WRITEBACK is selected.
+ *
+ * Input Parameters:
+ *   path     - The path to the caching block driver inode
+ *   mode     - Access privileges
+ *   parent   - The path to the cached block driver
+ *   nsectors - The number of sectors to cache
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+int register_blockcache(FAR const char *path, mode_t mode,
+                        FAR const char *parent, unsigned int nsectors);
+#endif
+
+/****************************************************************************
+ * Name: register_blockcrypt
+ *
+ * Description:
+ *   Register a block driver at 'path' that encrypts the sectors of the
+ *   block driver at 'parent' with AES-XTS, using the sector number as the
+ *   tweak.
+ *
+ * Input Parameters:
+ *   path   - The path to the encrypting block driver inode
+ *   mode   - Access privileges
+ *   parent - The path to the encrypted block driver
+ *   key    - The XTS key: the data key followed by the tweak key
+ *   keylen - The key length in bytes, 32 (AES-128) or 64 (AES-256)
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCRYPT
+int register_blockcrypt(FAR const char *path, mode_t mode,
+                        FAR const char *parent, FAR const uint8_t *key,
+                        size_t keylen);
+#endif
+
 /****************************************************************************
  * Name: unregister_driver
  *
@@ -1514,6 +1586,37 @@ ssize_t file_pread(FAR struct file *filep, FAR void *buf, size_t nbytes,
 ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
                     size_t nbytes, off_t offset);
 
+/****************************************************************************
+ * Name: file_readv and file_writev
+ *
+ * Description:
+ *   Equivalent to the standard readv() and writev() functions except that
+ *   they accept a struct file instance instead of a file descriptor, do
+ *   not modify the errno variable and are not cancellation points.
+ *
+ *   The driver's readv or writev method transfers all segments in one
+ *   call.  Otherwise each segment is transferred with the read or write
+ *   method and the transfer stops at the first short read or write.
+ *
+ ****************************************************************************/
+
+ssize_t file_readv(FAR struct file *filep,
+                   FAR const struct iovec *iov, int iovcnt);
+ssize_t file_writev(FAR struct file *filep,
+                    FAR const struct iovec *iov, int iovcnt);
+
+/****************************************************************************
+ * Name: nx_readv and nx_writev
+ *
+ * Description:
+ *   Equivalent to the standard readv() and writev() functions except that
+ *   they do not modify the errno variable and are not cancellation points.
+ *
+ ****************************************************************************/
+
+ssize_t nx_readv(int fd, FAR const struct iovec *iov, int iovcnt);
+ssize_t nx_writev(int fd, FAR const struct iovec *iov, int iovcnt);
+
 /****************************************************************************
  * Name: file_sendfile
  *
@@ -1603,6 +1706,20 @@ int file_truncate(FAR struct file *filep, off_t length);
 int file_mmap(FAR struct file *filep, FAR void *start, size_t length,
               int prot, int flags, off_t offset, FAR void **mapped);
 
+/****************************************************************************
+ * Name: file_mmap_direct
+ *
+ * Description:
+ *   Map a region of a file only if it can be accessed in place, without
+ *   copying it into RAM.  Returns zero if the region is a static address,
+ *   one if it must be released with file_munmap(), or a negated errno
+ *   value.
+ *
+ ****************************************************************************/
+
+int file_mmap_direct(FAR struct file *filep, size_t length, off_t offset,
+                     FAR void **mapped);
+
 /****************************************************************************
  * Name: file_mummap
  *
@@ -1676,6 +1793,25 @@ int file_fcntl(FAR struct file *filep, int cmd, ...);
 
 int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: poll_cache_release
+ *
+ * Description:
+ *   Unregister the descriptors cached by the last poll() of a thread and
+ *   release their files.
+ *
+ * Input Parameters:
+ *   tcb - The thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+void poll_cache_release(FAR struct tcb_s *tcb);
+#endif
+
 /****************************************************************************
  * Name: file_fstat
  *
@@ -1839,6 +1975,23 @@ int file_pipe(FAR struct file *filep[2], size_t bufsize, int flags);
 int nx_mkfifo(FAR const char *pathname, mode_t mode, size_t bufsize);
 #endif
 
+/****************************************************************************
+ * Name: file_splice and file_tee
+ *
+ * Description:
+ *   Equivalent to the standard splice() and tee() functions except that
+ *   they accept struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PIPES_SPLICE
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t len, unsigned int flags);
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
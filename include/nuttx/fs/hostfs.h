@@ -220,6 +220,10 @@ int           host_rename(const char *oldpath, const char *newpath);
 int           host_stat(const char *path, struct nuttx_stat_s *buf);
 int           host_chstat(const char *path,
                           const struct nuttx_stat_s *buf, int flags);
+#ifdef CONFIG_FS_HOSTFS_MMAP
+void         *host_mmap(int fd, nuttx_size_t length);
+int           host_munmap(void *addr, nuttx_size_t length);
+#endif
 #else
 int           host_open(const char *pathname, int flags, int mode);
 int           host_close(int fd);
@@ -244,6 +248,10 @@ int           host_rename(const char *oldpath, const char *newpath);
 int           host_stat(const char *path, struct stat *buf);
 int           host_chstat(const char *path,
                           const struct stat *buf, int flags);
+#ifdef CONFIG_FS_HOSTFS_MMAP
+void         *host_mmap(int fd, size_t length);
+int           host_munmap(void *addr, size_t length);
+#endif
 #endif /* __SIM__ */
 
 #endif /* __INCLUDE_NUTTX_FS_HOSTFS_H */
@@ -104,6 +104,7 @@
 #define _PINCTRLBASE    (0x4000) /* Pinctrl driver ioctl commands */
 #define _PCIBASE        (0x4100) /* Pci ioctl commands */
 #define _I3CBASE        (0x4200) /* I3C driver ioctl commands */
+#define _USRSOCKBASE    (0x4300) /* usrsock device ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -340,6 +341,28 @@
                                            *      to return sector numbers.
                                            * OUT: Data return in user-provided
                                            *      buffer. */
+#define BIOC_GETQUEUE   _BIOC(0x0011)     /* Get the block request queue
+                                           * (kernel only).
+                                           * IN:  Pointer to writable instance
+                                           *      of FAR struct blk_queue_s *
+                                           * OUT: The queue pointer */
+#define BIOC_DISCARD    _BIOC(0x0012)     /* Tell the device that sectors are
+                                           * unused, their contents become
+                                           * undefined.
+                                           * IN:  Pointer to two uint64_t, the
+                                           *      first sector and the number
+                                           *      of sectors.
+                                           * OUT: None (ioctl return value
+                                           *      provides success/failure
+                                           *      indication). */
+#define BIOC_ZEROOUT    _BIOC(0x0013)     /* Zero sectors without transferring
+                                           * data.
+                                           * IN:  Pointer to two uint64_t, the
+                                           *      first sector and the number
+                                           *      of sectors.
+                                           * OUT: None (ioctl return value
+                                           *      provides success/failure
+                                           *      indication). */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -748,6 +771,13 @@
 #define _PINCTRLIOCVALID(c) (_IOC_TYPE(c)==_PINCTRLBASE)
 #define _PINCTRLIOC(nr)     _IOC(_PINCTRLBASE,nr)
 
+/* usrsock device ioctl definitions *****************************************/
+
+/* see nuttx/include/net/usrsock.h */
+
+#define _USRSOCKIOCVALID(c) (_IOC_TYPE(c)==_USRSOCKBASE)
+#define _USRSOCKIOC(nr)     _IOC(_USRSOCKBASE,nr)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
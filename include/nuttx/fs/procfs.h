@@ -32,6 +32,18 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Resources whose stalls are reported in /proc/pressure */
+
+#define PRESSURE_CPU        0 /* Runnable tasks waiting for a CPU */
+#define PRESSURE_IO         1 /* Tasks waiting for a block or MTD driver */
+#define PRESSURE_NET        2 /* Tasks waiting for network buffers */
+#define PRESSURE_NSTALLS    3
+
+/* Evaluate 'x', a wait for 'resource' returning ssize_t or int */
+
+#define PRESSURE_STALL(resource, x) \
+  (pressure_stall_enter(resource), pressure_stall_leave(resource, (x)))
+
 /* Data entry declaration prototypes ****************************************/
 
 /* Procfs operations are a subset of the mountpt_operations */
@@ -291,6 +303,48 @@ void procfs_register_meminfo(FAR struct procfs_meminfo_entry_s *entry);
 
 void procfs_unregister_meminfo(FAR struct procfs_meminfo_entry_s *entry);
 
+/* Functions contained in fs_procfspressure.c *******************************/
+
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+
+/****************************************************************************
+ * Name: pressure_stall_enter and pressure_stall_leave
+ *
+ * Description:
+ *   Mark the beginning and the end of a wait of the calling task for one
+ *   of the PRESSURE_* resources.  The resource is under pressure while at
+ *   least one task waits for it.  pressure_stall_leave() returns 'ret', so
+ *   that a call returning ssize_t can be wrapped in an expression.
+ *
+ ****************************************************************************/
+
+void pressure_stall_enter(int resource);
+ssize_t pressure_stall_leave(int resource, ssize_t ret);
+
+/****************************************************************************
+ * Name: pressure_stall_tick
+ *
+ * Description:
+ *   Called on each system timer tick with whether runnable tasks wait for
+ *   a CPU.  Accounts the CPU pressure, updates the running averages of all
+ *   of the resources and fires the triggers of stalls still in progress.
+ *
+ ****************************************************************************/
+
+void pressure_stall_tick(bool stalled);
+#else
+static inline void pressure_stall_enter(int resource)
+{
+}
+
+static inline ssize_t pressure_stall_leave(int resource, ssize_t ret)
+{
+  return ret;
+}
+
+#  define pressure_stall_tick(stalled)
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,103 @@
+/****************************************************************************
+ * include/nuttx/futex.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FUTEX_H
+#define __INCLUDE_NUTTX_FUTEX_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_FUTEX
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: futex_wait
+ *
+ * Description:
+ *   Block the calling thread on the 32-bit word at 'uaddr' if it still
+ *   holds 'val'.  The comparison and the queueing are atomic with respect
+ *   to futex_wake(), so a wake-up following a change of the word is never
+ *   lost.  The word itself is only read here, the caller changes it with
+ *   atomic operations in user space and calls the kernel only when it has
+ *   to wait or to wake up waiters.
+ *
+ *   Waiters are keyed by the address of the word.  In the kernel build,
+ *   the key also includes the task group, so the word cannot be shared by
+ *   processes.
+ *
+ * Input Parameters:
+ *   uaddr   - The futex word.
+ *   val     - The expected value of the word.
+ *   clockid - The clock of 'abstime'.
+ *   abstime - Absolute timeout, or NULL to wait forever.
+ *
+ * Returned Value:
+ *   Zero (OK) when woken up, which may be spurious.  -EAGAIN if the word
+ *   does not hold 'val', -ETIMEDOUT if the timeout expired, or -EINTR if
+ *   the wait was interrupted by a signal.
+ *
+ ****************************************************************************/
+
+int futex_wait(FAR volatile uint32_t *uaddr, uint32_t val,
+               clockid_t clockid, FAR const struct timespec *abstime);
+
+/****************************************************************************
+ * Name: futex_wake
+ *
+ * Description:
+ *   Wake up to 'nwake' threads waiting on the futex word at 'uaddr'.
+ *
+ * Input Parameters:
+ *   uaddr - The futex word.
+ *   nwake - The maximum number of threads to wake up, INT_MAX for all.
+ *
+ * Returned Value:
+ *   The number of threads woken up.
+ *
+ ****************************************************************************/
+
+int futex_wake(FAR volatile uint32_t *uaddr, int nwake);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_FUTEX */
+#endif /* __INCLUDE_NUTTX_FUTEX_H */
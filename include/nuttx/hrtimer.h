@@ -0,0 +1,187 @@
+/****************************************************************************
+ * include/nuttx/hrtimer.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_HRTIMER_H
+#define __INCLUDE_NUTTX_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/list.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HRTIMER_ISACTIVE(t) ((t)->func != NULL)
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+struct hrtimer_s;
+
+/* This is the form of the function that is called when the timer
+ * expires.
+ */
+
+typedef CODE void (*hrtentry_t)(FAR struct hrtimer_s *timer);
+
+/* A high resolution timer.  Times are nanoseconds of the monotonic clock
+ * of the oneshot timer.
+ */
+
+struct hrtimer_s
+{
+  struct list_node node;    /* Entry in the timer queue */
+  uint64_t         expired; /* Time the timer expires at the earliest */
+  uint32_t         slack;   /* How much later it may expire */
+  hrtentry_t       func;    /* Function to execute when expired */
+  FAR void        *arg;     /* Argument of the function */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the current time of the high resolution timers.
+ *
+ * Returned Value:
+ *   The time in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void);
+
+/****************************************************************************
+ * Name: hrtimer_abstime
+ *
+ * Description:
+ *   Convert an absolute time of a clock into the time of the high
+ *   resolution timers.
+ *
+ * Input Parameters:
+ *   clockid - The clock of abstime.
+ *   abstime - The absolute time.
+ *
+ * Returned Value:
+ *   The time in nanoseconds.  A time already passed returns the current
+ *   time.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_abstime(clockid_t clockid,
+                         FAR const struct timespec *abstime);
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start a high resolution timer, or restart it with a new expiration.
+ *   The function is called from the interrupt level once the time has
+ *   passed, and at the latest slack nanoseconds later.  Timers whose
+ *   intervals overlap expire together, with a single interrupt.
+ *
+ * Input Parameters:
+ *   timer   - The timer.
+ *   expired - The time to expire at, from hrtimer_gettime().
+ *   slack   - How much later the timer may expire.
+ *   func    - Function to call on expiration.
+ *   arg     - Argument of the function, in timer->arg.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ * Assumptions:
+ *   The function runs in the context of the timer interrupt handler, with
+ *   the same restrictions as a watchdog function.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t expired,
+                  uint32_t slack, hrtentry_t func, FAR void *arg);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a high resolution timer.  Nothing is done if it is not active.
+ *
+ * Input Parameters:
+ *   timer - The timer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer);
+
+/****************************************************************************
+ * Name: hrtimer_gettimeleft
+ *
+ * Description:
+ *   Return the nanoseconds until a timer expires, zero if it is not
+ *   active.
+ *
+ ****************************************************************************/
+
+static inline uint64_t hrtimer_gettimeleft(FAR struct hrtimer_s *timer)
+{
+  uint64_t now;
+
+  if (!HRTIMER_ISACTIVE(timer))
+    {
+      return 0;
+    }
+
+  now = hrtimer_gettime();
+  return timer->expired > now ? timer->expired - now : 0;
+}
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __INCLUDE_NUTTX_HRTIMER_H */
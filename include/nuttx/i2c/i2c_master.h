@@ -203,6 +203,31 @@
 
 #define I2C_SHUTDOWN(d) ((d)->ops->shutdown(d))
 
+/****************************************************************************
+ * Name: I2C_ASYNC
+ *
+ * Description:
+ *   Start the messages of a request and return without waiting.  The
+ *   lower half runs them as one sequence, DMA-driven where it can, and
+ *   calls i2c_async_complete() when they are done, normally from its
+ *   interrupt handler.  Only the I2C asynchronous queue calls this method;
+ *   transfer() must wait while a request is in progress.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - The request to run
+ *
+ * Returned Value:
+ *   OK      - The messages were started
+ *   -ENOSYS - The lower half cannot run requests asynchronously
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_ASYNC
+#  define I2C_ASYNC(d,r) \
+  (((d)->ops->async) ? ((d)->ops->async(d,r)) : -ENOSYS)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -211,6 +236,7 @@
 
 struct i2c_master_s;
 struct i2c_msg_s;
+struct i2c_request_s;
 struct i2c_ops_s
 {
   CODE int (*transfer)(FAR struct i2c_master_s *dev,
@@ -220,6 +246,10 @@ struct i2c_ops_s
 #endif
   CODE int (*setup)(FAR struct i2c_master_s *dev);
   CODE int (*shutdown)(FAR struct i2c_master_s *dev);
+#ifdef CONFIG_I2C_ASYNC
+  CODE int (*async)(FAR struct i2c_master_s *dev,
+                    FAR struct i2c_request_s *req);
+#endif
 };
 
 /* This structure contains the full state of I2C as needed for a specific
@@ -268,6 +298,40 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_ASYNC
+/* This describes the messages queued with i2c_async_submit().  The
+ * callback runs when they are done, from the interrupt handler of the
+ * lower half if it implements I2C_ASYNC(), from the work queue otherwise.
+ * It may submit the request again.
+ */
+
+struct i2c_async_s;
+
+typedef CODE void (*i2c_async_callback_t)(FAR struct i2c_request_s *req);
+
+struct i2c_request_s
+{
+  FAR struct i2c_request_s *flink;  /* Used by the queue */
+  FAR struct i2c_async_s *queue;    /* Used by the queue */
+  FAR struct i2c_msg_s *msgs;       /* The messages */
+  int count;                        /* Number of messages */
+  i2c_async_callback_t callback;    /* Called on completion */
+  FAR void *arg;                    /* Argument of the callback */
+  int result;                       /* OK or a negated errno value */
+};
+
+/* One device of a scan list: length bytes are read from register reg on */
+
+struct i2c_scan_s
+{
+  uint16_t addr;                    /* Slave address (7- or 10-bit) */
+  uint16_t flags;                   /* I2C_M_TEN for a 10-bit address */
+  uint8_t reg;                      /* First register to read */
+  FAR uint8_t *buffer;              /* Receives the registers */
+  ssize_t length;                   /* Number of bytes to read */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -381,6 +445,103 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+#ifdef CONFIG_I2C_ASYNC
+/****************************************************************************
+ * Name: i2c_async_initialize
+ *
+ * Description:
+ *   Create the asynchronous request queue of an I2C bus.  All of the
+ *   drivers of devices on the bus share it.
+ *
+ *   If the lower half implements I2C_ASYNC(), the requests are started
+ *   from the submitter and from the completion interrupt without a thread
+ *   in between.  Otherwise they are run with I2C_TRANSFER() on the work
+ *   queue.
+ *
+ * Input Parameters:
+ *   i2c - An instance of the lower half I2C driver
+ *
+ * Returned Value:
+ *   The queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct i2c_async_s *i2c_async_initialize(FAR struct i2c_master_s *i2c);
+
+/****************************************************************************
+ * Name: i2c_async_uninitialize
+ *
+ * Description:
+ *   Free a queue created by i2c_async_initialize().  It must be idle.
+ *
+ ****************************************************************************/
+
+void i2c_async_uninitialize(FAR struct i2c_async_s *async);
+
+/****************************************************************************
+ * Name: i2c_async_submit
+ *
+ * Description:
+ *   Queue a request and return.  The requests of the bus are run in order
+ *   back to back.  req->msgs, req->count, req->callback and req->arg must
+ *   be set; the request and its buffers must stay valid until the
+ *   callback.  May be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   async - The queue of the bus
+ *   req   - The request to run
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int i2c_async_submit(FAR struct i2c_async_s *async,
+                     FAR struct i2c_request_s *req);
+
+/****************************************************************************
+ * Name: i2c_async_complete
+ *
+ * Description:
+ *   Called by a lower half that implements I2C_ASYNC() when the request it
+ *   was given is done.  The callback of the request is called and the next
+ *   request is started.  May be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   req    - The request that is done
+ *   result - OK or a negated errno value
+ *
+ ****************************************************************************/
+
+void i2c_async_complete(FAR struct i2c_request_s *req, int result);
+
+/****************************************************************************
+ * Name: i2c_scan_setup
+ *
+ * Description:
+ *   Build a request that reads the registers of several devices back to
+ *   back in a single sequence: a write of the register address followed
+ *   by a restarted read for each device.  The request can be submitted
+ *   again each cycle, its callback gets the readings of all devices at
+ *   once.
+ *
+ * Input Parameters:
+ *   req       - The request to build.  The callback and its argument are
+ *               left to the caller.
+ *   msgs      - An array of 2 * nscan messages for the request
+ *   scan      - The devices and registers to read.  It must stay valid as
+ *               long as the request is used.
+ *   nscan     - The number of devices
+ *   frequency - I2C frequency
+ *
+ ****************************************************************************/
+
+void i2c_scan_setup(FAR struct i2c_request_s *req,
+                    FAR struct i2c_msg_s *msgs,
+                    FAR struct i2c_scan_s *scan, int nscan,
+                    uint32_t frequency);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,180 @@
+/****************************************************************************
+ * include/nuttx/initcall.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_INITCALL_H
+#define __INCLUDE_NUTTX_INITCALL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+#include <nuttx/queue.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_INITCALL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Initcall levels.  All of the calls of a level that are not deferred are
+ * complete before any call of a higher level starts.
+ */
+
+#define INITCALL_LEVEL_BUS     0   /* Buses, clocks, regulators */
+#define INITCALL_LEVEL_DRIVER  1   /* Device drivers */
+#define INITCALL_LEVEL_FS      2   /* File systems, mount points */
+#define INITCALL_LEVEL_NET     3   /* Network interfaces */
+#define INITCALL_LEVEL_LATE    4   /* Anything else */
+
+/* Initcall flags */
+
+#define INITCALL_DEFERRED      (1 << 0) /* Neither later levels nor the
+                                         * application wait for it */
+
+/* Define a static initcall, for example:
+ *
+ *   static FAR const char * const g_sdmount_deps[] =
+ *   {
+ *     "sdcard", NULL
+ *   };
+ *
+ *   static INITCALL_DEFINE(g_sdmount, "sdmount", board_sdmount,
+ *                          INITCALL_LEVEL_FS, INITCALL_DEFERRED,
+ *                          g_sdmount_deps);
+ */
+
+#define INITCALL_DEFINE(var, name, func, level, flags, depends) \
+  struct initcall_s var = \
+  { \
+    { NULL }, (name), (func), (level), (flags), (depends) \
+  }
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct initcall_s
+{
+  sq_entry_t node;                   /* Used internally */
+  FAR const char *name;              /* Name used by dependencies */
+  CODE int (*func)(void);            /* The initialization function */
+  uint8_t level;                     /* See INITCALL_LEVEL_* */
+  uint8_t flags;                     /* See INITCALL_* flags */
+  FAR const char * const *depends;   /* NULL terminated names, or NULL */
+
+  /* The state of the call, used internally */
+
+  uint8_t state;
+  int result;
+#ifdef CONFIG_INITCALL_TRACE
+  uint8_t cpu;
+  clock_t start;
+  clock_t end;
+#endif
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: initcall_register
+ *
+ * Description:
+ *   Queue an initcall.  Calls are queued from board_early_initialize() or
+ *   board_late_initialize(), and are run by initcall_run(), which is
+ *   called once board_late_initialize() returns.
+ *
+ * Input Parameters:
+ *   call - The initcall, which must stay valid.
+ *
+ ****************************************************************************/
+
+void initcall_register(FAR struct initcall_s *call);
+
+/****************************************************************************
+ * Name: initcall_run
+ *
+ * Description:
+ *   Run the queued initcalls up to level on the initcall threads, and
+ *   wait until all of those which are not deferred are complete.  A call
+ *   starts once all of its dependencies are complete.  A call with a
+ *   dependency that failed fails with -ENODEV without being run.
+ *
+ * Input Parameters:
+ *   level - The highest level to run.
+ *
+ * Returned Value:
+ *   Zero (OK) if all of the calls waited for succeeded; the error of one
+ *   of those that failed otherwise.
+ *
+ ****************************************************************************/
+
+int initcall_run(int level);
+
+/****************************************************************************
+ * Name: initcall_wait
+ *
+ * Description:
+ *   Wait until a call, deferred or not, is complete.
+ *
+ * Input Parameters:
+ *   name - The name of the call.
+ *
+ * Returned Value:
+ *   The value returned by the call; -ENOENT if no such call is queued.
+ *
+ ****************************************************************************/
+
+int initcall_wait(FAR const char *name);
+
+/****************************************************************************
+ * Name: initcall_trace
+ *
+ * Description:
+ *   Print when and on which CPU each complete call ran, and the chain of
+ *   calls and dependencies that took longest to boot.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_INITCALL_TRACE
+void initcall_trace(void);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_INITCALL */
+#endif /* __INCLUDE_NUTTX_INITCALL_H */
@@ -30,6 +30,7 @@
 #ifndef __ASSEMBLY__
 #  include <stdint.h>
 #  include <stdbool.h>
+#  include <sys/types.h>
 #endif
 
 /* Now include architecture-specific types */
@@ -222,12 +223,63 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
 int irq_attach_wqueue(int irq, xcpt_t isr, xcpt_t isrwork,
                       FAR void *arg, int priority);
 
+/****************************************************************************
+ * Name: irq_set_affinity/irq_get_affinity
+ *
+ * Description:
+ *   Set or get the CPUs that IRQ number 'irq' is routed to.  The handler
+ *   thread of an IRQ attached with irq_attach_thread() is bound to the same
+ *   CPUs.  Setting the affinity pins the IRQ, so that the IRQ balancer does
+ *   not move it any more; setting it to all of the CPUs unpins it.
+ *
+ *   Interrupt controllers that can only route an IRQ to a single CPU
+ *   route it to the first CPU of the set, or to any CPU (if supported) if
+ *   the set holds all of them.
+ *
+ * Input Parameters:
+ *   irq    - IRQ number
+ *   cpuset - The CPUs
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.  An IRQ whose
+ *   affinity was never set reports all of the CPUs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQAFFINITY
+int irq_set_affinity(int irq, cpu_set_t cpuset);
+int irq_get_affinity(int irq, FAR cpu_set_t *cpuset);
+#endif
+
 #ifdef CONFIG_IRQCHAIN
 int irqchain_detach(int irq, xcpt_t isr, FAR void *arg);
 #else
 #  define irqchain_detach(irq, isr, arg) irq_detach(irq)
 #endif
 
+/****************************************************************************
+ * Name: irq_latency_start
+ *
+ * Description:
+ *   Start measuring the interrupt latency with a oneshot timer that is not
+ *   used for anything else.  A high priority kernel thread programs the
+ *   timer again and again; the delays from the programmed expiry to the
+ *   timer interrupt and to the wakeup of the thread are collected into
+ *   histograms per CPU, shown in /proc/irqlatency.
+ *
+ * Input Parameters:
+ *   lower - The oneshot timer, typically set up by the board.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQLATENCY
+struct oneshot_lowerhalf_s;
+int irq_latency_start(FAR struct oneshot_lowerhalf_s *lower);
+#endif
+
 /****************************************************************************
  * Name: enter_critical_section
  *
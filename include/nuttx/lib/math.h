@@ -69,6 +69,10 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#ifdef CONFIG_LIBM_VECTOR
+#  include <stddef.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -610,6 +614,16 @@ double      scalbn(double x, int n);
 long double scalbnl(long double x, int n);
 #endif
 
+/* Vector Functions *********************************************************/
+
+#ifdef CONFIG_LIBM_VECTOR
+void        vsinf (FAR const float *x, FAR float *y, size_t n);
+void        vcosf (FAR const float *x, FAR float *y, size_t n);
+void        vexpf (FAR const float *x, FAR float *y, size_t n);
+void        vlogf (FAR const float *x, FAR float *y, size_t n);
+void        vsqrtf(FAR const float *x, FAR float *y, size_t n);
+#endif
+
 #define FP_INFINITE     0
 #define FP_NAN          1
 #define FP_NORMAL       2
@@ -22,7 +22,10 @@
 #define __INCLUDE_NUTTX_MM_CIRCBUF_H
 
 /* Note about locking: There is no locking required while only one reader
- * and one writer is using the circular buffer.
+ * and one writer is using the circular buffer.  The writer publishes the
+ * head only after the data, and the reader the tail only after it is done
+ * with the data, so an interrupt handler may produce for a thread without
+ * a critical section.
  * For multiple writer and one reader there is only a need to lock the
  * writer. And vice versa for only one writer and multiple reader there is
  * only a need to lock the reader.
@@ -48,8 +51,30 @@ struct circbuf_s
   size_t    head;     /* The head of buffer space */
   size_t    tail;     /* The tail of buffer space */
   bool      external; /* The flag for external buffer */
+
+  /* The header mapped by circbuf_mmap(), or NULL */
+
+  FAR struct circbuf_header_s *header;
 };
 
+/* This structure is the header of the region that circbuf_mmap() maps,
+ * the data follows it.  head and tail count the bytes written and consumed
+ * since the buffer was created; byte n is at offset n % size after the
+ * header.  head is updated after the data, so a mapping user may read
+ * the bytes between tail and head, and checks tail again afterwards to
+ * find out whether the writer has overwritten them meanwhile.
+ */
+
+struct circbuf_header_s
+{
+  volatile size_t head;     /* The number of bytes written */
+  volatile size_t tail;     /* The number of bytes consumed */
+  size_t          size;     /* The size of the data */
+  size_t          reserved; /* Keeps the data 64-bit aligned */
+};
+
+struct mm_map_entry_s;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -114,6 +139,45 @@ int circbuf_resize(FAR struct circbuf_s *circ, size_t bytes);
 
 void circbuf_uninit(FAR struct circbuf_s *circ);
 
+/****************************************************************************
+ * Name: circbuf_init_mmap
+ *
+ * Description:
+ *   Initialize a circular buffer that can be mapped read-only with
+ *   circbuf_mmap().  The buffer is allocated behind a struct
+ *   circbuf_header_s, which mirrors the head and the tail.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   bytes - The size of the internal buffer.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int circbuf_init_mmap(FAR struct circbuf_s *circ, size_t bytes);
+
+/****************************************************************************
+ * Name: circbuf_mmap
+ *
+ * Description:
+ *   Map the header and the data of a circular buffer set up with
+ *   circbuf_init_mmap(), for the mmap() method of a driver.  The mapping
+ *   must be read-only.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   map   - The mapping requested, vaddr is set on success.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int circbuf_mmap(FAR struct circbuf_s *circ,
+                 FAR struct mm_map_entry_s *map);
+
 /****************************************************************************
  * Name: circbuf_reset
  *
@@ -219,6 +219,19 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Try to allocate 'count' I/O buffers linked through io_flink with a
+ *   single acquisition of the free list lock.  Either all of the buffers
+ *   are allocated or none; the function never waits and may be called from
+ *   interrupt handlers.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_batch(bool throttled, unsigned int count);
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
@@ -361,6 +374,17 @@ void iob_notifier_teardown(int key);
 
 void iob_free_chain(FAR struct iob_s *iob);
 
+/****************************************************************************
+ * Name: iob_free_chain_batch
+ *
+ * Description:
+ *   Free an entire buffer chain with a single acquisition of the free list
+ *   lock, unless a task waits for an I/O buffer.
+ *
+ ****************************************************************************/
+
+void iob_free_chain_batch(FAR struct iob_s *iob);
+
 /****************************************************************************
  * Name: iob_add_queue
  *
@@ -44,6 +44,12 @@
 #  define MEMPOOL_ALIGN       CONFIG_MM_DEFAULT_ALIGNMENT
 #endif
 
+/* The size of a cache line, the architecture may override it */
+
+#ifndef MEMPOOL_CACHE_ALIGN
+#  define MEMPOOL_CACHE_ALIGN 64
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 #  define MEMPOOL_REALBLOCKSIZE(pool) (ALIGN_UP((pool)->blocksize + \
                                        sizeof(struct mempool_backtrace_s), \
@@ -90,6 +96,24 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+/* The per-CPU cache of free blocks of a memory pool.  Aligned so that the
+ * caches of two CPUs never share a cache line.
+ */
+
+struct mempool_cache_s
+{
+  /* LIFO of cached free blocks, starting a cache line */
+
+  FAR sq_entry_t *head aligned_data(MEMPOOL_CACHE_ALIGN);
+  size_t          count;   /* The number of blocks in the cache */
+  unsigned long   ahit;    /* Allocations served by the cache */
+  unsigned long   amiss;   /* Allocations that had to refill the cache */
+  unsigned long   fhit;    /* Releases absorbed by the cache */
+  unsigned long   fmiss;   /* Releases that had to flush the cache */
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -116,6 +140,9 @@ struct mempool_s
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
 #endif
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+  struct mempool_cache_s cache[CONFIG_SMP_NCPUS]; /* The per-CPU caches */
+#endif
 };
 
 #if CONFIG_MM_BACKTRACE >= 0
@@ -163,6 +163,11 @@ struct mempool_init_s
   size_t            dict_expendsize;
 };
 
+/* This describes the callback for mm_foreach_unused */
+
+typedef CODE void (*mm_range_handler_t)(FAR void *start, size_t size,
+                                        FAR void *arg);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -406,6 +411,11 @@ struct mallinfo_task kmm_mallinfo_task(FAR const struct malltask *task);
 void mm_memdump(FAR struct mm_heap_s *heap,
                 FAR const struct mm_memdump_s *dump);
 
+/* Functions contained in mm_foreach.c **************************************/
+
+void mm_foreach_unused(FAR struct mm_heap_s *heap,
+                       mm_range_handler_t handler, FAR void *arg);
+
 /* Functions contained in umm_memdump.c *************************************/
 
 void umm_memdump(FAR const struct mm_memdump_s *dump);
@@ -36,6 +36,7 @@
 #include <stdbool.h>
 #include <mqueue.h>
 #include <poll.h>
+#include <semaphore.h>
 
 #if defined(CONFIG_MQ_MAXMSGSIZE) && (CONFIG_MQ_MAXMSGSIZE > 0)
 
@@ -89,6 +90,14 @@
 #  define nxmq_pollnotify(msgq, eventset)
 #endif
 
+#ifdef CONFIG_MQ_RING
+#  define nxmq_nmsgs(msgq) \
+     ((msgq)->ring != NULL ? \
+      (int16_t)((msgq)->ring->head - (msgq)->ring->tail) : (msgq)->nmsgs)
+#else
+#  define nxmq_nmsgs(msgq)            ((msgq)->nmsgs)
+#endif
+
 #  define MQ_WNELIST(cmn)             (&((cmn).waitfornotempty))
 #  define MQ_WNFLIST(cmn)             (&((cmn).waitfornotfull))
 
@@ -106,6 +115,26 @@ struct mqueue_cmn_s
   int16_t nwaitnotempty;      /* Number tasks waiting for not empty */
 };
 
+#ifdef CONFIG_MQ_RING
+/* Preallocated ring of a queue created with MQ_RING.  Senders and
+ * receivers claim slots with compare-and-swap and only use the semaphores
+ * when the ring is full or empty.
+ */
+
+struct mqueue_ring_s
+{
+  volatile uint32_t head;      /* Position of the next slot to fill */
+  volatile uint32_t tail;      /* Position of the next slot to drain */
+  volatile uint32_t nwaitsend; /* Senders waiting for a free slot */
+  volatile uint32_t nwaitrecv; /* Receivers waiting for a message */
+  sem_t notfull;               /* Posted when a slot is freed */
+  sem_t notempty;              /* Posted when a message is added */
+  uint32_t mask;               /* Number of slots - 1 */
+  uint32_t slotsize;           /* Sequence word and payload of a slot */
+  FAR uint8_t *slots;          /* The slots, after this structure */
+};
+#endif
+
 /* This structure defines a message queue */
 
 struct mqueue_inode_s
@@ -124,6 +153,9 @@ struct mqueue_inode_s
   pid_t ntpid;                /* Notification: Receiving Task's PID */
   struct sigevent ntevent;    /* Notification description */
   struct sigwork_s ntwork;    /* Notification work */
+#endif
+#ifdef CONFIG_MQ_RING
+  FAR struct mqueue_ring_s *ring; /* Ring of a MQ_RING queue, or NULL */
 #endif
   FAR struct pollfd *fds[CONFIG_FS_MQUEUE_NPOLLWAITERS];
 };
@@ -33,6 +33,7 @@
 #include <stdbool.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/fs/procfs.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -77,13 +78,22 @@
 #define MTDIOC_ERASESECTORS _MTDIOC(0x000c) /* IN: Pointer to mtd_erase_s structure
                                              * OUT: None */
 
-/* Macros to hide implementation */
+/* Macros to hide implementation.  The accesses to the media are accounted
+ * as IO pressure.
+ */
 
-#define MTD_ERASE(d,s,n)   ((d)->erase   ? (d)->erase(d,s,n)    : (-ENOSYS))
-#define MTD_BREAD(d,s,n,b) ((d)->bread   ? (d)->bread(d,s,n,b)  : (-ENOSYS))
-#define MTD_BWRITE(d,s,n,b)((d)->bwrite  ? (d)->bwrite(d,s,n,b) : (-ENOSYS))
-#define MTD_READ(d,s,n,b)  ((d)->read    ? (d)->read(d,s,n,b)   : (-ENOSYS))
-#define MTD_WRITE(d,s,n,b) ((d)->write   ? (d)->write(d,s,n,b)  : (-ENOSYS))
+#define MTD_STALL(x)       PRESSURE_STALL(PRESSURE_IO, x)
+
+#define MTD_ERASE(d,s,n)   \
+  MTD_STALL((d)->erase  ? (d)->erase(d,s,n)    : (-ENOSYS))
+#define MTD_BREAD(d,s,n,b) \
+  MTD_STALL((d)->bread  ? (d)->bread(d,s,n,b)  : (-ENOSYS))
+#define MTD_BWRITE(d,s,n,b) \
+  MTD_STALL((d)->bwrite ? (d)->bwrite(d,s,n,b) : (-ENOSYS))
+#define MTD_READ(d,s,n,b)  \
+  MTD_STALL((d)->read   ? (d)->read(d,s,n,b)   : (-ENOSYS))
+#define MTD_WRITE(d,s,n,b) \
+  MTD_STALL((d)->write  ? (d)->write(d,s,n,b)  : (-ENOSYS))
 #define MTD_IOCTL(d,c,a)   ((d)->ioctl   ? (d)->ioctl(d,c,a)    : (-ENOSYS))
 #define MTD_ISBAD(d,b)     ((d)->isbad   ? (d)->isbad(d,b)      : (-ENOSYS))
 #define MTD_MARKBAD(d,b)   ((d)->markbad ? (d)->markbad(d,b)    : (-ENOSYS))
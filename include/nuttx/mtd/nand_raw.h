@@ -65,6 +65,10 @@
 #define COMMAND_READID                  0x90
 #define COMMAND_WRITE_1                 0x80
 #define COMMAND_WRITE_2                 0x10
+#define COMMAND_WRITE_CACHE_2           0x15
+#define COMMAND_WRITE_PLANE_2           0x11
+#define COMMAND_READ_CACHE_SEQ          0x31
+#define COMMAND_READ_CACHE_END          0x3f
 #define COMMAND_ERASE_1                 0x60
 #define COMMAND_ERASE_2                 0xd0
 #define COMMAND_STATUS                  0x70
@@ -225,6 +229,56 @@
 #  define NAND_WRITEPAGE(r,b,p,d,s) ((r)->rawwrite(r,b,p,d,s))
 #endif
 
+/****************************************************************************
+ * Name: NAND_READPAGES
+ *
+ * Description:
+ *   Reads the data areas of consecutive pages of one block, like
+ *   NAND_READPAGE does for a single page.  This is optional: lower halves
+ *   supporting the read cache commands (COMMAND_READ_CACHE_SEQ and
+ *   COMMAND_READ_CACHE_END) or multi-plane reads provide it to transfer a
+ *   page while the next one is read from the array.  readpages is NULL
+ *   otherwise.
+ *
+ * Input Parameters:
+ *   raw    - Lower-half, raw NAND FLASH interface
+ *   block  - Number of the block where the pages to read reside.
+ *   page   - Number of the first page to read inside the given block.
+ *   npages - Number of pages to read, not beyond the end of the block.
+ *   data   - Buffer where the data areas will be stored.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *   -EUCLEAN is returned if bit errors were corrected.
+ *
+ ****************************************************************************/
+
+#define NAND_READPAGES(r,b,p,n,d) ((r)->readpages(r,b,p,n,d))
+
+/****************************************************************************
+ * Name: NAND_WRITEPAGES
+ *
+ * Description:
+ *   Writes the data areas of consecutive pages of one block, like
+ *   NAND_WRITEPAGE does for a single page.  This is optional: lower halves
+ *   supporting the cache program command (COMMAND_WRITE_CACHE_2) or
+ *   multi-plane programs (COMMAND_WRITE_PLANE_2) provide it to load a page
+ *   while the previous one is programmed.  writepages is NULL otherwise.
+ *
+ * Input Parameters:
+ *   raw    - Lower-half, raw NAND FLASH interface
+ *   block  - Number of the block where the pages to write reside.
+ *   page   - Number of the first page to write inside the given block.
+ *   npages - Number of pages to write, not beyond the end of the block.
+ *   data   - Buffer containing the data to be written.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#define NAND_WRITEPAGES(r,b,p,n,d) ((r)->writepages(r,b,p,n,d))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -261,6 +315,15 @@ struct nand_raw_s
                         FAR const void *spare);
 #endif
 
+  /* Optional multi-page operations, may be NULL */
+
+  CODE int (*readpages)(FAR struct nand_raw_s *raw, off_t block,
+                        unsigned int page, unsigned int npages,
+                        FAR void *data);
+  CODE int (*writepages)(FAR struct nand_raw_s *raw, off_t block,
+                         unsigned int page, unsigned int npages,
+                         FAR const void *data);
+
 #if defined(CONFIG_MTD_NAND_SWECC) || defined(CONFIG_MTD_NAND_HWECC)
   /* ECC working buffers */
 
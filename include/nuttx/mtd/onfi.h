@@ -48,6 +48,17 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Features supported (bytes 6-7 in the parameter page) */
+
+#define ONFI_FEATURE_BUS16        (1 << 0) /* 16-bit data bus */
+#define ONFI_FEATURE_MULTILUN     (1 << 1) /* Multiple LUN operations */
+#define ONFI_FEATURE_MULTIPLANE   (1 << 3) /* Multi-plane program and erase */
+
+/* Optional commands supported (bytes 8-9 in the parameter page) */
+
+#define ONFI_OPTCMD_CACHEPROGRAM  (1 << 0) /* Page cache program */
+#define ONFI_OPTCMD_CACHEREAD     (1 << 1) /* Read cache */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -61,6 +72,8 @@ struct onfi_pgparam_s
   uint8_t luns;           /* Number of logical units */
   uint8_t eccsize;        /* Number of bits of ECC correction */
   uint8_t model;          /* Device model */
+  uint16_t features;      /* Features supported, see ONFI_FEATURE_* */
+  uint16_t optcmds;       /* Optional commands supported, see ONFI_OPTCMD_* */
   uint16_t sparesize;     /* Number of spare bytes per page */
   uint16_t pagesperblock; /* Number of pages per block */
   uint16_t blocksperlun;  /* Number of blocks per logical unit (LUN) */
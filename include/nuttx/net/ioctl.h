@@ -123,6 +123,14 @@
 #define SIOCACANSTDFILTER  _SIOC(0x0030)  /* Add hardware-level standard ID filter */
 #define SIOCDCANSTDFILTER  _SIOC(0x0031)  /* Delete hardware-level standard ID filter */
 #define SIOCCANRECOVERY    _SIOC(0x0032)  /* Recovery can, work only when bus-off state */
+#define SIOCSCANHWFILTER   _SIOC(0x0042)  /* Set the acceptance filter that
+                                           * passes every frame a socket
+                                           * wants.  Argument:
+                                           * struct can_ioctl_filter_s with
+                                           * ftype CAN_FILTER_MASK, fid1 the
+                                           * code and fid2 the mask over the
+                                           * canid_t bits.  Issued by the
+                                           * stack to d_ioctl only. */
 
 /* Network socket control ***************************************************/
 
@@ -146,6 +154,11 @@
 #define SIOCATMARK         _SIOC(0x003E)  /* Determine whether socket is at
                                            * out-of-band mark */
 
+/* Zero-copy receive ********************************************************/
+
+#define SIOCRECVIOB        _SIOC(0x0041)  /* Take the received IOB chain.
+                                           * Argument: struct net_recviob_s */
+
 /* RSS notify recv cpu calls ************************************************/
 
 #define SIOCNOTIFYRECVCPU  _SIOC(0x003F)  /* RSS notify recv cpu */
@@ -135,10 +135,11 @@ typedef uint8_t sockcaps_t;
  * a given address family.
  */
 
-struct file;    /* Forward reference */
-struct stat;    /* Forward reference */
-struct socket;  /* Forward reference */
-struct pollfd;  /* Forward reference */
+struct file;           /* Forward reference */
+struct stat;           /* Forward reference */
+struct socket;         /* Forward reference */
+struct pollfd;         /* Forward reference */
+struct mm_map_entry_s; /* Forward reference */
 
 struct sock_intf_s
 {
@@ -179,6 +180,8 @@ struct sock_intf_s
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+  CODE int        (*si_mmap)(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -189,6 +192,32 @@ struct sock_intf_s
  * then follow the common prologue fields.
  */
 
+#ifdef CONFIG_NET_LATENCY
+/* The stages of the latency of a socket */
+
+enum net_latency_e
+{
+  NET_LATENCY_INPUT = 0,  /* Packet received until queued to the socket */
+  NET_LATENCY_RECV,       /* Queued to the socket until read */
+  NET_LATENCY_SEND,       /* Written until handed to the device */
+  NET_LATENCY_NSTAGES
+};
+
+/* The latency histogram of one stage, bucket n counts the latencies below
+ * 2^n microseconds, the last bucket all of the longer ones.
+ */
+
+#define NET_LATENCY_NBUCKETS 16
+
+struct net_latency_s
+{
+  uint32_t count;         /* Number of samples */
+  uint32_t max;           /* Longest latency (us) */
+  uint64_t total;         /* Sum of the latencies (us) */
+  uint32_t hist[NET_LATENCY_NBUCKETS];
+};
+#endif
+
 struct devif_callback_s;  /* Forward reference */
 
 struct socket_conn_s
@@ -232,9 +261,37 @@ struct socket_conn_s
   uint8_t       s_ttl;       /* Default time-to-live */
 #endif
 
+#ifdef CONFIG_NET_LOCK_SPLIT
+  rmutex_t      s_lock;      /* Protects the connection read-ahead data */
+#endif
+
+#ifdef CONFIG_NET_LATENCY
+  struct net_latency_s s_latency[NET_LATENCY_NSTAGES];
+#endif
+
   /* Connection-specific content may follow */
 };
 
+#ifdef CONFIG_NET_RECV_ZEROCOPY
+/* The argument of the SIOCRECVIOB ioctl.  On success, ri_iob holds the
+ * received data (only the payload) as an I/O buffer chain owned by the
+ * caller, to be released with iob_free_chain().  The ioctl never blocks:
+ * -EAGAIN is returned if there is no data yet.
+ */
+
+struct iob_s;             /* Forward reference */
+
+struct net_recviob_s
+{
+  size_t            ri_maxlen;  /* In: Max bytes to take (TCP), 0: all */
+  FAR struct iob_s *ri_iob;     /* Out: The received I/O buffer chain */
+  size_t            ri_len;     /* Out: The number of bytes in ri_iob */
+  FAR struct sockaddr *ri_from; /* In: Buffer for the source address of a
+                                 *     datagram (UDP), may be NULL */
+  socklen_t         ri_fromlen; /* In/Out: Length of ri_from */
+};
+#endif
+
 /* This is the internal representation of a socket reference by a file
  * descriptor.
  */
@@ -294,6 +351,20 @@ extern "C"
 
 void net_initialize(void);
 
+/****************************************************************************
+ * Name: net_bench_start
+ *
+ * Description:
+ *   Start the kernel thread that measures the throughput and the cost per
+ *   packet of the stack, over the interface that owns
+ *   CONFIG_NET_BENCH_ADDR, and logs the results.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BENCH
+int net_bench_start(void);
+#endif
+
 /****************************************************************************
  * Name: net_ioctl_arglen
  *
@@ -378,6 +449,51 @@ int net_trylock(void);
 
 void net_unlock(void);
 
+/****************************************************************************
+ * Name: netdev_lock, netdev_unlock
+ *
+ * Description:
+ *   Take or release the lock of one network device.  With
+ *   CONFIG_NET_LOCK_SPLIT, this serializes the access to the driver (and to
+ *   its d_iob/d_buf) without holding the network lock.  If both are needed,
+ *   the network lock must be taken first.  These are no-ops otherwise.
+ *
+ * Input Parameters:
+ *   dev - The network device to be locked or unlocked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_SPLIT
+struct net_driver_s;      /* Forward reference */
+void netdev_lock(FAR struct net_driver_s *dev);
+void netdev_unlock(FAR struct net_driver_s *dev);
+#else
+#  define netdev_lock(dev)
+#  define netdev_unlock(dev)
+#endif
+
+/****************************************************************************
+ * Name: conn_lock, conn_unlock
+ *
+ * Description:
+ *   Take or release the lock of one socket connection.  With
+ *   CONFIG_NET_LOCK_SPLIT, this protects the read-ahead data of the
+ *   connection so that it can be consumed without holding the network lock.
+ *   It is the innermost network lock.  These are no-ops otherwise.
+ *
+ * Input Parameters:
+ *   sconn - The common part of the connection to be locked or unlocked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_SPLIT
+void conn_lock(FAR struct socket_conn_s *sconn);
+void conn_unlock(FAR struct socket_conn_s *sconn);
+#else
+#  define conn_lock(sconn)
+#  define conn_unlock(sconn)
+#endif
+
 /****************************************************************************
  * Name: net_sem_timedwait
  *
@@ -926,6 +1042,56 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a vector of messages from a socket.  This is
+ *   an internal OS interface, functionally equivalent to recvmmsg() except
+ *   that it is not a cancellation point, does not modify errno and accepts
+ *   the internal socket structure.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to receive
+ *   vlen      The number of messages in msgvec
+ *   flags     Receive flags
+ *   timeout   Optional limit on the time spent receiving
+ *
+ * Returned Value:
+ *   The number of messages received, or a negated errno value if not even
+ *   the first one could be received.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout);
+
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends a vector of messages to a socket.  This is an
+ *   internal OS interface, functionally equivalent to sendmmsg() except
+ *   that it is not a cancellation point, does not modify errno and accepts
+ *   the internal socket structure.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send
+ *   vlen      The number of messages in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent, or a negated errno value if not even the
+ *   first one could be sent.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -209,6 +209,43 @@
 #define IPv4BUF ((FAR struct ipv4_hdr_s *)IPBUF(0))
 #define IPv6BUF ((FAR struct ipv6_hdr_s *)IPBUF(0))
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+/* Offloads that a driver implements, see d_features */
+
+#  define NETDEV_FEATURE_TXCSUM  (1 << 0) /* Completes TCP checksums */
+#  define NETDEV_FEATURE_RXCSUM  (1 << 1) /* Verifies TCP/UDP checksums */
+#  define NETDEV_FEATURE_TSO4    (1 << 2) /* Segments TCP over IPv4 */
+#  define NETDEV_FEATURE_TSO6    (1 << 3) /* Segments TCP over IPv6 */
+
+/* Offload state of the packet in d_buf, see d_offload */
+
+#  define NETDEV_OFFLOAD_TXCSUM  (1 << 0) /* Checksum left to the driver */
+#  define NETDEV_OFFLOAD_RXCSUM  (1 << 1) /* Checksum verified by driver */
+
+/* Check whether d_buf holds a TCP super-segment, and whether the driver
+ * segments it.
+ */
+
+#  define NETDEV_IS_GSO(dev) ((dev)->d_gso_size > 0)
+
+#  define NETDEV_TSO(dev) \
+     (((dev)->d_features & (IFF_IS_IPv6((dev)->d_flags) ? \
+                            NETDEV_FEATURE_TSO6 : NETDEV_FEATURE_TSO4)) != 0)
+
+/* Forget the transmit offload state when d_buf gets a new packet */
+
+#  define netdev_offload_reset(dev) \
+     do \
+       { \
+         (dev)->d_offload &= ~NETDEV_OFFLOAD_TXCSUM; \
+         (dev)->d_gso_size = 0; \
+       } \
+     while (0)
+#else
+#  define NETDEV_IS_GSO(dev) false
+#  define netdev_offload_reset(dev)
+#endif
+
 #ifdef CONFIG_NET_IPv6
 #  ifndef CONFIG_NETDEV_MAX_IPv6_ADDR
 #    define CONFIG_NETDEV_MAX_IPv6_ADDR 1
@@ -345,6 +382,30 @@ struct net_driver_s
 
   uint16_t d_pktsize;           /* Maximum packet size */
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Checksum and segmentation offload.  d_features is set by the driver
+   * before it registers.  The other fields describe the packet in d_buf:
+   *
+   * - With NETDEV_OFFLOAD_TXCSUM, the checksum field of an outgoing packet
+   *   only holds the sum of the pseudo-header.  The driver sums the data
+   *   from d_csum_start (an offset from the IP header) to the end and
+   *   stores the result d_csum_offset bytes after d_csum_start.
+   * - A d_gso_size other than zero marks an outgoing TCP super-segment,
+   *   that the driver cuts into segments of d_gso_size payload bytes.  It
+   *   is no longer than d_gso_maxsize, if the driver set it, measured from
+   *   the IP header.
+   * - The driver sets NETDEV_OFFLOAD_RXCSUM on a received packet whose
+   *   TCP/UDP checksum it has verified.
+   */
+
+  uint32_t d_features;          /* See NETDEV_FEATURE_* definitions */
+  uint8_t  d_offload;           /* See NETDEV_OFFLOAD_* definitions */
+  uint8_t  d_csum_offset;       /* Checksum offset in the L4 header */
+  uint16_t d_csum_start;        /* L4 header offset from the IP header */
+  uint16_t d_gso_size;          /* Payload per segment, 0 if none */
+  uint16_t d_gso_maxsize;       /* Largest super-segment, 0 if no limit */
+#endif
+
   /* Link layer address */
 
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_NET_6LOWPAN) || \
@@ -510,6 +571,20 @@ struct net_driver_s
   struct timespec d_rxtime;
 #endif
 
+#ifdef CONFIG_NET_LATENCY
+  /* perf_gettime() when the packet being processed was received.  A driver
+   * may set it as soon as it sees the packet, so the time spent in its
+   * queue and waiting for the network lock is accounted too.  Otherwise
+   * it is set when the packet enters ipv4_input or ipv6_input.
+   */
+
+  clock_t d_rxstamp;
+
+  /* The time from reception until a socket got the packet */
+
+  struct net_latency_s d_rxlatency;
+#endif
+
   /* Application callbacks:
    *
    * Network device event handlers are retained in a 'list' and are called
@@ -548,6 +623,12 @@ struct net_driver_s
                       unsigned long arg);
 #endif
 
+#ifdef CONFIG_NET_LOCK_SPLIT
+  /* Serializes the access to the driver, see netdev_lock() */
+
+  rmutex_t d_lock;
+#endif
+
   /* Drivers may attached device-specific, private information */
 
   FAR void *d_private;
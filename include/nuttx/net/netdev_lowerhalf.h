@@ -119,6 +119,15 @@ struct netdev_lowerhalf_s
 
   atomic_int quota[NETPKT_TYPENUM];
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Number of hardware RX and TX queues, set before registering.  Zero is
+   * taken as one queue, the queue operations are used with more than one.
+   */
+
+  uint8_t rxqueues;
+  uint8_t txqueues;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -172,6 +181,45 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+#ifdef CONFIG_NETDEV_BATCH
+  /* receive_batch - Try to receive up to 'n' packets, non-blocking.
+   *   Returned Value:
+   *     The number of packets stored in 'pkts', 0 if no more packets.
+   *
+   * transmit_batch - Try to send the 'n' packets in 'pkts', non-blocking,
+   *                  own the accepted netpkts like transmit.
+   *   Returned Value:
+   *     The number of leading packets accepted, the other ones will be
+   *       recycled by upper half and the current sending is stopped.
+   *     Negated errno value if no packet could be sent.
+   *
+   * Both are optional, receive and transmit are used if not provided.
+   */
+
+  CODE int (*receive_batch)(FAR struct netdev_lowerhalf_s *dev,
+                            FAR netpkt_t **pkts, int n);
+  CODE int (*transmit_batch)(FAR struct netdev_lowerhalf_s *dev,
+                             FAR netpkt_t **pkts, int n);
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* transmit_queue/receive_queue/reclaim_queue - Same as transmit, receive
+   *   and reclaim, on the hardware queue 'qid'.  Required when the lower
+   *   half has more than one TX (respectively RX) queue.  Each queue is
+   *   served by its own thread, so different queues may be called at the
+   *   same time from different CPUs, but one queue is never called from
+   *   two threads at the same time.  As the queues run concurrently,
+   *   receive_queue reports the RX offload flags of the packet through
+   *   'offload' instead of d_offload.
+   */
+
+  CODE int (*transmit_queue)(FAR struct netdev_lowerhalf_s *dev, int qid,
+                             FAR netpkt_t *pkt);
+  CODE FAR netpkt_t *(*receive_queue)(FAR struct netdev_lowerhalf_s *dev,
+                                      int qid, FAR uint8_t *offload);
+  CODE void (*reclaim_queue)(FAR struct netdev_lowerhalf_s *dev, int qid);
+#endif
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -308,6 +356,26 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue/txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer that an RX packet is ready to read, or
+ *   that a TX packet is sent, on the hardware queue 'qid'.  Only the thread
+ *   serving that queue is woken up.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   qid - The queue index
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int qid);
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev, int qid);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -387,6 +387,10 @@ struct sixlowpan_reassbuf_s
 
   FAR struct sixlowpan_reassbuf_s *rb_flink;
 
+  /* Supports the hash chain of active reassembly buffers */
+
+  FAR struct sixlowpan_reassbuf_s *rb_hlink;
+
   /* Fragmentation is handled frame by frame and requires that certain
    * state information be retained from frame to frame.  That additional
    * information follows the externally visible packet buffer.
@@ -44,6 +44,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+
 #include <nuttx/net/ioctl.h>
 
 /****************************************************************************
@@ -56,13 +59,67 @@
 #define IFF_TAP          0x02
 #define IFF_MASK         0x7f
 #define IFF_NO_PI        0x80
+#define IFF_MULTI_QUEUE  0x0100  /* Attach another queue to the interface */
+#define IFF_VNET_HDR     0x0200  /* Packets start with a tun_vnet_hdr_s */
+#define IFF_BATCH        0x0400  /* Several packets per read() or write() */
 
-#ifdef CONFIG_NET_TUN
+/* struct tun_vnet_hdr_s flags */
+
+#define TUN_VNET_HDR_F_NEEDS_CSUM  1  /* Checksum is to be completed */
+#define TUN_VNET_HDR_F_DATA_VALID  2  /* Checksum was already verified */
+
+/* struct tun_vnet_hdr_s GSO types */
+
+#define TUN_VNET_HDR_GSO_NONE      0
+#define TUN_VNET_HDR_GSO_TCPV4     1
+#define TUN_VNET_HDR_GSO_TCPV6     4
+
+/* With IFF_BATCH, each packet starts at a 4-byte boundary of the buffer */
+
+#define TUN_BATCH_ALIGN(n) (((n) + 3) & ~3)
 
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
+/* With IFF_VNET_HDR, this header comes right before each packet read or
+ * written.  It has the layout of the virtio net header and its offsets
+ * are measured from the start of the packet.
+ *
+ * On read, NEEDS_CSUM means that the checksum field only holds the sum of
+ * the pseudo-header: the reader sums the packet from csum_start to the end
+ * and stores the result csum_offset bytes after csum_start.  A gso_type
+ * other than NONE marks a TCP super-segment, to be cut into segments of
+ * gso_size payload bytes after hdr_len bytes of headers.
+ *
+ * On write, NEEDS_CSUM asks the driver to complete the checksum in the
+ * same way and DATA_VALID tells that the checksum was verified.  Only
+ * GSO_NONE is accepted.
+ */
+
+struct tun_vnet_hdr_s
+{
+  uint8_t  flags;        /* See TUN_VNET_HDR_F_* definitions */
+  uint8_t  gso_type;     /* See TUN_VNET_HDR_GSO_* definitions */
+  uint16_t hdr_len;      /* Size of the headers of a super-segment */
+  uint16_t gso_size;     /* Payload per segment of a super-segment */
+  uint16_t csum_start;   /* Start of the checksummed data */
+  uint16_t csum_offset;  /* Checksum field offset from csum_start */
+};
+
+/* With IFF_BATCH, this header comes before each packet, and before its
+ * tun_vnet_hdr_s.  read() returns as many queued packets as fit in the
+ * buffer and write() takes all the packets in the buffer.
+ */
+
+struct tun_batch_hdr_s
+{
+  uint16_t len;          /* Length of the packet, without the headers */
+  uint16_t reserved;
+};
+
+#ifdef CONFIG_NET_TUN
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
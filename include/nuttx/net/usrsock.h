@@ -34,6 +34,7 @@
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/compiler.h>
+#include <nuttx/fs/ioctl.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -61,6 +62,17 @@
 #define USRSOCK_MESSAGE_REQ_COMPLETED(flags) \
                           (!USRSOCK_MESSAGE_REQ_IN_PROGRESS(flags))
 
+/* /dev/usrsock ioctl commands */
+
+#define USRSOCKIOC_DOORBELL _USRSOCKIOC(0x0001) /* Handle the messages in
+                                                 * the response area of the
+                                                 * shared ring.  Returns the
+                                                 * number of messages */
+
+/* Messages in the shared ring start at multiples of this alignment */
+
+#define USRSOCK_RING_ALIGN  4
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -265,6 +277,37 @@ begin_packed_struct struct usrsock_message_socket_event_s
   int16_t usockid;
 } end_packed_struct;
 
+/* The shared ring of /dev/usrsock.  mmap() of the device returns this
+ * header, followed by the request area (kernel => daemon) and then the
+ * response area (daemon => kernel) of 'size' bytes each.  'head' and 'tail'
+ * are free-running byte counts:  The writer of an area advances 'head'
+ * after writing a message, the reader advances 'tail' once it is done with
+ * one.  A message is stored as a uint32_t length followed by the message
+ * itself, padded to USRSOCK_RING_ALIGN.  A message never wraps; if it does
+ * not fit before the end of the area, a zero length is stored and the
+ * message starts at the beginning of the area.
+ *
+ * Once the device is mapped, the requests are put in the request area and
+ * POLLIN is raised as before; a request that does not fit is still read()
+ * from the device.  The daemon may put any number of responses and events
+ * in the response area and then handle all of them with one
+ * USRSOCKIOC_DOORBELL ioctl, instead of one write() each.
+ */
+
+struct usrsock_ring_area_s
+{
+  volatile uint32_t head;
+  volatile uint32_t tail;
+};
+
+struct usrsock_ring_s
+{
+  struct usrsock_ring_area_s req;   /* Requests, kernel => daemon */
+  struct usrsock_ring_area_s resp;  /* Responses and events, daemon => kernel */
+  uint32_t size;                    /* The size of each area */
+  uint32_t reserved;                /* Keeps the areas 64-bit aligned */
+};
+
 /****************************************************************************
  * Name: usrsock_iovec_get() - copy from iovec to buffer.
  ****************************************************************************/
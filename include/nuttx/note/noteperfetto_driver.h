@@ -0,0 +1,51 @@
+/****************************************************************************
+ * include/nuttx/note/noteperfetto_driver.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NOTE_NOTEPERFETTO_DRIVER_H
+#define __INCLUDE_NUTTX_NOTE_NOTEPERFETTO_DRIVER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVERS_NOTEPERFETTO
+
+/****************************************************************************
+ * Name: noteperfetto_register
+ *
+ * Description:
+ *   Register the /dev/note/perfetto character device which streams the
+ *   notes as a Perfetto protobuf trace.
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int noteperfetto_register(void);
+
+#endif
+#endif /* __INCLUDE_NUTTX_NOTE_NOTEPERFETTO_DRIVER_H */
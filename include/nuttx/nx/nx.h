@@ -549,6 +549,25 @@ int nx_block(NXWINDOW hwnd, FAR void *arg);
 
 int nx_synch(NXWINDOW hwnd, FAR void *arg);
 
+/****************************************************************************
+ * Name: nx_flush
+ *
+ * Description:
+ *   Wait until the server has executed all drawing commands sent on this
+ *   connection.  Drawing commands are batched in a command ring shared
+ *   with the server (CONFIG_NX_CMDRING_SIZE) and executed asynchronously;
+ *   after nx_flush() returns, their results are in the framebuffer.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect()
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_flush(NXHANDLE handle);
+
 /****************************************************************************
  * Name: nx_requestbkgd
  *
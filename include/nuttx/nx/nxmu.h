@@ -31,6 +31,8 @@
 #include <stdbool.h>
 #include <mqueue.h>
 
+#include <nuttx/atomic.h>
+#include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/nx/nx.h>
 #include <nuttx/nx/nxcursor.h>
@@ -56,6 +58,25 @@
 
 #define NX_MXSVRMSGLEN       (64) /* Maximum size of a client->server command */
 #define NX_MXEVENTLEN        (64) /* Maximum size of an event */
+
+/* Command ring.  Each command is preceded by its length and padded to
+ * NX_CMDRING_ALIGN bytes.  A zero length marks the unused end of the ring:
+ * the next command is at the start.
+ */
+
+#if defined(CONFIG_NX_CMDRING_SIZE) && CONFIG_NX_CMDRING_SIZE > 0
+#  define NX_CMDRING 1
+#  define NX_CMDRING_ALIGN  8
+#  define NX_CMDRING_MASK   (CONFIG_NX_CMDRING_SIZE - 1)
+#  define NX_CMDRING_RECLEN(n) \
+     (((n) + sizeof(uint32_t) + NX_CMDRING_ALIGN - 1) & \
+      ~(NX_CMDRING_ALIGN - 1))
+
+#  if (CONFIG_NX_CMDRING_SIZE & NX_CMDRING_MASK) != 0 || \
+      CONFIG_NX_CMDRING_SIZE < 4 * NX_MXSVRMSGLEN
+#    error CONFIG_NX_CMDRING_SIZE must be a power of two >= 256
+#  endif
+#endif
 #define NX_MXCLIMSGLEN       (64) /* Maximum size of a server->client message */
 
 /* Message priorities -- they must all be at the same priority to assure
@@ -80,6 +101,27 @@ enum nx_clistate_e
   NX_CLISTATE_DISCONNECT_PENDING, /* Waiting for server to acknowledge disconnect */
 };
 
+/* Drawing commands of one client, written by the client and executed by
+ * the server.  'head' and 'tail' are free running byte counts.  The client
+ * sends one NX_SVRMSG_CMDRING message when it finds 'pending' clear; the
+ * server clears it before it empties the ring.  So the commands are
+ * batched while the server is busy, and they are always executed before
+ * any message the client sends later through the message queue.
+ */
+
+#ifdef NX_CMDRING
+struct nxmu_cmdring_s
+{
+  atomic_uint head;       /* End of the written commands (client) */
+  atomic_uint tail;       /* End of the executed commands (server) */
+  atomic_uint pending;    /* An NX_SVRMSG_CMDRING message is queued */
+  atomic_uint waiting;    /* The client waits for space */
+  mutex_t lock;           /* Serializes the writers (client) */
+  sem_t space;            /* Posted when space is freed (server) */
+  uint64_t buffer[CONFIG_NX_CMDRING_SIZE / sizeof(uint64_t)];
+};
+#endif
+
 /* This structure represents a connection between the client and the server */
 
 struct nxmu_conn_s
@@ -93,6 +135,9 @@ struct nxmu_conn_s
 
   mqd_t crdmq;            /* MQ to read from the server (may be non-blocking) */
   mqd_t cwrmq;            /* MQ to write to the server (blocking) */
+#ifdef NX_CMDRING
+  FAR struct nxmu_cmdring_s *ring; /* Drawing commands to the server */
+#endif
 
   /* These are only usable on the server side of the connection */
 
@@ -142,7 +187,9 @@ enum nxmsg_e
   NX_SVRMSG_SETBGCOLOR,       /* Set the color of the background */
   NX_SVRMSG_MOUSEIN,          /* New mouse report from mouse client */
   NX_SVRMSG_KBDIN,            /* New keyboard report from keyboard client */
-  NX_SVRMSG_REDRAWREQ         /* Request re-drawing of rectangular region */
+  NX_SVRMSG_REDRAWREQ,        /* Request re-drawing of rectangular region */
+  NX_SVRMSG_CMDRING,          /* Execute the commands in the client ring */
+  NX_SVRMSG_FENCE             /* Report that all previous commands are done */
 };
 
 /* Server-to-Client Message Structures **************************************/
@@ -520,6 +567,14 @@ struct nxsvrmsg_redrawreq_s
   struct nxgl_rect_s rect;         /* Describes the rectangular region to be redrawn */
 };
 
+/* Report when all previous commands of the client have been executed */
+
+struct nxsvrmsg_fence_s
+{
+  uint32_t msgid;                  /* NX_SVRMSG_FENCE */
+  FAR sem_t *sem_done;             /* Semaphore to report when done */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -602,6 +657,31 @@ int nxmu_sendserver(FAR struct nxmu_conn_s *conn,
 int nxmu_sendwindow(FAR struct nxbe_window_s *wnd, FAR const void *msg,
                     size_t msglen);
 
+/****************************************************************************
+ * Name: nxmu_sendring / nxmu_ringwindow
+ *
+ * Description:
+ *  Queue a drawing command in the command ring of the connection, or
+ *  destined for a specific window.  The server is notified only if it is
+ *  not already going to empty the ring.  Without a command ring, the
+ *  command is sent through the message queue.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *   wnd    - A pointer to the back-end window structure
+ *   msg    - A pointer to the message to send
+ *   msglen - The length of the message in bytes.
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nxmu_sendring(FAR struct nxmu_conn_s *conn, FAR const void *msg,
+                  size_t msglen);
+int nxmu_ringwindow(FAR struct nxbe_window_s *wnd, FAR const void *msg,
+                    size_t msglen);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,115 @@
+/****************************************************************************
+ * include/nuttx/perf_sample.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_PERF_SAMPLE_H
+#define __INCLUDE_NUTTX_PERF_SAMPLE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_PERF_SAMPLE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_PERF_SAMPLE_CALLCHAIN
+#  define CONFIG_PERF_SAMPLE_CALLCHAIN 0
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The records read from /dev/perf.  Only the first ps_nip entries of
+ * ps_ip are transferred: ps_ip[0] is the sampled program counter, followed
+ * by the return addresses of the callchain.  ps_size is the length of the
+ * whole record in bytes, so a host tool can walk the stream without
+ * knowing the configuration of the target.
+ */
+
+struct perf_sample_s
+{
+  uint16_t  ps_size;                  /* Size of this record in bytes */
+  uint8_t   ps_cpu;                   /* CPU that took the sample */
+  uint8_t   ps_nip;                   /* Number of entries in ps_ip */
+  pid_t     ps_pid;                   /* Thread that was interrupted */
+  uint64_t  ps_time;                  /* perf_gettime() of the sample */
+  uintptr_t ps_ip[1 + CONFIG_PERF_SAMPLE_CALLCHAIN];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: perf_sample
+ *
+ * Description:
+ *   Record a sample of the thread interrupted on this CPU.  Called from
+ *   the performance counter overflow interrupt or, without one, from the
+ *   system timer interrupt.  Nothing is done unless /dev/perf is open.
+ *
+ * Input Parameters:
+ *   regs - The register context of the interrupted thread.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void perf_sample(FAR void *regs);
+
+/****************************************************************************
+ * Name: perf_sample_register
+ *
+ * Description:
+ *   Register the /dev/perf sample stream.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int perf_sample_register(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_PERF_SAMPLE */
+#endif /* __INCLUDE_NUTTX_PERF_SAMPLE_H */
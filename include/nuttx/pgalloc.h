@@ -78,6 +78,13 @@
 #define MM_NPAGES(s)      (((uintptr_t)(s) + MM_PGMASK) >> MM_PGSHIFT)
 #define MM_ISALIGNED(a)   (((uintptr_t)(a) & MM_PGMASK) == 0)
 
+/* A large page is the memory mapped by one last level page table */
+
+#define MM_LARGE_NPAGES   (MM_PGSIZE / sizeof(uintptr_t))
+#define MM_LARGE_PGSIZE   ((uintptr_t)MM_LARGE_NPAGES << MM_PGSHIFT)
+#define MM_LARGE_PGMASK   (MM_LARGE_PGSIZE - 1)
+#define MM_LARGE_ISALIGNED(a) (((uintptr_t)(a) & MM_LARGE_PGMASK) == 0)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -165,6 +172,25 @@ void mm_pgreserve(uintptr_t start, size_t size);
 
 uintptr_t mm_pgalloc(unsigned int npages);
 
+/****************************************************************************
+ * Name: mm_pgalloc_aligned
+ *
+ * Description:
+ *   Allocate physically contiguous page memory from the page memory pool,
+ *   aligned to a multiple of pages.
+ *
+ * Input Parameters:
+ *   npages - The number of pages to allocate, each of size CONFIG_MM_PGSIZE.
+ *   align  - The alignment in pages.  Must be a power of two.
+ *
+ * Returned Value:
+ *   On success, a non-zero, physical address of the allocated page memory
+ *   is returned.  Zero is returned on failure.
+ *
+ ****************************************************************************/
+
+uintptr_t mm_pgalloc_aligned(unsigned int npages, unsigned int align);
+
 /****************************************************************************
  * Name: mm_pgfree
  *
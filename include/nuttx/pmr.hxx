@@ -0,0 +1,293 @@
+//***************************************************************************
+// include/nuttx/pmr.hxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+#ifndef __INCLUDE_NUTTX_PMR_HXX
+#define __INCLUDE_NUTTX_PMR_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <memory_resource>
+
+#include <nuttx/arena.h>
+#include <nuttx/mm/mempool.h>
+#ifdef CONFIG_GRAN
+#  include <nuttx/mm/gran.h>
+#endif
+
+#ifdef CONFIG_LIBXX_PMR
+
+//***************************************************************************
+// Public Types
+//***************************************************************************
+
+// std::pmr::memory_resource implementations over the NuttX allocators, so
+// that the containers of std::pmr take their memory from bounded pools
+// instead of the heap:
+//
+//   nuttx::pmr::mempool_resource res("rx", sizeof(node), 4096, 0,
+//                                    std::pmr::null_memory_resource());
+//   std::pmr::list<frame> queue(&res);
+//
+// The resources that can run out pass such requests to an upstream
+// resource.  Pass std::pmr::null_memory_resource() to make running out an
+// error instead of a heap allocation.  None of the resources is tied to a
+// thread; those that do not lock are noted below.
+
+namespace nuttx::pmr
+{
+//***************************************************************************
+// Name: throw_bad_alloc
+//
+// Description:
+//   Report a request that cannot be served: throw std::bad_alloc if C++
+//   exceptions are enabled, else abort like the C++ library does.
+//
+//***************************************************************************
+
+[[noreturn]] void throw_bad_alloc();
+
+//***************************************************************************
+// Class: mempool_resource
+//
+// Description:
+//   Fixed size blocks from a struct mempool_s owned by the resource, e.g.
+//   for the nodes of a std::pmr::list or std::pmr::map.  Requests that do
+//   not fit a block go to the upstream resource.  If the pool is empty, it
+//   grows by expandsize, waits for a free block if wait is set, or else
+//   fails.
+//
+//***************************************************************************
+
+class mempool_resource : public std::pmr::memory_resource
+{
+public:
+  mempool_resource(FAR const char *name, std::size_t blocksize,
+                   std::size_t initialsize, std::size_t expandsize,
+                   FAR std::pmr::memory_resource *upstream =
+                   std::pmr::get_default_resource(), bool wait = false);
+  ~mempool_resource() override;
+
+  mempool_resource(const mempool_resource &) = delete;
+  mempool_resource &operator=(const mempool_resource &) = delete;
+
+  FAR std::pmr::memory_resource *upstream_resource() const noexcept
+  {
+    return m_upstream;
+  }
+
+protected:
+  FAR void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(FAR void *p, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other)
+    const noexcept override
+  {
+    return this == &other;
+  }
+
+private:
+  struct mempool_s m_pool;                        // The blocks
+  FAR std::pmr::memory_resource *m_upstream;      // Requests not fitting
+  std::size_t m_alignment;                        // Alignment of a block
+  bool m_ready;                                   // m_pool is initialized
+};
+
+//***************************************************************************
+// Class: mempool_multiple_resource
+//
+// Description:
+//   Blocks of several size classes from a struct mempool_multiple_s owned
+//   by the resource, e.g. for std::pmr::vector or std::pmr::string whose
+//   sizes vary.  poolsize lists the size classes in increasing order.
+//   Requests larger than the last class, and those that come when the
+//   pools can no longer grow, go to the upstream resource.
+//
+//***************************************************************************
+
+class mempool_multiple_resource : public std::pmr::memory_resource
+{
+public:
+  mempool_multiple_resource(FAR const char *name,
+                            FAR const std::size_t *poolsize,
+                            std::size_t npools, std::size_t expandsize,
+                            FAR std::pmr::memory_resource *upstream =
+                            std::pmr::get_default_resource());
+  ~mempool_multiple_resource() override;
+
+  mempool_multiple_resource(const mempool_multiple_resource &) = delete;
+  mempool_multiple_resource &
+  operator=(const mempool_multiple_resource &) = delete;
+
+  FAR std::pmr::memory_resource *upstream_resource() const noexcept
+  {
+    return m_upstream;
+  }
+
+protected:
+  FAR void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(FAR void *p, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other)
+    const noexcept override
+  {
+    return this == &other;
+  }
+
+private:
+  FAR struct mempool_multiple_s *m_mpool;         // The pools, may be NULL
+  FAR std::pmr::memory_resource *m_upstream;      // Requests not fitting
+};
+
+//***************************************************************************
+// Class: gran_resource
+//
+// Description:
+//   Granules of a region of memory given to the resource, e.g. a DMA
+//   capable or tightly coupled RAM.  Allocations are aligned to
+//   1 << log2align; requests with a larger alignment, and those that come
+//   when the region is full, go to the upstream resource.
+//
+//***************************************************************************
+
+#ifdef CONFIG_GRAN
+class gran_resource : public std::pmr::memory_resource
+{
+public:
+  gran_resource(FAR void *heapstart, std::size_t heapsize,
+                unsigned int log2gran, unsigned int log2align,
+                FAR std::pmr::memory_resource *upstream =
+                std::pmr::get_default_resource());
+  ~gran_resource() override;
+
+  gran_resource(const gran_resource &) = delete;
+  gran_resource &operator=(const gran_resource &) = delete;
+
+  FAR std::pmr::memory_resource *upstream_resource() const noexcept
+  {
+    return m_upstream;
+  }
+
+protected:
+  FAR void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(FAR void *p, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other)
+    const noexcept override
+  {
+    return this == &other;
+  }
+
+private:
+  GRAN_HANDLE m_handle;                           // The granule allocator
+  FAR char *m_start;                              // The region
+  FAR char *m_end;
+  std::size_t m_alignment;                        // 1 << log2align
+  FAR std::pmr::memory_resource *m_upstream;      // Requests not fitting
+};
+#endif
+
+//***************************************************************************
+// Class: arena_resource
+//
+// Description:
+//   Memory from a struct arena_s owned by the resource.  Deallocation does
+//   nothing; release() makes all memory available again but keeps the
+//   first block of the arena, so that a resource reused for each request
+//   of a server stops touching the heap.  The arena is not locked, so the
+//   resource must be used by one thread at a time.
+//
+//***************************************************************************
+
+class arena_resource : public std::pmr::memory_resource
+{
+public:
+  explicit arena_resource(std::size_t blocksize = 0);
+  ~arena_resource() override;
+
+  arena_resource(const arena_resource &) = delete;
+  arena_resource &operator=(const arena_resource &) = delete;
+
+  void release() noexcept;
+
+protected:
+  FAR void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(FAR void *p, std::size_t bytes,
+                     std::size_t alignment) override
+  {
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other)
+    const noexcept override
+  {
+    return this == &other;
+  }
+
+private:
+  FAR struct arena_s *m_arena;                    // May be NULL
+};
+
+//***************************************************************************
+// Class: stack_buffer_resource
+//
+// Description:
+//   A std::pmr::monotonic_buffer_resource with its buffer inside, meant to
+//   be declared as a local variable so that the containers of a function
+//   live on its stack:
+//
+//     nuttx::pmr::stack_buffer_resource<> res;
+//     std::pmr::vector<int> v(&res);
+//
+//   Unlike the standard resource, the upstream is the null resource by
+//   default, so that a container that outgrows the buffer fails instead
+//   of taking the heap lock on a time critical path.  The default size is
+//   CONFIG_LIBXX_PMR_STACK_BUFFER_SIZE, kept small for the stacks of
+//   NuttX tasks.  Not locked, like the standard resource.
+//
+//***************************************************************************
+
+template <std::size_t Size>
+struct stack_buffer
+{
+  alignas(std::max_align_t) std::byte m_buffer[Size];
+};
+
+template <std::size_t Size = CONFIG_LIBXX_PMR_STACK_BUFFER_SIZE>
+class stack_buffer_resource : private stack_buffer<Size>,
+                              public std::pmr::monotonic_buffer_resource
+{
+public:
+  explicit stack_buffer_resource(FAR std::pmr::memory_resource *upstream =
+                                 std::pmr::null_memory_resource())
+    : std::pmr::monotonic_buffer_resource(this->m_buffer, Size, upstream)
+  {
+  }
+
+  stack_buffer_resource(const stack_buffer_resource &) = delete;
+  stack_buffer_resource &operator=(const stack_buffer_resource &) = delete;
+};
+} // namespace nuttx::pmr
+
+#endif // CONFIG_LIBXX_PMR
+#endif // __INCLUDE_NUTTX_PMR_HXX
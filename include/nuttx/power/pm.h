@@ -835,6 +835,51 @@ void pm_auto_updatestate(int domain);
 
 void pm_idle(pm_idle_handler_t handler);
 
+#ifdef CONFIG_PM_HIBERNATE
+struct memory_region_s;
+
+/****************************************************************************
+ * Name: pm_hibernate
+ *
+ * Description:
+ *   Save the RAM regions, compressed, to the CONFIG_PM_HIBERNATE_MTD
+ *   partition with the drivers in PM_SLEEP.  The board may then cut the
+ *   power.  After pm_hibernate_resume() restored the image, this returns
+ *   a second time, with the drivers back in PM_NORMAL.
+ *
+ * Input Parameters:
+ *   regions - The RAM to save, ending with an entry whose start is not
+ *             below its end.  It must hold the data and the stacks, this
+ *             function's own state included.
+ *
+ * Returned Value:
+ *   Zero when the image was saved, one when it was resumed, or a negated
+ *   errno value on failure.
+ *
+ ****************************************************************************/
+
+int pm_hibernate(FAR const struct memory_region_s *regions);
+
+/****************************************************************************
+ * Name: pm_hibernate_resume
+ *
+ * Description:
+ *   Restore an image saved by pm_hibernate(), normally called from
+ *   board_late_initialize().  This does not return on success.
+ *
+ * Input Parameters:
+ *   scratch - Stack of the restore thread, outside of the saved regions.
+ *   size    - The size of the stack.
+ *
+ * Returned Value:
+ *   A negated errno value if there is no valid image: -ENOENT without
+ *   one, -ENOTSUP if the partition is not memory mapped.
+ *
+ ****************************************************************************/
+
+int pm_hibernate_resume(FAR void *scratch, size_t size);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
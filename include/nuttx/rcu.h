@@ -0,0 +1,141 @@
+/****************************************************************************
+ * include/nuttx/rcu.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RCU_H
+#define __INCLUDE_NUTTX_RCU_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/atomic.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Read a pointer published with rcu_assign_pointer() inside a read-side
+ * critical section.
+ */
+
+#define rcu_dereference(p) (*(FAR volatile typeof(p) *)&(p))
+
+/* Publish a pointer to an object after the object has been initialized */
+
+#define rcu_assign_pointer(p, v) \
+  do \
+    { \
+      atomic_thread_fence(memory_order_release); \
+      *(FAR volatile typeof(p) *)&(p) = (v); \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Embedded in an object whose release is deferred with call_rcu() */
+
+struct rcu_head
+{
+  FAR struct rcu_head *next;
+  CODE void (*func)(FAR struct rcu_head *head);
+};
+
+typedef CODE void (*rcu_callback_t)(FAR struct rcu_head *head);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: rcu_read_lock
+ *
+ * Description:
+ *   Enter a read-side critical section.  Objects reached through
+ *   rcu_dereference() stay valid until the matching rcu_read_unlock().
+ *   The sections nest, may be entered from interrupt handlers, and, unlike
+ *   Linux, may block: the grace period simply lasts longer.
+ *
+ ****************************************************************************/
+
+void rcu_read_lock(void);
+
+/****************************************************************************
+ * Name: rcu_read_unlock
+ *
+ * Description:
+ *   Leave a read-side critical section.
+ *
+ ****************************************************************************/
+
+void rcu_read_unlock(void);
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait until every read-side critical section that was in progress when
+ *   this was called has ended.  Objects unlinked before the call may then
+ *   be freed.  This sleeps, so it must not be called from an interrupt
+ *   handler or inside a read-side critical section.
+ *
+ ****************************************************************************/
+
+void synchronize_rcu(void);
+
+/****************************************************************************
+ * Name: call_rcu
+ *
+ * Description:
+ *   Call func from a work queue once the read-side critical sections in
+ *   progress have ended.  The callbacks queued on a CPU are batched behind
+ *   a single grace period.  This never blocks.
+ *
+ * Input Parameters:
+ *   head - Embedded in the object to release
+ *   func - Called with head after the grace period
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+void call_rcu(FAR struct rcu_head *head, rcu_callback_t func);
+#endif
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_RCU_H */
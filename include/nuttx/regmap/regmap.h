@@ -39,6 +39,23 @@
 
 struct regmap_bus_s;
 
+/* Register cache types */
+
+enum regcache_type_e
+{
+  REGCACHE_NONE = 0,  /* No register cache */
+  REGCACHE_FLAT,      /* Array of all registers up to max_register */
+  REGCACHE_RBTREE     /* Red-black tree of the registers accessed */
+};
+
+/* Power-on value of a register */
+
+struct reg_default_s
+{
+  unsigned int reg;
+  unsigned int def;
+};
+
 /* Single byte register read/write. */
 
 typedef CODE int (*reg_read_t)(FAR struct regmap_bus_s *bus,
@@ -98,6 +115,42 @@ struct regmap_config_s
    */
 
   bool disable_locking;
+
+  /* The register cache, REGCACHE_NONE if registers are not cached.
+   * Ignored unless CONFIG_REGMAP_CACHE is enabled.
+   */
+
+  enum regcache_type_e cache_type;
+
+  /* The highest valid register address, mandatory for REGCACHE_FLAT. */
+
+  unsigned int max_register;
+
+  /* Power-on values of registers, used to fill the cache. */
+
+  FAR const struct reg_default_s *reg_defaults;
+  unsigned int num_reg_defaults;
+
+  /* Optional.  Return true for registers whose value is changed by the
+   * device, they are never cached.
+   */
+
+  CODE bool (*volatile_reg)(unsigned int reg);
+
+  /* Optional.  Return true for registers that must only be read when
+   * asked for, like clear-on-read status registers.  They are never
+   * cached and regmap_update_bits() refuses them.
+   */
+
+  CODE bool (*precious_reg)(unsigned int reg);
+
+  /* The device does not auto-increment the register address, so
+   * regmap_sync() writes the registers one by one.  Otherwise adjacent
+   * registers are written in a single bus write of the address followed
+   * by the values, all most significant byte first.
+   */
+
+  bool use_single_write;
 };
 
 struct regmap_s;
@@ -310,6 +363,79 @@ int regmap_read(FAR struct regmap_s *map, unsigned int reg,
 int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
                      FAR void *val, unsigned int val_count);
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write of a register.  Only the bits set in mask are
+ *   changed, and the register is not written if they already have the
+ *   requested value.  A cached register is not read from the device.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - the bits to change.
+ *   val  - the new value of these bits.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val);
+
+#ifdef CONFIG_REGMAP_CACHE
+/****************************************************************************
+ * Name: regmap_cache_only
+ *
+ * Description:
+ *   Enable or disable the cache-only mode, for instance while the device
+ *   is suspended.  In this mode writes of cached registers only update
+ *   the cache and mark them dirty, and accesses to the other registers
+ *   fail with -EBUSY.
+ *
+ * Input Parameters:
+ *   map    - regmap handler, from regmap bus init function return.
+ *   enable - true to enter the cache-only mode.
+ *
+ ****************************************************************************/
+
+void regmap_cache_only(FAR struct regmap_s *map, bool enable);
+
+/****************************************************************************
+ * Name: regmap_mark_dirty
+ *
+ * Description:
+ *   Mark all cached registers dirty, so the next regmap_sync() writes them
+ *   all, for instance after the device lost its state.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ ****************************************************************************/
+
+void regmap_mark_dirty(FAR struct regmap_s *map);
+
+/****************************************************************************
+ * Name: regmap_sync
+ *
+ * Description:
+ *   Write the dirty registers of the cache to the device.  Runs of
+ *   adjacent registers are written in a single bulk transfer.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -EBUSY if the
+ *   map is in cache-only mode.
+ *
+ ****************************************************************************/
+
+int regmap_sync(FAR struct regmap_s *map);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -25,9 +25,20 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/atomic.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The reader counts of the CPUs are kept in different cache lines */
+
+#ifndef PERCPU_RWSEM_ALIGN
+#  define PERCPU_RWSEM_ALIGN 64
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -41,6 +52,25 @@ typedef struct
   int     reader;
 } rw_semaphore_t;
 
+/* A read-write-lock for data read constantly and written rarely.  A reader
+ * only counts itself on its CPU; a writer waits for the counts of all CPUs
+ * to drain.  The count of a CPU may go negative when a reader migrates,
+ * only the sum is meaningful.
+ */
+
+struct percpu_rwsem_cpu_s
+{
+  atomic_int readers aligned_data(PERCPU_RWSEM_ALIGN);
+};
+
+typedef struct
+{
+  struct percpu_rwsem_cpu_s cpu[CONFIG_SMP_NCPUS];
+  rw_semaphore_t rwsem;     /* Held by the writer and by blocked readers */
+  sem_t          drain;     /* Posted by the readers leaving for a writer */
+  atomic_bool    writer;    /* A writer waits or holds the lock */
+} percpu_rw_semaphore_t;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -160,4 +190,88 @@ int init_rwsem(FAR rw_semaphore_t *rwsem);
 
 void destroy_rwsem(FAR rw_semaphore_t *rwsem);
 
+/****************************************************************************
+ * Name: percpu_down_read
+ *
+ * Description:
+ *   Acquire a read lock on a per-CPU read-write-lock object.  Unless a
+ *   writer is in, this only touches the count of the current CPU.
+ *
+ * Input Parameters:
+ *   sem - Pointer to the per-CPU read-write-lock descriptor.
+ *
+ ****************************************************************************/
+
+void percpu_down_read(FAR percpu_rw_semaphore_t *sem);
+
+/****************************************************************************
+ * Name: percpu_up_read
+ *
+ * Description:
+ *   Unlock a read lock on a per-CPU read-write-lock object.
+ *
+ * Input Parameters:
+ *   sem - Pointer to the per-CPU read-write-lock descriptor.
+ *
+ ****************************************************************************/
+
+void percpu_up_read(FAR percpu_rw_semaphore_t *sem);
+
+/****************************************************************************
+ * Name: percpu_down_write
+ *
+ * Description:
+ *   Acquire a write lock on a per-CPU read-write-lock object.  This waits
+ *   for the readers of all CPUs to leave.
+ *
+ * Input Parameters:
+ *   sem - Pointer to the per-CPU read-write-lock descriptor.
+ *
+ ****************************************************************************/
+
+void percpu_down_write(FAR percpu_rw_semaphore_t *sem);
+
+/****************************************************************************
+ * Name: percpu_up_write
+ *
+ * Description:
+ *   Unlock a write lock on a per-CPU read-write-lock object.
+ *
+ * Input Parameters:
+ *   sem - Pointer to the per-CPU read-write-lock descriptor.
+ *
+ ****************************************************************************/
+
+void percpu_up_write(FAR percpu_rw_semaphore_t *sem);
+
+/****************************************************************************
+ * Name: percpu_init_rwsem
+ *
+ * Description:
+ *   Initialize a per-CPU read-write-lock object.
+ *
+ * Input Parameters:
+ *   sem - Pointer to the per-CPU read-write-lock descriptor.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success. A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int percpu_init_rwsem(FAR percpu_rw_semaphore_t *sem);
+
+/****************************************************************************
+ * Name: percpu_destroy_rwsem
+ *
+ * Description:
+ *   Destroy a per-CPU read-write-lock object.
+ *
+ * Input Parameters:
+ *   sem - Pointer to the per-CPU read-write-lock descriptor.
+ *
+ ****************************************************************************/
+
+void percpu_destroy_rwsem(FAR percpu_rw_semaphore_t *sem);
+
 #endif  /* __INCLUDE_NUTTX_RWSEM_H */
@@ -37,6 +37,7 @@
 
 #include <nuttx/addrenv.h>
 #include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/irq.h>
 #include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
@@ -98,6 +99,14 @@
 #  define CONFIG_SCHED_CRITMONITOR_MAXTIME_WDOG -1
 #endif
 
+#ifndef CONFIG_SCHED_CRITMONITOR_TOPN
+#  define CONFIG_SCHED_CRITMONITOR_TOPN 0
+#endif
+
+#ifndef CONFIG_SCHED_CRITMONITOR_TOPN_BACKTRACE
+#  define CONFIG_SCHED_CRITMONITOR_TOPN_BACKTRACE 0
+#endif
+
 /* Task Management Definitions **********************************************/
 
 /* Special task IDS.  Any negative PID is invalid. */
@@ -121,6 +130,7 @@
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT)  /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT)  /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT)  /* Sporadic scheding policy */
+#  define TCB_FLAG_SCHED_DEADLINE  (3 << TCB_FLAG_POLICY_SHIFT)  /* EDF */
 #define TCB_FLAG_CPU_LOCKED        (1 << 5)                      /* Bit 5: Locked to this CPU */
 #define TCB_FLAG_SIGNAL_ACTION     (1 << 6)                      /* Bit 6: In a signal handler */
 #define TCB_FLAG_SYSCALL           (1 << 7)                      /* Bit 7: In a system call */
@@ -354,6 +364,29 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s ********************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure is an allocated "plug-in" to the main TCB structure, like
+ * struct sporadic_s.  It holds the constant bandwidth server of a thread
+ * with the deadline scheduling policy.  All times are in clock ticks.
+ */
+
+struct deadline_s
+{
+  clock_t   runtime;                /* Budget per period                    */
+  clock_t   deadline;               /* Relative deadline                    */
+  clock_t   period;                 /* Period of the server                 */
+  clock_t   absdeadline;            /* Current absolute deadline            */
+  clock_t   budget;                 /* Budget left until absdeadline        */
+  clock_t   eventtime;              /* Time thread was last [re-]started    */
+  uint32_t  bw;                     /* Reserved bandwidth, runtime / period */
+  struct wdog_s timer;              /* Budget exhaustion timer              */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s ****************************************************/
 
 /* This structure is used to maintain information about child tasks.
@@ -524,6 +557,11 @@ struct task_group_s
 
   sq_queue_t tg_sigactionq;         /* List of actions for signals              */
   sq_queue_t tg_sigpendingq;        /* List of pending signals                  */
+  sigset_t tg_sigpendingset;        /* Signals in tg_sigpendingq */
+#if CONFIG_SIG_PENDING_GROUP_CACHE > 0
+  sq_queue_t tg_sigpendingfree;     /* Free entries kept for reuse */
+  uint8_t tg_sigpendingnfree;       /* Entries in tg_sigpendingfree */
+#endif
 #ifdef CONFIG_SIG_DEFAULT
   sigset_t tg_sigdefault;           /* Set of signals set to the default action */
 #endif
@@ -626,6 +664,8 @@ struct tcb_s
   int16_t  irqcount;                     /* 0=Not in critical section       */
 #endif
   int16_t  errcode;                      /* Used to pass error information  */
+  uint16_t rcu_nesting;                  /* Nesting of RCU read sections    */
+  uint32_t rcu_seq;                      /* Counts outermost RCU sections   */
 
 #if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
   int32_t  timeslice;                    /* RR timeslice OR Sporadic budget */
@@ -634,8 +674,14 @@ struct tcb_s
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters  */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  FAR struct deadline_s *deadline;       /* Deadline scheduling parameters  */
+#endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s waithrtimer;          /* Timer of the high res. waits    */
+#endif
 
   /* Stack-Related Fields ***************************************************/
 
@@ -672,6 +718,12 @@ struct tcb_s
   FAR struct pthread_mutex_s *mhead;     /* List of mutexes held by thread  */
 #endif
 
+  /* Poll support ***********************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+  FAR struct poll_cache_s *pollcache;    /* Registration of the last poll() */
+#endif
+
   /* CPU load monitoring support ********************************************/
 
 #ifndef CONFIG_SCHED_CPULOAD_NONE
@@ -777,6 +829,26 @@ struct pthread_tcb_s
 };
 #endif /* !CONFIG_DISABLE_PTHREAD */
 
+/* struct critmon_top_s *****************************************************/
+
+/* One of the longest critical sections or intervals with pre-emption
+ * disabled that the critical section monitor recorded.
+ */
+
+#if CONFIG_SCHED_CRITMONITOR_TOPN > 0
+struct critmon_top_s
+{
+  clock_t elapsed;                       /* Duration, zero if unused        */
+  pid_t pid;                             /* The thread                      */
+  uint8_t cpu;                           /* The CPU it ran on               */
+  FAR void *entry;                       /* Caller that entered             */
+  FAR void *exit;                        /* Caller that left                */
+#if CONFIG_SCHED_CRITMONITOR_TOPN_BACKTRACE > 0
+  FAR void *backtrace[CONFIG_SCHED_CRITMONITOR_TOPN_BACKTRACE];
+#endif
+};
+#endif
+
 /* struct tcbinfo_s *********************************************************/
 
 /* The structure save key filed offset of tcb_s while can be used by
@@ -845,6 +917,20 @@ EXTERN clock_t g_premp_max[CONFIG_SMP_NCPUS];
 EXTERN clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
 
+/* The longest intervals with pre-emption disabled or within a critical
+ * section, in no particular order.
+ */
+
+#if CONFIG_SCHED_CRITMONITOR_TOPN > 0
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
+EXTERN struct critmon_top_s g_premp_top[CONFIG_SCHED_CRITMONITOR_TOPN];
+#  endif
+
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
+EXTERN struct critmon_top_s g_crit_top[CONFIG_SCHED_CRITMONITOR_TOPN];
+#  endif
+#endif
+
 EXTERN const struct tcbinfo_s g_tcbinfo;
 
 /****************************************************************************
@@ -1518,6 +1604,25 @@ int nxsched_get_stackinfo(pid_t pid, FAR struct stackinfo_s *stackinfo);
 void nxsched_get_stateinfo(FAR struct tcb_s *tcb, FAR char *state,
                            size_t length);
 
+/****************************************************************************
+ * Name: nxsched_get_runtime
+ *
+ * Description:
+ *   Return the time that a thread has run, including the time since it was
+ *   last switched in if it is running now.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread.
+ *
+ * Returned Value:
+ *   The run time in units of the performance counter (see perf_convert()).
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+clock_t nxsched_get_runtime(FAR struct tcb_s *tcb);
+#endif
+
 /****************************************************************************
  * Name: nxsched_waitpid
  *
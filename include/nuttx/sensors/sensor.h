@@ -498,6 +498,42 @@ struct sensor_ops_s
   CODE int (*control)(FAR struct sensor_lowerhalf_s *lower,
                       FAR struct file *filep,
                       int cmd, unsigned long arg);
+
+  /**************************************************************************
+   * Name: fifo_read
+   *
+   * Read samples from the hardware FIFO.  It is called by
+   * sensor_push_fifo(), which is called by the lower half driver when the
+   * FIFO has reached its watermark.  The timestamps of the samples need not
+   * be set, sensor_push_fifo() reconstructs them.
+   *
+   * Input Parameters:
+   *   lower      - The instance of lower half sensor driver.
+   *   buffer     - The buffer that receives the samples.
+   *   nsamples   - The maximum number of samples to read.
+   *
+   * Returned Value:
+   *   The number of samples read on success; a negated errno value on
+   *   failure.
+   *
+   **************************************************************************/
+
+  CODE int (*fifo_read)(FAR struct sensor_lowerhalf_s *lower,
+                        FAR void *buffer, uint32_t nsamples);
+};
+
+/* This structure describes the batch buffer of a lower half driver that
+ * is drained with sensor_push_fifo().  The lower half driver sets all but
+ * the timestamp.
+ */
+
+struct sensor_fifo_s
+{
+  FAR void *buffer;            /* Room for 'depth' samples */
+  size_t    esize;             /* The size of one sample */
+  uint32_t  depth;             /* The number of samples of the FIFO */
+  uint32_t  interval;          /* The nominal sample period, in us */
+  uint64_t  timestamp;         /* The time of the previous watermark */
 };
 
 /* This structure is the generic form of state structure used by lower half
@@ -634,6 +670,36 @@ extern "C"
 void sensor_remap_vector_raw16(FAR const int16_t *in, FAR int16_t *out,
                                int place);
 
+/****************************************************************************
+ * Name: sensor_push_fifo
+ *
+ * Description:
+ *   Lower half driver calls this function when its hardware FIFO holds
+ *   'nsamples' samples, e.g. from the work of the watermark interrupt.
+ *   The samples are read with sensor_ops_s::fifo_read and pushed as one
+ *   batch, so that the subscribers are notified once.
+ *
+ *   The last sample is stamped with 'timestamp' and the others are evenly
+ *   spaced before it.  The period is measured between the watermarks, if
+ *   it is close to the nominal interval.  The samples must start with the
+ *   uint64_t timestamp, as all of the struct sensor_xxx do.
+ *
+ * Input Parameters:
+ *   lower     - The instance of lower half sensor driver.
+ *   fifo      - The batch buffer of the lower half driver.
+ *   nsamples  - The number of samples in the hardware FIFO.
+ *   timestamp - The time of the watermark, in us.
+ *
+ * Returned Value:
+ *   The number of bytes pushed on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t sensor_push_fifo(FAR struct sensor_lowerhalf_s *lower,
+                         FAR struct sensor_fifo_s *fifo,
+                         uint32_t nsamples, uint64_t timestamp);
+
 /****************************************************************************
  * "Upper Half" Sensor Driver Interfaces
  ****************************************************************************/
@@ -497,6 +497,21 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_circular
+ *
+ * Description:
+ *  Account for the bytes written to the RX circular buffer by a circular
+ *  Rx DMA, up to the DMA write position 'pos', and wake up the readers
+ *  once per burst.  Called by the lower half on the half-transfer,
+ *  transfer-complete and line-idle ('idle' true) interrupts.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA_CIRCULAR
+void uart_recvchars_circular(FAR uart_dev_t *dev, size_t pos, bool idle);
+#endif
+
 /****************************************************************************
  * Name: uart_reset_sem
  *
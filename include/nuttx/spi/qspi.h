@@ -227,6 +227,36 @@
   (((f) & (QSPIMEM_SCRAMBLE|QSPIMEM_RANDOM)) == \
           (QSPIMEM_SCRAMBLE|QSPIMEM_RANDOM))
 
+/****************************************************************************
+ * Name: QSPI_MEMMAP
+ *
+ * Description:
+ *   Switch the controller to memory-mapped mode.  The FLASH is then read
+ *   with the command described by 'meminfo' whenever the CPU accesses the
+ *   mapped window.  Only the flags, addrlen, dummies and cmd fields are
+ *   used.  With 'meminfo' NULL, the controller is switched back to
+ *   indirect mode, as needed for any other command or memory transfer.
+ *
+ *   The caller holds the bus lock.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   meminfo - Describes the read command, or NULL to leave the mode.
+ *   base    - Location to return the address of the window, may be NULL.
+ *
+ * Returned Value:
+ *   Zero (OK) on SUCCESS, -ENOSYS if memory-mapped mode is not supported,
+ *   or another negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_QSPI_MEMMAP
+#  define QSPI_MEMMAP(d,m,b) \
+  (((d)->ops->memmap) ? (d)->ops->memmap(d,m,b) : -ENOSYS)
+#else
+#  define QSPI_MEMMAP(d,m,b) (-ENOSYS)
+#endif
+
 /****************************************************************************
  * Name: QSPI_ALLOC
  *
@@ -329,6 +359,11 @@ struct qspi_ops_s
                     FAR struct qspi_meminfo_s *meminfo);
   CODE FAR void *(*alloc)(FAR struct qspi_dev_s *dev, size_t buflen);
   CODE void      (*free)(FAR struct qspi_dev_s *dev, FAR void *buffer);
+#ifdef CONFIG_QSPI_MEMMAP
+  CODE int       (*memmap)(FAR struct qspi_dev_s *dev,
+                    FAR const struct qspi_meminfo_s *meminfo,
+                    FAR void **base);
+#endif
 };
 
 /* QSPI private data.  This structure only defines the initial fields of the
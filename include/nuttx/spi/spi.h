@@ -434,6 +434,32 @@
 #  define SPI_TRIGGER(d) \
   (((d)->ops->trigger) ? ((d)->ops->trigger(d)) : -ENOSYS)
 
+/****************************************************************************
+ * Name: SPI_ASYNC
+ *
+ * Description:
+ *   Start all of the transfers of a message and return without waiting.
+ *   The lower half selects the device and configures the bus as described
+ *   by msg->seq, chains the transfers in one DMA descriptor list where it
+ *   can, and calls spi_async_complete() when the last transfer is done,
+ *   normally from its interrupt handler.  Only the SPI asynchronous queue
+ *   calls this method, the bus is not locked.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   msg - The message to transfer
+ *
+ * Returned Value:
+ *   OK      - The transfers were started
+ *   -ENOSYS - The lower half cannot run messages asynchronously
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+#  define SPI_ASYNC(d,m) \
+  (((d)->ops->async) ? ((d)->ops->async(d,m)) : -ENOSYS)
+#endif
+
 /* SPI Device Macros ********************************************************/
 
 /* This builds a SPI devid from its type and index */
@@ -541,6 +567,7 @@ typedef uint8_t spi_hwfeatures_t;
 /* The SPI vtable */
 
 struct spi_dev_s;
+struct spi_message_s;
 struct spi_ops_s
 {
   CODE int      (*lock)(FAR struct spi_dev_s *dev, bool lock);
@@ -579,6 +606,10 @@ struct spi_ops_s
 #endif
   CODE int      (*registercallback)(FAR struct spi_dev_s *dev,
                   spi_mediachange_t callback, void *arg);
+#ifdef CONFIG_SPI_ASYNC
+  CODE int      (*async)(FAR struct spi_dev_s *dev,
+                  FAR struct spi_message_s *msg);
+#endif
 };
 
 /* SPI private data.  This structure only defines the initial fields of the
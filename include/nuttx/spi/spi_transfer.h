@@ -112,6 +112,29 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_ASYNC
+/* This describes a sequence queued with spi_async_submit().  The callback
+ * runs when the sequence is done, from the interrupt handler of the lower
+ * half if it implements SPI_ASYNC(), from the work queue otherwise.  It
+ * may submit the next message.
+ */
+
+struct spi_async_s;
+struct spi_message_s;
+
+typedef CODE void (*spi_async_callback_t)(FAR struct spi_message_s *msg);
+
+struct spi_message_s
+{
+  FAR struct spi_message_s *flink;  /* Used by the queue */
+  FAR struct spi_async_s *queue;    /* Used by the queue */
+  FAR struct spi_sequence_s *seq;   /* The transfers */
+  spi_async_callback_t callback;    /* Called on completion */
+  FAR void *arg;                    /* Argument of the callback */
+  int result;                       /* OK or a negated errno value */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -161,6 +184,98 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 int spi_register(FAR struct spi_dev_s *spi, int bus);
 #endif
 
+#ifdef CONFIG_SPI_ASYNC
+/****************************************************************************
+ * Name: spi_async_initialize
+ *
+ * Description:
+ *   Create the asynchronous message queue of an SPI bus.  All of the
+ *   drivers of devices on the bus share it.
+ *
+ *   If the lower half implements SPI_ASYNC(), the messages are started
+ *   from the submitter and from the completion interrupt without a thread
+ *   in between.  The queue then owns the bus: all of its clients must go
+ *   through the queue, spi_async_transfer() replaces spi_transfer().
+ *   Otherwise the messages are run with spi_transfer() on the work queue,
+ *   and other clients may lock the bus as usual.
+ *
+ * Input Parameters:
+ *   spi - An instance of the lower half SPI driver
+ *
+ * Returned Value:
+ *   The queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct spi_async_s *spi_async_initialize(FAR struct spi_dev_s *spi);
+
+/****************************************************************************
+ * Name: spi_async_uninitialize
+ *
+ * Description:
+ *   Free a queue created by spi_async_initialize().  It must be idle.
+ *
+ ****************************************************************************/
+
+void spi_async_uninitialize(FAR struct spi_async_s *async);
+
+/****************************************************************************
+ * Name: spi_async_submit
+ *
+ * Description:
+ *   Queue a message and return.  The messages of the bus are run in order
+ *   back to back.  msg->seq, msg->callback and msg->arg must be set; the
+ *   message and its buffers must stay valid until the callback.  May be
+ *   called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   async - The queue of the bus
+ *   msg   - The message to transfer
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_async_submit(FAR struct spi_async_s *async,
+                     FAR struct spi_message_s *msg);
+
+/****************************************************************************
+ * Name: spi_async_transfer
+ *
+ * Description:
+ *   Queue a sequence of transfers and wait for it, spi_transfer() for the
+ *   clients of a bus with an asynchronous queue.
+ *
+ * Input Parameters:
+ *   async - The queue of the bus
+ *   seq   - Describes the sequence of transfers.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_async_transfer(FAR struct spi_async_s *async,
+                       FAR struct spi_sequence_s *seq);
+
+/****************************************************************************
+ * Name: spi_async_complete
+ *
+ * Description:
+ *   Called by a lower half that implements SPI_ASYNC() when the message it
+ *   was given is done.  The callback of the message is called and the next
+ *   message is started.  May be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   msg    - The message that is done
+ *   result - OK or a negated errno value
+ *
+ ****************************************************************************/
+
+void spi_async_complete(FAR struct spi_message_s *msg, int result);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
@@ -34,7 +34,8 @@
 #include <nuttx/compiler.h>
 #include <nuttx/irq.h>
 
-#if defined(CONFIG_TICKET_SPINLOCK) || defined(CONFIG_RW_SPINLOCK)
+#if defined(CONFIG_TICKET_SPINLOCK) || defined(CONFIG_MCS_SPINLOCK) || \
+    defined(CONFIG_RW_SPINLOCK)
 #  include <nuttx/atomic.h>
 #endif
 
@@ -75,6 +76,19 @@ typedef union spinlock_u spinlock_t;
 #  define SP_UNLOCKED (union spinlock_u){{0, 0}}
 #  define SP_LOCKED (union spinlock_u){{0, 1}}
 
+#elif defined(CONFIG_MCS_SPINLOCK)
+
+/* Bit 0 is the lock.  The upper half is the tail of the queue of waiters,
+ * the index plus one of the CPU that queued last.
+ */
+
+typedef unsigned int spinlock_t;
+
+#  define SP_UNLOCKED    0u          /* The Un-locked state */
+#  define SP_LOCKED      1u          /* The Locked state */
+#  define SP_TAIL_SHIFT  16
+#  define SP_TAIL_MASK   0xffff0000u
+
 #else
 
 /* The architecture specific spinlock.h header file must also provide the
@@ -120,7 +134,14 @@ typedef union spinlock_u spinlock_t;
 #  define SP_SEV()
 #endif
 
+/* Tell the CPU that the caller is busy waiting */
+
+#if !defined(up_cpu_relax)
+#  define up_cpu_relax()
+#endif
+
 #if !defined(__SP_UNLOCK_FUNCTION) && (defined(CONFIG_TICKET_SPINLOCK) || \
+     defined(CONFIG_MCS_SPINLOCK) || \
      defined(CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS))
 #  define __SP_UNLOCK_FUNCTION 1
 #endif
@@ -141,6 +162,10 @@ void sched_note_spinlock_unlock(FAR volatile spinlock_t *spinlock);
 #  define sched_note_spinlock_unlock(spinlock)
 #endif
 
+#ifdef CONFIG_MCS_SPINLOCK
+void spin_lock_queued(FAR volatile spinlock_t *lock);
+#endif
+
 /****************************************************************************
  * Public Data Types
  ****************************************************************************/
@@ -239,6 +264,17 @@ static inline spinlock_t up_testset(FAR volatile spinlock_t *lock)
 #ifdef CONFIG_SPINLOCK
 static inline_function void spin_lock_wo_note(FAR volatile spinlock_t *lock)
 {
+#if defined(CONFIG_MCS_SPINLOCK)
+  unsigned int unlocked = SP_UNLOCKED;
+
+  /* Queue up only if the lock is contended */
+
+  if (!atomic_compare_exchange_strong((FAR atomic_uint *)lock, &unlocked,
+                                      SP_LOCKED))
+    {
+      spin_lock_queued(lock);
+    }
+#else /* CONFIG_MCS_SPINLOCK */
 #ifdef CONFIG_TICKET_SPINLOCK
   unsigned short ticket =
     atomic_fetch_add((FAR atomic_ushort *)&lock->tickets.next, 1);
@@ -250,6 +286,7 @@ static inline_function void spin_lock_wo_note(FAR volatile spinlock_t *lock)
       SP_DSB();
       SP_WFE();
     }
+#endif /* CONFIG_MCS_SPINLOCK */
 
   SP_DMB();
 }
@@ -341,6 +378,13 @@ spin_trylock_wo_note(FAR volatile spinlock_t *lock)
 
   if (!atomic_compare_exchange_strong((FAR atomic_uint *)&lock->value,
                                       &oldval.value, newval.value))
+#elif defined(CONFIG_MCS_SPINLOCK)
+  unsigned int unlocked = SP_UNLOCKED;
+
+  /* Fail as well if there are waiters queued */
+
+  if (!atomic_compare_exchange_strong((FAR atomic_uint *)lock, &unlocked,
+                                      SP_LOCKED))
 #else /* CONFIG_TICKET_SPINLOCK */
   if (up_testset(lock) == SP_LOCKED)
 #endif /* CONFIG_TICKET_SPINLOCK */
@@ -429,6 +473,8 @@ spin_unlock_wo_note(FAR volatile spinlock_t *lock)
   SP_DMB();
 #ifdef CONFIG_TICKET_SPINLOCK
   atomic_fetch_add((FAR atomic_ushort *)&lock->tickets.owner, 1);
+#elif defined(CONFIG_MCS_SPINLOCK)
+  atomic_fetch_and((FAR atomic_uint *)lock, ~SP_LOCKED);
 #else
   *lock = SP_UNLOCKED;
 #endif
@@ -488,6 +534,8 @@ static inline_function void spin_unlock(FAR volatile spinlock_t *lock)
 /* bool spin_islocked(FAR spinlock_t lock); */
 #ifdef CONFIG_TICKET_SPINLOCK
 #  define spin_is_locked(l) ((*l).tickets.owner != (*l).tickets.next)
+#elif defined(CONFIG_MCS_SPINLOCK)
+#  define spin_is_locked(l) ((*(l) & SP_LOCKED) != 0)
 #else
 #  define spin_is_locked(l) (*(l) == SP_LOCKED)
 #endif
@@ -350,6 +350,8 @@ void lib_memsostream(FAR struct lib_memsostream_s *stream,
  * Description:
  *   Initializes a stream for use with a FILE instance.
  *   Defined in lib/stdio/lib_stdinstream.c and lib/stdio/lib_stdoutstream.c
+ *   The caller of lib_stdoutstream() holds flockfile() on the FILE
+ *   instance while the stream is in use.
  *
  * Input Parameters:
  *   stream  - User allocated, uninitialized instance of stream
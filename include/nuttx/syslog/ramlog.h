@@ -42,6 +42,8 @@
 #include <nuttx/config.h>
 #include <nuttx/syslog/syslog.h>
 
+#include <stdarg.h>
+
 #ifdef CONFIG_RAMLOG
 
 /****************************************************************************
@@ -64,6 +66,8 @@
  * provided:
  *
  * CONFIG_RAMLOG_BUFSIZE - Size of the console RAM log.  Default: 1024
+ * CONFIG_RAMLOG_BINARY - Save binary records of the syslog() messages in
+ *   the console RAM log, formatted when the log is read.
  */
 
 #ifndef CONFIG_RAMLOG_NPOLLWAITERS
@@ -149,6 +153,20 @@ ssize_t ramlog_write(FAR syslog_channel_t *channel,
                      FAR const char *buffer, size_t buflen);
 #endif
 
+/****************************************************************************
+ * Name: ramlog_vsyslog
+ *
+ * Description:
+ *   Save a syslog() message as a binary record; it is formatted when the
+ *   RAM log is read.  Called by nx_vsyslog() if CONFIG_RAMLOG_BINARY is
+ *   selected.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_BINARY
+void ramlog_vsyslog(int priority, FAR const IPTR char *fmt, va_list ap);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -749,6 +749,24 @@ struct sensor_ustate_s
   uint64_t generation;         /* The recent generation of circular buffer */
 };
 
+/* This structure is the header of the buffer that mmap() returns for a
+ * sensor topic, the samples follow it.  'head' counts the samples written
+ * since the buffer was created and is updated after the samples; sample n
+ * is at offset (n % nbuffer) * esize after the header.  A subscriber keeps
+ * its own index and may use sample n in place as long as head - n stays
+ * below nbuffer, i.e. it has to check head again after using the sample.
+ */
+
+#ifdef CONFIG_SENSORS_MMAP
+struct sensor_ring_s
+{
+  volatile uint32_t head;      /* The number of samples written */
+  uint32_t nbuffer;            /* The number of samples in the buffer */
+  uint32_t esize;              /* The size of one sample */
+  uint32_t reserved;           /* Keeps the samples 64-bit aligned */
+};
+#endif
+
 /* This structure describes the register info for the user sensor */
 
 #ifdef CONFIG_USENSOR
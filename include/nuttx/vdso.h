@@ -0,0 +1,131 @@
+/****************************************************************************
+ * include/nuttx/vdso.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_VDSO_H
+#define __INCLUDE_NUTTX_VDSO_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __KERNEL__
+#  include <nuttx/arch.h>
+#endif
+
+#ifdef CONFIG_CLOCK_VDSO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The clock data page is the first page of the shared memory region of
+ * every process.
+ */
+
+#define VDSO_DATA_VBASE   CONFIG_ARCH_SHM_VBASE
+#define VDSO_DATA         ((FAR const struct vdso_data_s *)VDSO_DATA_VBASE)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The clock data shared with user space.  The kernel makes seq odd while it
+ * updates the other fields, readers retry until they see the same even
+ * value before and after reading them.  The time now is the base time plus
+ * ((up_vdso_counter() - counter) * mult) >> shift nanoseconds.
+ */
+
+struct vdso_data_s
+{
+  uint32_t        seq;          /* Update sequence, odd while updating */
+  uint32_t        shift;        /* Scale of mult */
+  uint64_t        mult;         /* Nanoseconds per count << shift */
+  uint64_t        maxdelta;     /* Larger deltas take the system call */
+  uint64_t        counter;      /* up_vdso_counter() at mono */
+  struct timespec mono;         /* CLOCK_MONOTONIC at counter */
+  struct timespec real_offset;  /* CLOCK_REALTIME - CLOCK_MONOTONIC */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef __KERNEL__
+
+/****************************************************************************
+ * Name: clock_vdso_initialize
+ *
+ * Description:
+ *   Allocate and fill the clock data page, and start updating it.
+ *
+ ****************************************************************************/
+
+void clock_vdso_initialize(void);
+
+/****************************************************************************
+ * Name: clock_vdso_update
+ *
+ * Description:
+ *   Bring the clock data page up to date.  Called periodically, and when
+ *   the wall time is set.
+ *
+ ****************************************************************************/
+
+void clock_vdso_update(void);
+
+/****************************************************************************
+ * Name: clock_vdso_map
+ *
+ * Description:
+ *   Map the clock data page read-only at VDSO_DATA_VBASE in a new address
+ *   environment.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int clock_vdso_map(FAR arch_addrenv_t *addrenv);
+
+#endif /* __KERNEL__ */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_CLOCK_VDSO */
+#endif /* __INCLUDE_NUTTX_VDSO_H */
@@ -0,0 +1,210 @@
+/****************************************************************************
+ * include/nuttx/video/dmabuf.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_VIDEO_DMABUF_H
+#define __INCLUDE_NUTTX_VIDEO_DMABUF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <limits.h>
+#include <poll.h>
+#include <stddef.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+
+#ifdef CONFIG_VIDEO_DMABUF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Timeout of dmabuf_fence_wait() never expiring */
+
+#define DMABUF_WAIT_FOREVER UINT_MAX
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A buffer shared between video devices.  Capture devices, codecs and
+ * displays pass frames to each other as file descriptors referring to
+ * such buffers, instead of copying the frames through user memory.
+ *
+ * The buffer stays allocated as long as a reference to it is held, either
+ * by a driver or through a file descriptor.  A slice refers to a part of
+ * another buffer and holds a reference to it.
+ *
+ * A device writing into the buffer holds a fence on it until the write is
+ * complete.  Devices reading from the buffer wait for the fences to be
+ * released first, and poll() on the descriptor reports the buffer ready
+ * when no fence is held.
+ */
+
+struct dmabuf_s;
+typedef CODE void (*dmabuf_release_t)(FAR struct dmabuf_s *buf);
+
+struct dmabuf_s
+{
+  FAR void *vaddr;                /* Start of the buffer */
+  size_t size;                    /* Size of the buffer in bytes */
+  FAR struct dmabuf_s *parent;    /* Buffer that this is a slice of */
+  dmabuf_release_t release;       /* Frees the memory, NULL for slices */
+  FAR void *priv;                 /* For use by release() */
+
+  spinlock_t lock;                /* Protects the fields below */
+  unsigned int refs;              /* References to the buffer */
+  unsigned int fences;            /* Writes in progress */
+  unsigned int waiters;           /* Threads waiting for the writes */
+  sem_t fencesem;                 /* Posted when the writes complete */
+  FAR struct pollfd *fds[CONFIG_VIDEO_DMABUF_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: dmabuf_create
+ *
+ * Description:
+ *   Create a shared buffer describing the memory at 'vaddr'.  The caller
+ *   holds the only reference to it, and release() is called to free the
+ *   memory when the last reference is dropped.
+ *
+ * Returned Value:
+ *   The new buffer, or NULL if out of memory.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_create(FAR void *vaddr, size_t size,
+                                   dmabuf_release_t release,
+                                   FAR void *priv);
+
+/****************************************************************************
+ * Name: dmabuf_slice
+ *
+ * Description:
+ *   Create a buffer referring to 'size' bytes at 'offset' in 'parent'.
+ *   The slice holds a reference to its parent.
+ *
+ * Returned Value:
+ *   The new buffer, or NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_s *dmabuf_slice(FAR struct dmabuf_s *parent,
+                                  size_t offset, size_t size);
+
+/****************************************************************************
+ * Name: dmabuf_get / dmabuf_put
+ *
+ * Description:
+ *   Take or drop a reference to a buffer.  The buffer is freed when the
+ *   last reference is dropped.  dmabuf_put() must be called from a task.
+ *
+ ****************************************************************************/
+
+void dmabuf_get(FAR struct dmabuf_s *buf);
+void dmabuf_put(FAR struct dmabuf_s *buf);
+
+/****************************************************************************
+ * Name: dmabuf_export
+ *
+ * Description:
+ *   Allocate a file descriptor referring to the buffer.  The descriptor
+ *   holds its own reference, which is dropped when it is closed.  It can be
+ *   mmap()ed, poll()ed for the completion of writes and passed to other
+ *   video devices.
+ *
+ * Input Parameters:
+ *   buf    - The buffer to export.
+ *   oflags - O_CLOEXEC and/or O_NONBLOCK.
+ *
+ * Returned Value:
+ *   The new file descriptor, or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dmabuf_export(FAR struct dmabuf_s *buf, int oflags);
+
+/****************************************************************************
+ * Name: dmabuf_import
+ *
+ * Description:
+ *   Look up the buffer that a file descriptor returned by dmabuf_export()
+ *   refers to and take a reference to it.
+ *
+ * Returned Value:
+ *   Zero on success, -EBADF if 'fd' is not valid and -EINVAL if it does
+ *   not refer to a shared buffer.
+ *
+ ****************************************************************************/
+
+int dmabuf_import(int fd, FAR struct dmabuf_s **buf);
+
+/****************************************************************************
+ * Name: dmabuf_fence_begin / dmabuf_fence_end
+ *
+ * Description:
+ *   Mark the start and the end of a write to the buffer.  dmabuf_fence_end()
+ *   may be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+void dmabuf_fence_begin(FAR struct dmabuf_s *buf);
+void dmabuf_fence_end(FAR struct dmabuf_s *buf);
+
+/****************************************************************************
+ * Name: dmabuf_fence_wait
+ *
+ * Description:
+ *   Wait up to 'msec' milliseconds, or DMABUF_WAIT_FOREVER, for the writes
+ *   in progress to complete.
+ *
+ * Returned Value:
+ *   Zero when no write is in progress, -EAGAIN if 'msec' is zero and a
+ *   write is in progress, or -ETIMEDOUT.
+ *
+ ****************************************************************************/
+
+int dmabuf_fence_wait(FAR struct dmabuf_s *buf, unsigned int msec);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_VIDEO_DMABUF */
+#endif /* __INCLUDE_NUTTX_VIDEO_DMABUF_H */
@@ -317,6 +317,12 @@
                                               /* Argument: writable struct
                                                *           fb_fix_screeninfo */
 
+#ifdef CONFIG_VIDEO_DMABUF
+#define FBIOPAN_DMABUF        _FBIOC(0x001d)  /* Pan display to a shared
+                                               * buffer, see dmabuf.h
+                                               * Argument: int (its fd) */
+#endif
+
 #define FB_TYPE_PACKED_PIXELS        0      /* Packed Pixels */
 #define FB_TYPE_PLANES               1      /* Non interleaved planes */
 #define FB_TYPE_INTERLEAVED_PLANES   2      /* Interleaved planes */
@@ -848,6 +854,15 @@ struct fb_vtable_s
 
   int (*ioctl)(FAR struct fb_vtable_s *vtable, int cmd, unsigned long arg);
 
+#ifdef CONFIG_VIDEO_DMABUF
+  /* Set if the driver displays the fbmem of the queued pan infos, which is
+   * NULL for pans within its own frame buffer memory.  FBIOPAN_DMABUF is
+   * only supported then.
+   */
+
+  bool pandmabuf;
+#endif
+
   /* Pointer to framebuffer device private data. */
 
   FAR void *priv;
@@ -70,6 +70,8 @@
  *   priority worker thread.  Default: 176
  * CONFIG_SCHED_LPWORKSTACKSIZE - The stack size allocated for the lower
  *   priority worker thread.  Default: 2048.
+ * CONFIG_SCHED_WORKQUEUE_PERCPU - Keep the pending work of the kernel work
+ *   queues per CPU and run it on the CPU that queued it when possible.
  *
  * The user-mode work queue is only available in the protected or kernel
  * builds.  This those configurations, the user-mode work queue provides the
@@ -100,6 +102,7 @@
 #  undef CONFIG_SCHED_HPWORK
 #  undef CONFIG_SCHED_LPWORK
 #  undef CONFIG_SCHED_WORKQUEUE
+#  undef CONFIG_SCHED_WORKQUEUE_PERCPU
 
   /* User-space worker threads are not built in a kernel build when we are
    * building the kernel-space libraries (but we still need to know that it
@@ -259,6 +262,12 @@ struct work_s
   worker_t  worker;              /* Work callback */
   FAR void *arg;                 /* Callback argument */
   FAR struct kwork_wqueue_s *wq; /* Work queue */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  uint8_t   cpu;                 /* CPU the work is posted on */
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  clock_t   qstamp;              /* perf_gettime() when work was posted */
+#endif
 };
 
 /* This is an enumeration of the various events that may be
@@ -413,6 +422,43 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
                   FAR struct work_s *work, worker_t worker,
                   FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_on/work_queue_wq_on
+ *
+ * Description:
+ *   Queue work like work_queue()/work_queue_wq(), but post it on the given
+ *   CPU instead of the calling one.  The work runs on that CPU unless its
+ *   workers are busy and a worker of another CPU steals it.  Without
+ *   CONFIG_SCHED_WORKQUEUE_PERCPU the CPU is ignored.
+ *
+ * Input Parameters:
+ *   cpu    - The CPU to post the work on
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+int work_queue_on(int cpu, int qid, FAR struct work_s *work,
+                  worker_t worker, FAR void *arg, clock_t delay);
+int work_queue_wq_on(int cpu, FAR struct kwork_wqueue_s *wqueue,
+                     FAR struct work_s *work, worker_t worker,
+                     FAR void *arg, clock_t delay);
+#else
+#  define work_queue_on(cpu, qid, work, worker, arg, delay) \
+     work_queue(qid, work, worker, arg, delay)
+#  define work_queue_wq_on(cpu, wqueue, work, worker, arg, delay) \
+     work_queue_wq(wqueue, work, worker, arg, delay)
+#endif
+
 /****************************************************************************
  * Name: work_queue_pri
  *
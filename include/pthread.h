@@ -265,7 +265,12 @@ typedef struct pthread_condattr_s pthread_condattr_t;
 
 struct pthread_cond_s
 {
+#ifdef CONFIG_PTHREAD_FUTEX
+  volatile uint32_t seq;      /* Futex word, changed by each signal */
+  volatile uint32_t waiters;  /* Threads in pthread_cond_clockwait() */
+#else
   sem_t sem;
+#endif
   clockid_t clockid;
 };
 
@@ -274,7 +279,11 @@ typedef struct pthread_cond_s pthread_cond_t;
 #  define __PTHREAD_COND_T_DEFINED 1
 #endif
 
-#define PTHREAD_COND_INITIALIZER {SEM_INITIALIZER(0), CLOCK_REALTIME }
+#ifdef CONFIG_PTHREAD_FUTEX
+#  define PTHREAD_COND_INITIALIZER {0, 0, CLOCK_REALTIME}
+#else
+#  define PTHREAD_COND_INITIALIZER {SEM_INITIALIZER(0), CLOCK_REALTIME }
+#endif
 
 struct pthread_mutexattr_s
 {
@@ -298,6 +307,24 @@ typedef struct pthread_mutexattr_s pthread_mutexattr_t;
 #  define __PTHREAD_MUTEXATTR_T_DEFINED 1
 #endif
 
+#ifdef CONFIG_PTHREAD_FUTEX
+/* The mutex is a futex word holding the thread ID of the holder and
+ * _PTHREAD_FUTEX_WAITERS, so that it is taken and released without a
+ * system call when not contended.
+ */
+
+#  define _PTHREAD_FUTEX_WAITERS      (1u << 31)
+#  define _PTHREAD_FUTEX_TIDMASK      (~_PTHREAD_FUTEX_WAITERS)
+
+struct pthread_mutex_s
+{
+  volatile uint32_t futex;  /* Holder TID and _PTHREAD_FUTEX_WAITERS */
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  uint8_t type;             /* Type of the mutex.  See PTHREAD_MUTEX_* */
+  uint16_t nlocks;          /* Depth of a recursive mutex */
+#endif
+};
+#else
 struct pthread_mutex_s
 {
 #ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
@@ -316,6 +343,7 @@ struct pthread_mutex_s
   mutex_t mutex;    /* Mutex underlying the implementation of the mutex */
 #endif
 };
+#endif /* CONFIG_PTHREAD_FUTEX */
 
 #ifndef __PTHREAD_MUTEX_T_DEFINED
 typedef struct pthread_mutex_s pthread_mutex_t;
@@ -330,7 +358,13 @@ typedef struct pthread_mutex_s pthread_mutex_t;
 #  endif
 #endif
 
-#if defined(CONFIG_PTHREAD_MUTEX_TYPES) && !defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
+#if defined(CONFIG_PTHREAD_FUTEX) && defined(CONFIG_PTHREAD_MUTEX_TYPES)
+#  define PTHREAD_MUTEX_INITIALIZER {0, PTHREAD_MUTEX_DEFAULT, 0}
+#  define PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP \
+                                    {0, PTHREAD_MUTEX_RECURSIVE, 0}
+#elif defined(CONFIG_PTHREAD_FUTEX)
+#  define PTHREAD_MUTEX_INITIALIZER {0}
+#elif defined(CONFIG_PTHREAD_MUTEX_TYPES) && !defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
 #  define PTHREAD_MUTEX_INITIALIZER {NULL, __PTHREAD_MUTEX_DEFAULT_FLAGS, \
                                      PTHREAD_MUTEX_DEFAULT, \
                                      NXRMUTEX_INITIALIZER}
@@ -0,0 +1,180 @@
+/****************************************************************************
+ * include/sys/uring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_URING_H
+#define __INCLUDE_SYS_URING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Submission queue entry operations */
+
+#define URING_OP_NOP          0  /* Complete at once with res = 0 */
+#define URING_OP_READ         1  /* read() or pread() into addr */
+#define URING_OP_WRITE        2  /* write() or pwrite() from addr */
+#define URING_OP_SEND         3  /* send() from addr with op_flags */
+#define URING_OP_RECV         4  /* recv() into addr with op_flags */
+#define URING_OP_FSYNC        5  /* fsync() */
+#define URING_OP_POLL         6  /* Wait for the op_flags events,
+                                  * res = revents */
+#define URING_OP_TIMEOUT      7  /* Wait for the struct timespec at addr,
+                                  * res = -ETIME */
+
+/* Use the file position instead of 'off' for READ and WRITE */
+
+#define URING_OFF_CURRENT     ((uint64_t)-1)
+
+/* uring_enter() flags */
+
+#define URING_ENTER_GETEVENTS (1 << 0) /* Wait for min_complete CQEs */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* The head and tail of a ring shared by the kernel and the application.
+ * The producer writes the entry, then the tail; the consumer reads the
+ * entry, then writes the head.  Indexes run freely and are masked with
+ * 'mask' to address the entries.
+ *
+ * The kernel owns the head of the submission queue and the tail of the
+ * completion queue.  The application reads the completion queue tail with
+ * acquire semantics, e.g. with __atomic_load_n(..., __ATOMIC_ACQUIRE).
+ */
+
+struct uring_ring
+{
+  volatile uint32_t head;
+  volatile uint32_t tail;
+  uint32_t          mask;
+  uint32_t          entries;
+};
+
+/* Submission queue entry */
+
+struct uring_sqe
+{
+  uint8_t   opcode;         /* See URING_OP_* definitions */
+  uint8_t   flags;          /* Reserved, must be zero */
+  uint16_t  reserved;
+  int32_t   fd;             /* File or socket descriptor */
+  uint64_t  off;            /* File offset or URING_OFF_CURRENT */
+  FAR void *addr;           /* Buffer, or struct timespec for TIMEOUT */
+  uint32_t  len;            /* Buffer length in bytes */
+  uint32_t  op_flags;       /* SEND/RECV msg_flags or POLL events */
+  uint64_t  user_data;      /* Copied to the completion queue entry */
+};
+
+/* Completion queue entry */
+
+struct uring_cqe
+{
+  uint64_t  user_data;      /* From the submission queue entry */
+  int32_t   res;            /* Result or negated errno value */
+  uint32_t  flags;          /* Reserved */
+};
+
+/* uring_setup() parameters.  The rings are in memory accessible by the
+ * application and stay valid until the descriptor is closed.
+ */
+
+struct uring_params
+{
+  uint32_t                  sq_entries; /* Submission queue size */
+  uint32_t                  cq_entries; /* Completion queue size */
+  uint32_t                  flags;      /* Reserved, must be zero */
+  FAR struct uring_ring    *sq;         /* Submission queue indexes */
+  FAR struct uring_sqe     *sqes;       /* Submission queue entries */
+  FAR struct uring_ring    *cq;         /* Completion queue indexes */
+  FAR struct uring_cqe     *cqes;       /* Completion queue entries */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: uring_setup
+ *
+ * Description:
+ *   Create a submission/completion ring pair and return a descriptor that
+ *   refers to it.  The submission queue has 'entries' entries rounded up
+ *   to a power of two; the completion queue has twice as many.  Closing
+ *   the descriptor cancels the pending polls and timeouts, waits for the
+ *   other requests and frees the rings.
+ *
+ * Input Parameters:
+ *   entries - Requested submission queue size
+ *   params  - Returns the sizes and the addresses of the rings
+ *
+ * Returned Value:
+ *   A new file descriptor on success; -1 (ERROR) on failure with errno set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int uring_setup(unsigned int entries, FAR struct uring_params *params);
+
+/****************************************************************************
+ * Name: uring_enter
+ *
+ * Description:
+ *   Submit up to 'to_submit' entries from the submission queue and, with
+ *   URING_ENTER_GETEVENTS, wait until at least 'min_complete' entries are
+ *   in the completion queue.  Completions are reaped from the completion
+ *   queue without a system call.  Each submitted request produces exactly
+ *   one completion entry.
+ *
+ * Returned Value:
+ *   The number of entries submitted on success; -1 (ERROR) on failure with
+ *   errno set appropriately.  EBUSY means that the completion queue could
+ *   overflow:  Reap completions, then submit again.
+ *
+ ****************************************************************************/
+
+int uring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                unsigned int flags);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_SYS_URING_H */
@@ -798,6 +798,24 @@ struct v4l2_buffer
 
 typedef struct v4l2_buffer v4l2_buffer_t;
 
+/* struct v4l2_exportbuffer
+ * Parameter of ioctl(VIDIOC_EXPBUF).
+ * The driver returns in fd a DMABUF descriptor of the V4L2_MEMORY_MMAP
+ * buffer selected by type and index.  flags accepts O_CLOEXEC.
+ */
+
+struct v4l2_exportbuffer
+{
+  uint32_t type;          /* enum #v4l2_buf_type */
+  uint32_t index;         /* Buffer id */
+  uint32_t plane;         /* Plane of a multi-planar buffer */
+  uint32_t flags;         /* Flags of the new descriptor */
+  int32_t  fd;            /* The new descriptor */
+  uint32_t reserved[11];
+};
+
+typedef struct v4l2_exportbuffer v4l2_exportbuffer_t;
+
 /* Image is a keyframe (I-frame) */
 
 #define V4L2_BUF_FLAG_KEYFRAME                  0x00000008
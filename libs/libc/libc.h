@@ -237,6 +237,16 @@ void lib_skipspace(FAR const char **pptr);
 
 bool lib_isbasedigit(int ch, int base, FAR int *value);
 
+/* Defined in lib_parse8digits.c */
+
+bool lib_parse8digits(FAR const char *ptr, FAR uint32_t *value);
+
+/* Defined in lib_strtod_fast.c */
+
+#ifdef CONFIG_LIBC_STRTOD_FAST
+double lib_strtod_fast(FAR const char *str, FAR char **endptr, bool single);
+#endif
+
 /* Defined in lib_checkbase.c */
 
 int lib_checkbase(int base, FAR const char **pptr);
@@ -0,0 +1,113 @@
+/****************************************************************************
+ * libs/libc/machine/arm64/arch_crc32.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <arm_acle.h>
+
+#include <nuttx/crc32.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The CRC32 instructions are optional before ARMv8.1, enable them for the
+ * functions that use them only.
+ */
+
+#define CRC_FUNCTION __attribute__((target("+crc")))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crc32part
+ *
+ * Description:
+ *   Continue CRC calculation on a part of the buffer, with the CRC32
+ *   instructions.
+ *
+ ****************************************************************************/
+
+CRC_FUNCTION
+uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  uint64_t data;
+
+  for (; len > 0 && ((uintptr_t)src & 7) != 0; len--)
+    {
+      crc32val = __crc32b(crc32val, *src++);
+    }
+
+  for (; len >= 8; len -= 8, src += 8)
+    {
+      memcpy(&data, src, sizeof(data));
+      crc32val = __crc32d(crc32val, data);
+    }
+
+  for (; len > 0; len--)
+    {
+      crc32val = __crc32b(crc32val, *src++);
+    }
+
+  return crc32val;
+}
+
+/****************************************************************************
+ * Name: crc32cpart
+ *
+ * Description:
+ *   Continue CRC-32C calculation on a part of the buffer, with the CRC32C
+ *   instructions.
+ *
+ ****************************************************************************/
+
+CRC_FUNCTION
+uint32_t crc32cpart(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  uint64_t data;
+
+  for (; len > 0 && ((uintptr_t)src & 7) != 0; len--)
+    {
+      crc32val = __crc32cb(crc32val, *src++);
+    }
+
+  for (; len >= 8; len -= 8, src += 8)
+    {
+      memcpy(&data, src, sizeof(data));
+      crc32val = __crc32cd(crc32val, data);
+    }
+
+  for (; len > 0; len--)
+    {
+      crc32val = __crc32cb(crc32val, *src++);
+    }
+
+  return crc32val;
+}
@@ -29,10 +29,12 @@
 #  define SZREG  8
 #  define REG_S sd
 #  define REG_L ld
+#  define REPEAT01 0x0101010101010101
 #else
 #  define SZREG  4
 #  define REG_S sw
 #  define REG_L lw
+#  define REPEAT01 0x01010101
 #endif
 
 #ifdef CONFIG_ARCH_QPFPU
@@ -0,0 +1,227 @@
+/****************************************************************************
+ * libs/libc/misc/lib_arena.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/arena.h>
+#include <nuttx/lib/lib.h>
+#include <nuttx/nuttx.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ARENA_ALIGN      (2 * sizeof(uintptr_t))
+#define ARENA_BLOCKSIZE  1024
+
+#define ARENA_HDRSIZE    ALIGN_UP(sizeof(struct arena_block_s), ARENA_ALIGN)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The header of each block, followed by the memory handed out */
+
+struct arena_block_s
+{
+  FAR struct arena_block_s *next;  /* The block allocated before this one */
+  FAR char *end;                   /* The end of the block */
+};
+
+struct arena_s
+{
+  FAR struct arena_block_s *head;  /* The most recent block */
+  FAR char *ptr;                   /* The free memory of the head block */
+  size_t blocksize;                /* The usable size of a new block */
+  struct arena_block_s first;      /* The block allocated with the arena */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arena_first
+ *
+ * Description:
+ *   Return the start of the memory of the first block.
+ *
+ ****************************************************************************/
+
+static inline FAR char *arena_first(FAR struct arena_s *arena)
+{
+  return (FAR char *)arena +
+         ALIGN_UP(sizeof(struct arena_s), ARENA_ALIGN);
+}
+
+/****************************************************************************
+ * Name: arena_grow
+ *
+ * Description:
+ *   Add a block that holds at least 'size' bytes.
+ *
+ ****************************************************************************/
+
+static FAR void *arena_grow(FAR struct arena_s *arena, size_t size)
+{
+  FAR struct arena_block_s *block;
+  bool large = size > arena->blocksize / 2;
+  size_t blocksize = large ? size : arena->blocksize;
+
+  block = lib_malloc(ARENA_HDRSIZE + blocksize);
+  if (block == NULL)
+    {
+      return NULL;
+    }
+
+  block->end = (FAR char *)block + ARENA_HDRSIZE + blocksize;
+
+  /* A large request gets a block of its own, behind the head block whose
+   * free memory stays in use.
+   */
+
+  if (large)
+    {
+      block->next       = arena->head->next;
+      arena->head->next = block;
+    }
+  else
+    {
+      block->next = arena->head;
+      arena->head = block;
+      arena->ptr  = (FAR char *)block + ARENA_HDRSIZE + size;
+    }
+
+  return (FAR char *)block + ARENA_HDRSIZE;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arena_create
+ ****************************************************************************/
+
+FAR struct arena_s *arena_create(size_t blocksize)
+{
+  FAR struct arena_s *arena;
+
+  blocksize = ALIGN_UP(blocksize > 0 ? blocksize : ARENA_BLOCKSIZE,
+                       ARENA_ALIGN);
+
+  arena = lib_malloc(ALIGN_UP(sizeof(struct arena_s), ARENA_ALIGN) +
+                     blocksize);
+  if (arena != NULL)
+    {
+      arena->head       = &arena->first;
+      arena->ptr        = arena_first(arena);
+      arena->blocksize  = blocksize;
+      arena->first.next = NULL;
+      arena->first.end  = arena->ptr + blocksize;
+    }
+
+  return arena;
+}
+
+/****************************************************************************
+ * Name: arena_alloc
+ ****************************************************************************/
+
+FAR void *arena_alloc(FAR struct arena_s *arena, size_t size)
+{
+  FAR void *ptr;
+
+  size = ALIGN_UP(size > 0 ? size : 1, ARENA_ALIGN);
+  if (size > (size_t)(arena->head->end - arena->ptr))
+    {
+      return arena_grow(arena, size);
+    }
+
+  ptr         = arena->ptr;
+  arena->ptr += size;
+  return ptr;
+}
+
+/****************************************************************************
+ * Name: arena_zalloc
+ ****************************************************************************/
+
+FAR void *arena_zalloc(FAR struct arena_s *arena, size_t size)
+{
+  FAR void *ptr = arena_alloc(arena, size);
+
+  if (ptr != NULL)
+    {
+      memset(ptr, 0, size);
+    }
+
+  return ptr;
+}
+
+/****************************************************************************
+ * Name: arena_reset
+ ****************************************************************************/
+
+void arena_reset(FAR struct arena_s *arena)
+{
+  FAR struct arena_block_s *block = arena->head;
+  FAR struct arena_block_s *next;
+
+  /* The first block is the last of the list, unless blocks of large
+   * requests were linked behind it.
+   */
+
+  while (block != NULL)
+    {
+      next = block->next;
+      if (block != &arena->first)
+        {
+          lib_free(block);
+        }
+
+      block = next;
+    }
+
+  arena->first.next = NULL;
+  arena->head       = &arena->first;
+  arena->ptr        = arena_first(arena);
+}
+
+/****************************************************************************
+ * Name: arena_destroy
+ ****************************************************************************/
+
+void arena_destroy(FAR struct arena_s *arena)
+{
+  if (arena != NULL)
+    {
+      arena_reset(arena);
+      lib_free(arena);
+    }
+}
@@ -26,8 +26,10 @@
 
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -57,6 +59,99 @@ static bool nxmutex_is_reset(FAR mutex_t *mutex)
   return mutex->holder == NXMUTEX_RESET;
 }
 
+/****************************************************************************
+ * Name: nxmutex_holder_running
+ *
+ * Description:
+ *   Return true if the thread 'holder' is running on a CPU.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_MUTEX_ADAPTIVE_SPIN) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+static bool nxmutex_holder_running(pid_t holder)
+{
+  FAR struct tcb_s *htcb;
+  irqstate_t flags;
+  bool running;
+
+  /* The TCB can neither be freed nor change its state meanwhile */
+
+  flags   = enter_critical_section();
+  htcb    = nxsched_get_tcb(holder);
+  running = htcb != NULL && htcb->task_state == TSTATE_TASK_RUNNING;
+  leave_critical_section(flags);
+
+  return running;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxmutex_spin
+ *
+ * Description:
+ *   Spin while the holder of the mutex is running on another CPU, in the
+ *   hope that it releases the mutex before the caller would have finished
+ *   blocking.
+ *
+ * Parameters:
+ *   mutex - mutex descriptor.
+ *
+ * Return Value:
+ *   true if the mutex was taken; false if the caller should block.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_MUTEX_ADAPTIVE_SPIN) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+static bool nxmutex_spin(FAR mutex_t *mutex)
+{
+  int spins = CONFIG_MUTEX_ADAPTIVE_SPIN_COUNT;
+  pid_t checked = NXMUTEX_NO_HOLDER;
+  pid_t holder;
+  int count;
+
+  while (spins-- > 0)
+    {
+      /* Don't overtake the threads already waiting for the mutex */
+
+      if (nxsem_get_value(&mutex->sem, &count) < 0 || count < 0)
+        {
+          return false;
+        }
+
+      holder = mutex->holder;
+      if (holder == NXMUTEX_NO_HOLDER)
+        {
+          if (nxsem_trywait(&mutex->sem) >= 0)
+            {
+              return true;
+            }
+        }
+      else if (holder != checked)
+        {
+          /* Blocking is cheaper if the holder has to be scheduled first.
+           * Each holder is checked once, the spin count bounds the time
+           * lost if it is preempted later.
+           */
+
+          if (!nxmutex_holder_running(holder))
+            {
+              return false;
+            }
+
+          checked = holder;
+        }
+
+      up_cpu_relax();
+    }
+
+  return false;
+}
+#else
+#  define nxmutex_spin(mutex) false
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -215,6 +310,13 @@ int nxmutex_lock(FAR mutex_t *mutex)
   int ret;
 
   DEBUGASSERT(!nxmutex_is_hold(mutex));
+
+  if (nxmutex_spin(mutex))
+    {
+      mutex->holder = _SCHED_GETTID();
+      return OK;
+    }
+
   for (; ; )
     {
       /* Take the semaphore (perhaps waiting) */
@@ -68,6 +68,16 @@ typedef struct
   int        idx;
 } Elf_SymCache;
 
+/* Symbols resolved so far, shared by all relocation sections of a module
+ * so that every import is looked up only once.
+ */
+
+struct modlib_symlru_s
+{
+  dq_queue_t q;         /* Most recently used first */
+  int        count;     /* Number of entries in q */
+};
+
 struct
 {
   int stroff;           /* offset to string table */
@@ -161,6 +171,109 @@ static inline int modlib_readrelas(FAR struct mod_loadinfo_s *loadinfo,
                      relsec->sh_offset + offset);
 }
 
+/****************************************************************************
+ * Name: modlib_getsym
+ *
+ * Description:
+ *   Return the symbol table entry 'symidx' with its value resolved, reading
+ *   and resolving it only if it is not in the cache yet.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+static int modlib_getsym(FAR struct module_s *modp,
+                         FAR struct mod_loadinfo_s *loadinfo,
+                         FAR struct modlib_symlru_s *lru, int symidx,
+                         FAR Elf_Sym **psym)
+{
+  FAR Elf_SymCache *cache;
+  FAR dq_entry_t *e;
+  int ret;
+
+  /* First try the cache */
+
+  for (e = dq_peek(&lru->q); e; e = dq_next(e))
+    {
+      cache = (FAR Elf_SymCache *)e;
+      if (cache->idx == symidx)
+        {
+          dq_rem(&cache->entry, &lru->q);
+          dq_addfirst(&cache->entry, &lru->q);
+          *psym = &cache->sym;
+          return OK;
+        }
+    }
+
+  /* If the symbol was not found in the cache, we will need to read the
+   * symbol from the file.
+   */
+
+  if (lru->count < CONFIG_MODLIB_SYMBOL_CACHECOUNT)
+    {
+      cache = lib_malloc(sizeof(Elf_SymCache));
+      if (!cache)
+        {
+          berr("Failed to allocate memory for elf symbols\n");
+          return -ENOMEM;
+        }
+
+      lru->count++;
+    }
+  else
+    {
+      cache = (FAR Elf_SymCache *)dq_remlast(&lru->q);
+    }
+
+  /* Read the symbol table entry into memory */
+
+  ret = modlib_readsym(loadinfo, symidx, &cache->sym,
+                       &loadinfo->shdr[loadinfo->symtabidx]);
+  if (ret < 0)
+    {
+      berr("ERROR: Failed to read symbol[%d]: %d\n", symidx, ret);
+      goto errout;
+    }
+
+  /* Get the value of the symbol (in sym.st_value) */
+
+  ret = modlib_symvalue(modp, loadinfo, &cache->sym,
+                        loadinfo->shdr[loadinfo->strtabidx].sh_offset);
+  if (ret < 0)
+    {
+      /* The special error -ESRCH is returned only in one condition:
+       * The symbol has no name.
+       *
+       * There are a few relocations for a few architectures that do
+       * no depend upon a named symbol.  We don't know if that is the
+       * case here, but we will use a NULL symbol pointer to indicate
+       * that case to up_relocate().  That function can then do what
+       * is best.
+       */
+
+      if (ret != -ESRCH)
+        {
+          berr("ERROR: Failed to get value of symbol[%d]: %d\n",
+               symidx, ret);
+          goto errout;
+        }
+
+      berr("ERROR: Undefined symbol[%d] has no name: %d\n", symidx, ret);
+    }
+
+  cache->idx = symidx;
+  dq_addfirst(&cache->entry, &lru->q);
+  *psym = &cache->sym;
+  return OK;
+
+errout:
+  lib_free(cache);
+  lru->count--;
+  return ret;
+}
+
 /****************************************************************************
  * Name: modlib_relocate and modlib_relocateadd
  *
@@ -174,21 +287,18 @@ static inline int modlib_readrelas(FAR struct mod_loadinfo_s *loadinfo,
  ****************************************************************************/
 
 static int modlib_relocate(FAR struct module_s *modp,
-                           FAR struct mod_loadinfo_s *loadinfo, int relidx)
+                           FAR struct mod_loadinfo_s *loadinfo, int relidx,
+                           FAR struct modlib_symlru_s *lru)
 {
   FAR Elf_Shdr     *relsec = &loadinfo->shdr[relidx];
   FAR Elf_Shdr     *dstsec = &loadinfo->shdr[relsec->sh_info];
   FAR Elf_Rel      *rels;
   FAR Elf_Rel      *rel;
-  FAR Elf_SymCache *cache;
   FAR Elf_Sym      *sym;
-  FAR dq_entry_t   *e;
-  dq_queue_t        q;
   uintptr_t         addr;
   int               symidx;
   int               ret = OK;
   int               i;
-  int               j;
 
   /* Define potential architecture specific elf data container */
 
@@ -201,14 +311,12 @@ static int modlib_relocate(FAR struct module_s *modp,
       return -ENOMEM;
     }
 
-  dq_init(&q);
-
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
    */
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf_Rel); i++)
+  for (i = 0; i < relsec->sh_size / sizeof(Elf_Rel); i++)
     {
       /* Read the relocation entry into memory */
 
@@ -233,93 +341,13 @@ static int modlib_relocate(FAR struct module_s *modp,
 
       symidx = ELF_R_SYM(rel->r_info);
 
-      /* First try the cache */
-
-      sym = NULL;
-      for (e = dq_peek(&q); e; e = dq_next(e))
-        {
-          cache = (FAR Elf_SymCache *)e;
-          if (cache->idx == symidx)
-            {
-              dq_rem(&cache->entry, &q);
-              dq_addfirst(&cache->entry, &q);
-              sym = &cache->sym;
-              break;
-            }
-        }
-
-      /* If the symbol was not found in the cache, we will need to read the
-       * symbol from the file.
-       */
-
-      if (sym == NULL)
+      ret = modlib_getsym(modp, loadinfo, lru, symidx, &sym);
+      if (ret < 0)
         {
-          if (j < CONFIG_MODLIB_SYMBOL_CACHECOUNT)
-            {
-              cache = lib_malloc(sizeof(Elf_SymCache));
-              if (!cache)
-                {
-                  berr("Failed to allocate memory for elf symbols\n");
-                  ret = -ENOMEM;
-                  break;
-                }
-
-              j++;
-            }
-          else
-            {
-              cache = (FAR Elf_SymCache *)dq_remlast(&q);
-            }
-
-          sym = &cache->sym;
-
-          /* Read the symbol table entry into memory */
-
-          ret = modlib_readsym(loadinfo, symidx, sym,
-                               &loadinfo->shdr[loadinfo->symtabidx]);
-          if (ret < 0)
-            {
-              berr("ERROR: Section %d reloc %d: "
-                   "Failed to read symbol[%d]: %d\n",
-                   relidx, i, symidx, ret);
-              lib_free(cache);
-              break;
-            }
-
-          /* Get the value of the symbol (in sym.st_value) */
-
-          ret = modlib_symvalue(modp, loadinfo, sym,
-                           loadinfo->shdr[loadinfo->strtabidx].sh_offset);
-          if (ret < 0)
-            {
-              /* The special error -ESRCH is returned only in one condition:
-               * The symbol has no name.
-               *
-               * There are a few relocations for a few architectures that do
-               * no depend upon a named symbol.  We don't know if that is the
-               * case here, but we will use a NULL symbol pointer to indicate
-               * that case to up_relocate().  That function can then do what
-               * is best.
-               */
-
-              if (ret == -ESRCH)
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Undefined symbol[%d] has no name: %d\n",
-                       relidx, i, symidx, ret);
-                }
-              else
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Failed to get value of symbol[%d]: %d\n",
-                       relidx, i, symidx, ret);
-                  lib_free(cache);
-                  break;
-                }
-            }
-
-          cache->idx = symidx;
-          dq_addfirst(&cache->entry, &q);
+          berr("ERROR: Section %d reloc %d: "
+               "Failed to get symbol[%d]: %d\n",
+               relidx, i, symidx, ret);
+          break;
         }
 
       if (sym->st_shndx == SHN_UNDEF && sym->st_name == 0)
@@ -354,32 +382,24 @@ static int modlib_relocate(FAR struct module_s *modp,
     }
 
   lib_free(rels);
-  while ((e = dq_peek(&q)) != NULL)
-    {
-      dq_rem(e, &q);
-      lib_free(e);
-    }
 
   return ret;
 }
 
 static int modlib_relocateadd(FAR struct module_s *modp,
                               FAR struct mod_loadinfo_s *loadinfo,
-                              int relidx)
+                              int relidx,
+                              FAR struct modlib_symlru_s *lru)
 {
   FAR Elf_Shdr     *relsec = &loadinfo->shdr[relidx];
   FAR Elf_Shdr     *dstsec = &loadinfo->shdr[relsec->sh_info];
   FAR Elf_Rela     *relas;
   FAR Elf_Rela     *rela;
-  FAR Elf_SymCache *cache;
   FAR Elf_Sym      *sym;
-  FAR dq_entry_t   *e;
-  dq_queue_t        q;
   uintptr_t         addr;
   int               symidx;
   int               ret = OK;
   int               i;
-  int               j;
 
   /* Define potential architecture specific elf data container */
 
@@ -393,14 +413,12 @@ static int modlib_relocateadd(FAR struct module_s *modp,
       return -ENOMEM;
     }
 
-  dq_init(&q);
-
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
    */
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf_Rela); i++)
+  for (i = 0; i < relsec->sh_size / sizeof(Elf_Rela); i++)
     {
       /* Read the relocation entry into memory */
 
@@ -425,93 +443,13 @@ static int modlib_relocateadd(FAR struct module_s *modp,
 
       symidx = ELF_R_SYM(rela->r_info);
 
-      /* First try the cache */
-
-      sym = NULL;
-      for (e = dq_peek(&q); e; e = dq_next(e))
-        {
-          cache = (FAR Elf_SymCache *)e;
-          if (cache->idx == symidx)
-            {
-              dq_rem(&cache->entry, &q);
-              dq_addfirst(&cache->entry, &q);
-              sym = &cache->sym;
-              break;
-            }
-        }
-
-      /* If the symbol was not found in the cache, we will need to read the
-       * symbol from the file.
-       */
-
-      if (sym == NULL)
+      ret = modlib_getsym(modp, loadinfo, lru, symidx, &sym);
+      if (ret < 0)
         {
-          if (j < CONFIG_MODLIB_SYMBOL_CACHECOUNT)
-            {
-              cache = lib_malloc(sizeof(Elf_SymCache));
-              if (!cache)
-                {
-                  berr("Failed to allocate memory for elf symbols\n");
-                  ret = -ENOMEM;
-                  break;
-                }
-
-              j++;
-            }
-          else
-            {
-              cache = (FAR Elf_SymCache *)dq_remlast(&q);
-            }
-
-          sym = &cache->sym;
-
-          /* Read the symbol table entry into memory */
-
-          ret = modlib_readsym(loadinfo, symidx, sym,
-                               &loadinfo->shdr[loadinfo->symtabidx]);
-          if (ret < 0)
-            {
-              berr("ERROR: Section %d reloc %d: "
-                   "Failed to read symbol[%d]: %d\n",
-                   relidx, i, symidx, ret);
-              lib_free(cache);
-              break;
-            }
-
-          /* Get the value of the symbol (in sym.st_value) */
-
-          ret = modlib_symvalue(modp, loadinfo, sym,
-                           loadinfo->shdr[loadinfo->strtabidx].sh_offset);
-          if (ret < 0)
-            {
-              /* The special error -ESRCH is returned only in one condition:
-               * The symbol has no name.
-               *
-               * There are a few relocations for a few architectures that do
-               * no depend upon a named symbol.  We don't know if that is the
-               * case here, but we will use a NULL symbol pointer to indicate
-               * that case to up_relocate().  That function can then do what
-               * is best.
-               */
-
-              if (ret == -ESRCH)
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Undefined symbol[%d] has no name: %d\n",
-                       relidx, i, symidx, ret);
-                }
-              else
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Failed to get value of symbol[%d]: %d\n",
-                       relidx, i, symidx, ret);
-                  lib_free(cache);
-                  break;
-                }
-            }
-
-          cache->idx = symidx;
-          dq_addfirst(&cache->entry, &q);
+          berr("ERROR: Section %d reloc %d: "
+               "Failed to get symbol[%d]: %d\n",
+               relidx, i, symidx, ret);
+          break;
         }
 
       if (sym->st_shndx == SHN_UNDEF && sym->st_name == 0)
@@ -546,11 +484,6 @@ static int modlib_relocateadd(FAR struct module_s *modp,
     }
 
   lib_free(relas);
-  while ((e = dq_peek(&q)) != NULL)
-    {
-      dq_rem(e, &q);
-      lib_free(e);
-    }
 
   return ret;
 }
@@ -867,6 +800,8 @@ static int modlib_relocatedyn(FAR struct module_s *modp,
 int modlib_bind(FAR struct module_s *modp,
                 FAR struct mod_loadinfo_s *loadinfo)
 {
+  struct modlib_symlru_s lru;
+  FAR dq_entry_t *e;
   int ret;
   int i;
 
@@ -880,6 +815,9 @@ int modlib_bind(FAR struct module_s *modp,
 
   /* Process relocations in every allocated section */
 
+  dq_init(&lru.q);
+  lru.count = 0;
+
   for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
     {
       /* Get the index to the relocation section */
@@ -942,10 +880,10 @@ int modlib_bind(FAR struct module_s *modp,
           switch (loadinfo->shdr[i].sh_type)
             {
               case SHT_REL:
-                ret = modlib_relocate(modp, loadinfo, i);
+                ret = modlib_relocate(modp, loadinfo, i, &lru);
                 break;
               case SHT_RELA:
-                ret = modlib_relocateadd(modp, loadinfo, i);
+                ret = modlib_relocateadd(modp, loadinfo, i, &lru);
                 break;
             }
         }
@@ -956,6 +894,11 @@ int modlib_bind(FAR struct module_s *modp,
         }
     }
 
+  while ((e = dq_remfirst(&lru.q)) != NULL)
+    {
+      lib_free(e);
+    }
+
   /* Ensure that the I and D caches are coherent before starting the newly
    * loaded module by cleaning the D cache (i.e., flushing the D cache
    * contents to memory and invalidating the I cache).
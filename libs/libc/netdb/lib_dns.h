@@ -76,6 +76,14 @@
 #  define CONFIG_NETDB_DNSCLIENT_LIFESEC 3600
 #endif
 
+#ifndef CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC
+#  define CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC 60
+#endif
+
+#ifndef CONFIG_NETDB_DNSCLIENT_RESOLUTION_DELAY
+#  define CONFIG_NETDB_DNSCLIENT_RESOLUTION_DELAY 50
+#endif
+
 #ifndef CONFIG_NETDB_RESOLVCONF_PATH
 #  define CONFIG_NETDB_RESOLVCONF_PATH "/etc/resolv.conf"
 #endif
@@ -193,8 +201,9 @@ int dns_bind(sa_family_t family);
  * Name: dns_query
  *
  * Description:
- *   Using the DNS resolver socket (sd), look up the 'hostname', and
- *   return its IP address in 'ipaddr'
+ *   Look up the 'hostname', and return its IP addresses in 'addr'.  The
+ *   AAAA and A queries are sent together to all of the name servers, the
+ *   first answer of each type is used.
  *
  * Input Parameters:
  *   hostname - The hostname string to be resolved.
@@ -205,7 +214,8 @@ int dns_bind(sa_family_t family);
  *     the returned addresses.
  *
  * Returned Value:
- *   Returns zero (OK) if the query was successful.
+ *   Returns zero (OK) if the query was successful, -ENXIO if the name does
+ *   not exist.
  *
  ****************************************************************************/
 
@@ -238,7 +248,8 @@ bool dns_is_queryfamily(sa_family_t family);
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses, zero if the name does not
+ *              exist.
  *   ttl      - The TTL of the IP addresses.
  *
  * Returned Value:
@@ -284,8 +295,9 @@ void dns_clear_answer(void);
  * Returned Value:
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
- *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   value will be returned: -ENOENT meaning that the hostname was not
+ *   found in the cache, -ENXIO that the cache knows that the hostname
+ *   does not exist.
  *
  ****************************************************************************/
 
@@ -36,11 +36,24 @@
 
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The hash chains link the entries by index + 1, zero ends a chain */
+
+#define DNS_CACHE_NBUCKETS CONFIG_NETDB_DNSCLIENT_ENTRIES
+
+/* Upper bound of the TTLs, as recommended by RFC 8767 */
+
+#define DNS_CACHE_MAXTTL   (7 * 24 * 3600)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* This described one entry in the cache of resolved hostnames.
+/* This described one entry in the cache of resolved hostnames.  An entry
+ * without addresses records a name that does not exist.
  *
  * REVISIT: this consumes extra space, especially when multiple
  * addresses per name are stored.
@@ -48,23 +61,25 @@
 
 struct dns_cache_s
 {
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  time_t            ctime;      /* Creation time */
-#endif
-  char              name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
+  time_t            expire;     /* Expiration time */
+  uint32_t          hash;       /* Hash of the name */
+  uint32_t          age;        /* Time of the last use */
+  uint8_t           next;       /* Next entry of the hash chain */
   uint8_t           naddr;      /* How many addresses per name */
+  char              name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
   union dns_addr_u  addr[CONFIG_NETDB_MAX_IPADDR];
-  uint32_t          ttl;
 };
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static uint8_t g_dns_head;        /* Head of the circular, DNS resolver cache */
-static uint8_t g_dns_tail;        /* Tail of the circular, DNS resolver cache */
+static uint8_t g_dns_bucket[DNS_CACHE_NBUCKETS];
+static uint32_t g_dns_age;
 
-/* This is the DNS resolver cache */
+/* This is the DNS resolver cache, an entry is unused if its name is
+ * empty.
+ */
 
 static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
 
@@ -72,6 +87,95 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: dns_cache_now
+ ****************************************************************************/
+
+static time_t dns_cache_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec;
+}
+
+/****************************************************************************
+ * Name: dns_cache_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash of a hostname.
+ *
+ ****************************************************************************/
+
+static uint32_t dns_cache_hash(FAR const char *hostname)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*hostname != '\0')
+    {
+      hash = (hash ^ (uint8_t)*hostname++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: dns_cache_unlink
+ *
+ * Description:
+ *   Remove an entry from its hash chain and mark it unused.
+ *
+ ****************************************************************************/
+
+static void dns_cache_unlink(FAR struct dns_cache_s *entry)
+{
+  FAR uint8_t *link = &g_dns_bucket[entry->hash % DNS_CACHE_NBUCKETS];
+  int ndx = entry - g_dns_cache;
+
+  while (*link != ndx + 1)
+    {
+      DEBUGASSERT(*link != 0);
+      link = &g_dns_cache[*link - 1].next;
+    }
+
+  *link          = entry->next;
+  entry->name[0] = '\0';
+}
+
+/****************************************************************************
+ * Name: dns_cache_lookup
+ *
+ * Description:
+ *   Return the entry of a hostname, dropping the expired entries met on the
+ *   way, or NULL if the name is not in the cache.
+ *
+ ****************************************************************************/
+
+static FAR struct dns_cache_s *dns_cache_lookup(FAR const char *hostname,
+                                                uint32_t hash, time_t now)
+{
+  FAR struct dns_cache_s *entry;
+  int ndx;
+  int next;
+
+  for (ndx = g_dns_bucket[hash % DNS_CACHE_NBUCKETS]; ndx != 0; ndx = next)
+    {
+      entry = &g_dns_cache[ndx - 1];
+      next  = entry->next;
+
+      if (now >= entry->expire)
+        {
+          dns_cache_unlink(entry);
+        }
+      else if (entry->hash == hash && strcmp(entry->name, hostname) == 0)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -85,7 +189,8 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses, zero if the name does not
+ *              exist.
  *   ttl      - The TTL of the IP addresses.
  *
  * Returned Value:
@@ -97,63 +202,87 @@ void dns_save_answer(FAR const char *hostname,
                      FAR const union dns_addr_u *addr, int naddr,
                      uint32_t ttl)
 {
+  FAR struct dns_cache_s *victim = NULL;
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-#endif
-  int next;
-  int ndx;
+  FAR uint8_t *bucket;
+  uint32_t hash;
+  time_t now;
+  int i;
 
   naddr = MIN(naddr, CONFIG_NETDB_MAX_IPADDR);
-  DEBUGASSERT(naddr >= 1 && naddr <= UCHAR_MAX);
+  DEBUGASSERT(naddr >= 0 && naddr <= UCHAR_MAX);
 
-  /* Get exclusive access to the DNS cache */
+  /* A truncated name would alias the names with the same prefix */
 
-  dns_lock();
+  if (strlen(hostname) >= CONFIG_NETDB_DNSCLIENT_NAMESIZE)
+    {
+      return;
+    }
 
-  /* Get the index to the new head of the list */
+  if (naddr == 0)
+    {
+      ttl = MIN(ttl, CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC);
+    }
+  else
+    {
+#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
+      ttl = MIN(ttl, CONFIG_NETDB_DNSCLIENT_LIFESEC);
+#endif
+      ttl = MIN(ttl, DNS_CACHE_MAXTTL);
+    }
 
-  ndx  = g_dns_head;
-  next = ndx + 1;
-  if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+  if (ttl == 0)
     {
-      next = 0;
+      return;
     }
 
-  /* If the next head pointer would match the tail index, then increment
-   * the tail index, discarding the oldest mapping in the cache.
-   */
+  hash = dns_cache_hash(hostname);
+  now  = dns_cache_now();
+
+  /* Get exclusive access to the DNS cache */
+
+  dns_lock();
 
-  if (next == g_dns_tail)
+  entry = dns_cache_lookup(hostname, hash, now);
+  if (entry == NULL)
     {
-      int tmp = g_dns_tail + 1;
-      if (tmp >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+      /* Take an unused entry, else the least recently used one */
+
+      for (i = 0; i < CONFIG_NETDB_DNSCLIENT_ENTRIES; i++)
+        {
+          entry = &g_dns_cache[i];
+          if (entry->name[0] == '\0')
+            {
+              victim = entry;
+              break;
+            }
+
+          if (victim == NULL || (int32_t)(entry->age - victim->age) < 0)
+            {
+              victim = entry;
+            }
+        }
+
+      entry = victim;
+      if (entry->name[0] != '\0')
         {
-          tmp = 0;
+          dns_cache_unlink(entry);
         }
 
-      g_dns_tail = tmp;
+      bucket      = &g_dns_bucket[hash % DNS_CACHE_NBUCKETS];
+      entry->next = *bucket;
+      *bucket     = entry - g_dns_cache + 1;
+      entry->hash = hash;
+      strlcpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
     }
 
   /* Save the answer in the cache */
 
-  entry = &g_dns_cache[ndx];
-
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time */
-
-  clock_gettime(CLOCK_MONOTONIC, &now);
-  entry->ctime = (time_t)now.tv_sec;
-#endif
-
-  strlcpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
   memcpy(&entry->addr, addr, naddr * sizeof(*addr));
-  entry->naddr = naddr;
-  entry->ttl = ttl;
+  entry->naddr  = naddr;
+  entry->expire = now + ttl;
+  entry->age    = ++g_dns_age;
 
-  /* Save the updated head index */
-
-  g_dns_head = next;
   dns_unlock();
 }
 
@@ -170,14 +299,17 @@ void dns_save_answer(FAR const char *hostname,
 
 void dns_clear_answer(void)
 {
+  int i;
+
   /* Get exclusive access to the DNS cache */
 
   dns_lock();
 
-  /* Reset the circular of DNS cache */
-
-  g_dns_head = 0;
-  g_dns_tail = 0;
+  memset(g_dns_bucket, 0, sizeof(g_dns_bucket));
+  for (i = 0; i < CONFIG_NETDB_DNSCLIENT_ENTRIES; i++)
+    {
+      g_dns_cache[i].name[0] = '\0';
+    }
 
   dns_unlock();
 }
@@ -199,8 +331,9 @@ void dns_clear_answer(void)
  * Returned Value:
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
- *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   value will be returned: -ENOENT meaning that the hostname was not
+ *   found in the cache, -ENXIO that the cache knows that the hostname
+ *   does not exist.
  *
  ****************************************************************************/
 
@@ -208,86 +341,37 @@ int dns_find_answer(FAR const char *hostname, FAR union dns_addr_u *addr,
                     FAR int *naddr)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-  uint32_t elapsed;
-  int ret;
-#endif
-  int next;
-  int ndx;
+  uint32_t hash;
+  time_t now;
+  int ret = -ENOENT;
+
+  hash = dns_cache_hash(hostname);
+  now  = dns_cache_now();
 
   /* Get exclusive access to the DNS cache */
 
   dns_lock();
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time */
-
-  ret = clock_gettime(CLOCK_MONOTONIC, &now);
-#endif
-
-  for (ndx = g_dns_tail; ndx != g_dns_head; ndx = next)
+  entry = dns_cache_lookup(hostname, hash, now);
+  if (entry != NULL && entry->naddr == 0)
     {
-      entry = &g_dns_cache[ndx];
-
-      /* Advance the index for the next time through the loop, handling
-       * wrapping to the beginning of the circular buffer.
-       */
-
-      next = ndx + 1;
-      if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
-        {
-          next = 0;
-        }
-
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-      /* Check if this entry has expired
-       * REVISIT: Does not this calculation assume that the sizeof(time_t)
-       * is equal to the sizeof(uint32_t)?
+      ret = -ENXIO;
+    }
+  else if (entry != NULL)
+    {
+      /* Make sure that the address will fit in the caller-provided
+       * buffer.
        */
 
-      elapsed = (uint32_t)now.tv_sec - (uint32_t)entry->ctime;
-      if (ret >= 0 &&
-          (elapsed > CONFIG_NETDB_DNSCLIENT_LIFESEC || elapsed > entry->ttl))
-        {
-          /* This entry has expired.  Increment the tail index to exclude
-           * this entry on future traversals.
-           */
+      *naddr = MIN(*naddr, entry->naddr);
 
-          g_dns_tail = next;
-        }
-      else
-#endif
-        {
-          /* The entry has not expired, check for a name match. Because
-           * the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
-           * this has the possibility of aliasing two names and returning
-           * the wrong entry from the cache.
-           */
-
-          if (strncmp(hostname, entry->name,
-                      CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
-            {
-              /* We have a match.  Return the resolved host address */
-
-              /* Make sure that the address will fit in the caller-provided
-               * buffer.
-               */
-
-              *naddr = MIN(*naddr, entry->naddr);
-
-              /* Return the address information */
+      /* Return the address information */
 
-              memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
-
-              dns_unlock();
-              return OK;
-            }
-        }
+      memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
+      entry->age = ++g_dns_age;
+      ret = OK;
     }
 
-  ret = -ENOENT;
-
   dns_unlock();
   return ret;
 }
@@ -48,8 +48,10 @@
 
 #include <nuttx/config.h>
 
+#include <inttypes.h>
 #include <string.h>
 #include <time.h>
+#include <poll.h>
 #include <unistd.h>
 #include <errno.h>
 #include <debug.h>
@@ -63,6 +65,7 @@
 #include <nuttx/net/dns.h>
 
 #include "netdb/lib_dns.h"
+#include "netdb/lib_netdb.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -83,19 +86,17 @@
 #define RECV_BUFFER_SIZE  CONFIG_NETDB_DNSCLIENT_MAXRESPONSE
 #define QUERY_BUFFER_SIZE MAX(SEND_BUFFER_SIZE, RECV_BUFFER_SIZE)
 
+/* The AAAA and A queries are sent together, over one socket per address
+ * family of the name servers.
+ */
+
+#define DNS_QUERY_NTYPES    2
+#define DNS_QUERY_NSOCKETS  2
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-struct dns_query_s
-{
-  int result;                     /* Explanation of the failure */
-  FAR const char *hostname;       /* Hostname to lookup */
-  FAR union dns_addr_u *addr;     /* Location to return host address */
-  FAR int *naddr;                 /* Number of returned addresses */
-  uint32_t ttl;                   /* Time to Live, unit:s */
-};
-
 /* Query info to check response against. */
 
 struct dns_query_info_s
@@ -107,10 +108,27 @@ struct dns_query_info_s
                                                     * encoded format + NUL */
 };
 
-struct dns_query_data_s
+/* The state of the query of one record type */
+
+struct dns_query_type_s
 {
-  struct dns_query_s query;
   struct dns_query_info_s qinfo;
+  int maxaddr;                    /* Number of addresses kept */
+  int result;                     /* Number of addresses or errno */
+  int nerrors;                    /* Name servers that failed */
+  bool done;                      /* An answer was received */
+  uint32_t ttl;                   /* Time to Live, unit:s */
+  union dns_addr_u addr[CONFIG_NETDB_MAX_IPADDR];
+};
+
+struct dns_query_data_s
+{
+  FAR const char *hostname;       /* Hostname to lookup */
+  int ntypes;                     /* Number of record types queried */
+  int nservers;                   /* Number of name servers */
+  int sd[DNS_QUERY_NSOCKETS];     /* IPv4 and IPv6 sockets, or -1 */
+  struct dns_query_type_s type[DNS_QUERY_NTYPES];
+  union dns_addr_u servers[CONFIG_NETDB_DNSSERVER_NAMESERVERS];
   uint8_t buffer[QUERY_BUFFER_SIZE]; /* Buffer to hold request & response */
 };
 
@@ -197,18 +215,33 @@ static inline uint16_t dns_alloc_id(void)
 }
 
 /****************************************************************************
- * Name: dns_send_query
+ * Name: dns_gettime
  *
  * Description:
- *   Runs through the list of names to see if there are any that have
- *   not yet been queried and, if so, sends out a query.
+ *   Return the time of the monotonic clock in milliseconds.
  *
  ****************************************************************************/
 
-static int dns_send_query(int sd, FAR const char *name,
-                          FAR union dns_addr_u *uaddr, uint16_t rectype,
-                          FAR struct dns_query_info_s *qinfo,
-                          FAR uint8_t *buffer)
+static uint32_t dns_gettime(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/****************************************************************************
+ * Name: dns_encode_query
+ *
+ * Description:
+ *   Build the query of one record type in 'buffer' and return its length.
+ *
+ ****************************************************************************/
+
+static int dns_encode_query(FAR const char *name, uint16_t id,
+                            uint16_t rectype,
+                            FAR struct dns_query_info_s *qinfo,
+                            FAR uint8_t *buffer)
 {
   FAR struct dns_header_s *hdr;
   FAR uint8_t *dest;
@@ -216,16 +249,9 @@ static int dns_send_query(int sd, FAR const char *name,
   FAR char *qname;
   FAR char *qptr;
   FAR const char *src;
-  uint16_t id;
-  socklen_t addrlen;
-  int ret;
   int len;
   int n;
 
-  /* Get a new ID for query */
-
-  id = dns_alloc_id();
-
   /* Initialize the request header */
 
   hdr               = (FAR struct dns_header_s *)buffer;
@@ -293,51 +319,26 @@ static int dns_send_query(int sd, FAR const char *name,
   qinfo->rectype = HTONS(rectype);
   qinfo->id      = hdr->id;
 
-  /* Send the request */
-
-  if (uaddr->addr.sa_family == AF_INET)
-    {
-      addrlen = sizeof(struct sockaddr_in);
-    }
-  else
-    {
-      addrlen = sizeof(struct sockaddr_in6);
-    }
-
-  ret = connect(sd, &uaddr->addr, addrlen);
-  if (ret < 0)
-    {
-      ret = -get_errno();
-      nerr("ERROR: connect failed: %d\n", ret);
-      return ret;
-    }
-
-  ret = send(sd, buffer, dest - buffer, 0);
-  if (ret < 0)
-    {
-      ret = -get_errno();
-      nerr("ERROR: sendto failed: %d\n", ret);
-      return ret;
-    }
-
-  return OK;
+  return dest - buffer;
 }
 
 /****************************************************************************
- * Name: dns_recv_response
+ * Name: dns_parse_response
  *
  * Description:
- *   Called when new UDP data arrives
+ *   Parse the response to one of the queries.
  *
  * Returned Value:
  *   Returns number of valid IP address responses.  Negated errno value is
- *   returned in all other cases.
+ *   returned in all other cases: -ENXIO if the name does not exist,
+ *   -EADDRNOTAVAIL if it has no address of the queried type.
  *
  ****************************************************************************/
 
-static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
-                             FAR struct dns_query_info_s *qinfo,
-                             FAR uint32_t *ttl, FAR uint8_t *buffer)
+static int dns_parse_response(FAR uint8_t *buffer, int buflen,
+                              FAR union dns_addr_u *addr, int naddr,
+                              FAR struct dns_query_info_s *qinfo,
+                              FAR uint32_t *ttl)
 {
   FAR uint8_t *nameptr;
   FAR uint8_t *namestart;
@@ -348,6 +349,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
   uint16_t nquestions;
   uint16_t nanswers;
   uint16_t temp;
+  uint32_t anttl;
   int naddr_read;
   int ret;
 
@@ -356,26 +358,8 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
       return -ERANGE;
     }
 
-  /* Receive the response */
-
-  ret = recv(sd, buffer, RECV_BUFFER_SIZE, 0);
-  if (ret < 0)
-    {
-      ret = -get_errno();
-      nerr("ERROR: recv failed: %d\n", ret);
-      return ret;
-    }
-
-  if (ret < sizeof(*hdr))
-    {
-      /* DNS header can't fit in received data */
-
-      nerr("ERROR: DNS response is too short\n");
-      return -EILSEQ;
-    }
-
   hdr         = (FAR struct dns_header_s *)buffer;
-  endofbuffer = buffer + ret;
+  endofbuffer = buffer + buflen;
 
   ninfo("ID %d\n", NTOHS(hdr->id));
   ninfo("Query %d\n", hdr->flags1 & DNS_FLAG1_RESPONSE);
@@ -386,19 +370,15 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
 
   /* Check for error */
 
-  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
+  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) == DNS_FLAG2_ERR_NAME)
     {
-      nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
-      return -EPROTO;
+      ninfo("DNS reported that the name does not exist\n");
+      return -ENXIO;
     }
-
-  /* Check for matching ID. */
-
-  if (hdr->id != qinfo->id)
+  else if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
     {
-      nerr("ERROR: DNS wrong response ID (expected %d, got %d)\n",
-           NTOHS(qinfo->id), NTOHS(hdr->id));
-      return -EBADMSG;
+      nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
+      return -EPROTO;
     }
 
   /* We only care about the question(s) and the answers. The authrr
@@ -478,19 +458,16 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
           break;
         }
 
-      ans = (FAR struct dns_answer_s *)nameptr;
+      ans   = (FAR struct dns_answer_s *)nameptr;
+      anttl = (NTOHS(ans->ttl[0]) << 16) | NTOHS(ans->ttl[1]);
 
-      ninfo("Answer: type=%04x, class=%04x, ttl=%06x, length=%04x\n",
-            NTOHS(ans->type), NTOHS(ans->class),
-            (NTOHS(ans->ttl[0]) << 16) | NTOHS(ans->ttl[1]),
-            NTOHS(ans->len));
-      if (ttl)
-        {
-          *ttl = (NTOHS(ans->ttl[0]) << 16) | NTOHS(ans->ttl[1]);
-        }
+      ninfo("Answer: type=%04x, class=%04x, ttl=%06" PRIx32
+            ", length=%04x\n",
+            NTOHS(ans->type), NTOHS(ans->class), anttl, NTOHS(ans->len));
 
       /* Check for IPv4/6 address type and Internet class. Others are
-       * discarded.
+       * discarded.  The addresses are valid as long as the record with
+       * the smallest TTL.
        */
 
 #ifdef CONFIG_NET_IPv4
@@ -514,6 +491,11 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
           inaddr->sin_port        = 0;
           inaddr->sin_addr.s_addr = ans->u.ipv4.s_addr;
 
+          if (naddr_read == 0 || anttl < *ttl)
+            {
+              *ttl = anttl;
+            }
+
           if (++naddr_read >= naddr)
             {
               ret = -ERANGE;
@@ -547,6 +529,11 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
           inaddr->sin6_port       = 0;
           memcpy(inaddr->sin6_addr.s6_addr, ans->u.ipv6.s6_addr, 16);
 
+          if (naddr_read == 0 || anttl < *ttl)
+            {
+              *ttl = anttl;
+            }
+
           if (++naddr_read >= naddr)
             {
               ret = -ERANGE;
@@ -608,157 +595,332 @@ static void dns_query_error(FAR const char *prompt, int ret,
 }
 
 /****************************************************************************
- * Name: dns_query_callback
+ * Name: dns_server_callback
  *
  * Description:
- *   Using the DNS information and this DNS server address, look up the
- *   hostname.
- *
- * Input Parameters:
- *   arg      - Query arguments
- *   addr     - DNS name server address
- *   addrlen  - Length of the DNS name server address.
+ *   Add a name server to the servers queried.
  *
  * Returned Value:
- *   Returns one (1) if the query was successful.  Zero is returned in all
- *   other cases.  The result field of the query structure is set to a
- *   negated errno value indicate the reason for the last failure (only).
+ *   Zero (OK) to continue the traversal, one (1) when there is no room for
+ *   more servers.
  *
  ****************************************************************************/
 
-static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
-                              FAR socklen_t addrlen)
+static int dns_server_callback(FAR void *arg, FAR struct sockaddr *addr,
+                               FAR socklen_t addrlen)
 {
   FAR struct dns_query_data_s *qdata = arg;
-  FAR struct dns_query_s      *query = &qdata->query;
-  int next = 0;
-  int retries;
-  int ret;
-  int sd;
 
-  /* Loop while receive timeout errors occur and there are remaining
-   * retries.
-   */
+  memcpy(&qdata->servers[qdata->nservers], addr, addrlen);
+  if (++qdata->nservers >= CONFIG_NETDB_DNSSERVER_NAMESERVERS)
+    {
+      return 1;
+    }
 
-  for (retries = 0; retries < CONFIG_NETDB_DNSCLIENT_RETRIES; retries++)
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dns_server_socket
+ *
+ * Description:
+ *   Return the socket used for the name servers of an address family.
+ *
+ ****************************************************************************/
+
+static int dns_server_socket(FAR struct dns_query_data_s *qdata,
+                             sa_family_t family)
+{
+  int ndx = family == AF_INET ? 0 : 1;
+
+  if (qdata->sd[ndx] < 0)
     {
+      qdata->sd[ndx] = dns_bind(family);
+    }
+
+  return qdata->sd[ndx];
+}
+
+/****************************************************************************
+ * Name: dns_server_match
+ *
+ * Description:
+ *   Check if a response comes from one of the name servers.
+ *
+ ****************************************************************************/
+
+static bool dns_server_match(FAR struct dns_query_data_s *qdata,
+                             FAR const union dns_addr_u *from)
+{
+  FAR const union dns_addr_u *server;
+  int i;
+
+  for (i = 0; i < qdata->nservers; i++)
+    {
+      server = &qdata->servers[i];
+
+#ifdef CONFIG_NET_IPv4
+      if (from->addr.sa_family == AF_INET &&
+          server->addr.sa_family == AF_INET &&
+          from->ipv4.sin_port == server->ipv4.sin_port &&
+          from->ipv4.sin_addr.s_addr == server->ipv4.sin_addr.s_addr)
+        {
+          return true;
+        }
+#endif
+
 #ifdef CONFIG_NET_IPv6
-      if (dns_is_queryfamily(AF_INET6))
+      if (from->addr.sa_family == AF_INET6 &&
+          server->addr.sa_family == AF_INET6 &&
+          from->ipv6.sin6_port == server->ipv6.sin6_port &&
+          memcmp(&from->ipv6.sin6_addr, &server->ipv6.sin6_addr,
+                 sizeof(struct in6_addr)) == 0)
         {
-          /* Send the IPv6 query */
+          return true;
+        }
+#endif
+    }
 
-          sd = dns_bind(addr->sa_family);
-          if (sd < 0)
-            {
-              query->result = sd;
-              return 0;
-            }
+  return false;
+}
 
-          ret = dns_send_query(sd, query->hostname,
-                               (FAR union dns_addr_u *)addr,
-                               DNS_RECTYPE_AAAA, &qdata->qinfo,
-                               qdata->buffer);
-          if (ret < 0)
-            {
-              dns_query_error("ERROR: IPv6 dns_send_query failed",
-                              ret, (FAR union dns_addr_u *)addr);
-              query->result = ret;
-            }
-          else
-            {
-              /* Obtain the IPv6 response */
+/****************************************************************************
+ * Name: dns_send_queries
+ *
+ * Description:
+ *   Send the queries without an answer yet to all of the name servers.
+ *
+ * Returned Value:
+ *   The number of queries sent.
+ *
+ ****************************************************************************/
 
-              ret = dns_recv_response(sd, &query->addr[next],
-                                      CONFIG_NETDB_MAX_IPv6ADDR,
-                                      &qdata->qinfo,
-                                      &query->ttl, qdata->buffer);
-              if (ret >= 0)
-                {
-                  next += ret;
-                }
-              else
-                {
-                  dns_query_error("ERROR: IPv6 dns_recv_response failed",
-                                  ret, (FAR union dns_addr_u *)addr);
-                  query->result = ret;
-                }
-            }
+static int dns_send_queries(FAR struct dns_query_data_s *qdata)
+{
+  FAR struct dns_query_type_s *type;
+  FAR union dns_addr_u *server;
+  socklen_t addrlen;
+  int nsent = 0;
+  int len;
+  int ret;
+  int sd;
+  int i;
+  int j;
 
-          close(sd);
+  for (i = 0; i < qdata->ntypes; i++)
+    {
+      type = &qdata->type[i];
+      if (type->done)
+        {
+          continue;
         }
-#endif
 
-#ifdef CONFIG_NET_IPv4
-      if (dns_is_queryfamily(AF_INET))
+      type->nerrors = 0;
+      len = dns_encode_query(qdata->hostname, NTOHS(type->qinfo.id),
+                             NTOHS(type->qinfo.rectype), &type->qinfo,
+                             qdata->buffer);
+
+      for (j = 0; j < qdata->nservers; j++)
         {
-          /* Send the IPv4 query */
+          server = &qdata->servers[j];
+          if (server->addr.sa_family == AF_INET)
+            {
+              addrlen = sizeof(struct sockaddr_in);
+            }
+          else
+            {
+              addrlen = sizeof(struct sockaddr_in6);
+            }
 
-          sd = dns_bind(addr->sa_family);
-          if (sd < 0)
+          sd  = dns_server_socket(qdata, server->addr.sa_family);
+          ret = sd;
+          if (sd >= 0)
             {
-              query->result = sd;
-              return 0;
+              ret = sendto(sd, qdata->buffer, len, 0, &server->addr,
+                           addrlen);
+              if (ret < 0)
+                {
+                  ret = -get_errno();
+                }
             }
 
-          ret = dns_send_query(sd, query->hostname,
-                               (FAR union dns_addr_u *)addr,
-                               DNS_RECTYPE_A, &qdata->qinfo, qdata->buffer);
           if (ret < 0)
             {
-              dns_query_error("ERROR: IPv4 dns_send_query failed",
-                              ret, (FAR union dns_addr_u *)addr);
-              query->result = ret;
+              dns_query_error("ERROR: dns_send_queries failed",
+                              ret, server);
+              type->result = ret;
+              type->nerrors++;
             }
           else
             {
-              /* Obtain the IPv4 response */
+              nsent++;
+            }
+        }
 
-              if (next >= *query->naddr)
-                {
-                  next = *query->naddr / 2;
-                }
+      if (type->nerrors >= qdata->nservers)
+        {
+          type->done = true;
+        }
+    }
 
-              ret = dns_recv_response(sd, &query->addr[next],
-                                      CONFIG_NETDB_MAX_IPv4ADDR,
-                                      &qdata->qinfo,
-                                      &query->ttl, qdata->buffer);
-              if (ret >= 0)
-                {
-                  next += ret;
-                }
-              else
-                {
-                  dns_query_error("ERROR: IPv4 dns_recv_response failed",
-                                  ret, (FAR union dns_addr_u *)addr);
-                  query->result = ret;
-                }
-            }
+  return nsent;
+}
 
-          close(sd);
+/****************************************************************************
+ * Name: dns_recv_response
+ *
+ * Description:
+ *   Receive a response from a socket and account for it in the query of
+ *   its record type.  The first answer wins: the name servers answering
+ *   late are ignored, as the ones failing while another can still answer.
+ *
+ ****************************************************************************/
+
+static void dns_recv_response(FAR struct dns_query_data_s *qdata, int sd)
+{
+  FAR struct dns_query_type_s *type;
+  FAR struct dns_header_s *hdr;
+  union dns_addr_u from;
+  socklen_t fromlen = sizeof(from);
+  int ret;
+  int i;
+
+  ret = recvfrom(sd, qdata->buffer, RECV_BUFFER_SIZE, 0, &from.addr,
+                 &fromlen);
+  if (ret < 0)
+    {
+      nerr("ERROR: recv failed: %d\n", -get_errno());
+      return;
+    }
+
+  if (ret < sizeof(*hdr) || !dns_server_match(qdata, &from))
+    {
+      nerr("ERROR: DNS response is too short or from an unknown server\n");
+      return;
+    }
+
+  hdr = (FAR struct dns_header_s *)qdata->buffer;
+  for (i = 0; i < qdata->ntypes; i++)
+    {
+      type = &qdata->type[i];
+      if (hdr->id == type->qinfo.id)
+        {
+          break;
         }
-#endif /* CONFIG_NET_IPv4 */
+    }
 
-      if (next > 0)
+  if (i >= qdata->ntypes || type->done)
+    {
+      ninfo("Ignore the response with ID %d\n", NTOHS(hdr->id));
+      return;
+    }
+
+  ret = dns_parse_response(qdata->buffer, ret, type->addr, type->maxaddr,
+                           &type->qinfo, &type->ttl);
+  if (ret < 0 && ret != -ENXIO && ret != -EADDRNOTAVAIL)
+    {
+      dns_query_error("ERROR: dns_parse_response failed", ret, &from);
+      type->result = ret;
+      if (++type->nerrors < qdata->nservers)
         {
-#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-          /* Save the answer in the DNS cache */
+          return;
+        }
+    }
 
-          dns_save_answer(query->hostname, query->addr, next, query->ttl);
-#endif
-          /* Return 1 to indicate to (1) stop the traversal, and (2)
-           * indicate that the address was found.
-           */
+  type->result = ret;
+  type->done   = true;
+}
+
+/****************************************************************************
+ * Name: dns_recv_responses
+ *
+ * Description:
+ *   Wait for the answers to all of the queries sent.  Once one record type
+ *   got addresses, the other ones are waited for during the resolution
+ *   delay only, so that a name server not answering to AAAA queries does
+ *   not delay the answer.
+ *
+ * Returned Value:
+ *   True if addresses were received.
+ *
+ ****************************************************************************/
+
+static bool dns_recv_responses(FAR struct dns_query_data_s *qdata)
+{
+  struct pollfd fds[DNS_QUERY_NSOCKETS];
+  uint32_t deadline;
+  uint32_t now;
+  int timeout;
+  bool found;
+  bool done;
+  int nfds = 0;
+  int ret;
+  int i;
+
+  for (i = 0; i < DNS_QUERY_NSOCKETS; i++)
+    {
+      if (qdata->sd[i] >= 0)
+        {
+          fds[nfds].fd     = qdata->sd[i];
+          fds[nfds].events = POLLIN;
+          nfds++;
+        }
+    }
+
+  deadline = dns_gettime() + CONFIG_NETDB_DNSCLIENT_RECV_TIMEOUT * 1000;
+
+  for (; ; )
+    {
+      found = false;
+      done  = true;
+
+      for (i = 0; i < qdata->ntypes; i++)
+        {
+          found |= qdata->type[i].done && qdata->type[i].result > 0;
+          done  &= qdata->type[i].done;
+        }
+
+      if (done)
+        {
+          break;
+        }
+
+      now     = dns_gettime();
+      timeout = (int32_t)(deadline - now);
+      if (found && timeout > CONFIG_NETDB_DNSCLIENT_RESOLUTION_DELAY)
+        {
+          deadline = now + CONFIG_NETDB_DNSCLIENT_RESOLUTION_DELAY;
+          timeout  = CONFIG_NETDB_DNSCLIENT_RESOLUTION_DELAY;
+        }
 
-          *query->naddr = next;
-          return 1;
+      if (timeout <= 0)
+        {
+          break;
         }
-      else if (query->result != -EAGAIN)
+
+      ret = poll(fds, nfds, timeout);
+      if (ret < 0)
         {
+          ret = -get_errno();
+          if (ret == -EINTR)
+            {
+              continue;
+            }
+
+          nerr("ERROR: poll failed: %d\n", ret);
           break;
         }
+
+      for (i = 0; i < nfds; i++)
+        {
+          if ((fds[i].revents & POLLIN) != 0)
+            {
+              dns_recv_response(qdata, fds[i].fd);
+            }
+        }
     }
 
-  return 0;
+  return found;
 }
 
 /****************************************************************************
@@ -769,8 +931,9 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
  * Name: dns_query
  *
  * Description:
- *   Using the DNS resolver socket (sd), look up the 'hostname', and
- *   return its IP address in 'ipaddr'
+ *   Look up the 'hostname', and return its IP addresses in 'addr'.  The
+ *   AAAA and A queries are sent together to all of the name servers, the
+ *   first answer of each type is used.
  *
  * Input Parameters:
  *   hostname - The hostname string to be resolved.
@@ -781,50 +944,153 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
  *     the returned addresses.
  *
  * Returned Value:
- *   Returns zero (OK) if the query was successful.
+ *   Returns zero (OK) if the query was successful, -ENXIO if the name does
+ *   not exist.
  *
  ****************************************************************************/
 
 int dns_query(FAR const char *hostname, FAR union dns_addr_u *addr,
               FAR int *naddr)
 {
-  FAR struct dns_query_data_s *qdata = lib_malloc(sizeof(*qdata));
+  FAR struct dns_query_data_s *qdata;
+  FAR struct dns_query_type_s *type;
+  uint32_t ttl = UINT32_MAX;
+  uint16_t id;
+  int retries;
+  int next = 0;
   int ret;
+  int i;
+  int n;
 
+  qdata = lib_zalloc(sizeof(*qdata));
   if (qdata == NULL)
     {
       return -ENOMEM;
     }
 
-  /* Set up the query info structure */
+  qdata->hostname = hostname;
+  for (i = 0; i < DNS_QUERY_NSOCKETS; i++)
+    {
+      qdata->sd[i] = -1;
+    }
 
-  qdata->query.result   = -EADDRNOTAVAIL;
-  qdata->query.hostname = hostname;
-  qdata->query.addr     = addr;
-  qdata->query.naddr    = naddr;
+  /* Get the name servers */
 
-  /* Perform the query. dns_foreach_nameserver() will return:
-   *
-   *  1 - The query was successful.
-   *  0 - Look up failed
-   * <0 - Some other failure (?, shouldn't happen)
+  ret = dns_foreach_nameserver(dns_server_callback, qdata);
+  if (qdata->nservers == 0)
+    {
+      ret = ret < 0 ? ret : -EADDRNOTAVAIL;
+      goto errout;
+    }
+
+  /* Set up the queries, IPv6 first as its addresses are returned first */
+
+  id = dns_alloc_id();
+
+#ifdef CONFIG_NET_IPv6
+  if (dns_is_queryfamily(AF_INET6))
+    {
+      type = &qdata->type[qdata->ntypes++];
+      type->qinfo.id      = HTONS(id++);
+      type->qinfo.rectype = HTONS(DNS_RECTYPE_AAAA);
+      type->maxaddr       = CONFIG_NETDB_MAX_IPv6ADDR;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if (dns_is_queryfamily(AF_INET))
+    {
+      type = &qdata->type[qdata->ntypes++];
+      type->qinfo.id      = HTONS(id++);
+      type->qinfo.rectype = HTONS(DNS_RECTYPE_A);
+      type->maxaddr       = CONFIG_NETDB_MAX_IPv4ADDR;
+    }
+#endif
+
+  /* Loop while some name servers did not answer and there are remaining
+   * retries.
    */
 
-  ret = dns_foreach_nameserver(dns_query_callback, qdata);
-  if (ret > 0)
+  for (retries = 0; retries < CONFIG_NETDB_DNSCLIENT_RETRIES; retries++)
     {
-      /* The lookup was successful */
+      for (i = 0; i < qdata->ntypes; i++)
+        {
+          if (!qdata->type[i].done)
+            {
+              qdata->type[i].result = -EAGAIN;
+            }
+        }
+
+      if (dns_send_queries(qdata) == 0)
+        {
+          break;
+        }
+
+      /* Do not retry the queries still pending once addresses were
+       * received.
+       */
+
+      if (dns_recv_responses(qdata))
+        {
+          break;
+        }
+    }
+
+  ret = -EADDRNOTAVAIL;
+
+  /* Gather the addresses.  If the IPv6 addresses fill the buffer, the
+   * IPv4 addresses take its second half.
+   */
+
+  for (i = 0; i < qdata->ntypes; i++)
+    {
+      type = &qdata->type[i];
+      if (type->result > 0)
+        {
+          if (next >= *naddr)
+            {
+              next = *naddr / 2;
+            }
 
-      ret = OK;
+          n = MIN(type->result, *naddr - next);
+          memcpy(&addr[next], type->addr, n * sizeof(*addr));
+          next += n;
+          ttl   = MIN(ttl, type->ttl);
+        }
+      else if (ret != -ENXIO)
+        {
+          ret = type->result;
+        }
     }
-  else if (ret == 0)
+
+  if (next > 0)
     {
-      ret = qdata->query.result;
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+      /* Save the answer in the DNS cache */
+
+      dns_save_answer(hostname, addr, next, ttl);
+#endif
+      *naddr = next;
+      ret    = OK;
     }
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+  else if (ret == -ENXIO)
+    {
+      /* Remember that the name does not exist */
 
-  /* Free the query data */
+      dns_save_answer(hostname, addr, 0, UINT32_MAX);
+    }
+#endif
 
-  lib_free(qdata);
+errout:
+  for (i = 0; i < DNS_QUERY_NSOCKETS; i++)
+    {
+      if (qdata->sd[i] >= 0)
+        {
+          close(qdata->sd[i]);
+        }
+    }
 
+  lib_free(qdata);
   return ret;
 }
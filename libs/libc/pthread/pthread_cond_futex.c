@@ -0,0 +1,254 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_cond_futex.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include <errno.h>
+
+#include <nuttx/futex.h>
+
+#ifdef CONFIG_PTHREAD_FUTEX
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_cond_wake
+ *
+ * Description:
+ *   Wake up to 'nwake' waiters of the condition variable.  The sequence
+ *   number is changed first, so that a thread about to wait sees the
+ *   change instead of missing the wake-up.  No system call is made when
+ *   nobody waits.
+ *
+ ****************************************************************************/
+
+static int pthread_cond_wake(FAR pthread_cond_t *cond, int nwake)
+{
+  if (cond == NULL)
+    {
+      return EINVAL;
+    }
+
+  __atomic_fetch_add(&cond->seq, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&cond->waiters, __ATOMIC_SEQ_CST) != 0)
+    {
+      futex_wake(&cond->seq, nwake);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_cond_init
+ *
+ * Description:
+ *   A thread can create condition variables.
+ *
+ * Input Parameters:
+ *   cond - The condition variable to initialize.
+ *   attr - The attributes of the condition variable, or NULL.
+ *
+ * Returned Value:
+ *   OK (0) on success; EINVAL if 'cond' is NULL.
+ *
+ ****************************************************************************/
+
+int pthread_cond_init(FAR pthread_cond_t *cond,
+                      FAR const pthread_condattr_t *attr)
+{
+  if (cond == NULL)
+    {
+      return EINVAL;
+    }
+
+  cond->seq     = 0;
+  cond->waiters = 0;
+  cond->clockid = attr ? attr->clockid : CLOCK_REALTIME;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pthread_cond_destroy
+ *
+ * Description:
+ *   A thread can delete condition variables.
+ *
+ * Input Parameters:
+ *   cond - The condition variable to destroy.
+ *
+ * Returned Value:
+ *   OK (0) on success; EBUSY if threads wait on 'cond', EINVAL if 'cond'
+ *   is NULL.
+ *
+ ****************************************************************************/
+
+int pthread_cond_destroy(FAR pthread_cond_t *cond)
+{
+  if (cond == NULL)
+    {
+      return EINVAL;
+    }
+
+  return cond->waiters != 0 ? EBUSY : OK;
+}
+
+/****************************************************************************
+ * Name: pthread_cond_clockwait
+ *
+ * Description:
+ *   Release 'mutex' and wait on the condition variable until it is
+ *   signaled or 'abstime' expires, then take 'mutex' again.  The wait is a
+ *   cancellation point, cancellation is acted upon before blocking and
+ *   after waking up.
+ *
+ * Input Parameters:
+ *   cond    - The condition variable to wait on.
+ *   mutex   - The mutex that protects the condition variable.
+ *   clockid - The clock of 'abstime'.
+ *   abstime - Absolute timeout, or NULL to wait forever.
+ *
+ * Returned Value:
+ *   OK (0) on success, which may be spurious; ETIMEDOUT if 'abstime'
+ *   expired, or another errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_cond_clockwait(FAR pthread_cond_t *cond,
+                           FAR pthread_mutex_t *mutex,
+                           clockid_t clockid,
+                           FAR const struct timespec *abstime)
+{
+  uint32_t seq;
+  int status;
+  int ret;
+
+  if (cond == NULL || mutex == NULL)
+    {
+      return EINVAL;
+    }
+
+  pthread_testcancel();
+
+  /* Register as a waiter and sample the sequence number while holding
+   * the mutex, a signal sent after releasing it then changes the number
+   * and futex_wait() returns immediately.
+   */
+
+  __atomic_fetch_add(&cond->waiters, 1, __ATOMIC_SEQ_CST);
+  seq = __atomic_load_n(&cond->seq, __ATOMIC_SEQ_CST);
+
+  ret = pthread_mutex_unlock(mutex);
+  if (ret != OK)
+    {
+      __atomic_fetch_sub(&cond->waiters, 1, __ATOMIC_SEQ_CST);
+      return ret;
+    }
+
+  /* A signal or a change of the sequence number ends the wait as a
+   * spurious wake-up, which the caller has to handle anyway.
+   */
+
+  status = futex_wait(&cond->seq, seq, clockid, abstime);
+  __atomic_fetch_sub(&cond->waiters, 1, __ATOMIC_SEQ_CST);
+
+  ret = pthread_mutex_lock(mutex);
+  if (ret == OK && (status == -ETIMEDOUT || status == -EINVAL))
+    {
+      ret = -status;
+    }
+
+  pthread_testcancel();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pthread_cond_wait
+ *
+ * Description:
+ *   Wait on the condition variable without a timeout.
+ *
+ * Input Parameters:
+ *   cond  - The condition variable to wait on.
+ *   mutex - The mutex that protects the condition variable.
+ *
+ * Returned Value:
+ *   OK (0) on success; an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
+{
+  return pthread_cond_clockwait(cond, mutex, CLOCK_REALTIME, NULL);
+}
+
+/****************************************************************************
+ * Name: pthread_cond_signal
+ *
+ * Description:
+ *   Wake up at least one thread waiting on the condition variable.
+ *
+ * Input Parameters:
+ *   cond - The condition variable to signal.
+ *
+ * Returned Value:
+ *   OK (0) on success; EINVAL if 'cond' is NULL.
+ *
+ ****************************************************************************/
+
+int pthread_cond_signal(FAR pthread_cond_t *cond)
+{
+  return pthread_cond_wake(cond, 1);
+}
+
+/****************************************************************************
+ * Name: pthread_cond_broadcast
+ *
+ * Description:
+ *   Wake up all threads waiting on the condition variable.
+ *
+ * Input Parameters:
+ *   cond - The condition variable to broadcast.
+ *
+ * Returned Value:
+ *   OK (0) on success; EINVAL if 'cond' is NULL.
+ *
+ ****************************************************************************/
+
+int pthread_cond_broadcast(FAR pthread_cond_t *cond)
+{
+  return pthread_cond_wake(cond, INT_MAX);
+}
+
+#endif /* CONFIG_PTHREAD_FUTEX */
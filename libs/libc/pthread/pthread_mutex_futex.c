@@ -0,0 +1,315 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_mutex_futex.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <nuttx/futex.h>
+#include <nuttx/tls.h>
+
+#ifdef CONFIG_PTHREAD_FUTEX
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_tid
+ *
+ * Description:
+ *   Return the ID of the calling thread.  gettid() is a system call, so it
+ *   is called once per thread and the result is kept in the TLS.
+ *
+ ****************************************************************************/
+
+static inline uint32_t pthread_mutex_tid(void)
+{
+  FAR struct tls_info_s *info = tls_get_info();
+
+  if (info->tl_tid == 0)
+    {
+      info->tl_tid = gettid();
+    }
+
+  return (uint32_t)info->tl_tid;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_take
+ *
+ * Description:
+ *   Take the mutex, blocking until 'abstime' if it is held by another
+ *   thread and 'trylock' is false.  The holder is only known to the futex
+ *   word, so an uncontended mutex is taken without a system call.
+ *
+ ****************************************************************************/
+
+static int pthread_mutex_take(FAR pthread_mutex_t *mutex,
+                              FAR const struct timespec *abstime,
+                              bool trylock)
+{
+  uint32_t tid = pthread_mutex_tid();
+  uint32_t old = 0;
+  int ret;
+
+  if (mutex == NULL)
+    {
+      return EINVAL;
+    }
+
+  if (__atomic_compare_exchange_n(&mutex->futex, &old, tid, false,
+                                  __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  if ((old & _PTHREAD_FUTEX_TIDMASK) == tid)
+    {
+      if (mutex->type == PTHREAD_MUTEX_RECURSIVE)
+        {
+          if (mutex->nlocks == UINT16_MAX)
+            {
+              return EAGAIN;
+            }
+
+          mutex->nlocks++;
+          return OK;
+        }
+      else if (mutex->type == PTHREAD_MUTEX_ERRORCHECK)
+        {
+          return EDEADLK;
+        }
+    }
+#endif
+
+  if (trylock)
+    {
+      return EBUSY;
+    }
+
+  for (; ; )
+    {
+      old = __atomic_load_n(&mutex->futex, __ATOMIC_RELAXED);
+
+      /* The mutex was released.  Take it with the waiters flag set, as
+       * other threads may still sleep on it.
+       */
+
+      if (old == 0)
+        {
+          if (__atomic_compare_exchange_n(&mutex->futex, &old,
+                                          tid | _PTHREAD_FUTEX_WAITERS,
+                                          false, __ATOMIC_ACQUIRE,
+                                          __ATOMIC_RELAXED))
+            {
+              return OK;
+            }
+
+          continue;
+        }
+
+      /* Tell the holder to wake up the waiters when releasing it */
+
+      if ((old & _PTHREAD_FUTEX_WAITERS) == 0)
+        {
+          if (!__atomic_compare_exchange_n(&mutex->futex, &old,
+                                           old | _PTHREAD_FUTEX_WAITERS,
+                                           false, __ATOMIC_RELAXED,
+                                           __ATOMIC_RELAXED))
+            {
+              continue;
+            }
+
+          old |= _PTHREAD_FUTEX_WAITERS;
+        }
+
+      /* Signals do not interrupt the wait: retry after -EINTR, and after
+       * -EAGAIN when the word changed before sleeping.
+       */
+
+      ret = futex_wait(&mutex->futex, old, CLOCK_REALTIME, abstime);
+      if (ret == -ETIMEDOUT || ret == -EINVAL)
+        {
+          return -ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_init
+ *
+ * Description:
+ *   Create a mutex.
+ *
+ * Input Parameters:
+ *   mutex - The mutex to initialize.
+ *   attr  - The attributes of the mutex, or NULL for the defaults.
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_init(FAR pthread_mutex_t *mutex,
+                       FAR const pthread_mutexattr_t *attr)
+{
+  if (mutex == NULL)
+    {
+      return EINVAL;
+    }
+
+  mutex->futex = 0;
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  mutex->type   = attr ? attr->type : PTHREAD_MUTEX_DEFAULT;
+  mutex->nlocks = 0;
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_destroy
+ *
+ * Description:
+ *   Destroy a mutex.
+ *
+ * Input Parameters:
+ *   mutex - The mutex to destroy.
+ *
+ * Returned Value:
+ *   0 on success, EBUSY if the mutex is held or EINVAL.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_destroy(FAR pthread_mutex_t *mutex)
+{
+  if (mutex == NULL)
+    {
+      return EINVAL;
+    }
+
+  return mutex->futex != 0 ? EBUSY : OK;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_timedlock
+ *
+ * Description:
+ *   Lock the mutex, waiting until 'abs_timeout' if it is held by another
+ *   thread.  See pthread_mutex_lock().
+ *
+ * Input Parameters:
+ *   mutex       - The mutex to lock.
+ *   abs_timeout - Absolute CLOCK_REALTIME timeout, or NULL to wait forever.
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.  EINTR is never returned.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_timedlock(FAR pthread_mutex_t *mutex,
+                            FAR const struct timespec *abs_timeout)
+{
+  return pthread_mutex_take(mutex, abs_timeout, false);
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_trylock
+ *
+ * Description:
+ *   Lock the mutex if it is not held by another thread.
+ *
+ * Input Parameters:
+ *   mutex - The mutex to lock.
+ *
+ * Returned Value:
+ *   0 on success, EBUSY if the mutex is held, or another errno value.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_trylock(FAR pthread_mutex_t *mutex)
+{
+  return pthread_mutex_take(mutex, NULL, true);
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_unlock
+ *
+ * Description:
+ *   Release the mutex, and wake up one of its waiters if there are any.
+ *
+ * Input Parameters:
+ *   mutex - The mutex to unlock.
+ *
+ * Returned Value:
+ *   0 on success, or EPERM if the calling thread does not hold the mutex.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
+{
+  uint32_t old;
+
+  if (mutex == NULL)
+    {
+      return EINVAL;
+    }
+
+  old = __atomic_load_n(&mutex->futex, __ATOMIC_RELAXED);
+  if ((old & _PTHREAD_FUTEX_TIDMASK) != pthread_mutex_tid())
+    {
+      return EPERM;
+    }
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  if (mutex->nlocks > 0)
+    {
+      mutex->nlocks--;
+      return OK;
+    }
+#endif
+
+  old = __atomic_exchange_n(&mutex->futex, 0, __ATOMIC_RELEASE);
+  if ((old & _PTHREAD_FUTEX_WAITERS) != 0)
+    {
+      futex_wake(&mutex->futex, 1);
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_PTHREAD_FUTEX */
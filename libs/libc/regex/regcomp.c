@@ -3662,6 +3662,55 @@ static reg_errcode_t tre_ast_to_tnfa(tre_ast_node_t *node,
     }                        \
   while (/* CONSTCOND */ 0)
 
+/* Sets the prefix of the TNFA to the literal characters at the start of
+ *  `regex', which every match contains.  Escapes and multibyte characters
+ *  end the prefix, and an alternation anywhere means there is none.
+ */
+
+static void tre_literal_prefix(tre_tnfa_t *tnfa, const char *regex,
+                               int cflags)
+{
+  const char *specials = (cflags & REG_EXTENDED) ? "\\.[()*+?{|^$" :
+                                                   "\\.[*^$";
+  const char *start = regex;
+  const char *end;
+
+  if ((cflags & REG_ICASE) || strchr(regex, '|') != NULL)
+    {
+      return;
+    }
+
+  if (*start == '^')
+    {
+      start++;
+    }
+
+  for (end = start; *end != '\0' && (unsigned char)*end < 0x80 &&
+                    strchr(specials, *end) == NULL; end++)
+    {
+    }
+
+  /* A quantifier that allows zero repetitions applies to the last one. */
+
+  if (end > start &&
+      (*end == '*' ||
+       ((cflags & REG_EXTENDED) && (*end == '?' || *end == '{')) ||
+       (*end == '\\' && (end[1] == '?' || end[1] == '{'))))
+    {
+      end--;
+    }
+
+  if (end > start)
+    {
+      tnfa->prefix = xmalloc(end - start);
+      if (tnfa->prefix != NULL)
+        {
+          memcpy(tnfa->prefix, start, end - start);
+          tnfa->prefix_len = end - start;
+        }
+    }
+}
+
 int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
 {
   tre_stack_t           *stack;
@@ -3924,6 +3973,9 @@ int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
   tnfa->final           = transitions + offs[tree->lastpos[0].position];
   tnfa->num_states      = parse_ctx.position;
   tnfa->cflags          = cflags;
+  tnfa->dfa             = tre_dfa_new(tnfa);
+
+  tre_literal_prefix(tnfa, regex, cflags);
 
   tre_mem_destroy(mem);
   tre_stack_destroy(stack);
@@ -4032,5 +4084,8 @@ void regfree(regex_t *preg)
       xfree(tnfa->minimal_tags);
     }
 
+  tre_dfa_free(tnfa->dfa);
+  xfree(tnfa->prefix);
+  xfree(tnfa->match_buf);
   xfree(tnfa);
 }
@@ -35,6 +35,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <stdlib.h>
 #include <string.h>
 #include <wchar.h>
@@ -192,10 +194,23 @@ typedef struct
   int **tags;
 } tre_reach_pos_t;
 
+/* Returns the size of the work memory of the parallel matcher. */
+
+static size_t tre_tnfa_parallel_bytes(const tre_tnfa_t *tnfa, int num_tags)
+{
+  size_t tbytes = sizeof(int) * num_tags;
+  size_t rbytes = sizeof(tre_tnfa_reach_t) * (tnfa->num_states + 1);
+  size_t pbytes = sizeof(tre_reach_pos_t) * tnfa->num_states;
+  size_t xbytes = sizeof(int) * num_tags;
+
+  return (sizeof(long) - 1) * 4 /* for alignment paddings */
+         + (rbytes + xbytes * tnfa->num_states) * 2 + tbytes + pbytes;
+}
+
 static reg_errcode_t tre_tnfa_run_parallel(const tre_tnfa_t *tnfa,
                                            const void *string,
                                            int *match_tags, int eflags,
-                                           int *match_end_ofs)
+                                           int *match_end_ofs, char *buf)
 {
   /* State variables required by GET_NEXT_WCHAR. */
 
@@ -212,7 +227,6 @@ static reg_errcode_t tre_tnfa_run_parallel(const tre_tnfa_t *tnfa,
   int                   reg_newline = tnfa->cflags & REG_NEWLINE;
   reg_errcode_t         ret;
 
-  char                  *buf;
   tre_tnfa_transition_t *trans_i;
   tre_tnfa_reach_t      *reach, *reach_next, *reach_i, *reach_next_i;
   tre_reach_pos_t       *reach_pos;
@@ -239,10 +253,9 @@ static reg_errcode_t tre_tnfa_run_parallel(const tre_tnfa_t *tnfa,
       num_tags = tnfa->num_tags;
     }
 
-  /* Allocate memory for temporary data required for matching. This needs to
-   *  be done for every matching operation to be thread safe.  This allocates
-   *  everything in a single large block from the stack frame using alloca()
-   *  or with malloc() if alloca is unavailable.
+  /* Lay out the temporary data required for matching in `buf'.  Each
+   *  matching operation needs its own to be thread safe, the caller
+   *  reuses it between operations.
    */
 
     {
@@ -250,28 +263,16 @@ static reg_errcode_t tre_tnfa_run_parallel(const tre_tnfa_t *tnfa,
       int     rbytes;
       int     pbytes;
       int     xbytes;
-      int     total_bytes;
       char    *tmp_buf;
 
-      /* Compute the length of the block we need. */
+      /* Compute the length of the parts we need. */
 
       tbytes      = sizeof(*tmp_tags) * num_tags;
       rbytes      = sizeof(*reach_next) * (tnfa->num_states + 1);
       pbytes      = sizeof(*reach_pos) * tnfa->num_states;
       xbytes      = sizeof(int) * num_tags;
-      total_bytes = (sizeof(long) - 1) * 4 /* for alignment paddings */
-                  + (rbytes + xbytes * tnfa->num_states) * 2 + tbytes +
-                  pbytes;
-
-      /* Allocate the memory. */
 
-      buf = xmalloc((unsigned)total_bytes);
-      if (buf == NULL)
-        {
-          return REG_ESPACE;
-        }
-
-      memset(buf, 0, (size_t)total_bytes);
+      memset(buf, 0, tre_tnfa_parallel_bytes(tnfa, num_tags));
 
       /* Get the various pointers within tmp_buf (properly aligned). */
 
@@ -547,7 +548,6 @@ static reg_errcode_t tre_tnfa_run_parallel(const tre_tnfa_t *tnfa,
   *match_end_ofs    = match_eo;
   ret               = match_eo >= 0 ? REG_OK : REG_NOMATCH;
 error_exit:
-  xfree(buf);
   return ret;
 }
 
@@ -1211,6 +1211,408 @@ static void tre_fill_pmatch(size_t nmatch, regmatch_t pmatch[], int cflags,
     }
 }
 
+/* Matching accelerators.
+ */
+
+/*  Regexps without back references are first run on a DFA that only tells
+ *  whether the string matches.  The DFA is built lazily from the TNFA: a
+ *  DFA state is the set of TNFA states reached at a position, and each
+ *  transition is computed the first time it is taken and then cached.
+ *  Assertions depend on the character after the position, so transitions
+ *  are cached per class of that character, if the regexp has assertions.
+ *  Only the ASCII characters have cached transitions, the others compute
+ *  the next state every time.  When the cache is full, the match falls
+ *  back to the TNFA and the cache starts over on the next call.
+ *
+ *  The DFA is shared by the threads using the regexp.  A thread finding it
+ *  busy simply uses the TNFA.
+ */
+
+#if CONFIG_LIBC_REGEX_DFA_NSTATES > 0
+
+#define TRE_DFA_NCHARS      128
+#define TRE_DFA_NCTX        5
+
+#define TRE_DFA_CTX_ASSERTIONS                                  \
+  (ASSERT_AT_BOL | ASSERT_AT_EOL | ASSERT_AT_BOW | ASSERT_AT_EOW | \
+   ASSERT_AT_WB | ASSERT_AT_WB_NEG)
+
+struct tre_dfa_state
+{
+  unsigned long hash;
+  int accept;               /* Contains the final TNFA state */
+  unsigned char *trans;     /* Next state + 1 by class and character */
+  unsigned char set[1];     /* Bitmap of the TNFA states */
+};
+
+struct tre_dfa
+{
+  int busy;
+  int nctx;                 /* Classes of the next character */
+  int setbytes;
+  int final_id;
+  int nstates;
+  tre_mem_t mem;            /* Memory of the DFA states */
+
+  /* TNFA state by state id. */
+
+  tre_tnfa_transition_t **idmap;
+  unsigned char *scratch;   /* The set of the next state */
+  struct tre_dfa_state *states[CONFIG_LIBC_REGEX_DFA_NSTATES];
+};
+
+struct tre_dfa *tre_dfa_new(const tre_tnfa_t *tnfa)
+{
+  struct tre_dfa *dfa;
+  tre_tnfa_transition_t *trans_i;
+  unsigned int i;
+  int assertions = 0;
+  int setbytes = (tnfa->num_states + 7) / 8;
+
+  if (tnfa->have_backrefs || tnfa->num_states <= 0)
+    {
+      return NULL;
+    }
+
+  dfa = xcalloc(1, sizeof(*dfa) +
+                   sizeof(*dfa->idmap) * tnfa->num_states + setbytes);
+  if (dfa == NULL)
+    {
+      return NULL;
+    }
+
+  dfa->mem = tre_mem_new();
+  if (dfa->mem == NULL)
+    {
+      xfree(dfa);
+      return NULL;
+    }
+
+  dfa->idmap    = (void *)(dfa + 1);
+  dfa->scratch  = (void *)(dfa->idmap + tnfa->num_states);
+  dfa->setbytes = setbytes;
+  dfa->final_id = -1;
+
+  for (i = 0; i < tnfa->num_transitions; i++)
+    {
+      trans_i = &tnfa->transitions[i];
+      if (trans_i->state != NULL)
+        {
+          dfa->idmap[trans_i->state_id] = trans_i->state;
+          assertions |= trans_i->assertions;
+        }
+    }
+
+  for (trans_i = tnfa->initial; trans_i->state != NULL; trans_i++)
+    {
+      dfa->idmap[trans_i->state_id] = trans_i->state;
+      assertions |= trans_i->assertions;
+    }
+
+  for (i = 0; i < tnfa->num_states; i++)
+    {
+      if (dfa->idmap[i] == tnfa->final)
+        {
+          dfa->final_id = i;
+        }
+    }
+
+  dfa->nctx = (assertions & TRE_DFA_CTX_ASSERTIONS) ? TRE_DFA_NCTX : 1;
+  return dfa;
+}
+
+void tre_dfa_free(struct tre_dfa *dfa)
+{
+  if (dfa != NULL)
+    {
+      tre_mem_destroy(dfa->mem);
+      xfree(dfa);
+    }
+}
+
+/* Returns the class of the character after the position, which decides
+ *  the assertions.
+ */
+
+static int tre_dfa_ctx(const struct tre_dfa *dfa, tre_char_t next_c,
+                       int eflags)
+{
+  if (dfa->nctx == 1)
+    {
+      return 0;
+    }
+  else if (next_c == L'\0')
+    {
+      return (eflags & REG_NOTEOL) ? 1 : 0;
+    }
+  else if (next_c == L'\n')
+    {
+      return 2;
+    }
+
+  return IS_WORD_CHAR(next_c) ? 3 : 4;
+}
+
+/* Computes in `dfa->scratch' the TNFA states reached from `set' (NULL at
+ *  the start of the string) by `prev_c', plus the initial states.
+ */
+
+static void tre_dfa_step(const tre_tnfa_t *tnfa, struct tre_dfa *dfa,
+                         const unsigned char *set, tre_char_t prev_c,
+                         tre_char_t next_c, int pos, int eflags)
+{
+  tre_tnfa_transition_t *trans_i;
+  int reg_notbol  = eflags & REG_NOTBOL;
+  int reg_noteol  = eflags & REG_NOTEOL;
+  int reg_newline = tnfa->cflags & REG_NEWLINE;
+  int i;
+
+  memset(dfa->scratch, 0, dfa->setbytes);
+
+  for (i = 0; set != NULL && i < tnfa->num_states; i++)
+    {
+      if ((set[i / 8] & (1 << (i % 8))) == 0)
+        {
+          continue;
+        }
+
+      for (trans_i = dfa->idmap[i]; trans_i->state; trans_i++)
+        {
+          if (trans_i->code_min <= (tre_cint_t)prev_c &&
+              trans_i->code_max >= (tre_cint_t)prev_c &&
+              !(trans_i->assertions &&
+                (CHECK_ASSERTIONS(trans_i->assertions) ||
+                 CHECK_CHAR_CLASSES(trans_i, tnfa, eflags))))
+            {
+              dfa->scratch[trans_i->state_id / 8] |=
+                1 << (trans_i->state_id % 8);
+            }
+        }
+    }
+
+  for (trans_i = tnfa->initial; trans_i->state; trans_i++)
+    {
+      if (!(trans_i->assertions && CHECK_ASSERTIONS(trans_i->assertions)))
+        {
+          dfa->scratch[trans_i->state_id / 8] |=
+            1 << (trans_i->state_id % 8);
+        }
+    }
+}
+
+/* Returns the index of the DFA state for `dfa->scratch', adding it if it
+ *  is new, or -1 if the cache is full.
+ */
+
+static int tre_dfa_intern(struct tre_dfa *dfa)
+{
+  struct tre_dfa_state *state;
+  unsigned long hash = 5381;
+  int i;
+
+  for (i = 0; i < dfa->setbytes; i++)
+    {
+      hash = hash * 33 + dfa->scratch[i];
+    }
+
+  for (i = 0; i < dfa->nstates; i++)
+    {
+      state = dfa->states[i];
+      if (state->hash == hash &&
+          memcmp(state->set, dfa->scratch, dfa->setbytes) == 0)
+        {
+          return i;
+        }
+    }
+
+  if (dfa->nstates >= CONFIG_LIBC_REGEX_DFA_NSTATES)
+    {
+      return -1;
+    }
+
+  state = tre_mem_alloc(dfa->mem, sizeof(*state) + dfa->setbytes);
+  if (state == NULL)
+    {
+      return -1;
+    }
+
+  state->trans = tre_mem_calloc(dfa->mem, TRE_DFA_NCHARS * dfa->nctx);
+  if (state->trans == NULL)
+    {
+      return -1;
+    }
+
+  memcpy(state->set, dfa->scratch, dfa->setbytes);
+  state->hash   = hash;
+  state->accept = dfa->final_id >= 0 &&
+                  (state->set[dfa->final_id / 8] &
+                   (1 << (dfa->final_id % 8))) != 0;
+
+  dfa->states[dfa->nstates] = state;
+  return dfa->nstates++;
+}
+
+/* Reads the character at `str_byte', returns its length or -1 if it is
+ *  not valid.
+ */
+
+static int tre_dfa_getc(const char *str_byte, tre_char_t *c)
+{
+  int len;
+
+  if ((unsigned char)*str_byte < 0x80)
+    {
+      *c = (unsigned char)*str_byte;
+      return 1;
+    }
+
+  len = mbtowc(c, str_byte, MB_LEN_MAX);
+  return len > 0 ? len : -1;
+}
+
+/* Returns REG_OK if `string' contains a match, REG_NOMATCH if not, or -1
+ *  if the DFA cannot tell.
+ */
+
+static int tre_dfa_run(const tre_tnfa_t *tnfa, const char *string,
+                       int eflags)
+{
+  struct tre_dfa *dfa = tnfa->dfa;
+  const char *str_byte = string;
+  tre_char_t prev_c;
+  tre_char_t next_c;
+  int ret = -1;
+  int next;
+  int cur;
+  int len;
+  int i;
+
+  if (dfa == NULL || __atomic_exchange_n(&dfa->busy, 1, __ATOMIC_ACQUIRE))
+    {
+      return -1;
+    }
+
+  len = tre_dfa_getc(str_byte, &next_c);
+  if (len < 0)
+    {
+      ret = REG_NOMATCH;
+      goto out;
+    }
+
+  str_byte += len;
+  tre_dfa_step(tnfa, dfa, NULL, L'\0', next_c, 0, eflags);
+  cur = tre_dfa_intern(dfa);
+
+  while (cur >= 0 && !dfa->states[cur]->accept)
+    {
+      if (next_c == L'\0')
+        {
+          ret = REG_NOMATCH;
+          goto out;
+        }
+
+      prev_c = next_c;
+      len    = tre_dfa_getc(str_byte, &next_c);
+      if (len < 0)
+        {
+          ret = REG_NOMATCH;
+          goto out;
+        }
+
+      str_byte += len;
+
+      if ((tre_cint_t)prev_c < TRE_DFA_NCHARS)
+        {
+          i    = tre_dfa_ctx(dfa, next_c, eflags) * TRE_DFA_NCHARS + prev_c;
+          next = dfa->states[cur]->trans[i] - 1;
+          if (next < 0)
+            {
+              tre_dfa_step(tnfa, dfa, dfa->states[cur]->set, prev_c,
+                           next_c, 1, eflags);
+              next = tre_dfa_intern(dfa);
+              if (next >= 0)
+                {
+                  dfa->states[cur]->trans[i] = next + 1;
+                }
+            }
+        }
+      else
+        {
+          tre_dfa_step(tnfa, dfa, dfa->states[cur]->set, prev_c,
+                       next_c, 1, eflags);
+          next = tre_dfa_intern(dfa);
+        }
+
+      cur = next;
+    }
+
+  if (cur >= 0)
+    {
+      ret = REG_OK;
+    }
+  else
+    {
+      /* The cache is full, start over on the next call. */
+
+      arena_reset(dfa->mem);
+      dfa->nstates = 0;
+    }
+
+out:
+  __atomic_store_n(&dfa->busy, 0, __ATOMIC_RELEASE);
+  return ret;
+}
+
+#else
+#  define tre_dfa_run(tnfa, string, eflags) (-1)
+
+struct tre_dfa *tre_dfa_new(const tre_tnfa_t *tnfa)
+{
+  return NULL;
+}
+
+void tre_dfa_free(struct tre_dfa *dfa)
+{
+}
+#endif /* CONFIG_LIBC_REGEX_DFA_NSTATES > 0 */
+
+/* Returns the work memory of the matchers: the tags, followed by the
+ *  memory of the parallel matcher.  It is kept in the TNFA for the next
+ *  match.
+ */
+
+static size_t tre_match_tags_bytes(const tre_tnfa_t *tnfa)
+{
+  return (sizeof(int) * tnfa->num_tags + sizeof(long) - 1) &
+         ~(sizeof(long) - 1);
+}
+
+static char *tre_match_buf_get(tre_tnfa_t *tnfa)
+{
+  char *buf;
+
+  buf = __atomic_exchange_n(&tnfa->match_buf, NULL, __ATOMIC_ACQUIRE);
+  if (buf == NULL)
+    {
+      buf = xmalloc(tre_match_tags_bytes(tnfa) +
+                    (tnfa->have_backrefs ? 0 :
+                     tre_tnfa_parallel_bytes(tnfa, tnfa->num_tags)));
+    }
+
+  return buf;
+}
+
+static void tre_match_buf_put(tre_tnfa_t *tnfa, char *buf)
+{
+  char *expect = NULL;
+
+  if (!__atomic_compare_exchange_n(&tnfa->match_buf, &expect, buf, 0,
+                                   __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    {
+      xfree(buf);
+    }
+}
+
 /* Wrapper functions for POSIX compatible regexp matching.
  */
 
@@ -1220,6 +1622,7 @@ int regexec(const regex_t *restrict preg, const char *restrict string,
   tre_tnfa_t    *tnfa = (void *)preg->TRE_REGEX_T_FIELD;
   reg_errcode_t status;
   int           *tags = NULL;
+  char          *buf;
   int           eo;
 
   if (tnfa->cflags & REG_NOSUB)
@@ -1227,13 +1630,34 @@ int regexec(const regex_t *restrict preg, const char *restrict string,
       nmatch = 0;
     }
 
+  /* A string without the literal of the regexp cannot match. */
+
+  if (tnfa->prefix != NULL &&
+      memmem(string, strlen(string), tnfa->prefix,
+             tnfa->prefix_len) == NULL)
+    {
+      return REG_NOMATCH;
+    }
+
+  /* The DFA tells whether there is a match, the TNFA is needed only to
+   *  find where.
+   */
+
+  status = tre_dfa_run(tnfa, string, eflags);
+  if (status == REG_NOMATCH || (status == REG_OK && nmatch == 0))
+    {
+      return status;
+    }
+
+  buf = tre_match_buf_get(tnfa);
+  if (buf == NULL)
+    {
+      return REG_ESPACE;
+    }
+
   if (tnfa->num_tags > 0 && nmatch > 0)
     {
-      tags = xmalloc(sizeof(*tags) * tnfa->num_tags);
-      if (tags == NULL)
-        {
-          return REG_ESPACE;
-        }
+      tags = (int *)buf;
     }
 
   /* Dispatch to the appropriate matcher. */
@@ -1248,7 +1672,8 @@ int regexec(const regex_t *restrict preg, const char *restrict string,
     {
       /* Exact matching, no back references, use the parallel matcher. */
 
-      status = tre_tnfa_run_parallel(tnfa, string, tags, eflags, &eo);
+      status = tre_tnfa_run_parallel(tnfa, string, tags, eflags, &eo,
+                                     buf + tre_match_tags_bytes(tnfa));
     }
 
   if (status == REG_OK)
@@ -1258,10 +1683,6 @@ int regexec(const regex_t *restrict preg, const char *restrict string,
       tre_fill_pmatch(nmatch, pmatch, tnfa->cflags, tnfa, tags, eo);
     }
 
-  if (tags)
-    {
-      xfree(tags);
-    }
-
+  tre_match_buf_put(tnfa, buf);
   return status;
 }
@@ -42,6 +42,8 @@
 #include <wchar.h>
 #include <wctype.h>
 
+#include <nuttx/arena.h>
+
 #undef  TRE_MBSTATE
 
 #ifndef NDEBUG
@@ -194,6 +196,8 @@ typedef struct tre_submatch_data tre_submatch_data_t;
 
 typedef struct tnfa tre_tnfa_t;
 
+struct tre_dfa;
+
 struct tnfa
 {
   tre_tnfa_transition_t *transitions;
@@ -213,72 +217,55 @@ struct tnfa
   int cflags;
   int have_backrefs;
   int have_approx;
+
+  /* Matching accelerators, see regexec.c. */
+
+  char *prefix;             /* Literal every match contains, or NULL */
+  size_t prefix_len;
+  struct tre_dfa *dfa;      /* Lazily built DFA, or NULL */
+  char *match_buf;          /* Work memory kept for the next match */
 };
 
-/* from tre-mem.h: */
+#define tre_dfa_new   __tre_dfa_new
+#define tre_dfa_free  __tre_dfa_free
 
-#define TRE_MEM_BLOCK_SIZE  1024
+/* Returns the DFA cache of `tnfa', or NULL if the TNFA cannot be turned
+ *  into a DFA or out of memory.
+ */
 
-typedef struct tre_list
-{
-  void *data;
-  struct tre_list *next;
-} tre_list_t;
+struct tre_dfa *tre_dfa_new(const tre_tnfa_t *tnfa);
+void tre_dfa_free(struct tre_dfa *dfa);
 
-struct tre_mem_struct
-{
-  tre_list_t *blocks;
-  tre_list_t *current;
-  char *ptr;
-  size_t n;
-  int failed;
-  void **provided;
-};
+/* from tre-mem.h: */
 
-typedef struct tre_mem_struct *tre_mem_t;
+/* The allocations of the compiler and of the backtracking matcher are
+ * freed all at once, so they come from an arena.
+ */
 
-#define tre_mem_new_impl    __tre_mem_new_impl
-#define tre_mem_alloc_impl  __tre_mem_alloc_impl
-#define tre_mem_destroy     __tre_mem_destroy
+#define TRE_MEM_BLOCK_SIZE  1024
 
-tre_mem_t tre_mem_new_impl(int provided, void *provided_block);
-void *tre_mem_alloc_impl(tre_mem_t mem, int provided, void *provided_block,
-                         int zero, size_t size);
+typedef FAR struct arena_s *tre_mem_t;
 
 /* Returns a new memory allocator or NULL if out of memory. */
-#define tre_mem_new()               tre_mem_new_impl(0, NULL)
+
+#define tre_mem_new()               arena_create(TRE_MEM_BLOCK_SIZE)
 
 /* Allocates a block of `size' bytes from `mem'.  Returns a pointer to the
  *  allocated block or NULL if an underlying malloc() failed.
  */
 
-#define tre_mem_alloc(mem, size)    tre_mem_alloc_impl(mem, 0, NULL, 0, size)
+#define tre_mem_alloc(mem, size)    arena_alloc(mem, size)
 
 /* Allocates a block of `size' bytes from `mem'.  Returns a pointer to the
  *  allocated block or NULL if an underlying malloc() failed.  The memory
  *  is set to zero.
  */
 
-#define tre_mem_calloc(mem, size)   tre_mem_alloc_impl(mem, 0, NULL, 1, size)
-
-#ifdef TRE_USE_ALLOCA
-
-/* alloca() versions.  Like above, but memory is allocated with alloca()
- *  instead of malloc().
- */
-
-#define tre_mem_newa() \
-  tre_mem_new_impl(1, alloca(sizeof(struct tre_mem_struct)))
-
-#define tre_mem_alloca(mem, size)                  \
-  ((mem)->n >= (size)                              \
-   ? tre_mem_alloc_impl((mem), 1, NULL, 0, (size)) \
-   : tre_mem_alloc_impl((mem), 1, alloca(TRE_MEM_BLOCK_SIZE), 0, (size)))
-#endif /* TRE_USE_ALLOCA */
+#define tre_mem_calloc(mem, size)   arena_zalloc(mem, size)
 
 /* Frees the memory allocator and all memory allocated with it. */
 
-void tre_mem_destroy(tre_mem_t mem);
+#define tre_mem_destroy(mem)        arena_destroy(mem)
 
 #define xmalloc     malloc
 #define xcalloc     calloc
@@ -49,7 +49,18 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define DTOA_MAX_DIG        DBL_DIG
+/* The Ryu engine converts up to 17 digits, enough for any double to read
+ * back unchanged.
+ */
+
+#ifdef CONFIG_LIBC_DTOA_RYU
+#  define DTOA_MAX_DIG      17
+#else
+#  define DTOA_MAX_DIG      DBL_DIG
+#endif
+
+#define DTOA_POW5_INV_NUM   342
+#define DTOA_POW5_NUM       342
 
 #define DTOA_MINUS          1
 #define DTOA_ZERO           2
@@ -181,10 +192,21 @@ extern const double g_dtoa_scale_up[];
 extern const double g_dtoa_scale_down[];
 extern const double g_dtoa_round[];
 
+#ifdef CONFIG_LIBC_DTOA_RYU
+extern const uint64_t g_dtoa_pow5_inv_split[DTOA_POW5_INV_NUM][2];
+extern const uint64_t g_dtoa_pow5_split[DTOA_POW5_NUM][2];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/* Convert x to max_digits decimal digits, or to no more than the digits
+ * left of the decimal point plus max_decimals if max_decimals is not zero.
+ * With the Ryu engine, a max_digits of zero selects the fewest digits that
+ * read back to x.  Returns the number of digits.
+ */
+
 int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
                   int max_decimals);
 
@@ -0,0 +1,638 @@
+/****************************************************************************
+ * libs/libc/stdio/lib_dtoa_ryu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "lib_dtoa_engine.h"
+#include "lib_ultoa_invert.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if DBL_MANT_DIG != 53 || DBL_MAX_EXP != 1024
+#  error The Ryu engine needs IEEE 754 double precision
+#endif
+
+#define RYU_MANTISSA_BITS  52
+#define RYU_EXPONENT_MASK  0x7ff
+#define RYU_BIAS           1023
+#define RYU_POW5_INV_BITS  125
+#define RYU_POW5_BITS      125
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint64_t g_ryu_pow10[20] =
+{
+  UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000),
+  UINT64_C(10000), UINT64_C(100000), UINT64_C(1000000),
+  UINT64_C(10000000), UINT64_C(100000000), UINT64_C(1000000000),
+  UINT64_C(10000000000), UINT64_C(100000000000),
+  UINT64_C(1000000000000), UINT64_C(10000000000000),
+  UINT64_C(100000000000000), UINT64_C(1000000000000000),
+  UINT64_C(10000000000000000), UINT64_C(100000000000000000),
+  UINT64_C(1000000000000000000), UINT64_C(10000000000000000000)
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ryu_pow5bits, ryu_log10pow2 and ryu_log10pow5
+ *
+ * Description:
+ *   Return ceil(log2(5^e)), floor(log10(2^e)) and floor(log10(5^e)) for
+ *   the exponents of a double.
+ *
+ ****************************************************************************/
+
+static inline int32_t ryu_pow5bits(int32_t e)
+{
+  return ((e * 1217359) >> 19) + 1;
+}
+
+static inline int32_t ryu_log10pow2(int32_t e)
+{
+  return (e * 78913) >> 18;
+}
+
+static inline int32_t ryu_log10pow5(int32_t e)
+{
+  return (e * 732923) >> 20;
+}
+
+/****************************************************************************
+ * Name: ryu_umul128
+ *
+ * Description:
+ *   Return the low half of the 128 bit product of a and b and store the
+ *   high half in *high.
+ *
+ ****************************************************************************/
+
+static inline uint64_t ryu_umul128(uint64_t a, uint64_t b,
+                                   FAR uint64_t *high)
+{
+#ifdef __SIZEOF_INT128__
+  __uint128_t p = (__uint128_t)a * b;
+
+  *high = (uint64_t)(p >> 64);
+  return (uint64_t)p;
+#else
+  uint64_t b00 = (uint64_t)(uint32_t)a * (uint32_t)b;
+  uint64_t b01 = (uint64_t)(uint32_t)a * (uint32_t)(b >> 32);
+  uint64_t b10 = (uint64_t)(uint32_t)(a >> 32) * (uint32_t)b;
+  uint64_t b11 = (uint64_t)(uint32_t)(a >> 32) * (uint32_t)(b >> 32);
+  uint64_t mid1 = b10 + (b00 >> 32);
+  uint64_t mid2 = b01 + (uint32_t)mid1;
+
+  *high = b11 + (mid1 >> 32) + (mid2 >> 32);
+  return (mid2 << 32) | (uint32_t)b00;
+#endif
+}
+
+/****************************************************************************
+ * Name: ryu_div5, ryu_div10 and ryu_div100
+ *
+ * Description:
+ *   Divisions by constants.  They are multiplications unless the compiler
+ *   has to call a 64 bit division helper.
+ *
+ ****************************************************************************/
+
+static inline uint64_t ryu_div5(uint64_t x)
+{
+#ifdef __SIZEOF_INT128__
+  return x / 5;
+#else
+  uint64_t high;
+
+  ryu_umul128(x, UINT64_C(0xcccccccccccccccd), &high);
+  return high >> 2;
+#endif
+}
+
+static inline uint64_t ryu_div10(uint64_t x)
+{
+#ifdef __SIZEOF_INT128__
+  return x / 10;
+#else
+  uint64_t high;
+
+  ryu_umul128(x, UINT64_C(0xcccccccccccccccd), &high);
+  return high >> 3;
+#endif
+}
+
+static inline uint64_t ryu_div100(uint64_t x)
+{
+#ifdef __SIZEOF_INT128__
+  return x / 100;
+#else
+  uint64_t high;
+
+  ryu_umul128(x >> 2, UINT64_C(0x28f5c28f5c28f5c3), &high);
+  return high >> 2;
+#endif
+}
+
+/****************************************************************************
+ * Name: ryu_multiple_pow5 and ryu_multiple_pow2
+ *
+ * Description:
+ *   Return true if value, which is not zero, is a multiple of 5^p or 2^p.
+ *
+ ****************************************************************************/
+
+static bool ryu_multiple_pow5(uint64_t value, int32_t p)
+{
+  uint64_t q;
+
+  for (; p > 0; p--)
+    {
+      q = ryu_div5(value);
+      if (value != 5 * q)
+        {
+          return false;
+        }
+
+      value = q;
+    }
+
+  return true;
+}
+
+static inline bool ryu_multiple_pow2(uint64_t value, int32_t p)
+{
+  return p < 64 && (value & ((UINT64_C(1) << p) - 1)) == 0;
+}
+
+/****************************************************************************
+ * Name: ryu_mulshift
+ *
+ * Description:
+ *   Return the product of m and the 128 bit table entry mul, shifted right
+ *   by j bits, with 64 < j < 128.
+ *
+ ****************************************************************************/
+
+static inline uint64_t ryu_mulshift(uint64_t m, FAR const uint64_t *mul,
+                                    int32_t j)
+{
+  uint64_t high0;
+  uint64_t high1;
+  uint64_t low1;
+  uint64_t sum;
+
+  ryu_umul128(m, mul[0], &high0);
+  low1 = ryu_umul128(m, mul[1], &high1);
+
+  sum = high0 + low1;
+  if (sum < high0)
+    {
+      high1++;
+    }
+
+  j -= 64;
+  return (high1 << (64 - j)) | (sum >> j);
+}
+
+/****************************************************************************
+ * Name: ryu_length
+ *
+ * Description:
+ *   Return the number of decimal digits of v.
+ *
+ ****************************************************************************/
+
+static int ryu_length(uint64_t v)
+{
+  int len = 1;
+
+  while (len < 20 && v >= g_ryu_pow10[len])
+    {
+      len++;
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: ryu_digits
+ *
+ * Description:
+ *   Write the len decimal digits of v to buf.
+ *
+ ****************************************************************************/
+
+static void ryu_digits(uint64_t v, int len, FAR char *buf)
+{
+  FAR char *p = buf + len;
+  uint32_t v32;
+  uint32_t r;
+  uint64_t q;
+  int i;
+
+  /* Eight digits per 64 bit division, two per 32 bit one */
+
+  while ((v >> 32) != 0)
+    {
+      q   = v / 100000000;
+      v32 = (uint32_t)(v - q * 100000000);
+      v   = q;
+
+      for (i = 0; i < 4; i++)
+        {
+          r    = v32 % 100;
+          v32 /= 100;
+          *--p = g_ultoa_digits[2 * r + 1];
+          *--p = g_ultoa_digits[2 * r];
+        }
+    }
+
+  v32 = (uint32_t)v;
+  while (p - buf >= 2)
+    {
+      r    = v32 % 100;
+      v32 /= 100;
+      *--p = g_ultoa_digits[2 * r + 1];
+      *--p = g_ultoa_digits[2 * r];
+    }
+
+  if (p > buf)
+    {
+      *--p = '0' + v32;
+    }
+}
+
+/****************************************************************************
+ * Name: ryu_scale
+ *
+ * Description:
+ *   Compute vr = mv * 2^e2 / 10^e10 rounded down, where e10 is chosen so
+ *   that vr has 17 or more digits if bit 52 of m2 is set, as well as vp
+ *   and vm for the upper and lower bounds of the interval of the values
+ *   that round to the double.  The 125 bit tables make the results exact.
+ *
+ ****************************************************************************/
+
+static uint64_t ryu_scale(uint64_t m2, int32_t e2, bool mmshift,
+                          FAR uint64_t *vp, FAR uint64_t *vm,
+                          FAR int32_t *e10, FAR int32_t *q)
+{
+  FAR const uint64_t *mul;
+  uint64_t mv = 4 * m2;
+  int32_t i;
+  int32_t j;
+
+  if (e2 >= 0)
+    {
+      *q   = ryu_log10pow2(e2) - (e2 > 3);
+      *e10 = *q;
+      mul  = g_dtoa_pow5_inv_split[*q];
+      j    = -e2 + *q + RYU_POW5_INV_BITS + ryu_pow5bits(*q) - 1;
+    }
+  else
+    {
+      *q   = ryu_log10pow5(-e2) - (-e2 > 1);
+      *e10 = *q + e2;
+      i    = -e2 - *q;
+      mul  = g_dtoa_pow5_split[i];
+      j    = *q - (ryu_pow5bits(i) - RYU_POW5_BITS);
+    }
+
+  *vp = ryu_mulshift(mv + 2, mul, j);
+  *vm = ryu_mulshift(mv - 1 - mmshift, mul, j);
+  return ryu_mulshift(mv, mul, j);
+}
+
+/****************************************************************************
+ * Name: ryu_shortest
+ *
+ * Description:
+ *   Return the fewest digits that read back to the double m2 * 2^e2 and
+ *   store their exponent in *exp10.  This is the Ryu algorithm of Ulf
+ *   Adams, "Ryu: fast float-to-string conversion", PLDI 2018.
+ *
+ ****************************************************************************/
+
+static uint64_t ryu_shortest(uint64_t m2, int32_t e2, bool mmshift,
+                             FAR int32_t *exp10)
+{
+  bool acceptbounds = (m2 & 1) == 0;
+  bool vmtrailing = false;
+  bool vrtrailing = false;
+  bool roundup = false;
+  uint64_t mv = 4 * m2;
+  uint64_t vr;
+  uint64_t vp;
+  uint64_t vm;
+  int32_t removed = 0;
+  int32_t e10;
+  int32_t q;
+  int lastdigit = 0;
+
+  vr = ryu_scale(m2, e2, mmshift, &vp, &vm, &e10, &q);
+
+  /* Only one of mv - 1 - mmshift, mv and mv + 2 can be a multiple of 5,
+   * and none of them of 5^22.
+   */
+
+  if (e2 >= 0)
+    {
+      if (q <= 21)
+        {
+          if (mv == 5 * ryu_div5(mv))
+            {
+              vrtrailing = ryu_multiple_pow5(mv, q);
+            }
+          else if (acceptbounds)
+            {
+              vmtrailing = ryu_multiple_pow5(mv - 1 - mmshift, q);
+            }
+          else
+            {
+              vp -= ryu_multiple_pow5(mv + 2, q);
+            }
+        }
+    }
+  else if (q <= 1)
+    {
+      /* mv has at least two trailing zero bits */
+
+      vrtrailing = true;
+      if (acceptbounds)
+        {
+          vmtrailing = mmshift;
+        }
+      else
+        {
+          vp--;
+        }
+    }
+  else if (q < 63)
+    {
+      vrtrailing = ryu_multiple_pow2(mv, q);
+    }
+
+  if (vmtrailing || vrtrailing)
+    {
+      /* The rare case of an exact value: remember the removed digits to
+       * round to even.
+       */
+
+      while (ryu_div10(vp) > ryu_div10(vm))
+        {
+          vmtrailing &= vm == 10 * ryu_div10(vm);
+          vrtrailing &= lastdigit == 0;
+          lastdigit   = (int)(vr - 10 * ryu_div10(vr));
+          vr          = ryu_div10(vr);
+          vp          = ryu_div10(vp);
+          vm          = ryu_div10(vm);
+          removed++;
+        }
+
+      if (vmtrailing)
+        {
+          while (vm == 10 * ryu_div10(vm))
+            {
+              vrtrailing &= lastdigit == 0;
+              lastdigit   = (int)(vr - 10 * ryu_div10(vr));
+              vr          = ryu_div10(vr);
+              vp          = ryu_div10(vp);
+              vm          = ryu_div10(vm);
+              removed++;
+            }
+        }
+
+      if (vrtrailing && lastdigit == 5 && (vr & 1) == 0)
+        {
+          lastdigit = 4;
+        }
+
+      vr += (vr == vm && (!acceptbounds || !vmtrailing)) || lastdigit >= 5;
+    }
+  else
+    {
+      /* The common case: two digits at a time first */
+
+      if (ryu_div100(vp) > ryu_div100(vm))
+        {
+          roundup  = vr - 100 * ryu_div100(vr) >= 50;
+          vr       = ryu_div100(vr);
+          vp       = ryu_div100(vp);
+          vm       = ryu_div100(vm);
+          removed += 2;
+        }
+
+      while (ryu_div10(vp) > ryu_div10(vm))
+        {
+          roundup = vr - 10 * ryu_div10(vr) >= 5;
+          vr      = ryu_div10(vr);
+          vp      = ryu_div10(vp);
+          vm      = ryu_div10(vm);
+          removed++;
+        }
+
+      vr += vr == vm || roundup;
+    }
+
+  *exp10 = e10 + removed;
+  return vr;
+}
+
+/****************************************************************************
+ * Name: ryu_exact
+ *
+ * Description:
+ *   Return the leading digits of the double m2 * 2^e2, rounded down, and
+ *   store their exponent in *exp10.  *exact tells whether they are all of
+ *   the digits.
+ *
+ ****************************************************************************/
+
+static uint64_t ryu_exact(uint64_t m2, int32_t e2, FAR int32_t *exp10,
+                          FAR bool *exact)
+{
+  uint64_t vr;
+  uint64_t vp;
+  uint64_t vm;
+  int32_t q;
+
+  vr = ryu_scale(m2, e2, 0, &vp, &vm, exp10, &q);
+
+  if (e2 >= 0)
+    {
+      *exact = ryu_multiple_pow5(4 * m2, q);
+    }
+  else
+    {
+      *exact = ryu_multiple_pow2(4 * m2, q);
+    }
+
+  return vr;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
+                  int max_decimals)
+{
+  uint64_t bits;
+  uint64_t mant;
+  uint64_t half;
+  uint64_t rem;
+  uint64_t vr;
+  int32_t exp = 0;
+  int32_t ieee_exp;
+  int32_t e2;
+  uint8_t flags = 0;
+  bool mmshift;
+  bool exact;
+  int ndigits;
+  int i;
+
+  memcpy(&bits, &x, sizeof(bits));
+  mant     = bits & ((UINT64_C(1) << RYU_MANTISSA_BITS) - 1);
+  ieee_exp = (int32_t)(bits >> RYU_MANTISSA_BITS) & RYU_EXPONENT_MASK;
+
+  if ((bits >> 63) != 0)
+    {
+      flags |= DTOA_MINUS;
+    }
+
+  if (ieee_exp == RYU_EXPONENT_MASK)
+    {
+      flags |= mant != 0 ? DTOA_NAN : DTOA_INF;
+    }
+  else if (ieee_exp == 0 && mant == 0)
+    {
+      flags |= DTOA_ZERO;
+      if (max_digits == 0)
+        {
+          max_digits = 1;
+        }
+
+      for (i = 0; i < max_digits; i++)
+        {
+          dtoa->digits[i] = '0';
+        }
+    }
+  else
+    {
+      /* x = m2 * 2^(e2 + 2), the 2 leaves room for the interval bounds.
+       * The lower bound is closer at a power of two.
+       */
+
+      mmshift = mant != 0 || ieee_exp <= 1;
+
+      if (ieee_exp == 0)
+        {
+          e2 = 1 - RYU_BIAS - RYU_MANTISSA_BITS - 2;
+        }
+      else
+        {
+          e2    = ieee_exp - RYU_BIAS - RYU_MANTISSA_BITS - 2;
+          mant |= UINT64_C(1) << RYU_MANTISSA_BITS;
+        }
+
+      if (max_digits == 0)
+        {
+          vr = ryu_shortest(mant, e2, mmshift, &exp);
+          max_digits = ryu_length(vr);
+          ryu_digits(vr, max_digits, dtoa->digits);
+          exp += max_digits - 1;
+        }
+      else
+        {
+          /* Normalize a subnormal, else vr would have too few digits and
+           * the rest would be taken as zeros.  The power of five table
+           * goes down to the exponent of the smallest one for this.
+           */
+
+          while (mant < (UINT64_C(1) << RYU_MANTISSA_BITS))
+            {
+              mant <<= 1;
+              e2--;
+            }
+
+          vr      = ryu_exact(mant, e2, &exp, &exact);
+          ndigits = ryu_length(vr);
+          exp    += ndigits - 1;
+
+          /* If limiting decimals, then limit the max digits to no more
+           * than the number of digits left of the decimal plus the number
+           * of digits right of the decimal.
+           */
+
+          if (max_decimals != 0)
+            {
+              max_digits = MIN(max_digits, max_decimals + MAX(exp + 1, 0));
+            }
+
+          /* Round the digits that do not fit to nearest, ties to even */
+
+          if (ndigits > max_digits)
+            {
+              half = g_ryu_pow10[ndigits - max_digits];
+              rem  = vr % half;
+              vr  /= half;
+              half /= 2;
+
+              if (rem > half || (rem == half && (!exact || (vr & 1) != 0)))
+                {
+                  if (++vr == g_ryu_pow10[max_digits])
+                    {
+                      vr /= 10;
+                      exp++;
+                    }
+                }
+
+              ndigits = max_digits;
+            }
+
+          ryu_digits(vr, ndigits, dtoa->digits);
+          for (i = ndigits; i < max_digits; i++)
+            {
+              dtoa->digits[i] = '0';
+            }
+        }
+    }
+
+  dtoa->digits[max_digits] = '\0';
+  dtoa->flags = flags;
+  dtoa->exp = exp;
+  return max_digits;
+}
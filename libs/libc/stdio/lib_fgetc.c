@@ -38,6 +38,19 @@ int fgetc_unlocked(FAR FILE *stream)
   unsigned char ch;
   ssize_t ret;
 
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  /* Take the character straight from the read-ahead data */
+
+  if (stream != NULL &&
+#  if CONFIG_NUNGET_CHARS > 0
+      stream->fs_nungotten == 0 &&
+#  endif
+      stream->fs_bufpos < stream->fs_bufread)
+    {
+      return (unsigned char)*stream->fs_bufpos++;
+    }
+#endif
+
   ret = lib_fread_unlocked(&ch, 1, stream);
   if (ret > 0)
     {
@@ -24,6 +24,8 @@
 
 #include <nuttx/config.h>
 
+#include <sys/stat.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -55,6 +57,75 @@
 
 #define FLAG_KEEP (O_TEXT | O_CLOEXEC | O_EXCL)
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_fbuffer
+ *
+ * Description:
+ *   Set up the buffer of a stream being opened.  The standard streams use
+ *   the buffers of the stream list.  The other streams allocate one,
+ *   larger and never line buffered for regular files that are usually
+ *   accessed in bulk; without memory, they are unbuffered.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+static void lib_fbuffer(FAR FILE *filep, int fd,
+                        FAR struct streamlist *list)
+{
+  FAR char *buffer = NULL;
+  bool regular = false;
+  size_t size = 0;
+  struct stat buf;
+
+  filep->fs_flags = 0;
+
+  if (fd < 3)
+    {
+#  if CONFIG_STDIO_BUFFER_SIZE > 0
+      buffer = list->sl_buffer[fd];
+      size   = CONFIG_STDIO_BUFFER_SIZE;
+
+      filep->fs_flags = __FS_FLAG_UBF; /* Fake setvbuf and fclose */
+#  endif
+    }
+  else
+    {
+      regular = fstat(fd, &buf) == 0 && S_ISREG(buf.st_mode);
+      size    = regular ? CONFIG_STDIO_FILE_BUFFER_SIZE :
+                          CONFIG_STDIO_BUFFER_SIZE;
+
+      if (size > 0)
+        {
+          buffer = lib_malloc(size);
+          if (buffer == NULL)
+            {
+              size = 0;
+            }
+        }
+    }
+
+  /* Set up pointers */
+
+  filep->fs_bufstart = buffer;
+  filep->fs_bufend   = buffer + size;
+  filep->fs_bufpos   = buffer;
+  filep->fs_bufread  = buffer;
+
+#  ifdef CONFIG_STDIO_LINEBUFFER
+  /* Setup buffer flags */
+
+  if (buffer != NULL && !regular)
+    {
+      filep->fs_flags |= __FS_FLAG_LBF; /* Line buffering */
+    }
+#  endif
+}
+#endif /* !CONFIG_STDIO_DISABLE_BUFFERING */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -117,22 +188,11 @@ FAR FILE *fdopen(int fd, FAR const char *mode)
       filep = &list->sl_std[fd];
     }
 
-#if !defined(CONFIG_STDIO_DISABLE_BUFFERING) && CONFIG_STDIO_BUFFER_SIZE > 0
-  /* Set up pointers */
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  /* Set up the buffer */
 
-  filep->fs_bufstart = filep->fs_buffer;
-  filep->fs_bufend   = filep->fs_bufstart + CONFIG_STDIO_BUFFER_SIZE;
-  filep->fs_bufpos   = filep->fs_bufstart;
-  filep->fs_bufread  = filep->fs_bufstart;
-  filep->fs_flags    = __FS_FLAG_UBF; /* Fake setvbuf and fclose */
-
-#  ifdef CONFIG_STDIO_LINEBUFFER
-  /* Setup buffer flags */
-
-  filep->fs_flags   |= __FS_FLAG_LBF; /* Line buffering */
-
-#  endif /* CONFIG_STDIO_LINEBUFFER */
-#endif /* !CONFIG_STDIO_DISABLE_BUFFERING && CONFIG_STDIO_BUFFER_SIZE > 0 */
+  lib_fbuffer(filep, fd, list);
+#endif
 
   /* Save the file description and open flags.  Setting the
    * file descriptor locks this stream.
@@ -23,6 +23,8 @@
  ****************************************************************************/
 
 #include <stdio.h>
+#include <fcntl.h>
+
 #include "libc.h"
 
 /****************************************************************************
@@ -38,6 +40,21 @@ int fputc_unlocked(int c, FAR FILE *stream)
   unsigned char buf = (unsigned char)c;
   int ret;
 
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  /* Store the character straight into a write buffer that does not fill
+   * up with it, unless it is a newline flushing a line buffered stream.
+   */
+
+  if (stream != NULL && (stream->fs_oflags & O_WROK) != 0 &&
+      stream->fs_bufread == stream->fs_bufstart &&
+      stream->fs_bufend - stream->fs_bufpos > 1 &&
+      (c != '\n' || (stream->fs_flags & __FS_FLAG_LBF) == 0))
+    {
+      *stream->fs_bufpos++ = buf;
+      return c;
+    }
+#endif
+
   ret = lib_fwrite_unlocked(&buf, 1, stream);
   if (ret > 0)
     {
@@ -51,6 +51,7 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
   FAR const char *src   = ptr;
   ssize_t ret = ERROR;
   size_t gulp_size;
+  size_t buf_size;
 
   /* Make sure that writing to this stream is allowed */
 
@@ -100,10 +101,13 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
       goto errout;
     }
 
-  /* Determine the number of bytes left in the buffer */
+  /* Determine the number of bytes left in the buffer.  Data as large as
+   * the buffer is written directly unless the buffer already holds some.
+   */
 
+  buf_size  = stream->fs_bufend - stream->fs_bufstart;
   gulp_size = stream->fs_bufend - stream->fs_bufpos;
-  if (gulp_size != CONFIG_STDIO_BUFFER_SIZE || count < gulp_size)
+  if (gulp_size != buf_size || count < gulp_size)
     {
       if (gulp_size > count)
         {
@@ -138,7 +142,7 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
         }
     }
 
-  if (count >= CONFIG_STDIO_BUFFER_SIZE)
+  if (count >= buf_size)
     {
       if (stream->fs_iofunc.write != NULL)
         {
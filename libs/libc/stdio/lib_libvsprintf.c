@@ -590,8 +590,19 @@ flt_oper:
             }
           else
             {
-              ndigs = prec;
+              /* A precision of zero is taken as one */
+
+              ndigs = prec > 0 ? prec : 1;
               ndecimal = 0;
+
+#ifdef CONFIG_LIBC_PRINTF_SHORTEST
+              /* No precision: the shortest digits that read back */
+
+              if ((flags & FL_PREC) == 0)
+                {
+                  ndigs = 0;
+                }
+#endif
             }
 
           if (ndigs > DTOA_MAX_DIG)
@@ -685,6 +696,12 @@ flt_oper:
               /* 'g(G)' format */
 
               prec = ndigs;
+#ifdef CONFIG_LIBC_PRINTF_SHORTEST
+              if ((flags & FL_PREC) == 0)
+                {
+                  prec = DTOA_MAX_DIG;
+                }
+#endif
 
               /* Remove trailing zeros */
 
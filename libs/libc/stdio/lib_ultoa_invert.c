@@ -37,8 +37,24 @@
  * Included Files
  ****************************************************************************/
 
+#include <limits.h>
+#include <strings.h>
+
 #include "lib_ultoa_invert.h"
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#if defined(CONFIG_LIBC_PRINTF_FAST_INTEGER) || defined(CONFIG_LIBC_DTOA_RYU)
+const char g_ultoa_digits[200] =
+  "00010203040506070809" "10111213141516171819"
+  "20212223242526272829" "30313233343536373839"
+  "40414243444546474849" "50515253545556575859"
+  "60616263646566676869" "70717273747576777879"
+  "80818283848586878889" "90919293949596979899";
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -57,6 +73,77 @@ FAR char *__ultoa_invert(unsigned long val, FAR char *str, int base)
       base &= ~XTOA_UPPER;
     }
 
+#ifdef CONFIG_LIBC_PRINTF_FAST_INTEGER
+  if (base == 10)
+    {
+      unsigned long lval;
+      unsigned int r;
+
+#  ifdef CONFIG_LIBC_LONG_LONG
+      /* Split off eight digits at a time while the value needs long long
+       * arithmetic, which is slow on 32 bit CPUs.
+       */
+
+      while (val > ULONG_MAX)
+        {
+          unsigned long long q = val / 100000000;
+
+          lval = (unsigned long)(val - q * 100000000);
+          val  = q;
+
+          for (r = 0; r < 4; r++)
+            {
+              unsigned int d = lval % 100;
+
+              lval  /= 100;
+              *str++ = g_ultoa_digits[2 * d + 1];
+              *str++ = g_ultoa_digits[2 * d];
+            }
+        }
+#  endif
+
+      /* Then two digits per division */
+
+      lval = (unsigned long)val;
+      while (lval >= 100)
+        {
+          r      = lval % 100;
+          lval  /= 100;
+          *str++ = g_ultoa_digits[2 * r + 1];
+          *str++ = g_ultoa_digits[2 * r];
+        }
+
+      if (lval >= 10)
+        {
+          *str++ = g_ultoa_digits[2 * lval + 1];
+          *str++ = g_ultoa_digits[2 * lval];
+        }
+      else
+        {
+          *str++ = '0' + lval;
+        }
+
+      return str;
+    }
+  else if ((base & (base - 1)) == 0)
+    {
+      FAR const char *digits = upper ? "0123456789ABCDEF" :
+                                       "0123456789abcdef";
+      int shift = ffs(base) - 1;
+
+      /* Power of two bases need no division */
+
+      do
+        {
+          *str++ = digits[val & (base - 1)];
+          val  >>= shift;
+        }
+      while (val);
+
+      return str;
+    }
+#endif
+
   do
     {
       int v;
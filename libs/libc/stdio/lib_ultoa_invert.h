@@ -59,6 +59,16 @@
 #define XTOA_PREFIX  0x0100    /* Put prefix for octal or hex */
 #define XTOA_UPPER   0x0200    /* Use upper case letters */
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#if defined(CONFIG_LIBC_PRINTF_FAST_INTEGER) || defined(CONFIG_LIBC_DTOA_RYU)
+/* The decimal digits of 0 to 99, two characters each */
+
+extern const char g_ultoa_digits[200];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -0,0 +1,84 @@
+/****************************************************************************
+ * libs/libc/stdlib/lib_parse8digits.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/endian.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_parse8digits
+ *
+ * Description:
+ *   Convert the eight decimal digits at ptr with a few 64 bit operations
+ *   instead of eight multiplications.  The characters are checked one by
+ *   one first, so nothing is read beyond a terminating NUL.
+ *
+ * Input Parameters:
+ *   ptr   - The digits.
+ *   value - Where to store the value of the digits.
+ *
+ * Returned Value:
+ *   True if the next eight characters are all decimal digits.
+ *
+ ****************************************************************************/
+
+bool lib_parse8digits(FAR const char *ptr, FAR uint32_t *value)
+{
+  uint64_t val;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      if (!isdigit(ptr[i]))
+        {
+          return false;
+        }
+    }
+
+  memcpy(&val, ptr, sizeof(val));
+  val = le64toh(val) - UINT64_C(0x3030303030303030);
+
+  /* Combine pairs of digits, then pairs of pairs, then the two halves */
+
+  val = val * 10 + (val >> 8);
+  val = (((val & UINT64_C(0x000000ff000000ff)) *
+          (100 + (UINT64_C(1000000) << 32))) +
+         (((val >> 16) & UINT64_C(0x000000ff000000ff)) *
+          (1 + (UINT64_C(10000) << 32)))) >> 32;
+
+  *value = (uint32_t)val;
+  return true;
+}
@@ -1,42 +1,22 @@
 /****************************************************************************
  * libs/libc/stdlib/lib_qsort.c
  *
- *   Copyright (C) 2007, 2009, 2011 Gregory Nutt. All rights reserved.
- *   Author: Gregory Nutt <gnutt@nuttx.org>
+ * SPDX-License-Identifier: Apache-2.0
  *
- * Leveraged from:
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
  *
- *  Copyright (c) 1992, 1993
- *  The Regents of the University of California.  All rights reserved.
+ *   http://www.apache.org/licenses/LICENSE-2.0
  *
- * Redistribution and use in source and binary forms, with or without
- * modification, are permitted provided that the following conditions
- * are met:
- *
- * 1. Redistributions of source code must retain the above copyright
- *    notice, this list of conditions and the following disclaimer.
- * 2. Redistributions in binary form must reproduce the above copyright
- *    notice, this list of conditions and the following disclaimer in the
- *    documentation and/or other materials provided with the distribution.
- * 3. All advertising materials mentioning features or use of this software
- *    must display the following acknowledgement:
- *    This product includes software developed by the University of
- *    California, Berkeley and its contributors.
- * 4. Neither the name of the University nor the names of its contributors
- *    may be used to endorse or promote products derived from this software
- *    without specific prior written permission.
- *
- * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
- * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
- * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
- * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
- * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
- * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
- * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
- * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
- * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
- * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
- * SUCH DAMAGE.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
  *
  ****************************************************************************/
 
@@ -47,250 +27,619 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
-#include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define swapcode(TYPE, parmi, parmj, n) \
-  { \
-    long i = (n) / sizeof(TYPE); \
-    register FAR TYPE *pi = (FAR TYPE *)(parmi); \
-    register FAR TYPE *pj = (FAR TYPE *)(parmj); \
-    do { \
-      register TYPE t = *pi; \
-      *pi++ = *pj; \
-      *pj++ = t; \
-    } while (--i > 0); \
-  }
-
-#define SWAPINIT(a, width) \
-  swaptype = (uintptr_t)a % sizeof(long) || \
-  width % sizeof(long) ? 2 : width == sizeof(long) ? 0 : 1;
-
-#define swap(a, b) \
-  if (swaptype == 0) \
-    { \
-      long t = *(FAR long *)(a); \
-      *(FAR long *)(a) = *(FAR long *)(b); \
-      *(FAR long *)(b) = t; \
-    } \
-  else \
-    { \
-      swapfunc(a, b, width, swaptype); \
-    }
+/* Partitions below this number of elements are insertion sorted.  Moving
+ * a large element costs more, so they switch earlier.
+ */
+
+#define QSORT_INSERTION(q)  ((q)->width <= 2 * sizeof(long) ? 12 : 8)
+
+/* Partitions above this number of elements take the pivot as the median
+ * of three medians of three.
+ */
 
-#define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
+#define QSORT_NINTHER       128
+
+/* Partial insertion sort gives up after this many moves */
+
+#define QSORT_PARTIAL_LIMIT 8
 
 /****************************************************************************
- * Private Function Prototypes
+ * Private Types
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
-static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *));
+enum qsort_swap_e
+{
+  QSORT_SWAP_U32,                  /* Aligned 4 byte elements */
+  QSORT_SWAP_U64,                  /* Aligned 8 byte elements */
+  QSORT_SWAP_LONG,                 /* Aligned multiples of long */
+  QSORT_SWAP_BYTE                  /* Anything else */
+};
+
+struct qsort_s
+{
+  CODE int (*compar)(FAR const void *, FAR const void *);
+  CODE int (*compar_r)(FAR const void *, FAR const void *, FAR void *);
+  FAR void *arg;
+  size_t width;
+  enum qsort_swap_e swaptype;
+};
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
+static inline int qsort_cmp(FAR const struct qsort_s *q,
+                            FAR const char *a, FAR const char *b)
 {
-  if (swaptype <= 1)
+  return q->compar_r != NULL ? q->compar_r(a, b, q->arg) : q->compar(a, b);
+}
+
+static inline bool qsort_less(FAR const struct qsort_s *q,
+                              FAR const char *a, FAR const char *b)
+{
+  return qsort_cmp(q, a, b) < 0;
+}
+
+static void qsort_swap(FAR const struct qsort_s *q, FAR char *a, FAR char *b)
+{
+  size_t n;
+
+  switch (q->swaptype)
     {
-      swapcode(long, a, b, n)
+      case QSORT_SWAP_U32:
+        {
+          uint32_t t = *(FAR uint32_t *)a;
+          *(FAR uint32_t *)a = *(FAR uint32_t *)b;
+          *(FAR uint32_t *)b = t;
+        }
+        break;
+
+      case QSORT_SWAP_U64:
+        {
+          uint64_t t = *(FAR uint64_t *)a;
+          *(FAR uint64_t *)a = *(FAR uint64_t *)b;
+          *(FAR uint64_t *)b = t;
+        }
+        break;
+
+      case QSORT_SWAP_LONG:
+        for (n = q->width / sizeof(long); n > 0; n--)
+          {
+            long t = *(FAR long *)a;
+            *(FAR long *)a = *(FAR long *)b;
+            *(FAR long *)b = t;
+            a += sizeof(long);
+            b += sizeof(long);
+          }
+        break;
+
+      default:
+        for (n = q->width; n > 0; n--)
+          {
+            char t = *a;
+            *a++ = *b;
+            *b++ = t;
+          }
+        break;
     }
-  else
+}
+
+/****************************************************************************
+ * Name: qsort_sort2 and qsort_sort3
+ *
+ * Description:
+ *   Order two or three elements.
+ *
+ ****************************************************************************/
+
+static void qsort_sort2(FAR const struct qsort_s *q, FAR char *a,
+                        FAR char *b)
+{
+  if (qsort_less(q, b, a))
     {
-      swapcode(char, a, b, n)
+      qsort_swap(q, a, b);
     }
 }
 
-static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *))
+static void qsort_sort3(FAR const struct qsort_s *q, FAR char *a,
+                        FAR char *b, FAR char *c)
 {
-  return compar(a, b) < 0 ?
-         (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a)) :
-         (compar(b, c) > 0 ? b : (compar(a, c) < 0 ? a : c));
+  qsort_sort2(q, a, b);
+  qsort_sort2(q, b, c);
+  qsort_sort2(q, a, b);
 }
 
 /****************************************************************************
- * Public Function
+ * Name: qsort_insertion
+ *
+ * Description:
+ *   Insertion sort [begin, end).  With a limit, give up once more than
+ *   'limit' elements were moved and return false.
+ *
  ****************************************************************************/
 
+static bool qsort_insertion(FAR const struct qsort_s *q, FAR char *begin,
+                            FAR char *end, size_t limit)
+{
+  size_t width = q->width;
+  size_t moves = 0;
+  FAR char *cur;
+  FAR char *sift;
+
+  for (cur = begin + width; cur < end; cur += width)
+    {
+      for (sift = cur; sift > begin && qsort_less(q, sift, sift - width);
+           sift -= width)
+        {
+          qsort_swap(q, sift, sift - width);
+        }
+
+      moves += (cur - sift) / width;
+      if (limit > 0 && moves > limit)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: qsort_heap
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
+ *   Heapsort [begin, begin + n), the O(n log n) fallback when the
+ *   partitions keep coming out unbalanced.
  *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
- *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
+ ****************************************************************************/
+
+static void qsort_siftdown(FAR const struct qsort_s *q, FAR char *begin,
+                           size_t root, size_t n)
+{
+  size_t width = q->width;
+  size_t child;
+
+  while ((child = 2 * root + 1) < n)
+    {
+      if (child + 1 < n &&
+          qsort_less(q, begin + child * width, begin + (child + 1) * width))
+        {
+          child++;
+        }
+
+      if (!qsort_less(q, begin + root * width, begin + child * width))
+        {
+          break;
+        }
+
+      qsort_swap(q, begin + root * width, begin + child * width);
+      root = child;
+    }
+}
+
+static void qsort_heap(FAR const struct qsort_s *q, FAR char *begin,
+                       size_t n)
+{
+  size_t i;
+
+  for (i = n / 2; i > 0; i--)
+    {
+      qsort_siftdown(q, begin, i - 1, n);
+    }
+
+  for (i = n - 1; i > 0; i--)
+    {
+      qsort_swap(q, begin, begin + i * q->width);
+      qsort_siftdown(q, begin, 0, i);
+    }
+}
+
+/****************************************************************************
+ * Name: qsort_partition_right
  *
- *   (Based on description from OpenGroup.org).
+ * Description:
+ *   Partition [begin, end) around the pivot at 'begin': the elements less
+ *   than the pivot go to its left, the others to its right.  The caller
+ *   guarantees that an element not less than the pivot follows it.
  *
  * Returned Value:
- *   The qsort() function will not return a value.
- *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *   The final position of the pivot.  '*partitioned' tells whether no
+ *   element had to be moved.
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static FAR char *qsort_partition_right(FAR const struct qsort_s *q,
+                                       FAR char *begin, FAR char *end,
+                                       FAR bool *partitioned)
 {
-  FAR char *pa;
-  FAR char *pb;
-  FAR char *pc;
-  FAR char *pd;
-  FAR char *pl;
-  FAR char *pm;
-  FAR char *pn;
-  int swaptype;
-  int swap_cnt;
-  int d;
-  int r;
-
-loop:
-  SWAPINIT(base, width);
-  swap_cnt = 0;
-
-  if (nel < 7)
+  size_t width = q->width;
+  FAR char *first = begin;
+  FAR char *last = end;
+
+  do
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      first += width;
+    }
+  while (qsort_less(q, first, begin));
+
+  /* Without an element less than the pivot on the left, the search from
+   * the right needs a bound.
+   */
+
+  if (first - width == begin)
+    {
+      do
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          last -= width;
         }
-
-      return;
+      while (first < last && !qsort_less(q, last, begin));
     }
-
-  pm = (FAR char *)base + (nel / 2) * width;
-  if (nel > 7)
+  else
     {
-      pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
-      if (nel > 40)
+      do
         {
-          d  = (nel / 8) * width;
-          pl = med3(pl, pl + d, pl + 2 * d, compar);
-          pm = med3(pm - d, pm, pm + d, compar);
-          pn = med3(pn - 2 * d, pn - d, pn, compar);
+          last -= width;
         }
-
-      pm = med3(pl, pm, pn, compar);
+      while (!qsort_less(q, last, begin));
     }
 
-  swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+  *partitioned = first >= last;
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
-  for (; ; )
+  while (first < last)
     {
-      while (pb <= pc && (r = compar(pb, base)) <= 0)
+      qsort_swap(q, first, last);
+
+      do
         {
-          if (r == 0)
-            {
-              swap_cnt = 1;
-              swap(pa, pb);
-              pa += width;
-            }
+          first += width;
+        }
+      while (qsort_less(q, first, begin));
 
-          pb += width;
+      do
+        {
+          last -= width;
         }
+      while (!qsort_less(q, last, begin));
+    }
+
+  first -= width;
+  if (first != begin)
+    {
+      qsort_swap(q, begin, first);
+    }
+
+  return first;
+}
+
+/****************************************************************************
+ * Name: qsort_partition_left
+ *
+ * Description:
+ *   Partition [begin, end) around the pivot at 'begin', which is equal to
+ *   the element before 'begin': the elements equal to the pivot go to its
+ *   left, so that runs of equal elements are done in linear time.
+ *
+ ****************************************************************************/
 
-      while (pb <= pc && (r = compar(pc, base)) >= 0)
+static FAR char *qsort_partition_left(FAR const struct qsort_s *q,
+                                      FAR char *begin, FAR char *end)
+{
+  size_t width = q->width;
+  FAR char *first = begin;
+  FAR char *last = end;
+
+  do
+    {
+      last -= width;
+    }
+  while (qsort_less(q, begin, last));
+
+  if (last + width == end)
+    {
+      do
         {
-          if (r == 0)
-            {
-              swap_cnt = 1;
-              swap(pc, pd);
-              pd -= width;
-            }
+          first += width;
+        }
+      while (first < last && !qsort_less(q, begin, first));
+    }
+  else
+    {
+      do
+        {
+          first += width;
+        }
+      while (!qsort_less(q, begin, first));
+    }
+
+  while (first < last)
+    {
+      qsort_swap(q, first, last);
 
-          pc -= width;
+      do
+        {
+          last -= width;
         }
+      while (qsort_less(q, begin, last));
 
-      if (pb > pc)
+      do
         {
-          break;
+          first += width;
         }
+      while (!qsort_less(q, begin, first));
+    }
 
-      swap(pb, pc);
-      swap_cnt = 1;
-      pb      += width;
-      pc      -= width;
+  if (last != begin)
+    {
+      qsort_swap(q, begin, last);
     }
 
-  if (swap_cnt == 0)
+  return last;
+}
+
+/****************************************************************************
+ * Name: qsort_shuffle
+ *
+ * Description:
+ *   Break a pattern that made an unbalanced partition by swapping a few
+ *   elements of the partition of 'n' elements at 'begin'.
+ *
+ ****************************************************************************/
+
+static void qsort_shuffle(FAR const struct qsort_s *q, FAR char *begin,
+                          size_t n)
+{
+  size_t width = q->width;
+  FAR char *end = begin + n * width;
+  size_t quarter = n / 4;
+
+  qsort_swap(q, begin, begin + quarter * width);
+  qsort_swap(q, end - width, end - (quarter + 1) * width);
+
+  if (n > QSORT_NINTHER)
     {
-      /* Switch to insertion sort */
+      qsort_swap(q, begin + width, begin + (quarter + 1) * width);
+      qsort_swap(q, begin + 2 * width, begin + (quarter + 2) * width);
+      qsort_swap(q, end - 2 * width, end - (quarter + 2) * width);
+      qsort_swap(q, end - 3 * width, end - (quarter + 3) * width);
+    }
+}
 
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+/****************************************************************************
+ * Name: qsort_loop
+ *
+ * Description:
+ *   Pattern-defeating quicksort of [begin, end).  'leftmost' tells whether
+ *   there is no element before 'begin'; 'bad' is the number of unbalanced
+ *   partitions allowed before switching to heapsort.
+ *
+ ****************************************************************************/
+
+static void qsort_loop(FAR const struct qsort_s *q, FAR char *begin,
+                       FAR char *end, int bad, bool leftmost)
+{
+  size_t width = q->width;
+  FAR char *pivot;
+  size_t lsize;
+  size_t rsize;
+  size_t half;
+  size_t n;
+  bool partitioned;
+
+  for (; ; )
+    {
+      n = (end - begin) / width;
+      if (n < QSORT_INSERTION(q))
+        {
+          qsort_insertion(q, begin, end, 0);
+          return;
+        }
+
+      /* Move the median of three, or of three medians of three, to the
+       * front.
+       */
+
+      half = (n / 2) * width;
+      if (n > QSORT_NINTHER)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
+          qsort_sort3(q, begin, begin + half, end - width);
+          qsort_sort3(q, begin + width, begin + half - width,
+                      end - 2 * width);
+          qsort_sort3(q, begin + 2 * width, begin + half + width,
+                      end - 3 * width);
+          qsort_sort3(q, begin + half - width, begin + half,
+                      begin + half + width);
+          qsort_swap(q, begin, begin + half);
+        }
+      else
+        {
+          qsort_sort3(q, begin + half, begin, end - width);
+        }
+
+      /* A pivot equal to the element before the partition is its smallest
+       * value: set aside all of its copies at once.
+       */
+
+      if (!leftmost && !qsort_less(q, begin - width, begin))
+        {
+          begin = qsort_partition_left(q, begin, end) + width;
+          continue;
+        }
+
+      pivot = qsort_partition_right(q, begin, end, &partitioned);
+      lsize = (pivot - begin) / width;
+      rsize = (end - pivot) / width - 1;
+
+      if (lsize < n / 8 || rsize < n / 8)
+        {
+          if (--bad == 0)
+            {
+              qsort_heap(q, begin, n);
+              return;
+            }
+
+          if (lsize >= QSORT_INSERTION(q))
             {
-              swap(pl, pl - width);
+              qsort_shuffle(q, begin, lsize);
+            }
+
+          if (rsize >= QSORT_INSERTION(q))
+            {
+              qsort_shuffle(q, pivot + width, rsize);
             }
         }
+      else if (partitioned &&
+               qsort_insertion(q, begin, pivot, QSORT_PARTIAL_LIMIT) &&
+               qsort_insertion(q, pivot + width, end, QSORT_PARTIAL_LIMIT))
+        {
+          /* The input looked sorted and it was */
 
-      return;
+          return;
+        }
+
+      /* Recurse into the smaller side to bound the stack, iterate on the
+       * larger one.
+       */
+
+      if (lsize < rsize)
+        {
+          qsort_loop(q, begin, pivot, bad, leftmost);
+          begin    = pivot + width;
+          leftmost = false;
+        }
+      else
+        {
+          qsort_loop(q, pivot + width, end, bad, false);
+          end = pivot;
+        }
     }
+}
 
-  pn = (FAR char *)base + nel * width;
-  r  = MIN(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
+/****************************************************************************
+ * Name: qsort_run
+ ****************************************************************************/
 
-  r  = MIN(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+static void qsort_run(FAR struct qsort_s *q, FAR void *base, size_t nel)
+{
+  uintptr_t align = (uintptr_t)base | q->width;
+  int bad = 0;
 
-  if ((r = pb - pa) > width)
+  if (nel < 2 || q->width == 0)
     {
-      qsort(base, r / width, width, compar);
+      return;
     }
 
-  if ((r = pd - pc) > width)
+  if (q->width == sizeof(uint32_t) && align % sizeof(uint32_t) == 0)
+    {
+      q->swaptype = QSORT_SWAP_U32;
+    }
+  else if (q->width == sizeof(uint64_t) && align % sizeof(uint64_t) == 0)
+    {
+      q->swaptype = QSORT_SWAP_U64;
+    }
+  else if (align % sizeof(long) == 0)
     {
-      /* Iterate rather than recurse to save stack space */
+      q->swaptype = QSORT_SWAP_LONG;
+    }
+  else
+    {
+      q->swaptype = QSORT_SWAP_BYTE;
+    }
 
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+  /* Allow log2(nel) unbalanced partitions */
+
+  while (nel >> bad)
+    {
+      bad++;
     }
+
+  qsort_loop(q, base, (FAR char *)base + nel * q->width, bad, true);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes:
+ *   Pattern-defeating quicksort, after Orson Peters' pdqsort: introsort
+ *   with a heapsort fallback that guarantees O(n log n), linear time on
+ *   sorted input and runs of equal elements, and word-sized swaps.
+ *
+ ****************************************************************************/
+
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int (*compar)(FAR const void *, FAR const void *))
+{
+  struct qsort_s q;
+
+  q.compar   = compar;
+  q.compar_r = NULL;
+  q.arg      = NULL;
+  q.width    = width;
+
+  qsort_run(&q, base, nel);
+}
+
+/****************************************************************************
+ * Name: qsort_r
+ *
+ * Description:
+ *   Like qsort(), with 'arg' passed as the third argument of 'compar'.
+ *
+ ****************************************************************************/
+
+void qsort_r(FAR void *base, size_t nel, size_t width,
+             CODE int (*compar)(FAR const void *, FAR const void *,
+                                FAR void *),
+             FAR void *arg)
+{
+  struct qsort_s q;
+
+  q.compar   = NULL;
+  q.compar_r = compar;
+  q.arg      = arg;
+  q.width    = width;
+
+  qsort_run(&q, base, nel);
 }
@@ -43,6 +43,8 @@
 #include <errno.h>
 #include <math.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Pre-processor definitions
  ****************************************************************************/
@@ -721,7 +723,16 @@ static long_double strtox(FAR const char *str, FAR char **endptr, int flag)
     }
   else if (isdigit(*s) || (*s == '.' && isdigit(*(s + 1))))
     {
-      y = decfloat(s, endptr);
+#ifdef CONFIG_LIBC_STRTOD_FAST
+      if (bits <= DBL_MANT_DIG)
+        {
+          y = lib_strtod_fast(s, endptr, bits == FLT_MANT_DIG);
+        }
+      else
+#endif
+        {
+          y = decfloat(s, endptr);
+        }
     }
   else
     {
@@ -56,6 +56,7 @@ unsigned long strtoul(FAR const char *nptr, FAR char **endptr, int base)
   unsigned long accum = 0;
   unsigned long limit;
   int value = -1;
+  uint32_t chunk;
   int last_digit;
   char sign = 0;
 
@@ -90,6 +91,17 @@ unsigned long strtoul(FAR const char *nptr, FAR char **endptr, int base)
 
           while (lib_isbasedigit(*nptr, base, &value))
             {
+              /* Eight decimal digits at a time while they cannot overflow */
+
+              if (base == 10 &&
+                  accum <= (ULONG_MAX - 99999999) / 100000000 &&
+                  lib_parse8digits(nptr, &chunk))
+                {
+                  accum = accum * 100000000 + chunk;
+                  nptr += 8;
+                  continue;
+                }
+
               /* Check for overflow */
 
               if (accum > limit || (accum == limit && value > last_digit))
@@ -59,6 +59,7 @@ unsigned long long strtoull(FAR const char *nptr,
   unsigned long long accum = 0;
   unsigned long long limit;
   int value;
+  uint32_t chunk;
   int last_digit;
   char sign = 0;
 
@@ -94,6 +95,17 @@ unsigned long long strtoull(FAR const char *nptr,
 
           while (lib_isbasedigit(*nptr, base, &value))
             {
+              /* Eight decimal digits at a time while they cannot overflow */
+
+              if (base == 10 &&
+                  accum <= (ULLONG_MAX - 99999999) / 100000000 &&
+                  lib_parse8digits(nptr, &chunk))
+                {
+                  accum = accum * 100000000 + chunk;
+                  nptr += 8;
+                  continue;
+                }
+
               /* Check for overflow */
 
               if (accum > limit || (accum == limit && value > last_digit))
@@ -51,7 +51,7 @@ static void stdoutstream_putc(FAR struct lib_outstream_s *self, int ch)
 
   do
     {
-      result = fputc(ch, stream->handle);
+      result = fputc_unlocked(ch, stream->handle);
       if (result != EOF)
         {
           self->nput++;
@@ -84,7 +84,7 @@ static int stdoutstream_puts(FAR struct lib_outstream_s *self,
 
   do
     {
-      result = fwrite(buffer, len, 1, stream->handle);
+      result = fwrite_unlocked(buffer, len, 1, stream->handle);
       if (result >= 0)
         {
           self->nput += result;
@@ -113,7 +113,7 @@ static int stdoutstream_flush(FAR struct lib_outstream_s *self)
                                 (FAR struct lib_stdoutstream_s *)self;
 
   DEBUGASSERT(stream != NULL && stream->handle != NULL);
-  return lib_fflush(stream->handle);
+  return lib_fflush_unlocked(stream->handle);
 }
 #endif
 
@@ -125,7 +125,9 @@ static int stdoutstream_flush(FAR struct lib_outstream_s *self)
  * Name: lib_stdoutstream
  *
  * Description:
- *   Initializes a stream for use with a FILE instance.
+ *   Initializes a stream for use with a FILE instance.  The stream does
+ *   not lock the FILE instance: the caller holds flockfile() on it while
+ *   the stream is in use.
  *
  * Input Parameters:
  *   outstream - User allocated, uninitialized instance of struct
@@ -24,10 +24,23 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORD_MASK      (sizeof(uintptr_t) - 1)
+#define WORD_ONES      (UINTPTR_MAX / 0xff)
+#define WORD_HIGHS     (WORD_ONES * 0x80)
+
+/* Nonzero if any byte of the word 'x' is zero */
+
+#define WORD_HASZERO(x) (((x) - WORD_ONES) & ~(x) & WORD_HIGHS)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -52,6 +65,31 @@ FAR void *memchr(FAR const void *s, int c, size_t n)
 {
   FAR const unsigned char *p = (FAR const unsigned char *)s;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  uintptr_t cw = WORD_ONES * (unsigned char)c;
+
+  /* Check the bytes up to the first word boundary */
+
+  for (; ((uintptr_t)p & WORD_MASK) != 0 && n > 0; p++, n--)
+    {
+      if (*p == (unsigned char)c)
+        {
+          return (FAR void *)p;
+        }
+    }
+
+  /* Skip the words without 'c'.  The bytes of the word holding it are
+   * checked below.
+   */
+
+  while (n >= sizeof(uintptr_t) &&
+         !WORD_HASZERO(*(FAR const uintptr_t *)p ^ cw))
+    {
+      p += sizeof(uintptr_t);
+      n -= sizeof(uintptr_t);
+    }
+#endif
+
   while (n--)
     {
       if (*p == (unsigned char)c)
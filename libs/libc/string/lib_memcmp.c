@@ -24,10 +24,17 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORD_MASK      (sizeof(uintptr_t) - 1)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -40,6 +47,33 @@ int memcmp(FAR const void *s1, FAR const void *s2, size_t n)
   FAR unsigned char *p1 = (FAR unsigned char *)s1;
   FAR unsigned char *p2 = (FAR unsigned char *)s2;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  /* Skip the equal words if the buffers are co-aligned.  The bytes of the
+   * first differing word are compared below.
+   */
+
+  if ((((uintptr_t)p1 ^ (uintptr_t)p2) & WORD_MASK) == 0)
+    {
+      while (((uintptr_t)p1 & WORD_MASK) != 0 && n > 0 && *p1 == *p2)
+        {
+          p1++;
+          p2++;
+          n--;
+        }
+
+      if (((uintptr_t)p1 & WORD_MASK) == 0)
+        {
+          while (n >= sizeof(uintptr_t) &&
+                 *(FAR uintptr_t *)p1 == *(FAR uintptr_t *)p2)
+            {
+              p1 += sizeof(uintptr_t);
+              p2 += sizeof(uintptr_t);
+              n  -= sizeof(uintptr_t);
+            }
+        }
+    }
+#endif
+
   while (n-- > 0)
     {
       if (*p1 < *p2)
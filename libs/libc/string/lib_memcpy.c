@@ -24,10 +24,17 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORD_MASK      (sizeof(uintptr_t) - 1)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -43,6 +50,39 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR unsigned char *pout = (FAR unsigned char *)dest;
   FAR unsigned char *pin  = (FAR unsigned char *)src;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  /* Copy whole words if the source and the destination are co-aligned */
+
+  if ((((uintptr_t)pout ^ (uintptr_t)pin) & WORD_MASK) == 0)
+    {
+      while (((uintptr_t)pout & WORD_MASK) != 0 && n > 0)
+        {
+          *pout++ = *pin++;
+          n--;
+        }
+
+      while (n >= 4 * sizeof(uintptr_t))
+        {
+          ((FAR uintptr_t *)pout)[0] = ((FAR uintptr_t *)pin)[0];
+          ((FAR uintptr_t *)pout)[1] = ((FAR uintptr_t *)pin)[1];
+          ((FAR uintptr_t *)pout)[2] = ((FAR uintptr_t *)pin)[2];
+          ((FAR uintptr_t *)pout)[3] = ((FAR uintptr_t *)pin)[3];
+          pout += 4 * sizeof(uintptr_t);
+          pin  += 4 * sizeof(uintptr_t);
+          n    -= 4 * sizeof(uintptr_t);
+        }
+
+      while (n >= sizeof(uintptr_t))
+        {
+          *(FAR uintptr_t *)pout = *(FAR uintptr_t *)pin;
+          pout += sizeof(uintptr_t);
+          pin  += sizeof(uintptr_t);
+          n    -= sizeof(uintptr_t);
+        }
+    }
+#endif
+
   while (n-- > 0)
     {
       *pout++ = *pin++;
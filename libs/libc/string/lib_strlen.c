@@ -24,20 +24,57 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORD_MASK      (sizeof(uintptr_t) - 1)
+#define WORD_ONES      (UINTPTR_MAX / 0xff)
+#define WORD_HIGHS     (WORD_ONES * 0x80)
+
+/* Nonzero if any byte of the word 'x' is zero */
+
+#define WORD_HASZERO(x) (((x) - WORD_ONES) & ~(x) & WORD_HIGHS)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 #if !defined(CONFIG_LIBC_ARCH_STRLEN) && defined(LIBC_BUILD_STRLEN)
 #undef strlen /* See mm/README.txt */
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+nosanitize_address
+#endif
 size_t strlen(FAR const char *s)
 {
-  FAR const char *sc;
-  for (sc = s; *sc != '\0'; ++sc);
+  FAR const char *sc = s;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  FAR const uintptr_t *wp;
+
+  /* Check the bytes up to the first word boundary, then whole words.  An
+   * aligned word never crosses a page, so reading past the terminator
+   * inside the last word is safe.
+   */
+
+  for (; ((uintptr_t)sc & WORD_MASK) != 0; ++sc)
+    {
+      if (*sc == '\0')
+        {
+          return sc - s;
+        }
+    }
+
+  for (wp = (FAR const uintptr_t *)sc; !WORD_HASZERO(*wp); wp++);
+  sc = (FAR const char *)wp;
+#endif
+
+  for (; *sc != '\0'; ++sc);
   return sc - s;
 }
 #endif
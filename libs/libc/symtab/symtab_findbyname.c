@@ -24,13 +24,185 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 #include <debug.h>
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/mutex.h>
 #include <nuttx/symtab.h>
 
+#include "libc.h"
+
+#ifdef CONFIG_SYMTAB_HASHED
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A hash index over one symbol table.  'bucket' holds the first entry of
+ * each hash chain and 'chain' the next entry of the same chain, -1 ends a
+ * chain.  The index is built on the first lookup in a table.
+ */
+
+struct symtab_hash_s
+{
+  FAR const struct symtab_s *symtab;
+  int nsyms;
+  uint32_t mask;                 /* Number of buckets - 1 */
+  FAR int *bucket;
+  FAR int *chain;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct symtab_hash_s g_symtab_hash[CONFIG_SYMTAB_HASH_NTABLES];
+static unsigned int g_symtab_hashnext;
+static mutex_t g_symtab_hashlock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hashname
+ *
+ * Description:
+ *   The DJB hash function used by GNU hash sections.
+ *
+ ****************************************************************************/
+
+static uint32_t symtab_hashname(FAR const char *name)
+{
+  uint32_t h = 5381;
+
+  while (*name != '\0')
+    {
+      h = (h << 5) + h + (uint8_t)*name++;
+    }
+
+  return h;
+}
+
+/****************************************************************************
+ * Name: symtab_hashbuild
+ *
+ * Description:
+ *   Build the hash index of 'symtab' in 'hash'.
+ *
+ ****************************************************************************/
+
+static int symtab_hashbuild(FAR struct symtab_hash_s *hash,
+                            FAR const struct symtab_s *symtab, int nsyms)
+{
+  uint32_t nbuckets = 1;
+  uint32_t h;
+  int i;
+
+  while (nbuckets < (uint32_t)nsyms)
+    {
+      nbuckets <<= 1;
+    }
+
+  hash->bucket = lib_malloc((nbuckets + nsyms) * sizeof(int));
+  if (hash->bucket == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hash->chain = hash->bucket + nbuckets;
+  hash->mask  = nbuckets - 1;
+  memset(hash->bucket, 0xff, nbuckets * sizeof(int));
+
+  /* Insert backwards so that each chain is in table order and the first
+   * of duplicated names wins, as with the linear search.
+   */
+
+  for (i = nsyms - 1; i >= 0; i--)
+    {
+      h = symtab_hashname(symtab[i].sym_name) & hash->mask;
+      hash->chain[i]  = hash->bucket[h];
+      hash->bucket[h] = i;
+    }
+
+  hash->symtab = symtab;
+  hash->nsyms  = nsyms;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: symtab_hashfind
+ *
+ * Description:
+ *   Look up 'name' through the hash index of 'symtab', building the index
+ *   if needed.  Indexes of the least recently built tables are discarded
+ *   when more than CONFIG_SYMTAB_HASH_NTABLES tables are in use.
+ *
+ * Returned Value:
+ *   Zero (OK) with the entry (or NULL) in 'found', or -ENOMEM if there is
+ *   no index and none could be built.
+ *
+ ****************************************************************************/
+
+static int symtab_hashfind(FAR const struct symtab_s *symtab,
+                           FAR const char *name, int nsyms,
+                           FAR const struct symtab_s **found)
+{
+  FAR struct symtab_hash_s *hash = NULL;
+  int ret = OK;
+  int i;
+
+  nxmutex_lock(&g_symtab_hashlock);
+
+  for (i = 0; i < CONFIG_SYMTAB_HASH_NTABLES; i++)
+    {
+      if (g_symtab_hash[i].symtab == symtab &&
+          g_symtab_hash[i].nsyms == nsyms)
+        {
+          hash = &g_symtab_hash[i];
+          break;
+        }
+    }
+
+  if (hash == NULL)
+    {
+      hash = &g_symtab_hash[g_symtab_hashnext];
+      if (hash->bucket != NULL)
+        {
+          lib_free(hash->bucket);
+          memset(hash, 0, sizeof(*hash));
+        }
+
+      ret = symtab_hashbuild(hash, symtab, nsyms);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      g_symtab_hashnext = (g_symtab_hashnext + 1) %
+                          CONFIG_SYMTAB_HASH_NTABLES;
+    }
+
+  *found = NULL;
+  for (i = hash->bucket[symtab_hashname(name) & hash->mask]; i >= 0;
+       i = hash->chain[i])
+    {
+      if (strcmp(name, symtab[i].sym_name) == 0)
+        {
+          *found = &symtab[i];
+          break;
+        }
+    }
+
+out:
+  nxmutex_unlock(&g_symtab_hashlock);
+  return ret;
+}
+#endif /* CONFIG_SYMTAB_HASHED */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -42,6 +214,8 @@
  *   Find the symbol in the symbol table with the matching name.
  *   This version assumes that table is not ordered with respect to symbol
  *   name and, hence, access time will be linear with respect to nsyms.
+ *   With CONFIG_SYMTAB_HASHED, large tables are searched through a hash
+ *   index instead, built on the first lookup.
  *
  * Returned Value:
  *   A reference to the symbol table entry if an entry with the matching
@@ -75,6 +249,18 @@ symtab_findbyname(FAR const struct symtab_s *symtab,
 
   DEBUGASSERT(name != NULL);
 
+#ifdef CONFIG_SYMTAB_HASHED
+  if (nsyms >= CONFIG_SYMTAB_HASH_MINSYMS)
+    {
+      FAR const struct symtab_s *found;
+
+      if (symtab_hashfind(symtab, name, nsyms, &found) >= 0)
+        {
+          return found;
+        }
+    }
+#endif
+
 #ifdef CONFIG_SYMTAB_ORDEREDBYNAME
   while (low < high)
     {
@@ -0,0 +1,135 @@
+/****************************************************************************
+ * libs/libc/time/lib_clock_gettime.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <syscall.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/vdso.h>
+
+/* The kernel has its own clock_gettime(), user space replaces the system
+ * call proxy with this one.
+ */
+
+#if defined(CONFIG_CLOCK_VDSO) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vdso_gettime
+ *
+ * Description:
+ *   Compute the time from the clock data page.
+ *
+ * Returned Value:
+ *   True on success; false if the system call must be used instead.
+ *
+ ****************************************************************************/
+
+static bool vdso_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  FAR const struct vdso_data_s *vd = VDSO_DATA;
+  struct timespec offset;
+  struct timespec ts;
+  uint64_t delta;
+  uint64_t nsec;
+  uint64_t mult;
+  uint32_t shift;
+  uint32_t seq;
+
+  do
+    {
+      /* Wait until the writer has finished an update in progress */
+
+      while (((seq = __atomic_load_n(&vd->seq, __ATOMIC_ACQUIRE)) & 1) != 0)
+        {
+        }
+
+      delta = up_vdso_counter() - vd->counter;
+      if (delta > vd->maxdelta)
+        {
+          return false;
+        }
+
+      mult   = vd->mult;
+      shift  = vd->shift;
+      ts     = vd->mono;
+      offset = vd->real_offset;
+
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    }
+  while (__atomic_load_n(&vd->seq, __ATOMIC_RELAXED) != seq);
+
+  nsec = ((delta * mult) >> shift) + ts.tv_nsec;
+  ts.tv_sec += nsec / NSEC_PER_SEC;
+  ts.tv_nsec = nsec % NSEC_PER_SEC;
+
+  if (clock_id == CLOCK_REALTIME)
+    {
+      clock_timespec_add(&ts, &offset, &ts);
+    }
+
+  *tp = ts;
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   CLOCK_REALTIME, CLOCK_MONOTONIC and CLOCK_BOOTTIME are read from the
+ *   clock data page without entering the kernel.  The other clocks, and
+ *   the rare case where the page is too old to extrapolate from, use the
+ *   system call.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  if (tp != NULL &&
+      (clock_id == CLOCK_REALTIME || clock_id == CLOCK_MONOTONIC ||
+       clock_id == CLOCK_BOOTTIME) &&
+      vdso_gettime(clock_id, tp))
+    {
+      return OK;
+    }
+
+  return (int)sys_call2((unsigned int)SYS_clock_gettime,
+                        (uintptr_t)clock_id, (uintptr_t)tp);
+}
+
+#endif /* CONFIG_CLOCK_VDSO && !__KERNEL__ */
@@ -25,6 +25,19 @@
 #include <dsp.h>
 #include <string.h>
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* SVM sector indexed by the signs of the auxiliary frame:
+ * (i > 0) | (j > 0) << 1 | (k > 0) << 2, as found by svm3_sector_get().
+ */
+
+static const uint8_t g_svm3_sector[8] =
+{
+  2, 6, 2, 1, 4, 5, 3, 5
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -346,6 +359,57 @@ void svm3(FAR struct svm3_state_f32_s *s, FAR ab_frame_f32_t *v_ab)
    */
 }
 
+/****************************************************************************
+ * Name: svm3_batch
+ *
+ * Description:
+ *   One step of the space vector modulation for n motors, with the same
+ *   results as svm3().
+ *
+ *   In every sector the duty cycles differ by the line voltages and the
+ *   largest and the smallest of them add up to 1, so they are computed
+ *   without the sector: d = x - (max(x) + min(x)) / 2 + 0.5 with
+ *   x = (i + j, j, 0).  With no branches in the loop the compiler can
+ *   vectorize it for Helium (MVE) or NEON.
+ *
+ * Input Parameters:
+ *   s    - (out) array of n SVM data
+ *   v_ab - (in) array of n modulation voltage vectors in alpha-beta frame,
+ *          normalized to magnitude (0.0 - 1.0)
+ *   n    - number of motors
+ *
+ ****************************************************************************/
+
+void svm3_batch(FAR struct svm3_state_f32_s *s,
+                FAR const ab_frame_f32_t *v_ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(s != NULL || n == 0);
+  LIBDSP_DEBUGASSERT(v_ab != NULL || n == 0);
+
+  for (i = 0; i < n; i++)
+    {
+      float ii = -0.5f*v_ab[i].b + SQRT3_BY_TWO_F*v_ab[i].a;
+      float jj = v_ab[i].b;
+      float kk = -jj - ii;
+      float xu = ii + jj;
+      float max = xu > jj ? xu : jj;
+      float min = xu < jj ? xu : jj;
+      float d0;
+
+      max = max > 0.0f ? max : 0.0f;
+      min = min < 0.0f ? min : 0.0f;
+      d0  = 0.5f - 0.5f * (max + min);
+
+      s[i].sector = g_svm3_sector[(ii > 0.0f) | (jj > 0.0f) << 1 |
+                                  (kk > 0.0f) << 2];
+      s[i].d_u    = xu + d0;
+      s[i].d_v    = jj + d0;
+      s[i].d_w    = d0;
+    }
+}
+
 /****************************************************************************
  * Name: svm3_current_correct
  *
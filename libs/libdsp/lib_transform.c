@@ -147,3 +147,154 @@ void inv_park_transform(FAR phase_angle_f32_t *angle,
   ab->a = angle->cos * dq->d - angle->sin * dq->q;
   ab->b = angle->cos * dq->q + angle->sin * dq->d;
 }
+
+/****************************************************************************
+ * Name: clarke_transform_batch
+ *
+ * Description:
+ *   Clarke transform of the abc frames of n motors.
+ *
+ *   The batch functions have no branches and no calls in their loops, so
+ *   the compiler can vectorize them for Helium (MVE) or NEON and process
+ *   several motors with one instruction.
+ *
+ * Input Parameters:
+ *   abc - (in) array of n abc frames
+ *   ab  - (out) array of n alpha-beta frames
+ *   n   - number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_batch(FAR const abc_frame_f32_t *abc,
+                            FAR ab_frame_f32_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(abc != NULL || n == 0);
+  LIBDSP_DEBUGASSERT(ab != NULL || n == 0);
+
+  for (i = 0; i < n; i++)
+    {
+      float a = abc[i].a;
+      float b = abc[i].b;
+
+      ab[i].a = a;
+      ab[i].b = ONE_BY_SQRT3_F*a + TWO_BY_SQRT3_F*b;
+    }
+}
+
+/****************************************************************************
+ * Name: inv_clarke_transform_batch
+ *
+ * Description:
+ *   Inverse Clarke transform of the alpha-beta frames of n motors.
+ *
+ * Input Parameters:
+ *   ab  - (in) array of n alpha-beta frames
+ *   abc - (out) array of n abc frames
+ *   n   - number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_clarke_transform_batch(FAR const ab_frame_f32_t *ab,
+                                FAR abc_frame_f32_t *abc, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(ab != NULL || n == 0);
+  LIBDSP_DEBUGASSERT(abc != NULL || n == 0);
+
+  for (i = 0; i < n; i++)
+    {
+      float a = ab[i].a;
+      float b = -0.5f*ab[i].a + SQRT3_BY_TWO_F*ab[i].b;
+
+      abc[i].a = a;
+      abc[i].b = b;
+      abc[i].c = -a - b;
+    }
+}
+
+/****************************************************************************
+ * Name: park_transform_batch
+ *
+ * Description:
+ *   Park transform of the alpha-beta frames of n motors.
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   ab    - (in) array of n alpha-beta frames
+ *   dq    - (out) array of n direct-quadrature frames
+ *   n     - number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_batch(FAR const phase_angle_f32_t *angle,
+                          FAR const ab_frame_f32_t *ab,
+                          FAR dq_frame_f32_t *dq, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL || n == 0);
+  LIBDSP_DEBUGASSERT(ab != NULL || n == 0);
+  LIBDSP_DEBUGASSERT(dq != NULL || n == 0);
+
+  for (i = 0; i < n; i++)
+    {
+      float s = angle[i].sin;
+      float c = angle[i].cos;
+      float a = ab[i].a;
+      float b = ab[i].b;
+
+      dq[i].d = c * a + s * b;
+      dq[i].q = c * b - s * a;
+    }
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_batch
+ *
+ * Description:
+ *   Inverse Park transform of the direct-quadrature frames of n motors.
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   dq    - (in) array of n direct-quadrature frames
+ *   ab    - (out) array of n alpha-beta frames
+ *   n     - number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_batch(FAR const phase_angle_f32_t *angle,
+                              FAR const dq_frame_f32_t *dq,
+                              FAR ab_frame_f32_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL || n == 0);
+  LIBDSP_DEBUGASSERT(dq != NULL || n == 0);
+  LIBDSP_DEBUGASSERT(ab != NULL || n == 0);
+
+  for (i = 0; i < n; i++)
+    {
+      float s = angle[i].sin;
+      float c = angle[i].cos;
+      float d = dq[i].d;
+      float q = dq[i].q;
+
+      ab[i].a = c * d - s * q;
+      ab[i].b = c * q + s * d;
+    }
+}
@@ -0,0 +1,355 @@
+/****************************************************************************
+ * libs/libm/libm/lib_vmathf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef CONFIG_LIBM_VECTOR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The arrays are processed in blocks of this many elements: the kernels
+ * write a block to the stack, the few arguments they do not handle are
+ * then replaced by the results of the scalar functions.
+ */
+
+#define VMATHF_BLOCK      32
+
+/* Adding and subtracting 1.5 * 2^23 rounds to the nearest integer and
+ * leaves that integer in the low bits of the sum.
+ */
+
+#define VMATHF_SHIFT      12582912.0f
+
+/* Arguments with (bits & mask) - low > span are left to the scalar
+ * functions.
+ */
+
+#define VMATHF_ABS_MASK   0x7fffffffu
+#define VMATHF_SIN_SPAN   0x46000000u   /* |x| <= 8192 */
+#define VMATHF_EXP_SPAN   0x42ac0000u   /* |x| <= 86, a normal result */
+#define VMATHF_POS_LOW    0x00800000u   /* Positive normal numbers */
+#define VMATHF_POS_SPAN   (0x7f7fffffu - VMATHF_POS_LOW)
+
+/* pi/2 split into 1.5703125 + PIO2_2 + PIO2_3 so that n * PIO2_1 and
+ * n * PIO2_2 are exact for |n| < 2^13.
+ */
+
+#define VMATHF_2_BY_PI    0.636619772367581343f
+#define VMATHF_PIO2_1     1.5703125f
+#define VMATHF_PIO2_2     4.837512969970703125e-4f
+#define VMATHF_PIO2_3     7.54978995489188216e-8f
+
+/* ln(2) split into 0.693359375 - LN2_LO */
+
+#define VMATHF_LOG2E      1.44269504088896341f
+#define VMATHF_LN2_HI     0.693359375f
+#define VMATHF_LN2_LO     (-2.12194440e-4f)
+
+/* Polynomials.  The default ones are the Cephes single precision
+ * approximations: the results are within 1.5 ULP, except for the sine and
+ * the cosine of |x| > pi close to their zeros, where the error of the
+ * argument reduction stays below 1e-7.  The reduced ones are minimax fits
+ * with two to five terms less and an error below 2e-5.
+ */
+
+#ifdef CONFIG_LIBM_VECTOR_FAST
+#  define VMATHF_SIN(z) \
+     (-1.66633904e-1f + (z) * 8.16328205e-3f)
+#  define VMATHF_COS(z) \
+     (-4.99760557e-1f + (z) * 4.04584528e-2f)
+#  define VMATHF_EXP(r) \
+     (5.00051162e-1f + (r) * (1.67535144e-1f + (r) * 4.12777353e-2f))
+#  define VMATHF_LOG(f) \
+     (3.32854715e-1f + (f) * (-2.52450070e-1f + (f) * \
+     (2.17764958e-1f + (f) * -1.45924241e-1f)))
+#else
+#  define VMATHF_SIN(z) \
+     (-1.6666654611e-1f + (z) * (8.3321608736e-3f + \
+     (z) * -1.9515295891e-4f))
+#  define VMATHF_COS(z) \
+     (-0.5f + (z) * (4.166664568298827e-2f + (z) * \
+     (-1.388731625493765e-3f + (z) * 2.443315711809948e-5f)))
+#  define VMATHF_EXP(r) \
+     (5.0000001201e-1f + (r) * (1.6666665459e-1f + (r) * \
+     (4.1665795894e-2f + (r) * (8.3334519073e-3f + (r) * \
+     (1.3981999507e-3f + (r) * 1.9875691500e-4f)))))
+#  define VMATHF_LOG(f) \
+     (3.3333331174e-1f + (f) * (-2.4999993993e-1f + (f) * \
+     (2.0000714765e-1f + (f) * (-1.6668057665e-1f + (f) * \
+     (1.4249322787e-1f + (f) * (-1.2420140846e-1f + (f) * \
+     (1.1676998740e-1f + (f) * (-1.1514610310e-1f + (f) * \
+     7.0376836292e-2f))))))))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE void (*vmathf_kernel_t)(FAR const float *x, FAR float *y,
+                                     size_t n, uint32_t arg);
+typedef CODE float (*vmathf_scalar_t)(float x);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t vmathf_asuint(float x)
+{
+  uint32_t u;
+
+  memcpy(&u, &x, sizeof(u));
+  return u;
+}
+
+static inline float vmathf_asfloat(uint32_t u)
+{
+  float x;
+
+  memcpy(&x, &u, sizeof(x));
+  return x;
+}
+
+/****************************************************************************
+ * Name: vmathf_sin_kernel
+ *
+ * Description:
+ *   sin(x + arg * pi/2) for |x| <= 8192.  Both the sine and the cosine of
+ *   the reduced argument are computed and the quadrant selects one of them
+ *   without a branch.
+ *
+ ****************************************************************************/
+
+static void vmathf_sin_kernel(FAR const float *x, FAR float *y, size_t n,
+                              uint32_t arg)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      float k = x[i] * VMATHF_2_BY_PI + VMATHF_SHIFT;
+      uint32_t q = vmathf_asuint(k) + arg;
+      float fn = k - VMATHF_SHIFT;
+      float r = x[i] - fn * VMATHF_PIO2_1 - fn * VMATHF_PIO2_2 -
+                fn * VMATHF_PIO2_3;
+      float z = r * r;
+      float s = r + r * z * VMATHF_SIN(z);
+      float c = 1.0f + z * VMATHF_COS(z);
+      float v = (q & 1) != 0 ? c : s;
+
+      y[i] = vmathf_asfloat(vmathf_asuint(v) ^ ((q & 2) << 30));
+    }
+}
+
+/****************************************************************************
+ * Name: vmathf_exp_kernel
+ *
+ * Description:
+ *   exp(x) = 2^n * exp(r) with |r| <= ln(2)/2, for results that are
+ *   normal numbers.
+ *
+ ****************************************************************************/
+
+static void vmathf_exp_kernel(FAR const float *x, FAR float *y, size_t n,
+                              uint32_t arg)
+{
+  size_t i;
+
+  UNUSED(arg);
+
+  for (i = 0; i < n; i++)
+    {
+      float k = x[i] * VMATHF_LOG2E + VMATHF_SHIFT;
+      uint32_t e = vmathf_asuint(k) - vmathf_asuint(VMATHF_SHIFT);
+      float fn = k - VMATHF_SHIFT;
+      float r = x[i] - fn * VMATHF_LN2_HI - fn * VMATHF_LN2_LO;
+      float p = 1.0f + r + r * r * VMATHF_EXP(r);
+
+      y[i] = vmathf_asfloat(vmathf_asuint(p) + (e << 23));
+    }
+}
+
+/****************************************************************************
+ * Name: vmathf_log_kernel
+ *
+ * Description:
+ *   log(x) = e * ln(2) + log(1 + f) with sqrt(1/2) <= 1 + f < sqrt(2),
+ *   for positive normal numbers.
+ *
+ ****************************************************************************/
+
+static void vmathf_log_kernel(FAR const float *x, FAR float *y, size_t n,
+                              uint32_t arg)
+{
+  size_t i;
+
+  UNUSED(arg);
+
+  for (i = 0; i < n; i++)
+    {
+      uint32_t u = vmathf_asuint(x[i]);
+      uint32_t t = u - 0x3f3504f3u;
+      float e = (float)((int32_t)t >> 23);
+      float f = vmathf_asfloat(u - (t & 0xff800000u)) - 1.0f;
+      float z = f * f;
+
+      y[i] = f + (f * z * VMATHF_LOG(f) + e * VMATHF_LN2_LO - 0.5f * z) +
+             e * VMATHF_LN2_HI;
+    }
+}
+
+/****************************************************************************
+ * Name: vmathf_sqrt_kernel
+ *
+ * Description:
+ *   Refine an estimate of 1 / sqrt(x) with Newton iterations and multiply
+ *   it by x, for positive normal numbers.
+ *
+ ****************************************************************************/
+
+static void vmathf_sqrt_kernel(FAR const float *x, FAR float *y, size_t n,
+                               uint32_t arg)
+{
+  size_t i;
+
+  UNUSED(arg);
+
+  for (i = 0; i < n; i++)
+    {
+      float h = 0.5f * x[i];
+      float r = vmathf_asfloat(0x5f375a86u - (vmathf_asuint(x[i]) >> 1));
+      float s;
+
+      r = r * (1.5f - h * r * r);
+      r = r * (1.5f - h * r * r);
+      s = x[i] * r;
+#ifndef CONFIG_LIBM_VECTOR_FAST
+      s = s + r * (h - 0.5f * s * s);
+#endif
+      y[i] = s;
+    }
+}
+
+/****************************************************************************
+ * Name: vmathf_map
+ *
+ * Description:
+ *   Apply a kernel to the array block by block and fix the results of the
+ *   arguments out of its range with the scalar function.  This is inlined
+ *   into every caller so the kernel gets inlined and vectorized too.  x
+ *   and y may be the same array.
+ *
+ ****************************************************************************/
+
+static inline_function
+void vmathf_map(FAR const float *x, FAR float *y, size_t n,
+                vmathf_kernel_t kernel, uint32_t arg,
+                vmathf_scalar_t scalar, uint32_t mask, uint32_t low,
+                uint32_t span)
+{
+  float buf[VMATHF_BLOCK];
+  size_t len;
+  size_t i;
+
+  while (n > 0)
+    {
+      len = MIN(n, VMATHF_BLOCK);
+      kernel(x, buf, len, arg);
+
+      for (i = 0; i < len; i++)
+        {
+          if ((vmathf_asuint(x[i]) & mask) - low > span)
+            {
+              buf[i] = scalar(x[i]);
+            }
+        }
+
+      memcpy(y, buf, len * sizeof(float));
+      x += len;
+      y += len;
+      n -= len;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vsinf, vcosf, vexpf, vlogf and vsqrtf
+ *
+ * Description:
+ *   y[i] = f(x[i]) for 0 <= i < n.  The loops have no branches and no
+ *   calls, so the compiler can vectorize them for NEON, RVV, SSE or Helium.
+ *   Arguments out of the range of the fast path, like huge angles,
+ *   infinities, NaNs, subnormal numbers and domain errors, are passed to
+ *   the scalar functions.  x and y may be the same array.
+ *
+ * Input Parameters:
+ *   x - The arguments
+ *   y - The results
+ *   n - The number of elements
+ *
+ ****************************************************************************/
+
+void vsinf(FAR const float *x, FAR float *y, size_t n)
+{
+  vmathf_map(x, y, n, vmathf_sin_kernel, 0, sinf,
+             VMATHF_ABS_MASK, 0, VMATHF_SIN_SPAN);
+}
+
+void vcosf(FAR const float *x, FAR float *y, size_t n)
+{
+  vmathf_map(x, y, n, vmathf_sin_kernel, 1, cosf,
+             VMATHF_ABS_MASK, 0, VMATHF_SIN_SPAN);
+}
+
+void vexpf(FAR const float *x, FAR float *y, size_t n)
+{
+  vmathf_map(x, y, n, vmathf_exp_kernel, 0, expf,
+             VMATHF_ABS_MASK, 0, VMATHF_EXP_SPAN);
+}
+
+void vlogf(FAR const float *x, FAR float *y, size_t n)
+{
+  vmathf_map(x, y, n, vmathf_log_kernel, 0, logf,
+             UINT32_MAX, VMATHF_POS_LOW, VMATHF_POS_SPAN);
+}
+
+void vsqrtf(FAR const float *x, FAR float *y, size_t n)
+{
+  vmathf_map(x, y, n, vmathf_sqrt_kernel, 0, sqrtf,
+             UINT32_MAX, VMATHF_POS_LOW, VMATHF_POS_SPAN);
+}
+
+#endif /* CONFIG_LIBM_VECTOR */
@@ -26,74 +26,6 @@
 #include <fixedmath.h>
 #include <nuttx/video/rgbcolors.h>
 
-/****************************************************************************
- * Private Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: nxglib_rgb24_blend and nxglib_rgb565_blend
- *
- * Description:
- *   Blend a single RGB color component.  This is *not* alpha blending:
- *   component2 is assumed to be opaque and "under" a semi-transparent
- *   component1.
- *
- *   The frac1 value could be though as related to the 1/alpha value for
- *   component1.
- *   However, the background, component2, is always treated as though
- *   alpha == 1.
- *
- *   This algorithm is used to handle endpoints as part of the
- *   implementation of anti-aliasing without transparency.
- *
- * Input Parameters:
- *   component1 - The semi-transparent, foreground 8-bit color component
- *   component2 - The opaque, background color component
- *   frac1  - The fractional amount of component1 to blend into component2
- *
- * Returned Value:
- *   The blended 8-bit color component.
- *
- ****************************************************************************/
-
-#if !defined(CONFIG_NX_DISABLE_16BPP) || !defined(CONFIG_NX_DISABLE_24BPP) || \
-    !defined(CONFIG_NX_DISABLE_32BPP)
-
-static uint8_t nxglib_blend_component(uint8_t component1, uint8_t component2,
-                                     ub8_t frac1)
-{
-  uint16_t blend;
-  uint32_t blendb8;
-
-  /* Use a uint32_t for the intermediate calculation.  Due to rounding this
-   * value could exceed ub8MAX (0xffff == 255.999..).
-   *
-   * Hmm.. that might not actually be possible but this gives me piece of
-   * mind and there should not be any particular overhead on a 32-bit
-   * processor.
-   */
-
-  blendb8 = (uint32_t)((ub16_t)component1 * frac1) +
-            (uint32_t)((ub16_t)component2 * (b8ONE - frac1)) +
-            (uint32_t)b8HALF;
-
-  /* Now we can snap it down to 16-bits and check for the overflow
-   * condition.
-   */
-
-  blend = ub8toi(blendb8);
-  if (blend > 255)
-    {
-      blend = 255;
-    }
-
-  /* Return the blended value */
-
-  return (uint8_t)blend;
-}
-
-#endif
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -113,6 +45,9 @@ static uint8_t nxglib_blend_component(uint8_t component1, uint8_t component2,
  *   This algorithm is used to handle endpoints as part of the
  *   implementation of anti-aliasing without transparency.
  *
+ *   The color components are blended together in one 32-bit register,
+ *   each of them in its own field wide enough to hold the products.
+ *
  * Input Parameters:
  *   color1 - The semi-transparent, foreground color
  *   color2 - The opaque, background color
@@ -127,10 +62,8 @@ static uint8_t nxglib_blend_component(uint8_t component1, uint8_t component2,
 
 uint32_t nxglib_rgb24_blend(uint32_t color1, uint32_t color2, ub16_t frac1)
 {
-  uint8_t r;
-  uint8_t g;
-  uint8_t b;
-  uint8_t bg;
+  uint32_t rb;
+  uint32_t g;
   ub8_t fracb8;
 
   /* Convert the fraction to ub8_t.  We don't need that much precision to
@@ -153,23 +86,18 @@ uint32_t nxglib_rgb24_blend(uint32_t color1, uint32_t color2, ub16_t frac1)
       return color2;
     }
 
-  /* Separate and blend each component */
-
-  r  = RGB24RED(color1);
-  bg = RGB24RED(color2);
-  r  = nxglib_blend_component(r, bg, fracb8);
-
-  g  = RGB24GREEN(color1);
-  bg = RGB24GREEN(color2);
-  g  = nxglib_blend_component(g, bg, fracb8);
+  /* Blend red and blue together, each in a 16-bit field, then green.
+   * Neither field can overflow:  255 * 256 + 128 < 65536.
+   */
 
-  b  = RGB24BLUE(color1);
-  bg = RGB24BLUE(color2);
-  b  = nxglib_blend_component(b, bg, fracb8);
+  rb = (color1 & 0xff00ff) * fracb8 +
+       (color2 & 0xff00ff) * (b8ONE - fracb8) + 0x800080;
+  g  = (color1 & 0x00ff00) * fracb8 +
+       (color2 & 0x00ff00) * (b8ONE - fracb8) + 0x008000;
 
   /* Recombine and return the blended value */
 
-  return RGBTO24(r, g, b);
+  return ((rb >> 8) & 0xff00ff) | ((g >> 8) & 0x00ff00);
 }
 
 #endif
@@ -178,44 +106,41 @@ uint32_t nxglib_rgb24_blend(uint32_t color1, uint32_t color2, ub16_t frac1)
 
 uint16_t nxglib_rgb565_blend(uint16_t color1, uint16_t color2, ub16_t frac1)
 {
-  uint8_t r;
-  uint8_t g;
-  uint8_t b;
-  uint8_t bg;
-  ub8_t fracb8;
+  uint32_t wide1;
+  uint32_t wide2;
+  uint32_t blend;
+  uint32_t frac5;
 
-  /* Convert the fraction to ub8_t.  We don't need that much precision. */
+  /* Convert the fraction to 5 bits, the precision of red and blue */
 
-  fracb8 = ub16toub8(frac1);
+  frac5 = (ub16toub8(frac1) + 4) >> 3;
 
   /* Some limit checks */
 
-  if (fracb8 >= b8ONE)
+  if (frac5 >= 32)
     {
       return color1;
     }
-  else if (fracb8 == 0)
+  else if (frac5 == 0)
     {
       return color2;
     }
 
-  /* Separate and blend each component */
+  /* Spread the components apart as 00000gggggg00000rrrrr000000bbbbb so
+   * that each has room for the product with the 5-bit fraction.
+   */
 
-  r  = RGB16RED(color1);
-  bg = RGB16RED(color2);
-  r  = nxglib_blend_component(r, bg, fracb8);
+  wide1 = (color1 | ((uint32_t)color1 << 16)) & 0x07e0f81f;
+  wide2 = (color2 | ((uint32_t)color2 << 16)) & 0x07e0f81f;
 
-  g  = RGB16GREEN(color1);
-  bg = RGB16GREEN(color2);
-  g  = nxglib_blend_component(g, bg, fracb8);
+  /* Blend all components at once, rounding each of them */
 
-  b  = RGB16BLUE(color1);
-  bg = RGB16BLUE(color2);
-  b  = nxglib_blend_component(b, bg, fracb8);
+  blend = (wide1 * frac5 + wide2 * (32 - frac5) + 0x02008010) >> 5;
+  blend &= 0x07e0f81f;
 
   /* Recombine and return the blended value */
 
-  return RGBTO24(r, g, b);
+  return (uint16_t)(blend | (blend >> 16));
 }
 
 #endif
@@ -104,7 +104,7 @@ int nx_bitmap(NXWINDOW hwnd, FAR const struct nxgl_rect_s *dest,
 
   /* Forward the fill command to the server */
 
-  ret = nxmu_sendwindow(wnd, &outmsg, sizeof(struct nxsvrmsg_bitmap_s));
+  ret = nxmu_ringwindow(wnd, &outmsg, sizeof(struct nxsvrmsg_bitmap_s));
 
   /* Wait that the command is completed, so that caller can release the
    * buffer.
@@ -110,6 +110,21 @@ NXHANDLE nx_connectinstance(FAR const char *svrmqname)
       goto errout;
     }
 
+#ifdef NX_CMDRING
+  /* Allocate the drawing command ring shared with the server */
+
+  conn->ring = (FAR struct nxmu_cmdring_s *)
+    lib_uzalloc(sizeof(struct nxmu_cmdring_s));
+  if (!conn->ring)
+    {
+      set_errno(ENOMEM);
+      goto errout_with_conn;
+    }
+
+  nxmutex_init(&conn->ring->lock);
+  nxsem_init(&conn->ring->space, 0, 0);
+#endif
+
   /* Create the client MQ name */
 
   nxmutex_lock(&g_nxliblock);
@@ -192,6 +207,15 @@ errout_with_wmq:
 errout_with_rmq:
   _MQ_CLOSE(conn->crdmq);
 errout_with_conn:
+#ifdef NX_CMDRING
+  if (conn->ring)
+    {
+      nxmutex_destroy(&conn->ring->lock);
+      nxsem_destroy(&conn->ring->space);
+      lib_ufree(conn->ring);
+    }
+
+#endif
   lib_ufree(conn);
 errout:
   return NULL;
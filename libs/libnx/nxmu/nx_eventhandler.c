@@ -67,6 +67,14 @@ static inline void nx_disconnected(FAR struct nxmu_conn_s *conn)
   _MQ_CLOSE(conn->cwrmq);
   _MQ_CLOSE(conn->crdmq);
 
+#ifdef NX_CMDRING
+  /* The server executed the whole ring before it disconnected */
+
+  nxmutex_destroy(&conn->ring->lock);
+  nxsem_destroy(&conn->ring->space);
+  lib_ufree(conn->ring);
+#endif
+
   /* And free the client structure */
 
   lib_ufree(conn);
@@ -115,6 +115,6 @@ int nx_filltrapezoid(NXWINDOW hwnd, FAR const struct nxgl_rect_s *clip,
 
   /* Forward the trapezoid fill command to the server */
 
-  return nxmu_sendwindow(wnd, &outmsg,
+  return nxmu_ringwindow(wnd, &outmsg,
                          sizeof(struct nxsvrmsg_filltrapezoid_s));
 }
@@ -0,0 +1,96 @@
+/****************************************************************************
+ * libs/libnx/nxmu/nx_flush.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxmu.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_flush
+ *
+ * Description:
+ *   Wait until the server has executed all drawing commands sent on this
+ *   connection.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect()
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_flush(NXHANDLE handle)
+{
+  FAR struct nxmu_conn_s *conn = (FAR struct nxmu_conn_s *)handle;
+  struct nxsvrmsg_fence_s outmsg;
+  sem_t sem_done;
+  int ret;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (conn == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  /* The fence follows the drawing commands in the ring, so the server
+   * reaches it when they are all done.
+   */
+
+  outmsg.msgid    = NX_SVRMSG_FENCE;
+  outmsg.sem_done = &sem_done;
+
+  ret = nxsem_init(&sem_done, 0, 0);
+  if (ret < 0)
+    {
+      gerr("ERROR: nxsem_init failed: %d\n", ret);
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  ret = nxmu_sendring(conn, &outmsg, sizeof(struct nxsvrmsg_fence_s));
+  if (ret == OK)
+    {
+      ret = nxsem_wait_uninterruptible(&sem_done);
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          ret = ERROR;
+        }
+    }
+
+  nxsem_destroy(&sem_done);
+  return ret;
+}
@@ -80,5 +80,5 @@ int nx_setpixel(NXWINDOW hwnd, FAR const struct nxgl_point_s *pos,
 
   /* Forward the fill command to the server */
 
-  return nxmu_sendwindow(wnd, &outmsg, sizeof(struct nxsvrmsg_setpixel_s));
+  return nxmu_ringwindow(wnd, &outmsg, sizeof(struct nxsvrmsg_setpixel_s));
 }
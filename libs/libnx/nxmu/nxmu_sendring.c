@@ -0,0 +1,221 @@
+/****************************************************************************
+ * libs/libnx/nxmu/nxmu_sendring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nx/nxbe.h>
+#include <nuttx/nx/nxmu.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmu_kickring
+ *
+ * Description:
+ *   Make sure that the server is going to empty the ring.
+ *
+ ****************************************************************************/
+
+#ifdef NX_CMDRING
+static int nxmu_kickring(FAR struct nxmu_conn_s *conn)
+{
+  FAR struct nxmu_cmdring_s *ring = conn->ring;
+  struct nxsvrmsg_s outmsg;
+  int ret;
+
+  if (atomic_exchange(&ring->pending, 1) != 0)
+    {
+      return OK;
+    }
+
+  outmsg.msgid = NX_SVRMSG_CMDRING;
+  outmsg.conn  = conn;
+
+  ret = nxmu_sendserver(conn, &outmsg, sizeof(struct nxsvrmsg_s));
+  if (ret < 0)
+    {
+      atomic_store(&ring->pending, 0);
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmu_sendring
+ *
+ * Description:
+ *  Queue a drawing command in the command ring of the connection.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *   msg    - A pointer to the message to send
+ *   msglen - The length of the message in bytes.
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nxmu_sendring(FAR struct nxmu_conn_s *conn, FAR const void *msg,
+                  size_t msglen)
+{
+#ifdef NX_CMDRING
+  FAR struct nxmu_cmdring_s *ring = conn->ring;
+  FAR uint8_t *buffer;
+  unsigned int reclen;
+  unsigned int head;
+  unsigned int tail;
+  unsigned int need;
+  unsigned int end;
+  int ret = OK;
+
+  if (ring == NULL)
+    {
+      return nxmu_sendserver(conn, msg, msglen);
+    }
+
+  DEBUGASSERT(msglen <= NX_MXSVRMSGLEN);
+
+  buffer = (FAR uint8_t *)ring->buffer;
+  reclen = NX_CMDRING_RECLEN(msglen);
+
+  nxmutex_lock(&ring->lock);
+
+  /* Only this client moves the head, the server only reads it */
+
+  head = atomic_load(&ring->head);
+  end  = CONFIG_NX_CMDRING_SIZE - (head & NX_CMDRING_MASK);
+  need = end < reclen ? end + reclen : reclen;
+
+  /* Wait until the server has made enough space */
+
+  for (; ; )
+    {
+      tail = atomic_load(&ring->tail);
+      if (CONFIG_NX_CMDRING_SIZE - (head - tail) >= need)
+        {
+          break;
+        }
+
+      atomic_store(&ring->waiting, 1);
+      if (CONFIG_NX_CMDRING_SIZE - (head - atomic_load(&ring->tail)) >=
+          need)
+        {
+          continue;
+        }
+
+      ret = nxmu_kickring(conn);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      ret = nxsem_wait_uninterruptible(&ring->space);
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          ret = ERROR;
+          goto out;
+        }
+    }
+
+  /* A command is never split: skip the end of the ring if it is too
+   * short.
+   */
+
+  if (end < reclen)
+    {
+      *(FAR uint32_t *)&buffer[head & NX_CMDRING_MASK] = 0;
+      head += end;
+    }
+
+  *(FAR uint32_t *)&buffer[head & NX_CMDRING_MASK] = msglen;
+  memcpy(&buffer[(head & NX_CMDRING_MASK) + sizeof(uint32_t)], msg, msglen);
+
+  /* Publish the command, then notify the server if needed */
+
+  atomic_store(&ring->head, head + reclen);
+  ret = nxmu_kickring(conn);
+
+out:
+  nxmutex_unlock(&ring->lock);
+  return ret;
+#else
+  return nxmu_sendserver(conn, msg, msglen);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxmu_ringwindow
+ *
+ * Description:
+ *  Queue a drawing command destined for a specific window in the command
+ *  ring of its connection.
+ *
+ * Input Parameters:
+ *   wnd    - A pointer to the back-end window structure
+ *   msg    - A pointer to the message to send
+ *   msglen - The length of the message in bytes.
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nxmu_ringwindow(FAR struct nxbe_window_s *wnd, FAR const void *msg,
+                    size_t msglen)
+{
+  int ret = OK;
+
+  /* Sanity checking */
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!wnd || !wnd->conn)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  /* Ignore messages destined to a blocked window (no errors reported) */
+
+  if (!NXBE_ISBLOCKED(wnd))
+    {
+      ret = nxmu_sendring(wnd->conn, msg, msglen);
+    }
+
+  return ret;
+}
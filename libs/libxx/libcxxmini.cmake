@@ -37,6 +37,10 @@ target_sources(
           libcxxmini/libxx_new.cxx
           libcxxmini/libxx_newa.cxx)
 
+if(CONFIG_LIBCXXMINI_MEMPOOL)
+  target_sources(libcxxmini PRIVATE libcxxmini/libxx_mempool.cxx)
+endif()
+
 # Why c++14? * libcxx seems to require c++11. * The compiler defaults varies:
 # clang/macOS (from xcode): 199711L gcc/ubuntu:               201402L * There is
 # a precedent to use c++14. (boards/arm/stm32l4/nucleo-l476rg/scripts/Make.defs)
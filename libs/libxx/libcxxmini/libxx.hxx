@@ -0,0 +1,59 @@
+//***************************************************************************
+// libs/libxx/libcxxmini/libxx.hxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+//
+//***************************************************************************
+
+
+#ifndef __LIBS_LIBXX_LIBCXXMINI_LIBXX_HXX
+#define __LIBS_LIBXX_LIBCXXMINI_LIBXX_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+
+#include <nuttx/lib/lib.h>
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+#ifdef CONFIG_LIBCXXMINI_MEMPOOL
+
+//***************************************************************************
+// Name: libxx_malloc and libxx_free
+//
+// Description:
+//   Allocate and free the memory of operator new and delete.  Sizes up to
+//   CONFIG_LIBCXXMINI_MEMPOOL_THRESHOLD are served by size-class memory
+//   pools, larger ones by the heap.  nbytes of libxx_free() is the size
+//   passed to the sized delete operators or zero if it is unknown.
+//
+//***************************************************************************
+
+FAR void *libxx_malloc(std::size_t nbytes);
+void libxx_free(FAR void *ptr, std::size_t nbytes);
+
+#else
+#  define libxx_malloc(n)   lib_malloc(n)
+#  define libxx_free(p, n)  lib_free(p)
+#endif
+
+#endif // __LIBS_LIBXX_LIBCXXMINI_LIBXX_HXX
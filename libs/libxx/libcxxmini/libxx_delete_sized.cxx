@@ -25,7 +25,7 @@
 
 #include <cstddef>
 
-#include <nuttx/lib/lib.h>
+#include "libxx.hxx"
 
 #ifdef CONFIG_HAVE_CXX14
 
@@ -49,7 +49,7 @@
 
 void operator delete(FAR void *ptr, std::size_t size)
 {
-  lib_free(ptr);
+  libxx_free(ptr, size);
 }
 
 #endif /* CONFIG_HAVE_CXX14 */
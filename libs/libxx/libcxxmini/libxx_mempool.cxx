@@ -0,0 +1,181 @@
+//***************************************************************************
+// libs/libxx/libcxxmini/libxx_mempool.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+//
+//***************************************************************************
+
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <nuttx/lib/lib.h>
+#include <nuttx/mm/mempool.h>
+
+#include "libxx.hxx"
+
+#ifdef CONFIG_LIBCXXMINI_MEMPOOL
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+// The size classes are multiples of LIBXX_MEMPOOL_STEP up to the threshold
+
+#define LIBXX_MEMPOOL_STEP   (2 * sizeof(uintptr_t))
+#define LIBXX_MEMPOOL_NPOOLS \
+  (CONFIG_LIBCXXMINI_MEMPOOL_THRESHOLD / LIBXX_MEMPOOL_STEP)
+
+//***************************************************************************
+// Private Data
+//***************************************************************************
+
+static FAR struct mempool_multiple_s *g_libxx_mempool;
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+static FAR void *libxx_mempool_alloc(FAR void *arg, std::size_t alignment,
+                                     std::size_t size)
+{
+  return lib_memalign(alignment, size);
+}
+
+static std::size_t libxx_mempool_size(FAR void *arg, FAR void *addr)
+{
+  return lib_malloc_size(addr);
+}
+
+static void libxx_mempool_free(FAR void *arg, FAR void *addr)
+{
+  lib_free(addr);
+}
+
+//***************************************************************************
+// Name: libxx_mempool
+//
+// Description:
+//   Return the pools, creating them on the first allocation.  That may
+//   happen from a static constructor, so it cannot wait for an explicit
+//   initialization.  Threads racing here all create pools, the loser
+//   frees its own.
+//
+//***************************************************************************
+
+static FAR struct mempool_multiple_s *libxx_mempool(void)
+{
+  FAR struct mempool_multiple_s *mpool;
+  FAR struct mempool_multiple_s *expect = NULL;
+  std::size_t poolsize[LIBXX_MEMPOOL_NPOOLS];
+  std::size_t i;
+
+  mpool = __atomic_load_n(&g_libxx_mempool, __ATOMIC_ACQUIRE);
+  if (mpool != NULL)
+    {
+      return mpool;
+    }
+
+  for (i = 0; i < LIBXX_MEMPOOL_NPOOLS; i++)
+    {
+      poolsize[i] = (i + 1) * LIBXX_MEMPOOL_STEP;
+    }
+
+  mpool = mempool_multiple_init("libxx", poolsize, LIBXX_MEMPOOL_NPOOLS,
+                                libxx_mempool_alloc, libxx_mempool_size,
+                                libxx_mempool_free, NULL, 0,
+                                CONFIG_LIBCXXMINI_MEMPOOL_EXPAND_SIZE,
+                                CONFIG_LIBCXXMINI_MEMPOOL_DICT_EXPAND_SIZE);
+  if (mpool == NULL)
+    {
+      return NULL;
+    }
+
+  if (!__atomic_compare_exchange_n(&g_libxx_mempool, &expect, mpool, false,
+                                   __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+      mempool_multiple_deinit(mpool);
+      mpool = expect;
+    }
+
+  return mpool;
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: libxx_malloc
+//***************************************************************************
+
+FAR void *libxx_malloc(std::size_t nbytes)
+{
+  FAR struct mempool_multiple_s *mpool;
+  FAR void *alloc;
+
+  if (nbytes <= CONFIG_LIBCXXMINI_MEMPOOL_THRESHOLD)
+    {
+      mpool = libxx_mempool();
+      if (mpool != NULL)
+        {
+          // Fall back to the heap only when the pools cannot grow
+
+          alloc = mempool_multiple_alloc(mpool, nbytes > 0 ? nbytes : 1);
+          if (alloc != NULL)
+            {
+              return alloc;
+            }
+        }
+    }
+
+  return lib_malloc(nbytes);
+}
+
+//***************************************************************************
+// Name: libxx_free
+//***************************************************************************
+
+void libxx_free(FAR void *ptr, std::size_t nbytes)
+{
+  FAR struct mempool_multiple_s *mpool;
+
+  if (ptr == NULL)
+    {
+      return;
+    }
+
+  // A known size above the threshold never came from a pool, which saves
+  // looking the block up in the dictionary of the pools.
+
+  if (nbytes <= CONFIG_LIBCXXMINI_MEMPOOL_THRESHOLD)
+    {
+      mpool = __atomic_load_n(&g_libxx_mempool, __ATOMIC_ACQUIRE);
+      if (mpool != NULL && mempool_multiple_free(mpool, ptr) >= 0)
+        {
+          return;
+        }
+    }
+
+  lib_free(ptr);
+}
+
+#endif // CONFIG_LIBCXXMINI_MEMPOOL
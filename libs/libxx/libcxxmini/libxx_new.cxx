@@ -26,7 +26,7 @@
 #include <cstddef>
 #include <debug.h>
 
-#include <nuttx/lib/lib.h>
+#include "libxx.hxx"
 
 //***************************************************************************
 // Operators
@@ -50,7 +50,7 @@ FAR void *operator new(std::size_t nbytes)
 {
   // Perform the allocation
 
-  FAR void *alloc = lib_malloc(nbytes);
+  FAR void *alloc = libxx_malloc(nbytes);
 
 #ifdef CONFIG_DEBUG_ERROR
   if (alloc == 0)
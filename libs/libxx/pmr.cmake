@@ -0,0 +1,28 @@
+# ##############################################################################
+# libs/libxx/pmr.cmake
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more contributor
+# license agreements.  See the NOTICE file distributed with this work for
+# additional information regarding copyright ownership.  The ASF licenses this
+# file to you under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License.  You may obtain a copy of
+# the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations under
+# the License.
+#
+# ##############################################################################
+
+nuttx_add_system_library(libxxpmr)
+
+target_sources(libxxpmr PRIVATE pmr/libxx_pmr.cxx pmr/libxx_pmr_arena.cxx
+                                pmr/libxx_pmr_mempool.cxx)
+
+if(CONFIG_GRAN)
+  target_sources(libxxpmr PRIVATE pmr/libxx_pmr_gran.cxx)
+endif()
@@ -0,0 +1,54 @@
+//***************************************************************************
+// libs/libxx/pmr/libxx_pmr.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstdlib>
+#include <new>
+
+#include <nuttx/pmr.hxx>
+
+#ifdef CONFIG_LIBXX_PMR
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx::pmr
+{
+//***************************************************************************
+// Name: throw_bad_alloc
+//***************************************************************************
+
+void throw_bad_alloc()
+{
+#ifdef CONFIG_CXX_EXCEPTION
+  throw std::bad_alloc();
+#else
+  std::abort();
+#endif
+}
+} // namespace nuttx::pmr
+
+#endif // CONFIG_LIBXX_PMR
@@ -0,0 +1,112 @@
+//***************************************************************************
+// libs/libxx/pmr/libxx_pmr_arena.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <nuttx/arena.h>
+#include <nuttx/pmr.hxx>
+
+#ifdef CONFIG_LIBXX_PMR
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx::pmr
+{
+//***************************************************************************
+// Name: arena_resource::arena_resource
+//***************************************************************************
+
+arena_resource::arena_resource(std::size_t blocksize)
+  : m_arena(arena_create(blocksize))
+{
+}
+
+//***************************************************************************
+// Name: arena_resource::~arena_resource
+//***************************************************************************
+
+arena_resource::~arena_resource()
+{
+  if (m_arena != NULL)
+    {
+      arena_destroy(m_arena);
+    }
+}
+
+//***************************************************************************
+// Name: arena_resource::release
+//***************************************************************************
+
+void arena_resource::release() noexcept
+{
+  if (m_arena != NULL)
+    {
+      arena_reset(m_arena);
+    }
+}
+
+//***************************************************************************
+// Name: arena_resource::do_allocate
+//***************************************************************************
+
+FAR void *arena_resource::do_allocate(std::size_t bytes,
+                                      std::size_t alignment)
+{
+  std::uintptr_t addr;
+  FAR void *p = NULL;
+
+  // The arena aligns for any type, a larger alignment is made by
+  // allocating more.  Nothing is freed one by one, so the start of the
+  // allocation does not need to be remembered.
+
+  if (alignment <= alignof(std::max_align_t))
+    {
+      p = m_arena != NULL ? arena_alloc(m_arena, bytes) : NULL;
+    }
+  else if (m_arena != NULL)
+    {
+      p = arena_alloc(m_arena, bytes + alignment - 1);
+      if (p != NULL)
+        {
+          addr = reinterpret_cast<std::uintptr_t>(p);
+          addr = (addr + alignment - 1) & ~(alignment - 1);
+          p    = reinterpret_cast<FAR void *>(addr);
+        }
+    }
+
+  if (p == NULL)
+    {
+      throw_bad_alloc();
+    }
+
+  return p;
+}
+} // namespace nuttx::pmr
+
+#endif // CONFIG_LIBXX_PMR
@@ -0,0 +1,104 @@
+//***************************************************************************
+// libs/libxx/pmr/libxx_pmr_gran.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+
+#include <nuttx/mm/gran.h>
+#include <nuttx/pmr.hxx>
+
+#if defined(CONFIG_LIBXX_PMR) && defined(CONFIG_GRAN)
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx::pmr
+{
+//***************************************************************************
+// Name: gran_resource::gran_resource
+//***************************************************************************
+
+gran_resource::gran_resource(FAR void *heapstart, std::size_t heapsize,
+                             unsigned int log2gran, unsigned int log2align,
+                             FAR std::pmr::memory_resource *upstream)
+  : m_start(static_cast<FAR char *>(heapstart)),
+    m_end(static_cast<FAR char *>(heapstart) + heapsize),
+    m_alignment(std::size_t(1) << log2align),
+    m_upstream(upstream)
+{
+  m_handle = gran_initialize(heapstart, heapsize, log2gran, log2align);
+}
+
+//***************************************************************************
+// Name: gran_resource::~gran_resource
+//***************************************************************************
+
+gran_resource::~gran_resource()
+{
+  if (m_handle != NULL)
+    {
+      gran_release(m_handle);
+    }
+}
+
+//***************************************************************************
+// Name: gran_resource::do_allocate
+//***************************************************************************
+
+FAR void *gran_resource::do_allocate(std::size_t bytes,
+                                     std::size_t alignment)
+{
+  FAR void *p = NULL;
+
+  if (m_handle != NULL && alignment <= m_alignment)
+    {
+      p = gran_alloc(m_handle, bytes > 0 ? bytes : 1);
+    }
+
+  return p != NULL ? p : m_upstream->allocate(bytes, alignment);
+}
+
+//***************************************************************************
+// Name: gran_resource::do_deallocate
+//***************************************************************************
+
+void gran_resource::do_deallocate(FAR void *p, std::size_t bytes,
+                                  std::size_t alignment)
+{
+  FAR char *addr = static_cast<FAR char *>(p);
+
+  if (addr >= m_start && addr < m_end)
+    {
+      gran_free(m_handle, p, bytes > 0 ? bytes : 1);
+    }
+  else
+    {
+      m_upstream->deallocate(p, bytes, alignment);
+    }
+}
+} // namespace nuttx::pmr
+
+#endif // CONFIG_LIBXX_PMR && CONFIG_GRAN
@@ -0,0 +1,229 @@
+//***************************************************************************
+// libs/libxx/pmr/libxx_pmr_mempool.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <assert.h>
+
+#include <nuttx/lib/lib.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/pmr.hxx>
+
+#ifdef CONFIG_LIBXX_PMR
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+// The memory of the pools comes from the heap of the caller, aligned so
+// that every block is aligned to the largest power of two that divides
+// the block size.
+
+static FAR void *pmr_mempool_alloc(FAR struct mempool_s *pool,
+                                   std::size_t size)
+{
+  return lib_memalign(alignof(std::max_align_t), size);
+}
+
+static void pmr_mempool_free(FAR struct mempool_s *pool, FAR void *addr)
+{
+  lib_free(addr);
+}
+
+static FAR void *pmr_multiple_alloc(FAR void *arg, std::size_t alignment,
+                                    std::size_t size)
+{
+  return lib_memalign(alignment, size);
+}
+
+static std::size_t pmr_multiple_size(FAR void *arg, FAR void *addr)
+{
+  return lib_malloc_size(addr);
+}
+
+static void pmr_multiple_free(FAR void *arg, FAR void *addr)
+{
+  lib_free(addr);
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx::pmr
+{
+//***************************************************************************
+// Name: mempool_resource::mempool_resource
+//***************************************************************************
+
+mempool_resource::mempool_resource(FAR const char *name,
+                                   std::size_t blocksize,
+                                   std::size_t initialsize,
+                                   std::size_t expandsize,
+                                   FAR std::pmr::memory_resource *upstream,
+                                   bool wait)
+  : m_pool(), m_upstream(upstream)
+{
+  std::size_t realsize;
+
+  m_pool.blocksize   = blocksize > 0 ? blocksize : 1;
+  m_pool.initialsize = initialsize;
+  m_pool.expandsize  = expandsize;
+  m_pool.wait        = wait;
+  m_pool.alloc       = pmr_mempool_alloc;
+  m_pool.free        = pmr_mempool_free;
+
+  realsize    = MEMPOOL_REALBLOCKSIZE(&m_pool);
+  m_alignment = realsize & -realsize;
+  if (m_alignment > alignof(std::max_align_t))
+    {
+      m_alignment = alignof(std::max_align_t);
+    }
+
+  m_ready = mempool_init(&m_pool, name) >= 0;
+}
+
+//***************************************************************************
+// Name: mempool_resource::~mempool_resource
+//***************************************************************************
+
+mempool_resource::~mempool_resource()
+{
+  if (m_ready)
+    {
+      mempool_deinit(&m_pool);
+    }
+}
+
+//***************************************************************************
+// Name: mempool_resource::do_allocate
+//***************************************************************************
+
+FAR void *mempool_resource::do_allocate(std::size_t bytes,
+                                        std::size_t alignment)
+{
+  FAR void *p;
+
+  if (bytes > m_pool.blocksize || alignment > m_alignment)
+    {
+      return m_upstream->allocate(bytes, alignment);
+    }
+
+  // A small block can only be returned to the pool, so running out is not
+  // passed to the upstream resource.
+
+  p = m_ready ? mempool_allocate(&m_pool) : NULL;
+  if (p == NULL)
+    {
+      throw_bad_alloc();
+    }
+
+  return p;
+}
+
+//***************************************************************************
+// Name: mempool_resource::do_deallocate
+//***************************************************************************
+
+void mempool_resource::do_deallocate(FAR void *p, std::size_t bytes,
+                                     std::size_t alignment)
+{
+  if (bytes > m_pool.blocksize || alignment > m_alignment)
+    {
+      m_upstream->deallocate(p, bytes, alignment);
+    }
+  else
+    {
+      mempool_release(&m_pool, p);
+    }
+}
+
+//***************************************************************************
+// Name: mempool_multiple_resource::mempool_multiple_resource
+//***************************************************************************
+
+mempool_multiple_resource::
+mempool_multiple_resource(FAR const char *name,
+                          FAR const std::size_t *poolsize,
+                          std::size_t npools, std::size_t expandsize,
+                          FAR std::pmr::memory_resource *upstream)
+  : m_upstream(upstream)
+{
+  m_mpool = mempool_multiple_init(name, poolsize, npools,
+                                  pmr_multiple_alloc, pmr_multiple_size,
+                                  pmr_multiple_free, NULL, 0, expandsize,
+                                  expandsize);
+}
+
+//***************************************************************************
+// Name: mempool_multiple_resource::~mempool_multiple_resource
+//***************************************************************************
+
+mempool_multiple_resource::~mempool_multiple_resource()
+{
+  if (m_mpool != NULL)
+    {
+      mempool_multiple_deinit(m_mpool);
+    }
+}
+
+//***************************************************************************
+// Name: mempool_multiple_resource::do_allocate
+//***************************************************************************
+
+FAR void *mempool_multiple_resource::do_allocate(std::size_t bytes,
+                                                 std::size_t alignment)
+{
+  FAR void *p = NULL;
+
+  if (m_mpool != NULL)
+    {
+      p = mempool_multiple_memalign(m_mpool, alignment,
+                                    bytes > 0 ? bytes : 1);
+    }
+
+  return p != NULL ? p : m_upstream->allocate(bytes, alignment);
+}
+
+//***************************************************************************
+// Name: mempool_multiple_resource::do_deallocate
+//***************************************************************************
+
+void mempool_multiple_resource::do_deallocate(FAR void *p,
+                                              std::size_t bytes,
+                                              std::size_t alignment)
+{
+  // The pools know their own blocks, the rest came from upstream
+
+  if (m_mpool == NULL || mempool_multiple_free(m_mpool, p) < 0)
+    {
+      m_upstream->deallocate(p, bytes, alignment);
+    }
+}
+} // namespace nuttx::pmr
+
+#endif // CONFIG_LIBXX_PMR
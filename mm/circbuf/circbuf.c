@@ -33,15 +33,86 @@
 
 #include <nuttx/config.h>
 
+#include <sys/mman.h>
 #include <assert.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/circbuf.h>
+#include <nuttx/mm/map.h>
 
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: circbuf_off
+ *
+ * Description:
+ *   Return the offset in the buffer of position pos.  A buffer whose size
+ *   is a power of two wraps with a mask instead of a division.
+ *
+ ****************************************************************************/
+
+static inline size_t circbuf_off(FAR struct circbuf_s *circ, size_t pos)
+{
+  if ((circ->size & (circ->size - 1)) == 0)
+    {
+      return pos & (circ->size - 1);
+    }
+
+  return pos % circ->size;
+}
+
+/****************************************************************************
+ * Name: circbuf_load
+ *
+ * Description:
+ *   Read the head or the tail, which the other side may update.
+ *
+ ****************************************************************************/
+
+static inline size_t circbuf_load(FAR size_t *pos)
+{
+  return atomic_load_explicit((FAR atomic_size_t *)pos,
+                              memory_order_acquire);
+}
+
+/****************************************************************************
+ * Name: circbuf_set_head/circbuf_set_tail
+ *
+ * Description:
+ *   Publish a new head after the data written, or a new tail after the
+ *   data consumed.
+ *
+ ****************************************************************************/
+
+static inline void circbuf_set_head(FAR struct circbuf_s *circ, size_t head)
+{
+  atomic_store_explicit((FAR atomic_size_t *)&circ->head, head,
+                        memory_order_release);
+  if (circ->header != NULL)
+    {
+      atomic_store_explicit((FAR atomic_size_t *)&circ->header->head, head,
+                            memory_order_release);
+    }
+}
+
+static inline void circbuf_set_tail(FAR struct circbuf_s *circ, size_t tail)
+{
+  atomic_store_explicit((FAR atomic_size_t *)&circ->tail, tail,
+                        memory_order_release);
+  if (circ->header != NULL)
+    {
+      atomic_store_explicit((FAR atomic_size_t *)&circ->header->tail, tail,
+                            memory_order_release);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -71,6 +142,7 @@ int circbuf_init(FAR struct circbuf_s *circ, FAR void *base, size_t bytes)
   DEBUGASSERT(!base || bytes);
 
   circ->external = !!base;
+  circ->header   = NULL;
 
   if (!base && bytes)
     {
@@ -110,7 +182,7 @@ int circbuf_resize(FAR struct circbuf_s *circ, size_t bytes)
   size_t len = 0;
 
   DEBUGASSERT(circ);
-  DEBUGASSERT(!circ->external);
+  DEBUGASSERT(!circ->external && !circ->header);
   if (bytes == circ->size)
     {
       return 0;
@@ -157,7 +229,8 @@ int circbuf_resize(FAR struct circbuf_s *circ, size_t bytes)
 void circbuf_reset(FAR struct circbuf_s *circ)
 {
   DEBUGASSERT(circ);
-  circ->head = circ->tail = 0;
+  circbuf_set_head(circ, 0);
+  circbuf_set_tail(circ, 0);
 }
 
 /****************************************************************************
@@ -174,7 +247,11 @@ void circbuf_uninit(FAR struct circbuf_s *circ)
 {
   DEBUGASSERT(circ);
 
-  if (!circ->external)
+  if (circ->header)
+    {
+      kmm_free(circ->header);
+    }
+  else if (!circ->external)
     {
       kmm_free(circ->base);
     }
@@ -182,6 +259,94 @@ void circbuf_uninit(FAR struct circbuf_s *circ)
   memset(circ, 0, sizeof(*circ));
 }
 
+/****************************************************************************
+ * Name: circbuf_init_mmap
+ *
+ * Description:
+ *   Initialize a circular buffer that can be mapped read-only with
+ *   circbuf_mmap().  The buffer is allocated behind a struct
+ *   circbuf_header_s, which mirrors the head and the tail.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   bytes - The size of the internal buffer.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int circbuf_init_mmap(FAR struct circbuf_s *circ, size_t bytes)
+{
+  FAR struct circbuf_header_s *header;
+  int ret;
+
+  DEBUGASSERT(circ && bytes);
+
+  header = kmm_zalloc(sizeof(*header) + bytes);
+  if (!header)
+    {
+      return -ENOMEM;
+    }
+
+  header->size = bytes;
+
+  ret = circbuf_init(circ, header + 1, bytes);
+  if (ret < 0)
+    {
+      kmm_free(header);
+      return ret;
+    }
+
+  circ->header = header;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: circbuf_mmap
+ *
+ * Description:
+ *   Map the header and the data of a circular buffer set up with
+ *   circbuf_init_mmap(), for the mmap() method of a driver.  The mapping
+ *   must be read-only.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   map   - The mapping requested, vaddr is set on success.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int circbuf_mmap(FAR struct circbuf_s *circ,
+                 FAR struct mm_map_entry_s *map)
+{
+  size_t size;
+
+  DEBUGASSERT(circ && map);
+
+  if (!circ->header)
+    {
+      return -ENODEV;
+    }
+
+  if ((map->prot & PROT_WRITE) != 0)
+    {
+      return -EACCES;
+    }
+
+  size = sizeof(struct circbuf_header_s) + circ->size;
+  if (map->offset < 0 || (size_t)map->offset >= size ||
+      map->length > size - map->offset)
+    {
+      return -EINVAL;
+    }
+
+  map->vaddr = (FAR char *)circ->header + map->offset;
+  return 0;
+}
+
 /****************************************************************************
  * Name: circbuf_size
  *
@@ -211,7 +376,7 @@ size_t circbuf_size(FAR struct circbuf_s *circ)
 size_t circbuf_used(FAR struct circbuf_s *circ)
 {
   DEBUGASSERT(circ);
-  return circ->head - circ->tail;
+  return circbuf_load(&circ->head) - circbuf_load(&circ->tail);
 }
 
 /****************************************************************************
@@ -298,6 +463,8 @@ bool circbuf_is_full(FAR struct circbuf_s *circ)
 ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
                        FAR void *dst, size_t bytes)
 {
+  size_t head;
+  size_t tail;
   size_t len;
   size_t off;
 
@@ -308,13 +475,15 @@ ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
       return 0;
     }
 
-  if (circ->head - pos > circ->head - circ->tail)
+  head = circbuf_load(&circ->head);
+  tail = circbuf_load(&circ->tail);
+  if (head - pos > head - tail)
     {
-      pos = circ->tail;
+      pos = tail;
     }
 
-  len = circ->head - pos;
-  off = pos % circ->size;
+  len = head - pos;
+  off = circbuf_off(circ, pos);
 
   if (bytes > len)
     {
@@ -386,7 +555,7 @@ ssize_t circbuf_read(FAR struct circbuf_s *circ,
   DEBUGASSERT(dst || !bytes);
 
   bytes = circbuf_peek(circ, dst, bytes);
-  circ->tail += bytes;
+  circbuf_set_tail(circ, circ->tail + bytes);
 
   return bytes;
 }
@@ -423,7 +592,7 @@ ssize_t circbuf_skip(FAR struct circbuf_s *circ, size_t bytes)
       bytes = len;
     }
 
-  circ->tail += bytes;
+  circbuf_set_tail(circ, circ->tail + bytes);
 
   return bytes;
 }
@@ -463,7 +632,7 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
     }
 
   space = circbuf_space(circ);
-  off = circ->head % circ->size;
+  off = circbuf_off(circ, circ->head);
   if (bytes > space)
     {
       bytes = space;
@@ -477,7 +646,7 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
 
   memcpy((FAR char *)circ->base + off, src, space);
   memcpy(circ->base, (FAR char *)src + space, bytes - space);
-  circ->head += bytes;
+  circbuf_set_head(circ, circ->head + bytes);
 
   return bytes;
 }
@@ -533,8 +702,7 @@ ssize_t circbuf_overwrite(FAR struct circbuf_s *circ,
       overwrite = bytes - space + skip;
     }
 
-  circ->head += skip;
-  off = circ->head % circ->size;
+  off = circbuf_off(circ, circ->head + skip);
   space = circ->size - off;
   if (bytes < space)
     {
@@ -543,8 +711,8 @@ ssize_t circbuf_overwrite(FAR struct circbuf_s *circ,
 
   memcpy((FAR char *)circ->base + off, src, space);
   memcpy(circ->base, (FAR char *)src + space, bytes - space);
-  circ->head += bytes;
-  circ->tail += overwrite;
+  circbuf_set_tail(circ, circ->tail + overwrite);
+  circbuf_set_head(circ, circ->head + skip + bytes);
 
   return overwrite;
 }
@@ -571,9 +739,9 @@ FAR void *circbuf_get_writeptr(FAR struct circbuf_s *circ, FAR size_t *size)
 
   DEBUGASSERT(circ);
 
-  off = circ->head % circ->size;
-  pos = circ->tail % circ->size;
-  if (off >= pos)
+  off = circbuf_off(circ, circ->head);
+  pos = circbuf_off(circ, circbuf_load(&circ->tail));
+  if (off > pos || (off == pos && circbuf_is_empty(circ)))
     {
       *size = circ->size - off;
     }
@@ -607,9 +775,9 @@ FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
 
   DEBUGASSERT(circ);
 
-  off = circ->head % circ->size;
-  pos = circ->tail % circ->size;
-  if (pos > off)
+  off = circbuf_off(circ, circbuf_load(&circ->head));
+  pos = circbuf_off(circ, circ->tail);
+  if (pos > off || (pos == off && !circbuf_is_empty(circ)))
     {
       *size = circ->size - pos;
     }
@@ -638,7 +806,7 @@ FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
 void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 {
   DEBUGASSERT(circ);
-  circ->head += writtensize;
+  circbuf_set_head(circ, circ->head + writtensize);
 }
 
 /****************************************************************************
@@ -658,5 +826,5 @@ void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 void circbuf_readcommit(FAR struct circbuf_s *circ, size_t readsize)
 {
   DEBUGASSERT(circ);
-  circ->tail += readsize;
+  circbuf_set_tail(circ, circ->tail + readsize);
 }
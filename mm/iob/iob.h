@@ -53,6 +53,57 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+#ifdef CONFIG_IOB_NOTIFIER
+#  if !defined(CONFIG_IOB_NOTIFIER_DIV) || CONFIG_IOB_NOTIFIER_DIV < 2
+#    define IOB_DIVIDER 1
+#  elif CONFIG_IOB_NOTIFIER_DIV < 4
+#    define IOB_DIVIDER 2
+#  elif CONFIG_IOB_NOTIFIER_DIV < 8
+#    define IOB_DIVIDER 4
+#  elif CONFIG_IOB_NOTIFIER_DIV < 16
+#    define IOB_DIVIDER 8
+#  elif CONFIG_IOB_NOTIFIER_DIV < 32
+#    define IOB_DIVIDER 16
+#  elif CONFIG_IOB_NOTIFIER_DIV < 64
+#    define IOB_DIVIDER 32
+#  else
+#    define IOB_DIVIDER 64
+#  endif
+#endif
+
+#define IOB_MASK      (IOB_DIVIDER - 1)
+
+/* Pools of pre-allocated I/O buffers larger than CONFIG_IOB_BUFSIZE */
+
+#ifdef CONFIG_IOB_ALLOC
+#  if CONFIG_IOB_CLASS1_NBUFFERS > 0 && CONFIG_IOB_CLASS2_NBUFFERS > 0
+#    define IOB_NCLASSES 2
+#    if CONFIG_IOB_CLASS1_BUFSIZE >= CONFIG_IOB_CLASS2_BUFSIZE
+#      error CONFIG_IOB_CLASS2_BUFSIZE must be larger
+#    endif
+#  elif CONFIG_IOB_CLASS1_NBUFFERS > 0 || CONFIG_IOB_CLASS2_NBUFFERS > 0
+#    define IOB_NCLASSES 1
+#  else
+#    define IOB_NCLASSES 0
+#  endif
+#else
+#  define IOB_NCLASSES   0
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#if IOB_NCLASSES > 0
+/* One size class of I/O buffers, ordered by increasing size */
+
+struct iob_class_s
+{
+  FAR struct iob_s *freelist; /* Free I/O buffers of this class */
+  uint16_t bufsize;           /* Payload size of the I/O buffers */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -87,6 +138,12 @@ extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 
 extern spinlock_t g_iob_lock;
 
+#if IOB_NCLASSES > 0
+/* The larger I/O buffer classes */
+
+extern struct iob_class_s g_iob_classes[IOB_NCLASSES];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -126,6 +183,19 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_class_free
+ *
+ * Description:
+ *   The io_free callback of the I/O buffers of the larger classes.  Return
+ *   the I/O buffer that owns 'data' to the free list of its class.
+ *
+ ****************************************************************************/
+
+#if IOB_NCLASSES > 0
+void iob_class_free(FAR void *data);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
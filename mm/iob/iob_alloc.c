@@ -32,6 +32,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
+#include <nuttx/fs/procfs.h>
 #ifdef CONFIG_IOB_ALLOC
 #  include <nuttx/kmalloc.h>
 #endif
@@ -145,17 +146,20 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
       /* If not successful, then the semaphore count was less than or equal
        * to zero (meaning that there are no free buffers).  We need to wait
        * for an I/O buffer to be released and placed in the committed
-       * list.
+       * list.  The wait is accounted as network pressure.
        */
 
       if (timeout == UINT_MAX)
         {
-          ret = nxsem_wait_uninterruptible(sem);
+          ret = PRESSURE_STALL(PRESSURE_NET,
+                               nxsem_wait_uninterruptible(sem));
         }
       else
         {
-          ret = nxsem_tickwait_uninterruptible(sem,
-                                   iob_allocwait_gettimeout(start, timeout));
+          clock_t ticks = iob_allocwait_gettimeout(start, timeout);
+
+          ret = PRESSURE_STALL(PRESSURE_NET,
+                               nxsem_tickwait_uninterruptible(sem, ticks));
         }
 
       if (ret >= 0)
@@ -189,6 +193,50 @@ static void iob_free_dynamic(FAR void *data)
 }
 #endif
 
+#if IOB_NCLASSES > 0
+/****************************************************************************
+ * Name: iob_class_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the smallest pre-allocated class that holds
+ *   'size' bytes.  Return NULL if no class has room for it.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_class_alloc(uint16_t size)
+{
+  FAR struct iob_s *iob = NULL;
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  for (i = 0; i < IOB_NCLASSES; i++)
+    {
+      FAR struct iob_class_s *cls = &g_iob_classes[i];
+
+      if (size <= cls->bufsize && cls->freelist != NULL)
+        {
+          iob           = cls->freelist;
+          cls->freelist = iob->io_flink;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  if (iob != NULL)
+    {
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -324,13 +372,90 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   return NULL;
 }
 
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Try to allocate 'count' I/O buffers linked through io_flink with a
+ *   single acquisition of the free list lock.  Either all of the buffers
+ *   are allocated or none; the function never waits.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_batch(bool throttled, unsigned int count)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  unsigned int i;
+  FAR sem_t *sem;
+
+#if CONFIG_IOB_THROTTLE > 0
+  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+#else
+  sem = &g_iob_sem;
+#endif
+
+  if (count == 0)
+    {
+      return NULL;
+    }
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  if (sem->semcount >= (int)count && g_iob_sem.semcount >= (int)count)
+    {
+      /* The free list is linked through io_flink already.  Detach its
+       * first 'count' buffers as the new chain.
+       */
+
+      head = g_iob_freelist;
+      for (iob = head, i = 1; i < count; i++)
+        {
+          DEBUGASSERT(iob != NULL);
+          iob = iob->io_flink;
+        }
+
+      g_iob_freelist = iob->io_flink;
+      iob->io_flink  = NULL;
+
+      g_iob_sem.semcount -= count;
+      DEBUGASSERT(g_iob_sem.semcount >= 0);
+
+#if CONFIG_IOB_THROTTLE > 0
+      if (g_throttle_sem.semcount > (int)count)
+        {
+          g_throttle_sem.semcount -= count;
+        }
+      else if (g_throttle_sem.semcount > 0)
+        {
+          g_throttle_sem.semcount = 0;
+        }
+#endif
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  /* Put the I/O buffers in a known state */
+
+  for (iob = head; iob != NULL; iob = iob->io_flink)
+    {
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return head;
+}
+
 #ifdef CONFIG_IOB_ALLOC
 
 /****************************************************************************
  * Name: iob_alloc_dynamic
  *
  * Description:
- *   Allocate an I/O buffer and playload from heap
+ *   Allocate an I/O buffer and playload from the smallest pre-allocated
+ *   class that fits, or from the heap
  *
  * Input Parameters:
  *   size    - The size of the io_data that is allocated.
@@ -348,6 +473,14 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size)
   FAR struct iob_s *iob;
   size_t alignsize;
 
+#if IOB_NCLASSES > 0
+  iob = iob_class_alloc(size);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+
+#endif
   alignsize = ROUNDUP(sizeof(struct iob_s), CONFIG_IOB_ALIGNMENT) + size;
 
   iob = kmm_memalign(CONFIG_IOB_ALIGNMENT, alignsize);
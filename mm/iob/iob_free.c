@@ -40,33 +40,42 @@
 #include "iob.h"
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Public Functions
  ****************************************************************************/
 
-#ifdef CONFIG_IOB_NOTIFIER
-#  if !defined(CONFIG_IOB_NOTIFIER_DIV) || CONFIG_IOB_NOTIFIER_DIV < 2
-#    define IOB_DIVIDER 1
-#  elif CONFIG_IOB_NOTIFIER_DIV < 4
-#    define IOB_DIVIDER 2
-#  elif CONFIG_IOB_NOTIFIER_DIV < 8
-#    define IOB_DIVIDER 4
-#  elif CONFIG_IOB_NOTIFIER_DIV < 16
-#    define IOB_DIVIDER 8
-#  elif CONFIG_IOB_NOTIFIER_DIV < 32
-#    define IOB_DIVIDER 16
-#  elif CONFIG_IOB_NOTIFIER_DIV < 64
-#    define IOB_DIVIDER 32
-#  else
-#    define IOB_DIVIDER 64
-#  endif
-#endif
-
-#define IOB_MASK      (IOB_DIVIDER - 1)
-
+#if IOB_NCLASSES > 0
 /****************************************************************************
- * Public Functions
+ * Name: iob_class_free
+ *
+ * Description:
+ *   The io_free callback of the I/O buffers of the larger classes.  Return
+ *   the I/O buffer that owns 'data' to the free list of its class.
+ *
  ****************************************************************************/
 
+void iob_class_free(FAR void *data)
+{
+  FAR struct iob_s *iob = (FAR struct iob_s *)data - 1;
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  for (i = 0; i < IOB_NCLASSES - 1; i++)
+    {
+      if (iob->io_bufsize == g_iob_classes[i].bufsize)
+        {
+          break;
+        }
+    }
+
+  iob->io_flink = g_iob_classes[i].freelist;
+  g_iob_classes[i].freelist = iob;
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+}
+#endif
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -123,8 +132,16 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 #ifdef CONFIG_IOB_ALLOC
   if (iob->io_free != NULL)
     {
-      iob->io_free(iob->io_data);
-      kmm_free(iob);
+      iob_free_cb_t free_cb = iob->io_free;
+
+      free_cb(iob->io_data);
+#  if IOB_NCLASSES > 0
+      if (free_cb != iob_class_free)
+#  endif
+        {
+          kmm_free(iob);
+        }
+
       return next;
     }
 #endif
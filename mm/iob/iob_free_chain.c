@@ -26,6 +26,9 @@
 
 #include <nuttx/config.h>
 
+#include <assert.h>
+#include <sys/param.h>
+
 #include <nuttx/arch.h>
 #include <nuttx/mm/iob.h>
 
@@ -55,3 +58,89 @@ void iob_free_chain(FAR struct iob_s *iob)
       next = iob_free(iob);
     }
 }
+
+/****************************************************************************
+ * Name: iob_free_chain_batch
+ *
+ * Description:
+ *   Free an entire buffer chain like iob_free_chain(), but return all of
+ *   the buffers to the free list with a single acquisition of the free
+ *   list lock when nobody waits for a buffer.  Otherwise the buffers are
+ *   freed one at a time so that the waiters get them.
+ *
+ ****************************************************************************/
+
+void iob_free_chain_batch(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *tail;
+  irqstate_t flags;
+  int count = 1;
+#ifdef CONFIG_IOB_NOTIFIER
+  int navail;
+#endif
+
+  if (iob == NULL)
+    {
+      return;
+    }
+
+#ifdef CONFIG_IOB_ALLOC
+  for (tail = iob; tail != NULL; tail = tail->io_flink)
+    {
+      if (tail->io_free != NULL)
+        {
+          /* Dynamically allocated buffers go back to the heap */
+
+          iob_free_chain(iob);
+          return;
+        }
+    }
+#endif
+
+  for (tail = iob; tail->io_flink != NULL; tail = tail->io_flink)
+    {
+      count++;
+    }
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+#if CONFIG_IOB_THROTTLE > 0
+  if (g_iob_sem.semcount < 0 || g_throttle_sem.semcount < 0)
+#else
+  if (g_iob_sem.semcount < 0)
+#endif
+    {
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+      iob_free_chain(iob);
+      return;
+    }
+
+  /* Nobody waits, so the counts can be raised without posting */
+
+  tail->io_flink  = g_iob_freelist;
+  g_iob_freelist  = iob;
+
+#if CONFIG_IOB_THROTTLE > 0
+  if (g_iob_sem.semcount + count > CONFIG_IOB_THROTTLE)
+    {
+      g_throttle_sem.semcount += g_iob_sem.semcount + count -
+                                 MAX(g_iob_sem.semcount,
+                                     CONFIG_IOB_THROTTLE);
+    }
+#endif
+
+  g_iob_sem.semcount += count;
+  DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+#ifdef CONFIG_IOB_NOTIFIER
+  /* Signal the notifier if the count crossed a multiple of the divider */
+
+  navail = iob_navail(false);
+  if (navail > 0 && ((navail - count) & ~IOB_MASK) != (navail & ~IOB_MASK))
+    {
+      iob_notifier_signal();
+    }
+#endif
+}
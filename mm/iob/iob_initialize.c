@@ -63,6 +63,23 @@ static uint8_t g_iob_buffer[IOB_BUFFER_SIZE] locate_data(IOB_SECTION);
 static uint8_t g_iob_buffer[IOB_BUFFER_SIZE];
 #endif
 
+#if IOB_NCLASSES > 0
+#  define IOB_CLASS_SIZE(n) ROUNDUP(sizeof(struct iob_s) + \
+                                    CONFIG_IOB_CLASS##n##_BUFSIZE, \
+                                    CONFIG_IOB_ALIGNMENT)
+#  define IOB_CLASS_BUFFER_SIZE(n) (IOB_CLASS_SIZE(n) * \
+                                    CONFIG_IOB_CLASS##n##_NBUFFERS + \
+                                    CONFIG_IOB_ALIGNMENT - 1)
+#endif
+
+#if CONFIG_IOB_CLASS1_NBUFFERS > 0
+static uint8_t g_iob_class1_buffer[IOB_CLASS_BUFFER_SIZE(1)];
+#endif
+
+#if CONFIG_IOB_CLASS2_NBUFFERS > 0
+static uint8_t g_iob_class2_buffer[IOB_CLASS_BUFFER_SIZE(2)];
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* This is a pool of pre-allocated iob_qentry_s buffers */
 
@@ -110,6 +127,50 @@ sem_t g_qentry_sem = SEM_INITIALIZER(CONFIG_IOB_NCHAINS);
 
 spinlock_t g_iob_lock = SP_UNLOCKED;
 
+#if IOB_NCLASSES > 0
+/* The larger I/O buffer classes */
+
+struct iob_class_s g_iob_classes[IOB_NCLASSES];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#if IOB_NCLASSES > 0
+/****************************************************************************
+ * Name: iob_initialize_class
+ *
+ * Description:
+ *   Divide 'buffer' into 'nbuffers' I/O buffers of 'bufsize' bytes each
+ *   and add them to the free list of 'cls'.
+ *
+ ****************************************************************************/
+
+static void iob_initialize_class(FAR struct iob_class_s *cls,
+                                 FAR uint8_t *buffer, size_t size,
+                                 uint16_t bufsize, int nbuffers)
+{
+  uintptr_t buf;
+  int i;
+
+  buf = ROUNDUP((uintptr_t)buffer + sizeof(struct iob_s),
+                CONFIG_IOB_ALIGNMENT) - sizeof(struct iob_s);
+
+  cls->bufsize = bufsize;
+  for (i = 0; i < nbuffers; i++)
+    {
+      FAR struct iob_s *iob = (FAR struct iob_s *)(buf + i * size);
+
+      iob->io_flink   = cls->freelist;
+      iob->io_bufsize = bufsize;
+      iob->io_free    = iob_class_free;
+      iob->io_data    = (FAR uint8_t *)(iob + 1);
+      cls->freelist   = iob;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -152,6 +213,22 @@ void iob_initialize(void)
       g_iob_freelist  = iob;
     }
 
+#if IOB_NCLASSES > 0
+  /* Set up the pools of larger I/O buffers, smallest class first */
+
+  i = 0;
+#  if CONFIG_IOB_CLASS1_NBUFFERS > 0
+  iob_initialize_class(&g_iob_classes[i++], g_iob_class1_buffer,
+                       IOB_CLASS_SIZE(1), CONFIG_IOB_CLASS1_BUFSIZE,
+                       CONFIG_IOB_CLASS1_NBUFFERS);
+#  endif
+#  if CONFIG_IOB_CLASS2_NBUFFERS > 0
+  iob_initialize_class(&g_iob_classes[i++], g_iob_class2_buffer,
+                       IOB_CLASS_SIZE(2), CONFIG_IOB_CLASS2_BUFSIZE,
+                       CONFIG_IOB_CLASS2_NBUFFERS);
+#  endif
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
   /* Add each I/O buffer chain queue container to the free list */
 
@@ -51,6 +51,20 @@
 #define KASAN_REGION_SIZE(size) \
   (sizeof(struct kasan_region_s) + KASAN_SHADOW_SIZE(size))
 
+/* The fixed shadow covers CONFIG_MM_KASAN_SHADOW_SIZE bytes from
+ * CONFIG_MM_KASAN_SHADOW_START, normally the main heap, so the shadow of
+ * an address there is found with a shift and an offset.
+ */
+
+#define KASAN_FIXED_WORDS \
+  ((CONFIG_MM_KASAN_SHADOW_SIZE / KASAN_SHADOW_SCALE + \
+    KASAN_BITS_PER_WORD - 1) / KASAN_BITS_PER_WORD)
+
+#define KASAN_IS_FIXED(addr, size) \
+  ((addr) - CONFIG_MM_KASAN_SHADOW_START < CONFIG_MM_KASAN_SHADOW_SIZE && \
+   (size) <= CONFIG_MM_KASAN_SHADOW_START + CONFIG_MM_KASAN_SHADOW_SIZE - \
+             (addr))
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -70,6 +84,10 @@ static FAR struct kasan_region_s *g_region[CONFIG_MM_KASAN_REGIONS];
 static size_t g_region_count;
 static spinlock_t g_lock;
 
+#if CONFIG_MM_KASAN_SHADOW_SIZE > 0
+static uintptr_t g_shadow[KASAN_FIXED_WORDS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -81,6 +99,17 @@ kasan_mem_to_shadow(FAR const void *ptr, size_t size,
   uintptr_t addr = (uintptr_t)ptr;
   size_t i;
 
+#if CONFIG_MM_KASAN_SHADOW_SIZE > 0
+  if (addr - CONFIG_MM_KASAN_SHADOW_START < CONFIG_MM_KASAN_SHADOW_SIZE)
+    {
+      DEBUGASSERT(KASAN_IS_FIXED(addr, size));
+      addr -= CONFIG_MM_KASAN_SHADOW_START;
+      addr /= KASAN_SHADOW_SCALE;
+      *bit  = addr % KASAN_BITS_PER_WORD;
+      return &g_shadow[addr / KASAN_BITS_PER_WORD];
+    }
+#endif
+
   for (i = 0; i < g_region_count; i++)
     {
       if (addr >= g_region[i]->begin && addr < g_region[i]->end)
@@ -110,9 +139,14 @@ kasan_is_poisoned(FAR const void *addr, size_t size)
       return kasan_global_is_poisoned(addr, size);
     }
 
-  if (size <= KASAN_SHADOW_SCALE)
+  /* The 1, 2, 4 and 8 byte accesses almost always stay in one word */
+
+  nbit = ((uintptr_t)addr % KASAN_SHADOW_SCALE + size +
+          KASAN_SHADOW_SCALE - 1) / KASAN_SHADOW_SCALE;
+  if (bit + nbit <= KASAN_BITS_PER_WORD)
     {
-      return ((*p >> bit) & 1);
+      return ((*p >> bit) &
+              (UINTPTR_MAX >> (KASAN_BITS_PER_WORD - nbit))) != 0;
     }
 
   nbit = KASAN_BITS_PER_WORD - bit % KASAN_BITS_PER_WORD;
@@ -200,6 +234,26 @@ static void kasan_set_poison(FAR const void *addr, size_t size,
   spin_unlock_irqrestore(&g_lock, flags);
 }
 
+/****************************************************************************
+ * Name: kasan_is_sampled
+ *
+ * Description:
+ *   Whether the block at addr is one of the sampled ones.  It depends on
+ *   the address only, so the allocation and the free of a block agree.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MM_KASAN_SAMPLE_RATE > 1
+static inline_function bool kasan_is_sampled(FAR const void *addr)
+{
+  uint32_t hash = (uint32_t)((uintptr_t)addr / KASAN_SHADOW_SCALE);
+
+  hash *= 0x9e3779b1;
+  hash ^= hash >> 16;
+  return hash % CONFIG_MM_KASAN_SAMPLE_RATE == 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -211,6 +265,13 @@ FAR void *kasan_reset_tag(FAR const void *addr)
 
 void kasan_poison(FAR const void *addr, size_t size)
 {
+#if CONFIG_MM_KASAN_SAMPLE_RATE > 1
+  if (!kasan_is_sampled(addr))
+    {
+      return;
+    }
+#endif
+
   kasan_set_poison(addr, size, true);
 }
 
@@ -223,24 +284,44 @@ FAR void *kasan_unpoison(FAR const void *addr, size_t size)
 void kasan_register(FAR void *addr, FAR size_t *size)
 {
   FAR struct kasan_region_s *region;
+  size_t shadow = KASAN_REGION_SIZE(*size);
   irqstate_t flags;
 
-  region = (FAR struct kasan_region_s *)
-    ((FAR char *)addr + *size - KASAN_REGION_SIZE(*size));
+#if CONFIG_MM_KASAN_SHADOW_SIZE > 0
+  if (KASAN_IS_FIXED((uintptr_t)addr, *size))
+    {
+      shadow = 0;
+    }
+  else
+#endif
+    {
+      region = (FAR struct kasan_region_s *)
+        ((FAR char *)addr + *size - shadow);
 
-  region->begin = (uintptr_t)addr;
-  region->end   = region->begin + *size;
+      region->begin = (uintptr_t)addr;
+      region->end   = region->begin + *size;
 
-  flags = spin_lock_irqsave(&g_lock);
+      flags = spin_lock_irqsave(&g_lock);
 
-  DEBUGASSERT(g_region_count <= CONFIG_MM_KASAN_REGIONS);
-  g_region[g_region_count++] = region;
+      DEBUGASSERT(g_region_count <= CONFIG_MM_KASAN_REGIONS);
+      g_region[g_region_count++] = region;
 
-  spin_unlock_irqrestore(&g_lock, flags);
+      spin_unlock_irqrestore(&g_lock, flags);
+    }
 
   kasan_start();
-  kasan_poison(addr, *size);
-  *size -= KASAN_REGION_SIZE(*size);
+
+  /* With sampling the heap starts out clean, only the sampled blocks are
+   * poisoned once freed, so the other blocks cost no shadow updates.
+   */
+
+#if CONFIG_MM_KASAN_SAMPLE_RATE > 1
+  kasan_set_poison(addr, *size, false);
+#else
+  kasan_set_poison(addr, *size, true);
+#endif
+
+  *size -= shadow;
 }
 
 void kasan_unregister(FAR void *addr)
@@ -31,6 +31,7 @@
 #include <stddef.h>
 #include <nuttx/sched.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/vdso.h>
 #include <assert.h>
 #include <debug.h>
 
@@ -126,6 +127,14 @@ void mm_map_initialize(FAR struct mm_map_s *mm, bool kernel)
         {
           merr("gran_initialize() failed\n");
         }
+#ifdef CONFIG_CLOCK_VDSO
+      else
+        {
+          /* The first page holds the clock data, see clock_vdso_map() */
+
+          gran_reserve(mm->mm_map_vpages, VDSO_DATA_VBASE, MM_PGSIZE);
+        }
+#endif
     }
   else
     {
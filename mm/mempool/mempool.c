@@ -42,6 +42,17 @@
 #undef  ALIGN_UP
 #define ALIGN_UP(x, a) (((x) + ((a) - 1)) & (~((a) - 1)))
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+/* The number of blocks moved between a per-CPU cache and the pool at once */
+
+#  define MEMPOOL_CACHE_BATCH  (CONFIG_MM_MEMPOOL_PERCPU_CACHE_SIZE / 2)
+
+/* Pools with blocking waiters must see every free block in their queue */
+
+#  define MEMPOOL_CACHE_ENABLED(pool) \
+     (!(pool)->wait || (pool)->expandsize != 0)
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 #define MEMPOOL_MAGIC_FREE  0xAAAAAAAA
 #define MEMPOOL_MAGIC_ALLOC 0x55555555
@@ -100,6 +111,180 @@ static inline void mempool_add_queue(FAR struct mempool_s *pool,
     }
 }
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+/****************************************************************************
+ * Name: mempool_cache_alloc
+ *
+ * Description:
+ *   Take a free block from the cache of the current CPU, refilling the
+ *   cache from the normal queue of the pool if it is empty.  Return NULL if
+ *   the normal queue is empty too; the caller then follows the slow path.
+ *
+ ****************************************************************************/
+
+static FAR sq_entry_t *mempool_cache_alloc(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_cache_s *cache;
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+
+  if (!MEMPOOL_CACHE_ENABLED(pool))
+    {
+      return NULL;
+    }
+
+  flags = up_irq_save();
+  cache = &pool->cache[this_cpu()];
+
+  if (cache->count > 0)
+    {
+      cache->ahit++;
+    }
+  else
+    {
+      irqstate_t lflags = spin_lock_irqsave(&pool->lock);
+
+      cache->amiss++;
+      while (cache->count < MEMPOOL_CACHE_BATCH &&
+             (blk = mempool_remove_queue(pool, &pool->queue)) != NULL)
+        {
+          blk->flink  = cache->head;
+          cache->head = blk;
+          cache->count++;
+
+          /* Blocks held by the caches are accounted as used by the pool */
+
+          pool->nalloc++;
+        }
+
+      spin_unlock_irqrestore(&pool->lock, lflags);
+    }
+
+  blk = cache->head;
+  if (blk != NULL)
+    {
+      cache->head = blk->flink;
+      cache->count--;
+      blk->flink  = NULL;
+    }
+
+  up_irq_restore(flags);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_cache_release
+ *
+ * Description:
+ *   Put a free block into the cache of the current CPU, flushing half of
+ *   the cache back to the normal queue of the pool if it is full.  Return
+ *   false if the block can not be cached.
+ *
+ ****************************************************************************/
+
+static bool mempool_cache_release(FAR struct mempool_s *pool,
+                                  FAR sq_entry_t *blk)
+{
+  FAR struct mempool_cache_s *cache;
+  irqstate_t flags;
+
+  if (!MEMPOOL_CACHE_ENABLED(pool) ||
+      (pool->ibase != NULL && (FAR char *)blk >= pool->ibase &&
+       (FAR char *)blk < pool->ibase + pool->interruptsize))
+    {
+      return false;
+    }
+
+  flags = up_irq_save();
+  cache = &pool->cache[this_cpu()];
+
+  if (cache->count < CONFIG_MM_MEMPOOL_PERCPU_CACHE_SIZE)
+    {
+      cache->fhit++;
+    }
+  else
+    {
+      irqstate_t lflags = spin_lock_irqsave(&pool->lock);
+
+      cache->fmiss++;
+      while (cache->count > MEMPOOL_CACHE_BATCH)
+        {
+          FAR sq_entry_t *tmp = cache->head;
+
+          cache->head = tmp->flink;
+          cache->count--;
+          sq_addlast(tmp, &pool->queue);
+          pool->nalloc--;
+        }
+
+      spin_unlock_irqrestore(&pool->lock, lflags);
+    }
+
+  blk->flink  = cache->head;
+  cache->head = blk;
+  cache->count++;
+
+  up_irq_restore(flags);
+  return true;
+}
+
+/****************************************************************************
+ * Name: mempool_cache_count
+ *
+ * Description:
+ *   Return the number of free blocks held by all of the per-CPU caches.
+ *
+ ****************************************************************************/
+
+static size_t mempool_cache_count(FAR struct mempool_s *pool)
+{
+  size_t count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      count += pool->cache[cpu].count;
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: mempool_cache_flush
+ *
+ * Description:
+ *   Return the content of all the per-CPU caches to the normal queue.
+ *
+ * Assumptions:
+ *   No other CPU is using the pool.
+ *
+ ****************************************************************************/
+
+static void mempool_cache_flush(FAR struct mempool_s *pool)
+{
+  irqstate_t flags = spin_lock_irqsave(&pool->lock);
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      FAR struct mempool_cache_s *cache = &pool->cache[cpu];
+
+      while (cache->head != NULL)
+        {
+          FAR sq_entry_t *tmp = cache->head;
+
+          cache->head = tmp->flink;
+          sq_addlast(tmp, &pool->queue);
+          pool->nalloc--;
+        }
+
+      cache->count = 0;
+    }
+
+  spin_unlock_irqrestore(&pool->lock, flags);
+}
+#endif /* CONFIG_MM_MEMPOOL_PERCPU_CACHE */
+
 #if CONFIG_MM_BACKTRACE >= 0
 static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
                                          FAR struct mempool_backtrace_s *buf)
@@ -271,6 +456,9 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
   sq_init(&pool->iqueue);
   sq_init(&pool->equeue);
   pool->nalloc = 0;
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+  memset(pool->cache, 0, sizeof(pool->cache));
+#endif
   if (pool->interruptsize >= blocksize)
     {
       size_t ninterrupt = pool->interruptsize / blocksize;
@@ -353,6 +541,14 @@ FAR void *mempool_allocate(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   irqstate_t flags;
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+  blk = mempool_cache_alloc(pool);
+  if (blk != NULL)
+    {
+      goto out;
+    }
+#endif
+
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(pool, &pool->queue);
@@ -406,6 +602,10 @@ retry:
 
   pool->nalloc++;
   spin_unlock_irqrestore(&pool->lock, flags);
+
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+out:
+#endif
   blk = kasan_unpoison(blk, pool->blocksize);
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   memset(blk, MM_ALLOC_MAGIC, pool->blocksize);
@@ -432,8 +632,8 @@ retry:
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  irqstate_t flags;
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
@@ -445,12 +645,23 @@ void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 
 #endif
 
-  pool->nalloc--;
-
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   memset(blk, MM_FREE_MAGIC, pool->blocksize);
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+  kasan_poison(blk, pool->blocksize);
+  if (mempool_cache_release(pool, blk))
+    {
+      return;
+    }
+
+  blk = kasan_unpoison(blk, pool->blocksize);
+#endif
+
+  flags = spin_lock_irqsave(&pool->lock);
+  pool->nalloc--;
+
   if (pool->interruptsize > blocksize)
     {
       if ((FAR char *)blk >= pool->ibase &&
@@ -507,6 +718,12 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
   info->ordblks = sq_count(&pool->queue);
   info->iordblks = sq_count(&pool->iqueue);
   info->aordblks = pool->nalloc;
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+  /* The blocks held by the per-CPU caches are free */
+
+  info->ordblks  += mempool_cache_count(pool);
+  info->aordblks -= mempool_cache_count(pool);
+#endif
   info->arena = sq_count(&pool->equeue) * sizeof(sq_entry_t) +
     (info->aordblks + info->ordblks + info->iordblks) * blocksize;
   spin_unlock_irqrestore(&pool->lock, flags);
@@ -545,6 +762,10 @@ mempool_info_task(FAR struct mempool_s *pool,
       irqstate_t flags = spin_lock_irqsave(&pool->lock);
       size_t count = sq_count(&pool->queue) +
                      sq_count(&pool->iqueue);
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+
+      count += mempool_cache_count(pool);
+#endif
 
       spin_unlock_irqrestore(&pool->lock, flags);
       info.aordblks += count;
@@ -552,8 +773,13 @@ mempool_info_task(FAR struct mempool_s *pool,
     }
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      size_t nalloc = pool->nalloc;
+
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+      nalloc -= mempool_cache_count(pool);
+#endif
+      info.aordblks += nalloc;
+      info.uordblks += nalloc * blocksize;
     }
 #if CONFIG_MM_BACKTRACE >= 0
   else
@@ -622,6 +848,10 @@ int mempool_deinit(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   size_t count = 0;
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+  mempool_cache_flush(pool);
+#endif
+
   if (pool->nalloc != 0)
     {
       return -EBUSY;
@@ -138,6 +138,9 @@ static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
   size_t copysize;
   size_t totalsize;
   off_t offset;
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+  int cpu;
+#endif
 
   offset    = filep->f_pos;
   procfile  = filep->f_priv;
@@ -150,6 +153,22 @@ static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
                             &offset);
   totalsize = copysize;
 
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
+                                   "%13s%11s%9s%9s%9s%9s\n", "",
+                                   "cached", "ahit", "amiss", "fhit",
+                                   "fmiss");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
   for (entry = g_mempool_procfs; entry != NULL; entry = entry->next)
     {
       if (totalsize < buflen)
@@ -171,6 +190,28 @@ static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
           copysize   = procfs_memcpy(procfile->line, linesize, buffer,
                                      buflen, &offset);
           totalsize += copysize;
+
+#ifdef CONFIG_MM_MEMPOOL_PERCPU_CACHE
+          /* One line per CPU with the hits and misses of its cache */
+
+          for (cpu = 0; cpu < CONFIG_SMP_NCPUS && totalsize < buflen; cpu++)
+            {
+              FAR struct mempool_cache_s *cache = &pool->cache[cpu];
+
+              buffer    += copysize;
+              buflen    -= copysize;
+
+              linesize   = procfs_snprintf(procfile->line,
+                                           MEMPOOLINFO_LINELEN,
+                                           "%9scpu%d:%11zu%9lu%9lu%9lu%9lu"
+                                           "\n", "", cpu, cache->count,
+                                           cache->ahit, cache->amiss,
+                                           cache->fhit, cache->fmiss);
+              copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                         buflen, &offset);
+              totalsize += copysize;
+            }
+#endif
         }
     }
 
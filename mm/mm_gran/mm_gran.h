@@ -44,8 +44,19 @@
 
 #define SIZEOF_GAT(n) \
   ((n + 31) >> 5)
+#define SIZEOF_FULLMAP(n) \
+  ((SIZEOF_GAT(n) + 31) >> 5)
 #define SIZEOF_GRAN_S(n) \
-  (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
+  (sizeof(struct gran_s) + \
+   sizeof(uint32_t) * (SIZEOF_GAT(n) + SIZEOF_FULLMAP(n) - 1))
+
+/* The full map follows the GAT: one bit per GAT cell, set while all of
+ * the granules of the cell are in use.  With at most 65535 granules it
+ * has at most 64 words, summarized by the bits of fullsum[].
+ */
+
+#define GRAN_FULLMAP(g)   (&(g)->gat[SIZEOF_GAT((g)->ngranules)])
+#define GRAN_FULLSUM      2
 
 /* Debug */
 
@@ -77,6 +88,11 @@ struct gran_s
   mutex_t    lock;       /* For exclusive access to the GAT */
 #endif
   uintptr_t  heapstart; /* The aligned start of the granule heap */
+  uint16_t   hint;      /* GAT cell where the next search starts */
+
+  /* A bit set per full map word whose cells are all full */
+
+  uint32_t   fullsum[GRAN_FULLSUM];
   uint32_t   gat[1];    /* Start of the granule allocation table */
 };
 
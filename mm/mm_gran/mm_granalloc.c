@@ -65,6 +65,7 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
   if (posi >= 0)
     {
       gran_set(gran, posi, ngran);
+      gran->hint = (posi + ngran - 1) >> 5;
     }
 
   gran_leave_critical(gran);
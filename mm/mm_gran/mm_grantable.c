@@ -32,6 +32,7 @@
 #include <debug.h>
 
 #include <nuttx/bits.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/mm/gran.h>
 
 #include "mm_gran/mm_gran.h"
@@ -90,10 +91,26 @@ uint32_t lsb_mask(uint32_t n)
   return (-n & n) & GATCFULL;
 }
 
-/* set or clear a GAT cell with given bit mask */
+/* return LSB(n) */
+
+static inline uint32_t lsb_index(uint32_t n)
+{
+#ifdef CONFIG_HAVE_BUILTIN_CTZ
+  return __builtin_ctz(n);
+#else
+  return DEBRUJIN_LUT[(uint32_t)(lsb_mask(n) * DEBRUJIN_NUM) >> 27];
+#endif
+}
+
+/* set or clear a GAT cell with given bit mask, keeping the full map and
+ * its summary in sync
+ */
 
 static void cell_set(gran_t *gran, uint32_t cell, uint32_t mask, bool val)
 {
+  FAR uint32_t *fullmap = GRAN_FULLMAP(gran);
+  uint32_t word = cell >> 5;
+
   if (val)
     {
       gran->gat[cell] |= mask;
@@ -102,6 +119,77 @@ static void cell_set(gran_t *gran, uint32_t cell, uint32_t mask, bool val)
     {
       gran->gat[cell] &= ~mask;
     }
+
+  if (gran->gat[cell] == GATCFULL)
+    {
+      fullmap[word] |= BIT(cell & 31);
+    }
+  else
+    {
+      fullmap[word] &= ~BIT(cell & 31);
+    }
+
+  if (fullmap[word] == GATCFULL)
+    {
+      gran->fullsum[word >> 5] |= BIT(word & 31);
+    }
+  else
+    {
+      gran->fullsum[word >> 5] &= ~BIT(word & 31);
+    }
+}
+
+/* return the first GAT cell from cell on that is not full, or the number
+ * of cells if there is none.  Full stretches are skipped 32 or 1024 cells
+ * at a time.
+ */
+
+static uint32_t cell_nonfull(const gran_t *gran, uint32_t cell)
+{
+  FAR const uint32_t *fullmap = GRAN_FULLMAP(gran);
+  uint32_t ncells = SIZEOF_GAT(gran->ngranules);
+  uint32_t nwords = SIZEOF_FULLMAP(gran->ngranules);
+  uint32_t word = cell >> 5;
+  uint32_t m;
+
+  if (cell >= ncells)
+    {
+      return ncells;
+    }
+
+  m = ~fullmap[word] & (GATCFULL << (cell & 31));
+  while (m == 0)
+    {
+      /* Look for the next full map word with a cell that is not full */
+
+      if (++word >= nwords)
+        {
+          return ncells;
+        }
+
+      m = ~gran->fullsum[word >> 5] & (GATCFULL << (word & 31));
+      if (m == 0)
+        {
+          word = ALIGN_UP(word + 1, 32);
+          if (word >= nwords)
+            {
+              return ncells;
+            }
+
+          continue;
+        }
+
+      word = (word & ~31) + lsb_index(m);
+      if (word >= nwords)
+        {
+          return ncells;
+        }
+
+      m = ~fullmap[word];
+    }
+
+  cell = (word << 5) + lsb_index(m);
+  return cell < ncells ? cell : ncells;
 }
 
 /* set or clear a range of GAT bits */
@@ -240,24 +328,59 @@ failure:
 
 int gran_search(const gran_t *gran, size_t size)
 {
-  int ret = -EINVAL;
+  uint32_t cell;
+  size_t posi;
+
+  if (gran == NULL || size == 0 || gran->ngranules < size)
+    {
+      return -EINVAL;
+    }
+
+  /* A single granule comes from the first cell with room, next-fit from
+   * the cell of the last allocation, in a few summary lookups.
+   */
 
-  if (gran == NULL || gran->ngranules < size)
+  if (size == 1)
     {
-      return ret;
+      cell = cell_nonfull(gran, gran->hint);
+      if (cell >= SIZEOF_GAT(gran->ngranules))
+        {
+          cell = cell_nonfull(gran, 0);
+        }
+
+      if (cell < SIZEOF_GAT(gran->ngranules))
+        {
+          posi = (cell << 5) + lsb_index(~gran->gat[cell]);
+          if (posi < gran->ngranules)
+            {
+              return posi;
+            }
+        }
     }
 
-  ret = -ENOMEM;
-  for (size_t i = 0; i <= gran->ngranules - size; i++)
+  /* First-fit for ranges, skipping full cells; a failed match resumes
+   * after the last used granule it met.
+   */
+
+  for (posi = 0; posi <= gran->ngranules - size; posi++)
     {
-      if (gran_match(gran, i, size, 0, &i))
+      cell = cell_nonfull(gran, posi >> 5);
+      if (posi < (cell << 5))
         {
-          ret = i;
-          break;
+          posi = cell << 5;
+          if (posi > gran->ngranules - size)
+            {
+              break;
+            }
+        }
+
+      if (gran_match(gran, posi, size, 0, &posi))
+        {
+          return posi;
         }
     }
 
-  return ret;
+  return -ENOMEM;
 }
 
 /* set a range of granules */
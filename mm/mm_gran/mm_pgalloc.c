@@ -28,6 +28,7 @@
 
 #include <assert.h>
 
+#include <nuttx/nuttx.h>
 #include <nuttx/mm/gran.h>
 #include <nuttx/pgalloc.h>
 
@@ -150,6 +151,59 @@ uintptr_t mm_pgalloc(unsigned int npages)
   return (uintptr_t)gran_alloc(g_pgalloc, (size_t)npages << MM_PGSHIFT);
 }
 
+/****************************************************************************
+ * Name: mm_pgalloc_aligned
+ *
+ * Description:
+ *   Allocate physically contiguous page memory from the page memory pool,
+ *   aligned to a multiple of pages.
+ *
+ * Input Parameters:
+ *   npages - The number of pages to allocate, each of size CONFIG_MM_PGSIZE.
+ *   align  - The alignment in pages.  Must be a power of two.
+ *
+ * Returned Value:
+ *   On success, a non-zero, physical address of the allocated page memory
+ *   is returned.  Zero is returned on failure.
+ *
+ ****************************************************************************/
+
+uintptr_t mm_pgalloc_aligned(unsigned int npages, unsigned int align)
+{
+  uintptr_t paddr;
+  uintptr_t aligned;
+  uintptr_t end;
+  size_t size;
+
+  DEBUGASSERT(align > 0 && (align & (align - 1)) == 0);
+
+  /* Over-allocate by the alignment, then give back the pages before and
+   * after the aligned run.
+   */
+
+  size  = (size_t)(npages + align - 1) << MM_PGSHIFT;
+  paddr = (uintptr_t)gran_alloc(g_pgalloc, size);
+  if (paddr == 0)
+    {
+      return 0;
+    }
+
+  aligned = ALIGN_UP(paddr, (uintptr_t)align << MM_PGSHIFT);
+  end     = aligned + ((uintptr_t)npages << MM_PGSHIFT);
+
+  if (aligned > paddr)
+    {
+      gran_free(g_pgalloc, (FAR void *)paddr, aligned - paddr);
+    }
+
+  if (paddr + size > end)
+    {
+      gran_free(g_pgalloc, (FAR void *)end, paddr + size - end);
+    }
+
+  return aligned;
+}
+
 /****************************************************************************
  * Name: mm_pgfree
  *
@@ -149,6 +149,17 @@
 
 #define MM_ALLOCNODE_OVERHEAD (MM_SIZEOF_ALLOCNODE - sizeof(mmsize_t))
 
+/* The per-CPU chunk caches have one bin per node size up to the node size
+ * of CONFIG_MM_HEAP_TCACHE_MAXSIZE
+ */
+
+#ifdef CONFIG_MM_HEAP_TCACHE
+#  define MM_TCACHE_MAXNODE \
+     MM_ALIGN_UP(CONFIG_MM_HEAP_TCACHE_MAXSIZE + MM_ALLOCNODE_OVERHEAD)
+#  define MM_TCACHE_NDX(s)  ((s) / MM_ALIGN)
+#  define MM_TCACHE_NBINS   (MM_TCACHE_NDX(MM_TCACHE_MAXNODE) + 1)
+#endif
+
 /* Get the node size */
 
 #define MM_SIZEOF_NODE(node) ((node)->size & (~MM_MASK_BIT))
@@ -208,6 +219,8 @@ struct mm_freenode_s
 static_assert(MM_SIZEOF_ALLOCNODE <= MM_MIN_CHUNK,
               "Error size for struct mm_allocnode_s\n");
 
+static_assert(MM_NNODES <= 32, "Error size for mm_nodemask\n");
+
 static_assert(MM_ALIGN >= sizeof(uintptr_t) &&
               (MM_ALIGN & MM_GRAN_MASK) == 0,
               "Error memory alignment\n");
@@ -253,6 +266,13 @@ struct mm_heap_s
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
 
+  /* Bit n is set when mm_nodelist[n] may be followed by free nodes before
+   * mm_nodelist[n + 1].  mm_addfreechunk() sets the bits, mm_malloc()
+   * clears the bits of the lists that it finds empty.
+   */
+
+  uint32_t mm_nodemask;
+
   /* Free delay list, as sometimes we can't do free immdiately. */
 
   FAR struct mm_delaynode_s *mm_delaylist[CONFIG_SMP_NCPUS];
@@ -261,6 +281,13 @@ struct mm_heap_s
   size_t mm_delaycount[CONFIG_SMP_NCPUS];
 #endif
 
+  /* Per-CPU caches of small chunks that are still marked as allocated */
+
+#ifdef CONFIG_MM_HEAP_TCACHE
+  FAR struct mm_delaynode_s *mm_tcache[CONFIG_SMP_NCPUS][MM_TCACHE_NBINS];
+  uint8_t mm_tcount[CONFIG_SMP_NCPUS][MM_TCACHE_NBINS];
+#endif
+
   /* The is a multiple mempool of the heap */
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
@@ -310,4 +337,14 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
 
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
 
+/* Functions contained in mm_profile.c **************************************/
+
+#ifdef CONFIG_MM_HEAP_PROFILE
+void mm_profile_alloc(FAR void *mem, size_t size);
+void mm_profile_free(FAR void *mem);
+#else
+#  define mm_profile_alloc(mem, size)
+#  define mm_profile_free(mem)
+#endif
+
 #endif /* __MM_MM_HEAP_MM_H */
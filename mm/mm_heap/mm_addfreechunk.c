@@ -79,4 +79,6 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap,
 
       next->blink = node;
     }
+
+  heap->mm_nodemask |= 1u << ndx;
 }
@@ -102,3 +102,63 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
     }
 #undef region
 }
+
+/****************************************************************************
+ * Name: mm_foreach_unused
+ *
+ * Description:
+ *   Report the memory of each free chunk in heap that holds no heap
+ *   metadata, in address order within each region.  This is meant for
+ *   crash dumps, so the heap mutex is not taken and the walk of a region
+ *   stops at the first node that does not look sane.
+ *
+ * Input Parameters:
+ *   heap    - The heap to walk.
+ *   handler - Called with the start and size of each unused range.
+ *   arg     - Passed through to handler.
+ *
+ ****************************************************************************/
+
+void mm_foreach_unused(FAR struct mm_heap_s *heap,
+                       mm_range_handler_t handler, FAR void *arg)
+{
+  FAR struct mm_allocnode_s *node;
+  size_t nodesize;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#  define region 0
+#endif
+
+  DEBUGASSERT(handler);
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      for (node = heap->mm_heapstart[region];
+           node < heap->mm_heapend[region];
+           node = (FAR struct mm_allocnode_s *)((FAR char *)node + nodesize))
+        {
+          nodesize = MM_SIZEOF_NODE(node);
+          if (nodesize < MM_SIZEOF_ALLOCNODE ||
+              nodesize > (FAR char *)heap->mm_heapend[region] -
+                         (FAR char *)node)
+            {
+              break;
+            }
+
+          /* The links of the free list are kept, the preceding field of
+           * the next node lies beyond this node.
+           */
+
+          if (MM_NODE_IS_FREE(node) &&
+              nodesize > sizeof(struct mm_freenode_s))
+            {
+              handler((FAR char *)node + sizeof(struct mm_freenode_s),
+                      nodesize - sizeof(struct mm_freenode_s), arg);
+            }
+        }
+    }
+#undef region
+}
@@ -69,18 +69,15 @@ static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: mm_delayfree
+ * Name: free_node
  *
  * Description:
- *   Delay free memory if `delay` is true, otherwise free it immediately.
+ *   Return a chunk to the list of free nodes, merging it with the adjacent
+ *   free chunks.  The caller holds the heap mutex.
  *
  ****************************************************************************/
 
-void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
+static void free_node(FAR struct mm_heap_s *heap, FAR void *mem)
 {
   FAR struct mm_freenode_s *node;
   FAR struct mm_freenode_s *prev;
@@ -88,30 +85,6 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
   size_t nodesize;
   size_t prevsize;
 
-  if (mm_lock(heap) < 0)
-    {
-      /* Meet -ESRCH return, which means we are in situations
-       * during context switching(See mm_lock() & gettid()).
-       * Then add to the delay list.
-       */
-
-      add_delaylist(heap, mem);
-      return;
-    }
-
-#ifdef CONFIG_MM_FILL_ALLOCATIONS
-  memset(mem, MM_FREE_MAGIC, mm_malloc_size(heap, mem));
-#endif
-
-  kasan_poison(mem, mm_malloc_size(heap, mem));
-
-  if (delay)
-    {
-      mm_unlock(heap);
-      add_delaylist(heap, mem);
-      return;
-    }
-
   /* Map the memory chunk into a free node */
 
   node = (FAR struct mm_freenode_s *)((FAR char *)mem - MM_SIZEOF_ALLOCNODE);
@@ -202,6 +175,161 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
   /* Add the merged node to the nodelist */
 
   mm_addfreechunk(heap, node);
+}
+
+#ifdef CONFIG_MM_HEAP_TCACHE
+/****************************************************************************
+ * Name: free_list
+ *
+ * Description:
+ *   Return a list of cached chunks to the heap under a single lock.
+ *
+ ****************************************************************************/
+
+static void free_list(FAR struct mm_heap_s *heap,
+                      FAR struct mm_delaynode_s *list)
+{
+  FAR struct mm_delaynode_s *tmp;
+
+  if (mm_lock(heap) < 0)
+    {
+      while (list != NULL)
+        {
+          tmp  = list;
+          list = list->flink;
+          add_delaylist(heap, tmp);
+        }
+
+      return;
+    }
+
+  while (list != NULL)
+    {
+      tmp  = list;
+      list = list->flink;
+      free_node(heap, tmp);
+    }
+
+  mm_unlock(heap);
+}
+
+/****************************************************************************
+ * Name: tcache_put
+ *
+ * Description:
+ *   Put a small chunk into the cache of this CPU.  It stays marked as
+ *   allocated until it is reused or flushed to the heap.  A full bin
+ *   gives its older half back to the heap first.
+ *
+ *   Return true if the chunk was cached.
+ *
+ ****************************************************************************/
+
+static bool tcache_put(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_delaynode_s *tmp = mem;
+  FAR struct mm_delaynode_s *list = NULL;
+  FAR struct mm_freenode_s *node;
+  irqstate_t flags;
+  size_t nodesize;
+  int ndx;
+  int cpu;
+
+  node = (FAR struct mm_freenode_s *)((FAR char *)mem - MM_SIZEOF_ALLOCNODE);
+  nodesize = MM_SIZEOF_NODE(node);
+  if (nodesize > MM_TCACHE_MAXNODE || (nodesize & MM_GRAN_MASK) != 0)
+    {
+      return false;
+    }
+
+  DEBUGASSERT(MM_NODE_IS_ALLOC(node));
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(mem, MM_FREE_MAGIC, mm_malloc_size(heap, mem));
+#endif
+
+  kasan_poison(mem, mm_malloc_size(heap, mem));
+
+  ndx   = MM_TCACHE_NDX(nodesize);
+  flags = up_irq_save();
+  cpu   = this_cpu();
+
+  if (heap->mm_tcount[cpu][ndx] >= CONFIG_MM_HEAP_TCACHE_COUNT)
+    {
+      FAR struct mm_delaynode_s *last = heap->mm_tcache[cpu][ndx];
+      int keep = CONFIG_MM_HEAP_TCACHE_COUNT / 2;
+      int i;
+
+      /* Keep the most recently freed half, flush the rest */
+
+      for (i = 1; i < keep; i++)
+        {
+          last = last->flink;
+        }
+
+      list        = last->flink;
+      last->flink = NULL;
+      heap->mm_tcount[cpu][ndx] = keep;
+    }
+
+  tmp->flink = heap->mm_tcache[cpu][ndx];
+  heap->mm_tcache[cpu][ndx] = tmp;
+  heap->mm_tcount[cpu][ndx]++;
+
+  up_irq_restore(flags);
+
+  if (list != NULL)
+    {
+      free_list(heap, list);
+    }
+
+  return true;
+#else
+  return false;
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_delayfree
+ *
+ * Description:
+ *   Delay free memory if `delay` is true, otherwise free it immediately.
+ *
+ ****************************************************************************/
+
+void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
+{
+  if (mm_lock(heap) < 0)
+    {
+      /* Meet -ESRCH return, which means we are in situations
+       * during context switching(See mm_lock() & gettid()).
+       * Then add to the delay list.
+       */
+
+      add_delaylist(heap, mem);
+      return;
+    }
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(mem, MM_FREE_MAGIC, mm_malloc_size(heap, mem));
+#endif
+
+  kasan_poison(mem, mm_malloc_size(heap, mem));
+
+  if (delay)
+    {
+      mm_unlock(heap);
+      add_delaylist(heap, mem);
+      return;
+    }
+
+  free_node(heap, mem);
   mm_unlock(heap);
 }
 
@@ -226,6 +354,7 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
     }
 
   DEBUGASSERT(mm_heapmember(heap, mem));
+  mm_profile_free(mem);
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   if (heap->mm_mpool)
@@ -237,5 +366,12 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
     }
 #endif
 
+#ifdef CONFIG_MM_HEAP_TCACHE
+  if (tcache_put(heap, mem))
+    {
+      return;
+    }
+#endif
+
   mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
 }
@@ -28,6 +28,7 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <sched.h>
 #include <string.h>
 
 #include <nuttx/arch.h>
@@ -37,6 +38,21 @@
 
 #include "mm_heap/mm.h"
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if defined(CONFIG_MM_HEAP_TCACHE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+/* The chunks taken out of the bins of one CPU by tcache_flush() */
+
+struct tcache_detach_s
+{
+  FAR struct mm_heap_s *heap;
+  FAR struct mm_delaynode_s *bins[MM_TCACHE_NBINS];
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -108,6 +124,170 @@ static bool free_delaylist(FAR struct mm_heap_s *heap, bool force)
   return ret;
 }
 
+#ifdef CONFIG_MM_HEAP_TCACHE
+/****************************************************************************
+ * Name: tcache_get
+ *
+ * Description:
+ *   Take a chunk of exactly 'alignsize' bytes from the cache of this CPU.
+ *
+ *   Return the node or NULL if the bin is empty.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_freenode_s *tcache_get(FAR struct mm_heap_s *heap,
+                                            size_t alignsize)
+{
+  FAR struct mm_delaynode_s *tmp = NULL;
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  irqstate_t flags;
+  int ndx;
+  int cpu;
+
+  if (alignsize > MM_TCACHE_MAXNODE)
+    {
+      return NULL;
+    }
+
+  ndx   = MM_TCACHE_NDX(alignsize);
+  flags = up_irq_save();
+  cpu   = this_cpu();
+
+  tmp = heap->mm_tcache[cpu][ndx];
+  if (tmp != NULL)
+    {
+      heap->mm_tcache[cpu][ndx] = tmp->flink;
+      heap->mm_tcount[cpu][ndx]--;
+    }
+
+  up_irq_restore(flags);
+#endif
+
+  if (tmp == NULL)
+    {
+      return NULL;
+    }
+
+  return (FAR struct mm_freenode_s *)
+    ((FAR char *)tmp - MM_SIZEOF_ALLOCNODE);
+}
+
+/****************************************************************************
+ * Name: tcache_detach
+ *
+ * Description:
+ *   Take all the chunks cached by the calling CPU out of its bins.  A CPU
+ *   only touches its own bins, with its interrupts disabled, so this runs
+ *   on each CPU in turn.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+static int tcache_detach(FAR void *arg)
+{
+  FAR struct tcache_detach_s *detach = arg;
+  FAR struct mm_heap_s *heap = detach->heap;
+  irqstate_t flags;
+  int ndx;
+  int cpu;
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+
+  for (ndx = 0; ndx < MM_TCACHE_NBINS; ndx++)
+    {
+      detach->bins[ndx] = heap->mm_tcache[cpu][ndx];
+      heap->mm_tcache[cpu][ndx] = NULL;
+      heap->mm_tcount[cpu][ndx] = 0;
+    }
+
+  up_irq_restore(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcache_release
+ *
+ * Description:
+ *   Give the chunks detached by tcache_detach() back to the heap.
+ *
+ *   Return true if there is memory freed.
+ *
+ ****************************************************************************/
+
+static bool tcache_release(FAR struct tcache_detach_s *detach)
+{
+  FAR struct mm_delaynode_s *tmp;
+  bool ret = false;
+  int ndx;
+
+  for (ndx = 0; ndx < MM_TCACHE_NBINS; ndx++)
+    {
+      tmp = detach->bins[ndx];
+      while (tmp)
+        {
+          FAR void *address = tmp;
+
+          tmp = tmp->flink;
+          mm_delayfree(detach->heap, address, false);
+          ret = true;
+        }
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcache_flush
+ *
+ * Description:
+ *   Give all the chunks cached by all CPUs back to the heap.
+ *
+ *   Return true if there is memory freed.
+ *
+ ****************************************************************************/
+
+static bool tcache_flush(FAR struct mm_heap_s *heap)
+{
+  bool ret = false;
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  struct tcache_detach_s detach;
+#ifdef CONFIG_SMP
+  int cpu;
+#endif
+
+  detach.heap = heap;
+
+#ifdef CONFIG_SMP
+  /* Have each CPU detach its bins.  Waiting for the other CPUs needs a
+   * context that can block, else only the bins of this CPU are flushed.
+   */
+
+  if (!up_interrupt_context() && !sched_idletask())
+    {
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          if (nxsched_smp_call_single(cpu, tcache_detach, &detach,
+                                      true) >= 0 &&
+              tcache_release(&detach))
+            {
+              ret = true;
+            }
+        }
+
+      return ret;
+    }
+#endif
+
+  tcache_detach(&detach);
+  ret = tcache_release(&detach);
+#endif
+
+  return ret;
+}
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 void mm_dump_handler(FAR struct tcb_s *tcb, FAR void *arg)
 {
@@ -152,6 +332,9 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap)
   if (heap)
     {
        free_delaylist(heap, true);
+#ifdef CONFIG_MM_HEAP_TCACHE
+       tcache_flush(heap);
+#endif
     }
 }
 
@@ -184,6 +367,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       ret = mempool_multiple_alloc(heap->mm_mpool, size);
       if (ret != NULL)
         {
+          mm_profile_alloc(ret, size);
           return ret;
         }
     }
@@ -209,6 +393,17 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   DEBUGASSERT(alignsize >= MM_ALIGN);
 
+#ifdef CONFIG_MM_HEAP_TCACHE
+  /* Reuse a chunk of exactly this size cached by this CPU */
+
+  node = tcache_get(heap, alignsize);
+  if (node != NULL)
+    {
+      ret = (FAR void *)((FAR char *)node + MM_SIZEOF_ALLOCNODE);
+      goto out;
+    }
+
+#endif
   /* We need to hold the MM mutex while we muck with the nodelist. */
 
   DEBUGVERIFY(mm_lock(heap));
@@ -218,11 +413,13 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   ndx = mm_size2ndx(alignsize);
 
   /* Search for a large enough chunk in the list of nodes. This list is
-   * ordered by size, but will have occasional zero sized nodes as we visit
-   * other mm_nodelist[] entries.
+   * ordered by size and the zero sized mm_nodelist[] entries split it in
+   * size classes.  Only the first class may hold chunks that are too small;
+   * the first chunk of any other non-empty class is the best fit.
    */
 
-  for (node = heap->mm_nodelist[ndx].flink; node; node = node->flink)
+  for (node = heap->mm_nodelist[ndx].flink; node && node->size;
+       node = node->flink)
     {
       DEBUGASSERT(node->blink->flink == node);
       nodesize = MM_SIZEOF_NODE(node);
@@ -232,6 +429,35 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
         }
     }
 
+  if (node == heap->mm_nodelist[ndx].flink && (!node || !node->size))
+    {
+      heap->mm_nodemask &= ~(1u << ndx);
+    }
+
+  while ((!node || !node->size) && ndx < MM_NNODES - 1)
+    {
+      /* Find the next size class that may be non-empty */
+
+      ndx = ffs(heap->mm_nodemask & ~((2u << ndx) - 1)) - 1;
+      if (ndx < 0)
+        {
+          node = NULL;
+          break;
+        }
+
+      node = heap->mm_nodelist[ndx].flink;
+      if (node && node->size)
+        {
+          DEBUGASSERT(node->blink->flink == node);
+          nodesize = MM_SIZEOF_NODE(node);
+          DEBUGASSERT(nodesize >= alignsize);
+        }
+      else
+        {
+          heap->mm_nodemask &= ~(1u << ndx);
+        }
+    }
+
   /* If we found a node with non-zero size, then this is one to use. Since
    * the list is ordered, we know that it must be the best fitting chunk
    * available.
@@ -321,10 +547,14 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   DEBUGASSERT(ret == NULL || mm_heapmember(heap, ret));
   mm_unlock(heap);
 
+#ifdef CONFIG_MM_HEAP_TCACHE
+out:
+#endif
   if (ret)
     {
       MM_ADD_BACKTRACE(heap, node);
       ret = kasan_unpoison(ret, mm_malloc_size(heap, ret));
+      mm_profile_alloc(ret, size);
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
       memset(ret, MM_ALLOC_MAGIC, alignsize - MM_ALLOCNODE_OVERHEAD);
 #endif
@@ -342,6 +572,15 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+#ifdef CONFIG_MM_HEAP_TCACHE
+  /* Try again after flushing the chunks cached by the CPUs */
+
+  else if (tcache_flush(heap))
+    {
+      return mm_malloc(heap, size);
+    }
+#endif
+
 #ifdef CONFIG_DEBUG_MM
   else if (MM_INTERNAL_HEAP(heap))
     {
@@ -80,6 +80,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       node = mempool_multiple_memalign(heap->mm_mpool, alignment, size);
       if (node != NULL)
         {
+          mm_profile_alloc(node, size);
           return node;
         }
     }
@@ -283,5 +284,6 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
                                    (FAR void *)alignedchunk));
 
   DEBUGASSERT(alignedchunk % alignment == 0);
+  mm_profile_alloc((FAR void *)alignedchunk, size);
   return (FAR void *)alignedchunk;
 }
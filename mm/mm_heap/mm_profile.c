@@ -0,0 +1,494 @@
+/****************************************************************************
+ * mm/mm_heap/mm_profile.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_MM_HEAP_PROFILE_NSAMPLES & (CONFIG_MM_HEAP_PROFILE_NSAMPLES - 1))
+#  error CONFIG_MM_HEAP_PROFILE_NSAMPLES must be a power of two
+#endif
+
+#define MM_PROFILE_MASK   (CONFIG_MM_HEAP_PROFILE_NSAMPLES - 1)
+
+/* Keep a quarter of the table empty so the probe sequences stay short */
+
+#define MM_PROFILE_MAXLIVE \
+  (CONFIG_MM_HEAP_PROFILE_NSAMPLES - CONFIG_MM_HEAP_PROFILE_NSAMPLES / 4)
+
+#define MM_PROFILE_HASH(p) \
+  ((((uintptr_t)(p) >> 4) * 2654435761u) & MM_PROFILE_MASK)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One sampled allocation which is still live */
+
+struct mm_profile_sample_s
+{
+  FAR void *ptr;                     /* The allocation, NULL if unused */
+  size_t size;                       /* The requested size */
+  size_t weight;                     /* The bytes this sample stands for */
+  pid_t pid;                         /* The allocating thread */
+  FAR void *backtrace[CONFIG_MM_HEAP_PROFILE_DEPTH];
+};
+
+/* The bytes left before the next sample, per CPU.  They are updated
+ * without a lock: a race between two threads of one CPU only moves a
+ * sample by a few bytes.
+ */
+
+struct mm_profile_cpu_s
+{
+  ssize_t countdown;
+  uint32_t seed;
+};
+
+struct mm_profile_s
+{
+  spinlock_t lock;                   /* Protects the table */
+  size_t interval;                   /* The mean bytes between samples */
+  unsigned int nlive;                /* The number of used entries */
+  unsigned long dropped;             /* Samples lost with a full table */
+  struct mm_profile_cpu_s cpu[CONFIG_SMP_NCPUS];
+  struct mm_profile_sample_s table[CONFIG_MM_HEAP_PROFILE_NSAMPLES];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     mm_profile_open(FAR struct file *filep,
+                               FAR const char *relpath,
+                               int oflags, mode_t mode);
+static int     mm_profile_close(FAR struct file *filep);
+static ssize_t mm_profile_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen);
+static ssize_t mm_profile_write(FAR struct file *filep,
+                                FAR const char *buffer, size_t buflen);
+static int     mm_profile_dup(FAR const struct file *oldp,
+                              FAR struct file *newp);
+static int     mm_profile_stat(FAR const char *relpath,
+                               FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct mm_profile_s g_mm_profile =
+{
+  SP_UNLOCKED,
+  CONFIG_MM_HEAP_PROFILE_INTERVAL,
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct procfs_operations g_heapprof_operations =
+{
+  mm_profile_open,    /* open */
+  mm_profile_close,   /* close */
+  mm_profile_read,    /* read */
+  mm_profile_write,   /* write */
+  NULL,               /* poll */
+
+  mm_profile_dup,     /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  mm_profile_stat     /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_profile_next
+ *
+ * Description:
+ *   Return the distance to the next sample, spread evenly around the
+ *   sampling interval so that periodic allocation patterns do not always
+ *   hit or always miss the samples.
+ *
+ ****************************************************************************/
+
+static ssize_t mm_profile_next(FAR struct mm_profile_cpu_s *cpu,
+                               size_t interval)
+{
+  uint32_t x = cpu->seed != 0 ? cpu->seed : 2463534242u;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  cpu->seed = x;
+
+  return interval / 2 + x % interval + 1;
+}
+
+/****************************************************************************
+ * Name: mm_profile_insert
+ *
+ * Description:
+ *   Add a sample to the live table.  Called with the lock held.
+ *
+ ****************************************************************************/
+
+static void mm_profile_insert(FAR struct mm_profile_sample_s *sample)
+{
+  unsigned int i;
+
+  if (g_mm_profile.nlive >= MM_PROFILE_MAXLIVE)
+    {
+      g_mm_profile.dropped++;
+      return;
+    }
+
+  for (i = MM_PROFILE_HASH(sample->ptr);
+       g_mm_profile.table[i].ptr != NULL;
+       i = (i + 1) & MM_PROFILE_MASK)
+    {
+    }
+
+  memcpy(&g_mm_profile.table[i], sample, sizeof(*sample));
+  g_mm_profile.nlive++;
+}
+
+/****************************************************************************
+ * Name: mm_profile_remove
+ *
+ * Description:
+ *   Remove the sample of mem from the live table, if there is one.  The
+ *   entries which follow in the probe sequence are shifted back, so no
+ *   tombstones are needed.  Called with the lock held.
+ *
+ ****************************************************************************/
+
+static void mm_profile_remove(FAR void *mem)
+{
+  FAR struct mm_profile_sample_s *table = g_mm_profile.table;
+  unsigned int home;
+  unsigned int i;
+  unsigned int j;
+
+  for (i = MM_PROFILE_HASH(mem); table[i].ptr != mem;
+       i = (i + 1) & MM_PROFILE_MASK)
+    {
+      if (table[i].ptr == NULL)
+        {
+          return;
+        }
+    }
+
+  for (j = (i + 1) & MM_PROFILE_MASK; table[j].ptr != NULL;
+       j = (j + 1) & MM_PROFILE_MASK)
+    {
+      /* Move entry j into the hole at i unless its home slot lies
+       * cyclically in (i, j].
+       */
+
+      home = MM_PROFILE_HASH(table[j].ptr);
+      if (((j - home) & MM_PROFILE_MASK) >= ((j - i) & MM_PROFILE_MASK))
+        {
+          memcpy(&table[i], &table[j], sizeof(*table));
+          i = j;
+        }
+    }
+
+  table[i].ptr = NULL;
+  g_mm_profile.nlive--;
+}
+
+/****************************************************************************
+ * Name: mm_profile_open
+ ****************************************************************************/
+
+static int mm_profile_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode)
+{
+  FAR struct procfs_file_s *attr;
+
+  attr = kmm_zalloc(sizeof(struct procfs_file_s));
+  if (attr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_profile_close
+ ****************************************************************************/
+
+static int mm_profile_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_profile_read
+ *
+ * Description:
+ *   Print the live samples as folded stacks, one line per sample: the
+ *   thread, then the frames from the outermost caller to the allocation
+ *   site separated by ';', then the bytes the sample stands for.  This is
+ *   the input format of flamegraph.pl and most flame graph viewers.
+ *
+ ****************************************************************************/
+
+static ssize_t mm_profile_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  struct mm_profile_sample_s sample;
+  off_t offset = filep->f_pos;
+  irqstate_t flags;
+  int depth;
+  int i;
+
+  procfs_sprintf(buffer, buflen, &offset,
+                 "# interval %zu live %u dropped %lu\n",
+                 g_mm_profile.interval, g_mm_profile.nlive,
+                 g_mm_profile.dropped);
+
+  for (i = 0; i < CONFIG_MM_HEAP_PROFILE_NSAMPLES; i++)
+    {
+      flags = spin_lock_irqsave(&g_mm_profile.lock);
+      memcpy(&sample, &g_mm_profile.table[i], sizeof(sample));
+      spin_unlock_irqrestore(&g_mm_profile.lock, flags);
+
+      if (sample.ptr == NULL)
+        {
+          continue;
+        }
+
+      procfs_sprintf(buffer, buflen, &offset, "pid %d", sample.pid);
+
+      for (depth = 0; depth < CONFIG_MM_HEAP_PROFILE_DEPTH &&
+                      sample.backtrace[depth] != NULL; depth++)
+        {
+        }
+
+      while (depth-- > 0)
+        {
+          procfs_sprintf(buffer, buflen, &offset, ";%p",
+                         sample.backtrace[depth]);
+        }
+
+      procfs_sprintf(buffer, buflen, &offset, " %zu\n", sample.weight);
+    }
+
+  if (offset >= 0)
+    {
+      return 0;
+    }
+
+  filep->f_pos += -offset;
+  return -offset;
+}
+
+/****************************************************************************
+ * Name: mm_profile_write
+ *
+ * Description:
+ *   Set the mean sampling interval in bytes, 0 stops sampling.  The
+ *   samples taken so far are kept until their memory is freed.
+ *
+ ****************************************************************************/
+
+static ssize_t mm_profile_write(FAR struct file *filep,
+                                FAR const char *buffer, size_t buflen)
+{
+  char str[16];
+  int i;
+
+  if (buflen >= sizeof(str))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(str, buffer, buflen);
+  str[buflen] = '\0';
+
+  g_mm_profile.interval = strtoul(str, NULL, 0);
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      g_mm_profile.cpu[i].countdown = 0;
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: mm_profile_dup
+ ****************************************************************************/
+
+static int mm_profile_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct procfs_file_s *attr;
+
+  attr = kmm_malloc(sizeof(struct procfs_file_s));
+  if (attr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(attr, oldp->f_priv, sizeof(struct procfs_file_s));
+  newp->f_priv = attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_profile_stat
+ ****************************************************************************/
+
+static int mm_profile_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_profile_alloc
+ *
+ * Description:
+ *   Account a successful allocation.  One byte in every interval bytes on
+ *   average is sampled, so an allocation is picked with a probability
+ *   proportional to its size, and a picked allocation records the bytes
+ *   it stands for together with its backtrace.  The common path is a
+ *   subtraction and a compare.
+ *
+ * Input Parameters:
+ *   mem  - The allocated memory.
+ *   size - The requested size.
+ *
+ ****************************************************************************/
+
+void mm_profile_alloc(FAR void *mem, size_t size)
+{
+  struct mm_profile_sample_s sample;
+  FAR struct mm_profile_cpu_s *cpu;
+  size_t interval = g_mm_profile.interval;
+  irqstate_t flags;
+  size_t deficit;
+  int n;
+
+  if (interval == 0 || mem == NULL)
+    {
+      return;
+    }
+
+  cpu = &g_mm_profile.cpu[this_cpu()];
+  cpu->countdown -= size;
+  if (cpu->countdown > 0)
+    {
+      return;
+    }
+
+  /* A large allocation may cross several sampling points at once */
+
+  deficit = -cpu->countdown;
+  cpu->countdown = mm_profile_next(cpu, interval);
+
+  sample.ptr    = mem;
+  sample.size   = size;
+  sample.weight = (deficit / interval + 1) * interval;
+  sample.pid    = _SCHED_GETTID();
+
+  n = sched_backtrace(sample.pid, sample.backtrace,
+                      CONFIG_MM_HEAP_PROFILE_DEPTH, 2);
+  if (n < 0)
+    {
+      n = 0;
+    }
+
+  if (n < CONFIG_MM_HEAP_PROFILE_DEPTH)
+    {
+      sample.backtrace[n] = NULL;
+    }
+
+  flags = spin_lock_irqsave(&g_mm_profile.lock);
+  mm_profile_insert(&sample);
+  spin_unlock_irqrestore(&g_mm_profile.lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_profile_free
+ *
+ * Description:
+ *   Forget the sample of mem, if it was sampled.
+ *
+ * Input Parameters:
+ *   mem - The memory being freed.
+ *
+ ****************************************************************************/
+
+void mm_profile_free(FAR void *mem)
+{
+  irqstate_t flags;
+
+  if (g_mm_profile.nlive == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_mm_profile.lock);
+  mm_profile_remove(mem);
+  spin_unlock_irqrestore(&g_mm_profile.lock, flags);
+}
@@ -91,6 +91,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       newmem = mempool_multiple_realloc(heap->mm_mpool, oldmem, size);
       if (newmem != NULL)
         {
+          mm_profile_free(oldmem);
+          mm_profile_alloc(newmem, size);
           return newmem;
         }
       else if (size <= heap->mm_threshold ||
@@ -159,6 +161,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
       mm_unlock(heap);
       MM_ADD_BACKTRACE(heap, oldnode);
+      mm_profile_free(oldmem);
+      mm_profile_alloc(oldmem, size);
 
       return oldmem;
     }
@@ -386,6 +390,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       MM_ADD_BACKTRACE(heap, (FAR char *)newmem - MM_SIZEOF_ALLOCNODE);
 
       newmem = kasan_unpoison(newmem, mm_malloc_size(heap, newmem));
+      mm_profile_free(oldmem);
+      mm_profile_alloc(newmem, size);
       if (kasan_reset_tag(newmem) != kasan_reset_tag(oldmem))
         {
           /* Now we have to move the user contents 'down' in memory.  memcpy
@@ -33,6 +33,7 @@
 
 #include <nuttx/sched.h>
 #include <nuttx/arch.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/pgalloc.h>
 #include <nuttx/mm/map.h>
 
@@ -214,6 +215,11 @@ FAR void *shmat(int shmid, FAR const void *shmaddr, int shmflg)
   unsigned int npages;
   int ret;
   struct mm_map_entry_s entry;
+#ifdef CONFIG_MM_PGALLOC_LARGE
+  uintptr_t start;
+  uintptr_t end;
+  size_t size;
+#endif
 
   /* Get the region associated with the shmid */
 
@@ -239,8 +245,42 @@ FAR void *shmat(int shmid, FAR const void *shmaddr, int shmflg)
 
   /* Set aside a virtual address space to span this physical region */
 
-  vaddr = vm_alloc_region(get_group_mm(group), NULL,
-                          region->sr_ds.shm_segsz);
+#ifdef CONFIG_MM_PGALLOC_LARGE
+  if (region->sr_ds.shm_segsz >= MM_LARGE_PGSIZE)
+    {
+      /* Align the region to a large page, like its physical pages, and
+       * give back the rest of the space.
+       */
+
+      size  = region->sr_ds.shm_segsz + MM_LARGE_PGSIZE - MM_PGSIZE;
+      vaddr = vm_alloc_region(get_group_mm(group), NULL, size);
+      if (vaddr != NULL)
+        {
+          start = ALIGN_UP((uintptr_t)vaddr, MM_LARGE_PGSIZE);
+          end   = MM_PGALIGNUP(start + region->sr_ds.shm_segsz);
+
+          if (start > (uintptr_t)vaddr)
+            {
+              vm_release_region(get_group_mm(group), vaddr,
+                                start - (uintptr_t)vaddr);
+            }
+
+          if ((uintptr_t)vaddr + size > end)
+            {
+              vm_release_region(get_group_mm(group), (FAR void *)end,
+                                (uintptr_t)vaddr + size - end);
+            }
+
+          vaddr = (FAR void *)start;
+        }
+    }
+  else
+#endif
+    {
+      vaddr = vm_alloc_region(get_group_mm(group), NULL,
+                              region->sr_ds.shm_segsz);
+    }
+
   if (vaddr == NULL)
     {
       shmerr("ERROR: vm_alloc_regioon() failed\n");
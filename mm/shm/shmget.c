@@ -166,6 +166,10 @@ static int shm_extend(int shmid, size_t size)
   FAR struct shm_region_s *region = &g_shminfo.si_region[shmid];
   unsigned int pgalloc;
   unsigned int pgneeded;
+#ifdef CONFIG_MM_PGALLOC_LARGE
+  uintptr_t paddr;
+  unsigned int i;
+#endif
 
   /* This is the number of pages that are needed to satisfy the allocation */
 
@@ -179,6 +183,30 @@ static int shm_extend(int shmid, size_t size)
 
   while (pgalloc < pgneeded && pgalloc < CONFIG_ARCH_SHM_NPAGES)
     {
+#ifdef CONFIG_MM_PGALLOC_LARGE
+      /* Allocate a whole large page where one fits, so that the region can
+       * be mapped with block descriptors.
+       */
+
+      if (pgalloc % MM_LARGE_NPAGES == 0 &&
+          pgneeded - pgalloc >= MM_LARGE_NPAGES &&
+          CONFIG_ARCH_SHM_NPAGES - pgalloc >= MM_LARGE_NPAGES)
+        {
+          paddr = mm_pgalloc_aligned(MM_LARGE_NPAGES, MM_LARGE_NPAGES);
+          if (paddr != 0)
+            {
+              memset((FAR void *)paddr, 0, MM_LARGE_PGSIZE);
+
+              for (i = 0; i < MM_LARGE_NPAGES; i++)
+                {
+                  region->sr_pages[pgalloc++] = paddr + (i << MM_PGSHIFT);
+                }
+
+              continue;
+            }
+        }
+#endif
+
       /* Allocate one more physical page */
 
       region->sr_pages[pgalloc] = mm_pgalloc(1);
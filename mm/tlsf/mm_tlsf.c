@@ -130,6 +130,12 @@ struct mm_mallinfo_handler_s
   FAR struct mallinfo_task *info;
 };
 
+struct mm_foreach_unused_s
+{
+  mm_range_handler_t handler;
+  FAR void *arg;
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -479,6 +485,28 @@ static void memdump_handler(FAR void *ptr, size_t size, int used,
     }
 }
 
+/****************************************************************************
+ * Name: unused_handler
+ *
+ * Description:
+ *   Report the payload of a free block without the free list links at its
+ *   start and the physical link of the next block at its end.
+ *
+ ****************************************************************************/
+
+static void unused_handler(FAR void *ptr, size_t size, int used,
+                           FAR void *user)
+{
+  FAR struct mm_foreach_unused_s *unused = user;
+  size_t overhead = 3 * sizeof(FAR void *);
+
+  if (!used && size > overhead)
+    {
+      unused->handler((FAR char *)ptr + 2 * sizeof(FAR void *),
+                      size - overhead, unused->arg);
+    }
+}
+
 /****************************************************************************
  * Name: mm_delayfree
  *
@@ -1038,6 +1066,38 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
   return info;
 }
 
+/****************************************************************************
+ * Name: mm_foreach_unused
+ *
+ * Description:
+ *   Report the memory of each free block in heap that holds no heap
+ *   metadata.  This is meant for crash dumps, so the heap mutex is not
+ *   taken.
+ *
+ ****************************************************************************/
+
+void mm_foreach_unused(FAR struct mm_heap_s *heap,
+                       mm_range_handler_t handler, FAR void *arg)
+{
+  struct mm_foreach_unused_s unused;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#  define region 0
+#endif
+
+  unused.handler = handler;
+  unused.arg     = arg;
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      tlsf_walk_pool(heap->mm_heapstart[region], unused_handler, &unused);
+    }
+#undef region
+}
+
 /****************************************************************************
  * Name: mm_memdump
  *
@@ -45,6 +45,7 @@
 #include <netinet/arp.h>
 #include <netinet/in.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/semaphore.h>
 
@@ -161,6 +162,8 @@ struct arp_notify_s
 
 struct arp_entry_s
 {
+  hash_node_t              at_hnode;    /* Link in the hash bucket */
+  dq_entry_t               at_lru;      /* Link in the LRU or free list */
   in_addr_t                at_ipaddr;   /* IP address */
   struct ether_addr        at_ethaddr;  /* Hardware address */
   clock_t                  at_time;     /* Time of last usage */
@@ -60,7 +60,7 @@ static void arp_send_terminate(FAR struct net_driver_s *dev,
 
   state->snd_sent      = true;
   state->snd_result    = (int16_t)result;
-  state->snd_cb->flags = 0;
+  devif_callback_setflags(state->snd_cb, 0);
   state->snd_cb->priv  = NULL;
   state->snd_cb->event = NULL;
 
@@ -328,7 +328,7 @@ int arp_send(in_addr_t ipaddr)
 
       state.snd_sent      = false;
       state.snd_result    = -EBUSY;
-      state.snd_cb->flags = (ARP_POLL | NETDEV_DOWN);
+      devif_callback_setflags(state.snd_cb, ARP_POLL | NETDEV_DOWN);
       state.snd_cb->priv  = (FAR void *)&state;
       state.snd_cb->event = arp_send_eventhandler;
       state.finish_cb     = NULL;
@@ -461,7 +461,7 @@ int arp_send_async(in_addr_t ipaddr, arp_send_finish_cb_t cb)
 
   /* Arm/re-arm the callback */
 
-  state->snd_cb->flags = (ARP_POLL | NETDEV_DOWN);
+  devif_callback_setflags(state->snd_cb, ARP_POLL | NETDEV_DOWN);
   state->snd_cb->priv  = (FAR void *)state;
   state->snd_cb->event = arp_send_eventhandler;
   state->finish_cb     = cb;
@@ -73,6 +73,16 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+/* About one hash bucket per table entry */
+
+#if CONFIG_NET_ARPTAB_SIZE > 1
+#  define ARP_HASH_BITS LOG2_CEIL(CONFIG_NET_ARPTAB_SIZE)
+#else
+#  define ARP_HASH_BITS 1
+#endif
+
+#define ARP_ENTRY(p, m) container_of(p, struct arp_entry_s, m)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -87,9 +97,17 @@ struct arp_table_info_s
  * Private Data
  ****************************************************************************/
 
-/* The table of known address mappings */
+/* The table of known address mappings.  The entries in use are indexed
+ * by IP address in g_arphash and linked in g_arplru, the most recently
+ * used first.  The deleted entries are linked in g_arpfree, and the
+ * entries from g_arpnext on were never used.
+ */
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static DECLARE_HASHTABLE(g_arphash, ARP_HASH_BITS);
+static dq_queue_t g_arplru;
+static dq_queue_t g_arpfree;
+static unsigned int g_arpnext;
 
 /****************************************************************************
  * Private Functions
@@ -142,39 +160,38 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_hash_find
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Find the ARP entry of this IP address and device, expired or not.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static FAR struct arp_entry_s *arp_hash_find(in_addr_t ipaddr,
+                                             FAR struct net_driver_s *dev)
 {
-  if (e1->at_ipaddr == 0)
-    {
-      return e1;
-    }
-  else if (e2->at_ipaddr == 0)
-    {
-      return e2;
-    }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
-    {
-      return e1;
-    }
-  else
+  FAR hash_node_t *p;
+
+  hashtable_for_every_possible(g_arphash, p, ipaddr)
     {
-      return e2;
+      FAR struct arp_entry_s *tabptr = ARP_ENTRY(p, at_hnode);
+
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
     }
+
+  return NULL;
 }
 
 /****************************************************************************
  * Name: arp_lookup
  *
  * Description:
- *   Find the ARP entry corresponding to this IP address in the ARP table.
+ *   Find the ARP entry corresponding to this IP address in the ARP table,
+ *   and make it the most recently used entry.
  *
  * Input Parameters:
  *   ipaddr - Refers to an IP address in network order
@@ -190,19 +207,20 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
-  int i;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_hash_find(ipaddr, dev);
+  if (tabptr != NULL &&
+      clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
+      if (dq_peek(&g_arplru) != &tabptr->at_lru)
         {
-          return tabptr;
+          dq_rem(&tabptr->at_lru, &g_arplru);
+          dq_addfirst(&tabptr->at_lru, &g_arplru);
         }
+
+      return tabptr;
     }
 
   /* Not found */
@@ -210,6 +228,54 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: arp_alloc
+ *
+ * Description:
+ *   Get an unused ARP table entry, or the least recently used one if the
+ *   table is full.  The entry that is returned is not linked anywhere.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_alloc(void)
+{
+  FAR struct arp_entry_s *tabptr;
+  FAR dq_entry_t *entry;
+
+  entry = dq_remfirst(&g_arpfree);
+  if (entry != NULL)
+    {
+      return ARP_ENTRY(entry, at_lru);
+    }
+
+  if (g_arpnext < CONFIG_NET_ARPTAB_SIZE)
+    {
+      return &g_arptable[g_arpnext++];
+    }
+
+  tabptr = ARP_ENTRY(dq_remlast(&g_arplru), at_lru);
+  hashtable_delete(g_arphash, &tabptr->at_hnode, tabptr->at_ipaddr);
+  return tabptr;
+}
+
+/****************************************************************************
+ * Name: arp_release
+ *
+ * Description:
+ *   Remove an entry from the ARP table.
+ *
+ ****************************************************************************/
+
+static void arp_release(FAR struct arp_entry_s *tabptr)
+{
+  hashtable_delete(g_arphash, &tabptr->at_hnode, tabptr->at_ipaddr);
+  dq_rem(&tabptr->at_lru, &g_arplru);
+
+  tabptr->at_ipaddr = 0;
+  tabptr->at_dev    = NULL;
+  dq_addlast(&tabptr->at_lru, &g_arpfree);
+}
+
 /****************************************************************************
  * Name: arp_get_arpreq
  *
@@ -269,43 +335,27 @@ static void arp_get_arpreq(FAR struct arpreq *output,
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *tabptr;
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
-  bool found = false;
   bool new_entry;
 #endif
-  int i;
+  bool found;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Try to find an entry to update.  If none is found, the IP -> MAC
+   * address mapping is inserted in the ARP table, in an unused entry or
+   * in place of the least recently used one.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_hash_find(ipaddr, dev);
+  found  = tabptr != NULL;
+  if (found)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
-#ifdef CONFIG_NETLINK_ROUTE
-          found = true;
-#endif
-          break;
-        }
-      else
-        {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
+      dq_rem(&tabptr->at_lru, &g_arplru);
+    }
+  else
+    {
+      tabptr = arp_alloc();
     }
 
   /* When overwite old entry, notify old entry RTM_DELNEIGH */
@@ -332,6 +382,13 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
   tabptr->at_dev = dev;
   tabptr->at_time = clock_systime_ticks();
 
+  if (!found)
+    {
+      hashtable_add(g_arphash, &tabptr->at_hnode, ipaddr);
+    }
+
+  dq_addfirst(&tabptr->at_lru, &g_arplru);
+
   /* Notify the new entry */
 
 #ifdef CONFIG_NETLINK_ROUTE
@@ -474,9 +531,9 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
       netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
 #endif
 
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* Yes.. Remove it from the table */
 
-      tabptr->at_ipaddr = 0;
+      arp_release(tabptr);
       return OK;
     }
 
@@ -499,13 +556,17 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 
 void arp_cleanup(FAR struct net_driver_s *dev)
 {
-  int i;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (entry = dq_peek(&g_arplru); entry != NULL; entry = next)
     {
-      if (dev == g_arptable[i].at_dev)
+      FAR struct arp_entry_s *tabptr = ARP_ENTRY(entry, at_lru);
+
+      next = dq_next(entry);
+      if (dev == tabptr->at_dev)
         {
-          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          arp_release(tabptr);
         }
     }
 }
@@ -535,19 +596,18 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
                           unsigned int nentries)
 {
   FAR struct arp_entry_s *tabptr;
+  FAR dq_entry_t *entry;
   clock_t now;
   unsigned int ncopied;
-  int i;
 
-  /* Copy all non-empty, non-expired entries in the ARP table. */
+  /* Copy all non-expired entries in the ARP table. */
 
-  for (i = 0, now = clock_systime_ticks(), ncopied = 0;
-       nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE;
-       i++)
+  for (entry = dq_peek(&g_arplru), now = clock_systime_ticks(), ncopied = 0;
+       nentries > ncopied && entry != NULL;
+       entry = dq_next(entry))
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_ipaddr != 0 &&
-          now - tabptr->at_time <= ARP_MAXAGE_TICK)
+      tabptr = ARP_ENTRY(entry, at_lru);
+      if (now - tabptr->at_time <= ARP_MAXAGE_TICK)
         {
           arp_get_arpreq(&snapshot[ncopied], tabptr);
           ncopied++;
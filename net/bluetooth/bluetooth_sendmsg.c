@@ -178,7 +178,7 @@ static uint16_t bluetooth_sendto_eventhandler(FAR struct net_driver_s *dev,
 
       /* Don't allow any further call backs. */
 
-      pstate->is_cb->flags = 0;
+      devif_callback_setflags(pstate->is_cb, 0);
       pstate->is_cb->priv  = NULL;
       pstate->is_cb->event = NULL;
 
@@ -193,7 +193,7 @@ errout:
 
   /* Don't allow any further call backs. */
 
-  pstate->is_cb->flags = 0;
+  devif_callback_setflags(pstate->is_cb, 0);
   pstate->is_cb->priv  = NULL;
   pstate->is_cb->event = NULL;
   pstate->is_sent      = ret;
@@ -338,7 +338,7 @@ static ssize_t bluetooth_sendto(FAR struct socket *psock,
         {
           /* Set up the callback in the connection */
 
-          state.is_cb->flags = PKT_POLL;
+          devif_callback_setflags(state.is_cb, PKT_POLL);
           state.is_cb->priv  = (FAR void *)&state;
           state.is_cb->event = bluetooth_sendto_eventhandler;
 
@@ -111,6 +111,8 @@ struct can_conn_s
 #  endif
   struct can_filter filters[CONFIG_NET_CAN_RAW_FILTER_MAX];
   int32_t filter_count;
+  canid_t filter_code;               /* Bits shared by all of the filters */
+  canid_t filter_mask;               /* Mask of the shared bits */
 #  ifdef CONFIG_NET_CAN_ERRORS
   can_err_mask_t err_mask;
 #  endif
@@ -397,6 +399,65 @@ int can_setsockopt(FAR struct socket *psock, int level, int option,
                    FAR const void *value, socklen_t value_len);
 #endif
 
+/****************************************************************************
+ * Name: can_filter_update
+ *
+ * Description:
+ *   Recompute the combined filter of a connection after its CAN_RAW
+ *   filters changed.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection whose filters changed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+void can_filter_update(FAR struct can_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: can_recv_filter
+ *
+ * Description:
+ *   Check a received CAN ID against the filters of a connection.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection.
+ *   id   - The CAN ID of the frame, including the CAN_*_FLAG bits.
+ *
+ * Returned Value:
+ *   1 if the connection accepts the frame, 0 if it does not.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+int can_recv_filter(FAR struct can_conn_s *conn, canid_t id);
+#endif
+
+/****************************************************************************
+ * Name: can_hwfilter_update
+ *
+ * Description:
+ *   Pass the union of the filters of all of the sockets listening on a
+ *   device to its driver through SIOCSCANHWFILTER.
+ *
+ * Input Parameters:
+ *   dev - The CAN device; NULL updates every CAN device.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+void can_hwfilter_update(FAR struct net_driver_s *dev);
+#else
+#  define can_hwfilter_update(dev)
+#endif
+
 /****************************************************************************
  * Name: can_getsockopt
  *
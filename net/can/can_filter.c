@@ -0,0 +1,274 @@
+/****************************************************************************
+ * net/can/can_filter.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET_CAN) && defined(CONFIG_NET_CANPROTO_OPTIONS)
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <net/if.h>
+
+#include <nuttx/can.h>
+#include <nuttx/net/ioctl.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "can/can.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_filter_combine
+ *
+ * Description:
+ *   Fold a list of CAN_RAW filters into a single code/mask pair that every
+ *   frame accepted by any of the filters satisfies.  An inverted filter
+ *   can match almost any ID, so it clears the mask.
+ *
+ * Input Parameters:
+ *   filters - The filters to fold in.
+ *   count   - The number of filters.
+ *   code    - The combined code, updated in place.
+ *   mask    - The combined mask, updated in place.
+ *   empty   - True while nothing has been folded in yet.
+ *
+ ****************************************************************************/
+
+static void can_filter_combine(FAR const struct can_filter *filters,
+                               int count, FAR canid_t *code,
+                               FAR canid_t *mask, FAR bool *empty)
+{
+  canid_t fid;
+  int i;
+
+  for (i = 0; i < count; i++)
+    {
+      if ((filters[i].can_id & CAN_INV_FILTER) != 0)
+        {
+          *code  = 0;
+          *mask  = 0;
+          *empty = false;
+          return;
+        }
+
+      fid = filters[i].can_id & filters[i].can_mask;
+      if (*empty)
+        {
+          *code  = fid;
+          *mask  = filters[i].can_mask;
+          *empty = false;
+        }
+      else
+        {
+          *mask &= filters[i].can_mask & ~(*code ^ fid);
+          *code &= *mask;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: can_hwfilter_callback
+ *
+ * Description:
+ *   netdev_foreach() callback that updates the filter of each CAN device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+static int can_hwfilter_callback(FAR struct net_driver_s *dev,
+                                 FAR void *arg)
+{
+  if (dev->d_lltype == NET_LL_CAN)
+    {
+      can_hwfilter_update(dev);
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_filter_update
+ *
+ * Description:
+ *   Recompute the combined filter of a connection after its CAN_RAW
+ *   filters changed.  The combination lets can_recv_filter() reject most
+ *   frames with a single compare.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection whose filters changed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void can_filter_update(FAR struct can_conn_s *conn)
+{
+  bool empty = true;
+
+  conn->filter_code = 0;
+  conn->filter_mask = 0;
+  can_filter_combine(conn->filters, conn->filter_count,
+                     &conn->filter_code, &conn->filter_mask, &empty);
+}
+
+/****************************************************************************
+ * Name: can_recv_filter
+ *
+ * Description:
+ *   Check a received CAN ID against the filters of a connection.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection.
+ *   id   - The CAN ID of the frame, including the CAN_*_FLAG bits.
+ *
+ * Returned Value:
+ *   1 if the connection accepts the frame, 0 if it does not.
+ *
+ ****************************************************************************/
+
+int can_recv_filter(FAR struct can_conn_s *conn, canid_t id)
+{
+  uint32_t i;
+
+#ifdef CONFIG_NET_CAN_ERRORS
+  /* error message frame */
+
+  if ((id & CAN_ERR_FLAG) != 0)
+    {
+      return id & conn->err_mask ? 1 : 0;
+    }
+#endif
+
+  /* A frame outside of the combined filter matches none of the filters */
+
+  if ((id & conn->filter_mask) != conn->filter_code)
+    {
+      return 0;
+    }
+
+  for (i = 0; i < conn->filter_count; i++)
+    {
+      if (conn->filters[i].can_id & CAN_INV_FILTER)
+        {
+          if ((id & conn->filters[i].can_mask) !=
+                ((conn->filters[i].can_id & ~CAN_INV_FILTER) &
+                 conn->filters[i].can_mask))
+            {
+              return 1;
+            }
+        }
+      else
+        {
+          if ((id & conn->filters[i].can_mask) ==
+                (conn->filters[i].can_id & conn->filters[i].can_mask))
+            {
+              return 1;
+            }
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: can_hwfilter_update
+ *
+ * Description:
+ *   Combine the filters of all of the sockets that listen on a device and
+ *   pass the result to the driver with SIOCSCANHWFILTER, so that the
+ *   controller acceptance filter drops frames no socket wants before they
+ *   cost an interrupt.  Drivers without the ioctl simply keep receiving
+ *   everything.
+ *
+ * Input Parameters:
+ *   dev - The CAN device; NULL updates every CAN device.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+void can_hwfilter_update(FAR struct net_driver_s *dev)
+{
+  struct can_ioctl_filter_s filter;
+  FAR struct can_conn_s *conn = NULL;
+  canid_t code = 0;
+  canid_t mask = 0;
+  bool empty = true;
+  int ret;
+
+  if (dev == NULL)
+    {
+      netdev_foreach(can_hwfilter_callback, NULL);
+      return;
+    }
+
+  if (dev->d_ioctl == NULL)
+    {
+      return;
+    }
+
+  while ((conn = can_active(dev, conn)) != NULL)
+    {
+      can_filter_combine(conn->filters, conn->filter_count,
+                         &code, &mask, &empty);
+    }
+
+  /* Keep accepting everything while nobody listens */
+
+  if (empty)
+    {
+      mask = 0;
+      code = 0;
+    }
+
+  filter.fid1  = code;
+  filter.fid2  = mask;
+  filter.ftype = CAN_FILTER_MASK;
+  filter.fprio = CAN_MSGPRIO_HIGH;
+
+  ret = dev->d_ioctl(dev, SIOCSCANHWFILTER,
+                     (unsigned long)(uintptr_t)&filter);
+  if (ret < 0 && ret != -ENOTTY && ret != -ENOSYS && ret != -ENOTSUP)
+    {
+      nwarn("WARNING: Failed to set the hardware filter: %d\n", ret);
+    }
+}
+#endif
+
+#endif /* CONFIG_NET_CAN && CONFIG_NET_CANPROTO_OPTIONS */
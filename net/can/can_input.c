@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_CAN)
 
+#include <string.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -189,6 +190,41 @@ static int can_input_conn(FAR struct net_driver_s *dev,
   return ret;
 }
 
+/****************************************************************************
+ * Name: can_listener
+ *
+ * Description:
+ *   Find the next connection on dev whose filters accept the frame, so
+ *   that the frame is neither cloned nor queued for sockets that would
+ *   drop it later anyway.
+ *
+ * Input Parameters:
+ *   dev    - The device that received the frame
+ *   conn   - The current connection; may be NULL to start the search at
+ *            the beginning
+ *   can_id - The CAN ID of the frame
+ *
+ ****************************************************************************/
+
+static FAR struct can_conn_s *can_listener(FAR struct net_driver_s *dev,
+                                           FAR struct can_conn_s *conn,
+                                           canid_t can_id)
+{
+  while ((conn = can_active(dev, conn)) != NULL)
+    {
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+      if (can_recv_filter(conn, can_id) == 0)
+        {
+          continue;
+        }
+#endif
+
+      break;
+    }
+
+  return conn;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -215,12 +251,25 @@ static int can_input_conn(FAR struct net_driver_s *dev,
 
 static int can_in(FAR struct net_driver_s *dev)
 {
-  FAR struct can_conn_s *conn = can_active(dev, NULL);
+  FAR struct can_conn_s *conn;
   FAR struct can_conn_s *nextconn;
+  canid_t can_id;
+
+  memcpy(&can_id, dev->d_buf, sizeof(canid_t));
+
+  conn = can_listener(dev, NULL, can_id);
+  if (conn == NULL && can_active(dev, NULL) != NULL)
+    {
+      /* There are listeners, but all of them filter the frame out */
+
+      dev->d_len = 0;
+      netdev_iob_release(dev);
+      return OK;
+    }
 
   /* Do we have second connection that can hold this packet? */
 
-  while ((nextconn = can_active(dev, conn)) != NULL)
+  while ((nextconn = can_listener(dev, conn, can_id)) != NULL)
     {
       /* Yes... There are multiple listeners on the same dev.
        * We need to clone the packet and deliver it to each listener.
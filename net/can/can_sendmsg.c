@@ -130,7 +130,7 @@ end_wait:
 
       /* Don't allow any further call backs. */
 
-      pstate->snd_cb->flags = 0;
+      devif_callback_setflags(pstate->snd_cb, 0);
       pstate->snd_cb->priv  = NULL;
       pstate->snd_cb->event = NULL;
 
@@ -254,7 +254,7 @@ ssize_t can_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
     {
       /* Set up the callback in the connection */
 
-      state.snd_cb->flags = CAN_POLL;
+      devif_callback_setflags(state.snd_cb, CAN_POLL);
       state.snd_cb->priv  = (FAR void *)&state;
       state.snd_cb->event = psock_send_eventhandler;
 
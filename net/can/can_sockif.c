@@ -340,6 +340,14 @@ static int can_bind(FAR struct socket *psock,
   conn->dev = netdev_findbyname((const char *)&netdev_name);
 #endif
 
+#ifdef CONFIG_NET_CAN_HWFILTER
+  /* The socket may have moved between devices */
+
+  net_lock();
+  can_hwfilter_update(NULL);
+  net_unlock();
+#endif
+
   return OK;
 }
 
@@ -406,18 +414,18 @@ static int can_poll_local(FAR struct socket *psock, FAR struct pollfd *fds,
        * during callback processing.
        */
 
-      cb->flags = NETDEV_DOWN;
+      devif_callback_setflags(cb, NETDEV_DOWN);
       cb->priv  = info;
       cb->event = can_poll_eventhandler;
 
       if ((fds->events & POLLOUT) != 0)
         {
-          cb->flags |= CAN_POLL;
+          devif_callback_setflags(cb, cb->flags | CAN_POLL);
         }
 
       if ((fds->events & POLLIN) != 0)
         {
-          cb->flags |= CAN_NEWDATA;
+          devif_callback_setflags(cb, cb->flags | CAN_NEWDATA);
         }
 
       /* Save the reference in the poll info structure as fds private as well
@@ -510,6 +518,14 @@ static int can_close(FAR struct socket *psock)
       conn->crefs = 0;
       can_free(psock->s_conn);
 
+#ifdef CONFIG_NET_CAN_HWFILTER
+      /* Its filters no longer widen the hardware filter */
+
+      net_lock();
+      can_hwfilter_update(NULL);
+      net_unlock();
+#endif
+
       if (ret < 0)
         {
           /* Return with error code, but free resources. */
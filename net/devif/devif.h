@@ -257,7 +257,11 @@
  *   priv    - Holds a reference to socket layer specific data that will
  *             provided
  *   flags   - Set by the socket layer to inform the lower layer which flags
- *             are and are not handled by the callback.
+ *             are and are not handled by the callback.  It must be changed
+ *             with devif_callback_setflags().
+ *   mask    - The flags of this callback ORed with the mask of the next
+ *             callback in the connection list, so that devif_conn_event()
+ *             can stop as soon as no remaining callback is interested.
  */
 
 struct net_driver_s;       /* Forward reference */
@@ -274,6 +278,7 @@ struct devif_callback_s
   FAR devif_callback_event_t event;
   FAR void *priv;
   uint16_t flags;
+  uint16_t mask;
 };
 
 /****************************************************************************
@@ -343,6 +348,20 @@ FAR struct devif_callback_s *
                        FAR struct devif_callback_s **list_head,
                        FAR struct devif_callback_s **list_tail);
 
+/****************************************************************************
+ * Name: devif_callback_setflags
+ *
+ * Description:
+ *   Set the events that trigger a callback.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void devif_callback_setflags(FAR struct devif_callback_s *cb,
+                             uint16_t flags);
+
 /****************************************************************************
  * Name: devif_conn_callback_free
  *
@@ -512,6 +531,32 @@ int devif_file_send(FAR struct net_driver_s *dev, FAR struct file *file,
                     unsigned int target_offset);
 #endif
 
+/****************************************************************************
+ * Name: devif_ref_send
+ *
+ * Description:
+ *   Called from socket logic in response to a xmit or poll request from the
+ *   the network interface driver.
+ *
+ *   This is identical to calling devif_send() except that the data is
+ *   referred to by an I/O buffer instead of being copied.  'free_cb' is
+ *   called when that I/O buffer is released.
+ *
+ * Returned Value:
+ *   The number of bytes referred to, zero if all of the data was copied,
+ *   or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_ALLOC
+int devif_ref_send(FAR struct net_driver_s *dev, FAR const void *buf,
+                   unsigned int len, unsigned int target_offset,
+                   iob_free_cb_t free_cb);
+#endif
+
 /****************************************************************************
  * Name: devif_out
  *
@@ -55,6 +55,41 @@ static FAR struct devif_callback_s *g_cbfreelist = NULL;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: devif_callback_update
+ *
+ * Description:
+ *   Recompute the mask of a callback and of the callbacks before it in the
+ *   connection list, after its flags or its successor changed.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void devif_callback_update(FAR struct devif_callback_s *cb)
+{
+  uint16_t mask;
+
+  for (; cb != NULL; cb = cb->prevconn)
+    {
+      mask = cb->flags;
+      if (cb->nxtconn != NULL)
+        {
+          mask |= cb->nxtconn->mask;
+        }
+
+      /* The callbacks before this one are not affected if it is unchanged */
+
+      if (mask == cb->mask)
+        {
+          break;
+        }
+
+      cb->mask = mask;
+    }
+}
+
 /****************************************************************************
  * Name: devif_callback_free
  *
@@ -165,6 +200,10 @@ static void devif_callback_free(FAR struct net_driver_s *dev,
               DEBUGASSERT(list_tail);
               *list_tail = prev;
             }
+
+          /* The events of the callback are no longer waited for */
+
+          devif_callback_update(prev);
         }
 
       /* If this is a preallocated or a batch allocated callback store it in
@@ -228,6 +267,31 @@ static bool devif_event_trigger(uint16_t events, uint16_t triggers)
   return false;
 }
 
+/****************************************************************************
+ * Name: devif_event_wanted
+ *
+ * Description:
+ *   Return true if the current set of events may trigger any callback
+ *   whose flags are included in a mask.
+ *
+ * Input Parameters:
+ *   events - The set of events that has occurred.
+ *   mask   - The flags of a set of callbacks ORed together.
+ *
+ ****************************************************************************/
+
+static bool devif_event_wanted(uint16_t events, uint16_t mask)
+{
+  uint16_t poll = events & DEVPOLL_MASK;
+
+  /* An encoded poll event can only match callbacks that have all of its
+   * bits.
+   */
+
+  return (events & mask & ~DEVPOLL_MASK) != 0 ||
+         (poll != 0 && (poll & ~mask) == 0);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -378,6 +442,24 @@ FAR struct devif_callback_s *
   return ret;
 }
 
+/****************************************************************************
+ * Name: devif_callback_setflags
+ *
+ * Description:
+ *   Set the events that trigger a callback.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+void devif_callback_setflags(FAR struct devif_callback_s *cb,
+                             uint16_t flags)
+{
+  cb->flags = flags;
+  devif_callback_update(cb);
+}
+
 /****************************************************************************
  * Name: devif_conn_callback_free
  *
@@ -504,6 +586,13 @@ uint16_t devif_conn_event(FAR struct net_driver_s *dev, uint16_t flags,
   net_lock();
   while (list && flags)
     {
+      /* Stop if none of the remaining callbacks handles the events */
+
+      if (!devif_event_wanted(flags, list->mask))
+        {
+          break;
+        }
+
       /* Save the pointer to the next callback in the lists.  This is done
        * because the callback action might delete the entry pointed to by
        * list.
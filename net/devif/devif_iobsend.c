@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
@@ -114,4 +115,107 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_IOB_ALLOC
+/****************************************************************************
+ * Name: devif_ref_send
+ *
+ * Description:
+ *   Called from socket logic in response to a xmit or poll request from the
+ *   the network interface driver.
+ *
+ *   This is identical to calling devif_send() except that the data is not
+ *   copied into the device buffer:  The part that does not fit behind the
+ *   headers is appended as an I/O buffer that refers to 'buf'.  'free_cb'
+ *   is called when that I/O buffer is released, the memory must remain
+ *   valid until then and must not be modified.
+ *
+ * Returned Value:
+ *   The number of bytes referred to by the appended I/O buffer, zero if all
+ *   of the data was copied, or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+int devif_ref_send(FAR struct net_driver_s *dev, FAR const void *buf,
+                   unsigned int len, unsigned int target_offset,
+                   iob_free_cb_t free_cb)
+{
+  FAR const uint8_t *src = buf;
+  FAR struct iob_s *iob;
+  unsigned int copyin;
+  int ret;
+
+  if (dev == NULL)
+    {
+      ret = -ENODEV;
+      goto errout;
+    }
+
+  if (len == 0 || len > UINT16_MAX)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+#ifndef CONFIG_NET_IPFRAG
+  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+    {
+      ret = -EMSGSIZE;
+      goto errout;
+    }
+#endif
+
+  if (netdev_iob_prepare(dev, false, 0) != OK)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  /* Trim the device buffer to the headers and find its last entry */
+
+  iob_update_pktlen(dev->d_iob, target_offset, false);
+
+  for (iob = dev->d_iob; iob->io_flink != NULL; iob = iob->io_flink)
+    {
+    }
+
+  /* Fill the free space behind the headers first:  Every entry of a chain
+   * but the last one has to be full.
+   */
+
+  copyin = IOB_BUFSIZE(iob) - (iob->io_len + iob->io_offset);
+  if (copyin > len)
+    {
+      copyin = len;
+    }
+
+  memcpy(iob->io_data + iob->io_len + iob->io_offset, src, copyin);
+  iob->io_len += copyin;
+
+  if (copyin < len)
+    {
+      iob->io_flink = iob_alloc_with_data((FAR void *)(src + copyin),
+                                          len - copyin, free_cb);
+      if (iob->io_flink == NULL)
+        {
+          netdev_iob_release(dev);
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      iob->io_flink->io_len = len - copyin;
+    }
+
+  dev->d_iob->io_pktlen = target_offset + len;
+  dev->d_sndlen = len;
+  return len - copyin;
+
+errout:
+  nerr("ERROR: devif_ref_send error: %d\n", ret);
+  return ret;
+}
+#endif
+
 #endif /* CONFIG_MM_IOB */
@@ -105,6 +105,18 @@ int devif_loopback(FAR struct net_driver_s *dev)
        NETDEV_TXPACKETS(dev);
        NETDEV_RXPACKETS(dev);
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+      /* A checksum left to the device is never completed, but the packet
+       * does not leave the host either.
+       */
+
+      if ((dev->d_offload & NETDEV_OFFLOAD_TXCSUM) != 0)
+        {
+          dev->d_offload |= NETDEV_OFFLOAD_RXCSUM;
+          netdev_offload_reset(dev);
+        }
+#endif
+
 #ifdef CONFIG_NET_PKT
       /* When packet sockets are enabled, feed the frame into the tap */
 
@@ -140,6 +152,10 @@ int devif_loopback(FAR struct net_driver_s *dev)
         }
 
       NETDEV_TXDONE(dev);
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+      dev->d_offload &= ~NETDEV_OFFLOAD_RXCSUM;
+#endif
     }
   while (dev->d_len > 0);
 
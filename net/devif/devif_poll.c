@@ -587,6 +587,9 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
 {
   FAR struct udp_conn_s *conn = NULL;
   int bstop = 0;
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+  bool sent;
+#endif
 
   /* Traverse all of the allocated UDP connections and perform the poll
    * action.
@@ -600,17 +603,37 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
       if (dev == conn->dev)
 #endif
         {
-          /* Perform the UDP TX poll */
+          for (; ; )
+            {
+              /* Perform the UDP TX poll */
 
-          udp_poll(dev, conn);
+              udp_poll(dev, conn);
 
-          /* Perform any necessary conversions on outgoing packets */
+              /* Perform any necessary conversions on outgoing packets */
 
-          devif_packet_conversion(dev, DEVIF_UDP);
+              devif_packet_conversion(dev, DEVIF_UDP);
 
-          /* Call back into the driver */
+              /* Call back into the driver */
 
-          bstop = devif_poll_local_out(dev, callback);
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+              sent  = dev->d_len > 0;
+#endif
+              bstop = devif_poll_local_out(dev, callback);
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+              /* Keep draining the write buffers while the driver takes
+               * packets, so a burst such as one from sendmmsg() leaves in
+               * a single poll.
+               */
+
+              if (!bstop && sent && !sq_empty(&conn->write_q))
+                {
+                  continue;
+                }
+#endif
+
+              break;
+            }
         }
     }
 
@@ -1144,6 +1167,74 @@ void devif_out(FAR struct net_driver_s *dev)
     }
 }
 
+/****************************************************************************
+ * Name: devif_is_udp_gso
+ *
+ * Description:
+ *   Check if d_iob holds a UDP super-datagram.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GSO
+static bool devif_is_udp_gso(FAR struct net_driver_s *dev)
+{
+  if (dev->d_gso_size == 0)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv6
+  if (IFF_IS_IPv6(dev->d_flags))
+    {
+      return IPv6BUF->proto == IP_PROTO_UDP;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  return IPv4BUF->proto == IP_PROTO_UDP;
+#else
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: devif_poll_udp_gso
+ *
+ * Description:
+ *   Cut the UDP super-datagram in d_iob and send the datagrams, or loop
+ *   them back one by one if they are sent to ourself.
+ *
+ * Returned Value:
+ *   Zero indicated the polling will continue, else stop the polling.
+ *
+ ****************************************************************************/
+
+static int devif_poll_udp_gso(FAR struct net_driver_s *dev,
+                              devif_poll_callback_t callback)
+{
+  FAR struct iob_s *seg;
+  bool loopback = devif_is_loopback(dev);
+
+  if (udp_gso_segment(dev) != OK)
+    {
+      return 1;
+    }
+
+  if (!loopback)
+    {
+      return devif_poll_ipfrag(dev, callback);
+    }
+
+  while ((seg = iob_remove_queue(&dev->d_fragout)) != NULL)
+    {
+      netdev_iob_replace(dev, seg);
+      devif_loopback(dev);
+    }
+
+  return 1;
+}
+#endif
+
 /****************************************************************************
  * Name: devif_poll_out
  *
@@ -1166,6 +1257,34 @@ int devif_poll_out(FAR struct net_driver_s *dev,
       return 0;
     }
 
+#ifdef CONFIG_NET_UDP_GSO
+  /* UDP super-datagrams are always cut in software, none of the devices
+   * segments them.
+   */
+
+  if (devif_is_udp_gso(dev) && (callback || devif_is_loopback(dev)))
+    {
+      return devif_poll_udp_gso(dev, callback);
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_GSO
+  /* Cut a TCP super-segment here if the device cannot, the segments are
+   * then sent like IP fragments.
+   */
+
+  if (callback && dev->d_gso_size > 0 && !NETDEV_TSO(dev) &&
+      !devif_is_loopback(dev))
+    {
+      if (tcp_gso_segment(dev) != OK)
+        {
+          return 1;
+        }
+
+      return devif_poll_ipfrag(dev, callback);
+    }
+#endif
+
   devif_out(dev);
 
   bstop = devif_loopback(dev);
@@ -1177,6 +1296,15 @@ int devif_poll_out(FAR struct net_driver_s *dev,
   if (callback)
     {
 #ifdef CONFIG_NET_IPFRAG
+#  ifdef CONFIG_NETDEV_OFFLOAD
+      /* The device segments a super-segment, it is not fragmented */
+
+      if (dev->d_gso_size > 0)
+        {
+          return callback(dev);
+        }
+#  endif
+
       if (ip_fragout(dev) != OK)
         {
           netdev_iob_release(dev);
@@ -90,6 +90,7 @@
 #include <netinet/in.h>
 #include <net/if.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
@@ -509,6 +510,15 @@ int ipv4_input(FAR struct net_driver_s *dev)
   clock_gettime(CLOCK_REALTIME, &dev->d_rxtime);
 #endif
 
+#ifdef CONFIG_NET_LATENCY
+  /* Start the reception latency unless the driver already did */
+
+  if (dev->d_rxstamp == 0)
+    {
+      dev->d_rxstamp = perf_gettime();
+    }
+#endif
+
   if (dev->d_iob != NULL)
     {
       buf = dev->d_buf;
@@ -519,11 +529,17 @@ int ipv4_input(FAR struct net_driver_s *dev)
       ret = ipv4_in(dev);
 
       dev->d_buf = buf;
-
-      return ret;
+    }
+  else
+    {
+      ret = netdev_input(dev, ipv4_in, true);
     }
 
-  return netdev_input(dev, ipv4_in, true);
+#ifdef CONFIG_NET_LATENCY
+  dev->d_rxstamp = 0;
+#endif
+
+  return ret;
 }
 
 #endif /* CONFIG_NET_IPv4 */
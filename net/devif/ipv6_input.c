@@ -35,6 +35,7 @@
 
 #include <net/if.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
@@ -636,6 +637,15 @@ int ipv6_input(FAR struct net_driver_s *dev)
   clock_gettime(CLOCK_REALTIME, &dev->d_rxtime);
 #endif
 
+#ifdef CONFIG_NET_LATENCY
+  /* Start the reception latency unless the driver already did */
+
+  if (dev->d_rxstamp == 0)
+    {
+      dev->d_rxstamp = perf_gettime();
+    }
+#endif
+
   if (dev->d_iob != NULL)
     {
       buf = dev->d_buf;
@@ -646,10 +656,16 @@ int ipv6_input(FAR struct net_driver_s *dev)
       ret = ipv6_in(dev);
 
       dev->d_buf = buf;
-
-      return ret;
     }
+  else
+    {
+      ret = netdev_input(dev, ipv6_in, true);
+    }
+
+#ifdef CONFIG_NET_LATENCY
+  dev->d_rxstamp = 0;
+#endif
 
-  return netdev_input(dev, ipv6_in, true);
+  return ret;
 }
 #endif /* CONFIG_NET_IPv6 */
@@ -191,13 +191,13 @@ int icmp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
    * callback processing.
    */
 
-  cb->flags = NETDEV_DOWN;
+  devif_callback_setflags(cb, NETDEV_DOWN);
   cb->priv  = info;
   cb->event = icmp_poll_eventhandler;
 
   if ((fds->events & POLLIN) != 0)
     {
-      cb->flags |= ICMP_NEWDATA;
+      devif_callback_setflags(cb, cb->flags | ICMP_NEWDATA);
     }
 
   /* Save the reference in the poll info structure as fds private as well
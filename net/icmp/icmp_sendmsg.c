@@ -229,7 +229,7 @@ end_wait:
 
   /* Do not allow any further callbacks */
 
-  pstate->snd_cb->flags   = 0;
+  devif_callback_setflags(pstate->snd_cb, 0);
   pstate->snd_cb->priv    = NULL;
   pstate->snd_cb->event   = NULL;
 
@@ -386,7 +386,7 @@ ssize_t icmp_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   state.snd_cb = icmp_callback_alloc(dev, conn);
   if (state.snd_cb != NULL)
     {
-      state.snd_cb->flags = (ICMP_POLL | NETDEV_DOWN);
+      devif_callback_setflags(state.snd_cb, ICMP_POLL | NETDEV_DOWN);
       state.snd_cb->priv  = (FAR void *)&state;
       state.snd_cb->event = sendto_eventhandler;
 
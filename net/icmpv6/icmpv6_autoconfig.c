@@ -79,7 +79,7 @@ static void icmpv6_router_terminate(FAR struct icmpv6_router_s *state,
 
   state->snd_sent         = true;
   state->snd_result       = (int16_t)result;
-  state->snd_cb->flags    = 0;
+  devif_callback_setflags(state->snd_cb, 0);
   state->snd_cb->priv     = NULL;
   state->snd_cb->event    = NULL;
 
@@ -218,7 +218,7 @@ static int icmpv6_send_message(FAR struct net_driver_s *dev, bool advertise)
   state.snd_sent      = false;
   state.snd_result    = -EBUSY;
   state.snd_advertise = advertise;
-  state.snd_cb->flags = (ICMPv6_POLL | NETDEV_DOWN);
+  devif_callback_setflags(state.snd_cb, ICMPv6_POLL | NETDEV_DOWN);
   state.snd_cb->priv  = (FAR void *)&state;
   state.snd_cb->event = icmpv6_router_eventhandler;
 
@@ -130,7 +130,7 @@ static uint16_t icmpv6_neighbor_eventhandler(FAR struct net_driver_s *dev,
       /* Don't allow any further call backs. */
 
       state->snd_sent         = true;
-      state->snd_cb->flags    = 0;
+      devif_callback_setflags(state->snd_cb, 0);
       state->snd_cb->priv     = NULL;
       state->snd_cb->event    = NULL;
 
@@ -317,7 +317,7 @@ int icmpv6_neighbor(FAR struct net_driver_s *dev,
       /* Arm/re-arm the callback */
 
       state.snd_sent      = false;
-      state.snd_cb->flags = ICMPv6_POLL;
+      devif_callback_setflags(state.snd_cb, ICMPv6_POLL);
       state.snd_cb->priv  = (FAR void *)&state;
       state.snd_cb->event = icmpv6_neighbor_eventhandler;
 
@@ -190,13 +190,13 @@ int icmpv6_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
    * callback processing.
    */
 
-  cb->flags = NETDEV_DOWN;
+  devif_callback_setflags(cb, NETDEV_DOWN);
   cb->priv  = info;
   cb->event = icmpv6_poll_eventhandler;
 
   if ((fds->events & POLLIN) != 0)
     {
-      cb->flags |= ICMPv6_NEWDATA;
+      devif_callback_setflags(cb, cb->flags | ICMPv6_NEWDATA);
     }
 
   /* Save the reference in the poll info structure as fds private as well
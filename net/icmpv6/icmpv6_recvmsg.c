@@ -178,7 +178,7 @@ end_wait:
 
   /* Do not allow any further callbacks */
 
-  pstate->recv_cb->flags   = 0;
+  devif_callback_setflags(pstate->recv_cb, 0);
   pstate->recv_cb->priv    = NULL;
   pstate->recv_cb->event   = NULL;
 
@@ -375,7 +375,8 @@ ssize_t icmpv6_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
       state.recv_cb = icmpv6_callback_alloc(dev, conn);
       if (state.recv_cb)
         {
-          state.recv_cb->flags = (ICMPv6_NEWDATA | NETDEV_DOWN);
+          devif_callback_setflags(state.recv_cb, ICMPv6_NEWDATA |
+                                                 NETDEV_DOWN);
           state.recv_cb->priv  = (FAR void *)&state;
           state.recv_cb->event = recvfrom_eventhandler;
 
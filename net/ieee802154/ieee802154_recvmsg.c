@@ -247,7 +247,7 @@ static uint16_t
             {
               /* Don't allow any further call backs. */
 
-              pstate->ir_cb->flags   = 0;
+              devif_callback_setflags(pstate->ir_cb, 0);
               pstate->ir_cb->priv    = NULL;
               pstate->ir_cb->event   = NULL;
               pstate->ir_result      = ret;
@@ -373,7 +373,8 @@ ssize_t ieee802154_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   state.ir_cb = ieee802154_callback_alloc(&radio->r_dev, conn);
   if (state.ir_cb)
     {
-      state.ir_cb->flags  = (IEEE802154_NEWDATA | IEEE802154_POLL);
+      devif_callback_setflags(state.ir_cb, IEEE802154_NEWDATA |
+                                           IEEE802154_POLL);
       state.ir_cb->priv   = (FAR void *)&state;
       state.ir_cb->event  = ieee802154_recvfrom_eventhandler;
 
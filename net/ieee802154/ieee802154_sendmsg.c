@@ -363,7 +363,7 @@ static uint16_t ieee802154_sendto_eventhandler(FAR struct net_driver_s *dev,
 
       /* Don't allow any further call backs. */
 
-      pstate->is_cb->flags    = 0;
+      devif_callback_setflags(pstate->is_cb, 0);
       pstate->is_cb->priv     = NULL;
       pstate->is_cb->event    = NULL;
 
@@ -378,7 +378,7 @@ errout:
 
   /* Don't allow any further call backs. */
 
-  pstate->is_cb->flags    = 0;
+  devif_callback_setflags(pstate->is_cb, 0);
   pstate->is_cb->priv     = NULL;
   pstate->is_cb->event    = NULL;
   pstate->is_sent         = ret;
@@ -492,7 +492,7 @@ static ssize_t ieee802154_sendto(FAR struct socket *psock,
         {
           /* Set up the callback in the connection */
 
-          state.is_cb->flags = PKT_POLL;
+          devif_callback_setflags(state.is_cb, PKT_POLL);
           state.is_cb->priv  = (FAR void *)&state;
           state.is_cb->event = ieee802154_sendto_eventhandler;
 
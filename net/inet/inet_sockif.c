@@ -974,6 +974,9 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
               /* Save the receive buffer size */
 
               tcp->rcv_bufs = buffersize;
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+              tcp->flags   |= TCP_RCVBUF_LOCK;
+#endif
             }
           else
 #endif
@@ -1035,6 +1038,9 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
               /* Save the send buffer size */
 
               tcp->snd_bufs = buffersize;
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+              tcp->flags   |= TCP_SNDBUF_LOCK;
+#endif
             }
           else
 #endif
@@ -1957,6 +1963,45 @@ static ssize_t inet_sendmsg(FAR struct socket *psock,
     }
 
   end = &msg->msg_iov[msg->msg_iovlen];
+
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCP_WRITE_BUFFERS)
+  if (psock->s_type == SOCK_STREAM && to == NULL)
+    {
+      ssize_t nsent = 0;
+
+      /* A stream has no message boundaries:  Copy the segments straight
+       * into the write buffer chain instead of into a temporary buffer.
+       * With the network locked, each segment is coalesced into the write
+       * buffer of the previous one as long as that was not sent yet.
+       */
+
+      ret = 0;
+      net_lock();
+      for (iov = msg->msg_iov; iov != end; iov++)
+        {
+          if (iov->iov_len == 0)
+            {
+              continue;
+            }
+
+          ret = inet_send(psock, iov->iov_base, iov->iov_len, flags);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          nsent += ret;
+          if ((size_t)ret < iov->iov_len)
+            {
+              break;
+            }
+        }
+
+      net_unlock();
+      return nsent > 0 ? nsent : ret;
+    }
+#endif
+
   for (len = 0, iov = msg->msg_iov; iov != end; iov++)
     {
       len += iov->iov_len;
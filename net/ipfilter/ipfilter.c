@@ -37,6 +37,7 @@
 #include "icmp/icmp.h"
 #include "icmpv6/icmpv6.h"
 #include "ipfilter/ipfilter.h"
+#include "ipforward/ipforward.h"
 #include "utils/utils.h"
 
 #ifdef CONFIG_NET_IPFILTER
@@ -76,6 +77,17 @@ static sq_queue_t g_ipv4_filters[IPFILTER_CHAIN_MAX];
 static sq_queue_t g_ipv6_filters[IPFILTER_CHAIN_MAX];
 #endif
 
+/* The compiled chains, NULL while a chain is matched entry by entry */
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+#  ifdef CONFIG_NET_IPv4
+static FAR struct ipfilter_index_s *g_ipv4_index[IPFILTER_CHAIN_MAX];
+#  endif
+#  ifdef CONFIG_NET_IPv6
+static FAR struct ipfilter_index_s *g_ipv6_index[IPFILTER_CHAIN_MAX];
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -188,6 +200,201 @@ static bool ipfilter_match_proto(FAR const struct ipfilter_entry_s *entry,
     }
 }
 
+/****************************************************************************
+ * Name: ipfilter_pkt_init
+ *
+ * Description:
+ *   Collect the fields of a packet that the compiled chains are indexed on.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+static void ipfilter_pkt_init(FAR struct ipfilter_pkt_s *pkt,
+                              FAR const struct net_driver_s *indev,
+                              FAR const struct net_driver_s *outdev,
+                              FAR const void *sip, FAR const void *dip,
+                              uint8_t alen, uint8_t proto,
+                              FAR const void *l4hdr)
+{
+  FAR const struct udp_hdr_s *udp = l4hdr;
+
+  pkt->indev  = indev;
+  pkt->outdev = outdev;
+  pkt->sip    = sip;
+  pkt->dip    = dip;
+  pkt->alen   = alen;
+  pkt->proto  = proto;
+  pkt->ports  = proto == IP_PROTO_TCP || proto == IP_PROTO_UDP;
+
+  /* Ports in TCP & UDP headers have same offset. */
+
+  pkt->sport  = pkt->ports ? NTOHS(udp->srcport) : 0;
+  pkt->dport  = pkt->ports ? NTOHS(udp->destport) : 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipv4_filter_entry / ipv6_filter_entry
+ *
+ * Description:
+ *   Match the packet with one filter entry.
+ *
+ * Returned Value:
+ *   true  - The packet is matched
+ *   false - The packet is not matched
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static bool ipv4_filter_entry(FAR const struct ipv4_filter_entry_s *filter,
+                              FAR const struct net_driver_s *indev,
+                              FAR const struct net_driver_s *outdev,
+                              FAR const struct ipv4_hdr_s *ipv4,
+                              FAR const void *l4hdr)
+{
+  in_addr_t ipaddr;
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
+
+  ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
+  matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static bool ipv6_filter_entry(FAR const struct ipv6_filter_entry_s *filter,
+                              FAR const struct net_driver_s *indev,
+                              FAR const struct net_driver_s *outdev,
+                              FAR const struct ipv6_hdr_s *ipv6,
+                              FAR const void *l4hdr, uint8_t proto)
+{
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
+
+  matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
+                                 filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
+                                 filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, l4hdr, proto);
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_index_match
+ *
+ * Description:
+ *   Match the packet with the entries of a compiled chain that it may
+ *   match, in chain order.
+ *
+ * Returned Value:
+ *   The target action of the first matching entry, IPFILTER_TARGET_ACCEPT
+ *   if none matches.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+static int ipfilter_index_match(FAR struct ipfilter_index_s *index,
+                                FAR const struct ipfilter_pkt_s *pkt,
+                                FAR const void *iphdr,
+                                FAR const void *l4hdr)
+{
+  FAR const struct ipfilter_entry_s *entry;
+  struct ipfilter_cursor_s cursor;
+  bool matched = false;
+
+#if CONFIG_NET_IPFILTER_FLOWS > 0
+  if (ipfilter_flow_lookup(index, pkt))
+    {
+      return IPFILTER_TARGET_ACCEPT;
+    }
+#endif
+
+  ipfilter_index_first(index, pkt, &cursor);
+  while (!matched && (entry = ipfilter_index_next(&cursor)) != NULL)
+    {
+#ifdef CONFIG_NET_IPv4
+      if (pkt->alen == sizeof(in_addr_t))
+        {
+          matched = ipv4_filter_entry(
+                      (FAR const struct ipv4_filter_entry_s *)entry,
+                      pkt->indev, pkt->outdev, iphdr, l4hdr);
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+      if (pkt->alen == sizeof(net_ipv6addr_t))
+        {
+          matched = ipv6_filter_entry(
+                      (FAR const struct ipv6_filter_entry_s *)entry,
+                      pkt->indev, pkt->outdev, iphdr, l4hdr, pkt->proto);
+        }
+#endif
+    }
+
+  if (!matched)
+    {
+      ninfo("No filter matched, maybe uninitialized.\n");
+      return IPFILTER_TARGET_ACCEPT;
+    }
+
+#if CONFIG_NET_IPFILTER_FLOWS > 0
+  if (entry->target == IPFILTER_TARGET_ACCEPT)
+    {
+      ipfilter_flow_add(index, pkt);
+    }
+#endif
+
+  return entry->target;
+}
+#endif
+
 /****************************************************************************
  * Name: ipv4_filter_match / ipv6_filter_match
  *
@@ -217,8 +424,6 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
   FAR const sq_queue_t *queue = &g_ipv4_filters[chain];
   FAR const sq_entry_t *entry;
   FAR const void *l4hdr;
-  in_addr_t ipaddr;
-  bool matched;
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -229,45 +434,28 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
 
   l4hdr = IPv4_L4HDR(ipv4);
 
-  sq_for_every(queue, entry)
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  if (g_ipv4_index[chain] != NULL)
     {
-      filter = (FAR struct ipv4_filter_entry_s *)entry;
-
-      /* Match device */
+      struct ipfilter_pkt_s pkt;
 
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
-        {
-          continue;
-        }
-
-      /* Match addresses */
-
-      ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
-      matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
+      ipfilter_pkt_init(&pkt, indev, outdev, ipv4->srcipaddr,
+                        ipv4->destipaddr, sizeof(in_addr_t), ipv4->proto,
+                        l4hdr);
+      return ipfilter_index_match(g_ipv4_index[chain], &pkt, ipv4, l4hdr);
+    }
+#endif
 
-      ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
-      matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
-        {
-          continue;
-        }
+  sq_for_every(queue, entry)
+    {
+      filter = (FAR struct ipv4_filter_entry_s *)entry;
 
-      /* Match protocol */
+      /* Return the target action if matched. */
 
-      if (!ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto))
+      if (ipv4_filter_entry(filter, indev, outdev, ipv4, l4hdr))
         {
-          continue;
+          return filter->common.target;
         }
-
-      /* Return the target action if matched. */
-
-      return filter->common.target;
     }
 
   /* Normally there should be a default rule in chain, won't reach here. */
@@ -288,7 +476,6 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
   FAR const sq_entry_t *entry;
   FAR const void *l4hdr;
   uint8_t proto;
-  bool matched;
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -299,45 +486,28 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
 
   l4hdr = IPv6_L4HDR(ipv6, proto);
 
-  sq_for_every(queue, entry)
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  if (g_ipv6_index[chain] != NULL)
     {
-      filter = (FAR struct ipv6_filter_entry_s *)entry;
-
-      /* Match device */
-
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
-        {
-          continue;
-        }
+      struct ipfilter_pkt_s pkt;
 
-      /* Match addresses */
-
-      matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
-                                     filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
+      ipfilter_pkt_init(&pkt, indev, outdev, ipv6->srcipaddr,
+                        ipv6->destipaddr, sizeof(net_ipv6addr_t), proto,
+                        l4hdr);
+      return ipfilter_index_match(g_ipv6_index[chain], &pkt, ipv6, l4hdr);
+    }
+#endif
 
-      matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
-                                     filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
-        {
-          continue;
-        }
+  sq_for_every(queue, entry)
+    {
+      filter = (FAR struct ipv6_filter_entry_s *)entry;
 
-      /* Match protocol */
+      /* Return the target action if matched. */
 
-      if (!ipfilter_match_proto(&filter->common, l4hdr, proto))
+      if (ipv6_filter_entry(filter, indev, outdev, ipv6, l4hdr, proto))
         {
-          continue;
+          return filter->common.target;
         }
-
-      /* Return the target action if matched. */
-
-      return filter->common.target;
     }
 
   /* Normally there should be a default rule in chain, won't reach here. */
@@ -347,6 +517,38 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
 }
 #endif
 
+/****************************************************************************
+ * Name: ipfilter_index_drop
+ *
+ * Description:
+ *   Free the compiled chain, if any, before its entries change.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+static void ipfilter_index_drop(sa_family_t family,
+                                enum ipfilter_chain_e chain)
+{
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      ipfilter_index_free(g_ipv4_index[chain]);
+      g_ipv4_index[chain] = NULL;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      ipfilter_index_free(g_ipv6_index[chain]);
+      g_ipv6_index[chain] = NULL;
+    }
+#endif
+}
+#else
+#  define ipfilter_index_drop(family, chain)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -407,6 +609,13 @@ FAR struct ipfilter_entry_s *ipfilter_cfg_alloc(sa_family_t family)
 void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
                       sa_family_t family, enum ipfilter_chain_e chain)
 {
+  /* The chain is matched entry by entry until it is compiled again, and
+   * the forwarded flows that it accepted are looked at again.
+   */
+
+  ipfilter_index_drop(family, chain);
+  ipfwd_flowcache_flush();
+
 #ifdef CONFIG_NET_IPv4
   if (family == PF_INET)
     {
@@ -440,6 +649,9 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
 
 void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
 {
+  ipfilter_index_drop(family, chain);
+  ipfwd_flowcache_flush();
+
 #ifdef CONFIG_NET_IPv4
   if (family == PF_INET)
     {
@@ -463,6 +675,46 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
 #endif
 }
 
+/****************************************************************************
+ * Name: ipfilter_cfg_commit
+ *
+ * Description:
+ *   Compile the filter configuration entries of the specified chain, once
+ *   all of them have been added.  A chain that is not compiled is matched
+ *   entry by entry.
+ *
+ * Input Parameters:
+ *   family - The address family of the chain
+ *   chain  - The chain to compile
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+void ipfilter_cfg_commit(sa_family_t family, enum ipfilter_chain_e chain)
+{
+  ipfilter_index_drop(family, chain);
+
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      g_ipv4_index[chain] = ipfilter_index_build(&g_ipv4_filters[chain],
+                                                 PF_INET);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      g_ipv6_index[chain] = ipfilter_index_build(&g_ipv6_filters[chain],
+                                                 PF_INET6);
+    }
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: ipv4_filter_in / ipv6_filter_in
  *
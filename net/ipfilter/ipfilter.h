@@ -29,10 +29,12 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/compiler.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/queue.h>
 
 #ifdef CONFIG_NET_IPFILTER
 
@@ -44,6 +46,15 @@
 #define IPFILTER_TARGET_DROP   (-1)
 #define IPFILTER_TARGET_REJECT (-2)
 
+/* The candidate lists of a compiled chain, see ipfilter_index_s */
+
+#define IPFILTER_RUN_DPORT     0  /* Hashed on protocol and dest port */
+#define IPFILTER_RUN_DADDR     1  /* Hashed on destination address */
+#define IPFILTER_RUN_SADDR     2  /* Hashed on source address */
+#define IPFILTER_RUN_RANGE     3  /* Dest port range segments */
+#define IPFILTER_RUN_OTHER     4  /* All of the other entries */
+#define IPFILTER_NRUNS         5
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -81,6 +92,9 @@ struct ipfilter_entry_s
 
   uint8_t proto;          /* Protocol to match, 0 = ALL (Same as Linux) */
   int8_t  target;
+#ifdef CONFIG_NET_IPFILTER_INDEX
+  uint16_t index;         /* The position of the entry in its chain */
+#endif
 
   /* Match flags, whether we need to match protocol in detail */
 
@@ -123,6 +137,33 @@ struct ipv6_filter_entry_s
   net_ipv6addr_t dmsk;
 };
 
+#ifdef CONFIG_NET_IPFILTER_INDEX
+/* The fields of a packet that the compiled chains are indexed on */
+
+struct ipfilter_pkt_s
+{
+  FAR const struct net_driver_s *indev;
+  FAR const struct net_driver_s *outdev;
+  FAR const uint8_t *sip;  /* Source address, in network byte order */
+  FAR const uint8_t *dip;  /* Destination address */
+  uint16_t sport;          /* Ports in host byte order, if 'ports' */
+  uint16_t dport;
+  uint8_t  proto;
+  uint8_t  alen;           /* The size of the addresses */
+  bool     ports;          /* A TCP or UDP packet */
+};
+
+/* The entries that a packet may match, in one list per run */
+
+struct ipfilter_cursor_s
+{
+  FAR struct ipfilter_entry_s * const *pos[IPFILTER_NRUNS];
+  FAR struct ipfilter_entry_s * const *end[IPFILTER_NRUNS];
+};
+
+struct ipfilter_index_s; /* Opaque, see ipfilter_index.c */
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -182,6 +223,101 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
 
 void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain);
 
+/****************************************************************************
+ * Name: ipfilter_cfg_commit
+ *
+ * Description:
+ *   Compile the filter configuration entries of the specified chain, once
+ *   all of them have been added.  A chain that is not compiled is matched
+ *   entry by entry.
+ *
+ * Input Parameters:
+ *   family - The address family of the chain
+ *   chain  - The chain to compile
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+void ipfilter_cfg_commit(sa_family_t family, enum ipfilter_chain_e chain);
+#else
+#  define ipfilter_cfg_commit(family, chain)
+#endif
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+
+/****************************************************************************
+ * Name: ipfilter_index_build
+ *
+ * Description:
+ *   Compile a chain:  Sort its entries into hash tables on the exact
+ *   destination port, destination address or source address that they
+ *   match, into a segment table on the destination port range that they
+ *   match, or into a list of entries that must always be checked.
+ *
+ * Input Parameters:
+ *   queue  - The entries of the chain, in order
+ *   family - The address family of the entries
+ *
+ * Returned Value:
+ *   The compiled chain; NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct ipfilter_index_s *ipfilter_index_build(FAR sq_queue_t *queue,
+                                                  sa_family_t family);
+
+/****************************************************************************
+ * Name: ipfilter_index_free
+ ****************************************************************************/
+
+void ipfilter_index_free(FAR struct ipfilter_index_s *index);
+
+/****************************************************************************
+ * Name: ipfilter_index_first
+ *
+ * Description:
+ *   Find the lists of the entries that a packet may match.
+ *
+ ****************************************************************************/
+
+void ipfilter_index_first(FAR const struct ipfilter_index_s *index,
+                          FAR const struct ipfilter_pkt_s *pkt,
+                          FAR struct ipfilter_cursor_s *cursor);
+
+/****************************************************************************
+ * Name: ipfilter_index_next
+ *
+ * Description:
+ *   Return the next entry that the packet may match, in chain order, or
+ *   NULL at the end.
+ *
+ ****************************************************************************/
+
+FAR struct ipfilter_entry_s *
+ipfilter_index_next(FAR struct ipfilter_cursor_s *cursor);
+
+/****************************************************************************
+ * Name: ipfilter_flow_lookup and ipfilter_flow_add
+ *
+ * Description:
+ *   Look up or remember a TCP or UDP flow that the chain accepted.  The
+ *   chain is stateless:  Every packet of the flow is accepted until the
+ *   chain is compiled again.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFILTER_FLOWS > 0
+bool ipfilter_flow_lookup(FAR const struct ipfilter_index_s *index,
+                          FAR const struct ipfilter_pkt_s *pkt);
+void ipfilter_flow_add(FAR struct ipfilter_index_s *index,
+                       FAR const struct ipfilter_pkt_s *pkt);
+#endif
+
+#endif /* CONFIG_NET_IPFILTER_INDEX */
+
 /****************************************************************************
  * Name: ipv4_filter_in / ipv6_filter_in
  *
@@ -0,0 +1,822 @@
+/****************************************************************************
+ * net/ipfilter/ipfilter_index.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/queue.h>
+
+#include "ipfilter/ipfilter.h"
+
+#ifdef CONFIG_NET_IPFILTER_INDEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPFILTER_NHASH      3     /* DPORT, DADDR and SADDR runs */
+
+#ifdef CONFIG_NET_IPv6
+#  define IPFILTER_ADDRLEN  16
+#else
+#  define IPFILTER_ADDRLEN  4
+#endif
+
+#if CONFIG_NET_IPFILTER_FLOWS > 0
+#  define IPFILTER_FLOW_MASK (CONFIG_NET_IPFILTER_FLOWS - 1)
+#  if (CONFIG_NET_IPFILTER_FLOWS & IPFILTER_FLOW_MASK) != 0
+#    error CONFIG_NET_IPFILTER_FLOWS must be a power of two
+#  endif
+#endif
+
+/* Overlapping port ranges make the segment table grow as the square of
+ * their number:  Beyond this many references per range entry, the range
+ * entries are checked one by one.
+ */
+
+#define IPFILTER_RANGE_REFS 8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A hash table of entries:  The entries of bucket b are rules[start[b]]
+ * to rules[start[b + 1] - 1], in chain order.
+ */
+
+struct ipfilter_hash_s
+{
+  FAR struct ipfilter_entry_s **rules;
+  FAR uint16_t *start;
+  uint16_t mask;
+};
+
+/* The port range entries:  The destination ports lo[s] to lo[s + 1] - 1
+ * are matched by the entries rules[start[s]] to rules[start[s + 1] - 1],
+ * in chain order.
+ */
+
+struct ipfilter_range_s
+{
+  FAR struct ipfilter_entry_s **rules;
+  FAR uint16_t *start;
+  FAR uint32_t *lo;
+  uint16_t nsegs;
+};
+
+/* A remembered accepted flow */
+
+#if CONFIG_NET_IPFILTER_FLOWS > 0
+struct ipfilter_flow_s
+{
+  FAR const struct net_driver_s *indev;
+  FAR const struct net_driver_s *outdev;
+  uint8_t  addr[2 * IPFILTER_ADDRLEN];
+  uint16_t sport;
+  uint16_t dport;
+  uint8_t  proto;
+  bool     valid;
+};
+#endif
+
+/* A compiled chain.  Every entry is in exactly one run, and it is left out
+ * of the candidates of a packet only if it cannot match that packet.
+ */
+
+struct ipfilter_index_s
+{
+  struct ipfilter_hash_s hash[IPFILTER_NHASH];
+  struct ipfilter_range_s range;
+  FAR struct ipfilter_entry_s **other;
+  uint16_t nother;
+#if CONFIG_NET_IPFILTER_FLOWS > 0
+  struct ipfilter_flow_s flows[CONFIG_NET_IPFILTER_FLOWS];
+#endif
+};
+
+/* The addresses of an entry */
+
+struct ipfilter_addrs_s
+{
+  FAR const uint8_t *sip;
+  FAR const uint8_t *smsk;
+  FAR const uint8_t *dip;
+  FAR const uint8_t *dmsk;
+  uint8_t alen;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_addrs
+ ****************************************************************************/
+
+static void ipfilter_addrs(FAR const struct ipfilter_entry_s *entry,
+                           sa_family_t family,
+                           FAR struct ipfilter_addrs_s *addrs)
+{
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      FAR const struct ipv4_filter_entry_s *filter =
+        (FAR const struct ipv4_filter_entry_s *)entry;
+
+      addrs->sip  = (FAR const uint8_t *)&filter->sip;
+      addrs->smsk = (FAR const uint8_t *)&filter->smsk;
+      addrs->dip  = (FAR const uint8_t *)&filter->dip;
+      addrs->dmsk = (FAR const uint8_t *)&filter->dmsk;
+      addrs->alen = sizeof(in_addr_t);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      FAR const struct ipv6_filter_entry_s *filter =
+        (FAR const struct ipv6_filter_entry_s *)entry;
+
+      addrs->sip  = (FAR const uint8_t *)filter->sip;
+      addrs->smsk = (FAR const uint8_t *)filter->smsk;
+      addrs->dip  = (FAR const uint8_t *)filter->dip;
+      addrs->dmsk = (FAR const uint8_t *)filter->dmsk;
+      addrs->alen = sizeof(net_ipv6addr_t);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: ipfilter_fullmask
+ ****************************************************************************/
+
+static bool ipfilter_fullmask(FAR const uint8_t *mask, unsigned int len)
+{
+  while (len-- > 0)
+    {
+      if (*mask++ != 0xff)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: ipfilter_hash
+ ****************************************************************************/
+
+static uint32_t ipfilter_hash(FAR const uint8_t *key, unsigned int len,
+                              uint32_t hash)
+{
+  while (len-- > 0)
+    {
+      hash = (hash ^ *key++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: ipfilter_port_hash
+ ****************************************************************************/
+
+static uint32_t ipfilter_port_hash(uint8_t proto, uint16_t port)
+{
+  uint8_t key[3];
+
+  key[0] = proto;
+  key[1] = port >> 8;
+  key[2] = port & 0xff;
+
+  return ipfilter_hash(key, sizeof(key), 2166136261u);
+}
+
+/****************************************************************************
+ * Name: ipfilter_portmatch
+ *
+ * Description:
+ *   Check whether an entry only matches the TCP or UDP packets of its
+ *   protocol with a destination port in its range.
+ *
+ ****************************************************************************/
+
+static bool ipfilter_portmatch(FAR const struct ipfilter_entry_s *entry)
+{
+  return (entry->proto == IP_PROTO_TCP || entry->proto == IP_PROTO_UDP) &&
+         !entry->inv_proto && entry->match_tcpudp && !entry->inv_dport;
+}
+
+/****************************************************************************
+ * Name: ipfilter_classify
+ *
+ * Description:
+ *   Choose the run of an entry and compute its hash, if any.
+ *
+ ****************************************************************************/
+
+static int ipfilter_classify(FAR const struct ipfilter_entry_s *entry,
+                             sa_family_t family, FAR uint32_t *hash)
+{
+  struct ipfilter_addrs_s addrs;
+  FAR const uint16_t *dports = entry->match.tcpudp.dports;
+
+  if (ipfilter_portmatch(entry) && dports[0] == dports[1])
+    {
+      *hash = ipfilter_port_hash(entry->proto, dports[0]);
+      return IPFILTER_RUN_DPORT;
+    }
+
+  ipfilter_addrs(entry, family, &addrs);
+
+  if (!entry->inv_dstip && ipfilter_fullmask(addrs.dmsk, addrs.alen))
+    {
+      *hash = ipfilter_hash(addrs.dip, addrs.alen, 2166136261u);
+      return IPFILTER_RUN_DADDR;
+    }
+
+  if (!entry->inv_srcip && ipfilter_fullmask(addrs.smsk, addrs.alen))
+    {
+      *hash = ipfilter_hash(addrs.sip, addrs.alen, 2166136261u);
+      return IPFILTER_RUN_SADDR;
+    }
+
+  if (ipfilter_portmatch(entry) && dports[0] <= dports[1] &&
+      (dports[0] != 0 || dports[1] != UINT16_MAX))
+    {
+      return IPFILTER_RUN_RANGE;
+    }
+
+  return IPFILTER_RUN_OTHER;
+}
+
+/****************************************************************************
+ * Name: ipfilter_nbuckets
+ *
+ * Description:
+ *   Return the size of a hash table for n entries, a power of two.
+ *
+ ****************************************************************************/
+
+static uint16_t ipfilter_nbuckets(unsigned int n)
+{
+  uint16_t nbuckets = 1;
+
+  while (nbuckets < n)
+    {
+      nbuckets <<= 1;
+    }
+
+  return nbuckets;
+}
+
+/****************************************************************************
+ * Name: ipfilter_range_bounds
+ *
+ * Description:
+ *   Collect the sorted, distinct lower bounds of the port segments that no
+ *   range entry tells apart.
+ *
+ * Returned Value:
+ *   The number of segments.
+ *
+ ****************************************************************************/
+
+static uint16_t ipfilter_range_bounds(FAR sq_queue_t *queue,
+                                      FAR const uint8_t *runs,
+                                      FAR uint32_t *lo)
+{
+  FAR struct ipfilter_entry_s *entry;
+  FAR sq_entry_t *node;
+  unsigned int nsegs = 0;
+  unsigned int i;
+  unsigned int j;
+  uint32_t bound[2];
+  uint32_t tmp;
+  int k;
+
+  lo[nsegs++] = 0;
+
+  sq_for_every(queue, node)
+    {
+      entry = (FAR struct ipfilter_entry_s *)node;
+      if (runs[entry->index] != IPFILTER_RUN_RANGE)
+        {
+          continue;
+        }
+
+      bound[0] = entry->match.tcpudp.dports[0];
+      bound[1] = entry->match.tcpudp.dports[1] + 1;
+
+      for (k = 0; k < 2; k++)
+        {
+          if (bound[k] <= UINT16_MAX)
+            {
+              lo[nsegs++] = bound[k];
+            }
+        }
+    }
+
+  /* Insertion sort, then drop the duplicates */
+
+  for (i = 1; i < nsegs; i++)
+    {
+      tmp = lo[i];
+      for (j = i; j > 0 && lo[j - 1] > tmp; j--)
+        {
+          lo[j] = lo[j - 1];
+        }
+
+      lo[j] = tmp;
+    }
+
+  for (i = 1, j = 1; i < nsegs; i++)
+    {
+      if (lo[i] != lo[j - 1])
+        {
+          lo[j++] = lo[i];
+        }
+    }
+
+  return j;
+}
+
+/****************************************************************************
+ * Name: ipfilter_range_covers
+ ****************************************************************************/
+
+static inline bool
+ipfilter_range_covers(FAR const struct ipfilter_entry_s *entry, uint32_t lo)
+{
+  return lo >= entry->match.tcpudp.dports[0] &&
+         lo <= entry->match.tcpudp.dports[1];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_index_build
+ *
+ * Description:
+ *   Compile a chain:  Sort its entries into hash tables on the exact
+ *   destination port, destination address or source address that they
+ *   match, into a segment table on the destination port range that they
+ *   match, or into a list of entries that must always be checked.
+ *
+ * Input Parameters:
+ *   queue  - The entries of the chain, in order
+ *   family - The address family of the entries
+ *
+ * Returned Value:
+ *   The compiled chain; NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct ipfilter_index_s *ipfilter_index_build(FAR sq_queue_t *queue,
+                                                  sa_family_t family)
+{
+  FAR struct ipfilter_index_s *index = NULL;
+  FAR struct ipfilter_entry_s **rules;
+  FAR struct ipfilter_entry_s *entry;
+  FAR struct ipfilter_hash_s *hash;
+  FAR sq_entry_t *node;
+  FAR uint32_t *hashes = NULL;
+  FAR uint32_t *lo = NULL;
+  FAR uint8_t *runs = NULL;
+  FAR uint16_t *start;
+  unsigned int count[IPFILTER_NRUNS];
+  unsigned int nentries = 0;
+  unsigned int nrefs = 0;
+  unsigned int nsegs = 1;
+  unsigned int nslots;
+  unsigned int nbuckets[IPFILTER_NHASH];
+  unsigned int s;
+  size_t size;
+  int run;
+
+  /* Number the entries and choose their runs */
+
+  sq_for_every(queue, node)
+    {
+      nentries++;
+    }
+
+  if (nentries == 0 || nentries > UINT16_MAX)
+    {
+      return NULL;
+    }
+
+  runs   = kmm_malloc(nentries);
+  hashes = kmm_malloc(nentries * sizeof(uint32_t));
+  lo     = kmm_malloc((2 * nentries + 1) * sizeof(uint32_t));
+  if (runs == NULL || hashes == NULL || lo == NULL)
+    {
+      goto out;
+    }
+
+  memset(count, 0, sizeof(count));
+  nentries = 0;
+
+  sq_for_every(queue, node)
+    {
+      entry        = (FAR struct ipfilter_entry_s *)node;
+      entry->index = nentries;
+      run          = ipfilter_classify(entry, family, &hashes[nentries]);
+      runs[nentries++] = run;
+      count[run]++;
+    }
+
+  /* Cut the port space in segments.  Give up on the segment table if the
+   * ranges overlap too much.
+   */
+
+  if (count[IPFILTER_RUN_RANGE] > 0)
+    {
+      nsegs = ipfilter_range_bounds(queue, runs, lo);
+
+      for (s = 0; s < nsegs; s++)
+        {
+          sq_for_every(queue, node)
+            {
+              entry = (FAR struct ipfilter_entry_s *)node;
+              if (runs[entry->index] == IPFILTER_RUN_RANGE &&
+                  ipfilter_range_covers(entry, lo[s]))
+                {
+                  nrefs++;
+                }
+            }
+        }
+
+      if (nrefs > IPFILTER_RANGE_REFS * count[IPFILTER_RUN_RANGE])
+        {
+          nwarn("WARNING: Port ranges overlap, not indexed\n");
+
+          sq_for_every(queue, node)
+            {
+              entry = (FAR struct ipfilter_entry_s *)node;
+              if (runs[entry->index] == IPFILTER_RUN_RANGE)
+                {
+                  runs[entry->index] = IPFILTER_RUN_OTHER;
+                }
+            }
+
+          count[IPFILTER_RUN_OTHER] += count[IPFILTER_RUN_RANGE];
+          count[IPFILTER_RUN_RANGE] = 0;
+          nsegs = 1;
+          nrefs = 0;
+        }
+    }
+
+  /* Allocate the compiled chain in one block:  The structure, then the
+   * entry pointers, then the segment bounds, then the 16-bit offsets.
+   */
+
+  nslots = 0;
+  for (run = 0; run < IPFILTER_NHASH; run++)
+    {
+      nbuckets[run] = ipfilter_nbuckets(count[run]);
+      nslots       += nbuckets[run] + 1;
+    }
+
+  nslots += nsegs + 1;
+
+  size = sizeof(struct ipfilter_index_s) +
+         (nentries - count[IPFILTER_RUN_RANGE] + nrefs) *
+         sizeof(FAR struct ipfilter_entry_s *) +
+         nsegs * sizeof(uint32_t) + nslots * sizeof(uint16_t);
+
+  index = kmm_zalloc(size);
+  if (index == NULL)
+    {
+      goto out;
+    }
+
+  rules = (FAR struct ipfilter_entry_s **)(index + 1);
+  for (run = 0; run < IPFILTER_NHASH; run++)
+    {
+      index->hash[run].rules = rules;
+      rules += count[run];
+    }
+
+  index->range.rules = rules;
+  rules             += nrefs;
+  index->other       = rules;
+  rules             += count[IPFILTER_RUN_OTHER];
+
+  index->range.lo    = (FAR uint32_t *)rules;
+  index->range.nsegs = nsegs;
+  memcpy(index->range.lo, lo, nsegs * sizeof(uint32_t));
+
+  start = (FAR uint16_t *)(index->range.lo + nsegs);
+  for (run = 0; run < IPFILTER_NHASH; run++)
+    {
+      index->hash[run].start = start;
+      index->hash[run].mask  = nbuckets[run] - 1;
+      start += nbuckets[run] + 1;
+    }
+
+  index->range.start = start;
+
+  /* Fill the hash tables:  Count the entries of each bucket, turn the
+   * counts into the start of the buckets, fill the buckets in chain order
+   * while moving their start up, and move the starts back down.
+   */
+
+  sq_for_every(queue, node)
+    {
+      entry = (FAR struct ipfilter_entry_s *)node;
+      run   = runs[entry->index];
+      if (run < IPFILTER_NHASH)
+        {
+          hash = &index->hash[run];
+          hash->start[(hashes[entry->index] & hash->mask) + 1]++;
+        }
+    }
+
+  for (run = 0; run < IPFILTER_NHASH; run++)
+    {
+      hash = &index->hash[run];
+      for (s = 1; s <= hash->mask + 1; s++)
+        {
+          hash->start[s] += hash->start[s - 1];
+        }
+    }
+
+  sq_for_every(queue, node)
+    {
+      entry = (FAR struct ipfilter_entry_s *)node;
+      run   = runs[entry->index];
+      if (run < IPFILTER_NHASH)
+        {
+          hash = &index->hash[run];
+          hash->rules[hash->start[hashes[entry->index] & hash->mask]++] =
+            entry;
+        }
+      else if (run == IPFILTER_RUN_OTHER)
+        {
+          index->other[index->nother++] = entry;
+        }
+    }
+
+  for (run = 0; run < IPFILTER_NHASH; run++)
+    {
+      hash = &index->hash[run];
+      for (s = hash->mask + 1; s > 0; s--)
+        {
+          hash->start[s] = hash->start[s - 1];
+        }
+
+      hash->start[0] = 0;
+    }
+
+  /* Fill the segment table */
+
+  nrefs = 0;
+  for (s = 0; s < nsegs; s++)
+    {
+      index->range.start[s] = nrefs;
+      sq_for_every(queue, node)
+        {
+          entry = (FAR struct ipfilter_entry_s *)node;
+          if (runs[entry->index] == IPFILTER_RUN_RANGE &&
+              ipfilter_range_covers(entry, lo[s]))
+            {
+              index->range.rules[nrefs++] = entry;
+            }
+        }
+    }
+
+  index->range.start[nsegs] = nrefs;
+
+  ninfo("Compiled %u entries: %u %u %u %u %u\n", nentries,
+        count[IPFILTER_RUN_DPORT], count[IPFILTER_RUN_DADDR],
+        count[IPFILTER_RUN_SADDR], count[IPFILTER_RUN_RANGE],
+        count[IPFILTER_RUN_OTHER]);
+
+out:
+  kmm_free(runs);
+  kmm_free(hashes);
+  kmm_free(lo);
+  return index;
+}
+
+/****************************************************************************
+ * Name: ipfilter_index_free
+ ****************************************************************************/
+
+void ipfilter_index_free(FAR struct ipfilter_index_s *index)
+{
+  kmm_free(index);
+}
+
+/****************************************************************************
+ * Name: ipfilter_index_first
+ *
+ * Description:
+ *   Find the lists of the entries that a packet may match.
+ *
+ ****************************************************************************/
+
+void ipfilter_index_first(FAR const struct ipfilter_index_s *index,
+                          FAR const struct ipfilter_pkt_s *pkt,
+                          FAR struct ipfilter_cursor_s *cursor)
+{
+  FAR const struct ipfilter_hash_s *hash;
+  FAR const struct ipfilter_range_s *range = &index->range;
+  uint32_t key[IPFILTER_NHASH];
+  unsigned int first;
+  unsigned int last;
+  unsigned int mid;
+  int run;
+
+  memset(cursor, 0, sizeof(*cursor));
+
+  key[IPFILTER_RUN_DADDR] = ipfilter_hash(pkt->dip, pkt->alen, 2166136261u);
+  key[IPFILTER_RUN_SADDR] = ipfilter_hash(pkt->sip, pkt->alen, 2166136261u);
+
+  for (run = 0; run < IPFILTER_NHASH; run++)
+    {
+      if (run == IPFILTER_RUN_DPORT)
+        {
+          if (!pkt->ports)
+            {
+              continue;
+            }
+
+          key[run] = ipfilter_port_hash(pkt->proto, pkt->dport);
+        }
+
+      hash              = &index->hash[run];
+      cursor->pos[run]  = &hash->rules[hash->start[key[run] & hash->mask]];
+      cursor->end[run]  =
+        &hash->rules[hash->start[(key[run] & hash->mask) + 1]];
+    }
+
+  /* Find the port segment by binary search */
+
+  if (pkt->ports && range->nsegs > 1)
+    {
+      first = 0;
+      last  = range->nsegs - 1;
+
+      while (first < last)
+        {
+          mid = (first + last + 1) / 2;
+          if (range->lo[mid] <= pkt->dport)
+            {
+              first = mid;
+            }
+          else
+            {
+              last = mid - 1;
+            }
+        }
+
+      cursor->pos[IPFILTER_RUN_RANGE] = &range->rules[range->start[first]];
+      cursor->end[IPFILTER_RUN_RANGE] =
+        &range->rules[range->start[first + 1]];
+    }
+
+  cursor->pos[IPFILTER_RUN_OTHER] = index->other;
+  cursor->end[IPFILTER_RUN_OTHER] = index->other + index->nother;
+}
+
+/****************************************************************************
+ * Name: ipfilter_index_next
+ *
+ * Description:
+ *   Return the next entry that the packet may match, in chain order, or
+ *   NULL at the end.
+ *
+ ****************************************************************************/
+
+FAR struct ipfilter_entry_s *
+ipfilter_index_next(FAR struct ipfilter_cursor_s *cursor)
+{
+  FAR struct ipfilter_entry_s *best = NULL;
+  int bestrun = 0;
+  int run;
+
+  for (run = 0; run < IPFILTER_NRUNS; run++)
+    {
+      if (cursor->pos[run] < cursor->end[run] &&
+          (best == NULL || (*cursor->pos[run])->index < best->index))
+        {
+          best    = *cursor->pos[run];
+          bestrun = run;
+        }
+    }
+
+  if (best != NULL)
+    {
+      cursor->pos[bestrun]++;
+    }
+
+  return best;
+}
+
+#if CONFIG_NET_IPFILTER_FLOWS > 0
+
+/****************************************************************************
+ * Name: ipfilter_flow_find
+ ****************************************************************************/
+
+static FAR struct ipfilter_flow_s *
+ipfilter_flow_find(FAR const struct ipfilter_index_s *index,
+                   FAR const struct ipfilter_pkt_s *pkt)
+{
+  uint32_t hash;
+
+  hash = ipfilter_hash(pkt->sip, pkt->alen, 2166136261u);
+  hash = ipfilter_hash(pkt->dip, pkt->alen, hash);
+  hash = ipfilter_hash((FAR const uint8_t *)&pkt->sport,
+                       sizeof(pkt->sport), hash);
+  hash = ipfilter_hash((FAR const uint8_t *)&pkt->dport,
+                       sizeof(pkt->dport), hash);
+
+  return (FAR struct ipfilter_flow_s *)
+         &index->flows[(hash ^ pkt->proto) & IPFILTER_FLOW_MASK];
+}
+
+/****************************************************************************
+ * Name: ipfilter_flow_lookup and ipfilter_flow_add
+ *
+ * Description:
+ *   Look up or remember a TCP or UDP flow that the chain accepted.  The
+ *   chain is stateless:  Every packet of the flow is accepted until the
+ *   chain is compiled again.
+ *
+ ****************************************************************************/
+
+bool ipfilter_flow_lookup(FAR const struct ipfilter_index_s *index,
+                          FAR const struct ipfilter_pkt_s *pkt)
+{
+  FAR const struct ipfilter_flow_s *flow;
+
+  if (!pkt->ports)
+    {
+      return false;
+    }
+
+  flow = ipfilter_flow_find(index, pkt);
+  return flow->valid && flow->indev == pkt->indev &&
+         flow->outdev == pkt->outdev && flow->proto == pkt->proto &&
+         flow->sport == pkt->sport && flow->dport == pkt->dport &&
+         memcmp(flow->addr, pkt->sip, pkt->alen) == 0 &&
+         memcmp(flow->addr + pkt->alen, pkt->dip, pkt->alen) == 0;
+}
+
+void ipfilter_flow_add(FAR struct ipfilter_index_s *index,
+                       FAR const struct ipfilter_pkt_s *pkt)
+{
+  FAR struct ipfilter_flow_s *flow;
+
+  if (!pkt->ports)
+    {
+      return;
+    }
+
+  flow         = ipfilter_flow_find(index, pkt);
+  flow->indev  = pkt->indev;
+  flow->outdev = pkt->outdev;
+  flow->proto  = pkt->proto;
+  flow->sport  = pkt->sport;
+  flow->dport  = pkt->dport;
+  flow->valid  = true;
+  memcpy(flow->addr, pkt->sip, pkt->alen);
+  memcpy(flow->addr + pkt->alen, pkt->dip, pkt->alen);
+}
+
+#endif /* CONFIG_NET_IPFILTER_FLOWS > 0 */
+#endif /* CONFIG_NET_IPFILTER_INDEX */
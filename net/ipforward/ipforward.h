@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #undef HAVE_FWDALLOC
@@ -76,6 +77,19 @@ struct forward_s
 #endif
 };
 
+/* The key of a forwarded TCP or UDP flow */
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+struct ipfwd_flowkey_s
+{
+  uint16_t addr[16];  /* Source then destination address */
+  uint16_t sport;     /* Ports in network byte order */
+  uint16_t dport;
+  uint8_t  naddr;     /* Half-words per address, 2 (IPv4) or 8 (IPv6) */
+  uint8_t  proto;
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -368,5 +382,87 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #  define ipv4_dropstats(ipv4)
 #endif
 
+/****************************************************************************
+ * Name: ipv4_flowkey / ipv6_flowkey
+ *
+ * Description:
+ *   Get the flow key of a packet to be forwarded.
+ *
+ * Returned Value:
+ *   True if the packet is a TCP or UDP packet that may be cached, false
+ *   otherwise.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+#ifdef CONFIG_NET_IPv4
+bool ipv4_flowkey(FAR struct net_driver_s *dev,
+                  FAR const struct ipv4_hdr_s *ipv4,
+                  FAR struct ipfwd_flowkey_s *key);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+bool ipv6_flowkey(FAR struct net_driver_s *dev,
+                  FAR const struct ipv6_hdr_s *ipv6,
+                  FAR struct ipfwd_flowkey_s *key);
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flow_lookup
+ *
+ * Description:
+ *   Look up the device that a flow received on 'dev' was last forwarded
+ *   to.  A hit means that the route lookup and the FORWARD filter chain
+ *   can be skipped.
+ *
+ * Returned Value:
+ *   The forwarding device, NULL if the flow is not cached or the device is
+ *   down.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct net_driver_s *
+ipfwd_flow_lookup(FAR struct net_driver_s *dev,
+                  FAR const struct ipfwd_flowkey_s *key);
+
+/****************************************************************************
+ * Name: ipfwd_flow_add
+ *
+ * Description:
+ *   Remember that a flow received on 'dev' was routed to 'fwddev' and
+ *   accepted by the FORWARD filter chain.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipfwd_flow_add(FAR struct net_driver_s *dev,
+                    FAR const struct ipfwd_flowkey_s *key,
+                    FAR struct net_driver_s *fwddev);
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE */
+
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipfwd_flowcache_flush
+ *
+ * Description:
+ *   Forget all of the cached flows.  Called whenever a route, a filter
+ *   rule, or the address or state of a network device changes.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipfwd_flowcache_flush(void);
+#else
+#  define ipfwd_flowcache_flush()
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
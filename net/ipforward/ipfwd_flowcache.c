@@ -0,0 +1,244 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flowcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+
+#include "ipforward/ipforward.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPFWD_FLOW_MASK (CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE - 1)
+
+#if (CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE & IPFWD_FLOW_MASK) != 0
+#  error CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE must be a power of two
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A remembered forwarded flow.  It is valid only while 'gen' is the current
+ * generation.
+ */
+
+struct ipfwd_flow_s
+{
+  FAR struct net_driver_s *indev;
+  FAR struct net_driver_s *outdev;
+  struct ipfwd_flowkey_s   key;
+  uint32_t                 gen;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ipfwd_flow_s g_ipfwd_flows[IPFWD_FLOW_MASK + 1];
+static uint32_t g_ipfwd_flowgen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_flow_find
+ ****************************************************************************/
+
+static FAR struct ipfwd_flow_s *
+ipfwd_flow_find(FAR const struct net_driver_s *dev,
+                FAR const struct ipfwd_flowkey_s *key)
+{
+  uint32_t hash = 2166136261u ^ (uintptr_t)dev;
+  int i;
+
+  for (i = 0; i < 2 * key->naddr; i++)
+    {
+      hash = (hash ^ key->addr[i]) * 16777619u;
+    }
+
+  hash = (hash ^ key->sport) * 16777619u;
+  hash = (hash ^ key->dport) * 16777619u;
+  hash = (hash ^ key->proto) * 16777619u;
+  hash ^= hash >> 16;
+
+  return &g_ipfwd_flows[hash & IPFWD_FLOW_MASK];
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_match
+ ****************************************************************************/
+
+static bool ipfwd_flow_match(FAR const struct ipfwd_flowkey_s *a,
+                             FAR const struct ipfwd_flowkey_s *b)
+{
+  return a->naddr == b->naddr && a->proto == b->proto &&
+         a->sport == b->sport && a->dport == b->dport &&
+         memcmp(a->addr, b->addr, 2 * a->naddr * sizeof(uint16_t)) == 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flowkey
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+bool ipv4_flowkey(FAR struct net_driver_s *dev,
+                  FAR const struct ipv4_hdr_s *ipv4,
+                  FAR struct ipfwd_flowkey_s *key)
+{
+  FAR const uint16_t *ports;
+  uint16_t iphdrlen;
+
+  if (ipv4->proto != IP_PROTO_TCP && ipv4->proto != IP_PROTO_UDP)
+    {
+      return false;
+    }
+
+  /* Only the first fragment has the ports, the others are not cached */
+
+  if ((ipv4->ipoffset[0] & ((IP_FLAG_MOREFRAGS | 0x1fff) >> 8)) != 0 ||
+      ipv4->ipoffset[1] != 0)
+    {
+      return false;
+    }
+
+  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+  if (dev->d_len < iphdrlen + 2 * sizeof(uint16_t))
+    {
+      return false;
+    }
+
+  ports = (FAR const uint16_t *)((FAR const uint8_t *)ipv4 + iphdrlen);
+
+  memcpy(key->addr, ipv4->srcipaddr, sizeof(in_addr_t));
+  memcpy(&key->addr[2], ipv4->destipaddr, sizeof(in_addr_t));
+  key->sport = ports[0];
+  key->dport = ports[1];
+  key->naddr = 2;
+  key->proto = ipv4->proto;
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipv6_flowkey
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+bool ipv6_flowkey(FAR struct net_driver_s *dev,
+                  FAR const struct ipv6_hdr_s *ipv6,
+                  FAR struct ipfwd_flowkey_s *key)
+{
+  FAR const uint16_t *ports;
+
+  /* Packets with extension headers are not cached */
+
+  if ((ipv6->proto != IP_PROTO_TCP && ipv6->proto != IP_PROTO_UDP) ||
+      dev->d_len < IPv6_HDRLEN + 2 * sizeof(uint16_t))
+    {
+      return false;
+    }
+
+  ports = (FAR const uint16_t *)((FAR const uint8_t *)ipv6 + IPv6_HDRLEN);
+
+  memcpy(key->addr, ipv6->srcipaddr, sizeof(net_ipv6addr_t));
+  memcpy(&key->addr[8], ipv6->destipaddr, sizeof(net_ipv6addr_t));
+  key->sport = ports[0];
+  key->dport = ports[1];
+  key->naddr = 8;
+  key->proto = ipv6->proto;
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flow_lookup
+ ****************************************************************************/
+
+FAR struct net_driver_s *
+ipfwd_flow_lookup(FAR struct net_driver_s *dev,
+                  FAR const struct ipfwd_flowkey_s *key)
+{
+  FAR struct ipfwd_flow_s *flow = ipfwd_flow_find(dev, key);
+
+  if (flow->gen != g_ipfwd_flowgen || flow->indev != dev ||
+      !ipfwd_flow_match(&flow->key, key) ||
+      !IFF_IS_UP(flow->outdev->d_flags))
+    {
+      return NULL;
+    }
+
+  return flow->outdev;
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_add
+ ****************************************************************************/
+
+void ipfwd_flow_add(FAR struct net_driver_s *dev,
+                    FAR const struct ipfwd_flowkey_s *key,
+                    FAR struct net_driver_s *fwddev)
+{
+  FAR struct ipfwd_flow_s *flow = ipfwd_flow_find(dev, key);
+
+  flow->indev  = dev;
+  flow->outdev = fwddev;
+  flow->key    = *key;
+  flow->gen    = g_ipfwd_flowgen;
+}
+
+/****************************************************************************
+ * Name: ipfwd_flowcache_flush
+ ****************************************************************************/
+
+void ipfwd_flowcache_flush(void)
+{
+  /* Start a new generation.  The entries are cleared only when the
+   * generation wraps around, so that no old entry can become valid again.
+   */
+
+  if (++g_ipfwd_flowgen == 0)
+    {
+      memset(g_ipfwd_flows, 0, sizeof(g_ipfwd_flows));
+      g_ipfwd_flowgen = 1;
+    }
+}
+
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE */
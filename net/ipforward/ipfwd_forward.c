@@ -181,7 +181,7 @@ static uint16_t ipfwd_eventhandler(FAR struct net_driver_s *dev,
 
       /* Free the allocated callback structure */
 
-      fwd->f_cb->flags = 0;
+      devif_callback_setflags(fwd->f_cb, 0);
       fwd->f_cb->priv  = NULL;
       fwd->f_cb->event = NULL;
 
@@ -238,7 +238,7 @@ int ipfwd_forward(FAR struct forward_s *fwd)
   fwd->f_cb = ipfwd_callback_alloc(fwd->f_dev);
   if (fwd->f_cb != NULL)
     {
-      fwd->f_cb->flags   = (IPFWD_POLL | NETDEV_DOWN);
+      devif_callback_setflags(fwd->f_cb, IPFWD_POLL | NETDEV_DOWN);
       fwd->f_cb->priv    = (FAR void *)fwd;
       fwd->f_cb->event   = ipfwd_eventhandler;
 
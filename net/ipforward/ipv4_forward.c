@@ -143,8 +143,8 @@ static int ipv4_hdrsize(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 {
-  uint16_t iphdrlen;
-  uint16_t sum;
+  FAR uint16_t *ttlproto = (FAR uint16_t *)&ipv4->ttl;
+  uint16_t old = *ttlproto;
   int ttl;
 
   /* Check time-to-live (TTL) */
@@ -161,27 +161,12 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
   ipv4->ttl = ttl;
 
-  /* Get the IP header length (accounting for possible options). */
-
-  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
-
-  /* Re-calculate the IPv4 checksum.  This checksum is the Internet checksum
-   * of the 20 bytes of the IPv4 header.  This checksum will be different
-   * because we just modify the IPv4 TTL.
+  /* Only the TTL changed, so adjust the IPv4 checksum for the 16-bit word
+   * holding the TTL instead of computing it again over the whole header.
    */
 
-  ipv4->ipchksum = 0;
-  sum            = chksum(0, (FAR const uint8_t *)ipv4, iphdrlen);
-  if (sum == 0)
-    {
-      sum = 0xffff;
-    }
-  else
-    {
-      sum = HTONS(sum);
-    }
-
-  ipv4->ipchksum = ~sum;
+  net_chksum_adjust(&ipv4->ipchksum, &old, sizeof(old), ttlproto,
+                    sizeof(old));
   return ttl;
 }
 
@@ -199,6 +184,8 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
  *              contains the IPv4 packet.
  *   fwdddev  - The device on which the packet must be forwarded.
  *   ipv4     - A pointer to the IPv4 header in within the IPv4 packet
+ *   filter   - False if the flow cache says that the FORWARD chain already
+ *              accepted the flow.
  *
  * Returned Value:
  *   Zero is returned if the packet was successfully forward;  A negated
@@ -209,7 +196,7 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_dev_forward(FAR struct net_driver_s *dev,
                             FAR struct net_driver_s *fwddev,
-                            FAR struct ipv4_hdr_s *ipv4)
+                            FAR struct ipv4_hdr_s *ipv4, bool filter)
 {
   FAR struct forward_s *fwd = NULL;
 #ifdef CONFIG_DEBUG_NET_WARN
@@ -222,7 +209,7 @@ static int ipv4_dev_forward(FAR struct net_driver_s *dev,
    * replying any other errors.
    */
 
-  ret = ipv4_filter_fwd(dev, fwddev, ipv4);
+  ret = filter ? ipv4_filter_fwd(dev, fwddev, ipv4) : OK;
   if (ret < 0)
     {
       ninfo("Drop/Reject FORWARD packet due to filter %d\n", ret);
@@ -403,7 +390,7 @@ static int ipv4_forward_callback(FAR struct net_driver_s *fwddev,
 
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv4_dev_forward(dev, fwddev, ipv4);
+      ret = ipv4_dev_forward(dev, fwddev, ipv4, true);
       if (ret < 0)
         {
           iob_free_chain(iob);
@@ -459,11 +446,34 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   in_addr_t srcipaddr;
   FAR struct net_driver_s *fwddev;
   int ret;
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  struct ipfwd_flowkey_s key;
+  bool flow;
+#endif
 #ifdef CONFIG_NET_ICMP
   int icmp_reply_type;
   int icmp_reply_code;
 #endif /* CONFIG_NET_ICMP */
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* A flow forwarded before goes to the same device, without the route
+   * lookup and the FORWARD chain.
+   */
+
+  flow = ipv4_flowkey(dev, ipv4, &key);
+  if (flow && (fwddev = ipfwd_flow_lookup(dev, &key)) != NULL)
+    {
+      ret = ipv4_dev_forward(dev, fwddev, ipv4, false);
+      if (ret < 0)
+        {
+          nwarn("WARNING: ipv4_dev_forward failed: %d\n", ret);
+          goto drop;
+        }
+
+      return OK;
+    }
+#endif
+
   /* Search for a device that can forward this packet. */
 
   destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
@@ -485,12 +495,19 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
     {
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv4_dev_forward(dev, fwddev, ipv4);
+      ret = ipv4_dev_forward(dev, fwddev, ipv4, true);
       if (ret < 0)
         {
           nwarn("WARNING: ipv4_dev_forward failed: %d\n", ret);
           goto drop;
         }
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      if (flow)
+        {
+          ipfwd_flow_add(dev, &key, fwddev);
+        }
+#endif
     }
   else
     {
@@ -322,6 +322,8 @@ static int ipv6_packet_conversion(FAR struct net_driver_s *dev,
  *              contains the IPv6 packet.
  *   fwdddev  - The device on which the packet must be forwarded.
  *   ipv6     - A pointer to the IPv6 header in within the IPv6 packet
+ *   filter   - False if the flow cache says that the FORWARD chain already
+ *              accepted the flow.
  *
  * Returned Value:
  *   Zero is returned if the packet was successfully forwarded;  A negated
@@ -332,7 +334,7 @@ static int ipv6_packet_conversion(FAR struct net_driver_s *dev,
 
 static int ipv6_dev_forward(FAR struct net_driver_s *dev,
                             FAR struct net_driver_s *fwddev,
-                            FAR struct ipv6_hdr_s *ipv6)
+                            FAR struct ipv6_hdr_s *ipv6, bool filter)
 {
   FAR struct forward_s *fwd = NULL;
 #ifdef CONFIG_DEBUG_NET_WARN
@@ -345,7 +347,7 @@ static int ipv6_dev_forward(FAR struct net_driver_s *dev,
    * replying any other errors.
    */
 
-  ret = ipv6_filter_fwd(dev, fwddev, ipv6);
+  ret = filter ? ipv6_filter_fwd(dev, fwddev, ipv6) : OK;
   if (ret < 0)
     {
       ninfo("Drop/Reject FORWARD packet due to filter %d\n", ret);
@@ -542,7 +544,7 @@ static int ipv6_forward_callback(FAR struct net_driver_s *fwddev,
 
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv6_dev_forward(dev, fwddev, ipv6);
+      ret = ipv6_dev_forward(dev, fwddev, ipv6, true);
       if (ret < 0)
         {
           iob_free_chain(iob);
@@ -596,12 +598,35 @@ int ipv6_forward(FAR struct net_driver_s *dev, FAR struct ipv6_hdr_s *ipv6)
 {
   FAR struct net_driver_s *fwddev;
   int ret;
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  struct ipfwd_flowkey_s key;
+  bool flow;
+#endif
 #ifdef CONFIG_NET_ICMPv6
   int icmpv6_reply_type;
   int icmpv6_reply_code;
   int icmpv6_reply_data;
 #endif /* CONFIG_NET_ICMP */
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* A flow forwarded before goes to the same device, without the route
+   * lookup and the FORWARD chain.
+   */
+
+  flow = ipv6_flowkey(dev, ipv6, &key);
+  if (flow && (fwddev = ipfwd_flow_lookup(dev, &key)) != NULL)
+    {
+      ret = ipv6_dev_forward(dev, fwddev, ipv6, false);
+      if (ret < 0)
+        {
+          nwarn("WARNING: ipv6_dev_forward failed: %d\n", ret);
+          goto drop;
+        }
+
+      return OK;
+    }
+#endif
+
   /* Search for a device that can forward this packet. */
 
   fwddev = netdev_findby_ripv6addr(ipv6->srcipaddr, ipv6->destipaddr);
@@ -620,12 +645,19 @@ int ipv6_forward(FAR struct net_driver_s *dev, FAR struct ipv6_hdr_s *ipv6)
     {
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv6_dev_forward(dev, fwddev, ipv6);
+      ret = ipv6_dev_forward(dev, fwddev, ipv6, true);
       if (ret < 0)
         {
           nwarn("WARNING: ipv6_dev_forward failed: %d\n", ret);
           goto drop;
         }
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      if (flow)
+        {
+          ipfwd_flow_add(dev, &key, fwddev);
+        }
+#endif
     }
   else
 #if defined(CONFIG_NET_6LOWPAN) /* REVISIT:  Currently only support for 6LoWPAN */
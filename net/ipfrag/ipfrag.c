@@ -31,6 +31,7 @@
 #include <sys/ioctl.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <inttypes.h>
 #include <debug.h>
 #include <string.h>
 #include <errno.h>
@@ -94,7 +95,15 @@ do  \
 
 /* The maximum I/O buffer occupied by fragment reassembly cache */
 
-#define REASSEMBLY_MAXOCCUPYIOB        CONFIG_IOB_NBUFFERS / 5
+#if CONFIG_NET_IPFRAG_REASS_MAXIOB > 0
+#  define REASSEMBLY_MAXOCCUPYIOB      CONFIG_NET_IPFRAG_REASS_MAXIOB
+#else
+#  define REASSEMBLY_MAXOCCUPYIOB      (CONFIG_IOB_NBUFFERS / 5)
+#endif
+
+/* The payload of an IP datagram can never exceed 64KiB */
+
+#define REASSEMBLY_MAXLEN              0xffff
 
 /* Deciding whether to fragment outgoing packets which target is to ourself */
 
@@ -117,26 +126,26 @@ static struct work_s g_wkfragtimeout;
 
 /* Remember the number of I/O buffers currently in reassembly cache */
 
-static uint8_t       g_bufoccupy;
+static uint32_t      g_bufoccupy;
 
-/* Queue header definition, it links all fragments of all NICs by ascending
- * ipid.
+/* Hashtable of the datagrams under reassembly of all NICs, indexed by
+ * source, destination, IP ID and protocol.
  */
 
-static sq_queue_t    g_assemblyhead_ipid;
+static DECLARE_HASHTABLE(g_assemblyhash, CONFIG_NET_IPFRAG_HASH_BITS);
 
 /* Queue header definition, which connects all fragments of all NICs in order
  * of addition time.
  */
 
-static sq_queue_t    g_assemblyhead_time;
+static dq_queue_t    g_assemblyhead_time;
 
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time.
+/* Only one thread can access g_assemblyhash and g_assemblyhead_time at a
+ * time.
  */
 
 mutex_t              g_ipfrag_lock = NXMUTEX_INITIALIZER;
@@ -149,8 +158,9 @@ static void ip_fragin_timerout_expiry(wdparm_t arg);
 static void ip_fragin_timerwork(FAR void *arg);
 static inline FAR struct ip_fraglink_s *
 ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink);
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode);
-static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode);
+static void ip_fragin_dropnode(FAR struct ip_fragsnode_s *node);
+static bool ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode,
+                                   uint32_t bufcnt);
 static inline FAR struct iob_s *
 ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq);
 
@@ -193,8 +203,8 @@ static void ip_fragin_timerwork(FAR void *arg)
 {
   clock_t curtick = clock_systime_ticks();
   sclock_t interval = 0;
-  FAR sq_entry_t *entry;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *entrynext;
   FAR struct ip_fragsnode_s *node;
 
   ninfo("Start reassembly work queue\n");
@@ -205,13 +215,11 @@ static void ip_fragin_timerwork(FAR void *arg)
    * interval
    */
 
-  entry = sq_peek(&g_assemblyhead_time);
+  entry = dq_peek(&g_assemblyhead_time);
   while (entry != NULL)
     {
-      entrynext = sq_next(entry);
-
-      node = (FAR struct ip_fragsnode_s *)
-             container_of(entry, FAR struct ip_fragsnode_s, flinkat);
+      entrynext = dq_next(entry);
+      node = container_of(entry, struct ip_fragsnode_s, tnode);
 
       /* Check for timeout, be careful with the calculation formula,
        * the tick counter may overflow
@@ -270,22 +278,9 @@ static void ip_fragin_timerwork(FAR void *arg)
             }
 #endif
 
-          /* Remove fragments of this node */
-
-          if (node->frags != NULL)
-            {
-              FAR struct ip_fraglink_s *fraglink = node->frags;
-
-              while (fraglink)
-                {
-                  fraglink = ip_fragin_freelink(fraglink);
-                }
-            }
+          /* Remove fragments of this node and free node memory */
 
-          /* Remove node from single-list and free node memory */
-
-          ip_frag_remnode(node);
-          kmm_free(node);
+          ip_fragin_dropnode(node);
         }
       else
         {
@@ -305,7 +300,7 @@ static void ip_fragin_timerwork(FAR void *arg)
 
   /* Be sure to start the timer, if there are nodes in the linked list */
 
-  if (sq_peek(&g_assemblyhead_time) != NULL)
+  if (dq_peek(&g_assemblyhead_time) != NULL)
     {
       clock_t delay = REASSEMBLY_TIMEOUT_MINIMALTICKS;
 
@@ -363,115 +358,130 @@ ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink)
 }
 
 /****************************************************************************
- * Name: ip_fragin_check
+ * Name: ip_fragin_dropnode
  *
  * Description:
- *   Check whether the zero fragment has been received or all fragments have
- *   been received.
+ *   Remove a datagram from the reassembly cache and free its fragments
+ *   and the node itself.
  *
  * Input Parameters:
- *   fragsnode - node of the upper-level linked list, it maintains
- *               information bout all fragments belonging to an IP datagram
+ *   node - node of the upper-level linked list, it maintains information
+ *          about all fragments belonging to an IP datagram
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
+static void ip_fragin_dropnode(FAR struct ip_fragsnode_s *node)
 {
-  uint16_t formerlen = 0;
-  FAR struct ip_fraglink_s *entry;
+  FAR struct ip_fraglink_s *fraglink = node->frags;
 
-  if (fragsnode->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG)
+  while (fraglink != NULL)
     {
-      entry = fragsnode->frags;
-      while (entry != NULL)
-        {
-          if (entry->morefrags)
-            {
-              formerlen += entry->fraglen;
-            }
-          else
-            {
-              /* Only the last entry has a 0 morefrags flag */
+      fraglink = ip_fragin_freelink(fraglink);
+    }
 
-              if (entry->fragoff == formerlen)
-                {
-                  fragsnode->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
-                }
-            }
+  ip_frag_remnode(node);
+  kmm_free(node);
+}
+
+/****************************************************************************
+ * Name: ip_fragin_hash
+ *
+ * Description:
+ *   Fold the key of a datagram into the value used to index
+ *   g_assemblyhash.
+ *
+ ****************************************************************************/
+
+static uint32_t ip_fragin_hash(FAR const struct ip_fragkey_s *key)
+{
+  uint32_t hash = key->ipid ^ ((uint32_t)key->proto << 24);
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      hash ^= key->srcipaddr[i] ^ key->destipaddr[i];
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: ip_fragin_findnode
+ *
+ * Description:
+ *   Find the datagram under reassembly with this key on this device.
+ *
+ ****************************************************************************/
 
-          entry = entry->flink;
+static FAR struct ip_fragsnode_s *
+ip_fragin_findnode(FAR struct net_driver_s *dev,
+                   FAR const struct ip_fragkey_s *key, uint32_t hash)
+{
+  FAR hash_node_t *p;
+
+  hashtable_for_every_possible(g_assemblyhash, p, hash)
+    {
+      FAR struct ip_fragsnode_s *node =
+        container_of(p, struct ip_fragsnode_s, hnode);
+
+      if (node->hash == hash && node->dev == dev &&
+          memcmp(&node->key, key, sizeof(*key)) == 0)
+        {
+          return node;
         }
     }
+
+  return NULL;
 }
 
 /****************************************************************************
  * Name: ip_fragin_cachemonitor
  *
  * Description:
- *   Check the reassembly cache buffer size, if it exceeds the configured
- *   threshold, some I/O buffers need to be freed
+ *   Make room for some more I/O buffers in the reassembly cache.  While
+ *   that would exceed the configured threshold, the oldest datagrams are
+ *   dropped.
  *
  * Input Parameters:
  *   curnode - node of the upper-level linked list, it maintains information
- *             about all fragments belonging to an IP datagram
+ *             about all fragments belonging to an IP datagram, it is never
+ *             dropped.  May be NULL.
+ *   bufcnt  - The number of I/O buffers to be added
  *
  * Returned Value:
- *   none
+ *   true if the I/O buffers fit in the reassembly cache now.
  *
  ****************************************************************************/
 
-static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
+static bool ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode,
+                                   uint32_t bufcnt)
 {
-  uint32_t        cleancnt = 0;
-  uint32_t        bufcnt;
-  FAR sq_entry_t *entry;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *entrynext;
   FAR struct ip_fragsnode_s *node;
 
-  /* Start cache cleaning if g_bufoccupy exceeds the cache threshold */
-
-  if (g_bufoccupy > REASSEMBLY_MAXOCCUPYIOB)
+  entry = dq_peek(&g_assemblyhead_time);
+  while (entry != NULL && g_bufoccupy + bufcnt > REASSEMBLY_MAXOCCUPYIOB)
     {
-      cleancnt = g_bufoccupy - REASSEMBLY_MAXOCCUPYIOB;
-      entry = sq_peek(&g_assemblyhead_time);
-
-      while (entry != NULL && cleancnt > 0)
-        {
-          entrynext = sq_next(entry);
-
-          node = (FAR struct ip_fragsnode_s *)
-                 container_of(entry, FAR struct ip_fragsnode_s, flinkat);
+      entrynext = dq_next(entry);
+      node = container_of(entry, struct ip_fragsnode_s, tnode);
 
-          /* Skip specified node */
-
-          if (node != curnode)
-            {
-              /* Remove fragments of this node */
-
-              if (node->frags != NULL)
-                {
-                  FAR struct ip_fraglink_s *fraglink = node->frags;
-
-                  while (fraglink != NULL)
-                    {
-                      fraglink = ip_fragin_freelink(fraglink);
-                    }
-                }
-
-              /* Remove node from single-list and free node memory */
-
-              bufcnt = ip_frag_remnode(node);
-              kmm_free(node);
-
-              cleancnt = cleancnt > bufcnt ? cleancnt - bufcnt : 0;
-            }
+      /* Skip specified node */
 
-          entry = entrynext;
+      if (node != curnode)
+        {
+          ninfo("Drop the oldest datagram, ipid: %" PRIx32 "\n",
+                node->key.ipid);
+          ip_fragin_dropnode(node);
         }
+
+      entry = entrynext;
     }
+
+  return g_bufoccupy + bufcnt <= REASSEMBLY_MAXOCCUPYIOB;
 }
 
 /****************************************************************************
@@ -530,8 +540,8 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
   g_bufoccupy -= node->bufcnt;
   ASSERT(g_bufoccupy < CONFIG_IOB_NBUFFERS);
 
-  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-  sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
+  hashtable_delete(g_assemblyhash, &node->hnode, node->hash);
+  dq_rem(&node->tnode, &g_assemblyhead_time);
 
   return node->bufcnt;
 }
@@ -542,97 +552,95 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  * Description:
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
- *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   ordered by offset, that is a ip_fragsnode_s node.  The nodes are
+ *   indexed by their key in a hashtable and linked in order of creation.
+ *   A fragment that overlaps another one or lies beyond the tail of the
+ *   datagram drops the whole datagram.  When the I/O buffers held for
+ *   reassembly would exceed the budget, the oldest datagrams are dropped.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
+ *   key         - The identity of the datagram of this fragment
  *   curfraglink - node of the lower-level linked list, it maintains
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   OK if the fragment was taken over, dev->d_iob is cleared then.  On
+ *   failure a negated errno is returned, and neither curfraglink nor
+ *   dev->d_iob is consumed:
+ *   EINVAL  - The fragment is malformed or overlaps another one
+ *   ENOBUFS - The datagram does not fit in the reassembly budget
+ *   ENOMEM  - No memory
+ *
+ * Assumptions:
+ *   The caller holds g_ipfrag_lock.
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink)
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR const struct ip_fragkey_s *key,
+                      FAR struct ip_fraglink_s *curfraglink)
 {
   FAR struct ip_fragsnode_s *node;
-  FAR sq_entry_t            *entry;
-  FAR sq_entry_t            *entrylast = NULL;
-  bool                       empty;
+  FAR struct ip_fraglink_s  *lastlink = NULL;
+  FAR struct ip_fraglink_s  *fraglink = NULL;
+  uint32_t                   hash = ip_fragin_hash(key);
+  uint32_t                   end;
+  uint32_t                   bufcnt;
 
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
-   */
+  end = (uint32_t)curfraglink->fragoff + curfraglink->fraglen;
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-  empty = (entry == NULL) ? true : false;
+  /* Every fragment but the tail one carries a multiple of 8 bytes, and the
+   * datagram can not grow beyond 64KiB.
+   */
 
-  while (entry != NULL)
+  if (curfraglink->fraglen == 0 || end > REASSEMBLY_MAXLEN ||
+      (curfraglink->morefrags && (curfraglink->fraglen & 0x7) != 0))
     {
-      node = (struct ip_fragsnode_s *)entry;
-
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
-        {
-          break;
-        }
-
-      entrylast = entry;
-      entry = sq_next(entry);
+      nwarn("WARNING: Bad fragment, offset: %u, length: %u\n",
+            curfraglink->fragoff, curfraglink->fraglen);
+      return -EINVAL;
     }
 
-  node = (FAR struct ip_fragsnode_s *)entry;
-
-  if (node != NULL && curfraglink->ipid == node->ipid)
+  node = ip_fragin_findnode(dev, key, hash);
+  if (node != NULL)
     {
-      FAR struct ip_fraglink_s *fraglink;
-      FAR struct ip_fraglink_s *lastlink = NULL;
+      FAR struct ip_fraglink_s *tail = node->lastfrag;
 
-      /* Found a previously created ip_fragsnode_s, insert this new
-       * ip_fraglink_s to the subchain of this node.
+      /* Find the place of this fragment in the list ordered by offset,
+       * fragments mostly arrive in order and go behind the last one.
        */
 
-      fraglink = node->frags;
-
-      /* An ip_fragsnode_s must have an ip_fraglink_s because we allocate a
-       * new ip_fraglink_s when caching a new ip_fraglink_s with a new IP ID
-       */
-
-      while (fraglink != NULL)
+      if (curfraglink->fragoff > tail->fragoff)
         {
-          /* The fragment list is ordered by fragment offset value */
-
-          if (curfraglink->fragoff <= fraglink->fragoff)
+          lastlink = tail;
+        }
+      else
+        {
+          fraglink = node->frags;
+          while (fraglink != NULL &&
+                 fraglink->fragoff < curfraglink->fragoff)
             {
-              break;
+              lastlink = fraglink;
+              fraglink = fraglink->flink;
             }
-
-          lastlink = fraglink;
-          fraglink = fraglink->flink;
         }
 
-      if (fraglink == NULL)
+      if (fraglink != NULL &&
+          fraglink->fragoff == curfraglink->fragoff &&
+          fraglink->fraglen == curfraglink->fraglen &&
+          fraglink->morefrags == curfraglink->morefrags)
         {
-          /* This fragment offset is greater than the previous fragments,
-           * added to the last position
+          /* Fragments with same offset value contain the same data, use
+           * the more recently arrived copy. Refer to RFC791, Section3.2,
+           * Page29.  The received length does not change.
            */
 
-          lastlink->flink      = curfraglink;
-
-          /* Remember I/O buffer count */
-
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
-        }
-      else if (curfraglink->fragoff == fraglink->fragoff)
-        {
-          /* Fragments with same offset value contain the same data, use the
-           * more recently arrived copy. Refer to RFC791, Section3.2, Page29.
-           * Replace and removed the old packet from the fragment list
-           */
+          bufcnt = IOBUF_CNT(curfraglink->frag);
+          if (!ip_fragin_cachemonitor(node, bufcnt))
+            {
+              goto nobufs;
+            }
 
           curfraglink->flink = fraglink->flink;
           if (lastlink == NULL)
@@ -644,40 +652,77 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
               lastlink->flink = curfraglink;
             }
 
+          if (node->lastfrag == fraglink)
+            {
+              node->lastfrag = curfraglink;
+            }
+
+          node->bufcnt += bufcnt;
+          g_bufoccupy  += bufcnt;
+
+          bufcnt = IOBUF_CNT(fraglink->frag);
+          node->bufcnt -= bufcnt;
+          g_bufoccupy  -= bufcnt;
+
           iob_free_chain(fraglink->frag);
           kmm_free(fraglink);
+          goto out;
         }
-      else
-        {
-          /* Insert into the fragment list */
 
-          if (lastlink == NULL)
-            {
-              /* Insert before the first node */
+      /* Overlapping fragments are a known attack vector and can not be
+       * reassembled unambiguously, drop the whole datagram (RFC 5722).  A
+       * fragment must not lie beyond the tail either, and a tail must not
+       * come before data already received.
+       */
 
-              curfraglink->flink = node->frags;
-              node->frags = curfraglink;
-            }
-          else
-            {
-              /* Insert this node after lastlink */
+      if ((lastlink != NULL &&
+           lastlink->fragoff + lastlink->fraglen > curfraglink->fragoff) ||
+          (fraglink != NULL && end > fraglink->fragoff) ||
+          (node->totallen != 0 && end > node->totallen) ||
+          (!curfraglink->morefrags &&
+           (node->totallen != 0 || end < tail->fragoff + tail->fraglen)))
+        {
+          nwarn("WARNING: Overlapping fragment, drop ipid: %" PRIx32 "\n",
+                key->ipid);
+          ip_fragin_dropnode(node);
+          return -EINVAL;
+        }
 
-              curfraglink->flink = lastlink->flink;
-              lastlink->flink = curfraglink;
-            }
+      bufcnt = IOBUF_CNT(curfraglink->frag);
+      if (!ip_fragin_cachemonitor(node, bufcnt))
+        {
+          goto nobufs;
+        }
+
+      /* Insert into the fragment list */
 
-          /* Remember I/O buffer count */
+      curfraglink->flink = fraglink;
+      if (lastlink == NULL)
+        {
+          node->frags = curfraglink;
+        }
+      else
+        {
+          lastlink->flink = curfraglink;
+        }
 
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
+      if (fraglink == NULL)
+        {
+          node->lastfrag = curfraglink;
         }
     }
   else
     {
-      /* It's a new IP ID fragment, malloc a new node and insert it into the
-       * linked list
+      /* It's a new datagram, make room for it first, then malloc a new
+       * node and insert it into the hashtable and the time queue.
        */
 
+      bufcnt = IOBUF_CNT(curfraglink->frag);
+      if (!ip_fragin_cachemonitor(NULL, bufcnt))
+        {
+          return -ENOBUFS;
+        }
+
       node = kmm_malloc(sizeof(struct ip_fragsnode_s));
       if (node == NULL)
         {
@@ -685,37 +730,29 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
           return -ENOMEM;
         }
 
-      node->flink      = NULL;
-      node->flinkat    = NULL;
       node->dev        = dev;
-      node->ipid       = curfraglink->ipid;
-      node->frags      = curfraglink;
+      node->key        = *key;
+      node->hash       = hash;
       node->tick       = clock_systime_ticks();
-      node->bufcnt     = IOBUF_CNT(curfraglink->frag);
-      g_bufoccupy     += IOBUF_CNT(curfraglink->frag);
+      node->bufcnt     = 0;
+      node->rcvdlen    = 0;
+      node->totallen   = 0;
       node->verifyflag = 0;
       node->outgoframe = NULL;
 
-      /* Insert this new node into linked list identified by
-       * g_assemblyhead_ipid with correct position
-       */
+      curfraglink->flink = NULL;
+      node->frags        = curfraglink;
+      node->lastfrag     = curfraglink;
 
-      if (sq_peek(&g_assemblyhead_ipid) == NULL || entrylast == NULL)
-        {
-          sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-        }
-      else
-        {
-          sq_addafter(entrylast, (FAR sq_entry_t *)node,
-                      &g_assemblyhead_ipid);
-        }
+      hashtable_add(g_assemblyhash, &node->hnode, hash);
+      dq_addlast(&node->tnode, &g_assemblyhead_time);
+    }
 
-      /* Add this new node to the tail of linked list identified by
-       * g_assemblyhead_time
-       */
+  /* Remember I/O buffer count and the received length */
 
-      sq_addlast((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
-    }
+  node->bufcnt  += bufcnt;
+  g_bufoccupy   += bufcnt;
+  node->rcvdlen += curfraglink->fraglen;
 
   if (curfraglink->fragoff == 0)
     {
@@ -723,32 +760,45 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
 
       node->verifyflag |= IP_FRAGVERIFY_RECVDZEROFRAG;
     }
-  else if (!curfraglink->morefrags)
+
+  if (!curfraglink->morefrags)
     {
-      /* Have received the tail fragment */
+      /* Have received the tail fragment, the length is known now */
 
       node->verifyflag |= IP_FRAGVERIFY_RECVDTAILFRAG;
+      node->totallen    = end;
     }
 
-  /* For indexing convenience */
+  /* No fragments overlap, so there is no hole left once the received
+   * bytes cover the whole datagram.
+   */
 
-  curfraglink->fragsnode = node;
+  if (node->rcvdlen == node->totallen)
+    {
+      node->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
+    }
 
-  /* Check receiving status */
+out:
 
-  ip_fragin_check(node);
+  /* For indexing convenience */
+
+  curfraglink->fragsnode = node;
 
   /* Buffer is take away, clear original pointers in NIC */
 
   netdev_iob_clear(dev);
+  return OK;
 
-  /* Perform cache cleaning when reassembly cache size exceeds the configured
-   * threshold
-   */
+nobufs:
 
-  ip_fragin_cachemonitor(node);
+  /* Even alone this datagram exceeds the budget, it can never be
+   * reassembled.
+   */
 
-  return empty;
+  nwarn("WARNING: Reassembly cache full, drop ipid: %" PRIx32 "\n",
+        key->ipid);
+  ip_fragin_dropnode(node);
+  return -ENOBUFS;
 }
 
 /****************************************************************************
@@ -1110,36 +1160,26 @@ int32_t ip_frag_uninit(void)
 
 void ip_frag_stop(FAR struct net_driver_s *dev)
 {
-  FAR sq_entry_t *entry = NULL;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *entrynext;
 
   ninfo("Stop frag processing for NIC:%p\n", dev);
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = dq_peek(&g_assemblyhead_time);
 
   /* Drop those unassembled incoming fragments belonging to this NIC */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
-      entrynext = sq_next(entry);
+      FAR struct ip_fragsnode_s *node =
+        container_of(entry, struct ip_fragsnode_s, tnode);
+      entrynext = dq_next(entry);
 
       if (dev == node->dev)
         {
-          if (node->frags != NULL)
-            {
-              FAR struct ip_fraglink_s *fraglink = node->frags;
-
-              while (fraglink != NULL)
-                {
-                  fraglink = ip_fragin_freelink(fraglink);
-                }
-            }
-
-          ip_frag_remnode(node);
-          kmm_free(entry);
+          ip_fragin_dropnode(node);
         }
 
       entry = entrynext;
@@ -1166,45 +1206,23 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
 void ip_frag_remallfrags(void)
 {
-  FAR sq_entry_t *entry = NULL;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *entrynext;
   FAR struct net_driver_s *dev;
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = dq_peek(&g_assemblyhead_time);
 
   /* Drop all unassembled incoming fragments */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
-      entrynext = sq_next(entry);
-
-      if (node->frags != NULL)
-        {
-          FAR struct ip_fraglink_s *fraglink = node->frags;
-
-          while (fraglink != NULL)
-            {
-              fraglink = ip_fragin_freelink(fraglink);
-            }
-        }
-
-      /* Because nodes managed by the two queues are the same,
-       * and g_assemblyhead_ipid will be cleared after this loop ends,
-       * so only reset g_assemblyhead_time is needed after this loop ends
-       */
-
-      sq_rem(entry, &g_assemblyhead_ipid);
-      kmm_free(entry);
-
+      entrynext = dq_next(entry);
+      ip_fragin_dropnode(container_of(entry, struct ip_fragsnode_s, tnode));
       entry = entrynext;
     }
 
-  sq_init(&g_assemblyhead_time);
-  g_bufoccupy = 0;
-
   nxmutex_unlock(&g_ipfrag_lock);
 
   /* Drop all unsent outgoing fragments */
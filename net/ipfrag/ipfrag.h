@@ -33,6 +33,7 @@
 #include <stdint.h>
 #include <assert.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/mutex.h>
 #include <nuttx/queue.h>
 #include <nuttx/mm/iob.h>
@@ -70,6 +71,24 @@ enum ip_fragverify_e
   IP_FRAGVERIFY_RECVDTAILFRAG  = 0x01 << 2,
 };
 
+/* The identity of a datagram under reassembly.  Fragments belong to the
+ * same datagram if they arrived on the same interface with the same key.
+ * Unused bytes must be zero, keys are compared with memcmp().
+ */
+
+struct ip_fragkey_s
+{
+  /* The identification field is 16 bits in IPv4 header but 32 bits in IPv6
+   * fragment header
+   */
+
+  uint32_t                   ipid;
+  uint8_t                    isipv4;        /* IPv4 or IPv6 */
+  uint8_t                    proto;         /* IPv4 protocol, 0 for IPv6 */
+  uint32_t                   srcipaddr[4];  /* IPv4 uses the first word */
+  uint32_t                   destipaddr[4]; /* IPv4 uses the first word */
+};
+
 struct ip_fraglink_s
 {
   /* This link is used to maintain a single-linked list of ip_fraglink_s,
@@ -84,37 +103,28 @@ struct ip_fraglink_s
   uint16_t                   fragoff;   /* Fragment offset */
   uint16_t                   fraglen;   /* Payload length */
   uint16_t                   morefrags; /* The more frag flag */
-
-  /* The identification field is 16 bits in IPv4 header but 32 bits in IPv6
-   * fragment header
-   */
-
-  uint32_t                   ipid;
 };
 
 struct ip_fragsnode_s
 {
-  /* This link is used to maintain a single-linked list of ip_fragsnode_s.
-   * Must be the first field in the structure due to flink type casting.
-   */
+  /* Links the node in the reassembly hashtable, indexed by the key */
 
-  FAR struct ip_fragsnode_s *flink;
+  hash_node_t                hnode;
 
   /* Another link which connects all ip_fragsnode_s in order of addition
    * time
    */
 
-  FAR sq_entry_t            *flinkat;
+  dq_entry_t                 tnode;
 
   /* Interface understood by the network */
 
   FAR struct net_driver_s   *dev;
 
-  /* IP Identification (IP ID) field defined in ipv4 header or in ipv6
-   * fragment header.
-   */
+  /* Source, destination, IP ID and protocol of the datagram */
 
-  uint32_t                   ipid;
+  struct ip_fragkey_s        key;
+  uint32_t                   hash;
 
   /* Count ticks, used by ressembly timer */
 
@@ -128,9 +138,19 @@ struct ip_fragsnode_s
 
   uint32_t                   bufcnt;
 
-  /* Linked all fragments with the same IP ID. */
+  /* The fragments never overlap, so the payload is complete once the
+   * received bytes add up to the length given by the tail fragment.
+   */
+
+  uint32_t                   rcvdlen;
+  uint32_t                   totallen;
+
+  /* Linked all fragments with the same IP ID, ordered by offset.  The
+   * last one is remembered, fragments mostly arrive in order.
+   */
 
   FAR struct ip_fraglink_s  *frags;
+  FAR struct ip_fraglink_s  *lastfrag;
 
   /* Points to the reassembled outgoing IP frame */
 
@@ -149,8 +169,8 @@ extern "C"
 #  define EXTERN extern
 #endif
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time
+/* Only one thread can access the reassembly hashtable and time queue at a
+ * time
  */
 
 extern mutex_t g_ipfrag_lock;
@@ -182,21 +202,34 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  * Description:
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
- *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   ordered by offset, that is a ip_fragsnode_s node.  The nodes are
+ *   indexed by their key in a hashtable and linked in order of creation.
+ *   A fragment that overlaps another one or lies beyond the tail of the
+ *   datagram drops the whole datagram.  When the I/O buffers held for
+ *   reassembly would exceed the budget, the oldest datagrams are dropped.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
+ *   key         - The identity of the datagram of this fragment
  *   curfraglink - node of the lower-level linked list, it maintains
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   OK if the fragment was taken over, dev->d_iob is cleared then.  On
+ *   failure a negated errno is returned, and neither curfraglink nor
+ *   dev->d_iob is consumed:
+ *   EINVAL  - The fragment is malformed or overlaps another one
+ *   ENOBUFS - The datagram does not fit in the reassembly budget
+ *   ENOMEM  - No memory
+ *
+ * Assumptions:
+ *   The caller holds g_ipfrag_lock.
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink);
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR const struct ip_fragkey_s *key,
+                      FAR struct ip_fraglink_s *curfraglink);
 
 /****************************************************************************
  * Name: ipv4_fragin
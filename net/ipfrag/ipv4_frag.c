@@ -54,7 +54,8 @@
 
 static inline int32_t
 ipv4_fragin_getinfo(FAR struct iob_s *iob,
-                    FAR struct ip_fraglink_s *fraglink);
+                    FAR struct ip_fraglink_s *fraglink,
+                    FAR struct ip_fragkey_s *key);
 static uint32_t ipv4_fragin_reassemble(FAR struct ip_fragsnode_s *node);
 static inline void
 ipv4_fragout_buildipv4header(FAR struct ipv4_hdr_s *ref,
@@ -75,6 +76,7 @@ ipv4_fragout_buildipv4header(FAR struct ipv4_hdr_s *ref,
  *   iob      - An IPv4 fragment
  *   fraglink - node of the lower-level linked list, it maintains information
  *              of one fragment
+ *   key      - The identity of the datagram of this fragment
  *
  * Returned Value:
  *   None
@@ -83,10 +85,12 @@ ipv4_fragout_buildipv4header(FAR struct ipv4_hdr_s *ref,
 
 static inline int32_t
 ipv4_fragin_getinfo(FAR struct iob_s *iob,
-                    FAR struct ip_fraglink_s *fraglink)
+                    FAR struct ip_fraglink_s *fraglink,
+                    FAR struct ip_fragkey_s *key)
 {
   FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)
                                 (iob->io_data + iob->io_offset);
+  uint16_t iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
   uint16_t offset;
 
   fraglink->flink     = NULL;
@@ -97,10 +101,16 @@ ipv4_fragin_getinfo(FAR struct iob_s *iob,
   fraglink->morefrags = offset & IP_FLAG_MOREFRAGS;
   fraglink->fragoff   = ((offset & 0x1fff) << 3);
 
-  fraglink->fraglen   = (ipv4->len[0] << 8) + ipv4->len[1] - IPv4_HDRLEN;
-  fraglink->ipid      = (ipv4->ipid[0] << 8) + ipv4->ipid[1];
+  fraglink->fraglen   = (ipv4->len[0] << 8) + ipv4->len[1] - iphdrlen;
   fraglink->frag      = iob;
 
+  memset(key, 0, sizeof(*key));
+  key->ipid           = (ipv4->ipid[0] << 8) + ipv4->ipid[1];
+  key->isipv4         = true;
+  key->proto          = ipv4->proto;
+  memcpy(key->srcipaddr, ipv4->srcipaddr, sizeof(in_addr_t));
+  memcpy(key->destipaddr, ipv4->destipaddr, sizeof(in_addr_t));
+
   return OK;
 }
 
@@ -142,10 +152,11 @@ static uint32_t ipv4_fragin_reassemble(FAR struct ip_fragsnode_s *node)
           uint16_t iphdrlen;
 
           /* Get IPv4 header length from IPv4 header (it may carry some
-           * IPv4 options)
+           * IPv4 options, which are not necessarily copied to all
+           * fragments)
            */
 
-          ipv4 = (FAR struct ipv4_hdr_s *)(head->io_data + head->io_offset);
+          ipv4 = (FAR struct ipv4_hdr_s *)(iob->io_data + iob->io_offset);
           iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
 
           /* Just modify the offset and length of all none zero fragments */
@@ -261,7 +272,8 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 {
   FAR struct ip_fragsnode_s *node;
   FAR struct ip_fraglink_s *fraginfo;
-  bool restartwdog;
+  struct ip_fragkey_s key;
+  int ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -278,13 +290,19 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
   /* Polulate fragment information from input packet data */
 
-  ipv4_fragin_getinfo(dev->d_iob, fraginfo);
+  ipv4_fragin_getinfo(dev->d_iob, fraginfo, &key);
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  /* Need to restart reassembly worker if the original linked list is empty */
+  ret = ip_fragin_enqueue(dev, &key, fraginfo);
+  if (ret < 0)
+    {
+      /* The fragment was not taken, dev->d_iob is dropped by the caller */
 
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return ret;
+    }
 
   node = fraginfo->fragsnode;
 
@@ -320,12 +338,9 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
   nxmutex_unlock(&g_ipfrag_lock);
 
-  if (restartwdog)
-    {
-      /* Restart the work queue for fragment processing */
+  /* Start the reassembly timer unless it is already running */
 
-      ip_frag_startwdog();
-    }
+  ip_frag_startwdog();
 
   return OK;
 }
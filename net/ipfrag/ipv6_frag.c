@@ -60,7 +60,8 @@ static uint32_t g_ipv6id;
  ****************************************************************************/
 
 static int32_t ipv6_fragin_getinfo(FAR struct iob_s *iob,
-                                   FAR struct ip_fraglink_s *fraglink);
+                                   FAR struct ip_fraglink_s *fraglink,
+                                   FAR struct ip_fragkey_s *key);
 static uint32_t ipv6_fragin_reassemble(FAR struct ip_fragsnode_s *node);
 static inline void
 ipv6_fragout_buildipv6header(FAR struct ipv6_hdr_s *ref,
@@ -97,7 +98,8 @@ static uint16_t ipv6_fragout_getunfraginfo(FAR struct iob_s *iob,
  ****************************************************************************/
 
 static int32_t ipv6_fragin_getinfo(FAR struct iob_s *iob,
-                                   FAR struct ip_fraglink_s *fraglink)
+                                   FAR struct ip_fraglink_s *fraglink,
+                                   FAR struct ip_fragkey_s *key)
 {
   FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)
                                 (iob->io_data + iob->io_offset);
@@ -142,11 +144,19 @@ static int32_t ipv6_fragin_getinfo(FAR struct iob_s *iob,
       fraglink->morefrags = fraglink->fragoff & 0x1;
       fraglink->fragoff  &= 0xfff8;
       fraglink->fraglen   = paylen;
-      fraglink->ipid      = NTOHL(
+      fraglink->frag      = iob;
+
+      /* The next header may differ between fragments, RFC 8200 identifies
+       * a datagram by the addresses and the ID only.
+       */
+
+      memset(key, 0, sizeof(*key));
+      key->ipid           = NTOHL(
         ((uint32_t)(*(FAR uint16_t *)(&fraghdr->id[0])) << 16) +
          (uint32_t)(*(FAR uint16_t *)(&fraghdr->id[2])));
-
-      fraglink->frag      = iob;
+      key->isipv4         = false;
+      memcpy(key->srcipaddr, ipv6->srcipaddr, sizeof(net_ipv6addr_t));
+      memcpy(key->destipaddr, ipv6->destipaddr, sizeof(net_ipv6addr_t));
 
       return OK;
     }
@@ -468,7 +478,8 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 {
   FAR struct ip_fragsnode_s *node = NULL;
   FAR struct ip_fraglink_s *fraginfo = NULL;
-  bool restartwdog;
+  struct ip_fragkey_s key;
+  int ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -485,13 +496,24 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 
   /* Polulate fragment information from input packet data */
 
-  ipv6_fragin_getinfo(dev->d_iob, fraginfo);
+  ret = ipv6_fragin_getinfo(dev->d_iob, fraginfo, &key);
+  if (ret < 0)
+    {
+      kmm_free(fraginfo);
+      return ret;
+    }
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  /* Need to restart reassembly worker if the original linked list is empty */
+  ret = ip_fragin_enqueue(dev, &key, fraginfo);
+  if (ret < 0)
+    {
+      /* The fragment was not taken, dev->d_iob is dropped by the caller */
 
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return ret;
+    }
 
   node = fraginfo->fragsnode;
   if (node->verifyflag & IP_FRAGVERIFY_RECVDALLFRAGS)
@@ -526,12 +548,9 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 
   nxmutex_unlock(&g_ipfrag_lock);
 
-  if (restartwdog)
-    {
-      /* Restart the work queue for fragment processing */
+  /* Start the reassembly timer unless it is already running */
 
-      ip_frag_startwdog();
-    }
+  ip_frag_startwdog();
 
   return OK;
 }
@@ -570,6 +570,20 @@ int local_getaddr(FAR struct local_conn_s *conn, FAR struct sockaddr *addr,
 int local_create_fifos(FAR struct local_conn_s *conn,
                        uint32_t cssize, uint32_t scsize);
 
+/****************************************************************************
+ * Name: local_ring_connect
+ *
+ * Description:
+ *   Connect a client and a server stream with a pair of in-kernel rings
+ *   instead of a pair of FIFOs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_RING
+int local_ring_connect(FAR struct local_conn_s *client,
+                       FAR struct local_conn_s *server, bool nonblock);
+#endif
+
 /****************************************************************************
  * Name: local_create_halfduplex
  *
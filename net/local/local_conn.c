@@ -200,7 +200,9 @@ int local_alloc_accept(FAR struct local_conn_s *server,
                        FAR struct local_conn_s **accept)
 {
   FAR struct local_conn_s *conn;
+#ifndef CONFIG_NET_LOCAL_RING
   int ret;
+#endif
 
   /* Create a new connection structure for the server side of the
    * connection.
@@ -222,6 +224,12 @@ int local_alloc_accept(FAR struct local_conn_s *server,
   strlcpy(conn->lc_path, client->lc_path, sizeof(conn->lc_path));
   conn->lc_instance_id = client->lc_instance_id;
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* The rings are created by local_stream_connect() */
+
+  *accept = conn;
+  return OK;
+#else
   /* Open the server-side write-only FIFO.  This should not
    * block.
    */
@@ -260,6 +268,7 @@ int local_alloc_accept(FAR struct local_conn_s *server,
 err:
   local_free(conn);
   return ret;
+#endif
 }
 
 /****************************************************************************
@@ -324,7 +333,13 @@ void local_free(FAR struct local_conn_s *conn)
 
   /* Destroy all FIFOs associted with the connection */
 
-  local_release_fifos(conn);
+#ifdef CONFIG_NET_LOCAL_RING
+  if (conn->lc_proto != SOCK_STREAM)
+#endif
+    {
+      local_release_fifos(conn);
+    }
+
 #ifdef CONFIG_NET_LOCAL_STREAM
   nxsem_destroy(&conn->lc_waitsem);
 #endif
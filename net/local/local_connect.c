@@ -88,6 +88,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
       return -ECONNREFUSED;
     }
 
+#ifndef CONFIG_NET_LOCAL_RING
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(client, server->lc_rcvsize, client->lc_rcvsize);
@@ -111,6 +112,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_outfile.f_inode != NULL);
+#endif
 
   net_lock();
   ret = local_alloc_accept(server, client, &conn);
@@ -124,6 +126,15 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
 
   client->lc_state = LOCAL_STATE_ACCEPT;
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Connect the two ends with rings instead of FIFOs */
+
+  ret = local_ring_connect(client, conn, nonblock);
+  if (ret < 0)
+    {
+      goto errout_with_conn;
+    }
+#else
   /* Yes.. open the read-only FIFO */
 
   ret = local_open_client_rx(client, nonblock);
@@ -133,6 +144,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
            client->lc_path, ret);
       goto errout_with_conn;
     }
+#endif
 
   DEBUGASSERT(client->lc_infile.f_inode != NULL);
 
@@ -160,11 +172,13 @@ errout_with_conn:
   net_unlock();
 
 errout_with_outfd:
+#ifndef CONFIG_NET_LOCAL_RING
   file_close(&client->lc_outfile);
   client->lc_outfile.f_inode = NULL;
 
 errout_with_fifos:
   local_release_fifos(client);
+#endif
   client->lc_state = LOCAL_STATE_BOUND;
   return ret;
 }
@@ -35,6 +35,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <fcntl.h>
+#include <string.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
@@ -165,14 +166,26 @@ static void local_recvctl(FAR struct local_conn_s *conn,
       goto out;
     }
 
-  fds = cmsg_append(msg, SOL_SOCKET, SCM_RIGHTS, NULL,
-                    sizeof(int) * peer->lc_cfpcount);
-  if (fds == NULL)
+  /* Pass as many of the pending rights as the control buffer can take in
+   * one message.  The others are left for the next call.
+   */
+
+  count = peer->lc_cfpcount;
+  while (count > 0 &&
+         msg->msg_controllen < CMSG_SPACE(sizeof(int) * count))
+    {
+      count--;
+    }
+
+  if (count == 0)
     {
       goto out;
     }
 
-  count = peer->lc_cfpcount;
+  fds = cmsg_append(msg, SOL_SOCKET, SCM_RIGHTS, NULL,
+                    sizeof(int) * count);
+  DEBUGASSERT(fds != NULL);
+
   for (i = 0; i < count; i++)
     {
       fds[i] = file_dup(peer->lc_cfps[i], 0,
@@ -180,7 +193,6 @@ static void local_recvctl(FAR struct local_conn_s *conn,
       file_close(peer->lc_cfps[i]);
       kmm_free(peer->lc_cfps[i]);
       peer->lc_cfps[i] = NULL;
-      peer->lc_cfpcount--;
       if (fds[i] < 0)
         {
           i++;
@@ -188,13 +200,15 @@ static void local_recvctl(FAR struct local_conn_s *conn,
         }
     }
 
-  if (i > 0)
+  /* Shift the rights that are left to the head of the array */
+
+  peer->lc_cfpcount -= i;
+  if (peer->lc_cfpcount > 0)
     {
-      if (peer->lc_cfpcount)
-        {
-          memmove(peer->lc_cfps[0], peer->lc_cfps[i],
-                  sizeof(FAR void *) * peer->lc_cfpcount);
-        }
+      memmove(&peer->lc_cfps[0], &peer->lc_cfps[i],
+              sizeof(FAR struct file *) * peer->lc_cfpcount);
+      memset(&peer->lc_cfps[peer->lc_cfpcount], 0,
+             sizeof(FAR struct file *) * i);
     }
 
 out:
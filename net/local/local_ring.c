@@ -0,0 +1,644 @@
+/****************************************************************************
+ * net/local/local_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mm/circbuf.h>
+
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each connected peer may have LOCAL_NPOLLWAITERS pollers on each end */
+
+#define LOCAL_RING_NPOLLWAITERS (2 * LOCAL_NPOLLWAITERS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One direction of a connected stream.  The ring is the private inode of
+ * its two files, the read end of the receiver and the write end of the
+ * sender, and is freed with the inode when both are closed.
+ */
+
+struct local_ring_s
+{
+  struct inode      lr_inode;     /* Must be first */
+  mutex_t           lr_lock;      /* Protects the ring */
+  sem_t             lr_rdsem;     /* Readers waiting for data */
+  sem_t             lr_wrsem;     /* Writers waiting for space */
+  struct circbuf_s  lr_buffer;    /* Data that was not handed off */
+  lc_size_t         lr_pollinthrd;
+  lc_size_t         lr_polloutthrd;
+  uint8_t           lr_nreaders;  /* Open read ends */
+  uint8_t           lr_nwriters;  /* Open write ends */
+
+  /* The buffer of a reader blocked on the empty ring.  The writer copies
+   * the data straight into it, without going through lr_buffer.
+   */
+
+  FAR uint8_t      *lr_rbuf;
+  size_t            lr_rlen;
+  size_t            lr_rdone;
+
+  FAR struct pollfd *lr_fds[LOCAL_RING_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     local_ring_close(FAR struct file *filep);
+static ssize_t local_ring_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen);
+static ssize_t local_ring_write(FAR struct file *filep,
+                                FAR const char *buffer, size_t buflen);
+static int     local_ring_ioctl(FAR struct file *filep, int cmd,
+                                unsigned long arg);
+static int     local_ring_poll(FAR struct file *filep,
+                               FAR struct pollfd *fds, bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_local_ring_ops =
+{
+  NULL,              /* open */
+  local_ring_close,  /* close */
+  local_ring_read,   /* read */
+  local_ring_write,  /* write */
+  NULL,              /* seek */
+  local_ring_ioctl,  /* ioctl */
+  NULL,              /* mmap */
+  NULL,              /* truncate */
+  local_ring_poll    /* poll */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_wakeup
+ ****************************************************************************/
+
+static void local_ring_wakeup(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_get_value(sem, &sval) == OK && sval <= 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_readdone
+ *
+ * Description:
+ *   Notify the writers after data was removed from the ring.
+ *
+ ****************************************************************************/
+
+static void local_ring_readdone(FAR struct local_ring_s *ring)
+{
+  if (circbuf_space(&ring->lr_buffer) > ring->lr_polloutthrd)
+    {
+      poll_notify(ring->lr_fds, LOCAL_RING_NPOLLWAITERS, POLLOUT);
+    }
+
+  local_ring_wakeup(&ring->lr_wrsem);
+}
+
+/****************************************************************************
+ * Name: local_ring_writedone
+ *
+ * Description:
+ *   Notify the readers after data was added to the ring.
+ *
+ ****************************************************************************/
+
+static void local_ring_writedone(FAR struct local_ring_s *ring)
+{
+  if (circbuf_used(&ring->lr_buffer) > ring->lr_pollinthrd)
+    {
+      poll_notify(ring->lr_fds, LOCAL_RING_NPOLLWAITERS, POLLIN);
+    }
+
+  local_ring_wakeup(&ring->lr_rdsem);
+}
+
+/****************************************************************************
+ * Name: local_ring_close
+ ****************************************************************************/
+
+static int local_ring_close(FAR struct file *filep)
+{
+  FAR struct local_ring_s *ring = filep->f_inode->i_private;
+
+  nxmutex_lock(&ring->lr_lock);
+
+  if ((filep->f_oflags & O_RDOK) != 0)
+    {
+      /* The writer fails with EPIPE from now on */
+
+      ring->lr_nreaders--;
+      poll_notify(ring->lr_fds, LOCAL_RING_NPOLLWAITERS, POLLERR);
+      local_ring_wakeup(&ring->lr_wrsem);
+    }
+  else
+    {
+      /* The reader gets the end of file once the ring is drained */
+
+      ring->lr_nwriters--;
+      poll_notify(ring->lr_fds, LOCAL_RING_NPOLLWAITERS, POLLHUP);
+      local_ring_wakeup(&ring->lr_rdsem);
+    }
+
+  if (ring->lr_nreaders > 0 || ring->lr_nwriters > 0)
+    {
+      nxmutex_unlock(&ring->lr_lock);
+      return OK;
+    }
+
+  /* Both ends are closed.  The ring itself is freed by inode_release(). */
+
+  nxmutex_unlock(&ring->lr_lock);
+  circbuf_uninit(&ring->lr_buffer);
+  nxsem_destroy(&ring->lr_rdsem);
+  nxsem_destroy(&ring->lr_wrsem);
+  nxmutex_destroy(&ring->lr_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_read
+ *
+ * Description:
+ *   Return the data in the ring or, if it is empty, wait for a writer to
+ *   copy its data straight into the buffer of the caller.
+ *
+ ****************************************************************************/
+
+static ssize_t local_ring_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR struct local_ring_s *ring = filep->f_inode->i_private;
+  ssize_t nread;
+  bool posted;
+  int ret;
+
+  if (buflen == 0)
+    {
+      return 0;
+    }
+
+  nxmutex_lock(&ring->lr_lock);
+
+  for (; ; )
+    {
+      if (!circbuf_is_empty(&ring->lr_buffer))
+        {
+          nread = circbuf_read(&ring->lr_buffer, buffer, buflen);
+          local_ring_readdone(ring);
+          break;
+        }
+
+      /* Return the end of file if there are no writers */
+
+      if (ring->lr_nwriters == 0)
+        {
+          nread = 0;
+          break;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          nread = -EAGAIN;
+          break;
+        }
+
+      /* Post the buffer for the writer, unless another reader already
+       * did.
+       */
+
+      posted = ring->lr_rbuf == NULL;
+      if (posted)
+        {
+          ring->lr_rbuf  = (FAR uint8_t *)buffer;
+          ring->lr_rlen  = buflen;
+          ring->lr_rdone = 0;
+        }
+
+      nxmutex_unlock(&ring->lr_lock);
+      ret = nxsem_wait(&ring->lr_rdsem);
+      nxmutex_lock(&ring->lr_lock);
+
+      if (posted)
+        {
+          nread         = ring->lr_rdone;
+          ring->lr_rbuf = NULL;
+
+          /* The data handed off is returned even if the wait was
+           * interrupted.
+           */
+
+          if (nread > 0)
+            {
+              local_ring_readdone(ring);
+              break;
+            }
+        }
+
+      if (ret < 0)
+        {
+          nread = ret;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&ring->lr_lock);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: local_ring_write
+ ****************************************************************************/
+
+static ssize_t local_ring_write(FAR struct file *filep,
+                                FAR const char *buffer, size_t buflen)
+{
+  FAR struct local_ring_s *ring = filep->f_inode->i_private;
+  ssize_t nwritten = 0;
+  size_t n;
+  int ret;
+
+  if (buflen == 0)
+    {
+      return 0;
+    }
+
+  nxmutex_lock(&ring->lr_lock);
+
+  for (; ; )
+    {
+      if (ring->lr_nreaders == 0)
+        {
+          ret = -EPIPE;
+          break;
+        }
+
+      /* Hand the data off to a blocked reader.  The ring is empty then, so
+       * the order of the data is kept.
+       */
+
+      if (ring->lr_rbuf != NULL && ring->lr_rdone == 0 &&
+          circbuf_is_empty(&ring->lr_buffer))
+        {
+          n = MIN(buflen - nwritten, ring->lr_rlen);
+          memcpy(ring->lr_rbuf, buffer + nwritten, n);
+          ring->lr_rdone = n;
+          nwritten      += n;
+          local_ring_wakeup(&ring->lr_rdsem);
+        }
+
+      if ((size_t)nwritten < buflen && !circbuf_is_full(&ring->lr_buffer))
+        {
+          nwritten += circbuf_write(&ring->lr_buffer, buffer + nwritten,
+                                    buflen - nwritten);
+          local_ring_writedone(ring);
+        }
+
+      if ((size_t)nwritten == buflen)
+        {
+          ret = OK;
+          break;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      nxmutex_unlock(&ring->lr_lock);
+      ret = nxsem_wait(&ring->lr_wrsem);
+      nxmutex_lock(&ring->lr_lock);
+
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&ring->lr_lock);
+  return nwritten > 0 ? nwritten : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_ioctl
+ ****************************************************************************/
+
+static int local_ring_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg)
+{
+  FAR struct local_ring_s *ring = filep->f_inode->i_private;
+  int ret;
+
+  nxmutex_lock(&ring->lr_lock);
+
+  switch (cmd)
+    {
+      case PIPEIOC_POLLINTHRD:
+      case PIPEIOC_POLLOUTTHRD:
+        {
+          if (arg >= circbuf_size(&ring->lr_buffer))
+            {
+              ret = -EINVAL;
+            }
+          else if (cmd == PIPEIOC_POLLINTHRD)
+            {
+              ring->lr_pollinthrd = arg;
+              ret = OK;
+            }
+          else
+            {
+              ring->lr_polloutthrd = arg;
+              ret = OK;
+            }
+        }
+        break;
+
+      case PIPEIOC_PEEK:
+        {
+          FAR struct pipe_peek_s *peek = (FAR struct pipe_peek_s *)arg;
+
+          DEBUGASSERT(peek && peek->buf);
+
+          ret = circbuf_peekat(&ring->lr_buffer,
+                               ring->lr_buffer.tail + peek->offset,
+                               peek->buf, peek->size);
+        }
+        break;
+
+      case PIPEIOC_SETSIZE:
+        {
+          size_t size = MIN((size_t)arg, CONFIG_DEV_PIPE_MAXSIZE);
+
+          ret = size > 0 ? circbuf_resize(&ring->lr_buffer, size) : -EINVAL;
+        }
+        break;
+
+      case PIPEIOC_GETSIZE:
+        ret = circbuf_size(&ring->lr_buffer);
+        break;
+
+      case FIONWRITE:
+      case FIONREAD:
+        *(FAR int *)((uintptr_t)arg) = circbuf_used(&ring->lr_buffer);
+        ret = OK;
+        break;
+
+      case FIONSPACE:
+        *(FAR int *)((uintptr_t)arg) = circbuf_space(&ring->lr_buffer);
+        ret = OK;
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&ring->lr_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_poll
+ ****************************************************************************/
+
+static int local_ring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup)
+{
+  FAR struct local_ring_s *ring = filep->f_inode->i_private;
+  pollevent_t eventset = 0;
+  int ret = OK;
+  int i;
+
+  nxmutex_lock(&ring->lr_lock);
+
+  if (!setup)
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+        }
+
+      nxmutex_unlock(&ring->lr_lock);
+      return OK;
+    }
+
+  for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+    {
+      if (ring->lr_fds[i] == NULL)
+        {
+          ring->lr_fds[i] = fds;
+          fds->priv       = &ring->lr_fds[i];
+          break;
+        }
+    }
+
+  if (i >= LOCAL_RING_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      ret       = -EBUSY;
+      goto errout;
+    }
+
+  if ((filep->f_oflags & O_RDOK) != 0)
+    {
+      if (circbuf_used(&ring->lr_buffer) > ring->lr_pollinthrd)
+        {
+          eventset |= POLLIN;
+        }
+      else if (ring->lr_nwriters == 0)
+        {
+          eventset |= POLLHUP;
+        }
+    }
+  else
+    {
+      if (ring->lr_nreaders == 0)
+        {
+          eventset |= POLLERR;
+        }
+      else if (circbuf_space(&ring->lr_buffer) > ring->lr_polloutthrd)
+        {
+          eventset |= POLLOUT;
+        }
+    }
+
+  poll_notify(&fds, 1, eventset);
+
+errout:
+  nxmutex_unlock(&ring->lr_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_open
+ *
+ * Description:
+ *   Create one direction of a connection, from the writer to the reader.
+ *
+ ****************************************************************************/
+
+static int local_ring_open(FAR struct local_conn_s *writer,
+                           FAR struct local_conn_s *reader,
+                           size_t size, bool wnonblock, bool rnonblock)
+{
+  FAR struct local_ring_s *ring;
+  int ret;
+
+  ring = kmm_zalloc(sizeof(struct local_ring_s));
+  if (ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = circbuf_init(&ring->lr_buffer, NULL,
+                     MIN(MAX(size, 1), CONFIG_DEV_PIPE_MAXSIZE));
+  if (ret < 0)
+    {
+      kmm_free(ring);
+      return ret;
+    }
+
+  nxmutex_init(&ring->lr_lock);
+  nxsem_init(&ring->lr_rdsem, 0, 0);
+  nxsem_init(&ring->lr_wrsem, 0, 0);
+  ring->lr_nreaders = 1;
+  ring->lr_nwriters = 1;
+
+  /* The inode is not linked in the pseudo file system.  It is referenced
+   * by the two files only.
+   */
+
+  INODE_SET_PIPE(&ring->lr_inode);
+  atomic_init(&ring->lr_inode.i_crefs, 2);
+  ring->lr_inode.u.i_ops   = &g_local_ring_ops;
+  ring->lr_inode.i_private = ring;
+
+  memset(&writer->lc_outfile, 0, sizeof(struct file));
+  writer->lc_outfile.f_oflags = O_WRONLY | O_CLOEXEC |
+                                (wnonblock ? O_NONBLOCK : 0);
+  writer->lc_outfile.f_inode  = &ring->lr_inode;
+
+  memset(&reader->lc_infile, 0, sizeof(struct file));
+  reader->lc_infile.f_oflags  = O_RDONLY | O_CLOEXEC |
+                                (rnonblock ? O_NONBLOCK : 0);
+  reader->lc_infile.f_inode   = &ring->lr_inode;
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_connect
+ *
+ * Description:
+ *   Connect a client and a server stream with a pair of in-kernel rings,
+ *   in place of the pair of FIFOs created by local_create_fifos().  The
+ *   ends are attached to lc_infile and lc_outfile as for the FIFOs.
+ *
+ * Input Parameters:
+ *   client   - The client connection
+ *   server   - The server side connection
+ *   nonblock - Open the ends of the client for non-blocking access
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int local_ring_connect(FAR struct local_conn_s *client,
+                       FAR struct local_conn_s *server, bool nonblock)
+{
+  int ret;
+
+  /* The client-to-server ring has the receive size of the server */
+
+  ret = local_ring_open(client, server, server->lc_rcvsize,
+                        nonblock, false);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to create the ring to %s: %d\n",
+           server->lc_path, ret);
+      return ret;
+    }
+
+  ret = local_ring_open(server, client, client->lc_rcvsize,
+                        false, nonblock);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to create the ring from %s: %d\n",
+           server->lc_path, ret);
+
+      file_close(&client->lc_outfile);
+      file_close(&server->lc_infile);
+      return ret;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_NET_LOCAL_RING */
@@ -63,6 +63,11 @@ static void local_freectl(FAR struct local_conn_s *conn, int count)
 {
   FAR struct local_conn_s *peer = conn->lc_peer;
 
+  if (peer == NULL)
+    {
+      peer = conn;
+    }
+
   while (count-- > 0)
     {
       file_close(peer->lc_cfps[--peer->lc_cfpcount]);
@@ -78,10 +83,12 @@ static int local_sendctl(FAR struct local_conn_s *conn,
   FAR struct file *filep2;
   FAR struct file *filep;
   FAR struct cmsghdr *cmsg;
-  int count = 0;
+  int total = 0;
+  int added = 0;
+  int count;
   FAR int *fds;
   int ret;
-  int i = 0;
+  int i;
 
   net_lock();
   peer = conn->lc_peer;
@@ -90,6 +97,10 @@ static int local_sendctl(FAR struct local_conn_s *conn,
       peer = conn;
     }
 
+  /* Check all of the control messages before any right is passed:  The
+   * rights of a message are passed all together or not at all.
+   */
+
   for_each_cmsghdr(cmsg, msg)
     {
       if (!CMSG_OK(msg, cmsg) ||
@@ -100,15 +111,20 @@ static int local_sendctl(FAR struct local_conn_s *conn,
           goto fail;
         }
 
+      total += (cmsg->cmsg_len - sizeof(struct cmsghdr)) / sizeof(int);
+    }
+
+  if (total + peer->lc_cfpcount >= LOCAL_NCONTROLFDS)
+    {
+      ret = -EMFILE;
+      goto fail;
+    }
+
+  for_each_cmsghdr(cmsg, msg)
+    {
       fds = (FAR int *)CMSG_DATA(cmsg);
       count = (cmsg->cmsg_len - sizeof(struct cmsghdr)) / sizeof(int);
 
-      if (count + peer->lc_cfpcount >= LOCAL_NCONTROLFDS)
-        {
-          ret = -EMFILE;
-          goto fail;
-        }
-
       for (i = 0; i < count; i++)
         {
           ret = fs_getfilep(fds[i], &filep);
@@ -134,14 +150,15 @@ static int local_sendctl(FAR struct local_conn_s *conn,
             }
 
           peer->lc_cfps[peer->lc_cfpcount++] = filep2;
+          added++;
         }
     }
 
   net_unlock();
-  return count;
+  return total;
 
 fail:
-  local_freectl(conn, i);
+  local_freectl(conn, added);
   net_unlock();
   return ret;
 }
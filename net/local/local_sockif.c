@@ -1053,6 +1053,29 @@ static int local_socketpair(FAR struct socket *psocks[2])
                            = -1;
 #endif
 
+  nonblock = _SS_ISNONBLOCK(conns[0]->lc_conn.s_flags);
+
+#ifdef CONFIG_NET_LOCAL_RING
+  /* The stream pairs are connected with rings instead of FIFOs */
+
+  if (psocks[0]->s_type == SOCK_STREAM)
+    {
+      ret = local_ring_connect(conns[0], conns[1], nonblock);
+      if (ret >= 0 && nonblock)
+        {
+          ret = local_set_nonblocking(conns[1]);
+        }
+
+      if (ret >= 0)
+        {
+          conns[0]->lc_state = conns[1]->lc_state
+                             = LOCAL_STATE_CONNECTED;
+        }
+
+      return ret;
+    }
+#endif
+
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(conns[0], conns[0]->lc_rcvsize,
@@ -1062,8 +1085,6 @@ static int local_socketpair(FAR struct socket *psocks[2])
       goto errout;
     }
 
-  nonblock = _SS_ISNONBLOCK(conns[0]->lc_conn.s_flags);
-
   /* Open the client-side write-only FIFO. */
 
   ret = local_open_client_tx(conns[0], nonblock);
@@ -31,6 +31,7 @@
 
 #include <net/ethernet.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
@@ -38,15 +39,57 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* About one hash bucket per table entry */
+
+#if CONFIG_NET_IPv6_NCONF_ENTRIES > 1
+#  define NEIGHBOR_HASH_BITS LOG2_CEIL(CONFIG_NET_IPv6_NCONF_ENTRIES)
+#else
+#  define NEIGHBOR_HASH_BITS 1
+#endif
+
+/* The hash key of an IPv6 address:  The interface identifier, which
+ * differs between the neighbors of a link.
+ */
+
+#define NEIGHBOR_HASH_KEY(ipaddr) \
+  ((((uint32_t)(ipaddr)[4] << 16) | (ipaddr)[5]) ^ \
+   (((uint32_t)(ipaddr)[6] << 16) | (ipaddr)[7]))
+
+#define NEIGHBOR_NODE(p, m) container_of(p, struct neighbor_node_s, m)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One entry of the Neighbor table, with its links in the hash bucket of its
+ * address and in the LRU list.
+ */
+
+struct neighbor_node_s
+{
+  hash_node_t             nn_hnode;
+  dq_entry_t              nn_lru;
+  struct neighbor_entry_s nn_entry;
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* This is the Neighbor table.  The network should be locked when accessing
- * this table.
+/* This is the Neighbor table.  The entries in use are indexed by IPv6
+ * address in g_neighbor_hash and linked in g_neighbor_lru, the most
+ * recently used first; the entries from g_neighbor_nused on were never
+ * used.  The network should be locked when accessing this table.
  */
 
-extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern struct neighbor_node_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern DECLARE_HASHTABLE(g_neighbor_hash, NEIGHBOR_HASH_BITS);
+extern dq_queue_t g_neighbor_lru;
+extern unsigned int g_neighbor_nused;
 
 /****************************************************************************
  * Public Function Prototypes
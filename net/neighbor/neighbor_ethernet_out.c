@@ -170,6 +170,7 @@ void neighbor_ethernet_out(FAR struct net_driver_s *dev)
            */
 
           icmpv6_solicit(dev, ipaddr);
+          netdev_offload_reset(dev);
 #else
           /* What to do here? We need the laddr, but no way to get it. */
 
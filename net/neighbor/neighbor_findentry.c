@@ -39,8 +39,9 @@
  * Name: neighbor_findentry
  *
  * Description:
- *   Find an entry in the Neighbor Table.  This interface is internal to
- *   the neighbor implementation; Consider using neighbor_lookup() instead;
+ *   Find an entry in the Neighbor Table and make it the most recently used
+ *   entry.  This interface is internal to the neighbor implementation;
+ *   Consider using neighbor_lookup() instead;
  *
  * Input Parameters:
  *   ipaddr - The IPv6 address to use in the lookup;
@@ -53,16 +54,23 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR hash_node_t *p;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  hashtable_for_every_possible(g_neighbor_hash, p,
+                               NEIGHBOR_HASH_KEY(ipaddr))
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      FAR struct neighbor_node_s *node = NEIGHBOR_NODE(p, nn_hnode);
 
-      if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
+      if (net_ipv6addr_cmp(node->nn_entry.ne_ipaddr, ipaddr))
         {
-          neighbor_dumpentry("Entry found", neighbor);
-          return neighbor;
+          if (dq_peek(&g_neighbor_lru) != &node->nn_lru)
+            {
+              dq_rem(&node->nn_lru, &g_neighbor_lru);
+              dq_addfirst(&node->nn_lru, &g_neighbor_lru);
+            }
+
+          neighbor_dumpentry("Entry found", &node->nn_entry);
+          return &node->nn_entry;
         }
     }
 
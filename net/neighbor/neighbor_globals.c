@@ -36,7 +36,10 @@
  * this table.
  */
 
-struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+struct neighbor_node_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+DECLARE_HASHTABLE(g_neighbor_hash, NEIGHBOR_HASH_BITS);
+dq_queue_t g_neighbor_lru;
+unsigned int g_neighbor_nused;
 
 /****************************************************************************
  * Public Functions
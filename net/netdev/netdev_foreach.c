@@ -29,6 +29,7 @@
 #include <debug.h>
 
 #include <nuttx/net/netdev.h>
+#include <nuttx/rcu.h>
 
 #include "netdev/netdev.h"
 
@@ -44,7 +45,9 @@
  *   when either (1) all devices have been enumerated or (2) when a callback
  *   returns any non-zero value.
  *
- *   NOTE 1:  The network must be locked throughout the enumeration.
+ *   NOTE 1:  The device list is walked in an RCU read-side critical
+ *            section, so the network need not be locked.  A device
+ *            unregistered meanwhile stays valid until the walk ends.
  *   NOTE 2:  No checks are made on devices.  For examples, callbacks will
  *            will be made on network devices that are in the 'down' state.
  *            The callback implementations must take into account all
@@ -60,7 +63,7 @@
  *  1: Enumeration terminated early by callback
  *
  * Assumptions:
- *  The network is locked.
+ *  Any context but an interrupt handler.
  *
  ****************************************************************************/
 
@@ -71,7 +74,10 @@ int netdev_foreach(netdev_callback_t callback, FAR void *arg)
 
   if (callback != NULL)
     {
-      for (dev = g_netdevices; dev; dev = dev->flink)
+      rcu_read_lock();
+
+      for (dev = rcu_dereference(g_netdevices); dev;
+           dev = rcu_dereference(dev->flink))
         {
           if (callback(dev, arg) != 0)
             {
@@ -79,6 +85,8 @@ int netdev_foreach(netdev_callback_t callback, FAR void *arg)
               break;
             }
         }
+
+      rcu_read_unlock();
     }
 
   return ret;
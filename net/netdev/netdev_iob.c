@@ -82,6 +82,7 @@ int netdev_iob_prepare(FAR struct net_driver_s *dev, bool throttled,
   /* Set the device buffer to l2 */
 
   dev->d_buf = NETLLBUF;
+  netdev_offload_reset(dev);
 
   return OK;
 }
@@ -191,6 +192,7 @@ void netdev_iob_release(FAR struct net_driver_s *dev)
     }
 
   dev->d_buf = NULL;
+  netdev_offload_reset(dev);
 }
 
 /****************************************************************************
@@ -84,6 +84,7 @@
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "utils/utils.h"
 
@@ -1224,6 +1225,18 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
         break;
     }
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* The routes of the forwarded flows depend on the device addresses */
+
+  if (ret >= 0 &&
+      (cmd == SIOCSIFADDR || cmd == SIOCDIFADDR || cmd == SIOCSIFNETMASK ||
+       cmd == SIOCSIFDSTADDR || cmd == SIOCSLIFADDR ||
+       cmd == SIOCSLIFNETMASK || cmd == SIOCSLIFDSTADDR))
+    {
+      ipfwd_flowcache_flush();
+    }
+#endif
+
   net_unlock();
   return ret;
 }
@@ -1945,6 +1958,7 @@ int netdev_ifup(FAR struct net_driver_s *dev)
               /* Mark the interface as up */
 
               dev->d_flags |= IFF_UP;
+              ipfwd_flowcache_flush();
 
               /* Update the driver status */
 
@@ -1979,6 +1993,7 @@ int netdev_ifdown(FAR struct net_driver_s *dev)
               /* Mark the interface as down */
 
               dev->d_flags &= ~(IFF_UP | IFF_RUNNING);
+              ipfwd_flowcache_flush();
 
               /* Update the driver status */
 
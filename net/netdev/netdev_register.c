@@ -40,6 +40,7 @@
 #include <nuttx/net/ethernet.h>
 #include <nuttx/net/bluetooth.h>
 #include <nuttx/net/can.h>
+#include <nuttx/rcu.h>
 
 #include "utils/utils.h"
 #include "icmpv6/icmpv6.h"
@@ -392,6 +393,10 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       dev->d_conncb_tail = NULL;
       dev->d_devcb = NULL;
 
+#ifdef CONFIG_NET_LOCK_SPLIT
+      nxrmutex_init(&dev->d_lock);
+#endif
+
       /* We need exclusive access for the following operations */
 
       net_lock();
@@ -462,9 +467,8 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
           last = &((*last)->flink);
         }
 
-      *last = dev;
-
       dev->flink = NULL;
+      rcu_assign_pointer(*last, dev);
 
 #ifdef CONFIG_NET_IGMP
       /* Configure the device for IGMP support */
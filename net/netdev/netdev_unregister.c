@@ -36,9 +36,11 @@
 #include <net/if.h>
 #include <net/ethernet.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/rcu.h>
 
 #include "utils/utils.h"
 #include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -135,23 +137,31 @@ int netdev_unregister(FAR struct net_driver_s *dev)
             {
               /* The entry was in the middle or at the end of the list */
 
-              prev->flink = curr->flink;
+              rcu_assign_pointer(prev->flink, curr->flink);
             }
           else
             {
               /* The entry was at the beginning of the list */
 
-              g_netdevices = curr->flink;
+              rcu_assign_pointer(g_netdevices, curr->flink);
             }
 
-          curr->flink = NULL;
+          /* curr->flink is left alone, a reader may still be on curr */
         }
 
 #ifdef CONFIG_NETDEV_IFINDEX
       free_ifindex(dev->d_ifindex);
 #endif
+
+      /* No cached forwarded flow may refer to the device any more */
+
+      ipfwd_flowcache_flush();
       net_unlock();
 
+      /* Wait for the readers that may still see the device */
+
+      synchronize_rcu();
+
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
       work_cancel_sync(NETDEV_STATISTICS_WORK, &dev->d_statistics.logwork);
 #endif
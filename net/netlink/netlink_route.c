@@ -48,6 +48,7 @@
 #include "net/if_arp.h"
 #include "neighbor/neighbor.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "utils/utils.h"
 
@@ -1027,6 +1028,7 @@ static int netlink_new_ipv4addr(NETLINK_HANDLE handle,
 
   dev->d_ipaddr  = nla_get_in_addr(tb[IFA_LOCAL]);
   dev->d_netmask = make_mask(ifm->ifa_prefixlen);
+  ipfwd_flowcache_flush();
 
   netlink_device_notify_ipaddr(dev, RTM_NEWADDR, AF_INET, &dev->d_ipaddr,
                                ifm->ifa_prefixlen);
@@ -1131,6 +1133,7 @@ static int netlink_del_ipv4addr(NETLINK_HANDLE handle,
   netlink_device_notify_ipaddr(dev, RTM_DELADDR, AF_INET, &dev->d_ipaddr,
                                net_ipv4_mask2pref(dev->d_netmask));
   dev->d_ipaddr  = 0;
+  ipfwd_flowcache_flush();
 
   net_unlock();
 
@@ -30,8 +30,11 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <poll.h>
 
 #include <nuttx/net/net.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 
 #ifdef CONFIG_NET_PKT
 
@@ -50,9 +53,33 @@
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_PKT_MMAP
+/* One PACKET_RX_RING or PACKET_TX_RING shared with user space.  The ring
+ * memory is a slice of pkt_conn_s::ringbuf so that both rings can be
+ * mapped with a single mmap() call, RX ring first.
+ */
+
+struct pkt_ring_s
+{
+  FAR uint8_t *buf;           /* Start of the ring, NULL if not set up */
+  size_t       size;          /* blocksize * blocknr */
+  uint32_t     blocksize;     /* Bytes per block */
+  uint32_t     blocknr;       /* Number of blocks */
+  uint32_t     framesize;     /* TX: bytes per frame slot */
+  uint32_t     framenr;       /* TX: number of frame slots */
+  uint32_t     head;          /* RX: block being filled, TX: next frame */
+  uint32_t     offset;        /* RX: fill offset, 0 if no block is open */
+  uint32_t     first;         /* RX: offset of the first frame in a block */
+  uint32_t     prev;          /* RX: offset of the last frame written */
+  uint64_t     seqnum;        /* RX: sequence number of the next block */
+  clock_t      tmo;           /* RX: block retire timeout in ticks */
+};
+#endif
+
 /* Representation of a packet socket connection */
 
 struct devif_callback_s; /* Forward reference */
+struct pollfd;           /* Forward reference */
 
 struct pkt_conn_s
 {
@@ -69,11 +96,38 @@ struct pkt_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the PKT read-ahead data is retained.
-   *
-   * TODO: Maybe support PACKET_MMAP for further optimize.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+
+  /* poll() waiters, notified directly from the input and TX ring paths */
+
+  FAR struct pollfd *fds[CONFIG_NET_PKT_NPOLLWAITERS];
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* PACKET_RX_RING / PACKET_TX_RING state.  When an RX ring is set up,
+   * pkt_input() writes frames straight into it and the read-ahead queue is
+   * bypassed.
+   */
+
+  FAR uint8_t       *ringbuf;      /* Memory backing both rings */
+  struct pkt_ring_s  rxring;
+  struct pkt_ring_s  txring;
+  bool               mapped;       /* Rings are mapped, geometry is fixed */
+  bool               txwait;       /* A sender waits on txsem */
+  bool               freeze;       /* RX ring is full, input is dropped */
+  struct work_s      rxwork;       /* Retires a partially filled block */
+  FAR struct devif_callback_s *txcb;
+  FAR struct net_driver_s *txdev;  /* Device txcb is attached to */
+  sem_t              txsem;        /* Signalled when the TX ring drains */
+  ssize_t            txsent;       /* Bytes sent since the last send() */
+
+  /* PACKET_STATISTICS counters */
+
+  uint32_t           packets;
+  uint32_t           drops;
+  uint32_t           freezes;
+#endif
 };
 
 /****************************************************************************
@@ -96,8 +150,10 @@ EXTERN const struct sock_intf_s g_pkt_sockif;
  * Public Function Prototypes
  ****************************************************************************/
 
-struct net_driver_s; /* Forward reference */
-struct socket;       /* Forward reference */
+struct net_driver_s;   /* Forward reference */
+struct socket;         /* Forward reference */
+struct tpacket_req3;   /* Forward reference */
+struct mm_map_entry_s; /* Forward reference */
 
 /****************************************************************************
  * Name: pkt_initialize()
@@ -292,6 +348,122 @@ void pkt_poll(FAR struct net_driver_s *dev, FAR struct pkt_conn_s *conn);
 ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: pkt_pollsetup / pkt_pollteardown
+ *
+ * Description:
+ *   Setup or teardown the poll state of a packet socket.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds);
+int pkt_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds);
+
+/****************************************************************************
+ * Name: pkt_pollnotify
+ *
+ * Description:
+ *   Notify the poll() waiters of a packet socket.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_pollnotify(FAR struct pkt_conn_s *conn, pollevent_t eventset);
+
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Handle PACKET_RX_RING and PACKET_TX_RING: allocate or, with a zero
+ *   tp_block_nr, release the requested ring.
+ *
+ * Input Parameters:
+ *   conn  - The packet connection
+ *   tx    - True for PACKET_TX_RING
+ *   req   - The requested ring geometry
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn, bool tx,
+                   FAR const struct tpacket_req3 *req);
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release both rings of a connection when the socket is closed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the RX ring followed by the TX ring into user space.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct pkt_conn_s *conn,
+                  FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the frame in dev->d_iob into the RX ring of the connection.
+ *
+ * Returned Value:
+ *   Always OK: a frame that does not fit is dropped and counted.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_input(FAR struct net_driver_s *dev,
+                   FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Transmit every TP_STATUS_SEND_REQUEST frame of the TX ring.  Called for
+ *   a zero-length send() on a socket with a TX ring.
+ *
+ * Returned Value:
+ *   The number of bytes sent, or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock,
+                      FAR struct net_driver_s *dev, int flags);
+
+/****************************************************************************
+ * Name: pkt_ring_pollstate
+ *
+ * Description:
+ *   Return the POLLIN/POLLOUT state of the rings of a connection.
+ *
+ ****************************************************************************/
+
+pollevent_t pkt_ring_pollstate(FAR struct pkt_conn_s *conn);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
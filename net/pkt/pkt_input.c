@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_PKT)
 
+#include <poll.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -93,6 +94,7 @@ static uint16_t pkt_datahandler(FAR struct net_driver_s *dev,
   else
     {
       ninfo("Buffered %d bytes\n", dev->d_len);
+      pkt_pollnotify(conn, POLLIN);
       return dev->d_len;
     }
 
@@ -152,6 +154,15 @@ static int pkt_in(FAR struct net_driver_s *dev)
        * and thus the packet can be deleted (OK will be returned).
        */
 
+#ifdef CONFIG_NET_PKT_MMAP
+      if ((flags & PKT_NEWDATA) != 0 && conn->rxring.buf != NULL)
+        {
+          /* Write the frame straight into the mapped RX ring */
+
+          return pkt_ring_input(dev, conn);
+        }
+#endif
+
       if ((flags & PKT_NEWDATA) != 0)
         {
           /* Add the PKT to the socket read-ahead buffer. */
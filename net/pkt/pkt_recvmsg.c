@@ -198,7 +198,7 @@ static uint16_t pkt_recvfrom_eventhandler(FAR struct net_driver_s *dev,
 
           /* Don't allow any further call backs. */
 
-          pstate->pr_cb->flags   = 0;
+          devif_callback_setflags(pstate->pr_cb, 0);
           pstate->pr_cb->priv    = NULL;
           pstate->pr_cb->event   = NULL;
 
@@ -469,7 +469,7 @@ ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
       state.pr_cb = pkt_callback_alloc(dev, conn);
       if (state.pr_cb)
         {
-          state.pr_cb->flags  = (PKT_NEWDATA | PKT_POLL);
+          devif_callback_setflags(state.pr_cb, PKT_NEWDATA | PKT_POLL);
           state.pr_cb->priv   = (FAR void *)&state;
           state.pr_cb->event  = pkt_recvfrom_eventhandler;
 
@@ -0,0 +1,759 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT_MMAP)
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "socket/socket.h"
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PKT_ALIGN8(x)        (((x) + 7) & ~7)
+
+/* Offset of the sockaddr_ll and of the link-layer frame in a ring frame */
+
+#define PKT_RING_HDRLEN      TPACKET_ALIGN(sizeof(struct tpacket3_hdr))
+#define PKT_RING_MACOFF      TPACKET_ALIGN(PKT_RING_HDRLEN + \
+                                           sizeof(struct sockaddr_ll))
+
+/* Retire timeout of a partially filled RX block if none was requested */
+
+#define PKT_RING_DEFAULT_TOV 8
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_block
+ ****************************************************************************/
+
+static inline FAR uint8_t *pkt_ring_block(FAR struct pkt_ring_s *ring,
+                                          uint32_t index)
+{
+  return ring->buf + (size_t)index * ring->blocksize;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_txframe
+ *
+ * Description:
+ *   TX frames are fixed-size slots packed from the start of each block.
+ *
+ ****************************************************************************/
+
+static FAR struct tpacket3_hdr *pkt_ring_txframe(FAR struct pkt_ring_s *ring,
+                                                 uint32_t index)
+{
+  uint32_t perblock = ring->blocksize / ring->framesize;
+
+  return (FAR struct tpacket3_hdr *)
+    (pkt_ring_block(ring, index / perblock) +
+     (index % perblock) * ring->framesize);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_retire
+ *
+ * Description:
+ *   Hand the RX block being filled over to user space and move on to the
+ *   next one.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_retire(FAR struct pkt_conn_s *conn, uint32_t status)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket_block_desc *desc;
+
+  if (ring->offset == 0)
+    {
+      return;
+    }
+
+  work_cancel(LPWORK, &conn->rxwork);
+
+  desc = (FAR struct tpacket_block_desc *)pkt_ring_block(ring, ring->head);
+  desc->hdr.bh1.block_status = TP_STATUS_USER | status;
+
+  ring->offset = 0;
+  ring->head   = (ring->head + 1) % ring->blocknr;
+
+  pkt_pollnotify(conn, POLLIN);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_timeout
+ *
+ * Description:
+ *   Retire a block that has not filled up within tp_retire_blk_tov so that
+ *   a slow trickle of frames still reaches user space.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_timeout(FAR void *arg)
+{
+  FAR struct pkt_conn_s *conn = arg;
+
+  net_lock();
+  if (conn->rxring.buf != NULL)
+    {
+      pkt_ring_retire(conn, TP_STATUS_BLK_TMO);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: pkt_ring_open
+ *
+ * Description:
+ *   Start filling the block at the RX ring head.
+ *
+ * Returned Value:
+ *   OK, or -EAGAIN if user space still owns the block (the ring is full).
+ *
+ ****************************************************************************/
+
+static int pkt_ring_open(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket_block_desc *desc;
+  FAR struct tpacket_hdr_v1 *bh1;
+
+  desc = (FAR struct tpacket_block_desc *)pkt_ring_block(ring, ring->head);
+  bh1  = &desc->hdr.bh1;
+
+  if (bh1->block_status != TP_STATUS_KERNEL)
+    {
+      if (!conn->freeze)
+        {
+          conn->freeze = true;
+          conn->freezes++;
+        }
+
+      return -EAGAIN;
+    }
+
+  conn->freeze             = false;
+  desc->version            = TPACKET_V3;
+  desc->offset_to_priv     = PKT_ALIGN8(sizeof(struct tpacket_block_desc));
+  bh1->num_pkts            = 0;
+  bh1->offset_to_first_pkt = ring->first;
+  bh1->blk_len             = ring->first;
+  bh1->seq_num             = ring->seqnum++;
+
+  ring->offset = ring->first;
+  ring->prev   = 0;
+
+  /* Retire the block on timeout if it does not fill up before */
+
+  work_queue(LPWORK, &conn->rxwork, pkt_ring_timeout, conn, ring->tmo);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_txhandler
+ *
+ * Description:
+ *   Device poll callback that transmits one TP_STATUS_SEND_REQUEST frame
+ *   per poll until the TX ring is drained.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static uint16_t pkt_ring_txhandler(FAR struct net_driver_s *dev,
+                                   FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct pkt_conn_s *conn = pvpriv;
+  FAR struct pkt_ring_s *ring;
+  FAR struct tpacket3_hdr *hdr;
+  uint32_t len;
+  int ret;
+
+  if (conn == NULL || dev->d_sndlen > 0 || (flags & PKT_NEWDATA) != 0)
+    {
+      /* The device buffer is busy, wait for the next polling cycle */
+
+      return flags;
+    }
+
+  ring = &conn->txring;
+  hdr  = pkt_ring_txframe(ring, ring->head);
+
+  if (hdr->tp_status != TP_STATUS_SEND_REQUEST)
+    {
+      /* Drained: stop polling and wake up the sender */
+
+      devif_callback_setflags(conn->txcb, 0);
+      if (conn->txwait)
+        {
+          conn->txwait = false;
+          nxsem_post(&conn->txsem);
+        }
+
+      pkt_pollnotify(conn, POLLOUT);
+      return flags;
+    }
+
+  /* tp_len was written by user space, so check it before use */
+
+  len = hdr->tp_len;
+  if (len == 0 || len > ring->framesize - PKT_RING_HDRLEN ||
+      len > NETDEV_PKTSIZE(dev))
+    {
+      ret = -EMSGSIZE;
+    }
+  else
+    {
+      ret = devif_send(dev, (FAR uint8_t *)hdr + PKT_RING_HDRLEN, len,
+                       -NET_LL_HDRLEN(dev));
+      if (ret == -ENOMEM)
+        {
+          /* Out of IOBs, retry this frame on the next poll */
+
+          return flags;
+        }
+    }
+
+  if (ret > 0)
+    {
+      dev->d_len    = dev->d_sndlen;
+      conn->txsent += len;
+      hdr->tp_status = TP_STATUS_AVAILABLE;
+
+      /* Make sure no ARP request overwrites this frame.  This flag will be
+       * cleared in arp_out().
+       */
+
+      IFF_SET_NOARP(dev->d_flags);
+    }
+  else
+    {
+      nwarn("WARNING: Dropping TX ring frame of %" PRIu32 " bytes\n", len);
+      hdr->tp_status = TP_STATUS_WRONG_FORMAT;
+    }
+
+  ring->head = (ring->head + 1) % ring->framenr;
+
+  /* Poll again for the next frame */
+
+  netdev_txnotify_dev(dev);
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Handle PACKET_RX_RING and PACKET_TX_RING: allocate or, with a zero
+ *   tp_block_nr, release the requested ring.  Both rings live in a single
+ *   allocation, so (re)configuring one of them resets the other; this is
+ *   only permitted before the rings are mapped.
+ *
+ * Input Parameters:
+ *   conn  - The packet connection
+ *   tx    - True for PACKET_TX_RING
+ *   req   - The requested ring geometry
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn, bool tx,
+                   FAR const struct tpacket_req3 *req)
+{
+  FAR struct pkt_ring_s *ring = tx ? &conn->txring : &conn->rxring;
+  struct pkt_ring_s newring;
+  FAR uint8_t *buf;
+  uint32_t first = 0;
+  int ret = OK;
+
+  memset(&newring, 0, sizeof(newring));
+
+  if (req->tp_block_nr > 0)
+    {
+      /* Validate the geometry */
+
+      if (req->tp_block_size == 0 ||
+          req->tp_block_size % TPACKET_ALIGNMENT != 0 ||
+          req->tp_frame_size < PKT_RING_MACOFF ||
+          req->tp_frame_size % TPACKET_ALIGNMENT != 0 ||
+          req->tp_frame_size > req->tp_block_size ||
+          req->tp_block_nr > CONFIG_NET_PKT_MMAP_MAXSIZE /
+                             req->tp_block_size ||
+          req->tp_frame_nr != (req->tp_block_size / req->tp_frame_size) *
+                              req->tp_block_nr)
+        {
+          return -EINVAL;
+        }
+
+      first = PKT_ALIGN8(sizeof(struct tpacket_block_desc)) +
+              PKT_ALIGN8(req->tp_sizeof_priv);
+      if (!tx && (req->tp_sizeof_priv > req->tp_block_size ||
+                  first + PKT_RING_MACOFF > req->tp_block_size))
+        {
+          return -EINVAL;
+        }
+
+      newring.blocksize = req->tp_block_size;
+      newring.blocknr   = req->tp_block_nr;
+      newring.framesize = req->tp_frame_size;
+      newring.framenr   = req->tp_frame_nr;
+      newring.size      = (size_t)req->tp_block_size * req->tp_block_nr;
+      newring.first     = first;
+      newring.tmo       = MSEC2TICK(req->tp_retire_blk_tov > 0 ?
+                                    req->tp_retire_blk_tov :
+                                    PKT_RING_DEFAULT_TOV);
+    }
+
+  net_lock();
+
+  if (conn->mapped)
+    {
+      ret = -EBUSY;
+      goto errout_with_lock;
+    }
+
+  if (ring->buf == NULL && newring.size == 0)
+    {
+      goto errout_with_lock;
+    }
+
+  /* Allocate the memory backing both rings, RX ring first */
+
+  buf = NULL;
+  if (newring.size + (tx ? conn->rxring.size : conn->txring.size) > 0)
+    {
+      buf = kumm_memalign(TPACKET_ALIGNMENT, newring.size +
+                          (tx ? conn->rxring.size : conn->txring.size));
+      if (buf == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+    }
+
+  work_cancel(LPWORK, &conn->rxwork);
+
+  if (conn->ringbuf != NULL)
+    {
+      kumm_free(conn->ringbuf);
+    }
+
+  if (tx && conn->txring.buf == NULL && newring.size > 0)
+    {
+      nxsem_init(&conn->txsem, 0, 0);
+    }
+  else if (tx && conn->txring.buf != NULL && newring.size == 0)
+    {
+      if (conn->txcb != NULL)
+        {
+          pkt_callback_free(conn->txdev, conn, conn->txcb);
+          conn->txcb = NULL;
+        }
+
+      nxsem_destroy(&conn->txsem);
+    }
+
+  *ring = newring;
+
+  /* Lay out and reset both rings in the new buffer */
+
+  conn->ringbuf = buf;
+  if (buf != NULL)
+    {
+      memset(buf, 0, conn->rxring.size + conn->txring.size);
+      if (conn->rxring.size > 0)
+        {
+          conn->rxring.buf = buf;
+        }
+
+      if (conn->txring.size > 0)
+        {
+          conn->txring.buf = buf + conn->rxring.size;
+        }
+    }
+
+  conn->rxring.head   = 0;
+  conn->rxring.offset = 0;
+  conn->txring.head   = 0;
+
+errout_with_lock:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release both rings of a connection when the socket is closed.  Any user
+ *   mapping of the rings must not be used after the socket is closed.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  /* The timeout work takes the network lock, so wait for it unlocked */
+
+  work_cancel_sync(LPWORK, &conn->rxwork);
+
+  net_lock();
+
+  if (conn->txcb != NULL)
+    {
+      pkt_callback_free(conn->txdev, conn, conn->txcb);
+      conn->txcb = NULL;
+    }
+
+  if (conn->txring.buf != NULL)
+    {
+      nxsem_destroy(&conn->txsem);
+    }
+
+  if (conn->ringbuf != NULL)
+    {
+      kumm_free(conn->ringbuf);
+      conn->ringbuf = NULL;
+    }
+
+  memset(&conn->rxring, 0, sizeof(conn->rxring));
+  memset(&conn->txring, 0, sizeof(conn->txring));
+  conn->mapped = false;
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the RX ring followed by the TX ring into user space.  The ring
+ *   memory comes from the user heap, so flat and protected builds can hand
+ *   out its address directly.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct pkt_conn_s *conn,
+                  FAR struct mm_map_entry_s *map)
+{
+  size_t total;
+  int ret = OK;
+
+  net_lock();
+
+  total = conn->rxring.size + conn->txring.size;
+  if (conn->ringbuf == NULL)
+    {
+      ret = -ENODEV;
+    }
+  else if (map->offset < 0 || map->offset >= total ||
+           map->length == 0 || map->length > total - map->offset)
+    {
+      ret = -EINVAL;
+    }
+  else
+    {
+      map->vaddr   = conn->ringbuf + map->offset;
+      conn->mapped = true;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the frame in dev->d_iob into the RX ring of the connection.
+ *
+ * Returned Value:
+ *   Always OK: a frame that does not fit is dropped and counted.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int pkt_ring_input(FAR struct net_driver_s *dev,
+                   FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket_block_desc *desc;
+  FAR struct tpacket3_hdr *hdr;
+  FAR struct sockaddr_ll *sll;
+  FAR uint8_t *block;
+  struct timespec ts;
+  uint32_t snaplen;
+  uint32_t total;
+  int ret;
+
+  conn->packets++;
+
+  snaplen = MIN(dev->d_len, ring->blocksize - ring->first -
+                            PKT_RING_MACOFF);
+  total   = TPACKET_ALIGN(PKT_RING_MACOFF + snaplen);
+
+  /* Retire the current block if the frame does not fit in it */
+
+  if (ring->offset != 0 && ring->offset + total > ring->blocksize)
+    {
+      pkt_ring_retire(conn, 0);
+    }
+
+  if (ring->offset == 0 && pkt_ring_open(conn) < 0)
+    {
+      conn->drops++;
+      return OK;
+    }
+
+  block = pkt_ring_block(ring, ring->head);
+  desc  = (FAR struct tpacket_block_desc *)block;
+  hdr   = (FAR struct tpacket3_hdr *)(block + ring->offset);
+  sll   = (FAR struct sockaddr_ll *)((FAR uint8_t *)hdr + PKT_RING_HDRLEN);
+
+  ret = iob_copyout((FAR uint8_t *)hdr + PKT_RING_MACOFF, dev->d_iob,
+                    snaplen, -NET_LL_HDRLEN(dev));
+  if (ret < 0)
+    {
+      conn->drops++;
+      return OK;
+    }
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  memset(hdr, 0, PKT_RING_MACOFF);
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_nsec    = ts.tv_nsec;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_mac     = PKT_RING_MACOFF;
+  hdr->tp_net     = PKT_RING_MACOFF + NET_LL_HDRLEN(dev);
+  hdr->tp_status  = TP_STATUS_USER |
+                    (conn->drops > 0 ? TP_STATUS_LOSING : 0);
+
+  sll->sll_family  = AF_PACKET;
+  sll->sll_ifindex = dev->d_ifindex;
+  sll->sll_hatype  = dev->d_lltype;
+
+#ifdef CONFIG_NET_ETHERNET
+  if (dev->d_lltype == NET_LL_ETHERNET && snaplen >= ETH_HDRLEN)
+    {
+      FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)
+        ((FAR uint8_t *)hdr + PKT_RING_MACOFF);
+
+      sll->sll_protocol = eth->type;
+      sll->sll_halen    = ETHER_ADDR_LEN;
+      memcpy(sll->sll_addr, eth->src, ETHER_ADDR_LEN);
+    }
+#endif
+
+  /* Chain the frame to the previous one of the block */
+
+  if (ring->prev != 0)
+    {
+      FAR struct tpacket3_hdr *prev =
+        (FAR struct tpacket3_hdr *)(block + ring->prev);
+
+      prev->tp_next_offset = ring->offset - ring->prev;
+    }
+  else
+    {
+      desc->hdr.bh1.ts_first_pkt.ts_sec  = ts.tv_sec;
+      desc->hdr.bh1.ts_first_pkt.ts_nsec = ts.tv_nsec;
+    }
+
+  desc->hdr.bh1.ts_last_pkt.ts_sec  = ts.tv_sec;
+  desc->hdr.bh1.ts_last_pkt.ts_nsec = ts.tv_nsec;
+  desc->hdr.bh1.num_pkts++;
+
+  ring->prev    = ring->offset;
+  ring->offset += total;
+  desc->hdr.bh1.blk_len = ring->offset;
+
+  /* Retire the block now if not even an empty frame would fit any more */
+
+  if (ring->offset + PKT_RING_MACOFF > ring->blocksize)
+    {
+      pkt_ring_retire(conn, 0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Transmit every TP_STATUS_SEND_REQUEST frame of the TX ring, starting at
+ *   the ring head.  Called for a zero-length send() on a socket with a TX
+ *   ring.  Unless the socket is non-blocking, wait until the ring drains.
+ *
+ * Returned Value:
+ *   The number of bytes sent, or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock,
+                      FAR struct net_driver_s *dev, int flags)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  ssize_t ret;
+
+  net_lock();
+
+  if (conn->txring.buf == NULL)
+    {
+      net_unlock();
+      return -EINVAL;
+    }
+
+  /* (Re)attach the poll callback to the device the socket is bound to */
+
+  if (conn->txcb != NULL && conn->txdev != dev)
+    {
+      pkt_callback_free(conn->txdev, conn, conn->txcb);
+      conn->txcb = NULL;
+    }
+
+  if (conn->txcb == NULL)
+    {
+      conn->txcb = pkt_callback_alloc(dev, conn);
+      if (conn->txcb == NULL)
+        {
+          net_unlock();
+          return -EBUSY;
+        }
+
+      conn->txdev       = dev;
+      conn->txcb->priv  = conn;
+      conn->txcb->event = pkt_ring_txhandler;
+    }
+
+  devif_callback_setflags(conn->txcb, PKT_POLL);
+  conn->txsent      = 0;
+
+  /* Notify the device driver that new TX data is available. */
+
+  netdev_txnotify_dev(dev);
+
+  ret = OK;
+  if (!_SS_ISNONBLOCK(conn->sconn.s_flags) && (flags & MSG_DONTWAIT) == 0)
+    {
+      conn->txwait = true;
+      ret = net_sem_wait(&conn->txsem);
+      conn->txwait = false;
+    }
+
+  if (ret >= 0)
+    {
+      ret = conn->txsent;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_pollstate
+ *
+ * Description:
+ *   Return the POLLIN/POLLOUT state of the rings of a connection.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+pollevent_t pkt_ring_pollstate(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket_block_desc *desc;
+  pollevent_t eventset = 0;
+  uint32_t index;
+
+  if (ring->buf != NULL)
+    {
+      /* Readable if the last retired block is still held by user space */
+
+      index = (ring->head + ring->blocknr - 1) % ring->blocknr;
+      desc  = (FAR struct tpacket_block_desc *)pkt_ring_block(ring, index);
+      if (desc->hdr.bh1.block_status != TP_STATUS_KERNEL)
+        {
+          eventset |= POLLIN;
+        }
+    }
+
+  ring = &conn->txring;
+  if (ring->buf == NULL ||
+      pkt_ring_txframe(ring, ring->head)->tp_status !=
+      TP_STATUS_SEND_REQUEST)
+    {
+      eventset |= POLLOUT;
+    }
+
+  return eventset;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT_MMAP */
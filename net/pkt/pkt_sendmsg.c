@@ -129,7 +129,7 @@ end_wait:
 
       /* Don't allow any further call backs. */
 
-      pstate->snd_cb->flags    = 0;
+      devif_callback_setflags(pstate->snd_cb, 0);
       pstate->snd_cb->priv     = NULL;
       pstate->snd_cb->event    = NULL;
 
@@ -214,6 +214,16 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
       return -ENODEV;
     }
 
+#ifdef CONFIG_NET_PKT_MMAP
+  /* A zero-length send() on a socket with a TX ring flushes the ring */
+
+  if (len == 0 &&
+      ((FAR struct pkt_conn_s *)psock->s_conn)->txring.buf != NULL)
+    {
+      return pkt_ring_send(psock, dev, flags);
+    }
+#endif
+
   /* Perform the send operation */
 
   /* Initialize the state structure. This is done with the network locked
@@ -239,7 +249,7 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
         {
           /* Set up the callback in the connection */
 
-          state.snd_cb->flags = PKT_POLL;
+          devif_callback_setflags(state.snd_cb, PKT_POLL);
           state.snd_cb->priv  = (FAR void *)&state;
           state.snd_cb->event = psock_send_eventhandler;
 
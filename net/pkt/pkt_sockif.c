@@ -54,7 +54,19 @@ static sockcaps_t pkt_sockcaps(FAR struct socket *psock);
 static void       pkt_addref(FAR struct socket *psock);
 static int        pkt_bind(FAR struct socket *psock,
                     FAR const struct sockaddr *addr, socklen_t addrlen);
+static int        pkt_netpoll(FAR struct socket *psock,
+                              FAR struct pollfd *fds, bool setup);
 static int        pkt_close(FAR struct socket *psock);
+#ifdef CONFIG_NET_PKT_MMAP
+static int        pkt_getsockopt(FAR struct socket *psock, int level,
+                                 int option, FAR void *value,
+                                 FAR socklen_t *value_len);
+static int        pkt_setsockopt(FAR struct socket *psock, int level,
+                                 int option, FAR const void *value,
+                                 socklen_t value_len);
+static int        pkt_mmap(FAR struct socket *psock,
+                           FAR struct mm_map_entry_s *map);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -71,10 +83,21 @@ const struct sock_intf_s g_pkt_sockif =
   NULL,            /* si_listen */
   NULL,            /* si_connect */
   NULL,            /* si_accept */
-  NULL,            /* si_poll */
+  pkt_netpoll,     /* si_poll */
   pkt_sendmsg,     /* si_sendmsg */
   pkt_recvmsg,     /* si_recvmsg */
-  pkt_close        /* si_close */
+  pkt_close,       /* si_close */
+#ifdef CONFIG_NET_PKT_MMAP
+  NULL,            /* si_ioctl */
+  NULL,            /* si_socketpair */
+  NULL,            /* si_shutdown */
+  pkt_getsockopt,  /* si_getsockopt */
+  pkt_setsockopt,  /* si_setsockopt */
+#ifdef CONFIG_NET_SENDFILE
+  NULL,            /* si_sendfile */
+#endif
+  pkt_mmap         /* si_mmap */
+#endif
 };
 
 /****************************************************************************
@@ -264,6 +287,180 @@ static int pkt_bind(FAR struct socket *psock,
     }
 }
 
+/****************************************************************************
+ * Name: pkt_netpoll
+ *
+ * Description:
+ *   The standard poll() operation redirects operations on socket descriptors
+ *   to this function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored.
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+static int pkt_netpoll(FAR struct socket *psock, FAR struct pollfd *fds,
+                       bool setup)
+{
+  if (setup)
+    {
+      return pkt_pollsetup(psock, fds);
+    }
+  else
+    {
+      return pkt_pollteardown(psock, fds);
+    }
+}
+
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: pkt_getsockopt
+ *
+ * Description:
+ *   Return the value of a SOL_PACKET option: PACKET_VERSION and
+ *   PACKET_STATISTICS, whose counters are cleared by the read.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   level     Protocol level to set the option
+ *   option    identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int pkt_getsockopt(FAR struct socket *psock, int level, int option,
+                          FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case PACKET_VERSION:
+        if (*value_len < sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        *(FAR int *)value = TPACKET_V3;
+        *value_len        = sizeof(int);
+        return OK;
+
+      case PACKET_STATISTICS:
+        {
+          FAR struct tpacket_stats_v3 *stats = value;
+
+          if (*value_len < sizeof(struct tpacket_stats_v3))
+            {
+              return -EINVAL;
+            }
+
+          net_lock();
+          stats->tp_packets      = conn->packets;
+          stats->tp_drops        = conn->drops;
+          stats->tp_freeze_q_cnt = conn->freezes;
+          conn->packets          = 0;
+          conn->drops            = 0;
+          conn->freezes          = 0;
+          net_unlock();
+
+          *value_len = sizeof(struct tpacket_stats_v3);
+          return OK;
+        }
+
+      default:
+        return -ENOPROTOOPT;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   Set a SOL_PACKET option: PACKET_VERSION (only TPACKET_V3 is accepted),
+ *   PACKET_RX_RING and PACKET_TX_RING.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to configure
+ *   level     Protocol level to set the option
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int pkt_setsockopt(FAR struct socket *psock, int level, int option,
+                          FAR const void *value, socklen_t value_len)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case PACKET_VERSION:
+        if (value_len < sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        return *(FAR const int *)value == TPACKET_V3 ? OK : -EINVAL;
+
+      case PACKET_RX_RING:
+      case PACKET_TX_RING:
+        if (value_len < sizeof(struct tpacket_req3))
+          {
+            return -EINVAL;
+          }
+
+        return pkt_ring_setup(conn, option == PACKET_TX_RING, value);
+
+      default:
+        return -ENOPROTOOPT;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_mmap
+ *
+ * Description:
+ *   Map the packet rings of the socket into user space.
+ *
+ * Input Parameters:
+ *   psock   Socket instance
+ *   map     The mapping to fill in
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int pkt_mmap(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map)
+{
+  return pkt_ring_mmap(psock->s_conn, map);
+}
+#endif
+
 /****************************************************************************
  * Name: pkt_close
  *
@@ -301,6 +498,12 @@ static int pkt_close(FAR struct socket *psock)
 
               iob_free_queue(&conn->readahead);
 
+#ifdef CONFIG_NET_PKT_MMAP
+              /* And the packet rings */
+
+              pkt_ring_free(conn);
+#endif
+
               /* Then free the connection structure */
 
               conn->crefs = 0;          /* No more references on the connection */
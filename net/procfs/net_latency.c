@@ -0,0 +1,234 @@
+/****************************************************************************
+ * net/procfs/net_latency.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "procfs/procfs.h"
+#include "tcp/tcp.h"
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET_LATENCY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* One line: name, stage, count, avg, max and the histogram */
+
+#define LATENCY_LINELEN (48 + 11 * NET_LATENCY_NBUCKETS)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *g_latency_stage[NET_LATENCY_NSTAGES] =
+{
+  "input",
+  "recv",
+  "send"
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_latency_line
+ *
+ * Description:
+ *   Format one latency histogram.
+ *
+ ****************************************************************************/
+
+static int netprocfs_latency_line(FAR char *buffer, size_t buflen,
+                                  FAR const char *name,
+                                  FAR const char *stage,
+                                  FAR const struct net_latency_s *lat)
+{
+  int len;
+  int i;
+
+  len = snprintf(buffer, buflen, "%-12s %-5s %8" PRIu32 " %8" PRIu64
+                 " %8" PRIu32, name, stage, lat->count,
+                 lat->count > 0 ? lat->total / lat->count : 0,
+                 lat->max);
+
+  for (i = 0; i < NET_LATENCY_NBUCKETS; i++)
+    {
+      len += snprintf(buffer + len, buflen - len, " %" PRIu32,
+                      lat->hist[i]);
+    }
+
+  len += snprintf(buffer + len, buflen - len, "\n");
+  return len;
+}
+
+/****************************************************************************
+ * Name: netprocfs_latency_conn
+ *
+ * Description:
+ *   Format the latency histograms of one socket.
+ *
+ ****************************************************************************/
+
+static int netprocfs_latency_conn(FAR char *buffer, size_t buflen,
+                                  FAR const char *proto, uint16_t lport,
+                                  FAR const struct socket_conn_s *conn)
+{
+  char name[16];
+  int len = 0;
+  int i;
+
+  snprintf(name, sizeof(name), "%s/%" PRIu16, proto, ntohs(lport));
+
+  for (i = 0; i < NET_LATENCY_NSTAGES; i++)
+    {
+      len += netprocfs_latency_line(buffer + len, buflen - len, name,
+                                    g_latency_stage[i], &conn->s_latency[i]);
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_latency
+ *
+ * Description:
+ *   Read and format the latency histograms of the network devices and of
+ *   the TCP and UDP sockets.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_latency(FAR struct netprocfs_file_s *priv,
+                               FAR char *buffer, size_t buflen)
+{
+  FAR struct net_driver_s *dev;
+#ifdef NET_TCP_HAVE_STACK
+  FAR struct tcp_conn_s *tcp = NULL;
+#endif
+#ifdef NET_UDP_HAVE_STACK
+  FAR struct udp_conn_s *udp = NULL;
+#endif
+  int skip = 1;
+  int len = 0;
+
+  if (priv->offset == 0)
+    {
+      len = snprintf(buffer, buflen,
+                     "%-12s %-5s %8s %8s %8s histogram(<1,2,4..us)\n",
+                     "name", "stage", "count", "avg(us)", "max(us)");
+      priv->offset = 1;
+    }
+
+  net_lock();
+
+  for (dev = g_netdevices; dev != NULL; dev = dev->flink)
+    {
+      if (++skip <= priv->offset)
+        {
+          continue;
+        }
+
+      if (buflen - len < LATENCY_LINELEN)
+        {
+          goto out;
+        }
+
+      len += netprocfs_latency_line(buffer + len, buflen - len,
+                                    dev->d_ifname, "input",
+                                    &dev->d_rxlatency);
+      priv->offset++;
+    }
+
+#ifdef NET_TCP_HAVE_STACK
+  while ((tcp = tcp_nextconn(tcp)) != NULL)
+    {
+      if (++skip <= priv->offset)
+        {
+          continue;
+        }
+
+      if (buflen - len < LATENCY_LINELEN * NET_LATENCY_NSTAGES)
+        {
+          goto out;
+        }
+
+      len += netprocfs_latency_conn(buffer + len, buflen - len, "tcp",
+                                    tcp->lport, &tcp->sconn);
+      priv->offset++;
+    }
+#endif
+
+#ifdef NET_UDP_HAVE_STACK
+  while ((udp = udp_nextconn(udp)) != NULL)
+    {
+      if (++skip <= priv->offset)
+        {
+          continue;
+        }
+
+      if (buflen - len < LATENCY_LINELEN * NET_LATENCY_NSTAGES)
+        {
+          goto out;
+        }
+
+      len += netprocfs_latency_conn(buffer + len, buflen - len, "udp",
+                                    udp->lport, &udp->sconn);
+      priv->offset++;
+    }
+#endif
+
+out:
+  net_unlock();
+  return len;
+}
+
+#endif /* CONFIG_NET_LATENCY */
@@ -108,6 +108,14 @@ extern const struct procfs_operations g_netroute_operations;
 static const struct netprocfs_entry_s g_net_entries[] =
 {
 #ifdef CONFIG_NET_STATISTICS
+#  ifdef CONFIG_NET_LATENCY
+  {
+    DTYPE_FILE, "latency",
+    {
+      netprocfs_read_latency
+    }
+  },
+#  endif
   {
     DTYPE_FILE, "stat",
     {
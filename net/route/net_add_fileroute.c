@@ -33,11 +33,13 @@
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
 
@@ -88,6 +90,12 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_closeroute_ipv4(&fshandle);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  net_lock();
+  ipfwd_flowcache_flush();
+  net_unlock();
+#endif
+
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
@@ -124,6 +132,12 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   net_closeroute_ipv6(&fshandle);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  net_lock();
+  ipfwd_flowcache_flush();
+  net_unlock();
+#endif
+
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET6);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
@@ -36,12 +36,14 @@
 #include <arpa/inet.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
 
@@ -323,6 +325,13 @@ errout_with_fshandle:
 
 errout_with_lock:
   net_unlockroute_ipv4();
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  net_lock();
+  ipfwd_flowcache_flush();
+  net_unlock();
+#endif
+
   return ret;
 }
 #endif
@@ -476,6 +485,13 @@ errout_with_fshandle:
 
 errout_with_lock:
   net_unlockroute_ipv6();
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  net_lock();
+  ipfwd_flowcache_flush();
+  net_unlock();
+#endif
+
   return ret;
 }
 #endif
@@ -33,10 +33,13 @@
 
 #include <arpa/inet.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/rcu.h>
 
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 
@@ -48,6 +51,7 @@
 struct route_match_ipv4_s
 {
   FAR struct net_route_ipv4_s *prev;     /* Predecessor in the list */
+  FAR struct net_route_ipv4_s *route;    /* The entry removed */
   in_addr_t                    target;   /* The target IP address to match */
   in_addr_t                    netmask;  /* The network mask to match */
 };
@@ -57,6 +61,7 @@ struct route_match_ipv4_s
 struct route_match_ipv6_s
 {
   FAR struct net_route_ipv6_s *prev;     /* Predecessor in the list */
+  FAR struct net_route_ipv6_s *route;    /* The entry removed */
   net_ipv6addr_t               target;   /* The target IP address to match */
   net_ipv6addr_t               netmask;  /* The network mask to match */
 };
@@ -113,11 +118,15 @@ static int net_del_ipv4route(FAR struct net_route_ipv4_s *route,
           ramroute_ipv4_remfirst(&g_ipv4_routes);
         }
 
+#ifdef CONFIG_ROUTE_LPM
+      net_lpm_rebuild_ipv4();
+#endif
+
       netlink_route_notify(route, RTM_DELROUTE, AF_INET);
 
-      /* And free the routing table entry by adding it to the free list */
+      /* It is freed once the readers that may still see it are done */
 
-      net_freeroute_ipv4(route);
+      match->route = route;
 
       /* Return a non-zero value to terminate the traversal */
 
@@ -171,11 +180,15 @@ static int net_del_ipv6route(FAR struct net_route_ipv6_s *route,
           ramroute_ipv6_remfirst(&g_ipv6_routes);
         }
 
+#ifdef CONFIG_ROUTE_LPM
+      net_lpm_rebuild_ipv6();
+#endif
+
       netlink_route_notify(route, RTM_DELROUTE, AF_INET6);
 
-      /* And free the routing table entry by adding it to the free list */
+      /* It is freed once the readers that may still see it are done */
 
-      net_freeroute_ipv6(route);
+      match->route = route;
 
       /* Return a non-zero value to terminate the traversal */
 
@@ -213,13 +226,30 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 
   /* Set up the comparison structure */
 
-  match.prev = NULL;
+  match.prev  = NULL;
+  match.route = NULL;
   net_ipv4addr_copy(match.target, target);
   net_ipv4addr_copy(match.netmask, netmask);
 
-  /* Then remove the entry from the routing table */
+  /* Then remove the entry from the routing table.  The readers walk the
+   * table without the network lock, it still serializes the writers.
+   */
+
+  net_lock();
+  net_foreachroute_ipv4(net_del_ipv4route, &match);
+  ipfwd_flowcache_flush();
+  net_unlock();
+
+  if (match.route == NULL)
+    {
+      return -ENOENT;
+    }
+
+  /* And free the routing table entry by adding it to the free list */
 
-  return net_foreachroute_ipv4(net_del_ipv4route, &match) ? OK : -ENOENT;
+  synchronize_rcu();
+  net_freeroute_ipv4(match.route);
+  return OK;
 }
 #endif
 
@@ -230,13 +260,30 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 
   /* Set up the comparison structure */
 
-  match.prev = NULL;
+  match.prev  = NULL;
+  match.route = NULL;
   net_ipv6addr_copy(match.target, target);
   net_ipv6addr_copy(match.netmask, netmask);
 
-  /* Then remove the entry from the routing table */
+  /* Then remove the entry from the routing table.  The readers walk the
+   * table without the network lock, it still serializes the writers.
+   */
+
+  net_lock();
+  net_foreachroute_ipv6(net_del_ipv6route, &match);
+  ipfwd_flowcache_flush();
+  net_unlock();
+
+  if (match.route == NULL)
+    {
+      return -ENOENT;
+    }
+
+  /* And free the routing table entry by adding it to the free list */
 
-  return net_foreachroute_ipv6(net_del_ipv6route, &match) ? OK : -ENOENT;
+  synchronize_rcu();
+  net_freeroute_ipv6(match.route);
+  return OK;
 }
 #endif
 
@@ -30,6 +30,7 @@
 #include <errno.h>
 
 #include <nuttx/net/net.h>
+#include <nuttx/rcu.h>
 
 #include <arch/irq.h>
 
@@ -66,25 +67,26 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg)
   FAR struct net_route_ipv4_entry_s *next;
   int ret = 0;
 
-  /* Prevent concurrent access to the routing table */
+  /* The entries are released only after a grace period, so the table can
+   * be walked while it is changed.
+   */
 
-  net_lock();
+  rcu_read_lock();
 
   /* Visit each entry in the routing table */
 
-  for (route = g_ipv4_routes.head; ret == 0 && route != NULL; route = next)
+  for (route = rcu_dereference(g_ipv4_routes.head);
+       ret == 0 && route != NULL; route = next)
     {
       /* Get the next entry in the to visit.  We do this BEFORE calling the
        * handler because the handler may delete this entry.
        */
 
-      next = route->flink;
+      next = rcu_dereference(route->flink);
       ret  = handler(&route->entry, arg);
     }
 
-  /* Unlock the network */
-
-  net_unlock();
+  rcu_read_unlock();
   return ret;
 }
 #endif
@@ -96,25 +98,26 @@ int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
   FAR struct net_route_ipv6_entry_s *next;
   int ret = 0;
 
-  /* Prevent concurrent access to the routing table */
+  /* The entries are released only after a grace period, so the table can
+   * be walked while it is changed.
+   */
 
-  net_lock();
+  rcu_read_lock();
 
   /* Visit each entry in the routing table */
 
-  for (route = g_ipv6_routes.head; ret == 0 && route != NULL; route = next)
+  for (route = rcu_dereference(g_ipv6_routes.head);
+       ret == 0 && route != NULL; route = next)
     {
       /* Get the next entry in the to visit.  We do this BEFORE calling the
        * handler because the handler may delete this entry.
        */
 
-      next = route->flink;
+      next = rcu_dereference(route->flink);
       ret  = handler(&route->entry, arg);
     }
 
-  /* Unlock the network */
-
-  net_unlock();
+  rcu_read_unlock();
   return ret;
 }
 #endif
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include "route/ramroute.h"
+#include "route/lpmroute.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
 
@@ -56,6 +57,10 @@ void net_init_route(void)
   net_init_ramroute();
 #endif
 
+#ifdef CONFIG_ROUTE_LPM
+  net_init_lpmroute();
+#endif
+
 #if defined(CONFIG_ROUTE_IPv4_CACHEROUTE) || defined(CONFIG_ROUTE_IPv6_CACHEROUTE)
   net_init_cacheroute();
 #endif
@@ -0,0 +1,616 @@
+/****************************************************************************
+ * net/route/net_lpmroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/net/ip.h>
+
+#include "route/ramroute.h"
+#include "route/lpmroute.h"
+#include "route/route.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_ROUTE_LPM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+#  define LPM_KEYLEN 16
+#else
+#  define LPM_KEYLEN 4
+#endif
+
+/* A trie of n routes has at most n - 1 glue nodes */
+
+#define LPM_IPv4_NODES (2 * CONFIG_ROUTE_MAX_IPv4_RAMROUTES)
+#define LPM_IPv6_NODES (2 * CONFIG_ROUTE_MAX_IPv6_RAMROUTES)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of a path-compressed binary trie.  The node stands for the
+ * first 'len' bits of 'key'; its children extend the prefix with a '0' or
+ * a '1' bit, possibly skipping the bits that no route tells apart.  Glue
+ * nodes, where two branches split, have no route.
+ */
+
+struct route_lpm_node_s
+{
+  FAR struct route_lpm_node_s *child[2];
+  FAR void *route;               /* The route of this prefix, or NULL */
+  uint8_t   key[LPM_KEYLEN];     /* The prefix, in network order */
+  uint8_t   len;                 /* The prefix length in bits */
+};
+
+/* The trie is modified with the network locked.  The lookups do not lock:
+ * They retry if the sequence count was odd (an update in progress) or has
+ * changed.  The nodes and the routes are never freed to the heap, so a
+ * lookup that races with an update only reads stale data, that it then
+ * discards.
+ */
+
+struct route_lpm_s
+{
+  FAR struct route_lpm_node_s *root;
+  FAR struct route_lpm_node_s *pool;
+  uint16_t    npool;             /* The size of the node pool */
+  uint16_t    nused;             /* The nodes in use */
+  uint16_t    nunindexed;        /* The routes with a malformed netmask */
+  uint8_t     keybits;           /* 32 or 128 */
+  atomic_uint seq;               /* Odd while the trie is updated */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+static struct route_lpm_node_s g_ipv4_lpmnodes[LPM_IPv4_NODES];
+static struct route_lpm_s g_ipv4_lpm;
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+static struct route_lpm_node_s g_ipv6_lpmnodes[LPM_IPv6_NODES];
+static struct route_lpm_s g_ipv6_lpm;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpm_bit
+ *
+ * Description:
+ *   Return bit 'n' of a key, counted from the most significant bit.
+ *
+ ****************************************************************************/
+
+static inline int lpm_bit(FAR const uint8_t *key, unsigned int n)
+{
+  return (key[n >> 3] >> (7 - (n & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: lpm_common
+ *
+ * Description:
+ *   Return the number of leading bits, up to 'len', that two keys share.
+ *
+ ****************************************************************************/
+
+static unsigned int lpm_common(FAR const uint8_t *a, FAR const uint8_t *b,
+                               unsigned int len)
+{
+  unsigned int n = 0;
+  uint8_t diff;
+
+  while (n < len && a[n >> 3] == b[n >> 3])
+    {
+      n += 8;
+    }
+
+  if (n >= len)
+    {
+      return len;
+    }
+
+  for (diff = a[n >> 3] ^ b[n >> 3]; (diff & 0x80) == 0; diff <<= 1)
+    {
+      n++;
+    }
+
+  return MIN(n, len);
+}
+
+/****************************************************************************
+ * Name: lpm_write_begin and lpm_write_end
+ ****************************************************************************/
+
+static void lpm_write_begin(FAR struct route_lpm_s *lpm)
+{
+  atomic_fetch_add_explicit(&lpm->seq, 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+}
+
+static void lpm_write_end(FAR struct route_lpm_s *lpm)
+{
+  atomic_fetch_add_explicit(&lpm->seq, 1, memory_order_release);
+}
+
+/****************************************************************************
+ * Name: lpm_init
+ ****************************************************************************/
+
+static void lpm_init(FAR struct route_lpm_s *lpm,
+                     FAR struct route_lpm_node_s *pool, uint16_t npool,
+                     uint8_t keybits)
+{
+  lpm->root       = NULL;
+  lpm->pool       = pool;
+  lpm->npool      = npool;
+  lpm->nused      = 0;
+  lpm->nunindexed = 0;
+  lpm->keybits    = keybits;
+  atomic_init(&lpm->seq, 0);
+}
+
+/****************************************************************************
+ * Name: lpm_alloc
+ ****************************************************************************/
+
+static FAR struct route_lpm_node_s *
+lpm_alloc(FAR struct route_lpm_s *lpm, FAR const uint8_t *key,
+          unsigned int len, FAR void *route)
+{
+  FAR struct route_lpm_node_s *node;
+  unsigned int nbytes = (len + 7) >> 3;
+
+  if (lpm->nused >= lpm->npool)
+    {
+      return NULL;
+    }
+
+  node           = &lpm->pool[lpm->nused++];
+  node->child[0] = NULL;
+  node->child[1] = NULL;
+  node->route    = route;
+  node->len      = len;
+
+  /* Keep only the bits of the prefix */
+
+  memset(node->key, 0, sizeof(node->key));
+  memcpy(node->key, key, nbytes);
+  if ((len & 7) != 0)
+    {
+      node->key[nbytes - 1] &= 0xff << (8 - (len & 7));
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: lpm_insert
+ *
+ * Description:
+ *   Insert a prefix in the trie.  The new nodes are filled before they are
+ *   linked, so that a concurrent lookup always finds a consistent path.
+ *
+ ****************************************************************************/
+
+static int lpm_insert(FAR struct route_lpm_s *lpm, FAR const uint8_t *key,
+                      unsigned int len, FAR void *route)
+{
+  FAR struct route_lpm_node_s **link = &lpm->root;
+  FAR struct route_lpm_node_s *node;
+  FAR struct route_lpm_node_s *leaf;
+  FAR struct route_lpm_node_s *glue;
+  unsigned int n = 0;
+
+  /* Walk down while the prefix of the node is a prefix of the new one */
+
+  while ((node = *link) != NULL)
+    {
+      n = lpm_common(node->key, key, MIN(node->len, len));
+      if (n < node->len)
+        {
+          break;
+        }
+
+      if (node->len == len)
+        {
+          /* The prefix is there:  Give its route to a glue node, or keep
+           * the older route.
+           */
+
+          if (node->route == NULL)
+            {
+              node->route = route;
+            }
+
+          return OK;
+        }
+
+      link = &node->child[lpm_bit(key, node->len)];
+    }
+
+  leaf = lpm_alloc(lpm, key, len, route);
+  if (leaf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  if (node == NULL)
+    {
+      /* An empty branch */
+    }
+  else if (n == len)
+    {
+      /* The new prefix is a prefix of the node:  Insert it above */
+
+      leaf->child[lpm_bit(node->key, len)] = node;
+    }
+  else
+    {
+      /* The prefixes split at bit n:  Insert a glue node above both */
+
+      glue = lpm_alloc(lpm, key, n, NULL);
+      if (glue == NULL)
+        {
+          lpm->nused--;
+          return -ENOMEM;
+        }
+
+      glue->child[lpm_bit(key, n)]       = leaf;
+      glue->child[lpm_bit(node->key, n)] = node;
+      leaf = glue;
+    }
+
+  atomic_thread_fence(memory_order_release);
+  *link = leaf;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lpm_lookup
+ *
+ * Description:
+ *   Find the route of the longest prefix that matches the key.  The walk is
+ *   bounded, in case it races with an update.
+ *
+ ****************************************************************************/
+
+static FAR void *lpm_lookup(FAR struct route_lpm_s *lpm,
+                            FAR const uint8_t *key, FAR int *len)
+{
+  FAR struct route_lpm_node_s *node = lpm->root;
+  FAR void *route = NULL;
+  unsigned int depth;
+
+  *len = -1;
+
+  for (depth = 0; node != NULL && depth <= lpm->keybits; depth++)
+    {
+      if (node->len > lpm->keybits ||
+          lpm_common(node->key, key, node->len) < node->len)
+        {
+          break;
+        }
+
+      if (node->route != NULL)
+        {
+          route = node->route;
+          *len  = node->len;
+        }
+
+      if (node->len >= lpm->keybits)
+        {
+          break;
+        }
+
+      node = node->child[lpm_bit(key, node->len)];
+    }
+
+  return route;
+}
+
+/****************************************************************************
+ * Name: lpm_ipv4_index
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+static void lpm_ipv4_index(FAR struct net_route_ipv4_s *route)
+{
+  uint32_t mask = NTOHL(route->netmask);
+
+  /* A netmask with intermixed 1's and 0's is not a prefix */
+
+  if ((~mask & (~mask + 1)) != 0 ||
+      lpm_insert(&g_ipv4_lpm, (FAR const uint8_t *)&route->target,
+                 net_ipv4_mask2pref(route->netmask), route) < 0)
+    {
+      nwarn("WARNING: IPv4 route not indexed\n");
+      g_ipv4_lpm.nunindexed++;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: lpm_ipv6_index
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+static void lpm_ipv6_index(FAR struct net_route_ipv6_s *route)
+{
+  net_ipv6addr_t mask;
+  uint8_t preflen = net_ipv6_mask2pref(route->netmask);
+
+  /* A netmask with intermixed 1's and 0's is not a prefix */
+
+  net_ipv6_pref2mask(mask, preflen);
+  if (!net_ipv6addr_cmp(mask, route->netmask) ||
+      lpm_insert(&g_ipv6_lpm, (FAR const uint8_t *)route->target,
+                 preflen, route) < 0)
+    {
+      nwarn("WARNING: IPv6 route not indexed\n");
+      g_ipv6_lpm.nunindexed++;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_lpmroute
+ *
+ * Description:
+ *   Initialize the longest prefix match tries of the RAM routing tables.
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+void net_init_lpmroute(void)
+{
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+  lpm_init(&g_ipv4_lpm, g_ipv4_lpmnodes, LPM_IPv4_NODES, 32);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+  lpm_init(&g_ipv6_lpm, g_ipv6_lpmnodes, LPM_IPv6_NODES, 128);
+#endif
+}
+
+/****************************************************************************
+ * Name: net_lpm_add_ipv4 and net_lpm_add_ipv6
+ *
+ * Description:
+ *   Index a route that was just added to the RAM routing table.  If the
+ *   same prefix is already indexed, the older route is kept, as the linear
+ *   search would return it first.
+ *
+ * Input Parameters:
+ *   route - The new route
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+void net_lpm_add_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  lpm_write_begin(&g_ipv4_lpm);
+  lpm_ipv4_index(route);
+  lpm_write_end(&g_ipv4_lpm);
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+void net_lpm_add_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  lpm_write_begin(&g_ipv6_lpm);
+  lpm_ipv6_index(route);
+  lpm_write_end(&g_ipv6_lpm);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lpm_rebuild_ipv4 and net_lpm_rebuild_ipv6
+ *
+ * Description:
+ *   Index the RAM routing table again after a route was removed from it.
+ *   Deleting a route is rare, and rebuilding also hands its prefix to the
+ *   next route with the same prefix, if any.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+void net_lpm_rebuild_ipv4(void)
+{
+  FAR struct net_route_ipv4_entry_s *entry;
+
+  lpm_write_begin(&g_ipv4_lpm);
+
+  g_ipv4_lpm.root       = NULL;
+  g_ipv4_lpm.nused      = 0;
+  g_ipv4_lpm.nunindexed = 0;
+
+  for (entry = g_ipv4_routes.head; entry != NULL; entry = entry->flink)
+    {
+      lpm_ipv4_index(&entry->entry);
+    }
+
+  lpm_write_end(&g_ipv4_lpm);
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+void net_lpm_rebuild_ipv6(void)
+{
+  FAR struct net_route_ipv6_entry_s *entry;
+
+  lpm_write_begin(&g_ipv6_lpm);
+
+  g_ipv6_lpm.root       = NULL;
+  g_ipv6_lpm.nused      = 0;
+  g_ipv6_lpm.nunindexed = 0;
+
+  for (entry = g_ipv6_routes.head; entry != NULL; entry = entry->flink)
+    {
+      lpm_ipv6_index(&entry->entry);
+    }
+
+  lpm_write_end(&g_ipv6_lpm);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lpm_router_ipv4 and net_lpm_router_ipv6
+ *
+ * Description:
+ *   Find the router of the longest prefix that matches the target, without
+ *   locking the network.
+ *
+ * Input Parameters:
+ *   target    - An IP address on a remote network to use in the lookup.
+ *   router    - The address of router on a local network that can forward
+ *               our packets to the target.
+ *   prefixlen - Only match prefixes longer than prefixlen.
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no route; -ENOSYS if the table has
+ *   routes that the trie cannot index and must be searched linearly.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+int net_lpm_router_ipv4(in_addr_t target, FAR in_addr_t *router,
+                        int8_t prefixlen)
+{
+  FAR struct net_route_ipv4_s *route;
+  in_addr_t found;
+  unsigned int seq;
+  int len;
+
+  for (; ; )
+    {
+      seq = atomic_load_explicit(&g_ipv4_lpm.seq, memory_order_acquire);
+      if ((seq & 1) != 0)
+        {
+          continue;
+        }
+
+      if (g_ipv4_lpm.nunindexed > 0)
+        {
+          return -ENOSYS;
+        }
+
+      route = lpm_lookup(&g_ipv4_lpm, (FAR const uint8_t *)&target, &len);
+      if (route != NULL)
+        {
+          found = route->router;
+        }
+
+      atomic_thread_fence(memory_order_acquire);
+      if (seq == atomic_load_explicit(&g_ipv4_lpm.seq, memory_order_relaxed))
+        {
+          break;
+        }
+    }
+
+  if (route == NULL || len <= prefixlen)
+    {
+      return -ENOENT;
+    }
+
+  net_ipv4addr_copy(*router, found);
+  return OK;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+int net_lpm_router_ipv6(const net_ipv6addr_t target, net_ipv6addr_t router,
+                        int16_t prefixlen)
+{
+  FAR struct net_route_ipv6_s *route;
+  net_ipv6addr_t found;
+  unsigned int seq;
+  int len;
+
+  for (; ; )
+    {
+      seq = atomic_load_explicit(&g_ipv6_lpm.seq, memory_order_acquire);
+      if ((seq & 1) != 0)
+        {
+          continue;
+        }
+
+      if (g_ipv6_lpm.nunindexed > 0)
+        {
+          return -ENOSYS;
+        }
+
+      route = lpm_lookup(&g_ipv6_lpm, (FAR const uint8_t *)target, &len);
+      if (route != NULL)
+        {
+          net_ipv6addr_copy(found, route->router);
+        }
+
+      atomic_thread_fence(memory_order_acquire);
+      if (seq == atomic_load_explicit(&g_ipv6_lpm.seq, memory_order_relaxed))
+        {
+          break;
+        }
+    }
+
+  if (route == NULL || len <= prefixlen)
+    {
+      return -ENOENT;
+    }
+
+  net_ipv6addr_copy(router, found);
+  return OK;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_LPM */
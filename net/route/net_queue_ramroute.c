@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/rcu.h>
+
 #include "route/ramroute.h"
 #include "route/route.h"
 
@@ -57,13 +59,13 @@ void ramroute_ipv4_addlast(FAR struct net_route_ipv4_entry_s *entry,
   entry->flink = NULL;
   if (!list->head)
     {
-      list->head = entry;
+      rcu_assign_pointer(list->head, entry);
       list->tail = entry;
     }
   else
     {
-      list->tail->flink = entry;
-      list->tail        = entry;
+      rcu_assign_pointer(list->tail->flink, entry);
+      list->tail = entry;
     }
 }
 #endif
@@ -75,13 +77,13 @@ void ramroute_ipv6_addlast(FAR struct net_route_ipv6_entry_s *entry,
   entry->flink = NULL;
   if (!list->head)
     {
-      list->head = entry;
+      rcu_assign_pointer(list->head, entry);
       list->tail = entry;
     }
   else
     {
-      list->tail->flink = entry;
-      list->tail        = entry;
+      rcu_assign_pointer(list->tail->flink, entry);
+      list->tail = entry;
     }
 }
 #endif
@@ -110,13 +112,13 @@ ramroute_ipv4_remfirst(FAR struct net_route_ipv4_queue_s *list)
 
   if (ret)
     {
-      list->head = ret->flink;
+      /* ret->flink is left alone, a reader may still be on ret */
+
+      rcu_assign_pointer(list->head, ret->flink);
       if (!list->head)
         {
           list->tail = NULL;
         }
-
-      ret->flink = NULL;
     }
 
   return ret;
@@ -131,13 +133,13 @@ ramroute_ipv6_remfirst(FAR struct net_route_ipv6_queue_s *list)
 
   if (ret)
     {
-      list->head = ret->flink;
+      /* ret->flink is left alone, a reader may still be on ret */
+
+      rcu_assign_pointer(list->head, ret->flink);
       if (!list->head)
         {
           list->tail = NULL;
         }
-
-      ret->flink = NULL;
     }
 
   return ret;
@@ -170,17 +172,14 @@ ramroute_ipv4_remafter(FAR struct net_route_ipv4_entry_s *entry,
 
   if (list->head && ret)
     {
+      /* ret->flink is left alone, a reader may still be on ret */
+
       if (list->tail == ret)
         {
           list->tail = entry;
-          entry->flink = NULL;
-        }
-      else
-        {
-          entry->flink = ret->flink;
         }
 
-      ret->flink = NULL;
+      rcu_assign_pointer(entry->flink, ret->flink);
     }
 
   return ret;
@@ -196,17 +195,14 @@ ramroute_ipv6_remafter(FAR struct net_route_ipv6_entry_s *entry,
 
   if (list->head && ret)
     {
+      /* ret->flink is left alone, a reader may still be on ret */
+
       if (list->tail == ret)
         {
           list->tail = entry;
-          entry->flink = NULL;
-        }
-      else
-        {
-          entry->flink = ret->flink;
         }
 
-      ret->flink = NULL;
+      rcu_assign_pointer(entry->flink, ret->flink);
     }
 
   return ret;
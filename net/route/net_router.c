@@ -36,6 +36,7 @@
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 #include "utils/utils.h"
 
@@ -264,6 +265,16 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
       return -ENOENT;
     }
 
+#if defined(CONFIG_ROUTE_LPM) && defined(CONFIG_ROUTE_IPv4_RAMROUTE)
+  /* Look up the trie, unless it cannot index every route */
+
+  ret = net_lpm_router_ipv4(target, router, prefixlen);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_match_s));
@@ -358,6 +369,16 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
       return -ENOENT;
     }
 
+#if defined(CONFIG_ROUTE_LPM) && defined(CONFIG_ROUTE_IPv6_RAMROUTE)
+  /* Look up the trie, unless it cannot index every route */
+
+  ret = net_lpm_router_ipv6(target, router, prefixlen);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_match_s));
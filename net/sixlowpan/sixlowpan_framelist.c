@@ -698,26 +698,16 @@ int sixlowpan_queue_frames(FAR struct radio_driver_s *radio,
           qhead->io_pktlen += iob->io_len;
         }
 
-      /* Submit all of the fragments to the MAC.  We send all frames back-
-       * to-back like this to minimize any possible condition where some
-       * frame which is not a fragment from this sequence from intervening.
+      /* Submit the whole train of fragments to the MAC at once.  The radio
+       * queues the list back-to-back, so no frame which is not a fragment
+       * from this sequence can intervene, and the MAC is kicked only once.
        */
 
-      for (iob = qhead; iob != NULL; iob = qhead)
+      ninfo("Submitting %u bytes of fragments\n", qhead->io_pktlen);
+      ret = sixlowpan_frame_submit(radio, &meta, qhead);
+      if (ret < 0)
         {
-          /* Remove the IOB containing the frame from the list */
-
-          qhead         = iob->io_flink;
-          iob->io_flink = NULL;
-
-          /* And submit the frame to the MAC */
-
-          ninfo("Submitting frame\n");
-          ret = sixlowpan_frame_submit(radio, &meta, iob);
-          if (ret < 0)
-            {
-              nerr("ERROR: sixlowpan_frame_submit() failed: %d\n", ret);
-            }
+          nerr("ERROR: sixlowpan_frame_submit() failed: %d\n", ret);
         }
 
       /* Update the datagram TAG value */
@@ -59,6 +59,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <string.h>
 #include <debug.h>
 
@@ -101,6 +102,17 @@ struct sixlowpan_addrcontext_s
   uint8_t prefix[8];
 };
 
+/* The context last found for a prefix.  The source and the destination
+ * prefixes rarely change from packet to packet, so each has its own.
+ */
+
+struct sixlowpan_ctxcache_s
+{
+  bool valid;
+  uint16_t prefix[4];
+  FAR struct sixlowpan_addrcontext_s *context;
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -118,6 +130,15 @@ struct sixlowpan_addrcontext_s
 
 static struct sixlowpan_addrcontext_s
   g_hc06_addrcontexts[CONFIG_NET_6LOWPAN_MAXADDRCONTEXT];
+
+/* The address contexts indexed by their 4-bit number */
+
+static FAR struct sixlowpan_addrcontext_s *g_hc06_bynumber[16];
+
+/* The contexts of the last source and destination prefixes */
+
+static struct sixlowpan_ctxcache_s g_hc06_srccache;
+static struct sixlowpan_ctxcache_s g_hc06_dstcache;
 #endif
 
 /* Pointer to the byte where to write next inline field. */
@@ -204,15 +225,9 @@ static FAR struct sixlowpan_addrcontext_s *
    */
 
 #if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
-  int i;
-
-  for (i = 0; i < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT; i++)
+  if (number < nitems(g_hc06_bynumber))
     {
-      if ((g_hc06_addrcontexts[i].used == 1) &&
-           g_hc06_addrcontexts[i].number == number)
-        {
-          return &g_hc06_addrcontexts[i];
-        }
+      return g_hc06_bynumber[number];
     }
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
 
@@ -227,15 +242,23 @@ static FAR struct sixlowpan_addrcontext_s *
  *
  ****************************************************************************/
 
+#if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
 static FAR struct sixlowpan_addrcontext_s *
-  find_addrcontext_byprefix(FAR const net_ipv6addr_t ipaddr)
+  find_addrcontext_byprefix(FAR const net_ipv6addr_t ipaddr,
+                            FAR struct sixlowpan_ctxcache_s *cache)
 {
-#if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
   int i;
 
-  /* Remove code to avoid warnings and save flash if no address context is
-   * used
-   */
+  /* The prefix of the previous packet is the most likely */
+
+  if (cache->valid && memcmp(cache->prefix, ipaddr, 8) == 0)
+    {
+      return cache->context;
+    }
+
+  memcpy(cache->prefix, ipaddr, 8);
+  cache->valid   = true;
+  cache->context = NULL;
 
   for (i = 0; i < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT; i++)
     {
@@ -250,13 +273,20 @@ static FAR struct sixlowpan_addrcontext_s *
                 NTOHS(ipaddr[6]), NTOHS(ipaddr[7]),
                 g_hc06_addrcontexts[i].number);
 
-          return &g_hc06_addrcontexts[i];
+          cache->context = &g_hc06_addrcontexts[i];
+          break;
         }
     }
-#endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
 
-  return NULL;
+  return cache->context;
 }
+#else
+/* Remove code to avoid warnings and save flash if no address context is
+ * used
+ */
+
+#  define find_addrcontext_byprefix(ipaddr, cache) NULL
+#endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
 
 /****************************************************************************
  * Name: compress_ipaddr, compress_tagaddr, and compress_laddr
@@ -594,9 +624,7 @@ static void uncompress_addr(FAR const struct netdev_varaddr_s *addr,
 void sixlowpan_hc06_initialize(void)
 {
 #if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
-#if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 1
   int i;
-#endif
 
   /* Preinitialize any address contexts for better header compression
    * (Saves up to 13 bytes per 6lowpan packet).
@@ -682,6 +710,21 @@ void sixlowpan_hc06_initialize(void)
 #endif /* SIXLOWPAN_CONF_ADDR_CONTEXT_1 */
     }
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 1 */
+
+  /* Index the contexts in use by number for the uncompression */
+
+  for (i = 0; i < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT; i++)
+    {
+      if (g_hc06_addrcontexts[i].used == 1 &&
+          g_hc06_addrcontexts[i].number < nitems(g_hc06_bynumber))
+        {
+          g_hc06_bynumber[g_hc06_addrcontexts[i].number] =
+            &g_hc06_addrcontexts[i];
+        }
+    }
+
+  g_hc06_srccache.valid = false;
+  g_hc06_dstcache.valid = false;
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
 }
 
@@ -773,8 +816,10 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
 
   /* Check if dest address context exists (for allocating third byte) */
 
-  daddrcontext = find_addrcontext_byprefix(ipv6->destipaddr);
-  saddrcontext = find_addrcontext_byprefix(ipv6->srcipaddr);
+  daddrcontext = find_addrcontext_byprefix(ipv6->destipaddr,
+                                           &g_hc06_dstcache);
+  saddrcontext = find_addrcontext_byprefix(ipv6->srcipaddr,
+                                           &g_hc06_srccache);
 
   if (daddrcontext != NULL || saddrcontext != NULL)
     {
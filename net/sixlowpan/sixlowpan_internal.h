@@ -351,7 +351,8 @@ int sixlowpan_frame_hdrlen(FAR struct radio_driver_s *radio,
  * Input Parameters:
  *   radio - Reference to a radio network driver state instance.
  *   meta  - Obfuscated metadata that describes the MAC header
- *   frame - The IOB containing the frame to be submitted.
+ *   frame - The IOB containing the frame to be submitted, or the first of
+ *           a list of frames linked through io_flink.
  *
  * Returned Value:
  *   Zero (OK) is returned on success; otherwise, a negated errno value is
@@ -66,10 +66,50 @@ static FAR struct sixlowpan_reassbuf_s *g_active_reass;
 static struct sixlowpan_reassbuf_s
               g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF];
 
+/* The active reassembly buffers hashed by source address and tag */
+
+static FAR struct sixlowpan_reassbuf_s *
+              g_reass_hash[CONFIG_NET_6LOWPAN_REASS_NHASH];
+
+/* The time at which the earliest active reassembly expires */
+
+static clock_t g_reass_expire;
+
+#if !defined(CONFIG_NET_6LOWPAN_REASS_STATIC) && \
+    CONFIG_NET_6LOWPAN_REASS_MAXDYNAMIC > 0
+/* Number of dynamically allocated reassembly buffers */
+
+static unsigned int g_reass_ndynamic;
+#endif
+
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sixlowpan_reass_hash
+ *
+ * Description:
+ *   Return the hash table index of the reassembly of a tag and a source
+ *   address.
+ *
+ ****************************************************************************/
+
+static unsigned int
+sixlowpan_reass_hash(uint16_t reasstag,
+                     FAR const struct netdev_varaddr_s *fragsrc)
+{
+  unsigned int hash = reasstag;
+  int i;
+
+  for (i = 0; i < fragsrc->nv_addrlen; i++)
+    {
+      hash = hash * 31 + fragsrc->nv_addr[i];
+    }
+
+  return hash % CONFIG_NET_6LOWPAN_REASS_NHASH;
+}
+
 /****************************************************************************
  * Name: sixlowpan_compare_fragsrc
  *
@@ -123,7 +163,20 @@ static void sixlowpan_reass_expire(void)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
   FAR struct sixlowpan_reassbuf_s *next;
-  clock_t elapsed;
+  clock_t expire;
+  clock_t now;
+
+  /* Nothing can have expired before the earliest expiration.  Inactive
+   * buffers are skipped by the lookups in the meantime.
+   */
+
+  now = clock_systime_ticks();
+  if (g_active_reass == NULL || (sclock_t)(now - g_reass_expire) < 0)
+    {
+      return;
+    }
+
+  g_reass_expire = now + NET_6LOWPAN_TIMEOUT;
 
   /* If reassembly timed out, cancel it */
 
@@ -143,19 +196,109 @@ static void sixlowpan_reass_expire(void)
         }
       else
         {
-          /* Get the elpased time of the reassembly */
-
-          elapsed = clock_systime_ticks() - reass->rb_time;
-
           /* If the reassembly has expired, then free the reassembly buffer */
 
-          if (elapsed >= NET_6LOWPAN_TIMEOUT)
+          expire = reass->rb_time + NET_6LOWPAN_TIMEOUT;
+          if ((sclock_t)(now - expire) >= 0)
             {
               nwarn("WARNING: Reassembly timed out\n");
               sixlowpan_reass_free(reass);
             }
+          else if ((sclock_t)(expire - g_reass_expire) < 0)
+            {
+              g_reass_expire = expire;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: sixlowpan_reass_oldest
+ *
+ * Description:
+ *   Return the reassembly buffer to drop when none is left: an inactive
+ *   one if any, otherwise the oldest reassembly in progress.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static FAR struct sixlowpan_reassbuf_s *sixlowpan_reass_oldest(void)
+{
+  FAR struct sixlowpan_reassbuf_s *oldest = g_active_reass;
+  FAR struct sixlowpan_reassbuf_s *reass;
+
+  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+    {
+      if (!reass->rb_active)
+        {
+          return reass;
         }
+
+      if ((sclock_t)(reass->rb_time - oldest->rb_time) < 0)
+        {
+          oldest = reass;
+        }
+    }
+
+  return oldest;
+}
+
+/****************************************************************************
+ * Name: sixlowpan_reass_get
+ *
+ * Description:
+ *   Take a reassembly buffer from the free list or, failing that, from the
+ *   heap within CONFIG_NET_6LOWPAN_REASS_MAXDYNAMIC.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static FAR struct sixlowpan_reassbuf_s *
+  sixlowpan_reass_get(FAR uint8_t *pool)
+{
+  FAR struct sixlowpan_reassbuf_s *reass;
+
+  /* Try the free list first */
+
+  if (g_free_reass != NULL)
+    {
+      reass         = g_free_reass;
+      g_free_reass  = reass->rb_flink;
+      *pool         = REASS_POOL_PREALLOCATED;
+      return reass;
+    }
+
+#ifdef CONFIG_NET_6LOWPAN_REASS_STATIC
+  return NULL;
+#else
+#  if CONFIG_NET_6LOWPAN_REASS_MAXDYNAMIC > 0
+  if (g_reass_ndynamic >= CONFIG_NET_6LOWPAN_REASS_MAXDYNAMIC)
+    {
+      return NULL;
+    }
+#  endif
+
+  /* If we cannot get a reassembly buffer instance from the free list,
+   * then we will have to allocate one from the kernel memory pool.
+   */
+
+  reass = (FAR struct sixlowpan_reassbuf_s *)
+    kmm_malloc((sizeof (struct sixlowpan_reassbuf_s)));
+  *pool = REASS_POOL_DYNAMIC;
+
+#  if CONFIG_NET_6LOWPAN_REASS_MAXDYNAMIC > 0
+  if (reass != NULL)
+    {
+      g_reass_ndynamic++;
     }
+#  endif
+
+  return reass;
+#endif
 }
 
 /****************************************************************************
@@ -177,9 +320,28 @@ static void sixlowpan_reass_expire(void)
 
 static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
+  FAR struct sixlowpan_reassbuf_s **link;
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
 
+  /* Buffers provided by the radio are never hashed */
+
+  if (reass->rb_pool != REASS_POOL_RADIO)
+    {
+      link = &g_reass_hash[sixlowpan_reass_hash(reass->rb_reasstag,
+                                                &reass->rb_fragsrc)];
+      for (; *link != NULL; link = &(*link)->rb_hlink)
+        {
+          if (*link == reass)
+            {
+              *link = reass->rb_hlink;
+              break;
+            }
+        }
+
+      reass->rb_hlink = NULL;
+    }
+
   /* Find the reassembly buffer in the list of active reassembly buffers */
 
   for (prev = NULL, curr = g_active_reass;
@@ -282,6 +444,7 @@ FAR struct sixlowpan_reassbuf_s *
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
+  unsigned int hash;
   uint8_t pool;
 
   /* First, removed any expired or inactive reassembly buffers.  This might
@@ -290,27 +453,16 @@ FAR struct sixlowpan_reassbuf_s *
 
   sixlowpan_reass_expire();
 
-  /* Now, try the free list first */
+  /* Get a buffer.  If none is left, the oldest reassembly is unlikely to
+   * complete, so it is dropped in favor of the new one.
+   */
 
-  if (g_free_reass != NULL)
-    {
-      reass         = g_free_reass;
-      g_free_reass  = reass->rb_flink;
-      pool          = REASS_POOL_PREALLOCATED;
-    }
-  else
+  reass = sixlowpan_reass_get(&pool);
+  if (reass == NULL && g_active_reass != NULL)
     {
-#ifdef CONFIG_NET_6LOWPAN_REASS_STATIC
-      reass         = NULL;
-#else
-      /* If we cannot get a reassembly buffer instance from the free list,
-       * then we will have to allocate one from the kernel memory pool.
-       */
-
-      reass = (FAR struct sixlowpan_reassbuf_s *)
-        kmm_malloc((sizeof (struct sixlowpan_reassbuf_s)));
-      pool  = REASS_POOL_DYNAMIC;
-#endif
+      nwarn("WARNING: Dropping the oldest reassembly\n");
+      sixlowpan_reass_free(sixlowpan_reass_oldest());
+      reass = sixlowpan_reass_get(&pool);
     }
 
   /* We have successfully allocated memory from some source? */
@@ -326,10 +478,23 @@ FAR struct sixlowpan_reassbuf_s *
       reass->rb_reasstag = reasstag;
       reass->rb_time     = clock_systime_ticks();
 
+      /* It expires last, unless it is the only one */
+
+      if (g_active_reass == NULL)
+        {
+          g_reass_expire = reass->rb_time + NET_6LOWPAN_TIMEOUT;
+        }
+
       /* Add the reassembly buffer to the list of active reassembly buffers */
 
       reass->rb_flink   = g_active_reass;
       g_active_reass    = reass;
+
+      /* And to its hash chain */
+
+      hash = sixlowpan_reass_hash(reasstag, fragsrc);
+      reass->rb_hlink = g_reass_hash[hash];
+      g_reass_hash[hash] = reass;
     }
 
   return reass;
@@ -367,17 +532,18 @@ FAR struct sixlowpan_reassbuf_s *
   sixlowpan_reass_expire();
 
   /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
+   * reassembly buffers with the same hash.
    */
 
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  for (reass = g_reass_hash[sixlowpan_reass_hash(reasstag, fragsrc)];
+       reass != NULL; reass = reass->rb_hlink)
     {
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
        * reassembly tag).
        */
 
-      if (reass->rb_reasstag == reasstag &&
+      if (reass->rb_active && reass->rb_reasstag == reasstag &&
           sixlowpan_compare_fragsrc(reass, fragsrc))
         {
           return reass;
@@ -436,6 +602,9 @@ void sixlowpan_reass_free(FAR struct sixlowpan_reassbuf_s *reass)
       /* Otherwise, deallocate it. */
 
       kmm_free(reass);
+#  if CONFIG_NET_6LOWPAN_REASS_MAXDYNAMIC > 0
+      g_reass_ndynamic--;
+#  endif
 #endif
     }
 
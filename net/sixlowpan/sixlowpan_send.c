@@ -155,7 +155,7 @@ end_wait:
 
   /* Do not allow any further callbacks */
 
-  sinfo->s_cb->flags   = 0;
+  devif_callback_setflags(sinfo->s_cb, 0);
   sinfo->s_cb->priv    = NULL;
   sinfo->s_cb->event   = NULL;
 
@@ -239,7 +239,7 @@ int sixlowpan_send(FAR struct net_driver_s *dev,
 
           /* Set up the callback in the connection */
 
-          sinfo.s_cb->flags = (NETDEV_DOWN | WPAN_POLL);
+          devif_callback_setflags(sinfo.s_cb, NETDEV_DOWN | WPAN_POLL);
           sinfo.s_cb->priv  = (FAR void *)&sinfo;
           sinfo.s_cb->event = send_eventhandler;
 
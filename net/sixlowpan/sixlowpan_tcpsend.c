@@ -537,7 +537,7 @@ end_wait:
 
   /* Do not allow any further callbacks */
 
-  sinfo->s_cb->flags   = 0;
+  devif_callback_setflags(sinfo->s_cb, 0);
   sinfo->s_cb->priv    = NULL;
   sinfo->s_cb->event   = NULL;
 
@@ -627,8 +627,9 @@ static int sixlowpan_send_packet(FAR struct socket *psock,
 
           /* Set up the callback in the connection */
 
-          sinfo.s_cb->flags = (NETDEV_DOWN | TCP_ACKDATA | TCP_REXMIT |
-                               TCP_DISCONN_EVENTS | WPAN_POLL);
+          devif_callback_setflags(sinfo.s_cb, NETDEV_DOWN | TCP_ACKDATA |
+                                              TCP_REXMIT | WPAN_POLL |
+                                              TCP_DISCONN_EVENTS);
           sinfo.s_cb->priv  = (FAR void *)&sinfo;
           sinfo.s_cb->event = tcp_send_eventhandler;
 
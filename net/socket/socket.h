@@ -65,10 +65,11 @@
 #define _SO_TYPE         _SO_BIT(SO_TYPE)
 #define _SO_TIMESTAMP    _SO_BIT(SO_TIMESTAMP)
 #define _SO_BINDTODEVICE _SO_BIT(SO_BINDTODEVICE)
+#define _SO_REUSEPORT    _SO_BIT(SO_REUSEPORT)
 
 /* This is the largest option value.  REVISIT: belongs in sys/socket.h */
 
-#define _SO_MAXOPT       (18)
+#define _SO_MAXOPT       (19)
 
 /* Macros to set, test, clear options */
 
@@ -122,6 +123,18 @@
 #  define _SO_SETERRNO(s,e)
 #endif /* CONFIG_NET_SOCKOPTS */
 
+/* recvmmsg() and sendmmsg() hold the network lock across a whole batch
+ * for the families whose waits release it through net_sem_wait().
+ */
+
+#ifndef CONFIG_NET_LOCK_SPLIT
+#  define _SS_BATCHLOCK(s) \
+    ((s)->s_domain == PF_INET || (s)->s_domain == PF_INET6 || \
+     (s)->s_domain == PF_CAN || (s)->s_domain == PF_PACKET)
+#else
+#  define _SS_BATCHLOCK(s) (false)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
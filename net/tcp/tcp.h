@@ -31,6 +31,7 @@
 
 #include <sys/types.h>
 
+#include <nuttx/nuttx.h>
 #include <nuttx/clock.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
@@ -66,6 +67,32 @@
 #define tcp_callback_free(conn,cb) \
   devif_conn_callback_free((conn)->dev, (cb), &(conn)->sconn.list, &(conn)->sconn.list_tail)
 
+/* The sender keeps a scoreboard of the SACKed ranges and recovers the lost
+ * segments from it (RFC 6675) when both SACK and write buffering are in use.
+ */
+
+#if defined(CONFIG_NET_TCP_SELECTIVE_ACK) && \
+    defined(CONFIG_NET_TCP_WRITE_BUFFERS)
+#  define NET_TCP_SACK_RECOVERY 1
+
+/* The max count of SACKed ranges kept in the scoreboard */
+
+#  define TCP_SACK_SCOREBOARD_MAX 8
+
+/* The flags of a write buffer in the loss recovery */
+
+#  define TCP_WB_LOST         0x01U /* Holes of the buffer must be resent */
+#  define TCP_WB_REXMIT       0x02U /* The buffer was retransmitted */
+#  define TCP_WB_SACKED       0x04U /* Data of the buffer was SACKed */
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+/* The kinds of the RACK-TLP timer */
+
+#  define TCP_RACK_TIMER_REO  1     /* Reordering window timeout */
+#  define TCP_RACK_TIMER_TLP  2     /* Tail loss probe timeout */
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
 /* TCP write buffer access macros */
 
@@ -77,6 +104,10 @@
 #  define TCP_WBNACK(wrb)            ((wrb)->wb_nack)
 #endif
 #  define TCP_WBIOB(wrb)             ((wrb)->wb_iob)
+#ifdef NET_TCP_SACK_RECOVERY
+#  define TCP_WBFLAGS(wrb)           ((wrb)->wb_flags)
+#  define TCP_WBRXTSEQ(wrb)          ((wrb)->wb_rxtseq)
+#endif
 #  define TCP_WBCOPYOUT(wrb,dest,n)  (iob_copyout(dest,(wrb)->wb_iob,(n),0))
 #  define TCP_WBCOPYIN(wrb,src,n,off) \
      (iob_copyin((wrb)->wb_iob,src,(n),(off),true))
@@ -109,6 +140,8 @@
 #define TCP_WSCALE            0x01U /* Window Scale option enabled */
 #define TCP_SACK              0x02U /* Selective ACKs enabled */
 #define TCP_CLOSE_ARRANGED    0x04U /* Connection is arranged to be freed */
+#define TCP_RCVBUF_LOCK       0x20U /* SO_RCVBUF set, no autotuning */
+#define TCP_SNDBUF_LOCK       0x40U /* SO_SNDBUF set, no autotuning */
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
 /* The TCP flags for congestion control */
@@ -131,6 +164,17 @@
 #define TCP_RTO_MAX 240 /* 120s,The unit is half a second */
 #define TCP_RTO_MIN 1   /* 0.5s */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* Map a hash bucket entry back to its connection structure */
+
+#  define TCP_HNODE2CONN(e) \
+    ((e) == NULL ? NULL : container_of(e, struct tcp_conn_s, hnode))
+
+/* Listener hash bucket of a local port number (network byte order) */
+
+#  define TCP_LISTEN_HASH(p) (NTOHS(p) % CONFIG_NET_TCP_CONN_HASH_SIZE)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -180,6 +224,91 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* A congestion control algorithm.  The generic code in tcp_cc.c detects
+ * the losses, runs the fast recovery and measures the RTT; the algorithm
+ * decides how the congestion window grows and shrinks.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;   /* The name used with TCP_CONGESTION */
+
+  /* Reset the private state of the algorithm */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* Grow cwnd when 'acked' bytes of new data are acknowledged outside of
+   * the fast recovery.
+   */
+
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+  /* Return the slow start threshold after a loss */
+
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+
+  /* Optional:  One RTT sample (units: microseconds) and the number of bytes
+   * acknowledged while it was measured, about once per round trip.
+   */
+
+  CODE void (*rtt_sample)(FAR struct tcp_conn_s *conn, uint32_t rtt,
+                          uint32_t delivered);
+
+  /* True if the algorithm sets the pacing rate itself */
+
+  bool pacing;
+};
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* The state of CUBIC (RFC 8312) */
+
+struct tcp_cubic_s
+{
+  uint32_t w_max;         /* cwnd before the last reduction */
+  uint32_t origin;        /* The window at the plateau of the curve */
+  uint32_t k;             /* Time to reach the plateau (units: ms) */
+  uint32_t w_est;         /* The NewReno-friendly window estimate */
+  clock_t  epoch;         /* Start of the congestion avoidance epoch */
+  bool     started;       /* The epoch has started */
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+#  define TCP_BBR_BW_ROUNDS 10
+
+/* The state of BBR */
+
+struct tcp_bbr_s
+{
+  /* Delivery rates of the last rounds (units: bytes per second) */
+
+  uint32_t bw[TCP_BBR_BW_ROUNDS];
+  uint32_t full_bw;        /* The rate at the last growth in STARTUP */
+  uint32_t min_rtt;        /* The minimum RTT (units: microseconds) */
+  clock_t  min_rtt_stamp;  /* The time min_rtt was measured */
+  clock_t  probe_rtt_done; /* The end of PROBE_RTT */
+  uint32_t prior_cwnd;     /* cwnd before PROBE_RTT */
+  uint32_t round;          /* The number of round trips */
+  uint8_t  mode;           /* STARTUP, DRAIN, PROBE_BW or PROBE_RTT */
+  uint8_t  cycle;          /* The phase of the PROBE_BW gain cycle */
+  uint8_t  full_cnt;       /* Rounds without bandwidth growth */
+  bool     filled;         /* The bottleneck bandwidth is reached */
+};
+#endif
+
+union tcp_cc_priv_u
+{
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  struct tcp_cubic_s cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+  struct tcp_bbr_s   bbr;
+#endif
+  uint8_t dummy;
+};
+#endif /* CONFIG_NET_TCP_CC_NEWRENO */
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -213,6 +342,10 @@ struct tcp_conn_s
   /* TCP-specific content follows */
 
   union ip_binding_u u;   /* IP address binding */
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  dq_entry_t hnode;       /* Link in the connection or the listener hash
+                           * bucket.  A connection is never in both. */
+#endif
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
   uint8_t  sndseq[4];     /* The sequence number that was last sent by us */
@@ -230,7 +363,12 @@ struct tcp_conn_s
                            * variable */
   uint8_t  rto;           /* Retransmission time-out */
   uint8_t  tcpstateflags; /* TCP state and flags */
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+  dq_entry_t tnode;       /* Link in the timer wheel slot */
+  clock_t  texpire;       /* Expiration time (ticks), 0 if not armed */
+#else
   struct   work_s work;   /* TCP timer handle */
+#endif
   bool     timeout;       /* Trigger from timer expiry */
   uint8_t  timer;         /* The retransmission timer (units: half-seconds) */
   uint8_t  nrtx;          /* The number of retransmissions for the last
@@ -256,6 +394,23 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  /* The congestion control algorithm and its private state */
+
+  FAR const struct tcp_cc_ops_s *cc_ops;
+  union tcp_cc_priv_u cc_priv;
+  uint32_t cc_delivered;  /* The number of bytes acknowledged so far */
+  uint32_t cc_rttseq;     /* The sequence number timed for the RTT */
+  uint32_t cc_rttdlvd;    /* cc_delivered when the RTT timing started */
+  clock_t  cc_rtttime;    /* The time the RTT timing started */
+  uint32_t cc_srtt;       /* Smoothed RTT (units: microseconds) */
+  bool     cc_rttvalid;   /* The RTT is being timed */
+#endif
+#ifdef CONFIG_NET_TCP_PACING
+  struct work_s pacing_work; /* The pacing timer */
+  uint32_t pacing_rate;      /* Bytes per second, zero if not paced */
+  uint32_t pacing_credit;    /* The bytes that may be sent now */
+  clock_t  pacing_stamp;     /* The time pacing_credit was refilled */
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -275,6 +430,11 @@ struct tcp_conn_s
   int32_t  snd_bufs;      /* Maximum amount of bytes queued in send */
   sem_t    snd_sem;       /* Semaphore signals send completion */
 #endif
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+  uint32_t rcvq_space;    /* Most bytes read by the application in a RTT */
+  uint32_t rcvq_copied;   /* Bytes read since rcvq_time */
+  clock_t  rcvq_time;     /* The start of the current RTT */
+#endif
 #if defined(CONFIG_NET_TCP_WRITE_BUFFERS) || \
     defined(CONFIG_NET_TCP_WINDOW_SCALE)
   uint32_t tx_unacked;    /* Number bytes sent but not yet ACKed */
@@ -301,6 +461,9 @@ struct tcp_conn_s
    */
 
   FAR struct iob_s *readahead;   /* Read-ahead buffering */
+#ifdef CONFIG_NET_LATENCY
+  clock_t rxstamp;               /* perf_gettime() when readahead filled */
+#endif
 
 #ifdef CONFIG_NET_TCP_OUT_OF_ORDER
 
@@ -332,6 +495,45 @@ struct tcp_conn_s
                            * segment (next greater sndseq) */
 #endif
 
+#ifdef NET_TCP_SACK_RECOVERY
+  /* The SACK scoreboard (RFC 6675)
+   *
+   *   sack_sb       - The SACKed ranges above snd_una, sorted and disjoint
+   *   sack_nsb      - The number of ranges in sack_sb
+   *   sack_recovery - True while a loss recovery is in progress
+   *   sack_recover  - The highest sequence sent when the recovery started
+   */
+
+  struct tcp_sack_s sack_sb[TCP_SACK_SCOREBOARD_MAX];
+  uint8_t    sack_nsb;
+  bool       sack_recovery;
+  uint32_t   sack_recover;
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+  /* RACK-TLP time based loss detection (RFC 8985).  All times are in units
+   * of the system clock tick.
+   */
+
+  struct work_s rack_work;    /* The reordering or the probe timer */
+  clock_t    rack_xmittime;   /* Send time of the latest delivered data */
+  uint32_t   rack_endseq;     /* The end sequence of that data */
+  uint32_t   rack_fack;       /* The highest end sequence delivered */
+  clock_t    rack_rtt;        /* The RTT of the latest delivered data */
+  clock_t    rack_minrtt;     /* The minimum RTT seen */
+  clock_t    rack_srtt;       /* The smoothed RTT, scaled by 8 */
+  bool       rack_rttvalid;   /* An RTT was measured */
+  bool       rack_reordering; /* Reordering was seen on the connection */
+  uint8_t    rack_reomult;    /* Extra multiples of the reordering window */
+  uint8_t    rack_reopersist; /* Recoveries before the multiplier resets */
+  uint8_t    rack_timer;      /* The pending timer: TCP_RACK_TIMER_* */
+  bool       rack_fired;      /* The timer expired and must be handled */
+  bool       tlp_inflight;    /* A loss probe is not yet acknowledged */
+  bool       tlp_rexmit;      /* The loss probe was a retransmission */
+  bool       tlp_newdata;     /* Send one segment of new data as a probe */
+  uint32_t   tlp_endseq;      /* snd_nxt when the probe was sent */
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   /* Listen backlog support
    *
@@ -417,6 +619,16 @@ struct tcp_wrbuffer_s
                             * segment sent */
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
   uint8_t    wb_nack;      /* The number of ack count */
+#endif
+#ifdef NET_TCP_SACK_RECOVERY
+  uint8_t    wb_flags;     /* The loss recovery flags: TCP_WB_* */
+  uint32_t   wb_rxtseq;    /* The next sequence number to retransmit */
+#endif
+#ifdef CONFIG_NET_TCP_RACK
+  clock_t    wb_xmittime;  /* The time the buffer was last sent */
+#endif
+#ifdef CONFIG_NET_LATENCY
+  clock_t    wb_stamp;     /* perf_gettime() when send() began */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
@@ -452,6 +664,16 @@ extern "C"
 {
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+extern const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#endif
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+extern const struct tcp_cc_ops_s g_tcp_cc_bbr;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -1043,6 +1265,27 @@ void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout);
 
 void tcp_stop_timer(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_timer_pending
+ *
+ * Description:
+ *   Return true if the TCP timer of the connection is armed.
+ *
+ ****************************************************************************/
+
+bool tcp_timer_pending(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_timer_timeleft
+ *
+ * Description:
+ *   Return the time left (units: ticks) before the TCP timer of the
+ *   connection expires, zero if it is not armed.
+ *
+ ****************************************************************************/
+
+clock_t tcp_timer_timeleft(FAR struct tcp_conn_s *conn);
+
 /****************************************************************************
  * Name: tcp_findlistener
  *
@@ -1063,6 +1306,25 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno);
 #endif
 
+/****************************************************************************
+ * Name: tcp_reuseport_select
+ *
+ * Description:
+ *   Given the listener found for a connection, return the member of its
+ *   SO_REUSEPORT group that handles the connection with the remote address
+ *   in uaddr and the remote port rport.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+FAR struct tcp_conn_s *
+  tcp_reuseport_select(FAR struct tcp_conn_s *listener,
+                       FAR const union ip_binding_u *uaddr, uint16_t rport);
+#endif
+
 /****************************************************************************
  * Name: tcp_unlisten
  *
@@ -1726,6 +1988,123 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
 
 bool tcp_should_send_recvwindow(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_autotune_rcvbuf
+ *
+ * Description:
+ *   Account the data the application just read and grow the receive
+ *   buffer size to twice the most data read in one RTT.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection structure holding connection information.
+ *   copied - The number of bytes read.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_AUTOTUNE) && CONFIG_NET_RECV_BUFSIZE > 0
+void tcp_autotune_rcvbuf(FAR struct tcp_conn_s *conn, uint32_t copied);
+#else
+#  define tcp_autotune_rcvbuf(conn, copied)
+#endif
+
+/****************************************************************************
+ * Name: tcp_autotune_sndbuf
+ *
+ * Description:
+ *   Grow the send buffer size to twice the send window.  Called when an
+ *   ACK is received.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure holding connection information.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_AUTOTUNE) && CONFIG_NET_SEND_BUFSIZE > 0
+void tcp_autotune_sndbuf(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_autotune_sndbuf(conn)
+#endif
+
+/****************************************************************************
+ * Name: tcp_syncookie_conn
+ *
+ * Description:
+ *   Prepare the stand-in connection that answers a SYN with a cookie.  The
+ *   caller may parse the TCP options of the SYN into it before
+ *   tcp_syncookie_synack() is called.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the SYN.
+ *   tcp      - The TCP header of the SYN.
+ *   listener - The listening connection.
+ *
+ * Returned Value:
+ *   The stand-in connection.  It is not allocated from the connection pool
+ *   and is only valid until the network is unlocked.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+FAR struct tcp_conn_s *tcp_syncookie_conn(FAR struct net_driver_s *dev,
+                                          FAR struct tcp_hdr_s *tcp,
+                                          FAR struct tcp_conn_s *listener);
+
+/****************************************************************************
+ * Name: tcp_syncookie_synack
+ *
+ * Description:
+ *   Send the SYN-ACK of a stand-in connection, with a cookie as the initial
+ *   sequence number.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure to use in the send operation.
+ *   conn - The stand-in connection from tcp_syncookie_conn().
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_syncookie_synack(FAR struct net_driver_s *dev,
+                          FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_syncookie_accept
+ *
+ * Description:
+ *   Check if an ACK to a listening port returns a cookie.  If so, allocate
+ *   the connection in the TCP_SYN_RCVD state.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the ACK.
+ *   tcp      - The TCP header of the ACK.
+ *   listener - The listening connection.
+ *   accept   - The location to return the new connection.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the ACK does not hold a valid cookie;
+ *   -ENOMEM if no connection is available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_syncookie_accept(FAR struct net_driver_s *dev,
+                         FAR struct tcp_hdr_s *tcp,
+                         FAR struct tcp_conn_s *listener,
+                         FAR struct tcp_conn_s **accept);
+#endif
+
 /****************************************************************************
  * Name: psock_tcp_cansend
  *
@@ -2307,6 +2686,391 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables when the retransmission timer
+ *   expires.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_sent
+ *
+ * Description:
+ *   Start timing the RTT with a segment of new data, unless a segment is
+ *   already timed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   seq    - The sequence number of the segment
+ *   len    - The length of the segment
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_sent(FAR struct tcp_conn_s *conn, uint32_t seq, uint32_t len);
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if the algorithm is not available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name);
+
+/****************************************************************************
+ * Name: tcp_cc_name
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of a connection.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_name(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_slow_start
+ *
+ * Description:
+ *   Grow cwnd by 'acked' bytes, up to one MSS, per ACK (RFC 5681).
+ *
+ ****************************************************************************/
+
+void tcp_cc_slow_start(FAR struct tcp_conn_s *conn, uint32_t acked);
+#endif
+
+#ifdef CONFIG_NET_TCP_PACING
+
+/****************************************************************************
+ * Name: tcp_pacing_limit
+ *
+ * Description:
+ *   Check how much of 'len' bytes the pacing rate allows to send now, and
+ *   consume it.  If nothing can be sent, the pacing timer is started to
+ *   poll the connection again when enough credit has accumulated.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   len    - The number of bytes ready to send
+ *
+ * Returned Value:
+ *   The number of bytes that may be sent now; zero to wait.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_pacing_limit(FAR struct tcp_conn_s *conn, uint32_t len);
+
+/****************************************************************************
+ * Name: tcp_pacing_timer
+ *
+ * Description:
+ *   Poll the connection again after 'ticks' system ticks.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   ticks  - The delay
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_timer(FAR struct tcp_conn_s *conn, clock_t ticks);
+#endif
+
+#ifdef NET_TCP_SACK_RECOVERY
+
+/****************************************************************************
+ * Name: tcp_sack_nextwrb
+ *
+ * Description:
+ *   Walk the outstanding write buffers in sequence order:  The unacked_q,
+ *   then the partially sent head of the write_q.  Start with NULL.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_wrbuffer_s *
+tcp_sack_nextwrb(FAR struct tcp_conn_s *conn,
+                 FAR struct tcp_wrbuffer_s *wrb);
+
+/****************************************************************************
+ * Name: tcp_sack_hole
+ *
+ * Description:
+ *   Find the first range in [*seq, end) that the scoreboard does not
+ *   cover.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   seq  - The start of the search, and the returned start of the hole
+ *   end  - The end of the search
+ *   len  - The returned length of the hole
+ *
+ * Returned Value:
+ *   True if a hole was found.
+ *
+ ****************************************************************************/
+
+bool tcp_sack_hole(FAR struct tcp_conn_s *conn, FAR uint32_t *seq,
+                   uint32_t end, FAR uint32_t *len);
+
+/****************************************************************************
+ * Name: tcp_sack_bytes
+ *
+ * Description:
+ *   Return the number of bytes SACKed above 'seq'.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_sack_bytes(FAR struct tcp_conn_s *conn, uint32_t seq);
+
+/****************************************************************************
+ * Name: tcp_sack_markloss
+ *
+ * Description:
+ *   Mark the holes of a write buffer for retransmission, and enter the
+ *   loss recovery if not yet in it.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_sack_markloss(FAR struct tcp_conn_s *conn,
+                       FAR struct tcp_wrbuffer_s *wrb);
+
+/****************************************************************************
+ * Name: tcp_sack_input
+ *
+ * Description:
+ *   Update the scoreboard with the SACK blocks of a received ACK and
+ *   detect the lost segments.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   tcp   - The TCP header of the ACK
+ *   ackno - The acknowledgement number of the ACK
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_sack_input(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
+                    uint32_t ackno);
+
+/****************************************************************************
+ * Name: tcp_sack_send
+ *
+ * Description:
+ *   Set up the retransmission of 'len' bytes of an outstanding write
+ *   buffer, from the sequence number 'seq'.
+ *
+ * Returned Value:
+ *   The number of bytes set up to be sent; zero or a negated errno value
+ *   if the device could not take them.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_sack_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
+                  FAR struct tcp_wrbuffer_s *wrb, uint32_t seq,
+                  uint32_t len);
+
+/****************************************************************************
+ * Name: tcp_sack_rexmit
+ *
+ * Description:
+ *   Retransmit up to one MSS of the lowest hole of the write buffers that
+ *   are marked lost.
+ *
+ * Returned Value:
+ *   True if the device is used by a retransmission.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_sack_rexmit(FAR struct net_driver_s *dev,
+                     FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_sack_rto
+ *
+ * Description:
+ *   Handle the retransmission timeout with the scoreboard.
+ *
+ * Returned Value:
+ *   True if the holes will be retransmitted from the scoreboard; false if
+ *   the caller must retransmit all the outstanding data.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_sack_rto(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_sack_reset
+ *
+ * Description:
+ *   Clear the scoreboard and the loss marks of the write buffers.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_sack_reset(FAR struct tcp_conn_s *conn);
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+
+/****************************************************************************
+ * Name: tcp_rack_delivered
+ *
+ * Description:
+ *   Update the RACK state with data of a write buffer that was delivered,
+ *   either cumulatively ACKed or newly SACKed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   wrb    - The write buffer with the delivered data
+ *   endseq - The end sequence of the delivered data
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rack_delivered(FAR struct tcp_conn_s *conn,
+                        FAR struct tcp_wrbuffer_s *wrb, uint32_t endseq);
+
+/****************************************************************************
+ * Name: tcp_rack_detect
+ *
+ * Description:
+ *   Mark lost the outstanding write buffers sent long enough before the
+ *   latest delivered data, and start the reordering timer for the others.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rack_detect(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_rack_ack
+ *
+ * Description:
+ *   Process an ACK for the reordering window and the loss probe.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rack_ack(FAR struct tcp_conn_s *conn, uint32_t ackno, bool dsack);
+
+/****************************************************************************
+ * Name: tcp_rack_sent
+ *
+ * Description:
+ *   Record the send time of new data of a write buffer.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rack_sent(FAR struct tcp_conn_s *conn,
+                   FAR struct tcp_wrbuffer_s *wrb);
+
+/****************************************************************************
+ * Name: tcp_rack_timeout
+ *
+ * Description:
+ *   Handle the expired reordering or probe timer from the poll of the
+ *   connection.
+ *
+ * Returned Value:
+ *   True if the device is used by a retransmitted probe.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_rack_timeout(FAR struct net_driver_s *dev,
+                      FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_rack_stop
+ *
+ * Description:
+ *   Stop the reordering and the probe timer of a connection.
+ *
+ ****************************************************************************/
+
+void tcp_rack_stop(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_gso_segment
+ *
+ * Description:
+ *   Cut the TCP super-segment in d_iob in segments of d_gso_size bytes of
+ *   payload, with their own IP and TCP headers and checksums.  The
+ *   segments are queued in dev->d_fragout, like IP fragments, and d_iob
+ *   is released.
+ *
+ * Input Parameters:
+ *   dev - The device with the super-segment in d_iob
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  d_iob and the
+ *   segments are released on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GSO
+int tcp_gso_segment(FAR struct net_driver_s *dev);
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,234 @@
+/****************************************************************************
+ * net/tcp/tcp_autotune.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+#include <sys/param.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_NET_MAX_RECV_BUFSIZE > 0 && \
+    CONFIG_NET_MAX_RECV_BUFSIZE < CONFIG_NET_TCP_AUTOTUNE_MAX_RCVBUF
+#  define TCP_AUTOTUNE_MAX_RCVBUF CONFIG_NET_MAX_RECV_BUFSIZE
+#else
+#  define TCP_AUTOTUNE_MAX_RCVBUF CONFIG_NET_TCP_AUTOTUNE_MAX_RCVBUF
+#endif
+
+#if CONFIG_NET_MAX_SEND_BUFSIZE > 0 && \
+    CONFIG_NET_MAX_SEND_BUFSIZE < CONFIG_NET_TCP_AUTOTUNE_MAX_SNDBUF
+#  define TCP_AUTOTUNE_MAX_SNDBUF CONFIG_NET_MAX_SEND_BUFSIZE
+#else
+#  define TCP_AUTOTUNE_MAX_SNDBUF CONFIG_NET_TCP_AUTOTUNE_MAX_SNDBUF
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_autotune_pressure
+ *
+ * Description:
+ *   Return true if the IOBs, which hold the data of all of the TCP
+ *   buffers, are running out.
+ *
+ ****************************************************************************/
+
+static bool tcp_autotune_pressure(void)
+{
+  return iob_navail(false) * 100 <
+         CONFIG_IOB_NBUFFERS * CONFIG_NET_TCP_AUTOTUNE_PRESSURE;
+}
+
+/****************************************************************************
+ * Name: tcp_autotune_rtt
+ *
+ * Description:
+ *   Return the smoothed RTT of the connection in system ticks, at least
+ *   one.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_RECV_BUFSIZE > 0
+static clock_t tcp_autotune_rtt(FAR struct tcp_conn_s *conn)
+{
+  clock_t rtt;
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+  if (conn->cc_srtt > 0)
+    {
+      rtt = USEC2TICK(conn->cc_srtt);
+    }
+  else
+#endif
+    {
+      /* sa is eight times the RTT in units of the TCP timer */
+
+      rtt = (conn->sa >> 3) * TICK_PER_HSEC;
+    }
+
+  return MAX(rtt, 1);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_autotune_rcvbuf
+ *
+ * Description:
+ *   Account the data the application just read and grow the receive
+ *   buffer size to twice the most data read in one RTT.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection structure holding connection information.
+ *   copied - The number of bytes read.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_RECV_BUFSIZE > 0
+void tcp_autotune_rcvbuf(FAR struct tcp_conn_s *conn, uint32_t copied)
+{
+  clock_t now = clock_systime_ticks();
+  uint32_t space;
+  int32_t bufs;
+
+  if ((conn->flags & TCP_RCVBUF_LOCK) != 0)
+    {
+      return;
+    }
+
+  if (conn->rcvq_time == 0)
+    {
+      conn->rcvq_time = now;
+    }
+
+  conn->rcvq_copied += copied;
+  if (now - conn->rcvq_time < tcp_autotune_rtt(conn))
+    {
+      return;
+    }
+
+  /* One RTT is over, the reader drained space bytes in it */
+
+  space             = conn->rcvq_copied;
+  conn->rcvq_copied = 0;
+  conn->rcvq_time   = now;
+
+  if (tcp_autotune_pressure())
+    {
+      conn->rcvq_space = 0;
+      conn->rcv_bufs   = MIN(conn->rcv_bufs, CONFIG_NET_RECV_BUFSIZE);
+      return;
+    }
+
+  if (space <= conn->rcvq_space)
+    {
+      return;
+    }
+
+  /* Twice the data of a RTT, so the sender is not limited by the window
+   * while the reader falls behind during one RTT.
+   */
+
+  conn->rcvq_space = space;
+  bufs = MIN(2 * (uint64_t)space, TCP_AUTOTUNE_MAX_RCVBUF);
+  if (bufs > conn->rcv_bufs)
+    {
+      ninfo("rcv_bufs %" PRId32 " -> %" PRId32 "\n", conn->rcv_bufs, bufs);
+      conn->rcv_bufs = bufs;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_autotune_sndbuf
+ *
+ * Description:
+ *   Grow the send buffer size to twice the send window.  Called when an
+ *   ACK is received.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure holding connection information.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_SEND_BUFSIZE > 0
+void tcp_autotune_sndbuf(FAR struct tcp_conn_s *conn)
+{
+  uint32_t wnd;
+  int32_t bufs;
+
+  if ((conn->flags & TCP_SNDBUF_LOCK) != 0)
+    {
+      return;
+    }
+
+  if (tcp_autotune_pressure())
+    {
+      conn->snd_bufs = MIN(conn->snd_bufs, CONFIG_NET_SEND_BUFSIZE);
+      return;
+    }
+
+  /* Keep a window in flight and the next one queued behind it */
+
+  wnd = conn->snd_wnd;
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+  wnd = MIN(wnd, conn->cwnd);
+#endif
+
+  bufs = MIN(2 * (uint64_t)wnd, TCP_AUTOTUNE_MAX_SNDBUF);
+  if (bufs > conn->snd_bufs)
+    {
+      ninfo("snd_bufs %" PRId32 " -> %" PRId32 "\n", conn->snd_bufs, bufs);
+      conn->snd_bufs = bufs;
+    }
+}
+#endif
+
+#endif /* CONFIG_NET_TCP_AUTOTUNE */
@@ -31,6 +31,7 @@
 #include <debug.h>
 #include <assert.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
@@ -298,6 +299,13 @@ uint16_t tcp_callback(FAR struct net_driver_s *dev,
    *                 not set, then dev->d_len should also be cleared).
    */
 
+#ifdef CONFIG_NET_LATENCY
+  if ((flags & TCP_NEWDATA) != 0)
+    {
+      net_latency_input(dev, &conn->sconn);
+    }
+#endif
+
   flags = devif_conn_event(dev, flags, conn->sconn.list);
 
   /* There may be no new data handler in place at them moment that the new
@@ -402,6 +410,15 @@ uint16_t tcp_datahandler(FAR struct net_driver_s *dev,
 
   buflen = iob->io_pktlen;
 
+#ifdef CONFIG_NET_LATENCY
+  /* The receive latency is that of the oldest byte buffered */
+
+  if (conn->readahead == NULL)
+    {
+      conn->rxstamp = perf_gettime();
+    }
+#endif
+
   /* Concat the iob to readahead */
 
   net_iob_concat(&conn->readahead, &iob);
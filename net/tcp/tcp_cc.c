@@ -24,8 +24,14 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+
 #include "tcp/tcp.h"
 
 /****************************************************************************
@@ -74,10 +80,206 @@
     } \
  } while(0)
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_newreno_init(FAR struct tcp_conn_s *conn);
+static void tcp_newreno_cong_avoid(FAR struct tcp_conn_s *conn,
+                                   uint32_t acked);
+static uint32_t tcp_newreno_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "newreno",              /* name */
+  tcp_newreno_init,       /* init */
+  tcp_newreno_cong_avoid, /* cong_avoid */
+  tcp_newreno_ssthresh,   /* ssthresh */
+  NULL,                   /* rtt_sample */
+  false                   /* pacing */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The algorithms that TCP_CONGESTION may select */
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc_algs[] =
+{
+  &g_tcp_cc_newreno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+  &g_tcp_cc_bbr,
+#endif
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_newreno_init
+ ****************************************************************************/
+
+static void tcp_newreno_init(FAR struct tcp_conn_s *conn)
+{
+  /* NewReno has no private state */
+}
+
+/****************************************************************************
+ * Name: tcp_newreno_cong_avoid
+ ****************************************************************************/
+
+static void tcp_newreno_cong_avoid(FAR struct tcp_conn_s *conn,
+                                   uint32_t acked)
+{
+  uint32_t increase;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      tcp_cc_slow_start(conn, acked);
+    }
+  else
+    {
+      /* cong avoid (RFC 5681):
+       * Grow cwnd linearly by approximately maxseg per RTT using
+       * maxseg^2 / cwnd per ACK as the increment.
+       * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
+       * avoid capping cwnd.
+       */
+
+      increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+      CC_CWND_INC(conn->cwnd, increase);
+      conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+      ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_newreno_ssthresh
+ ****************************************************************************/
+
+static uint32_t tcp_newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  /* ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681 */
+
+  return MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_find
+ *
+ * Description:
+ *   Find an algorithm by its name.
+ *
+ ****************************************************************************/
+
+static FAR const struct tcp_cc_ops_s *tcp_cc_find(FAR const char *name)
+{
+  int i;
+
+  for (i = 0; i < nitems(g_tcp_cc_algs); i++)
+    {
+      if (strcmp(g_tcp_cc_algs[i]->name, name) == 0)
+        {
+          return g_tcp_cc_algs[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_default
+ *
+ * Description:
+ *   Return the algorithm of the sockets that do not select one.
+ *
+ ****************************************************************************/
+
+static FAR const struct tcp_cc_ops_s *tcp_cc_default(void)
+{
+  FAR const struct tcp_cc_ops_s *ops;
+
+  ops = tcp_cc_find(CONFIG_NET_TCP_CC_DEFAULT);
+  return ops != NULL ? ops : &g_tcp_cc_newreno;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_rtt
+ *
+ * Description:
+ *   Take the RTT sample when the timed segment is acknowledged.
+ *
+ ****************************************************************************/
+
+static void tcp_cc_rtt(FAR struct tcp_conn_s *conn, uint32_t ackno)
+{
+  clock_t elapsed;
+  uint32_t rtt;
+
+  if (!conn->cc_rttvalid || TCP_SEQ_LT(ackno, conn->cc_rttseq))
+    {
+      return;
+    }
+
+  conn->cc_rttvalid = false;
+
+  /* An RTT shorter than a tick is counted as half of a tick */
+
+  elapsed = clock_systime_ticks() - conn->cc_rtttime;
+  rtt     = elapsed > 0 ? TICK2USEC(elapsed) : USEC_PER_TICK / 2;
+
+  if (conn->cc_srtt == 0)
+    {
+      conn->cc_srtt = rtt;
+    }
+  else
+    {
+      conn->cc_srtt = conn->cc_srtt - (conn->cc_srtt >> 3) + (rtt >> 3);
+    }
+
+  if (conn->cc_ops->rtt_sample != NULL)
+    {
+      conn->cc_ops->rtt_sample(conn, rtt,
+                               conn->cc_delivered - conn->cc_rttdlvd);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_pacing
+ *
+ * Description:
+ *   Pace the algorithms that do not set a rate themselves at twice cwnd per
+ *   RTT in slow start and 1.2 times cwnd per RTT in congestion avoidance.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_PACING
+static void tcp_cc_pacing(FAR struct tcp_conn_s *conn)
+{
+  uint64_t rate;
+
+  if (conn->cc_ops->pacing || conn->cc_srtt == 0)
+    {
+      return;
+    }
+
+  rate = (uint64_t)conn->cwnd * USEC_PER_SEC / conn->cc_srtt;
+  rate = conn->cwnd < conn->ssthresh ? rate * 2 : rate * 6 / 5;
+
+  conn->pacing_rate = MIN(rate, UINT32_MAX);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -103,6 +305,13 @@
 
 void tcp_cc_init(FAR struct tcp_conn_s *conn)
 {
+  /* Use the algorithm selected with TCP_CONGESTION, if any */
+
+  if (conn->cc_ops == NULL)
+    {
+      conn->cc_ops = tcp_cc_default();
+    }
+
   CC_INIT_CWND(conn->cwnd, conn->mss);
 
   /* RFC 5681 recommends setting ssthresh arbitrarily high and
@@ -117,6 +326,17 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
   conn->ssthresh = 2 * TCP_IPV4_DEFAULT_MSS;
   conn->dupacks = 0;
+
+  conn->cc_delivered = 0;
+  conn->cc_srtt      = 0;
+  conn->cc_rttvalid  = false;
+#ifdef CONFIG_NET_TCP_PACING
+  conn->pacing_rate   = 0;
+  conn->pacing_credit = 0;
+  conn->pacing_stamp  = clock_systime_ticks();
+#endif
+
+  conn->cc_ops->init(conn);
 }
 
 /****************************************************************************
@@ -140,19 +360,22 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
 void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 {
-  /* After Fast retransmitted, set ssthresh to the maximum of
-   * the unacked and the 2*SMSS, and enter to Fast Recovery.
-   * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+  /* After Fast retransmitted, set ssthresh as the algorithm decides, and
+   * enter to Fast Recovery.
    * cwnd=ssthresh + 3*SMSS  referring to rfc5681
    */
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->ssthresh = conn->cc_ops->ssthresh(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
       conn->flags &= ~TCP_INFT;
       conn->flags |= TCP_INFR;
+
+      /* Karn's algorithm: Do not time the retransmitted data */
+
+      conn->cc_rttvalid = false;
     }
 
   /* Update the cc parameters in the TCP_SYN_RCVD and TCP_SYN_SENT states
@@ -243,6 +466,9 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
       conn->dupacks = 0;
       conn->last_ackno = ackno;
 
+      conn->cc_delivered += acked;
+      tcp_cc_rtt(conn, ackno);
+
       /* When the ackno covers more than the fr_recover, exit the
        * fast recovery. Then, reset the "IN Fast Recovery" flags.
        * Also reset the congestion window to the slow start threshold.
@@ -269,34 +495,220 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
       if (conn->tcpstateflags >= TCP_ESTABLISHED)
         {
-          uint32_t increase;
+          conn->cc_ops->cong_avoid(conn, acked);
+        }
 
-          if (conn->cwnd < conn->ssthresh)
-            {
-              /* slow start (RFC 5681):
-               * Grow cwnd exponentially by maxseg(smss) per ACK.
-               */
+#ifdef CONFIG_NET_TCP_PACING
+      tcp_cc_pacing(conn);
+#endif
+    }
+}
 
-              increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables when the retransmission timer
+ *   expires.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-              CC_CWND_INC(conn->cwnd, increase);
-              ninfo("update slow start cwnd to %u\n", conn->cwnd);
-            }
-          else
-            {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
 
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+  conn->flags &= ~TCP_INFR;
 
-              CC_CWND_INC(conn->cwnd, increase);
-              conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
-              ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
-            }
+  /* update the max_cwnd */
+
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+
+  /* reset cwnd and ssthresh, refers to RFC5861. */
+
+  conn->ssthresh = conn->cc_ops->ssthresh(conn);
+  conn->cwnd = conn->mss;
+
+  /* Karn's algorithm: Do not time the retransmitted data */
+
+  conn->cc_rttvalid = false;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_sent
+ *
+ * Description:
+ *   Start timing the RTT with a segment of new data, unless a segment is
+ *   already timed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   seq    - The sequence number of the segment
+ *   len    - The length of the segment
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_sent(FAR struct tcp_conn_s *conn, uint32_t seq, uint32_t len)
+{
+  if (!conn->cc_rttvalid && len > 0)
+    {
+      conn->cc_rttvalid = true;
+      conn->cc_rttseq   = seq + len;
+      conn->cc_rttdlvd  = conn->cc_delivered;
+      conn->cc_rtttime  = clock_systime_ticks();
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection.  The window
+ *   of a connected socket is kept, only the state of the algorithm is
+ *   reset.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if the algorithm is not available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name)
+{
+  FAR const struct tcp_cc_ops_s *ops = tcp_cc_find(name);
+
+  if (ops == NULL)
+    {
+      return -ENOENT;
+    }
+
+  if (ops != conn->cc_ops)
+    {
+      conn->cc_ops = ops;
+      ops->init(conn);
+#ifdef CONFIG_NET_TCP_PACING
+      conn->pacing_rate = 0;
+#endif
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_name
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of a connection.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_name(FAR struct tcp_conn_s *conn)
+{
+  return conn->cc_ops != NULL ? conn->cc_ops->name : tcp_cc_default()->name;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_slow_start
+ *
+ * Description:
+ *   Grow cwnd by 'acked' bytes, up to one MSS, per ACK (RFC 5681).
+ *
+ ****************************************************************************/
+
+void tcp_cc_slow_start(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+
+  CC_CWND_INC(conn->cwnd, increase);
+  ninfo("update slow start cwnd to %u\n", conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_limit
+ *
+ * Description:
+ *   Check how much of 'len' bytes the pacing rate allows to send now, and
+ *   consume it.  The credit accumulates at the pacing rate, up to a burst
+ *   of two ticks (or two segments), and at least one segment must be
+ *   available to send.  Otherwise, the pacing timer is started to poll the
+ *   connection again when it is.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   len    - The number of bytes ready to send
+ *
+ * Returned Value:
+ *   The number of bytes that may be sent now; zero to wait.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_PACING
+uint32_t tcp_pacing_limit(FAR struct tcp_conn_s *conn, uint32_t len)
+{
+  clock_t now = clock_systime_ticks();
+  clock_t elapsed = now - conn->pacing_stamp;
+  uint64_t credit;
+  uint32_t burst;
+  uint32_t need;
+
+  if (conn->pacing_rate == 0 || len == 0)
+    {
+      return len;
+    }
+
+  burst = MAX(conn->pacing_rate / TICK_PER_SEC * 2, 2 * conn->mss);
+  if (elapsed >= TICK_PER_SEC)
+    {
+      credit = burst;
+    }
+  else
+    {
+      credit = conn->pacing_credit +
+               (uint64_t)conn->pacing_rate * elapsed / TICK_PER_SEC;
+      credit = MIN(credit, burst);
+    }
+
+  conn->pacing_stamp = now;
+
+  need = MIN(len, conn->mss);
+  if (credit < need)
+    {
+      conn->pacing_credit = credit;
+      tcp_pacing_timer(conn, MAX(((uint64_t)(need - credit) *
+                                  TICK_PER_SEC + conn->pacing_rate - 1) /
+                                 conn->pacing_rate, 1));
+      return 0;
+    }
+
+  /* Send whole segments if the credit does not cover all of the data */
+
+  if (len > credit)
+    {
+      len = credit;
+      if (len > conn->mss)
+        {
+          len -= len % conn->mss;
         }
     }
+
+  conn->pacing_credit = credit - len;
+  return len;
 }
+#endif
@@ -0,0 +1,329 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_bbr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The modes of BBR */
+
+#define BBR_STARTUP       0  /* Grow the rate exponentially */
+#define BBR_DRAIN         1  /* Drain the queue built in STARTUP */
+#define BBR_PROBE_BW      2  /* Cycle the rate around the bandwidth */
+#define BBR_PROBE_RTT     3  /* Drain the queue to measure the RTT */
+
+/* The gains, in units of 1/256 */
+
+#define BBR_UNIT          256
+#define BBR_HIGH_GAIN     739  /* 2 / ln(2) */
+#define BBR_DRAIN_GAIN    89   /* 1 / BBR_HIGH_GAIN */
+#define BBR_CWND_GAIN     512
+
+#define BBR_CYCLE_LEN     8
+
+/* STARTUP ends when the bandwidth has not grown by 25% in 3 rounds */
+
+#define BBR_FULL_BW_CNT   3
+
+/* min_rtt is measured again in PROBE_RTT if it is 10 seconds old */
+
+#define BBR_MIN_RTT_TICKS SEC2TICK(10)
+#define BBR_PROBE_RTT_TICKS MSEC2TICK(200)
+
+#define BBR_MIN_CWND(conn) (4 * (uint32_t)(conn)->mss)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_bbr_init(FAR struct tcp_conn_s *conn);
+static void tcp_bbr_cong_avoid(FAR struct tcp_conn_s *conn,
+                               uint32_t acked);
+static uint32_t tcp_bbr_ssthresh(FAR struct tcp_conn_s *conn);
+static void tcp_bbr_rtt_sample(FAR struct tcp_conn_s *conn, uint32_t rtt,
+                               uint32_t delivered);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_bbr =
+{
+  "bbr",                  /* name */
+  tcp_bbr_init,           /* init */
+  tcp_bbr_cong_avoid,     /* cong_avoid */
+  tcp_bbr_ssthresh,       /* ssthresh */
+  tcp_bbr_rtt_sample,     /* rtt_sample */
+  true                    /* pacing */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The pacing gains of the PROBE_BW cycle:  Probe for more bandwidth, drain
+ * the queue this made, then cruise at the estimated bandwidth.
+ */
+
+static const uint16_t g_bbr_cycle_gain[BBR_CYCLE_LEN] =
+{
+  BBR_UNIT * 5 / 4, BBR_UNIT * 3 / 4, BBR_UNIT, BBR_UNIT,
+  BBR_UNIT, BBR_UNIT, BBR_UNIT, BBR_UNIT
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_bbr_bw
+ *
+ * Description:
+ *   Return the bottleneck bandwidth:  The maximum delivery rate of the last
+ *   rounds.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_bbr_bw(FAR struct tcp_bbr_s *bbr)
+{
+  uint32_t bw = 0;
+  int i;
+
+  for (i = 0; i < TCP_BBR_BW_ROUNDS; i++)
+    {
+      bw = MAX(bw, bbr->bw[i]);
+    }
+
+  return bw;
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_bdp
+ *
+ * Description:
+ *   Return the bandwidth-delay product, multiplied by 'gain'.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_bbr_bdp(FAR struct tcp_bbr_s *bbr, uint32_t gain)
+{
+  uint64_t bdp;
+
+  if (bbr->min_rtt == UINT32_MAX)
+    {
+      return 0;
+    }
+
+  bdp = (uint64_t)tcp_bbr_bw(bbr) * bbr->min_rtt / USEC_PER_SEC;
+  return MIN(bdp * gain / BBR_UNIT, UINT32_MAX);
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_pacing_gain
+ ****************************************************************************/
+
+static uint32_t tcp_bbr_pacing_gain(FAR struct tcp_bbr_s *bbr)
+{
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+        return BBR_HIGH_GAIN;
+
+      case BBR_DRAIN:
+        return BBR_DRAIN_GAIN;
+
+      case BBR_PROBE_BW:
+        return g_bbr_cycle_gain[bbr->cycle];
+
+      default:
+        return BBR_UNIT;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_init
+ ****************************************************************************/
+
+static void tcp_bbr_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc_priv.bbr;
+
+  memset(bbr, 0, sizeof(*bbr));
+  bbr->min_rtt       = UINT32_MAX;
+  bbr->min_rtt_stamp = clock_systime_ticks();
+  bbr->mode          = BBR_STARTUP;
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_rtt_sample
+ *
+ * Description:
+ *   Update the model of the path at the end of each round trip and run the
+ *   state machine.
+ *
+ ****************************************************************************/
+
+static void tcp_bbr_rtt_sample(FAR struct tcp_conn_s *conn, uint32_t rtt,
+                               uint32_t delivered)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc_priv.bbr;
+  clock_t now = clock_systime_ticks();
+  uint64_t rate;
+  uint32_t bw;
+  bool expired;
+
+  /* The delivery rate of this round */
+
+  rate = (uint64_t)delivered * USEC_PER_SEC / MAX(rtt, 1);
+  bbr->bw[bbr->round++ % TCP_BBR_BW_ROUNDS] = MIN(rate, UINT32_MAX);
+  bw = tcp_bbr_bw(bbr);
+
+  expired = now - bbr->min_rtt_stamp > BBR_MIN_RTT_TICKS;
+  if (rtt <= bbr->min_rtt || expired)
+    {
+      bbr->min_rtt       = rtt;
+      bbr->min_rtt_stamp = now;
+    }
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+        if (bw >= (uint64_t)bbr->full_bw * 5 / 4)
+          {
+            bbr->full_bw  = bw;
+            bbr->full_cnt = 0;
+          }
+        else if (++bbr->full_cnt >= BBR_FULL_BW_CNT)
+          {
+            bbr->filled = true;
+            bbr->mode   = BBR_DRAIN;
+            ninfo("bbr: bandwidth %" PRIu32 " reached\n", bw);
+          }
+        break;
+
+      case BBR_DRAIN:
+        if (conn->tx_unacked <= tcp_bbr_bdp(bbr, BBR_UNIT))
+          {
+            bbr->mode  = BBR_PROBE_BW;
+            bbr->cycle = 2;
+          }
+        break;
+
+      case BBR_PROBE_BW:
+        bbr->cycle = (bbr->cycle + 1) % BBR_CYCLE_LEN;
+        break;
+
+      case BBR_PROBE_RTT:
+        if ((sclock_t)(now - bbr->probe_rtt_done) >= 0)
+          {
+            bbr->min_rtt_stamp = now;
+            bbr->mode          = bbr->filled ? BBR_PROBE_BW : BBR_STARTUP;
+            conn->cwnd         = MAX(conn->cwnd, bbr->prior_cwnd);
+          }
+        break;
+    }
+
+  if (expired && bbr->mode != BBR_PROBE_RTT)
+    {
+      bbr->mode           = BBR_PROBE_RTT;
+      bbr->prior_cwnd     = conn->cwnd;
+      bbr->probe_rtt_done = now + BBR_PROBE_RTT_TICKS;
+      conn->cwnd          = MIN(conn->cwnd, BBR_MIN_CWND(conn));
+    }
+
+  rate = (uint64_t)bw * tcp_bbr_pacing_gain(bbr) / BBR_UNIT;
+  conn->pacing_rate = MIN(rate, UINT32_MAX);
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_cong_avoid
+ *
+ * Description:
+ *   Grow cwnd toward the bandwidth-delay product, with room for the delayed
+ *   and aggregated ACKs.
+ *
+ ****************************************************************************/
+
+static void tcp_bbr_cong_avoid(FAR struct tcp_conn_s *conn,
+                               uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc_priv.bbr;
+  uint64_t cwnd = conn->cwnd;
+  uint32_t target;
+
+  if (bbr->mode == BBR_PROBE_RTT)
+    {
+      conn->cwnd = MIN(conn->cwnd, BBR_MIN_CWND(conn));
+      return;
+    }
+
+  target = tcp_bbr_bdp(bbr, bbr->mode == BBR_PROBE_BW ?
+                            BBR_CWND_GAIN : BBR_HIGH_GAIN);
+  if (target > 0)
+    {
+      target += 3 * conn->mss;
+    }
+
+  if (bbr->filled)
+    {
+      cwnd = MIN(cwnd + acked, target);
+    }
+  else if (cwnd < target || target == 0)
+    {
+      cwnd += acked;
+    }
+
+  conn->cwnd = MAX(MIN(cwnd, UINT32_MAX), BBR_MIN_CWND(conn));
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_ssthresh
+ *
+ * Description:
+ *   BBR does not take the losses as a signal of congestion:  The window is
+ *   kept through the fast recovery and grows back quickly after a timeout.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_bbr_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->cwnd, BBR_MIN_CWND(conn));
+}
+
+#endif /* CONFIG_NET_TCP_CC_BBR */
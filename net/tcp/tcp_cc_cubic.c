@@ -0,0 +1,242 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* RFC 8312 uses C = 0.4 and beta_cubic = 0.7.  With the time in ms and
+ * the windows in bytes, W_cubic(t) = C * (t - K)^3 + W_max becomes
+ * 4 * (t - K)^3 * MSS / 10^10 + W_max and
+ * K = cbrt((W_max - cwnd) * 2.5 * 10^9 / MSS).
+ */
+
+#define CUBIC_K_SCALE     2500000000ull
+#define CUBIC_C_NUM       4
+#define CUBIC_C_DEN       10000000000ll
+
+/* Keep (t - K)^3 * MSS within 64 bits */
+
+#define CUBIC_MAX_DELTA   30000
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_cubic_init(FAR struct tcp_conn_s *conn);
+static void tcp_cubic_cong_avoid(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked);
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",                /* name */
+  tcp_cubic_init,         /* init */
+  tcp_cubic_cong_avoid,   /* cong_avoid */
+  tcp_cubic_ssthresh,     /* ssthresh */
+  NULL,                   /* rtt_sample */
+  false                   /* pacing */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cubic_cbrt
+ *
+ * Description:
+ *   Integer cube root, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_cbrt(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_init
+ ****************************************************************************/
+
+static void tcp_cubic_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cc_priv.cubic;
+
+  cubic->w_max   = 0;
+  cubic->started = false;
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_target
+ *
+ * Description:
+ *   Return W_cubic(t + RTT), the window that the curve reaches in one RTT.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_target(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cc_priv.cubic;
+  int64_t delta;
+  int64_t target;
+
+  delta = (int64_t)TICK2MSEC(clock_systime_ticks() - cubic->epoch) +
+          conn->cc_srtt / USEC_PER_MSEC - cubic->k;
+  delta = MIN(delta, CUBIC_MAX_DELTA);
+  delta = MAX(delta, -CUBIC_MAX_DELTA);
+
+  target = cubic->origin +
+           CUBIC_C_NUM * delta * delta * delta * conn->mss / CUBIC_C_DEN;
+
+  return target < 0 ? 0 : MIN(target, UINT32_MAX);
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_cong_avoid
+ ****************************************************************************/
+
+static void tcp_cubic_cong_avoid(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cc_priv.cubic;
+  uint64_t increase;
+  uint32_t target;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      tcp_cc_slow_start(conn, acked);
+      return;
+    }
+
+  /* Do not grow a window that the application does not use */
+
+  if (conn->tx_unacked < conn->cwnd / 2)
+    {
+      return;
+    }
+
+  if (!cubic->started)
+    {
+      cubic->started = true;
+      cubic->epoch   = clock_systime_ticks();
+      cubic->w_est   = conn->cwnd;
+
+      if (conn->cwnd < cubic->w_max)
+        {
+          cubic->k      = tcp_cubic_cbrt((uint64_t)(cubic->w_max -
+                                                    conn->cwnd) *
+                                         (CUBIC_K_SCALE / conn->mss));
+          cubic->origin = cubic->w_max;
+        }
+      else
+        {
+          cubic->k      = 0;
+          cubic->origin = conn->cwnd;
+        }
+    }
+
+  /* The NewReno-friendly region (RFC 8312 section 4.2):  W_est grows by
+   * 3 * (1 - beta) / (1 + beta) segments per RTT.
+   */
+
+  cubic->w_est += (uint64_t)conn->mss * acked * 9 / 17 / conn->cwnd;
+
+  target = MAX(tcp_cubic_target(conn), cubic->w_est);
+  if (target > conn->cwnd)
+    {
+      /* Reach the target in one RTT */
+
+      increase = (uint64_t)(target - conn->cwnd) * acked / conn->cwnd;
+    }
+  else
+    {
+      /* Around the plateau: Grow very slowly */
+
+      increase = (uint64_t)conn->mss * acked / 100 / conn->cwnd;
+    }
+
+  conn->cwnd = MIN(conn->cwnd + MAX(increase, 1), UINT32_MAX);
+  ninfo("update cubic cwnd to %u target %u\n", conn->cwnd, target);
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_ssthresh
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cc_priv.cubic;
+
+  /* Fast convergence: Release bandwidth to the new flows if the window
+   * did not reach the previous plateau.
+   */
+
+  if (conn->cwnd < cubic->w_max)
+    {
+      cubic->w_max = (uint64_t)conn->cwnd * 17 / 20;
+    }
+  else
+    {
+      cubic->w_max = conn->cwnd;
+    }
+
+  cubic->started = false;
+
+  return MAX((uint64_t)conn->cwnd * 7 / 10, 2 * conn->mss);
+}
+
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
@@ -164,7 +164,7 @@ static uint16_t tcp_close_eventhandler(FAR struct net_driver_s *dev,
 
       if (conn->sndcb != NULL)
         {
-          conn->sndcb->flags = 0;
+          devif_callback_setflags(conn->sndcb, 0);
           conn->sndcb->event = NULL;
 
           /* The callback will be freed by tcp_free. */
@@ -245,8 +245,8 @@ static inline int tcp_close_disconnect(FAR struct socket *psock)
 
       /* Set up to receive TCP data event callbacks */
 
-      conn->clscb->flags = TCP_NEWDATA | TCP_ACKDATA |
-                           TCP_POLL | TCP_DISCONN_EVENTS;
+      devif_callback_setflags(conn->clscb, TCP_NEWDATA | TCP_ACKDATA |
+                                           TCP_POLL | TCP_DISCONN_EVENTS);
       conn->clscb->event = tcp_close_eventhandler;
       conn->clscb->priv  = conn; /* reference for event handler to free cb */
 
@@ -71,6 +71,7 @@
 #include "icmpv6/icmpv6.h"
 #include "nat/nat.h"
 #include "netdev/netdev.h"
+#include "socket/socket.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -91,10 +92,137 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The active connections hashed on (lport, rport, raddr).  The local
+ * address is not part of the key so that connections bound to INADDR_ANY
+ * land in the same bucket as the segments directed to them.
+ */
+
+static dq_queue_t g_tcp_connhash[CONFIG_NET_TCP_CONN_HASH_SIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/****************************************************************************
+ * Name: tcp_hash
+ *
+ * Description:
+ *   Return the connection hash bucket of a port pair and a (folded) remote
+ *   IP address.
+ *
+ ****************************************************************************/
+
+static inline_function unsigned int tcp_hash(uint16_t lport, uint16_t rport,
+                                             uint32_t raddr)
+{
+  uint32_t hash = raddr ^ (((uint32_t)lport << 16) | rport);
+
+  /* Mix the bits so that sequential ports and addresses spread well */
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return hash % CONFIG_NET_TCP_CONN_HASH_SIZE;
+}
+
+#ifdef CONFIG_NET_IPv6
+static inline_function uint32_t tcp_ipv6_fold(FAR const uint16_t *addr)
+{
+  return ((uint32_t)(addr[0] ^ addr[2] ^ addr[4] ^ addr[6]) << 16) |
+         (addr[1] ^ addr[3] ^ addr[5] ^ addr[7]);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_conn_hash
+ *
+ * Description:
+ *   Return the hash bucket of a connection whose ports and remote address
+ *   are set up.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_conn_hash(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      return tcp_hash(conn->lport, conn->rport,
+                      tcp_ipv6_fold(conn->u.ipv6.raddr));
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      return tcp_hash(conn->lport, conn->rport, conn->u.ipv4.raddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+
+/****************************************************************************
+ * Name: tcp_hash_next
+ *
+ * Description:
+ *   Return the connection that follows 'conn' in its hash bucket.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct tcp_conn_s *
+  tcp_hash_next(FAR struct tcp_conn_s *conn)
+{
+  return TCP_HNODE2CONN(conn->hnode.flink);
+}
+#endif /* CONFIG_NET_TCP_CONN_HASH */
+
+/****************************************************************************
+ * Name: tcp_addactive
+ *
+ * Description:
+ *   Put a connection whose ports and remote address are set up into the
+ *   list (and the hash table) of active connections.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_addactive(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  dq_addlast(&conn->hnode, &g_tcp_connhash[tcp_conn_hash(conn)]);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_remactive
+ *
+ * Description:
+ *   Remove a connection from the list (and the hash table) of active
+ *   connections.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_remactive(FAR struct tcp_conn_s *conn)
+{
+  dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  dq_rem(&conn->hnode, &g_tcp_connhash[tcp_conn_hash(conn)]);
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -105,11 +233,13 @@ static dq_queue_t g_active_tcp_connections;
  *   Primary uses: (1) to determine if a port number is available, (2) to
  *   To identify the socket that will accept new connections on a local port.
  *
+ *   If reuseport is true, connections that set SO_REUSEPORT are ignored.
+ *
  ****************************************************************************/
 
 static FAR struct tcp_conn_s *
   tcp_listener(uint8_t domain, FAR const union ip_addr_u *ipaddr,
-               uint16_t portno)
+               uint16_t portno, bool reuseport)
 {
   FAR struct tcp_conn_s *conn = NULL;
 
@@ -124,6 +254,10 @@ static FAR struct tcp_conn_s *
       if (conn->tcpstateflags != TCP_CLOSED && conn->lport == portno
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
           && domain == conn->domain
+#endif
+#ifdef CONFIG_NET_REUSEPORT
+          && !(reuseport &&
+               _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
 #endif
          )
         {
@@ -188,10 +322,18 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  unsigned int index;
+#endif
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  index      = tcp_hash(tcp->destport, tcp->srcport, srcipaddr);
+  conn       = TCP_HNODE2CONN(g_tcp_connhash[index].head);
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -228,7 +370,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      conn = tcp_hash_next(conn);
+#else
       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
@@ -255,10 +401,19 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  unsigned int index;
+#endif
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  index      = tcp_hash(tcp->destport, tcp->srcport,
+                        tcp_ipv6_fold(*srcipaddr));
+  conn       = TCP_HNODE2CONN(g_tcp_connhash[index].head);
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 
   while (conn)
     {
@@ -295,13 +450,48 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      conn = tcp_hash_next(conn);
+#else
       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
 }
 #endif /* CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: tcp_bindport
+ *
+ * Description:
+ *   Verify or select the local port of a bind().  A socket that sets
+ *   SO_REUSEPORT may share the port with the others that set it too.
+ *
+ ****************************************************************************/
+
+static int tcp_bindport(FAR struct tcp_conn_s *conn, uint8_t domain,
+                        FAR const union ip_addr_u *ipaddr, uint16_t portno)
+{
+#ifdef CONFIG_NET_REUSEPORT
+  if (portno != 0 && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      if (tcp_listener(domain, ipaddr, portno, true)
+#ifdef CONFIG_NET_NAT
+          || nat_port_inuse(domain, IP_PROTO_TCP, ipaddr, portno)
+#endif
+      )
+        {
+          return -EADDRINUSE;
+        }
+
+      return portno;
+    }
+#endif
+
+  return tcp_selectport(domain, ipaddr, portno);
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_bind
  *
@@ -360,12 +550,12 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   /* Verify or select a local port (network byte order) */
 
-  port = tcp_selectport(PF_INET,
-                       (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
-                       addr->sin_port);
+  port = tcp_bindport(conn, PF_INET,
+                      (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
+                      addr->sin_port);
   if (port < 0)
     {
-      nerr("ERROR: tcp_selectport failed: %d\n", port);
+      nerr("ERROR: tcp_bindport failed: %d\n", port);
       net_unlock();
       return port;
     }
@@ -460,12 +650,12 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   /* The port number must be unique for this address binding */
 
-  port = tcp_selectport(PF_INET6,
+  port = tcp_bindport(conn, PF_INET6,
                 (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
                 addr->sin6_port);
   if (port < 0)
     {
-      nerr("ERROR: tcp_selectport failed: %d\n", port);
+      nerr("ERROR: tcp_bindport failed: %d\n", port);
       net_unlock();
       return port;
     }
@@ -610,7 +800,7 @@ int tcp_selectport(uint8_t domain,
               return -EADDRINUSE;
             }
         }
-      while (tcp_listener(domain, ipaddr, portno)
+      while (tcp_listener(domain, ipaddr, portno, false)
 #ifdef CONFIG_NET_NAT
              || nat_port_inuse(domain, IP_PROTO_TCP, ipaddr, portno)
 #endif
@@ -622,7 +812,7 @@ int tcp_selectport(uint8_t domain,
        * connection is using this local port.
        */
 
-      if (tcp_listener(domain, ipaddr, portno)
+      if (tcp_listener(domain, ipaddr, portno, false)
 #ifdef CONFIG_NET_NAT
           || nat_port_inuse(domain, IP_PROTO_TCP, ipaddr, portno)
 #endif
@@ -783,6 +973,9 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
     {
       memset(conn, 0, sizeof(struct tcp_conn_s));
       conn->sconn.s_ttl   = IP_TTL_DEFAULT;
+#ifdef CONFIG_NET_LOCK_SPLIT
+      nxrmutex_init(&conn->sconn.s_lock);
+#endif
       conn->tcpstateflags = TCP_ALLOCATED;
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       conn->domain        = domain;
@@ -922,7 +1115,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       /* Remove the connection from the active list */
 
-      dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_remactive(conn);
     }
 
   tcp_free_rx_buffers(conn);
@@ -971,6 +1164,9 @@ void tcp_free(FAR struct tcp_conn_s *conn)
   /* Mark the connection available. */
 
   conn->tcpstateflags = TCP_CLOSED;
+#ifdef CONFIG_NET_LOCK_SPLIT
+  nxrmutex_destroy(&conn->sconn.s_lock);
+#endif
 
   /* If this is a preallocated or a batch allocated connection store it in
    * the free connections list. Else free it.
@@ -1170,6 +1366,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #  ifdef CONFIG_NET_BINDTODEVICE
       conn->sconn.s_boundto  = listener->sconn.s_boundto;
 #  endif
+#  ifdef CONFIG_NET_REUSEPORT
+      conn->sconn.s_options |= listener->sconn.s_options & _SO_REUSEPORT;
+#  endif
 #endif
 
       conn->sconn.s_tos      = listener->sconn.s_tos;
@@ -1179,6 +1378,10 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #endif
 #if CONFIG_NET_SEND_BUFSIZE > 0
       conn->snd_bufs         = listener->snd_bufs;
+#endif
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+      conn->flags           |= listener->flags &
+                               (TCP_RCVBUF_LOCK | TCP_SNDBUF_LOCK);
 #endif
       conn->mss              = listener->mss;
 
@@ -1206,8 +1409,11 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #endif
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-      /* Initialize the variables of congestion control */
+      /* Initialize the variables of congestion control, with the
+       * algorithm of the listener.
+       */
 
+      conn->cc_ops           = listener->cc_ops;
       tcp_cc_init(conn);
 #endif
 
@@ -1231,7 +1437,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_addactive(conn);
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1542,7 +1748,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_addactive(conn);
   ret = OK;
 
 errout_with_lock:
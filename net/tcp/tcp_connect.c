@@ -101,8 +101,9 @@ static inline int psock_setup_callbacks(FAR struct socket *psock,
     {
       /* Set up the connection event handler */
 
-      pstate->tc_cb->flags   = (TCP_NEWDATA | TCP_CLOSE | TCP_ABORT |
-                                TCP_TIMEDOUT | TCP_CONNECTED | NETDEV_DOWN);
+      devif_callback_setflags(pstate->tc_cb, TCP_NEWDATA | TCP_CLOSE |
+                                             TCP_ABORT | TCP_TIMEDOUT |
+                                             TCP_CONNECTED | NETDEV_DOWN);
       pstate->tc_cb->priv    = (FAR void *)pstate;
       pstate->tc_cb->event   = psock_connect_eventhandler;
       ret                    = OK;
@@ -0,0 +1,279 @@
+/****************************************************************************
+ * net/tcp/tcp_gso.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_GSO
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_gso_fixup
+ *
+ * Description:
+ *   Update the IP and TCP headers of one segment and compute its
+ *   checksums.
+ *
+ * Input Parameters:
+ *   seg    - The segment, with its headers in the first I/O buffer
+ *   ipv6   - True if the segment is an IPv6 packet
+ *   iplen  - The size of the IP header
+ *   index  - The index of the segment in the super-segment
+ *   seqno  - The sequence number of the segment
+ *   last   - True for the last segment
+ *
+ ****************************************************************************/
+
+static void tcp_gso_fixup(FAR struct iob_s *seg, bool ipv6,
+                          unsigned int iplen, unsigned int index,
+                          uint32_t seqno, bool last)
+{
+  FAR uint8_t *ip = seg->io_data + seg->io_offset;
+  FAR struct tcp_hdr_s *tcp = (FAR struct tcp_hdr_s *)(ip + iplen);
+  uint16_t upperlen = seg->io_pktlen - iplen;
+  uint16_t sum;
+
+#ifdef CONFIG_NET_IPv6
+  if (ipv6)
+    {
+      FAR struct ipv6_hdr_s *ipv6hdr = (FAR struct ipv6_hdr_s *)ip;
+      uint16_t len = seg->io_pktlen - IPv6_HDRLEN;
+
+      ipv6hdr->len[0] = len >> 8;
+      ipv6hdr->len[1] = len & 0xff;
+
+      sum = chksum(upperlen + IP_PROTO_TCP,
+                   (FAR uint8_t *)&ipv6hdr->srcipaddr,
+                   2 * sizeof(net_ipv6addr_t));
+    }
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv4
+      FAR struct ipv4_hdr_s *ipv4hdr = (FAR struct ipv4_hdr_s *)ip;
+      uint16_t ipid;
+
+      /* The segments are sent with IP_FLAG_DONTFRAG, their identifiers
+       * only need to differ from each other.
+       */
+
+      ipid = ((uint16_t)ipv4hdr->ipid[0] << 8) + ipv4hdr->ipid[1] + index;
+
+      ipv4hdr->len[0]   = seg->io_pktlen >> 8;
+      ipv4hdr->len[1]   = seg->io_pktlen & 0xff;
+      ipv4hdr->ipid[0]  = ipid >> 8;
+      ipv4hdr->ipid[1]  = ipid & 0xff;
+      ipv4hdr->ipchksum = 0;
+#ifdef CONFIG_NET_IPV4_CHECKSUMS
+      ipv4hdr->ipchksum = ~ipv4_chksum(ipv4hdr);
+#endif
+
+      sum = chksum(upperlen + IP_PROTO_TCP,
+                   (FAR uint8_t *)&ipv4hdr->srcipaddr,
+                   2 * sizeof(in_addr_t));
+#endif
+    }
+
+  tcp_setsequence(tcp->seqno, seqno);
+
+  /* FIN and PSH belong to the end of the data */
+
+  if (!last)
+    {
+      tcp->flags &= ~(TCP_FIN | TCP_PSH);
+    }
+
+  /* The checksum of the super-segment, if any, only covered the
+   * pseudo-header.
+   */
+
+  tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  sum = chksum_iob(sum, seg, iplen);
+  tcp->tcpchksum = ~((sum == 0) ? 0xffff : HTONS(sum));
+#else
+  UNUSED(sum);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_gso_segment
+ *
+ * Description:
+ *   Cut the TCP super-segment in d_iob in segments of d_gso_size bytes of
+ *   payload, with their own IP and TCP headers and checksums.  The
+ *   segments are queued in dev->d_fragout, like IP fragments, and d_iob
+ *   is released.
+ *
+ * Input Parameters:
+ *   dev - The device with the super-segment in d_iob
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  d_iob and the
+ *   segments are released on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_gso_segment(FAR struct net_driver_s *dev)
+{
+  FAR struct tcp_hdr_s *tcp;
+  FAR struct iob_s *seg;
+  unsigned int nsegs = 0;
+  unsigned int hdrlen;
+  unsigned int iplen;
+  unsigned int paylen;
+  unsigned int offset;
+  unsigned int len;
+  uint32_t seqno;
+  bool ipv6 = false;
+  int ret;
+
+  DEBUGASSERT(dev->d_iob != NULL && dev->d_gso_size > 0);
+
+#ifdef CONFIG_NET_IPv6
+  if (IFF_IS_IPv6(dev->d_flags))
+    {
+      ipv6  = true;
+      iplen = IPv6_HDRLEN;
+      tcp   = TCPIPv6BUF;
+    }
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv4
+      iplen = (IPv4BUF->vhl & IPv4_HLMASK) << 2;
+      tcp   = (FAR struct tcp_hdr_s *)IPBUF(iplen);
+#endif
+    }
+
+  hdrlen = iplen + ((tcp->tcpoffset >> 4) << 2);
+  paylen = dev->d_iob->io_pktlen - hdrlen;
+  seqno  = tcp_getsequence(tcp->seqno);
+
+  ninfo("GSO: %u bytes in segments of %u\n", paylen, dev->d_gso_size);
+
+  for (offset = 0; offset < paylen; offset += len)
+    {
+      len = paylen - offset;
+      if (len > dev->d_gso_size)
+        {
+          len = dev->d_gso_size;
+        }
+
+      seg = iob_tryalloc(false);
+      if (seg == NULL)
+        {
+          goto errout;
+        }
+
+      /* Each segment starts with a copy of the headers, that must fit in
+       * its first I/O buffer.
+       */
+
+      iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+      DEBUGASSERT(CONFIG_NET_LL_GUARDSIZE + hdrlen <= IOB_BUFSIZE(seg));
+
+      ret = iob_clone_partial(dev->d_iob, hdrlen, 0, seg, 0, false, false);
+      if (ret >= 0)
+        {
+          ret = iob_clone_partial(dev->d_iob, len, hdrlen + offset,
+                                  seg, hdrlen, false, false);
+        }
+
+      if (ret < 0)
+        {
+          iob_free_chain(seg);
+          goto errout;
+        }
+
+      tcp_gso_fixup(seg, ipv6, iplen, nsegs, seqno + offset,
+                    offset + len >= paylen);
+
+      if (iob_tryadd_queue(seg, &dev->d_fragout) < 0)
+        {
+          iob_free_chain(seg);
+          goto errout;
+        }
+
+      nsegs++;
+    }
+
+#ifdef CONFIG_NET_STATISTICS
+  if (nsegs > 1)
+    {
+      g_netstats.tcp.sent += nsegs - 1;
+#ifdef CONFIG_NET_IPv6
+      if (ipv6)
+        {
+          g_netstats.ipv6.sent += nsegs - 1;
+        }
+      else
+#endif
+        {
+#ifdef CONFIG_NET_IPv4
+          g_netstats.ipv4.sent += nsegs - 1;
+#endif
+        }
+    }
+#endif
+
+  netdev_iob_release(dev);
+  return OK;
+
+errout:
+  nerr("ERROR: Failed to segment %u bytes\n", paylen);
+  iob_free_queue(&dev->d_fragout);
+  netdev_iob_release(dev);
+  return -ENOMEM;
+}
+
+#endif /* CONFIG_NET_TCP_GSO */
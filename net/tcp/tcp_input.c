@@ -53,6 +53,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -724,9 +725,16 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   tcpiplen = iplen + TCP_HDRLEN;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-  /* Start of TCP input header processing code. */
+  /* Start of TCP input header processing code.  The checksum was already
+   * verified if the device tells so.
+   */
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  if ((dev->d_offload & NETDEV_OFFLOAD_RXCSUM) == 0 &&
+      tcp_chksum(dev) != 0xffff)
+#else
   if (tcp_chksum(dev) != 0xffff)
+#endif
     {
       /* Compute and check the TCP checksum. */
 
@@ -768,10 +776,14 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
    * it is an old packet and we send a RST.
    */
 
-  if ((tcp->flags & TCP_CTL) == TCP_SYN)
+  if ((tcp->flags & TCP_CTL) == TCP_SYN
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+      || (tcp->flags & (TCP_SYN | TCP_RST | TCP_ACK)) == TCP_ACK
+#endif
+     )
     {
-      /* This is a SYN packet for a connection.  Find the connection
-       * listening on this port.
+      /* This is a SYN packet for a connection (or the ACK that returns a
+       * SYN cookie).  Find the connection listening on this port.
        */
 
       tmp16 = tcp->destport;
@@ -781,6 +793,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #  endif
         {
           net_ipv6addr_copy(&uaddr.ipv6.laddr, IPv6BUF->destipaddr);
+          net_ipv6addr_copy(&uaddr.ipv6.raddr, IPv6BUF->srcipaddr);
         }
 #endif
 
@@ -791,19 +804,54 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
         {
           net_ipv4addr_copy(uaddr.ipv4.laddr,
                             net_ip4addr_conv32(IPv4BUF->destipaddr));
+          net_ipv4addr_copy(uaddr.ipv4.raddr,
+                            net_ip4addr_conv32(IPv4BUF->srcipaddr));
         }
 #endif
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if ((conn = tcp_findlistener(&uaddr, tmp16, domain)) != NULL)
+      conn = tcp_findlistener(&uaddr, tmp16, domain);
 #else
-      if ((conn = tcp_findlistener(&uaddr, tmp16)) != NULL)
+      conn = tcp_findlistener(&uaddr, tmp16);
 #endif
+#ifdef CONFIG_NET_REUSEPORT
+      conn = tcp_reuseport_select(conn, &uaddr, tcp->srcport);
+#endif
+      if (conn != NULL)
         {
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+          FAR struct tcp_conn_s *listener = conn;
+
+          if ((tcp->flags & TCP_SYN) == 0)
+            {
+              /* An ACK completes a handshake only if it returns a cookie.
+               * If there is still no room for the connection, drop it.  The
+               * peer retransmits and the cookie stays valid for a while.
+               */
+
+              int ret = tcp_syncookie_accept(dev, tcp, listener, &conn);
+              if (ret == -EINVAL)
+                {
+                  conn = NULL;
+                  goto reset;
+                }
+              else if (ret < 0)
+                {
+                  goto drop;
+                }
+
+              goto found;
+            }
+#endif
+
           if (!tcp_backlogavailable(conn))
             {
               nerr("ERROR: no free containers for TCP BACKLOG!\n");
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+              goto syncookie;
+#else
               goto drop;
+#endif
             }
 
           /* We matched the incoming packet with a connection in LISTEN.
@@ -853,7 +901,11 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
               g_netstats.tcp.syndrop++;
 #endif
               nerr("ERROR: No free TCP connections\n");
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+              goto syncookie;
+#else
               goto drop;
+#endif
             }
 
           net_incr32(conn->rcvseq, 1); /* ack SYN */
@@ -866,6 +918,19 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
           tcp_synack(dev, conn, TCP_ACK | TCP_SYN);
           return;
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+syncookie:
+
+          /* Answer with a cookie instead, nothing is allocated until the
+           * ACK returns it.
+           */
+
+          conn = tcp_syncookie_conn(dev, tcp, listener);
+          tcp_parse_option(dev, conn, iplen);
+          tcp_syncookie_synack(dev, conn);
+          return;
+#endif
         }
     }
 
@@ -938,6 +1003,9 @@ found:
 #else
           listener = tcp_findlistener(&uaddr, conn->lport);
 #endif
+#ifdef CONFIG_NET_REUSEPORT
+          listener = tcp_reuseport_select(listener, &conn->u, conn->rport);
+#endif
 
           /* We must free this TCP connection structure; this connection
            * will never be established.  There should only be one reference
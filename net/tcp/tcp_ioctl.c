@@ -38,6 +38,8 @@
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
 
+#include "netdev/netdev.h"
+#include "utils/utils.h"
 #include "tcp/tcp.h"
 
 /****************************************************************************
@@ -99,6 +101,67 @@ static void tcp_path(FAR struct tcp_conn_s *conn, FAR char *buf, size_t len)
            );
 }
 
+/****************************************************************************
+ * Name: tcp_recviob
+ *
+ * Description:
+ *   Hand the data queued in the read-ahead buffer over to the caller of the
+ *   SIOCRECVIOB ioctl, without copying it.
+ *
+ * Parameters:
+ *   conn     The TCP connection of interest
+ *   ri       The zero-copy receive request
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECV_ZEROCOPY
+static int tcp_recviob(FAR struct tcp_conn_s *conn,
+                       FAR struct net_recviob_s *ri)
+{
+  unsigned int len;
+
+  ri->ri_iob = NULL;
+  ri->ri_len = 0;
+
+  if (conn->readahead == NULL)
+    {
+      /* Report the end-of-file of a gracefully closed connection like
+       * recv() does.
+       */
+
+      if (!_SS_ISCONNECTED(conn->sconn.s_flags))
+        {
+          return _SS_ISCLOSED(conn->sconn.s_flags) ? OK : -ENOTCONN;
+        }
+
+      return -EAGAIN;
+    }
+
+  len = conn->readahead->io_pktlen;
+  if (ri->ri_maxlen > 0 && ri->ri_maxlen < len)
+    {
+      len = ri->ri_maxlen;
+    }
+
+  ri->ri_iob = net_iob_detach(&conn->readahead, len);
+  if (ri->ri_iob == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ri->ri_len = len;
+
+  /* The receive window opens, send the window update timely */
+
+  if (tcp_should_send_recvwindow(conn))
+    {
+      netdev_txnotify_dev(conn->dev);
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -151,6 +214,12 @@ int tcp_ioctl(FAR struct tcp_conn_s *conn, int cmd, unsigned long arg)
       case FIOC_FILEPATH:
         tcp_path(conn, (FAR char *)(uintptr_t)arg, PATH_MAX);
         break;
+#ifdef CONFIG_NET_RECV_ZEROCOPY
+      case SIOCRECVIOB:
+        ret = tcp_recviob(conn,
+                          (FAR struct net_recviob_s *)(uintptr_t)arg);
+        break;
+#endif
       default:
         ret = -ENOTTY;
         break;
@@ -55,20 +55,70 @@
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "socket/socket.h"
 #include "tcp/tcp.h"
+#include "utils/utils.h"
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The listening connections hashed on their local port, and their count */
+
+static dq_queue_t g_tcp_listenhash[CONFIG_NET_TCP_CONN_HASH_SIZE];
+static int g_tcp_nlisteners;
+#else
 /* The tcp_listenports list all currently listening ports. */
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_nextlistener
+ *
+ * Description:
+ *   Return the listener that follows 'conn', or the first one if 'conn' is
+ *   NULL, among those that may listen on 'portno'.  *ndx is the position
+ *   in the listener list, which starts at -1.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s *tcp_nextlistener(FAR struct tcp_conn_s *conn,
+                                               uint16_t portno,
+                                               FAR int *ndx)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  /* Examine only the listeners hashed on the same local port */
+
+  if (conn == NULL)
+    {
+      return TCP_HNODE2CONN(g_tcp_listenhash[TCP_LISTEN_HASH(portno)].head);
+    }
+
+  return TCP_HNODE2CONN(conn->hnode.flink);
+#else
+  /* Examine each assigned slot of the listener list */
+
+  while (++(*ndx) < CONFIG_NET_MAX_LISTENPORTS)
+    {
+      if (tcp_listenports[*ndx] != NULL)
+        {
+          return tcp_listenports[*ndx];
+        }
+    }
+
+  return NULL;
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_findlistener
  *
@@ -89,21 +139,18 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno)
 #endif
 {
-  int ndx;
-
-  /* Examine each connection structure in each slot of the listener list */
+  FAR struct tcp_conn_s *conn;
+  int ndx = -1;
 
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  for (conn = tcp_nextlistener(NULL, portno, &ndx); conn != NULL;
+       conn = tcp_nextlistener(conn, portno, &ndx))
     {
-      /* Is this slot assigned?  If so, does the connection have the same
-       * local port number?
-       */
+      /* Does the connection have the same local port number? */
 
-      FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if (conn && conn->lport == portno && conn->domain == domain)
+      if (conn->lport == portno && conn->domain == domain)
 #else
-      if (conn && conn->lport == portno)
+      if (conn->lport == portno)
 #endif
         {
 #ifdef CONFIG_NET_IPv6
@@ -143,6 +190,75 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: tcp_reuseport_member
+ *
+ * Description:
+ *   Return member number 'index' of the SO_REUSEPORT group of listener, in
+ *   the order of the listener list.  If there is no such member, return
+ *   NULL with the size of the group in *count.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+static FAR struct tcp_conn_s *
+  tcp_reuseport_member(FAR struct tcp_conn_s *listener, int index,
+                       FAR int *count)
+{
+  FAR struct tcp_conn_s *conn;
+  int ndx = -1;
+  int n = 0;
+
+  for (conn = tcp_nextlistener(NULL, listener->lport, &ndx); conn != NULL;
+       conn = tcp_nextlistener(conn, listener->lport, &ndx))
+    {
+      if (conn->lport != listener->lport ||
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+          conn->domain != listener->domain ||
+#endif
+          !_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          continue;
+        }
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+      if (listener->domain == PF_INET6)
+#  endif
+        {
+          if (!net_ipv6addr_cmp(conn->u.ipv6.laddr, listener->u.ipv6.laddr))
+            {
+              continue;
+            }
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+      if (listener->domain == PF_INET)
+#  endif
+        {
+          if (!net_ipv4addr_cmp(conn->u.ipv4.laddr, listener->u.ipv4.laddr))
+            {
+              continue;
+            }
+        }
+#endif
+
+      if (n++ == index)
+        {
+          return conn;
+        }
+    }
+
+  *count = n;
+  return NULL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -160,10 +276,28 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR dq_queue_t *bucket;
+  FAR dq_entry_t *entry;
+#else
   int ndx;
+#endif
   int ret = -EINVAL;
 
   net_lock();
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  bucket = &g_tcp_listenhash[TCP_LISTEN_HASH(conn->lport)];
+  for (entry = dq_peek(bucket); entry != NULL; entry = dq_next(entry))
+    {
+      if (entry == &conn->hnode)
+        {
+          dq_rem(entry, bucket);
+          g_tcp_nlisteners--;
+          ret = OK;
+          break;
+        }
+    }
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       if (tcp_listenports[ndx] == conn)
@@ -173,6 +307,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
           break;
         }
     }
+#endif
 
   net_unlock();
   return ret;
@@ -191,7 +326,10 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+  FAR struct tcp_conn_s *listener;
+#ifndef CONFIG_NET_TCP_CONN_HASH
   int ndx;
+#endif
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -200,13 +338,21 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
   net_lock();
 
-  /* First, check if there is already a socket listening on this port */
+  /* First, check if there is already a socket listening on this port.
+   * Sockets that all set SO_REUSEPORT may listen on the same port.
+   */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(&conn->u, conn->lport, conn->domain))
+  listener = tcp_findlistener(&conn->u, conn->lport, conn->domain);
 #else
-  if (tcp_islistener(&conn->u, conn->lport))
+  listener = tcp_findlistener(&conn->u, conn->lport);
 #endif
+  if (listener != NULL
+#ifdef CONFIG_NET_REUSEPORT
+      && !(_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) &&
+           _SO_GETOPT(listener->sconn.s_options, SO_REUSEPORT))
+#endif
+     )
     {
       /* Yes, then we must refuse this request */
 
@@ -220,6 +366,15 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -ENOBUFS; /* Assume failure */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      if (g_tcp_nlisteners < CONFIG_NET_MAX_LISTENPORTS)
+        {
+          dq_addlast(&conn->hnode,
+                     &g_tcp_listenhash[TCP_LISTEN_HASH(conn->lport)]);
+          g_tcp_nlisteners++;
+          ret = OK;
+        }
+#else
       /* Search all slots until an available slot is found */
 
       for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
@@ -235,6 +390,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               break;
             }
         }
+#endif
     }
 
   net_unlock();
@@ -265,6 +421,68 @@ bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno)
 }
 #endif
 
+/****************************************************************************
+ * Name: tcp_reuseport_select
+ *
+ * Description:
+ *   Given the listener found for a connection, pick the member of its
+ *   SO_REUSEPORT group that handles the connection.  The choice depends on
+ *   the remote address and port only, so that the SYN, the ACK that
+ *   completes the handshake and any timeout of the connection all see the
+ *   same listener while the group does not change.
+ *
+ * Input Parameters:
+ *   listener - The listener returned by tcp_findlistener().
+ *   uaddr    - Holds the remote address of the connection.
+ *   rport    - The remote port of the connection (network order).
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+FAR struct tcp_conn_s *
+  tcp_reuseport_select(FAR struct tcp_conn_s *listener,
+                       FAR const union ip_binding_u *uaddr, uint16_t rport)
+{
+  FAR const uint16_t *raddr;
+  uint32_t hash;
+  int count;
+  int naddr;
+
+  if (listener == NULL ||
+      !_SO_GETOPT(listener->sconn.s_options, SO_REUSEPORT) ||
+      tcp_reuseport_member(listener, -1, &count) != NULL || count < 2)
+    {
+      return listener;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (listener->domain == PF_INET6)
+#  endif
+    {
+      raddr = uaddr->ipv6.raddr;
+      naddr = 8;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      raddr = (FAR const uint16_t *)&uaddr->ipv4.raddr;
+      naddr = 2;
+    }
+#endif
+
+  hash = net_flowhash(raddr, naddr, rport, listener->lport);
+  return tcp_reuseport_member(listener, hash % count, &count);
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_accept_connection
  *
@@ -291,6 +509,9 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
   listener = tcp_findlistener(&conn->u, portno, conn->domain);
 #else
   listener = tcp_findlistener(&conn->u, portno);
+#endif
+#ifdef CONFIG_NET_REUSEPORT
+  listener = tcp_reuseport_select(listener, &conn->u, conn->rport);
 #endif
   if (listener != NULL)
     {
@@ -300,13 +300,13 @@ int tcp_start_monitor(FAR struct socket *psock)
     {
       cb->event = tcp_monitor_event;
       cb->priv  = (FAR void *)conn;
-      cb->flags = TCP_DISCONN_EVENTS;
+      devif_callback_setflags(cb, TCP_DISCONN_EVENTS);
 
       /* Monitor the connected event */
 
       if (nonblock_conn)
         {
-          cb->flags |= TCP_CONNECTED;
+          devif_callback_setflags(cb, cb->flags | TCP_CONNECTED);
         }
     }
 
@@ -381,7 +381,7 @@ void tcp_lost_connection(FAR struct tcp_conn_s *conn,
 
   if (cb != NULL)
     {
-      cb->flags = 0;
+      devif_callback_setflags(cb, 0);
       cb->priv  = NULL;
       cb->event = NULL;
     }
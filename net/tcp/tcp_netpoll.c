@@ -167,7 +167,7 @@ static uint16_t tcp_poll_eventhandler(FAR struct net_driver_s *dev,
         {
           /* Stop further callbacks */
 
-          info->cb->flags = 0;
+          devif_callback_setflags(info->cb, 0);
           info->cb->priv  = NULL;
           info->cb->event = NULL;
         }
@@ -258,28 +258,28 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
    * callback processing.
    */
 
-  cb->flags = TCP_DISCONN_EVENTS;
+  devif_callback_setflags(cb, TCP_DISCONN_EVENTS);
   cb->priv  = info;
   cb->event = tcp_poll_eventhandler;
 
   if ((fds->events & POLLOUT) != 0)
     {
-      cb->flags |= TCP_POLL;
+      devif_callback_setflags(cb, cb->flags | TCP_POLL);
 #if defined(CONFIG_NET_TCP_WRITE_BUFFERS)
-      cb->flags |= TCP_ACKDATA;
+      devif_callback_setflags(cb, cb->flags | TCP_ACKDATA);
 #endif
 
       /* Monitor the connected event */
 
       if (nonblock_conn)
         {
-          cb->flags |= TCP_CONNECTED;
+          devif_callback_setflags(cb, cb->flags | TCP_CONNECTED);
         }
     }
 
   if ((fds->events & POLLIN) != 0)
     {
-      cb->flags |= TCP_NEWDATA | TCP_BACKLOG;
+      devif_callback_setflags(cb, cb->flags | (TCP_NEWDATA | TCP_BACKLOG));
     }
 
   /* Save the reference in the poll info structure as fds private as well
@@ -0,0 +1,548 @@
+/****************************************************************************
+ * net/tcp/tcp_rack.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_RACK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The worst case delayed ACK timer of the receiver (RFC 8985, 7.2) */
+
+#define TCP_TLP_WCDELACK       MSEC2TICK(200)
+
+/* The probe timeout when no RTT was measured yet */
+
+#define TCP_TLP_INITPTO        SEC2TICK(1)
+
+/* The number of recoveries the reordering window stays inflated after a
+ * D-SACK, and the max multiplier (RFC 8985, 6.2)
+ */
+
+#define TCP_RACK_REOPERSIST    16
+#define TCP_RACK_REOMULT_MAX   16
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_rack_sentafter
+ *
+ * Description:
+ *   Check if the data ending at seq1 was sent after the data ending at
+ *   seq2.
+ *
+ ****************************************************************************/
+
+static bool tcp_rack_sentafter(clock_t t1, uint32_t seq1,
+                               clock_t t2, uint32_t seq2)
+{
+  return (sclock_t)(t1 - t2) > 0 ||
+         (t1 == t2 && TCP_SEQ_GT(seq1, seq2));
+}
+
+/****************************************************************************
+ * Name: tcp_rack_expiry
+ *
+ * Description:
+ *   The reordering or the probe timer expired:  Poll the connection to
+ *   handle it with the device available.
+ *
+ * Input Parameters:
+ *   arg - The TCP connection
+ *
+ ****************************************************************************/
+
+static void tcp_rack_expiry(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+
+  net_lock();
+
+  while ((conn = tcp_nextconn(conn)) != NULL)
+    {
+      if (conn == arg)
+        {
+          conn->rack_fired = true;
+          netdev_txnotify_dev(conn->dev);
+          break;
+        }
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: tcp_rack_settimer
+ *
+ * Description:
+ *   Start the reordering or the probe timer.
+ *
+ ****************************************************************************/
+
+static void tcp_rack_settimer(FAR struct tcp_conn_s *conn, uint8_t kind,
+                              clock_t ticks)
+{
+  conn->rack_timer = kind;
+  conn->rack_fired = false;
+  work_queue(LPWORK, &conn->rack_work, tcp_rack_expiry, conn, ticks);
+}
+
+/****************************************************************************
+ * Name: tcp_rack_reownd
+ *
+ * Description:
+ *   Get the reordering window (RFC 8985, 6.2 step 4):  Zero while no
+ *   reordering was seen and the loss is already certain, otherwise a
+ *   quarter of the min RTT per multiple, bounded by the SRTT.
+ *
+ ****************************************************************************/
+
+static clock_t tcp_rack_reownd(FAR struct tcp_conn_s *conn, uint32_t una)
+{
+  clock_t reownd;
+  clock_t srtt;
+
+  if (!conn->rack_reordering &&
+      (conn->sack_recovery ||
+       tcp_sack_bytes(conn, una) >=
+       TCP_FAST_RETRANSMISSION_THRESH * conn->mss))
+    {
+      return 0;
+    }
+
+  reownd = (conn->rack_reomult + 1) * conn->rack_minrtt / 4;
+  srtt   = conn->rack_srtt >> 3;
+  if (reownd > srtt)
+    {
+      reownd = srtt;
+    }
+
+  /* One more tick for the granularity of the clock */
+
+  return reownd + 1;
+}
+
+/****************************************************************************
+ * Name: tcp_rack_armtlp
+ *
+ * Description:
+ *   Start the probe timer (RFC 8985, 7.2), unless the reordering timer is
+ *   pending or the retransmission timer expires first.
+ *
+ ****************************************************************************/
+
+static void tcp_rack_armtlp(FAR struct tcp_conn_s *conn)
+{
+  clock_t pto;
+
+  if (conn->sack_recovery || conn->tlp_inflight || conn->tx_unacked == 0)
+    {
+      return;
+    }
+
+  if (!work_available(&conn->rack_work) &&
+      conn->rack_timer == TCP_RACK_TIMER_REO)
+    {
+      return;
+    }
+
+  if (conn->rack_rttvalid)
+    {
+      pto = 2 * (conn->rack_srtt >> 3);
+      if (conn->tx_unacked <= conn->mss)
+        {
+          pto += TCP_TLP_WCDELACK;
+        }
+      else
+        {
+          pto += 2;
+        }
+    }
+  else
+    {
+      pto = TCP_TLP_INITPTO;
+    }
+
+  if (tcp_timer_pending(conn) && pto >= tcp_timer_timeleft(conn))
+    {
+      work_cancel(LPWORK, &conn->rack_work);
+      return;
+    }
+
+  tcp_rack_settimer(conn, TCP_RACK_TIMER_TLP, pto);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_rack_delivered
+ *
+ * Description:
+ *   Update the RACK state with data of a write buffer that was delivered,
+ *   either cumulatively ACKed or newly SACKed (RFC 8985, 6.2 steps 1-3).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   wrb    - The write buffer with the delivered data
+ *   endseq - The end sequence of the delivered data
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rack_delivered(FAR struct tcp_conn_s *conn,
+                        FAR struct tcp_wrbuffer_s *wrb, uint32_t endseq)
+{
+  clock_t rtt = clock_systime_ticks() - wrb->wb_xmittime;
+
+  /* An ACK of retransmitted data faster than the min RTT is for the
+   * original transmission.
+   */
+
+  if ((TCP_WBFLAGS(wrb) & TCP_WB_REXMIT) != 0 && conn->rack_rttvalid &&
+      rtt < conn->rack_minrtt)
+    {
+      return;
+    }
+
+  conn->rack_rtt = rtt;
+  if (!conn->rack_rttvalid)
+    {
+      conn->rack_minrtt   = rtt;
+      conn->rack_srtt     = rtt << 3;
+      conn->rack_rttvalid = true;
+    }
+  else
+    {
+      if (rtt < conn->rack_minrtt)
+        {
+          conn->rack_minrtt = rtt;
+        }
+
+      conn->rack_srtt += rtt - (conn->rack_srtt >> 3);
+    }
+
+  if (tcp_rack_sentafter(wrb->wb_xmittime, endseq,
+                         conn->rack_xmittime, conn->rack_endseq))
+    {
+      conn->rack_xmittime = wrb->wb_xmittime;
+      conn->rack_endseq   = endseq;
+    }
+
+  /* Original data delivered below the highest delivered data was
+   * reordered by the network.
+   */
+
+  if ((TCP_WBFLAGS(wrb) & (TCP_WB_REXMIT | TCP_WB_SACKED)) == 0 &&
+      TCP_SEQ_LT(endseq, conn->rack_fack))
+    {
+      conn->rack_reordering = true;
+    }
+  else if (TCP_SEQ_GT(endseq, conn->rack_fack))
+    {
+      conn->rack_fack = endseq;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_rack_detect
+ *
+ * Description:
+ *   Mark lost the outstanding write buffers sent long enough before the
+ *   latest delivered data (RFC 8985, 6.2 step 5), and start the
+ *   reordering timer for the ones that are not yet.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rack_detect(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  sclock_t timeout = 0;
+  sclock_t remaining;
+  clock_t reownd;
+  clock_t now;
+  uint32_t seq;
+  uint32_t end;
+  uint32_t len;
+
+  wrb = tcp_sack_nextwrb(conn, NULL);
+  if (wrb == NULL || !conn->rack_rttvalid)
+    {
+      return;
+    }
+
+  now    = clock_systime_ticks();
+  reownd = tcp_rack_reownd(conn, TCP_WBSEQNO(wrb));
+
+  for (; wrb != NULL; wrb = tcp_sack_nextwrb(conn, wrb))
+    {
+      if ((TCP_WBFLAGS(wrb) & TCP_WB_LOST) != 0)
+        {
+          continue;
+        }
+
+      seq = TCP_WBSEQNO(wrb);
+      end = seq + TCP_WBSENT(wrb);
+      if (!tcp_sack_hole(conn, &seq, end, &len) ||
+          !tcp_rack_sentafter(conn->rack_xmittime, conn->rack_endseq,
+                              wrb->wb_xmittime, end))
+        {
+          continue;
+        }
+
+      remaining = wrb->wb_xmittime + conn->rack_rtt + reownd - now;
+      if (remaining <= 0)
+        {
+          tcp_sack_markloss(conn, wrb);
+        }
+      else if (remaining > timeout)
+        {
+          timeout = remaining;
+        }
+    }
+
+  if (timeout > 0)
+    {
+      tcp_rack_settimer(conn, TCP_RACK_TIMER_REO, timeout);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_rack_ack
+ *
+ * Description:
+ *   Process an ACK:  Inflate the reordering window on D-SACK, close the
+ *   loss probe episode (RFC 8985, 7.4) and restart the probe timer.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   ackno - The acknowledgement number of the ACK
+ *   dsack - True if the ACK reported a duplicate segment
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rack_ack(FAR struct tcp_conn_s *conn, uint32_t ackno, bool dsack)
+{
+  if (dsack)
+    {
+      if (conn->rack_reomult < TCP_RACK_REOMULT_MAX - 1)
+        {
+          conn->rack_reomult++;
+        }
+
+      conn->rack_reopersist = TCP_RACK_REOPERSIST;
+    }
+
+  if (conn->tlp_inflight && TCP_SEQ_GTE(ackno, conn->tlp_endseq))
+    {
+      /* Without a D-SACK for it, the retransmitted probe repaired a loss:
+       * The congestion control must still react to it.
+       */
+
+      if (conn->tlp_rexmit && !dsack)
+        {
+          ninfo("TLP: probe repaired a loss\n");
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+          conn->ssthresh = conn->cc_ops->ssthresh(conn);
+          conn->cwnd     = conn->ssthresh;
+#endif
+        }
+
+      conn->tlp_inflight = false;
+    }
+
+  if (conn->tx_unacked == 0)
+    {
+      work_cancel(LPWORK, &conn->rack_work);
+    }
+  else
+    {
+      tcp_rack_armtlp(conn);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_rack_sent
+ *
+ * Description:
+ *   Record the send time of new data of a write buffer, and start the
+ *   probe timer if it is not running.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   wrb  - The write buffer with the data sent
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rack_sent(FAR struct tcp_conn_s *conn,
+                   FAR struct tcp_wrbuffer_s *wrb)
+{
+  wrb->wb_xmittime = clock_systime_ticks();
+
+  if (conn->tlp_newdata)
+    {
+      ninfo("TLP: probe with new data, endseq=%" PRIu32 "\n",
+            conn->sndseq_max);
+
+      conn->tlp_newdata  = false;
+      conn->tlp_inflight = true;
+      conn->tlp_rexmit   = false;
+      conn->tlp_endseq   = conn->sndseq_max;
+    }
+
+  if (work_available(&conn->rack_work))
+    {
+      tcp_rack_armtlp(conn);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_rack_timeout
+ *
+ * Description:
+ *   Handle the expired reordering or probe timer from the poll of the
+ *   connection.  A probe (RFC 8985, 7.3) sends one segment of new data if
+ *   the window allows, else it retransmits the last segment sent.
+ *
+ * Input Parameters:
+ *   dev  - The device to send on
+ *   conn - The TCP connection of interest
+ *
+ * Returned Value:
+ *   True if the device is used by a retransmitted probe.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_rack_timeout(FAR struct net_driver_s *dev,
+                      FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *last = NULL;
+  FAR struct tcp_wrbuffer_s *wrb;
+  uint32_t len;
+
+  conn->rack_fired = false;
+
+  if (conn->rack_timer == TCP_RACK_TIMER_REO)
+    {
+      tcp_rack_detect(conn);
+      return false;
+    }
+
+  if (conn->sack_recovery || conn->tlp_inflight || conn->tx_unacked == 0)
+    {
+      return false;
+    }
+
+  /* Probe with new data if there is some and the peer can take it */
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+  if (wrb != NULL && TCP_WBSENT(wrb) < TCP_WBPKTLEN(wrb) &&
+      TCP_SEQ_LT(conn->sndseq_max, conn->snd_wl2 + conn->snd_wnd))
+    {
+      conn->tlp_newdata = true;
+      return false;
+    }
+
+  /* Else retransmit the last segment sent */
+
+  for (wrb = tcp_sack_nextwrb(conn, NULL); wrb != NULL;
+       wrb = tcp_sack_nextwrb(conn, wrb))
+    {
+      last = wrb;
+    }
+
+  if (last == NULL)
+    {
+      return false;
+    }
+
+  len = TCP_WBSENT(last) < conn->mss ? TCP_WBSENT(last) : conn->mss;
+  if (tcp_sack_send(dev, conn, last,
+                    TCP_WBSEQNO(last) + TCP_WBSENT(last) - len, len) > 0)
+    {
+      ninfo("TLP: probe retransmitted, endseq=%" PRIu32 "\n",
+            conn->sndseq_max);
+
+      conn->tlp_inflight = true;
+      conn->tlp_rexmit   = true;
+      conn->tlp_endseq   = conn->sndseq_max;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_rack_stop
+ *
+ * Description:
+ *   Stop the reordering and the probe timer of a connection.
+ *
+ ****************************************************************************/
+
+void tcp_rack_stop(FAR struct tcp_conn_s *conn)
+{
+  work_cancel(LPWORK, &conn->rack_work);
+  conn->rack_fired = false;
+}
+
+#endif /* CONFIG_NET_TCP_RACK */
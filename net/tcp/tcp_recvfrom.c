@@ -32,6 +32,7 @@
 #include <debug.h>
 #include <assert.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
@@ -42,6 +43,7 @@
 #include "netdev/netdev.h"
 #include "devif/devif.h"
 #include "tcp/tcp.h"
+#include "utils/utils.h"
 #include "socket/socket.h"
 
 /****************************************************************************
@@ -274,6 +276,13 @@ static inline void tcp_readahead(struct tcp_recvfrom_s *pstate)
           break;
         }
 
+#ifdef CONFIG_NET_LATENCY
+      net_latency_add(&conn->sconn.s_latency[NET_LATENCY_RECV],
+                      conn->rxstamp);
+#endif
+
+      tcp_autotune_rcvbuf(conn, recvlen);
+
       /* If we took all of the data from the I/O buffer chain is empty, then
        * release it.  If there is still data available in the I/O buffer
        * chain, then just trim the data that we have taken from the
@@ -436,7 +445,7 @@ static uint16_t tcp_recvhandler(FAR struct net_driver_s *dev,
                * allow any further TCP call backs.
                */
 
-              pstate->ir_cb->flags   = 0;
+              devif_callback_setflags(pstate->ir_cb, 0);
               pstate->ir_cb->priv    = NULL;
               pstate->ir_cb->event   = NULL;
 
@@ -764,8 +773,10 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
       state.ir_cb = tcp_callback_alloc(conn);
       if (state.ir_cb)
         {
-          state.ir_cb->flags   = (TCP_NEWDATA | TCP_DISCONN_EVENTS);
-          state.ir_cb->flags  |= (flags & MSG_WAITALL) ? TCP_WAITALL : 0;
+          devif_callback_setflags(state.ir_cb, TCP_NEWDATA |
+                                               TCP_DISCONN_EVENTS |
+                                               ((flags & MSG_WAITALL) ?
+                                                TCP_WAITALL : 0));
           state.ir_cb->priv    = (FAR void *)&state;
           state.ir_cb->event   = tcp_recvhandler;
 
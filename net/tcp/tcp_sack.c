@@ -0,0 +1,859 @@
+/****************************************************************************
+ * net/tcp/tcp_sack.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "utils/utils.h"
+#include "tcp/tcp.h"
+
+#ifdef NET_TCP_SACK_RECOVERY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* If both IPv4 and IPv6 support are both enabled, then we will need to build
+ * in some additional domain selection support.
+ */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define NEED_IPDOMAIN_SUPPORT 1
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_sack_parse
+ *
+ * Description:
+ *   Get the SACK blocks from the options of a received TCP header.
+ *
+ * Input Parameters:
+ *   tcp    - The TCP header
+ *   blocks - The returned SACK blocks, in the order they were sent
+ *
+ * Returned Value:
+ *   The number of SACK blocks
+ *
+ ****************************************************************************/
+
+static int tcp_sack_parse(FAR struct tcp_hdr_s *tcp,
+                          FAR struct tcp_sack_s *blocks)
+{
+  FAR uint8_t *sacks;
+  int optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  int nsack;
+  uint8_t opt;
+  int i;
+  int j;
+
+  for (i = 0; i < optlen; )
+    {
+      opt = tcp->optdata[i];
+      if (opt == TCP_OPT_END)
+        {
+          /* End of options. */
+
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          /* NOP option. */
+
+          i++;
+          continue;
+        }
+
+      /* All other options have a length field, so that we easily can
+       * skip past them.  If the length field is invalid, the options are
+       * malformed and we don't process them further.
+       */
+
+      if (i + 1 >= optlen || tcp->optdata[i + 1] < 2 ||
+          i + tcp->optdata[i + 1] > optlen)
+        {
+          break;
+        }
+
+      if (opt == TCP_OPT_SACK)
+        {
+          nsack = (tcp->optdata[i + 1] - TCP_OPT_SACK_PERM_LEN) /
+                  (sizeof(uint32_t) * 2);
+          if (nsack > TCP_SACK_RANGES_MAX)
+            {
+              nsack = TCP_SACK_RANGES_MAX;
+            }
+
+          sacks = &tcp->optdata[i + TCP_OPT_SACK_PERM_LEN];
+          for (j = 0; j < nsack; j++)
+            {
+              /* Use the pointer to avoid the error of 4 byte alignment. */
+
+              blocks[j].left  = tcp_getsequence(sacks + 8 * j);
+              blocks[j].right = tcp_getsequence(sacks + 8 * j + 4);
+            }
+
+          return nsack;
+        }
+
+      i += tcp->optdata[i + 1];
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_covered
+ *
+ * Description:
+ *   Check if the scoreboard already covers all of [left, right).
+ *
+ ****************************************************************************/
+
+static bool tcp_sack_covered(FAR struct tcp_conn_s *conn,
+                             uint32_t left, uint32_t right)
+{
+  int i;
+
+  for (i = 0; i < conn->sack_nsb; i++)
+    {
+      if (TCP_SEQ_LTE(conn->sack_sb[i].left, left) &&
+          TCP_SEQ_GTE(conn->sack_sb[i].right, right))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_add
+ *
+ * Description:
+ *   Merge the range [left, right) in the scoreboard, keeping the ranges
+ *   sorted and disjoint.  If the scoreboard is full, the highest range is
+ *   forgotten:  The loss detection only needs the ranges near snd_una.
+ *
+ ****************************************************************************/
+
+static void tcp_sack_add(FAR struct tcp_conn_s *conn,
+                         uint32_t left, uint32_t right)
+{
+  FAR struct tcp_sack_s *sb = conn->sack_sb;
+  int n = conn->sack_nsb;
+  int i;
+  int j;
+
+  /* Skip the ranges entirely below the new one */
+
+  for (i = 0; i < n && TCP_SEQ_LT(sb[i].right, left); i++);
+
+  /* Absorb the ranges overlapping or adjacent to the new one */
+
+  for (j = i; j < n && TCP_SEQ_LTE(sb[j].left, right); j++)
+    {
+      if (TCP_SEQ_LT(sb[j].left, left))
+        {
+          left = sb[j].left;
+        }
+
+      if (TCP_SEQ_GT(sb[j].right, right))
+        {
+          right = sb[j].right;
+        }
+    }
+
+  if (j == i)
+    {
+      /* Nothing absorbed, make room for a new range at i */
+
+      if (n == TCP_SACK_SCOREBOARD_MAX)
+        {
+          if (i == n)
+            {
+              return;
+            }
+
+          n--;
+        }
+
+      memmove(&sb[i + 1], &sb[i], (n - i) * sizeof(struct tcp_sack_s));
+      n++;
+    }
+  else
+    {
+      /* Replace sb[i..j) by the merged range */
+
+      memmove(&sb[i + 1], &sb[j], (n - j) * sizeof(struct tcp_sack_s));
+      n -= j - i - 1;
+    }
+
+  sb[i].left  = left;
+  sb[i].right = right;
+  conn->sack_nsb = n;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_trim
+ *
+ * Description:
+ *   Forget the part of the scoreboard that snd_una has passed.
+ *
+ ****************************************************************************/
+
+static void tcp_sack_trim(FAR struct tcp_conn_s *conn, uint32_t ackno)
+{
+  FAR struct tcp_sack_s *sb = conn->sack_sb;
+  int i;
+
+  for (i = 0; i < conn->sack_nsb && TCP_SEQ_LTE(sb[i].right, ackno); i++);
+
+  if (i > 0)
+    {
+      conn->sack_nsb -= i;
+      memmove(sb, &sb[i], conn->sack_nsb * sizeof(struct tcp_sack_s));
+    }
+
+  if (conn->sack_nsb > 0 && TCP_SEQ_LT(sb[0].left, ackno))
+    {
+      sb[0].left = ackno;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_sack_delivered
+ *
+ * Description:
+ *   Tell RACK about the write buffers that a new SACK block overlaps.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RACK
+static void tcp_sack_delivered(FAR struct tcp_conn_s *conn,
+                               uint32_t left, uint32_t right)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  uint32_t end;
+
+  for (wrb = tcp_sack_nextwrb(conn, NULL); wrb != NULL;
+       wrb = tcp_sack_nextwrb(conn, wrb))
+    {
+      if (TCP_SEQ_GTE(TCP_WBSEQNO(wrb), right))
+        {
+          break;
+        }
+
+      end = TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb);
+      if (TCP_SEQ_GT(end, left))
+        {
+          tcp_rack_delivered(conn, wrb,
+                             TCP_SEQ_LT(right, end) ? right : end);
+          TCP_WBFLAGS(wrb) |= TCP_WB_SACKED;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_sack_islost
+ *
+ * Description:
+ *   The IsLost() test of RFC 6675:  The data at 'seq' is lost if DupThresh
+ *   discontiguous ranges, or more than (DupThresh - 1) * SMSS bytes, were
+ *   SACKed above it.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_TCP_RACK
+static bool tcp_sack_islost(FAR struct tcp_conn_s *conn, uint32_t seq)
+{
+  uint32_t bytes = 0;
+  int nranges = 0;
+  int i;
+
+  for (i = conn->sack_nsb - 1; i >= 0; i--)
+    {
+      if (TCP_SEQ_LTE(conn->sack_sb[i].right, seq))
+        {
+          break;
+        }
+
+      nranges++;
+      bytes += TCP_SEQ_SUB(conn->sack_sb[i].right,
+                           TCP_SEQ_LT(conn->sack_sb[i].left, seq) ?
+                           seq : conn->sack_sb[i].left);
+    }
+
+  return nranges >= TCP_FAST_RETRANSMISSION_THRESH ||
+         bytes > (TCP_FAST_RETRANSMISSION_THRESH - 1) * conn->mss;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_detect
+ *
+ * Description:
+ *   Mark lost the outstanding write buffers that have a hole passing the
+ *   IsLost() test.  The holes are tested in sequence order:  Once one is
+ *   not lost, none above it is.
+ *
+ ****************************************************************************/
+
+static void tcp_sack_detect(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  uint32_t seq;
+  uint32_t len;
+
+  for (wrb = tcp_sack_nextwrb(conn, NULL); wrb != NULL;
+       wrb = tcp_sack_nextwrb(conn, wrb))
+    {
+      if ((TCP_WBFLAGS(wrb) & TCP_WB_LOST) != 0)
+        {
+          continue;
+        }
+
+      seq = TCP_WBSEQNO(wrb);
+      if (!tcp_sack_hole(conn, &seq, TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb),
+                         &len))
+        {
+          continue;
+        }
+
+      if (!tcp_sack_islost(conn, seq))
+        {
+          break;
+        }
+
+      tcp_sack_markloss(conn, wrb);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_sack_recovery
+ *
+ * Description:
+ *   Enter the loss recovery, and let the congestion control reduce cwnd
+ *   once for it.
+ *
+ ****************************************************************************/
+
+static void tcp_sack_recovery(FAR struct tcp_conn_s *conn)
+{
+  if (conn->sack_recovery)
+    {
+      return;
+    }
+
+  ninfo("SACK: enter recovery, recover=%" PRIu32 "\n", conn->sndseq_max);
+
+  conn->sack_recovery = true;
+  conn->sack_recover  = conn->sndseq_max;
+
+#ifdef CONFIG_NET_TCP_RACK
+  /* Go back to the default reordering window after 16 recoveries */
+
+  if (conn->rack_reopersist > 0 && --conn->rack_reopersist == 0)
+    {
+      conn->rack_reomult = 1;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+  if ((conn->flags & TCP_INFR) == 0)
+    {
+      conn->flags     |= TCP_INFT;
+      conn->fr_recover = conn->sndseq_max;
+      tcp_cc_update(conn, NULL);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_sack_nextwrb
+ *
+ * Description:
+ *   Walk the outstanding write buffers in sequence order:  The unacked_q,
+ *   then the partially sent head of the write_q.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_wrbuffer_s *
+tcp_sack_nextwrb(FAR struct tcp_conn_s *conn,
+                 FAR struct tcp_wrbuffer_s *wrb)
+{
+  FAR struct tcp_wrbuffer_s *head;
+  FAR sq_entry_t *entry;
+
+  head = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+  if (wrb == NULL)
+    {
+      entry = sq_peek(&conn->unacked_q);
+    }
+  else if (wrb == head)
+    {
+      return NULL;
+    }
+  else
+    {
+      entry = sq_next(&wrb->wb_node);
+    }
+
+  if (entry != NULL)
+    {
+      return (FAR struct tcp_wrbuffer_s *)entry;
+    }
+
+  return head != NULL && TCP_WBSENT(head) > 0 ? head : NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_hole
+ *
+ * Description:
+ *   Find the first range in [*seq, end) that the scoreboard does not
+ *   cover.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   seq  - The start of the search, and the returned start of the hole
+ *   end  - The end of the search
+ *   len  - The returned length of the hole
+ *
+ * Returned Value:
+ *   True if a hole was found.
+ *
+ ****************************************************************************/
+
+bool tcp_sack_hole(FAR struct tcp_conn_s *conn, FAR uint32_t *seq,
+                   uint32_t end, FAR uint32_t *len)
+{
+  FAR struct tcp_sack_s *sb = conn->sack_sb;
+  uint32_t start = *seq;
+  int i;
+
+  for (i = 0; i < conn->sack_nsb; i++)
+    {
+      if (TCP_SEQ_LTE(sb[i].right, start))
+        {
+          continue;
+        }
+
+      if (TCP_SEQ_GT(sb[i].left, start))
+        {
+          break;
+        }
+
+      start = sb[i].right;
+    }
+
+  if (TCP_SEQ_GTE(start, end))
+    {
+      return false;
+    }
+
+  if (i < conn->sack_nsb && TCP_SEQ_LT(sb[i].left, end))
+    {
+      end = sb[i].left;
+    }
+
+  *seq = start;
+  *len = TCP_SEQ_SUB(end, start);
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_bytes
+ *
+ * Description:
+ *   Return the number of bytes SACKed above 'seq'.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_sack_bytes(FAR struct tcp_conn_s *conn, uint32_t seq)
+{
+  uint32_t bytes = 0;
+  int i;
+
+  for (i = 0; i < conn->sack_nsb; i++)
+    {
+      if (TCP_SEQ_GT(conn->sack_sb[i].right, seq))
+        {
+          bytes += TCP_SEQ_SUB(conn->sack_sb[i].right,
+                               TCP_SEQ_LT(conn->sack_sb[i].left, seq) ?
+                               seq : conn->sack_sb[i].left);
+        }
+    }
+
+  return bytes;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_markloss
+ *
+ * Description:
+ *   Mark the holes of a write buffer for retransmission, and enter the
+ *   loss recovery if not yet in it.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   wrb  - The outstanding write buffer
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_sack_markloss(FAR struct tcp_conn_s *conn,
+                       FAR struct tcp_wrbuffer_s *wrb)
+{
+  ninfo("SACK: lost wrb=%p seqno=%" PRIu32 " sent=%u\n",
+        wrb, TCP_WBSEQNO(wrb), TCP_WBSENT(wrb));
+
+  TCP_WBFLAGS(wrb) |= TCP_WB_LOST;
+  TCP_WBRXTSEQ(wrb) = TCP_WBSEQNO(wrb);
+  tcp_sack_recovery(conn);
+}
+
+/****************************************************************************
+ * Name: tcp_sack_input
+ *
+ * Description:
+ *   Update the scoreboard with the SACK blocks of a received ACK (RFC
+ *   2018), ignoring the D-SACK blocks (RFC 2883), and detect the lost
+ *   segments with RACK (RFC 8985) or with the IsLost() rule of RFC 6675.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection of interest
+ *   tcp   - The TCP header of the ACK
+ *   ackno - The acknowledgement number of the ACK
+ *
+ * Assumptions:
+ *   The network is locked.  The ACKed write buffers were already released.
+ *
+ ****************************************************************************/
+
+void tcp_sack_input(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
+                    uint32_t ackno)
+{
+  struct tcp_sack_s blocks[TCP_SACK_RANGES_MAX];
+  bool dsack = false;
+  int nsack;
+  int i;
+
+  tcp_sack_trim(conn, ackno);
+
+  nsack = (tcp->tcpoffset & 0xf0) > 0x50 ? tcp_sack_parse(tcp, blocks) : 0;
+  for (i = 0; i < nsack; i++)
+    {
+      uint32_t left  = blocks[i].left;
+      uint32_t right = blocks[i].right;
+
+      ninfo("SACK: [%d] [%" PRIu32 " : %" PRIu32 "]\n", i, left, right);
+
+      /* A first block below the ACK or inside the second block is a
+       * D-SACK:  It reports a duplicate segment, not a hole.
+       */
+
+      if (i == 0 && (TCP_SEQ_LTE(right, ackno) ||
+                     (nsack > 1 &&
+                      TCP_SEQ_GTE(left, blocks[1].left) &&
+                      TCP_SEQ_LTE(right, blocks[1].right))))
+        {
+          dsack = true;
+          continue;
+        }
+
+      /* Drop the invalid blocks */
+
+      if (TCP_SEQ_GTE(left, right) || TCP_SEQ_LT(left, ackno) ||
+          TCP_SEQ_GT(right, conn->sndseq_max))
+        {
+          continue;
+        }
+
+      if (tcp_sack_covered(conn, left, right))
+        {
+          continue;
+        }
+
+      tcp_sack_add(conn, left, right);
+
+#ifdef CONFIG_NET_TCP_RACK
+      tcp_sack_delivered(conn, left, right);
+#endif
+    }
+
+  /* Exit the recovery when all the data outstanding at its start is
+   * acknowledged.
+   */
+
+  if (conn->sack_recovery && TCP_SEQ_GT(ackno, conn->sack_recover))
+    {
+      ninfo("SACK: exit recovery, ackno=%" PRIu32 "\n", ackno);
+      conn->sack_recovery = false;
+    }
+
+#ifdef CONFIG_NET_TCP_RACK
+  tcp_rack_ack(conn, ackno, dsack);
+  tcp_rack_detect(conn);
+#else
+  UNUSED(dsack);
+  tcp_sack_detect(conn);
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+  /* The congestion control reacted to the loss when the recovery started,
+   * don't let more duplicate ACKs start another fast retransmit.
+   */
+
+  conn->flags &= ~TCP_INFT;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_sack_send
+ *
+ * Description:
+ *   Set up the retransmission of 'len' bytes of an outstanding write
+ *   buffer, from the sequence number 'seq'.
+ *
+ * Input Parameters:
+ *   dev  - The device to send on
+ *   conn - The TCP connection of interest
+ *   wrb  - The outstanding write buffer
+ *   seq  - The first sequence number to send
+ *   len  - The number of bytes to send
+ *
+ * Returned Value:
+ *   The number of bytes set up to be sent; zero or a negated errno value
+ *   if the device could not take them.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_sack_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
+                  FAR struct tcp_wrbuffer_s *wrb, uint32_t seq,
+                  uint32_t len)
+{
+  int ret;
+
+  ninfo("SACK: REXMIT wrb=%p [%" PRIu32 " : %" PRIu32 "]\n",
+        wrb, seq, len);
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+  /* If both IPv4 and IPv6 support are enabled, then we will need to
+   * select which one to use when generating the outgoing packet.
+   */
+
+  tcp_ip_select(conn);
+#endif
+
+  tcp_setsequence(conn->sndseq, seq);
+
+#ifdef CONFIG_NET_JUMBO_FRAME
+  netdev_iob_prepare_dynamic(dev, len + tcpip_hdrsize(conn));
+#endif
+
+  ret = devif_iob_send(dev, TCP_WBIOB(wrb), len,
+                       TCP_SEQ_SUB(seq, TCP_WBSEQNO(wrb)),
+                       tcpip_hdrsize(conn));
+  if (ret > 0)
+    {
+      TCP_WBFLAGS(wrb) |= TCP_WB_REXMIT;
+#ifdef CONFIG_NET_TCP_RACK
+      wrb->wb_xmittime = clock_systime_ticks();
+#endif
+
+      /* Reset the retransmission timer. */
+
+      tcp_update_retrantimer(conn, conn->rto);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_rexmit
+ *
+ * Description:
+ *   Retransmit up to one MSS of the lowest hole of the write buffers that
+ *   are marked lost.
+ *
+ * Input Parameters:
+ *   dev  - The device to send on
+ *   conn - The TCP connection of interest
+ *
+ * Returned Value:
+ *   True if the device is used by a retransmission, and no new data may be
+ *   sent now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_sack_rexmit(FAR struct net_driver_s *dev,
+                     FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  uint32_t seq;
+  uint32_t len;
+
+  for (wrb = tcp_sack_nextwrb(conn, NULL); wrb != NULL;
+       wrb = tcp_sack_nextwrb(conn, wrb))
+    {
+      if ((TCP_WBFLAGS(wrb) & TCP_WB_LOST) == 0)
+        {
+          continue;
+        }
+
+      seq = TCP_WBRXTSEQ(wrb);
+      if (TCP_SEQ_LT(seq, TCP_WBSEQNO(wrb)))
+        {
+          seq = TCP_WBSEQNO(wrb);
+        }
+
+      if (!tcp_sack_hole(conn, &seq, TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb),
+                         &len))
+        {
+          /* All the holes of the buffer were retransmitted */
+
+          TCP_WBFLAGS(wrb) &= ~TCP_WB_LOST;
+          continue;
+        }
+
+      if (len > conn->mss)
+        {
+          len = conn->mss;
+        }
+
+      if (tcp_sack_send(dev, conn, wrb, seq, len) > 0)
+        {
+          TCP_WBRXTSEQ(wrb) = seq + len;
+        }
+
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_rto
+ *
+ * Description:
+ *   Handle the retransmission timeout.  The first timeout keeps the
+ *   scoreboard and marks all the outstanding data lost (RFC 6675,
+ *   section 5.1), so that only the holes are resent.  Another timeout
+ *   without progress may mean that the receiver reneged on its SACKs:
+ *   The scoreboard is cleared and the caller goes back to N.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ * Returned Value:
+ *   True if the holes will be retransmitted from the scoreboard; false if
+ *   the caller must retransmit all the outstanding data.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_sack_rto(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+
+  if (conn->sack_nsb == 0 || conn->nrtx > 1)
+    {
+      tcp_sack_reset(conn);
+      return false;
+    }
+
+  for (wrb = tcp_sack_nextwrb(conn, NULL); wrb != NULL;
+       wrb = tcp_sack_nextwrb(conn, wrb))
+    {
+      TCP_WBFLAGS(wrb) |= TCP_WB_LOST;
+      TCP_WBRXTSEQ(wrb) = TCP_WBSEQNO(wrb);
+    }
+
+  /* The timeout reduced cwnd, start a new recovery without another
+   * reduction.
+   */
+
+  conn->sack_recovery = true;
+  conn->sack_recover  = conn->sndseq_max;
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_reset
+ *
+ * Description:
+ *   Clear the scoreboard and the loss marks of the write buffers.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_sack_reset(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+
+  for (wrb = tcp_sack_nextwrb(conn, NULL); wrb != NULL;
+       wrb = tcp_sack_nextwrb(conn, wrb))
+    {
+      TCP_WBFLAGS(wrb) = 0;
+    }
+
+  conn->sack_nsb      = 0;
+  conn->sack_recovery = false;
+}
+
+#endif /* NET_TCP_SACK_RECOVERY */
@@ -48,6 +48,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <debug.h>
@@ -104,6 +105,65 @@ static inline FAR struct tcp_hdr_s *tcp_header(FAR struct net_driver_s *dev)
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: tcp_offload_chksum
+ *
+ * Description:
+ *   Leave the TCP checksum of the packet in d_buf to the device, if it can
+ *   complete it or if the packet is a super-segment.  Only the pseudo-
+ *   header is summed then.  The length is taken out of the pseudo-header
+ *   of a super-segment, the device adds that of each segment.
+ *
+ * Input Parameters:
+ *   dev   - The device driver structure to use in the send operation
+ *   tcp   - The TCP header of the packet
+ *   iplen - The size of the IP header
+ *
+ * Returned Value:
+ *   True if the checksum is left to the device
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+static bool tcp_offload_chksum(FAR struct net_driver_s *dev,
+                               FAR struct tcp_hdr_s *tcp,
+                               unsigned int iplen)
+{
+  uint32_t sum;
+
+  if (dev->d_gso_size == 0 &&
+      (dev->d_features & NETDEV_FEATURE_TXCSUM) == 0)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv6
+  if (IFF_IS_IPv6(dev->d_flags))
+    {
+      sum = ipv6_upperlayer_header_chksum(dev, IP_PROTO_TCP, iplen);
+    }
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv4
+      sum = ipv4_upperlayer_header_chksum(dev, IP_PROTO_TCP);
+#endif
+    }
+
+  if (dev->d_gso_size > 0)
+    {
+      sum += (uint16_t)~(dev->d_len - iplen);
+      sum  = (sum & 0xffff) + (sum >> 16);
+    }
+
+  tcp->tcpchksum     = HTONS((uint16_t)sum);
+  dev->d_offload    |= NETDEV_OFFLOAD_TXCSUM;
+  dev->d_csum_start  = iplen;
+  dev->d_csum_offset = offsetof(struct tcp_hdr_s, tcpchksum);
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_sendcommon
  *
@@ -149,7 +209,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
   else
     {
-      if (work_available(&conn->work) && conn->tx_unacked != 0)
+      if (!tcp_timer_pending(conn) && conn->tx_unacked != 0)
         {
           conn->timeout = false;
           tcp_update_retrantimer(conn, conn->rto);
@@ -177,6 +237,14 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
   tcp->urgp[0] = 0;
   tcp->urgp[1] = 0;
 
+#ifdef CONFIG_NET_TCP_GSO
+  /* Data beyond the MSS is a super-segment, that is cut in segments of
+   * one MSS before it goes out on the wire.
+   */
+
+  dev->d_gso_size = dev->d_sndlen > conn->mss ? conn->mss : 0;
+#endif
+
   /* Update device buffer length before setup the IP header */
 
   iob_update_pktlen(dev->d_iob, dev->d_len, false);
@@ -197,11 +265,16 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
 
       /* Calculate TCP checksum. */
 
-      tcp->tcpchksum = 0;
+#ifdef CONFIG_NETDEV_OFFLOAD
+      if (!tcp_offload_chksum(dev, tcp, IPv6_HDRLEN))
+#endif
+        {
+          tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
 #endif
+        }
 
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.ipv6.sent++;
@@ -221,11 +294,16 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
 
       /* Calculate TCP checksum. */
 
-      tcp->tcpchksum = 0;
+#ifdef CONFIG_NETDEV_OFFLOAD
+      if (!tcp_offload_chksum(dev, tcp, IPv4_HDRLEN))
+#endif
+        {
+          tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
 #endif
+        }
 
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.ipv4.sent++;
@@ -49,6 +49,7 @@
 #include <debug.h>
 
 #include <arch/irq.h>
+#include <nuttx/clock.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
@@ -235,6 +236,12 @@ static void retransmit_segment(FAR struct tcp_conn_s *conn,
 
       TCP_WBSENT(wrb) = 0;
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      /* The next ACK of the buffer may be for the original data */
+
+      TCP_WBFLAGS(wrb) = TCP_WB_REXMIT;
+#endif
+
       /* Insert the write buffer into the write_q (in sequence
        * number order).  The retransmission will occur below
        * when the write buffer with the lowest sequence number
@@ -273,7 +280,7 @@ static inline void psock_lost_connection(FAR struct tcp_conn_s *conn,
 
   if (conn->sndcb != NULL)
     {
-      conn->sndcb->flags = 0;
+      devif_callback_setflags(conn->sndcb, 0);
       conn->sndcb->event = NULL;
     }
 
@@ -319,97 +326,32 @@ static inline void psock_lost_connection(FAR struct tcp_conn_s *conn,
 }
 
 /****************************************************************************
- * Name: parse_sack
+ * Name: tcp_gso_maxlen
  *
  * Description:
- *   Parse sack from incoming TCP options
- *
- * Input Parameters:
- *   conn   - The TCP connection of interest
- *   tcp    - Header of tcp structure
- *   segs   - Segments edge of sacks
- *
- * Returned Value:
- *   Number of sacks
- *
- * Assumptions:
- *   The network is locked.
+ *   Get the most data that may be sent in one super-segment on 'dev':  A
+ *   multiple of the MSS that fits CONFIG_NET_TCP_GSO_MAXSIZE and the limit
+ *   of the device, with the headers.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
-static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
-                      FAR struct tcp_ofoseg_s *segs)
+#ifdef CONFIG_NET_TCP_GSO
+static uint32_t tcp_gso_maxlen(FAR struct net_driver_s *dev,
+                               FAR struct tcp_conn_s *conn)
 {
-  FAR struct tcp_sack_s *sacks;
-  int nsack = 0;
-  uint8_t opt;
-  int i;
+  uint32_t maxsize = CONFIG_NET_TCP_GSO_MAXSIZE;
+  uint32_t len;
 
-  /* Get the size of the link layer header,
-   * the IP and TCP header
-   */
-
-  for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
+  if (dev->d_gso_maxsize > 0 && dev->d_gso_maxsize < maxsize)
     {
-      opt = *(tcp->optdata + i);
-      if (opt == TCP_OPT_END)
-        {
-          /* End of options. */
-
-          break;
-        }
-      else if (opt == TCP_OPT_NOOP)
-        {
-          /* NOP option. */
-
-          ++i;
-          continue;
-        }
-      else if (opt == TCP_OPT_SACK)
-        {
-          nsack = (*(tcp->optdata + 1 + i) -
-                   TCP_OPT_SACK_PERM_LEN) /
-                   (sizeof(uint32_t) * 2);
-          sacks = (FAR struct tcp_sack_s *)
-                  (tcp->optdata + i +
-                   TCP_OPT_SACK_PERM_LEN);
-
-          for (i = 0; i < nsack; i++)
-            {
-              /* Use the pointer to avoid the error of 4 byte alignment. */
-
-              segs[i].left = tcp_getsequence((uint8_t *)&sacks[i]);
-              segs[i].right = tcp_getsequence((uint8_t *)&sacks[i] + 4);
-            }
-
-          tcp_reorder_ofosegs(nsack, segs);
-
-          break;
-        }
-      else
-        {
-          /* All other options have a length field,
-           * so that we easily can skip past them.
-           */
-
-          if (*(tcp->optdata + 1 + i) == 0)
-            {
-              /* If the length field is zero,
-               * the options are malformed and
-               * we don't process them further.
-               */
-
-              break;
-            }
-        }
-
-      i += *(tcp->optdata + 1 + i);
+      maxsize = dev->d_gso_maxsize;
     }
 
-  return nsack;
+  len = maxsize - tcpip_hdrsize(conn);
+  len = len - len % conn->mss;
+  return len > conn->mss ? len : conn->mss;
 }
-#endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
+#endif
 
 /****************************************************************************
  * Name: psock_send_eventhandler
@@ -435,10 +377,6 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                                         FAR void *pvpriv, uint16_t flags)
 {
   FAR struct tcp_conn_s *conn = pvpriv;
-#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
-  struct tcp_ofoseg_s ofosegs[TCP_SACK_RANGES_MAX];
-  uint8_t nsacks = 0;
-#endif
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
   uint32_t rexmitno = 0;
 #endif
@@ -536,6 +474,17 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                     wrb, TCP_WBSEQNO(wrb), lastseq, TCP_WBPKTLEN(wrb),
                     ackno);
 
+#ifdef CONFIG_NET_TCP_RACK
+              /* Data SACKed before was already seen delivered */
+
+              if ((conn->flags & TCP_SACK) != 0 &&
+                  (TCP_WBFLAGS(wrb) & TCP_WB_SACKED) == 0)
+                {
+                  tcp_rack_delivered(conn, wrb, TCP_SEQ_LT(ackno, lastseq) ?
+                                     ackno : lastseq);
+                }
+#endif
+
               /* Has the entire buffer been ACKed? */
 
               if (TCP_SEQ_GTE(ackno, lastseq))
@@ -606,14 +555,13 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 #endif
                 {
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
-                  if ((conn->flags & TCP_SACK) &&
-                      (tcp->tcpoffset & 0xf0) > 0x50)
+                  if ((conn->flags & TCP_SACK) != 0)
                     {
-                      /* Parse s-ack from tcp options */
-
-                      nsacks = parse_sack(conn, tcp, ofosegs);
+                      /* Retransmit the first unSACKed segment (RFC 6675),
+                       * the scoreboard tells which of the others are lost.
+                       */
 
-                      flags |= TCP_REXMIT;
+                      tcp_sack_markloss(conn, wrb);
                     }
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
                   else
@@ -663,6 +611,14 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                 " nacked=%" PRIu32 " sent=%u ackno=%" PRIu32 "\n",
                 wrb, TCP_WBSEQNO(wrb), nacked, TCP_WBSENT(wrb), ackno);
 
+#ifdef CONFIG_NET_TCP_RACK
+          if ((conn->flags & TCP_SACK) != 0 &&
+              (TCP_WBFLAGS(wrb) & TCP_WB_SACKED) == 0)
+            {
+              tcp_rack_delivered(conn, wrb, TCP_WBSEQNO(wrb) + nacked);
+            }
+#endif
+
           /* Trim the ACKed bytes from the beginning of the write buffer. */
 
           TCP_WBTRIM(wrb, nacked);
@@ -672,6 +628,15 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%" PRIu32 " pktlen=%u sent=%u\n",
                 wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb));
         }
+
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      /* Update the scoreboard and detect the lost segments */
+
+      if ((conn->flags & TCP_SACK) != 0)
+        {
+          tcp_sack_input(conn, tcp, ackno);
+        }
+#endif
     }
 
   /* Check for a loss of connection */
@@ -794,65 +759,34 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 #endif
 
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  /* With SACK, the holes marked lost are retransmitted before new data.
+   * A retransmission timeout marks all the holes lost, unless the
+   * scoreboard must be dropped and all the data retransmitted.
+   */
 
-  /* Check if we are being asked to retransmit s-ack data */
-
-  if (nsacks > 0)
+  if ((conn->flags & TCP_SACK) != 0 &&
+      ((flags & TCP_REXMIT) == 0 || tcp_sack_rto(conn)))
     {
-      FAR struct tcp_wrbuffer_s *wrb;
-      FAR sq_entry_t *entry;
-      FAR sq_entry_t *next;
-      uint32_t right;
-      int i;
-
-      /* Dump s-ack edge */
-
-      for (i = 0, right = 0; i < nsacks; i++)
+      if (dev->d_sndlen == 0 &&
+          (flags & (TCP_POLL | TCP_REXMIT | TCP_ACKDATA)) != 0)
         {
-          ninfo("TCP SACK [%d]"
-                "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n",
-                i, ofosegs[i].left, ofosegs[i].right,
-                TCP_SEQ_SUB(ofosegs[i].right, ofosegs[i].left));
-        }
-
-      for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
-        {
-          wrb  = (FAR struct tcp_wrbuffer_s *)entry;
-          next = sq_next(entry);
-
-          for (i = 0, right = 0; i < nsacks; i++)
+#ifdef CONFIG_NET_TCP_RACK
+          if ((flags & TCP_POLL) != 0 && conn->rack_fired &&
+              tcp_rack_timeout(dev, conn))
             {
-              /* Wrb seqno out of s-ack edge ? do retransmit ! */
-
-              if (TCP_SEQ_LT(TCP_WBSEQNO(wrb), ofosegs[i].left) &&
-                  TCP_SEQ_GTE(TCP_WBSEQNO(wrb), right))
-                {
-                  ninfo("TCP REXMIT "
-                        "[%" PRIu32 " : %" PRIu32 " : %d]\n",
-                        TCP_WBSEQNO(wrb),
-                        TCP_SEQ_ADD(TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb)),
-                        TCP_WBPKTLEN(wrb));
-                  sq_rem(entry, &conn->unacked_q);
-                  retransmit_segment(conn, (FAR void *)entry);
-                  break;
-                }
-
-              right = ofosegs[i].right;
+              return flags & ~TCP_POLL;
             }
-        }
-
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
-          /* After Fast retransmitted, set ssthresh to the maximum of
-           * the unacked and the 2*SMSS, and enter to Fast Recovery.
-           * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
-           * cwnd=ssthresh + 3*SMSS  referring to rfc5681
-           */
+#endif
 
-          if (conn->flags & TCP_INFT)
+          if (tcp_sack_rexmit(dev, conn))
             {
-              tcp_cc_update(conn, NULL);
+              /* Only one data can be sent by low level driver at once,
+               * tell the caller stop polling the other connection.
+               */
+
+              return flags & ~TCP_POLL;
             }
-#endif
+        }
     }
   else
 #endif
@@ -959,6 +893,11 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
     }
 
 #if CONFIG_NET_SEND_BUFSIZE > 0
+  if ((flags & TCP_ACKDATA) != 0)
+    {
+      tcp_autotune_sndbuf(conn);
+    }
+
   /* Notify the send buffer available if wrbbuffer drained */
 
   tcp_sendbuffer_notify(conn);
@@ -1026,15 +965,47 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 #else
       snd_wnd_edge = conn->snd_wl2 + conn->snd_wnd;
 #endif
+
+#ifdef CONFIG_NET_TCP_RACK
+      /* A loss probe with new data ignores the congestion window */
+
+      if (conn->tlp_newdata)
+        {
+          snd_wnd_edge = conn->snd_wl2 + conn->snd_wnd;
+        }
+#endif
+
       if (TCP_SEQ_LT(seq, snd_wnd_edge))
         {
           uint32_t remaining_snd_wnd;
+          uint32_t maxlen;
           int ret;
 
+          maxlen = conn->mss;
+#ifdef CONFIG_NET_TCP_GSO
+          /* Only a poll sends the packet through devif_poll_out(), where
+           * a super-segment is cut if the device cannot do it.
+           */
+
+          if ((flags & TCP_POLL) != 0)
+            {
+              maxlen = tcp_gso_maxlen(dev, conn);
+            }
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+          /* A loss probe is one segment */
+
+          if (conn->tlp_newdata)
+            {
+              maxlen = conn->mss;
+            }
+#endif
+
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > maxlen)
             {
-              sndlen = conn->mss;
+              sndlen = maxlen;
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1059,6 +1030,18 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               sndlen = CONFIG_IOB_BUFSIZE;
             }
 
+#ifdef CONFIG_NET_TCP_PACING
+          /* Wait for the pacing timer if the rate does not allow to send
+           * a segment now.
+           */
+
+          sndlen = tcp_pacing_limit(conn, sndlen);
+          if (sndlen == 0)
+            {
+              return flags;
+            }
+#endif
+
           ninfo("SEND: wrb=%p seq=%" PRIu32 " pktlen=%u sent=%u sndlen=%zu "
                 "mss=%u snd_wnd=%" PRIu32 " seq=%" PRIu32
                 " remaining_snd_wnd=%" PRIu32 "\n",
@@ -1122,6 +1105,15 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
           if (TCP_SEQ_GT(predicted_seqno, conn->sndseq_max))
             {
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+              /* Time the RTT with new data only */
+
+              if (TCP_SEQ_GTE(seq, conn->sndseq_max))
+                {
+                  tcp_cc_sent(conn, seq, sndlen);
+                }
+#endif
+
                conn->sndseq_max = predicted_seqno;
             }
 
@@ -1129,10 +1121,22 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                 " sent=%" PRIu32 "\n",
                 wrb, TCP_WBNRTX(wrb), conn->tx_unacked, conn->sent);
 
+#ifdef CONFIG_NET_LATENCY
+          if (TCP_WBSENT(wrb) == 0 && TCP_WBNRTX(wrb) == 0)
+            {
+              net_latency_add(&conn->sconn.s_latency[NET_LATENCY_SEND],
+                              wrb->wb_stamp);
+            }
+#endif
+
           /* Increment the count of bytes sent from this write buffer */
 
           TCP_WBSENT(wrb) += sndlen;
 
+#ifdef CONFIG_NET_TCP_RACK
+          tcp_rack_sent(conn, wrb);
+#endif
+
           ninfo("SEND: wrb=%p sent=%u pktlen=%u\n",
                 wrb, TCP_WBSENT(wrb), TCP_WBPKTLEN(wrb));
 
@@ -1193,6 +1197,15 @@ static uint32_t tcp_max_wrb_size(FAR struct tcp_conn_s *conn)
 
   size = 4 * mss;
 
+#ifdef CONFIG_NET_TCP_GSO
+  /* or a whole super-segment */
+
+  if (size < CONFIG_NET_TCP_GSO_MAXSIZE)
+    {
+      size = CONFIG_NET_TCP_GSO_MAXSIZE;
+    }
+#endif
+
   /* but it should not hog too many IOB buffers */
 
   if (size > CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE / 2)
@@ -1312,6 +1325,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   bool       nonblock;
   int        ret = OK;
   clock_t    start;
+#ifdef CONFIG_NET_LATENCY
+  clock_t    stamp = perf_gettime();
+#endif
 
   if (psock == NULL || psock->s_type != SOCK_STREAM ||
       psock->s_conn == NULL)
@@ -1411,8 +1427,8 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
       /* Set up the callback in the connection */
 
-      conn->sndcb->flags = (TCP_ACKDATA | TCP_REXMIT | TCP_POLL |
-                               TCP_DISCONN_EVENTS);
+      devif_callback_setflags(conn->sndcb, TCP_ACKDATA | TCP_REXMIT |
+                                           TCP_POLL | TCP_DISCONN_EVENTS);
       conn->sndcb->priv  = (FAR void *)conn;
       conn->sndcb->event = psock_send_eventhandler;
 
@@ -1503,6 +1519,15 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
               goto errout_with_lock;
             }
 
+#ifdef CONFIG_NET_LATENCY
+          /* A coalesced buffer keeps the time of its oldest data */
+
+          if (TCP_WBPKTLEN(wrb) == 0)
+            {
+              wrb->wb_stamp = stamp;
+            }
+#endif
+
           /* Initialize the write buffer */
 
           TCP_WBSEQNO(wrb) = (unsigned)-1;
@@ -403,7 +403,7 @@ end_wait:
 
   DEBUGASSERT(pstate->snd_cb != NULL);
 
-  pstate->snd_cb->flags   = 0;
+  devif_callback_setflags(pstate->snd_cb, 0);
   pstate->snd_cb->priv    = NULL;
   pstate->snd_cb->event   = NULL;
 
@@ -587,8 +587,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock,
 
           /* Set up the callback in the connection */
 
-          state.snd_cb->flags   = (TCP_ACKDATA | TCP_REXMIT | TCP_POLL |
-                                   TCP_DISCONN_EVENTS);
+          devif_callback_setflags(state.snd_cb, TCP_ACKDATA | TCP_REXMIT |
+                                                TCP_POLL |
+                                                TCP_DISCONN_EVENTS);
           state.snd_cb->priv    = (FAR void *)&state;
           state.snd_cb->event   = tcpsend_eventhandler;
 
@@ -42,8 +42,11 @@
 #include <debug.h>
 
 #include <arch/irq.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
 #include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -90,12 +93,231 @@ struct sendfile_s
 #endif
   int                snd_dup_acks;         /* Duplicate ACK counter */
 #endif
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  sq_entry_t         snd_node;             /* Link in g_sendfile_maps */
+  FAR uint8_t       *snd_map;              /* File data accessed in place */
+  bool               snd_unmap;            /* snd_map must be unmapped */
+  bool               snd_waiting;          /* Waiting for snd_nrefs == 0 */
+  int                snd_nrefs;            /* IOBs referring to snd_map */
+  sem_t              snd_refsem;           /* Posted at snd_nrefs == 0 */
+#endif
 };
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+/* The operations whose data has to be unmapped.  A released I/O buffer is
+ * matched to its operation by address, so the mapped ranges may not
+ * overlap.
+ */
+
+static sq_queue_t g_sendfile_maps;
+static spinlock_t g_sendfile_lock = SP_UNLOCKED;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+/****************************************************************************
+ * Name: sendfile_iob_free
+ *
+ * Description:
+ *   Called when an I/O buffer that refers to mapped file data is released.
+ *
+ ****************************************************************************/
+
+static void sendfile_iob_free(FAR void *data)
+{
+  FAR uint8_t *addr = data;
+  FAR sem_t *sem = NULL;
+  FAR sq_entry_t *node;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_sendfile_lock);
+
+  for (node = sq_peek(&g_sendfile_maps); node != NULL; node = sq_next(node))
+    {
+      FAR struct sendfile_s *pstate =
+        container_of(node, struct sendfile_s, snd_node);
+
+      if (addr >= pstate->snd_map &&
+          addr < pstate->snd_map + pstate->snd_flen)
+        {
+          if (--pstate->snd_nrefs == 0 && pstate->snd_waiting)
+            {
+              sem = &pstate->snd_refsem;
+            }
+
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_sendfile_lock, flags);
+
+  if (sem != NULL)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: sendfile_map
+ *
+ * Description:
+ *   Try to access the file data in place.  snd_map is left NULL if the data
+ *   has to be read into the I/O buffers.
+ *
+ ****************************************************************************/
+
+static void sendfile_map(FAR struct sendfile_s *pstate)
+{
+  FAR sq_entry_t *node;
+  FAR uint8_t *start;
+  FAR void *mapped;
+  irqstate_t flags;
+  int ret;
+
+  ret = file_mmap_direct(pstate->snd_file, pstate->snd_flen,
+                         pstate->snd_foffset, &mapped);
+  if (ret < 0)
+    {
+      return;
+    }
+  else if (ret == 0)
+    {
+      /* A static address, e.g. a ROMFS image in XIP memory */
+
+      pstate->snd_map = mapped;
+      return;
+    }
+
+  /* The mapping can be released only when the network driver has released
+   * all of the I/O buffers that refer to it.  Copy the data instead if the
+   * I/O buffers could not be told apart from those of another operation.
+   */
+
+  start = mapped;
+  flags = spin_lock_irqsave(&g_sendfile_lock);
+
+  for (node = sq_peek(&g_sendfile_maps); node != NULL; node = sq_next(node))
+    {
+      FAR struct sendfile_s *other =
+        container_of(node, struct sendfile_s, snd_node);
+
+      if (start < other->snd_map + other->snd_flen &&
+          other->snd_map < start + pstate->snd_flen)
+        {
+          break;
+        }
+    }
+
+  if (node == NULL)
+    {
+      nxsem_init(&pstate->snd_refsem, 0, 0);
+      pstate->snd_map   = start;
+      pstate->snd_unmap = true;
+      sq_addlast(&pstate->snd_node, &g_sendfile_maps);
+    }
+
+  spin_unlock_irqrestore(&g_sendfile_lock, flags);
+
+  if (node != NULL)
+    {
+      file_munmap(mapped, pstate->snd_flen);
+    }
+}
+
+/****************************************************************************
+ * Name: sendfile_unmap
+ *
+ * Description:
+ *   Wait until no I/O buffer refers to the mapped data, then unmap it.
+ *
+ ****************************************************************************/
+
+static void sendfile_unmap(FAR struct sendfile_s *pstate)
+{
+  irqstate_t flags;
+  bool wait;
+
+  if (!pstate->snd_unmap)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_sendfile_lock);
+  wait  = pstate->snd_nrefs > 0;
+  pstate->snd_waiting = wait;
+  spin_unlock_irqrestore(&g_sendfile_lock, flags);
+
+  if (wait)
+    {
+      nxsem_wait_uninterruptible(&pstate->snd_refsem);
+    }
+
+  flags = spin_lock_irqsave(&g_sendfile_lock);
+  sq_rem(&pstate->snd_node, &g_sendfile_maps);
+  spin_unlock_irqrestore(&g_sendfile_lock, flags);
+
+  nxsem_destroy(&pstate->snd_refsem);
+  file_munmap(pstate->snd_map, pstate->snd_flen);
+}
+#endif
+
+/****************************************************************************
+ * Name: sendfile_send
+ *
+ * Description:
+ *   Set up the device buffer to send 'sndlen' bytes from file offset
+ *   'offset'.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static int sendfile_send(FAR struct net_driver_s *dev,
+                         FAR struct sendfile_s *pstate,
+                         uint32_t sndlen, off_t offset)
+{
+  FAR struct tcp_conn_s *conn = pstate->snd_conn;
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  /* Refer to mapped data instead of copying it.  Not on the loopback
+   * device:  The receive path modifies the I/O buffers of the packet.
+   */
+
+  if (pstate->snd_map != NULL && dev->d_lltype != NET_LL_LOOPBACK)
+    {
+      int ret = devif_ref_send(dev,
+                               pstate->snd_map +
+                               (offset - pstate->snd_foffset),
+                               sndlen, tcpip_hdrsize(conn),
+                               sendfile_iob_free);
+      if (ret >= 0)
+        {
+          if (ret > 0 && pstate->snd_unmap)
+            {
+              irqstate_t flags = spin_lock_irqsave(&g_sendfile_lock);
+              pstate->snd_nrefs++;
+              spin_unlock_irqrestore(&g_sendfile_lock, flags);
+            }
+
+          return OK;
+        }
+
+      /* Try to copy the data instead */
+    }
+#endif
+
+  return devif_file_send(dev, pstate->snd_file, sndlen, offset,
+                         tcpip_hdrsize(conn));
+}
+
 /****************************************************************************
  * Name: sendfile_eventhandler
  *
@@ -269,9 +491,8 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
        * happen until the polling cycle completes).
        */
 
-      ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                            pstate->snd_foffset + pstate->snd_acked,
-                            tcpip_hdrsize(conn));
+      ret = sendfile_send(dev, pstate, sndlen,
+                          pstate->snd_foffset + pstate->snd_acked);
       if (ret < 0)
         {
           nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -340,9 +561,8 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                                pstate->snd_foffset + pstate->snd_sent,
-                                tcpip_hdrsize(conn));
+          ret = sendfile_send(dev, pstate, sndlen,
+                              pstate->snd_foffset + pstate->snd_sent);
           if (ret < 0)
             {
               nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -375,7 +595,7 @@ end_wait:
 
   DEBUGASSERT(pstate->snd_cb != NULL);
 
-  pstate->snd_cb->flags   = 0;
+  devif_callback_setflags(pstate->snd_cb, 0);
   pstate->snd_cb->priv    = NULL;
   pstate->snd_cb->event   = NULL;
 
@@ -470,6 +690,18 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
       return startpos;
     }
 
+  memset(&state, 0, sizeof(struct sendfile_s));
+
+  state.snd_foffset = offset ? *offset : startpos; /* Input file offset */
+  state.snd_flen    = count;                       /* Number of bytes to send */
+  state.snd_file    = infile;                      /* File to read from */
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  /* Mapping the file may block, do it before locking the network */
+
+  sendfile_map(&state);
+#endif
+
   /* Initialize the state structure.  This is done with the network
    * locked because we don't want anything to happen until we are
    * ready.
@@ -479,13 +711,9 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->sendfile = true;
 #endif
-  memset(&state, 0, sizeof(struct sendfile_s));
   nxsem_init(&state.snd_sem, 0, 0);                /* Doesn't really fail */
 
   state.snd_conn    = conn;                        /* Tcp conn to use */
-  state.snd_foffset = offset ? *offset : startpos; /* Input file offset */
-  state.snd_flen    = count;                       /* Number of bytes to send */
-  state.snd_file    = infile;                      /* File to read from */
 
   /* Allocate resources to receive a callback */
 
@@ -510,8 +738,8 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 
   /* Set up the callback in the connection */
 
-  state.snd_cb->flags    = (TCP_ACKDATA | TCP_REXMIT | TCP_POLL |
-                            TCP_DISCONN_EVENTS);
+  devif_callback_setflags(state.snd_cb, TCP_ACKDATA | TCP_REXMIT | TCP_POLL |
+                                        TCP_DISCONN_EVENTS);
   state.snd_cb->priv     = (FAR void *)&state;
   state.snd_cb->event    = sendfile_eventhandler;
 
@@ -545,6 +773,19 @@ errout_locked:
 #endif
   net_unlock();
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  sendfile_unmap(&state);
+
+  /* The data accessed in place was not read:  Move the file position as
+   * the reads would have.
+   */
+
+  if (state.snd_map != NULL && state.snd_sent > 0)
+    {
+      file_seek(infile, state.snd_foffset + state.snd_sent, SEEK_SET);
+    }
+#endif
+
   /* Return the current file position */
 
   if (offset)
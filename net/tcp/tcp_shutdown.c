@@ -60,7 +60,7 @@ static uint16_t tcp_shutdown_eventhandler(FAR struct net_driver_s *dev,
 
   if (conn->sndcb != NULL)
     {
-      conn->sndcb->flags = 0;
+      devif_callback_setflags(conn->sndcb, 0);
       conn->sndcb->event = NULL;
 
       /* The callback will be freed by tcp_free. */
@@ -122,7 +122,7 @@ static inline int tcp_send_fin(FAR struct socket *psock)
 
       /* Set up to receive TCP data event callbacks */
 
-      conn->shdcb->flags = TCP_POLL;
+      devif_callback_setflags(conn->shdcb, TCP_POLL);
       conn->shdcb->event = tcp_shutdown_eventhandler;
       conn->shdcb->priv  = conn; /* reference for event handler to free cb */
 
@@ -0,0 +1,384 @@
+/****************************************************************************
+ * net/tcp/tcp_syncookie.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+#include <sys/param.h>
+
+#include <crypto/siphash.h>
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A cookie is the initial sequence number of the SYN-ACK:
+ *
+ *   bits 31-27  The time counter, in 64 second units
+ *   bits 26-24  The index of the peer MSS in g_tcp_cookiemss
+ *   bits 23-0   A keyed hash of the addresses, the ports, the peer
+ *               initial sequence number and the time counter
+ */
+
+#define TCP_COOKIE_PERIOD   SEC2TICK(64)
+#define TCP_COOKIE_TSHIFT   27
+#define TCP_COOKIE_TMASK    0x1f
+#define TCP_COOKIE_MSSSHIFT 24
+#define TCP_COOKIE_MSSMASK  0x07
+#define TCP_COOKIE_HASHMASK 0x00ffffff
+
+/* A cookie is still accepted one period after it was sent */
+
+#define TCP_COOKIE_MAXAGE   1
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The MSS values that can be encoded, in increasing order */
+
+static const uint16_t g_tcp_cookiemss[] =
+{
+  536, 1024, 1220, 1300, 1360, 1440, 1460, 8960
+};
+
+static SIPHASH_KEY g_tcp_cookiekey;
+
+/* The stand-in for the connection when the SYN-ACK of a cookie is sent */
+
+static struct tcp_conn_s g_tcp_cookieconn;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cookie_hash
+ *
+ * Description:
+ *   Calculate the hash part of a cookie.
+ *
+ * Input Parameters:
+ *   conn  - The addresses and the ports of the connection.
+ *   isn   - The initial sequence number of the peer.
+ *   count - The time counter.
+ *
+ * Returned Value:
+ *   The 24 bit hash.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cookie_hash(FAR struct tcp_conn_s *conn, uint32_t isn,
+                                uint32_t count)
+{
+  const size_t addrlen = net_ip_domain_select(conn->domain,
+                                  sizeof(in_addr_t), sizeof(net_ipv6addr_t));
+  SIPHASH_CTX ctx;
+
+  /* Make sure we have a secret key */
+
+  if (g_tcp_cookiekey.k0 == 0 && g_tcp_cookiekey.k1 == 0)
+    {
+      net_getrandom(&g_tcp_cookiekey, sizeof(g_tcp_cookiekey));
+    }
+
+  siphash_init(&ctx, &g_tcp_cookiekey);
+  siphash_update(&ctx, 2, 4, net_ip_binding_laddr(&conn->u, conn->domain),
+                 addrlen);
+  siphash_update(&ctx, 2, 4, &conn->lport, sizeof(conn->lport));
+  siphash_update(&ctx, 2, 4, net_ip_binding_raddr(&conn->u, conn->domain),
+                 addrlen);
+  siphash_update(&ctx, 2, 4, &conn->rport, sizeof(conn->rport));
+  siphash_update(&ctx, 2, 4, &isn, sizeof(isn));
+  siphash_update(&ctx, 2, 4, &count, sizeof(count));
+
+  return (uint32_t)siphash_end(&ctx, 2, 4) & TCP_COOKIE_HASHMASK;
+}
+
+/****************************************************************************
+ * Name: tcp_cookie_count
+ *
+ * Description:
+ *   Return the current value of the cookie time counter.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cookie_count(void)
+{
+  return (uint32_t)(clock_systime_ticks() / TCP_COOKIE_PERIOD);
+}
+
+/****************************************************************************
+ * Name: tcp_cookie_setup
+ *
+ * Description:
+ *   Fill in the addresses and the ports of the stand-in connection from
+ *   the incoming packet.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s *
+tcp_cookie_setup(FAR struct net_driver_s *dev, FAR struct tcp_hdr_s *tcp,
+                 FAR struct tcp_conn_s *listener)
+{
+  FAR struct tcp_conn_s *conn = &g_tcp_cookieconn;
+
+  memset(conn, 0, sizeof(*conn));
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ip = IPv6BUF;
+
+      conn->domain = PF_INET6;
+      conn->mss    = TCP_DEFAULT_IPv6_MSS;
+      net_ipv6addr_copy(conn->u.ipv6.raddr, ip->srcipaddr);
+      net_ipv6addr_copy(conn->u.ipv6.laddr, ip->destipaddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ip = IPv4BUF;
+
+      conn->domain = PF_INET;
+      conn->mss    = TCP_DEFAULT_IPv4_MSS;
+      net_ipv4addr_copy(conn->u.ipv4.raddr,
+                        net_ip4addr_conv32(ip->srcipaddr));
+      net_ipv4addr_copy(conn->u.ipv4.laddr,
+                        net_ip4addr_conv32(ip->destipaddr));
+    }
+#endif
+
+  conn->dev           = dev;
+  conn->lport         = tcp->destport;
+  conn->rport         = tcp->srcport;
+  conn->tcpstateflags = TCP_SYN_RCVD;
+  conn->sconn.s_ttl   = listener->sconn.s_ttl;
+  conn->sconn.s_tos   = listener->sconn.s_tos;
+#if CONFIG_NET_RECV_BUFSIZE > 0
+  conn->rcv_bufs      = listener->rcv_bufs;
+#endif
+#ifdef CONFIG_NET_TCPPROTO_OPTIONS
+  conn->user_mss      = listener->user_mss;
+#endif
+
+  return conn;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_syncookie_conn
+ *
+ * Description:
+ *   Prepare the stand-in connection that answers a SYN with a cookie.  The
+ *   caller may parse the TCP options of the SYN into it before
+ *   tcp_syncookie_synack() is called.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the SYN.
+ *   tcp      - The TCP header of the SYN.
+ *   listener - The listening connection.
+ *
+ * Returned Value:
+ *   The stand-in connection.  It is not allocated from the connection pool
+ *   and is only valid until the network is unlocked.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_syncookie_conn(FAR struct net_driver_s *dev,
+                                          FAR struct tcp_hdr_s *tcp,
+                                          FAR struct tcp_conn_s *listener)
+{
+  FAR struct tcp_conn_s *conn = tcp_cookie_setup(dev, tcp, listener);
+
+  /* rcvseq acknowledges the SYN */
+
+  memcpy(conn->rcvseq, tcp->seqno, 4);
+  net_incr32(conn->rcvseq, 1);
+  return conn;
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_synack
+ *
+ * Description:
+ *   Send the SYN-ACK of a stand-in connection, with a cookie as the initial
+ *   sequence number.  Nothing is kept about the connection until the ACK
+ *   returns the cookie.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure to use in the send operation.
+ *   conn - The stand-in connection from tcp_syncookie_conn().
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_syncookie_synack(FAR struct net_driver_s *dev,
+                          FAR struct tcp_conn_s *conn)
+{
+  uint32_t count = tcp_cookie_count();
+  uint32_t isn = tcp_getsequence(conn->rcvseq) - 1;
+  uint32_t cookie;
+  int index;
+
+  /* Encode the largest MSS that does not exceed the peer MSS */
+
+  for (index = nitems(g_tcp_cookiemss) - 1; index > 0; index--)
+    {
+      if (g_tcp_cookiemss[index] <= conn->mss)
+        {
+          break;
+        }
+    }
+
+  cookie = (count & TCP_COOKIE_TMASK) << TCP_COOKIE_TSHIFT |
+           (uint32_t)index << TCP_COOKIE_MSSSHIFT |
+           tcp_cookie_hash(conn, isn, count);
+
+  /* There is no state to keep the window scale or SACK permitted options
+   * of the SYN, so these are not negotiated.
+   */
+
+  conn->flags = 0;
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  conn->rcv_scale = 0;
+#endif
+
+  tcp_setsequence(conn->sndseq, cookie);
+  tcp_synack(dev, conn, TCP_ACK | TCP_SYN);
+
+  ninfo("SYN cookie %08" PRIx32 " sent to port %u\n",
+        cookie, NTOHS(conn->rport));
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_accept
+ *
+ * Description:
+ *   Check if an ACK to a listening port returns a cookie.  If so, allocate
+ *   the connection in the TCP_SYN_RCVD state, as though the SYN had been
+ *   accepted with the sequence number of the cookie.  The caller then
+ *   completes the handshake with the ACK.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure holding the ACK.
+ *   tcp      - The TCP header of the ACK.
+ *   listener - The listening connection.
+ *   accept   - The location to return the new connection.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the ACK does not hold a valid cookie;
+ *   -ENOMEM if no connection is available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_syncookie_accept(FAR struct net_driver_s *dev,
+                         FAR struct tcp_hdr_s *tcp,
+                         FAR struct tcp_conn_s *listener,
+                         FAR struct tcp_conn_s **accept)
+{
+  FAR struct tcp_conn_s *conn;
+  uint32_t cookie = tcp_getsequence(tcp->ackno) - 1;
+  uint32_t isn = tcp_getsequence(tcp->seqno) - 1;
+  uint32_t count = tcp_cookie_count();
+  uint32_t age;
+
+  age = (count - (cookie >> TCP_COOKIE_TSHIFT)) & TCP_COOKIE_TMASK;
+  if (age > TCP_COOKIE_MAXAGE)
+    {
+      return -EINVAL;
+    }
+
+  count -= age;
+  conn   = tcp_cookie_setup(dev, tcp, listener);
+  if ((cookie & TCP_COOKIE_HASHMASK) != tcp_cookie_hash(conn, isn, count))
+    {
+      return -EINVAL;
+    }
+
+  if (!tcp_backlogavailable(listener))
+    {
+      return -ENOMEM;
+    }
+
+  conn = tcp_alloc_accept(dev, tcp, listener);
+  if (conn == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* tcp_alloc_accept() took rcvseq from the ACK, which is already one past
+   * the SYN.  Restore what the SYN-ACK of the cookie sent.
+   */
+
+  conn->crefs = 1;
+  conn->mss   = g_tcp_cookiemss[(cookie >> TCP_COOKIE_MSSSHIFT) &
+                                TCP_COOKIE_MSSMASK];
+  tcp_setsequence(conn->sndseq, cookie);
+#if !defined(CONFIG_NET_TCP_WRITE_BUFFERS)
+  conn->rexmit_seq = cookie;
+#endif
+
+  ninfo("SYN cookie %08" PRIx32 " accepted on port %u\n",
+        cookie, NTOHS(conn->lport));
+
+  *accept = conn;
+  return OK;
+}
+
+#endif /* CONFIG_NET_TCP_SYNCOOKIES */
@@ -53,6 +53,10 @@
 #include <time.h>
 #include <stdlib.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -78,6 +82,45 @@
 
 #define ACK_DELAY (1)
 
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+#  define TCP_WHEEL_SLOT(hsec) ((hsec) % CONFIG_NET_TCP_TIMER_WHEEL_SLOTS)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+/* The timers of all of the connections.  A connection expiring at tick t is
+ * in the slot of the first half-second boundary at or after t, the slots
+ * up to the one of half-second 'next' have been expired.
+ */
+
+struct tcp_wheel_s
+{
+  struct work_s work;      /* Expires the slots */
+  clock_t next;            /* The next half-second to expire */
+  unsigned int count;      /* Number of armed timers */
+  dq_queue_t slots[CONFIG_NET_TCP_TIMER_WHEEL_SLOTS];
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+static struct tcp_wheel_s g_tcp_wheel;
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+static void tcp_wheel_expiry(FAR void *arg);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -141,6 +184,7 @@ static int tcp_get_timeout(FAR struct tcp_conn_s *conn)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NET_TCP_TIMER_WHEEL
 static void tcp_timer_expiry(FAR void *arg)
 {
   FAR struct tcp_conn_s *conn = NULL;
@@ -159,6 +203,177 @@ static void tcp_timer_expiry(FAR void *arg)
 
   net_unlock();
 }
+#else
+
+/****************************************************************************
+ * Name: tcp_wheel_remove
+ *
+ * Description:
+ *   Disarm the timer of a connection.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_wheel_remove(FAR struct tcp_conn_s *conn)
+{
+  clock_t hsec = div_const_roundup(conn->texpire, TICK_PER_HSEC);
+
+  dq_rem(&conn->tnode, &g_tcp_wheel.slots[TCP_WHEEL_SLOT(hsec)]);
+  conn->texpire = 0;
+  g_tcp_wheel.count--;
+}
+
+/****************************************************************************
+ * Name: tcp_wheel_schedule
+ *
+ * Description:
+ *   Queue the wheel work for the next half-second boundary.
+ *
+ ****************************************************************************/
+
+static void tcp_wheel_schedule(void)
+{
+  clock_t now = clock_systime_ticks();
+  clock_t at = g_tcp_wheel.next * TICK_PER_HSEC;
+
+  work_queue(LPWORK, &g_tcp_wheel.work, tcp_wheel_expiry, NULL,
+             (sclock_t)(at - now) > 0 ? at - now : 0);
+}
+
+/****************************************************************************
+ * Name: tcp_wheel_expiry
+ *
+ * Description:
+ *   Expire the slots of the half-seconds elapsed, and notify the devices of
+ *   the connections due.  All of them are handled with the network locked
+ *   once.
+ *
+ ****************************************************************************/
+
+static void tcp_wheel_expiry(FAR void *arg)
+{
+  FAR struct net_driver_s *notified = NULL;
+  FAR struct tcp_conn_s *conn;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
+  clock_t now;
+  clock_t last;
+  clock_t hsec;
+
+  net_lock();
+
+  now  = clock_systime_ticks();
+  last = now / TICK_PER_HSEC;
+
+  /* Visit each slot once even if the wheel is late by a whole turn */
+
+  hsec = g_tcp_wheel.next;
+  if ((sclock_t)(last - hsec) >= CONFIG_NET_TCP_TIMER_WHEEL_SLOTS)
+    {
+      hsec = last - CONFIG_NET_TCP_TIMER_WHEEL_SLOTS + 1;
+    }
+
+  for (; (sclock_t)(last - hsec) >= 0; hsec++)
+    {
+      for (entry = dq_peek(&g_tcp_wheel.slots[TCP_WHEEL_SLOT(hsec)]);
+           entry != NULL; entry = next)
+        {
+          next = dq_next(entry);
+          conn = container_of(entry, struct tcp_conn_s, tnode);
+
+          /* A later turn of the wheel? */
+
+          if ((sclock_t)(conn->texpire - now) > 0)
+            {
+              continue;
+            }
+
+          tcp_wheel_remove(conn);
+          conn->timeout = true;
+
+          /* Connections of a slot often share the device */
+
+          if (conn->dev != notified)
+            {
+              netdev_txnotify_dev(conn->dev);
+              notified = conn->dev;
+            }
+        }
+    }
+
+  g_tcp_wheel.next = last + 1;
+  if (g_tcp_wheel.count > 0)
+    {
+      tcp_wheel_schedule();
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: tcp_wheel_insert
+ *
+ * Description:
+ *   Arm the timer of a connection to expire in 'ticks'.
+ *
+ * Assumptions:
+ *   The network is locked and the timer is not armed.
+ *
+ ****************************************************************************/
+
+static void tcp_wheel_insert(FAR struct tcp_conn_s *conn, clock_t ticks)
+{
+  clock_t now = clock_systime_ticks();
+  clock_t hsec;
+
+  /* 0 means not armed */
+
+  conn->texpire = now + ticks != 0 ? now + ticks : 1;
+  hsec = div_const_roundup(conn->texpire, TICK_PER_HSEC);
+  dq_addlast(&conn->tnode, &g_tcp_wheel.slots[TCP_WHEEL_SLOT(hsec)]);
+
+  if (g_tcp_wheel.count++ == 0)
+    {
+      /* The wheel was idle, restart it from the current half-second */
+
+      g_tcp_wheel.next = now / TICK_PER_HSEC + 1;
+      tcp_wheel_schedule();
+    }
+}
+#endif /* CONFIG_NET_TCP_TIMER_WHEEL */
+
+/****************************************************************************
+ * Name: tcp_pacing_expiry
+ *
+ * Description:
+ *   Poll a paced connection again, now that it may send more data.
+ *
+ * Input Parameters:
+ *   arg - The TCP "connection" to poll for TX data
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_PACING
+static void tcp_pacing_expiry(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+
+  net_lock();
+
+  while ((conn = tcp_nextconn(conn)) != NULL)
+    {
+      if (conn == arg)
+        {
+          netdev_txnotify_dev(conn->dev);
+          break;
+        }
+    }
+
+  net_unlock();
+}
+#endif
 
 /****************************************************************************
  * Name: tcp_xmit_probe
@@ -251,16 +466,44 @@ void tcp_update_timer(FAR struct tcp_conn_s *conn)
         }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+      if (!tcp_timer_pending(conn) ||
+          TICK2HSEC(tcp_timer_timeleft(conn)) != timeout)
+        {
+          if (tcp_timer_pending(conn))
+            {
+              tcp_wheel_remove(conn);
+            }
+
+          if (timeout > 0)
+            {
+              tcp_wheel_insert(conn, HSEC2TICK(timeout));
+            }
+          else
+            {
+              conn->timeout = true;
+              netdev_txnotify_dev(conn->dev);
+            }
+        }
+#else
       if (work_available(&conn->work) ||
           TICK2HSEC(work_timeleft(&conn->work)) != timeout)
         {
           work_queue(LPWORK, &conn->work, tcp_timer_expiry,
                      conn, HSEC2TICK(timeout));
         }
+#endif
     }
   else
     {
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+      if (tcp_timer_pending(conn))
+        {
+          tcp_wheel_remove(conn);
+        }
+#else
       work_cancel(LPWORK, &conn->work);
+#endif
     }
 }
 
@@ -338,9 +581,92 @@ void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout)
 
 void tcp_stop_timer(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+  if (tcp_timer_pending(conn))
+    {
+      tcp_wheel_remove(conn);
+    }
+#else
   work_cancel(LPWORK, &conn->work);
+#endif
+#ifdef CONFIG_NET_TCP_PACING
+  work_cancel(LPWORK, &conn->pacing_work);
+#endif
+#ifdef CONFIG_NET_TCP_RACK
+  tcp_rack_stop(conn);
+#endif
 }
 
+/****************************************************************************
+ * Name: tcp_timer_pending
+ *
+ * Description:
+ *   Return true if the TCP timer of the connection is armed.
+ *
+ ****************************************************************************/
+
+bool tcp_timer_pending(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+  return conn->texpire != 0;
+#else
+  return !work_available(&conn->work);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_timer_timeleft
+ *
+ * Description:
+ *   Return the time left (units: ticks) before the TCP timer of the
+ *   connection expires, zero if it is not armed.
+ *
+ ****************************************************************************/
+
+clock_t tcp_timer_timeleft(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+  sclock_t ticks;
+
+  if (conn->texpire == 0)
+    {
+      return 0;
+    }
+
+  ticks = conn->texpire - clock_systime_ticks();
+  return ticks > 0 ? ticks : 0;
+#else
+  return work_timeleft(&conn->work);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_timer
+ *
+ * Description:
+ *   Poll the connection again after 'ticks' system ticks, unless the
+ *   pacing timer is already running.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   ticks  - The delay
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_PACING
+void tcp_pacing_timer(FAR struct tcp_conn_s *conn, clock_t ticks)
+{
+  if (work_available(&conn->pacing_work))
+    {
+      work_queue(LPWORK, &conn->pacing_work, tcp_pacing_expiry, conn,
+                 ticks);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_set_zero_probe
  *
@@ -539,6 +865,10 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                                               conn->domain);
 #else
                   listener = tcp_findlistener(&conn->u, conn->lport);
+#endif
+#ifdef CONFIG_NET_REUSEPORT
+                  listener = tcp_reuseport_select(listener, &conn->u,
+                                                  conn->rport);
 #endif
                   if (listener != NULL)
                     {
@@ -652,22 +982,9 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                     tcp_rexmit(dev, conn, result);
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-                    /* If conn is TCP_INFR, it should enter to slow start */
-
-                    if (conn->flags & TCP_INFR)
-                      {
-                        conn->flags &= ~TCP_INFR;
-                      }
-
-                    /* update the max_cwnd */
-
-                    conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
-
-                    /* reset cwnd and ssthresh, refers to RFC5861. */
+                    /* Enter to slow start and reset cwnd and ssthresh */
 
-                    conn->ssthresh =
-                                    MAX(conn->tx_unacked / 2, 2 * conn->mss);
-                    conn->cwnd = conn->mss;
+                    tcp_cc_timeout(conn);
 #endif
                     goto done;
 
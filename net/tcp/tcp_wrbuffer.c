@@ -40,6 +40,7 @@
 
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/fs/procfs.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
 
@@ -137,7 +138,16 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_timedalloc(unsigned int timeout)
    * buffer
    */
 
-  ret = net_sem_timedwait_uninterruptible(&g_wrbuffer.sem, timeout);
+  ret = nxsem_trywait(&g_wrbuffer.sem);
+  if (ret < 0)
+    {
+      /* No write buffer is free, the wait is network pressure */
+
+      ret = PRESSURE_STALL(PRESSURE_NET,
+                           net_sem_timedwait_uninterruptible(&g_wrbuffer.sem,
+                                                             timeout));
+    }
+
   if (ret != OK)
     {
       return NULL;
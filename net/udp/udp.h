@@ -164,6 +164,12 @@ struct udp_conn_s
 #ifdef CONFIG_NET_TIMESTAMP
   int timestamp; /* Nonzero when SO_TIMESTAMP is enabled */
 #endif
+#ifdef CONFIG_NET_UDP_GSO
+  uint16_t gso_size;      /* UDP_SEGMENT datagram size, zero if disabled */
+#endif
+#ifdef CONFIG_NET_UDP_GRO
+  bool     gro;           /* True when UDP_GRO is enabled */
+#endif
 };
 
 /* This structure supports UDP write buffering.  It is simply a container
@@ -176,6 +182,12 @@ struct udp_wrbuffer_s
   sq_entry_t wb_node;              /* Supports a singly linked list */
   struct sockaddr_storage wb_dest; /* Destination address */
   FAR struct iob_s *wb_iob;        /* Head of the I/O buffer chain */
+#ifdef CONFIG_NET_UDP_GSO
+  uint16_t wb_gso_size;            /* Datagram size, zero if not segmented */
+#endif
+#ifdef CONFIG_NET_LATENCY
+  clock_t wb_stamp;                /* perf_gettime() when sendto() began */
+#endif
 };
 #endif
 
@@ -244,6 +256,24 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_conn_s *conn,
                                   FAR struct udp_hdr_s *udp);
 
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   Pick the member of the SO_REUSEPORT group of conn, the first connection
+ *   that accepts a unicast datagram, that receives the datagram.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+FAR struct udp_conn_s *udp_reuseport_select(FAR struct net_driver_s *dev,
+                                            FAR struct udp_conn_s *conn,
+                                            FAR struct udp_hdr_s *udp);
+#endif
+
 /****************************************************************************
  * Name: udp_nextconn
  *
@@ -474,6 +504,31 @@ int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len);
 #endif
 
+/****************************************************************************
+ * Name: udp_gso_segment
+ *
+ * Description:
+ *   Cut the UDP super-datagram in d_iob in datagrams of d_gso_size bytes of
+ *   payload, with their own IP and UDP headers and checksums.  The
+ *   datagrams are queued in dev->d_fragout, like IP fragments, and d_iob
+ *   is released.
+ *
+ * Input Parameters:
+ *   dev - The device with the super-datagram in d_iob
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  d_iob and the
+ *   datagrams are released on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GSO
+int udp_gso_segment(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: udp_wrbuffer_initialize
  *
@@ -27,11 +27,13 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_UDP)
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <debug.h>
 #include <sys/time.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
@@ -77,9 +79,23 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
   uint8_t src_addr_size;
   FAR void *src_addr;
   int offset;
+#ifdef CONFIG_NET_LATENCY
+  clock_t stamp;
+#endif
 
 #if CONFIG_NET_RECV_BUFSIZE > 0
-  if (conn->readahead && conn->readahead->io_pktlen > conn->rcvbufs)
+  bool full;
+
+  /* recvfrom() may consume the read-ahead data with only the connection
+   * locked.
+   */
+
+  conn_lock(&conn->sconn);
+  full = conn->readahead != NULL &&
+         conn->readahead->io_pktlen > conn->rcvbufs;
+  conn_unlock(&conn->sconn);
+
+  if (full)
     {
       netdev_iob_release(dev);
 #ifdef CONFIG_NET_STATISTICS
@@ -156,11 +172,25 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 #endif /* CONFIG_NET_IPv4 */
 
   /* Copy the meta info into the I/O buffer chain, just before data.
-   * Layout: |datalen|ifindex|src_addr_size|src_addr|[timestamp]|data|
+   * Layout:
+   *   |datalen|ifindex|src_addr_size|src_addr|[timestamp]|[stamp]|data|
    */
 
   offset = (dev->d_appdata - iob->io_data) - iob->io_offset;
 
+#ifdef CONFIG_NET_LATENCY
+  /* Store when the packet was queued for the receive latency */
+
+  stamp   = perf_gettime();
+  offset -= sizeof(stamp);
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)&stamp, sizeof(stamp),
+                      offset, true);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+#endif
+
 #ifdef CONFIG_NET_TIMESTAMP
   /* Store timestamp while packet is being queued.
    * This is done unconditionally to avoid race condition when SO_TIMESTAMP
@@ -216,7 +246,9 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 
   /* Concat the iob to readahead */
 
+  conn_lock(&conn->sconn);
   net_iob_concat(&conn->readahead, &iob);
+  conn_unlock(&conn->sconn);
 
 #ifdef CONFIG_NET_UDP_NOTIFIER
   ninfo("Buffered %d bytes\n", buflen);
@@ -314,6 +346,13 @@ uint16_t udp_callback(FAR struct net_driver_s *dev,
 
   if (conn)
     {
+#ifdef CONFIG_NET_LATENCY
+      if ((flags & UDP_NEWDATA) != 0)
+        {
+          net_latency_input(dev, &conn->sconn);
+        }
+#endif
+
       /* Perform the callback */
 
       flags = devif_conn_event(dev, flags, conn->sconn.list);
@@ -109,6 +109,8 @@ static dq_queue_t g_active_udp_connections;
  *   portno - The port to use in the lookup
  *   opt    - The option from another conn to match the conflict conn
  *              SO_REUSEADDR: If both sockets have this, they never confilct.
+ *              SO_REUSEPORT: Likewise, but the sockets form a group that
+ *                            shares the incoming datagrams.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -123,6 +125,9 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
 #endif
+#ifdef CONFIG_NET_REUSEPORT
+  bool skip_reuseport = _SO_GETOPT(opt, SO_REUSEPORT);
+#endif
 
   /* Now search each connection structure. */
 
@@ -139,6 +144,13 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
         }
 #endif
 
+#ifdef CONFIG_NET_REUSEPORT
+      if (skip_reuseport && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          continue;
+        }
+#endif
+
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
        * reference to the connection structure.  INADDR_ANY is a special
@@ -637,6 +649,9 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
       /* Make sure that the connection is marked as uninitialized */
 
       conn->sconn.s_ttl = IP_TTL_DEFAULT;
+#ifdef CONFIG_NET_LOCK_SPLIT
+      nxrmutex_init(&conn->sconn.s_lock);
+#endif
       conn->flags       = 0;
 #if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
       conn->domain      = domain;
@@ -710,6 +725,10 @@ void udp_free(FAR struct udp_conn_s *conn)
   udp_sendbuffer_notify(conn);
 #endif /* CONFIG_NET_SEND_BUFSIZE */
 
+#endif
+
+#ifdef CONFIG_NET_LOCK_SPLIT
+  nxrmutex_destroy(&conn->sconn.s_lock);
 #endif
 
   /* Free the connection.
@@ -768,6 +787,90 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   Given the first connection that accepts a unicast datagram, pick the
+ *   one of its SO_REUSEPORT group that receives it.  The choice depends on
+ *   the remote address and port only, so a flow keeps going to the same
+ *   socket while the group does not change.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+FAR struct udp_conn_s *udp_reuseport_select(FAR struct net_driver_s *dev,
+                                            FAR struct udp_conn_s *conn,
+                                            FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *next;
+  FAR const uint16_t *raddr;
+  uint32_t index;
+  int naddr;
+  int count;
+
+  if (!_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return conn;
+    }
+
+  /* Count the members of the group that accept this datagram */
+
+  count = 1;
+  for (next = udp_active(dev, conn, udp); next != NULL;
+       next = udp_active(dev, next, udp))
+    {
+      if (_SO_GETOPT(next->sconn.s_options, SO_REUSEPORT))
+        {
+          count++;
+        }
+    }
+
+  if (count == 1)
+    {
+      return conn;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      raddr = IPv6BUF->srcipaddr;
+      naddr = 8;
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      raddr = IPv4BUF->srcipaddr;
+      naddr = 2;
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  index = net_flowhash(raddr, naddr, udp->srcport, udp->destport) % count;
+
+  /* And walk to the chosen one */
+
+  for (next = conn; index > 0; )
+    {
+      next = udp_active(dev, next, udp);
+      if (_SO_GETOPT(next->sconn.s_options, SO_REUSEPORT))
+        {
+          index--;
+        }
+    }
+
+  return next;
+}
+#endif
+
 /****************************************************************************
  * Name: udp_nextconn
  *
@@ -0,0 +1,262 @@
+/****************************************************************************
+ * net/udp/udp_gso.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/udp.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "utils/utils.h"
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET_UDP_GSO
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_gso_fixup
+ *
+ * Description:
+ *   Update the IP and UDP headers of one datagram and compute its
+ *   checksums.
+ *
+ * Input Parameters:
+ *   seg    - The datagram, with its headers in the first I/O buffer
+ *   ipv6   - True if the datagram is an IPv6 packet
+ *   iplen  - The size of the IP header
+ *   index  - The index of the datagram in the super-datagram
+ *
+ ****************************************************************************/
+
+static void udp_gso_fixup(FAR struct iob_s *seg, bool ipv6,
+                          unsigned int iplen, unsigned int index)
+{
+  FAR uint8_t *ip = seg->io_data + seg->io_offset;
+  FAR struct udp_hdr_s *udp = (FAR struct udp_hdr_s *)(ip + iplen);
+  uint16_t upperlen = seg->io_pktlen - iplen;
+  uint16_t sum;
+
+#ifdef CONFIG_NET_IPv6
+  if (ipv6)
+    {
+      FAR struct ipv6_hdr_s *ipv6hdr = (FAR struct ipv6_hdr_s *)ip;
+
+      ipv6hdr->len[0] = upperlen >> 8;
+      ipv6hdr->len[1] = upperlen & 0xff;
+
+      sum = chksum(upperlen + IP_PROTO_UDP,
+                   (FAR uint8_t *)&ipv6hdr->srcipaddr,
+                   2 * sizeof(net_ipv6addr_t));
+    }
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv4
+      FAR struct ipv4_hdr_s *ipv4hdr = (FAR struct ipv4_hdr_s *)ip;
+      uint16_t ipid;
+
+      /* The datagrams only need identifiers that differ from each other,
+       * they are never fragmented.
+       */
+
+      ipid = ((uint16_t)ipv4hdr->ipid[0] << 8) + ipv4hdr->ipid[1] + index;
+
+      ipv4hdr->len[0]   = seg->io_pktlen >> 8;
+      ipv4hdr->len[1]   = seg->io_pktlen & 0xff;
+      ipv4hdr->ipid[0]  = ipid >> 8;
+      ipv4hdr->ipid[1]  = ipid & 0xff;
+      ipv4hdr->ipchksum = 0;
+#ifdef CONFIG_NET_IPV4_CHECKSUMS
+      ipv4hdr->ipchksum = ~ipv4_chksum(ipv4hdr);
+#endif
+
+      sum = chksum(upperlen + IP_PROTO_UDP,
+                   (FAR uint8_t *)&ipv4hdr->srcipaddr,
+                   2 * sizeof(in_addr_t));
+#endif
+    }
+
+  udp->udplen    = HTONS(upperlen);
+  udp->udpchksum = 0;
+
+#ifdef CONFIG_NET_UDP_CHECKSUMS
+  sum = chksum_iob(sum, seg, iplen);
+  udp->udpchksum = ~((sum == 0) ? 0xffff : HTONS(sum));
+  if (udp->udpchksum == 0)
+    {
+      udp->udpchksum = 0xffff;
+    }
+#else
+  UNUSED(sum);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_gso_segment
+ *
+ * Description:
+ *   Cut the UDP super-datagram in d_iob in datagrams of d_gso_size bytes of
+ *   payload, with their own IP and UDP headers and checksums.  The
+ *   datagrams are queued in dev->d_fragout, like IP fragments, and d_iob
+ *   is released.
+ *
+ * Input Parameters:
+ *   dev - The device with the super-datagram in d_iob
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  d_iob and the
+ *   datagrams are released on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int udp_gso_segment(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *seg;
+  unsigned int nsegs = 0;
+  unsigned int hdrlen;
+  unsigned int iplen;
+  unsigned int paylen;
+  unsigned int offset;
+  unsigned int len;
+  bool ipv6 = false;
+  int ret;
+
+  DEBUGASSERT(dev->d_iob != NULL && dev->d_gso_size > 0);
+
+#ifdef CONFIG_NET_IPv6
+  if (IFF_IS_IPv6(dev->d_flags))
+    {
+      ipv6  = true;
+      iplen = IPv6_HDRLEN;
+    }
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv4
+      iplen = (IPv4BUF->vhl & IPv4_HLMASK) << 2;
+#endif
+    }
+
+  hdrlen = iplen + UDP_HDRLEN;
+  paylen = dev->d_iob->io_pktlen - hdrlen;
+
+  ninfo("GSO: %u bytes in datagrams of %u\n", paylen, dev->d_gso_size);
+
+  for (offset = 0; offset < paylen; offset += len)
+    {
+      len = paylen - offset;
+      if (len > dev->d_gso_size)
+        {
+          len = dev->d_gso_size;
+        }
+
+      seg = iob_tryalloc(false);
+      if (seg == NULL)
+        {
+          goto errout;
+        }
+
+      /* Each datagram starts with a copy of the headers, that must fit in
+       * its first I/O buffer.
+       */
+
+      iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+      DEBUGASSERT(CONFIG_NET_LL_GUARDSIZE + hdrlen <= IOB_BUFSIZE(seg));
+
+      ret = iob_clone_partial(dev->d_iob, hdrlen, 0, seg, 0, false, false);
+      if (ret >= 0)
+        {
+          ret = iob_clone_partial(dev->d_iob, len, hdrlen + offset,
+                                  seg, hdrlen, false, false);
+        }
+
+      if (ret < 0)
+        {
+          iob_free_chain(seg);
+          goto errout;
+        }
+
+      udp_gso_fixup(seg, ipv6, iplen, nsegs);
+
+      if (iob_tryadd_queue(seg, &dev->d_fragout) < 0)
+        {
+          iob_free_chain(seg);
+          goto errout;
+        }
+
+      nsegs++;
+    }
+
+#ifdef CONFIG_NET_STATISTICS
+  if (nsegs > 1)
+    {
+      g_netstats.udp.sent += nsegs - 1;
+#ifdef CONFIG_NET_IPv6
+      if (ipv6)
+        {
+          g_netstats.ipv6.sent += nsegs - 1;
+        }
+      else
+#endif
+        {
+#ifdef CONFIG_NET_IPv4
+          g_netstats.ipv4.sent += nsegs - 1;
+#endif
+        }
+    }
+#endif
+
+  netdev_iob_release(dev);
+  return OK;
+
+errout:
+  nerr("ERROR: Failed to segment %u bytes\n", paylen);
+  iob_free_queue(&dev->d_fragout);
+  netdev_iob_release(dev);
+  return -ENOMEM;
+}
+
+#endif /* CONFIG_NET_UDP_GSO */
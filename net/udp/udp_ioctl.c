@@ -34,10 +34,12 @@
 
 #include <net/if.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
 
+#include "utils/utils.h"
 #include "udp/udp.h"
 
 /****************************************************************************
@@ -91,6 +93,95 @@ static void udp_path(FAR struct udp_conn_s *conn, FAR char *buf, size_t len)
            );
 }
 
+/****************************************************************************
+ * Name: udp_recviob
+ *
+ * Description:
+ *   Hand the first datagram queued in the read-ahead buffer over to the
+ *   caller of the SIOCRECVIOB ioctl, without copying it.
+ *
+ * Parameters:
+ *   conn     The UDP connection of interest
+ *   ri       The zero-copy receive request
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECV_ZEROCOPY
+static int udp_recviob(FAR struct udp_conn_s *conn,
+                       FAR struct net_recviob_s *ri)
+{
+  FAR struct iob_s *iob;
+  uint16_t datalen;
+  uint8_t src_addr_size;
+  unsigned int offset;
+#ifdef CONFIG_NET_LATENCY
+  clock_t stamp;
+#endif
+  int ret = OK;
+
+  ri->ri_iob = NULL;
+  ri->ri_len = 0;
+
+  conn_lock(&conn->sconn);
+
+  iob = conn->readahead;
+  if (iob == NULL)
+    {
+      ret = -EAGAIN;
+      goto out;
+    }
+
+  /* Skip the saved connection information, see udp_readahead().
+   * Layout:
+   *   |datalen|ifindex|src_addr_size|src_addr|[timestamp]|[stamp]|data|
+   */
+
+  iob_copyout((FAR uint8_t *)&datalen, iob, sizeof(datalen), 0);
+  offset = sizeof(datalen);
+#ifdef CONFIG_NETDEV_IFINDEX
+  offset += sizeof(uint8_t);
+#endif
+  iob_copyout(&src_addr_size, iob, sizeof(src_addr_size), offset);
+  offset += sizeof(src_addr_size);
+
+  if (ri->ri_from != NULL)
+    {
+      if (ri->ri_fromlen > src_addr_size)
+        {
+          ri->ri_fromlen = src_addr_size;
+        }
+
+      iob_copyout((FAR uint8_t *)ri->ri_from, iob, ri->ri_fromlen, offset);
+    }
+
+  offset += src_addr_size;
+#ifdef CONFIG_NET_TIMESTAMP
+  offset += sizeof(struct timespec);
+#endif
+#ifdef CONFIG_NET_LATENCY
+  iob_copyout((FAR uint8_t *)&stamp, iob, sizeof(stamp), offset);
+  net_latency_add(&conn->sconn.s_latency[NET_LATENCY_RECV], stamp);
+  offset += sizeof(stamp);
+#endif
+
+  /* Detach the whole datagram, then drop its header */
+
+  iob = net_iob_detach(&conn->readahead, offset + datalen);
+  if (iob == NULL)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  ri->ri_iob = iob_trimhead(iob, offset);
+  ri->ri_len = datalen;
+
+out:
+  conn_unlock(&conn->sconn);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -118,6 +209,7 @@ int udp_ioctl(FAR struct udp_conn_s *conn, int cmd, unsigned long arg)
   switch (cmd)
     {
       case FIONREAD:
+        conn_lock(&conn->sconn);
         iob = conn->readahead;
         if (iob)
           {
@@ -129,6 +221,8 @@ int udp_ioctl(FAR struct udp_conn_s *conn, int cmd, unsigned long arg)
           {
             *(FAR int *)((uintptr_t)arg) = 0;
           }
+
+        conn_unlock(&conn->sconn);
         break;
       case FIONSPACE:
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
@@ -146,6 +240,12 @@ int udp_ioctl(FAR struct udp_conn_s *conn, int cmd, unsigned long arg)
       case FIOC_FILEPATH:
         udp_path(conn, (FAR char *)(uintptr_t)arg, PATH_MAX);
         break;
+#ifdef CONFIG_NET_RECV_ZEROCOPY
+      case SIOCRECVIOB:
+        ret = udp_recviob(conn,
+                          (FAR struct net_recviob_s *)(uintptr_t)arg);
+        break;
+#endif
       default:
         ret = -ENOTTY;
         break;
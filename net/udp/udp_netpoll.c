@@ -188,18 +188,18 @@ int udp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
    * callback processing.
    */
 
-  cb->flags = NETDEV_DOWN;
+  devif_callback_setflags(cb, NETDEV_DOWN);
   cb->priv  = info;
   cb->event = udp_poll_eventhandler;
 
   if ((fds->events & POLLOUT) != 0)
     {
-      cb->flags |= UDP_POLL;
+      devif_callback_setflags(cb, cb->flags | UDP_POLL);
     }
 
   if ((fds->events & POLLIN) != 0)
     {
-      cb->flags |= UDP_NEWDATA;
+      devif_callback_setflags(cb, cb->flags | UDP_NEWDATA);
     }
 
   /* Save the reference in the poll info structure as fds private as well
@@ -33,6 +33,7 @@
 #include <assert.h>
 
 #include <sys/time.h>
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
@@ -40,6 +41,7 @@
 #include <nuttx/net/ip.h>
 #include <nuttx/net/udp.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 
 #include "netdev/netdev.h"
 #include "devif/devif.h"
@@ -169,6 +171,104 @@ static inline size_t udp_recvfrom_newdata(FAR struct net_driver_s *dev,
   return recvlen;
 }
 
+/****************************************************************************
+ * Name: udp_readahead_gro
+ *
+ * Description:
+ *   Append to the datagram just read the following read-ahead datagrams of
+ *   the same sender that are no larger than it, up to the first shorter
+ *   one, as long as they fit in the user buffer.  A UDP_GRO control
+ *   message reports the datagram size if more than one was read.
+ *
+ * Input Parameters:
+ *   pstate   - recvfrom state structure
+ *   srcaddr  - The address of the sender of the first datagram
+ *   addrsize - The size of srcaddr
+ *   segsize  - The size of the first datagram
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GRO
+static void udp_readahead_gro(FAR struct udp_recvfrom_s *pstate,
+                              FAR const uint8_t *srcaddr,
+                              uint8_t addrsize, uint16_t segsize)
+{
+  FAR struct udp_conn_s *conn = pstate->ir_conn;
+  FAR struct iovec *iov = pstate->ir_msg->msg_iov;
+  FAR struct iob_s *iob;
+  uint16_t datalen = segsize;
+  uint8_t src_addr_size;
+#ifdef CONFIG_NET_IPv6
+  uint8_t addr[sizeof(struct sockaddr_in6)];
+#else
+  uint8_t addr[sizeof(struct sockaddr_in)];
+#endif
+#ifdef CONFIG_NET_LATENCY
+  clock_t stamp;
+#endif
+  int nsegs = 1;
+  int offset;
+
+  while (datalen == segsize && (iob = conn->readahead) != NULL)
+    {
+      offset = iob_copyout((FAR uint8_t *)&datalen, iob,
+                           sizeof(datalen), 0);
+#ifdef CONFIG_NETDEV_IFINDEX
+      offset += sizeof(uint8_t);
+#endif
+      offset += iob_copyout(&src_addr_size, iob,
+                            sizeof(src_addr_size), offset);
+      if (src_addr_size != addrsize || datalen > segsize ||
+          pstate->ir_recvlen + datalen > iov->iov_len)
+        {
+          break;
+        }
+
+      offset += iob_copyout(addr, iob, src_addr_size, offset);
+      if (memcmp(addr, srcaddr, addrsize) != 0)
+        {
+          break;
+        }
+
+#ifdef CONFIG_NET_TIMESTAMP
+      offset += sizeof(struct timespec);
+#endif
+#ifdef CONFIG_NET_LATENCY
+      iob_copyout((FAR uint8_t *)&stamp, iob, sizeof(stamp), offset);
+      net_latency_add(&conn->sconn.s_latency[NET_LATENCY_RECV], stamp);
+      offset += sizeof(stamp);
+#endif
+
+      pstate->ir_recvlen +=
+        iob_copyout((FAR uint8_t *)iov->iov_base + pstate->ir_recvlen,
+                    iob, datalen, offset);
+
+      if (offset + datalen >= iob->io_pktlen)
+        {
+          iob_free_chain(iob);
+          conn->readahead = NULL;
+        }
+      else
+        {
+          conn->readahead = iob_trimhead(iob, offset + datalen);
+        }
+
+      nsegs++;
+    }
+
+  if (nsegs > 1)
+    {
+      int size = segsize;
+
+      ninfo("Coalesced %d datagrams of %u bytes\n", nsegs, segsize);
+      cmsg_append(pstate->ir_msg, SOL_UDP, UDP_GRO, &size, sizeof(size));
+    }
+}
+#endif
+
 static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 {
   FAR struct udp_conn_s *conn = pstate->ir_conn;
@@ -194,7 +294,8 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 #endif
 
       /* Unflatten saved connection information
-       * Layout: |datalen|ifindex|src_addr_size|src_addr|[timestamp]|data|
+       * Layout:
+       *   |datalen|ifindex|src_addr_size|src_addr|[timestamp]|[stamp]|data|
        */
 
       recvlen = iob_copyout((FAR uint8_t *)&datalen, iob,
@@ -234,6 +335,20 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
       offset += sizeof(struct timespec);
 #endif
 
+#ifdef CONFIG_NET_LATENCY
+      /* Account the time the datagram waited to be read */
+
+      if (!(pstate->ir_flags & MSG_PEEK))
+        {
+          clock_t stamp;
+
+          iob_copyout((FAR uint8_t *)&stamp, iob, sizeof(stamp), offset);
+          net_latency_add(&conn->sconn.s_latency[NET_LATENCY_RECV], stamp);
+        }
+
+      offset += sizeof(clock_t);
+#endif
+
       /* Copy to user */
 
       recvlen = iob_copyout(pstate->ir_msg->msg_iov->iov_base, iob,
@@ -272,6 +387,13 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
             {
               conn->readahead = iob_trimhead(iob, offset + datalen);
             }
+
+#ifdef CONFIG_NET_UDP_GRO
+          if (conn->gro && recvlen == datalen && datalen > 0)
+            {
+              udp_readahead_gro(pstate, srcaddr, src_addr_size, datalen);
+            }
+#endif
         }
     }
 }
@@ -404,7 +526,7 @@ static void udp_terminate(FAR struct udp_recvfrom_s *pstate, int result)
 {
   /* Don't allow any further UDP call backs. */
 
-  pstate->ir_cb->flags = 0;
+  devif_callback_setflags(pstate->ir_cb, 0);
   pstate->ir_cb->priv  = NULL;
   pstate->ir_cb->event = NULL;
 
@@ -685,6 +807,26 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
   /* Perform the UDP recvfrom() operation */
 
+#if defined(CONFIG_NET_LOCK_SPLIT) && !defined(CONFIG_NETDEV_RSS)
+  /* A datagram already queued in the read-ahead buffer can be consumed
+   * under the connection lock alone, without waiting for the network lock.
+   */
+
+  udp_recvfrom_initialize(conn, msg, &state, flags);
+
+  conn_lock(&conn->sconn);
+  udp_readahead(&state);
+  conn_unlock(&conn->sconn);
+
+  if (state.ir_recvlen >= 0)
+    {
+      udp_recvfrom_uninitialize(&state);
+      return state.ir_recvlen;
+    }
+
+  udp_recvfrom_uninitialize(&state);
+#endif
+
   /* Initialize the state structure.  This is done with the network locked
    * because we don't want anything to happen until we are ready.
    */
@@ -692,9 +834,14 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   net_lock();
   udp_recvfrom_initialize(conn, msg, &state, flags);
 
-  /* Copy the read-ahead data from the packet */
+  /* Copy the read-ahead data from the packet.  This is repeated with the
+   * network locked in the split lock mode, since a datagram may have been
+   * queued in the meantime.
+   */
 
+  conn_lock(&conn->sconn);
   udp_readahead(&state);
+  conn_unlock(&conn->sconn);
 
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
@@ -744,7 +891,7 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
         {
           /* Set up the callback in the connection */
 
-          state.ir_cb->flags = (UDP_NEWDATA | NETDEV_DOWN);
+          devif_callback_setflags(state.ir_cb, UDP_NEWDATA | NETDEV_DOWN);
           state.ir_cb->priv  = (FAR void *)&state;
           state.ir_cb->event = udp_eventhandler;
 
@@ -48,6 +48,7 @@
 #include <debug.h>
 
 #include <arch/irq.h>
+#include <nuttx/clock.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
@@ -133,7 +134,7 @@ static void sendto_writebuffer_release(FAR struct udp_conn_s *conn)
            * enqueued.
            */
 
-          conn->sndcb->flags = 0;
+          devif_callback_setflags(conn->sndcb, 0);
           conn->sndcb->priv  = NULL;
           conn->sndcb->event = NULL;
           wrb = NULL;
@@ -334,7 +335,7 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
 
   /* Set up the callback in the connection */
 
-  conn->sndcb->flags = (UDP_POLL | NETDEV_DOWN);
+  devif_callback_setflags(conn->sndcb, UDP_POLL | NETDEV_DOWN);
   conn->sndcb->priv  = (FAR void *)conn;
   conn->sndcb->event = sendto_eventhandler;
 
@@ -442,6 +443,12 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
 
       netdev_iob_replace(dev, wrb->wb_iob);
 
+#ifdef CONFIG_NET_UDP_GSO
+      /* A super-datagram is segmented by devif_poll_out() */
+
+      dev->d_gso_size = wrb->wb_gso_size;
+#endif
+
       /* Get the amount of data that we can send in the next packet.
        * We will send either the remaining data in the buffer I/O
        * buffer chain, or as much as will fit given the MSS and current
@@ -467,6 +474,11 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
       sendto_ipselect(dev, conn);
 #endif
 
+#ifdef CONFIG_NET_LATENCY
+      net_latency_add(&conn->sconn.s_latency[NET_LATENCY_SEND],
+                      wrb->wb_stamp);
+#endif
+
       /* Free the write buffer at the head of the queue and attempt to
        * setup the next transfer.
        */
@@ -485,6 +497,53 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
   return flags;
 }
 
+/****************************************************************************
+ * Name: sendto_gso_size
+ *
+ * Description:
+ *   Return the size of the datagrams a send of len bytes to the current
+ *   remote address of the connection is segmented in, or zero if it is
+ *   sent as a single datagram.  Multicast is never segmented, it may be
+ *   looped back to ourself.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GSO
+static uint16_t sendto_gso_size(FAR struct udp_conn_s *conn, size_t len)
+{
+  if (conn->gso_size == 0 || len <= conn->gso_size)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      if (IN_MULTICAST(NTOHL(conn->u.ipv4.raddr)))
+        {
+          return 0;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      if (IN6_IS_ADDR_MULTICAST((FAR struct in6_addr *)conn->u.ipv6.raddr))
+        {
+          return 0;
+        }
+    }
+#endif
+
+  return conn->gso_size;
+}
+#endif
+
 /****************************************************************************
  * Name: udp_send_gettimeout
  *
@@ -554,6 +613,9 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
   bool empty;
   int ret = OK;
   clock_t start;
+#ifdef CONFIG_NET_LATENCY
+  clock_t stamp = perf_gettime();
+#endif
 
   /* Get the underlying the UDP connection structure.  */
 
@@ -758,6 +820,10 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
           goto errout_with_lock;
         }
 
+#ifdef CONFIG_NET_LATENCY
+      wrb->wb_stamp = stamp;
+#endif
+
       /* Initialize the write buffer
        *
        * Check if the socket is connected
@@ -806,6 +872,10 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
           udp_connect(conn, to);
         }
 
+#ifdef CONFIG_NET_UDP_GSO
+      wrb->wb_gso_size = sendto_gso_size(conn, len);
+#endif
+
       /* Skip l2/l3/l4 offset before copy */
 
       udpiplen = udpip_hdrsize(conn);
@@ -222,7 +222,7 @@ end_wait:
 
       /* Don't allow any further call backs. */
 
-      pstate->st_cb->flags = 0;
+      devif_callback_setflags(pstate->st_cb, 0);
       pstate->st_cb->priv  = NULL;
       pstate->st_cb->event = NULL;
 
@@ -455,7 +455,7 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
   state.st_cb = udp_callback_alloc(state.st_dev, conn);
   if (state.st_cb)
     {
-      state.st_cb->flags   = (UDP_POLL | NETDEV_DOWN);
+      devif_callback_setflags(state.st_cb, UDP_POLL | NETDEV_DOWN);
       state.st_cb->priv    = (FAR void *)&state;
       state.st_cb->event   = sendto_eventhandler;
 
@@ -76,7 +76,57 @@
 int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len)
 {
-  return -ENOPROTOOPT;
+  FAR struct udp_conn_s *conn;
+  int ret = OK;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL);
+  conn = psock->s_conn;
+
+  switch (option)
+    {
+#ifdef CONFIG_NET_UDP_GSO
+      case UDP_SEGMENT: /* Size of the datagrams a send is segmented in */
+        if (value_len != sizeof(int))
+          {
+            ret = -EDOM;
+          }
+        else
+          {
+            int size = *(FAR const int *)value;
+
+            if (size < 0 || size > UINT16_MAX)
+              {
+                ret = -EINVAL;
+              }
+            else
+              {
+                conn->gso_size = size;
+              }
+          }
+        break;
+#endif
+
+#ifdef CONFIG_NET_UDP_GRO
+      case UDP_GRO: /* Receive several datagrams at once */
+        if (value_len != sizeof(int))
+          {
+            ret = -EDOM;
+          }
+        else
+          {
+            conn->gro = *(FAR const int *)value != 0;
+          }
+        break;
+#endif
+
+      default:
+        nerr("ERROR: Unrecognized UDP option: %d\n", option);
+        UNUSED(conn);
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  return ret;
 }
 
 #endif /* CONFIG_NET_UDPPROTO_OPTIONS */
@@ -56,7 +56,7 @@ static uint16_t accept_event(FAR struct net_driver_s *dev,
 
       /* Stop further callbacks */
 
-      pstate->reqstate.cb->flags = 0;
+      devif_callback_setflags(pstate->reqstate.cb, 0);
       pstate->reqstate.cb->priv  = NULL;
       pstate->reqstate.cb->event = NULL;
 
@@ -92,7 +92,7 @@ static uint16_t accept_event(FAR struct net_driver_s *dev,
 
       /* Stop further callbacks */
 
-      pstate->reqstate.cb->flags = 0;
+      devif_callback_setflags(pstate->reqstate.cb, 0);
       pstate->reqstate.cb->priv  = NULL;
       pstate->reqstate.cb->event = NULL;
 
@@ -108,7 +108,7 @@ static uint16_t accept_event(FAR struct net_driver_s *dev,
 
       /* Stop further callbacks */
 
-      pstate->reqstate.cb->flags = 0;
+      devif_callback_setflags(pstate->reqstate.cb, 0);
       pstate->reqstate.cb->priv  = NULL;
       pstate->reqstate.cb->event = NULL;
 
@@ -124,7 +124,7 @@ static uint16_t accept_event(FAR struct net_driver_s *dev,
 
       /* Stop further callbacks */
 
-      pstate->reqstate.cb->flags = 0;
+      devif_callback_setflags(pstate->reqstate.cb, 0);
       pstate->reqstate.cb->priv  = NULL;
       pstate->reqstate.cb->event = NULL;
 
@@ -59,7 +59,7 @@ static uint16_t bind_event(FAR struct net_driver_s *dev,
 
       /* Stop further callbacks */
 
-      pstate->cb->flags = 0;
+      devif_callback_setflags(pstate->cb, 0);
       pstate->cb->priv  = NULL;
       pstate->cb->event = NULL;
 
@@ -75,7 +75,7 @@ static uint16_t bind_event(FAR struct net_driver_s *dev,
 
       /* Stop further callbacks */
 
-      pstate->cb->flags = 0;
+      devif_callback_setflags(pstate->cb, 0);
       pstate->cb->priv  = NULL;
       pstate->cb->event = NULL;
 
@@ -255,7 +255,7 @@ int usrsock_setup_request_callback(FAR struct usrsock_conn_s *conn,
 
       /* Set up the connection event handler */
 
-      pstate->cb->flags = flags;
+      devif_callback_setflags(pstate->cb, flags);
       pstate->cb->priv  = (FAR void *)pstate;
       pstate->cb->event = event;
 
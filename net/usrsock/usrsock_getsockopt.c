@@ -61,7 +61,7 @@ static uint16_t getsockopt_event(FAR struct net_driver_s *dev,
 
       /* Stop further callbacks */
 
-      pstate->reqstate.cb->flags = 0;
+      devif_callback_setflags(pstate->reqstate.cb, 0);
       pstate->reqstate.cb->priv  = NULL;
       pstate->reqstate.cb->event = NULL;
 
@@ -85,7 +85,7 @@ static uint16_t getsockopt_event(FAR struct net_driver_s *dev,
 
       /* Stop further callbacks */
 
-      pstate->reqstate.cb->flags = 0;
+      devif_callback_setflags(pstate->reqstate.cb, 0);
       pstate->reqstate.cb->priv  = NULL;
       pstate->reqstate.cb->event = NULL;
 
@@ -54,7 +54,7 @@ static uint16_t listen_event(FAR struct net_driver_s *dev,
 
       /* Stop further callbacks */
 
-      pstate->cb->flags = 0;
+      devif_callback_setflags(pstate->cb, 0);
       pstate->cb->priv  = NULL;
       pstate->cb->event = NULL;
 
@@ -70,7 +70,7 @@ static uint16_t listen_event(FAR struct net_driver_s *dev,
 
       /* Stop further callbacks */
 
-      pstate->cb->flags = 0;
+      devif_callback_setflags(pstate->cb, 0);
       pstate->cb->priv  = NULL;
       pstate->cb->event = NULL;
 
@@ -176,9 +176,11 @@ static int usrsock_pollsetup(FAR struct socket *psock,
    * callback processing.
    */
 
-  cb->flags = USRSOCK_EVENT_ABORT | USRSOCK_EVENT_CONNECT_READY |
-              USRSOCK_EVENT_SENDTO_READY | USRSOCK_EVENT_RECVFROM_AVAIL |
-              USRSOCK_EVENT_REMOTE_CLOSED;
+  devif_callback_setflags(cb, USRSOCK_EVENT_ABORT |
+                              USRSOCK_EVENT_CONNECT_READY |
+                              USRSOCK_EVENT_SENDTO_READY |
+                              USRSOCK_EVENT_RECVFROM_AVAIL |
+                              USRSOCK_EVENT_REMOTE_CLOSED);
   cb->priv  = info;
   cb->event = poll_event;
 
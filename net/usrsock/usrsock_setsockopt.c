@@ -60,7 +60,7 @@ static uint16_t setsockopt_event(FAR struct net_driver_s *dev,
 
       /* Stop further callbacks */
 
-      pstate->cb->flags = 0;
+      devif_callback_setflags(pstate->cb, 0);
       pstate->cb->priv  = NULL;
       pstate->cb->event = NULL;
 
@@ -76,7 +76,7 @@ static uint16_t setsockopt_event(FAR struct net_driver_s *dev,
 
       /* Stop further callbacks */
 
-      pstate->cb->flags = 0;
+      devif_callback_setflags(pstate->cb, 0);
       pstate->cb->priv  = NULL;
       pstate->cb->event = NULL;
 
@@ -0,0 +1,472 @@
+/****************************************************************************
+ * net/utils/net_bench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <inttypes.h>
+#include <string.h>
+#include <syslog.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/signal.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NETBENCH_COUNT      CONFIG_NET_BENCH_COUNT
+#define NETBENCH_MSGSIZE    CONFIG_NET_BENCH_MSGSIZE
+
+/* The time waited for the peer:  For the interface at startup, for a
+ * connection and for the next datagram.
+ */
+
+#define NETBENCH_IFWAIT     60
+#define NETBENCH_ACCEPTWAIT 1000
+#define NETBENCH_RCVTIMEO   200
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum netbench_test_e
+{
+  NETBENCH_TCP_STREAM = 0,           /* Bulk data in one direction */
+  NETBENCH_TCP_RR,                   /* Request and response */
+  NETBENCH_UDP_STREAM                /* Datagrams in one direction */
+};
+
+struct netbench_s
+{
+  enum netbench_test_e test;
+  struct sockaddr_in addr;           /* Where the peer listens */
+  struct socket server;              /* The listening or bound socket */
+  sem_t done;                        /* Posted by the peer when it ends */
+  clock_t end;                       /* When the peer got the last data */
+  size_t received;                   /* Bytes or datagrams received */
+  FAR uint8_t *rxbuf;
+  FAR uint8_t *txbuf;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char * const g_netbench_name[] =
+{
+  "TCP_STREAM", "TCP_RR", "UDP_STREAM"
+};
+
+static struct netbench_s g_netbench;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_ns
+ ****************************************************************************/
+
+static uint64_t netbench_ns(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: netbench_ifup
+ *
+ * Description:
+ *   Wait until the interface that owns the address is up.  The loopback
+ *   device is, but a TUN device is brought up by its user.
+ *
+ ****************************************************************************/
+
+static bool netbench_ifup(in_addr_t addr)
+{
+  FAR struct net_driver_s *dev;
+  bool up = false;
+  int i;
+
+  for (i = 0; i < NETBENCH_IFWAIT && !up; i++)
+    {
+      if (i > 0)
+        {
+          nxsig_sleep(1);
+        }
+
+      net_lock();
+      dev = netdev_findby_lipv4addr(addr);
+      up  = dev != NULL && IFF_IS_UP(dev->d_flags);
+      net_unlock();
+    }
+
+  return up;
+}
+
+/****************************************************************************
+ * Name: netbench_accept
+ *
+ * Description:
+ *   Accept the connection of the benchmark without blocking for ever, in
+ *   case the connect failed.
+ *
+ ****************************************************************************/
+
+static int netbench_accept(FAR struct socket *conn)
+{
+  int ret = -EAGAIN;
+  int i;
+
+  for (i = 0; i < NETBENCH_ACCEPTWAIT && ret == -EAGAIN; i++)
+    {
+      ret = psock_accept(&g_netbench.server, NULL, NULL, conn, 0);
+      if (ret == -EAGAIN)
+        {
+          nxsig_usleep(1000);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_peer
+ *
+ * Description:
+ *   The receiving side:  A sink for the stream tests and an echo server
+ *   for the request and response test.
+ *
+ ****************************************************************************/
+
+static int netbench_peer(int argc, FAR char *argv[])
+{
+  FAR struct netbench_s *nb = &g_netbench;
+  struct socket conn;
+  ssize_t nrecv;
+  int ret;
+
+  nb->received = 0;
+  nb->end      = 0;
+
+  if (nb->test == NETBENCH_UDP_STREAM)
+    {
+      while (nb->received < NETBENCH_COUNT)
+        {
+          nrecv = psock_recv(&nb->server, nb->rxbuf, NETBENCH_MSGSIZE, 0);
+          if (nrecv <= 0)
+            {
+              break;
+            }
+
+          nb->end = perf_gettime();
+          nb->received++;
+        }
+
+      goto out;
+    }
+
+  ret = netbench_accept(&conn);
+  if (ret < 0)
+    {
+      nerr("ERROR: accept failed: %d\n", ret);
+      goto out;
+    }
+
+  for (; ; )
+    {
+      nrecv = psock_recv(&conn, nb->rxbuf, NETBENCH_MSGSIZE, 0);
+      if (nrecv <= 0)
+        {
+          break;
+        }
+
+      nb->received += nrecv;
+      if (nb->test == NETBENCH_TCP_RR &&
+          psock_send(&conn, nb->rxbuf, nrecv, 0) != nrecv)
+        {
+          break;
+        }
+    }
+
+  nb->end = perf_gettime();
+  psock_close(&conn);
+
+out:
+  nxsem_post(&nb->done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: netbench_send
+ *
+ * Description:
+ *   The sending side of one test.  Returns the number of the messages
+ *   sent, or transactions made.
+ *
+ ****************************************************************************/
+
+static int netbench_send(FAR struct socket *psock)
+{
+  FAR struct netbench_s *nb = &g_netbench;
+  ssize_t nrecv;
+  size_t len;
+  int i;
+
+  for (i = 0; i < NETBENCH_COUNT; i++)
+    {
+      if (nb->test == NETBENCH_UDP_STREAM)
+        {
+          if (psock_sendto(psock, nb->txbuf, NETBENCH_MSGSIZE, 0,
+                           (FAR struct sockaddr *)&nb->addr,
+                           sizeof(nb->addr)) < 0)
+            {
+              break;
+            }
+        }
+      else if (psock_send(psock, nb->txbuf, NETBENCH_MSGSIZE, 0) !=
+               NETBENCH_MSGSIZE)
+        {
+          break;
+        }
+
+      /* Wait for the whole response of the request */
+
+      for (len = 0; nb->test == NETBENCH_TCP_RR && len < NETBENCH_MSGSIZE;
+           len += nrecv)
+        {
+          nrecv = psock_recv(psock, nb->txbuf + len,
+                             NETBENCH_MSGSIZE - len, 0);
+          if (nrecv <= 0)
+            {
+              return i;
+            }
+        }
+    }
+
+  return i;
+}
+
+/****************************************************************************
+ * Name: netbench_run
+ *
+ * Description:
+ *   Run one test against the peer thread and log its cost.
+ *
+ ****************************************************************************/
+
+static void netbench_run(enum netbench_test_e test)
+{
+  FAR struct netbench_s *nb = &g_netbench;
+  FAR const char *name = g_netbench_name[test];
+  struct socket client;
+  struct timeval tv;
+  clock_t start;
+  uint64_t ns;
+  int type;
+  int nbio;
+  int sent;
+  int ret;
+
+  nb->test = test;
+  type     = test == NETBENCH_UDP_STREAM ? SOCK_DGRAM : SOCK_STREAM;
+
+  ret = psock_socket(PF_INET, type, 0, &nb->server);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = psock_bind(&nb->server, (FAR struct sockaddr *)&nb->addr,
+                   sizeof(nb->addr));
+  if (ret >= 0 && type == SOCK_STREAM)
+    {
+      nbio = 1;
+      ret  = psock_listen(&nb->server, 1);
+      if (ret >= 0)
+        {
+          ret = psock_ioctl(&nb->server, FIONBIO, &nbio);
+        }
+    }
+  else if (ret >= 0)
+    {
+      tv.tv_sec  = 0;
+      tv.tv_usec = NETBENCH_RCVTIMEO * USEC_PER_MSEC;
+      ret = psock_setsockopt(&nb->server, SOL_SOCKET, SO_RCVTIMEO, &tv,
+                             sizeof(tv));
+    }
+
+  if (ret < 0)
+    {
+      goto errout_with_server;
+    }
+
+  ret = psock_socket(PF_INET, type, 0, &client);
+  if (ret < 0)
+    {
+      goto errout_with_server;
+    }
+
+  ret = kthread_create("netbench_peer", CONFIG_NET_BENCH_PRIORITY,
+                       CONFIG_NET_BENCH_STACKSIZE, netbench_peer, NULL);
+  if (ret < 0)
+    {
+      goto errout_with_client;
+    }
+
+  start = perf_gettime();
+  sent  = 0;
+
+  if (type == SOCK_DGRAM ||
+      psock_connect(&client, (FAR struct sockaddr *)&nb->addr,
+                    sizeof(nb->addr)) >= 0)
+    {
+      sent = netbench_send(&client);
+    }
+
+  /* Closing the stream tells the peer that it is done */
+
+  psock_close(&client);
+  nxsem_wait_uninterruptible(&nb->done);
+  psock_close(&nb->server);
+
+  if (sent == 0 || nb->end == 0)
+    {
+      syslog(LOG_ERR, "netbench: %s failed\n", name);
+      return;
+    }
+
+  ns = netbench_ns(nb->end - start);
+  if (test == NETBENCH_TCP_STREAM)
+    {
+      syslog(LOG_INFO, "netbench: %-10s %zu bytes in %" PRIu64 " us, "
+             "%" PRIu64 " KiB/s, %" PRIu64 " ns per %d byte send\n",
+             name, nb->received, ns / NSEC_PER_USEC,
+             ns ? (uint64_t)nb->received * NSEC_PER_SEC / ns / 1024 : 0,
+             ns / sent, NETBENCH_MSGSIZE);
+    }
+  else if (test == NETBENCH_TCP_RR)
+    {
+      syslog(LOG_INFO, "netbench: %-10s %d transactions of %d bytes, "
+             "%" PRIu64 " ns each\n", name, sent, NETBENCH_MSGSIZE,
+             ns / sent);
+    }
+  else
+    {
+      syslog(LOG_INFO, "netbench: %-10s %zu of %d datagrams of %d bytes "
+             "received, %" PRIu64 " ns each\n", name, nb->received, sent,
+             NETBENCH_MSGSIZE, nb->received ? ns / nb->received : 0);
+    }
+
+  return;
+
+errout_with_client:
+  psock_close(&client);
+errout_with_server:
+  psock_close(&nb->server);
+errout:
+  syslog(LOG_ERR, "netbench: %s setup failed: %d\n", name, ret);
+}
+
+/****************************************************************************
+ * Name: netbench_main
+ ****************************************************************************/
+
+static int netbench_main(int argc, FAR char *argv[])
+{
+  FAR struct netbench_s *nb = &g_netbench;
+
+  nb->addr.sin_family      = AF_INET;
+  nb->addr.sin_port        = HTONS(CONFIG_NET_BENCH_PORT);
+  nb->addr.sin_addr.s_addr = inet_addr(CONFIG_NET_BENCH_ADDR);
+
+  if (!netbench_ifup(nb->addr.sin_addr.s_addr))
+    {
+      syslog(LOG_ERR, "netbench: %s is not up\n", CONFIG_NET_BENCH_ADDR);
+      return -ENETDOWN;
+    }
+
+  nb->rxbuf = kmm_malloc(NETBENCH_MSGSIZE);
+  nb->txbuf = kmm_zalloc(NETBENCH_MSGSIZE);
+  if (nb->rxbuf == NULL || nb->txbuf == NULL)
+    {
+      kmm_free(nb->rxbuf);
+      kmm_free(nb->txbuf);
+      return -ENOMEM;
+    }
+
+  nxsem_init(&nb->done, 0, 0);
+
+  syslog(LOG_INFO, "netbench: %s, %d messages\n", CONFIG_NET_BENCH_ADDR,
+         NETBENCH_COUNT);
+
+#ifdef CONFIG_NET_TCP
+  netbench_run(NETBENCH_TCP_STREAM);
+  netbench_run(NETBENCH_TCP_RR);
+#endif
+#ifdef CONFIG_NET_UDP
+  netbench_run(NETBENCH_UDP_STREAM);
+#endif
+
+  nxsem_destroy(&nb->done);
+  kmm_free(nb->txbuf);
+  kmm_free(nb->rxbuf);
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_bench_start
+ ****************************************************************************/
+
+int net_bench_start(void)
+{
+  int pid;
+
+  pid = kthread_create("netbench", CONFIG_NET_BENCH_PRIORITY,
+                       CONFIG_NET_BENCH_STACKSIZE, netbench_main, NULL);
+  return pid < 0 ? pid : OK;
+}
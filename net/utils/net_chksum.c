@@ -27,12 +27,116 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <nuttx/arch.h>
+
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CHKSUM_SWAP16(x) ((uint16_t)(((x) << 8) | ((x) >> 8)))
+
+#ifdef CONFIG_ARCH_HAVE_CHKSUM
+#  define chksum_native(data, len) up_chksum(data, len)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: chksum_native
+ *
+ * Description:
+ *   Portable word-at-a-time version of up_chksum():  Sum the 16-bit words
+ *   of the buffer in native byte order, 32 bits at a time into a 64-bit
+ *   accumulator so that no carry is lost in the loop.
+ *
+ * Input Parameters:
+ *   data - Beginning of the data to sum.
+ *   len  - Length of the data in bytes.
+ *
+ * Returned Value:
+ *   The sum, folded to 16 bits.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && !defined(CONFIG_ARCH_HAVE_CHKSUM)
+static uint16_t chksum_native(FAR const uint8_t *data, size_t len)
+{
+  uint64_t acc = 0;
+  uint32_t sum;
+  bool swap = false;
+
+  /* An odd address puts every byte to the other half of the words that
+   * are loaded, sum from the next address and swap the result back.
+   */
+
+  if (((uintptr_t)data & 1) != 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc = data[0];
+#else
+      acc = (uint32_t)data[0] << 8;
+#endif
+      data++;
+      len--;
+      swap = true;
+    }
+
+  if (((uintptr_t)data & 2) != 0 && len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  while (len >= 16)
+    {
+      acc  += *(FAR const uint32_t *)data;
+      acc  += *(FAR const uint32_t *)(data + 4);
+      acc  += *(FAR const uint32_t *)(data + 8);
+      acc  += *(FAR const uint32_t *)(data + 12);
+      data += 16;
+      len  -= 16;
+    }
+
+  while (len >= 4)
+    {
+      acc  += *(FAR const uint32_t *)data;
+      data += 4;
+      len  -= 4;
+    }
+
+  if (len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  if (len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc += (uint32_t)data[0] << 8;
+#else
+      acc += data[0];
+#endif
+    }
+
+  /* Fold the accumulator down to 16 bits */
+
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  sum = (uint32_t)acc;
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+
+  return swap ? CHKSUM_SWAP16(sum) : sum;
+}
+#endif
+
 /****************************************************************************
  * Name: checksum
  *
@@ -57,56 +161,36 @@
 uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
                     uint16_t len, bool *odd)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
-
-  dataptr = data;
-  last_byte = data + len - 1;
+  uint32_t t;
 
-  if (*odd == true)
+  if (len == 0)
     {
-      t = dataptr[0];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 1;
+      return sum;
     }
 
-  while (dataptr < last_byte)
-    {
-      /* At least two more bytes */
-
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  /* The native sum is in network order on big-endian machines.  It has to
+   * be swapped once more if this region starts at an odd offset of the
+   * data summed so far (RFC1071, byte order independence).
+   */
 
-      dataptr += 2;
+  t = chksum_native(data, len);
+#ifdef CONFIG_ENDIAN_BIG
+  if (*odd)
+#else
+  if (!*odd)
+#endif
+    {
+      t = CHKSUM_SWAP16(t);
     }
 
-  *odd = false;
+  t += sum;
+  t  = (t & 0xffff) + (t >> 16);
 
-  if (dataptr == last_byte)
-    {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      *odd = true;
-    }
+  *odd ^= (len & 1) != 0;
 
   /* Return sum in host byte order. */
 
-  return sum;
+  return t;
 }
 
 /****************************************************************************
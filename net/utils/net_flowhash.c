@@ -0,0 +1,80 @@
+/****************************************************************************
+ * net/utils/net_flowhash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_REUSEPORT
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint32_t g_flowhash_key;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_flowhash
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+uint32_t net_flowhash(FAR const uint16_t *raddr, int naddr, uint16_t rport,
+                      uint16_t lport)
+{
+  uint32_t hash;
+  int i;
+
+  if (g_flowhash_key == 0)
+    {
+      net_getrandom(&g_flowhash_key, sizeof(g_flowhash_key));
+      g_flowhash_key |= 1;
+    }
+
+  hash = g_flowhash_key ^ (((uint32_t)rport << 16) | lport);
+  for (i = 0; i < naddr; i++)
+    {
+      hash = (hash ^ raddr[i]) * 0x01000193;
+    }
+
+  /* Mix the bits so that the low ones depend on all of the input */
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return hash;
+}
+
+#endif /* CONFIG_NET_REUSEPORT */
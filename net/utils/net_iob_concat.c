@@ -73,4 +73,89 @@ uint16_t net_iob_concat(FAR struct iob_s **iob1, FAR struct iob_s **iob2)
   return (*iob1)->io_pktlen;
 }
 
+/****************************************************************************
+ * Name: net_iob_detach
+ *
+ * Description:
+ *   Detach the first 'len' bytes of the I/O buffer chain '*iob' as a new
+ *   chain, leaving the remaining data in '*iob'.  If 'len' ends in the
+ *   middle of an I/O buffer, the tail of that buffer is copied into newly
+ *   allocated I/O buffers.
+ *
+ * Returned Value:
+ *   The detached chain.  NULL if there is nothing to detach or no I/O
+ *   buffer is available; '*iob' is left unchanged in that case.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECV_ZEROCOPY
+FAR struct iob_s *net_iob_detach(FAR struct iob_s **iob, unsigned int len)
+{
+  FAR struct iob_s *head = *iob;
+  FAR struct iob_s *last;
+  FAR struct iob_s *rest;
+  unsigned int taken = 0;
+  unsigned int keep;
+
+  if (head == NULL || len == 0)
+    {
+      return NULL;
+    }
+
+  if (len >= head->io_pktlen)
+    {
+      *iob = NULL;
+      return head;
+    }
+
+  /* Find the I/O buffer that holds the last detached byte */
+
+  for (last = head; taken + last->io_len < len; last = last->io_flink)
+    {
+      taken += last->io_len;
+    }
+
+  keep = len - taken;
+  if (keep < last->io_len)
+    {
+      FAR struct iob_s *tail;
+
+      /* Split that I/O buffer:  Its tail starts the remaining chain */
+
+      rest = iob_tryalloc(false);
+      if (rest == NULL)
+        {
+          return NULL;
+        }
+
+      if (iob_trycopyin(rest, &last->io_data[last->io_offset + keep],
+                        last->io_len - keep, 0, false) < 0)
+        {
+          iob_free_chain(rest);
+          return NULL;
+        }
+
+      tail = rest;
+      while (tail->io_flink != NULL)
+        {
+          tail = tail->io_flink;
+        }
+
+      tail->io_flink = last->io_flink;
+      last->io_len   = keep;
+    }
+  else
+    {
+      rest = last->io_flink;
+    }
+
+  last->io_flink  = NULL;
+  rest->io_pktlen = head->io_pktlen - len;
+  head->io_pktlen = len;
+
+  *iob = rest;
+  return head;
+}
+#endif
+
 #endif /* CONFIG_MM_IOB */
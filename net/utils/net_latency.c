@@ -0,0 +1,113 @@
+/****************************************************************************
+ * net/utils/net_latency.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "utils/utils.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_latency_add
+ *
+ * Description:
+ *   Account the time elapsed since start into a latency histogram.
+ *
+ * Input Parameters:
+ *   lat   - The histogram.
+ *   start - perf_gettime() at the start of the stage, 0 if unknown.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void net_latency_add(FAR struct net_latency_s *lat, clock_t start)
+{
+  struct timespec ts;
+  uint32_t us;
+  int bucket;
+
+  if (start == 0)
+    {
+      return;
+    }
+
+  perf_convert(perf_gettime() - start, &ts);
+  if (ts.tv_sec >= UINT32_MAX / USEC_PER_SEC)
+    {
+      us = UINT32_MAX;
+    }
+  else
+    {
+      us = ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+    }
+
+  /* Bucket n holds [2^(n - 1), 2^n) us, bucket 0 less than 1 us */
+
+  bucket = us != 0 ? fls(us) : 0;
+  if (bucket >= NET_LATENCY_NBUCKETS)
+    {
+      bucket = NET_LATENCY_NBUCKETS - 1;
+    }
+
+  lat->hist[bucket]++;
+  lat->count++;
+  lat->total += us;
+  if (us > lat->max)
+    {
+      lat->max = us;
+    }
+}
+
+/****************************************************************************
+ * Name: net_latency_input
+ *
+ * Description:
+ *   Account the reception latency of the packet in dev, which a socket
+ *   just got, to the socket and to the device.
+ *
+ ****************************************************************************/
+
+void net_latency_input(FAR struct net_driver_s *dev,
+                       FAR struct socket_conn_s *conn)
+{
+  if (dev->d_rxstamp != 0)
+    {
+      net_latency_add(&conn->s_latency[NET_LATENCY_INPUT], dev->d_rxstamp);
+      net_latency_add(&dev->d_rxlatency, dev->d_rxstamp);
+    }
+}
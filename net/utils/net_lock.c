@@ -39,6 +39,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
 
 #include "utils/utils.h"
 
@@ -179,6 +180,60 @@ void net_unlock(void)
   nxrmutex_unlock(&g_netlock);
 }
 
+#ifdef CONFIG_NET_LOCK_SPLIT
+/****************************************************************************
+ * Name: netdev_lock
+ *
+ * Description:
+ *   Take the lock of one network device.
+ *
+ ****************************************************************************/
+
+void netdev_lock(FAR struct net_driver_s *dev)
+{
+  nxrmutex_lock(&dev->d_lock);
+}
+
+/****************************************************************************
+ * Name: netdev_unlock
+ *
+ * Description:
+ *   Release the lock of one network device.
+ *
+ ****************************************************************************/
+
+void netdev_unlock(FAR struct net_driver_s *dev)
+{
+  nxrmutex_unlock(&dev->d_lock);
+}
+
+/****************************************************************************
+ * Name: conn_lock
+ *
+ * Description:
+ *   Take the lock of one socket connection.
+ *
+ ****************************************************************************/
+
+void conn_lock(FAR struct socket_conn_s *sconn)
+{
+  nxrmutex_lock(&sconn->s_lock);
+}
+
+/****************************************************************************
+ * Name: conn_unlock
+ *
+ * Description:
+ *   Release the lock of one socket connection.
+ *
+ ****************************************************************************/
+
+void conn_unlock(FAR struct socket_conn_s *sconn)
+{
+  nxrmutex_unlock(&sconn->s_lock);
+}
+#endif /* CONFIG_NET_LOCK_SPLIT */
+
 /****************************************************************************
  * Name: net_breaklock
  *
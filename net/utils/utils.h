@@ -334,6 +334,25 @@ FAR void *net_ipv6_payload(FAR struct ipv6_hdr_s *ipv6, FAR uint8_t *proto);
 uint16_t net_iob_concat(FAR struct iob_s **iob1, FAR struct iob_s **iob2);
 #endif
 
+/****************************************************************************
+ * Name: net_iob_detach
+ *
+ * Description:
+ *   Detach the first 'len' bytes of the I/O buffer chain '*iob' as a new
+ *   chain, leaving the remaining data in '*iob'.  If 'len' ends in the
+ *   middle of an I/O buffer, the tail of that buffer is copied into newly
+ *   allocated I/O buffers.
+ *
+ * Returned Value:
+ *   The detached chain.  NULL if there is nothing to detach or no I/O
+ *   buffer is available; '*iob' is left unchanged in that case.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECV_ZEROCOPY
+FAR struct iob_s *net_iob_detach(FAR struct iob_s **iob, unsigned int len);
+#endif
+
 /****************************************************************************
  * Name: net_chksum_adjust
  *
@@ -481,6 +500,59 @@ uint16_t icmpv6_chksum(FAR struct net_driver_s *dev, unsigned int iplen);
 FAR void *cmsg_append(FAR struct msghdr *msg, int level, int type,
                       FAR void *value, int value_len);
 
+/****************************************************************************
+ * Name: net_flowhash
+ *
+ * Description:
+ *   Hash the remote address and port and the local port of a flow, to
+ *   spread the flows over the sockets of a SO_REUSEPORT group.  The hash is
+ *   keyed with a random value, so a peer cannot aim all of its flows at
+ *   one socket.
+ *
+ * Input Parameters:
+ *   raddr - The remote address, 2 (IPv4) or 8 (IPv6) half words in network
+ *           order.
+ *   naddr - The number of half words in raddr.
+ *   rport - The remote port (network order).
+ *   lport - The local port (network order).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+uint32_t net_flowhash(FAR const uint16_t *raddr, int naddr, uint16_t rport,
+                      uint16_t lport);
+#endif
+
+#ifdef CONFIG_NET_LATENCY
+
+/****************************************************************************
+ * Name: net_latency_add
+ *
+ * Description:
+ *   Account the time elapsed since start into a latency histogram.
+ *
+ * Input Parameters:
+ *   lat   - The histogram.
+ *   start - perf_gettime() at the start of the stage, 0 if unknown.
+ *
+ ****************************************************************************/
+
+void net_latency_add(FAR struct net_latency_s *lat, clock_t start);
+
+/****************************************************************************
+ * Name: net_latency_input
+ *
+ * Description:
+ *   Account the reception latency of the packet in dev, which a socket
+ *   just got, to the socket and to the device.
+ *
+ ****************************************************************************/
+
+void net_latency_input(FAR struct net_driver_s *dev,
+                       FAR struct socket_conn_s *conn);
+
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
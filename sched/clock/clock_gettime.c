@@ -63,13 +63,13 @@ static clock_t clock_process_runtime(FAR struct tcb_s *tcb)
     {
       tcb = container_of(curr, struct tcb_s, member);
 
-      runtime += tcb->run_time;
+      runtime += nxsched_get_runtime(tcb);
     }
 
   spin_unlock_irqrestore(NULL, flags);
   return runtime;
 # else  /* HAVE_GROUP_MEMBERS */
-  return tcb->run_time;
+  return nxsched_get_runtime(tcb);
 # endif /* HAVE_GROUP_MEMBERS */
 }
 #endif
@@ -140,7 +140,7 @@ void nxclock_gettime(clockid_t clock_id, FAR struct timespec *tp)
             }
           else if (clock_type == CLOCK_THREAD_CPUTIME_ID)
             {
-              up_perf_convert(tcb->run_time, tp);
+              up_perf_convert(nxsched_get_runtime(tcb), tp);
             }
         }
 #endif
@@ -39,6 +39,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/clock.h>
 #include <nuttx/trace.h>
+#include <nuttx/vdso.h>
 
 #include "clock/clock.h"
 #ifdef CONFIG_CLOCK_TIMEKEEPING
@@ -231,6 +232,10 @@ void clock_initialize(void)
 
   perf_init();
 
+#ifdef CONFIG_CLOCK_VDSO
+  clock_vdso_initialize();
+#endif
+
   sched_trace_end();
 }
 
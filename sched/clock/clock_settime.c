@@ -33,6 +33,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
+#include <nuttx/vdso.h>
 #include <sys/time.h>
 
 #include "clock/clock.h"
@@ -99,6 +100,10 @@ void nxclock_settime(clockid_t clock_id, FAR const struct timespec *tp)
 #else
   clock_timekeeping_set_wall_time(tp);
 #endif
+
+#ifdef CONFIG_CLOCK_VDSO
+  clock_vdso_update();
+#endif
 }
 
 /****************************************************************************
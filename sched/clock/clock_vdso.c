@@ -0,0 +1,171 @@
+/****************************************************************************
+ * sched/clock/clock_vdso.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/pgalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/vdso.h>
+#include <nuttx/wdog.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_CLOCK_VDSO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define VDSO_SHIFT        24
+#define VDSO_MAXSEC       60
+#define VDSO_UPDATE_TICKS SEC2TICK(1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uintptr_t g_vdso_page;
+static FAR struct vdso_data_s *g_vdso;
+static spinlock_t g_vdso_lock = SP_UNLOCKED;
+static struct wdog_s g_vdso_wdog;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_vdso_timeout
+ ****************************************************************************/
+
+static void clock_vdso_timeout(wdparm_t arg)
+{
+  clock_vdso_update();
+  wd_start(&g_vdso_wdog, VDSO_UPDATE_TICKS, clock_vdso_timeout, arg);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_vdso_initialize
+ ****************************************************************************/
+
+void clock_vdso_initialize(void)
+{
+  FAR struct vdso_data_s *vd;
+  uint64_t freq = up_vdso_getfreq();
+
+  DEBUGASSERT(sizeof(struct vdso_data_s) <= MM_PGSIZE && freq > 0);
+
+  g_vdso_page = mm_pgalloc(1);
+  if (g_vdso_page == 0)
+    {
+      serr("ERROR: No page for the clock data\n");
+      return;
+    }
+
+  vd = (FAR struct vdso_data_s *)up_addrenv_page_vaddr(g_vdso_page);
+  memset(vd, 0, MM_PGSIZE);
+
+  vd->shift    = VDSO_SHIFT;
+  vd->mult     = ((uint64_t)NSEC_PER_SEC << VDSO_SHIFT) / freq;
+  vd->maxdelta = freq * VDSO_MAXSEC;
+  vd->counter  = up_vdso_counter();
+  clock_systime_timespec(&vd->mono);
+
+  g_vdso = vd;
+  clock_vdso_update();
+
+  wd_start(&g_vdso_wdog, VDSO_UPDATE_TICKS, clock_vdso_timeout, 0);
+}
+
+/****************************************************************************
+ * Name: clock_vdso_update
+ ****************************************************************************/
+
+void clock_vdso_update(void)
+{
+  FAR struct vdso_data_s *vd = g_vdso;
+  struct timespec real;
+  irqstate_t flags;
+  uint64_t counter;
+  uint64_t nsec;
+  uint32_t seq;
+
+  if (vd == NULL)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_vdso_lock);
+
+  /* CLOCK_MONOTONIC moves forward along the counter only, so that user
+   * space never sees it going backwards.  CLOCK_REALTIME follows the
+   * kernel, which may set or slew it.
+   */
+
+  counter = up_vdso_counter();
+  nsec    = ((counter - vd->counter) * vd->mult) >> vd->shift;
+  nxclock_gettime(CLOCK_REALTIME, &real);
+
+  seq = vd->seq;
+  __atomic_store_n(&vd->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  vd->counter       = counter;
+  nsec             += vd->mono.tv_nsec;
+  vd->mono.tv_sec  += nsec / NSEC_PER_SEC;
+  vd->mono.tv_nsec  = nsec % NSEC_PER_SEC;
+  clock_timespec_subtract(&real, &vd->mono, &vd->real_offset);
+
+  __atomic_store_n(&vd->seq, seq + 2, __ATOMIC_RELEASE);
+
+  spin_unlock_irqrestore(&g_vdso_lock, flags);
+}
+
+/****************************************************************************
+ * Name: clock_vdso_map
+ ****************************************************************************/
+
+int clock_vdso_map(FAR arch_addrenv_t *addrenv)
+{
+  if (g_vdso_page == 0)
+    {
+      return -ENOMEM;
+    }
+
+  return up_addrenv_kpage_map(addrenv, g_vdso_page, VDSO_DATA_VBASE);
+}
+
+#endif /* CONFIG_CLOCK_VDSO */
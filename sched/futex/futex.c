@@ -0,0 +1,228 @@
+/****************************************************************************
+ * sched/futex/futex.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/queue.h>
+#include <nuttx/futex.h>
+#include <nuttx/semaphore.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_FUTEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of hash buckets of the waiters, a power of two */
+
+#define FUTEX_NBUCKETS 16
+
+#define FUTEX_BUCKET(a) \
+  (&g_futex_buckets[((uintptr_t)(a) >> 2) & (FUTEX_NBUCKETS - 1)])
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A thread waiting on a futex word, allocated on its stack */
+
+struct futex_waiter_s
+{
+  dq_entry_t node;                  /* Link in the bucket */
+  FAR void *group;                  /* Task group of the word, or NULL */
+  FAR volatile uint32_t *uaddr;     /* The futex word */
+  sem_t sem;                        /* Posted by futex_wake() */
+  bool woken;                       /* Removed by futex_wake() */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static dq_queue_t g_futex_buckets[FUTEX_NBUCKETS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: futex_group
+ *
+ * Description:
+ *   Return the part of the key identifying the address space of the word.
+ *   The addresses of the words are enough outside of the kernel build.
+ *
+ ****************************************************************************/
+
+static inline FAR void *futex_group(void)
+{
+#ifdef CONFIG_BUILD_KERNEL
+  return this_task()->group;
+#else
+  return NULL;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: futex_wait
+ *
+ * Description:
+ *   Block the calling thread on the 32-bit word at 'uaddr' if it still
+ *   holds 'val'.
+ *
+ * Input Parameters:
+ *   uaddr   - The futex word.
+ *   val     - The expected value of the word.
+ *   clockid - The clock of 'abstime'.
+ *   abstime - Absolute timeout, or NULL to wait forever.
+ *
+ * Returned Value:
+ *   Zero (OK) when woken up, -EAGAIN if the word does not hold 'val',
+ *   -ETIMEDOUT if the timeout expired, or -EINTR.
+ *
+ ****************************************************************************/
+
+int futex_wait(FAR volatile uint32_t *uaddr, uint32_t val,
+               clockid_t clockid, FAR const struct timespec *abstime)
+{
+  FAR dq_queue_t *bucket = FUTEX_BUCKET(uaddr);
+  struct futex_waiter_s waiter;
+  irqstate_t flags;
+  int ret;
+
+  if (uaddr == NULL || ((uintptr_t)uaddr & 3) != 0)
+    {
+      return -EINVAL;
+    }
+
+  waiter.group = futex_group();
+  waiter.uaddr = uaddr;
+  waiter.woken = false;
+  nxsem_init(&waiter.sem, 0, 0);
+
+  /* Check the word and queue the waiter atomically with respect to
+   * futex_wake().  The waker changes the word before calling it, so
+   * either the change is seen here or the waiter is found there.
+   */
+
+  flags = enter_critical_section();
+  if (*uaddr != val)
+    {
+      leave_critical_section(flags);
+      nxsem_destroy(&waiter.sem);
+      return -EAGAIN;
+    }
+
+  dq_addlast(&waiter.node, bucket);
+  leave_critical_section(flags);
+
+  if (abstime != NULL)
+    {
+      ret = nxsem_clockwait(&waiter.sem, clockid, abstime);
+    }
+  else
+    {
+      ret = nxsem_wait(&waiter.sem);
+    }
+
+  /* Leave the bucket if the wait ended without futex_wake().  A wake-up
+   * racing with the timeout still counts as a wake-up.
+   */
+
+  flags = enter_critical_section();
+  if (waiter.woken)
+    {
+      ret = OK;
+    }
+  else
+    {
+      dq_rem(&waiter.node, bucket);
+    }
+
+  leave_critical_section(flags);
+
+  nxsem_destroy(&waiter.sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: futex_wake
+ *
+ * Description:
+ *   Wake up to 'nwake' threads waiting on the futex word at 'uaddr'.
+ *
+ * Input Parameters:
+ *   uaddr - The futex word.
+ *   nwake - The maximum number of threads to wake up.
+ *
+ * Returned Value:
+ *   The number of threads woken up.
+ *
+ ****************************************************************************/
+
+int futex_wake(FAR volatile uint32_t *uaddr, int nwake)
+{
+  FAR dq_queue_t *bucket = FUTEX_BUCKET(uaddr);
+  FAR struct futex_waiter_s *waiter;
+  FAR dq_entry_t *node;
+  FAR dq_entry_t *next;
+  FAR void *group = futex_group();
+  irqstate_t flags;
+  int nwoken = 0;
+
+  flags = enter_critical_section();
+
+  for (node = dq_peek(bucket); node != NULL && nwoken < nwake; node = next)
+    {
+      next   = dq_next(node);
+      waiter = (FAR struct futex_waiter_s *)node;
+
+      if (waiter->uaddr == uaddr && waiter->group == group)
+        {
+          dq_rem(node, bucket);
+          waiter->woken = true;
+          nxsem_post(&waiter->sem);
+          nwoken++;
+        }
+    }
+
+  leave_critical_section(flags);
+  return nwoken;
+}
+
+#endif /* CONFIG_FUTEX */
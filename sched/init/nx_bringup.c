@@ -37,6 +37,7 @@
 #include <nuttx/coredump.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/init.h>
+#include <nuttx/initcall.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/symtab.h>
 #include <nuttx/trace.h>
@@ -44,6 +45,7 @@
 #include <nuttx/kthread.h>
 #include <nuttx/userspace.h>
 #include <nuttx/binfmt/binfmt.h>
+#include <nuttx/net/net.h>
 
 #ifdef CONFIG_LEGACY_PAGING
 #  include "paging/paging.h"
@@ -51,6 +53,7 @@
 
 #include "sched/sched.h"
 #include "wqueue/wqueue.h"
+#include "irq/irq.h"
 #include "init/init.h"
 
 #ifdef CONFIG_ETC_ROMFS
@@ -322,6 +325,14 @@ static inline void nx_start_application(void)
   board_late_initialize();
 #endif
 
+#ifdef CONFIG_INITCALL
+  /* Run the initcalls queued by the board, the deferred ones may complete
+   * after the application started.
+   */
+
+  initcall_run(INITCALL_LEVEL_LATE);
+#endif
+
 #if defined(CONFIG_BOARD_COREDUMP_SYSLOG) || \
     defined(CONFIG_BOARD_COREDUMP_BLKDEV)
   coredump_initialize();
@@ -522,6 +533,24 @@ int nx_bringup(void)
 
   nx_workqueues();
 
+#ifdef CONFIG_SCHED_IRQBALANCE
+  /* Start the thread that spreads the threaded IRQs over the CPUs */
+
+  irqbalance_start();
+#endif
+
+#ifdef CONFIG_SCHED_BENCH
+  /* Start the thread that runs the kernel micro-benchmarks */
+
+  nxbench_start();
+#endif
+
+#ifdef CONFIG_NET_BENCH
+  /* Start the thread that runs the network stack benchmark */
+
+  net_bench_start();
+#endif
+
   /* Once the operating system has been initialized, the system must be
    * started by spawning the user initialization thread of execution.  This
    * will be the first user-mode thread.
@@ -0,0 +1,508 @@
+/****************************************************************************
+ * sched/init/nx_initcall.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <string.h>
+#include <syslog.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/initcall.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+
+#ifdef CONFIG_INITCALL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define INITCALL_PENDING  0
+#define INITCALL_RUNNING  1
+#define INITCALL_DONE     2
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sq_queue_t g_initcall_queue;
+static mutex_t g_initcall_lock = NXMUTEX_INITIALIZER;
+static sem_t g_initcall_wake = SEM_INITIALIZER(0);
+static int g_initcall_nwaiters;
+static int g_initcall_nthreads;
+static int g_initcall_level = -1;
+
+#ifdef CONFIG_INITCALL_TRACE
+static clock_t g_initcall_boot;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: initcall_find
+ ****************************************************************************/
+
+static FAR struct initcall_s *initcall_find(FAR const char *name)
+{
+  FAR sq_entry_t *entry;
+
+  sq_for_every(&g_initcall_queue, entry)
+    {
+      FAR struct initcall_s *call = (FAR struct initcall_s *)entry;
+
+      if (strcmp(call->name, name) == 0)
+        {
+          return call;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: initcall_ready
+ *
+ * Description:
+ *   Check if a call can start: it is pending, its level is being run, all
+ *   of the calls of lower levels that are not deferred are complete, and
+ *   so are all of its dependencies.  A dependency that is not queued is
+ *   not configured and ignored.
+ *
+ * Returned Value:
+ *   1 if the call can start, 0 if not yet, -ENODEV if a dependency failed.
+ *
+ ****************************************************************************/
+
+static int initcall_ready(FAR struct initcall_s *call)
+{
+  FAR struct initcall_s *other;
+  FAR const char * const *name;
+  FAR sq_entry_t *entry;
+
+  if (call->state != INITCALL_PENDING || call->level > g_initcall_level)
+    {
+      return 0;
+    }
+
+  sq_for_every(&g_initcall_queue, entry)
+    {
+      other = (FAR struct initcall_s *)entry;
+      if (other->level < call->level && other->state != INITCALL_DONE &&
+          (other->flags & INITCALL_DEFERRED) == 0)
+        {
+          return 0;
+        }
+    }
+
+  for (name = call->depends; name != NULL && *name != NULL; name++)
+    {
+      other = initcall_find(*name);
+      if (other == NULL)
+        {
+          continue;
+        }
+
+      DEBUGASSERT(other->level <= call->level);
+
+      if (other->state != INITCALL_DONE)
+        {
+          return 0;
+        }
+      else if (other->result < 0)
+        {
+          return -ENODEV;
+        }
+    }
+
+  return 1;
+}
+
+/****************************************************************************
+ * Name: initcall_wakeup and initcall_sleep
+ *
+ * Description:
+ *   Wake up all of the threads waiting for a change of state, or wait for
+ *   one with the lock held.
+ *
+ ****************************************************************************/
+
+static void initcall_wakeup(void)
+{
+  while (g_initcall_nwaiters > 0)
+    {
+      g_initcall_nwaiters--;
+      nxsem_post(&g_initcall_wake);
+    }
+}
+
+static void initcall_sleep(void)
+{
+  g_initcall_nwaiters++;
+  nxmutex_unlock(&g_initcall_lock);
+  nxsem_wait_uninterruptible(&g_initcall_wake);
+  nxmutex_lock(&g_initcall_lock);
+}
+
+/****************************************************************************
+ * Name: initcall_thread
+ *
+ * Description:
+ *   One of the threads running the calls.  It exits once no call is
+ *   running and none can start.
+ *
+ ****************************************************************************/
+
+static int initcall_thread(int argc, FAR char *argv[])
+{
+  FAR struct initcall_s *call;
+  FAR sq_entry_t *entry;
+  bool busy;
+  int ret;
+
+  nxmutex_lock(&g_initcall_lock);
+
+  for (; ; )
+    {
+      call = NULL;
+      busy = false;
+
+      sq_for_every(&g_initcall_queue, entry)
+        {
+          FAR struct initcall_s *next = (FAR struct initcall_s *)entry;
+
+          if (next->state == INITCALL_RUNNING)
+            {
+              busy = true;
+              continue;
+            }
+
+          ret = initcall_ready(next);
+          if (ret < 0)
+            {
+              serr("ERROR: Initcall %s skipped, a dependency failed\n",
+                   next->name);
+              next->state  = INITCALL_DONE;
+              next->result = ret;
+              busy         = true;
+              initcall_wakeup();
+            }
+          else if (ret > 0)
+            {
+              call = next;
+              break;
+            }
+        }
+
+      if (call != NULL)
+        {
+          call->state = INITCALL_RUNNING;
+          nxmutex_unlock(&g_initcall_lock);
+
+#ifdef CONFIG_INITCALL_TRACE
+          call->cpu   = this_cpu();
+          call->start = perf_gettime();
+#endif
+          ret = call->func();
+#ifdef CONFIG_INITCALL_TRACE
+          call->end   = perf_gettime();
+#endif
+          if (ret < 0)
+            {
+              serr("ERROR: Initcall %s failed: %d\n", call->name, ret);
+            }
+
+          nxmutex_lock(&g_initcall_lock);
+          call->result = ret;
+          call->state  = INITCALL_DONE;
+          initcall_wakeup();
+        }
+      else if (busy)
+        {
+          initcall_sleep();
+        }
+      else
+        {
+          break;
+        }
+    }
+
+  g_initcall_nthreads--;
+  nxmutex_unlock(&g_initcall_lock);
+  return OK;
+}
+
+#ifdef CONFIG_INITCALL_TRACE
+/****************************************************************************
+ * Name: initcall_usec
+ ****************************************************************************/
+
+static unsigned long initcall_usec(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Name: initcall_pred
+ *
+ * Description:
+ *   Find the call that a call waited for last: the dependency or the call
+ *   of a lower level that is not deferred which completed last.
+ *
+ ****************************************************************************/
+
+static FAR struct initcall_s *initcall_pred(FAR struct initcall_s *call)
+{
+  FAR struct initcall_s *pred = NULL;
+  FAR struct initcall_s *other;
+  FAR const char * const *name;
+  FAR sq_entry_t *entry;
+
+  sq_for_every(&g_initcall_queue, entry)
+    {
+      other = (FAR struct initcall_s *)entry;
+      if (other->state == INITCALL_DONE && other->level < call->level &&
+          (other->flags & INITCALL_DEFERRED) == 0 &&
+          (pred == NULL || other->end > pred->end))
+        {
+          pred = other;
+        }
+    }
+
+  for (name = call->depends; name != NULL && *name != NULL; name++)
+    {
+      other = initcall_find(*name);
+      if (other != NULL && other->state == INITCALL_DONE &&
+          (pred == NULL || other->end > pred->end))
+        {
+          pred = other;
+        }
+    }
+
+  return pred;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: initcall_register
+ ****************************************************************************/
+
+void initcall_register(FAR struct initcall_s *call)
+{
+  DEBUGASSERT(call != NULL && call->name != NULL && call->func != NULL);
+
+  nxmutex_lock(&g_initcall_lock);
+  call->state = INITCALL_PENDING;
+  sq_addlast(&call->node, &g_initcall_queue);
+  nxmutex_unlock(&g_initcall_lock);
+}
+
+/****************************************************************************
+ * Name: initcall_run
+ ****************************************************************************/
+
+int initcall_run(int level)
+{
+  FAR struct initcall_s *call;
+  FAR sq_entry_t *entry;
+  bool pending;
+  int ret;
+
+  nxmutex_lock(&g_initcall_lock);
+
+#ifdef CONFIG_INITCALL_TRACE
+  if (g_initcall_level < 0)
+    {
+      g_initcall_boot = perf_gettime();
+    }
+#endif
+
+  if (level > g_initcall_level)
+    {
+      g_initcall_level = level;
+    }
+
+  /* Start the threads which exited, and wake up those which wait */
+
+  while (g_initcall_nthreads < CONFIG_INITCALL_NTHREADS)
+    {
+      ret = kthread_create("initcall", CONFIG_INITCALL_PRIORITY,
+                           CONFIG_INITCALL_STACKSIZE, initcall_thread,
+                           NULL);
+      if (ret < 0)
+        {
+          serr("ERROR: Failed to start an initcall thread: %d\n", ret);
+          if (g_initcall_nthreads == 0)
+            {
+              nxmutex_unlock(&g_initcall_lock);
+              return ret;
+            }
+
+          break;
+        }
+
+      g_initcall_nthreads++;
+    }
+
+  initcall_wakeup();
+
+  /* Wait for the calls that are not deferred */
+
+  do
+    {
+      pending = false;
+      ret     = OK;
+
+      sq_for_every(&g_initcall_queue, entry)
+        {
+          call = (FAR struct initcall_s *)entry;
+          if (call->level > level || (call->flags & INITCALL_DEFERRED) != 0)
+            {
+              continue;
+            }
+
+          if (call->state != INITCALL_DONE)
+            {
+              pending = true;
+              break;
+            }
+          else if (call->result < 0)
+            {
+              ret = call->result;
+            }
+        }
+
+      if (pending)
+        {
+          initcall_sleep();
+        }
+    }
+  while (pending);
+
+  nxmutex_unlock(&g_initcall_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: initcall_wait
+ ****************************************************************************/
+
+int initcall_wait(FAR const char *name)
+{
+  FAR struct initcall_s *call;
+  int ret;
+
+  nxmutex_lock(&g_initcall_lock);
+
+  call = initcall_find(name);
+  if (call == NULL)
+    {
+      ret = -ENOENT;
+    }
+  else
+    {
+      while (call->state != INITCALL_DONE)
+        {
+          initcall_sleep();
+        }
+
+      ret = call->result;
+    }
+
+  nxmutex_unlock(&g_initcall_lock);
+  return ret;
+}
+
+#ifdef CONFIG_INITCALL_TRACE
+/****************************************************************************
+ * Name: initcall_trace
+ ****************************************************************************/
+
+void initcall_trace(void)
+{
+  FAR struct initcall_s *last = NULL;
+  FAR struct initcall_s *call;
+  FAR sq_entry_t *entry;
+
+  nxmutex_lock(&g_initcall_lock);
+
+  syslog(LOG_INFO, "%-16s %5s %3s %10s %10s %6s\n",
+         "INITCALL", "LEVEL", "CPU", "START(us)", "TIME(us)", "RESULT");
+
+  sq_for_every(&g_initcall_queue, entry)
+    {
+      call = (FAR struct initcall_s *)entry;
+      if (call->state != INITCALL_DONE)
+        {
+          continue;
+        }
+
+      syslog(LOG_INFO, "%-16s %5d %3d %10lu %10lu %6d%s\n",
+             call->name, call->level, call->cpu,
+             initcall_usec(call->start - g_initcall_boot),
+             initcall_usec(call->end - call->start), call->result,
+             (call->flags & INITCALL_DEFERRED) != 0 ? " deferred" : "");
+
+      if ((call->flags & INITCALL_DEFERRED) == 0 &&
+          (last == NULL || call->end > last->end))
+        {
+          last = call;
+        }
+    }
+
+  /* Walk back from the call the application waited for last */
+
+  if (last != NULL)
+    {
+      syslog(LOG_INFO, "Critical path, %lu us:\n",
+             initcall_usec(last->end - g_initcall_boot));
+
+      for (call = last; call != NULL; call = initcall_pred(call))
+        {
+          syslog(LOG_INFO, "  %s\n", call->name);
+        }
+    }
+
+  nxmutex_unlock(&g_initcall_lock);
+}
+#endif
+
+#endif /* CONFIG_INITCALL */
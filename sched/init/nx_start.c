@@ -62,6 +62,7 @@
 #include "init/init.h"
 #include "instrument/instrument.h"
 #include "tls/tls.h"
+#include "wdog/wdog.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -423,6 +424,7 @@ static void idle_task_initialize(void)
       tasklist = TLIST_HEAD(tcb);
 #endif
       dq_addfirst((FAR dq_entry_t *)tcb, tasklist);
+      nxsched_rtr_add(tcb);
 
       /* Mark the idle task as the running task */
 
@@ -534,6 +536,12 @@ void nx_start(void)
 
   /* Initialize RTOS Data ***************************************************/
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Initialize the watchdog timer wheel before any watchdog is started */
+
+  wd_initialize();
+#endif
+
   drivers_early_initialize();
 
   sched_trace_begin();
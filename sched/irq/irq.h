@@ -194,6 +194,58 @@ int irq_unexpected_isr(int irq, FAR void *context, FAR void *arg);
 int irq_foreach(irq_foreach_t callback, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: irq_thread_pid
+ *
+ * Description:
+ *   Return the thread that irq_attach_thread() created for an IRQ, or zero
+ *   if the IRQ is not threaded.
+ *
+ ****************************************************************************/
+
+pid_t irq_thread_pid(int irq);
+
+/****************************************************************************
+ * Name: irq_affinity_apply
+ *
+ * Description:
+ *   Route an IRQ, and bind its handler thread if it has one, to the CPUs
+ *   of its affinity.  Nothing is done if no affinity was ever set.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQAFFINITY
+void irq_affinity_apply(int irq);
+#endif
+
+/****************************************************************************
+ * Name: irq_affinity_move
+ *
+ * Description:
+ *   Move an IRQ that was not pinned with irq_set_affinity() to one CPU.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EPERM if the IRQ is pinned; another negated
+ *   errno value if the IRQ is not valid.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQAFFINITY
+int irq_affinity_move(int irq, int cpu);
+#endif
+
+/****************************************************************************
+ * Name: irqbalance_start
+ *
+ * Description:
+ *   Start the thread that spreads the threaded IRQs over the CPUs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQBALANCE
+int irqbalance_start(void);
+#endif
+
 #ifdef CONFIG_IRQCHAIN
 void irqchain_initialize(void);
 bool is_irqchain(int ndx, xcpt_t isr);
@@ -0,0 +1,229 @@
+/****************************************************************************
+ * sched/irq/irq_affinity.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <sched.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_SCHED_IRQAFFINITY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IRQ_ALLCPUS ((cpu_set_t)((1u << CONFIG_SMP_NCPUS) - 1))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct irq_affinity_s
+{
+  cpu_set_t cpuset;  /* The CPUs that the IRQ is routed to, 0 if not set */
+  bool      pinned;  /* Set by irq_set_affinity(), left by the balancer */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
+static struct irq_affinity_s g_irq_affinity[CONFIG_ARCH_NUSER_INTERRUPTS];
+#else
+static struct irq_affinity_s g_irq_affinity[NR_IRQS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_affinity_ndx
+ ****************************************************************************/
+
+static int irq_affinity_ndx(int irq)
+{
+  if ((unsigned)irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+  return IRQ_TO_NDX(irq);
+}
+
+/****************************************************************************
+ * Name: irq_affinity_set
+ ****************************************************************************/
+
+static void irq_affinity_set(int irq, int ndx, cpu_set_t cpuset,
+                             bool pinned)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  g_irq_affinity[ndx].cpuset = cpuset;
+  g_irq_affinity[ndx].pinned = pinned;
+  leave_critical_section(flags);
+
+  irq_affinity_apply(irq);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_affinity_apply
+ *
+ * Description:
+ *   Route an IRQ, and bind its handler thread if it has one, to the CPUs
+ *   of its affinity.  Nothing is done if no affinity was ever set.
+ *
+ ****************************************************************************/
+
+void irq_affinity_apply(int irq)
+{
+  cpu_set_t cpuset;
+  pid_t pid;
+  int ndx;
+
+  ndx = irq_affinity_ndx(irq);
+  if (ndx < 0 || g_irq_affinity[ndx].cpuset == 0)
+    {
+      return;
+    }
+
+  cpuset = g_irq_affinity[ndx].cpuset;
+  up_affinity_irq(irq, cpuset);
+
+  pid = irq_thread_pid(irq);
+  if (pid > 0)
+    {
+      nxsched_set_affinity(pid, sizeof(cpuset), &cpuset);
+    }
+}
+
+/****************************************************************************
+ * Name: irq_affinity_move
+ *
+ * Description:
+ *   Move an IRQ that was not pinned with irq_set_affinity() to one CPU.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EPERM if the IRQ is pinned; another negated
+ *   errno value if the IRQ is not valid.
+ *
+ ****************************************************************************/
+
+int irq_affinity_move(int irq, int cpu)
+{
+  int ndx;
+
+  ndx = irq_affinity_ndx(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  if (g_irq_affinity[ndx].pinned)
+    {
+      return -EPERM;
+    }
+
+  if (g_irq_affinity[ndx].cpuset != (1u << cpu))
+    {
+      irq_affinity_set(irq, ndx, 1u << cpu, false);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_set_affinity
+ *
+ * Description:
+ *   Set the CPUs that IRQ number 'irq' is routed to and pin it there.
+ *   Setting all of the CPUs unpins the IRQ.
+ *
+ * Input Parameters:
+ *   irq    - IRQ number
+ *   cpuset - The CPUs
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_set_affinity(int irq, cpu_set_t cpuset)
+{
+  int ndx;
+
+  ndx = irq_affinity_ndx(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  cpuset &= IRQ_ALLCPUS;
+  if (cpuset == 0)
+    {
+      return -EINVAL;
+    }
+
+  irq_affinity_set(irq, ndx, cpuset, cpuset != IRQ_ALLCPUS);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_get_affinity
+ *
+ * Description:
+ *   Return the CPUs that IRQ number 'irq' is routed to.  An IRQ whose
+ *   affinity was never set reports all of the CPUs.
+ *
+ ****************************************************************************/
+
+int irq_get_affinity(int irq, FAR cpu_set_t *cpuset)
+{
+  int ndx;
+
+  ndx = irq_affinity_ndx(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  *cpuset = g_irq_affinity[ndx].cpuset != 0 ?
+            g_irq_affinity[ndx].cpuset : IRQ_ALLCPUS;
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_IRQAFFINITY */
@@ -204,7 +204,40 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
 
   g_irq_thread_pid[ndx] = pid;
 
+#ifdef CONFIG_SCHED_IRQAFFINITY
+  /* Bind the new thread to the CPUs of the IRQ */
+
+  irq_affinity_apply(irq);
+#endif
+
 #endif /* NR_IRQS */
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: irq_thread_pid
+ *
+ * Description:
+ *   Return the thread that irq_attach_thread() created for an IRQ, or zero
+ *   if the IRQ is not threaded.
+ *
+ ****************************************************************************/
+
+pid_t irq_thread_pid(int irq)
+{
+#if NR_IRQS > 0
+  int ndx;
+
+  if ((unsigned)irq < NR_IRQS)
+    {
+      ndx = IRQ_TO_NDX(irq);
+      if (ndx >= 0)
+        {
+          return g_irq_thread_pid[ndx];
+        }
+    }
+#endif
+
+  return 0;
+}
@@ -0,0 +1,268 @@
+/****************************************************************************
+ * sched/irq/irq_balance.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/signal.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_SCHED_IRQBALANCE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One threaded IRQ that is balanced */
+
+struct irqbalance_s
+{
+  int      irq;     /* The IRQ number, -1 if the slot is free */
+  uint32_t last;    /* The interrupt count at the last sample */
+  uint32_t load;    /* The interrupts in the last interval */
+  bool     seen;    /* Still threaded at the last sample */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct irqbalance_s g_irqbalance[CONFIG_SCHED_IRQBALANCE_NIRQS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irqbalance_sample
+ *
+ * Description:
+ *   Find the threaded IRQs and count their interrupts since the last
+ *   sample.
+ *
+ ****************************************************************************/
+
+static void irqbalance_sample(void)
+{
+  FAR struct irqbalance_s *slot;
+  FAR struct irqbalance_s *unused;
+  uint32_t count;
+  int irq;
+  int ndx;
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_IRQBALANCE_NIRQS; i++)
+    {
+      g_irqbalance[i].seen = false;
+    }
+
+  for (irq = 0; irq < NR_IRQS; irq++)
+    {
+      ndx = IRQ_TO_NDX(irq);
+      if (ndx < 0 || irq_thread_pid(irq) <= 0)
+        {
+          continue;
+        }
+
+      slot = NULL;
+      unused = NULL;
+      for (i = 0; i < CONFIG_SCHED_IRQBALANCE_NIRQS; i++)
+        {
+          if (g_irqbalance[i].irq == irq)
+            {
+              slot = &g_irqbalance[i];
+              break;
+            }
+          else if (g_irqbalance[i].irq < 0 && unused == NULL)
+            {
+              unused = &g_irqbalance[i];
+            }
+        }
+
+      /* The count is reset when /proc/irqs is read */
+
+      count = g_irqvector[ndx].count;
+      if (slot != NULL)
+        {
+          slot->load = count >= slot->last ? count - slot->last : count;
+        }
+      else if (unused != NULL)
+        {
+          slot       = unused;
+          slot->irq  = irq;
+          slot->load = 0;
+        }
+      else
+        {
+          continue;
+        }
+
+      slot->last = count;
+      slot->seen = true;
+    }
+
+  for (i = 0; i < CONFIG_SCHED_IRQBALANCE_NIRQS; i++)
+    {
+      if (!g_irqbalance[i].seen)
+        {
+          g_irqbalance[i].irq = -1;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: irqbalance_spread
+ *
+ * Description:
+ *   Give the busiest IRQ to the least loaded CPU, then the next one, and so
+ *   on.  An IRQ stays where it is if its CPU is about as good, so that the
+ *   IRQs do not move around for small changes of load.
+ *
+ ****************************************************************************/
+
+static void irqbalance_spread(void)
+{
+  FAR struct irqbalance_s *best;
+  uint32_t cpuload[CONFIG_SMP_NCPUS];
+  uint32_t done = 0;
+  cpu_set_t cpuset;
+  int target;
+  int cpu;
+  int i;
+
+  memset(cpuload, 0, sizeof(cpuload));
+
+  for (; ; )
+    {
+      best = NULL;
+      for (i = 0; i < CONFIG_SCHED_IRQBALANCE_NIRQS; i++)
+        {
+          if (g_irqbalance[i].irq >= 0 && (done & (1u << i)) == 0 &&
+              (best == NULL || g_irqbalance[i].load > best->load))
+            {
+              best = &g_irqbalance[i];
+            }
+        }
+
+      if (best == NULL)
+        {
+          break;
+        }
+
+      done |= 1u << (best - g_irqbalance);
+
+      target = 0;
+      for (cpu = 1; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          if (cpuload[cpu] < cpuload[target])
+            {
+              target = cpu;
+            }
+        }
+
+      /* Stay on the current CPU unless the move is worth it */
+
+      irq_get_affinity(best->irq, &cpuset);
+      cpu = ffs(cpuset) - 1;
+      if (cpuset == (1u << cpu) &&
+          cpuload[cpu] <= cpuload[target] + best->load / 4)
+        {
+          target = cpu;
+        }
+
+      if (irq_affinity_move(best->irq, target) == -EPERM)
+        {
+          /* Pinned:  It loads the CPU it is pinned to */
+
+          target = cpu;
+        }
+
+      /* Count one more, so that IRQs with no load are spread too */
+
+      cpuload[target] += best->load + 1;
+    }
+}
+
+/****************************************************************************
+ * Name: irqbalance_thread
+ ****************************************************************************/
+
+static int irqbalance_thread(int argc, FAR char *argv[])
+{
+  for (; ; )
+    {
+      nxsig_usleep(CONFIG_SCHED_IRQBALANCE_INTERVAL * USEC_PER_MSEC);
+      irqbalance_sample();
+      irqbalance_spread();
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irqbalance_start
+ *
+ * Description:
+ *   Start the thread that spreads the threaded IRQs over the CPUs.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irqbalance_start(void)
+{
+  int pid;
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_IRQBALANCE_NIRQS; i++)
+    {
+      g_irqbalance[i].irq = -1;
+    }
+
+  pid = kthread_create("irqbalance", CONFIG_SCHED_IRQBALANCE_PRIORITY,
+                       CONFIG_SCHED_IRQBALANCE_STACKSIZE,
+                       irqbalance_thread, NULL);
+  if (pid < 0)
+    {
+      serr("ERROR: Failed to start irqbalance: %d\n", pid);
+      return pid;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_IRQBALANCE */
@@ -139,11 +139,21 @@ void irq_dispatch(int irq, FAR void *context)
   sched_note_irqhandler(irq, vector, true);
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_IRQTIME
+  /* Stop charging the interrupted thread */
+
+  nxsched_critmon_irq(true);
+#endif
+
   /* Then dispatch to the interrupt handler */
 
   CALL_VECTOR(ndx, vector, irq, context, arg);
   UNUSED(ndx);
 
+#ifdef CONFIG_SCHED_CRITMONITOR_IRQTIME
+  nxsched_critmon_irq(false);
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
   /* Notify that we are leaving from the interrupt handler */
 
@@ -0,0 +1,527 @@
+/****************************************************************************
+ * sched/irq/irq_latency.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/timers/oneshot.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IRQLAT_NBUCKETS     CONFIG_SCHED_IRQLATENCY_NBUCKETS
+
+#ifdef CONFIG_ARCH_HAVE_BACKTRACE
+#  define IRQLAT_BACKTRACE  CONFIG_SCHED_IRQLATENCY_BACKTRACE
+#else
+#  define IRQLAT_BACKTRACE  0
+#endif
+
+/* What is measured from the programmed expiry of the timer */
+
+#define IRQLAT_ISR          0        /* To the timer callback */
+#define IRQLAT_THREAD       1        /* To the wakeup of the thread */
+#define IRQLAT_NTYPES       2
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The context of the worst case:  The thread that ran when the timer
+ * fired, and where it last entered a critical section or disabled
+ * pre-emption, as recorded by critmon.
+ */
+
+struct irqlat_max_s
+{
+  clock_t latency;
+  pid_t pid;
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
+  FAR void *csection;
+#endif
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
+  FAR void *preemption;
+#endif
+#if IRQLAT_BACKTRACE > 0
+  FAR void *backtrace[IRQLAT_BACKTRACE];
+#endif
+};
+
+struct irqlat_stat_s
+{
+  uint32_t hist[IRQLAT_NBUCKETS];    /* The last bucket takes the rest */
+  uint32_t count;
+  clock_t min;
+  uint64_t total;
+  struct irqlat_max_s max;
+};
+
+struct irqlat_s
+{
+  FAR struct oneshot_lowerhalf_s *lower;
+  sem_t sem;                         /* Posted by the timer callback */
+  clock_t bucket;                    /* Width of a bucket in perf ticks */
+  volatile clock_t expected;         /* The programmed expiry */
+  struct irqlat_max_s fired;         /* Context when the timer fired */
+  struct irqlat_stat_s stat[CONFIG_SMP_NCPUS][IRQLAT_NTYPES];
+};
+
+/* This structure describes one open "file" */
+
+struct irqlat_file_s
+{
+  struct procfs_file_s base;         /* Base open file structure */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     irqlat_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode);
+static int     irqlat_close(FAR struct file *filep);
+static ssize_t irqlat_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static int     irqlat_dup(FAR const struct file *oldp,
+                          FAR struct file *newp);
+static int     irqlat_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct irqlat_s *g_irqlat;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct procfs_operations g_irqlatency_operations =
+{
+  irqlat_open,    /* open */
+  irqlat_close,   /* close */
+  irqlat_read,    /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+
+  irqlat_dup,     /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  irqlat_stat     /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irqlat_ticks
+ *
+ * Description:
+ *   Convert microseconds to performance counter ticks.
+ *
+ ****************************************************************************/
+
+static clock_t irqlat_ticks(uint32_t usec)
+{
+  return (clock_t)((uint64_t)perf_getfreq() * usec / USEC_PER_SEC);
+}
+
+/****************************************************************************
+ * Name: irqlat_ns
+ ****************************************************************************/
+
+static uint64_t irqlat_ns(clock_t ticks)
+{
+  struct timespec ts;
+
+  perf_convert(ticks, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: irqlat_record
+ *
+ * Description:
+ *   Account one latency sample.  Returns true if it is a new maximum.
+ *
+ ****************************************************************************/
+
+static bool irqlat_record(FAR struct irqlat_stat_s *stat, clock_t now)
+{
+  clock_t latency = 0;
+  clock_t bucket;
+
+  /* A timer of coarse resolution may fire a bit early */
+
+  if ((sclock_t)(now - g_irqlat->expected) > 0)
+    {
+      latency = now - g_irqlat->expected;
+    }
+
+  bucket = latency / g_irqlat->bucket;
+  stat->hist[bucket < IRQLAT_NBUCKETS ? bucket : IRQLAT_NBUCKETS - 1]++;
+
+  if (stat->count++ == 0 || latency < stat->min)
+    {
+      stat->min = latency;
+    }
+
+  stat->total += latency;
+
+  if (latency > stat->max.latency || stat->count == 1)
+    {
+      stat->max.latency = latency;
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: irqlat_context
+ *
+ * Description:
+ *   Save the context of the thread interrupted by the timer.
+ *
+ ****************************************************************************/
+
+static void irqlat_context(FAR struct irqlat_max_s *max)
+{
+  FAR struct tcb_s *tcb = this_task();
+
+  max->pid = tcb->pid;
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
+  max->csection = tcb->crit_caller;
+#endif
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
+  max->preemption = tcb->premp_caller;
+#endif
+}
+
+/****************************************************************************
+ * Name: irqlat_callback
+ *
+ * Description:
+ *   The timer expiry, in interrupt context.
+ *
+ ****************************************************************************/
+
+static void irqlat_callback(FAR struct oneshot_lowerhalf_s *lower,
+                            FAR void *arg)
+{
+  FAR struct irqlat_stat_s *stat;
+  clock_t now = perf_gettime();
+
+  stat = &g_irqlat->stat[this_cpu()][IRQLAT_ISR];
+  irqlat_context(&g_irqlat->fired);
+
+  if (irqlat_record(stat, now))
+    {
+      irqlat_context(&stat->max);
+#if IRQLAT_BACKTRACE > 0
+      memset(stat->max.backtrace, 0, sizeof(stat->max.backtrace));
+      up_backtrace(this_task(), stat->max.backtrace, IRQLAT_BACKTRACE, 0);
+#endif
+    }
+
+  nxsem_post(&g_irqlat->sem);
+}
+
+/****************************************************************************
+ * Name: irqlat_thread
+ *
+ * Description:
+ *   Program the timer and wait for it, like cyclictest does.
+ *
+ ****************************************************************************/
+
+static int irqlat_thread(int argc, FAR char *argv[])
+{
+  FAR struct irqlat_stat_s *stat;
+  struct timespec ts;
+  irqstate_t flags;
+  clock_t interval;
+  clock_t now;
+
+  interval     = irqlat_ticks(CONFIG_SCHED_IRQLATENCY_INTERVAL);
+  ts.tv_sec    = CONFIG_SCHED_IRQLATENCY_INTERVAL / USEC_PER_SEC;
+  ts.tv_nsec   = CONFIG_SCHED_IRQLATENCY_INTERVAL % USEC_PER_SEC *
+                 NSEC_PER_USEC;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      g_irqlat->expected = perf_gettime() + interval;
+      ONESHOT_START(g_irqlat->lower, irqlat_callback, NULL, &ts);
+      leave_critical_section(flags);
+
+      nxsem_wait_uninterruptible(&g_irqlat->sem);
+      now = perf_gettime();
+
+      stat = &g_irqlat->stat[this_cpu()][IRQLAT_THREAD];
+
+      flags = enter_critical_section();
+      if (irqlat_record(stat, now))
+        {
+          clock_t latency = stat->max.latency;
+
+          stat->max = g_irqlat->fired;
+          stat->max.latency = latency;
+        }
+
+      leave_critical_section(flags);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: irqlat_open
+ ****************************************************************************/
+
+static int irqlat_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct irqlat_file_s *attr;
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      return -EACCES;
+    }
+
+  attr = kmm_zalloc(sizeof(struct irqlat_file_s));
+  if (attr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irqlat_close
+ ****************************************************************************/
+
+static int irqlat_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irqlat_print
+ *
+ * Description:
+ *   Print the statistics of one CPU and type, from a copy taken with the
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void irqlat_print(FAR char *buffer, size_t buflen,
+                         FAR off_t *offset, int cpu, int type)
+{
+  FAR const char *name = type == IRQLAT_ISR ? "irq" : "thread";
+  FAR struct irqlat_stat_s *stat;
+  irqstate_t flags;
+  int i;
+
+  stat = kmm_malloc(sizeof(struct irqlat_stat_s));
+  if (stat == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  memcpy(stat, &g_irqlat->stat[cpu][type], sizeof(*stat));
+  leave_critical_section(flags);
+
+  procfs_sprintf(buffer, buflen, offset,
+                 "%3d %-6s %10" PRIu32 " %8" PRIu64 " %8" PRIu64
+                 " %8" PRIu64 "\n", cpu, name, stat->count,
+                 irqlat_ns(stat->min),
+                 stat->count ? irqlat_ns(stat->total / stat->count) : 0,
+                 irqlat_ns(stat->max.latency));
+
+  procfs_sprintf(buffer, buflen, offset, "    hist");
+  for (i = 0; i < IRQLAT_NBUCKETS; i++)
+    {
+      procfs_sprintf(buffer, buflen, offset, " %" PRIu32, stat->hist[i]);
+    }
+
+  procfs_sprintf(buffer, buflen, offset, "\n    max pid %d",
+                 (int)stat->max.pid);
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
+  procfs_sprintf(buffer, buflen, offset, " csection %p",
+                 stat->max.csection);
+#endif
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
+  procfs_sprintf(buffer, buflen, offset, " preemption %p",
+                 stat->max.preemption);
+#endif
+#if IRQLAT_BACKTRACE > 0
+  for (i = 0; i < IRQLAT_BACKTRACE && stat->max.backtrace[i]; i++)
+    {
+      procfs_sprintf(buffer, buflen, offset, " %p", stat->max.backtrace[i]);
+    }
+#endif
+
+  procfs_sprintf(buffer, buflen, offset, "\n");
+  kmm_free(stat);
+}
+
+/****************************************************************************
+ * Name: irqlat_read
+ ****************************************************************************/
+
+static ssize_t irqlat_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  off_t offset = filep->f_pos;
+  int cpu;
+
+  if (g_irqlat == NULL)
+    {
+      return 0;
+    }
+
+  procfs_sprintf(buffer, buflen, &offset,
+                 "CPU TYPE        COUNT  MIN(ns)  AVG(ns)  MAX(ns), "
+                 "buckets of %" PRIu64 " ns\n", irqlat_ns(g_irqlat->bucket));
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      irqlat_print(buffer, buflen, &offset, cpu, IRQLAT_ISR);
+      irqlat_print(buffer, buflen, &offset, cpu, IRQLAT_THREAD);
+    }
+
+  if (offset >= 0)
+    {
+      return 0;
+    }
+
+  filep->f_pos += -offset;
+  return -offset;
+}
+
+/****************************************************************************
+ * Name: irqlat_dup
+ ****************************************************************************/
+
+static int irqlat_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct irqlat_file_s *attr;
+
+  attr = kmm_malloc(sizeof(struct irqlat_file_s));
+  if (attr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(attr, oldp->f_priv, sizeof(struct irqlat_file_s));
+  newp->f_priv = attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irqlat_stat
+ ****************************************************************************/
+
+static int irqlat_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_latency_start
+ ****************************************************************************/
+
+int irq_latency_start(FAR struct oneshot_lowerhalf_s *lower)
+{
+  FAR struct irqlat_s *irqlat;
+  int ret;
+
+  if (g_irqlat != NULL)
+    {
+      return -EBUSY;
+    }
+
+  irqlat = kmm_zalloc(sizeof(struct irqlat_s));
+  if (irqlat == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  irqlat->lower  = lower;
+  irqlat->bucket = irqlat_ticks(CONFIG_SCHED_IRQLATENCY_BUCKET);
+  if (irqlat->bucket == 0)
+    {
+      irqlat->bucket = 1;
+    }
+
+  nxsem_init(&irqlat->sem, 0, 0);
+  g_irqlat = irqlat;
+
+  ret = kthread_create("irqlatency", CONFIG_SCHED_IRQLATENCY_PRIORITY,
+                       CONFIG_SCHED_IRQLATENCY_STACKSIZE, irqlat_thread,
+                       NULL);
+  if (ret < 0)
+    {
+      g_irqlat = NULL;
+      nxsem_destroy(&irqlat->sem);
+      kmm_free(irqlat);
+      return ret;
+    }
+
+  return OK;
+}
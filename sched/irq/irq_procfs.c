@@ -27,7 +27,9 @@
 #include <nuttx/config.h>
 
 #include <sys/stat.h>
+#include <inttypes.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <fcntl.h>
 #include <string.h>
 #include <assert.h>
@@ -427,4 +429,407 @@ static int irq_stat(const char *relpath, struct stat *buf)
  ****************************************************************************/
 
 #endif /* CONFIG_SCHED_IRQMONITOR */
+
+#ifdef CONFIG_SCHED_IRQAFFINITY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The affinity of IRQ N is the hexadecimal CPU mask in the file
+ * "irq/N/smp_affinity".  Writing a mask to it sets the affinity.
+ */
+
+#define IRQAFF_ROOT     0          /* "irq" */
+#define IRQAFF_DIR      1          /* "irq/N" */
+#define IRQAFF_FILE     2          /* "irq/N/smp_affinity" */
+
+#define IRQAFF_FILENAME "smp_affinity"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct irqaff_file_s
+{
+  struct procfs_file_s base;       /* Base open file structure */
+  int irq;                         /* The IRQ of the file */
+};
+
+/* This structure describes one open directory */
+
+struct irqaff_dir_s
+{
+  struct procfs_dir_priv_s base;   /* Base directory private data */
+  int irq;                         /* The IRQ of an "irq/N" directory */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     irqaff_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     irqaff_close(FAR struct file *filep);
+static ssize_t irqaff_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t irqaff_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     irqaff_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     irqaff_opendir(FAR const char *relpath,
+                 FAR struct fs_dirent_s **dir);
+static int     irqaff_closedir(FAR struct fs_dirent_s *dir);
+static int     irqaff_readdir(FAR struct fs_dirent_s *dir,
+                 FAR struct dirent *entry);
+static int     irqaff_rewinddir(FAR struct fs_dirent_s *dir);
+static int     irqaff_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct procfs_operations g_irqaffinity_operations =
+{
+  irqaff_open,       /* open */
+  irqaff_close,      /* close */
+  irqaff_read,       /* read */
+  irqaff_write,      /* write */
+  NULL,              /* poll */
+
+  irqaff_dup,        /* dup */
+
+  irqaff_opendir,    /* opendir */
+  irqaff_closedir,   /* closedir */
+  irqaff_readdir,    /* readdir */
+  irqaff_rewinddir,  /* rewinddir */
+
+  irqaff_stat        /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irqaff_attached
+ ****************************************************************************/
+
+static bool irqaff_attached(int irq)
+{
+  int ndx = IRQ_TO_NDX(irq);
+
+  return ndx >= 0 && g_irqvector[ndx].handler != NULL &&
+         g_irqvector[ndx].handler != irq_unexpected_isr;
+}
+
+/****************************************************************************
+ * Name: irqaff_parse
+ *
+ * Description:
+ *   Parse a path below "irq".
+ *
+ * Returned Value:
+ *   IRQAFF_ROOT, IRQAFF_DIR or IRQAFF_FILE; -ENOENT if the path does not
+ *   exist.
+ *
+ ****************************************************************************/
+
+static int irqaff_parse(FAR const char *relpath, FAR int *irq)
+{
+  FAR char *end;
+  unsigned long value;
+
+  if (strncmp(relpath, "irq", 3) != 0)
+    {
+      return -ENOENT;
+    }
+
+  relpath += 3;
+  if (*relpath == '/')
+    {
+      relpath++;
+    }
+
+  if (*relpath == '\0')
+    {
+      return IRQAFF_ROOT;
+    }
+
+  value = strtoul(relpath, &end, 10);
+  if (end == relpath || value >= NR_IRQS || !irqaff_attached(value))
+    {
+      return -ENOENT;
+    }
+
+  *irq = value;
+  if (*end == '/')
+    {
+      end++;
+    }
+
+  if (*end == '\0')
+    {
+      return IRQAFF_DIR;
+    }
+
+  if (strcmp(end, IRQAFF_FILENAME) == 0)
+    {
+      return IRQAFF_FILE;
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: irqaff_open
+ ****************************************************************************/
+
+static int irqaff_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct irqaff_file_s *afffile;
+  int irq;
+
+  finfo("Open '%s'\n", relpath);
+
+  if (irqaff_parse(relpath, &irq) != IRQAFF_FILE)
+    {
+      return -ENOENT;
+    }
+
+  afffile = kmm_zalloc(sizeof(struct irqaff_file_s));
+  if (!afffile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  afffile->irq  = irq;
+  filep->f_priv = afffile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irqaff_close
+ ****************************************************************************/
+
+static int irqaff_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irqaff_read
+ ****************************************************************************/
+
+static ssize_t irqaff_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct irqaff_file_s *afffile = filep->f_priv;
+  cpu_set_t cpuset;
+  char line[16];
+  size_t linesize;
+  size_t copysize;
+  off_t offset;
+  int ret;
+
+  ret = irq_get_affinity(afffile->irq, &cpuset);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  linesize = snprintf(line, sizeof(line), "%08" PRIx32 "\n",
+                      (uint32_t)cpuset);
+  offset   = filep->f_pos;
+  copysize = procfs_memcpy(line, linesize, buffer, buflen, &offset);
+
+  filep->f_pos += copysize;
+  return copysize;
+}
+
+/****************************************************************************
+ * Name: irqaff_write
+ ****************************************************************************/
+
+static ssize_t irqaff_write(FAR struct file *filep, FAR const char *buffer,
+                            size_t buflen)
+{
+  FAR struct irqaff_file_s *afffile = filep->f_priv;
+  FAR char *end;
+  unsigned long cpuset;
+  char line[16];
+  int ret;
+
+  if (buflen >= sizeof(line))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(line, buffer, buflen);
+  line[buflen] = '\0';
+
+  cpuset = strtoul(line, &end, 16);
+  if (end == line || (*end != '\0' && *end != '\n'))
+    {
+      return -EINVAL;
+    }
+
+  ret = irq_set_affinity(afffile->irq, cpuset);
+  return ret < 0 ? ret : buflen;
+}
+
+/****************************************************************************
+ * Name: irqaff_dup
+ ****************************************************************************/
+
+static int irqaff_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct irqaff_file_s *newattr;
+
+  newattr = kmm_malloc(sizeof(struct irqaff_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldp->f_priv, sizeof(struct irqaff_file_s));
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irqaff_opendir
+ ****************************************************************************/
+
+static int irqaff_opendir(FAR const char *relpath,
+                          FAR struct fs_dirent_s **dir)
+{
+  FAR struct irqaff_dir_s *affdir;
+  int irq = 0;
+  int level;
+
+  level = irqaff_parse(relpath, &irq);
+  if (level != IRQAFF_ROOT && level != IRQAFF_DIR)
+    {
+      return level < 0 ? level : -ENOTDIR;
+    }
+
+  affdir = kmm_zalloc(sizeof(struct irqaff_dir_s));
+  if (affdir == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  affdir->base.level    = level + 1;
+  affdir->base.nentries = level == IRQAFF_ROOT ? NR_IRQS : 1;
+  affdir->irq           = irq;
+
+  *dir = (FAR struct fs_dirent_s *)affdir;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irqaff_closedir
+ ****************************************************************************/
+
+static int irqaff_closedir(FAR struct fs_dirent_s *dir)
+{
+  kmm_free(dir);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irqaff_readdir
+ ****************************************************************************/
+
+static int irqaff_readdir(FAR struct fs_dirent_s *dir,
+                          FAR struct dirent *entry)
+{
+  FAR struct irqaff_dir_s *affdir = (FAR struct irqaff_dir_s *)dir;
+
+  /* "irq/N" only holds the affinity file */
+
+  if (affdir->base.level == IRQAFF_DIR + 1)
+    {
+      if (affdir->base.index++ > 0)
+        {
+          return -ENOENT;
+        }
+
+      entry->d_type = DTYPE_FILE;
+      strlcpy(entry->d_name, IRQAFF_FILENAME, sizeof(entry->d_name));
+      return OK;
+    }
+
+  /* "irq" holds one directory for each attached IRQ */
+
+  while (affdir->base.index < affdir->base.nentries)
+    {
+      int irq = affdir->base.index++;
+
+      if (irqaff_attached(irq))
+        {
+          entry->d_type = DTYPE_DIRECTORY;
+          snprintf(entry->d_name, sizeof(entry->d_name), "%d", irq);
+          return OK;
+        }
+    }
+
+  /* We signal the end of the directory by returning the special error
+   * -ENOENT
+   */
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: irqaff_rewinddir
+ ****************************************************************************/
+
+static int irqaff_rewinddir(FAR struct fs_dirent_s *dir)
+{
+  FAR struct irqaff_dir_s *affdir = (FAR struct irqaff_dir_s *)dir;
+
+  affdir->base.index = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irqaff_stat
+ ****************************************************************************/
+
+static int irqaff_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  int irq;
+  int level;
+
+  level = irqaff_parse(relpath, &irq);
+  if (level < 0)
+    {
+      return level;
+    }
+
+  memset(buf, 0, sizeof(struct stat));
+  if (level == IRQAFF_FILE)
+    {
+      buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+    }
+  else
+    {
+      buf->st_mode = S_IFDIR | S_IROTH | S_IRGRP | S_IRUSR;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_IRQAFFINITY */
 #endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -35,6 +35,36 @@
 
 #if defined(CONFIG_SPINLOCK)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The nodes of the CPUs are kept in different cache lines */
+
+#define SP_NODE_ALIGN 64
+
+/* Number of queue nodes of each CPU.  The slow path runs with the
+ * interrupt state of the caller, so a CPU may be queued for a lock again
+ * by an interrupt handler or by a thread that preempted the first waiter.
+ */
+
+#define SP_NODE_NUM   4
+#define SP_NODE_MASK  ((1u << SP_NODE_NUM) - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_MCS_SPINLOCK
+/* The node a waiter spins on while it is queued for a spinlock */
+
+struct spin_node_s
+{
+  FAR struct spin_node_s *volatile next aligned_data(SP_NODE_ALIGN);
+  volatile bool locked;
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -58,10 +88,176 @@ static volatile uint8_t g_irq_rwspin_count[CONFIG_SMP_NCPUS];
 
 #endif
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_MCS_SPINLOCK
+static struct spin_node_s g_spin_node[CONFIG_SMP_NCPUS * SP_NODE_NUM];
+
+/* The nodes of each CPU in use, one bit per node */
+
+static atomic_uint g_spin_node_used[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spin_node_alloc
+ *
+ * Description:
+ *   Take a free queue node of this CPU.  The waiter may migrate to another
+ *   CPU while it is queued, so the nodes are taken and given back with
+ *   atomic operations rather than a per-CPU nesting count.
+ *
+ * Returned Value:
+ *   The index of the node in g_spin_node, or -1 if all the nodes of this
+ *   CPU are in use.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MCS_SPINLOCK
+static int spin_node_alloc(void)
+{
+  int cpu = this_cpu();
+  unsigned int used = atomic_load(&g_spin_node_used[cpu]);
+  int i;
+
+  while (used != SP_NODE_MASK)
+    {
+      for (i = 0; (used & (1u << i)) != 0; i++);
+
+      if (atomic_compare_exchange_weak(&g_spin_node_used[cpu], &used,
+                                       used | (1u << i)))
+        {
+          return cpu * SP_NODE_NUM + i;
+        }
+    }
+
+  return -1;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: spin_lock_queued
+ *
+ * Description:
+ *   The slow path of spin_lock() for the queued spinlocks, taken when the
+ *   lock is contended.  The CPU appends itself to the queue of waiters and
+ *   spins on its own node until it reaches the head of the queue.  Only
+ *   the head polls the lock itself; once it has the lock it wakes up the
+ *   next waiter.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MCS_SPINLOCK
+void spin_lock_queued(FAR volatile spinlock_t *lock)
+{
+  FAR atomic_uint *value = (FAR atomic_uint *)lock;
+  FAR struct spin_node_s *node;
+  FAR struct spin_node_s *prev;
+  unsigned int tail;
+  unsigned int old;
+  int ndx;
+
+  ndx = spin_node_alloc();
+  if (ndx < 0)
+    {
+      /* Out of nodes, wait until the lock is free with nobody queued */
+
+      for (; ; )
+        {
+          old = SP_UNLOCKED;
+          if (atomic_compare_exchange_weak(value, &old, SP_LOCKED))
+            {
+              return;
+            }
+
+          SP_DSB();
+          SP_WFE();
+        }
+    }
+
+  node = &g_spin_node[ndx];
+  tail = (unsigned int)(ndx + 1) << SP_TAIL_SHIFT;
+
+  node->next   = NULL;
+  node->locked = false;
+
+  /* Become the tail of the queue */
+
+  old = atomic_load(value);
+  while (!atomic_compare_exchange_weak(value, &old,
+                                       (old & ~SP_TAIL_MASK) | tail));
+
+  if ((old & SP_TAIL_MASK) != 0)
+    {
+      /* Link behind the previous tail and wait to be the head */
+
+      prev = &g_spin_node[(old >> SP_TAIL_SHIFT) - 1];
+      atomic_thread_fence(memory_order_release);
+      prev->next = node;
+
+      while (!node->locked)
+        {
+          SP_DSB();
+          SP_WFE();
+        }
+
+      atomic_thread_fence(memory_order_acquire);
+    }
+
+  /* The head of the queue waits for the holder to leave */
+
+  for (; ; )
+    {
+      old = atomic_load(value);
+      if ((old & SP_LOCKED) != 0)
+        {
+          SP_DSB();
+          SP_WFE();
+          continue;
+        }
+
+      if ((old & SP_TAIL_MASK) == tail)
+        {
+          /* Nobody queued behind, take the lock and empty the queue */
+
+          if (atomic_compare_exchange_weak(value, &old, SP_LOCKED))
+            {
+              break;
+            }
+        }
+      else if (atomic_compare_exchange_weak(value, &old, old | SP_LOCKED))
+        {
+          /* Make the next waiter the head, it may still be linking */
+
+          while (node->next == NULL)
+            {
+              SP_DSB();
+            }
+
+          node->next->locked = true;
+          SP_DSB();
+          SP_SEV();
+          break;
+        }
+    }
+
+  atomic_fetch_and(&g_spin_node_used[ndx / SP_NODE_NUM],
+                   ~(1u << (ndx % SP_NODE_NUM)));
+}
+#endif
+
 #ifdef CONFIG_RW_SPINLOCK
 
 /****************************************************************************
@@ -0,0 +1,725 @@
+/****************************************************************************
+ * sched/misc/bench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/param.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <sched.h>
+#include <string.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/iob.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_NLOOPS     CONFIG_SCHED_BENCH_ITERATIONS
+
+#if !defined(CONFIG_DISABLE_MQUEUE) && defined(CONFIG_MQ_MAXMSGSIZE) && \
+    CONFIG_MQ_MAXMSGSIZE >= 16
+#  define BENCH_MQUEUE
+#endif
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define BENCH_WORK     HPWORK
+#else
+#  define BENCH_WORK     LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bench_result_s
+{
+  clock_t min;
+  clock_t max;
+  uint64_t total;
+  unsigned long count;
+};
+
+struct bench_s
+{
+  sem_t done;                        /* Posted by the finished threads */
+  sem_t sem[2];                      /* Handshake of two threads */
+  mutex_t mutex;                     /* Contended by the CPUs */
+  spinlock_t lock;                   /* Protects result */
+  volatile clock_t stamp;            /* Start of the measured operation */
+  struct bench_result_s result;
+#ifdef CONFIG_SCHED_WORKQUEUE
+  struct work_s work;
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct bench_s g_bench;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_reset, bench_add and bench_merge
+ ****************************************************************************/
+
+static void bench_reset(FAR struct bench_result_s *result)
+{
+  result->min   = (clock_t)-1;
+  result->max   = 0;
+  result->total = 0;
+  result->count = 0;
+}
+
+static void bench_add(FAR struct bench_result_s *result, clock_t elapsed)
+{
+  if (elapsed < result->min)
+    {
+      result->min = elapsed;
+    }
+
+  if (elapsed > result->max)
+    {
+      result->max = elapsed;
+    }
+
+  result->total += elapsed;
+  result->count++;
+}
+
+static void bench_merge(FAR const struct bench_result_s *result)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_bench.lock);
+
+  if (result->min < g_bench.result.min)
+    {
+      g_bench.result.min = result->min;
+    }
+
+  if (result->max > g_bench.result.max)
+    {
+      g_bench.result.max = result->max;
+    }
+
+  g_bench.result.total += result->total;
+  g_bench.result.count += result->count;
+
+  spin_unlock_irqrestore(&g_bench.lock, flags);
+}
+
+/****************************************************************************
+ * Name: bench_ns
+ ****************************************************************************/
+
+static uint64_t bench_ns(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: bench_report
+ *
+ * Description:
+ *   Log the minimum, average and maximum of one benchmark, in counts of
+ *   the performance counter and in nanoseconds.
+ *
+ ****************************************************************************/
+
+static void bench_report(FAR const char *name, int param)
+{
+  FAR struct bench_result_s *result = &g_bench.result;
+  clock_t avg;
+
+  if (result->count == 0)
+    {
+      syslog(LOG_INFO, "bench: %-20s %4d: no samples\n", name, param);
+      return;
+    }
+
+  avg = result->total / result->count;
+  syslog(LOG_INFO, "bench: %-20s %4d: min %8lu avg %8lu max %8lu "
+         "(%" PRIu64 "/%" PRIu64 "/%" PRIu64 " ns)\n", name, param,
+         (unsigned long)result->min, (unsigned long)avg,
+         (unsigned long)result->max, bench_ns(result->min), bench_ns(avg),
+         bench_ns(result->max));
+}
+
+/****************************************************************************
+ * Name: bench_spawn
+ *
+ * Description:
+ *   Start a benchmark thread, on the given CPU with SMP.
+ *
+ ****************************************************************************/
+
+static int bench_spawn(FAR const char *name, int priority, main_t entry,
+                       int cpu)
+{
+  pid_t pid;
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+#endif
+
+  pid = kthread_create(name, priority, CONFIG_SCHED_BENCH_STACKSIZE,
+                       entry, NULL);
+  if (pid < 0)
+    {
+      return pid;
+    }
+
+#ifdef CONFIG_SMP
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu, &cpuset);
+  nxsched_set_affinity(pid, sizeof(cpuset), &cpuset);
+#else
+  UNUSED(cpu);
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_join
+ ****************************************************************************/
+
+static void bench_join(int nthreads)
+{
+  while (nthreads-- > 0)
+    {
+      nxsem_wait_uninterruptible(&g_bench.done);
+    }
+}
+
+/****************************************************************************
+ * Name: bench_ctxsw
+ *
+ * Description:
+ *   Two threads of the same priority on the same CPU yield to each other,
+ *   each measures the time from the yield of the other one.
+ *
+ ****************************************************************************/
+
+static int bench_ctxsw_thread(int argc, FAR char *argv[])
+{
+  clock_t now;
+  int i;
+
+  for (i = 0; i < BENCH_NLOOPS; i++)
+    {
+      now = perf_gettime();
+      if (g_bench.stamp != 0)
+        {
+          bench_add(&g_bench.result, now - g_bench.stamp);
+        }
+
+      g_bench.stamp = perf_gettime();
+      sched_yield();
+    }
+
+  g_bench.stamp = 0;
+  nxsem_post(&g_bench.done);
+  return 0;
+}
+
+static void bench_ctxsw(void)
+{
+  int priority = nxsched_self()->sched_priority;
+  int cpu = this_cpu();
+
+  bench_reset(&g_bench.result);
+  g_bench.stamp = 0;
+
+  /* The threads do not preempt this one, they start once it waits */
+
+  if (bench_spawn("bench_ctxsw", priority, bench_ctxsw_thread, cpu) < 0 ||
+      bench_spawn("bench_ctxsw", priority, bench_ctxsw_thread, cpu) < 0)
+    {
+      return;
+    }
+
+  bench_join(2);
+  bench_report("context switch", 2);
+}
+
+/****************************************************************************
+ * Name: bench_semwake
+ *
+ * Description:
+ *   The time from nxsem_post() to the return of nxsem_wait() in a thread
+ *   of higher priority.
+ *
+ ****************************************************************************/
+
+static int bench_semwake_thread(int argc, FAR char *argv[])
+{
+  int i;
+
+  for (i = 0; i < BENCH_NLOOPS; i++)
+    {
+      nxsem_wait_uninterruptible(&g_bench.sem[0]);
+      bench_add(&g_bench.result, perf_gettime() - g_bench.stamp);
+      nxsem_post(&g_bench.sem[1]);
+    }
+
+  nxsem_post(&g_bench.done);
+  return 0;
+}
+
+static void bench_semwake(void)
+{
+  int priority = nxsched_self()->sched_priority;
+  int i;
+
+  bench_reset(&g_bench.result);
+
+  if (bench_spawn("bench_sem", priority + 1, bench_semwake_thread,
+                  this_cpu()) < 0)
+    {
+      return;
+    }
+
+  for (i = 0; i < BENCH_NLOOPS; i++)
+    {
+      g_bench.stamp = perf_gettime();
+      nxsem_post(&g_bench.sem[0]);
+      nxsem_wait_uninterruptible(&g_bench.sem[1]);
+    }
+
+  bench_join(1);
+  bench_report("sem_post wakeup", 1);
+}
+
+/****************************************************************************
+ * Name: bench_mutex
+ *
+ * Description:
+ *   The time of a lock and unlock pair of one mutex taken by one thread on
+ *   each of ncpus CPUs.
+ *
+ ****************************************************************************/
+
+static int bench_mutex_thread(int argc, FAR char *argv[])
+{
+  struct bench_result_s result;
+  clock_t start;
+  int i;
+
+  bench_reset(&result);
+
+  for (i = 0; i < BENCH_NLOOPS; i++)
+    {
+      start = perf_gettime();
+      nxmutex_lock(&g_bench.mutex);
+      nxmutex_unlock(&g_bench.mutex);
+      bench_add(&result, perf_gettime() - start);
+    }
+
+  bench_merge(&result);
+  nxsem_post(&g_bench.done);
+  return 0;
+}
+
+static void bench_mutex(void)
+{
+  int priority = nxsched_self()->sched_priority;
+  int nthreads;
+  int ncpus;
+
+  for (ncpus = 1; ncpus <= CONFIG_SMP_NCPUS; ncpus++)
+    {
+      bench_reset(&g_bench.result);
+
+      for (nthreads = 0; nthreads < ncpus; nthreads++)
+        {
+          if (bench_spawn("bench_mutex", priority, bench_mutex_thread,
+                          nthreads) < 0)
+            {
+              break;
+            }
+        }
+
+      bench_join(nthreads);
+      bench_report("nxmutex lock/unlock", ncpus);
+    }
+}
+
+/****************************************************************************
+ * Name: bench_mqueue
+ *
+ * Description:
+ *   The time of an nxmq_send() and nxmq_receive() pair of 16 bytes.
+ *
+ ****************************************************************************/
+
+#ifdef BENCH_MQUEUE
+static void bench_mqueue(void)
+{
+  struct mq_attr attr;
+  char msg[16];
+  clock_t start;
+  mqd_t mqd;
+  int i;
+
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = sizeof(msg);
+  attr.mq_flags   = 0;
+
+  mqd = nxmq_open("bench", O_RDWR | O_CREAT, 0666, &attr);
+  if (mqd < 0)
+    {
+      return;
+    }
+
+  bench_reset(&g_bench.result);
+  memset(msg, 0, sizeof(msg));
+
+  for (i = 0; i < BENCH_NLOOPS; i++)
+    {
+      start = perf_gettime();
+      nxmq_send(mqd, msg, sizeof(msg), 0);
+      nxmq_receive(mqd, msg, sizeof(msg), NULL);
+      bench_add(&g_bench.result, perf_gettime() - start);
+    }
+
+  nxmq_close(mqd);
+  nxmq_unlink("bench");
+  bench_report("mq send/receive", sizeof(msg));
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_work
+ *
+ * Description:
+ *   The time from work_queue() to the call of the worker.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+static void bench_worker(FAR void *arg)
+{
+  bench_add(&g_bench.result, perf_gettime() - g_bench.stamp);
+  nxsem_post(&g_bench.sem[1]);
+}
+
+static void bench_work(void)
+{
+  int i;
+
+  bench_reset(&g_bench.result);
+
+  for (i = 0; i < BENCH_NLOOPS; i++)
+    {
+      g_bench.stamp = perf_gettime();
+      work_queue(BENCH_WORK, &g_bench.work, bench_worker, NULL, 0);
+      nxsem_wait_uninterruptible(&g_bench.sem[1]);
+    }
+
+  bench_report("work_queue dispatch", BENCH_WORK);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_wdog
+ *
+ * Description:
+ *   The time of a wd_start() and wd_cancel() pair, inserted in the middle
+ *   of CONFIG_SCHED_BENCH_NWDOGS active watchdogs.
+ *
+ ****************************************************************************/
+
+static void bench_wdentry(wdparm_t arg)
+{
+}
+
+static void bench_wdog(void)
+{
+  FAR struct wdog_s *wdog;
+  sclock_t delay = SEC2TICK(3600);
+  clock_t start;
+  int i;
+
+  wdog = kmm_zalloc((CONFIG_SCHED_BENCH_NWDOGS + 1) * sizeof(*wdog));
+  if (wdog == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < CONFIG_SCHED_BENCH_NWDOGS; i++)
+    {
+      wd_start(&wdog[i], delay + i, bench_wdentry, 0);
+    }
+
+  bench_reset(&g_bench.result);
+
+  for (i = 0; i < BENCH_NLOOPS; i++)
+    {
+      start = perf_gettime();
+      wd_start(&wdog[CONFIG_SCHED_BENCH_NWDOGS],
+               delay + CONFIG_SCHED_BENCH_NWDOGS / 2, bench_wdentry, 0);
+      wd_cancel(&wdog[CONFIG_SCHED_BENCH_NWDOGS]);
+      bench_add(&g_bench.result, perf_gettime() - start);
+    }
+
+  for (i = 0; i < CONFIG_SCHED_BENCH_NWDOGS; i++)
+    {
+      wd_cancel(&wdog[i]);
+    }
+
+  kmm_free(wdog);
+  bench_report("wd_start/wd_cancel", CONFIG_SCHED_BENCH_NWDOGS);
+}
+
+/****************************************************************************
+ * Name: bench_malloc
+ *
+ * Description:
+ *   The time of a kmm_malloc() and kmm_free() pair by size class.
+ *
+ ****************************************************************************/
+
+static void bench_malloc(void)
+{
+  static const int sizes[] =
+  {
+    16, 64, 256, 1024, 4096
+  };
+
+  FAR void *mem;
+  clock_t start;
+  size_t j;
+  int i;
+
+  for (j = 0; j < nitems(sizes); j++)
+    {
+      bench_reset(&g_bench.result);
+
+      for (i = 0; i < BENCH_NLOOPS; i++)
+        {
+          start = perf_gettime();
+          mem = kmm_malloc(sizes[j]);
+          kmm_free(mem);
+          bench_add(&g_bench.result, perf_gettime() - start);
+        }
+
+      bench_report("kmm_malloc/kmm_free", sizes[j]);
+    }
+}
+
+/****************************************************************************
+ * Name: bench_iob
+ *
+ * Description:
+ *   The time of an iob_tryalloc() and iob_free() pair.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_IOB
+static void bench_iob(void)
+{
+  FAR struct iob_s *iob;
+  clock_t start;
+  int i;
+
+  bench_reset(&g_bench.result);
+
+  for (i = 0; i < BENCH_NLOOPS; i++)
+    {
+      start = perf_gettime();
+      iob = iob_tryalloc(false);
+      if (iob != NULL)
+        {
+          iob_free(iob);
+          bench_add(&g_bench.result, perf_gettime() - start);
+        }
+    }
+
+  bench_report("iob_alloc/iob_free", CONFIG_IOB_BUFSIZE);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_epoll
+ *
+ * Description:
+ *   The time of an epoll_wait() that returns one ready eventfd, with an
+ *   increasing number of watched eventfds.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_EVENT_FD
+static void bench_epoll(void)
+{
+  struct epoll_event ev;
+  eventfd_t value = 1;
+  FAR int *fds;
+  clock_t start;
+  int nfds;
+  int epfd;
+  int i;
+
+  fds = kmm_malloc(CONFIG_SCHED_BENCH_NFDS * sizeof(int));
+  if (fds == NULL)
+    {
+      return;
+    }
+
+  for (nfds = 1; nfds <= CONFIG_SCHED_BENCH_NFDS; nfds *= 4)
+    {
+      epfd = epoll_create1(EPOLL_CLOEXEC);
+      if (epfd < 0)
+        {
+          break;
+        }
+
+      for (i = 0; i < nfds; i++)
+        {
+          fds[i] = eventfd(0, EFD_NONBLOCK);
+          if (fds[i] < 0)
+            {
+              break;
+            }
+
+          ev.events  = EPOLLIN;
+          ev.data.fd = fds[i];
+          epoll_ctl(epfd, EPOLL_CTL_ADD, fds[i], &ev);
+        }
+
+      bench_reset(&g_bench.result);
+
+      if (i == nfds)
+        {
+          nx_write(fds[nfds - 1], &value, sizeof(value));
+
+          for (i = 0; i < BENCH_NLOOPS; i++)
+            {
+              start = perf_gettime();
+              epoll_wait(epfd, &ev, 1, 0);
+              bench_add(&g_bench.result, perf_gettime() - start);
+            }
+
+          i = nfds;
+        }
+
+      while (i-- > 0)
+        {
+          nx_close(fds[i]);
+        }
+
+      nx_close(epfd);
+      bench_report("epoll_wait", nfds);
+    }
+
+  kmm_free(fds);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_main
+ ****************************************************************************/
+
+static int bench_main(int argc, FAR char *argv[])
+{
+  syslog(LOG_INFO, "bench: %d iterations, %lu Hz performance counter\n",
+         BENCH_NLOOPS, perf_getfreq());
+
+  nxsem_init(&g_bench.done, 0, 0);
+  nxsem_init(&g_bench.sem[0], 0, 0);
+  nxsem_init(&g_bench.sem[1], 0, 0);
+  nxmutex_init(&g_bench.mutex);
+
+  bench_ctxsw();
+  bench_semwake();
+  bench_mutex();
+#ifdef BENCH_MQUEUE
+  bench_mqueue();
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE
+  bench_work();
+#endif
+  bench_wdog();
+  bench_malloc();
+#ifdef CONFIG_MM_IOB
+  bench_iob();
+#endif
+#ifdef CONFIG_EVENT_FD
+  bench_epoll();
+#endif
+
+  nxmutex_destroy(&g_bench.mutex);
+  nxsem_destroy(&g_bench.sem[1]);
+  nxsem_destroy(&g_bench.sem[0]);
+  nxsem_destroy(&g_bench.done);
+
+  syslog(LOG_INFO, "bench: done\n");
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbench_start
+ *
+ * Description:
+ *   Start the kernel thread that runs the micro-benchmarks once and logs
+ *   the results.
+ *
+ ****************************************************************************/
+
+int nxbench_start(void)
+{
+  int pid;
+
+  pid = kthread_create("bench", CONFIG_SCHED_BENCH_PRIORITY,
+                       CONFIG_SCHED_BENCH_STACKSIZE, bench_main, NULL);
+  return pid < 0 ? pid : OK;
+}
@@ -62,6 +62,9 @@
  *   ENOSPC    There is insufficient space for the creation of the new
  *             message queue
  *
+ *   With CONFIG_MQ_RING, MQ_RING in attr->mq_flags preallocates the
+ *   messages in a ring, see nxmq_ring_alloc().
+ *
  ****************************************************************************/
 
 int nxmq_alloc_msgq(FAR struct mq_attr *attr,
@@ -106,6 +109,18 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
 
       dq_init(&msgq->cmn.waitfornotempty);
       dq_init(&msgq->cmn.waitfornotfull);
+
+#ifdef CONFIG_MQ_RING
+      if (attr && (attr->mq_flags & MQ_RING) != 0)
+        {
+          int ret = nxmq_ring_alloc(msgq);
+          if (ret < 0)
+            {
+              kmm_free(msgq);
+              return ret;
+            }
+        }
+#endif
     }
   else
     {
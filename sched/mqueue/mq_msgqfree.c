@@ -68,6 +68,13 @@ void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq)
       nxmq_free_msg(entry);
     }
 
+#ifdef CONFIG_MQ_RING
+  if (msgq->ring != NULL)
+    {
+      nxmq_ring_free(msgq);
+    }
+#endif
+
   /* Then deallocate the message queue itself */
 
   kmm_free(msgq);
@@ -77,6 +77,7 @@
  *     valid signal number.
  *   ENOMEM
  *     Insufficient memory.
+ *   ENOTSUP The queue was created with MQ_RING.
  *
  * Assumptions:
  *
@@ -134,6 +135,17 @@ int mq_notify(mqd_t mqdes, FAR const struct sigevent *notification)
   /* Is there already a notification attached */
 
   msgq = inode->i_private;
+
+#ifdef CONFIG_MQ_RING
+  /* Ring queues do not take the critical section needed to notify */
+
+  if (msgq->ring != NULL)
+    {
+      errval = ENOTSUP;
+      goto errout;
+    }
+#endif
+
   if (msgq->ntpid == INVALID_PROCESS_ID)
     {
       /* No... Have we been asked to establish one? */
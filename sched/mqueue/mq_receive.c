@@ -94,6 +94,14 @@ ssize_t file_mq_receive(FAR struct file *mq, FAR char *msg, size_t msglen,
 
   msgq = mq->f_inode->i_private;
 
+#ifdef CONFIG_MQ_RING
+  if (msgq->ring != NULL)
+    {
+      return nxmq_ring_receive(msgq, mq->f_oflags, msg, msglen, prio, NULL,
+                               MQ_RING_FOREVER);
+    }
+#endif
+
   /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
    * because messages can be sent from interrupt level.
    */
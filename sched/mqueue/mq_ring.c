@@ -0,0 +1,493 @@
+/****************************************************************************
+ * sched/mqueue/mq_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Largest ring, so that the number of messages fits in maxmsgs */
+
+#define MQ_RING_MAXSLOTS   16384
+
+/* Each slot holds a sequence word followed by the payload.  The word tells
+ * whether the slot is free for the sender at a position (== position) or
+ * holds the message for the receiver at a position (== position + 1).
+ */
+
+#define MQ_RING_SEQ(r, pos) \
+  ((FAR volatile uint32_t *) \
+   ((r)->slots + ((pos) & (r)->mask) * (r)->slotsize))
+#define MQ_RING_DATA(r, pos) \
+  ((FAR char *)MQ_RING_SEQ(r, pos) + sizeof(uint32_t))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_ring_wait
+ *
+ * Description:
+ *   Wait on one of the semaphores of the ring until it is posted or the
+ *   timeout expires.
+ *
+ ****************************************************************************/
+
+static int nxmq_ring_wait(FAR sem_t *sem, FAR const struct timespec *abstime,
+                          sclock_t ticks, clock_t start)
+{
+  if (abstime != NULL)
+    {
+      return nxsem_clockwait(sem, CLOCK_REALTIME, abstime);
+    }
+
+  if (ticks == MQ_RING_FOREVER)
+    {
+      return nxsem_wait(sem);
+    }
+
+  ticks -= (sclock_t)(clock_systime_ticks() - start);
+  if (ticks <= 0)
+    {
+      return -ETIMEDOUT;
+    }
+
+  return nxsem_tickwait(sem, ticks);
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_put
+ *
+ * Description:
+ *   Copy a message into the next free slot without blocking.
+ *
+ * Returned Value:
+ *   true if the message was added, false if the ring is full.
+ *
+ ****************************************************************************/
+
+static bool nxmq_ring_put(FAR struct mqueue_ring_s *ring,
+                          FAR const char *msg, size_t msglen)
+{
+  FAR volatile uint32_t *seqp;
+  uint32_t pos;
+  int32_t diff;
+
+  pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+  for (; ; )
+    {
+      seqp = MQ_RING_SEQ(ring, pos);
+      diff = (int32_t)(__atomic_load_n(seqp, __ATOMIC_ACQUIRE) - pos);
+      if (diff == 0)
+        {
+          /* The slot is free, claim it */
+
+          if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1,
+                                          false, __ATOMIC_RELAXED,
+                                          __ATOMIC_RELAXED))
+            {
+              break;
+            }
+        }
+      else if (diff < 0)
+        {
+          /* The slot still holds the message of the previous lap */
+
+          return false;
+        }
+      else
+        {
+          pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+        }
+    }
+
+  memcpy(MQ_RING_DATA(ring, pos), msg, msglen);
+  __atomic_store_n(seqp, pos + 1, __ATOMIC_SEQ_CST);
+  return true;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_get
+ *
+ * Description:
+ *   Copy the oldest message out of the ring without blocking.
+ *
+ * Returned Value:
+ *   true if a message was removed, false if the ring is empty.
+ *
+ ****************************************************************************/
+
+static bool nxmq_ring_get(FAR struct mqueue_ring_s *ring, FAR char *msg,
+                          size_t msglen)
+{
+  FAR volatile uint32_t *seqp;
+  uint32_t pos;
+  int32_t diff;
+
+  pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+  for (; ; )
+    {
+      seqp = MQ_RING_SEQ(ring, pos);
+      diff = (int32_t)(__atomic_load_n(seqp, __ATOMIC_ACQUIRE) - (pos + 1));
+      if (diff == 0)
+        {
+          if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1,
+                                          false, __ATOMIC_RELAXED,
+                                          __ATOMIC_RELAXED))
+            {
+              break;
+            }
+        }
+      else if (diff < 0)
+        {
+          return false;
+        }
+      else
+        {
+          pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+  memcpy(msg, MQ_RING_DATA(ring, pos), msglen);
+  __atomic_store_n(seqp, pos + ring->mask + 1, __ATOMIC_SEQ_CST);
+  return true;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_notify
+ *
+ * Description:
+ *   Notify the pollers, if any, of the current state of the queue.  With
+ *   several senders or receivers, the number of messages may skip the
+ *   values at the edges, so this is done after each message.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_MQUEUE_NPOLLWAITERS > 0
+static void nxmq_ring_notify(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_ring_s *ring = msgq->ring;
+  pollevent_t eventset = 0;
+  irqstate_t flags;
+  uint32_t nmsgs;
+  int i;
+
+  /* Pairs with the fence of nxmq_file_poll(): either a poller being set
+   * up sees the new state of the ring or it is seen here.
+   */
+
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  for (i = 0; i < CONFIG_FS_MQUEUE_NPOLLWAITERS; i++)
+    {
+      if (__atomic_load_n(&msgq->fds[i], __ATOMIC_RELAXED) != NULL)
+        {
+          break;
+        }
+    }
+
+  if (i >= CONFIG_FS_MQUEUE_NPOLLWAITERS)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  nmsgs = ring->head - ring->tail;
+  if (nmsgs > 0)
+    {
+      eventset |= POLLIN;
+    }
+
+  if (nmsgs <= ring->mask)
+    {
+      eventset |= POLLOUT;
+    }
+
+  nxmq_pollnotify(msgq, eventset);
+  leave_critical_section(flags);
+}
+#else
+#  define nxmq_ring_notify(msgq)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_ring_alloc
+ *
+ * Description:
+ *   Allocate the ring of a message queue created with MQ_RING.  The number
+ *   of messages is rounded up to a power of two.
+ *
+ * Input Parameters:
+ *   msgq - The new message queue, maxmsgs and maxmsgsize are set.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -EINVAL if the queue is too large or -ENOSPC.
+ *
+ ****************************************************************************/
+
+int nxmq_ring_alloc(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_ring_s *ring;
+  uint32_t nslots = 1;
+  uint32_t slotsize;
+  uint32_t i;
+
+  while (nslots < (uint32_t)msgq->maxmsgs)
+    {
+      nslots <<= 1;
+    }
+
+  if (nslots > MQ_RING_MAXSLOTS)
+    {
+      return -EINVAL;
+    }
+
+  slotsize = sizeof(uint32_t) +
+             ((msgq->maxmsgsize + sizeof(uint32_t) - 1) &
+              ~(sizeof(uint32_t) - 1));
+
+  ring = kmm_zalloc(sizeof(struct mqueue_ring_s) + nslots * slotsize);
+  if (ring == NULL)
+    {
+      return -ENOSPC;
+    }
+
+  ring->mask     = nslots - 1;
+  ring->slotsize = slotsize;
+  ring->slots    = (FAR uint8_t *)(ring + 1);
+
+  for (i = 0; i < nslots; i++)
+    {
+      *MQ_RING_SEQ(ring, i) = i;
+    }
+
+  nxsem_init(&ring->notfull, 0, 0);
+  nxsem_init(&ring->notempty, 0, 0);
+
+  msgq->maxmsgs = nslots;
+  msgq->ring    = ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_free
+ *
+ * Description:
+ *   Free the ring of a message queue, with the messages still in it.
+ *
+ ****************************************************************************/
+
+void nxmq_ring_free(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_ring_s *ring = msgq->ring;
+
+  nxsem_destroy(&ring->notfull);
+  nxsem_destroy(&ring->notempty);
+  kmm_free(ring);
+  msgq->ring = NULL;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_send
+ *
+ * Description:
+ *   Send a message to a ring queue.  When the ring is not full, no lock is
+ *   taken and interrupts stay enabled: the message is copied into a slot
+ *   claimed with a compare-and-swap, and the semaphore is posted only if a
+ *   receiver sleeps on the empty ring.
+ *
+ * Input Parameters:
+ *   msgq    - The message queue.
+ *   oflags  - Open flags of the descriptor.
+ *   msg     - The message, exactly maxmsgsize bytes.
+ *   msglen  - The length of the message.
+ *   prio    - The priority of the message, must be zero.
+ *   abstime - Absolute CLOCK_REALTIME timeout, or NULL to use 'ticks'.
+ *   ticks   - Relative timeout, or MQ_RING_FOREVER.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, or a negated errno value as [nx]mq_send().
+ *
+ ****************************************************************************/
+
+int nxmq_ring_send(FAR struct mqueue_inode_s *msgq, int oflags,
+                   FAR const char *msg, size_t msglen, unsigned int prio,
+                   FAR const struct timespec *abstime, sclock_t ticks)
+{
+  FAR struct mqueue_ring_s *ring = msgq->ring;
+  clock_t start = 0;
+  int ret;
+
+  if (abstime == NULL && ticks != MQ_RING_FOREVER)
+    {
+      start = clock_systime_ticks();
+    }
+
+  if (prio != 0)
+    {
+      return -EINVAL;
+    }
+
+  if (msglen != msgq->maxmsgsize)
+    {
+      return -EMSGSIZE;
+    }
+
+  while (!nxmq_ring_put(ring, msg, msglen))
+    {
+      if ((oflags & O_NONBLOCK) != 0 || up_interrupt_context())
+        {
+          return -EAGAIN;
+        }
+
+      /* Register as a waiter before trying again, so that a receiver
+       * freeing a slot now either lets the retry succeed or posts the
+       * semaphore.
+       */
+
+      __atomic_fetch_add(&ring->nwaitsend, 1, __ATOMIC_SEQ_CST);
+      if (nxmq_ring_put(ring, msg, msglen))
+        {
+          __atomic_fetch_sub(&ring->nwaitsend, 1, __ATOMIC_SEQ_CST);
+          break;
+        }
+
+      ret = nxmq_ring_wait(&ring->notfull, abstime, ticks, start);
+      __atomic_fetch_sub(&ring->nwaitsend, 1, __ATOMIC_SEQ_CST);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (__atomic_load_n(&ring->nwaitrecv, __ATOMIC_SEQ_CST) > 0)
+    {
+      nxsem_post(&ring->notempty);
+    }
+
+  nxmq_ring_notify(msgq);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_receive
+ *
+ * Description:
+ *   Receive the oldest message of a ring queue.  See nxmq_ring_send().
+ *
+ * Input Parameters:
+ *   msgq    - The message queue.
+ *   oflags  - Open flags of the descriptor.
+ *   msg     - The buffer receiving the message.
+ *   msglen  - The size of the buffer, at least maxmsgsize.
+ *   prio    - If not NULL, receives the priority of the message (zero).
+ *   abstime - Absolute CLOCK_REALTIME timeout, or NULL to use 'ticks'.
+ *   ticks   - Relative timeout, or MQ_RING_FOREVER.
+ *
+ * Returned Value:
+ *   The length of the message on success, or a negated errno value as
+ *   [nx]mq_receive().
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_ring_receive(FAR struct mqueue_inode_s *msgq, int oflags,
+                          FAR char *msg, size_t msglen,
+                          FAR unsigned int *prio,
+                          FAR const struct timespec *abstime,
+                          sclock_t ticks)
+{
+  FAR struct mqueue_ring_s *ring = msgq->ring;
+  clock_t start = 0;
+  int ret;
+
+  if (abstime == NULL && ticks != MQ_RING_FOREVER)
+    {
+      start = clock_systime_ticks();
+    }
+
+  msglen = msgq->maxmsgsize;
+
+  while (!nxmq_ring_get(ring, msg, msglen))
+    {
+      if ((oflags & O_NONBLOCK) != 0)
+        {
+          return -EAGAIN;
+        }
+
+      __atomic_fetch_add(&ring->nwaitrecv, 1, __ATOMIC_SEQ_CST);
+      if (nxmq_ring_get(ring, msg, msglen))
+        {
+          __atomic_fetch_sub(&ring->nwaitrecv, 1, __ATOMIC_SEQ_CST);
+          break;
+        }
+
+      ret = nxmq_ring_wait(&ring->notempty, abstime, ticks, start);
+      __atomic_fetch_sub(&ring->nwaitrecv, 1, __ATOMIC_SEQ_CST);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (__atomic_load_n(&ring->nwaitsend, __ATOMIC_SEQ_CST) > 0)
+    {
+      nxsem_post(&ring->notfull);
+    }
+
+  nxmq_ring_notify(msgq);
+
+  if (prio != NULL)
+    {
+      *prio = 0;
+    }
+
+  return msglen;
+}
+
+#endif /* CONFIG_MQ_RING */
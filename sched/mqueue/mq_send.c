@@ -90,6 +90,14 @@ int file_mq_send(FAR struct file *mq, FAR const char *msg, size_t msglen,
 
   msgq = mq->f_inode->i_private;
 
+#ifdef CONFIG_MQ_RING
+  if (msgq->ring != NULL)
+    {
+      return nxmq_ring_send(msgq, mq->f_oflags, msg, msglen, prio, NULL,
+                            MQ_RING_FOREVER);
+    }
+#endif
+
   /* Allocate a message structure:
    * - Immediately if we are called from an interrupt handler.
    * - Immediately if the message queue is not full, or
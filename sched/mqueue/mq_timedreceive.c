@@ -154,6 +154,14 @@ file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 
   msgq = mq->f_inode->i_private;
 
+#ifdef CONFIG_MQ_RING
+  if (msgq->ring != NULL)
+    {
+      return nxmq_ring_receive(msgq, mq->f_oflags, msg, msglen, prio,
+                               abstime, ticks);
+    }
+#endif
+
   /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
    * because messages can be sent from interrupt level.
    */
@@ -156,6 +156,14 @@ file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
 
   msgq = mq->f_inode->i_private;
 
+#ifdef CONFIG_MQ_RING
+  if (msgq->ring != NULL)
+    {
+      return nxmq_ring_send(msgq, mq->f_oflags, msg, msglen, prio, abstime,
+                            ticks);
+    }
+#endif
+
   /* Disable interruption */
 
   flags = enter_critical_section();
@@ -49,6 +49,10 @@
 #define MQ_MAX_MSGS    16
 #define MQ_PRIO_MAX    _POSIX_MQ_PRIO_MAX
 
+/* No timeout for nxmq_ring_send() and nxmq_ring_receive() */
+
+#define MQ_RING_FOREVER ((sclock_t)(CLOCK_MAX >> 1))
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -142,6 +146,21 @@ int nxmq_do_send(FAR struct mqueue_inode_s *msgq,
                  FAR struct mqueue_msg_s *mqmsg,
                  FAR const char *msg, size_t msglen, unsigned int prio);
 
+/* mq_ring.c ****************************************************************/
+
+#ifdef CONFIG_MQ_RING
+int nxmq_ring_alloc(FAR struct mqueue_inode_s *msgq);
+void nxmq_ring_free(FAR struct mqueue_inode_s *msgq);
+int nxmq_ring_send(FAR struct mqueue_inode_s *msgq, int oflags,
+                   FAR const char *msg, size_t msglen, unsigned int prio,
+                   FAR const struct timespec *abstime, sclock_t ticks);
+ssize_t nxmq_ring_receive(FAR struct mqueue_inode_s *msgq, int oflags,
+                          FAR char *msg, size_t msglen,
+                          FAR unsigned int *prio,
+                          FAR const struct timespec *abstime,
+                          sclock_t ticks);
+#endif
+
 /* mq_recover.c *************************************************************/
 
 void nxmq_recover(FAR struct tcb_s *tcb);
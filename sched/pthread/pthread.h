@@ -78,6 +78,19 @@
 #  define mutex_setprioceiling(m,p,o) nxmutex_setprioceiling(m,p,o)
 #endif
 
+/* A terminated pthread whose TCB and stack were both allocated by
+ * nx_pthread_create() may be kept for reuse by pthread_tcbcache_put().
+ */
+
+#if defined(CONFIG_PTHREAD_TCBCACHE) && CONFIG_PTHREAD_TCBCACHE > 0
+#  define PTHREAD_TCBCACHE_KEEP(tcb, ttype) \
+     ((ttype) == TCB_FLAG_TTYPE_PTHREAD && \
+      ((tcb)->flags & (TCB_FLAG_FREE_TCB | TCB_FLAG_FREE_STACK)) == \
+      (TCB_FLAG_FREE_TCB | TCB_FLAG_FREE_STACK))
+#else
+#  define PTHREAD_TCBCACHE_KEEP(tcb, ttype) false
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -107,6 +120,11 @@ int pthread_findjoininfo(FAR struct task_group_s *group, pid_t pid,
                          FAR struct task_join_s **join, bool create);
 void pthread_release(FAR struct task_group_s *group);
 
+#if defined(CONFIG_PTHREAD_TCBCACHE) && CONFIG_PTHREAD_TCBCACHE > 0
+FAR struct pthread_tcb_s *pthread_tcbcache_get(size_t stacksize);
+void pthread_tcbcache_put(FAR struct tcb_s *tcb);
+#endif
+
 int pthread_sem_take(FAR sem_t *sem, FAR const struct timespec *abs_timeout);
 #ifdef CONFIG_PTHREAD_MUTEX_UNSAFE
 int pthread_sem_trytake(FAR sem_t *sem);
@@ -207,9 +207,19 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
       attr = &default_attr;
     }
 
-  /* Allocate a TCB for the new task. */
+  /* Allocate a TCB for the new task, or reuse a cached one that already
+   * has a stack of the requested size.
+   */
+
+#if defined(CONFIG_PTHREAD_TCBCACHE) && CONFIG_PTHREAD_TCBCACHE > 0
+  ptcb = attr->stackaddr == NULL ?
+         pthread_tcbcache_get(attr->stacksize) : NULL;
+  if (ptcb == NULL)
+#endif
+    {
+      ptcb = kmm_zalloc(sizeof(struct pthread_tcb_s));
+    }
 
-  ptcb = kmm_zalloc(sizeof(struct pthread_tcb_s));
   if (!ptcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -251,13 +261,19 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
       ret = up_use_stack((FAR struct tcb_s *)ptcb, attr->stackaddr,
                          attr->stacksize);
     }
-  else
+  else if (ptcb->cmn.stack_alloc_ptr == NULL)
     {
       /* Allocate the stack for the TCB */
 
       ret = up_create_stack((FAR struct tcb_s *)ptcb, attr->stacksize,
                             TCB_FLAG_TTYPE_PTHREAD);
     }
+  else
+    {
+      /* A cached TCB comes with its stack */
+
+      ret = OK;
+    }
 
   if (ret != OK)
     {
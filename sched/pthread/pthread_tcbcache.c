@@ -0,0 +1,229 @@
+/****************************************************************************
+ * sched/pthread/pthread_tcbcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+
+#include "pthread/pthread.h"
+
+#if defined(CONFIG_PTHREAD_TCBCACHE) && CONFIG_PTHREAD_TCBCACHE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* up_create_stack() may give up to STACK_ALIGNMENT - 1 bytes less than the
+ * requested size.  This is the largest STACK_ALIGNMENT of all
+ * architectures, a cached stack that is that close to the requested size
+ * is as good as a new one.
+ */
+
+#define PTHREAD_TCBCACHE_SLOP 16
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pthread_tcbcache_s
+{
+  FAR struct pthread_tcb_s *tcb;  /* TCB with its stack still allocated */
+  size_t size;                    /* Stack size from up_create_stack() */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct pthread_tcbcache_s g_tcbcache[CONFIG_PTHREAD_TCBCACHE];
+static int g_ntcbcache;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_tcbcache_recolor
+ *
+ * Description:
+ *   Color again the part of the stack used by the last thread, that is the
+ *   part above its high water mark.  The word at the bottom of the stack
+ *   still has the color, unless the stack was full.
+ *
+ * Returned Value:
+ *   true on success; false if the stack was full.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STACK_COLORATION
+static bool pthread_tcbcache_recolor(FAR struct tcb_s *tcb)
+{
+  FAR uint32_t *ptr;
+  FAR uint32_t *end;
+  uint32_t color;
+  size_t used;
+
+  used = up_check_tcbstack(tcb);
+  if (used + sizeof(uint32_t) > tcb->adj_stack_size)
+    {
+      return false;
+    }
+
+  color = *(FAR uint32_t *)tcb->stack_base_ptr;
+  end   = (FAR uint32_t *)((uintptr_t)tcb->stack_base_ptr +
+                           tcb->adj_stack_size);
+  ptr   = (FAR uint32_t *)(((uintptr_t)end - used) &
+                           ~(sizeof(uint32_t) - 1));
+
+  while (ptr < end)
+    {
+      *ptr++ = color;
+    }
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_tcbcache_get
+ *
+ * Description:
+ *   Take a cached pthread TCB with a stack of the requested size.  The TCB
+ *   is cleared as if it was just allocated, but its stack fields describe
+ *   the whole stack, so that there is no need to call up_create_stack().
+ *
+ * Input Parameters:
+ *   stacksize - The requested stack size
+ *
+ * Returned Value:
+ *   The TCB, or NULL if there is none with a stack of this size.
+ *
+ ****************************************************************************/
+
+FAR struct pthread_tcb_s *pthread_tcbcache_get(size_t stacksize)
+{
+  FAR struct pthread_tcb_s *ptcb = NULL;
+  FAR void *stack;
+  irqstate_t flags;
+  size_t size = 0;
+  int i;
+
+  /* An exiting thread puts its TCB in the cache while it still runs on its
+   * stack.  It leaves the critical section only when it switches out.
+   */
+
+  flags = enter_critical_section();
+
+  for (i = 0; i < g_ntcbcache; i++)
+    {
+      if (g_tcbcache[i].size <= stacksize &&
+          g_tcbcache[i].size + PTHREAD_TCBCACHE_SLOP > stacksize)
+        {
+          ptcb = g_tcbcache[i].tcb;
+          size = g_tcbcache[i].size;
+          g_tcbcache[i] = g_tcbcache[--g_ntcbcache];
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  if (ptcb == NULL)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_STACK_COLORATION
+  if (!pthread_tcbcache_recolor(&ptcb->cmn))
+    {
+      up_release_stack(&ptcb->cmn, TCB_FLAG_TTYPE_PTHREAD);
+      kmm_free(ptcb);
+      return NULL;
+    }
+#endif
+
+  stack = ptcb->cmn.stack_alloc_ptr;
+  memset(ptcb, 0, sizeof(struct pthread_tcb_s));
+
+  ptcb->cmn.stack_alloc_ptr = stack;
+  ptcb->cmn.stack_base_ptr  = stack;
+  ptcb->cmn.adj_stack_size  = size;
+  ptcb->cmn.flags           = TCB_FLAG_FREE_STACK;
+
+  return ptcb;
+}
+
+/****************************************************************************
+ * Name: pthread_tcbcache_put
+ *
+ * Description:
+ *   Keep the TCB of a terminated pthread and its stack for reuse.  If the
+ *   cache is full, the stack and the TCB are freed.
+ *
+ * Input Parameters:
+ *   tcb - The TCB, see PTHREAD_TCBCACHE_KEEP()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pthread_tcbcache_put(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (g_ntcbcache < CONFIG_PTHREAD_TCBCACHE)
+    {
+      /* Frames, like the TLS data, were taken from the bottom */
+
+      g_tcbcache[g_ntcbcache].tcb  = (FAR struct pthread_tcb_s *)tcb;
+      g_tcbcache[g_ntcbcache].size = tcb->adj_stack_size +
+        ((uintptr_t)tcb->stack_base_ptr - (uintptr_t)tcb->stack_alloc_ptr);
+      g_ntcbcache++;
+
+      leave_critical_section(flags);
+      return;
+    }
+
+  leave_critical_section(flags);
+
+  up_release_stack(tcb, TCB_FLAG_TTYPE_PTHREAD);
+  kmm_free(tcb);
+}
+
+#endif /* CONFIG_PTHREAD_TCBCACHE > 0 */
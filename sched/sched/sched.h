@@ -331,6 +331,22 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb);
 int  nxsched_set_priority(FAR struct tcb_s *tcb, int sched_priority);
 bool nxsched_reprioritize_rtr(FAR struct tcb_s *tcb, int priority);
 
+/* Priority bitmap of the ready-to-run list */
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+FAR struct tcb_s *nxsched_rtr_search(FAR struct tcb_s *tcb);
+void nxsched_rtr_add(FAR struct tcb_s *tcb);
+void nxsched_rtr_remove(FAR struct tcb_s *tcb);
+void nxsched_rtr_setpriority(FAR struct tcb_s *tcb, int priority);
+#else
+#  define nxsched_rtr_search(tcb) \
+     ((FAR struct tcb_s *)list_readytorun()->head)
+#  define nxsched_rtr_add(tcb)
+#  define nxsched_rtr_remove(tcb)
+#  define nxsched_rtr_setpriority(tcb, priority) \
+     ((tcb)->sched_priority = (uint8_t)(priority))
+#endif
+
 /* Priority inheritance support */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -348,6 +364,15 @@ void nxsched_reassess_timer(void);
 #  define nxsched_reassess_timer()
 #endif
 
+#ifdef CONFIG_SCHED_TICKLESS_PERCPU
+void nxsched_cputimer_suspend(FAR struct tcb_s *tcb);
+void nxsched_cputimer_resume(FAR struct tcb_s *tcb);
+void nxsched_cputimer_reassess(void);
+#  define nxsched_reassess_timeslice() nxsched_cputimer_reassess()
+#else
+#  define nxsched_reassess_timeslice() nxsched_reassess_timer()
+#endif
+
 /* Scheduler policy support */
 
 #if CONFIG_RR_INTERVAL > 0
@@ -367,6 +392,34 @@ uint32_t nxsched_process_sporadic(FAR struct tcb_s *tcb, uint32_t ticks,
 void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  nxsched_start_deadline(FAR struct tcb_s *tcb, clock_t runtime,
+                            clock_t deadline, clock_t period);
+int  nxsched_stop_deadline(FAR struct tcb_s *tcb);
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb);
+void nxsched_resume_deadline(FAR struct tcb_s *tcb);
+void nxsched_suspend_deadline(FAR struct tcb_s *tcb);
+
+/* Deadline tasks of the same priority run in the order of their absolute
+ * deadlines, other tasks in the FIFO order.
+ */
+
+#  define nxsched_deadline_before(a, b) \
+     (((a)->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE && \
+      ((b)->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE && \
+      (sclock_t)((a)->deadline->absdeadline - \
+                 (b)->deadline->absdeadline) < 0)
+#else
+#  define nxsched_deadline_before(a, b) false
+#endif
+
+/* True if the task 'a' is to run before the task 'b' */
+
+#define nxsched_tcb_before(a, b) \
+  ((a)->sched_priority > (b)->sched_priority || \
+   ((a)->sched_priority == (b)->sched_priority && \
+    nxsched_deadline_before(a, b)))
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
@@ -396,6 +449,9 @@ static inline_function FAR struct tcb_s *this_task(void)
 }
 
 int  nxsched_select_cpu(cpu_set_t affinity);
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+FAR struct tcb_s *nxsched_steal_candidate(int cpu);
+#endif
 int  nxsched_pause_cpu(FAR struct tcb_s *tcb);
 
 #  define nxsched_islocked_global() (g_cpu_lockset != 0)
@@ -423,6 +479,10 @@ void nxsched_resume_critmon(FAR struct tcb_s *tcb);
 void nxsched_suspend_critmon(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_IRQTIME
+void nxsched_critmon_irq(bool state);
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
 void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
                                 FAR void *caller);
@@ -443,4 +503,10 @@ struct tls_info_s; /* Forward declare */
 FAR struct tls_info_s *nxsched_get_tls(FAR struct tcb_s *tcb);
 FAR char **nxsched_get_stackargs(FAR struct tcb_s *tcb);
 
+/* Kernel micro-benchmarks */
+
+#ifdef CONFIG_SCHED_BENCH
+int nxbench_start(void);
+#endif
+
 #endif /* __SCHED_SCHED_SCHED_H */
@@ -68,20 +68,28 @@ bool nxsched_add_prioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 {
   FAR struct tcb_s *next;
   FAR struct tcb_s *prev;
-  uint8_t sched_priority = tcb->sched_priority;
   bool ret = false;
 
   /* Lets do a sanity check before we get started. */
 
-  DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
+  DEBUGASSERT(tcb->sched_priority >= SCHED_PRIORITY_MIN);
 
   /* Search the list to find the location to insert the new Tcb.
-   * Each is list is maintained in descending sched_priority order.
+   * Each is list is maintained in descending sched_priority order, and
+   * in deadline order among deadline tasks of the same priority.  The
+   * priority bitmap of the ready-to-run list skips the higher priorities.
    */
 
-  for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
-       next = next->flink);
+  if (list == list_readytorun())
+    {
+      next = nxsched_rtr_search(tcb);
+    }
+  else
+    {
+      next = (FAR struct tcb_s *)list->head;
+    }
+
+  for (; next && !nxsched_tcb_before(tcb, next); next = next->flink);
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
    * goes at the end of the list. NOTE:  This could only happen if list
@@ -139,5 +147,10 @@ bool nxsched_add_prioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
         }
     }
 
+  if (list == list_readytorun())
+    {
+      nxsched_rtr_add(tcb);
+    }
+
   return ret;
 }
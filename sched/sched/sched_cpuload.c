@@ -30,6 +30,7 @@
 #include <assert.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/cpufreq.h>
 #include <nuttx/irq.h>
 
 #include "sched/sched.h"
@@ -61,6 +62,17 @@
       CONFIG_SCHED_CPULOAD_TIMECONSTANT * \
       CPULOAD_TICKSPERSEC)
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Free running tick counts of each CPU: all ticks and the ticks not spent
+ * in the IDLE thread.  These are never scaled back, users take the
+ * difference between two samples.
+ */
+
+static struct cpuload_s g_cpuload_cpu[CONFIG_SMP_NCPUS];
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -101,6 +113,18 @@ volatile clock_t g_cpuload_total;
 
 void nxsched_process_taskload_ticks(FAR struct tcb_s *tcb, clock_t ticks)
 {
+#ifdef CONFIG_SMP
+  FAR struct cpuload_s *cpuload = &g_cpuload_cpu[tcb->cpu];
+#else
+  FAR struct cpuload_s *cpuload = &g_cpuload_cpu[0];
+#endif
+
+  cpuload->total += ticks;
+  if (!is_idle_task(tcb))
+    {
+      cpuload->active += ticks;
+    }
+
   tcb->ticks += ticks;
   g_cpuload_total += ticks;
 
@@ -159,6 +183,18 @@ void nxsched_process_cpuload_ticks(clock_t ticks)
     {
       FAR struct tcb_s *rtcb = current_task(i);
       nxsched_process_taskload_ticks(rtcb, ticks);
+
+#ifdef CONFIG_CPUFREQ_SCHEDUTIL_RTBOOST
+      /* A real-time user thread is running: do not wait for the next
+       * sample of the governor to raise the frequency.
+       */
+
+      if (rtcb->sched_priority >= CONFIG_CPUFREQ_SCHEDUTIL_RTPRIORITY &&
+          (rtcb->flags & TCB_FLAG_TTYPE_MASK) != TCB_FLAG_TTYPE_KERNEL)
+        {
+          cpufreq_boost(i);
+        }
+#endif
     }
 }
 
@@ -221,3 +257,39 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
   leave_critical_section(flags);
   return ret;
 }
+
+/****************************************************************************
+ * Name:  clock_cpuload_cpu
+ *
+ * Description:
+ *   Return the free running load counts of one CPU.  'total' counts all
+ *   ticks of the CPU and 'active' the ticks not spent in its IDLE thread.
+ *   The load over an interval is the ratio of the differences of two
+ *   samples.
+ *
+ * Input Parameters:
+ *   cpu     - The CPU of interest.
+ *   cpuload - The location to return the counts.
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if 'cpu' is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+int clock_cpuload_cpu(int cpu, FAR struct cpuload_s *cpuload)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(cpuload);
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  cpuload->total  = g_cpuload_cpu[cpu].total;
+  cpuload->active = g_cpuload_cpu[cpu].active;
+  leave_critical_section(flags);
+  return OK;
+}
@@ -68,6 +68,9 @@ int nxsched_select_cpu(cpu_set_t affinity)
   uint8_t minprio;
   int cpu;
   int i;
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+  int me = this_cpu();
+#endif
 
   minprio = SCHED_PRIORITY_MAX;
   cpu     = IMPOSSIBLE_CPU;
@@ -94,12 +97,25 @@ int nxsched_select_cpu(cpu_set_t affinity)
               DEBUGASSERT(rtcb->sched_priority == 0);
               return i;
             }
-          else if (rtcb->sched_priority <= minprio)
+
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+          /* On a tie, prefer this CPU so that no IPI is needed */
+
+          if (rtcb->sched_priority < minprio ||
+              (rtcb->sched_priority == minprio && i == me))
             {
               DEBUGASSERT(rtcb->sched_priority > 0);
               minprio = rtcb->sched_priority;
               cpu = i;
             }
+#else
+          if (rtcb->sched_priority <= minprio)
+            {
+              DEBUGASSERT(rtcb->sched_priority > 0);
+              minprio = rtcb->sched_priority;
+              cpu = i;
+            }
+#endif
         }
     }
 
@@ -107,4 +123,71 @@ int nxsched_select_cpu(cpu_set_t affinity)
   return cpu;
 }
 
+/****************************************************************************
+ * Name:  nxsched_steal_candidate
+ *
+ * Description:
+ *   Find the highest priority task that is waiting (not running) in the
+ *   run queue of some other CPU and that is permitted to run on 'cpu'.
+ *
+ * Input Parameters:
+ *   cpu - The CPU that would run the stolen task.
+ *
+ * Returned Value:
+ *   The TCB of the best task to steal or NULL if there is none.  The TCB
+ *   is not removed from its run queue.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+FAR struct tcb_s *nxsched_steal_candidate(int cpu)
+{
+  FAR struct tcb_s *best = NULL;
+  FAR struct tcb_s *rtrtcb;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (i == cpu)
+        {
+          continue;
+        }
+
+      /* Skip the task running at the head of the list.  If that is the
+       * IDLE task, nothing is waiting on this CPU.
+       */
+
+      rtrtcb = (FAR struct tcb_s *)list_assignedtasks(i)->head;
+      if (is_idle_task(rtrtcb))
+        {
+          continue;
+        }
+
+      /* The list is prioritized, so the first task with a matching
+       * affinity is the best candidate of this CPU.
+       */
+
+      for (rtrtcb = rtrtcb->flink; !is_idle_task(rtrtcb);
+           rtrtcb = rtrtcb->flink)
+        {
+          if (CPU_ISSET(cpu, &rtrtcb->affinity))
+            {
+              if (best == NULL ||
+                  rtrtcb->sched_priority > best->sched_priority)
+                {
+                  best = rtrtcb;
+                }
+
+              break;
+            }
+        }
+    }
+
+  return best;
+}
+#endif
+
 #endif /* CONFIG_SMP */
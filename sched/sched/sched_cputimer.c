@@ -0,0 +1,285 @@
+/****************************************************************************
+ * sched/sched/sched_cputimer.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/clock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_TICKLESS_PERCPU
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The time at which the time slice of the task running on each CPU was
+ * last charged.
+ */
+
+static clock_t g_cputimer_start[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_cputimer_slice
+ *
+ * Description:
+ *   Return the number of ticks left in the time slice of 'tcb', or zero if
+ *   its scheduling policy does not need the timer.
+ *
+ ****************************************************************************/
+
+static clock_t nxsched_cputimer_slice(FAR struct tcb_s *tcb)
+{
+#if CONFIG_RR_INTERVAL > 0
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_RR)
+    {
+      /* An expired slice is rotated on the next tick */
+
+      return tcb->timeslice > 0 ? tcb->timeslice : 1;
+    }
+#endif
+
+#ifdef CONFIG_SCHED_SPORADIC
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+    {
+      /* The low priority phase is ended by the replenishment timers */
+
+      return tcb->timeslice > 0 ? tcb->timeslice : 0;
+    }
+#endif
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: nxsched_cputimer_start
+ *
+ * Description:
+ *   Start the timer of this CPU for 'ticks', or stop it if 'ticks' is zero.
+ *
+ ****************************************************************************/
+
+static void nxsched_cputimer_start(clock_t ticks)
+{
+  int ret;
+
+  if (ticks > 0)
+    {
+      ret = up_cpu_timer_tick_start(ticks);
+    }
+  else
+    {
+      ret = up_cpu_timer_tick_cancel();
+    }
+
+  if (ret < 0)
+    {
+      serr("ERROR: up_cpu_timer_tick_start/cancel failed: %d\n", ret);
+      UNUSED(ret);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_cputimer_process
+ *
+ * Description:
+ *   Charge 'elapsed' ticks to the task running on this CPU, switch it out
+ *   if its time slice expired and restart the timer for the rest of it.
+ *
+ ****************************************************************************/
+
+static void nxsched_cputimer_process(bool noswitches)
+{
+  FAR struct tcb_s *rtcb;
+  irqstate_t flags;
+  clock_t elapsed;
+  clock_t slice = 0;
+  clock_t now;
+  int cpu;
+
+  flags   = enter_critical_section();
+  cpu     = this_cpu();
+  rtcb    = current_task(cpu);
+  now     = clock_systime_ticks();
+  elapsed = now - g_cputimer_start[cpu];
+
+  /* A context switch below charges the task with nothing more */
+
+  g_cputimer_start[cpu] = now;
+
+#if CONFIG_RR_INTERVAL > 0
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_RR)
+    {
+      slice = nxsched_process_roundrobin(rtcb, elapsed, noswitches);
+    }
+#endif
+
+#ifdef CONFIG_SCHED_SPORADIC
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+    {
+      if (elapsed > 0)
+        {
+          rtcb->sporadic->eventtime = now;
+          slice = nxsched_process_sporadic(rtcb, elapsed, noswitches);
+        }
+      else
+        {
+          slice = nxsched_cputimer_slice(rtcb);
+        }
+    }
+#endif
+
+  /* If the task was switched out, the timer was already restarted for the
+   * new one by nxsched_resume_scheduler().
+   */
+
+  if (rtcb == current_task(cpu))
+    {
+      nxsched_cputimer_start(slice);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_cputimer_suspend
+ *
+ * Description:
+ *   Called when 'tcb' is switched out of this CPU.  The time it ran since
+ *   its time slice was last charged is deducted from the slice.  The
+ *   expiration itself is left to the timer, this is called with context
+ *   switches in progress.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task being suspended.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_cputimer_suspend(FAR struct tcb_s *tcb)
+{
+  clock_t elapsed = clock_systime_ticks() - g_cputimer_start[this_cpu()];
+
+  if (nxsched_cputimer_slice(tcb) == 0 || tcb->timeslice <= 0)
+    {
+      return;
+    }
+
+  if (elapsed < (clock_t)tcb->timeslice)
+    {
+      tcb->timeslice -= elapsed;
+    }
+#if CONFIG_RR_INTERVAL > 0
+  else if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_RR)
+    {
+      tcb->timeslice = 0;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: nxsched_cputimer_resume
+ *
+ * Description:
+ *   Called when 'tcb' is switched in on this CPU.  The timer of the CPU is
+ *   started for the rest of its time slice, or stopped if the task has
+ *   none.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task being resumed.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_cputimer_resume(FAR struct tcb_s *tcb)
+{
+  g_cputimer_start[this_cpu()] = clock_systime_ticks();
+  nxsched_cputimer_start(nxsched_cputimer_slice(tcb));
+}
+
+/****************************************************************************
+ * Name: nxsched_cputimer_reassess
+ *
+ * Description:
+ *   Charge the time slice of the task running on this CPU and restart the
+ *   timer without switching context.  Used by sched_unlock() when the time
+ *   slice expired while pre-emption was disabled.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_cputimer_reassess(void)
+{
+  nxsched_cputimer_process(true);
+}
+
+/****************************************************************************
+ * Name: nxsched_cpu_timer_expiration
+ *
+ * Description:
+ *   Called from the interrupt handler of the private timer of this CPU
+ *   when the time slice of the running task expires.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_cpu_timer_expiration(void)
+{
+  nxsched_cputimer_process(false);
+}
+
+#endif /* CONFIG_SCHED_TICKLESS_PERCPU */
@@ -30,6 +30,7 @@
 #include <sched.h>
 #include <assert.h>
 #include <debug.h>
+#include <string.h>
 #include <time.h>
 
 #include "sched/sched.h"
@@ -86,6 +87,25 @@
 #  define CHECK_THREAD(pid, elapsed)
 #endif
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Start time and nesting level of the interrupt handling on each CPU */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_IRQTIME
+static clock_t g_critmon_irqstart[CONFIG_SMP_NCPUS];
+static uint8_t g_critmon_irqnest[CONFIG_SMP_NCPUS];
+#endif
+
+/* The shortest interval worth a place in the top tables, in units of the
+ * performance counter.  Computed on first use.
+ */
+
+#if CONFIG_SCHED_CRITMONITOR_TOPN > 0
+static clock_t g_critmon_threshold;
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -100,6 +120,16 @@ clock_t g_premp_max[CONFIG_SMP_NCPUS];
 clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif
 
+#if CONFIG_SCHED_CRITMONITOR_TOPN > 0
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
+struct critmon_top_s g_premp_top[CONFIG_SCHED_CRITMONITOR_TOPN];
+#  endif
+
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
+struct critmon_top_s g_crit_top[CONFIG_SCHED_CRITMONITOR_TOPN];
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -153,10 +183,180 @@ static void nxsched_critmon_cpuload(FAR struct tcb_s *tcb, clock_t current,
 }
 #endif
 
+/****************************************************************************
+ * Name: nxsched_critmon_runend
+ *
+ * Description:
+ *   Return the end of the current run of the thread: 'current', or the
+ *   start of the interrupt handling in progress on its CPU.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+static clock_t nxsched_critmon_runend(FAR struct tcb_s *tcb,
+                                      clock_t current)
+{
+#ifdef CONFIG_SCHED_CRITMONITOR_IRQTIME
+  int cpu = tcb->cpu;
+
+  if (g_critmon_irqnest[cpu] > 0 &&
+      (sclock_t)(g_critmon_irqstart[cpu] - tcb->run_start) > 0)
+    {
+      return g_critmon_irqstart[cpu];
+    }
+#endif
+
+  return current;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsched_critmon_top
+ *
+ * Description:
+ *   Record an interval that ended if it is one of the longest.  The cost
+ *   is a comparison for an interval under the threshold.
+ *
+ * Input Parameters:
+ *   top     - The table of the longest intervals
+ *   tcb     - The thread that ended the interval
+ *   elapsed - The duration
+ *   entry   - Caller that started the interval
+ *   exit    - Caller that ended the interval
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_TOPN > 0
+static void nxsched_critmon_top(FAR struct critmon_top_s *top,
+                                FAR struct tcb_s *tcb, clock_t elapsed,
+                                FAR void *entry, FAR void *exit)
+{
+  FAR struct critmon_top_s *min;
+  int i;
+
+  if (g_critmon_threshold == 0)
+    {
+      g_critmon_threshold = (clock_t)((uint64_t)perf_getfreq() *
+                            CONFIG_SCHED_CRITMONITOR_TOPN_THRESHOLD /
+                            USEC_PER_SEC) + 1;
+    }
+
+  if (elapsed < g_critmon_threshold)
+    {
+      return;
+    }
+
+  /* Replace the shortest entry if this interval is longer */
+
+  for (min = top, i = 1; i < CONFIG_SCHED_CRITMONITOR_TOPN; i++)
+    {
+      if (top[i].elapsed < min->elapsed)
+        {
+          min = &top[i];
+        }
+    }
+
+  if (elapsed <= min->elapsed)
+    {
+      return;
+    }
+
+  min->elapsed = elapsed;
+  min->pid     = tcb->pid;
+  min->cpu     = this_cpu();
+  min->entry   = entry;
+  min->exit    = exit;
+
+#if CONFIG_SCHED_CRITMONITOR_TOPN_BACKTRACE > 0
+  memset(min->backtrace, 0, sizeof(min->backtrace));
+  up_backtrace(tcb, min->backtrace,
+               CONFIG_SCHED_CRITMONITOR_TOPN_BACKTRACE, 0);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxsched_critmon_irq
+ *
+ * Description:
+ *   Called on the entry and on the exit of the interrupt handling, which is
+ *   not charged to the thread running on the CPU.  Only the outermost of
+ *   nested interrupts is timed.
+ *
+ * Input Parameters:
+ *   state - true on the entry, false on the exit.
+ *
+ * Assumptions:
+ *   - Called from an interrupt handler
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_IRQTIME
+void nxsched_critmon_irq(bool state)
+{
+  clock_t current = perf_gettime();
+  FAR struct tcb_s *tcb;
+  int cpu = this_cpu();
+
+  if (state)
+    {
+      if (g_critmon_irqnest[cpu]++ == 0)
+        {
+          g_critmon_irqstart[cpu] = current;
+        }
+    }
+  else if (--g_critmon_irqnest[cpu] == 0)
+    {
+      /* Move the start of the run past the interrupt handling.  A thread
+       * switched in by the handler only started to run now.
+       */
+
+      tcb = current_task(cpu);
+      if ((sclock_t)(tcb->run_start - g_critmon_irqstart[cpu]) > 0)
+        {
+          tcb->run_start = current;
+        }
+      else
+        {
+          tcb->run_start += current - g_critmon_irqstart[cpu];
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsched_get_runtime
+ *
+ * Description:
+ *   Return the time that a thread has run, including the time since it was
+ *   last switched in if it is running now.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+clock_t nxsched_get_runtime(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+  clock_t runtime;
+
+  flags   = up_irq_save();
+  runtime = tcb->run_time;
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      runtime += nxsched_critmon_runend(tcb, perf_gettime()) -
+                 tcb->run_start;
+    }
+
+  up_irq_restore(flags);
+  return runtime;
+}
+#endif
+
 /****************************************************************************
  * Name: nxsched_critmon_preemption
  *
@@ -205,6 +405,11 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
         {
           g_premp_max[cpu] = elapsed;
         }
+
+#if CONFIG_SCHED_CRITMONITOR_TOPN > 0
+      nxsched_critmon_top(g_premp_top, tcb, elapsed, tcb->premp_caller,
+                          caller);
+#endif
     }
 }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0 */
@@ -257,6 +462,11 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
         {
           g_crit_max[cpu] = elapsed;
         }
+
+#if CONFIG_SCHED_CRITMONITOR_TOPN > 0
+      nxsched_critmon_top(g_crit_top, tcb, elapsed, tcb->crit_caller,
+                          caller);
+#endif
     }
 }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
@@ -323,9 +533,15 @@ void nxsched_resume_critmon(FAR struct tcb_s *tcb)
 void nxsched_suspend_critmon(FAR struct tcb_s *tcb)
 {
   clock_t current = perf_gettime();
-  clock_t elapsed = current - tcb->run_start;
+  clock_t elapsed;
   int cpu = this_cpu();
 
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+  elapsed = nxsched_critmon_runend(tcb, current) - tcb->run_start;
+#else
+  elapsed = current - tcb->run_start;
+#endif
+
 #ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
   clock_t tick = elapsed * CLOCKS_PER_SEC / perf_getfreq();
   nxsched_critmon_cpuload(tcb, current, tick);
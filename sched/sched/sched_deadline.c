@@ -0,0 +1,332 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/arch.h>
+#include <nuttx/wdog.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bandwidths are fixed point fractions of one CPU */
+
+#define DEADLINE_BW_SHIFT 20
+#define DEADLINE_BW_MAX \
+  ((((uint64_t)CONFIG_SCHED_DEADLINE_MAXUTIL * CONFIG_SMP_NCPUS) << \
+    DEADLINE_BW_SHIFT) / 100)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Sum of the bandwidths reserved by all deadline tasks */
+
+static uint64_t g_deadline_bw;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_budget_expire
+ *
+ * Description:
+ *   Handles the exhaustion of the budget of a running deadline task.  As
+ *   a constant bandwidth server, the task gets a new budget with its
+ *   deadline postponed by one period, and gives the CPU to any task of the
+ *   same priority with an earlier deadline.
+ *
+ * Input Parameters:
+ *   arg - The TCB of the deadline task.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the watchdog timer handler with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void deadline_budget_expire(wdparm_t arg)
+{
+  FAR struct tcb_s *tcb = (FAR struct tcb_s *)arg;
+  FAR struct deadline_s *deadline;
+  irqstate_t flags;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+
+  flags = enter_critical_section();
+
+  deadline->absdeadline += deadline->period;
+  deadline->budget       = deadline->runtime;
+  deadline->eventtime    = clock_systime_ticks();
+
+  wd_start(&deadline->timer, deadline->budget,
+           deadline_budget_expire, (wdparm_t)tcb);
+
+  /* Re-queue the task behind the earlier deadlines.  That would be a
+   * context switch, so it waits for the next event while the task has
+   * pre-emption disabled.
+   */
+
+  if (!nxsched_islocked_tcb(tcb))
+    {
+      nxsched_set_priority(tcb, tcb->sched_priority);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_start_deadline
+ *
+ * Description:
+ *   Set or change the constant bandwidth server of a task.  The server is
+ *   admitted only if the total bandwidth of the deadline tasks stays
+ *   within CONFIG_SCHED_DEADLINE_MAXUTIL percent of the CPUs.
+ *
+ * Input Parameters:
+ *   tcb      - The TCB of the task.
+ *   runtime  - The budget per period in clock ticks.
+ *   deadline - The relative deadline in clock ticks.
+ *   period   - The period in clock ticks.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure:
+ *   EINVAL if runtime <= deadline <= period does not hold, EBUSY if the
+ *   server cannot be admitted or ENOMEM.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+int nxsched_start_deadline(FAR struct tcb_s *tcb, clock_t runtime,
+                           clock_t deadline, clock_t period)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+  uint64_t oldbw = dl != NULL ? dl->bw : 0;
+  uint64_t bw;
+
+  if (runtime < 1 || runtime > deadline || deadline > period)
+    {
+      return -EINVAL;
+    }
+
+  bw = ((uint64_t)runtime << DEADLINE_BW_SHIFT) / period;
+  if (bw == 0)
+    {
+      bw = 1;
+    }
+
+  if (g_deadline_bw - oldbw + bw > DEADLINE_BW_MAX)
+    {
+      return -EBUSY;
+    }
+
+  if (dl == NULL)
+    {
+      dl = kmm_zalloc(sizeof(struct deadline_s));
+      if (dl == NULL)
+        {
+          serr("ERROR: Failed to allocate deadline data structure\n");
+          return -ENOMEM;
+        }
+
+      tcb->deadline = dl;
+    }
+  else
+    {
+      wd_cancel(&dl->timer);
+    }
+
+  g_deadline_bw  += bw - oldbw;
+
+  dl->runtime     = runtime;
+  dl->deadline    = deadline;
+  dl->period      = period;
+  dl->bw          = bw;
+  dl->eventtime   = clock_systime_ticks();
+  dl->absdeadline = dl->eventtime + deadline;
+  dl->budget      = runtime;
+
+  /* A running task starts consuming the budget now */
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      wd_start(&dl->timer, dl->budget,
+               deadline_budget_expire, (wdparm_t)tcb);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_stop_deadline
+ *
+ * Description:
+ *   Release the constant bandwidth server of a task that leaves the
+ *   deadline policy or exits.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxsched_stop_deadline(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(tcb && tcb->deadline);
+
+  flags = enter_critical_section();
+  wd_cancel(&tcb->deadline->timer);
+  g_deadline_bw -= tcb->deadline->bw;
+  leave_critical_section(flags);
+
+  kmm_free(tcb->deadline);
+  tcb->deadline = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_wakeup_deadline
+ *
+ * Description:
+ *   Called when a deadline task is made ready-to-run, before it is queued.
+ *   The constant bandwidth server keeps the current deadline only if the
+ *   budget left can be consumed before it without exceeding the reserved
+ *   bandwidth; otherwise a new deadline is set relative to now with a full
+ *   budget.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *deadline = tcb->deadline;
+  clock_t now = clock_systime_ticks();
+  sclock_t left;
+
+  DEBUGASSERT(deadline != NULL);
+
+  left = (sclock_t)(deadline->absdeadline - now);
+  if (left <= 0 ||
+      (uint64_t)deadline->budget * deadline->period >
+      (uint64_t)left * deadline->runtime)
+    {
+      deadline->absdeadline = now + deadline->deadline;
+      deadline->budget      = deadline->runtime;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_resume_deadline
+ *
+ * Description:
+ *   Called when a deadline task is switched in.  The budget exhaustion
+ *   timer runs while the task runs.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_resume_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *deadline = tcb->deadline;
+
+  DEBUGASSERT(deadline != NULL);
+
+  deadline->eventtime = clock_systime_ticks();
+  wd_start(&deadline->timer, deadline->budget > 0 ? deadline->budget : 1,
+           deadline_budget_expire, (wdparm_t)tcb);
+}
+
+/****************************************************************************
+ * Name: nxsched_suspend_deadline
+ *
+ * Description:
+ *   Called when a deadline task is switched out.  The time it ran is
+ *   charged to its budget.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *deadline = tcb->deadline;
+  clock_t elapsed;
+
+  DEBUGASSERT(deadline != NULL);
+
+  wd_cancel(&deadline->timer);
+
+  elapsed = clock_systime_ticks() - deadline->eventtime;
+  deadline->budget = elapsed < deadline->budget ?
+                     deadline->budget - elapsed : 0;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
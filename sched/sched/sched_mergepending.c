@@ -106,8 +106,12 @@ bool nxsched_merge_pending(void)
            * order.
            */
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+          rtcb = nxsched_rtr_search(ptcb);
+#endif
+
           for (;
-               (rtcb && ptcb->sched_priority <= rtcb->sched_priority);
+               (rtcb && !nxsched_tcb_before(ptcb, rtcb));
                rtcb = rtcb->flink)
             {
             }
@@ -147,6 +151,8 @@ bool nxsched_merge_pending(void)
               ptcb->task_state  = TSTATE_TASK_READYTORUN;
             }
 
+          nxsched_rtr_add(ptcb);
+
           /* Set up for the next time through */
 
           rtcb = ptcb;
@@ -223,7 +229,7 @@ bool nxsched_merge_pending(void)
        * end up in the g_readytorun list.
        */
 
-      while (ptcb->sched_priority > rtcb->sched_priority)
+      while (nxsched_tcb_before(ptcb, rtcb))
         {
           /* Remove the task from the pending task list */
 
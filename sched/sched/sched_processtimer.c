@@ -37,6 +37,15 @@
 #  include <nuttx/board.h>
 #endif
 
+#if defined(CONFIG_PERF_SAMPLE) && !defined(CONFIG_PERF_SAMPLE_PMU)
+#  include <nuttx/irq.h>
+#  include <nuttx/perf_sample.h>
+#endif
+
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+#  include <nuttx/fs/procfs.h>
+#endif
+
 #include "sched/sched.h"
 #include "wdog/wdog.h"
 #include "clock/clock.h"
@@ -140,6 +149,39 @@ static inline void nxsched_process_scheduler(void)
 #  define nxsched_process_scheduler()
 #endif
 
+/****************************************************************************
+ * Name: nxsched_cpu_stalled
+ *
+ * Description:
+ *   Return true if tasks are ready to run but none of the CPUs runs them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+static inline bool nxsched_cpu_stalled(void)
+{
+#ifdef CONFIG_SMP
+  /* g_readytorun only holds the tasks that are not running */
+
+  if (!dq_empty(list_readytorun()))
+    {
+      return true;
+    }
+#else
+  FAR struct tcb_s *next = this_task()->flink;
+
+  /* The idle task is the last task of g_readytorun */
+
+  if (next != NULL && next->flink != NULL)
+    {
+      return true;
+    }
+#endif
+
+  return !dq_empty(list_pendingtasks());
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -190,6 +232,20 @@ void nxsched_process_timer(void)
   nxsched_process_cpuload();
 #endif
 
+#ifdef CONFIG_FS_PROCFS_PRESSURE_STALL
+  /* Account the CPU pressure and update the averages of all pressures */
+
+  pressure_stall_tick(nxsched_cpu_stalled());
+#endif
+
+#if defined(CONFIG_PERF_SAMPLE) && !defined(CONFIG_PERF_SAMPLE_PMU)
+  /* Without a performance counter interrupt, the profiler samples the
+   * thread interrupted by the timer.
+   */
+
+  perf_sample(up_current_regs());
+#endif
+
   /* Check if the currently executing task has exceeded its
    * timeslice.
    */
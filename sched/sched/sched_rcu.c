@@ -0,0 +1,257 @@
+/****************************************************************************
+ * sched/sched/sched_rcu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/rcu.h>
+#include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The grace period sleeps, keep it off the high priority work queue */
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define RCU_WORK LPWORK
+#else
+#  define RCU_WORK HPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The callbacks queued on one CPU, waiting for the next grace period */
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+struct rcu_batch_s
+{
+  spinlock_t lock;
+  FAR struct rcu_head *head;
+  struct work_s work;
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+static struct rcu_batch_s g_rcu_batch[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_reading
+ *
+ * Description:
+ *   Return true if the thread pid is still in the read-side critical
+ *   section numbered seq.
+ *
+ ****************************************************************************/
+
+static bool rcu_reading(pid_t pid, uint32_t seq)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  bool reading;
+
+  flags   = enter_critical_section();
+  tcb     = nxsched_get_tcb(pid);
+  reading = tcb != NULL && tcb->rcu_nesting > 0 && tcb->rcu_seq == seq;
+  leave_critical_section(flags);
+
+  return reading;
+}
+
+/****************************************************************************
+ * Name: rcu_worker
+ *
+ * Description:
+ *   Run the callbacks queued on one CPU after a grace period.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+static void rcu_worker(FAR void *arg)
+{
+  FAR struct rcu_batch_s *batch = arg;
+  FAR struct rcu_head *head;
+  FAR struct rcu_head *next;
+  irqstate_t flags;
+
+  flags       = spin_lock_irqsave(&batch->lock);
+  head        = batch->head;
+  batch->head = NULL;
+  spin_unlock_irqrestore(&batch->lock, flags);
+
+  synchronize_rcu();
+
+  for (; head != NULL; head = next)
+    {
+      next = head->next;
+      head->func(head);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_read_lock
+ *
+ * Description:
+ *   Enter a read-side critical section.  The sections are counted in the
+ *   TCB of the running thread, so a reader may block or migrate.  An
+ *   interrupt handler counts in the TCB of the thread it interrupted and
+ *   is done before that thread runs again.
+ *
+ ****************************************************************************/
+
+void rcu_read_lock(void)
+{
+  FAR struct tcb_s *rtcb = this_task();
+
+  if (rtcb->rcu_nesting++ == 0)
+    {
+      rtcb->rcu_seq++;
+    }
+
+  /* Order the count before the reads of the protected data */
+
+  atomic_thread_fence(memory_order_seq_cst);
+}
+
+/****************************************************************************
+ * Name: rcu_read_unlock
+ ****************************************************************************/
+
+void rcu_read_unlock(void)
+{
+  FAR struct tcb_s *rtcb = this_task();
+
+  DEBUGASSERT(rtcb->rcu_nesting > 0);
+
+  atomic_thread_fence(memory_order_release);
+  rtcb->rcu_nesting--;
+}
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait for the read-side critical sections in progress.  Every thread
+ *   found inside one is polled once a tick until it has left that section
+ *   or has exited.  Sections entered after the call are not waited for,
+ *   they cannot see what was unlinked before it.
+ *
+ ****************************************************************************/
+
+void synchronize_rcu(void)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  uint32_t seq;
+  pid_t pid;
+  int i;
+
+  DEBUGASSERT(!up_interrupt_context() && this_task()->rcu_nesting == 0);
+
+  /* Order the unlinking before the checks of the readers */
+
+  atomic_thread_fence(memory_order_seq_cst);
+
+  for (i = 0; i < g_npidhash; i++)
+    {
+      flags = enter_critical_section();
+
+      tcb = i < g_npidhash ? g_pidhash[i] : NULL;
+      if (tcb == NULL || tcb->rcu_nesting == 0)
+        {
+          leave_critical_section(flags);
+          continue;
+        }
+
+      pid = tcb->pid;
+      seq = tcb->rcu_seq;
+      leave_critical_section(flags);
+
+      while (rcu_reading(pid, seq))
+        {
+          nxsig_usleep(USEC_PER_TICK);
+        }
+    }
+
+  atomic_thread_fence(memory_order_seq_cst);
+}
+
+/****************************************************************************
+ * Name: call_rcu
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+void call_rcu(FAR struct rcu_head *head, rcu_callback_t func)
+{
+  FAR struct rcu_batch_s *batch;
+  irqstate_t flags;
+  bool first;
+
+  head->func = func;
+
+  flags = up_irq_save();
+  batch = &g_rcu_batch[this_cpu()];
+
+  spin_lock(&batch->lock);
+  head->next  = batch->head;
+  first       = batch->head == NULL;
+  batch->head = head;
+  spin_unlock(&batch->lock);
+
+  /* The first callback of a batch schedules the grace period of all */
+
+  if (first)
+    {
+      work_queue(RCU_WORK, &batch->work, rcu_worker, batch, 0);
+    }
+
+  up_irq_restore(flags);
+}
+#endif
@@ -36,6 +36,7 @@
 #include "task/task.h"
 #include "sched/sched.h"
 #include "group/group.h"
+#include "pthread/pthread.h"
 #include "timer/timer.h"
 
 /****************************************************************************
@@ -103,10 +104,15 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 #ifndef CONFIG_DISABLE_PTHREAD
   FAR struct task_tcb_s *ttcb;
 #endif
+  bool keep;
   int ret = OK;
 
   if (tcb)
     {
+      /* A pthread TCB may be kept for reuse together with its stack */
+
+      keep = PTHREAD_TCBCACHE_KEEP(tcb, ttype);
+
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
       /* Release any timers that the task might hold.  We do this
        * before release the PID because it may still be trying to
@@ -130,7 +136,7 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       /* Delete the thread's stack if one has been allocated */
 
-      if (tcb->stack_alloc_ptr)
+      if (tcb->stack_alloc_ptr && !keep)
         {
           up_release_stack(tcb, ttype);
         }
@@ -196,7 +202,16 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       if (tcb->flags & TCB_FLAG_FREE_TCB)
         {
-          kmm_free(tcb);
+#if defined(CONFIG_PTHREAD_TCBCACHE) && CONFIG_PTHREAD_TCBCACHE > 0
+          if (keep)
+            {
+              pthread_tcbcache_put(tcb);
+            }
+          else
+#endif
+            {
+              kmm_free(tcb);
+            }
         }
     }
 
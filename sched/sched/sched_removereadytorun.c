@@ -93,6 +93,7 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb, bool merge)
    * is always the g_readytorun list.
    */
 
+  nxsched_rtr_remove(rtcb);
   dq_rem((FAR dq_entry_t *)rtcb, tasklist);
 
   /* Since the TCB is not in any list, it is now invalid */
@@ -186,6 +187,22 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
 
   dq_rem_head((FAR dq_entry_t *)tcb, tasklist);
 
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+  /* Steal the highest priority task waiting in the run queue of another
+   * CPU if it has a higher priority than the next task of this CPU.  The
+   * stolen task is not running, so its CPU does not have to be paused.
+   */
+
+  rtrtcb = nxsched_steal_candidate(cpu);
+  if (rtrtcb != NULL && rtrtcb->sched_priority > nxttcb->sched_priority)
+    {
+      dq_rem_mid(rtrtcb);
+      dq_addfirst_nonempty((FAR dq_entry_t *)rtrtcb, tasklist);
+
+      rtrtcb->cpu = cpu;
+      nxttcb = rtrtcb;
+    }
+#else
   /* Find the highest priority non-running tasks in the g_assignedtasks
    * list of other CPUs, and also non-idle tasks, place them in the
    * g_readytorun list. so as to find the task with the highest priority,
@@ -226,6 +243,7 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
             }
         }
     }
+#endif
 
   /* Which task will go at the head of the list?  It will be either the
    * next tcb in the assigned task list (nxttcb) or a TCB in the
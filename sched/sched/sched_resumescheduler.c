@@ -68,6 +68,21 @@ void nxsched_resume_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Start consuming the budget */
+
+      nxsched_resume_deadline(tcb);
+    }
+#endif
+
+#ifdef CONFIG_SCHED_TICKLESS_PERCPU
+  /* Start the time slice of the task on this CPU */
+
+  nxsched_cputimer_resume(tcb);
+#endif
+
   /* Indicate the task has been resumed */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
@@ -0,0 +1,248 @@
+/****************************************************************************
+ * sched/sched/sched_rtrbitmap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <sched.h>
+#include <assert.h>
+
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RTR_NPRIORITIES (SCHED_PRIORITY_MAX + 1)
+#define RTR_NWORDS      ((RTR_NPRIORITIES + 31) / 32)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* One bit for each priority that has at least one task in g_readytorun */
+
+static uint32_t g_rtrmap[RTR_NWORDS];
+
+/* The last task of each priority in g_readytorun, i.e. the task behind
+ * which a new task of the same priority is queued.
+ */
+
+static FAR struct tcb_s *g_rtrlast[RTR_NPRIORITIES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_rtr_higher
+ *
+ * Description:
+ *   Return the lowest priority above 'priority' that has tasks in the
+ *   ready-to-run list, or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int nxsched_rtr_higher(int priority)
+{
+  uint32_t bits;
+  int word = priority >> 5;
+
+  /* Ignore 'priority' and the priorities below it in the first word */
+
+  bits = g_rtrmap[word] & ~((2u << (priority & 31)) - 1);
+
+  while (bits == 0)
+    {
+      if (++word >= RTR_NWORDS)
+        {
+          return -1;
+        }
+
+      bits = g_rtrmap[word];
+    }
+
+  return (word << 5) + ffs(bits) - 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_rtr_search
+ *
+ * Description:
+ *   Return the task of the ready-to-run list from which the search for the
+ *   position of 'tcb' starts.  Tasks with a higher priority are skipped
+ *   without visiting them and, unless 'tcb' is ordered by deadline, so are
+ *   the tasks of the same priority.  The search then ends at the first
+ *   task visited.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task to be queued.
+ *
+ * Returned Value:
+ *   The first task to compare 'tcb' with, or NULL if 'tcb' goes at the end
+ *   of the list.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_rtr_search(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *prev;
+  int priority = tcb->sched_priority;
+
+  prev = g_rtrlast[priority];
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if (prev != NULL &&
+      (tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      prev = NULL;
+    }
+#endif
+
+  if (prev == NULL)
+    {
+      priority = nxsched_rtr_higher(priority);
+      if (priority < 0)
+        {
+          return (FAR struct tcb_s *)list_readytorun()->head;
+        }
+
+      prev = g_rtrlast[priority];
+    }
+
+  return prev->flink;
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_add
+ *
+ * Description:
+ *   Account for 'tcb' that was just linked into the ready-to-run list.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task added to the list.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_rtr_add(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *next = tcb->flink;
+  int priority = tcb->sched_priority;
+
+  if (next == NULL || next->sched_priority != priority)
+    {
+      g_rtrlast[priority] = tcb;
+      g_rtrmap[priority >> 5] |= 1u << (priority & 31);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_remove
+ *
+ * Description:
+ *   Account for 'tcb' that is about to be unlinked from the ready-to-run
+ *   list.  Nothing is done if the task is not in the list.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task removed from the list.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_rtr_remove(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *prev = tcb->blink;
+  int priority = tcb->sched_priority;
+
+  if (g_rtrlast[priority] != tcb)
+    {
+      return;
+    }
+
+  if (prev != NULL && prev->sched_priority == priority)
+    {
+      g_rtrlast[priority] = prev;
+    }
+  else
+    {
+      g_rtrlast[priority] = NULL;
+      g_rtrmap[priority >> 5] &= ~(1u << (priority & 31));
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_setpriority
+ *
+ * Description:
+ *   Change the priority of a task of the ready-to-run list without moving
+ *   it.  The caller guarantees that the list stays ordered.
+ *
+ * Input Parameters:
+ *   tcb      - The TCB of the task.
+ *   priority - The new priority of the task.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_rtr_setpriority(FAR struct tcb_s *tcb, int priority)
+{
+  DEBUGASSERT(priority >= SCHED_PRIORITY_MIN &&
+              priority <= SCHED_PRIORITY_MAX);
+
+  nxsched_rtr_remove(tcb);
+  tcb->sched_priority = (uint8_t)priority;
+  nxsched_rtr_add(tcb);
+}
+
+#endif /* CONFIG_SCHED_READYTORUN_BITMAP */
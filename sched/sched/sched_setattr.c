@@ -0,0 +1,175 @@
+/****************************************************************************
+ * sched/sched/sched_setattr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sched.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_set_deadline
+ *
+ * Description:
+ *   Make the task identified by pid a deadline task with the runtime,
+ *   deadline and period of 'attr'.
+ *
+ ****************************************************************************/
+
+static int nxsched_set_deadline(pid_t pid, FAR const struct sched_attr *attr)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  uint64_t period;
+  int ret;
+
+  period = attr->sched_period != 0 ? attr->sched_period :
+                                     attr->sched_deadline;
+
+  if (pid == 0)
+    {
+      pid = nxsched_gettid();
+    }
+
+  tcb = nxsched_get_tcb(pid);
+  if (tcb == NULL)
+    {
+      return -ESRCH;
+    }
+
+  sched_lock();
+  flags = enter_critical_section();
+
+  /* Admit the server first, so that a failure leaves the task as it was */
+
+  ret = nxsched_start_deadline(tcb, NSEC2TICK(attr->sched_runtime),
+                               NSEC2TICK(attr->sched_deadline),
+                               NSEC2TICK(period));
+  if (ret < 0)
+    {
+      leave_critical_section(flags);
+      sched_unlock();
+      return ret;
+    }
+
+#ifdef CONFIG_SCHED_SPORADIC
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+    {
+      DEBUGVERIFY(nxsched_stop_sporadic(tcb));
+    }
+#endif
+
+  tcb->flags &= ~TCB_FLAG_POLICY_MASK;
+  tcb->flags |= TCB_FLAG_SCHED_DEADLINE;
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+  tcb->timeslice = 0;
+#endif
+
+  leave_critical_section(flags);
+
+  /* Re-queue the task at the deadline priority and at the position of its
+   * new deadline.
+   */
+
+  ret = nxsched_reprioritize(tcb, CONFIG_SCHED_DEADLINE_PRIORITY);
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_setattr
+ *
+ * Description:
+ *   sched_setattr() sets the scheduling policy and attributes of the task
+ *   identified by pid, or of the calling task if pid is zero.  Besides the
+ *   policies of sched_setscheduler(), it selects SCHED_DEADLINE with the
+ *   sched_runtime, sched_deadline and sched_period fields, all in
+ *   nanoseconds.  A zero sched_period is the same as sched_deadline.
+ *
+ * Input Parameters:
+ *   pid   - The task ID of the task to modify, or zero.
+ *   attr  - The new scheduling attributes.
+ *   flags - Must be zero.
+ *
+ * Returned Value:
+ *   On success, sched_setattr() returns OK (zero).  On error, ERROR (-1)
+ *   is returned, and errno is set appropriately:
+ *
+ *   EINVAL The attributes are not valid.
+ *   EBUSY  The deadline bandwidth cannot be admitted.
+ *   ESRCH  The task whose ID is pid could not be found.
+ *
+ ****************************************************************************/
+
+int sched_setattr(pid_t pid, FAR const struct sched_attr *attr,
+                  unsigned int flags)
+{
+  struct sched_param param;
+  int ret;
+
+  if (attr == NULL || flags != 0 || attr->sched_flags != 0)
+    {
+      ret = -EINVAL;
+    }
+  else if (attr->sched_policy == SCHED_DEADLINE)
+    {
+      ret = nxsched_set_deadline(pid, attr);
+    }
+  else
+    {
+      memset(&param, 0, sizeof(param));
+      param.sched_priority = attr->sched_priority;
+      ret = nxsched_set_scheduler(pid, attr->sched_policy, &param);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
@@ -78,19 +78,32 @@ static FAR struct tcb_s *nxsched_nexttcb(FAR struct tcb_s *tcb)
            rtrtcb != NULL && !CPU_ISSET(tcb->cpu, &rtrtcb->affinity);
            rtrtcb = rtrtcb->flink);
 
-      /* Return the TCB from the readyt-to-run list if it is the next
+      /* Use the TCB from the readyt-to-run list if it is the next
        * highest priority task.
        */
 
       if (rtrtcb != NULL &&
           rtrtcb->sched_priority >= nxttcb->sched_priority)
         {
-          return rtrtcb;
+          nxttcb = rtrtcb;
         }
+
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+      /* A higher priority task may also be waiting in the run queue of
+       * another CPU.  nxsched_remove_running() would steal it.
+       */
+
+      rtrtcb = nxsched_steal_candidate(tcb->cpu);
+      if (rtrtcb != NULL &&
+          rtrtcb->sched_priority > nxttcb->sched_priority)
+        {
+          nxttcb = rtrtcb;
+        }
+#endif
     }
 
-  /* Otherwise, return the next TCB in the g_assignedtasks[] list...
-   * probably the TCB of the IDLE thread.
+  /* Otherwise, nxttcb is still the next TCB in the g_assignedtasks[]
+   * list... probably the TCB of the IDLE thread.
    * REVISIT:  What if it is not the IDLE thread?
    */
 
@@ -169,7 +182,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
           /* Change the task priority */
 
-          tcb->sched_priority = (uint8_t)sched_priority;
+          nxsched_rtr_setpriority(tcb, sched_priority);
         }
       else
         {
@@ -188,7 +201,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
     {
       /* Change the task priority */
 
-      tcb->sched_priority = (uint8_t)sched_priority;
+      nxsched_rtr_setpriority(tcb, sched_priority);
     }
 }
 
@@ -61,6 +61,12 @@
 
 void nxsched_suspend_scheduler(FAR struct tcb_s *tcb)
 {
+#ifdef CONFIG_SCHED_TICKLESS_PERCPU
+  /* Charge the time that the task ran on this CPU to its time slice */
+
+  nxsched_cputimer_suspend(tcb);
+#endif
+
 #ifdef CONFIG_SCHED_SPORADIC
   /* Perform sporadic schedule operations */
 
@@ -70,6 +76,15 @@ void nxsched_suspend_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Charge the budget of a deadline task */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      nxsched_suspend_deadline(tcb);
+    }
+#endif
+
   /* Indicate that the task has been suspended */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
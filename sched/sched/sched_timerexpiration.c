@@ -47,6 +47,19 @@
 
 #ifdef CONFIG_SCHED_TICKLESS
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Time slices expire with the system timer, unless every CPU has its own
+ * timer for them (see sched_cputimer.c).
+ */
+
+#if (CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)) && \
+    !defined(CONFIG_SCHED_TICKLESS_PERCPU)
+#  define SCHED_TIMER_TIMESLICE 1
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -72,11 +85,11 @@ uint32_t g_oneshot_maxticks = UINT32_MAX;
  * Private Function Prototypes
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#ifdef SCHED_TIMER_TIMESLICE
 static clock_t nxsched_cpu_scheduler(int cpu, clock_t ticks,
                                      clock_t elapsed, bool noswitches);
 #endif
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#ifdef SCHED_TIMER_TIMESLICE
 static clock_t nxsched_process_scheduler(clock_t ticks, clock_t elapsed,
                                          bool noswitches);
 #endif
@@ -178,7 +191,7 @@ int up_timer_tick_cancel(FAR clock_t *ticks)
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#ifdef SCHED_TIMER_TIMESLICE
 static clock_t nxsched_cpu_scheduler(int cpu, clock_t ticks,
                                      clock_t elapsed, bool noswitches)
 {
@@ -271,7 +284,7 @@ static clock_t nxsched_cpu_scheduler(int cpu, clock_t ticks,
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#ifdef SCHED_TIMER_TIMESLICE
 static clock_t nxsched_process_scheduler(clock_t ticks, clock_t elapsed,
                                          bool noswitches)
 {
@@ -361,7 +374,7 @@ static clock_t nxsched_timer_process(clock_t ticks, clock_t elapsed,
 
   tmp = nxsched_process_scheduler(ticks, elapsed, noswitches);
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#ifdef SCHED_TIMER_TIMESLICE
   if (tmp > 0 && (rettime == 0 || tmp < rettime))
     {
       rettime = tmp;
@@ -171,7 +171,7 @@ int sched_unlock(void)
 #ifdef CONFIG_SCHED_TICKLESS
               else
                 {
-                  nxsched_reassess_timer();
+                  nxsched_reassess_timeslice();
                 }
 #endif
             }
@@ -204,7 +204,7 @@ int sched_unlock(void)
 
               if (rtcb == current_task(cpu))
                 {
-                  nxsched_reassess_timer();
+                  nxsched_reassess_timeslice();
                 }
 #endif
             }
@@ -305,7 +305,7 @@ int sched_unlock(void)
 #ifdef CONFIG_SCHED_TICKLESS
               else
                 {
-                  nxsched_reassess_timer();
+                  nxsched_reassess_timeslice();
                 }
 #endif
             }
@@ -338,7 +338,7 @@ int sched_unlock(void)
 
               if (rtcb == this_task())
                 {
-                  nxsched_reassess_timer();
+                  nxsched_reassess_timeslice();
                 }
 #endif
             }
@@ -35,6 +35,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/wdog.h>
 
 #include "sched/sched.h"
@@ -94,7 +95,11 @@ int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
 {
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
+#ifdef CONFIG_HRTIMER
+  uint64_t expired;
+#else
   sclock_t ticks;
+#endif
   int ret = ERROR;
 
   DEBUGASSERT(sem != NULL && abstime != NULL);
@@ -132,6 +137,27 @@ int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
     }
 #endif
 
+#ifdef CONFIG_HRTIMER
+  /* Convert the timespec to the time of the high resolution timers.  We
+   * must have interrupts disabled here so that this time stays valid
+   * until the wait begins.
+   */
+
+  expired = hrtimer_abstime(clockid, abstime);
+
+  /* If the time has already expired return immediately. */
+
+  if (expired <= hrtimer_gettime())
+    {
+      ret = -ETIMEDOUT;
+      goto out;
+    }
+
+  /* Start the timer */
+
+  hrtimer_start(&rtcb->waithrtimer, expired, CONFIG_HRTIMER_SLACK,
+                nxsem_hrtimeout, (FAR void *)(uintptr_t)nxsched_gettid());
+#else
   /* Convert the timespec to clock ticks.  We must have interrupts
    * disabled here so that this time stays valid until the wait begins.
    *
@@ -152,6 +178,7 @@ int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
   /* Start the watchdog */
 
   wd_start(&rtcb->waitdog, ticks, nxsem_timeout, nxsched_gettid());
+#endif
 
   /* Now perform the blocking wait.  If nxsem_wait() fails, the
    * negated errno value will be returned below.
@@ -161,7 +188,11 @@ int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
 
   /* Stop the watchdog timer */
 
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&rtcb->waithrtimer);
+#else
   wd_cancel(&rtcb->waitdog);
+#endif
 
   /* We can now restore interrupts and delete the watchdog */
 
@@ -111,6 +111,12 @@ nxsem_allocholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
   /* Put it into the task's list */
 
   pholder->tlink  = htcb->holdsem;
+  pholder->tprev  = NULL;
+  if (htcb->holdsem != NULL)
+    {
+      htcb->holdsem->tprev = pholder;
+    }
+
   htcb->holdsem   = pholder;
 
   return pholder;
@@ -185,24 +191,33 @@ nxsem_findorallocateholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 static inline void nxsem_freeholder(FAR sem_t *sem,
                                     FAR struct semholder_s *pholder)
 {
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s * FAR *curr;
+#endif
 
-  /* Remove the holder from the task's list */
+  /* Remove the holder from the task's list.  The list is doubly linked so
+   * that releasing a semaphore does not depend on how many others the
+   * task holds.
+   */
 
-  for (curr = &pholder->htcb->holdsem;
-       *curr != NULL;
-       curr = &(*curr)->tlink)
+  if (pholder->tprev != NULL)
     {
-      if (*curr == pholder)
-        {
-          *curr = pholder->tlink;
-          break;
-        }
+      pholder->tprev->tlink = pholder->tlink;
+    }
+  else
+    {
+      pholder->htcb->holdsem = pholder->tlink;
+    }
+
+  if (pholder->tlink != NULL)
+    {
+      pholder->tlink->tprev = pholder->tprev;
     }
 
   /* Release the holder and counts */
 
   pholder->tlink  = NULL;
+  pholder->tprev  = NULL;
   pholder->sem    = NULL;
   pholder->htcb   = NULL;
   pholder->counts = 0;
@@ -369,13 +384,14 @@ static int nxsem_dumpholder(FAR struct semholder_s *pholder, FAR sem_t *sem,
                             FAR void *arg)
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  _info("  %08x: %08x %08x %08x %08x %04x\n",
+  _info("  %08x: %08x %08x %08x %08x %08x %04x\n",
         pholder, pholder->flink,
 #else
-  _info("  %08x: %08x %08x %08x %04x\n",
+  _info("  %08x: %08x %08x %08x %08x %04x\n",
         pholder,
 #endif
-        pholder->tlink, pholder->sem, pholder->htcb, pholder->counts);
+        pholder->tlink, pholder->tprev, pholder->sem, pholder->htcb,
+        pholder->counts);
   return 0;
 }
 #endif
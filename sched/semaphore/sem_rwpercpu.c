@@ -0,0 +1,277 @@
+/****************************************************************************
+ * sched/semaphore/sem_rwpercpu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/rwsem.h>
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: percpu_read_enter
+ *
+ * Description:
+ *   Count a reader on the current CPU.  Unless force is true, the count is
+ *   taken back when a writer is in.
+ *
+ * Returned Value:
+ *   True if the reader was counted.
+ *
+ ****************************************************************************/
+
+static bool percpu_read_enter(FAR percpu_rw_semaphore_t *sem, bool force)
+{
+  FAR atomic_int *readers;
+  irqstate_t flags;
+  bool ret = true;
+
+  flags   = up_irq_save();
+  readers = &sem->cpu[this_cpu()].readers;
+
+  atomic_fetch_add_explicit(readers, 1, memory_order_relaxed);
+
+  /* Pairs with the fence of percpu_down_write(): either the writer sees
+   * this count or this reader sees the writer.
+   */
+
+  atomic_thread_fence(memory_order_seq_cst);
+
+  if (!force && atomic_load_explicit(&sem->writer, memory_order_relaxed))
+    {
+      atomic_fetch_sub_explicit(readers, 1, memory_order_relaxed);
+      nxsem_post(&sem->drain);
+      ret = false;
+    }
+
+  up_irq_restore(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: percpu_readers
+ *
+ * Description:
+ *   Sum the counts of all CPUs.  Once the writer flag is visible no reader
+ *   can enter and the counts only fall, so a zero sum means that none of
+ *   the readers is left.
+ *
+ ****************************************************************************/
+
+static int percpu_readers(FAR percpu_rw_semaphore_t *sem)
+{
+  int sum = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      sum += atomic_load_explicit(&sem->cpu[i].readers,
+                                  memory_order_relaxed);
+    }
+
+  return sum;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: percpu_down_read
+ *
+ * Description:
+ *   Acquire a read lock on a per-CPU read-write-lock object.  Unless a
+ *   writer is in, this only touches the count of the current CPU.
+ *
+ * Input Parameters:
+ *   sem - Pointer to the per-CPU read-write-lock descriptor.
+ *
+ ****************************************************************************/
+
+void percpu_down_read(FAR percpu_rw_semaphore_t *sem)
+{
+  DEBUGASSERT(!up_interrupt_context());
+
+  if (!percpu_read_enter(sem, false))
+    {
+      /* A writer is in, wait behind it on the read-write-lock.  The writer
+       * holds it until it is done, and the next writer cannot take it
+       * before this reader is counted.
+       */
+
+      down_read(&sem->rwsem);
+      percpu_read_enter(sem, true);
+      up_read(&sem->rwsem);
+    }
+}
+
+/****************************************************************************
+ * Name: percpu_up_read
+ *
+ * Description:
+ *   Unlock a read lock on a per-CPU read-write-lock object.
+ *
+ * Input Parameters:
+ *   sem - Pointer to the per-CPU read-write-lock descriptor.
+ *
+ ****************************************************************************/
+
+void percpu_up_read(FAR percpu_rw_semaphore_t *sem)
+{
+  irqstate_t flags;
+
+  flags = up_irq_save();
+
+  atomic_thread_fence(memory_order_release);
+  atomic_fetch_sub_explicit(&sem->cpu[this_cpu()].readers, 1,
+                            memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+
+  /* Wake up a writer waiting for the readers to drain */
+
+  if (atomic_load_explicit(&sem->writer, memory_order_relaxed))
+    {
+      nxsem_post(&sem->drain);
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: percpu_down_write
+ *
+ * Description:
+ *   Acquire a write lock on a per-CPU read-write-lock object.  This waits
+ *   for the readers of all CPUs to leave.
+ *
+ * Input Parameters:
+ *   sem - Pointer to the per-CPU read-write-lock descriptor.
+ *
+ ****************************************************************************/
+
+void percpu_down_write(FAR percpu_rw_semaphore_t *sem)
+{
+  /* Exclude the other writers and the readers that have blocked */
+
+  down_write(&sem->rwsem);
+
+  /* Forget the wakeups left over from the previous writer */
+
+  while (nxsem_trywait(&sem->drain) >= 0);
+
+  atomic_store_explicit(&sem->writer, true, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+
+  while (percpu_readers(sem) > 0)
+    {
+      nxsem_wait_uninterruptible(&sem->drain);
+    }
+
+  atomic_thread_fence(memory_order_acquire);
+}
+
+/****************************************************************************
+ * Name: percpu_up_write
+ *
+ * Description:
+ *   Unlock a write lock on a per-CPU read-write-lock object.
+ *
+ * Input Parameters:
+ *   sem - Pointer to the per-CPU read-write-lock descriptor.
+ *
+ ****************************************************************************/
+
+void percpu_up_write(FAR percpu_rw_semaphore_t *sem)
+{
+  atomic_store_explicit(&sem->writer, false, memory_order_release);
+  up_write(&sem->rwsem);
+}
+
+/****************************************************************************
+ * Name: percpu_init_rwsem
+ *
+ * Description:
+ *   Initialize a per-CPU read-write-lock object.
+ *
+ * Input Parameters:
+ *   sem - Pointer to the per-CPU read-write-lock descriptor.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success. A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int percpu_init_rwsem(FAR percpu_rw_semaphore_t *sem)
+{
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      atomic_init(&sem->cpu[i].readers, 0);
+    }
+
+  atomic_init(&sem->writer, false);
+
+  ret = init_rwsem(&sem->rwsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nxsem_init(&sem->drain, 0, 0);
+  if (ret < 0)
+    {
+      destroy_rwsem(&sem->rwsem);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: percpu_destroy_rwsem
+ *
+ * Description:
+ *   Destroy a per-CPU read-write-lock object.
+ *
+ * Input Parameters:
+ *   sem - Pointer to the per-CPU read-write-lock descriptor.
+ *
+ ****************************************************************************/
+
+void percpu_destroy_rwsem(FAR percpu_rw_semaphore_t *sem)
+{
+  DEBUGASSERT(percpu_readers(sem) == 0 &&
+              !atomic_load(&sem->writer));
+
+  nxsem_destroy(&sem->drain);
+  destroy_rwsem(&sem->rwsem);
+}
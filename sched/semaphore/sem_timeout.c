@@ -29,6 +29,7 @@
 #include <errno.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/wdog.h>
 
 #include <nuttx/irq.h>
@@ -87,3 +88,19 @@ void nxsem_timeout(wdparm_t pid)
 
   leave_critical_section(flags);
 }
+
+/****************************************************************************
+ * Name: nxsem_hrtimeout
+ *
+ * Description:
+ *   The high resolution timer version of nxsem_timeout(), with the task ID
+ *   in the argument of the timer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+void nxsem_hrtimeout(FAR struct hrtimer_s *timer)
+{
+  nxsem_timeout((wdparm_t)(uintptr_t)timer->arg);
+}
+#endif
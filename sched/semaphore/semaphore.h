@@ -62,6 +62,9 @@ void nxsem_wait_irq(FAR struct tcb_s *wtcb, int errcode);
 /* Handle semaphore timer expiration */
 
 void nxsem_timeout(wdparm_t pid);
+#ifdef CONFIG_HRTIMER
+void nxsem_hrtimeout(FAR struct hrtimer_s *timer);
+#endif
 
 /* Recover semaphore resources with a task or thread is destroyed */
 
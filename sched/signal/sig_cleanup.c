@@ -96,6 +96,20 @@ void nxsig_release(FAR struct task_group_s *group)
   while ((sigpend = (FAR sigpendq_t *)sq_remfirst(&group->tg_sigpendingq))
          != NULL)
     {
-      nxsig_release_pendingsignal(sigpend);
+      nxsig_release_pendingsignal(NULL, sigpend);
     }
+
+  sigemptyset(&group->tg_sigpendingset);
+
+#if CONFIG_SIG_PENDING_GROUP_CACHE > 0
+  /* Return the pending signals kept for reuse */
+
+  while ((sigpend =
+          (FAR sigpendq_t *)sq_remfirst(&group->tg_sigpendingfree)) != NULL)
+    {
+      nxsig_release_pendingsignal(NULL, sigpend);
+    }
+
+  group->tg_sigpendingnfree = 0;
+#endif
 }
@@ -128,15 +128,30 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
  * Name: nxsig_alloc_pendingsignal
  *
  * Description:
- *   Allocate a pending signal list entry
+ *   Allocate a pending signal list entry, preferably one kept by the task
+ *   group.
  *
  ****************************************************************************/
 
-static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
+static FAR sigpendq_t *
+nxsig_alloc_pendingsignal(FAR struct task_group_s *group)
 {
   FAR sigpendq_t *sigpend;
   irqstate_t      flags;
 
+#if CONFIG_SIG_PENDING_GROUP_CACHE > 0
+  flags = enter_critical_section();
+  sigpend = (FAR sigpendq_t *)sq_remfirst(&group->tg_sigpendingfree);
+  if (sigpend != NULL)
+    {
+      group->tg_sigpendingnfree--;
+      leave_critical_section(flags);
+      return sigpend;
+    }
+
+  leave_critical_section(flags);
+#endif
+
   /* Check if we were called from an interrupt handler. */
 
   if (up_interrupt_context())
@@ -214,7 +229,13 @@ nxsig_find_pendingsignal(FAR struct task_group_s *group, int signo)
 
   flags = enter_critical_section();
 
-  /* Search the list for a action pending on this signal */
+  /* Search the list for a action pending on this signal, if any */
+
+  if (!nxsig_ismember(&group->tg_sigpendingset, signo))
+    {
+      leave_critical_section(flags);
+      return NULL;
+    }
 
   for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
        (sigpend && sigpend->info.si_signo != signo);
@@ -279,7 +300,7 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
     {
       /* Allocate a new pending signal entry */
 
-      sigpend = nxsig_alloc_pendingsignal();
+      sigpend = nxsig_alloc_pendingsignal(group);
       if (sigpend != NULL)
         {
           /* Put the signal information into the allocated structure */
@@ -290,6 +311,7 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
 
           flags = enter_critical_section();
           sq_addlast((FAR sq_entry_t *)sigpend, &group->tg_sigpendingq);
+          nxsig_addset(&group->tg_sigpendingset, info->si_signo);
           leave_critical_section(flags);
           nxsig_dispatch_kernel_action(stcb, &sigpend->info);
         }
@@ -73,7 +73,8 @@ int sigpending(FAR sigset_t *set)
  * Name: nxsig_pendingset
  *
  * Description:
- *   Convert the list of pending signals into a signal set
+ *   Return the set of pending signals, which is maintained along with the
+ *   list of pending signals
  *
  ****************************************************************************/
 
@@ -81,7 +82,6 @@ sigset_t nxsig_pendingset(FAR struct tcb_s *stcb)
 {
   FAR struct task_group_s *group;
   sigset_t sigpendset;
-  FAR sigpendq_t *sigpend;
   irqstate_t flags;
 
   if (stcb == NULL)
@@ -92,15 +92,8 @@ sigset_t nxsig_pendingset(FAR struct tcb_s *stcb)
   group = stcb->group;
   DEBUGASSERT(group);
 
-  sigemptyset(&sigpendset);
-
   flags = enter_critical_section();
-  for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
-       (sigpend); sigpend = sigpend->flink)
-    {
-      nxsig_addset(&sigpendset, sigpend->info.si_signo);
-    }
-
+  sigpendset = group->tg_sigpendingset;
   leave_critical_section(flags);
 
   return sigpendset;
@@ -48,14 +48,35 @@
  * Name: nxsig_release_pendingsignal
  *
  * Description:
- *   Deallocate a pending signal list entry
+ *   Deallocate a pending signal list entry.  The entry is kept for reuse by
+ *   'group' if the free list of the group is not full; a NULL 'group'
+ *   releases it to the global pools.
  *
  ****************************************************************************/
 
-void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
+void nxsig_release_pendingsignal(FAR struct task_group_s *group,
+                                 FAR sigpendq_t *sigpend)
 {
   irqstate_t flags;
 
+#if CONFIG_SIG_PENDING_GROUP_CACHE > 0
+  if (group != NULL)
+    {
+      flags = enter_critical_section();
+      if (group->tg_sigpendingnfree < CONFIG_SIG_PENDING_GROUP_CACHE)
+        {
+          sq_addfirst((FAR sq_entry_t *)sigpend, &group->tg_sigpendingfree);
+          group->tg_sigpendingnfree++;
+          leave_critical_section(flags);
+          return;
+        }
+
+      leave_critical_section(flags);
+    }
+#else
+  UNUSED(group);
+#endif
+
   /* If this is a generally available pre-allocated structure,
    * then just put it back in the free list.
    */
@@ -37,6 +37,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/signal.h>
 
 #include "signal/signal.h"
 
@@ -57,12 +58,21 @@ FAR sigpendq_t *nxsig_remove_pendingsignal(FAR struct tcb_s *stcb, int signo)
   FAR struct task_group_s *group = stcb->group;
   FAR sigpendq_t *currsig;
   FAR sigpendq_t *prevsig;
+  FAR sigpendq_t *nextsig;
   irqstate_t  flags;
 
   DEBUGASSERT(group);
 
   flags = enter_critical_section();
 
+  /* Nothing to search if the signal is not pending */
+
+  if (!nxsig_ismember(&group->tg_sigpendingset, signo))
+    {
+      leave_critical_section(flags);
+      return NULL;
+    }
+
   for (prevsig = NULL,
        currsig = (FAR sigpendq_t *)group->tg_sigpendingq.head;
        (currsig && currsig->info.si_signo != signo);
@@ -78,6 +88,17 @@ FAR sigpendq_t *nxsig_remove_pendingsignal(FAR struct tcb_s *stcb, int signo)
         {
           sq_remfirst(&group->tg_sigpendingq);
         }
+
+      /* Only real-time signals can be queued more than once */
+
+      for (nextsig = currsig->flink;
+           (nextsig && nextsig->info.si_signo != signo);
+           nextsig = nextsig->flink);
+
+      if (nextsig == NULL)
+        {
+          nxsig_delset(&group->tg_sigpendingset, signo);
+        }
     }
 
   leave_critical_section(flags);
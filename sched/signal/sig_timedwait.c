@@ -38,6 +38,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/wdog.h>
 #include <nuttx/signal.h>
 #include <nuttx/cancelpt.h>
@@ -64,7 +65,7 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nxsig_timeout
+ * Name: nxsig_timeout and nxsig_hrtimeout
  *
  * Description:
  *   A timeout elapsed while waiting for signals to be queued.
@@ -132,6 +133,13 @@ static void nxsig_timeout(wdparm_t arg)
 #endif
 }
 
+#ifdef CONFIG_HRTIMER
+static void nxsig_hrtimeout(FAR struct hrtimer_s *timer)
+{
+  nxsig_timeout((wdparm_t)timer->arg);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -250,7 +258,11 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
   sigset_t intersection;
   FAR sigpendq_t *sigpend;
   irqstate_t flags;
+#ifdef CONFIG_HRTIMER
+  uint64_t waitns;
+#else
   sclock_t waitticks;
+#endif
   siginfo_t unbinfo;
   int ret;
 
@@ -294,7 +306,7 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
       /* Then dispose of the pending signal structure properly */
 
-      nxsig_release_pendingsignal(sigpend);
+      nxsig_release_pendingsignal(rtcb->group, sigpend);
       leave_critical_section(flags);
     }
 
@@ -325,25 +337,32 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
       if (timeout != NULL)
         {
+#ifdef CONFIG_HRTIMER
+          /* The high resolution timer waits for the nanoseconds */
+
+          waitns = clock_time2nsec(timeout);
+          if (waitns > 0)
+#else
           /* Convert the timespec to system clock ticks, making sure that
            * the resulting delay is greater than or equal to the requested
            * time in nanoseconds.
            */
 
-#ifdef CONFIG_SYSTEM_TIME64
+#  ifdef CONFIG_SYSTEM_TIME64
           waitticks = ((uint64_t)timeout->tv_sec * NSEC_PER_SEC +
                       (uint64_t)timeout->tv_nsec + NSEC_PER_TICK - 1) /
                       NSEC_PER_TICK;
-#else
+#  else
           uint32_t waitmsec;
 
           DEBUGASSERT(timeout->tv_sec < UINT32_MAX / MSEC_PER_SEC);
           waitmsec = timeout->tv_sec * MSEC_PER_SEC +
                      (timeout->tv_nsec + NSEC_PER_MSEC - 1) / NSEC_PER_MSEC;
           waitticks = MSEC2TICK(waitmsec);
-#endif
+#  endif
 
           if (waitticks > 0)
+#endif
             {
               /* Save the set of pending signals to wait for */
 
@@ -351,8 +370,13 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
               /* Start the watchdog */
 
+#ifdef CONFIG_HRTIMER
+              hrtimer_start(&rtcb->waithrtimer, hrtimer_gettime() + waitns,
+                            CONFIG_HRTIMER_SLACK, nxsig_hrtimeout, rtcb);
+#else
               wd_start(&rtcb->waitdog, waitticks,
                        nxsig_timeout, (uintptr_t)rtcb);
+#endif
 
               /* Now wait for either the signal or the watchdog, but
                * first, make sure this is not the idle task,
@@ -376,7 +400,11 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
               /* We no longer need the watchdog */
 
+#ifdef CONFIG_HRTIMER
+              hrtimer_cancel(&rtcb->waithrtimer);
+#else
               wd_cancel(&rtcb->waitdog);
+#endif
             }
           else
             {
@@ -190,7 +190,9 @@ FAR sigactq_t     *nxsig_find_action(FAR struct task_group_s *group,
                                      int signo);
 int                nxsig_lowest(FAR sigset_t *set);
 void               nxsig_release_pendingsigaction(FAR sigq_t *sigq);
-void               nxsig_release_pendingsignal(FAR sigpendq_t *sigpend);
+void               nxsig_release_pendingsignal(
+                                   FAR struct task_group_s *group,
+                                   FAR sigpendq_t *sigpend);
 FAR sigpendq_t    *nxsig_remove_pendingsignal(FAR struct tcb_s *stcb,
                                               int signo);
 bool               nxsig_unmask_pendingsignal(void);
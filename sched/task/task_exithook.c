@@ -456,6 +456,12 @@ void nxtask_exithook(FAR struct tcb_s *tcb, int status)
 
   nxtask_exitwakeup(tcb, status);
 
+#ifdef CONFIG_FS_POLL_CACHE
+  /* Drop the poll() registration while the files are still there */
+
+  poll_cache_release(tcb);
+#endif
+
   /* Leave the task group.  Perhaps discarding any un-reaped child
    * status (no zombies here!)
    */
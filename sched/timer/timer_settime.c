@@ -47,6 +47,9 @@ static inline void timer_signotify(FAR struct posix_timer_s *timer);
 static inline void timer_restart(FAR struct posix_timer_s *timer,
                                  wdparm_t itimer);
 static void timer_timeout(wdparm_t itimer);
+#ifdef CONFIG_HRTIMER
+static void timer_hrtimeout(FAR struct hrtimer_s *hrtimer);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -93,6 +96,32 @@ static inline void timer_signotify(FAR struct posix_timer_s *timer)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_HRTIMER
+static inline void timer_restart(FAR struct posix_timer_s *timer,
+                                 wdparm_t itimer)
+{
+  uint64_t now;
+  uint64_t frame;
+
+  /* If this is a repetitive timer, then restart the timer.  The overruns
+   * are counted as with the watchdog below, in nanoseconds.
+   */
+
+  if (timer->pt_delay)
+    {
+      now   = hrtimer_gettime();
+      frame = now > timer->pt_expected ? now - timer->pt_expected : 0;
+      frame = (frame + timer->pt_delay) / timer->pt_delay;
+
+      timer->pt_overrun = frame - 1;
+      timer->pt_expected += frame * timer->pt_delay;
+
+      hrtimer_start(&timer->pt_hrtimer, timer->pt_expected,
+                    CONFIG_HRTIMER_SLACK, timer_hrtimeout,
+                    (FAR void *)itimer);
+    }
+}
+#else
 static inline void timer_restart(FAR struct posix_timer_s *timer,
                                  wdparm_t itimer)
 {
@@ -130,6 +159,7 @@ static inline void timer_restart(FAR struct posix_timer_s *timer,
                        timer_timeout, itimer);
     }
 }
+#endif
 
 /****************************************************************************
  * Name: timer_timeout
@@ -178,6 +208,13 @@ static void timer_timeout(wdparm_t itimer)
     }
 }
 
+#ifdef CONFIG_HRTIMER
+static void timer_hrtimeout(FAR struct hrtimer_s *hrtimer)
+{
+  timer_timeout((wdparm_t)hrtimer->arg);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -251,7 +288,9 @@ int timer_settime(timer_t timerid, int flags,
                   FAR struct itimerspec *ovalue)
 {
   FAR struct posix_timer_s *timer = timer_gethandle(timerid);
+#ifndef CONFIG_HRTIMER
   sclock_t delay;
+#endif
   int ret = OK;
 
   /* Some sanity checks */
@@ -264,6 +303,11 @@ int timer_settime(timer_t timerid, int flags,
 
   if (ovalue)
     {
+#ifdef CONFIG_HRTIMER
+      clock_nsec2time(&ovalue->it_value,
+                      hrtimer_gettimeleft(&timer->pt_hrtimer));
+      clock_nsec2time(&ovalue->it_interval, timer->pt_delay);
+#else
       /* Get the number of ticks before the underlying watchdog expires */
 
       delay = wd_gettime(&timer->pt_wdog);
@@ -272,13 +316,18 @@ int timer_settime(timer_t timerid, int flags,
 
       clock_ticks2time(&ovalue->it_value, delay);
       clock_ticks2time(&ovalue->it_interval, timer->pt_delay);
+#endif
     }
 
   /* Disarm the timer (in case the timer was already armed when
    * timer_settime() is called).
    */
 
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&timer->pt_hrtimer);
+#else
   wd_cancel(&timer->pt_wdog);
+#endif
 
   /* Cancel any pending notification */
 
@@ -293,6 +342,25 @@ int timer_settime(timer_t timerid, int flags,
       return OK;
     }
 
+#ifdef CONFIG_HRTIMER
+  /* Setup up any repetitive timer, then the first expiration */
+
+  timer->pt_delay = clock_time2nsec(&value->it_interval);
+
+  if ((flags & TIMER_ABSTIME) != 0)
+    {
+      timer->pt_expected = hrtimer_abstime(timer->pt_clock,
+                                           &value->it_value);
+    }
+  else
+    {
+      timer->pt_expected = hrtimer_gettime() +
+                           clock_time2nsec(&value->it_value);
+    }
+
+  ret = hrtimer_start(&timer->pt_hrtimer, timer->pt_expected,
+                      CONFIG_HRTIMER_SLACK, timer_hrtimeout, timer);
+#else
   /* Setup up any repetitive timer */
 
   if (value->it_interval.tv_sec > 0 || value->it_interval.tv_nsec > 0)
@@ -330,6 +398,7 @@ int timer_settime(timer_t timerid, int flags,
 
   ret = wd_start_abstick(&timer->pt_wdog, timer->pt_expected,
                          timer_timeout, (wdparm_t)timer);
+#endif
 
   if (ret < 0)
     {
@@ -65,7 +65,7 @@ static void task_init_stream(FAR struct streamlist *list)
 #if !defined(CONFIG_STDIO_DISABLE_BUFFERING) && CONFIG_STDIO_BUFFER_SIZE > 0
       /* Set up pointers */
 
-      stream[i].fs_bufstart = stream[i].fs_buffer;
+      stream[i].fs_bufstart = list->sl_buffer[i];
       stream[i].fs_bufend   = stream[i].fs_bufstart +
                               CONFIG_STDIO_BUFFER_SIZE;
       stream[i].fs_bufpos   = stream[i].fs_bufstart;
@@ -67,6 +67,10 @@ int tls_dup_info(FAR struct tcb_s *dst, FAR struct tcb_s *src)
 
   memcpy(info, src->stack_alloc_ptr, tls_info_size());
 
+  /* The thread ID cached by the parent is not the one of the child */
+
+  info->tl_tid = 0;
+
   /* Attach per-task info in group to TLS */
 
   info->tl_task = dst->group->tg_info;
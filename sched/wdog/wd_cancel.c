@@ -103,6 +103,15 @@ int wd_cancel_irq(FAR struct wdog_s *wdog)
 
   if (WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      /* Remove the watchdog from its timer wheel slot.  The interval timer
+       * is not reassessed:  At worst, the next timer event finds nothing
+       * to expire.
+       */
+
+      wd_wheel_delete(wdog);
+      wdog->func = NULL;
+#else
       bool head = list_is_head(&g_wdactivelist, &wdog->node);
 
       /* Now, remove the watchdog from the timer queue */
@@ -122,6 +131,7 @@ int wd_cancel_irq(FAR struct wdog_s *wdog)
 
           nxsched_reassess_timer();
         }
+#endif
     }
 
   return OK;
@@ -37,10 +37,44 @@
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
+ *
+ * If CONFIG_WDOG_TIMERWHEEL is enabled, the active watchdogs are held in
+ * the slots of the g_wdwheel timer wheel instead.
  */
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+struct wdog_wheel_s g_wdwheel;
+#else
 struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the slot lists of the watchdog timer wheel.  This must be
+ *   called very early in the boot sequence, before any watchdog is started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+void wd_initialize(void)
+{
+  int level;
+  int index;
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      for (index = 0; index < WDOG_WHEEL_SLOTS; index++)
+        {
+          list_initialize(&g_wdwheel.slot[level][index]);
+        }
+
+      g_wdwheel.bitmap[level] = 0;
+    }
+}
+#endif
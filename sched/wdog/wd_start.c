@@ -77,6 +77,15 @@
 
 #ifdef CONFIG_SCHED_TICKLESS
 static unsigned int g_wdtimernested;
+
+#  ifdef CONFIG_WDOG_TIMERWHEEL
+/* The absolute time of the next timer event, as last requested by
+ * wd_timer().  Only valid if g_wdnextvalid is true.
+ */
+
+static clock_t g_wdnextexpired;
+static bool g_wdnextvalid;
+#  endif
 #endif
 
 /****************************************************************************
@@ -103,6 +112,9 @@ static inline_function void wd_expiration(clock_t ticks)
   FAR struct wdog_s *wdog;
   irqstate_t flags;
   wdentry_t func;
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  clock_t next;
+#endif
 
   flags = enter_critical_section();
 
@@ -114,6 +126,48 @@ static inline_function void wd_expiration(clock_t ticks)
   g_wdtimernested++;
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Advance the wheel up to and including the current time.  Only the
+   * ticks at which a level 0 slot expires or a higher level slot cascades
+   * are visited; empty stretches of the wheel are skipped.
+   */
+
+  while (wd_wheel_next(&next) && clock_compare(next, ticks))
+    {
+      FAR struct list_node *slot;
+
+      g_wdwheel.base = next;
+      wd_wheel_cascade();
+
+      /* Every watchdog left in the current level 0 slot expires now */
+
+      slot = &g_wdwheel.slot[0][next & WDOG_WHEEL_MASK];
+      while (!list_is_empty(slot))
+        {
+          wdog = list_first_entry(slot, struct wdog_s, node);
+          wd_wheel_delete(wdog);
+
+          /* Indicate that the watchdog is no longer active. */
+
+          func = wdog->func;
+          wdog->func = NULL;
+
+          /* Execute the watchdog function */
+
+          up_setpicbase(wdog->picbase);
+          CALL_FUNC(func, wdog->arg);
+        }
+
+      g_wdwheel.base = next + 1;
+    }
+
+  /* Nothing is pending up to the current time */
+
+  if (clock_compare(g_wdwheel.base, ticks))
+    {
+      g_wdwheel.base = ticks + 1;
+    }
+#else
   /* Process the watchdog at the head of the list as well as any
    * other watchdogs that became ready to run at this time
    */
@@ -143,6 +197,7 @@ static inline_function void wd_expiration(clock_t ticks)
       up_setpicbase(wdog->picbase);
       CALL_FUNC(func, wdog->arg);
     }
+#endif
 
 #ifdef CONFIG_SCHED_TICKLESS
   /* Decrement the nested watchdog timer count */
@@ -178,6 +233,10 @@ static inline_function
 void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
 {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  wdog->expired = expired;
+  wd_wheel_insert(wdog);
+#else
   FAR struct wdog_s *curr;
 
   /* Traverse the watchdog list */
@@ -200,6 +259,7 @@ void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
    */
 
   list_add_before(&curr->node, &wdog->node);
+#endif
 
   wdog->func = wdentry;
   up_getpicbase(&wdog->picbase);
@@ -283,7 +343,52 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
    */
 
   flags = enter_critical_section();
-#ifdef CONFIG_SCHED_TICKLESS
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Check if the watchdog has been started. If so, delete it.  There is
+   * no need to reassess the timer when a watchdog is removed:  At worst,
+   * the next timer event finds nothing to expire.
+   */
+
+  if (WDOG_ISACTIVE(wdog))
+    {
+      wd_wheel_delete(wdog);
+      wdog->func = NULL;
+    }
+
+#  ifdef CONFIG_SCHED_TICKLESS
+  if (!g_wdtimernested)
+    {
+      clock_t next;
+
+      /* The wheel may have been idle for a long time.  Bring its base
+       * up to date so that the new watchdog lands on the lowest level.
+       */
+
+      if (!wd_wheel_next(&next))
+        {
+          g_wdwheel.base = clock_systime_ticks();
+        }
+
+      /* Reassess the timer if the new watchdog expires before the
+       * currently programmed timer event.
+       */
+
+      reassess = !g_wdnextvalid ||
+                 (sclock_t)(ticks - g_wdnextexpired) < 0;
+    }
+
+  wd_insert(wdog, ticks, wdentry, arg);
+
+  if (reassess)
+    {
+      nxsched_reassess_timer();
+    }
+#  else
+  UNUSED(reassess);
+
+  wd_insert(wdog, ticks, wdentry, arg);
+#  endif
+#elif defined(CONFIG_SCHED_TICKLESS)
   /* We need to reassess timer if the watchdog list head has changed. */
 
   if (WDOG_ISACTIVE(wdog))
@@ -401,7 +506,11 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
 #ifdef CONFIG_SCHED_TICKLESS
 clock_t wd_timer(clock_t ticks, bool noswitches)
 {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  clock_t next;
+#else
   FAR struct wdog_s *wdog;
+#endif
   irqstate_t flags;
   sclock_t ret;
 
@@ -414,6 +523,28 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
 
   flags = enter_critical_section();
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Return the delay for the next event of the timer wheel.  This may be
+   * a cascade rather than a real expiration, so it is a lower bound of the
+   * delay until the next watchdog expires.
+   */
+
+  if (!wd_wheel_next(&next))
+    {
+      g_wdnextvalid = false;
+      leave_critical_section(flags);
+      return 0;
+    }
+
+  ret = MAX((sclock_t)(next - ticks), 1);
+
+  g_wdnextexpired = ticks + ret;
+  g_wdnextvalid   = true;
+
+  leave_critical_section(flags);
+
+  return ret;
+#else
   /* Return the delay for the next watchdog to expire */
 
   if (list_is_empty(&g_wdactivelist))
@@ -434,6 +565,7 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
   /* Return the delay for the next watchdog to expire */
 
   return MAX(ret, 1);
+#endif
 }
 
 #else
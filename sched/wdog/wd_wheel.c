@@ -0,0 +1,279 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/list.h>
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of ticks covered by the whole wheel */
+
+#define WDOG_WHEEL_RANGE ((clock_t)1 << WDOG_WHEEL_SHIFT(WDOG_WHEEL_LEVELS))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_distance
+ *
+ * Description:
+ *   Return the distance (in slots) from slot 'index' to the first non-empty
+ *   slot in 'bitmap', searching cyclically and starting with 'index'
+ *   itself.
+ *
+ * Assumptions:
+ *   bitmap is not zero.
+ *
+ ****************************************************************************/
+
+static inline_function unsigned int wd_wheel_distance(uint32_t bitmap,
+                                                      unsigned int index)
+{
+  index &= WDOG_WHEEL_MASK;
+  if (index != 0)
+    {
+      bitmap = (bitmap >> index) | (bitmap << (WDOG_WHEEL_SLOTS - index));
+    }
+
+  return ffs(bitmap) - 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Link an inactive watchdog into the slot of the timer wheel that matches
+ *   its 'expired' time.  O(1).
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  clock_t expired = wdog->expired;
+  clock_t delta;
+  int level;
+  int index;
+
+  /* A watchdog that is already due goes to the next slot processed */
+
+  if (clock_compare(expired, g_wdwheel.base))
+    {
+      expired = g_wdwheel.base;
+    }
+
+  /* Watchdogs beyond the range of the wheel are parked in the farthest
+   * slot of the highest level.  They will be re-inserted, with their real
+   * expiration time, when that slot is cascaded.
+   */
+
+  delta = expired - g_wdwheel.base;
+  if (delta >= WDOG_WHEEL_RANGE)
+    {
+      expired = g_wdwheel.base + WDOG_WHEEL_RANGE - 1;
+      delta   = WDOG_WHEEL_RANGE - 1;
+    }
+
+  /* Select the lowest level that can hold the delay */
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS - 1; level++)
+    {
+      if (delta < ((clock_t)1 << WDOG_WHEEL_SHIFT(level + 1)))
+        {
+          break;
+        }
+    }
+
+  index = (expired >> WDOG_WHEEL_SHIFT(level)) & WDOG_WHEEL_MASK;
+
+  list_add_tail(&g_wdwheel.slot[level][index], &wdog->node);
+  g_wdwheel.bitmap[level] |= (uint32_t)1 << index;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_delete
+ *
+ * Description:
+ *   Unlink an active watchdog from its timer wheel slot.  O(1).
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_delete(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *next = wdog->node.next;
+
+  list_delete(&wdog->node);
+
+  /* Only a slot head can become an empty list.  In that case, recover the
+   * level and the slot index from the position of the head in the table.
+   */
+
+  if (list_is_empty(next))
+    {
+      int offset = next - &g_wdwheel.slot[0][0];
+
+      g_wdwheel.bitmap[offset >> WDOG_WHEEL_BITS] &=
+        ~((uint32_t)1 << (offset & WDOG_WHEEL_MASK));
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the earliest absolute tick at which the wheel needs attention,
+ *   i.e. either the expiration of a level 0 slot or the cascade of a
+ *   non-empty higher level slot.  This is a lower bound of the time of the
+ *   next watchdog expiration.  The wheel is empty if false is returned.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR clock_t *next)
+{
+  clock_t base = g_wdwheel.base;
+  clock_t earliest = 0;
+  clock_t tick;
+  bool found = false;
+  int level;
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      uint32_t bitmap = g_wdwheel.bitmap[level];
+      clock_t period;
+
+      if (bitmap == 0)
+        {
+          continue;
+        }
+
+      if (level == 0)
+        {
+          /* Level 0 slots hold exactly the ticks [base, base + 32) */
+
+          tick = base + wd_wheel_distance(bitmap, base);
+        }
+      else
+        {
+          /* A higher level slot is cascaded on the first period boundary
+           * at or after base that selects it.  If base is not on a
+           * boundary, the current slot was already cascaded in this round.
+           */
+
+          period = (base + ((clock_t)1 << WDOG_WHEEL_SHIFT(level)) - 1) >>
+                   WDOG_WHEEL_SHIFT(level);
+          tick   = (period + wd_wheel_distance(bitmap, period)) <<
+                   WDOG_WHEEL_SHIFT(level);
+        }
+
+      if (!found || (sclock_t)(tick - earliest) < 0)
+        {
+          earliest = tick;
+          found    = true;
+        }
+    }
+
+  *next = earliest;
+  return found;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Redistribute the current slot of every level whose period boundary is
+ *   crossed at g_wdwheel.base into the lower levels.  Must be called each
+ *   time that g_wdwheel.base is advanced onto a tick returned by
+ *   wd_wheel_next(), before the level 0 slot of that tick is expired.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_cascade(void)
+{
+  clock_t base = g_wdwheel.base;
+  int level;
+
+  /* Cascade from the top down so that a watchdog can fall through several
+   * levels at once.
+   */
+
+  for (level = WDOG_WHEEL_LEVELS - 1; level > 0; level--)
+    {
+      FAR struct list_node *slot;
+      int index;
+
+      if ((base & (((clock_t)1 << WDOG_WHEEL_SHIFT(level)) - 1)) != 0)
+        {
+          continue;
+        }
+
+      index = (base >> WDOG_WHEEL_SHIFT(level)) & WDOG_WHEEL_MASK;
+      if ((g_wdwheel.bitmap[level] & ((uint32_t)1 << index)) == 0)
+        {
+          continue;
+        }
+
+      slot = &g_wdwheel.slot[level][index];
+      while (!list_is_empty(slot))
+        {
+          FAR struct wdog_s *wdog =
+            list_first_entry(slot, struct wdog_s, node);
+
+          wd_wheel_delete(wdog);
+          wd_wheel_insert(wdog);
+        }
+    }
+}
+
+#endif /* CONFIG_WDOG_TIMERWHEEL */
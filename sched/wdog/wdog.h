@@ -46,6 +46,39 @@
 
 #define list_node wdlist_node
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/* Geometry of the hierarchical timer wheel */
+
+#  define WDOG_WHEEL_BITS     5
+#  define WDOG_WHEEL_SLOTS    (1 << WDOG_WHEEL_BITS)
+#  define WDOG_WHEEL_MASK     (WDOG_WHEEL_SLOTS - 1)
+#  define WDOG_WHEEL_LEVELS   CONFIG_WDOG_TIMERWHEEL_LEVELS
+
+/* Shift that selects the slot index of level 'l' from an absolute tick */
+
+#  define WDOG_WHEEL_SHIFT(l) ((l) * WDOG_WHEEL_BITS)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/* The hierarchical timer wheel.  A watchdog that expires 'delta' ticks
+ * after 'base' lives at level 'l' where delta < 32^(l+1), in the slot
+ * selected by bits [5*l, 5*l+4] of its absolute expiration time.  When
+ * 'base' crosses a multiple of 32^l, the current slot of level 'l' is
+ * cascaded into the lower levels.  Only level 0 slots are ever expired.
+ */
+
+struct wdog_wheel_s
+{
+  clock_t          base;                      /* Next tick to be processed */
+  uint32_t         bitmap[WDOG_WHEEL_LEVELS]; /* Non-empty slots per level */
+  struct list_node slot[WDOG_WHEEL_LEVELS][WDOG_WHEEL_SLOTS];
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -63,12 +96,88 @@ extern "C"
  * this linked list are removed and the function is called.
  */
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+extern struct wdog_wheel_s g_wdwheel;
+#else
 extern struct list_node g_wdactivelist;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the slot lists of the watchdog timer wheel.  This must be
+ *   called very early in the boot sequence, before any watchdog is started.
+ *
+ ****************************************************************************/
+
+void wd_initialize(void);
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Link an inactive watchdog into the slot of the timer wheel that matches
+ *   its 'expired' time.  O(1).
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_delete
+ *
+ * Description:
+ *   Unlink an active watchdog from its timer wheel slot.  O(1).
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_delete(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the earliest absolute tick at which the wheel needs attention,
+ *   i.e. either the expiration of a level 0 slot or the cascade of a
+ *   non-empty higher level slot.  This is a lower bound of the time of the
+ *   next watchdog expiration.  The wheel is empty if false is returned.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR clock_t *next);
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Redistribute the current slot of every level whose period boundary is
+ *   crossed at g_wdwheel.base into the lower levels.  Must be called each
+ *   time that g_wdwheel.base is advanced onto a tick returned by
+ *   wd_wheel_next(), before the level 0 slot of that tick is expired.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_cascade(void);
+#endif
+
 /****************************************************************************
  * Name: wd_timer
  *
@@ -71,7 +71,7 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
         }
       else
         {
-          dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+          dq_rem((FAR dq_entry_t *)work, WORK_PENDING(wqueue, work));
         }
 
       work->worker = NULL;
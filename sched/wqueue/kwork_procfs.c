@@ -0,0 +1,402 @@
+/****************************************************************************
+ * sched/wqueue/kwork_procfs.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "wqueue/wqueue.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Output format, for each of the high and low priority queues:
+ *
+ *   hpwork: COUNT works, RATE/s, max wait MAXWAIT us, max exec MAXEXEC us
+ *     us   <1 <2 <4 ... <16384 >=16384
+ *     wait N  N  N  ...
+ *     exec N  N  N  ...
+ *     WORKER   COUNT    MAXWAIT  MAXEXEC  AVGEXEC
+ *     XXXXXXXX DDDDDDDD DDDDDDDD DDDDDDDD DDDDDDDD
+ *
+ * The times are in microseconds and the figures are those since the file
+ * was last opened.
+ */
+
+#define WQUEUE_HDRLEN  96
+#define WQUEUE_HISTLEN (8 + 11 * WORK_STATS_NBUCKETS)
+#define WQUEUE_FNLEN   64
+#define WQUEUE_QLEN    (WQUEUE_HDRLEN + 3 * WQUEUE_HISTLEN + \
+                        (CONFIG_SCHED_WORKQUEUE_STATS_NFUNCS + 1) * \
+                        WQUEUE_FNLEN)
+#define WQUEUE_BUFLEN  (2 * WQUEUE_QLEN)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct wqueue_file_s
+{
+  struct procfs_file_s base;  /* Base open file structure */
+  size_t len;                 /* Length of the text in buffer[] */
+  char buffer[WQUEUE_BUFLEN]; /* The text generated at open time */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     wqueue_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode);
+static int     wqueue_close(FAR struct file *filep);
+static ssize_t wqueue_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static int     wqueue_dup(FAR const struct file *oldp,
+                          FAR struct file *newp);
+static int     wqueue_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_wqueue_operations =
+{
+  wqueue_open,    /* open */
+  wqueue_close,   /* close */
+  wqueue_read,    /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+
+  wqueue_dup,     /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  wqueue_stat     /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wqueue_hist
+ *
+ * Description:
+ *   Format one histogram line.
+ *
+ ****************************************************************************/
+
+static size_t wqueue_hist(FAR char *buffer, size_t buflen,
+                          FAR const char *name, FAR const uint32_t *hist)
+{
+  size_t len;
+  int i;
+
+  len = snprintf(buffer, buflen, "  %-4s", name);
+  for (i = 0; i < WORK_STATS_NBUCKETS && len < buflen; i++)
+    {
+      len += snprintf(buffer + len, buflen - len, " %" PRIu32, hist[i]);
+    }
+
+  if (len < buflen)
+    {
+      len += snprintf(buffer + len, buflen - len, "\n");
+    }
+
+  return MIN(len, buflen);
+}
+
+/****************************************************************************
+ * Name: wqueue_format
+ *
+ * Description:
+ *   Take a snapshot of the statistics of a queue and format them.
+ *
+ ****************************************************************************/
+
+static size_t wqueue_format(FAR char *buffer, size_t buflen,
+                            FAR const char *name,
+                            FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR struct kwork_stats_s *stats;
+  FAR struct kwork_fnstats_s *fn;
+  unsigned long intpart;
+  unsigned long fracpart;
+  clock_t elapsed;
+  size_t len;
+  int i;
+
+  stats = kmm_malloc(sizeof(*stats));
+  if (stats == NULL)
+    {
+      return 0;
+    }
+
+  work_stats_snapshot(wqueue, stats);
+
+  /* rate = <work-count> * TICK_PER_SEC / <elapsed-ticks> */
+
+  elapsed  = clock_systime_ticks() - stats->start;
+  elapsed  = elapsed ? elapsed : 1;
+  intpart  = (unsigned long)((uint64_t)stats->count * TICK_PER_SEC /
+                             elapsed);
+  fracpart = (unsigned long)
+    ((((uint64_t)stats->count * TICK_PER_SEC) % elapsed) * 1000 / elapsed);
+
+  len = snprintf(buffer, buflen,
+                 "%s: %" PRIu32 " works, %lu.%03lu/s, max wait %" PRIu32
+                 " us, max exec %" PRIu32 " us\n  us  ",
+                 name, stats->count, intpart, fracpart, stats->maxwait,
+                 stats->maxexec);
+
+  for (i = 0; i < WORK_STATS_NBUCKETS - 1 && len < buflen; i++)
+    {
+      len += snprintf(buffer + len, buflen - len, " <%lu", 1ul << i);
+    }
+
+  if (len < buflen)
+    {
+      len += snprintf(buffer + len, buflen - len, " >=%lu\n",
+                      1ul << (WORK_STATS_NBUCKETS - 2));
+    }
+
+  if (len < buflen)
+    {
+      len += wqueue_hist(buffer + len, buflen - len, "wait",
+                         stats->waithist);
+    }
+
+  if (len < buflen)
+    {
+      len += wqueue_hist(buffer + len, buflen - len, "exec",
+                         stats->exechist);
+    }
+
+  if (len < buflen)
+    {
+      len += snprintf(buffer + len, buflen - len,
+                      "  WORKER   COUNT    MAXWAIT  MAXEXEC  AVGEXEC\n");
+    }
+
+  for (i = 0; i < CONFIG_SCHED_WORKQUEUE_STATS_NFUNCS && len < buflen; i++)
+    {
+      fn = &stats->fn[i];
+      if (fn->worker != NULL)
+        {
+          len += snprintf(buffer + len, buflen - len,
+                          "  %08lx %-8" PRIu32 " %-8" PRIu32 " %-8" PRIu32
+                          " %-8" PRIu32 "\n",
+                          (unsigned long)(uintptr_t)fn->worker, fn->count,
+                          fn->maxwait, fn->maxexec,
+                          (uint32_t)(fn->exectime / fn->count));
+        }
+    }
+
+  kmm_free(stats);
+  return MIN(len, buflen);
+}
+
+/****************************************************************************
+ * Name: wqueue_open
+ ****************************************************************************/
+
+static int wqueue_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct wqueue_file_s *wqfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* This PROCFS file is read-only.  Any attempt to open with write access
+   * is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  wqfile = kmm_zalloc(sizeof(struct wqueue_file_s));
+  if (!wqfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Take the snapshot now, so that it stays consistent across reads */
+
+#ifdef CONFIG_SCHED_HPWORK
+  wqfile->len += wqueue_format(wqfile->buffer + wqfile->len,
+                               WQUEUE_BUFLEN - wqfile->len, HPWORKNAME,
+                               (FAR struct kwork_wqueue_s *)&g_hpwork);
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+  wqfile->len += wqueue_format(wqfile->buffer + wqfile->len,
+                               WQUEUE_BUFLEN - wqfile->len, LPWORKNAME,
+                               (FAR struct kwork_wqueue_s *)&g_lpwork);
+#endif
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)wqfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_close
+ ****************************************************************************/
+
+static int wqueue_close(FAR struct file *filep)
+{
+  FAR struct wqueue_file_s *wqfile;
+
+  /* Recover our private data from the struct file instance */
+
+  wqfile = (FAR struct wqueue_file_s *)filep->f_priv;
+  DEBUGASSERT(wqfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(wqfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_read
+ ****************************************************************************/
+
+static ssize_t wqueue_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct wqueue_file_s *wqfile;
+  off_t offset;
+  size_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  wqfile = (FAR struct wqueue_file_s *)filep->f_priv;
+  DEBUGASSERT(wqfile);
+
+  offset = filep->f_pos;
+  ret    = procfs_memcpy(wqfile->buffer, wqfile->len, buffer, buflen,
+                         &offset);
+
+  /* Update the file position */
+
+  filep->f_pos += ret;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: wqueue_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int wqueue_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct wqueue_file_s *oldattr;
+  FAR struct wqueue_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct wqueue_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct wqueue_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct wqueue_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int wqueue_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "wqueue" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_WORKQUEUE_STATS */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -44,6 +44,7 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
 #define queue_work(wqueue, work) \
   do \
     { \
@@ -56,11 +57,49 @@
         } \
     } \
   while (0)
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: queue_work
+ *
+ * Description:
+ *   Post the work on the list of its CPU and wake up an idle worker of
+ *   that CPU or, if there is none, an idle worker of another CPU that will
+ *   steal the work.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+static void queue_work(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work)
+{
+  int sem_count;
+  int cpu = work->cpu;
+  int i;
+
+  dq_addlast((FAR dq_entry_t *)work, &wqueue->cpuq[cpu].q);
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      nxsem_get_value(&wqueue->cpuq[cpu].sem, &sem_count);
+      if (sem_count < 0) /* There are threads waiting for sem. */
+        {
+          nxsem_post(&wqueue->cpuq[cpu].sem);
+          break;
+        }
+
+      if (++cpu >= CONFIG_SMP_NCPUS)
+        {
+          cpu = 0;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: work_timer_expiry
  ****************************************************************************/
@@ -70,6 +109,7 @@ static void work_timer_expiry(wdparm_t arg)
   FAR struct work_s *work = (FAR struct work_s *)arg;
   irqstate_t flags = enter_critical_section();
 
+  work_stats_posted(work);
   queue_work(work->wq, work);
   leave_critical_section(flags);
 }
@@ -96,42 +136,12 @@ static bool work_is_canceling(FAR struct kworker_s *kworkers, int nthreads,
 }
 
 /****************************************************************************
- * Public Functions
+ * Name: work_qqueue
  ****************************************************************************/
 
-/****************************************************************************
- * Name: work_queue/work_queue_wq
- *
- * Description:
- *   Queue work to be performed at a later time.  All queued work will be
- *   performed on the worker thread of execution (not the caller's).
- *
- *   The work structure is allocated and must be initialized to all zero by
- *   the caller.  Otherwise, the work structure is completely managed by the
- *   work queue logic.  The caller should never modify the contents of the
- *   work queue structure directly.  If work_queue() is called before the
- *   previous work has been performed and removed from the queue, then any
- *   pending work will be canceled and lost.
- *
- * Input Parameters:
- *   qid    - The work queue ID (must be HPWORK or LPWORK)
- *   wqueue - The work queue handle
- *   work   - The work structure to queue
- *   worker - The worker callback to be invoked.  The callback will be
- *            invoked on the worker thread of execution.
- *   arg    - The argument that will be passed to the worker callback when
- *            it is invoked.
- *   delay  - Delay (in clock ticks) from the time queue until the worker
- *            is invoked. Zero means to perform the work immediately.
- *
- * Returned Value:
- *   Zero on success, a negated errno on failure
- *
- ****************************************************************************/
-
-int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
-                  FAR struct work_s *work, worker_t worker,
-                  FAR void *arg, clock_t delay)
+static int work_qqueue(FAR struct kwork_wqueue_s *wqueue, int cpu,
+                       FAR struct work_s *work, worker_t worker,
+                       FAR void *arg, clock_t delay)
 {
   irqstate_t flags;
   int ret = OK;
@@ -164,11 +174,15 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
   work->worker = worker;           /* Work callback. non-NULL means queued */
   work->arg    = arg;              /* Callback argument */
   work->wq     = wqueue;           /* Work queue */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  work->cpu    = cpu < 0 ? this_cpu() : cpu;
+#endif
 
   /* Queue the new work */
 
   if (!delay)
     {
+      work_stats_posted(work);
       queue_work(wqueue, work);
     }
   else
@@ -181,10 +195,93 @@ out:
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_queue/work_queue_wq
+ *
+ * Description:
+ *   Queue work to be performed at a later time.  All queued work will be
+ *   performed on the worker thread of execution (not the caller's).
+ *
+ *   The work structure is allocated and must be initialized to all zero by
+ *   the caller.  Otherwise, the work structure is completely managed by the
+ *   work queue logic.  The caller should never modify the contents of the
+ *   work queue structure directly.  If work_queue() is called before the
+ *   previous work has been performed and removed from the queue, then any
+ *   pending work will be canceled and lost.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
+                  FAR struct work_s *work, worker_t worker,
+                  FAR void *arg, clock_t delay)
+{
+  return work_qqueue(wqueue, -1, work, worker, arg, delay);
+}
+
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay)
 {
-  return work_queue_wq(work_qid2wq(qid), work, worker, arg, delay);
+  return work_qqueue(work_qid2wq(qid), -1, work, worker, arg, delay);
+}
+
+/****************************************************************************
+ * Name: work_queue_on/work_queue_wq_on
+ *
+ * Description:
+ *   Queue work like work_queue()/work_queue_wq(), but post it on the given
+ *   CPU instead of the calling one.
+ *
+ * Input Parameters:
+ *   cpu    - The CPU to post the work on
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+int work_queue_wq_on(int cpu, FAR struct kwork_wqueue_s *wqueue,
+                     FAR struct work_s *work, worker_t worker,
+                     FAR void *arg, clock_t delay)
+{
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  return work_qqueue(wqueue, cpu, work, worker, arg, delay);
+}
+
+int work_queue_on(int cpu, int qid, FAR struct work_s *work,
+                  worker_t worker, FAR void *arg, clock_t delay)
+{
+  return work_queue_wq_on(cpu, work_qid2wq(qid), work, worker, arg, delay);
 }
+#endif
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
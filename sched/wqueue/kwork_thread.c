@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
+#include <inttypes.h>
 #include <unistd.h>
 #include <sched.h>
 #include <stdio.h>
@@ -40,6 +42,7 @@
 #include <nuttx/kthread.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/sched.h>
+#include <nuttx/sched_note.h>
 
 #include "sched/sched.h"
 #include "wqueue/wqueue.h"
@@ -74,6 +77,10 @@
 #  define CALL_WORKER(worker, arg) worker(arg)
 #endif
 
+#ifndef CONFIG_SCHED_WORKQUEUE_STATS
+#  define work_run(wqueue, worker, arg, qstamp) CALL_WORKER(worker, arg)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -83,8 +90,10 @@
 
 struct hp_wqueue_s g_hpwork =
 {
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
   {NULL, NULL},
   SEM_INITIALIZER(0),
+#endif
   SEM_INITIALIZER(0),
   CONFIG_SCHED_HPNTHREADS,
 };
@@ -96,8 +105,10 @@ struct hp_wqueue_s g_hpwork =
 
 struct lp_wqueue_s g_lpwork =
 {
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
   {NULL, NULL},
   SEM_INITIALIZER(0),
+#endif
   SEM_INITIALIZER(0),
   CONFIG_SCHED_LPNTHREADS,
 };
@@ -108,6 +119,153 @@ struct lp_wqueue_s g_lpwork =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_dequeue
+ *
+ * Description:
+ *   Remove the next work to run from the queue.  A worker takes the work
+ *   posted on its own CPU first and then steals the work of the other
+ *   CPUs, so that no work waits while a worker is idle.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+static FAR struct work_s *work_dequeue(FAR struct kwork_wqueue_s *wqueue,
+                                       FAR struct kworker_s *kworker)
+{
+  FAR dq_entry_t *entry;
+  int cpu = kworker->cpu;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      entry = dq_remfirst(&wqueue->cpuq[cpu].q);
+      if (entry != NULL)
+        {
+          return (FAR struct work_s *)entry;
+        }
+
+      if (++cpu >= CONFIG_SMP_NCPUS)
+        {
+          cpu = 0;
+        }
+    }
+
+  return NULL;
+}
+#else
+#  define work_dequeue(wqueue, kworker) \
+     ((FAR struct work_s *)dq_remfirst(&(wqueue)->q))
+#endif
+
+/****************************************************************************
+ * Name: work_stats_bucket
+ *
+ * Description:
+ *   Return the histogram bucket of a time in microseconds.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+static unsigned int work_stats_bucket(uint32_t us)
+{
+  unsigned int bucket = 0;
+
+  while (us != 0 && bucket < WORK_STATS_NBUCKETS - 1)
+    {
+      us >>= 1;
+      bucket++;
+    }
+
+  return bucket;
+}
+
+/****************************************************************************
+ * Name: work_stats_usec
+ ****************************************************************************/
+
+static uint32_t work_stats_usec(clock_t elapsed)
+{
+  struct timespec ts;
+  uint64_t us;
+
+  perf_convert(elapsed, &ts);
+  us = (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+  return us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+}
+
+/****************************************************************************
+ * Name: work_stats_update
+ *
+ * Description:
+ *   Account for a work that waited 'wait' and ran 'exec' microseconds.
+ *
+ ****************************************************************************/
+
+static void work_stats_update(FAR struct kwork_wqueue_s *wqueue,
+                              worker_t worker, uint32_t wait, uint32_t exec)
+{
+  FAR struct kwork_stats_s *stats = &wqueue->stats;
+  FAR struct kwork_fnstats_s *fn;
+  irqstate_t flags;
+  unsigned int ndx;
+  unsigned int i;
+
+  flags = enter_critical_section();
+
+  stats->count++;
+  stats->maxwait = MAX(stats->maxwait, wait);
+  stats->maxexec = MAX(stats->maxexec, exec);
+  stats->waithist[work_stats_bucket(wait)]++;
+  stats->exechist[work_stats_bucket(exec)]++;
+
+  /* Find the slot of the work function, or a free one */
+
+  ndx = ((uintptr_t)worker >> 2) % CONFIG_SCHED_WORKQUEUE_STATS_NFUNCS;
+  for (i = 0; i < CONFIG_SCHED_WORKQUEUE_STATS_NFUNCS; i++)
+    {
+      fn = &stats->fn[ndx];
+      if (fn->worker == worker || fn->worker == NULL)
+        {
+          fn->worker    = worker;
+          fn->count++;
+          fn->maxwait   = MAX(fn->maxwait, wait);
+          fn->maxexec   = MAX(fn->maxexec, exec);
+          fn->exectime += exec;
+          break;
+        }
+
+      if (++ndx >= CONFIG_SCHED_WORKQUEUE_STATS_NFUNCS)
+        {
+          ndx = 0;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  sched_note_printf(NOTE_TAG_SCHED, "work %p wait %" PRIu32
+                    "us exec %" PRIu32 "us", worker, wait, exec);
+}
+
+/****************************************************************************
+ * Name: work_run
+ *
+ * Description:
+ *   Run a work and account for its wait and execution times.
+ *
+ ****************************************************************************/
+
+static void work_run(FAR struct kwork_wqueue_s *wqueue, worker_t worker,
+                     FAR void *arg, clock_t qstamp)
+{
+  clock_t start = perf_gettime();
+
+  CALL_WORKER(worker, arg);
+  work_stats_update(wqueue, worker, work_stats_usec(start - qstamp),
+                    work_stats_usec(perf_gettime() - start));
+}
+#endif
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -138,6 +296,9 @@ static int work_thread(int argc, FAR char *argv[])
   worker_t worker;
   irqstate_t flags;
   FAR void *arg;
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  clock_t qstamp;
+#endif
   int semcount;
 
   /* Get the handle from argv */
@@ -160,7 +321,7 @@ static int work_thread(int argc, FAR char *argv[])
 
       /* Remove the ready-to-execute work from the list */
 
-      while ((work = (FAR struct work_s *)dq_remfirst(&wqueue->q)) != NULL)
+      while ((work = work_dequeue(wqueue, kworker)) != NULL)
         {
           if (work->worker == NULL)
             {
@@ -184,13 +345,16 @@ static int work_thread(int argc, FAR char *argv[])
           /* Mark the thread busy */
 
           kworker->work = work;
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+          qstamp        = work->qstamp;
+#endif
 
           /* Do the work.  Re-enable interrupts while the work is being
            * performed... we don't have any idea how long this will take!
            */
 
           leave_critical_section(flags);
-          CALL_WORKER(worker, arg);
+          work_run(wqueue, worker, arg, qstamp);
           flags = enter_critical_section();
 
           /* Mark the thread un-busy */
@@ -211,7 +375,7 @@ static int work_thread(int argc, FAR char *argv[])
        * posted.
        */
 
-      nxsem_wait_uninterruptible(&wqueue->sem);
+      nxsem_wait_uninterruptible(WORK_SEM(wqueue, kworker));
     }
 
   leave_critical_section(flags);
@@ -245,6 +409,10 @@ static int work_thread_create(FAR const char *name, int priority,
   FAR char *argv[3];
   char arg0[32];
   char arg1[32];
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  cpu_set_t cpuset;
+  int cpu;
+#endif
   int wndx;
   int pid;
 
@@ -254,9 +422,23 @@ static int work_thread_create(FAR const char *name, int priority,
 
   sched_lock();
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  /* The pending lists of all CPUs start zeroed, empty.  Only the
+   * semaphores need initializing:  Work may already be queued.
+   */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      nxsem_init(&wqueue->cpuq[cpu].sem, 0, 0);
+    }
+#endif
+
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
       nxsem_init(&wqueue->worker[wndx].wait, 0, 0);
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      wqueue->worker[wndx].cpu = wndx % CONFIG_SMP_NCPUS;
+#endif
 
       snprintf(arg0, sizeof(arg0), "%p", wqueue);
       snprintf(arg1, sizeof(arg1), "%p", &wqueue->worker[wndx]);
@@ -276,6 +458,14 @@ static int work_thread_create(FAR const char *name, int priority,
         }
 
       wqueue->worker[wndx].pid = pid;
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      /* Bind the worker to its CPU */
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(wqueue->worker[wndx].cpu, &cpuset);
+      nxsched_set_affinity(pid, sizeof(cpuset), &cpuset);
+#endif
     }
 
   sched_unlock();
@@ -330,8 +520,10 @@ FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
 
   /* Initialize the work queue structure */
 
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
   dq_init(&wqueue->q);
   nxsem_init(&wqueue->sem, 0, 0);
+#endif
   nxsem_init(&wqueue->exsem, 0, 0);
   wqueue->nthreads = nthreads;
 
@@ -380,7 +572,7 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
 
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
-      nxsem_post(&wqueue->sem);
+      nxsem_post(WORK_SEM(wqueue, &wqueue->worker[wndx]));
     }
 
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
@@ -388,7 +580,15 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
       nxsem_wait_uninterruptible(&wqueue->exsem);
     }
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  for (wndx = 0; wndx < CONFIG_SMP_NCPUS; wndx++)
+    {
+      nxsem_destroy(&wqueue->cpuq[wndx].sem);
+    }
+#else
   nxsem_destroy(&wqueue->sem);
+#endif
+
   nxsem_destroy(&wqueue->exsem);
   kmm_free(wqueue);
 
@@ -435,6 +635,32 @@ int work_queue_priority(int qid)
   return work_queue_priority_wq(work_qid2wq(qid));
 }
 
+/****************************************************************************
+ * Name: work_stats_snapshot
+ *
+ * Description:
+ *   Copy the statistics of a work queue and start a new interval.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   stats  - The location to return the statistics
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+void work_stats_snapshot(FAR struct kwork_wqueue_s *wqueue,
+                         FAR struct kwork_stats_s *stats)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  memcpy(stats, &wqueue->stats, sizeof(*stats));
+  memset(&wqueue->stats, 0, sizeof(wqueue->stats));
+  wqueue->stats.start = clock_systime_ticks();
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: work_start_highpri
  *
@@ -47,6 +47,27 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* The pending work list that a work is posted on and the semaphore that a
+ * worker waits on for new work.
+ */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+#  define WORK_PENDING(wqueue, work)  (&(wqueue)->cpuq[(work)->cpu].q)
+#  define WORK_SEM(wqueue, kworker)   (&(wqueue)->cpuq[(kworker)->cpu].sem)
+#else
+#  define WORK_PENDING(wqueue, work)  (&(wqueue)->q)
+#  define WORK_SEM(wqueue, kworker)   (&(wqueue)->sem)
+#endif
+
+/* Time stamp a work as it is posted on a pending list */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+#  define WORK_STATS_NBUCKETS         16
+#  define work_stats_posted(work)     ((work)->qstamp = perf_gettime())
+#else
+#  define work_stats_posted(work)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -58,17 +79,65 @@ struct kworker_s
   pid_t             pid;       /* The task ID of the worker thread */
   FAR struct work_s *work;     /* The work structure */
   sem_t             wait;      /* Sync waiting for worker done */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  uint8_t           cpu;       /* The CPU that the worker is bound to */
+#endif
 };
 
+/* This is the pending work of one CPU in a work queue */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+struct kwork_cpuq_s
+{
+  struct dq_queue_s q;         /* The work posted on the CPU */
+  sem_t             sem;       /* The idle workers bound to the CPU */
+};
+#endif
+
+/* These are the statistics of one work function and of one work queue.
+ * The times are in microseconds.  Bucket n of a histogram counts the times
+ * below 2^n microseconds; the last bucket also counts the longer ones.
+ */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+struct kwork_fnstats_s
+{
+  worker_t          worker;    /* The work function, NULL if unused */
+  uint32_t          count;     /* The number of works run */
+  uint32_t          maxwait;   /* The longest wait for a worker */
+  uint32_t          maxexec;   /* The longest execution */
+  uint64_t          exectime;  /* The total execution time */
+};
+
+struct kwork_stats_s
+{
+  clock_t           start;     /* clock_systime_ticks() at the last reset */
+  uint32_t          count;     /* The number of works run */
+  uint32_t          maxwait;   /* The longest wait for a worker */
+  uint32_t          maxexec;   /* The longest execution */
+  uint32_t          waithist[WORK_STATS_NBUCKETS];
+  uint32_t          exechist[WORK_STATS_NBUCKETS];
+  struct kwork_fnstats_s fn[CONFIG_SCHED_WORKQUEUE_STATS_NFUNCS];
+};
+#endif
+
 /* This structure defines the state of one kernel-mode work queue */
 
 struct kwork_wqueue_s
 {
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+#endif
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  struct kwork_stats_s stats;  /* The wait and execution statistics */
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  struct kwork_cpuq_s cpuq[CONFIG_SMP_NCPUS]; /* Pending work of each CPU */
+#endif
   struct kworker_s  worker[0]; /* Describes a worker thread */
 };
 
@@ -79,11 +148,19 @@ struct kwork_wqueue_s
 #ifdef CONFIG_SCHED_HPWORK
 struct hp_wqueue_s
 {
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+#endif
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  struct kwork_stats_s stats;  /* The wait and execution statistics */
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  struct kwork_cpuq_s cpuq[CONFIG_SMP_NCPUS]; /* Pending work of each CPU */
+#endif
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -98,11 +175,19 @@ struct hp_wqueue_s
 #ifdef CONFIG_SCHED_LPWORK
 struct lp_wqueue_s
 {
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+#endif
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  struct kwork_stats_s stats;  /* The wait and execution statistics */
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  struct kwork_cpuq_s cpuq[CONFIG_SMP_NCPUS]; /* Pending work of each CPU */
+#endif
 
   /* Describes each thread in the low priority queue's thread pool */
 
@@ -201,5 +286,22 @@ int work_start_lowpri(void);
 void work_initialize_notifier(void);
 #endif
 
+/****************************************************************************
+ * Name: work_stats_snapshot
+ *
+ * Description:
+ *   Copy the statistics of a work queue and start a new interval.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   stats  - The location to return the statistics
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+void work_stats_snapshot(FAR struct kwork_wqueue_s *wqueue,
+                         FAR struct kwork_stats_s *stats);
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
 #endif /* __SCHED_WQUEUE_WQUEUE_H */
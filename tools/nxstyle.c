@@ -314,6 +314,8 @@ static const char *g_white_content_list[] =
    * fs/nfs/nfs_vfsops.c
    */
 
+  "COMMIT3args",
+  "COMMIT3resok",
   "CREATE3args",
   "CREATE3resok",
   "LOOKUP3args",
@@ -599,6 +601,8 @@ static const char *g_white_content_list[] =
   "unzGetCurrentFileInfo64",
   "unzGoToNextFile",
   "unzGoToFirstFile",
+  "unzCloseCurrentFile",
+  "unzGetFilePos64",
   NULL
 };
 
@@ -124,32 +124,36 @@ static void bt_conn_reset_rx_state(FAR struct bt_conn_s *conn)
   conn->rx_len = 0;
 }
 
-static int conn_tx_kthread(int argc, FAR char *argv[])
+/****************************************************************************
+ * Name: conn_send_acl
+ *
+ * Description:
+ *   Send an L2CAP PDU as ACL packets of at most the controller's ACL MTU,
+ *   each as soon as the controller has a buffer for it.  The fragments are
+ *   cut in place: the ACL header of each goes in front of its data, over
+ *   the end of the fragment just sent, so nothing is copied.
+ *
+ ****************************************************************************/
+
+static int conn_send_acl(FAR struct bt_conn_s *conn,
+                         FAR struct bt_buf_s *buf)
 {
-  FAR struct bt_conn_s *conn;
-  FAR struct bt_buf_s *buf;
-  struct mq_attr attr;
+  FAR struct bt_hci_acl_hdr_s *hdr;
+  FAR uint8_t *data = buf->data;
+  uint16_t remaining = buf->len;
+  uint16_t flags = 0;
+  uint16_t len;
   int ret;
 
-  /* Get the connection instance */
-
-  conn = g_conn_handoff.conn;
-  DEBUGASSERT(conn != NULL);
-  nxsem_post(&g_conn_handoff.sync_sem);
-
-  wlinfo("Started for handle %u\n", conn->handle);
-
-  while (conn->state == BT_CONN_CONNECTED)
+  while (remaining > 0)
     {
-      /* Wait until the controller can accept ACL packets */
-
-      wlinfo("calling nxsem_wait_uninterruptible()\n");
+      /* Wait until the controller can accept one more ACL packet */
 
       ret = nxsem_wait_uninterruptible(&g_btdev.le_pkts_sem);
       if (ret < 0)
         {
           wlerr("nxsem_wait_uninterruptible() failed: %d\n", ret);
-          break;
+          return ret;
         }
 
       /* Check for disconnection */
@@ -157,10 +161,56 @@ static int conn_tx_kthread(int argc, FAR char *argv[])
       if (conn->state != BT_CONN_CONNECTED)
         {
           nxsem_post(&g_btdev.le_pkts_sem);
-          break;
+          return -ENOTCONN;
+        }
+
+      len = remaining;
+      if (len > g_btdev.le_mtu)
+        {
+          len = g_btdev.le_mtu;
         }
 
-      /* Get next ACL packet for connection */
+      hdr         = (FAR struct bt_hci_acl_hdr_s *)(data - sizeof(*hdr));
+      hdr->handle = BT_HOST2LE16(conn->handle | flags);
+      hdr->len    = BT_HOST2LE16(len);
+
+      buf->data   = (FAR uint8_t *)hdr;
+      buf->len    = len + sizeof(*hdr);
+
+      wlinfo("passing buf %p len %u to driver\n", buf, buf->len);
+      bt_send(g_btdev.btdev, buf);
+
+      /* The following fragments are continuations */
+
+      data       += len;
+      remaining  -= len;
+      flags       = 1 << 12;
+    }
+
+  return OK;
+}
+
+static int conn_tx_kthread(int argc, FAR char *argv[])
+{
+  FAR struct bt_conn_s *conn;
+  FAR struct bt_buf_s *buf;
+  struct mq_attr attr;
+  int ret;
+
+  /* Get the connection instance */
+
+  conn = g_conn_handoff.conn;
+  DEBUGASSERT(conn != NULL);
+  nxsem_post(&g_conn_handoff.sync_sem);
+
+  wlinfo("Started for handle %u\n", conn->handle);
+
+  while (conn->state == BT_CONN_CONNECTED)
+    {
+      /* Get next L2CAP PDU for connection.  The controller buffers are
+       * taken only once there is something to send, so that an idle
+       * connection does not hold one that another connection could use.
+       */
 
       ret = bt_queue_receive(&conn->tx_queue, &buf);
       DEBUGASSERT(ret >= 0 && buf != NULL);
@@ -168,14 +218,16 @@ static int conn_tx_kthread(int argc, FAR char *argv[])
 
       if (conn->state != BT_CONN_CONNECTED)
         {
-          nxsem_post(&g_btdev.le_pkts_sem);
           bt_buf_release(buf);
           break;
         }
 
-      wlinfo("passing buf %p len %u to driver\n", buf, buf->len);
-      bt_send(g_btdev.btdev, buf);
+      ret = conn_send_acl(conn, buf);
       bt_buf_release(buf);
+      if (ret < 0)
+        {
+          break;
+        }
     }
 
   wlinfo("handle %u disconnected - cleaning up\n", conn->handle);
@@ -401,16 +453,8 @@ void bt_conn_receive(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf,
 
 void bt_conn_send(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf)
 {
-  FAR struct bt_hci_acl_hdr_s *hdr;
-  sq_queue_t fraglist;
-  uint16_t len;
-  uint16_t remaining = buf->len;
-  FAR uint8_t *ptr;
-
   DEBUGASSERT(conn != NULL && buf != NULL);
 
-  sq_init(&fraglist);
-
   wlinfo("conn handle %u buf len %u\n", conn->handle, buf->len);
 
   if (conn->state != BT_CONN_CONNECTED)
@@ -419,55 +463,9 @@ void bt_conn_send(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf)
       return;
     }
 
-  len = remaining;
-  if (len > g_btdev.le_mtu)
-    {
-      len = g_btdev.le_mtu;
-    }
-
-  hdr         = bt_buf_provide(buf, sizeof(*hdr));
-  hdr->handle = BT_HOST2LE16(conn->handle);
-  hdr->len    = BT_HOST2LE16(len);
-
-  buf->len   -= remaining - len;
-  ptr         = bt_buf_tail(buf);
-
-  /* Add the fragment to the end of the list */
-
-  sq_addlast((FAR sq_entry_t *)buf, &fraglist);
-  remaining  -= len;
-
-  while (remaining)
-    {
-      buf = bt_l2cap_create_pdu(conn);
-
-      len = remaining;
-      if (len < g_btdev.le_mtu)
-        {
-          len = g_btdev.le_mtu;
-        }
-
-      /* Copy from original buffer */
-
-      memcpy(bt_buf_extend(buf, len), ptr, len);
-      ptr        += len;
-
-      hdr         = bt_buf_provide(buf, sizeof(*hdr));
-      hdr->handle = BT_HOST2LE16(conn->handle | (1 << 12));
-      hdr->len    = BT_HOST2LE16(len);
-
-      /* Add the fragment to the end of the list */
+  /* The Tx thread cuts the PDU into ACL packets as it sends it */
 
-      sq_addlast((FAR sq_entry_t *)buf, &fraglist);
-      remaining  -= len;
-    }
-
-  /* Then send each fragment in the correct order */
-
-  while ((buf = (FAR struct bt_buf_s *)sq_remfirst(&fraglist)) != NULL)
-    {
-      bt_queue_send(&conn->tx_queue, buf, BT_NORMAL_PRIO);
-    }
+  bt_queue_send(&conn->tx_queue, buf, BT_NORMAL_PRIO);
 }
 
 /****************************************************************************